@@ -11,3 +11,25 @@ find_package(Boost REQUIRED
   system
   thread
 )
+
+# moveit_generate_fk_kernel(<target> <robot_name> <urdf_file> <srdf_file>)
+#
+# Generate forward kinematics and Jacobian kernels specialized for the robot described by the given (plain, not xacro)
+# URDF and SRDF files and compile them into <target>. When a RobotModel for the same kinematic structure is
+# constructed in a process that loaded <target>, RobotState uses these kernels instead of the generic implementation.
+function(moveit_generate_fk_kernel target robot_name urdf_file srdf_file)
+  if(TARGET moveit_fk_kernel_generator)
+    set(generator $<TARGET_FILE:moveit_fk_kernel_generator>)
+    set(generator_target moveit_fk_kernel_generator)
+  else()
+    set(generator ${moveit_core_DIR}/../../../lib/moveit_core/moveit_fk_kernel_generator)
+  endif()
+  set(output ${CMAKE_CURRENT_BINARY_DIR}/${robot_name}_fk_kernel.cpp)
+  add_custom_command(
+    OUTPUT ${output}
+    COMMAND ${generator} ${urdf_file} ${srdf_file} ${output}
+    DEPENDS ${urdf_file} ${srdf_file} ${generator_target}
+    COMMENT "Generating forward kinematics kernel for ${robot_name}"
+  )
+  target_sources(${target} PRIVATE ${output})
+endfunction()
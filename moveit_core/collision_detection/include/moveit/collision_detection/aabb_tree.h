@@ -0,0 +1,136 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#pragma once
+
+#include <Eigen/Geometry>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace collision_detection
+{
+/** @class AABBTree
+ *  @brief A dynamic bounding volume hierarchy over named axis-aligned boxes.
+ *
+ *  Boxes can be inserted, moved and removed one at a time. The tree is kept balanced by rotations, so updates and
+ *  queries take logarithmic time in the number of boxes. Every leaf stores its box enlarged by a small margin, so a box
+ *  that moves by less than the margin does not change the structure of the tree. Boxes that are unbounded in any
+ *  direction are kept aside and reported by every query. */
+class AABBTree
+{
+public:
+  /** @brief The margin leaves are enlarged by, in meters */
+  static constexpr double MARGIN = 0.02;
+
+  /** @brief Insert the box named \e id, or replace its box if it is known already. An empty box removes \e id. */
+  void update(const std::string& id, const Eigen::AlignedBox3d& box);
+
+  /** @brief Remove the box named \e id. Returns false if it is not known */
+  bool remove(const std::string& id);
+
+  /** @brief Remove all boxes */
+  void clear();
+
+  /** @brief The number of boxes in the tree */
+  std::size_t size() const
+  {
+    return leaves_.size() + unbounded_.size();
+  }
+
+  /** @brief Add the ids of the boxes intersecting \e box to \e ids */
+  void query(const Eigen::AlignedBox3d& box, std::vector<std::string>& ids) const;
+
+  /** @brief Add the ids of the boxes that the segment from \e start to \e end crosses, after enlarging the boxes by
+   *  \e radius in every direction, to \e ids. This includes all boxes closer to the segment than \e radius. */
+  void querySegment(const Eigen::Vector3d& start, const Eigen::Vector3d& end, double radius,
+                    std::vector<std::string>& ids) const;
+
+  /** @brief The height of the tree; a leaf has height 0 and an empty tree has height -1 */
+  int height() const
+  {
+    return root_ < 0 ? -1 : nodes_[root_].height;
+  }
+
+private:
+  struct Node
+  {
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    /// Bounds of the subtree; for a leaf the enlarged box
+    Eigen::AlignedBox3d box;
+
+    /// For a leaf, the box as it was set
+    Eigen::AlignedBox3d tight;
+
+    int parent = -1;
+    int left = -1;
+    int right = -1;
+    int height = 0;
+
+    /// For a leaf, the name of the box
+    std::string id;
+
+    bool isLeaf() const
+    {
+      return left < 0;
+    }
+  };
+
+  int allocateNode();
+  void freeNode(int index);
+  void insertLeaf(int leaf);
+  void removeLeaf(int leaf);
+
+  /** Refit the bounds and heights from \e index up to the root, rebalancing on the way */
+  void refit(int index);
+
+  /** Rotate the tree at \e index if its subtrees differ in height by more than one. Returns the new subtree root */
+  int balance(int index);
+
+  template <typename Test>
+  void traverse(const Test& test, std::vector<std::string>& ids) const;
+
+  std::vector<Node, Eigen::aligned_allocator<Node>> nodes_;
+  std::vector<int> free_nodes_;
+  int root_ = -1;
+
+  /// The leaf holding each bounded box
+  std::unordered_map<std::string, int> leaves_;
+
+  /// Boxes unbounded in any direction
+  std::set<std::string> unbounded_;
+};
+}  // namespace collision_detection
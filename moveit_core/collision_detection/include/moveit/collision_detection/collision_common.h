@@ -191,6 +191,7 @@ struct CollisionRequest
     , max_contacts_per_pair(1)
     , max_cost_sources(1)
     , verbose(false)
+    , octree_lod_levels(0)
   {
   }
   virtual ~CollisionRequest()
@@ -224,6 +225,12 @@ struct CollisionRequest
 
   /** \brief Flag indicating whether information about detected collisions should be reported */
   bool verbose;
+
+  /** \brief If non-zero, bodies are first checked against a copy of each octree whose cells are 2^octree_lod_levels
+   * times larger. Only bodies touching an occupied coarse cell are checked against the full resolution tree. The
+   * coarse tree covers every occupied voxel, so the result does not change. Ignored when costs are computed.
+   * Currently only supported by FCL. */
+  unsigned int octree_lod_levels;
 };
 
 namespace DistanceRequestTypes
@@ -251,6 +258,7 @@ struct DistanceRequest
     , distance_threshold(std::numeric_limits<double>::max())
     , verbose(false)
     , compute_gradient(false)
+    , parallel(false)
   {
   }
 
@@ -296,6 +304,10 @@ struct DistanceRequest
   /// Indicate if gradient should be calculated between each object.
   /// This is the normalized vector connecting the closest points on the two objects.
   bool compute_gradient;
+
+  /// Split the query across several threads, if the collision detector supports it.
+  /// The reported distances are the same as those of a serial query.
+  bool parallel;
 };
 
 /** \brief Generic representation of the distance information for a pair of objects */
@@ -42,6 +42,7 @@
 #include <moveit_msgs/msg/link_padding.hpp>
 #include <moveit_msgs/msg/link_scale.hpp>
 #include <moveit/collision_detection/world.h>
+#include <functional>
 
 namespace collision_detection
 {
@@ -110,6 +111,19 @@ public:
   virtual void checkCollision(const CollisionRequest& req, CollisionResult& res, const moveit::core::RobotState& state,
                               const AllowedCollisionMatrix& acm) const;
 
+  /** \brief Check a batch of states for collisions of the robot with itself or the world, as checkCollision() does
+   *  for a single state. Allowed collisions specified by the allowed collision matrix are taken into account.
+   *
+   *  The default implementation checks the states one after the other. Implementations may override it to share
+   *  work across the batch and to check several states concurrently.
+   *  @param req A CollisionRequest object that encapsulates the collision request, used for all states
+   *  @param res Resized to the number of states; entry i holds the result for states[i]
+   *  @param states The kinematic states for which checks are being made, with up-to-date collision body transforms
+   *  @param acm The allowed collision matrix. */
+  virtual void checkCollisionBatch(const CollisionRequest& req, std::vector<CollisionResult>& res,
+                                   const std::vector<const moveit::core::RobotState*>& states,
+                                   const AllowedCollisionMatrix& acm) const;
+
   /** \brief Check whether the robot model is in collision with the world. Any collisions between a robot link
    *  and the world are considered. Self collisions are not checked.
    *  @param req A CollisionRequest object that encapsulates the collision request
@@ -311,6 +325,21 @@ protected:
       @param links the names of the links whose padding or scaling were updated */
   virtual void updatedPaddingOrScaling(const std::vector<std::string>& links);
 
+  /** @brief The number of threads checkCollisionBatch() implementations use for a batch of \e count states */
+  static std::size_t getBatchThreadCount(std::size_t count);
+
+  /** @brief Call \e check(thread, i) for all i in [0, count), spread over getBatchThreadCount(count) threads of the
+      shared task scheduler (moveit/utils/task_scheduler.h). \e thread is the index of the calling participant, so
+      callers can keep per-thread data. Small batches are run on the calling thread. */
+  static void forEachInBatch(std::size_t count, const std::function<void(std::size_t, std::size_t)>& check);
+
+  /** @brief Check whether the bounding spheres of the links in \e state stay more than \e margin apart for every pair
+      of links \e acm does not always allow to collide (every pair if \e acm is nullptr).
+      The spheres enclose the padded and scaled link geometry, so if this returns true, a self-collision check of
+      \e state cannot find a contact closer than \e margin. States with attached bodies always return false. */
+  bool areLinkBoundingSpheresSeparated(const moveit::core::RobotState& state, const AllowedCollisionMatrix* acm,
+                                       double margin = 0.0) const;
+
   /** @brief The kinematic model corresponding to this collision model*/
   moveit::core::RobotModelConstPtr robot_model_;
 
@@ -321,7 +350,13 @@ protected:
   std::map<std::string, double> link_scale_;
 
 private:
+  /** @brief Recompute link_bounding_sphere_radius_ from the link padding and scaling */
+  void updateLinkBoundingSphereRadii();
+
   WorldPtr world_;             // The world always valid, never nullptr.
   WorldConstPtr world_const_;  // always same as world_
+
+  /** @brief The radius of the padded and scaled bounding sphere of each link, indexed by link index */
+  std::vector<double> link_bounding_sphere_radius_;
 };
 }  // namespace collision_detection
@@ -43,6 +43,8 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <memory>
+#include <cstdint>
 
 namespace collision_detection
 {
@@ -70,7 +72,8 @@ enum Type
  * CONDITIONAL) */
 using DecideContactFn = std::function<bool(collision_detection::Contact&)>;
 
-MOVEIT_CLASS_FORWARD(AllowedCollisionMatrix);  // Defines AllowedCollisionMatrixPtr, ConstPtr, WeakPtr... etc
+MOVEIT_CLASS_FORWARD(AllowedCollisionMatrix);         // Defines AllowedCollisionMatrixPtr, ConstPtr, WeakPtr... etc
+MOVEIT_CLASS_FORWARD(IndexedAllowedCollisionMatrix);  // Defines IndexedAllowedCollisionMatrixPtr, ConstPtr, WeakPtr...
 
 /** @class AllowedCollisionMatrix
  *  @brief Definition of a structure for the allowed collision matrix. All elements in the collision world are referred
@@ -243,14 +246,102 @@ public:
   /** @brief Print the allowed collision matrix */
   void print(std::ostream& out) const;
 
+  /** @brief Get the entries between all links of \e robot_model, compiled into a table indexed by link index.
+   *
+   *  The table is built on the first call and reused until the matrix is modified or a different robot model is
+   *  passed in. It is safe to call this concurrently from several threads. */
+  IndexedAllowedCollisionMatrixConstPtr getIndexedLinkMatrix(const moveit::core::RobotModel& robot_model) const;
+
+  /** @brief Get a number identifying the current contents of the matrix.
+   *
+   *  Every modification assigns a new version that no other matrix has had before, while copies keep the version of
+   *  their source. Two matrices with the same version therefore have the same entries, which allows caching results
+   *  that depend on the matrix. */
+  std::uint64_t getVersion() const
+  {
+    return version_;
+  }
+
 private:
+  friend class IndexedAllowedCollisionMatrix;
+
   bool getDefaultEntry(const std::string& name1, const std::string& name2,
                        AllowedCollision::Type& allowed_collision) const;
 
-  std::map<std::string, std::map<std::string, AllowedCollision::Type> > entries_;
+  /** @brief Combine the default entries of two elements into the default for the pair */
+  static bool combineDefaultEntries(bool found1, AllowedCollision::Type t1, bool found2, AllowedCollision::Type t2,
+                                    AllowedCollision::Type& allowed_collision);
+
+  /** @brief Discard the indexed link matrix and assign a new version after a modification */
+  void invalidateIndexedLinkMatrix();
+
+  /** @brief Get a version number that was not handed out before */
+  static std::uint64_t nextVersion();
+
+  using EntryRow = std::map<std::string, AllowedCollision::Type>;
+
+  /** @brief Get the row of entries for \e name for modification, creating it if needed */
+  EntryRow& getEntryRowNonConst(const std::string& name);
+
+  /** @brief Copy \e row if it is shared with another matrix, so that it can be modified */
+  static EntryRow& ensureUnique(std::shared_ptr<EntryRow>& row);
+
+  /** @brief The rows of entries. Copies of the matrix share rows until they are modified, so copying a matrix only
+   *  costs a pointer per row. */
+  std::map<std::string, std::shared_ptr<EntryRow> > entries_;
   std::map<std::string, std::map<std::string, DecideContactFn> > allowed_contacts_;
 
   std::map<std::string, AllowedCollision::Type> default_entries_;
   std::map<std::string, DecideContactFn> default_allowed_contacts_;
+
+  /** @brief Cache of getIndexedLinkMatrix(), accessed with std::atomic_load() and std::atomic_store() */
+  mutable IndexedAllowedCollisionMatrixConstPtr indexed_links_;
+
+  std::uint64_t version_ = nextVersion();
+};
+
+/** @class IndexedAllowedCollisionMatrix
+ *  @brief The allowed collision types between a fixed list of elements, stored as a dense matrix.
+ *
+ *  Looking up an entry in an AllowedCollisionMatrix takes up to four string-keyed map lookups, which adds up when it
+ *  is done for every candidate pair of a collision check. An IndexedAllowedCollisionMatrix resolves the entries and
+ *  defaults between all pairs of a list of names once, so that a lookup by index is a single table access. Predicates
+ *  of AllowedCollision::CONDITIONAL entries are not stored; they still have to be fetched from the source matrix. */
+class IndexedAllowedCollisionMatrix
+{
+public:
+  /** @brief Resolve the entries of \e acm between all pairs of \e names */
+  IndexedAllowedCollisionMatrix(const AllowedCollisionMatrix& acm, const std::vector<std::string>& names);
+
+  /** @brief The number of indexed elements */
+  std::size_t getSize() const
+  {
+    return size_;
+  }
+
+  /** @brief Get the allowed collision type between the elements \e index1 and \e index2.
+   *  Returns false if neither an entry nor defaults are specified for this pair, like
+   *  AllowedCollisionMatrix::getAllowedCollision(). */
+  bool getAllowedCollision(std::size_t index1, std::size_t index2, AllowedCollision::Type& allowed_collision) const
+  {
+    const unsigned char entry = entries_[index1 * size_ + index2];
+    if (entry == NO_ENTRY)
+      return false;
+    allowed_collision = static_cast<AllowedCollision::Type>(entry);
+    return true;
+  }
+
+private:
+  friend class AllowedCollisionMatrix;
+
+  static constexpr unsigned char NO_ENTRY = 0xff;
+
+  std::size_t size_;
+
+  /** @brief Row-major table of AllowedCollision::Type values, or NO_ENTRY */
+  std::vector<unsigned char> entries_;
+
+  /** @brief The robot model the element names were taken from, if built by getIndexedLinkMatrix() */
+  const moveit::core::RobotModel* robot_model_ = nullptr;
 };
 }  // namespace collision_detection
@@ -38,9 +38,45 @@
 
 #include <moveit/collision_detection/collision_common.h>
 #include <moveit/collision_detection/collision_env.h>
+#include <functional>
+#include <vector>
 
 namespace collision_detection
 {
+/** @brief Scratch buffers for refineContactNormals().
+ *
+ *  Holds the gathered voxel centers as separate coordinate arrays so the metaball potential can be evaluated over
+ *  all of them in one vectorized pass. The buffers keep their capacity, so passing the same workspace to repeated
+ *  calls avoids allocating per contact. A workspace must not be shared between threads. */
+struct ContactRefinementWorkspace
+{
+  std::vector<double> x;
+  std::vector<double> y;
+  std::vector<double> z;
+  /** @brief Squared distances from the current sample position to each point */
+  std::vector<double> dist2;
+
+  void clear()
+  {
+    x.clear();
+    y.clear();
+    z.clear();
+  }
+
+  std::size_t size() const
+  {
+    return x.size();
+  }
+};
+
+/** @brief Optional distance-field lookup used by refineContactNormals().
+ *
+ *  Given a point in the world frame, writes the gradient of the distance to the nearest obstacle (pointing away
+ *  from it) and the signed distance (negative inside obstacles). Returns false if the point lies outside the field
+ *  or no gradient is defined there, in which case the metaball estimate is used instead. */
+using DistanceGradientFn =
+    std::function<bool(const Eigen::Vector3d& point, Eigen::Vector3d& gradient, double& signed_distance)>;
+
 /** @brief Re-proceses contact normals for an octomap by estimating a metaball
  *   iso-surface using the centers of occupied cells in a neighborhood of the contact point.
  *
@@ -60,4 +96,14 @@ namespace collision_detection
 int refineContactNormals(const World::ObjectConstPtr& object, CollisionResult& res,
                          double cell_bbx_search_distance = 1.0, double allowed_angle_divergence = 0.0,
                          bool estimate_depth = false, double iso_value = 0.5, double metaball_radius_multiple = 1.5);
+
+/** @brief Same as above, but reuses the buffers in @e workspace and tries @e distance_gradient first.
+ *
+ *  When @e distance_gradient is set and yields a gradient at a contact point, its normalized direction is taken as
+ *  the refined normal (and the negated signed distance as the depth), skipping the octree search for that contact.
+ */
+int refineContactNormals(const World::ObjectConstPtr& object, CollisionResult& res,
+                         ContactRefinementWorkspace& workspace, const DistanceGradientFn& distance_gradient = nullptr,
+                         double cell_bbx_search_distance = 1.0, double allowed_angle_divergence = 0.0,
+                         bool estimate_depth = false, double iso_value = 0.5, double metaball_radius_multiple = 1.5);
 }  // namespace collision_detection
@@ -0,0 +1,182 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#pragma once
+
+#include <moveit/collision_detection/collision_env.h>
+#include <moveit/collision_detection/collision_matrix.h>
+#include <moveit/collision_detection/world.h>
+#include <moveit/macros/class_forward.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace collision_detection
+{
+MOVEIT_CLASS_FORWARD(CollisionResultCache);  // Defines CollisionResultCachePtr, ConstPtr, WeakPtr... etc
+
+/** @class CollisionResultCache
+ *  @brief A bounded, thread-safe cache of binary collision results.
+ *
+ *  Planners and path validation often check the same configuration many times. The cache stores whether a state was
+ *  found in collision, keyed on the variables of a joint model group quantized to a grid of the given resolution and
+ *  on the version of the allowed collision matrix used for the check. All states in the same grid cell share one
+ *  result, so the resolution should be well below the collision padding. Variables outside of the group are not part
+ *  of the key and must not change while the cache is used.
+ *
+ *  If a world is passed in, the cache is cleared whenever an object of that world changes. Changes that are not
+ *  reported by the world, e.g. to attached bodies or to another scene, require an explicit clear(). */
+class CollisionResultCache
+{
+public:
+  static constexpr std::size_t DEFAULT_CAPACITY = 100000;
+  static constexpr double DEFAULT_RESOLUTION = 1e-4;
+
+  /** @brief Construct a cache holding up to \e capacity results, with variables quantized to \e resolution.
+   *  The cache is cleared whenever \e world, if given, is modified. */
+  CollisionResultCache(std::size_t capacity = DEFAULT_CAPACITY, double resolution = DEFAULT_RESOLUTION,
+                       const WorldPtr& world = WorldPtr());
+  ~CollisionResultCache();
+
+  CollisionResultCache(const CollisionResultCache&) = delete;
+  CollisionResultCache& operator=(const CollisionResultCache&) = delete;
+
+  /** @brief Check whether the result of \e req can be cached, i.e. it only asks whether there is a collision */
+  static bool isCacheable(const CollisionRequest& req);
+
+  /** @brief Look up the result for the variables of \e group in \e state, checked with \e acm.
+   *  If \e group is null, all variables of the state are used. Returns false if no result is known. */
+  bool lookup(const moveit::core::JointModelGroup* group, const moveit::core::RobotState& state,
+              const AllowedCollisionMatrix& acm, bool& collision) const;
+
+  /** @brief Store the result for the variables of \e group in \e state, checked with \e acm.
+   *  If the cache is full, an arbitrary entry is evicted. */
+  void insert(const moveit::core::JointModelGroup* group, const moveit::core::RobotState& state,
+              const AllowedCollisionMatrix& acm, bool collision);
+
+  /** @brief Check \e state for collisions using \e env, answering from the cache when possible.
+   *  Requests that ask for more than a binary result bypass the cache. The key is built from the variables of the
+   *  group named in \e req, or of the whole robot if no group is named. */
+  void checkCollision(const CollisionEnv& env, const CollisionRequest& req, CollisionResult& res,
+                      const moveit::core::RobotState& state, const AllowedCollisionMatrix& acm);
+
+  /** @brief Remove all stored results */
+  void clear();
+
+  /** @brief The number of stored results */
+  std::size_t size() const;
+
+  /** @brief The maximum number of stored results */
+  std::size_t getCapacity() const
+  {
+    return capacity_;
+  }
+
+  /** @brief The grid size variables are quantized to */
+  double getResolution() const
+  {
+    return resolution_;
+  }
+
+  /** @brief The number of lookups that found a result */
+  std::size_t getHitCount() const
+  {
+    return hits_;
+  }
+
+  /** @brief The number of lookups that did not find a result */
+  std::size_t getMissCount() const
+  {
+    return misses_;
+  }
+
+  /** @brief Reset the hit and miss counters */
+  void resetCounters();
+
+private:
+  struct Key
+  {
+    const moveit::core::JointModelGroup* group;
+    std::uint64_t acm_version;
+    std::vector<std::int64_t> values;
+    std::size_t hash;
+
+    bool operator==(const Key& other) const
+    {
+      return group == other.group && acm_version == other.acm_version && values == other.values;
+    }
+  };
+
+  struct KeyHash
+  {
+    std::size_t operator()(const Key& key) const
+    {
+      return key.hash;
+    }
+  };
+
+  /** @brief Entries are spread over several independently locked maps to reduce contention */
+  struct Shard
+  {
+    std::mutex lock;
+    std::unordered_map<Key, bool, KeyHash> entries;
+  };
+
+  static const std::size_t SHARD_COUNT = 16;
+
+  Key makeKey(const moveit::core::JointModelGroup* group, const moveit::core::RobotState& state,
+              const AllowedCollisionMatrix& acm) const;
+  bool find(const Key& key, bool& collision) const;
+  void store(Key&& key, bool collision);
+
+  Shard& getShard(const Key& key) const
+  {
+    return shards_[key.hash % SHARD_COUNT];
+  }
+
+  std::size_t capacity_;
+  std::size_t shard_capacity_;
+  double resolution_;
+
+  mutable std::array<Shard, SHARD_COUNT> shards_;
+  mutable std::atomic<std::size_t> hits_;
+  mutable std::atomic<std::size_t> misses_;
+
+  WorldPtr world_;
+  World::ObserverHandle observer_handle_;
+};
+}  // namespace collision_detection
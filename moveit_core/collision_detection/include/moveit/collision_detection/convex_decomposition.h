@@ -0,0 +1,131 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#pragma once
+
+#include <geometric_shapes/shapes.h>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace collision_detection
+{
+/** @brief Settings for the automatic convex decomposition of collision meshes */
+struct ConvexDecompositionOptions
+{
+  /** @brief Whether collision environments replace meshes by their convex parts */
+  bool enabled = false;
+
+  /** @brief How far the convex hull of a part may reach beyond the surface of the mesh, relative to the diagonal of
+   *  the bounding box of its connected component. Parts whose hull reaches further are split. */
+  double max_concavity = 0.02;
+
+  /** @brief How often a part may be split in half. Limits the number of parts per connected component to 2^max_depth */
+  unsigned int max_depth = 5;
+
+  /** @brief Directory the decompositions are stored in, so each mesh is decomposed once. Empty disables the files. */
+  std::string cache_directory;
+};
+
+/** @brief Split the mesh into convex parts.
+ *
+ *  This is a simple hierarchical approximate convex decomposition: each connected component of the mesh is
+ *  replaced by the convex hull of its vertices. A part whose hull reaches too far outside the component is cut in
+ *  half along the longest side of its bounding box, and both halves are decomposed again. Every triangle of the mesh
+ *  lies within the hull of its part, so the parts cover the surface of the mesh.
+ *
+ *  Returns the hulls as meshes in the frame of \e mesh, or an empty vector if the mesh can not be decomposed (e.g.
+ *  because a connected component is flat), in which case the mesh should be used as it is. */
+std::vector<shapes::ShapeConstPtr> decomposeMesh(const shapes::Mesh& mesh, const ConvexDecompositionOptions& options);
+
+/** @class ConvexDecompositionCache
+ *  @brief The process-wide store of convex decompositions, keyed by mesh contents.
+ *
+ *  Collision environments look up the decomposition of every mesh they build geometry for, so identical meshes
+ *  share their parts. With a cache directory set, decompositions are also written to and read from files named by
+ *  the hash of the mesh and the options, so an asset is decomposed only once across processes and runs. */
+class ConvexDecompositionCache
+{
+public:
+  static ConvexDecompositionCache& instance();
+
+  /** @brief Replace the options. Parts computed with the previous options are forgotten. */
+  void setOptions(const ConvexDecompositionOptions& options);
+
+  ConvexDecompositionOptions getOptions() const;
+
+  /** @brief Whether meshes should be replaced by their convex parts */
+  bool isEnabled() const;
+
+  /** @brief Get the convex parts of \e mesh, which must be a shapes::Mesh.
+   *
+   *  Returns an empty vector if decomposition is disabled or the mesh can not be decomposed. The returned parts are
+   *  shared by all meshes with the same contents and stay valid until the options change or clear() is called. */
+  std::vector<shapes::ShapeConstPtr> getConvexParts(const shapes::ShapeConstPtr& mesh);
+
+  /** @brief Forget all decompositions held in memory. Files in the cache directory are kept. */
+  void clear();
+
+  /** @brief Compute the hash of the mesh contents identifying its decomposition */
+  static std::uint64_t hashMesh(const shapes::Mesh& mesh);
+
+  /** @brief Read a decomposition stored with save(). Returns false if \e path does not hold the decomposition of a
+   *  mesh with the given hash and size. */
+  static bool load(const std::string& path, std::uint64_t hash, const shapes::Mesh& mesh,
+                   std::vector<shapes::ShapeConstPtr>& parts);
+
+  /** @brief Write \e parts, the decomposition of a mesh with the given hash and size, to \e path */
+  static bool save(const std::string& path, std::uint64_t hash, const shapes::Mesh& mesh,
+                   const std::vector<shapes::ShapeConstPtr>& parts);
+
+private:
+  ConvexDecompositionCache() = default;
+
+  std::string getCachePath(std::uint64_t hash) const;
+
+  mutable std::mutex lock_;
+  ConvexDecompositionOptions options_;
+
+  /** @brief Decompositions by hash of the mesh contents */
+  std::unordered_map<std::uint64_t, std::vector<shapes::ShapeConstPtr>> parts_;
+
+  /** @brief The hash computed for a mesh instance, to avoid hashing the same mesh again */
+  std::map<shapes::ShapeConstWeakPtr, std::uint64_t, std::owner_less<shapes::ShapeConstWeakPtr>> hashes_;
+  std::size_t prune_size_ = 16;
+};
+}  // namespace collision_detection
@@ -38,6 +38,7 @@
 
 #include <octomap/octomap.h>
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <shared_mutex>
@@ -77,6 +78,7 @@ public:
   void lockWrite()
   {
     tree_mutex_.lock();
+    ++version_;
   }
 
   /** @brief unlock the underlying octree. */
@@ -95,11 +97,66 @@ public:
 
   WriteLock writing()
   {
-    return WriteLock(tree_mutex_);
+    WriteLock lock(tree_mutex_);
+    ++version_;
+    return lock;
+  }
+
+  /** @brief Get a counter that is incremented whenever a writer locks the tree. Data derived from the tree can be
+   *  cached as long as the version it was computed for does not change. */
+  std::size_t getVersion() const
+  {
+    return version_;
+  }
+
+  /** @brief Enable or disable double buffering.
+   *
+   *  In double-buffered mode the updaters keep writing into this tree (the back buffer) under the write lock, while
+   *  readers use the immutable copy returned by getSnapshot(). A new copy is published by every call to
+   *  triggerUpdateCallback(), so collision checks never wait for perception updates to finish. The price is one copy of
+   *  the tree per update. */
+  void setDoubleBuffered(bool flag)
+  {
+    double_buffered_ = flag;
+    if (flag)
+    {
+      publishSnapshot();
+    }
+    else
+    {
+      std::atomic_store(&snapshot_, std::shared_ptr<const octomap::OcTree>());
+    }
+  }
+
+  bool isDoubleBuffered() const
+  {
+    return double_buffered_;
+  }
+
+  /** @brief Get the last published copy of the tree. This does not require any lock to be held and the returned tree
+   *  is never modified. Returns nullptr if double buffering is disabled. */
+  std::shared_ptr<const octomap::OcTree> getSnapshot() const
+  {
+    return std::atomic_load(&snapshot_);
+  }
+
+  /** @brief Copy the current contents of the tree into a new snapshot and swap it in. Only writers are blocked while
+   *  the copy is made. Does nothing if double buffering is disabled. */
+  void publishSnapshot()
+  {
+    if (!double_buffered_)
+      return;
+    std::shared_ptr<const octomap::OcTree> snapshot;
+    {
+      ReadLock lock = reading();
+      snapshot = std::make_shared<const octomap::OcTree>(static_cast<const octomap::OcTree&>(*this));
+    }
+    std::atomic_store(&snapshot_, std::move(snapshot));
   }
 
   void triggerUpdateCallback()
   {
+    publishSnapshot();
     if (update_callback_)
       update_callback_();
   }
@@ -113,6 +170,9 @@ public:
 private:
   std::shared_mutex tree_mutex_;
   std::function<void()> update_callback_;
+  std::atomic<std::size_t> version_{ 0 };
+  std::atomic<bool> double_buffered_{ false };
+  std::shared_ptr<const octomap::OcTree> snapshot_;
 };
 
 using OccMapTreePtr = std::shared_ptr<OccMapTree>;
@@ -40,7 +40,11 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <set>
+#include <cstdint>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <Eigen/Geometry>
 #include <eigen_stl_containers/eigen_stl_vector_container.h>
 #include <moveit/transforms/transforms.h>
@@ -52,6 +56,8 @@ MOVEIT_CLASS_FORWARD(Shape);  // Defines ShapePtr, ConstPtr, WeakPtr... etc
 
 namespace collision_detection
 {
+class AABBTree;
+
 MOVEIT_CLASS_FORWARD(World);  // Defines WorldPtr, ConstPtr, WeakPtr... etc
 
 /** \brief Maintain a representation of the environment */
@@ -63,7 +69,7 @@ public:
 
   /** \brief A copy constructor.
    * \e other should not be changed while the copy constructor is running
-   * This does copy on write and should be quick. */
+   * This does copy on write and should be quick: the table of objects is shared until either world is modified. */
   World(const World& other);
 
   virtual ~World();
@@ -127,22 +133,22 @@ public:
   /** iterator pointing to first change */
   const_iterator begin() const
   {
-    return objects_.begin();
+    return objects_->begin();
   }
   /** iterator pointing to end of changes */
   const_iterator end() const
   {
-    return objects_.end();
+    return objects_->end();
   }
   /** number of changes stored */
   std::size_t size() const
   {
-    return objects_.size();
+    return objects_->size();
   }
   /** find changes for a named object */
   const_iterator find(const std::string& object_id) const
   {
-    return objects_.find(object_id);
+    return objects_->find(object_id);
   }
 
   /** \brief Check if a particular object exists in the collision world*/
@@ -217,6 +223,10 @@ public:
   bool moveShapeInObject(const std::string& object_id, const shapes::ShapeConstPtr& shape,
                          const Eigen::Isometry3d& shape_pose);
 
+  /** \brief Notify observers that the contents of the shapes in an object changed in place, e.g. because new sensor
+   * data was integrated into an octree held by the object. Returns false if no such object was found. */
+  bool notifyShapesUpdated(const std::string& object_id);
+
   /** \brief Move the object pose (thus moving all shapes and subframes in the object)
    * according to the given transform specified in world frame.
    * The transform is relative to and changes the object pose. It does not replace it.
@@ -248,6 +258,27 @@ public:
    * the memory is freed. */
   void clearObjects();
 
+  /** \brief Make the objects of this world equal to the objects of \e other, which is typically an earlier copy of
+   * this world. Only objects that differ are replaced, and observers are notified about those only. If \e other is a
+   * copy that is still part of the history of this world (see getChangedObjectIds()), the cost depends on the number of
+   * changes since the copy rather than the number of objects. */
+  void restore(const World& other);
+
+  /** \brief Get the axis-aligned bounding box of an object in the world frame. The box is empty if the object has no
+   * shapes and unbounded if it contains a plane. */
+  static Eigen::AlignedBox3d getObjectBoundingBox(const Object& object);
+
+  /** \brief Get the ids of the objects whose bounding box intersects \e box.
+   * Objects containing a plane are always reported. The bounding boxes are kept in a bounding volume hierarchy that
+   * is built on the first query and then updated with every change, so a query does not visit every object. */
+  std::vector<std::string> queryObjectsInBox(const Eigen::AlignedBox3d& box) const;
+
+  /** \brief Get the ids of the objects whose bounding box, enlarged by \e radius in every direction, is crossed
+   * by the segment from \e start to \e end. This includes every object that comes closer to the segment than
+   * \e radius, and possibly objects that come within sqrt(3) * \e radius of it. @copydetails queryObjectsInBox */
+  std::vector<std::string> queryObjectsNearSegment(const Eigen::Vector3d& start, const Eigen::Vector3d& end,
+                                                   double radius) const;
+
   enum ActionBits
   {
     UNINITIALIZED = 0,
@@ -256,6 +287,7 @@ public:
     MOVE_SHAPE = 4,    /** one or more shapes in object were moved */
     ADD_SHAPE = 8,     /** shape(s) were added to object */
     REMOVE_SHAPE = 16, /** shape(s) were removed from object */
+    UPDATE_SHAPE = 32, /** contents of shape(s) in object were modified in place */
   };
 
   /** \brief Represents an action that occurred on an object in the world.
@@ -313,6 +345,18 @@ public:
    * Used which switching from one world to another. */
   void notifyObserverAllObjects(const ObserverHandle observer_handle, Action action) const;
 
+  /** \brief Get the version of this world. The version changes with every change of an object and is unique among
+   * all worlds, except for copies made by the copy constructor, which start out with the version of the original. */
+  std::uint64_t getVersion() const
+  {
+    return changes_ ? changes_->version : base_version_;
+  }
+
+  /** \brief Add the ids of the objects that changed since this world had version \e version to \e object_ids.
+   * Returns false if \e version is not part of the recent history of this world (because it is too old or belongs to
+   * another world), in which case any object may have changed. */
+  bool getChangedObjectIds(std::uint64_t version, std::set<std::string>& object_ids) const;
+
 private:
   /** notify all observers of a change */
   void notify(const ObjectConstPtr& /*obj*/, Action /*action*/);
@@ -320,11 +364,23 @@ private:
   /** send notification of change to all objects. */
   void notifyAll(Action action);
 
+  /** record a change of the object \e id in the change log */
+  void recordChange(const std::string& id);
+
   /** \brief Make sure that the object named \e id is known only to this
    * instance of the World. If the object is known outside of it, a
    * clone is made so that it can be safely modified later on. */
   void ensureUnique(ObjectPtr& obj);
 
+  using ObjectMap = std::map<std::string, ObjectPtr>;
+
+  /** \brief Get the table of objects for modification, copying it first if it is shared with another World */
+  ObjectMap& getObjectsNonConst();
+
+  /** \brief Find the object named \e object_id for modification. The table of objects is only copied if the object
+   * exists, so the result may be compared to objects_->end() */
+  ObjectMap::iterator findObjectNonConst(const std::string& object_id);
+
   /* Add a shape with no checking */
   virtual void addToObjectInternal(const ObjectPtr& obj, const shapes::ShapeConstPtr& shape,
                                    const Eigen::Isometry3d& shape_pose);
@@ -332,8 +388,8 @@ private:
   /** \brief Updates the global shape and subframe poses. */
   void updateGlobalPosesInternal(ObjectPtr& obj, bool update_shape_poses = true, bool update_subframe_poses = true);
 
-  /** The objects maintained in the world */
-  std::map<std::string, ObjectPtr> objects_;
+  /** The objects maintained in the world, shared with copies of this world until either is modified */
+  std::shared_ptr<ObjectMap> objects_;
 
   /** Wrapper for a callback function to call when something changes in the world */
   class Observer
@@ -347,5 +403,29 @@ private:
 
   /// All registered observers of this world representation
   std::vector<Observer*> observers_;
+
+  /** An entry of the change log, which is shared with copies of this world */
+  struct ChangeRecord
+  {
+    std::uint64_t version;
+    std::string id;
+    std::shared_ptr<const ChangeRecord> previous;
+  };
+
+  /// The most recent change, null if the world did not change since base_version_
+  std::shared_ptr<const ChangeRecord> changes_;
+
+  /// Number of records reachable from changes_
+  std::size_t change_count_;
+
+  /// The version before the oldest recorded change
+  std::uint64_t base_version_;
+
+  /** \brief Build the spatial index if there is none yet. Called with spatial_index_lock_ held */
+  const AABBTree& getSpatialIndex() const;
+
+  /// Bounding boxes of the objects, built on the first query. Copies of this world build their own
+  mutable std::unique_ptr<AABBTree> spatial_index_;
+  mutable std::mutex spatial_index_lock_;
 };
 }  // namespace collision_detection
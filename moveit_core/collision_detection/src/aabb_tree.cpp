@@ -0,0 +1,346 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/collision_detection/aabb_tree.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace collision_detection
+{
+namespace
+{
+double surfaceArea(const Eigen::AlignedBox3d& box)
+{
+  const Eigen::Vector3d d = box.sizes();
+  return 2.0 * (d.x() * d.y() + d.y() * d.z() + d.z() * d.x());
+}
+
+bool isBounded(const Eigen::AlignedBox3d& box)
+{
+  return box.min().allFinite() && box.max().allFinite();
+}
+
+/** Whether the segment start + t * delta, t in [0, 1], crosses the box */
+bool segmentIntersectsBox(const Eigen::Vector3d& start, const Eigen::Vector3d& delta, const Eigen::AlignedBox3d& box)
+{
+  double t_min = 0.0;
+  double t_max = 1.0;
+  for (int i = 0; i < 3; ++i)
+  {
+    if (std::fabs(delta[i]) < std::numeric_limits<double>::epsilon())
+    {
+      if (start[i] < box.min()[i] || start[i] > box.max()[i])
+        return false;
+      continue;
+    }
+    double t1 = (box.min()[i] - start[i]) / delta[i];
+    double t2 = (box.max()[i] - start[i]) / delta[i];
+    if (t1 > t2)
+      std::swap(t1, t2);
+    t_min = std::max(t_min, t1);
+    t_max = std::min(t_max, t2);
+    if (t_min > t_max)
+      return false;
+  }
+  return true;
+}
+}  // namespace
+
+void AABBTree::update(const std::string& id, const Eigen::AlignedBox3d& box)
+{
+  if (box.isEmpty())
+  {
+    remove(id);
+    return;
+  }
+  if (!isBounded(box))
+  {
+    remove(id);
+    unbounded_.insert(id);
+    return;
+  }
+  unbounded_.erase(id);
+
+  auto it = leaves_.find(id);
+  if (it != leaves_.end())
+  {
+    Node& node = nodes_[it->second];
+    node.tight = box;
+    // small motions stay within the enlarged box and do not touch the tree
+    if (node.box.contains(box))
+      return;
+    removeLeaf(it->second);
+    nodes_[it->second].box = Eigen::AlignedBox3d(box.min().array() - MARGIN, box.max().array() + MARGIN);
+    insertLeaf(it->second);
+    return;
+  }
+
+  const int leaf = allocateNode();
+  Node& node = nodes_[leaf];
+  node.id = id;
+  node.tight = box;
+  node.box = Eigen::AlignedBox3d(box.min().array() - MARGIN, box.max().array() + MARGIN);
+  leaves_[id] = leaf;
+  insertLeaf(leaf);
+}
+
+bool AABBTree::remove(const std::string& id)
+{
+  if (unbounded_.erase(id))
+    return true;
+  auto it = leaves_.find(id);
+  if (it == leaves_.end())
+    return false;
+  removeLeaf(it->second);
+  freeNode(it->second);
+  leaves_.erase(it);
+  return true;
+}
+
+void AABBTree::clear()
+{
+  nodes_.clear();
+  free_nodes_.clear();
+  root_ = -1;
+  leaves_.clear();
+  unbounded_.clear();
+}
+
+int AABBTree::allocateNode()
+{
+  if (free_nodes_.empty())
+  {
+    nodes_.emplace_back();
+    return static_cast<int>(nodes_.size()) - 1;
+  }
+  const int index = free_nodes_.back();
+  free_nodes_.pop_back();
+  nodes_[index] = Node();
+  return index;
+}
+
+void AABBTree::freeNode(int index)
+{
+  nodes_[index].id.clear();
+  free_nodes_.push_back(index);
+}
+
+void AABBTree::insertLeaf(int leaf)
+{
+  nodes_[leaf].parent = -1;
+  if (root_ < 0)
+  {
+    root_ = leaf;
+    return;
+  }
+
+  // descend towards the sibling that increases the surface area of the hierarchy the least
+  const Eigen::AlignedBox3d box = nodes_[leaf].box;
+  int index = root_;
+  while (!nodes_[index].isLeaf())
+  {
+    const Node& node = nodes_[index];
+    const double area = surfaceArea(node.box);
+    const double combined_area = surfaceArea(node.box.merged(box));
+
+    // cost of making a new parent for this node and the leaf, and the cost pushed down to the children
+    const double cost = 2.0 * combined_area;
+    const double inheritance_cost = 2.0 * (combined_area - area);
+
+    const auto child_cost = [&](int child) {
+      const Node& c = nodes_[child];
+      const double merged_area = surfaceArea(c.box.merged(box));
+      return (c.isLeaf() ? merged_area : merged_area - surfaceArea(c.box)) + inheritance_cost;
+    };
+    const double left_cost = child_cost(node.left);
+    const double right_cost = child_cost(node.right);
+
+    if (cost < left_cost && cost < right_cost)
+      break;
+    index = left_cost < right_cost ? node.left : node.right;
+  }
+
+  const int sibling = index;
+  const int old_parent = nodes_[sibling].parent;
+  const int new_parent = allocateNode();
+  Node& parent = nodes_[new_parent];
+  parent.parent = old_parent;
+  parent.box = box.merged(nodes_[sibling].box);
+  parent.height = nodes_[sibling].height + 1;
+  parent.left = sibling;
+  parent.right = leaf;
+  nodes_[sibling].parent = new_parent;
+  nodes_[leaf].parent = new_parent;
+
+  if (old_parent < 0)
+    root_ = new_parent;
+  else if (nodes_[old_parent].left == sibling)
+    nodes_[old_parent].left = new_parent;
+  else
+    nodes_[old_parent].right = new_parent;
+
+  refit(old_parent);
+}
+
+void AABBTree::removeLeaf(int leaf)
+{
+  if (leaf == root_)
+  {
+    root_ = -1;
+    return;
+  }
+
+  const int parent = nodes_[leaf].parent;
+  const int grand_parent = nodes_[parent].parent;
+  const int sibling = nodes_[parent].left == leaf ? nodes_[parent].right : nodes_[parent].left;
+
+  nodes_[sibling].parent = grand_parent;
+  if (grand_parent < 0)
+    root_ = sibling;
+  else if (nodes_[grand_parent].left == parent)
+    nodes_[grand_parent].left = sibling;
+  else
+    nodes_[grand_parent].right = sibling;
+  freeNode(parent);
+  nodes_[leaf].parent = -1;
+
+  refit(grand_parent);
+}
+
+void AABBTree::refit(int index)
+{
+  while (index >= 0)
+  {
+    index = balance(index);
+    Node& node = nodes_[index];
+    const Node& left = nodes_[node.left];
+    const Node& right = nodes_[node.right];
+    node.box = left.box.merged(right.box);
+    node.height = 1 + std::max(left.height, right.height);
+    index = node.parent;
+  }
+}
+
+int AABBTree::balance(int a)
+{
+  if (nodes_[a].isLeaf() || nodes_[a].height < 2)
+    return a;
+
+  const int b = nodes_[a].left;
+  const int c = nodes_[a].right;
+  const int difference = nodes_[c].height - nodes_[b].height;
+  if (difference >= -1 && difference <= 1)
+    return a;
+
+  // lift the taller child x in place of a; a keeps the shorter child and the shorter grandchild of x
+  const int x = difference > 1 ? c : b;
+  const int kept = difference > 1 ? b : c;
+  int tall = nodes_[x].left;
+  int small = nodes_[x].right;
+  if (nodes_[tall].height < nodes_[small].height)
+    std::swap(tall, small);
+
+  nodes_[x].parent = nodes_[a].parent;
+  if (nodes_[x].parent < 0)
+    root_ = x;
+  else if (nodes_[nodes_[x].parent].left == a)
+    nodes_[nodes_[x].parent].left = x;
+  else
+    nodes_[nodes_[x].parent].right = x;
+
+  nodes_[x].left = a;
+  nodes_[x].right = tall;
+  nodes_[a].parent = x;
+  nodes_[a].left = kept;
+  nodes_[a].right = small;
+  nodes_[small].parent = a;
+
+  nodes_[a].box = nodes_[kept].box.merged(nodes_[small].box);
+  nodes_[a].height = 1 + std::max(nodes_[kept].height, nodes_[small].height);
+  nodes_[x].box = nodes_[a].box.merged(nodes_[tall].box);
+  nodes_[x].height = 1 + std::max(nodes_[a].height, nodes_[tall].height);
+  return x;
+}
+
+template <typename Test>
+void AABBTree::traverse(const Test& test, std::vector<std::string>& ids) const
+{
+  ids.insert(ids.end(), unbounded_.begin(), unbounded_.end());
+  if (root_ < 0)
+    return;
+
+  std::vector<int> stack;
+  stack.reserve(2 * (nodes_[root_].height + 1));
+  stack.push_back(root_);
+  while (!stack.empty())
+  {
+    const Node& node = nodes_[stack.back()];
+    stack.pop_back();
+    if (!test(node.box))
+      continue;
+    if (node.isLeaf())
+    {
+      if (test(node.tight))
+        ids.push_back(node.id);
+    }
+    else
+    {
+      stack.push_back(node.left);
+      stack.push_back(node.right);
+    }
+  }
+}
+
+void AABBTree::query(const Eigen::AlignedBox3d& box, std::vector<std::string>& ids) const
+{
+  if (box.isEmpty())
+    return;
+  traverse([&box](const Eigen::AlignedBox3d& node_box) { return node_box.intersects(box); }, ids);
+}
+
+void AABBTree::querySegment(const Eigen::Vector3d& start, const Eigen::Vector3d& end, double radius,
+                            std::vector<std::string>& ids) const
+{
+  const Eigen::Vector3d delta = end - start;
+  radius = std::max(radius, 0.0);
+  traverse(
+      [&](const Eigen::AlignedBox3d& node_box) {
+        return segmentIntersectsBox(
+            start, delta, Eigen::AlignedBox3d(node_box.min().array() - radius, node_box.max().array() + radius));
+      },
+      ids);
+}
+
+}  // namespace collision_detection
@@ -35,8 +35,11 @@
 /* Author: Ioan Sucan, Jens Petit */
 
 #include <moveit/collision_detection/collision_env.h>
+#include <moveit/utils/task_scheduler.h>
 #include <rclcpp/logger.hpp>
 #include <rclcpp/logging.hpp>
+#include <algorithm>
+#include <cmath>
 #include <limits>
 
 // Logger
@@ -88,6 +91,7 @@ CollisionEnv::CollisionEnv(const moveit::core::RobotModelConstPtr& model, double
     link_padding_[link->getName()] = padding;
     link_scale_[link->getName()] = scale;
   }
+  updateLinkBoundingSphereRadii();
 }
 
 CollisionEnv::CollisionEnv(const moveit::core::RobotModelConstPtr& model, const WorldPtr& world, double padding,
@@ -105,6 +109,7 @@ CollisionEnv::CollisionEnv(const moveit::core::RobotModelConstPtr& model, const
     link_padding_[link->getName()] = padding;
     link_scale_[link->getName()] = scale;
   }
+  updateLinkBoundingSphereRadii();
 }
 
 CollisionEnv::CollisionEnv(const CollisionEnv& other, const WorldPtr& world)
@@ -112,6 +117,7 @@ CollisionEnv::CollisionEnv(const CollisionEnv& other, const WorldPtr& world)
 {
   link_padding_ = other.link_padding_;
   link_scale_ = other.link_scale_;
+  link_bounding_sphere_radius_ = other.link_bounding_sphere_radius_;
 }
 void CollisionEnv::setPadding(const double padding)
 {
@@ -126,7 +132,10 @@ void CollisionEnv::setPadding(const double padding)
     link_padding_[link->getName()] = padding;
   }
   if (!u.empty())
+  {
+    updateLinkBoundingSphereRadii();
     updatedPaddingOrScaling(u);
+  }
 }
 
 void CollisionEnv::setScale(const double scale)
@@ -142,7 +151,10 @@ void CollisionEnv::setScale(const double scale)
     link_scale_[link->getName()] = scale;
   }
   if (!u.empty())
+  {
+    updateLinkBoundingSphereRadii();
     updatedPaddingOrScaling(u);
+  }
 }
 
 void CollisionEnv::setLinkPadding(const std::string& link_name, const double padding)
@@ -152,6 +164,7 @@ void CollisionEnv::setLinkPadding(const std::string& link_name, const double pad
   link_padding_[link_name] = padding;
   if (update)
   {
+    updateLinkBoundingSphereRadii();
     std::vector<std::string> u(1, link_name);
     updatedPaddingOrScaling(u);
   }
@@ -178,7 +191,10 @@ void CollisionEnv::setLinkPadding(const std::map<std::string, double>& padding)
       u.push_back(link_pad_pair.first);
   }
   if (!u.empty())
+  {
+    updateLinkBoundingSphereRadii();
     updatedPaddingOrScaling(u);
+  }
 }
 
 const std::map<std::string, double>& CollisionEnv::getLinkPadding() const
@@ -193,6 +209,7 @@ void CollisionEnv::setLinkScale(const std::string& link_name, const double scale
   link_scale_[link_name] = scale;
   if (update)
   {
+    updateLinkBoundingSphereRadii();
     std::vector<std::string> u(1, link_name);
     updatedPaddingOrScaling(u);
   }
@@ -218,7 +235,10 @@ void CollisionEnv::setLinkScale(const std::map<std::string, double>& scale)
       u.push_back(link_scale_pair.first);
   }
   if (!u.empty())
+  {
+    updateLinkBoundingSphereRadii();
     updatedPaddingOrScaling(u);
+  }
 }
 
 const std::map<std::string, double>& CollisionEnv::getLinkScale() const
@@ -238,7 +258,10 @@ void CollisionEnv::setPadding(const std::vector<moveit_msgs::msg::LinkPadding>&
       u.push_back(p.link_name);
   }
   if (!u.empty())
+  {
+    updateLinkBoundingSphereRadii();
     updatedPaddingOrScaling(u);
+  }
 }
 
 void CollisionEnv::setScale(const std::vector<moveit_msgs::msg::LinkScale>& scale)
@@ -253,7 +276,10 @@ void CollisionEnv::setScale(const std::vector<moveit_msgs::msg::LinkScale>& scal
       u.push_back(s.link_name);
   }
   if (!u.empty())
+  {
+    updateLinkBoundingSphereRadii();
     updatedPaddingOrScaling(u);
+  }
 }
 
 void CollisionEnv::getPadding(std::vector<moveit_msgs::msg::LinkPadding>& padding) const
@@ -284,6 +310,51 @@ void CollisionEnv::updatedPaddingOrScaling(const std::vector<std::string>& /*lin
 {
 }
 
+void CollisionEnv::updateLinkBoundingSphereRadii()
+{
+  link_bounding_sphere_radius_.assign(robot_model_->getLinkModelCount(), 0.0);
+  for (const moveit::core::LinkModel* link : robot_model_->getLinkModelsWithCollisionGeometry())
+  {
+    // Shapes are scaled about their own origin (meshes about their centroid), which lies inside the bounding sphere,
+    // so a point of a scaled shape can move away from the sphere center by at most |scale - 1| * radius.
+    const double scale = getLinkScale(link->getName());
+    link_bounding_sphere_radius_[link->getLinkIndex()] =
+        (scale + std::fabs(scale - 1.0)) * link->getBoundingSphereRadius() + getLinkPadding(link->getName());
+  }
+}
+
+bool CollisionEnv::areLinkBoundingSpheresSeparated(const moveit::core::RobotState& state,
+                                                   const AllowedCollisionMatrix* acm, double margin) const
+{
+  std::vector<const moveit::core::AttachedBody*> attached_bodies;
+  state.getAttachedBodies(attached_bodies);
+  if (!attached_bodies.empty())
+    return false;
+
+  const std::vector<const moveit::core::LinkModel*>& links = robot_model_->getLinkModelsWithCollisionGeometry();
+  EigenSTL::vector_Vector3d centers(links.size());
+  for (std::size_t i = 0; i < links.size(); ++i)
+    centers[i] = state.getGlobalLinkTransform(links[i]) * links[i]->getCenteredBoundingBoxOffset();
+
+  const IndexedAllowedCollisionMatrixConstPtr indexed_acm =
+      acm ? acm->getIndexedLinkMatrix(*robot_model_) : IndexedAllowedCollisionMatrixConstPtr();
+  for (std::size_t i = 0; i < links.size(); ++i)
+  {
+    const std::size_t index1 = links[i]->getLinkIndex();
+    for (std::size_t j = i + 1; j < links.size(); ++j)
+    {
+      const std::size_t index2 = links[j]->getLinkIndex();
+      AllowedCollision::Type type;
+      if (indexed_acm && indexed_acm->getAllowedCollision(index1, index2, type) && type == AllowedCollision::ALWAYS)
+        continue;
+      const double reach = link_bounding_sphere_radius_[index1] + link_bounding_sphere_radius_[index2] + margin;
+      if ((centers[i] - centers[j]).squaredNorm() <= reach * reach)
+        return false;
+    }
+  }
+  return true;
+}
+
 void CollisionEnv::setWorld(const WorldPtr& world)
 {
   world_ = world;
@@ -308,4 +379,31 @@ void CollisionEnv::checkCollision(const CollisionRequest& req, CollisionResult&
   if (!res.collision || (req.contacts && res.contacts.size() < req.max_contacts))
     checkRobotCollision(req, res, state, acm);
 }
+
+void CollisionEnv::checkCollisionBatch(const CollisionRequest& req, std::vector<CollisionResult>& res,
+                                       const std::vector<const moveit::core::RobotState*>& states,
+                                       const AllowedCollisionMatrix& acm) const
+{
+  res.resize(states.size());
+  for (std::size_t i = 0; i < states.size(); ++i)
+  {
+    res[i].clear();
+    checkCollision(req, res[i], *states[i], acm);
+  }
+}
+
+std::size_t CollisionEnv::getBatchThreadCount(std::size_t count)
+{
+  // handing states to the workers costs about as much as a few collision checks
+  static const std::size_t MIN_STATES_PER_THREAD = 4;
+  // the calling thread takes part as well
+  const std::size_t participants = moveit::scheduling::getTaskScheduler().getThreadCount() + 1;
+  return std::max<std::size_t>(1, std::min(participants, count / MIN_STATES_PER_THREAD));
+}
+
+void CollisionEnv::forEachInBatch(std::size_t count, const std::function<void(std::size_t, std::size_t)>& check)
+{
+  moveit::scheduling::getTaskScheduler().parallelFor(count, getBatchThreadCount(count),
+                                                     moveit::scheduling::TaskPriority::PLANNING, check);
+}
 }  // end of namespace collision_detection
@@ -37,8 +37,10 @@
 #include <moveit/collision_detection/collision_matrix.h>
 #include <rclcpp/logger.hpp>
 #include <rclcpp/logging.hpp>
+#include <atomic>
 #include <functional>
 #include <iomanip>
+#include <unordered_map>
 
 namespace collision_detection
 {
@@ -121,8 +123,8 @@ bool AllowedCollisionMatrix::getEntry(const std::string& name1, const std::strin
   const auto it1 = entries_.find(name1);
   if (it1 == entries_.end())
     return false;
-  auto it2 = it1->second.find(name2);
-  if (it2 == it1->second.end())
+  auto it2 = it1->second->find(name2);
+  if (it2 == it1->second->end())
     return false;
   allowed_collision = it2->second;
   return true;
@@ -138,14 +140,31 @@ bool AllowedCollisionMatrix::hasEntry(const std::string& name1, const std::strin
   const auto it1 = entries_.find(name1);
   if (it1 == entries_.end())
     return false;
-  const auto it2 = it1->second.find(name2);
-  return it2 != it1->second.end();
+  const auto it2 = it1->second->find(name2);
+  return it2 != it1->second->end();
+}
+
+AllowedCollisionMatrix::EntryRow& AllowedCollisionMatrix::getEntryRowNonConst(const std::string& name)
+{
+  std::shared_ptr<EntryRow>& row = entries_[name];
+  if (!row)
+    row = std::make_shared<EntryRow>();
+  return ensureUnique(row);
+}
+
+AllowedCollisionMatrix::EntryRow& AllowedCollisionMatrix::ensureUnique(std::shared_ptr<EntryRow>& row)
+{
+  if (row.use_count() > 1)
+    row = std::make_shared<EntryRow>(*row);
+  return *row;
 }
 
 void AllowedCollisionMatrix::setEntry(const std::string& name1, const std::string& name2, const bool allowed)
 {
+  invalidateIndexedLinkMatrix();
   const AllowedCollision::Type v = allowed ? AllowedCollision::ALWAYS : AllowedCollision::NEVER;
-  entries_[name1][name2] = entries_[name2][name1] = v;
+  getEntryRowNonConst(name1)[name2] = v;
+  getEntryRowNonConst(name2)[name1] = v;
 
   // remove function pointers, if any
   auto it = allowed_contacts_.find(name1);
@@ -166,36 +185,33 @@ void AllowedCollisionMatrix::setEntry(const std::string& name1, const std::strin
 
 void AllowedCollisionMatrix::setEntry(const std::string& name1, const std::string& name2, DecideContactFn& fn)
 {
-  entries_[name1][name2] = entries_[name2][name1] = AllowedCollision::CONDITIONAL;
+  invalidateIndexedLinkMatrix();
+  getEntryRowNonConst(name1)[name2] = AllowedCollision::CONDITIONAL;
+  getEntryRowNonConst(name2)[name1] = AllowedCollision::CONDITIONAL;
   allowed_contacts_[name1][name2] = allowed_contacts_[name2][name1] = fn;
 }
 
 void AllowedCollisionMatrix::removeEntry(const std::string& name)
 {
+  invalidateIndexedLinkMatrix();
   entries_.erase(name);
   allowed_contacts_.erase(name);
   for (auto& entry : entries_)
-    entry.second.erase(name);
+    if (entry.second->count(name))
+      ensureUnique(entry.second).erase(name);
   for (auto& allowed_contact : allowed_contacts_)
     allowed_contact.second.erase(name);
 }
 
 void AllowedCollisionMatrix::removeEntry(const std::string& name1, const std::string& name2)
 {
+  invalidateIndexedLinkMatrix();
   auto jt = entries_.find(name1);
-  if (jt != entries_.end())
-  {
-    auto it = jt->second.find(name2);
-    if (it != jt->second.end())
-      jt->second.erase(it);
-  }
+  if (jt != entries_.end() && jt->second->count(name2))
+    ensureUnique(jt->second).erase(name2);
   jt = entries_.find(name2);
-  if (jt != entries_.end())
-  {
-    auto it = jt->second.find(name1);
-    if (it != jt->second.end())
-      jt->second.erase(it);
-  }
+  if (jt != entries_.end() && jt->second->count(name1))
+    ensureUnique(jt->second).erase(name1);
 
   auto it = allowed_contacts_.find(name1);
   if (it != allowed_contacts_.end())
@@ -241,14 +257,16 @@ void AllowedCollisionMatrix::setEntry(const std::string& name, const bool allowe
 
 void AllowedCollisionMatrix::setEntry(const bool allowed)
 {
+  invalidateIndexedLinkMatrix();
   const AllowedCollision::Type v = allowed ? AllowedCollision::ALWAYS : AllowedCollision::NEVER;
   for (auto& entry : entries_)
-    for (auto& it2 : entry.second)
+    for (auto& it2 : ensureUnique(entry.second))
       it2.second = v;
 }
 
 void AllowedCollisionMatrix::setDefaultEntry(const std::string& name, const bool allowed)
 {
+  invalidateIndexedLinkMatrix();
   const AllowedCollision::Type v = allowed ? AllowedCollision::ALWAYS : AllowedCollision::NEVER;
   default_entries_[name] = v;
   default_allowed_contacts_.erase(name);
@@ -256,6 +274,7 @@ void AllowedCollisionMatrix::setDefaultEntry(const std::string& name, const bool
 
 void AllowedCollisionMatrix::setDefaultEntry(const std::string& name, DecideContactFn& fn)
 {
+  invalidateIndexedLinkMatrix();
   default_entries_[name] = AllowedCollision::CONDITIONAL;
   default_allowed_contacts_[name] = fn;
 }
@@ -310,6 +329,12 @@ bool AllowedCollisionMatrix::getDefaultEntry(const std::string& name1, const std
   AllowedCollision::Type t1, t2;
   const bool found1 = getDefaultEntry(name1, t1);
   const bool found2 = getDefaultEntry(name2, t2);
+  return combineDefaultEntries(found1, t1, found2, t2, allowed_collision);
+}
+
+bool AllowedCollisionMatrix::combineDefaultEntries(bool found1, AllowedCollision::Type t1, bool found2,
+                                                   AllowedCollision::Type t2, AllowedCollision::Type& allowed_collision)
+{
   if (!found1 && !found2)
     return false;
   else if (found1 && !found2)
@@ -336,6 +361,7 @@ bool AllowedCollisionMatrix::getAllowedCollision(const std::string& name1, const
 
 void AllowedCollisionMatrix::clear()
 {
+  invalidateIndexedLinkMatrix();
   entries_.clear();
   allowed_contacts_.clear();
   default_entries_.clear();
@@ -390,6 +416,66 @@ void AllowedCollisionMatrix::getMessage(moveit_msgs::msg::AllowedCollisionMatrix
   }
 }
 
+IndexedAllowedCollisionMatrixConstPtr
+AllowedCollisionMatrix::getIndexedLinkMatrix(const moveit::core::RobotModel& robot_model) const
+{
+  IndexedAllowedCollisionMatrixConstPtr indexed = std::atomic_load(&indexed_links_);
+  if (indexed && indexed->robot_model_ == &robot_model && indexed->getSize() == robot_model.getLinkModelCount())
+    return indexed;
+
+  // concurrent callers may build the table at the same time; they all build the same one
+  auto links = std::make_shared<IndexedAllowedCollisionMatrix>(*this, robot_model.getLinkModelNames());
+  links->robot_model_ = &robot_model;
+  std::atomic_store(&indexed_links_, IndexedAllowedCollisionMatrixConstPtr(links));
+  return links;
+}
+
+void AllowedCollisionMatrix::invalidateIndexedLinkMatrix()
+{
+  std::atomic_store(&indexed_links_, IndexedAllowedCollisionMatrixConstPtr());
+  version_ = nextVersion();
+}
+
+std::uint64_t AllowedCollisionMatrix::nextVersion()
+{
+  static std::atomic<std::uint64_t> counter(0);
+  return ++counter;
+}
+
+IndexedAllowedCollisionMatrix::IndexedAllowedCollisionMatrix(const AllowedCollisionMatrix& acm,
+                                                             const std::vector<std::string>& names)
+  : size_(names.size()), entries_(names.size() * names.size(), NO_ENTRY)
+{
+  // resolve the defaults of every name once and combine them for all pairs
+  std::vector<AllowedCollision::Type> defaults(size_, AllowedCollision::NEVER);
+  std::vector<bool> has_default(size_);
+  std::unordered_map<std::string, std::size_t> indices;
+  for (std::size_t i = 0; i < size_; ++i)
+  {
+    has_default[i] = acm.getDefaultEntry(names[i], defaults[i]);
+    indices[names[i]] = i;
+  }
+  AllowedCollision::Type type;
+  for (std::size_t i = 0; i < size_; ++i)
+    for (std::size_t j = 0; j < size_; ++j)
+      if (AllowedCollisionMatrix::combineDefaultEntries(has_default[i], defaults[i], has_default[j], defaults[j], type))
+        entries_[i * size_ + j] = static_cast<unsigned char>(type);
+
+  // explicit entries take precedence over defaults
+  for (const auto& row : acm.entries_)
+  {
+    auto i = indices.find(row.first);
+    if (i == indices.end())
+      continue;
+    for (const auto& entry : *row.second)
+    {
+      auto j = indices.find(entry.first);
+      if (j != indices.end())
+        entries_[i->second * size_ + j->second] = static_cast<unsigned char>(entry.second);
+    }
+  }
+}
+
 void AllowedCollisionMatrix::print(std::ostream& out) const
 {
   std::vector<std::string> names;
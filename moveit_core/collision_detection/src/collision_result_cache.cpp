@@ -0,0 +1,196 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/collision_detection/collision_result_cache.h>
+#include <rclcpp/logger.hpp>
+#include <rclcpp/logging.hpp>
+#include <cmath>
+#include <functional>
+#include <utility>
+
+namespace collision_detection
+{
+// Logger
+static const rclcpp::Logger LOGGER = rclcpp::get_logger("moveit_collision_detection.collision_result_cache");
+
+CollisionResultCache::CollisionResultCache(std::size_t capacity, double resolution, const WorldPtr& world)
+  : capacity_(capacity)
+  , shard_capacity_((capacity + SHARD_COUNT - 1) / SHARD_COUNT)
+  , resolution_(resolution)
+  , hits_(0)
+  , misses_(0)
+  , world_(world)
+{
+  if (!(resolution_ > 0.0) || !std::isfinite(resolution_))
+  {
+    RCLCPP_ERROR(LOGGER, "Resolution must be positive and finite, using %g instead", DEFAULT_RESOLUTION);
+    resolution_ = DEFAULT_RESOLUTION;
+  }
+  if (world_)
+    observer_handle_ = world_->addObserver([this](const World::ObjectConstPtr& /*object*/, World::Action /*action*/) {
+      clear();
+    });
+}
+
+CollisionResultCache::~CollisionResultCache()
+{
+  if (world_)
+    world_->removeObserver(observer_handle_);
+}
+
+bool CollisionResultCache::isCacheable(const CollisionRequest& req)
+{
+  return !req.contacts && !req.distance && !req.cost && !req.verbose && !req.is_done;
+}
+
+CollisionResultCache::Key CollisionResultCache::makeKey(const moveit::core::JointModelGroup* group,
+                                                        const moveit::core::RobotState& state,
+                                                        const AllowedCollisionMatrix& acm) const
+{
+  Key key;
+  key.group = group;
+  key.acm_version = acm.getVersion();
+  const double* positions = state.getVariablePositions();
+  if (group)
+  {
+    const std::vector<int>& indices = group->getVariableIndexList();
+    key.values.reserve(indices.size());
+    for (int index : indices)
+      key.values.push_back(std::llround(positions[index] / resolution_));
+  }
+  else
+  {
+    key.values.reserve(state.getVariableCount());
+    for (std::size_t i = 0; i < state.getVariableCount(); ++i)
+      key.values.push_back(std::llround(positions[i] / resolution_));
+  }
+
+  std::size_t hash = std::hash<std::uint64_t>()(key.acm_version) ^ std::hash<const void*>()(group);
+  for (std::int64_t value : key.values)
+    hash ^= std::hash<std::int64_t>()(value) + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+  key.hash = hash;
+  return key;
+}
+
+bool CollisionResultCache::lookup(const moveit::core::JointModelGroup* group, const moveit::core::RobotState& state,
+                                  const AllowedCollisionMatrix& acm, bool& collision) const
+{
+  return find(makeKey(group, state, acm), collision);
+}
+
+void CollisionResultCache::insert(const moveit::core::JointModelGroup* group, const moveit::core::RobotState& state,
+                                  const AllowedCollisionMatrix& acm, bool collision)
+{
+  store(makeKey(group, state, acm), collision);
+}
+
+bool CollisionResultCache::find(const Key& key, bool& collision) const
+{
+  Shard& shard = getShard(key);
+  {
+    std::lock_guard<std::mutex> slock(shard.lock);
+    auto it = shard.entries.find(key);
+    if (it != shard.entries.end())
+    {
+      collision = it->second;
+      ++hits_;
+      return true;
+    }
+  }
+  ++misses_;
+  return false;
+}
+
+void CollisionResultCache::store(Key&& key, bool collision)
+{
+  if (capacity_ == 0)
+    return;
+  Shard& shard = getShard(key);
+  std::lock_guard<std::mutex> slock(shard.lock);
+  if (shard.entries.size() >= shard_capacity_ && shard.entries.find(key) == shard.entries.end())
+    shard.entries.erase(shard.entries.begin());
+  shard.entries[std::move(key)] = collision;
+}
+
+void CollisionResultCache::checkCollision(const CollisionEnv& env, const CollisionRequest& req, CollisionResult& res,
+                                          const moveit::core::RobotState& state, const AllowedCollisionMatrix& acm)
+{
+  if (!isCacheable(req))
+  {
+    env.checkCollision(req, res, state, acm);
+    return;
+  }
+
+  const moveit::core::JointModelGroup* group =
+      req.group_name.empty() ? nullptr : env.getRobotModel()->getJointModelGroup(req.group_name);
+  Key key = makeKey(group, state, acm);
+  bool collision;
+  if (find(key, collision))
+  {
+    res.collision = res.collision || collision;
+    return;
+  }
+
+  CollisionResult local_res;
+  env.checkCollision(req, local_res, state, acm);
+  store(std::move(key), local_res.collision);
+  res.collision = res.collision || local_res.collision;
+}
+
+void CollisionResultCache::clear()
+{
+  for (Shard& shard : shards_)
+  {
+    std::lock_guard<std::mutex> slock(shard.lock);
+    shard.entries.clear();
+  }
+}
+
+std::size_t CollisionResultCache::size() const
+{
+  std::size_t count = 0;
+  for (Shard& shard : shards_)
+  {
+    std::lock_guard<std::mutex> slock(shard.lock);
+    count += shard.entries.size();
+  }
+  return count;
+}
+
+void CollisionResultCache::resetCounters()
+{
+  hits_ = 0;
+  misses_ = 0;
+}
+}  // namespace collision_detection
@@ -0,0 +1,607 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/collision_detection/convex_decomposition.h>
+#include <geometric_shapes/bodies.h>
+#include <rclcpp/logger.hpp>
+#include <rclcpp/logging.hpp>
+#include <Eigen/Core>
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <sstream>
+
+namespace collision_detection
+{
+namespace
+{
+const rclcpp::Logger LOGGER = rclcpp::get_logger("moveit_collision_detection.convex_decomposition");
+
+// identifies the file type, followed by the format version and the sizes of the stored types
+constexpr char MAGIC[8] = { 'M', 'V', 'T', 'C', 'O', 'N', 'V', '\0' };
+constexpr std::uint32_t FORMAT_VERSION = 1;
+
+template <typename T>
+void write(std::ostream& out, const T& value)
+{
+  out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+void writeArray(std::ostream& out, const T* values, std::size_t count)
+{
+  out.write(reinterpret_cast<const char*>(values), sizeof(T) * count);
+}
+
+// Reads from a buffer holding the whole file; all reads fail once the end is exceeded
+class Reader
+{
+public:
+  Reader(const std::string& buffer) : data_(buffer.data()), remaining_(buffer.size())
+  {
+  }
+
+  template <typename T>
+  bool read(T& value)
+  {
+    return readArray(&value, 1);
+  }
+
+  template <typename T>
+  bool readArray(T* values, std::size_t count)
+  {
+    const std::size_t bytes = sizeof(T) * count;
+    if (count > remaining_ / sizeof(T))
+      return false;
+    std::memcpy(values, data_, bytes);
+    data_ += bytes;
+    remaining_ -= bytes;
+    return true;
+  }
+
+private:
+  const char* data_;
+  std::size_t remaining_;
+};
+
+// FNV-1a, which unlike std::hash is the same in every process
+std::uint64_t hashBytes(const void* data, std::size_t size, std::uint64_t hash = 14695981039346656037ull)
+{
+  const unsigned char* bytes = static_cast<const unsigned char*>(data);
+  for (std::size_t i = 0; i < size; ++i)
+  {
+    hash ^= bytes[i];
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+// The vertices and triangles of a mesh with vertices at identical positions merged
+struct WeldedMesh
+{
+  EigenSTL::vector_Vector3d vertices;
+  std::vector<std::array<unsigned int, 3>> triangles;
+};
+
+WeldedMesh weld(const shapes::Mesh& mesh)
+{
+  WeldedMesh welded;
+  std::map<std::array<double, 3>, unsigned int> index;
+  std::vector<unsigned int> remap(mesh.vertex_count);
+  for (unsigned int i = 0; i < mesh.vertex_count; ++i)
+  {
+    const std::array<double, 3> v = { mesh.vertices[3 * i], mesh.vertices[3 * i + 1], mesh.vertices[3 * i + 2] };
+    const auto inserted = index.emplace(v, welded.vertices.size());
+    if (inserted.second)
+      welded.vertices.emplace_back(v[0], v[1], v[2]);
+    remap[i] = inserted.first->second;
+  }
+  welded.triangles.reserve(mesh.triangle_count);
+  for (unsigned int i = 0; i < mesh.triangle_count; ++i)
+    welded.triangles.push_back(
+        { remap[mesh.triangles[3 * i]], remap[mesh.triangles[3 * i + 1]], remap[mesh.triangles[3 * i + 2]] });
+  return welded;
+}
+
+unsigned int findRoot(std::vector<unsigned int>& parent, unsigned int i)
+{
+  while (parent[i] != i)
+  {
+    parent[i] = parent[parent[i]];
+    i = parent[i];
+  }
+  return i;
+}
+
+// Group the triangles by connected component
+std::vector<std::vector<unsigned int>> connectedComponents(const WeldedMesh& mesh)
+{
+  std::vector<unsigned int> parent(mesh.vertices.size());
+  std::iota(parent.begin(), parent.end(), 0);
+  for (const std::array<unsigned int, 3>& t : mesh.triangles)
+  {
+    parent[findRoot(parent, t[1])] = findRoot(parent, t[0]);
+    parent[findRoot(parent, t[2])] = findRoot(parent, t[0]);
+  }
+
+  std::unordered_map<unsigned int, std::size_t> component_of_root;
+  std::vector<std::vector<unsigned int>> components;
+  for (unsigned int i = 0; i < mesh.triangles.size(); ++i)
+  {
+    const unsigned int root = findRoot(parent, mesh.triangles[i][0]);
+    const auto inserted = component_of_root.emplace(root, components.size());
+    if (inserted.second)
+      components.emplace_back();
+    components[inserted.first->second].push_back(i);
+  }
+  return components;
+}
+
+// The vertices used by a set of triangles, as a mesh of those triangles
+shapes::Mesh* extractPart(const WeldedMesh& mesh, const std::vector<unsigned int>& triangles)
+{
+  std::unordered_map<unsigned int, unsigned int> local_index;
+  std::vector<unsigned int> local_triangles;
+  local_triangles.reserve(3 * triangles.size());
+  for (unsigned int t : triangles)
+    for (unsigned int v : mesh.triangles[t])
+      local_triangles.push_back(local_index.emplace(v, local_index.size()).first->second);
+
+  auto part = new shapes::Mesh(local_index.size(), triangles.size());
+  for (const auto& entry : local_index)
+  {
+    const Eigen::Vector3d& v = mesh.vertices[entry.first];
+    std::copy(v.data(), v.data() + 3, part->vertices + 3 * entry.second);
+  }
+  std::copy(local_triangles.begin(), local_triangles.end(), part->triangles);
+  return part;
+}
+
+// The convex hull of a part, or nullptr if the part is flat
+std::shared_ptr<shapes::Mesh> computeHull(const shapes::Mesh& part)
+{
+  if (part.vertex_count < 4)
+    return nullptr;
+  const bodies::ConvexMesh hull(&part);
+  const std::vector<unsigned int>& triangles = hull.getTriangles();
+  const EigenSTL::vector_Vector3d& vertices = hull.getVertices();
+  if (triangles.empty() || vertices.empty())
+    return nullptr;
+
+  auto mesh = std::make_shared<shapes::Mesh>(vertices.size(), triangles.size() / 3);
+  for (std::size_t i = 0; i < vertices.size(); ++i)
+    std::copy(vertices[i].data(), vertices[i].data() + 3, mesh->vertices + 3 * i);
+  std::copy(triangles.begin(), triangles.end(), mesh->triangles);
+  mesh->computeTriangleNormals();
+  return mesh;
+}
+
+// The point of triangle abc closest to p (Ericson, Real-Time Collision Detection, 5.1.5)
+Eigen::Vector3d closestPointOnTriangle(const Eigen::Vector3d& p, const Eigen::Vector3d& a, const Eigen::Vector3d& b,
+                                       const Eigen::Vector3d& c)
+{
+  const Eigen::Vector3d ab = b - a, ac = c - a, ap = p - a;
+  const double d1 = ab.dot(ap), d2 = ac.dot(ap);
+  if (d1 <= 0.0 && d2 <= 0.0)
+    return a;
+  const Eigen::Vector3d bp = p - b;
+  const double d3 = ab.dot(bp), d4 = ac.dot(bp);
+  if (d3 >= 0.0 && d4 <= d3)
+    return b;
+  const double vc = d1 * d4 - d3 * d2;
+  if (vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0)
+    return a + ab * (d1 / (d1 - d3));
+  const Eigen::Vector3d cp = p - c;
+  const double d5 = ab.dot(cp), d6 = ac.dot(cp);
+  if (d6 >= 0.0 && d5 <= d6)
+    return c;
+  const double vb = d5 * d2 - d1 * d6;
+  if (vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0)
+    return a + ac * (d2 / (d2 - d6));
+  const double va = d3 * d6 - d5 * d4;
+  if (va <= 0.0 && (d4 - d3) >= 0.0 && (d5 - d6) >= 0.0)
+    return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+  const double denom = 1.0 / (va + vb + vc);
+  return a + ab * (vb * denom) + ac * (vc * denom);
+}
+
+// Whether the ray from p along dir crosses triangle abc (Moeller-Trumbore)
+bool rayHitsTriangle(const Eigen::Vector3d& p, const Eigen::Vector3d& dir, const Eigen::Vector3d& a,
+                     const Eigen::Vector3d& b, const Eigen::Vector3d& c)
+{
+  const Eigen::Vector3d e1 = b - a, e2 = c - a;
+  const Eigen::Vector3d h = dir.cross(e2);
+  const double det = e1.dot(h);
+  if (std::abs(det) < 1e-12)
+    return false;
+  const Eigen::Vector3d s = p - a;
+  const double u = s.dot(h) / det;
+  if (u < 0.0 || u > 1.0)
+    return false;
+  const Eigen::Vector3d q = s.cross(e1);
+  const double v = dir.dot(q) / det;
+  if (v < 0.0 || u + v > 1.0)
+    return false;
+  return e2.dot(q) / det > 0.0;
+}
+
+// How far the hull of a part reaches beyond the surface of its component: the largest distance from a point
+// sampled on the hull that is outside of the component to the component's surface. Points inside the component
+// (e.g. on the faces closing a cut) do not count. For meshes that are not closed every point counts as outside.
+double measureConcavity(const shapes::Mesh& hull, const WeldedMesh& mesh, const std::vector<unsigned int>& component)
+{
+  // a direction unlikely to run along an edge of a CAD mesh
+  const Eigen::Vector3d ray = Eigen::Vector3d(0.5773, 0.5774, 0.5775).normalized();
+
+  double concavity = 0.0;
+  for (unsigned int i = 0; i < hull.triangle_count; ++i)
+  {
+    const Eigen::Map<const Eigen::Vector3d> a(hull.vertices + 3 * hull.triangles[3 * i]);
+    const Eigen::Map<const Eigen::Vector3d> b(hull.vertices + 3 * hull.triangles[3 * i + 1]);
+    const Eigen::Map<const Eigen::Vector3d> c(hull.vertices + 3 * hull.triangles[3 * i + 2]);
+    const Eigen::Vector3d samples[4] = { (a + b + c) / 3.0, (a + b) / 2.0, (b + c) / 2.0, (a + c) / 2.0 };
+    for (const Eigen::Vector3d& sample : samples)
+    {
+      double distance2 = std::numeric_limits<double>::max();
+      unsigned int crossings = 0;
+      for (unsigned int t : component)
+      {
+        const Eigen::Vector3d& ta = mesh.vertices[mesh.triangles[t][0]];
+        const Eigen::Vector3d& tb = mesh.vertices[mesh.triangles[t][1]];
+        const Eigen::Vector3d& tc = mesh.vertices[mesh.triangles[t][2]];
+        distance2 = std::min(distance2, (closestPointOnTriangle(sample, ta, tb, tc) - sample).squaredNorm());
+        if (rayHitsTriangle(sample, ray, ta, tb, tc))
+          ++crossings;
+      }
+      if (crossings % 2 == 0)
+        concavity = std::max(concavity, std::sqrt(distance2));
+    }
+  }
+  return concavity;
+}
+
+// A part of a component waiting to be split or accepted
+struct Part
+{
+  std::vector<unsigned int> triangles;
+  unsigned int depth;
+  shapes::ShapeConstPtr hull;
+  double concavity;
+};
+
+bool makePart(const WeldedMesh& mesh, const std::vector<unsigned int>& component, std::vector<unsigned int> triangles,
+              unsigned int depth, Part& part)
+{
+  const std::unique_ptr<shapes::Mesh> extracted(extractPart(mesh, triangles));
+  const std::shared_ptr<shapes::Mesh> hull = computeHull(*extracted);
+  if (!hull)
+    return false;
+  part.concavity = measureConcavity(*hull, mesh, component);
+  part.hull = hull;
+  part.triangles = std::move(triangles);
+  part.depth = depth;
+  return true;
+}
+
+// Decompose one connected component, appending its parts. Returns false if the component is flat.
+bool decomposeComponent(const WeldedMesh& mesh, const std::vector<unsigned int>& component,
+                        const ConvexDecompositionOptions& options, std::vector<shapes::ShapeConstPtr>& parts)
+{
+  Eigen::Vector3d lower = Eigen::Vector3d::Constant(std::numeric_limits<double>::max());
+  Eigen::Vector3d upper = -lower;
+  for (unsigned int t : component)
+    for (unsigned int v : mesh.triangles[t])
+    {
+      lower = lower.cwiseMin(mesh.vertices[v]);
+      upper = upper.cwiseMax(mesh.vertices[v]);
+    }
+  const double max_concavity = options.max_concavity * (upper - lower).norm();
+
+  std::vector<Part> pending(1);
+  if (!makePart(mesh, component, component, 0, pending.front()))
+    return false;
+  while (!pending.empty())
+  {
+    Part part = std::move(pending.back());
+    pending.pop_back();
+    if (part.concavity <= max_concavity || part.depth >= options.max_depth || part.triangles.size() < 2)
+    {
+      parts.push_back(part.hull);
+      continue;
+    }
+
+    // cut at the median triangle center along the longest side of the part's bounding box
+    Eigen::Vector3d part_lower = Eigen::Vector3d::Constant(std::numeric_limits<double>::max());
+    Eigen::Vector3d part_upper = -part_lower;
+    for (unsigned int t : part.triangles)
+      for (unsigned int v : mesh.triangles[t])
+      {
+        part_lower = part_lower.cwiseMin(mesh.vertices[v]);
+        part_upper = part_upper.cwiseMax(mesh.vertices[v]);
+      }
+    Eigen::Index axis;
+    (part_upper - part_lower).maxCoeff(&axis);
+
+    std::vector<std::pair<double, unsigned int>> centers;
+    centers.reserve(part.triangles.size());
+    for (unsigned int t : part.triangles)
+    {
+      const std::array<unsigned int, 3>& tri = mesh.triangles[t];
+      centers.emplace_back(mesh.vertices[tri[0]][axis] + mesh.vertices[tri[1]][axis] + mesh.vertices[tri[2]][axis], t);
+    }
+    const auto middle = centers.begin() + centers.size() / 2;
+    std::nth_element(centers.begin(), middle, centers.end());
+
+    std::vector<unsigned int> below, above;
+    for (auto it = centers.begin(); it != centers.end(); ++it)
+      (it < middle ? below : above).push_back(it->second);
+
+    // a flat half has no hull, so the part is kept whole
+    Part lower_part, upper_part;
+    if (!makePart(mesh, component, std::move(below), part.depth + 1, lower_part) ||
+        !makePart(mesh, component, std::move(above), part.depth + 1, upper_part))
+    {
+      parts.push_back(part.hull);
+      continue;
+    }
+    pending.push_back(std::move(lower_part));
+    pending.push_back(std::move(upper_part));
+  }
+  return true;
+}
+}  // namespace
+
+std::vector<shapes::ShapeConstPtr> decomposeMesh(const shapes::Mesh& mesh, const ConvexDecompositionOptions& options)
+{
+  std::vector<shapes::ShapeConstPtr> parts;
+  if (mesh.vertex_count == 0 || mesh.triangle_count == 0)
+    return parts;
+
+  const WeldedMesh welded = weld(mesh);
+  for (const std::vector<unsigned int>& component : connectedComponents(welded))
+    if (!decomposeComponent(welded, component, options, parts))
+    {
+      RCLCPP_DEBUG(LOGGER, "A component of a mesh with %u triangles is flat, not decomposing the mesh",
+                   mesh.triangle_count);
+      return {};
+    }
+  return parts;
+}
+
+ConvexDecompositionCache& ConvexDecompositionCache::instance()
+{
+  static ConvexDecompositionCache cache;
+  return cache;
+}
+
+void ConvexDecompositionCache::setOptions(const ConvexDecompositionOptions& options)
+{
+  std::scoped_lock slock(lock_);
+  options_ = options;
+  parts_.clear();
+}
+
+ConvexDecompositionOptions ConvexDecompositionCache::getOptions() const
+{
+  std::scoped_lock slock(lock_);
+  return options_;
+}
+
+bool ConvexDecompositionCache::isEnabled() const
+{
+  std::scoped_lock slock(lock_);
+  return options_.enabled;
+}
+
+void ConvexDecompositionCache::clear()
+{
+  std::scoped_lock slock(lock_);
+  parts_.clear();
+  hashes_.clear();
+}
+
+std::uint64_t ConvexDecompositionCache::hashMesh(const shapes::Mesh& mesh)
+{
+  const std::uint64_t hash = hashBytes(mesh.vertices, 3 * sizeof(double) * mesh.vertex_count);
+  return hashBytes(mesh.triangles, 3 * sizeof(unsigned int) * mesh.triangle_count, hash);
+}
+
+std::string ConvexDecompositionCache::getCachePath(std::uint64_t hash) const
+{
+  // the decomposition also depends on the options, so they are part of the name
+  std::uint64_t options_hash = hashBytes(&options_.max_concavity, sizeof(options_.max_concavity));
+  options_hash = hashBytes(&options_.max_depth, sizeof(options_.max_depth), options_hash);
+
+  std::stringstream name;
+  name << std::hex << hash << '_' << options_hash << ".convex";
+  return (std::filesystem::path(options_.cache_directory) / name.str()).string();
+}
+
+std::vector<shapes::ShapeConstPtr> ConvexDecompositionCache::getConvexParts(const shapes::ShapeConstPtr& shape)
+{
+  const shapes::Mesh& mesh = static_cast<const shapes::Mesh&>(*shape);
+  ConvexDecompositionOptions options;
+  std::uint64_t hash;
+  std::string path;
+  {
+    std::scoped_lock slock(lock_);
+    if (!options_.enabled)
+      return {};
+    options = options_;
+
+    const auto known = hashes_.find(shape);
+    if (known != hashes_.end())
+      hash = known->second;
+    else
+    {
+      hash = hashMesh(mesh);
+      if (hashes_.size() >= 2 * prune_size_)
+      {
+        for (auto it = hashes_.begin(); it != hashes_.end();)
+          it = it->first.expired() ? hashes_.erase(it) : std::next(it);
+        prune_size_ = std::max<std::size_t>(hashes_.size(), 16);
+      }
+      hashes_.emplace(shape, hash);
+    }
+
+    const auto it = parts_.find(hash);
+    if (it != parts_.end())
+      return it->second;
+    if (!options_.cache_directory.empty())
+      path = getCachePath(hash);
+  }
+
+  // decomposition and file access happen unlocked; concurrent requests for the same mesh may duplicate the work
+  std::vector<shapes::ShapeConstPtr> parts;
+  if (path.empty() || !load(path, hash, mesh, parts))
+  {
+    parts = decomposeMesh(mesh, options);
+    if (!path.empty())
+    {
+      std::error_code error;
+      std::filesystem::create_directories(options.cache_directory, error);
+      save(path, hash, mesh, parts);
+    }
+  }
+
+  std::scoped_lock slock(lock_);
+  return parts_.emplace(hash, std::move(parts)).first->second;
+}
+
+bool ConvexDecompositionCache::load(const std::string& path, std::uint64_t hash, const shapes::Mesh& mesh,
+                                    std::vector<shapes::ShapeConstPtr>& parts)
+{
+  std::ifstream in(path, std::ios::binary);
+  if (!in)
+    return false;
+  const std::string buffer((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  Reader reader(buffer);
+
+  char magic[sizeof(MAGIC)];
+  std::uint32_t version;
+  std::uint8_t double_size, index_size;
+  std::uint64_t stored_hash;
+  std::uint32_t vertex_count, triangle_count, part_count;
+  if (!reader.readArray(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 ||
+      !reader.read(version) || !reader.read(double_size) || !reader.read(index_size) || !reader.read(stored_hash) ||
+      !reader.read(vertex_count) || !reader.read(triangle_count) || !reader.read(part_count))
+  {
+    RCLCPP_WARN(LOGGER, "'%s' is not a convex decomposition", path.c_str());
+    return false;
+  }
+  if (version != FORMAT_VERSION || double_size != sizeof(double) || index_size != sizeof(unsigned int) ||
+      stored_hash != hash || vertex_count != mesh.vertex_count || triangle_count != mesh.triangle_count)
+  {
+    RCLCPP_INFO(LOGGER, "Ignoring convex decomposition '%s' written for a different mesh or format", path.c_str());
+    return false;
+  }
+
+  std::vector<shapes::ShapeConstPtr> loaded;
+  for (std::uint32_t i = 0; i < part_count; ++i)
+  {
+    std::uint32_t part_vertices, part_triangles;
+    if (!reader.read(part_vertices) || !reader.read(part_triangles))
+      break;
+    auto part = std::make_shared<shapes::Mesh>(part_vertices, part_triangles);
+    if (!reader.readArray(part->vertices, 3 * part_vertices) || !reader.readArray(part->triangles, 3 * part_triangles))
+      break;
+    if (std::any_of(part->triangles, part->triangles + 3 * part_triangles,
+                    [part_vertices](unsigned int v) { return v >= part_vertices; }))
+      break;
+    part->computeTriangleNormals();
+    loaded.push_back(part);
+  }
+  if (loaded.size() != part_count)
+  {
+    RCLCPP_WARN(LOGGER, "Convex decomposition '%s' is truncated", path.c_str());
+    return false;
+  }
+  parts = std::move(loaded);
+  return true;
+}
+
+bool ConvexDecompositionCache::save(const std::string& path, std::uint64_t hash, const shapes::Mesh& mesh,
+                                    const std::vector<shapes::ShapeConstPtr>& parts)
+{
+  // other processes may be writing the same file, so each writes its own temporary file
+  std::stringstream tmp_path;
+  tmp_path << path << ".tmp." << std::hex << std::random_device()();
+  {
+    std::ofstream out(tmp_path.str(), std::ios::binary | std::ios::trunc);
+    if (!out)
+    {
+      RCLCPP_ERROR(LOGGER, "Unable to write convex decomposition '%s'", tmp_path.str().c_str());
+      return false;
+    }
+    out.write(MAGIC, sizeof(MAGIC));
+    write(out, FORMAT_VERSION);
+    write(out, static_cast<std::uint8_t>(sizeof(double)));
+    write(out, static_cast<std::uint8_t>(sizeof(unsigned int)));
+    write(out, hash);
+    write(out, static_cast<std::uint32_t>(mesh.vertex_count));
+    write(out, static_cast<std::uint32_t>(mesh.triangle_count));
+    write(out, static_cast<std::uint32_t>(parts.size()));
+    for (const shapes::ShapeConstPtr& shape : parts)
+    {
+      const shapes::Mesh& part = static_cast<const shapes::Mesh&>(*shape);
+      write(out, static_cast<std::uint32_t>(part.vertex_count));
+      write(out, static_cast<std::uint32_t>(part.triangle_count));
+      writeArray(out, part.vertices, 3 * part.vertex_count);
+      writeArray(out, part.triangles, 3 * part.triangle_count);
+    }
+    if (!out)
+    {
+      RCLCPP_ERROR(LOGGER, "Failed writing convex decomposition '%s'", tmp_path.str().c_str());
+      return false;
+    }
+  }
+
+  std::error_code error;
+  std::filesystem::rename(tmp_path.str(), path, error);
+  if (error)
+  {
+    RCLCPP_ERROR(LOGGER, "Unable to store convex decomposition '%s': %s", path.c_str(), error.message().c_str());
+    std::remove(tmp_path.str().c_str());
+    return false;
+  }
+  return true;
+}
+}  // namespace collision_detection
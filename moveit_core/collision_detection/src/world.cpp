@@ -35,22 +35,43 @@
 /* Author: Acorn Pooley, Ioan Sucan */
 
 #include <moveit/collision_detection/world.h>
+#include <moveit/collision_detection/aabb_tree.h>
+#include <moveit/robot_model/aabb.h>
 #include <geometric_shapes/check_isometry.h>
+#include <geometric_shapes/shapes.h>
+#include <octomap/octomap.h>
 #include <rclcpp/logger.hpp>
 #include <rclcpp/logging.hpp>
+#include <atomic>
+#include <limits>
 
 namespace collision_detection
 {
 // Logger
 static const rclcpp::Logger LOGGER = rclcpp::get_logger("moveit_collision_detection.world");
 
-World::World()
+// the change log keeps between MAX_CHANGES and twice as many records
+static const std::size_t MAX_CHANGES = 1024;
+
+namespace
+{
+std::uint64_t newVersion()
+{
+  static std::atomic<std::uint64_t> version(0);
+  return ++version;
+}
+}  // namespace
+
+World::World() : objects_(std::make_shared<ObjectMap>()), change_count_(0), base_version_(newVersion())
 {
 }
 
 World::World(const World& other)
+  : objects_(other.objects_)
+  , changes_(other.changes_)
+  , change_count_(other.change_count_)
+  , base_version_(other.base_version_)
 {
-  objects_ = other.objects_;
 }
 
 World::~World()
@@ -59,6 +80,101 @@ World::~World()
     removeObserver(observers_.front());
 }
 
+Eigen::AlignedBox3d World::getObjectBoundingBox(const Object& object)
+{
+  moveit::core::AABB aabb;
+  for (std::size_t i = 0; i < object.shapes_.size(); ++i)
+  {
+    const shapes::Shape* shape = object.shapes_[i].get();
+    const Eigen::Isometry3d& pose = object.global_shape_poses_[i];
+    switch (shape->type)
+    {
+      case shapes::SPHERE:
+      {
+        const double diameter = 2.0 * static_cast<const shapes::Sphere*>(shape)->radius;
+        aabb.extendWithTransformedBox(pose, Eigen::Vector3d::Constant(diameter));
+        break;
+      }
+      case shapes::BOX:
+      {
+        const double* size = static_cast<const shapes::Box*>(shape)->size;
+        aabb.extendWithTransformedBox(pose, Eigen::Vector3d(size[0], size[1], size[2]));
+        break;
+      }
+      case shapes::CYLINDER:
+      {
+        const auto* cylinder = static_cast<const shapes::Cylinder*>(shape);
+        const double diameter = 2.0 * cylinder->radius;
+        aabb.extendWithTransformedBox(pose, Eigen::Vector3d(diameter, diameter, cylinder->length));
+        break;
+      }
+      case shapes::CONE:
+      {
+        const auto* cone = static_cast<const shapes::Cone*>(shape);
+        const double diameter = 2.0 * cone->radius;
+        aabb.extendWithTransformedBox(pose, Eigen::Vector3d(diameter, diameter, cone->length));
+        break;
+      }
+      case shapes::MESH:
+      {
+        // the origin of a mesh need not be its center, so the vertices are transformed one by one
+        const auto* mesh = static_cast<const shapes::Mesh*>(shape);
+        for (unsigned int j = 0; j < mesh->vertex_count; ++j)
+          aabb.extend(pose * Eigen::Map<const Eigen::Vector3d>(&mesh->vertices[3 * j]));
+        break;
+      }
+      case shapes::OCTREE:
+      {
+        const auto& octree = static_cast<const shapes::OcTree*>(shape)->octree;
+        if (!octree || octree->size() == 0)
+          break;
+        double min_x, min_y, min_z, max_x, max_y, max_z;
+        octree->getMetricMin(min_x, min_y, min_z);
+        octree->getMetricMax(max_x, max_y, max_z);
+        const Eigen::Vector3d min(min_x, min_y, min_z);
+        const Eigen::Vector3d max(max_x, max_y, max_z);
+        aabb.extendWithTransformedBox(pose * Eigen::Translation3d(0.5 * (min + max)), max - min);
+        break;
+      }
+      case shapes::PLANE:
+        aabb.extend(Eigen::Vector3d::Constant(-std::numeric_limits<double>::infinity()));
+        aabb.extend(Eigen::Vector3d::Constant(std::numeric_limits<double>::infinity()));
+        break;
+      default:
+        break;
+    }
+  }
+  return aabb;
+}
+
+const AABBTree& World::getSpatialIndex() const
+{
+  if (!spatial_index_)
+  {
+    spatial_index_ = std::make_unique<AABBTree>();
+    for (const auto& object : *objects_)
+      spatial_index_->update(object.first, getObjectBoundingBox(*object.second));
+  }
+  return *spatial_index_;
+}
+
+std::vector<std::string> World::queryObjectsInBox(const Eigen::AlignedBox3d& box) const
+{
+  std::vector<std::string> ids;
+  std::scoped_lock slock(spatial_index_lock_);
+  getSpatialIndex().query(box, ids);
+  return ids;
+}
+
+std::vector<std::string> World::queryObjectsNearSegment(const Eigen::Vector3d& start, const Eigen::Vector3d& end,
+                                                        double radius) const
+{
+  std::vector<std::string> ids;
+  std::scoped_lock slock(spatial_index_lock_);
+  getSpatialIndex().querySegment(start, end, radius, ids);
+  return ids;
+}
+
 inline void World::addToObjectInternal(const ObjectPtr& obj, const shapes::ShapeConstPtr& shape,
                                        const Eigen::Isometry3d& shape_pose)
 {
@@ -84,7 +200,7 @@ void World::addToObject(const std::string& object_id, const Eigen::Isometry3d& p
 
   int action = ADD_SHAPE;
 
-  ObjectPtr& obj = objects_[object_id];
+  ObjectPtr& obj = getObjectsNonConst()[object_id];
   if (!obj)
   {
     obj = std::make_shared<Object>(object_id);
@@ -103,15 +219,15 @@ void World::addToObject(const std::string& object_id, const Eigen::Isometry3d& p
 std::vector<std::string> World::getObjectIds() const
 {
   std::vector<std::string> ids;
-  for (const auto& object : objects_)
+  for (const auto& object : *objects_)
     ids.push_back(object.first);
   return ids;
 }
 
 World::ObjectConstPtr World::getObject(const std::string& object_id) const
 {
-  const auto it = objects_.find(object_id);
-  if (it == objects_.end())
+  const auto it = objects_->find(object_id);
+  if (it == objects_->end())
     return ObjectConstPtr();
   else
     return it->second;
@@ -123,20 +239,36 @@ void World::ensureUnique(ObjectPtr& obj)
     obj = std::make_shared<Object>(*obj);
 }
 
+World::ObjectMap& World::getObjectsNonConst()
+{
+  // copying the table shares the objects themselves, which ensureUnique() then copies on modification
+  if (objects_.use_count() > 1)
+    objects_ = std::make_shared<ObjectMap>(*objects_);
+  return *objects_;
+}
+
+World::ObjectMap::iterator World::findObjectNonConst(const std::string& object_id)
+{
+  auto it = objects_->find(object_id);
+  if (it != objects_->end() && objects_.use_count() > 1)
+    it = getObjectsNonConst().find(object_id);
+  return it;
+}
+
 bool World::hasObject(const std::string& object_id) const
 {
-  return objects_.find(object_id) != objects_.end();
+  return objects_->find(object_id) != objects_->end();
 }
 
 bool World::knowsTransform(const std::string& name) const
 {
   // Check object names first
-  const std::map<std::string, ObjectPtr>::const_iterator it = objects_.find(name);
-  if (it != objects_.end())
+  const std::map<std::string, ObjectPtr>::const_iterator it = objects_->find(name);
+  if (it != objects_->end())
     return true;
   else  // Then objects' subframes
   {
-    for (const std::pair<const std::string, ObjectPtr>& object : objects_)
+    for (const std::pair<const std::string, ObjectPtr>& object : *objects_)
     {
       // if "object name/" matches start of object_id, we found the matching object
       // rfind searches name for object.first in the first index (returns 0 if found)
@@ -164,14 +296,14 @@ const Eigen::Isometry3d& World::getTransform(const std::string& name, bool& fram
   // assume found
   frame_found = true;
 
-  const std::map<std::string, ObjectPtr>::const_iterator it = objects_.find(name);
-  if (it != objects_.end())
+  const std::map<std::string, ObjectPtr>::const_iterator it = objects_->find(name);
+  if (it != objects_->end())
   {
     return it->second->pose_;
   }
   else  // Search within subframes
   {
-    for (const std::pair<const std::string, ObjectPtr>& object : objects_)
+    for (const std::pair<const std::string, ObjectPtr>& object : *objects_)
     {
       // if "object name/" matches start of object_id, we found the matching object
       // rfind searches name for object.first in the first index (returns 0 if found)
@@ -194,8 +326,8 @@ const Eigen::Isometry3d& World::getTransform(const std::string& name, bool& fram
 
 const Eigen::Isometry3d& World::getGlobalShapeTransform(const std::string& object_id, const int shape_index) const
 {
-  const auto it = objects_.find(object_id);
-  if (it != objects_.end())
+  const auto it = objects_->find(object_id);
+  if (it != objects_->end())
   {
     return it->second->global_shape_poses_[shape_index];
   }
@@ -209,8 +341,8 @@ const Eigen::Isometry3d& World::getGlobalShapeTransform(const std::string& objec
 
 const EigenSTL::vector_Isometry3d& World::getGlobalShapeTransforms(const std::string& object_id) const
 {
-  const auto it = objects_.find(object_id);
-  if (it != objects_.end())
+  const auto it = objects_->find(object_id);
+  if (it != objects_->end())
   {
     return it->second->global_shape_poses_;
   }
@@ -225,8 +357,8 @@ const EigenSTL::vector_Isometry3d& World::getGlobalShapeTransforms(const std::st
 bool World::moveShapeInObject(const std::string& object_id, const shapes::ShapeConstPtr& shape,
                               const Eigen::Isometry3d& shape_pose)
 {
-  const auto it = objects_.find(object_id);
-  if (it != objects_.end())
+  const auto it = findObjectNonConst(object_id);
+  if (it != objects_->end())
   {
     const unsigned int n = it->second->shapes_.size();
     for (unsigned int i = 0; i < n; ++i)
@@ -244,10 +376,19 @@ bool World::moveShapeInObject(const std::string& object_id, const shapes::ShapeC
   return false;
 }
 
+bool World::notifyShapesUpdated(const std::string& object_id)
+{
+  const auto it = objects_->find(object_id);
+  if (it == objects_->end())
+    return false;
+  notify(it->second, UPDATE_SHAPE);
+  return true;
+}
+
 bool World::moveObject(const std::string& object_id, const Eigen::Isometry3d& transform)
 {
-  const auto it = objects_.find(object_id);
-  if (it == objects_.end())
+  const auto it = objects_->find(object_id);
+  if (it == objects_->end())
     return false;
   if (transform.isApprox(Eigen::Isometry3d::Identity()))
     return true;  // object already at correct location
@@ -259,7 +400,7 @@ bool World::moveObject(const std::string& object_id, const Eigen::Isometry3d& tr
 bool World::setObjectPose(const std::string& object_id, const Eigen::Isometry3d& pose)
 {
   ASSERT_ISOMETRY(pose);  // unsanitized input, could contain a non-isometry
-  ObjectPtr& obj = objects_[object_id];
+  ObjectPtr& obj = getObjectsNonConst()[object_id];
   int action;
   if (!obj)
   {
@@ -280,8 +421,8 @@ bool World::setObjectPose(const std::string& object_id, const Eigen::Isometry3d&
 
 bool World::removeShapeFromObject(const std::string& object_id, const shapes::ShapeConstPtr& shape)
 {
-  const auto it = objects_.find(object_id);
-  if (it != objects_.end())
+  const auto it = findObjectNonConst(object_id);
+  if (it != objects_->end())
   {
     const unsigned int n = it->second->shapes_.size();
     for (unsigned int i = 0; i < n; ++i)
@@ -295,7 +436,7 @@ bool World::removeShapeFromObject(const std::string& object_id, const shapes::Sh
         if (it->second->shapes_.empty())
         {
           notify(it->second, DESTROY);
-          objects_.erase(it);
+          objects_->erase(it);
         }
         else
         {
@@ -309,11 +450,11 @@ bool World::removeShapeFromObject(const std::string& object_id, const shapes::Sh
 
 bool World::removeObject(const std::string& object_id)
 {
-  const auto it = objects_.find(object_id);
-  if (it != objects_.end())
+  const auto it = findObjectNonConst(object_id);
+  if (it != objects_->end())
   {
     notify(it->second, DESTROY);
-    objects_.erase(it);
+    objects_->erase(it);
     return true;
   }
   return false;
@@ -322,13 +463,44 @@ bool World::removeObject(const std::string& object_id)
 void World::clearObjects()
 {
   notifyAll(DESTROY);
-  objects_.clear();
+  objects_ = std::make_shared<ObjectMap>();
+}
+
+void World::restore(const World& other)
+{
+  std::set<std::string> ids;
+  if (!getChangedObjectIds(other.getVersion(), ids))
+  {
+    for (const auto& object : *objects_)
+      ids.insert(object.first);
+    for (const auto& object : *other.objects_)
+      ids.insert(object.first);
+  }
+
+  for (const std::string& id : ids)
+  {
+    const auto other_it = other.objects_->find(id);
+    const auto it = objects_->find(id);
+    const bool exists = it != objects_->end();
+    if (other_it == other.objects_->end() ? !exists : exists && it->second == other_it->second)
+      continue;
+
+    if (exists)
+      removeObject(id);
+    if (other_it != other.objects_->end())
+    {
+      // the object is shared with other until either world modifies it
+      ObjectPtr& obj = getObjectsNonConst()[id];
+      obj = other_it->second;
+      notify(obj, Action(obj->shapes_.empty() ? CREATE : CREATE | ADD_SHAPE));
+    }
+  }
 }
 
 bool World::setSubframesOfObject(const std::string& object_id, const moveit::core::FixedTransformsMap& subframe_poses)
 {
-  const auto obj_pair = objects_.find(object_id);
-  if (obj_pair == objects_.end())
+  const auto obj_pair = findObjectNonConst(object_id);
+  if (obj_pair == objects_->end())
   {
     return false;
   }
@@ -336,9 +508,11 @@ bool World::setSubframesOfObject(const std::string& object_id, const moveit::cor
   {
     ASSERT_ISOMETRY(t.second)  // unsanitized input, could contain a non-isometry
   }
+  ensureUnique(obj_pair->second);
   obj_pair->second->subframe_poses_ = subframe_poses;
   obj_pair->second->global_subframe_poses_ = subframe_poses;
   updateGlobalPosesInternal(obj_pair->second, false, true);
+  recordChange(object_id);
   return true;
 }
 
@@ -383,12 +557,20 @@ void World::removeObserver(ObserverHandle observer_handle)
 
 void World::notifyAll(Action action)
 {
-  for (std::map<std::string, ObjectPtr>::const_iterator it = objects_.begin(); it != objects_.end(); ++it)
+  for (std::map<std::string, ObjectPtr>::const_iterator it = objects_->begin(); it != objects_->end(); ++it)
     notify(it->second, action);
 }
 
 void World::notify(const ObjectConstPtr& obj, Action action)
 {
+  recordChange(obj->id_);
+  if (spatial_index_)
+  {
+    if (action & DESTROY)
+      spatial_index_->remove(obj->id_);
+    else
+      spatial_index_->update(obj->id_, getObjectBoundingBox(*obj));
+  }
   for (Observer* observer : observers_)
     observer->callback_(obj, action);
 }
@@ -400,11 +582,41 @@ void World::notifyObserverAllObjects(const ObserverHandle observer_handle, Actio
     if (observer == observer_handle.observer_)
     {
       // call the callback for each object
-      for (const auto& object : objects_)
+      for (const auto& object : *objects_)
         observer->callback_(object.second, action);
       break;
     }
   }
 }
 
+void World::recordChange(const std::string& id)
+{
+  changes_ = std::make_shared<const ChangeRecord>(ChangeRecord{ newVersion(), id, changes_ });
+  if (++change_count_ < 2 * MAX_CHANGES)
+    return;
+
+  // copy the most recent records, so that the older ones are released once no copy of this world refers to them
+  std::vector<const ChangeRecord*> recent;
+  recent.reserve(MAX_CHANGES);
+  const ChangeRecord* record = changes_.get();
+  for (; recent.size() < MAX_CHANGES; record = record->previous.get())
+    recent.push_back(record);
+  base_version_ = record->version;
+
+  std::shared_ptr<const ChangeRecord> chain;
+  for (auto it = recent.rbegin(); it != recent.rend(); ++it)
+    chain = std::make_shared<const ChangeRecord>(ChangeRecord{ (*it)->version, (*it)->id, chain });
+  changes_ = std::move(chain);
+  change_count_ = MAX_CHANGES;
+}
+
+bool World::getChangedObjectIds(std::uint64_t version, std::set<std::string>& object_ids) const
+{
+  // versions only increase along the change log, so version has to match one of its records exactly
+  const ChangeRecord* record = changes_.get();
+  for (; record && record->version > version; record = record->previous.get())
+    object_ids.insert(record->id);
+  return record ? record->version == version : base_version_ == version;
+}
+
 }  // end of namespace collision_detection
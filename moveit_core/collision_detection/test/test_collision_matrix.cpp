@@ -0,0 +1,113 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/collision_detection/collision_matrix.h>
+#include <moveit/utils/robot_model_test_utils.h>
+#include <gtest/gtest.h>
+
+namespace
+{
+void expectSameEntries(const collision_detection::AllowedCollisionMatrix& acm,
+                       const moveit::core::RobotModel& robot_model)
+{
+  collision_detection::IndexedAllowedCollisionMatrixConstPtr indexed = acm.getIndexedLinkMatrix(robot_model);
+  ASSERT_TRUE(indexed);
+  const std::vector<std::string>& names = robot_model.getLinkModelNames();
+  ASSERT_EQ(indexed->getSize(), names.size());
+  for (std::size_t i = 0; i < names.size(); ++i)
+    for (std::size_t j = 0; j < names.size(); ++j)
+    {
+      collision_detection::AllowedCollision::Type expected, type;
+      bool found = acm.getAllowedCollision(names[i], names[j], expected);
+      ASSERT_EQ(indexed->getAllowedCollision(i, j, type), found) << names[i] << " - " << names[j];
+      if (found)
+        EXPECT_EQ(type, expected) << names[i] << " - " << names[j];
+    }
+}
+}  // namespace
+
+TEST(IndexedAllowedCollisionMatrix, MatchesNamedLookups)
+{
+  moveit::core::RobotModelPtr robot_model = moveit::core::loadTestingRobotModel("pr2");
+  collision_detection::AllowedCollisionMatrix acm(*robot_model->getSRDF());
+  expectSameEntries(acm, *robot_model);
+
+  // the cached table is reused until the matrix changes
+  EXPECT_EQ(acm.getIndexedLinkMatrix(*robot_model), acm.getIndexedLinkMatrix(*robot_model));
+  collision_detection::IndexedAllowedCollisionMatrixConstPtr before = acm.getIndexedLinkMatrix(*robot_model);
+
+  acm.setDefaultEntry("r_gripper_palm_link", true);
+  acm.setDefaultEntry("l_gripper_palm_link", false);
+  collision_detection::DecideContactFn fn = [](collision_detection::Contact& /*contact*/) { return true; };
+  acm.setDefaultEntry("base_link", fn);
+  acm.setEntry("r_forearm_link", "l_forearm_link", true);
+  acm.removeEntry("torso_lift_link");
+  EXPECT_NE(acm.getIndexedLinkMatrix(*robot_model), before);
+  expectSameEntries(acm, *robot_model);
+}
+
+TEST(AllowedCollisionMatrix, CopiesAreIndependent)
+{
+  collision_detection::AllowedCollisionMatrix acm;
+  acm.setEntry("a", "b", true);
+  acm.setEntry("a", "c", false);
+
+  // copies share rows until they are modified
+  collision_detection::AllowedCollisionMatrix copy(acm);
+  copy.setEntry("a", "b", false);
+  copy.removeEntry("a", "c");
+  copy.setEntry("b", "d", true);
+
+  collision_detection::AllowedCollision::Type type;
+  ASSERT_TRUE(acm.getEntry("a", "b", type));
+  EXPECT_EQ(type, collision_detection::AllowedCollision::ALWAYS);
+  ASSERT_TRUE(acm.getEntry("c", "a", type));
+  EXPECT_EQ(type, collision_detection::AllowedCollision::NEVER);
+  EXPECT_FALSE(acm.hasEntry("d"));
+
+  ASSERT_TRUE(copy.getEntry("b", "a", type));
+  EXPECT_EQ(type, collision_detection::AllowedCollision::NEVER);
+  EXPECT_FALSE(copy.hasEntry("a", "c"));
+  EXPECT_TRUE(copy.hasEntry("d", "b"));
+
+  acm.setEntry(true);
+  ASSERT_TRUE(copy.getEntry("a", "b", type));
+  EXPECT_EQ(type, collision_detection::AllowedCollision::NEVER);
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
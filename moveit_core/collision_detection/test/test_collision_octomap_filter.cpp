@@ -0,0 +1,134 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <gtest/gtest.h>
+#include <moveit/collision_detection/collision_octomap_filter.h>
+#include <geometric_shapes/shapes.h>
+#include <octomap/octomap.h>
+
+namespace
+{
+// A horizontal slab of occupied voxels just below z = 0, wrapped as a world object
+collision_detection::World::ObjectConstPtr makeFloorObject()
+{
+  auto tree = std::make_shared<octomap::OcTree>(0.1);
+  for (double x = -0.45; x < 0.5; x += 0.1)
+    for (double y = -0.45; y < 0.5; y += 0.1)
+      tree->updateNode(octomap::point3d(x, y, -0.05), true);
+
+  auto object = std::make_shared<collision_detection::World::Object>("<octomap>");
+  object->shapes_.push_back(std::make_shared<const shapes::OcTree>(tree));
+  object->shape_poses_.push_back(Eigen::Isometry3d::Identity());
+  return object;
+}
+
+collision_detection::CollisionResult makeSidewaysContact(const Eigen::Vector3d& pos)
+{
+  collision_detection::Contact contact;
+  contact.pos = pos;
+  contact.normal = Eigen::Vector3d::UnitX();
+  contact.depth = 0.0;
+  contact.body_name_1 = "<octomap>";
+  contact.body_name_2 = "link";
+
+  collision_detection::CollisionResult res;
+  res.collision = true;
+  res.contacts[std::make_pair(contact.body_name_1, contact.body_name_2)].push_back(contact);
+  res.contact_count = 1;
+  return res;
+}
+
+const collision_detection::Contact& firstContact(const collision_detection::CollisionResult& res)
+{
+  return res.contacts.begin()->second.front();
+}
+}  // namespace
+
+TEST(CollisionOctomapFilter, RefinesTowardsSurfaceNormal)
+{
+  const collision_detection::World::ObjectConstPtr floor = makeFloorObject();
+  collision_detection::CollisionResult res = makeSidewaysContact(Eigen::Vector3d(0.0, 0.0, 0.02));
+
+  EXPECT_EQ(collision_detection::refineContactNormals(floor, res), 1);
+  const Eigen::Vector3d& normal = firstContact(res).normal;
+  EXPECT_NEAR(normal.norm(), 1.0, 1e-6);
+  EXPECT_GT(normal.z(), 0.9);
+}
+
+TEST(CollisionOctomapFilter, WorkspaceReuseMatchesDefault)
+{
+  const collision_detection::World::ObjectConstPtr floor = makeFloorObject();
+  collision_detection::ContactRefinementWorkspace workspace;
+
+  for (const Eigen::Vector3d& pos : { Eigen::Vector3d(0.0, 0.0, 0.02), Eigen::Vector3d(0.13, -0.07, 0.01) })
+  {
+    collision_detection::CollisionResult expected = makeSidewaysContact(pos);
+    collision_detection::CollisionResult actual = makeSidewaysContact(pos);
+    collision_detection::refineContactNormals(floor, expected, 1.0, 0.0, true);
+    collision_detection::refineContactNormals(floor, actual, workspace, nullptr, 1.0, 0.0, true);
+
+    EXPECT_TRUE(firstContact(actual).normal.isApprox(firstContact(expected).normal));
+    EXPECT_DOUBLE_EQ(firstContact(actual).depth, firstContact(expected).depth);
+  }
+  EXPECT_GT(workspace.x.capacity(), 0u);
+}
+
+TEST(CollisionOctomapFilter, DistanceGradientFastPath)
+{
+  const collision_detection::World::ObjectConstPtr floor = makeFloorObject();
+  collision_detection::ContactRefinementWorkspace workspace;
+  collision_detection::CollisionResult res = makeSidewaysContact(Eigen::Vector3d(0.0, 0.0, 0.02));
+
+  unsigned int lookups = 0;
+  const collision_detection::DistanceGradientFn field = [&lookups](const Eigen::Vector3d& /*point*/,
+                                                                   Eigen::Vector3d& gradient, double& distance) {
+    ++lookups;
+    gradient = Eigen::Vector3d(0.0, 2.0, 0.0);
+    distance = -0.01;
+    return true;
+  };
+
+  EXPECT_EQ(collision_detection::refineContactNormals(floor, res, workspace, field, 1.0, 0.0, true), 1);
+  EXPECT_EQ(lookups, 1u);
+  EXPECT_TRUE(firstContact(res).normal.isApprox(Eigen::Vector3d::UnitY()));
+  EXPECT_DOUBLE_EQ(firstContact(res).depth, 0.01);
+  // the octree was never searched
+  EXPECT_EQ(workspace.size(), 0u);
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,162 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/collision_detection/allvalid/collision_env_allvalid.h>
+#include <moveit/collision_detection/collision_result_cache.h>
+#include <moveit/utils/robot_model_test_utils.h>
+#include <geometric_shapes/shapes.h>
+#include <gtest/gtest.h>
+
+namespace
+{
+// Reports a collision whenever the first variable is positive and counts the checks it performs
+class CountingCollisionEnv : public collision_detection::CollisionEnvAllValid
+{
+public:
+  using CollisionEnvAllValid::CollisionEnvAllValid;
+  using CollisionEnvAllValid::checkCollision;
+
+  void checkCollision(const collision_detection::CollisionRequest& /*req*/, collision_detection::CollisionResult& res,
+                      const moveit::core::RobotState& state,
+                      const collision_detection::AllowedCollisionMatrix& /*acm*/) const override
+  {
+    ++checks;
+    res.collision = state.getVariablePosition(0) > 0.0;
+  }
+
+  mutable std::size_t checks = 0;
+};
+}  // namespace
+
+TEST(CollisionResultCache, LookupAndInsert)
+{
+  moveit::core::RobotModelPtr model = moveit::core::loadTestingRobotModel("panda");
+  ASSERT_TRUE(bool(model));
+  const moveit::core::JointModelGroup* group = model->getJointModelGroup("panda_arm");
+  ASSERT_TRUE(group);
+  moveit::core::RobotState state(model);
+  state.setToDefaultValues();
+  collision_detection::AllowedCollisionMatrix acm;
+
+  collision_detection::CollisionResultCache cache(100, 1e-3);
+  bool collision = false;
+  EXPECT_FALSE(cache.lookup(group, state, acm, collision));
+  cache.insert(group, state, acm, true);
+  EXPECT_TRUE(cache.lookup(group, state, acm, collision));
+  EXPECT_TRUE(collision);
+  EXPECT_EQ(cache.getHitCount(), 1u);
+  EXPECT_EQ(cache.getMissCount(), 1u);
+
+  // states within the same grid cell share the result, states in other cells do not
+  const int index = group->getVariableIndexList().front();
+  moveit::core::RobotState near(state);
+  near.setVariablePosition(index, state.getVariablePosition(index) + 1e-5);
+  EXPECT_TRUE(cache.lookup(group, near, acm, collision));
+  moveit::core::RobotState far(state);
+  far.setVariablePosition(index, state.getVariablePosition(index) + 0.1);
+  EXPECT_FALSE(cache.lookup(group, far, acm, collision));
+
+  // modifying the matrix changes its version, copies keep it
+  collision_detection::AllowedCollisionMatrix copy(acm);
+  EXPECT_TRUE(cache.lookup(group, state, copy, collision));
+  acm.setEntry("panda_link0", "panda_link1", true);
+  EXPECT_NE(acm.getVersion(), copy.getVersion());
+  EXPECT_FALSE(cache.lookup(group, state, acm, collision));
+
+  cache.clear();
+  EXPECT_EQ(cache.size(), 0u);
+  EXPECT_FALSE(cache.lookup(group, state, copy, collision));
+}
+
+TEST(CollisionResultCache, Capacity)
+{
+  moveit::core::RobotModelPtr model = moveit::core::loadTestingRobotModel("panda");
+  ASSERT_TRUE(bool(model));
+  moveit::core::RobotState state(model);
+  state.setToDefaultValues();
+  collision_detection::AllowedCollisionMatrix acm;
+
+  collision_detection::CollisionResultCache cache(32, 1e-3);
+  for (std::size_t i = 0; i < 1000; ++i)
+  {
+    state.setVariablePosition(0, 0.01 * i);
+    cache.insert(nullptr, state, acm, false);
+  }
+  EXPECT_LE(cache.size(), 32u);
+  EXPECT_GT(cache.size(), 0u);
+}
+
+TEST(CollisionResultCache, CheckCollision)
+{
+  moveit::core::RobotModelPtr model = moveit::core::loadTestingRobotModel("panda");
+  ASSERT_TRUE(bool(model));
+  auto world = std::make_shared<collision_detection::World>();
+  CountingCollisionEnv env(model, world);
+  collision_detection::CollisionResultCache cache(100, 1e-3, world);
+  collision_detection::AllowedCollisionMatrix acm;
+
+  moveit::core::RobotState state(model);
+  state.setToDefaultValues();
+  state.setVariablePosition(0, 0.5);
+  collision_detection::CollisionRequest req;
+  req.group_name = "panda_arm";
+  for (std::size_t i = 0; i < 3; ++i)
+  {
+    collision_detection::CollisionResult res;
+    cache.checkCollision(env, req, res, state, acm);
+    EXPECT_TRUE(res.collision);
+  }
+  EXPECT_EQ(env.checks, 1u);
+  EXPECT_EQ(cache.getHitCount(), 2u);
+
+  // changing the world clears the cache
+  world->addToObject("box", std::make_shared<shapes::Box>(0.1, 0.1, 0.1), Eigen::Isometry3d::Identity());
+  EXPECT_EQ(cache.size(), 0u);
+  collision_detection::CollisionResult res;
+  cache.checkCollision(env, req, res, state, acm);
+  EXPECT_EQ(env.checks, 2u);
+
+  // requests asking for contacts are not cached
+  req.contacts = true;
+  res.clear();
+  cache.checkCollision(env, req, res, state, acm);
+  EXPECT_TRUE(res.collision);
+  EXPECT_EQ(env.checks, 3u);
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,188 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <gtest/gtest.h>
+#include <moveit/collision_detection/convex_decomposition.h>
+#include <geometric_shapes/bodies.h>
+#include <filesystem>
+
+namespace
+{
+// Append an axis-aligned unit cube with its lower corner at (x, y, z)
+void addCube(std::vector<double>& vertices, std::vector<unsigned int>& triangles, double x, double y, double z)
+{
+  const unsigned int offset = vertices.size() / 3;
+  for (unsigned int i = 0; i < 8; ++i)
+  {
+    vertices.push_back(x + (i & 1));
+    vertices.push_back(y + ((i >> 1) & 1));
+    vertices.push_back(z + ((i >> 2) & 1));
+  }
+  const unsigned int faces[12][3] = { { 0, 2, 3 }, { 0, 3, 1 }, { 4, 5, 7 }, { 4, 7, 6 }, { 0, 1, 5 }, { 0, 5, 4 },
+                                      { 2, 6, 7 }, { 2, 7, 3 }, { 0, 4, 6 }, { 0, 6, 2 }, { 1, 3, 7 }, { 1, 7, 5 } };
+  for (const auto& face : faces)
+    for (unsigned int v : face)
+      triangles.push_back(offset + v);
+}
+
+shapes::ShapeConstPtr makeMesh(const std::vector<double>& vertices, const std::vector<unsigned int>& triangles)
+{
+  auto mesh = std::make_shared<shapes::Mesh>(vertices.size() / 3, triangles.size() / 3);
+  std::copy(vertices.begin(), vertices.end(), mesh->vertices);
+  std::copy(triangles.begin(), triangles.end(), mesh->triangles);
+  return mesh;
+}
+
+// An L-shaped block of three cubes, which is not convex
+shapes::ShapeConstPtr makeLShape()
+{
+  std::vector<double> vertices;
+  std::vector<unsigned int> triangles;
+  addCube(vertices, triangles, 0, 0, 0);
+  addCube(vertices, triangles, 1, 0, 0);
+  addCube(vertices, triangles, 0, 1, 0);
+  return makeMesh(vertices, triangles);
+}
+
+bool insideAnyPart(const std::vector<shapes::ShapeConstPtr>& parts, const Eigen::Vector3d& point)
+{
+  for (const shapes::ShapeConstPtr& part : parts)
+  {
+    bodies::ConvexMesh hull(part.get());
+    hull.setPadding(1e-6);
+    if (hull.containsPoint(point))
+      return true;
+  }
+  return false;
+}
+}  // namespace
+
+TEST(ConvexDecomposition, ConvexMeshIsOnePart)
+{
+  std::vector<double> vertices;
+  std::vector<unsigned int> triangles;
+  addCube(vertices, triangles, 0, 0, 0);
+  const std::vector<shapes::ShapeConstPtr> parts =
+      collision_detection::decomposeMesh(static_cast<const shapes::Mesh&>(*makeMesh(vertices, triangles)), {});
+  ASSERT_EQ(parts.size(), 1u);
+  EXPECT_EQ(static_cast<const shapes::Mesh&>(*parts[0]).vertex_count, 8u);
+}
+
+TEST(ConvexDecomposition, ComponentsAreSeparateParts)
+{
+  std::vector<double> vertices;
+  std::vector<unsigned int> triangles;
+  addCube(vertices, triangles, 0, 0, 0);
+  addCube(vertices, triangles, 3, 0, 0);
+  const std::vector<shapes::ShapeConstPtr> parts =
+      collision_detection::decomposeMesh(static_cast<const shapes::Mesh&>(*makeMesh(vertices, triangles)), {});
+  ASSERT_EQ(parts.size(), 2u);
+  EXPECT_FALSE(insideAnyPart(parts, Eigen::Vector3d(2.0, 0.5, 0.5)));
+}
+
+TEST(ConvexDecomposition, ConcaveMeshIsSplit)
+{
+  const shapes::ShapeConstPtr mesh = makeLShape();
+  const std::vector<shapes::ShapeConstPtr> parts =
+      collision_detection::decomposeMesh(static_cast<const shapes::Mesh&>(*mesh), {});
+  EXPECT_GT(parts.size(), 1u);
+
+  // the parts cover the block, but not the notch of the L that its convex hull would fill
+  EXPECT_TRUE(insideAnyPart(parts, Eigen::Vector3d(0.5, 0.5, 0.5)));
+  EXPECT_TRUE(insideAnyPart(parts, Eigen::Vector3d(1.5, 0.5, 0.5)));
+  EXPECT_TRUE(insideAnyPart(parts, Eigen::Vector3d(0.5, 1.5, 0.5)));
+  EXPECT_FALSE(insideAnyPart(parts, Eigen::Vector3d(1.7, 1.7, 0.5)));
+}
+
+TEST(ConvexDecomposition, FlatMeshIsNotDecomposed)
+{
+  const shapes::ShapeConstPtr plane = makeMesh({ 0, 0, 0, 1, 0, 0, 0, 1, 0, 1, 1, 0 }, { 0, 1, 2, 1, 3, 2 });
+  EXPECT_TRUE(collision_detection::decomposeMesh(static_cast<const shapes::Mesh&>(*plane), {}).empty());
+}
+
+TEST(ConvexDecompositionCache, DisabledByDefault)
+{
+  collision_detection::ConvexDecompositionCache& cache = collision_detection::ConvexDecompositionCache::instance();
+  EXPECT_FALSE(cache.isEnabled());
+  EXPECT_TRUE(cache.getConvexParts(makeLShape()).empty());
+}
+
+TEST(ConvexDecompositionCache, SharesAndPersistsParts)
+{
+  const std::filesystem::path directory = std::filesystem::temp_directory_path() / "test_convex_decomposition";
+  std::filesystem::remove_all(directory);
+
+  collision_detection::ConvexDecompositionCache& cache = collision_detection::ConvexDecompositionCache::instance();
+  collision_detection::ConvexDecompositionOptions options;
+  options.enabled = true;
+  options.cache_directory = directory.string();
+  cache.setOptions(options);
+
+  // identical meshes share their parts
+  const std::vector<shapes::ShapeConstPtr> parts = cache.getConvexParts(makeLShape());
+  ASSERT_GT(parts.size(), 1u);
+  EXPECT_EQ(cache.getConvexParts(makeLShape()), parts);
+  ASSERT_EQ(std::distance(std::filesystem::directory_iterator(directory), std::filesystem::directory_iterator()), 1);
+
+  // after forgetting them, they are read back from the file
+  cache.clear();
+  const std::vector<shapes::ShapeConstPtr> loaded = cache.getConvexParts(makeLShape());
+  ASSERT_EQ(loaded.size(), parts.size());
+  for (std::size_t i = 0; i < parts.size(); ++i)
+  {
+    const shapes::Mesh& a = static_cast<const shapes::Mesh&>(*parts[i]);
+    const shapes::Mesh& b = static_cast<const shapes::Mesh&>(*loaded[i]);
+    ASSERT_EQ(a.vertex_count, b.vertex_count);
+    ASSERT_EQ(a.triangle_count, b.triangle_count);
+    EXPECT_TRUE(std::equal(a.vertices, a.vertices + 3 * a.vertex_count, b.vertices));
+    EXPECT_TRUE(std::equal(a.triangles, a.triangles + 3 * a.triangle_count, b.triangles));
+  }
+
+  // a file written for another mesh is rejected
+  const std::filesystem::path file = *std::filesystem::directory_iterator(directory);
+  std::vector<shapes::ShapeConstPtr> rejected;
+  const shapes::ShapeConstPtr other = makeMesh({ 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 1 }, { 0, 1, 2, 0, 1, 3 });
+  EXPECT_FALSE(collision_detection::ConvexDecompositionCache::load(
+      file.string(), collision_detection::ConvexDecompositionCache::hashMesh(static_cast<const shapes::Mesh&>(*other)),
+      static_cast<const shapes::Mesh&>(*other), rejected));
+
+  cache.setOptions(collision_detection::ConvexDecompositionOptions());
+  std::filesystem::remove_all(directory);
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,115 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/collision_detection/allvalid/collision_env_allvalid.h>
+#include <moveit/utils/robot_model_test_utils.h>
+#include <geometric_shapes/shapes.h>
+#include <gtest/gtest.h>
+
+namespace
+{
+// Exposes the link bounding sphere test of CollisionEnv
+class SphereTestCollisionEnv : public collision_detection::CollisionEnvAllValid
+{
+public:
+  using CollisionEnvAllValid::areLinkBoundingSpheresSeparated;
+  using CollisionEnvAllValid::CollisionEnvAllValid;
+};
+
+// Only link0 and the hand, which are far apart in the home pose, still need to be checked
+class LinkBoundingSpheresTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    robot_model_ = moveit::core::loadTestingRobotModel("panda");
+    ASSERT_TRUE(static_cast<bool>(robot_model_));
+    env_ = std::make_shared<SphereTestCollisionEnv>(robot_model_);
+    acm_ = std::make_shared<collision_detection::AllowedCollisionMatrix>(robot_model_->getLinkModelNames(), true);
+    acm_->setEntry("panda_link0", "panda_hand", false);
+
+    state_ = std::make_shared<moveit::core::RobotState>(robot_model_);
+    state_->setToDefaultValues();
+    state_->setVariablePosition("panda_joint2", -0.785);
+    state_->setVariablePosition("panda_joint4", -2.356);
+    state_->setVariablePosition("panda_joint6", 1.571);
+    state_->setVariablePosition("panda_joint7", 0.785);
+    state_->update();
+  }
+
+  moveit::core::RobotModelPtr robot_model_;
+  std::shared_ptr<SphereTestCollisionEnv> env_;
+  collision_detection::AllowedCollisionMatrixPtr acm_;
+  moveit::core::RobotStatePtr state_;
+};
+}  // namespace
+
+TEST_F(LinkBoundingSpheresTest, LinksWithGeometryHaveSpheres)
+{
+  for (const moveit::core::LinkModel* link : robot_model_->getLinkModelsWithCollisionGeometry())
+    EXPECT_GT(link->getBoundingSphereRadius(), 0.0) << link->getName();
+}
+
+TEST_F(LinkBoundingSpheresTest, Separated)
+{
+  EXPECT_TRUE(env_->areLinkBoundingSpheresSeparated(*state_, acm_.get()));
+  EXPECT_FALSE(env_->areLinkBoundingSpheresSeparated(*state_, acm_.get(), 1.0));
+
+  // adjacent links touch
+  EXPECT_FALSE(env_->areLinkBoundingSpheresSeparated(*state_, nullptr));
+}
+
+TEST_F(LinkBoundingSpheresTest, PaddingAndScaling)
+{
+  env_->setLinkPadding("panda_hand", 1.0);
+  EXPECT_FALSE(env_->areLinkBoundingSpheresSeparated(*state_, acm_.get()));
+  env_->setLinkPadding("panda_hand", 0.0);
+  EXPECT_TRUE(env_->areLinkBoundingSpheresSeparated(*state_, acm_.get()));
+
+  env_->setScale(5.0);
+  EXPECT_FALSE(env_->areLinkBoundingSpheresSeparated(*state_, acm_.get()));
+}
+
+TEST_F(LinkBoundingSpheresTest, AttachedBodies)
+{
+  state_->attachBody("box", Eigen::Isometry3d::Identity(), { std::make_shared<const shapes::Box>(0.1, 0.1, 0.1) },
+                     { Eigen::Isometry3d::Identity() }, std::set<std::string>(), "panda_hand");
+  EXPECT_FALSE(env_->areLinkBoundingSpheresSeparated(*state_, acm_.get()));
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,87 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <gtest/gtest.h>
+#include <moveit/collision_detection/occupancy_map.h>
+
+TEST(OccMapTree, NoSnapshotByDefault)
+{
+  collision_detection::OccMapTree tree(0.1);
+  EXPECT_FALSE(tree.isDoubleBuffered());
+  tree.triggerUpdateCallback();
+  EXPECT_EQ(tree.getSnapshot(), nullptr);
+}
+
+TEST(OccMapTree, SnapshotIsIsolatedFromWrites)
+{
+  collision_detection::OccMapTree tree(0.1);
+  tree.setDoubleBuffered(true);
+  std::shared_ptr<const octomap::OcTree> empty = tree.getSnapshot();
+  ASSERT_NE(empty, nullptr);
+  EXPECT_EQ(empty->size(), 0u);
+
+  {
+    collision_detection::OccMapTree::WriteLock lock = tree.writing();
+    tree.updateNode(octomap::point3d(0.5, 0.5, 0.5), true);
+  }
+  // writes go into the back buffer only
+  EXPECT_EQ(tree.getSnapshot(), empty);
+  EXPECT_EQ(empty->size(), 0u);
+
+  unsigned int callbacks = 0;
+  tree.setUpdateCallback([&tree, &callbacks, empty] {
+    // the new snapshot is published before observers are notified
+    EXPECT_NE(tree.getSnapshot(), empty);
+    ++callbacks;
+  });
+  tree.triggerUpdateCallback();
+  EXPECT_EQ(callbacks, 1u);
+
+  std::shared_ptr<const octomap::OcTree> filled = tree.getSnapshot();
+  ASSERT_NE(filled, nullptr);
+  const octomap::OcTreeNode* node = filled->search(0.5, 0.5, 0.5);
+  ASSERT_NE(node, nullptr);
+  EXPECT_TRUE(filled->isNodeOccupied(node));
+  EXPECT_EQ(empty->size(), 0u);
+
+  tree.setDoubleBuffered(false);
+  EXPECT_EQ(tree.getSnapshot(), nullptr);
+  EXPECT_NE(filled->search(0.5, 0.5, 0.5), nullptr);
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -36,8 +36,11 @@
 
 #include <gtest/gtest.h>
 #include <moveit/collision_detection/world.h>
+#include <moveit/collision_detection/aabb_tree.h>
 #include <geometric_shapes/shapes.h>
+#include <algorithm>
 #include <functional>
+#include <random>
 
 using namespace collision_detection;
 
@@ -372,6 +375,143 @@ TEST(World, TrackChanges)
   EXPECT_EQ(4, ta3.cnt_);
 }
 
+TEST(World, NotifyShapesUpdated)
+{
+  World world;
+
+  TestAction ta;
+  World::ObserverHandle observer_ta;
+  observer_ta = world.addObserver([&ta](const World::ObjectConstPtr& object, World::Action action) {
+    return TrackChangesNotify(ta, object, action);
+  });
+
+  shapes::ShapePtr box = std::make_shared<shapes::Box>(1, 2, 3);
+  world.addToObject("obj1", box, Eigen::Isometry3d::Identity());
+  ta.reset();
+
+  // in-place updates are reported once, without changing the object
+  EXPECT_TRUE(world.notifyShapesUpdated("obj1"));
+  EXPECT_EQ(2, ta.cnt_);
+  EXPECT_EQ("obj1", ta.obj_.id_);
+  EXPECT_EQ(World::UPDATE_SHAPE, ta.action_);
+  ASSERT_EQ(1u, ta.obj_.shapes_.size());
+  EXPECT_EQ(box, ta.obj_.shapes_[0]);
+
+  // unknown objects are not reported
+  EXPECT_FALSE(world.notifyShapesUpdated("obj2"));
+  EXPECT_EQ(2, ta.cnt_);
+
+  world.removeObserver(observer_ta);
+}
+
+TEST(World, CopyOnWrite)
+{
+  World world;
+  shapes::ShapePtr ball = std::make_shared<shapes::Sphere>(1.0);
+  shapes::ShapePtr box = std::make_shared<shapes::Box>(1, 2, 3);
+  world.addToObject("ball", ball, Eigen::Isometry3d::Identity());
+  world.addToObject("box", box, Eigen::Isometry3d::Identity());
+
+  // a copy shares all objects until they are modified
+  World copy(world);
+  EXPECT_EQ(world.getObject("ball"), copy.getObject("ball"));
+  EXPECT_EQ(world.getObject("box"), copy.getObject("box"));
+
+  EXPECT_TRUE(copy.moveObject("ball", Eigen::Isometry3d(Eigen::Translation3d(0, 0, 1))));
+  EXPECT_NE(world.getObject("ball"), copy.getObject("ball"));
+  EXPECT_EQ(world.getObject("box"), copy.getObject("box"));
+  EXPECT_EQ(0.0, world.getObject("ball")->pose_(2, 3));
+  EXPECT_EQ(1.0, copy.getObject("ball")->pose_(2, 3));
+
+  moveit::core::FixedTransformsMap subframes;
+  subframes["frame"] = Eigen::Isometry3d(Eigen::Translation3d(0, 1, 0));
+  EXPECT_TRUE(copy.setSubframesOfObject("box", subframes));
+  EXPECT_TRUE(world.getObject("box")->subframe_poses_.empty());
+  EXPECT_EQ(1u, copy.getObject("box")->subframe_poses_.size());
+
+  EXPECT_TRUE(copy.removeObject("box"));
+  EXPECT_TRUE(world.hasObject("box"));
+  copy.clearObjects();
+  EXPECT_EQ(2u, world.size());
+  EXPECT_EQ(0u, copy.size());
+}
+
+TEST(World, ChangedObjectIds)
+{
+  World world;
+  shapes::ShapePtr ball = std::make_shared<shapes::Sphere>(1.0);
+  shapes::ShapePtr box = std::make_shared<shapes::Box>(1, 2, 3);
+  const std::uint64_t empty = world.getVersion();
+  world.addToObject("ball", ball, Eigen::Isometry3d::Identity());
+  const std::uint64_t with_ball = world.getVersion();
+  EXPECT_NE(empty, with_ball);
+  world.addToObject("box", box, Eigen::Isometry3d::Identity());
+
+  std::set<std::string> ids;
+  EXPECT_TRUE(world.getChangedObjectIds(with_ball, ids));
+  EXPECT_EQ(std::set<std::string>({ "box" }), ids);
+  ids.clear();
+  EXPECT_TRUE(world.getChangedObjectIds(empty, ids));
+  EXPECT_EQ(std::set<std::string>({ "ball", "box" }), ids);
+  ids.clear();
+  EXPECT_TRUE(world.getChangedObjectIds(world.getVersion(), ids));
+  EXPECT_TRUE(ids.empty());
+
+  // a copy shares the history up to the copy, but not the later changes of the original
+  World copy(world);
+  EXPECT_EQ(world.getVersion(), copy.getVersion());
+  const std::uint64_t copied = world.getVersion();
+  EXPECT_TRUE(world.removeObject("ball"));
+  EXPECT_TRUE(copy.setSubframesOfObject("box", moveit::core::FixedTransformsMap()));
+  EXPECT_NE(world.getVersion(), copy.getVersion());
+  ids.clear();
+  EXPECT_TRUE(copy.getChangedObjectIds(copied, ids));
+  EXPECT_EQ(std::set<std::string>({ "box" }), ids);
+  ids.clear();
+  EXPECT_FALSE(copy.getChangedObjectIds(world.getVersion(), ids));
+  EXPECT_FALSE(World().getChangedObjectIds(copied, ids));
+
+  // old versions are dropped from the history eventually
+  for (int i = 0; i < 5000; ++i)
+    world.moveObject("box", Eigen::Isometry3d(Eigen::Translation3d(0, 0, 1)));
+  EXPECT_FALSE(world.getChangedObjectIds(copied, ids));
+  EXPECT_TRUE(copy.getChangedObjectIds(copied, ids));
+}
+
+TEST(World, Restore)
+{
+  World world;
+  shapes::ShapePtr ball = std::make_shared<shapes::Sphere>(1.0);
+  shapes::ShapePtr box = std::make_shared<shapes::Box>(1, 2, 3);
+  world.addToObject("ball", ball, Eigen::Isometry3d::Identity());
+  world.addToObject("box", box, Eigen::Isometry3d::Identity());
+  world.addToObject("unchanged", box, Eigen::Isometry3d::Identity());
+  const World saved(world);
+
+  world.moveObject("ball", Eigen::Isometry3d(Eigen::Translation3d(0, 0, 1)));
+  world.removeObject("box");
+  world.addToObject("new", ball, Eigen::Isometry3d::Identity());
+
+  TestAction ta;
+  World::ObserverHandle observer_ta = world.addObserver(
+      [&ta](const World::ObjectConstPtr& object, World::Action action) { TrackChangesNotify(ta, object, action); });
+  world.restore(saved);
+
+  /* ball is replaced (destroy + create), box is created and new is destroyed */
+  EXPECT_EQ(4, ta.cnt_);
+  EXPECT_EQ(3u, world.size());
+  EXPECT_FALSE(world.hasObject("new"));
+  EXPECT_EQ(saved.getObject("ball"), world.getObject("ball"));
+  EXPECT_EQ(saved.getObject("box"), world.getObject("box"));
+  EXPECT_EQ(saved.getObject("unchanged"), world.getObject("unchanged"));
+  EXPECT_EQ(0.0, world.getObject("ball")->pose_(2, 3));
+
+  /* restored objects are still copied on write */
+  world.moveObject("ball", Eigen::Isometry3d(Eigen::Translation3d(0, 0, 1)));
+  EXPECT_EQ(0.0, saved.getObject("ball")->pose_(2, 3));
+  world.removeObserver(observer_ta);
+}
+
 TEST(World, ObjectPoseAndSubframes)
 {
   World world;
@@ -458,6 +598,108 @@ TEST(World, ObjectPoseAndSubframes)
   EXPECT_EQ(1.0, pose(2, 3));  // z
 }
 
+namespace
+{
+std::vector<std::string> sorted(std::vector<std::string> ids)
+{
+  std::sort(ids.begin(), ids.end());
+  return ids;
+}
+}  // namespace
+
+TEST(World, ObjectBoundingBox)
+{
+  World world;
+  shapes::ShapePtr box = std::make_shared<shapes::Box>(1, 2, 3);
+  Eigen::Isometry3d rotated(Eigen::AngleAxisd(M_PI / 2, Eigen::Vector3d::UnitZ()));
+  world.addToObject("box", Eigen::Isometry3d(Eigen::Translation3d(1, 0, 0)), box, rotated);
+
+  const Eigen::AlignedBox3d aabb = World::getObjectBoundingBox(*world.getObject("box"));
+  EXPECT_TRUE(aabb.min().isApprox(Eigen::Vector3d(0, -0.5, -1.5)));
+  EXPECT_TRUE(aabb.max().isApprox(Eigen::Vector3d(2, 0.5, 1.5)));
+
+  world.addToObject("plane", std::make_shared<shapes::Plane>(0, 0, 1, 0), Eigen::Isometry3d::Identity());
+  EXPECT_FALSE(World::getObjectBoundingBox(*world.getObject("plane")).max().allFinite());
+}
+
+TEST(World, SpatialQueries)
+{
+  World world;
+  shapes::ShapePtr ball = std::make_shared<shapes::Sphere>(0.1);
+  for (int i = 0; i < 10; ++i)
+    world.addToObject("ball" + std::to_string(i), Eigen::Isometry3d(Eigen::Translation3d(i, 0, 0)), ball,
+                      Eigen::Isometry3d::Identity());
+
+  const Eigen::AlignedBox3d query(Eigen::Vector3d(1.5, -1, -1), Eigen::Vector3d(3, 1, 1));
+  EXPECT_EQ(sorted(world.queryObjectsInBox(query)), std::vector<std::string>({ "ball2", "ball3" }));
+  EXPECT_TRUE(world.queryObjectsInBox(Eigen::AlignedBox3d(Eigen::Vector3d(0, 1, 0), Eigen::Vector3d(9, 2, 1))).empty());
+
+  // a segment parallel to the row of balls passes them at a distance of 0.5
+  const Eigen::Vector3d start(3.8, 0.6, 0);
+  const Eigen::Vector3d end(5.2, 0.6, 0);
+  EXPECT_TRUE(world.queryObjectsNearSegment(start, end, 0.4).empty());
+  EXPECT_EQ(sorted(world.queryObjectsNearSegment(start, end, 0.6)), std::vector<std::string>({ "ball4", "ball5" }));
+
+  // the index follows changes made after it was built
+  world.setObjectPose("ball4", Eigen::Isometry3d(Eigen::Translation3d(4, 5, 0)));
+  world.removeObject("ball5");
+  world.addToObject("new", ball, Eigen::Isometry3d(Eigen::Translation3d(5, 0.3, 0)));
+  EXPECT_EQ(sorted(world.queryObjectsNearSegment(start, end, 0.4)), std::vector<std::string>({ "new" }));
+
+  // copies build their own index, planes are always reported
+  World copy(world);
+  copy.addToObject("plane", std::make_shared<shapes::Plane>(0, 0, 1, 0), Eigen::Isometry3d::Identity());
+  EXPECT_EQ(sorted(copy.queryObjectsNearSegment(start, end, 0.4)), std::vector<std::string>({ "new", "plane" }));
+  EXPECT_EQ(sorted(world.queryObjectsNearSegment(start, end, 0.4)), std::vector<std::string>({ "new" }));
+
+  world.clearObjects();
+  EXPECT_TRUE(world.queryObjectsInBox(Eigen::AlignedBox3d(Eigen::Vector3d::Constant(-10), Eigen::Vector3d::Constant(10)))
+                  .empty());
+}
+
+TEST(AABBTree, MatchesBruteForce)
+{
+  AABBTree tree;
+  std::map<std::string, Eigen::AlignedBox3d> boxes;
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<double> position(-10.0, 10.0);
+  std::uniform_real_distribution<double> extent(0.01, 1.0);
+  const auto random_box = [&]() {
+    const Eigen::Vector3d min(position(gen), position(gen), position(gen));
+    return Eigen::AlignedBox3d(min, min + Eigen::Vector3d(extent(gen), extent(gen), extent(gen)));
+  };
+
+  for (int i = 0; i < 2000; ++i)
+  {
+    const std::string id = "box" + std::to_string(gen() % 500);
+    if (gen() % 4 == 0)
+    {
+      EXPECT_EQ(tree.remove(id), boxes.erase(id) == 1);
+    }
+    else
+    {
+      boxes[id] = random_box();
+      tree.update(id, boxes[id]);
+    }
+  }
+  ASSERT_EQ(tree.size(), boxes.size());
+  // balanced by rotations, so far lower than the number of boxes
+  EXPECT_LT(tree.height(), 25);
+
+  for (int i = 0; i < 100; ++i)
+  {
+    Eigen::AlignedBox3d query = random_box();
+    query.max() += Eigen::Vector3d::Constant(2.0);
+    std::vector<std::string> expected;
+    for (const auto& box : boxes)
+      if (box.second.intersects(query))
+        expected.push_back(box.first);
+    std::vector<std::string> ids;
+    tree.query(query, ids);
+    EXPECT_EQ(sorted(ids), expected);
+  }
+}
+
 int main(int argc, char** argv)
 {
   testing::InitGoogleTest(&argc, argv);
@@ -99,6 +99,15 @@ public:
    * @return The contact distance */
   double getContactDistanceThreshold() const;
 
+  /**@brief Restrict discrete contact tests to a subset of the collision pairs
+   *
+   * The pairs are split into \e count disjoint partitions by the names of their objects. Managers with the same
+   * objects and different \e index together check every pair once, which allows splitting a contact test across
+   * several managers. The default is a single partition containing all pairs.
+   * @param index The partition checked by this manager
+   * @param count The number of partitions */
+  void setPairPartition(std::size_t index, std::size_t count);
+
   /**@brief Perform a contact test for all objects
    * @param collisions The Contact results data
    * @param req The collision request data
@@ -139,6 +148,10 @@ protected:
   /** @brief The contact distance threshold */
   double contact_distance_;
 
+  /** @brief The partition of collision pairs checked by contactTest(), see setPairPartition() */
+  std::size_t partition_index_{ 0 };
+  std::size_t partition_count_{ 1 };
+
   /** @brief The bullet collision dispatcher used for getting object to object collision algorithm */
   std::unique_ptr<btCollisionDispatcher> dispatcher_;
 
@@ -43,6 +43,8 @@
 #include <moveit/collision_detection/collision_common.h>
 #include <moveit/macros/declare_ptr.h>
 #include <moveit/macros/class_forward.h>
+#include <functional>
+#include <string>
 
 namespace collision_detection_bullet
 {
@@ -542,6 +544,10 @@ struct BroadphaseContactResultCallback
   /** \brief Indicates if the callback is used for casted collisions */
   bool cast_{ false };
 
+  /** \brief Only pairs whose name hash modulo \e partition_count_ equals \e partition_index_ are checked */
+  std::size_t partition_index_{ 0 };
+  std::size_t partition_count_{ 1 };
+
   BroadphaseContactResultCallback(ContactTestData& collisions, double contact_distance,
                                   const collision_detection::AllowedCollisionMatrix* acm, bool self, bool cast = false)
     : collisions_(collisions), contact_distance_(contact_distance), acm_(acm), self_(self), cast_(cast)
@@ -562,10 +568,19 @@ struct BroadphaseContactResultCallback
     else
     {
       return !collisions_.done && (self_ ? isOnlyKinematic(cow0, cow1) : !isOnlyKinematic(cow0, cow1)) &&
-             !acmCheck(cow0->getName(), cow1->getName(), acm_);
+             inPartition(cow0, cow1) && !acmCheck(cow0->getName(), cow1->getName(), acm_);
     }
   }
 
+  /** \brief Check whether the pair belongs to the partition of pairs this callback is responsible for */
+  bool inPartition(const CollisionObjectWrapper* cow0, const CollisionObjectWrapper* cow1) const
+  {
+    if (partition_count_ <= 1)
+      return true;
+    const std::hash<std::string> hash;
+    return (hash(cow0->getName()) ^ hash(cow1->getName())) % partition_count_ == partition_index_;
+  }
+
   /** \brief This callback is used after btManifoldResult processed a collision result. */
   btScalar addSingleResult(btManifoldPoint& cp, const btCollisionObjectWrapper* colObj0Wrap, int partId0, int index0,
                            const btCollisionObjectWrapper* colObj1Wrap, int partId1, int index1);
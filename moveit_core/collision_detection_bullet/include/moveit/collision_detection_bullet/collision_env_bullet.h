@@ -40,6 +40,7 @@
 #include <moveit/collision_detection_bullet/bullet_integration/bullet_discrete_bvh_manager.h>
 #include <moveit/collision_detection_bullet/bullet_integration/bullet_cast_bvh_manager.h>
 #include <mutex>
+#include <vector>
 
 namespace collision_detection
 {
@@ -78,6 +79,12 @@ public:
   void checkRobotCollision(const CollisionRequest& req, CollisionResult& res, const moveit::core::RobotState& state1,
                            const moveit::core::RobotState& state2, const AllowedCollisionMatrix& acm) const override;
 
+  /** \brief Checks the states concurrently, each thread on its own clone of the collision manager. Small batches are
+   *   checked on the calling thread, locking the shared manager once for the whole batch. */
+  void checkCollisionBatch(const CollisionRequest& req, std::vector<CollisionResult>& res,
+                           const std::vector<const moveit::core::RobotState*>& states,
+                           const AllowedCollisionMatrix& acm) const override;
+
   void distanceSelf(const DistanceRequest& req, DistanceResult& res,
                     const moveit::core::RobotState& state) const override;
 
@@ -86,6 +93,17 @@ public:
 
   void setWorld(const WorldPtr& world) override;
 
+  /** \brief Set the number of threads a single discrete collision check is split across.
+   *
+   *   With more than one thread, the collision pairs are partitioned between worker managers that are kept across
+   *   checks, each running its own broadphase and narrowphase. The results are merged in a fixed order of the
+   *   pairs. This pays off for scenes with many mesh contacts; a value of 1 (the default) checks on the calling
+   *   thread. */
+  void setContactTestThreadCount(std::size_t thread_count);
+
+  /** \brief Get the number of threads a single discrete collision check is split across */
+  std::size_t getContactTestThreadCount() const;
+
 protected:
   /** \brief Updates the poses of the objects in the manager according to given robot state */
   void updateTransformsFromState(const moveit::core::RobotState& state,
@@ -110,6 +128,21 @@ protected:
   void checkRobotCollisionHelper(const CollisionRequest& req, CollisionResult& res,
                                  const moveit::core::RobotState& state, const AllowedCollisionMatrix* acm) const;
 
+  /** \brief Self-collision check on \e manager. The caller must have exclusive access to \e manager. */
+  void checkSelfCollisionWithManager(const CollisionRequest& req, CollisionResult& res,
+                                     const moveit::core::RobotState& state, const AllowedCollisionMatrix* acm,
+                                     const collision_detection_bullet::BulletDiscreteBVHManagerPtr& manager) const;
+
+  /** \brief Robot-world collision check on \e manager. The caller must have exclusive access to \e manager. */
+  void checkRobotCollisionWithManager(const CollisionRequest& req, CollisionResult& res,
+                                      const moveit::core::RobotState& state, const AllowedCollisionMatrix* acm,
+                                      const collision_detection_bullet::BulletDiscreteBVHManagerPtr& manager) const;
+
+  /** \brief Contact test split across the worker managers, see setContactTestThreadCount(). The caller must hold
+   *   collision_env_mutex_. */
+  void contactTestParallel(const CollisionRequest& req, CollisionResult& res, const moveit::core::RobotState& state,
+                           const AllowedCollisionMatrix* acm, bool self) const;
+
   /** \brief Construts a bullet collision object out of a robot link */
   void addLinkAsCollisionObject(const urdf::LinkSharedPtr& link);
 
@@ -126,6 +159,13 @@ protected:
   // Lock manager_ and manager_CCD_, for thread-safe collision tests
   mutable std::mutex collision_env_mutex_;
 
+  /** \brief The number of threads a single discrete collision check is split across */
+  std::size_t contact_test_thread_count_{ 1 };
+
+  /** \brief Clones of manager_ that each check one partition of the collision pairs, created on demand and discarded
+   *   when manager_ changes. Protected by collision_env_mutex_. */
+  mutable std::vector<collision_detection_bullet::BulletDiscreteBVHManagerPtr> worker_managers_;
+
   /** \brief Adds a world object to the collision managers */
   void addToManager(const World::Object* obj);
 
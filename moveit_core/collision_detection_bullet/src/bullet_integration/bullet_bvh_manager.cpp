@@ -32,6 +32,7 @@
 /* Authors: Levi Armstrong, Jens Petit */
 
 #include <moveit/collision_detection_bullet/bullet_integration/bullet_bvh_manager.h>
+#include <algorithm>
 #include <map>
 #include <utility>
 
@@ -155,6 +156,12 @@ void BulletBVHManager::setContactDistanceThreshold(double contact_distance)
   }
 }
 
+void BulletBVHManager::setPairPartition(std::size_t index, std::size_t count)
+{
+  partition_count_ = std::max<std::size_t>(count, 1);
+  partition_index_ = index % partition_count_;
+}
+
 double BulletBVHManager::getContactDistanceThreshold() const
 {
   return contact_distance_;
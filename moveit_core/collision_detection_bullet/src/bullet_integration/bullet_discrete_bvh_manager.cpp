@@ -74,6 +74,8 @@ void BulletDiscreteBVHManager::contactTest(collision_detection::CollisionResult&
   RCLCPP_DEBUG_STREAM(BULLET_LOGGER, "Num overlapping candidates " << pair_cache->getNumOverlappingPairs());
 
   BroadphaseContactResultCallback cc(cdata, contact_distance_, acm, self);
+  cc.partition_index_ = partition_index_;
+  cc.partition_count_ = partition_count_;
   TesseractCollisionPairCallback collision_callback(dispatch_info_, dispatcher_.get(), cc);
   pair_cache->processAllOverlappingPairs(&collision_callback, dispatcher_.get());
 
@@ -38,7 +38,12 @@
 #include <moveit/collision_detection_bullet/collision_detector_allocator_bullet.h>
 #include <moveit/collision_detection_bullet/bullet_integration/ros_bullet_utils.h>
 #include <moveit/collision_detection_bullet/bullet_integration/contact_checker_common.h>
+#include <moveit/collision_detection/convex_decomposition.h>
+#include <algorithm>
 #include <functional>
+#include <iterator>
+#include <limits>
+#include <thread>
 #include <bullet/btBulletCollisionCommon.h>
 #include <rclcpp/logger.hpp>
 #include <rclcpp/logging.hpp>
@@ -49,6 +54,35 @@ static const rclcpp::Logger LOGGER = rclcpp::get_logger("moveit.core.collision_d
 const std::string CollisionDetectorAllocatorBullet::NAME("Bullet");
 const double MAX_DISTANCE_MARGIN = 99;
 
+namespace
+{
+/** \brief Append \e shape at \e pose for a collision object wrapper. If convex decomposition is enabled, meshes are
+ *  appended as their convex parts, otherwise as their convex hull. */
+void appendShape(const shapes::ShapeConstPtr& shape, const Eigen::Isometry3d& pose,
+                 std::vector<shapes::ShapeConstPtr>& shapes,
+                 collision_detection_bullet::AlignedVector<Eigen::Isometry3d>& shape_poses,
+                 std::vector<collision_detection_bullet::CollisionObjectType>& collision_object_types)
+{
+  if (shape->type != shapes::MESH)
+  {
+    shapes.push_back(shape);
+    shape_poses.push_back(pose);
+    collision_object_types.push_back(collision_detection_bullet::CollisionObjectType::USE_SHAPE_TYPE);
+    return;
+  }
+
+  std::vector<shapes::ShapeConstPtr> parts = ConvexDecompositionCache::instance().getConvexParts(shape);
+  if (parts.empty())
+    parts.push_back(shape);
+  for (const shapes::ShapeConstPtr& part : parts)
+  {
+    shapes.push_back(part);
+    shape_poses.push_back(pose);
+    collision_object_types.push_back(collision_detection_bullet::CollisionObjectType::CONVEX_HULL);
+  }
+}
+}  // namespace
+
 CollisionEnvBullet::CollisionEnvBullet(const moveit::core::RobotModelConstPtr& model, double padding, double scale)
   : CollisionEnv(model, padding, scale)
 {
@@ -117,33 +151,47 @@ void CollisionEnvBullet::checkSelfCollisionHelper(const CollisionRequest& req, C
                                                   const AllowedCollisionMatrix* acm) const
 {
   std::lock_guard<std::mutex> guard(collision_env_mutex_);
+  // pairs closer than the contact distance are reported as contacts, so the spheres need to keep it as well
+  if (!req.distance && !req.cost &&
+      areLinkBoundingSpheresSeparated(state, acm, manager_->getContactDistanceThreshold()))
+    return;
 
+  if (contact_test_thread_count_ > 1)
+    contactTestParallel(req, res, state, acm, true);
+  else
+    checkSelfCollisionWithManager(req, res, state, acm, manager_);
+}
+
+void CollisionEnvBullet::checkSelfCollisionWithManager(
+    const CollisionRequest& req, CollisionResult& res, const moveit::core::RobotState& state,
+    const AllowedCollisionMatrix* acm, const collision_detection_bullet::BulletDiscreteBVHManagerPtr& manager) const
+{
   std::vector<collision_detection_bullet::CollisionObjectWrapperPtr> cows;
   addAttachedOjects(state, cows);
 
   if (req.distance)
   {
-    manager_->setContactDistanceThreshold(MAX_DISTANCE_MARGIN);
+    manager->setContactDistanceThreshold(MAX_DISTANCE_MARGIN);
   }
 
   for (const collision_detection_bullet::CollisionObjectWrapperPtr& cow : cows)
   {
-    manager_->addCollisionObject(cow);
-    manager_->setCollisionObjectsTransform(
+    manager->addCollisionObject(cow);
+    manager->setCollisionObjectsTransform(
         cow->getName(), state.getAttachedBody(cow->getName())->getGlobalCollisionBodyTransforms()[0]);
   }
 
   // updating link positions with the current robot state
   for (const std::string& link : active_)
   {
-    manager_->setCollisionObjectsTransform(link, state.getCollisionBodyTransform(link, 0));
+    manager->setCollisionObjectsTransform(link, state.getCollisionBodyTransform(link, 0));
   }
 
-  manager_->contactTest(res, req, acm, true);
+  manager->contactTest(res, req, acm, true);
 
   for (const collision_detection_bullet::CollisionObjectWrapperPtr& cow : cows)
   {
-    manager_->removeCollisionObject(cow->getName());
+    manager->removeCollisionObject(cow->getName());
   }
 }
 
@@ -180,31 +228,135 @@ void CollisionEnvBullet::checkRobotCollisionHelper(const CollisionRequest& req,
                                                    const AllowedCollisionMatrix* acm) const
 {
   std::lock_guard<std::mutex> guard(collision_env_mutex_);
+  if (contact_test_thread_count_ > 1)
+    contactTestParallel(req, res, state, acm, false);
+  else
+    checkRobotCollisionWithManager(req, res, state, acm, manager_);
+}
 
+void CollisionEnvBullet::checkRobotCollisionWithManager(
+    const CollisionRequest& req, CollisionResult& res, const moveit::core::RobotState& state,
+    const AllowedCollisionMatrix* acm, const collision_detection_bullet::BulletDiscreteBVHManagerPtr& manager) const
+{
   if (req.distance)
   {
-    manager_->setContactDistanceThreshold(MAX_DISTANCE_MARGIN);
+    manager->setContactDistanceThreshold(MAX_DISTANCE_MARGIN);
   }
 
   std::vector<collision_detection_bullet::CollisionObjectWrapperPtr> attached_cows;
   addAttachedOjects(state, attached_cows);
-  updateTransformsFromState(state, manager_);
+  updateTransformsFromState(state, manager);
 
   for (const collision_detection_bullet::CollisionObjectWrapperPtr& cow : attached_cows)
   {
-    manager_->addCollisionObject(cow);
-    manager_->setCollisionObjectsTransform(
+    manager->addCollisionObject(cow);
+    manager->setCollisionObjectsTransform(
         cow->getName(), state.getAttachedBody(cow->getName())->getGlobalCollisionBodyTransforms()[0]);
   }
 
-  manager_->contactTest(res, req, acm, false);
+  manager->contactTest(res, req, acm, false);
 
   for (const collision_detection_bullet::CollisionObjectWrapperPtr& cow : attached_cows)
   {
-    manager_->removeCollisionObject(cow->getName());
+    manager->removeCollisionObject(cow->getName());
+  }
+}
+
+void CollisionEnvBullet::contactTestParallel(const CollisionRequest& req, CollisionResult& res,
+                                             const moveit::core::RobotState& state, const AllowedCollisionMatrix* acm,
+                                             bool self) const
+{
+  const std::size_t thread_count = contact_test_thread_count_;
+  while (worker_managers_.size() < thread_count)
+    worker_managers_.push_back(manager_->clone());
+
+  // without contacts, the result is the combination of the partial results; otherwise the contacts of every pair are
+  // collected and added below as a serial check would have added them
+  CollisionRequest worker_req = req;
+  if (req.contacts)
+    worker_req.max_contacts = std::numeric_limits<std::size_t>::max();
+
+  std::vector<CollisionResult> parts(thread_count);
+  auto check = [&](std::size_t i) {
+    worker_managers_[i]->setPairPartition(i, thread_count);
+    if (self)
+      checkSelfCollisionWithManager(worker_req, parts[i], state, acm, worker_managers_[i]);
+    else
+      checkRobotCollisionWithManager(worker_req, parts[i], state, acm, worker_managers_[i]);
+  };
+  std::vector<std::thread> threads;
+  threads.reserve(thread_count - 1);
+  for (std::size_t i = 1; i < thread_count; ++i)
+    threads.emplace_back(check, i);
+  check(0);
+  for (std::thread& thread : threads)
+    thread.join();
+
+  if (!req.contacts)
+  {
+    for (const CollisionResult& part : parts)
+    {
+      res.collision = res.collision || part.collision;
+      if (req.distance)
+        res.distance = std::min(res.distance, part.distance);
+    }
+    return;
+  }
+
+  // the pairs are disjoint between the partitions; add them in the order of their names
+  CollisionResult::ContactMap contacts;
+  for (CollisionResult& part : parts)
+    contacts.insert(std::make_move_iterator(part.contacts.begin()), std::make_move_iterator(part.contacts.end()));
+
+  const double contact_distance = manager_->getContactDistanceThreshold();
+  collision_detection_bullet::ContactTestData cdata(active_, contact_distance, res, req);
+  for (std::pair<const std::pair<std::string, std::string>, std::vector<Contact>>& pair : contacts)
+  {
+    cdata.pair_done = false;
+    for (Contact& contact : pair.second)
+    {
+      if (cdata.done || cdata.pair_done)
+        break;
+      collision_detection_bullet::processResult(cdata, contact, pair.first,
+                                                res.contacts.find(pair.first) != res.contacts.end());
+    }
+    if (cdata.done)
+      break;
   }
 }
 
+void CollisionEnvBullet::checkCollisionBatch(const CollisionRequest& req, std::vector<CollisionResult>& res,
+                                             const std::vector<const moveit::core::RobotState*>& states,
+                                             const AllowedCollisionMatrix& acm) const
+{
+  res.resize(states.size());
+  auto check = [&](const collision_detection_bullet::BulletDiscreteBVHManagerPtr& manager, std::size_t i) {
+    res[i].clear();
+    checkSelfCollisionWithManager(req, res[i], *states[i], &acm, manager);
+    if (!res[i].collision || (req.contacts && res[i].contacts.size() < req.max_contacts))
+      checkRobotCollisionWithManager(req, res[i], *states[i], &acm, manager);
+  };
+
+  const std::size_t thread_count = getBatchThreadCount(states.size());
+  if (thread_count == 1)
+  {
+    // hold the lock once for the whole batch instead of twice per state
+    std::lock_guard<std::mutex> guard(collision_env_mutex_);
+    for (std::size_t i = 0; i < states.size(); ++i)
+      check(manager_, i);
+    return;
+  }
+
+  // every thread works on its own copy of the manager, following the advice of BulletDiscreteBVHManager::clone()
+  std::vector<collision_detection_bullet::BulletDiscreteBVHManagerPtr> managers(thread_count);
+  {
+    std::lock_guard<std::mutex> guard(collision_env_mutex_);
+    for (collision_detection_bullet::BulletDiscreteBVHManagerPtr& manager : managers)
+      manager = manager_->clone();
+  }
+  forEachInBatch(states.size(), [&](std::size_t thread, std::size_t i) { check(managers[thread], i); });
+}
+
 void CollisionEnvBullet::checkRobotCollisionHelperCCD(const CollisionRequest& req, CollisionResult& res,
                                                       const moveit::core::RobotState& state1,
                                                       const moveit::core::RobotState& state2,
@@ -251,19 +403,15 @@ void CollisionEnvBullet::distanceRobot(const DistanceRequest& /*req*/, DistanceR
 
 void CollisionEnvBullet::addToManager(const World::Object* obj)
 {
+  std::vector<shapes::ShapeConstPtr> shapes;
+  collision_detection_bullet::AlignedVector<Eigen::Isometry3d> shape_poses;
   std::vector<collision_detection_bullet::CollisionObjectType> collision_object_types;
 
-  for (const shapes::ShapeConstPtr& shape : obj->shapes_)
-  {
-    if (shape->type == shapes::MESH)
-      collision_object_types.push_back(collision_detection_bullet::CollisionObjectType::CONVEX_HULL);
-    else
-      collision_object_types.push_back(collision_detection_bullet::CollisionObjectType::USE_SHAPE_TYPE);
-  }
+  for (std::size_t i = 0; i < obj->shapes_.size(); ++i)
+    appendShape(obj->shapes_[i], obj->global_shape_poses_[i], shapes, shape_poses, collision_object_types);
 
   auto cow = std::make_shared<collision_detection_bullet::CollisionObjectWrapper>(
-      obj->id_, collision_detection::BodyType::WORLD_OBJECT, obj->shapes_, obj->global_shape_poses_,
-      collision_object_types, false);
+      obj->id_, collision_detection::BodyType::WORLD_OBJECT, shapes, shape_poses, collision_object_types, false);
 
   manager_->addCollisionObject(cow);
   manager_CCD_->addCollisionObject(cow->clone());
@@ -313,9 +461,24 @@ void CollisionEnvBullet::setWorld(const WorldPtr& world)
   getWorld()->notifyObserverAllObjects(observer_handle_, World::CREATE);
 }
 
+void CollisionEnvBullet::setContactTestThreadCount(std::size_t thread_count)
+{
+  std::lock_guard<std::mutex> guard(collision_env_mutex_);
+  contact_test_thread_count_ = std::max<std::size_t>(thread_count, 1);
+  if (worker_managers_.size() > contact_test_thread_count_)
+    worker_managers_.resize(contact_test_thread_count_);
+}
+
+std::size_t CollisionEnvBullet::getContactTestThreadCount() const
+{
+  std::lock_guard<std::mutex> guard(collision_env_mutex_);
+  return contact_test_thread_count_;
+}
+
 void CollisionEnvBullet::notifyObjectChange(const ObjectConstPtr& obj, World::Action action)
 {
   std::lock_guard<std::mutex> guard(collision_env_mutex_);
+  worker_managers_.clear();
   if (action == World::DESTROY)
   {
     manager_->removeCollisionObject(obj->id_);
@@ -357,6 +520,7 @@ void CollisionEnvBullet::addAttachedOjects(const moveit::core::RobotState& state
 
 void CollisionEnvBullet::updatedPaddingOrScaling(const std::vector<std::string>& links)
 {
+  worker_managers_.clear();
   for (const std::string& link : links)
   {
     if (robot_model_->getURDF()->links_.find(link) != robot_model_->getURDF()->links_.end())
@@ -407,17 +571,8 @@ void CollisionEnvBullet::addLinkAsCollisionObject(const urdf::LinkSharedPtr& lin
             shape->scaleAndPadd(getLinkScale(link->name), getLinkPadding(link->name));
           }
 
-          shapes.push_back(shape);
-          shape_poses.push_back(collision_detection_bullet::urdfPose2Eigen(i->origin));
-
-          if (shape->type == shapes::MESH)
-          {
-            collision_object_types.push_back(collision_detection_bullet::CollisionObjectType::CONVEX_HULL);
-          }
-          else
-          {
-            collision_object_types.push_back(collision_detection_bullet::CollisionObjectType::USE_SHAPE_TYPE);
-          }
+          appendShape(shape, collision_detection_bullet::urdfPose2Eigen(i->origin), shapes, shape_poses,
+                      collision_object_types);
         }
       }
     }
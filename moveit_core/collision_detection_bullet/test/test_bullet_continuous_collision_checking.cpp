@@ -323,6 +323,61 @@ TEST_F(BulletCollisionDetectionTester, ContinuousCollisionWorld)
   res.clear();
 }
 
+/** \brief Splitting a discrete check across threads reports the same contacts as a check on a single thread. */
+TEST_F(BulletCollisionDetectionTester, ParallelContactTest)
+{
+  auto world = std::make_shared<collision_detection::World>();
+  shapes::ShapeConstPtr box(new shapes::Box(0.3, 0.3, 0.3));
+  Eigen::Isometry3d pos{ Eigen::Isometry3d::Identity() };
+  pos.translation() = Eigen::Vector3d(0.1, 0.0, 0.6);
+  world->addToObject("box", box, pos);
+
+  collision_detection::CollisionEnvBullet serial_env(robot_model_, world);
+  collision_detection::CollisionEnvBullet parallel_env(robot_model_, world);
+  parallel_env.setContactTestThreadCount(4);
+  EXPECT_EQ(parallel_env.getContactTestThreadCount(), 4u);
+
+  moveit::core::RobotState state(robot_model_);
+  state.setToDefaultValues();
+  state.update();
+
+  for (bool contacts : { false, true })
+  {
+    collision_detection::CollisionRequest req;
+    req.contacts = contacts;
+    req.max_contacts = 100;
+    req.max_contacts_per_pair = 2;
+
+    collision_detection::CollisionResult serial_res, parallel_res;
+    serial_env.checkRobotCollision(req, serial_res, state, *acm_);
+    parallel_env.checkRobotCollision(req, parallel_res, state, *acm_);
+    EXPECT_TRUE(serial_res.collision);
+    EXPECT_EQ(serial_res.collision, parallel_res.collision);
+    EXPECT_EQ(serial_res.contact_count, parallel_res.contact_count);
+    ASSERT_EQ(serial_res.contacts.size(), parallel_res.contacts.size());
+    for (const auto& pair : serial_res.contacts)
+    {
+      auto it = parallel_res.contacts.find(pair.first);
+      ASSERT_NE(it, parallel_res.contacts.end()) << pair.first.first << " " << pair.first.second;
+      EXPECT_EQ(pair.second.size(), it->second.size());
+    }
+
+    serial_res.clear();
+    parallel_res.clear();
+    serial_env.checkSelfCollision(req, serial_res, state, *acm_);
+    parallel_env.checkSelfCollision(req, parallel_res, state, *acm_);
+    EXPECT_EQ(serial_res.collision, parallel_res.collision);
+    EXPECT_EQ(serial_res.contacts.size(), parallel_res.contacts.size());
+  }
+
+  // the worker managers follow changes of the world
+  world->removeObject("box");
+  collision_detection::CollisionRequest req;
+  collision_detection::CollisionResult res;
+  parallel_env.checkRobotCollision(req, res, state, *acm_);
+  EXPECT_FALSE(res.collision);
+}
+
 TEST(ContinuousCollisionUnit, BulletCastBVHCollisionBoxBoxUnit)
 {
   collision_detection::CollisionResult result;
@@ -52,12 +52,48 @@
 #include <fcl/distance.h>
 #endif
 
+#include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 
+namespace octomap
+{
+class OcTree;
+}
+
 namespace collision_detection
 {
 MOVEIT_STRUCT_FORWARD(CollisionGeometryData);
+MOVEIT_CLASS_FORWARD(OcTreeLevelOfDetail);
+class OccMapTree;
+
+/** \brief Coarse copies of an octree for level-of-detail collision culling. The occupied voxels are merged into cells
+ *  that are 2^levels times larger, so a body that does not collide with a coarse copy cannot collide with the octree.
+ *  Copies are built on first use and rebuilt after modifications of a collision_detection::OccMapTree. */
+class OcTreeLevelOfDetail
+{
+public:
+  OcTreeLevelOfDetail(const std::shared_ptr<const octomap::OcTree>& octree);
+
+  /** \brief Get the FCL geometry of the octree with its \e levels finest levels merged. Thread-safe. */
+  std::shared_ptr<fcl::CollisionGeometryd> getCoarseGeometry(unsigned int levels);
+
+private:
+  struct CoarseTree
+  {
+    std::size_t version;
+    std::shared_ptr<fcl::CollisionGeometryd> geometry;
+  };
+
+  std::shared_ptr<const octomap::OcTree> octree_;
+
+  /** \brief Set if \e octree_ tracks its modifications */
+  const OccMapTree* occ_map_tree_;
+
+  std::mutex lock_;
+  std::map<unsigned int, CoarseTree> coarse_trees_;
+};
 
 /** \brief Wrapper around world, link and attached objects' geometry data. */
 struct CollisionGeometryData
@@ -135,6 +171,9 @@ struct CollisionGeometryData
     const World::Object* obj;
     const void* raw;
   } ptr;
+
+  /** \brief Coarse copies of the geometry, only set for octrees. */
+  OcTreeLevelOfDetailPtr octree_lod;
 };
 
 /** \brief Data structure which is passed to the collision callback function of the collision manager. */
@@ -153,7 +192,8 @@ struct CollisionData
   {
   }
 
-  /** \brief Compute \e active_components_only_ based on the joint group specified in \e req_ */
+  /** \brief Compute \e active_components_only_ based on the joint group specified in \e req_, and fetch the
+   *  indexed link matrix of \e acm_ for \e robot_model */
   void enableGroup(const moveit::core::RobotModelConstPtr& robot_model);
 
   /** \brief The collision request passed by the user */
@@ -171,6 +211,9 @@ struct CollisionData
   /** \brief The user-specified collision matrix (may be nullptr). */
   const AllowedCollisionMatrix* acm_;
 
+  /** \brief The entries of \e acm_ between robot links, for constant-time lookups (may be nullptr). */
+  IndexedAllowedCollisionMatrixConstPtr indexed_acm_;
+
   /** \brief Flag indicating whether collision checking is complete. */
   bool done_;
 };
@@ -228,6 +271,15 @@ struct FCLGeometry
     collision_geometry_->setUserData(collision_geometry_data_.get());
   }
 
+  /** \brief Constructor for geometry that shares \e collision_geometry with other FCLGeometry instances. The user data
+   *  of a shared FCL geometry is not meaningful, the collision objects created by createCollisionObject() carry it. */
+  template <typename T>
+  FCLGeometry(const std::shared_ptr<fcl::CollisionGeometryd>& collision_geometry, const T* data, int shape_index)
+    : collision_geometry_(collision_geometry)
+    , collision_geometry_data_(std::make_shared<CollisionGeometryData>(data, shape_index))
+  {
+  }
+
   /** \brief Updates the \e collision_geometry_data_ with new data while also setting the \e collision_geometry_ to the
    *   new data. */
   template <typename T>
@@ -236,7 +288,9 @@ struct FCLGeometry
     if (!newType && collision_geometry_data_)
       if (collision_geometry_data_->ptr.raw == reinterpret_cast<const void*>(data))
         return;
+    OcTreeLevelOfDetailPtr octree_lod = collision_geometry_data_ ? collision_geometry_data_->octree_lod : nullptr;
     collision_geometry_data_ = std::make_shared<CollisionGeometryData>(data, shape_index);
+    collision_geometry_data_->octree_lod = std::move(octree_lod);
     collision_geometry_->setUserData(collision_geometry_data_.get());
   }
 
@@ -250,6 +304,24 @@ struct FCLGeometry
 typedef std::shared_ptr<fcl::CollisionObjectd> FCLCollisionObjectPtr;
 typedef std::shared_ptr<const fcl::CollisionObjectd> FCLCollisionObjectConstPtr;
 
+/** \brief Create an FCL collision object for \e geometry at \e transform. The object carries the CollisionGeometryData
+ *  of \e geometry as its user data, which the collision and distance callbacks read. */
+inline FCLCollisionObjectPtr createCollisionObject(const FCLGeometryConstPtr& geometry,
+                                                   const fcl::Transform3d& transform)
+{
+  auto object = std::make_shared<fcl::CollisionObjectd>(geometry->collision_geometry_, transform);
+  object->setUserData(geometry->collision_geometry_data_.get());
+  return object;
+}
+
+/** \brief Create an FCL collision object for \e geometry at the identity transform, see above. */
+inline FCLCollisionObjectPtr createCollisionObject(const FCLGeometryConstPtr& geometry)
+{
+  auto object = std::make_shared<fcl::CollisionObjectd>(geometry->collision_geometry_);
+  object->setUserData(geometry->collision_geometry_data_.get());
+  return object;
+}
+
 /** \brief A general high-level object which consists of multiple \e FCLCollisionObjects. It is the top level data
  *  structure which is used in the collision checking process. */
 struct FCLObject
@@ -314,6 +386,18 @@ FCLGeometryConstPtr createCollisionGeometry(const shapes::ShapeConstPtr& shape,
 FCLGeometryConstPtr createCollisionGeometry(const shapes::ShapeConstPtr& shape, double scale, double padding,
                                             const World::Object* obj);
 
+/** \brief Create the FCL geometries of a scaled and / or padded robot link shape and append them to \e geometries.
+ *
+ *  If convex decomposition is enabled in the ConvexDecompositionCache, a mesh yields one fcl::Convex for each of its
+ *  convex parts. Otherwise, and for all other shapes, the single geometry of createCollisionGeometry() is appended. */
+void createCollisionGeometries(const shapes::ShapeConstPtr& shape, double scale, double padding,
+                               const moveit::core::LinkModel* link, int shape_index,
+                               std::vector<FCLGeometryConstPtr>& geometries);
+
+/** \brief Create the FCL geometries of a world object shape and append them to \e geometries, see above. */
+void createCollisionGeometries(const shapes::ShapeConstPtr& shape, const World::Object* obj,
+                               std::vector<FCLGeometryConstPtr>& geometries);
+
 /** \brief Increases the counter of the caches which can trigger the cleaning of expired entries from them. */
 void cleanCollisionGeometryCache();
 
@@ -338,6 +422,25 @@ inline fcl::Transform3d transform2fcl(const Eigen::Isometry3d& b)
   return t;
 }
 
+/** \brief Transforms an FCL contact between the collision objects \e o1 and \e o2 into a MoveIt contact point. The body
+ *  names are taken from the objects created by createCollisionObject(), which also works for shared geometry. */
+inline void fcl2contact(const fcl::Contactd& fc, const fcl::CollisionObjectd* o1, const fcl::CollisionObjectd* o2,
+                        Contact& c)
+{
+  // FCL may report the geometries in the opposite order of the objects
+  if (fc.o1 != o1->collisionGeometry().get())
+    std::swap(o1, o2);
+  c.pos = Eigen::Vector3d(fc.pos[0], fc.pos[1], fc.pos[2]);
+  c.normal = Eigen::Vector3d(fc.normal[0], fc.normal[1], fc.normal[2]);
+  c.depth = fc.penetration_depth;
+  const CollisionGeometryData* cgd1 = static_cast<const CollisionGeometryData*>(o1->getUserData());
+  c.body_name_1 = cgd1->getID();
+  c.body_type_1 = cgd1->type;
+  const CollisionGeometryData* cgd2 = static_cast<const CollisionGeometryData*>(o2->getUserData());
+  c.body_name_2 = cgd2->getID();
+  c.body_type_2 = cgd2->type;
+}
+
 /** \brief Transforms an FCL contact into a MoveIt contact point. */
 inline void fcl2contact(const fcl::Contactd& fc, Contact& c)
 {
@@ -46,6 +46,8 @@
 #endif
 
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 
 namespace collision_detection
 {
@@ -82,6 +84,12 @@ public:
   void checkRobotCollision(const CollisionRequest& req, CollisionResult& res, const moveit::core::RobotState& state1,
                            const moveit::core::RobotState& state2) const override;
 
+  /** \brief Checks the states concurrently. All threads share the world broadphase and the cached robot geometry;
+   *   each thread refits its own persistent self-collision broadphase from state to state. */
+  void checkCollisionBatch(const CollisionRequest& req, std::vector<CollisionResult>& res,
+                           const std::vector<const moveit::core::RobotState*>& states,
+                           const AllowedCollisionMatrix& acm) const override;
+
   void distanceSelf(const DistanceRequest& req, DistanceResult& res,
                     const moveit::core::RobotState& state) const override;
 
@@ -108,6 +116,17 @@ protected:
   void checkRobotCollisionHelper(const CollisionRequest& req, CollisionResult& res,
                                  const moveit::core::RobotState& state, const AllowedCollisionMatrix* acm) const;
 
+  /** \brief Bundles the continuous checkRobotCollision functions into a single function.
+   *
+   *   Every robot body is swept from its pose in \e state1 to its pose in \e state2, interpolating position and
+   *   orientation linearly, and tested against the world objects whose AABBs overlap the swept AABB using
+   *   fcl::continuousCollide(). Contacts report the time of contact as percent_interpolation; their positions are
+   *   only the end pose of the robot body and their depths are zero. Conditionally allowed collisions are treated
+   *   as collisions, as no contact is available to decide on them. Requires FCL 0.6.0 or newer. */
+  void checkRobotCollisionHelperCCD(const CollisionRequest& req, CollisionResult& res,
+                                    const moveit::core::RobotState& state1, const moveit::core::RobotState& state2,
+                                    const AllowedCollisionMatrix* acm) const;
+
   /** \brief Construct an FCL collision object from MoveIt's World::Object. */
   void constructFCLObjectWorld(const World::Object* obj, FCLObject& fcl_obj) const;
 
@@ -130,6 +149,43 @@ protected:
    *   state and specifying a broadphase collision manager of FCL where the constructed object is registered to. */
   void allocSelfCollisionBroadPhase(const moveit::core::RobotState& state, FCLManager& manager) const;
 
+  /** \brief Construct the FCL collision objects of the attached bodies of \e state and append them to \e fcl_obj */
+  void constructFCLObjectAttachedBodies(const moveit::core::RobotState& state, FCLObject& fcl_obj) const;
+
+  /** \brief A self-collision broadphase that is kept across queries.
+   *
+   *   The link objects stay registered with the manager. Before each query only the objects whose transforms changed
+   *   are moved, which refits the dynamic AABB tree incrementally instead of building it from scratch. The attached
+   *   bodies of the queried state are registered for the duration of a query only. */
+  struct SelfCollisionBroadPhase
+  {
+    /** \brief The manager and the link objects registered to it */
+    FCLManager manager_;
+
+    /** \brief For each link object, the index of its geometry in robot_geoms_ */
+    std::vector<std::size_t> geometry_indices_;
+
+    /** \brief The attached body objects of the current query */
+    FCLObject attached_bodies_;
+  };
+  typedef std::unique_ptr<SelfCollisionBroadPhase> SelfCollisionBroadPhasePtr;
+
+  /** \brief Take a self-collision broadphase out of the pool, or create one if none is free, and update it to \e state.
+   *
+   *   Every concurrently running query holds its own broadphase, so the pool grows to the number of threads that check
+   *   for self-collision at the same time. Hand the broadphase back with releaseSelfCollisionBroadPhase(). */
+  SelfCollisionBroadPhasePtr acquireSelfCollisionBroadPhase(const moveit::core::RobotState& state) const;
+
+  /** \brief Return a broadphase obtained from acquireSelfCollisionBroadPhase() to the pool */
+  void releaseSelfCollisionBroadPhase(SelfCollisionBroadPhasePtr broad_phase) const;
+
+  /** \brief Create the geometry of shape \e shape_index of \e link in robot_geoms_ and robot_fcl_objs_.
+   *
+   *   The geometry is stored at the collision body index of the shape. If the shape is a mesh that is decomposed into
+   *   several convex parts, the first part takes that index and the others are appended after the geometry of all link
+   *   shapes. */
+  void createLinkGeometry(const moveit::core::LinkModel* link, std::size_t shape_index);
+
   /** \brief Converts all shapes which make up an attached body into a vector of FCLGeometryConstPtr.
    *
    *   When they are converted, they can be added to the FCL representation of the robot for collision checking.
@@ -139,7 +195,28 @@ protected:
    */
   void getAttachedBodyObjects(const moveit::core::AttachedBody* ab, std::vector<FCLGeometryConstPtr>& geoms) const;
 
-  /** \brief Vector of shared pointers to the FCL geometry for the objects in fcl_objs_. */
+  /** \brief FCL geometry built for a shape of an attached body, shared by all copies of that body */
+  struct AttachedBodyGeometry
+  {
+    /** \brief The shape the geometry was built from, to detect reuse of its address */
+    shapes::ShapeConstWeakPtr shape_;
+
+    /** \brief The link the body was attached to, whose scale and padding were applied */
+    std::string link_name_;
+
+    std::shared_ptr<fcl::CollisionGeometryd> collision_geometry_;
+  };
+
+  /** \brief Geometry of the attached body shapes, by shape address.
+   *
+   *   Copies of a robot state share the shapes of their attached bodies, so checking many states with the same
+   *   attached object only needs to build its geometry once. Only the transforms are updated per state. */
+  mutable std::unordered_map<const shapes::Shape*, AttachedBodyGeometry> attached_body_geometry_;
+  mutable std::mutex attached_body_geometry_lock_;
+
+  /** \brief Vector of shared pointers to the FCL geometry for the objects in fcl_objs_.
+   *
+   *   The first getLinkGeometryCount() entries are indexed by collision body, see createLinkGeometry(). */
   std::vector<FCLGeometryConstPtr> robot_geoms_;
 
   /** \brief Vector of shared pointers to the FCL collision objects which make up the robot */
@@ -150,6 +227,10 @@ protected:
 
   std::map<std::string, FCLObject> fcl_objs_;
 
+  /** \brief Pool of self-collision broadphases that are currently not in use */
+  mutable std::vector<SelfCollisionBroadPhasePtr> self_broad_phases_;
+  mutable std::mutex self_broad_phases_lock_;
+
 private:
   /** \brief Callback function executed for each change to the world environment */
   void notifyObjectChange(const ObjectConstPtr& obj, World::Action action);
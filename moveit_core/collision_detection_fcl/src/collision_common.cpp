@@ -35,6 +35,8 @@
 /* Author: Ioan Sucan, Jia Pan */
 
 #include <moveit/collision_detection_fcl/collision_common.h>
+#include <moveit/collision_detection/convex_decomposition.h>
+#include <moveit/collision_detection/occupancy_map.h>
 #include <geometric_shapes/shapes.h>
 #include <moveit/collision_detection_fcl/fcl_compat.h>
 #include <rclcpp/logger.hpp>
@@ -43,28 +45,115 @@
 #if (MOVEIT_FCL_VERSION >= FCL_VERSION_CHECK(0, 6, 0))
 #include <fcl/geometry/bvh/BVH_model.h>
 #include <fcl/geometry/octree/octree.h>
+#include <fcl/geometry/shape/convex.h>
 #else
 #include <fcl/BVH/BVH_model.h>
 #include <fcl/shape/geometric_shapes.h>
 #include <fcl/octree.h>
 #endif
 
+#include <algorithm>
+#include <cmath>
 #include <memory>
 #include <type_traits>
 #include <mutex>
+#include <string_view>
+#include <unordered_map>
 
 namespace collision_detection
 {
 // Logger
 static const rclcpp::Logger LOGGER = rclcpp::get_logger("moveit_collision_detection_fcl.collision_common");
 
+namespace
+{
+/** \brief Build a copy of \e tree whose cells are 2^levels times larger. A coarse cell is occupied if any voxel of
+ *  \e tree within it is occupied. */
+std::shared_ptr<fcl::CollisionGeometryd> buildCoarseOcTree(const octomap::OcTree& tree, unsigned int levels)
+{
+  const double resolution = tree.getResolution() * static_cast<double>(1u << levels);
+  auto coarse = std::make_shared<octomap::OcTree>(resolution);
+  coarse->setOccupancyThres(tree.getOccupancyThres());
+  coarse->setClampingThresMax(tree.getClampingThresMax());
+  const float occupied = coarse->getClampingThresMaxLog();
+
+  for (auto it = tree.begin_leafs(), end = tree.end_leafs(); it != end; ++it)
+  {
+    if (!tree.isNodeOccupied(*it))
+      continue;
+    // both trees share their origin, so a voxel lies entirely within the coarse cell containing its center
+    const octomap::point3d center = it.getCoordinate();
+    const double size = it.getSize();
+    if (size <= resolution)
+    {
+      coarse->setNodeValue(center, occupied, true);
+      continue;
+    }
+    // pruned leaves can span several coarse cells
+    const int cells = static_cast<int>(std::lround(size / resolution));
+    const double start = 0.5 * (resolution - size);
+    for (int x = 0; x < cells; ++x)
+      for (int y = 0; y < cells; ++y)
+        for (int z = 0; z < cells; ++z)
+          coarse->setNodeValue(center + octomap::point3d(start + x * resolution, start + y * resolution,
+                                                         start + z * resolution),
+                               occupied, true);
+  }
+  coarse->updateInnerOccupancy();
+  coarse->prune();
+
+  auto geometry = std::make_shared<fcl::OcTreed>(std::shared_ptr<const octomap::OcTree>(coarse));
+  geometry->computeLocalAABB();
+  return geometry;
+}
+
+/** \brief Level-of-detail culling for pairs that involve an octree: returns false if the other body does not touch
+ *  the coarse copy of the octree, i.e., the pair cannot be in collision. */
+bool mayCollideWithOctree(fcl::CollisionObjectd* o1, fcl::CollisionObjectd* o2, const CollisionGeometryData* cd1,
+                          const CollisionGeometryData* cd2, unsigned int levels)
+{
+  if (cd1->octree_lod && cd2->octree_lod)
+    return true;
+  if (cd1->octree_lod)
+  {
+    std::swap(o1, o2);
+    std::swap(cd1, cd2);
+  }
+  else if (!cd2->octree_lod)
+    return true;
+
+  fcl::CollisionObjectd coarse(cd2->octree_lod->getCoarseGeometry(levels), o2->getTransform());
+  fcl::CollisionResultd result;
+  fcl::collide(o1, &coarse, fcl::CollisionRequestd(), result);
+  return result.isCollision();
+}
+}  // namespace
+
+OcTreeLevelOfDetail::OcTreeLevelOfDetail(const std::shared_ptr<const octomap::OcTree>& octree)
+  : octree_(octree), occ_map_tree_(dynamic_cast<const OccMapTree*>(octree.get()))
+{
+}
+
+std::shared_ptr<fcl::CollisionGeometryd> OcTreeLevelOfDetail::getCoarseGeometry(unsigned int levels)
+{
+  const std::size_t version = occ_map_tree_ ? occ_map_tree_->getVersion() : 0;
+  std::scoped_lock slock(lock_);
+  CoarseTree& coarse = coarse_trees_[levels];
+  if (!coarse.geometry || coarse.version != version)
+  {
+    coarse.geometry = buildCoarseOcTree(*octree_, levels);
+    coarse.version = version;
+  }
+  return coarse.geometry;
+}
+
 bool collisionCallback(fcl::CollisionObjectd* o1, fcl::CollisionObjectd* o2, void* data)
 {
   CollisionData* cdata = reinterpret_cast<CollisionData*>(data);
   if (cdata->done_)
     return true;
-  const CollisionGeometryData* cd1 = static_cast<const CollisionGeometryData*>(o1->collisionGeometry()->getUserData());
-  const CollisionGeometryData* cd2 = static_cast<const CollisionGeometryData*>(o2->collisionGeometry()->getUserData());
+  const CollisionGeometryData* cd1 = static_cast<const CollisionGeometryData*>(o1->getUserData());
+  const CollisionGeometryData* cd2 = static_cast<const CollisionGeometryData*>(o2->getUserData());
 
   // do not collision check geoms part of the same object / link / attached body
   if (cd1->sameObject(*cd2))
@@ -94,7 +183,11 @@ bool collisionCallback(fcl::CollisionObjectd* o1, fcl::CollisionObjectd* o2, voi
   if (cdata->acm_)
   {
     AllowedCollision::Type type;
-    bool found = cdata->acm_->getAllowedCollision(cd1->getID(), cd2->getID(), type);
+    // collisions between robot links are looked up by link index; all other pairs by name
+    bool found = (cdata->indexed_acm_ && cd1->type == BodyTypes::ROBOT_LINK && cd2->type == BodyTypes::ROBOT_LINK) ?
+                     cdata->indexed_acm_->getAllowedCollision(cd1->ptr.link->getLinkIndex(),
+                                                              cd2->ptr.link->getLinkIndex(), type) :
+                     cdata->acm_->getAllowedCollision(cd1->getID(), cd2->getID(), type);
     if (found)
     {
       // if we have an entry in the collision matrix, we read it
@@ -152,6 +245,11 @@ bool collisionCallback(fcl::CollisionObjectd* o1, fcl::CollisionObjectd* o2, voi
   if (always_allow_collision)
     return false;
 
+  // costs are also collected from uncertain voxels, which the coarse copies of octrees do not represent
+  if (cdata->req_->octree_lod_levels > 0 && !cdata->req_->cost &&
+      !mayCollideWithOctree(o1, o2, cd1, cd2, cdata->req_->octree_lod_levels))
+    return false;
+
   if (cdata->req_->verbose)
     RCLCPP_DEBUG(LOGGER, "Actually checking collisions between %s and %s", cd1->getID().c_str(), cd2->getID().c_str());
 
@@ -200,7 +298,7 @@ bool collisionCallback(fcl::CollisionObjectd* o1, fcl::CollisionObjectd* o2, voi
                                                           std::make_pair(cd2->getID(), cd1->getID());
       for (int i = 0; i < num_contacts; ++i)
       {
-        fcl2contact(col_result.getContact(i), c);
+        fcl2contact(col_result.getContact(i), o1, o2, c);
         // if the contact is  not allowed, we have a collision
         if (!dcf(c))
         {
@@ -283,7 +381,7 @@ bool collisionCallback(fcl::CollisionObjectd* o1, fcl::CollisionObjectd* o2, voi
         for (int i = 0; i < num_contacts; ++i)
         {
           Contact c;
-          fcl2contact(col_result.getContact(i), c);
+          fcl2contact(col_result.getContact(i), o1, o2, c);
           cdata->res_->contacts[pc].push_back(c);
           cdata->res_->contact_count++;
         }
@@ -413,8 +511,8 @@ bool distanceCallback(fcl::CollisionObjectd* o1, fcl::CollisionObjectd* o2, void
 {
   DistanceData* cdata = reinterpret_cast<DistanceData*>(data);
 
-  const CollisionGeometryData* cd1 = static_cast<const CollisionGeometryData*>(o1->collisionGeometry()->getUserData());
-  const CollisionGeometryData* cd2 = static_cast<const CollisionGeometryData*>(o2->collisionGeometry()->getUserData());
+  const CollisionGeometryData* cd1 = static_cast<const CollisionGeometryData*>(o1->getUserData());
+  const CollisionGeometryData* cd2 = static_cast<const CollisionGeometryData*>(o2->getUserData());
 
   // do not distance check for geoms part of the same object / link / attached body
   if (cd1->sameObject(*cd2))
@@ -542,10 +640,10 @@ bool distanceCallback(fcl::CollisionObjectd* o1, fcl::CollisionObjectd* o2, void
     thread_local DistanceResultsData dist_result;
     dist_result.distance = fcl_result.min_distance;
 
-    // Careful here: Get the collision geometry data again, since FCL might
-    // swap o1 and o2 in the result.
-    const CollisionGeometryData* res_cd1 = static_cast<const CollisionGeometryData*>(fcl_result.o1->getUserData());
-    const CollisionGeometryData* res_cd2 = static_cast<const CollisionGeometryData*>(fcl_result.o2->getUserData());
+    // Careful here: FCL might swap o1 and o2 in the result.
+    const bool swapped = fcl_result.o1 != o1->collisionGeometry().get();
+    const CollisionGeometryData* res_cd1 = swapped ? cd2 : cd1;
+    const CollisionGeometryData* res_cd2 = swapped ? cd1 : cd2;
 
 #if (MOVEIT_FCL_VERSION >= FCL_VERSION_CHECK(0, 6, 0))
     dist_result.nearest_points[0] = fcl_result.nearest_points[0];
@@ -664,6 +762,74 @@ bool distanceCallback(fcl::CollisionObjectd* o1, fcl::CollisionObjectd* o2, void
   return cdata->done;
 }
 
+/** \brief Cache of the FCL geometries built for meshes, keyed by the mesh contents.
+ *
+ *  Identical meshes, e.g. many objects loaded from the same mesh file, share one BVH across objects, threads and
+ *  collision environments. An entry is valid as long as both the mesh it was built from and the geometry are alive. */
+template <typename BV>
+class FCLMeshGeometryCache
+{
+public:
+  static FCLMeshGeometryCache& instance()
+  {
+    static FCLMeshGeometryCache cache;
+    return cache;
+  }
+
+  std::shared_ptr<fcl::CollisionGeometryd> find(const shapes::Mesh& mesh)
+  {
+    std::scoped_lock lock(mutex_);
+    auto range = entries_.equal_range(hash(mesh));
+    for (auto it = range.first; it != range.second; ++it)
+    {
+      shapes::ShapeConstPtr source = it->second.mesh.lock();
+      std::shared_ptr<fcl::CollisionGeometryd> geometry = it->second.geometry.lock();
+      if (source && geometry && equal(mesh, static_cast<const shapes::Mesh&>(*source)))
+        return geometry;
+    }
+    return nullptr;
+  }
+
+  void insert(const shapes::ShapeConstPtr& mesh, const std::shared_ptr<fcl::CollisionGeometryd>& geometry)
+  {
+    std::scoped_lock lock(mutex_);
+    if (entries_.size() >= 2 * prune_size_)
+    {
+      for (auto it = entries_.begin(); it != entries_.end();)
+        it = it->second.mesh.expired() || it->second.geometry.expired() ? entries_.erase(it) : std::next(it);
+      prune_size_ = std::max<std::size_t>(entries_.size(), 16);
+    }
+    entries_.emplace(hash(static_cast<const shapes::Mesh&>(*mesh)), Entry{ mesh, geometry });
+  }
+
+private:
+  struct Entry
+  {
+    shapes::ShapeConstWeakPtr mesh;
+    std::weak_ptr<fcl::CollisionGeometryd> geometry;
+  };
+
+  static std::size_t hash(const shapes::Mesh& mesh)
+  {
+    const std::size_t vertices = std::hash<std::string_view>()(std::string_view(
+        reinterpret_cast<const char*>(mesh.vertices), 3 * sizeof(double) * mesh.vertex_count));
+    const std::size_t triangles = std::hash<std::string_view>()(std::string_view(
+        reinterpret_cast<const char*>(mesh.triangles), 3 * sizeof(unsigned int) * mesh.triangle_count));
+    return vertices ^ (triangles + 0x9e3779b9 + (vertices << 6) + (vertices >> 2));
+  }
+
+  static bool equal(const shapes::Mesh& a, const shapes::Mesh& b)
+  {
+    return a.vertex_count == b.vertex_count && a.triangle_count == b.triangle_count &&
+           std::equal(a.vertices, a.vertices + 3 * a.vertex_count, b.vertices) &&
+           std::equal(a.triangles, a.triangles + 3 * a.triangle_count, b.triangles);
+  }
+
+  std::mutex mutex_;
+  std::unordered_multimap<std::size_t, Entry> entries_;
+  std::size_t prune_size_ = 16;
+};
+
 /* Templated function to get a different cache for each of the template arguments combinations.
  *
  * The returned cache is a quasi-singleton for each thread as it is created \e thread_local. */
@@ -825,8 +991,16 @@ FCLGeometryConstPtr createCollisionGeometry(const shapes::ShapeConstPtr& shape,
     break;
     case shapes::MESH:
     {
-      auto g = new fcl::BVHModel<BV>();
       const shapes::Mesh* mesh = static_cast<const shapes::Mesh*>(shape.get());
+      if (std::shared_ptr<fcl::CollisionGeometryd> shared = FCLMeshGeometryCache<BV>::instance().find(*mesh))
+      {
+        FCLGeometryConstPtr res = std::make_shared<const FCLGeometry>(shared, data, shape_index);
+        cache.map_[wptr] = res;
+        cache.bumpUseCount();
+        return res;
+      }
+
+      auto g = new fcl::BVHModel<BV>();
       if (mesh->vertex_count > 0 && mesh->triangle_count > 0)
       {
         std::vector<fcl::Triangle> tri_indices(mesh->triangle_count);
@@ -859,7 +1033,12 @@ FCLGeometryConstPtr createCollisionGeometry(const shapes::ShapeConstPtr& shape,
   if (cg_g)
   {
     cg_g->computeLocalAABB();
-    FCLGeometryConstPtr res = std::make_shared<const FCLGeometry>(cg_g, data, shape_index);
+    auto res = std::make_shared<FCLGeometry>(cg_g, data, shape_index);
+    if (shape->type == shapes::OCTREE)
+      res->collision_geometry_data_->octree_lod =
+          std::make_shared<OcTreeLevelOfDetail>(static_cast<const shapes::OcTree*>(shape.get())->octree);
+    if (shape->type == shapes::MESH)
+      FCLMeshGeometryCache<BV>::instance().insert(shape, res->collision_geometry_);
     cache.map_[wptr] = res;
     cache.bumpUseCount();
     return res;
@@ -919,6 +1098,80 @@ FCLGeometryConstPtr createCollisionGeometry(const shapes::ShapeConstPtr& shape,
   return createCollisionGeometry<fcl::OBBRSSd, World::Object>(shape, scale, padding, obj, 0);
 }
 
+#if (MOVEIT_FCL_VERSION >= FCL_VERSION_CHECK(0, 6, 0))
+/** \brief Get the fcl::Convex for a convex part of a decomposed mesh, shared by all parts with the same contents */
+std::shared_ptr<fcl::CollisionGeometryd> createConvexGeometry(const shapes::ShapeConstPtr& part)
+{
+  const shapes::Mesh* mesh = static_cast<const shapes::Mesh*>(part.get());
+  FCLMeshGeometryCache<fcl::Convexd>& cache = FCLMeshGeometryCache<fcl::Convexd>::instance();
+  if (std::shared_ptr<fcl::CollisionGeometryd> shared = cache.find(*mesh))
+    return shared;
+
+  auto vertices = std::make_shared<std::vector<fcl::Vector3d>>(mesh->vertex_count);
+  for (unsigned int i = 0; i < mesh->vertex_count; ++i)
+    (*vertices)[i] = fcl::Vector3d(mesh->vertices[3 * i], mesh->vertices[3 * i + 1], mesh->vertices[3 * i + 2]);
+  // each face is stored as its vertex count followed by the vertex indices
+  auto faces = std::make_shared<std::vector<int>>();
+  faces->reserve(4 * mesh->triangle_count);
+  for (unsigned int i = 0; i < mesh->triangle_count; ++i)
+  {
+    faces->push_back(3);
+    faces->insert(faces->end(), mesh->triangles + 3 * i, mesh->triangles + 3 * i + 3);
+  }
+
+  auto convex = std::make_shared<fcl::Convexd>(vertices, mesh->triangle_count, faces);
+  convex->computeLocalAABB();
+  cache.insert(part, convex);
+  return convex;
+}
+#endif
+
+/** \brief Templated helper function creating the geometries of a shape, which are the convex parts of meshes if convex
+ *  decomposition is enabled. */
+template <typename T>
+void createCollisionGeometries(const shapes::ShapeConstPtr& shape, double scale, double padding, const T* data,
+                               int shape_index, std::vector<FCLGeometryConstPtr>& geometries)
+{
+#if (MOVEIT_FCL_VERSION >= FCL_VERSION_CHECK(0, 6, 0))
+  ConvexDecompositionCache& decomposition = ConvexDecompositionCache::instance();
+  if (shape->type == shapes::MESH && decomposition.isEnabled())
+  {
+    shapes::ShapeConstPtr mesh = shape;
+    if (fabs(scale - 1.0) > std::numeric_limits<double>::epsilon() ||
+        fabs(padding) > std::numeric_limits<double>::epsilon())
+    {
+      shapes::ShapePtr scaled_shape(shape->clone());
+      scaled_shape->scaleAndPadd(scale, padding);
+      mesh = scaled_shape;
+    }
+
+    const std::vector<shapes::ShapeConstPtr> parts = decomposition.getConvexParts(mesh);
+    if (!parts.empty())
+    {
+      for (const shapes::ShapeConstPtr& part : parts)
+        geometries.push_back(std::make_shared<const FCLGeometry>(createConvexGeometry(part), data, shape_index));
+      return;
+    }
+  }
+#endif
+
+  if (FCLGeometryConstPtr geometry = createCollisionGeometry<fcl::OBBRSSd, T>(shape, scale, padding, data, shape_index))
+    geometries.push_back(geometry);
+}
+
+void createCollisionGeometries(const shapes::ShapeConstPtr& shape, double scale, double padding,
+                               const moveit::core::LinkModel* link, int shape_index,
+                               std::vector<FCLGeometryConstPtr>& geometries)
+{
+  createCollisionGeometries<moveit::core::LinkModel>(shape, scale, padding, link, shape_index, geometries);
+}
+
+void createCollisionGeometries(const shapes::ShapeConstPtr& shape, const World::Object* obj,
+                               std::vector<FCLGeometryConstPtr>& geometries)
+{
+  createCollisionGeometries<World::Object>(shape, 1.0, 0.0, obj, 0, geometries);
+}
+
 void cleanCollisionGeometryCache()
 {
   FCLShapeCache& cache1 = GetShapeCache<fcl::OBBRSSd, World::Object>();
@@ -937,6 +1190,8 @@ void CollisionData::enableGroup(const moveit::core::RobotModelConstPtr& robot_mo
     active_components_only_ = &robot_model->getJointModelGroup(req_->group_name)->getUpdatedLinkModelsSet();
   else
     active_components_only_ = nullptr;
+  if (acm_)
+    indexed_acm_ = acm_->getIndexedLinkMatrix(*robot_model);
 }
 
 void FCLObject::registerTo(fcl::BroadPhaseCollisionManagerd* manager)
@@ -41,9 +41,11 @@
 #include <moveit/collision_detection_fcl/fcl_compat.h>
 #include <rclcpp/logger.hpp>
 #include <rclcpp/logging.hpp>
+#include <unordered_map>
 
 #if (MOVEIT_FCL_VERSION >= FCL_VERSION_CHECK(0, 6, 0))
 #include <fcl/broadphase/broadphase_dynamic_AABB_tree.h>
+#include <fcl/narrowphase/continuous_collision.h>
 #endif
 
 namespace collision_detection
@@ -74,36 +76,87 @@ void checkFCLCapabilities(const DistanceRequest& req)
   (void)(req);  // silent -Wunused-parameter
 #endif
 }
+
+// Distance data of a query of a single self-collision object against the whole broadphase
+struct SelfDistanceData : public DistanceData
+{
+  SelfDistanceData(const DistanceRequest* req, DistanceResult* res, const fcl::CollisionObjectd* query,
+                   const std::unordered_map<const fcl::CollisionObjectd*, std::size_t>* order)
+    : DistanceData(req, res), query(query), order(order)
+  {
+  }
+
+  const fcl::CollisionObjectd* query;
+
+  /** \brief The position of every object of the broadphase in the list of queried objects */
+  const std::unordered_map<const fcl::CollisionObjectd*, std::size_t>* order;
+};
+
+// Compute each pair only once: in the query of the object that comes first
+bool selfDistanceCallback(fcl::CollisionObjectd* o1, fcl::CollisionObjectd* o2, void* data, double& min_dist)
+{
+  SelfDistanceData* cdata = reinterpret_cast<SelfDistanceData*>(data);
+  const fcl::CollisionObjectd* other = o1 == cdata->query ? o2 : o1;
+  if (cdata->order->at(other) < cdata->order->at(cdata->query))
+    return cdata->done;
+  return distanceCallback(o1, o2, static_cast<DistanceData*>(cdata), min_dist);
+}
+
+// Merge the results of partial queries into res, as if the queries had been run one after another on the same result.
+// Partial queries after the first one that ended the query (done) are ignored, as a serial query would have stopped.
+void mergeDistanceResults(const DistanceRequest& req, const std::vector<DistanceResult>& parts,
+                          const std::vector<char>& done, DistanceResult& res)
+{
+  for (std::size_t i = 0; i < parts.size(); ++i)
+  {
+    const DistanceResult& part = parts[i];
+    if (part.minimum_distance.distance < res.minimum_distance.distance)
+      res.minimum_distance = part.minimum_distance;
+    res.collision = res.collision || part.collision;
+
+    if (req.type != DistanceRequestType::GLOBAL)
+    {
+      for (const auto& pair : part.distances)
+      {
+        auto it = res.distances.find(pair.first);
+        if (it == res.distances.end())
+        {
+          res.distances.insert(pair);
+          continue;
+        }
+        if (req.type == DistanceRequestType::SINGLE)
+        {
+          if (pair.second[0].distance < it->second[0].distance)
+            it->second[0] = pair.second[0];
+        }
+        else
+        {
+          for (const DistanceResultsData& data : pair.second)
+          {
+            if (req.type == DistanceRequestType::LIMITED && it->second.size() >= req.max_contacts_per_body)
+              break;
+            it->second.push_back(data);
+          }
+        }
+      }
+    }
+
+    if (done[i])
+      break;
+  }
+}
 }  // namespace
 
 CollisionEnvFCL::CollisionEnvFCL(const moveit::core::RobotModelConstPtr& model, double padding, double scale)
   : CollisionEnv(model, padding, scale)
 {
   const std::vector<const moveit::core::LinkModel*>& links = robot_model_->getLinkModelsWithCollisionGeometry();
-  std::size_t index;
   robot_geoms_.resize(robot_model_->getLinkGeometryCount());
   robot_fcl_objs_.resize(robot_model_->getLinkGeometryCount());
   // we keep the same order of objects as what RobotState *::getLinkState() returns
   for (auto link : links)
     for (std::size_t j = 0; j < link->getShapes().size(); ++j)
-    {
-      FCLGeometryConstPtr link_geometry = createCollisionGeometry(link->getShapes()[j], getLinkScale(link->getName()),
-                                                                  getLinkPadding(link->getName()), link, j);
-      if (link_geometry)
-      {
-        index = link->getFirstCollisionBodyTransformIndex() + j;
-        robot_geoms_[index] = link_geometry;
-
-        // Need to store the FCL object so the AABB does not get recreated every time.
-        // Every time this object is created, g->computeLocalAABB() is called  which is
-        // very expensive and should only be calculated once. To update the AABB, use the
-        // collObj->setTransform and then call collObj->computeAABB() to transform the AABB.
-        robot_fcl_objs_[index] = FCLCollisionObjectConstPtr(
-            std::make_shared<const fcl::CollisionObjectd>(link_geometry->collision_geometry_));
-      }
-      else
-        RCLCPP_ERROR(LOGGER, "Unable to construct collision geometry for link '%s'", link->getName().c_str());
-    }
+      createLinkGeometry(link, j);
 
   manager_ = std::make_unique<fcl::DynamicAABBTreeCollisionManagerd>();
 
@@ -117,29 +170,12 @@ CollisionEnvFCL::CollisionEnvFCL(const moveit::core::RobotModelConstPtr& model,
   : CollisionEnv(model, world, padding, scale)
 {
   const std::vector<const moveit::core::LinkModel*>& links = robot_model_->getLinkModelsWithCollisionGeometry();
-  std::size_t index;
   robot_geoms_.resize(robot_model_->getLinkGeometryCount());
   robot_fcl_objs_.resize(robot_model_->getLinkGeometryCount());
   // we keep the same order of objects as what RobotState *::getLinkState() returns
   for (auto link : links)
     for (std::size_t j = 0; j < link->getShapes().size(); ++j)
-    {
-      FCLGeometryConstPtr g = createCollisionGeometry(link->getShapes()[j], getLinkScale(link->getName()),
-                                                      getLinkPadding(link->getName()), link, j);
-      if (g)
-      {
-        index = link->getFirstCollisionBodyTransformIndex() + j;
-        robot_geoms_[index] = g;
-
-        // Need to store the FCL object so the AABB does not get recreated every time.
-        // Every time this object is created, g->computeLocalAABB() is called  which is
-        // very expensive and should only be calculated once. To update the AABB, use the
-        // collObj->setTransform and then call collObj->computeAABB() to transform the AABB.
-        robot_fcl_objs_[index] = std::make_shared<const fcl::CollisionObjectd>(g->collision_geometry_);
-      }
-      else
-        RCLCPP_ERROR(LOGGER, "Unable to construct collision geometry for link '%s'", link->getName().c_str());
-    }
+      createLinkGeometry(link, j);
 
   manager_ = std::make_unique<fcl::DynamicAABBTreeCollisionManagerd>();
 
@@ -171,30 +207,79 @@ CollisionEnvFCL::CollisionEnvFCL(const CollisionEnvFCL& other, const WorldPtr& w
       [this](const World::ObjectConstPtr& object, World::Action action) { notifyObjectChange(object, action); });
 }
 
+void CollisionEnvFCL::createLinkGeometry(const moveit::core::LinkModel* link, std::size_t shape_index)
+{
+  std::vector<FCLGeometryConstPtr> geometries;
+  createCollisionGeometries(link->getShapes()[shape_index], getLinkScale(link->getName()),
+                            getLinkPadding(link->getName()), link, shape_index, geometries);
+  if (geometries.empty())
+  {
+    RCLCPP_ERROR(LOGGER, "Unable to construct collision geometry for link '%s'", link->getName().c_str());
+    return;
+  }
+
+  // Need to store the FCL object so the AABB does not get recreated every time.
+  // Every time this object is created, g->computeLocalAABB() is called  which is
+  // very expensive and should only be calculated once. To update the AABB, use the
+  // collObj->setTransform and then call collObj->computeAABB() to transform the AABB.
+  const std::size_t index = link->getFirstCollisionBodyTransformIndex() + shape_index;
+  robot_geoms_[index] = geometries.front();
+  robot_fcl_objs_[index] = createCollisionObject(geometries.front());
+
+  // further convex parts of a decomposed mesh go after the geometry of all link shapes
+  for (std::size_t k = 1; k < geometries.size(); ++k)
+  {
+    robot_geoms_.push_back(geometries[k]);
+    robot_fcl_objs_.push_back(createCollisionObject(geometries[k]));
+  }
+}
+
 void CollisionEnvFCL::getAttachedBodyObjects(const moveit::core::AttachedBody* ab,
                                              std::vector<FCLGeometryConstPtr>& geoms) const
 {
   const std::vector<shapes::ShapeConstPtr>& shapes = ab->getShapes();
   const size_t num_shapes = shapes.size();
   geoms.reserve(num_shapes);
+  std::lock_guard<std::mutex> slock(attached_body_geometry_lock_);
   for (std::size_t i = 0; i < num_shapes; ++i)
   {
+    auto it = attached_body_geometry_.find(shapes[i].get());
+    if (it != attached_body_geometry_.end() && it->second.shape_.lock() == shapes[i] &&
+        it->second.link_name_ == ab->getAttachedLinkName())
+    {
+      geoms.push_back(std::make_shared<const FCLGeometry>(it->second.collision_geometry_, ab, i));
+      continue;
+    }
+
     FCLGeometryConstPtr co = createCollisionGeometry(shapes[i], getLinkScale(ab->getAttachedLinkName()),
                                                      getLinkPadding(ab->getAttachedLinkName()), ab, i);
-    if (co)
-      geoms.push_back(co);
+    if (!co)
+      continue;
+    geoms.push_back(co);
+    if (!co->collision_geometry_)
+      continue;
+
+    // forget the geometry of shapes that do not exist anymore
+    for (auto stale = attached_body_geometry_.begin(); stale != attached_body_geometry_.end();)
+      if (stale->second.shape_.expired())
+        stale = attached_body_geometry_.erase(stale);
+      else
+        ++stale;
+    attached_body_geometry_[shapes[i].get()] = { shapes[i], ab->getAttachedLinkName(), co->collision_geometry_ };
   }
 }
 
 void CollisionEnvFCL::constructFCLObjectWorld(const World::Object* obj, FCLObject& fcl_obj) const
 {
+  std::vector<FCLGeometryConstPtr> geometries;
   for (std::size_t i = 0; i < obj->shapes_.size(); ++i)
   {
-    FCLGeometryConstPtr g = createCollisionGeometry(obj->shapes_[i], obj);
-    if (g)
+    geometries.clear();
+    createCollisionGeometries(obj->shapes_[i], obj, geometries);
+    const fcl::Transform3d transform = transform2fcl(obj->global_shape_poses_[i]);
+    for (const FCLGeometryConstPtr& g : geometries)
     {
-      auto co = new fcl::CollisionObjectd(g->collision_geometry_, transform2fcl(obj->global_shape_poses_[i]));
-      fcl_obj.collision_objects_.push_back(FCLCollisionObjectPtr(co));
+      fcl_obj.collision_objects_.push_back(createCollisionObject(g, transform));
       fcl_obj.collision_geometry_.push_back(g);
     }
   }
@@ -217,7 +302,13 @@ void CollisionEnvFCL::constructFCLObjectRobot(const moveit::core::RobotState& st
       fcl_obj.collision_objects_.push_back(FCLCollisionObjectPtr(coll_obj));
     }
 
-  // TODO: Implement a method for caching fcl::CollisionObject's for moveit::core::AttachedBody's
+  constructFCLObjectAttachedBodies(state, fcl_obj);
+}
+
+void CollisionEnvFCL::constructFCLObjectAttachedBodies(const moveit::core::RobotState& state,
+                                                       FCLObject& fcl_obj) const
+{
+  fcl::Transform3d fcl_tf;
   std::vector<const moveit::core::AttachedBody*> ab;
   state.getAttachedBodies(ab);
   for (auto& body : ab)
@@ -229,8 +320,7 @@ void CollisionEnvFCL::constructFCLObjectRobot(const moveit::core::RobotState& st
       if (objs[k]->collision_geometry_)
       {
         transform2fcl(ab_t[k], fcl_tf);
-        fcl_obj.collision_objects_.push_back(
-            std::make_shared<fcl::CollisionObjectd>(objs[k]->collision_geometry_, fcl_tf));
+        fcl_obj.collision_objects_.push_back(createCollisionObject(objs[k], fcl_tf));
         // we copy the shared ptr to the CollisionGeometryData, as this is not stored by the class itself,
         // and would be destroyed when objs goes out of scope.
         fcl_obj.collision_geometry_.push_back(objs[k]);
@@ -246,6 +336,75 @@ void CollisionEnvFCL::allocSelfCollisionBroadPhase(const moveit::core::RobotStat
   manager.object_.registerTo(manager.manager_.get());
 }
 
+CollisionEnvFCL::SelfCollisionBroadPhasePtr
+CollisionEnvFCL::acquireSelfCollisionBroadPhase(const moveit::core::RobotState& state) const
+{
+  SelfCollisionBroadPhasePtr broad_phase;
+  {
+    std::lock_guard<std::mutex> slock(self_broad_phases_lock_);
+    if (!self_broad_phases_.empty())
+    {
+      broad_phase = std::move(self_broad_phases_.back());
+      self_broad_phases_.pop_back();
+    }
+  }
+
+  fcl::Transform3d fcl_tf;
+  if (!broad_phase)
+  {
+    broad_phase = std::make_unique<SelfCollisionBroadPhase>();
+    broad_phase->manager_.manager_ = std::make_shared<fcl::DynamicAABBTreeCollisionManagerd>();
+    FCLObject& links = broad_phase->manager_.object_;
+    for (std::size_t i = 0; i < robot_geoms_.size(); ++i)
+      if (robot_geoms_[i] && robot_geoms_[i]->collision_geometry_)
+      {
+        transform2fcl(state.getCollisionBodyTransform(robot_geoms_[i]->collision_geometry_data_->ptr.link,
+                                                      robot_geoms_[i]->collision_geometry_data_->shape_index),
+                      fcl_tf);
+        auto coll_obj = std::make_shared<fcl::CollisionObjectd>(*robot_fcl_objs_[i]);
+        coll_obj->setTransform(fcl_tf);
+        coll_obj->computeAABB();
+        links.collision_objects_.push_back(coll_obj);
+        broad_phase->geometry_indices_.push_back(i);
+      }
+    links.registerTo(broad_phase->manager_.manager_.get());
+  }
+  else
+  {
+    // only move the objects of links that moved since the previous query
+    std::vector<fcl::CollisionObjectd*> moved_objects;
+    const std::vector<FCLCollisionObjectPtr>& objects = broad_phase->manager_.object_.collision_objects_;
+    for (std::size_t k = 0; k < objects.size(); ++k)
+    {
+      const FCLGeometryConstPtr& geometry = robot_geoms_[broad_phase->geometry_indices_[k]];
+      transform2fcl(state.getCollisionBodyTransform(geometry->collision_geometry_data_->ptr.link,
+                                                    geometry->collision_geometry_data_->shape_index),
+                    fcl_tf);
+      if (objects[k]->getTransform().matrix() != fcl_tf.matrix())
+      {
+        objects[k]->setTransform(fcl_tf);
+        objects[k]->computeAABB();
+        moved_objects.push_back(objects[k].get());
+      }
+    }
+    if (!moved_objects.empty())
+      broad_phase->manager_.manager_->update(moved_objects);
+  }
+
+  constructFCLObjectAttachedBodies(state, broad_phase->attached_bodies_);
+  broad_phase->attached_bodies_.registerTo(broad_phase->manager_.manager_.get());
+  return broad_phase;
+}
+
+void CollisionEnvFCL::releaseSelfCollisionBroadPhase(SelfCollisionBroadPhasePtr broad_phase) const
+{
+  broad_phase->attached_bodies_.unregisterFrom(broad_phase->manager_.manager_.get());
+  broad_phase->attached_bodies_.clear();
+
+  std::lock_guard<std::mutex> slock(self_broad_phases_lock_);
+  self_broad_phases_.push_back(std::move(broad_phase));
+}
+
 void CollisionEnvFCL::checkSelfCollision(const CollisionRequest& req, CollisionResult& res,
                                          const moveit::core::RobotState& state) const
 {
@@ -262,11 +421,16 @@ void CollisionEnvFCL::checkSelfCollisionHelper(const CollisionRequest& req, Coll
                                                const moveit::core::RobotState& state,
                                                const AllowedCollisionMatrix* acm) const
 {
-  FCLManager manager;
-  allocSelfCollisionBroadPhase(state, manager);
+  // testing the link bounding spheres is much cheaper than updating the broadphase, and when they are all apart
+  // there is no contact to find
+  if (!req.distance && !req.cost && areLinkBoundingSpheresSeparated(state, acm))
+    return;
+
+  SelfCollisionBroadPhasePtr broad_phase = acquireSelfCollisionBroadPhase(state);
   CollisionData cd(&req, &res, acm);
   cd.enableGroup(getRobotModel());
-  manager.manager_->collide(&cd, &collisionCallback);
+  broad_phase->manager_.manager_->collide(&cd, &collisionCallback);
+  releaseSelfCollisionBroadPhase(std::move(broad_phase));
   if (req.distance)
   {
     DistanceRequest dreq;
@@ -293,19 +457,145 @@ void CollisionEnvFCL::checkRobotCollision(const CollisionRequest& req, Collision
   checkRobotCollisionHelper(req, res, state, &acm);
 }
 
-void CollisionEnvFCL::checkRobotCollision(const CollisionRequest& /*req*/, CollisionResult& /*res*/,
-                                          const moveit::core::RobotState& /*state1*/,
-                                          const moveit::core::RobotState& /*state2*/) const
+void CollisionEnvFCL::checkRobotCollision(const CollisionRequest& req, CollisionResult& res,
+                                          const moveit::core::RobotState& state1,
+                                          const moveit::core::RobotState& state2) const
 {
-  RCLCPP_ERROR(LOGGER, "Continuous collision not implemented");
+  checkRobotCollisionHelperCCD(req, res, state1, state2, nullptr);
 }
 
-void CollisionEnvFCL::checkRobotCollision(const CollisionRequest& /*req*/, CollisionResult& /*res*/,
-                                          const moveit::core::RobotState& /*state1*/,
-                                          const moveit::core::RobotState& /*state2*/,
-                                          const AllowedCollisionMatrix& /*acm*/) const
+void CollisionEnvFCL::checkRobotCollision(const CollisionRequest& req, CollisionResult& res,
+                                          const moveit::core::RobotState& state1,
+                                          const moveit::core::RobotState& state2,
+                                          const AllowedCollisionMatrix& acm) const
 {
-  RCLCPP_ERROR(LOGGER, "Not implemented");
+  checkRobotCollisionHelperCCD(req, res, state1, state2, &acm);
+}
+
+void CollisionEnvFCL::checkRobotCollisionHelperCCD(const CollisionRequest& req, CollisionResult& res,
+                                                   const moveit::core::RobotState& state1,
+                                                   const moveit::core::RobotState& state2,
+                                                   const AllowedCollisionMatrix* acm) const
+{
+#if (MOVEIT_FCL_VERSION >= FCL_VERSION_CHECK(0, 6, 0))
+  const std::set<const moveit::core::LinkModel*>* active_links = nullptr;
+  if (getRobotModel()->hasJointModelGroup(req.group_name))
+    active_links = &getRobotModel()->getJointModelGroup(req.group_name)->getUpdatedLinkModelsSet();
+
+  // the robot bodies at the start state, together with their end transforms
+  std::vector<FCLCollisionObjectPtr> objects;
+  std::vector<const CollisionGeometryData*> object_data;
+  std::vector<FCLGeometryConstPtr> attached_geometry;  // keeps the attached geometry data alive
+  fcl::Transform3d fcl_tf;
+  EigenSTL::vector_Isometry3d end_transforms;
+  for (std::size_t i = 0; i < robot_geoms_.size(); ++i)
+  {
+    if (!robot_geoms_[i] || !robot_geoms_[i]->collision_geometry_)
+      continue;
+    const CollisionGeometryData* data = robot_geoms_[i]->collision_geometry_data_.get();
+    if (active_links && active_links->find(data->ptr.link) == active_links->end())
+      continue;
+    transform2fcl(state1.getCollisionBodyTransform(data->ptr.link, data->shape_index), fcl_tf);
+    auto coll_obj = std::make_shared<fcl::CollisionObjectd>(*robot_fcl_objs_[i]);
+    coll_obj->setTransform(fcl_tf);
+    objects.push_back(coll_obj);
+    object_data.push_back(data);
+    end_transforms.push_back(state2.getCollisionBodyTransform(data->ptr.link, data->shape_index));
+  }
+  std::vector<const moveit::core::AttachedBody*> attached_bodies;
+  state1.getAttachedBodies(attached_bodies);
+  for (const moveit::core::AttachedBody* body : attached_bodies)
+  {
+    const moveit::core::AttachedBody* end_body = state2.getAttachedBody(body->getName());
+    if (!end_body || (active_links && active_links->find(body->getAttachedLink()) == active_links->end()))
+      continue;
+    std::vector<FCLGeometryConstPtr> geoms;
+    getAttachedBodyObjects(body, geoms);
+    for (const FCLGeometryConstPtr& geom : geoms)
+    {
+      if (!geom->collision_geometry_)
+        continue;
+      const int index = geom->collision_geometry_data_->shape_index;
+      transform2fcl(body->getGlobalCollisionBodyTransforms()[index], fcl_tf);
+      objects.push_back(createCollisionObject(geom, fcl_tf));
+      object_data.push_back(geom->collision_geometry_data_.get());
+      end_transforms.push_back(end_body->getGlobalCollisionBodyTransforms()[index]);
+      attached_geometry.push_back(geom);
+    }
+  }
+
+  fcl::ContinuousCollisionRequestd ccd_request;
+  ccd_request.ccd_motion_type = fcl::CCDM_LINEAR;
+  for (std::size_t i = 0; i < objects.size(); ++i)
+  {
+    // the AABB swept by the body bounds the candidates for the narrow phase
+    objects[i]->computeAABB();
+    fcl::AABBd swept_aabb = objects[i]->getAABB();
+    fcl::Transform3d end_tf;
+    transform2fcl(end_transforms[i], end_tf);
+    fcl::CollisionObjectd end_obj(objects[i]->collisionGeometry(), end_tf);
+    end_obj.computeAABB();
+    swept_aabb += end_obj.getAABB();
+
+    const CollisionGeometryData* data = object_data[i];
+    for (const std::pair<const std::string, FCLObject>& world_object : fcl_objs_)
+    {
+      const FCLObject& fcl_obj = world_object.second;
+      for (std::size_t k = 0; k < fcl_obj.collision_objects_.size(); ++k)
+      {
+        const fcl::CollisionObjectd* obstacle = fcl_obj.collision_objects_[k].get();
+        if (!swept_aabb.overlap(obstacle->getAABB()))
+          continue;
+
+        const CollisionGeometryData* obstacle_data = fcl_obj.collision_geometry_[k]->collision_geometry_data_.get();
+        AllowedCollision::Type type;
+        if (acm && acm->getAllowedCollision(data->getID(), obstacle_data->getID(), type) &&
+            type == AllowedCollision::ALWAYS)
+          continue;
+
+        // conservative advancement handles meshes and primitives; octrees are only supported by the naive solver
+        if (obstacle->getObjectType() == fcl::OT_OCTREE)
+          ccd_request.ccd_solver_type = fcl::CCDC_NAIVE;
+        else
+          ccd_request.ccd_solver_type = fcl::CCDC_CONSERVATIVE_ADVANCEMENT;
+        fcl::ContinuousCollisionResultd ccd_result;
+        fcl::continuousCollide(objects[i].get(), end_tf, obstacle, obstacle->getTransform(), ccd_request,
+                               ccd_result);
+        if (!ccd_result.is_collide)
+          continue;
+
+        res.collision = true;
+        if (req.verbose)
+          RCLCPP_INFO(LOGGER, "Continuous collision between '%s' and '%s' at %.3f of the motion",
+                      data->getID().c_str(), obstacle_data->getID().c_str(), ccd_result.time_of_contact);
+        if (!req.contacts || res.contact_count >= req.max_contacts)
+          return;
+
+        Contact contact;
+        contact.pos = end_transforms[i].translation();
+        contact.normal = Eigen::Vector3d::Zero();
+        contact.depth = 0.0;
+        contact.body_name_1 = data->getID();
+        contact.body_type_1 = data->type;
+        contact.body_name_2 = obstacle_data->getID();
+        contact.body_type_2 = obstacle_data->type;
+        contact.percent_interpolation = ccd_result.time_of_contact;
+        const std::pair<std::string, std::string> pair = contact.body_name_1 < contact.body_name_2 ?
+                                                             std::make_pair(contact.body_name_1, contact.body_name_2) :
+                                                             std::make_pair(contact.body_name_2, contact.body_name_1);
+        res.contacts[pair].push_back(contact);
+        res.contact_count++;
+      }
+    }
+  }
+#else
+  (void)req;
+  (void)res;
+  (void)state1;
+  (void)state2;
+  (void)acm;
+  RCLCPP_ERROR(LOGGER, "Continuous collision checking requires FCL 0.6.0 or newer");
+#endif
 }
 
 void CollisionEnvFCL::checkRobotCollisionHelper(const CollisionRequest& req, CollisionResult& res,
@@ -333,16 +623,50 @@ void CollisionEnvFCL::checkRobotCollisionHelper(const CollisionRequest& req, Col
   }
 }
 
+void CollisionEnvFCL::checkCollisionBatch(const CollisionRequest& req, std::vector<CollisionResult>& res,
+                                          const std::vector<const moveit::core::RobotState*>& states,
+                                          const AllowedCollisionMatrix& acm) const
+{
+  res.resize(states.size());
+  forEachInBatch(states.size(), [&](std::size_t /*thread*/, std::size_t i) {
+    res[i].clear();
+    checkCollision(req, res[i], *states[i], acm);
+  });
+}
+
 void CollisionEnvFCL::distanceSelf(const DistanceRequest& req, DistanceResult& res,
                                    const moveit::core::RobotState& state) const
 {
   checkFCLCapabilities(req);
 
-  FCLManager manager;
-  allocSelfCollisionBroadPhase(state, manager);
-  DistanceData drd(&req, &res);
+  SelfCollisionBroadPhasePtr broad_phase = acquireSelfCollisionBroadPhase(state);
+  if (!req.parallel)
+  {
+    DistanceData drd(&req, &res);
+    broad_phase->manager_.manager_->distance(&drd, &distanceCallback);
+    releaseSelfCollisionBroadPhase(std::move(broad_phase));
+    return;
+  }
 
-  manager.manager_->distance(&drd, &distanceCallback);
+  // query every object against the broadphase, computing each pair in the query of its first object only
+  std::vector<const fcl::CollisionObjectd*> objects;
+  for (const FCLObject* fcl_obj : { &broad_phase->manager_.object_, &broad_phase->attached_bodies_ })
+    for (const FCLCollisionObjectPtr& object : fcl_obj->collision_objects_)
+      objects.push_back(object.get());
+  std::unordered_map<const fcl::CollisionObjectd*, std::size_t> order;
+  for (std::size_t i = 0; i < objects.size(); ++i)
+    order[objects[i]] = i;
+
+  std::vector<DistanceResult> parts(objects.size());
+  std::vector<char> done(objects.size(), 0);
+  forEachInBatch(objects.size(), [&](std::size_t /*thread*/, std::size_t i) {
+    SelfDistanceData drd(&req, &parts[i], objects[i], &order);
+    broad_phase->manager_.manager_->distance(const_cast<fcl::CollisionObjectd*>(objects[i]), &drd,
+                                             &selfDistanceCallback);
+    done[i] = drd.done;
+  });
+  releaseSelfCollisionBroadPhase(std::move(broad_phase));
+  mergeDistanceResults(req, parts, done, res);
 }
 
 void CollisionEnvFCL::distanceRobot(const DistanceRequest& req, DistanceResult& res,
@@ -353,9 +677,23 @@ void CollisionEnvFCL::distanceRobot(const DistanceRequest& req, DistanceResult&
   FCLObject fcl_obj;
   constructFCLObjectRobot(state, fcl_obj);
 
-  DistanceData drd(&req, &res);
-  for (std::size_t i = 0; !drd.done && i < fcl_obj.collision_objects_.size(); ++i)
+  if (!req.parallel)
+  {
+    DistanceData drd(&req, &res);
+    for (std::size_t i = 0; !drd.done && i < fcl_obj.collision_objects_.size(); ++i)
+      manager_->distance(fcl_obj.collision_objects_[i].get(), &drd, &distanceCallback);
+    return;
+  }
+
+  // query the links in parallel, each into its own result, and merge them in the order of the serial query
+  std::vector<DistanceResult> parts(fcl_obj.collision_objects_.size());
+  std::vector<char> done(fcl_obj.collision_objects_.size(), 0);
+  forEachInBatch(fcl_obj.collision_objects_.size(), [&](std::size_t /*thread*/, std::size_t i) {
+    DistanceData drd(&req, &parts[i]);
     manager_->distance(fcl_obj.collision_objects_[i].get(), &drd, &distanceCallback);
+    done[i] = drd.done;
+  });
+  mergeDistanceResults(req, parts, done, res);
 }
 
 void CollisionEnvFCL::updateFCLObject(const std::string& id)
@@ -439,27 +777,37 @@ void CollisionEnvFCL::notifyObjectChange(const ObjectConstPtr& obj, World::Actio
 
 void CollisionEnvFCL::updatedPaddingOrScaling(const std::vector<std::string>& links)
 {
-  std::size_t index;
   for (const auto& link : links)
   {
     const moveit::core::LinkModel* lmodel = robot_model_->getLinkModel(link);
     if (lmodel)
     {
-      for (std::size_t j = 0; j < lmodel->getShapes().size(); ++j)
-      {
-        FCLGeometryConstPtr g = createCollisionGeometry(lmodel->getShapes()[j], getLinkScale(lmodel->getName()),
-                                                        getLinkPadding(lmodel->getName()), lmodel, j);
-        if (g)
+      // drop the further convex parts of the link, they are recreated with the new padding and scaling
+      for (std::size_t i = robot_model_->getLinkGeometryCount(); i < robot_geoms_.size();)
+        if (robot_geoms_[i]->collision_geometry_data_->ptr.link == lmodel)
         {
-          index = lmodel->getFirstCollisionBodyTransformIndex() + j;
-          robot_geoms_[index] = g;
-          robot_fcl_objs_[index] = std::make_shared<const fcl::CollisionObjectd>(g->collision_geometry_);
+          robot_geoms_.erase(robot_geoms_.begin() + i);
+          robot_fcl_objs_.erase(robot_fcl_objs_.begin() + i);
         }
-      }
+        else
+          ++i;
+
+      for (std::size_t j = 0; j < lmodel->getShapes().size(); ++j)
+        createLinkGeometry(lmodel, j);
     }
     else
       RCLCPP_ERROR(LOGGER, "Updating padding or scaling for unknown link: '%s'", link.c_str());
   }
+
+  // attached bodies use the scale and padding of their links as well
+  {
+    std::lock_guard<std::mutex> slock(attached_body_geometry_lock_);
+    attached_body_geometry_.clear();
+  }
+
+  // the pooled self-collision broadphases still hold the old geometry
+  std::lock_guard<std::mutex> slock(self_broad_phases_lock_);
+  self_broad_phases_.clear();
 }
 
 }  // end of namespace collision_detection
@@ -42,6 +42,8 @@
 #include <moveit/robot_state/robot_state.h>
 #include <moveit/utils/robot_model_test_utils.h>
 
+#include <moveit/collision_detection/convex_decomposition.h>
+#include <moveit/collision_detection/occupancy_map.h>
 #include <moveit/collision_detection_fcl/collision_common.h>
 #include <moveit/collision_detection_fcl/collision_env_fcl.h>
 
@@ -140,6 +142,148 @@ TEST_F(CollisionDetectionEnvTest, LinksInCollision)
   ASSERT_TRUE(res.collision);
 }
 
+/** \brief Repeated self-collision checks reuse the broadphase of earlier checks and must still see every change. */
+TEST_F(CollisionDetectionEnvTest, PersistentSelfCollisionBroadPhase)
+{
+  moveit::core::RobotState colliding_state(robot_model_);
+  colliding_state.setToDefaultValues();
+  colliding_state.update();
+
+  for (int i = 0; i < 4; ++i)
+  {
+    collision_detection::CollisionRequest req;
+    collision_detection::CollisionResult res;
+    c_env_->checkSelfCollision(req, res, i % 2 ? colliding_state : *robot_state_, *acm_);
+    EXPECT_EQ(res.collision, i % 2 == 1) << "check " << i;
+  }
+
+  // enlarging the links must invalidate the cached broadphase geometry
+  c_env_->setPadding(0.2);
+  collision_detection::CollisionRequest req;
+  collision_detection::CollisionResult res;
+  c_env_->checkSelfCollision(req, res, *robot_state_, *acm_);
+  EXPECT_TRUE(res.collision);
+}
+
+/** \brief A batch of states gives the same results as checking them one by one. */
+TEST_F(CollisionDetectionEnvTest, CheckCollisionBatch)
+{
+  shapes::ShapeConstPtr box(new shapes::Box(0.1, 0.1, 0.1));
+  Eigen::Isometry3d pose = Eigen::Isometry3d::Identity();
+  pose.translation() = Eigen::Vector3d(0.4, 0.0, 0.5);
+  c_env_->getWorld()->addToObject("box", box, pose);
+
+  std::vector<moveit::core::RobotState> states(64, *robot_state_);
+  std::vector<const moveit::core::RobotState*> state_ptrs;
+  for (moveit::core::RobotState& state : states)
+  {
+    state.setToRandomPositions();
+    state.update();
+    state_ptrs.push_back(&state);
+  }
+
+  collision_detection::CollisionRequest req;
+  std::vector<collision_detection::CollisionResult> results;
+  c_env_->checkCollisionBatch(req, results, state_ptrs, *acm_);
+  ASSERT_EQ(results.size(), states.size());
+  for (std::size_t i = 0; i < states.size(); ++i)
+  {
+    collision_detection::CollisionResult expected;
+    c_env_->checkCollision(req, expected, states[i], *acm_);
+    EXPECT_EQ(results[i].collision, expected.collision) << "state " << i;
+  }
+}
+
+/** \brief Parallel distance queries give the same results as serial ones. */
+TEST_F(CollisionDetectionEnvTest, ParallelDistance)
+{
+  shapes::ShapeConstPtr box(new shapes::Box(0.1, 0.1, 0.1));
+  for (int i = 0; i < 3; ++i)
+  {
+    Eigen::Isometry3d pose = Eigen::Isometry3d::Identity();
+    pose.translation() = Eigen::Vector3d(0.4, -0.3 + 0.3 * i, 0.3 + 0.2 * i);
+    c_env_->getWorld()->addToObject("box" + std::to_string(i), box, pose);
+  }
+
+  for (collision_detection::DistanceRequestType type :
+       { collision_detection::DistanceRequestType::GLOBAL, collision_detection::DistanceRequestType::SINGLE })
+  {
+    collision_detection::DistanceRequest req;
+    req.type = type;
+    req.acm = acm_.get();
+    req.enable_nearest_points = true;
+    collision_detection::DistanceRequest parallel_req = req;
+    parallel_req.parallel = true;
+
+    collision_detection::DistanceResult serial_res, parallel_res;
+    c_env_->distanceRobot(req, serial_res, *robot_state_);
+    c_env_->distanceRobot(parallel_req, parallel_res, *robot_state_);
+    EXPECT_EQ(serial_res.collision, parallel_res.collision);
+    EXPECT_DOUBLE_EQ(serial_res.minimum_distance.distance, parallel_res.minimum_distance.distance);
+    EXPECT_EQ(serial_res.minimum_distance.link_names[0], parallel_res.minimum_distance.link_names[0]);
+    EXPECT_EQ(serial_res.minimum_distance.link_names[1], parallel_res.minimum_distance.link_names[1]);
+    ASSERT_EQ(serial_res.distances.size(), parallel_res.distances.size());
+    for (const auto& pair : serial_res.distances)
+    {
+      auto it = parallel_res.distances.find(pair.first);
+      ASSERT_NE(it, parallel_res.distances.end()) << pair.first.first << " " << pair.first.second;
+      EXPECT_DOUBLE_EQ(pair.second[0].distance, it->second[0].distance);
+    }
+
+    serial_res.clear();
+    parallel_res.clear();
+    c_env_->distanceSelf(req, serial_res, *robot_state_);
+    c_env_->distanceSelf(parallel_req, parallel_res, *robot_state_);
+    EXPECT_EQ(serial_res.collision, parallel_res.collision);
+    EXPECT_DOUBLE_EQ(serial_res.minimum_distance.distance, parallel_res.minimum_distance.distance);
+    ASSERT_EQ(serial_res.distances.size(), parallel_res.distances.size());
+    for (const auto& pair : serial_res.distances)
+    {
+      auto it = parallel_res.distances.find(pair.first);
+      ASSERT_NE(it, parallel_res.distances.end()) << pair.first.first << " " << pair.first.second;
+      EXPECT_DOUBLE_EQ(pair.second[0].distance, it->second[0].distance);
+    }
+  }
+}
+
+/** \brief An obstacle passed through between two collision-free states is found by the continuous check. */
+TEST_F(CollisionDetectionEnvTest, ContinuousCollisionWorldSwept)
+{
+  shapes::ShapeConstPtr box(new shapes::Box(0.1, 0.1, 0.1));
+  Eigen::Isometry3d pose = Eigen::Isometry3d::Identity();
+  pose.translation() = Eigen::Vector3d(0.3, 0.0, 0.55);
+  c_env_->getWorld()->addToObject("box", box, pose);
+
+  moveit::core::RobotState start(*robot_state_);
+  moveit::core::RobotState end(*robot_state_);
+  start.setVariablePosition("panda_joint1", -1.2);
+  end.setVariablePosition("panda_joint1", 1.2);
+  start.update();
+  end.update();
+
+  collision_detection::CollisionRequest req;
+  collision_detection::CollisionResult res;
+  c_env_->checkRobotCollision(req, res, start, *acm_);
+  ASSERT_FALSE(res.collision);
+  c_env_->checkRobotCollision(req, res, end, *acm_);
+  ASSERT_FALSE(res.collision);
+
+  req.contacts = true;
+  c_env_->checkRobotCollision(req, res, start, end, *acm_);
+  EXPECT_TRUE(res.collision);
+  ASSERT_GE(res.contact_count, 1u);
+  const collision_detection::Contact& contact = res.contacts.begin()->second.front();
+  EXPECT_GT(contact.percent_interpolation, 0.0);
+  EXPECT_LT(contact.percent_interpolation, 1.0);
+
+  // nothing is in the way once the box is lifted above the robot
+  pose.translation().z() = 2.0;
+  c_env_->getWorld()->moveShapeInObject("box", box, pose);
+  res.clear();
+  c_env_->checkRobotCollision(req, res, start, end, *acm_);
+  EXPECT_FALSE(res.collision);
+}
+
 /** \brief Adding obstacles to the world which are tested against the robot. Simple cases. */
 TEST_F(CollisionDetectionEnvTest, RobotWorldCollision_1)
 {
@@ -191,6 +335,164 @@ TEST_F(CollisionDetectionEnvTest, RobotWorldCollision_2)
   res.clear();
 }
 
+/** \brief Level-of-detail culling against an octree reports the same collisions as the full resolution check, also
+ *  after the octree was modified in place. */
+TEST_F(CollisionDetectionEnvTest, OctreeLevelOfDetail)
+{
+  auto tree = std::make_shared<collision_detection::OccMapTree>(0.01);
+  {
+    collision_detection::OccMapTree::WriteLock lock = tree->writing();
+    tree->updateNode(octomap::point3d(0.5, 0.5, 0.05), true);
+  }
+  c_env_->getWorld()->addToObject("<octomap>", std::make_shared<const shapes::OcTree>(tree),
+                                  Eigen::Isometry3d::Identity());
+
+  collision_detection::CollisionRequest req;
+  collision_detection::CollisionRequest lod_req;
+  lod_req.octree_lod_levels = 3;
+  collision_detection::CollisionResult res;
+  c_env_->checkRobotCollision(req, res, *robot_state_, *acm_);
+  EXPECT_FALSE(res.collision);
+  res.clear();
+  c_env_->checkRobotCollision(lod_req, res, *robot_state_, *acm_);
+  EXPECT_FALSE(res.collision);
+  res.clear();
+
+  // fill a block around the robot, the cached coarse tree must be rebuilt
+  {
+    collision_detection::OccMapTree::WriteLock lock = tree->writing();
+    for (double x = -0.05; x <= 0.05; x += 0.01)
+      for (double y = -0.05; y <= 0.05; y += 0.01)
+        tree->updateNode(octomap::point3d(x, y, 0.3), true);
+  }
+  c_env_->getWorld()->notifyShapesUpdated("<octomap>");
+  c_env_->checkRobotCollision(req, res, *robot_state_, *acm_);
+  EXPECT_TRUE(res.collision);
+  res.clear();
+  c_env_->checkRobotCollision(lod_req, res, *robot_state_, *acm_);
+  EXPECT_TRUE(res.collision);
+}
+
+/** \brief Identical meshes share their FCL geometry, but contacts are still reported for the right object. */
+TEST_F(CollisionDetectionEnvTest, SharedMeshGeometry)
+{
+  collision_detection::CollisionRequest req;
+  collision_detection::CollisionResult res;
+  req.contacts = true;
+  req.max_contacts = 10;
+
+  const shapes::Box box(.4, .4, .4);
+  shapes::ShapeConstPtr mesh_a(shapes::createMeshFromShape(box));
+  shapes::ShapeConstPtr mesh_b(shapes::createMeshFromShape(box));
+
+  Eigen::Isometry3d pos_a = Eigen::Isometry3d::Identity();
+  pos_a.translation().z() = 0.3;
+  Eigen::Isometry3d pos_b = Eigen::Isometry3d::Identity();
+  pos_b.translation().x() = 3.0;
+  c_env_->getWorld()->addToObject("tote_b", mesh_b, pos_b);
+  c_env_->getWorld()->addToObject("tote_a", mesh_a, pos_a);
+
+  collision_detection::FCLGeometryConstPtr geometry_a =
+      collision_detection::createCollisionGeometry(mesh_a, c_env_->getWorld()->getObject("tote_a").get());
+  collision_detection::FCLGeometryConstPtr geometry_b =
+      collision_detection::createCollisionGeometry(mesh_b, c_env_->getWorld()->getObject("tote_b").get());
+  ASSERT_TRUE(geometry_a && geometry_b);
+  EXPECT_EQ(geometry_a->collision_geometry_, geometry_b->collision_geometry_);
+  EXPECT_NE(geometry_a->collision_geometry_data_->getID(), geometry_b->collision_geometry_data_->getID());
+
+  c_env_->checkRobotCollision(req, res, *robot_state_, *acm_);
+  ASSERT_TRUE(res.collision);
+  for (const auto& contacts : res.contacts)
+  {
+    EXPECT_TRUE(contacts.first.first == "tote_a" || contacts.first.second == "tote_a");
+    EXPECT_NE(contacts.first.first, "tote_b");
+    EXPECT_NE(contacts.first.second, "tote_b");
+  }
+}
+
+/** \brief A mesh decomposed into convex parts keeps its concavities: the robot fits into an open tote. */
+TEST_F(CollisionDetectionEnvTest, ConvexDecompositionOfWorldMesh)
+{
+  // a floor and four walls around the robot, as one mesh
+  std::vector<double> vertices;
+  std::vector<unsigned int> triangles;
+  const auto add_box = [&](const Eigen::Vector3d& size, const Eigen::Vector3d& center) {
+    const std::unique_ptr<shapes::Mesh> box(shapes::createMeshFromShape(shapes::Box(size.x(), size.y(), size.z())));
+    const unsigned int offset = vertices.size() / 3;
+    for (unsigned int i = 0; i < 3 * box->vertex_count; ++i)
+      vertices.push_back(box->vertices[i] + center[i % 3]);
+    for (unsigned int i = 0; i < 3 * box->triangle_count; ++i)
+      triangles.push_back(box->triangles[i] + offset);
+  };
+  add_box(Eigen::Vector3d(1.8, 1.8, 0.1), Eigen::Vector3d(0.0, 0.0, -0.15));
+  add_box(Eigen::Vector3d(0.1, 1.8, 1.2), Eigen::Vector3d(0.85, 0.0, 0.4));
+  add_box(Eigen::Vector3d(0.1, 1.8, 1.2), Eigen::Vector3d(-0.85, 0.0, 0.4));
+  add_box(Eigen::Vector3d(1.6, 0.1, 1.2), Eigen::Vector3d(0.0, 0.85, 0.4));
+  add_box(Eigen::Vector3d(1.6, 0.1, 1.2), Eigen::Vector3d(0.0, -0.85, 0.4));
+  auto tote = std::make_shared<shapes::Mesh>(vertices.size() / 3, triangles.size() / 3);
+  std::copy(vertices.begin(), vertices.end(), tote->vertices);
+  std::copy(triangles.begin(), triangles.end(), tote->triangles);
+
+  collision_detection::ConvexDecompositionOptions options;
+  options.enabled = true;
+  collision_detection::ConvexDecompositionCache::instance().setOptions(options);
+
+  c_env_->getWorld()->addToObject("tote", tote, Eigen::Isometry3d::Identity());
+  std::vector<collision_detection::FCLGeometryConstPtr> geometries;
+  collision_detection::createCollisionGeometries(tote, c_env_->getWorld()->getObject("tote").get(), geometries);
+  EXPECT_GE(geometries.size(), 5u);
+
+  collision_detection::CollisionRequest req;
+  collision_detection::CollisionResult res;
+  c_env_->checkRobotCollision(req, res, *robot_state_, *acm_);
+  EXPECT_FALSE(res.collision);
+  res.clear();
+
+  // a wall through the robot
+  Eigen::Isometry3d shifted = Eigen::Isometry3d::Identity();
+  shifted.translation().x() = 0.85;
+  c_env_->getWorld()->moveObject("tote", shifted);
+  c_env_->checkRobotCollision(req, res, *robot_state_, *acm_);
+  EXPECT_TRUE(res.collision);
+
+  collision_detection::ConvexDecompositionCache::instance().setOptions(collision_detection::ConvexDecompositionOptions());
+}
+
+/** \brief Copies of a state share the geometry of their attached bodies, contacts still name the copy's bodies. */
+TEST_F(CollisionDetectionEnvTest, AttachedBodyCopies)
+{
+  collision_detection::CollisionRequest req;
+  req.contacts = true;
+  req.max_contacts = 10;
+
+  const shapes::Box box(.1, .1, .1);
+  shapes::ShapeConstPtr tool(shapes::createMeshFromShape(box));
+  Eigen::Isometry3d tool_pose = Eigen::Isometry3d::Identity();
+  tool_pose.translation().z() = 0.3;
+  robot_state_->attachBody("tool", tool_pose, { tool }, { Eigen::Isometry3d::Identity() },
+                           std::set<std::string>{ "panda_hand" }, "panda_hand");
+  robot_state_->update();
+
+  Eigen::Isometry3d obstacle_pose = robot_state_->getGlobalLinkTransform("panda_hand") * tool_pose;
+  c_env_->getWorld()->addToObject("obstacle", std::make_shared<shapes::Sphere>(0.05), obstacle_pose);
+
+  const auto expect_tool_contact = [this, &req](const moveit::core::RobotState& state) {
+    collision_detection::CollisionResult res;
+    c_env_->checkRobotCollision(req, res, state, *acm_);
+    ASSERT_TRUE(res.collision);
+    ASSERT_EQ(1u, res.contacts.size());
+    const collision_detection::Contact& contact = res.contacts.begin()->second.front();
+    const bool tool_first = contact.body_type_1 == collision_detection::BodyTypes::ROBOT_ATTACHED;
+    EXPECT_EQ("tool", tool_first ? contact.body_name_1 : contact.body_name_2);
+  };
+  expect_tool_contact(*robot_state_);
+
+  // the copy reuses the geometry built for the original, which does not exist anymore
+  const moveit::core::RobotState copy(*robot_state_);
+  robot_state_.reset();
+  expect_tool_contact(copy);
+}
+
 /** \brief Tests the padding through expanding the link geometry in such a way that a collision occurs. */
 TEST_F(CollisionDetectionEnvTest, PaddingTest)
 {
@@ -213,7 +515,7 @@ TEST_F(CollisionDetectionEnvTest, PaddingTest)
   pos.translation().z() = 0.55;
   c_env_->getWorld()->addToObject("box", shape_ptr, pos);
 
-  c_env_->setLinkPadding("panda_hand", 0.08);
+  c_env_->setPadding(0.2);
   c_env_->checkRobotCollision(req, res, *robot_state_, *acm_);
   ASSERT_TRUE(res.collision);
   res.clear();
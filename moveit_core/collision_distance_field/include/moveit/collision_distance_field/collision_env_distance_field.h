@@ -43,6 +43,7 @@
 #include <moveit/planning_scene/planning_scene.h>
 #include "rclcpp/rclcpp.hpp"
 #include <mutex>
+#include <shared_mutex>
 
 namespace collision_detection
 {
@@ -141,6 +142,8 @@ public:
   {
     std::map<std::string, std::vector<PosedBodyPointDecompositionPtr>> posed_body_point_decompositions_;
     distance_field::DistanceFieldPtr distance_field_;
+    /** version of the world the field represents */
+    std::uint64_t version_ = 0;
   };
 
   ~CollisionEnvDistanceField() override;
@@ -205,8 +208,15 @@ public:
     return distance_field_cache_entry_->distance_field_;
   }
 
+  /** \brief Get the distance field that holds the objects of the world */
+  distance_field::DistanceFieldConstPtr getWorldDistanceField() const
+  {
+    return distance_field_cache_entry_world_->distance_field_;
+  }
+
   collision_detection::GroupStateRepresentationConstPtr getLastGroupStateRepresentation() const
   {
+    std::scoped_lock slock(last_gsr_lock_);
     return last_gsr_;
   }
 
@@ -258,6 +268,8 @@ protected:
 
   PosedBodyPointDecompositionPtr getPosedLinkBodyPointDecomposition(const moveit::core::LinkModel* ls) const;
 
+  void setLastGroupStateRepresentation(const GroupStateRepresentationPtr& gsr) const;
+
   void getGroupStateRepresentation(const DistanceFieldCacheEntryConstPtr& dfce, const moveit::core::RobotState& state,
                                    GroupStateRepresentationPtr& gsr) const;
 
@@ -269,8 +281,14 @@ protected:
 
   void updatedPaddingOrScaling(const std::vector<std::string>& /*links*/) override{};
 
+  /** \brief Get the world distance field for the current world. Fields are cached across environments by world
+   * version, so this either shares a cached field, updates a copy of a field cached for an earlier version of the
+   * world, or generates a new one. */
   DistanceFieldCacheEntryWorldPtr generateDistanceFieldCacheEntryWorld();
 
+  /** \brief Copy distance_field_cache_entry_world_ if it is shared with other environments, before modifying it */
+  void ensureUniqueDistanceFieldCacheEntryWorld();
+
   void updateDistanceObject(const std::string& id, CollisionEnvDistanceField::DistanceFieldCacheEntryWorldPtr& dfce,
                             EigenSTL::vector_Vector3d& add_points, EigenSTL::vector_Vector3d& subtract_points);
 
@@ -303,8 +321,13 @@ protected:
 
   planning_scene::PlanningScenePtr planning_scene_;
 
-  mutable std::mutex update_cache_lock_world_;
+  // guards distance_field_cache_entry_world_: world updates modify the field while queries read it
+  mutable std::shared_mutex update_cache_lock_world_;
   DistanceFieldCacheEntryWorldPtr distance_field_cache_entry_world_;
+  // whether distance_field_cache_entry_world_ is shared with the cache of world distance fields
+  bool distance_field_cache_entry_world_shared_ = false;
+  // guards last_gsr_: queries with separate group state representations may run concurrently
+  mutable std::mutex last_gsr_lock_;
   GroupStateRepresentationPtr last_gsr_;
   World::ObserverHandle observer_handle_;
 };
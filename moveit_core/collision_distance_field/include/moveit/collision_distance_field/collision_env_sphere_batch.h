@@ -0,0 +1,109 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#pragma once
+
+#include <moveit/collision_distance_field/collision_env_sphere_prefilter.h>
+
+namespace collision_detection
+{
+MOVEIT_CLASS_FORWARD(CollisionEnvSphereBatch);  // Defines CollisionEnvSphereBatchPtr, ConstPtr, WeakPtr... etc
+
+/** \brief A collision environment for checking large batches of states, e.g. to rank grasps or trajectories.
+ *
+ *  Every collision shape of the robot is covered by a row of spheres along the axis of its bounding cylinder, the
+ *  layout the body decompositions of collision_distance_field use, with radii enlarged so that the spheres enclose
+ *  the padded and scaled shape. checkCollisionBatch() poses these spheres for each state and tests them against the
+ *  distance field of the world and against the spheres of every link pair the allowed collision matrix does not
+ *  always allow to collide. The pairs and the field lookup parameters are set up once per batch. States whose spheres
+ *  all keep clear are answered as collision-free; the others, and requests asking for more than a binary answer, are
+ *  checked exactly by FCL. Single-state queries are answered as by CollisionEnvSpherePrefilter. */
+class CollisionEnvSphereBatch : public CollisionEnvSpherePrefilter
+{
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  CollisionEnvSphereBatch(const moveit::core::RobotModelConstPtr& robot_model, double padding = 0.0,
+                          double scale = 1.0);
+
+  CollisionEnvSphereBatch(const moveit::core::RobotModelConstPtr& robot_model, const WorldPtr& world,
+                          double padding = 0.0, double scale = 1.0);
+
+  CollisionEnvSphereBatch(const CollisionEnvSphereBatch& other, const WorldPtr& world);
+
+  void checkCollisionBatch(const CollisionRequest& req, std::vector<CollisionResult>& res,
+                           const std::vector<const moveit::core::RobotState*>& states,
+                           const AllowedCollisionMatrix& acm) const override;
+
+  /** \brief The number of spheres covering the robot */
+  std::size_t getSphereCount() const
+  {
+    return sphere_radii_.size();
+  }
+
+protected:
+  void updatedPaddingOrScaling(const std::vector<std::string>& links) override;
+
+private:
+  /** \brief The spheres covering one collision shape, stored at [first, first + count) of the sphere arrays */
+  struct CoveredShape
+  {
+    const moveit::core::LinkModel* link;
+    std::size_t shape_index;
+    std::size_t first;
+    std::size_t count;
+  };
+
+  /** \brief Everything about the batch that does not depend on the state */
+  struct BatchSetup;
+
+  void computeCoveringSpheres();
+
+  /** \brief Place the spheres of \e state in the model frame, or return false if the state has attached bodies */
+  bool poseSpheres(const moveit::core::RobotState& state, EigenSTL::vector_Vector3d& centers) const;
+
+  bool isSelfClear(const BatchSetup& setup, const EigenSTL::vector_Vector3d& centers) const;
+
+  bool isWorldClear(const BatchSetup& setup, const EigenSTL::vector_Vector3d& centers) const;
+
+  std::vector<CoveredShape> covered_shapes_;
+
+  /** \brief Centers of the spheres in the frame of their shape, and their radii */
+  EigenSTL::vector_Vector3d sphere_centers_;
+  std::vector<double> sphere_radii_;
+
+  /** \brief The index of the link each sphere belongs to */
+  std::vector<int> sphere_links_;
+};
+}  // namespace collision_detection
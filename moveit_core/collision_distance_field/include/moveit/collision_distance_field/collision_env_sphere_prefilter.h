@@ -0,0 +1,163 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#pragma once
+
+#include <moveit/collision_distance_field/collision_env_hybrid.h>
+#include <atomic>
+
+namespace collision_detection
+{
+MOVEIT_CLASS_FORWARD(CollisionEnvSpherePrefilter);  // Defines CollisionEnvSpherePrefilterPtr, ConstPtr, WeakPtr... etc
+
+/** \brief A collision environment that answers clearly collision-free queries from bounding spheres and falls back
+ *  to the exact FCL checks of CollisionEnvHybrid for everything else.
+ *
+ *  Every collision shape of the robot is approximated by its (padded and scaled) bounding sphere. For a robot-world
+ *  check, each sphere is looked up in the distance field of the world; for a self check, the spheres of every pair of
+ *  links that is not always allowed to collide are tested against each other. If all spheres are separated by more
+ *  than the discretization error of the field, the query is answered as collision-free without running FCL. Otherwise,
+ *  or if the query asks for more than a binary answer, FCL computes the result. The answer is therefore always the
+ *  one FCL would give. World objects the distance field cannot represent faithfully (planes, octrees and shapes too
+ *  thin to leave points in the field) disable the robot-world fast path while they are present. */
+class CollisionEnvSpherePrefilter : public CollisionEnvHybrid
+{
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  CollisionEnvSpherePrefilter(const moveit::core::RobotModelConstPtr& robot_model, double padding = 0.0,
+                              double scale = 1.0);
+
+  CollisionEnvSpherePrefilter(const moveit::core::RobotModelConstPtr& robot_model, const WorldPtr& world,
+                              double padding = 0.0, double scale = 1.0);
+
+  CollisionEnvSpherePrefilter(const CollisionEnvSpherePrefilter& other, const WorldPtr& world);
+
+  ~CollisionEnvSpherePrefilter() override;
+
+  using CollisionEnvFCL::checkRobotCollision;
+  using CollisionEnvFCL::checkSelfCollision;
+
+  void checkSelfCollision(const CollisionRequest& req, CollisionResult& res,
+                          const moveit::core::RobotState& state) const override;
+
+  void checkSelfCollision(const CollisionRequest& req, CollisionResult& res, const moveit::core::RobotState& state,
+                          const AllowedCollisionMatrix& acm) const override;
+
+  void checkRobotCollision(const CollisionRequest& req, CollisionResult& res,
+                           const moveit::core::RobotState& state) const override;
+
+  void checkRobotCollision(const CollisionRequest& req, CollisionResult& res, const moveit::core::RobotState& state,
+                           const AllowedCollisionMatrix& acm) const override;
+
+  void setWorld(const WorldPtr& world) override;
+
+  /** \brief Set an additional clearance the spheres need to keep before a query is answered by the fast path */
+  void setSafetyMargin(double margin)
+  {
+    safety_margin_ = margin;
+  }
+
+  double getSafetyMargin() const
+  {
+    return safety_margin_;
+  }
+
+  /** \brief The number of queries answered by the sphere test since construction or resetCounters() */
+  std::size_t getFastPathCount() const
+  {
+    return fast_path_count_;
+  }
+
+  /** \brief The number of queries passed on to FCL since construction or resetCounters() */
+  std::size_t getExactCheckCount() const
+  {
+    return exact_check_count_;
+  }
+
+  void resetCounters()
+  {
+    fast_path_count_ = 0;
+    exact_check_count_ = 0;
+  }
+
+protected:
+  void updatedPaddingOrScaling(const std::vector<std::string>& links) override;
+
+  /** \brief Whether a request can be answered by a plain "no collision" */
+  static bool isBinaryRequest(const CollisionRequest& req);
+
+  /** \brief The distance a point within the distance field of the world needs to report for a sphere of radius 0
+   *  around it to be certainly clear of the world, including the safety margin */
+  double getWorldDistanceSlack() const;
+
+  double safety_margin_ = 0.0;
+
+  /** \brief False if some world object is not faithfully represented by the points in the distance field */
+  std::atomic<bool> world_represented_{ true };
+
+  mutable std::atomic<std::size_t> fast_path_count_{ 0 };
+  mutable std::atomic<std::size_t> exact_check_count_{ 0 };
+
+private:
+  /** \brief The bounding sphere of one collision shape, expressed in the frame of that shape */
+  struct LinkSphere
+  {
+    const moveit::core::LinkModel* link;
+    std::size_t shape_index;
+    Eigen::Vector3d center;
+    double radius;
+  };
+
+  void computeLinkSpheres(const moveit::core::LinkModel* link);
+
+  void computeAllLinkSpheres();
+
+  /** \brief Place the bounding spheres of \e state in the model frame, or return false if the state has attached
+   *  bodies, which are not approximated */
+  bool getPosedSpheres(const moveit::core::RobotState& state, EigenSTL::vector_Vector3d& centers) const;
+
+  bool isSelfClearlyFree(const moveit::core::RobotState& state, const AllowedCollisionMatrix* acm) const;
+
+  bool isRobotClearlyFree(const moveit::core::RobotState& state) const;
+
+  /** \brief Recompute whether every world object is represented in the distance field */
+  void updateWorldRepresented();
+
+  /** \brief The bounding spheres of all collision shapes of the robot, ordered by link index */
+  std::vector<LinkSphere> link_spheres_;
+
+  World::ObserverHandle prefilter_observer_handle_;
+};
+}  // namespace collision_detection
@@ -49,8 +49,11 @@
 #include <moveit/collision_distance_field/collision_common_distance_field.h>
 #include <moveit/distance_field/propagation_distance_field.h>
 #include <moveit/collision_distance_field/collision_detector_allocator_distance_field.h>
+#include <deque>
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <set>
 #include <utility>
 
 namespace collision_detection
@@ -59,6 +62,94 @@ const rclcpp::Logger CollisionEnvDistanceField::LOGGER =
     rclcpp::get_logger("moveit_collision_distance_field.collision_robot_distance_field");
 const double EPSILON = 0.001f;
 
+namespace
+{
+// Distance fields of the world for recently seen world versions, shared read-only by all environments with the same
+// field parameters. Planning scene diffs start out with the world version of their parent, so the environments
+// allocated for each planning request find the field of the monitored scene here, or a field that only lacks the
+// latest changes of the world, instead of generating it from scratch.
+class WorldDistanceFieldCache
+{
+public:
+  struct Key
+  {
+    Eigen::Vector3d size;
+    Eigen::Vector3d origin;
+    double resolution;
+    double max_propagation_distance;
+    bool use_signed_distance_field;
+
+    bool operator==(const Key& other) const
+    {
+      return size == other.size && origin == other.origin && resolution == other.resolution &&
+             max_propagation_distance == other.max_propagation_distance &&
+             use_signed_distance_field == other.use_signed_distance_field;
+    }
+  };
+
+  /** \brief Find the entry for \e key whose world version is closest to \e world: the ids of the objects that
+   * changed since then are added to \e changed_ids. Returns null if no entry is part of the history of \e world. */
+  CollisionEnvDistanceField::DistanceFieldCacheEntryWorldPtr find(const Key& key, const World& world,
+                                                                  std::set<std::string>& changed_ids)
+  {
+    std::scoped_lock slock(lock_);
+    auto best = entries_.end();
+    for (auto it = entries_.begin(); it != entries_.end(); ++it)
+    {
+      std::set<std::string> ids;
+      if (!(it->first == key) || !world.getChangedObjectIds(it->second->version_, ids))
+        continue;
+      if (best == entries_.end() || ids.size() < changed_ids.size())
+      {
+        best = it;
+        changed_ids.swap(ids);
+      }
+      if (changed_ids.empty())
+        break;
+    }
+    if (best == entries_.end())
+      return nullptr;
+
+    // keep recently used entries at the front
+    auto entry = *best;
+    entries_.erase(best);
+    entries_.push_front(entry);
+    return entry.second;
+  }
+
+  void insert(const Key& key, const CollisionEnvDistanceField::DistanceFieldCacheEntryWorldPtr& dfce)
+  {
+    std::scoped_lock slock(lock_);
+    entries_.emplace_front(key, dfce);
+    if (entries_.size() > MAX_ENTRIES)
+      entries_.pop_back();
+  }
+
+private:
+  // fields are large (the default 3 x 3 x 4 m at 2 cm resolution takes more than 100 MB), so only few are kept
+  static constexpr std::size_t MAX_ENTRIES = 2;
+
+  std::mutex lock_;
+  std::deque<std::pair<Key, CollisionEnvDistanceField::DistanceFieldCacheEntryWorldPtr>> entries_;
+};
+
+WorldDistanceFieldCache& getWorldDistanceFieldCache()
+{
+  static WorldDistanceFieldCache cache;
+  return cache;
+}
+
+CollisionEnvDistanceField::DistanceFieldCacheEntryWorldPtr
+cloneDistanceFieldCacheEntryWorld(const CollisionEnvDistanceField::DistanceFieldCacheEntryWorld& dfce)
+{
+  // posed decompositions are replaced rather than modified on updates, so only the field itself needs a deep copy
+  auto clone = std::make_shared<CollisionEnvDistanceField::DistanceFieldCacheEntryWorld>(dfce);
+  clone->distance_field_ = std::make_shared<distance_field::PropagationDistanceField>(
+      static_cast<const distance_field::PropagationDistanceField&>(*dfce.distance_field_));
+  return clone;
+}
+}  // namespace
+
 const std::string collision_detection::CollisionDetectorAllocatorDistanceField::NAME("DISTANCE_FIELD");
 
 CollisionEnvDistanceField::CollisionEnvDistanceField(
@@ -95,8 +186,6 @@ CollisionEnvDistanceField::CollisionEnvDistanceField(
   // request notifications about changes to world
   observer_handle_ = getWorld()->addObserver(
       [this](const World::ObjectConstPtr& object, World::Action action) { return notifyObjectChange(object, action); });
-
-  getWorld()->notifyObserverAllObjects(observer_handle_, World::CREATE);
 }
 
 CollisionEnvDistanceField::CollisionEnvDistanceField(const CollisionEnvDistanceField& other, const WorldPtr& world)
@@ -119,7 +208,6 @@ CollisionEnvDistanceField::CollisionEnvDistanceField(const CollisionEnvDistanceF
   // request notifications about changes to world
   observer_handle_ = getWorld()->addObserver(
       [this](const World::ObjectConstPtr& object, World::Action action) { return notifyObjectChange(object, action); });
-  getWorld()->notifyObserverAllObjects(observer_handle_, World::CREATE);
 }
 
 CollisionEnvDistanceField::~CollisionEnvDistanceField()
@@ -1158,6 +1246,12 @@ void CollisionEnvDistanceField::updateGroupStateRepresentationState(const moveit
   }
 }
 
+void CollisionEnvDistanceField::setLastGroupStateRepresentation(const GroupStateRepresentationPtr& gsr) const
+{
+  std::scoped_lock slock(last_gsr_lock_);
+  (const_cast<CollisionEnvDistanceField*>(this))->last_gsr_ = gsr;
+}
+
 void CollisionEnvDistanceField::getGroupStateRepresentation(const DistanceFieldCacheEntryConstPtr& dfce,
                                                             const moveit::core::RobotState& state,
                                                             GroupStateRepresentationPtr& gsr) const
@@ -1409,10 +1503,11 @@ void CollisionEnvDistanceField::checkCollision(const CollisionRequest& req, Coll
   }
   if (!done)
   {
+    std::shared_lock<std::shared_mutex> world_lock(update_cache_lock_world_);
     getEnvironmentCollisions(req, res, distance_field_cache_entry_world_->distance_field_, gsr);
   }
 
-  (const_cast<CollisionEnvDistanceField*>(this))->last_gsr_ = gsr;
+  setLastGroupStateRepresentation(gsr);
 }
 
 void CollisionEnvDistanceField::checkCollision(const CollisionRequest& req, CollisionResult& res,
@@ -1442,10 +1537,11 @@ void CollisionEnvDistanceField::checkCollision(const CollisionRequest& req, Coll
   }
   if (!done)
   {
+    std::shared_lock<std::shared_mutex> world_lock(update_cache_lock_world_);
     getEnvironmentCollisions(req, res, distance_field_cache_entry_world_->distance_field_, gsr);
   }
 
-  (const_cast<CollisionEnvDistanceField*>(this))->last_gsr_ = gsr;
+  setLastGroupStateRepresentation(gsr);
 }
 
 void CollisionEnvDistanceField::checkRobotCollision(const CollisionRequest& req, CollisionResult& res,
@@ -1459,6 +1555,7 @@ void CollisionEnvDistanceField::checkRobotCollision(const CollisionRequest& req,
                                                     const moveit::core::RobotState& state,
                                                     GroupStateRepresentationPtr& gsr) const
 {
+  std::shared_lock<std::shared_mutex> world_lock(update_cache_lock_world_);
   distance_field::DistanceFieldConstPtr env_distance_field = distance_field_cache_entry_world_->distance_field_;
   if (!gsr)
   {
@@ -1469,7 +1566,7 @@ void CollisionEnvDistanceField::checkRobotCollision(const CollisionRequest& req,
     updateGroupStateRepresentationState(state, gsr);
   }
   getEnvironmentCollisions(req, res, env_distance_field, gsr);
-  (const_cast<CollisionEnvDistanceField*>(this))->last_gsr_ = gsr;
+  setLastGroupStateRepresentation(gsr);
 
   // checkRobotCollisionHelper(req, res, robot, state, &acm);
 }
@@ -1487,6 +1584,7 @@ void CollisionEnvDistanceField::checkRobotCollision(const CollisionRequest& req,
                                                     const AllowedCollisionMatrix& acm,
                                                     GroupStateRepresentationPtr& gsr) const
 {
+  std::shared_lock<std::shared_mutex> world_lock(update_cache_lock_world_);
   distance_field::DistanceFieldConstPtr env_distance_field = distance_field_cache_entry_world_->distance_field_;
 
   if (!gsr)
@@ -1498,7 +1596,7 @@ void CollisionEnvDistanceField::checkRobotCollision(const CollisionRequest& req,
     updateGroupStateRepresentationState(state, gsr);
   }
   getEnvironmentCollisions(req, res, env_distance_field, gsr);
-  (const_cast<CollisionEnvDistanceField*>(this))->last_gsr_ = gsr;
+  setLastGroupStateRepresentation(gsr);
 
   // checkRobotCollisionHelper(req, res, robot, state, &acm);
 }
@@ -1523,6 +1621,7 @@ void CollisionEnvDistanceField::getCollisionGradients(const CollisionRequest& re
                                                       const AllowedCollisionMatrix* acm,
                                                       GroupStateRepresentationPtr& gsr) const
 {
+  std::shared_lock<std::shared_mutex> world_lock(update_cache_lock_world_);
   distance_field::DistanceFieldConstPtr env_distance_field = distance_field_cache_entry_world_->distance_field_;
 
   if (!gsr)
@@ -1538,7 +1637,7 @@ void CollisionEnvDistanceField::getCollisionGradients(const CollisionRequest& re
   getIntraGroupProximityGradients(gsr);
   getEnvironmentProximityGradients(env_distance_field, gsr);
 
-  (const_cast<CollisionEnvDistanceField*>(this))->last_gsr_ = gsr;
+  setLastGroupStateRepresentation(gsr);
 }
 
 void CollisionEnvDistanceField::getAllCollisions(const CollisionRequest& req, CollisionResult& res,
@@ -1556,10 +1655,11 @@ void CollisionEnvDistanceField::getAllCollisions(const CollisionRequest& req, Co
   }
   getSelfCollisions(req, res, gsr);
   getIntraGroupCollisions(req, res, gsr);
+  std::shared_lock<std::shared_mutex> world_lock(update_cache_lock_world_);
   distance_field::DistanceFieldConstPtr env_distance_field = distance_field_cache_entry_world_->distance_field_;
   getEnvironmentCollisions(req, res, env_distance_field, gsr);
 
-  (const_cast<CollisionEnvDistanceField*>(this))->last_gsr_ = gsr;
+  setLastGroupStateRepresentation(gsr);
 }
 
 bool CollisionEnvDistanceField::getEnvironmentCollisions(const CollisionRequest& req, CollisionResult& res,
@@ -1692,17 +1792,16 @@ void CollisionEnvDistanceField::setWorld(const WorldPtr& world)
   // turn off notifications about old world
   getWorld()->removeObserver(observer_handle_);
 
-  // clear out objects from old world
-  distance_field_cache_entry_world_->distance_field_->reset();
-
   CollisionEnv::setWorld(world);
 
+  // the field of the new world is most likely cached already, as its scene allocated an environment for it
+  std::unique_lock<std::shared_mutex> world_lock(update_cache_lock_world_);
+  distance_field_cache_entry_world_ = generateDistanceFieldCacheEntryWorld();
+  world_lock.unlock();
+
   // request notifications about changes to new world
   observer_handle_ = getWorld()->addObserver(
       [this](const World::ObjectConstPtr& object, World::Action action) { return notifyObjectChange(object, action); });
-
-  // get notifications any objects already in the new world
-  getWorld()->notifyObserverAllObjects(observer_handle_, World::CREATE);
 }
 
 void CollisionEnvDistanceField::notifyObjectChange(const ObjectConstPtr& obj, World::Action action)
@@ -1712,12 +1811,26 @@ void CollisionEnvDistanceField::notifyObjectChange(const ObjectConstPtr& obj, Wo
 
   EigenSTL::vector_Vector3d add_points;
   EigenSTL::vector_Vector3d subtract_points;
+  std::unique_lock<std::shared_mutex> world_lock(update_cache_lock_world_);
+
+  // nothing to do if the field already represents this version of the world, e.g. when all objects are announced
+  // right after constructing the field
+  if (distance_field_cache_entry_world_->version_ == getWorld()->getVersion())
+    return;
+
+  ensureUniqueDistanceFieldCacheEntryWorld();
   updateDistanceObject(obj->id_, distance_field_cache_entry_world_, add_points, subtract_points);
 
   if (action == World::DESTROY)
   {
     distance_field_cache_entry_world_->distance_field_->removePointsFromField(subtract_points);
   }
+  else if (action == World::UPDATE_SHAPE)
+  {
+    // contents changed in place (e.g. an octomap update): most points are shared between the old and new sets, so
+    // only propagating the difference is much cheaper than clearing and re-adding the whole object
+    distance_field_cache_entry_world_->distance_field_->updatePointsInField(subtract_points, add_points);
+  }
   else if (action & (World::MOVE_SHAPE | World::REMOVE_SHAPE))
   {
     distance_field_cache_entry_world_->distance_field_->removePointsFromField(subtract_points);
@@ -1727,6 +1840,7 @@ void CollisionEnvDistanceField::notifyObjectChange(const ObjectConstPtr& obj, Wo
   {
     distance_field_cache_entry_world_->distance_field_->addPointsToField(add_points);
   }
+  distance_field_cache_entry_world_->version_ = getWorld()->getVersion();
 
   RCLCPP_DEBUG(LOGGER, "Modifying object %s took %lf s", obj->id_.c_str(), (clock.now() - start_time).seconds());
 }
@@ -1785,18 +1899,48 @@ void CollisionEnvDistanceField::updateDistanceObject(const std::string& id, Dist
 CollisionEnvDistanceField::DistanceFieldCacheEntryWorldPtr
 CollisionEnvDistanceField::generateDistanceFieldCacheEntryWorld()
 {
-  DistanceFieldCacheEntryWorldPtr dfce = std::make_shared<DistanceFieldCacheEntryWorld>();
-  dfce->distance_field_ = std::make_shared<distance_field::PropagationDistanceField>(
-      size_.x(), size_.y(), size_.z(), resolution_, origin_.x() - 0.5 * size_.x(), origin_.y() - 0.5 * size_.y(),
-      origin_.z() - 0.5 * size_.z(), max_propogation_distance_, use_signed_distance_field_);
+  const WorldDistanceFieldCache::Key key{ size_, origin_, resolution_, max_propogation_distance_,
+                                          use_signed_distance_field_ };
+  WorldDistanceFieldCache& cache = getWorldDistanceFieldCache();
+
+  std::set<std::string> changed_ids;
+  DistanceFieldCacheEntryWorldPtr dfce = cache.find(key, *getWorld(), changed_ids);
+  distance_field_cache_entry_world_shared_ = true;
+  if (dfce && changed_ids.empty())
+    return dfce;
 
   EigenSTL::vector_Vector3d add_points;
   EigenSTL::vector_Vector3d subtract_points;
-  for (const std::pair<const std::string, ObjectPtr>& object : *getWorld())
+  if (dfce)
+  {
+    // only the objects that changed since the cached version need to be updated
+    dfce = cloneDistanceFieldCacheEntryWorld(*dfce);
+    for (const std::string& id : changed_ids)
+      updateDistanceObject(id, dfce, add_points, subtract_points);
+    dfce->distance_field_->removePointsFromField(subtract_points);
+  }
+  else
   {
-    updateDistanceObject(object.first, dfce, add_points, subtract_points);
+    dfce = std::make_shared<DistanceFieldCacheEntryWorld>();
+    dfce->distance_field_ = std::make_shared<distance_field::PropagationDistanceField>(
+        size_.x(), size_.y(), size_.z(), resolution_, origin_.x() - 0.5 * size_.x(), origin_.y() - 0.5 * size_.y(),
+        origin_.z() - 0.5 * size_.z(), max_propogation_distance_, use_signed_distance_field_);
+    for (const std::pair<const std::string, ObjectPtr>& object : *getWorld())
+    {
+      updateDistanceObject(object.first, dfce, add_points, subtract_points);
+    }
   }
   dfce->distance_field_->addPointsToField(add_points);
+  dfce->version_ = getWorld()->getVersion();
+  cache.insert(key, dfce);
   return dfce;
 }
+
+void CollisionEnvDistanceField::ensureUniqueDistanceFieldCacheEntryWorld()
+{
+  if (!distance_field_cache_entry_world_shared_)
+    return;
+  distance_field_cache_entry_world_ = cloneDistanceFieldCacheEntryWorld(*distance_field_cache_entry_world_);
+  distance_field_cache_entry_world_shared_ = false;
+}
 }  // namespace collision_detection
@@ -0,0 +1,271 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/collision_distance_field/collision_detector_allocator_sphere_batch.h>
+#include <moveit/collision_distance_field/collision_env_sphere_batch.h>
+#include <geometric_shapes/bodies.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+
+namespace collision_detection
+{
+const std::string collision_detection::CollisionDetectorAllocatorSphereBatch::NAME("SphereBatch");
+
+static const rclcpp::Logger LOGGER = rclcpp::get_logger("moveit_collision_distance_field.collision_env_sphere_batch");
+
+namespace
+{
+// upper bound on the spheres covering one shape; fewer spheres are made larger to keep covering the shape
+const std::size_t MAX_SPHERES_PER_SHAPE = 32;
+}  // namespace
+
+struct CollisionEnvSphereBatch::BatchSetup
+{
+  /// Pairs of spheres on links that are not always allowed to collide
+  std::vector<std::pair<std::size_t, std::size_t>> self_pairs;
+
+  bool world_represented;
+  bool world_empty;
+  distance_field::DistanceFieldConstPtr field;
+  Eigen::Vector3d field_min;
+  Eigen::Vector3d field_max;
+  double slack;
+};
+
+CollisionEnvSphereBatch::CollisionEnvSphereBatch(const moveit::core::RobotModelConstPtr& robot_model, double padding,
+                                                 double scale)
+  : CollisionEnvSpherePrefilter(robot_model, padding, scale)
+{
+  computeCoveringSpheres();
+}
+
+CollisionEnvSphereBatch::CollisionEnvSphereBatch(const moveit::core::RobotModelConstPtr& robot_model,
+                                                 const WorldPtr& world, double padding, double scale)
+  : CollisionEnvSpherePrefilter(robot_model, world, padding, scale)
+{
+  computeCoveringSpheres();
+}
+
+CollisionEnvSphereBatch::CollisionEnvSphereBatch(const CollisionEnvSphereBatch& other, const WorldPtr& world)
+  : CollisionEnvSpherePrefilter(other, world)
+  , covered_shapes_(other.covered_shapes_)
+  , sphere_centers_(other.sphere_centers_)
+  , sphere_radii_(other.sphere_radii_)
+  , sphere_links_(other.sphere_links_)
+{
+}
+
+void CollisionEnvSphereBatch::computeCoveringSpheres()
+{
+  covered_shapes_.clear();
+  sphere_centers_.clear();
+  sphere_radii_.clear();
+  sphere_links_.clear();
+
+  for (const moveit::core::LinkModel* link : getRobotModel()->getLinkModelsWithCollisionGeometry())
+  {
+    const double padding = getLinkPadding(link->getName());
+    const double scale = getLinkScale(link->getName());
+    for (std::size_t i = 0; i < link->getShapes().size(); ++i)
+    {
+      CoveredShape covered{ link, i, sphere_radii_.size(), 0 };
+      const auto add_sphere = [&](const Eigen::Vector3d& center, double radius) {
+        sphere_centers_.push_back(center);
+        sphere_radii_.push_back(radius);
+        sphere_links_.push_back(link->getLinkIndex());
+        ++covered.count;
+      };
+
+      // pad and scale the shape the same way FCL does before wrapping it in a body
+      const std::unique_ptr<shapes::Shape> shape(link->getShapes()[i]->clone());
+      shape->scaleAndPadd(scale, padding);
+      const bodies::BodyPtr body(bodies::createEmptyBodyFromShapeType(shape->type));
+      if (!body)
+      {
+        RCLCPP_DEBUG(LOGGER, "Shape %zu of link '%s' can not be covered by spheres; it always takes the exact check", i,
+                     link->getName().c_str());
+        add_sphere(Eigen::Vector3d::Zero(), std::numeric_limits<double>::infinity());
+      }
+      else if (shape->type == shapes::SPHERE)
+        add_sphere(Eigen::Vector3d::Zero(), static_cast<const shapes::Sphere*>(shape.get())->radius);
+      else
+      {
+        body->setDimensionsDirty(shape.get());
+        body->updateInternalData();
+        bodies::BoundingCylinder cylinder;
+        body->computeBoundingCylinder(cylinder);
+
+        // determineCollisionSpheres() places spheres of the cylinder radius half a radius apart, which leaves the
+        // surface between them and the caps uncovered; each sphere here is grown to cover its slice of the cylinder
+        std::size_t count = 1;
+        if (cylinder.radius > 0.0)
+          count = std::clamp(static_cast<std::size_t>(std::ceil(2.0 * cylinder.length / cylinder.radius)),
+                             std::size_t(1), MAX_SPHERES_PER_SHAPE);
+        const double spacing = cylinder.length / count;
+        const double radius = std::hypot(cylinder.radius, 0.5 * spacing);
+        for (std::size_t k = 0; k < count; ++k)
+          add_sphere(cylinder.pose * Eigen::Vector3d(0.0, 0.0, -0.5 * cylinder.length + (k + 0.5) * spacing), radius);
+      }
+      covered_shapes_.push_back(covered);
+    }
+  }
+  RCLCPP_DEBUG(LOGGER, "Covered %zu collision shapes by %zu spheres", covered_shapes_.size(), sphere_radii_.size());
+}
+
+void CollisionEnvSphereBatch::updatedPaddingOrScaling(const std::vector<std::string>& links)
+{
+  CollisionEnvSpherePrefilter::updatedPaddingOrScaling(links);
+  computeCoveringSpheres();
+}
+
+bool CollisionEnvSphereBatch::poseSpheres(const moveit::core::RobotState& state,
+                                          EigenSTL::vector_Vector3d& centers) const
+{
+  std::vector<const moveit::core::AttachedBody*> attached_bodies;
+  state.getAttachedBodies(attached_bodies);
+  if (!attached_bodies.empty())
+    return false;
+
+  centers.resize(sphere_centers_.size());
+  for (const CoveredShape& covered : covered_shapes_)
+  {
+    const Eigen::Isometry3d& transform = state.getCollisionBodyTransform(covered.link, covered.shape_index);
+    for (std::size_t i = covered.first; i < covered.first + covered.count; ++i)
+      centers[i] = transform * sphere_centers_[i];
+  }
+  return true;
+}
+
+bool CollisionEnvSphereBatch::isSelfClear(const BatchSetup& setup, const EigenSTL::vector_Vector3d& centers) const
+{
+  for (const std::pair<std::size_t, std::size_t>& pair : setup.self_pairs)
+  {
+    const double reach = sphere_radii_[pair.first] + sphere_radii_[pair.second] + safety_margin_;
+    if ((centers[pair.first] - centers[pair.second]).squaredNorm() <= reach * reach)
+      return false;
+  }
+  return true;
+}
+
+bool CollisionEnvSphereBatch::isWorldClear(const BatchSetup& setup, const EigenSTL::vector_Vector3d& centers) const
+{
+  if (!setup.world_represented)
+    return false;
+  if (setup.world_empty)
+    return true;
+
+  for (std::size_t i = 0; i < centers.size(); ++i)
+  {
+    const double reach = sphere_radii_[i] + setup.slack;
+    // obstacles outside of the field are not represented, so the whole sphere needs to be inside of it
+    if (((centers[i].array() - reach) < setup.field_min.array()).any() ||
+        ((centers[i].array() + reach) > setup.field_max.array()).any())
+      return false;
+    if (setup.field->getDistance(centers[i].x(), centers[i].y(), centers[i].z()) <= reach)
+      return false;
+  }
+  return true;
+}
+
+void CollisionEnvSphereBatch::checkCollisionBatch(const CollisionRequest& req, std::vector<CollisionResult>& res,
+                                                  const std::vector<const moveit::core::RobotState*>& states,
+                                                  const AllowedCollisionMatrix& acm) const
+{
+  res.resize(states.size());
+  if (!isBinaryRequest(req))
+  {
+    forEachInBatch(states.size(), [&](std::size_t /*thread*/, std::size_t i) {
+      res[i].clear();
+      checkCollision(req, res[i], *states[i], acm);
+    });
+    return;
+  }
+
+  BatchSetup setup;
+  const IndexedAllowedCollisionMatrixConstPtr indexed_acm = acm.getIndexedLinkMatrix(*getRobotModel());
+  for (std::size_t a = 0; a < covered_shapes_.size(); ++a)
+  {
+    for (std::size_t b = a + 1; b < covered_shapes_.size(); ++b)
+    {
+      const CoveredShape& shape_a = covered_shapes_[a];
+      const CoveredShape& shape_b = covered_shapes_[b];
+      if (shape_a.link == shape_b.link)
+        continue;
+      AllowedCollision::Type type;
+      if (indexed_acm->getAllowedCollision(shape_a.link->getLinkIndex(), shape_b.link->getLinkIndex(), type) &&
+          type == AllowedCollision::ALWAYS)
+        continue;
+      for (std::size_t i = shape_a.first; i < shape_a.first + shape_a.count; ++i)
+        for (std::size_t j = shape_b.first; j < shape_b.first + shape_b.count; ++j)
+          setup.self_pairs.emplace_back(i, j);
+    }
+  }
+  setup.world_represented = world_represented_;
+  setup.world_empty = getWorld()->size() == 0;
+  setup.field = cenv_distance_->getWorldDistanceField();
+  setup.field_min = Eigen::Vector3d(setup.field->getOriginX(), setup.field->getOriginY(), setup.field->getOriginZ());
+  setup.field_max =
+      setup.field_min + Eigen::Vector3d(setup.field->getSizeX(), setup.field->getSizeY(), setup.field->getSizeZ());
+  setup.slack = getWorldDistanceSlack();
+
+  std::vector<EigenSTL::vector_Vector3d> thread_centers(getBatchThreadCount(states.size()));
+  forEachInBatch(states.size(), [&](std::size_t thread, std::size_t i) {
+    CollisionResult& result = res[i];
+    const moveit::core::RobotState& state = *states[i];
+    result.clear();
+
+    EigenSTL::vector_Vector3d& centers = thread_centers[thread];
+    const bool posed = poseSpheres(state, centers);
+    if (posed && isSelfClear(setup, centers))
+      ++fast_path_count_;
+    else
+    {
+      ++exact_check_count_;
+      CollisionEnvFCL::checkSelfCollision(req, result, state, acm);
+      if (result.collision)
+        return;
+    }
+
+    if (posed && isWorldClear(setup, centers))
+      ++fast_path_count_;
+    else
+    {
+      ++exact_check_count_;
+      CollisionEnvFCL::checkRobotCollision(req, result, state, acm);
+    }
+  });
+}
+}  // namespace collision_detection
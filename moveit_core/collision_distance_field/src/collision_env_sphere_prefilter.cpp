@@ -0,0 +1,316 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/collision_distance_field/collision_detector_allocator_sphere_prefilter.h>
+#include <moveit/collision_distance_field/collision_env_sphere_prefilter.h>
+#include <geometric_shapes/bodies.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+
+namespace collision_detection
+{
+const std::string collision_detection::CollisionDetectorAllocatorSpherePrefilter::NAME("SpherePrefilter");
+
+static const rclcpp::Logger LOGGER =
+    rclcpp::get_logger("moveit_collision_distance_field.collision_env_sphere_prefilter");
+
+CollisionEnvSpherePrefilter::CollisionEnvSpherePrefilter(const moveit::core::RobotModelConstPtr& robot_model,
+                                                         double padding, double scale)
+  : CollisionEnvHybrid(robot_model, std::map<std::string, std::vector<CollisionSphere>>(), DEFAULT_SIZE_X,
+                       DEFAULT_SIZE_Y, DEFAULT_SIZE_Z, Eigen::Vector3d(0, 0, 0), DEFAULT_USE_SIGNED_DISTANCE_FIELD,
+                       DEFAULT_RESOLUTION, DEFAULT_COLLISION_TOLERANCE, DEFAULT_MAX_PROPOGATION_DISTANCE, padding,
+                       scale)
+{
+  computeAllLinkSpheres();
+  prefilter_observer_handle_ =
+      getWorld()->addObserver([this](const World::ObjectConstPtr&, World::Action) { updateWorldRepresented(); });
+  updateWorldRepresented();
+}
+
+CollisionEnvSpherePrefilter::CollisionEnvSpherePrefilter(const moveit::core::RobotModelConstPtr& robot_model,
+                                                         const WorldPtr& world, double padding, double scale)
+  : CollisionEnvHybrid(robot_model, world, std::map<std::string, std::vector<CollisionSphere>>(), DEFAULT_SIZE_X,
+                       DEFAULT_SIZE_Y, DEFAULT_SIZE_Z, Eigen::Vector3d(0, 0, 0), DEFAULT_USE_SIGNED_DISTANCE_FIELD,
+                       DEFAULT_RESOLUTION, DEFAULT_COLLISION_TOLERANCE, DEFAULT_MAX_PROPOGATION_DISTANCE, padding,
+                       scale)
+{
+  computeAllLinkSpheres();
+  prefilter_observer_handle_ =
+      getWorld()->addObserver([this](const World::ObjectConstPtr&, World::Action) { updateWorldRepresented(); });
+  updateWorldRepresented();
+}
+
+CollisionEnvSpherePrefilter::CollisionEnvSpherePrefilter(const CollisionEnvSpherePrefilter& other,
+                                                         const WorldPtr& world)
+  : CollisionEnvHybrid(other, world), link_spheres_(other.link_spheres_), safety_margin_(other.safety_margin_)
+{
+  prefilter_observer_handle_ =
+      getWorld()->addObserver([this](const World::ObjectConstPtr&, World::Action) { updateWorldRepresented(); });
+  updateWorldRepresented();
+}
+
+CollisionEnvSpherePrefilter::~CollisionEnvSpherePrefilter()
+{
+  getWorld()->removeObserver(prefilter_observer_handle_);
+}
+
+bool CollisionEnvSpherePrefilter::isBinaryRequest(const CollisionRequest& req)
+{
+  return !req.contacts && !req.distance && !req.cost && !req.verbose;
+}
+
+void CollisionEnvSpherePrefilter::computeLinkSpheres(const moveit::core::LinkModel* link)
+{
+  link_spheres_.erase(std::remove_if(link_spheres_.begin(), link_spheres_.end(),
+                                     [link](const LinkSphere& sphere) { return sphere.link == link; }),
+                      link_spheres_.end());
+
+  const double padding = getLinkPadding(link->getName());
+  const double scale = getLinkScale(link->getName());
+  std::vector<LinkSphere> spheres;
+  for (std::size_t i = 0; i < link->getShapes().size(); ++i)
+  {
+    LinkSphere sphere{ link, i, Eigen::Vector3d::Zero(), std::numeric_limits<double>::infinity() };
+
+    // pad and scale the shape the same way FCL does before wrapping it in a body
+    const std::unique_ptr<shapes::Shape> shape(link->getShapes()[i]->clone());
+    shape->scaleAndPadd(scale, padding);
+    const bodies::BodyPtr body(bodies::createEmptyBodyFromShapeType(shape->type));
+    if (body)
+    {
+      body->setDimensionsDirty(shape.get());
+      body->updateInternalData();
+      bodies::BoundingSphere bounding_sphere;
+      body->computeBoundingSphere(bounding_sphere);
+      sphere.center = bounding_sphere.center;
+      sphere.radius = bounding_sphere.radius;
+    }
+    else
+      RCLCPP_DEBUG(LOGGER, "Shape %zu of link '%s' has no bounding sphere; it always takes the exact check", i,
+                   link->getName().c_str());
+    spheres.push_back(sphere);
+  }
+
+  // keep the spheres ordered by link index, so that the spheres of one link are contiguous
+  auto pos = std::find_if(link_spheres_.begin(), link_spheres_.end(), [link](const LinkSphere& sphere) {
+    return sphere.link->getLinkIndex() > link->getLinkIndex();
+  });
+  link_spheres_.insert(pos, spheres.begin(), spheres.end());
+}
+
+void CollisionEnvSpherePrefilter::computeAllLinkSpheres()
+{
+  link_spheres_.clear();
+  for (const moveit::core::LinkModel* link : getRobotModel()->getLinkModelsWithCollisionGeometry())
+    computeLinkSpheres(link);
+}
+
+void CollisionEnvSpherePrefilter::updatedPaddingOrScaling(const std::vector<std::string>& links)
+{
+  CollisionEnvFCL::updatedPaddingOrScaling(links);
+  for (const std::string& link_name : links)
+  {
+    const moveit::core::LinkModel* link = getRobotModel()->getLinkModel(link_name);
+    if (link && !link->getShapes().empty())
+      computeLinkSpheres(link);
+  }
+}
+
+bool CollisionEnvSpherePrefilter::getPosedSpheres(const moveit::core::RobotState& state,
+                                                  EigenSTL::vector_Vector3d& centers) const
+{
+  std::vector<const moveit::core::AttachedBody*> attached_bodies;
+  state.getAttachedBodies(attached_bodies);
+  if (!attached_bodies.empty())
+    return false;
+
+  centers.resize(link_spheres_.size());
+  for (std::size_t i = 0; i < link_spheres_.size(); ++i)
+    centers[i] = state.getCollisionBodyTransform(link_spheres_[i].link, link_spheres_[i].shape_index) *
+                 link_spheres_[i].center;
+  return true;
+}
+
+bool CollisionEnvSpherePrefilter::isSelfClearlyFree(const moveit::core::RobotState& state,
+                                                    const AllowedCollisionMatrix* acm) const
+{
+  EigenSTL::vector_Vector3d centers;
+  if (!getPosedSpheres(state, centers))
+    return false;
+
+  const IndexedAllowedCollisionMatrixConstPtr indexed_acm =
+      acm ? acm->getIndexedLinkMatrix(*getRobotModel()) : IndexedAllowedCollisionMatrixConstPtr();
+  for (std::size_t i = 0; i < link_spheres_.size(); ++i)
+  {
+    const LinkSphere& a = link_spheres_[i];
+    for (std::size_t j = i + 1; j < link_spheres_.size(); ++j)
+    {
+      const LinkSphere& b = link_spheres_[j];
+      if (a.link == b.link)
+        continue;
+      AllowedCollision::Type type;
+      if (indexed_acm &&
+          indexed_acm->getAllowedCollision(a.link->getLinkIndex(), b.link->getLinkIndex(), type) &&
+          type == AllowedCollision::ALWAYS)
+        continue;
+      const double reach = a.radius + b.radius + safety_margin_;
+      if ((centers[i] - centers[j]).squaredNorm() <= reach * reach)
+        return false;
+    }
+  }
+  return true;
+}
+
+double CollisionEnvSpherePrefilter::getWorldDistanceSlack() const
+{
+  // The looked up distance is that of the cell center to the nearest sampled obstacle point. The query point may be
+  // half a cell diagonal away from the cell center, and the surface of an obstacle up to a cell diagonal away from
+  // its nearest sample.
+  return 1.5 * std::sqrt(3.0) * cenv_distance_->getWorldDistanceField()->getResolution() + safety_margin_;
+}
+
+bool CollisionEnvSpherePrefilter::isRobotClearlyFree(const moveit::core::RobotState& state) const
+{
+  if (!world_represented_)
+    return false;
+
+  EigenSTL::vector_Vector3d centers;
+  if (!getPosedSpheres(state, centers))
+    return false;
+  if (getWorld()->size() == 0)
+    return true;
+
+  const distance_field::DistanceFieldConstPtr field = cenv_distance_->getWorldDistanceField();
+  const Eigen::Vector3d field_min(field->getOriginX(), field->getOriginY(), field->getOriginZ());
+  const Eigen::Vector3d field_max = field_min + Eigen::Vector3d(field->getSizeX(), field->getSizeY(),
+                                                                field->getSizeZ());
+
+  const double slack = getWorldDistanceSlack();
+  for (std::size_t i = 0; i < link_spheres_.size(); ++i)
+  {
+    const double reach = link_spheres_[i].radius + slack;
+    // obstacles outside of the field are not represented, so the whole sphere needs to be inside of it
+    if (((centers[i].array() - reach) < field_min.array()).any() ||
+        ((centers[i].array() + reach) > field_max.array()).any())
+      return false;
+    if (field->getDistance(centers[i].x(), centers[i].y(), centers[i].z()) <= reach)
+      return false;
+  }
+  return true;
+}
+
+void CollisionEnvSpherePrefilter::updateWorldRepresented()
+{
+  const double resolution = cenv_distance_->getWorldDistanceField()->getResolution();
+  for (const std::pair<const std::string, World::ObjectPtr>& object : *getWorld())
+  {
+    for (const shapes::ShapeConstPtr& shape : object.second->shapes_)
+    {
+      if (shape->type == shapes::OCTREE || shape->type == shapes::PLANE ||
+          getBodyDecompositionCacheEntry(shape, resolution)->getCollisionPoints().empty())
+      {
+        RCLCPP_DEBUG(LOGGER, "Object '%s' is not represented in the distance field, disabling the world fast path",
+                     object.first.c_str());
+        world_represented_ = false;
+        return;
+      }
+    }
+  }
+  world_represented_ = true;
+}
+
+void CollisionEnvSpherePrefilter::setWorld(const WorldPtr& world)
+{
+  if (world == getWorld())
+    return;
+
+  getWorld()->removeObserver(prefilter_observer_handle_);
+  CollisionEnvHybrid::setWorld(world);
+  prefilter_observer_handle_ =
+      getWorld()->addObserver([this](const World::ObjectConstPtr&, World::Action) { updateWorldRepresented(); });
+  updateWorldRepresented();
+}
+
+void CollisionEnvSpherePrefilter::checkSelfCollision(const CollisionRequest& req, CollisionResult& res,
+                                                     const moveit::core::RobotState& state) const
+{
+  if (isBinaryRequest(req) && isSelfClearlyFree(state, nullptr))
+  {
+    ++fast_path_count_;
+    return;
+  }
+  ++exact_check_count_;
+  CollisionEnvFCL::checkSelfCollision(req, res, state);
+}
+
+void CollisionEnvSpherePrefilter::checkSelfCollision(const CollisionRequest& req, CollisionResult& res,
+                                                     const moveit::core::RobotState& state,
+                                                     const AllowedCollisionMatrix& acm) const
+{
+  if (isBinaryRequest(req) && isSelfClearlyFree(state, &acm))
+  {
+    ++fast_path_count_;
+    return;
+  }
+  ++exact_check_count_;
+  CollisionEnvFCL::checkSelfCollision(req, res, state, acm);
+}
+
+void CollisionEnvSpherePrefilter::checkRobotCollision(const CollisionRequest& req, CollisionResult& res,
+                                                      const moveit::core::RobotState& state) const
+{
+  if (isBinaryRequest(req) && isRobotClearlyFree(state))
+  {
+    ++fast_path_count_;
+    return;
+  }
+  ++exact_check_count_;
+  CollisionEnvFCL::checkRobotCollision(req, res, state);
+}
+
+void CollisionEnvSpherePrefilter::checkRobotCollision(const CollisionRequest& req, CollisionResult& res,
+                                                      const moveit::core::RobotState& state,
+                                                      const AllowedCollisionMatrix& acm) const
+{
+  if (isBinaryRequest(req) && isRobotClearlyFree(state))
+  {
+    ++fast_path_count_;
+    return;
+  }
+  ++exact_check_count_;
+  CollisionEnvFCL::checkRobotCollision(req, res, state, acm);
+}
+}  // namespace collision_detection
@@ -0,0 +1,293 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Google Benchmark cases for the collision checking backends of moveit_core.
+
+   Run with --benchmark_out=<file>.json --benchmark_out_format=json to record results that can be compared between
+   releases. Every case is parameterized by robot (0: Panda, 1: PR2) and, where applicable, by backend and by the
+   number of random boxes in the scene. */
+
+#include <benchmark/benchmark.h>
+
+#include <moveit/collision_detection_bullet/collision_env_bullet.h>
+#include <moveit/collision_detection_fcl/collision_env_fcl.h>
+#include <moveit/collision_distance_field/collision_env_distance_field.h>
+#include <moveit/collision_distance_field/collision_env_hybrid.h>
+#include <moveit/robot_model/robot_model.h>
+#include <moveit/robot_state/robot_state.h>
+#include <moveit/utils/robot_model_test_utils.h>
+
+#include <geometric_shapes/shapes.h>
+#include <octomap/OcTree.h>
+#include <random_numbers/random_numbers.h>
+
+namespace
+{
+enum Backend
+{
+  FCL,
+  BULLET,
+  DISTANCE_FIELD,
+  HYBRID
+};
+
+const char* const BACKEND_NAMES[] = { "FCL", "Bullet", "DistanceField", "Hybrid" };
+const char* const ROBOT_NAMES[] = { "panda", "pr2" };
+const char* const GROUP_NAMES[] = { "panda_arm", "whole_body" };
+
+constexpr std::size_t STATE_COUNT = 100;
+constexpr unsigned int SEED = 42;
+
+/** \brief A robot with a fixed set of random states and its allowed collision matrix */
+struct RobotSetup
+{
+  moveit::core::RobotModelPtr robot_model;
+  collision_detection::AllowedCollisionMatrix acm;
+  std::string group_name;
+  std::vector<moveit::core::RobotState> states;
+};
+
+const RobotSetup& getRobotSetup(int robot)
+{
+  static std::map<int, RobotSetup> setups;
+  auto it = setups.find(robot);
+  if (it != setups.end())
+    return it->second;
+
+  RobotSetup& setup = setups[robot];
+  setup.robot_model = moveit::core::loadTestingRobotModel(ROBOT_NAMES[robot]);
+  setup.acm = collision_detection::AllowedCollisionMatrix(*setup.robot_model->getSRDF());
+  setup.group_name = GROUP_NAMES[robot];
+
+  const moveit::core::JointModelGroup* group = setup.robot_model->getJointModelGroup(setup.group_name);
+  random_numbers::RandomNumberGenerator rng(SEED);
+  moveit::core::RobotState state(setup.robot_model);
+  state.setToDefaultValues();
+  for (std::size_t i = 0; i < STATE_COUNT; ++i)
+  {
+    state.setToRandomPositions(group, rng);
+    state.update();
+    setup.states.push_back(state);
+  }
+  return setup;
+}
+
+/** \brief Fill \e world with \e count random boxes of 5 cm around the robot */
+void addRandomBoxes(const collision_detection::WorldPtr& world, std::size_t count)
+{
+  random_numbers::RandomNumberGenerator rng(SEED);
+  const shapes::ShapeConstPtr box = std::make_shared<const shapes::Box>(0.05, 0.05, 0.05);
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    Eigen::Isometry3d pose = Eigen::Isometry3d::Identity();
+    pose.translation() =
+        Eigen::Vector3d(rng.uniformReal(-1.2, 1.2), rng.uniformReal(-1.2, 1.2), rng.uniformReal(0.0, 1.8));
+    world->addToObject("box_" + std::to_string(i), pose, box, Eigen::Isometry3d::Identity());
+  }
+}
+
+/** \brief Add an octomap holding a 2 cm voxel wall in front of the robot */
+void addOctomap(const collision_detection::WorldPtr& world)
+{
+  auto tree = std::make_shared<octomap::OcTree>(0.02);
+  for (double y = -0.6; y <= 0.6; y += 0.02)
+  {
+    for (double z = 0.0; z <= 1.4; z += 0.02)
+      tree->updateNode(octomap::point3d(0.7, y, z), true);
+  }
+  world->addToObject("octomap", Eigen::Isometry3d::Identity(), std::make_shared<const shapes::OcTree>(tree),
+                     Eigen::Isometry3d::Identity());
+}
+
+collision_detection::CollisionEnvPtr createEnv(int backend, const moveit::core::RobotModelPtr& robot_model,
+                                               const collision_detection::WorldPtr& world)
+{
+  switch (backend)
+  {
+    case FCL:
+      return std::make_shared<collision_detection::CollisionEnvFCL>(robot_model, world);
+    case BULLET:
+      return std::make_shared<collision_detection::CollisionEnvBullet>(robot_model, world);
+    case DISTANCE_FIELD:
+      return std::make_shared<collision_detection::CollisionEnvDistanceField>(robot_model, world);
+    default:
+      return std::make_shared<collision_detection::CollisionEnvHybrid>(robot_model, world);
+  }
+}
+
+void setLabel(benchmark::State& st, int robot, int backend)
+{
+  st.SetLabel(std::string(ROBOT_NAMES[robot]) + "/" + BACKEND_NAMES[backend]);
+}
+
+void runSelfCollision(benchmark::State& st, int robot, int backend)
+{
+  const RobotSetup& setup = getRobotSetup(robot);
+  collision_detection::CollisionEnvPtr env =
+      createEnv(backend, setup.robot_model, std::make_shared<collision_detection::World>());
+  auto hybrid = std::dynamic_pointer_cast<collision_detection::CollisionEnvHybrid>(env);
+
+  collision_detection::CollisionRequest req;
+  req.group_name = setup.group_name;
+  std::size_t i = 0;
+  for (auto _ : st)
+  {
+    collision_detection::CollisionResult res;
+    const moveit::core::RobotState& state = setup.states[i++ % setup.states.size()];
+    if (hybrid)
+      hybrid->checkSelfCollisionDistanceField(req, res, state, setup.acm);
+    else
+      env->checkSelfCollision(req, res, state, setup.acm);
+    benchmark::DoNotOptimize(res.collision);
+  }
+  setLabel(st, robot, backend);
+}
+
+void runWorldCollision(benchmark::State& st, int robot, int backend, const collision_detection::WorldPtr& world)
+{
+  const RobotSetup& setup = getRobotSetup(robot);
+  collision_detection::CollisionEnvPtr env = createEnv(backend, setup.robot_model, world);
+  auto hybrid = std::dynamic_pointer_cast<collision_detection::CollisionEnvHybrid>(env);
+
+  collision_detection::CollisionRequest req;
+  req.group_name = setup.group_name;
+  std::size_t i = 0;
+  for (auto _ : st)
+  {
+    collision_detection::CollisionResult res;
+    const moveit::core::RobotState& state = setup.states[i++ % setup.states.size()];
+    if (hybrid)
+      hybrid->checkRobotCollisionDistanceField(req, res, state, setup.acm);
+    else
+      env->checkRobotCollision(req, res, state, setup.acm);
+    benchmark::DoNotOptimize(res.collision);
+  }
+  setLabel(st, robot, backend);
+}
+}  // namespace
+
+/** \brief Self-collision checks of random states; args: robot, backend */
+static void selfCollision(benchmark::State& st)
+{
+  runSelfCollision(st, st.range(0), st.range(1));
+}
+
+/** \brief Robot-world checks of random states against random boxes; args: robot, backend, box count */
+static void worldCollision(benchmark::State& st)
+{
+  auto world = std::make_shared<collision_detection::World>();
+  addRandomBoxes(world, st.range(2));
+  runWorldCollision(st, st.range(0), st.range(1), world);
+}
+
+/** \brief Robot-world checks of random states against an octomap; args: robot, backend */
+static void octomapCollision(benchmark::State& st)
+{
+  auto world = std::make_shared<collision_detection::World>();
+  addOctomap(world);
+  runWorldCollision(st, st.range(0), st.range(1), world);
+}
+
+/** \brief FCL robot-world distance queries against random boxes; args: robot, box count */
+static void worldDistance(benchmark::State& st)
+{
+  const RobotSetup& setup = getRobotSetup(st.range(0));
+  auto world = std::make_shared<collision_detection::World>();
+  addRandomBoxes(world, st.range(1));
+  collision_detection::CollisionEnvFCL env(setup.robot_model, world);
+
+  collision_detection::DistanceRequest req;
+  req.group_name = setup.group_name;
+  req.enableGroup(setup.robot_model);
+  req.acm = &setup.acm;
+  std::size_t i = 0;
+  for (auto _ : st)
+  {
+    collision_detection::DistanceResult res;
+    env.distanceRobot(req, res, setup.states[i++ % setup.states.size()]);
+    benchmark::DoNotOptimize(res.minimum_distance.distance);
+  }
+  setLabel(st, st.range(0), FCL);
+}
+
+/** \brief FCL self distance queries; args: robot */
+static void selfDistance(benchmark::State& st)
+{
+  const RobotSetup& setup = getRobotSetup(st.range(0));
+  collision_detection::CollisionEnvFCL env(setup.robot_model);
+
+  collision_detection::DistanceRequest req;
+  req.group_name = setup.group_name;
+  req.enableGroup(setup.robot_model);
+  req.acm = &setup.acm;
+  std::size_t i = 0;
+  for (auto _ : st)
+  {
+    collision_detection::DistanceResult res;
+    env.distanceSelf(req, res, setup.states[i++ % setup.states.size()]);
+    benchmark::DoNotOptimize(res.minimum_distance.distance);
+  }
+  setLabel(st, st.range(0), FCL);
+}
+
+/** \brief Continuous robot-world checks between consecutive random states; args: robot, backend, box count */
+static void continuousCollision(benchmark::State& st)
+{
+  const RobotSetup& setup = getRobotSetup(st.range(0));
+  auto world = std::make_shared<collision_detection::World>();
+  addRandomBoxes(world, st.range(2));
+  collision_detection::CollisionEnvPtr env = createEnv(st.range(1), setup.robot_model, world);
+
+  collision_detection::CollisionRequest req;
+  req.group_name = setup.group_name;
+  std::size_t i = 0;
+  for (auto _ : st)
+  {
+    collision_detection::CollisionResult res;
+    const moveit::core::RobotState& state1 = setup.states[i % setup.states.size()];
+    const moveit::core::RobotState& state2 = setup.states[++i % setup.states.size()];
+    env->checkRobotCollision(req, res, state1, state2, setup.acm);
+    benchmark::DoNotOptimize(res.collision);
+  }
+  setLabel(st, st.range(0), st.range(1));
+}
+
+BENCHMARK(selfCollision)->ArgsProduct({ { 0, 1 }, { FCL, BULLET, DISTANCE_FIELD, HYBRID } });
+BENCHMARK(worldCollision)->ArgsProduct({ { 0, 1 }, { FCL, BULLET, DISTANCE_FIELD, HYBRID }, { 10, 100, 1000 } });
+BENCHMARK(octomapCollision)->ArgsProduct({ { 0, 1 }, { FCL, BULLET, DISTANCE_FIELD, HYBRID } });
+BENCHMARK(worldDistance)->ArgsProduct({ { 0, 1 }, { 10, 100, 1000 } });
+BENCHMARK(selfDistance)->DenseRange(0, 1);
+BENCHMARK(continuousCollision)->ArgsProduct({ { 0, 1 }, { FCL, BULLET }, { 10, 100, 1000 } });
+
+BENCHMARK_MAIN();
@@ -330,6 +330,42 @@ TEST_F(DistanceFieldCollisionDetectionTester, AttachedBodyTester)
   ASSERT_TRUE(res.collision);
 }
 
+TEST_F(DistanceFieldCollisionDetectionTester, WorldDistanceFieldReuse)
+{
+  auto world = std::make_shared<collision_detection::World>();
+  Eigen::Isometry3d pose = Eigen::Isometry3d::Identity();
+  pose.translation() = Eigen::Vector3d(0.5, 0.0, 0.5);
+  world->addToObject("box", std::make_shared<const shapes::Box>(.2, .2, .2), pose);
+
+  std::map<std::string, std::vector<collision_detection::CollisionSphere>> link_body_decompositions;
+  DefaultCEnvType cenv(robot_model_, world, link_body_decompositions);
+
+  // an equal world shares the field
+  auto copy = std::make_shared<collision_detection::World>(*world);
+  DefaultCEnvType copy_cenv(robot_model_, copy, link_body_decompositions);
+  EXPECT_EQ(cenv.getWorldDistanceField(), copy_cenv.getWorldDistanceField());
+
+  // changes are applied to a copy of the shared field
+  Eigen::Isometry3d moved = pose;
+  moved.translation().y() = 0.8;
+  copy->setObjectPose("box", moved);
+  EXPECT_NE(cenv.getWorldDistanceField(), copy_cenv.getWorldDistanceField());
+  EXPECT_EQ(cenv.getWorldDistanceField()->getDistance(0.5, 0.0, 0.5), 0.0);
+  EXPECT_GT(cenv.getWorldDistanceField()->getDistance(0.5, 0.8, 0.5), 0.0);
+  EXPECT_GT(copy_cenv.getWorldDistanceField()->getDistance(0.5, 0.0, 0.5), 0.0);
+  EXPECT_EQ(copy_cenv.getWorldDistanceField()->getDistance(0.5, 0.8, 0.5), 0.0);
+
+  // a field for the moved world is derived from the cached field of the original world
+  auto moved_copy = std::make_shared<collision_detection::World>(*copy);
+  DefaultCEnvType moved_cenv(robot_model_, moved_copy, link_body_decompositions);
+  for (double y = -0.4; y <= 1.2; y += 0.1)
+  {
+    EXPECT_EQ(moved_cenv.getWorldDistanceField()->getDistance(0.5, y, 0.5),
+              copy_cenv.getWorldDistanceField()->getDistance(0.5, y, 0.5))
+        << y;
+  }
+}
+
 int main(int argc, char** argv)
 {
   testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,149 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <gtest/gtest.h>
+
+#include <moveit/collision_detection_fcl/collision_env_fcl.h>
+#include <moveit/collision_distance_field/collision_env_sphere_batch.h>
+#include <moveit/robot_model/robot_model.h>
+#include <moveit/robot_state/robot_state.h>
+#include <moveit/utils/robot_model_test_utils.h>
+
+#include <geometric_shapes/shapes.h>
+
+class SphereBatchTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    robot_model_ = moveit::core::loadTestingRobotModel("panda");
+    ASSERT_TRUE(static_cast<bool>(robot_model_));
+    acm_ = std::make_shared<collision_detection::AllowedCollisionMatrix>(*robot_model_->getSRDF());
+    world_ = std::make_shared<collision_detection::World>();
+    batch_env_ = std::make_shared<collision_detection::CollisionEnvSphereBatch>(robot_model_, world_);
+    fcl_env_ = std::make_shared<collision_detection::CollisionEnvFCL>(robot_model_, world_);
+  }
+
+  void addBox(const std::string& id, const Eigen::Vector3d& position, double size)
+  {
+    Eigen::Isometry3d pose = Eigen::Isometry3d::Identity();
+    pose.translation() = position;
+    world_->addToObject(id, pose, std::make_shared<const shapes::Box>(size, size, size), Eigen::Isometry3d::Identity());
+  }
+
+  std::vector<const moveit::core::RobotState*> makeRandomStates(std::size_t count)
+  {
+    states_.clear();
+    std::vector<const moveit::core::RobotState*> states;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      states_.push_back(std::make_shared<moveit::core::RobotState>(robot_model_));
+      states_.back()->setToRandomPositions();
+      states_.back()->update();
+      states.push_back(states_.back().get());
+    }
+    return states;
+  }
+
+  moveit::core::RobotModelPtr robot_model_;
+  collision_detection::AllowedCollisionMatrixPtr acm_;
+  collision_detection::WorldPtr world_;
+  collision_detection::CollisionEnvSphereBatchPtr batch_env_;
+  collision_detection::CollisionEnvPtr fcl_env_;
+  std::vector<moveit::core::RobotStatePtr> states_;
+};
+
+TEST_F(SphereBatchTest, SpheresCoverEveryShape)
+{
+  std::size_t shape_count = 0;
+  for (const moveit::core::LinkModel* link : robot_model_->getLinkModelsWithCollisionGeometry())
+    shape_count += link->getShapes().size();
+  EXPECT_GE(batch_env_->getSphereCount(), shape_count);
+}
+
+TEST_F(SphereBatchTest, AgreesWithFCL)
+{
+  addBox("box1", Eigen::Vector3d(0.5, 0.0, 0.4), 0.15);
+  addBox("box2", Eigen::Vector3d(-0.3, 0.4, 0.7), 0.2);
+
+  const std::vector<const moveit::core::RobotState*> states = makeRandomStates(500);
+  collision_detection::CollisionRequest req;
+  std::vector<collision_detection::CollisionResult> res;
+  batch_env_->checkCollisionBatch(req, res, states, *acm_);
+  ASSERT_EQ(res.size(), states.size());
+
+  for (std::size_t i = 0; i < states.size(); ++i)
+  {
+    collision_detection::CollisionResult expected;
+    fcl_env_->checkCollision(req, expected, *states[i], *acm_);
+    EXPECT_EQ(expected.collision, res[i].collision) << "state " << i;
+  }
+  EXPECT_GT(batch_env_->getFastPathCount(), 0u);
+}
+
+TEST_F(SphereBatchTest, DetailedRequestsFallBackToFCL)
+{
+  const std::vector<const moveit::core::RobotState*> states = makeRandomStates(10);
+  collision_detection::CollisionRequest req;
+  req.contacts = true;
+  std::vector<collision_detection::CollisionResult> res;
+  batch_env_->checkCollisionBatch(req, res, states, *acm_);
+  EXPECT_EQ(res.size(), states.size());
+  EXPECT_EQ(batch_env_->getFastPathCount(), 0u);
+}
+
+TEST_F(SphereBatchTest, UnrepresentedObjectsTakeExactWorldCheck)
+{
+  world_->addToObject("floor", Eigen::Isometry3d::Identity(), std::make_shared<const shapes::Plane>(0, 0, 1, -1.5),
+                      Eigen::Isometry3d::Identity());
+
+  const std::vector<const moveit::core::RobotState*> states = makeRandomStates(20);
+  collision_detection::CollisionRequest req;
+  std::vector<collision_detection::CollisionResult> res;
+  batch_env_->checkCollisionBatch(req, res, states, *acm_);
+
+  // only self checks can be answered from the spheres, and every state not in self collision is checked exactly
+  // against the world
+  std::size_t self_free = 0;
+  for (const collision_detection::CollisionResult& result : res)
+    self_free += result.collision ? 0 : 1;
+  EXPECT_GE(batch_env_->getExactCheckCount(), self_free);
+  EXPECT_LE(batch_env_->getFastPathCount(), states.size());
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
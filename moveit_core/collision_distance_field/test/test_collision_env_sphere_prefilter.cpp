@@ -0,0 +1,158 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <gtest/gtest.h>
+
+#include <moveit/collision_detection_fcl/collision_env_fcl.h>
+#include <moveit/collision_distance_field/collision_env_sphere_prefilter.h>
+#include <moveit/robot_model/robot_model.h>
+#include <moveit/robot_state/robot_state.h>
+#include <moveit/utils/robot_model_test_utils.h>
+
+#include <geometric_shapes/shapes.h>
+
+class SpherePrefilterTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    robot_model_ = moveit::core::loadTestingRobotModel("panda");
+    ASSERT_TRUE(static_cast<bool>(robot_model_));
+    acm_ = std::make_shared<collision_detection::AllowedCollisionMatrix>(*robot_model_->getSRDF());
+    world_ = std::make_shared<collision_detection::World>();
+    prefilter_env_ = std::make_shared<collision_detection::CollisionEnvSpherePrefilter>(robot_model_, world_);
+    fcl_env_ = std::make_shared<collision_detection::CollisionEnvFCL>(robot_model_, world_);
+    state_ = std::make_shared<moveit::core::RobotState>(robot_model_);
+    state_->setToDefaultValues();
+    state_->setVariablePosition("panda_joint2", -0.785);
+    state_->setVariablePosition("panda_joint4", -2.356);
+    state_->setVariablePosition("panda_joint6", 1.571);
+    state_->setVariablePosition("panda_joint7", 0.785);
+    state_->update();
+  }
+
+  void addBox(const std::string& id, const Eigen::Vector3d& position, double size)
+  {
+    Eigen::Isometry3d pose = Eigen::Isometry3d::Identity();
+    pose.translation() = position;
+    world_->addToObject(id, pose, std::make_shared<const shapes::Box>(size, size, size), Eigen::Isometry3d::Identity());
+  }
+
+  moveit::core::RobotModelPtr robot_model_;
+  collision_detection::AllowedCollisionMatrixPtr acm_;
+  collision_detection::WorldPtr world_;
+  collision_detection::CollisionEnvSpherePrefilterPtr prefilter_env_;
+  collision_detection::CollisionEnvPtr fcl_env_;
+  moveit::core::RobotStatePtr state_;
+};
+
+TEST_F(SpherePrefilterTest, ClearlyFreeSkipsExactCheck)
+{
+  addBox("far_box", Eigen::Vector3d(0.0, 1.2, 1.0), 0.1);
+
+  collision_detection::CollisionRequest req;
+  collision_detection::CollisionResult res;
+  prefilter_env_->checkRobotCollision(req, res, *state_, *acm_);
+  EXPECT_FALSE(res.collision);
+  EXPECT_EQ(prefilter_env_->getExactCheckCount(), 0u);
+  EXPECT_EQ(prefilter_env_->getFastPathCount(), 1u);
+}
+
+TEST_F(SpherePrefilterTest, NearContactFallsBackToFCL)
+{
+  const Eigen::Vector3d hand = state_->getGlobalLinkTransform("panda_hand").translation();
+  addBox("touching_box", hand, 0.05);
+
+  collision_detection::CollisionRequest req;
+  collision_detection::CollisionResult res;
+  prefilter_env_->checkRobotCollision(req, res, *state_, *acm_);
+  EXPECT_TRUE(res.collision);
+  EXPECT_EQ(prefilter_env_->getExactCheckCount(), 1u);
+}
+
+TEST_F(SpherePrefilterTest, DetailedRequestsFallBackToFCL)
+{
+  collision_detection::CollisionRequest req;
+  req.contacts = true;
+  collision_detection::CollisionResult res;
+  prefilter_env_->checkSelfCollision(req, res, *state_, *acm_);
+  EXPECT_EQ(prefilter_env_->getFastPathCount(), 0u);
+  EXPECT_EQ(prefilter_env_->getExactCheckCount(), 1u);
+}
+
+TEST_F(SpherePrefilterTest, UnrepresentedObjectsDisableWorldFastPath)
+{
+  world_->addToObject("floor", Eigen::Isometry3d::Identity(), std::make_shared<const shapes::Plane>(0, 0, 1, -1.5),
+                      Eigen::Isometry3d::Identity());
+
+  collision_detection::CollisionRequest req;
+  collision_detection::CollisionResult res;
+  prefilter_env_->checkRobotCollision(req, res, *state_, *acm_);
+  EXPECT_EQ(prefilter_env_->getFastPathCount(), 0u);
+
+  world_->removeObject("floor");
+  prefilter_env_->checkRobotCollision(req, res, *state_, *acm_);
+  EXPECT_EQ(prefilter_env_->getFastPathCount(), 1u);
+}
+
+TEST_F(SpherePrefilterTest, AgreesWithFCL)
+{
+  addBox("box1", Eigen::Vector3d(0.5, 0.0, 0.4), 0.15);
+  addBox("box2", Eigen::Vector3d(-0.3, 0.4, 0.7), 0.2);
+
+  collision_detection::CollisionRequest req;
+  for (unsigned int i = 0; i < 500; ++i)
+  {
+    state_->setToRandomPositions();
+    state_->update();
+
+    collision_detection::CollisionResult expected, actual;
+    fcl_env_->checkSelfCollision(req, expected, *state_, *acm_);
+    prefilter_env_->checkSelfCollision(req, actual, *state_, *acm_);
+    EXPECT_EQ(expected.collision, actual.collision);
+
+    expected.clear();
+    actual.clear();
+    fcl_env_->checkRobotCollision(req, expected, *state_, *acm_);
+    prefilter_env_->checkRobotCollision(req, actual, *state_, *acm_);
+    EXPECT_EQ(expected.collision, actual.collision);
+  }
+  EXPECT_EQ(prefilter_env_->getFastPathCount() + prefilter_env_->getExactCheckCount(), 1000u);
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
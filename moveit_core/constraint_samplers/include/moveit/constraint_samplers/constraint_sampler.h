@@ -244,6 +244,23 @@ public:
    */
   virtual bool project(moveit::core::RobotState& state, unsigned int max_attempts) = 0;
 
+  /**
+   * \brief Draw up to \e count samples, appending each successful one to \e states.
+   *
+   * Every sample starts as a copy of \e reference_state, whose link transforms are computed once for the whole batch,
+   * and is then used as its own reference. Sampling many goals this way does not repeat the forward kinematics of the
+   * reference state for each of them.
+   *
+   * @param [in] reference_state Reference state that will be used to do transforms or perform other actions
+   * @param [in] count The number of samples to draw
+   * @param [out] states The vector the successful samples are appended to
+   * @param [in] max_attempts The maximum number of attempts for each sample
+   *
+   * @return The number of samples appended to \e states
+   */
+  virtual std::size_t sampleBatch(const moveit::core::RobotState& reference_state, std::size_t count,
+                                  std::vector<moveit::core::RobotState>& states, unsigned int max_attempts);
+
   /**
    * \brief Returns whether or not the constraint sampler is valid or not.
    * To be valid, the joint model group must be available in the kinematic model and configure() must have successfully
@@ -37,7 +37,11 @@
 #pragma once
 
 #include <moveit/constraint_samplers/constraint_sampler_allocator.h>
+#include <moveit/constraint_samplers/reservoir_constraint_sampler.h>
 #include <moveit/macros/class_forward.h>
+#include <list>
+#include <mutex>
+#include <unordered_map>
 #include "rclcpp/rclcpp.hpp"
 #include "rclcpp/clock.hpp"
 #include "rclcpp/duration.hpp"
@@ -75,6 +79,21 @@ public:
   {
     sampler_alloc_.push_back(sa);
   }
+
+  /**
+   * \brief Keep valid samples across calls to selectSampler()
+   *
+   * Once enabled, samplers returned by selectSampler() that do not depend on
+   * mobile frames are wrapped in a ReservoirConstraintSampler. All samplers
+   * for the same group, constraints (ignoring names and time stamps) and
+   * scene version share one SampleReservoir, so repeated goals are served
+   * from earlier valid samples before new ones are drawn.
+   *
+   * @param reservoir_size The number of samples kept per reservoir, 0 disables the reservoirs
+   * @param max_reservoirs The number of reservoirs kept, the least recently used one is dropped first
+   */
+  void enableSampleReservoirs(std::size_t reservoir_size, std::size_t max_reservoirs);
+
   /**
    * \brief Selects among the potential sampler allocators.
    *
@@ -142,7 +161,20 @@ public:
                                                    const moveit_msgs::msg::Constraints& constr);
 
 private:
+  /** \brief The reservoir shared by samplers for \e constr, created if needed */
+  SampleReservoirPtr getSampleReservoir(const planning_scene::PlanningSceneConstPtr& scene,
+                                        const std::string& group_name,
+                                        const moveit_msgs::msg::Constraints& constr) const;
+
   std::vector<ConstraintSamplerAllocatorPtr>
       sampler_alloc_; /**< \brief Holds the constraint sampler allocators, which will be tested in order  */
+
+  std::size_t reservoir_size_ = 0;
+  std::size_t max_reservoirs_ = 0;
+  mutable std::mutex reservoirs_mutex_;
+  /** \brief Reservoirs with their keys, most recently used first */
+  mutable std::list<std::pair<std::string, SampleReservoirPtr>> reservoirs_;
+  mutable std::unordered_map<std::string, std::list<std::pair<std::string, SampleReservoirPtr>>::iterator>
+      reservoir_index_;
 };
 }  // namespace constraint_samplers
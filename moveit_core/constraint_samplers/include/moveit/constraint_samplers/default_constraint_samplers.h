@@ -37,7 +37,9 @@
 #pragma once
 
 #include <moveit/constraint_samplers/constraint_sampler.h>
+#include <moveit/kinematics_metrics/reachability_map.h>
 #include <moveit/macros/class_forward.h>
+#include <moveit/utils/random_seed.h>
 #include <random_numbers/random_numbers.h>
 #include "rclcpp/rclcpp.hpp"
 #include <string>
@@ -70,7 +72,7 @@ public:
    *
    */
   JointConstraintSampler(const planning_scene::PlanningSceneConstPtr& scene, const std::string& group_name)
-    : ConstraintSampler(scene, group_name), random_number_generator_(random_numbers::RandomNumberGenerator())
+    : ConstraintSampler(scene, group_name), random_number_generator_(moveit::core::makeRandomNumberGenerator())
   {
   }
 
@@ -325,7 +327,7 @@ public:
    *
    */
   IKConstraintSampler(const planning_scene::PlanningSceneConstPtr& scene, const std::string& group_name)
-    : ConstraintSampler(scene, group_name), random_number_generator_(random_numbers::RandomNumberGenerator())
+    : ConstraintSampler(scene, group_name), random_number_generator_(moveit::core::makeRandomNumberGenerator())
   {
   }
 
@@ -420,6 +422,26 @@ public:
     ik_timeout_ = timeout;
   }
 
+  /**
+   * \brief Use \e solver instead of the solver instance of the group, which is shared by all samplers of the group
+   *
+   * Kinematics solvers are generally not thread-safe, so samplers used concurrently need their own instances, which
+   * have to be configured like the one of the group.
+   *
+   * @return True if the solver can be used for the sampling pose of this sampler
+   */
+  bool setKinematicsSolver(const kinematics::KinematicsBaseConstPtr& solver);
+
+  /**
+   * \brief Reject sampled poses that lie outside of \e map before calling IK on them
+   *
+   * The map has to be built for the base and tip frames of the IK solver. As it is cleared when the sampler is
+   * configured, it has to be set afterwards. Pass nullptr to stop using a map.
+   *
+   * @return True if the map matches the frames of the IK solver of this sampler
+   */
+  bool setReachabilityMap(const kinematics_metrics::ReachabilityMapConstPtr& map);
+
   /**
    * \brief Gets the position constraint associated with this sampler.
    *
@@ -563,5 +585,6 @@ protected:
   bool need_eef_to_ik_tip_transform_; /**< \brief True if the tip frame of the inverse kinematic is different than the
                                         frame of the end effector */
   Eigen::Isometry3d eef_to_ik_tip_transform_; /**< \brief Holds the transformation from end effector to IK tip frame */
+  kinematics_metrics::ReachabilityMapConstPtr reachability_map_; /**< \brief Poses outside of it are not passed to IK */
 };
 }  // namespace constraint_samplers
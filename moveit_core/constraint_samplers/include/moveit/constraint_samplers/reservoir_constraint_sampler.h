@@ -0,0 +1,160 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#pragma once
+
+#include <moveit/constraint_samplers/constraint_sampler.h>
+#include <deque>
+#include <mutex>
+
+namespace constraint_samplers
+{
+MOVEIT_CLASS_FORWARD(SampleReservoir);  // Defines SampleReservoirPtr, ConstPtr, WeakPtr... etc
+
+/**
+ * \brief Recently drawn valid samples of one set of constraints.
+ *
+ * A reservoir is shared by all ReservoirConstraintSampler instances for the
+ * same constraints, group and scene, so samples drawn for one planning
+ * request (or by one of several concurrent samplers) are available to all
+ * others. It stores the positions of the joint model group only. Once full,
+ * the oldest sample is dropped for every new one.
+ */
+class SampleReservoir
+{
+public:
+  /**
+   * \brief Constructor
+   *
+   * @param [in] capacity The maximum number of samples kept
+   */
+  SampleReservoir(std::size_t capacity) : capacity_(std::max<std::size_t>(capacity, 1))
+  {
+  }
+
+  /** \brief Store the positions of \e jmg in \e state as a new sample */
+  void addSample(const moveit::core::RobotState& state, const moveit::core::JointModelGroup* jmg);
+
+  /**
+   * \brief Get a stored sample
+   *
+   * @param [in] index Index of the sample, counting from the oldest one
+   * @param [out] values The group positions of the sample
+   *
+   * @return False if there is no sample with this index
+   */
+  bool getSample(std::size_t index, std::vector<double>& values) const;
+
+  /** \brief The number of stored samples */
+  std::size_t size() const;
+
+private:
+  const std::size_t capacity_;
+  mutable std::mutex mutex_;
+  std::deque<std::vector<double>> samples_;
+};
+
+/**
+ * \brief A sampler that serves samples from a SampleReservoir before
+ * drawing new ones from the sampler it wraps.
+ *
+ * Every sample served from the reservoir is checked with the group state
+ * validity callback, if any; rejected samples are skipped. When the
+ * reservoir is exhausted, the wrapped sampler draws a new sample, which is
+ * added to the reservoir. Samples do not depend on the reference state, so
+ * only samplers without frame dependencies should be wrapped.
+ */
+class ReservoirConstraintSampler : public ConstraintSampler
+{
+public:
+  /**
+   * \brief Constructor
+   *
+   * @param [in] scene The planning scene
+   * @param [in] group_name The group name is ignored, as the wrapped sampler already has a group name
+   * @param [in] sampler The configured sampler that draws new samples
+   * @param [in] reservoir The reservoir of the constraints \e sampler is configured for
+   */
+  ReservoirConstraintSampler(const planning_scene::PlanningSceneConstPtr& scene, const std::string& group_name,
+                             ConstraintSamplerPtr sampler, SampleReservoirPtr reservoir);
+
+  /** \brief Gets the wrapped sampler */
+  const ConstraintSamplerPtr& getSampler() const
+  {
+    return sampler_;
+  }
+
+  /** \brief Gets the reservoir samples are served from */
+  const SampleReservoirPtr& getReservoir() const
+  {
+    return reservoir_;
+  }
+
+  /**
+   * \brief Configures the wrapped sampler.
+   *
+   * The reservoir refers to the constraints the sampler was configured for
+   * at construction, so this should only be called with the same constraints.
+   */
+  bool configure(const moveit_msgs::msg::Constraints& constr) override;
+
+  /**
+   * \brief Serve the next sample of the reservoir that passes the validity
+   * callback, or draw a new sample from the wrapped sampler.
+   *
+   * @param [out] state State where the group sample is written to
+   * @param [in] reference_state Reference kinematic state passed through to the wrapped sampler
+   * @param [in] max_attempts Max attempts passed through to the wrapped sampler
+   *
+   * @return True if a sample was served or drawn
+   */
+  bool sample(moveit::core::RobotState& state, const moveit::core::RobotState& reference_state,
+              unsigned int max_attempts) override;
+
+  bool project(moveit::core::RobotState& state, unsigned int max_attempts) override;
+
+  void setVerbose(bool verbose) override;
+
+  const std::string& getName() const override
+  {
+    static const std::string SAMPLER_NAME = "ReservoirConstraintSampler";
+    return SAMPLER_NAME;
+  }
+
+protected:
+  ConstraintSamplerPtr sampler_;  /**< \brief The wrapped sampler */
+  SampleReservoirPtr reservoir_;  /**< \brief The shared reservoir */
+  std::size_t next_sample_index_; /**< \brief Index of the next reservoir sample to serve */
+};
+}  // namespace constraint_samplers
@@ -167,5 +167,15 @@ public:
 
 protected:
   std::vector<ConstraintSamplerPtr> samplers_; /**< \brief Holder for sorted internal list of samplers*/
+
+  /** \brief For each sampler, whether it reads link transforms of the state it is given.
+   *
+   * Joint constraint samplers only write joint values, so the link transforms are brought up to date once before the
+   * next sampler that needs them, instead of after every sampler in the chain. */
+  std::vector<bool> needs_link_transforms_;
+
+  /** \brief Whether the group is randomized before sampling, which is unnecessary when the first sampler is a joint
+   * constraint sampler that writes every variable of the group anyway */
+  bool randomize_group_;
 };
 }  // namespace constraint_samplers
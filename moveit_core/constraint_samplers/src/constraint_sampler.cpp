@@ -52,6 +52,25 @@ constraint_samplers::ConstraintSampler::ConstraintSampler(const planning_scene::
   }
 }
 
+std::size_t constraint_samplers::ConstraintSampler::sampleBatch(const moveit::core::RobotState& reference_state,
+                                                                std::size_t count,
+                                                                std::vector<moveit::core::RobotState>& states,
+                                                                unsigned int max_attempts)
+{
+  moveit::core::RobotState seed(reference_state);
+  seed.updateLinkTransforms();
+
+  const std::size_t initial_size = states.size();
+  states.reserve(initial_size + count);
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    states.push_back(seed);
+    if (!sample(states.back(), states.back(), max_attempts))
+      states.pop_back();
+  }
+  return states.size() - initial_size;
+}
+
 void constraint_samplers::ConstraintSampler::clear()
 {
   is_valid_ = false;
@@ -39,6 +39,7 @@
 #include <moveit/constraint_samplers/union_constraint_sampler.h>
 #include <rclcpp/logger.hpp>
 #include <rclcpp/logging.hpp>
+#include <rclcpp/serialization.hpp>
 #include <sstream>
 
 namespace constraint_samplers
@@ -49,12 +50,78 @@ ConstraintSamplerPtr ConstraintSamplerManager::selectSampler(const planning_scen
                                                              const std::string& group_name,
                                                              const moveit_msgs::msg::Constraints& constr) const
 {
+  ConstraintSamplerPtr selected;
   for (const ConstraintSamplerAllocatorPtr& sampler : sampler_alloc_)
     if (sampler->canService(scene, group_name, constr))
-      return sampler->alloc(scene, group_name, constr);
+    {
+      selected = sampler->alloc(scene, group_name, constr);
+      break;
+    }
 
   // if no default sampler was used, try a default one
-  return selectDefaultSampler(scene, group_name, constr);
+  if (!selected)
+    selected = selectDefaultSampler(scene, group_name, constr);
+
+  // samples that depend on the reference state cannot be reused
+  if (!selected || reservoir_size_ == 0 || !selected->getFrameDependency().empty())
+    return selected;
+  return std::make_shared<ReservoirConstraintSampler>(scene, group_name, selected,
+                                                      getSampleReservoir(scene, group_name, constr));
+}
+
+void ConstraintSamplerManager::enableSampleReservoirs(std::size_t reservoir_size, std::size_t max_reservoirs)
+{
+  std::scoped_lock lock(reservoirs_mutex_);
+  reservoir_size_ = reservoir_size;
+  max_reservoirs_ = std::max<std::size_t>(max_reservoirs, 1);
+  reservoirs_.clear();
+  reservoir_index_.clear();
+}
+
+SampleReservoirPtr ConstraintSamplerManager::getSampleReservoir(const planning_scene::PlanningSceneConstPtr& scene,
+                                                                const std::string& group_name,
+                                                                const moveit_msgs::msg::Constraints& constr) const
+{
+  // samples stay valid as long as the collision objects and allowed collisions of the scene do not change
+  std::string key = group_name + '\0';
+  const auto append_value = [&key](auto value) { key.append(reinterpret_cast<const char*>(&value), sizeof(value)); };
+  append_value(scene->getWorldVersion());
+  append_value(scene->getAllowedCollisionMatrix().getVersion());
+
+  moveit_msgs::msg::Constraints canonical = constr;
+  canonical.name.clear();
+  for (moveit_msgs::msg::PositionConstraint& constraint : canonical.position_constraints)
+    constraint.header.stamp = builtin_interfaces::msg::Time();
+  for (moveit_msgs::msg::OrientationConstraint& constraint : canonical.orientation_constraints)
+    constraint.header.stamp = builtin_interfaces::msg::Time();
+  for (moveit_msgs::msg::VisibilityConstraint& constraint : canonical.visibility_constraints)
+  {
+    constraint.target_pose.header.stamp = builtin_interfaces::msg::Time();
+    constraint.sensor_pose.header.stamp = builtin_interfaces::msg::Time();
+  }
+  static const rclcpp::Serialization<moveit_msgs::msg::Constraints> SERIALIZER;
+  rclcpp::SerializedMessage serialized;
+  SERIALIZER.serialize_message(&canonical, &serialized);
+  const rcl_serialized_message_t& buffer = serialized.get_rcl_serialized_message();
+  key.append(reinterpret_cast<const char*>(buffer.buffer), buffer.buffer_length);
+
+  std::scoped_lock lock(reservoirs_mutex_);
+  const auto it = reservoir_index_.find(key);
+  if (it != reservoir_index_.end())
+  {
+    // move the reservoir to the front of the least recently used list
+    reservoirs_.splice(reservoirs_.begin(), reservoirs_, it->second);
+    return it->second->second;
+  }
+
+  reservoirs_.emplace_front(key, std::make_shared<SampleReservoir>(reservoir_size_));
+  reservoir_index_[key] = reservoirs_.begin();
+  while (reservoirs_.size() > max_reservoirs_)
+  {
+    reservoir_index_.erase(reservoirs_.back().first);
+    reservoirs_.pop_back();
+  }
+  return reservoirs_.front().second;
 }
 
 ConstraintSamplerPtr ConstraintSamplerManager::selectDefaultSampler(const planning_scene::PlanningSceneConstPtr& scene,
@@ -238,6 +238,7 @@ void IKConstraintSampler::clear()
   transform_ik_ = false;
   eef_to_ik_tip_transform_ = Eigen::Isometry3d::Identity();
   need_eef_to_ik_tip_transform_ = false;
+  reachability_map_.reset();
 }
 
 bool IKConstraintSampler::configure(const IKSamplingPose& sp)
@@ -341,6 +342,26 @@ const std::string& IKConstraintSampler::getLinkName() const
   return sampling_pose_.position_constraint_->getLinkModel()->getName();
 }
 
+bool IKConstraintSampler::setKinematicsSolver(const kinematics::KinematicsBaseConstPtr& solver)
+{
+  kb_ = solver;
+  is_valid_ = loadIKSolver();
+  return is_valid_;
+}
+
+bool IKConstraintSampler::setReachabilityMap(const kinematics_metrics::ReachabilityMapConstPtr& map)
+{
+  if (map && (!kb_ || !moveit::core::Transforms::sameFrame(map->getBaseFrame(), ik_frame_) ||
+              !moveit::core::Transforms::sameFrame(map->getTipFrame(), kb_->getTipFrame())))
+  {
+    RCLCPP_ERROR(LOGGER, "Reachability map from '%s' to '%s' does not match the frames of the IK solver",
+                 map->getBaseFrame().c_str(), map->getTipFrame().c_str());
+    return false;
+  }
+  reachability_map_ = map;
+  return true;
+}
+
 bool IKConstraintSampler::loadIKSolver()
 {
   if (!kb_)
@@ -602,6 +623,10 @@ bool IKConstraintSampler::sampleHelper(moveit::core::RobotState& state, const mo
       quat = Eigen::Quaterniond(ikq.linear());  // ikq is isometry, so quat is normalized
     }
 
+    // a pose in a cell no sampled configuration reached is not worth the IK timeout
+    if (reachability_map_ && !reachability_map_->isReachable(Eigen::Isometry3d(Eigen::Translation3d(point) * quat)))
+      continue;
+
     geometry_msgs::msg::Pose ik_query;
     ik_query.position.x = point.x();
     ik_query.position.y = point.y();
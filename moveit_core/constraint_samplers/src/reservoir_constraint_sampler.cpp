@@ -0,0 +1,116 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/constraint_samplers/reservoir_constraint_sampler.h>
+
+namespace constraint_samplers
+{
+void SampleReservoir::addSample(const moveit::core::RobotState& state, const moveit::core::JointModelGroup* jmg)
+{
+  std::vector<double> values;
+  state.copyJointGroupPositions(jmg, values);
+  std::scoped_lock lock(mutex_);
+  if (samples_.size() >= capacity_)
+    samples_.pop_front();
+  samples_.push_back(std::move(values));
+}
+
+bool SampleReservoir::getSample(std::size_t index, std::vector<double>& values) const
+{
+  std::scoped_lock lock(mutex_);
+  if (index >= samples_.size())
+    return false;
+  values = samples_[index];
+  return true;
+}
+
+std::size_t SampleReservoir::size() const
+{
+  std::scoped_lock lock(mutex_);
+  return samples_.size();
+}
+
+ReservoirConstraintSampler::ReservoirConstraintSampler(const planning_scene::PlanningSceneConstPtr& scene,
+                                                       const std::string& /*group_name*/, ConstraintSamplerPtr sampler,
+                                                       SampleReservoirPtr reservoir)
+  : ConstraintSampler(scene, sampler->getJointModelGroup()->getName())
+  , sampler_(std::move(sampler))
+  , reservoir_(std::move(reservoir))
+  , next_sample_index_(0)
+{
+  is_valid_ = sampler_->isValid();
+  frame_depends_ = sampler_->getFrameDependency();
+}
+
+bool ReservoirConstraintSampler::configure(const moveit_msgs::msg::Constraints& constr)
+{
+  is_valid_ = sampler_->configure(constr);
+  frame_depends_ = sampler_->getFrameDependency();
+  return is_valid_;
+}
+
+bool ReservoirConstraintSampler::sample(moveit::core::RobotState& state, const moveit::core::RobotState& reference_state,
+                                        unsigned int max_attempts)
+{
+  std::vector<double> values;
+  while (reservoir_->getSample(next_sample_index_, values))
+  {
+    ++next_sample_index_;
+    if (!group_state_validity_callback_ || group_state_validity_callback_(&state, jmg_, values.data()))
+    {
+      state.setJointGroupPositions(jmg_, values);
+      return true;
+    }
+  }
+
+  sampler_->setGroupStateValidityCallback(group_state_validity_callback_);
+  if (!sampler_->sample(state, reference_state, max_attempts))
+    return false;
+  reservoir_->addSample(state, jmg_);
+  // the new sample was appended to the reservoir, do not serve it again
+  ++next_sample_index_;
+  return true;
+}
+
+bool ReservoirConstraintSampler::project(moveit::core::RobotState& state, unsigned int max_attempts)
+{
+  return sampler_->project(state, max_attempts);
+}
+
+void ReservoirConstraintSampler::setVerbose(bool verbose)
+{
+  ConstraintSampler::setVerbose(verbose);
+  sampler_->setVerbose(verbose);
+}
+}  // namespace constraint_samplers
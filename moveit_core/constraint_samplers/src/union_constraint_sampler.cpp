@@ -39,6 +39,7 @@
 #include <rclcpp/logger.hpp>
 #include <rclcpp/logging.hpp>
 #include <algorithm>
+#include <set>
 
 namespace constraint_samplers
 {
@@ -111,7 +112,7 @@ struct OrderSamplers
 UnionConstraintSampler::UnionConstraintSampler(const planning_scene::PlanningSceneConstPtr& scene,
                                                const std::string& group_name,
                                                const std::vector<ConstraintSamplerPtr>& samplers)
-  : ConstraintSampler(scene, group_name), samplers_(samplers)
+  : ConstraintSampler(scene, group_name), samplers_(samplers), randomize_group_(true)
 {
   // using stable sort to preserve order of equivalents
   std::stable_sort(samplers_.begin(), samplers_.end(), OrderSamplers());
@@ -121,17 +122,28 @@ UnionConstraintSampler::UnionConstraintSampler(const planning_scene::PlanningSce
     const std::vector<std::string>& fds = sampler->getFrameDependency();
     for (const std::string& fd : fds)
       frame_depends_.push_back(fd);
+    needs_link_transforms_.push_back(dynamic_cast<JointConstraintSampler*>(sampler.get()) == nullptr);
 
     RCLCPP_DEBUG(LOGGER, "Union sampler for group '%s' includes sampler for group '%s'", jmg_->getName().c_str(),
                  sampler->getJointModelGroup()->getName().c_str());
   }
+
+  if (jmg_ && !samplers_.empty() && !needs_link_transforms_.front())
+  {
+    const std::vector<int>& first_variables = samplers_.front()->getJointModelGroup()->getVariableIndexList();
+    const std::set<int> written(first_variables.begin(), first_variables.end());
+    const std::vector<int>& variables = jmg_->getVariableIndexList();
+    randomize_group_ = !std::all_of(variables.begin(), variables.end(),
+                                    [&written](int index) { return written.count(index) > 0; });
+  }
 }
 
 bool UnionConstraintSampler::sample(moveit::core::RobotState& state, const moveit::core::RobotState& reference_state,
                                     unsigned int max_attempts)
 {
   state = reference_state;
-  state.setToRandomPositions(jmg_);
+  if (randomize_group_)
+    state.setToRandomPositions(jmg_);
 
   if (!samplers_.empty())
   {
@@ -143,8 +155,9 @@ bool UnionConstraintSampler::sample(moveit::core::RobotState& state, const movei
   {
     // ConstraintSampler::sample returns states with dirty link transforms (because it only writes values)
     // but requires a state with clean link transforms as input. This means that we need to clean the link
-    // transforms between calls to ConstraintSampler::sample.
-    state.updateLinkTransforms();
+    // transforms between calls to ConstraintSampler::sample, unless the next sampler only writes joint values.
+    if (needs_link_transforms_[i])
+      state.updateLinkTransforms();
     if (!samplers_[i]->sample(state, state, max_attempts))
       return false;
   }
@@ -153,13 +166,14 @@ bool UnionConstraintSampler::sample(moveit::core::RobotState& state, const movei
 
 bool UnionConstraintSampler::project(moveit::core::RobotState& state, unsigned int max_attempts)
 {
-  for (ConstraintSamplerPtr& sampler : samplers_)
+  for (std::size_t i = 0; i < samplers_.size(); ++i)
   {
     // ConstraintSampler::project returns states with dirty link transforms (because it only writes values)
     // but requires a state with clean link transforms as input. This means that we need to clean the link
-    // transforms between calls to ConstraintSampler::sample.
-    state.updateLinkTransforms();
-    if (!sampler->project(state, max_attempts))
+    // transforms between calls to ConstraintSampler::sample, unless the next sampler only writes joint values.
+    if (needs_link_transforms_[i])
+      state.updateLinkTransforms();
+    if (!samplers_[i]->project(state, max_attempts))
       return false;
   }
   return true;
@@ -40,6 +40,7 @@
 #include <moveit/constraint_samplers/union_constraint_sampler.h>
 #include <moveit/constraint_samplers/constraint_sampler_manager.h>
 #include <moveit/constraint_samplers/constraint_sampler_tools.h>
+#include <moveit/constraint_samplers/reservoir_constraint_sampler.h>
 #include <moveit/robot_state/conversions.h>
 #include <moveit/utils/robot_model_test_utils.h>
 
@@ -50,7 +51,9 @@
 #include <gtest/gtest.h>
 #include <urdf_parser/urdf_parser.h>
 #include <fstream>
+#include <atomic>
 #include <functional>
+#include <thread>
 
 #include "pr2_arm_kinematics_plugin.h"
 
@@ -317,6 +320,160 @@ TEST_F(LoadPlanningModelsPr2, IKConstraintsSamplerSimple)
   EXPECT_FALSE(iks.isValid());
 }
 
+TEST_F(LoadPlanningModelsPr2, IKConstraintsSamplerOwnSolver)
+{
+  moveit::core::Transforms& tf = ps_->getTransformsNonConst();
+
+  kinematic_constraints::PositionConstraint pc(robot_model_);
+  moveit_msgs::msg::PositionConstraint pcm;
+  pcm.header.frame_id = robot_model_->getModelFrame();
+  pcm.link_name = "l_wrist_roll_link";
+  pcm.constraint_region.primitives.resize(1);
+  pcm.constraint_region.primitives[0].type = shape_msgs::msg::SolidPrimitive::SPHERE;
+  pcm.constraint_region.primitives[0].dimensions.resize(1);
+  pcm.constraint_region.primitives[0].dimensions[0] = 0.001;
+  pcm.constraint_region.primitive_poses.resize(1);
+  pcm.constraint_region.primitive_poses[0].position.x = 0.55;
+  pcm.constraint_region.primitive_poses[0].position.y = 0.2;
+  pcm.constraint_region.primitive_poses[0].position.z = 1.25;
+  pcm.constraint_region.primitive_poses[0].orientation.w = 1.0;
+  pcm.weight = 1.0;
+  EXPECT_TRUE(pc.configure(pcm, tf));
+
+  constraint_samplers::IKConstraintSampler iks(ps_, "left_arm");
+  EXPECT_TRUE(iks.configure(constraint_samplers::IKSamplingPose(pc)));
+
+  // a separate instance configured like the solver of the group can be used instead
+  auto solver = std::make_shared<pr2_arm_kinematics::PR2ArmKinematicsPlugin>();
+  solver->initialize(node_, *robot_model_, "left_arm", "torso_lift_link", { "l_wrist_roll_link" }, .01);
+  EXPECT_TRUE(iks.setKinematicsSolver(solver));
+  moveit::core::RobotState ks(robot_model_);
+  ks.setToDefaultValues();
+  ks.update();
+  EXPECT_TRUE(iks.sample(ks, ks, 100));
+  ks.update();
+  EXPECT_TRUE(pc.decide(ks).satisfied);
+
+  // a solver for another tip link is rejected
+  EXPECT_FALSE(iks.setKinematicsSolver(pr2_kinematics_plugin_right_arm_));
+  EXPECT_FALSE(iks.isValid());
+}
+
+TEST_F(LoadPlanningModelsPr2, IKConstraintsSamplerReachabilityMap)
+{
+  moveit::core::Transforms& tf = ps_->getTransformsNonConst();
+
+  kinematic_constraints::PositionConstraint pc(robot_model_);
+  moveit_msgs::msg::PositionConstraint pcm;
+  pcm.header.frame_id = robot_model_->getModelFrame();
+  pcm.link_name = "l_wrist_roll_link";
+  pcm.constraint_region.primitives.resize(1);
+  pcm.constraint_region.primitives[0].type = shape_msgs::msg::SolidPrimitive::SPHERE;
+  pcm.constraint_region.primitives[0].dimensions.resize(1);
+  pcm.constraint_region.primitives[0].dimensions[0] = 0.001;
+  pcm.constraint_region.primitive_poses.resize(1);
+  pcm.constraint_region.primitive_poses[0].position.x = 0.55;
+  pcm.constraint_region.primitive_poses[0].position.y = 0.2;
+  pcm.constraint_region.primitive_poses[0].position.z = 1.25;
+  pcm.constraint_region.primitive_poses[0].orientation.w = 1.0;
+  pcm.weight = 1.0;
+  EXPECT_TRUE(pc.configure(pcm, tf));
+
+  kinematics_metrics::ReachabilityMap::Options options;
+  options.position_resolution = 0.1;
+  options.orientation_bins = 0;
+  options.num_samples = 100000;
+  kinematics_metrics::ReachabilityMapConstPtr map = kinematics_metrics::ReachabilityMap::generate(
+      robot_model_, "left_arm", "torso_lift_link", "l_wrist_roll_link", options);
+  ASSERT_TRUE(map);
+
+  constraint_samplers::IKConstraintSampler iks(ps_, "left_arm");
+  EXPECT_TRUE(iks.configure(constraint_samplers::IKSamplingPose(pc)));
+  EXPECT_TRUE(iks.setReachabilityMap(map));
+  moveit::core::RobotState ks(robot_model_);
+  ks.setToDefaultValues();
+  ks.update();
+  EXPECT_TRUE(iks.sample(ks, ks, 100));
+  ks.update();
+  EXPECT_TRUE(pc.decide(ks).satisfied);
+
+  // a goal out of reach of the arm is rejected without calling IK
+  pcm.constraint_region.primitive_poses[0].position.x = 3.0;
+  EXPECT_TRUE(pc.configure(pcm, tf));
+  EXPECT_TRUE(iks.configure(constraint_samplers::IKSamplingPose(pc)));
+  EXPECT_TRUE(iks.setReachabilityMap(map));
+  EXPECT_FALSE(iks.sample(ks, ks, 100));
+
+  // a map of another tip link is rejected
+  kinematics_metrics::ReachabilityMapConstPtr right_map = kinematics_metrics::ReachabilityMap::generate(
+      robot_model_, "right_arm", "torso_lift_link", "r_wrist_roll_link", options);
+  ASSERT_TRUE(right_map);
+  EXPECT_FALSE(iks.setReachabilityMap(right_map));
+}
+
+TEST_F(LoadPlanningModelsPr2, IKConstraintsSamplerPerThreadSolvers)
+{
+  moveit::core::JointModelGroup* jmg = robot_model_->getJointModelGroup("left_arm");
+  jmg->setSolverAllocators([this](const moveit::core::JointModelGroup* /*jmg*/) {
+    auto solver = std::make_shared<pr2_arm_kinematics::PR2ArmKinematicsPlugin>();
+    solver->initialize(node_, *robot_model_, "left_arm", "torso_lift_link", { "l_wrist_roll_link" }, .01);
+    return solver;
+  });
+  jmg->setPerThreadSolverInstances(true);
+
+  // every thread gets its own instance, which it keeps
+  const moveit::core::JointModelGroup* const_jmg = jmg;
+  const kinematics::KinematicsBaseConstPtr main_solver = const_jmg->getSolverInstance();
+  ASSERT_TRUE(main_solver);
+  EXPECT_EQ(main_solver, const_jmg->getSolverInstance());
+  EXPECT_NE(main_solver, jmg->getSolverInstance());
+
+  kinematic_constraints::PositionConstraint pc(robot_model_);
+  moveit_msgs::msg::PositionConstraint pcm;
+  pcm.header.frame_id = robot_model_->getModelFrame();
+  pcm.link_name = "l_wrist_roll_link";
+  pcm.constraint_region.primitives.resize(1);
+  pcm.constraint_region.primitives[0].type = shape_msgs::msg::SolidPrimitive::SPHERE;
+  pcm.constraint_region.primitives[0].dimensions.resize(1);
+  pcm.constraint_region.primitives[0].dimensions[0] = 0.001;
+  pcm.constraint_region.primitive_poses.resize(1);
+  pcm.constraint_region.primitive_poses[0].position.x = 0.55;
+  pcm.constraint_region.primitive_poses[0].position.y = 0.2;
+  pcm.constraint_region.primitive_poses[0].position.z = 1.25;
+  pcm.constraint_region.primitive_poses[0].orientation.w = 1.0;
+  pcm.weight = 1.0;
+  EXPECT_TRUE(pc.configure(pcm, ps_->getTransforms()));
+
+  // samplers running concurrently do not share a solver
+  const std::size_t num_threads = 4;
+  std::atomic<std::size_t> done(0);
+  std::vector<kinematics::KinematicsBaseConstPtr> solvers(num_threads);
+  std::vector<bool> sampled(num_threads, false);
+  std::vector<std::thread> threads;
+  for (std::size_t i = 0; i < num_threads; ++i)
+    threads.emplace_back([&, i] {
+      solvers[i] = const_jmg->getSolverInstance();
+      constraint_samplers::IKConstraintSampler iks(ps_, "left_arm");
+      moveit::core::RobotState ks(robot_model_);
+      ks.setToDefaultValues();
+      ks.update();
+      sampled[i] = iks.configure(constraint_samplers::IKSamplingPose(pc)) && iks.sample(ks, ks, 100);
+      // keep the thread alive so its id is not reused by another one
+      ++done;
+      while (done < num_threads)
+        std::this_thread::yield();
+    });
+  for (std::thread& thread : threads)
+    thread.join();
+  for (std::size_t i = 0; i < num_threads; ++i)
+  {
+    EXPECT_TRUE(sampled[i]);
+    EXPECT_NE(solvers[i], main_solver);
+    for (std::size_t j = 0; j < i; ++j)
+      EXPECT_NE(solvers[i], solvers[j]);
+  }
+}
+
 TEST_F(LoadPlanningModelsPr2, OrientationConstraintsSampler)
 {
   moveit::core::RobotState ks(robot_model_);
@@ -575,6 +732,18 @@ TEST_F(LoadPlanningModelsPr2, UnionConstraintSampler)
     EXPECT_TRUE(pc.decide(ks).satisfied);
   }
 
+  // a batch of samples from the same reference satisfies the constraints as well
+  std::vector<moveit::core::RobotState> batch;
+  EXPECT_EQ(ucs.sampleBatch(ks_const, 20, batch, 100), 20u);
+  ASSERT_EQ(batch.size(), 20u);
+  for (moveit::core::RobotState& sample : batch)
+  {
+    sample.update();
+    EXPECT_TRUE(jc1.decide(sample).satisfied);
+    EXPECT_TRUE(jc2.decide(sample).satisfied);
+    EXPECT_TRUE(pc.decide(sample).satisfied);
+  }
+
   // now we add a position constraint on right arm
   pcm.link_name = "r_wrist_roll_link";
   ocm.link_name = "r_wrist_roll_link";
@@ -1045,6 +1214,79 @@ TEST_F(LoadPlanningModelsPr2, SubgroupJointConstraintsSamplerManager)
   }
 }
 
+TEST_F(LoadPlanningModelsPr2, ReservoirConstraintSamplerManager)
+{
+  moveit::core::RobotState ks(robot_model_);
+  ks.setToDefaultValues();
+  ks.update();
+  moveit::core::RobotState ks_const(robot_model_);
+  ks_const.setToDefaultValues();
+  ks_const.update();
+
+  moveit_msgs::msg::JointConstraint jcm;
+  jcm.joint_name = "r_wrist_roll_joint";
+  jcm.position = 0.7;
+  jcm.tolerance_above = 0.1;
+  jcm.tolerance_below = 0.1;
+  jcm.weight = 1.0;
+  moveit_msgs::msg::Constraints c;
+  c.joint_constraints.push_back(jcm);
+
+  constraint_samplers::ConstraintSamplerManager manager;
+  manager.enableSampleReservoirs(3, 2);
+
+  constraint_samplers::ConstraintSamplerPtr s = manager.selectSampler(ps_, "right_arm", c);
+  auto reservoir_sampler = std::dynamic_pointer_cast<constraint_samplers::ReservoirConstraintSampler>(s);
+  ASSERT_TRUE(reservoir_sampler);
+  EXPECT_EQ(reservoir_sampler->getReservoir()->size(), 0u);
+
+  const moveit::core::JointModelGroup* jmg = robot_model_->getJointModelGroup("right_arm");
+  std::vector<std::vector<double>> samples;
+  for (int t = 0; t < 3; ++t)
+  {
+    EXPECT_TRUE(s->sample(ks, ks_const, 1));
+    samples.emplace_back();
+    ks.copyJointGroupPositions(jmg, samples.back());
+  }
+  EXPECT_EQ(reservoir_sampler->getReservoir()->size(), 3u);
+
+  // a later request for the same constraints is served the stored samples first, even if it is named differently
+  c.name = "repeated goal";
+  constraint_samplers::ConstraintSamplerPtr repeated = manager.selectSampler(ps_, "right_arm", c);
+  auto repeated_reservoir_sampler =
+      std::dynamic_pointer_cast<constraint_samplers::ReservoirConstraintSampler>(repeated);
+  ASSERT_TRUE(repeated_reservoir_sampler);
+  EXPECT_EQ(repeated_reservoir_sampler->getReservoir(), reservoir_sampler->getReservoir());
+  for (const std::vector<double>& sample : samples)
+  {
+    EXPECT_TRUE(repeated->sample(ks, ks_const, 1));
+    std::vector<double> values;
+    ks.copyJointGroupPositions(jmg, values);
+    EXPECT_EQ(values, sample);
+  }
+
+  // samples rejected by the validity callback are skipped
+  constraint_samplers::ConstraintSamplerPtr rejecting = manager.selectSampler(ps_, "right_arm", c);
+  std::size_t calls = 0;
+  rejecting->setGroupStateValidityCallback(
+      [&calls](moveit::core::RobotState*, const moveit::core::JointModelGroup*, const double*) {
+        return ++calls > 1;
+      });
+  EXPECT_TRUE(rejecting->sample(ks, ks_const, 1));
+  std::vector<double> values;
+  ks.copyJointGroupPositions(jmg, values);
+  EXPECT_EQ(values, samples[1]);
+
+  // a changed world gets its own reservoir
+  ps_->getWorldNonConst()->addToObject("box", std::make_shared<const shapes::Box>(0.1, 0.1, 0.1),
+                                       Eigen::Isometry3d::Identity());
+  constraint_samplers::ConstraintSamplerPtr changed = manager.selectSampler(ps_, "right_arm", c);
+  auto changed_reservoir_sampler = std::dynamic_pointer_cast<constraint_samplers::ReservoirConstraintSampler>(changed);
+  ASSERT_TRUE(changed_reservoir_sampler);
+  EXPECT_NE(changed_reservoir_sampler->getReservoir(), reservoir_sampler->getReservoir());
+  EXPECT_EQ(changed_reservoir_sampler->getReservoir()->size(), 0u);
+}
+
 TEST_F(LoadPlanningModelsPr2, SubgroupPoseConstraintsSampler)
 {
   moveit_msgs::msg::Constraints c;
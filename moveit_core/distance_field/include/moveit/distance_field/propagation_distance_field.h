@@ -215,6 +215,15 @@ public:
    * @return
    */
   PropagationDistanceField(std::istream& stream, double max_distance, bool propagate_negative_distances = false);
+
+  /**
+   * \brief Copy constructor. The distance data is copied, so that
+   * both fields can be modified independently afterwards.
+   *
+   * @param [in] other The field to copy
+   */
+  PropagationDistanceField(const PropagationDistanceField& other);
+
   /**
    * \brief Empty destructor
    *
@@ -446,6 +455,28 @@ public:
     return max_distance_sq_;
   }
 
+  /**
+   * \brief Sets the number of threads used to propagate distances.
+   *
+   * Large propagation fronts are split across this many threads. The
+   * resulting distances and closest points are identical to those of
+   * a serial propagation. A value of 0 uses one thread per hardware
+   * thread; the default is 1.
+   *
+   * @param [in] thread_count The number of propagation threads
+   */
+  void setPropagationThreadCount(unsigned int thread_count);
+
+  /**
+   * \brief Gets the number of threads used to propagate distances.
+   *
+   * @return The number of propagation threads
+   */
+  unsigned int getPropagationThreadCount() const
+  {
+    return propagation_thread_count_;
+  }
+
 private:
   /** Typedef for set of integer indices */
   typedef std::set<Eigen::Vector3i, CompareEigenVector3i, Eigen::aligned_allocator<Eigen::Vector3i>> VoxelSet;
@@ -487,6 +518,26 @@ private:
    */
   void propagateNegative();
 
+  /**
+   * \brief Expands one bucket of a propagation queue on several
+   * threads.
+   *
+   * The threads collect the neighbor updates of contiguous slices of
+   * the bucket without modifying the grid. The updates are then
+   * applied in the order the serial propagation would perform them,
+   * so the result does not depend on the number of threads.
+   *
+   * @param queue The bucket queue to expand
+   * @param bucket Index of the bucket to expand
+   * @param distance_sq The voxel member holding the propagated squared distance
+   * @param closest_point The voxel member holding the closest cell
+   * @param update_direction The voxel member holding the update direction
+   */
+  void propagateBucketParallel(std::vector<EigenSTL::vector_Vector3i>& queue, unsigned int bucket,
+                               int PropDistanceFieldVoxel::*distance_sq,
+                               Eigen::Vector3i PropDistanceFieldVoxel::*closest_point,
+                               int PropDistanceFieldVoxel::*update_direction);
+
   /**
    * \brief Determines distance based on actual voxel data
    *
@@ -576,6 +627,8 @@ private:
 
   EigenSTL::vector_Vector3i direction_number_to_direction_; /**< \brief Holds conversion from direction number to
                                                                   integer changes */
+
+  unsigned int propagation_thread_count_ = 1; /**< \brief Number of threads expanding large buckets */
 };
 
 ////////////////////////// inline functions follow ////////////////////////////////////////
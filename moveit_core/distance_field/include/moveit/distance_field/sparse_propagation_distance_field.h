@@ -0,0 +1,176 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#pragma once
+
+#include <moveit/distance_field/distance_field.h>
+#include <moveit/distance_field/propagation_distance_field.h>
+#include <moveit/distance_field/sparse_voxel_grid.h>
+#include <vector>
+
+namespace distance_field
+{
+/**
+ * \brief Structure that holds voxel information for the
+ * SparsePropagationDistanceField.  Will be used in SparseVoxelGrid.
+ */
+struct SparseDistanceFieldVoxel
+{
+  int distance_square_;           /**< \brief Distance in cells to the closest obstacle, squared */
+  Eigen::Vector3i closest_point_; /**< \brief Closest occupied cell */
+  int update_direction_;          /**< \brief Direction from which this voxel was updated */
+};
+
+MOVEIT_CLASS_FORWARD(SparsePropagationDistanceField);  // Defines SparsePropagationDistanceFieldPtr, ConstPtr, etc
+
+/**
+ * \brief An unsigned DistanceField implementation that uses the same
+ * vector propagation method as \ref PropagationDistanceField, but
+ * stores its cells in a \ref SparseVoxelGrid.
+ *
+ * Distances are truncated at the maximum distance: only cells within
+ * the maximum distance of an obstacle are ever allocated, all others
+ * report the maximum distance without occupying memory.  This makes
+ * the field suited for large workspaces that are mostly far away from
+ * any obstacle, as memory use and the cost of \ref reset scale with
+ * the obstacle surface instead of the workspace volume.  Individual
+ * cell accesses are slower than with the dense grid of \ref
+ * PropagationDistanceField, which should be preferred for small
+ * volumes.
+ */
+class SparsePropagationDistanceField : public DistanceField
+{
+public:
+  /**
+   * \brief Constructor that initializes the entire distance field to
+   * empty - all cells will be assigned maximum distance values, and no
+   * memory is allocated for them.
+   *
+   * @param [in] size_x The X dimension in meters of the volume to represent
+   * @param [in] size_y The Y dimension in meters of the volume to represent
+   * @param [in] size_z The Z dimension in meters of the volume to represent
+   * @param [in] resolution The resolution in meters of the volume
+   * @param [in] origin_x The minimum X point of the volume
+   * @param [in] origin_y The minimum Y point of the volume
+   * @param [in] origin_z The minimum Z point of the volume
+   *
+   * @param [in] max_distance The maximum distance to which to
+   * propagate distance values.  Cells that are greater than this
+   * distance will be assigned the maximum distance value.
+   */
+  SparsePropagationDistanceField(double size_x, double size_y, double size_z, double resolution, double origin_x,
+                                 double origin_y, double origin_z, double max_distance);
+
+  /**
+   * \brief Constructor that takes an istream in the format written by
+   * \ref writeToStream, which is the same as the one of \ref
+   * PropagationDistanceField::writeToStream.
+   *
+   * @param [in] stream The stream from which to read the data
+   * @param [in] max_distance The maximum distance to which to propagate distance values
+   */
+  SparsePropagationDistanceField(std::istream& stream, double max_distance);
+
+  // passthrough docs to DistanceField
+  void addPointsToField(const EigenSTL::vector_Vector3d& points) override;
+  void removePointsFromField(const EigenSTL::vector_Vector3d& points) override;
+  void updatePointsInField(const EigenSTL::vector_Vector3d& old_points,
+                           const EigenSTL::vector_Vector3d& new_points) override;
+  void reset() override;
+  double getDistance(double x, double y, double z) const override;
+  double getDistance(int x, int y, int z) const override;
+  bool isCellValid(int x, int y, int z) const override;
+  int getXNumCells() const override;
+  int getYNumCells() const override;
+  int getZNumCells() const override;
+  bool gridToWorld(int x, int y, int z, double& world_x, double& world_y, double& world_z) const override;
+  bool worldToGrid(double world_x, double world_y, double world_z, int& x, int& y, int& z) const override;
+  bool writeToStream(std::ostream& stream) const override;
+  bool readFromStream(std::istream& stream) override;
+
+  double getUninitializedDistance() const override
+  {
+    return max_distance_;
+  }
+
+  /**
+   * \brief Gets the voxel at the given cell, without allocating
+   * memory.  No check is made that the cell is valid.
+   */
+  const SparseDistanceFieldVoxel& getCell(int x, int y, int z) const
+  {
+    return voxel_grid_->getCell(x, y, z);
+  }
+
+  /** \brief Gets the maximum distance squared value, in cells */
+  int getMaximumDistanceSquared() const
+  {
+    return max_distance_sq_;
+  }
+
+  /** \brief Gets the number of voxels that currently occupy memory */
+  std::size_t getAllocatedCellCount() const
+  {
+    return voxel_grid_->getAllocatedCellCount();
+  }
+
+private:
+  /** \brief Initializes the voxel grid, the bucket queue and the sqrt table */
+  void initialize();
+
+  /** \brief Marks the given cells as obstacles and propagates the new distances */
+  void addNewObstacleVoxels(const EigenSTL::vector_Vector3i& voxel_points);
+
+  /** \brief Clears the given obstacle cells and re-propagates the distances of the cells that depended on them */
+  void removeObstacleVoxels(const EigenSTL::vector_Vector3i& voxel_points);
+
+  /** \brief Propagates distances from the cells in the bucket queue */
+  void propagate();
+
+  /** \brief Initializes the neighborhoods, see PropagationDistanceField::initNeighborhoods */
+  void initNeighborhoods();
+
+  double max_distance_; /**< \brief Holds maximum distance  */
+  int max_distance_sq_; /**< \brief Holds maximum distance squared in cells */
+
+  SparseVoxelGrid<SparseDistanceFieldVoxel>::Ptr voxel_grid_; /**< \brief Actual container for distance data */
+
+  std::vector<EigenSTL::vector_Vector3i> bucket_queue_; /**< \brief Propagation frontier, by distance squared */
+
+  std::vector<double> sqrt_table_; /**< \brief Precomputed square root table for faster distance lookups */
+
+  /** \brief Neighbors to expand by bucket (0 or >0) and update direction, as in PropagationDistanceField */
+  std::vector<std::vector<EigenSTL::vector_Vector3i>> neighborhoods_;
+};
+}  // namespace distance_field
@@ -0,0 +1,279 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#pragma once
+
+#include <moveit/distance_field/voxel_grid.h>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+
+namespace distance_field
+{
+/**
+ * \brief SparseVoxelGrid holds a 3D, axis-aligned set of data at a
+ * given resolution, like \ref VoxelGrid, but only allocates memory for
+ * the parts of the volume that have been written to.
+ *
+ * The volume is divided into cubic blocks of BLOCK_SIZE^3 cells that
+ * are stored in a hash map and allocated on the first non-const
+ * access to one of their cells.  All cells of unallocated blocks hold
+ * the default object.  Memory use and the cost of \ref
+ * SparseVoxelGrid::reset therefore scale with the number of touched
+ * blocks instead of the represented volume.
+ */
+template <typename T>
+class SparseVoxelGrid
+{
+public:
+  MOVEIT_DECLARE_PTR_MEMBER(SparseVoxelGrid);
+
+  /** \brief Number of cells along each edge of a block */
+  static const int BLOCK_SIZE = 8;
+
+  /**
+   * \brief Constructor for the SparseVoxelGrid.
+   *
+   * @param [in] size_x Size of the X axis in meters
+   * @param [in] size_y Size of the Y axis in meters
+   * @param [in] size_z Size of the Z axis in meters
+   *
+   * @param [in] resolution Resolution of a single cell in meters
+   *
+   * @param [in] origin_x Minimum point along the X axis of the volume
+   * @param [in] origin_y Minimum point along the Y axis of the volume
+   * @param [in] origin_z Minimum point along the Z axis of the volume
+   *
+   * @param [in] default_object The value of all unallocated cells, also
+   * returned for queries that are not valid
+   */
+  SparseVoxelGrid(double size_x, double size_y, double size_z, double resolution, double origin_x, double origin_y,
+                  double origin_z, T default_object);
+
+  /**
+   * \brief Gets the value at the given world location (x, y, z).
+   *
+   * @return The data stored at that location, or the default object
+   * if the location is not valid or not allocated.
+   */
+  const T& operator()(double x, double y, double z) const;
+
+  /**
+   * \brief Gives the value of the given cell, allocating its block if
+   * needed.  If x,y,z is invalid then corruption and/or SEGFAULTS will
+   * occur.
+   */
+  T& getCell(int x, int y, int z);
+
+  /**
+   * \brief Gives the value of the given cell without allocating
+   * memory.  Cells of unallocated blocks return the default object.
+   * If x,y,z is invalid then corruption and/or SEGFAULTS will occur.
+   */
+  const T& getCell(int x, int y, int z) const;
+
+  /**
+   * \brief Gives a pointer to the given cell if its block is
+   * allocated, otherwise nullptr.
+   */
+  const T* findCell(int x, int y, int z) const;
+
+  /**
+   * \brief Releases all blocks, so every cell holds the default object
+   * again.
+   */
+  void reset();
+
+  /** \brief Gets the number of allocated blocks */
+  std::size_t getBlockCount() const
+  {
+    return blocks_.size();
+  }
+
+  /** \brief Gets the number of cells held in allocated blocks */
+  std::size_t getAllocatedCellCount() const
+  {
+    return blocks_.size() * BLOCK_SIZE * BLOCK_SIZE * BLOCK_SIZE;
+  }
+
+  /** \brief Gets the resolution in meters */
+  double getResolution() const
+  {
+    return resolution_;
+  }
+
+  /** \brief Gets the number of cells in the indicated dimension */
+  int getNumCells(Dimension dim) const
+  {
+    return num_cells_[dim];
+  }
+
+  /** \brief Converts from a set of integer indices to a world location, see \ref VoxelGrid::gridToWorld */
+  void gridToWorld(int x, int y, int z, double& world_x, double& world_y, double& world_z) const;
+
+  /** \brief Converts from a world location to a set of integer indices, see \ref VoxelGrid::worldToGrid */
+  bool worldToGrid(double world_x, double world_y, double world_z, int& x, int& y, int& z) const;
+
+  /** \brief Checks if the given cell in integer coordinates is within the voxel grid */
+  bool isCellValid(int x, int y, int z) const;
+
+private:
+  static const int BLOCK_CELLS = BLOCK_SIZE * BLOCK_SIZE * BLOCK_SIZE;
+
+  /** \brief Gets the hash map key of the block containing the given cell */
+  std::int64_t blockKey(int x, int y, int z) const;
+
+  /** \brief Gets the index of the given cell inside its block */
+  static int cellIndex(int x, int y, int z);
+
+  /** \brief Gets the rounded cell index of a world location along the given dimension */
+  int getCellFromLocation(Dimension dim, double loc) const;
+
+  T default_object_;           /**< \brief Value of unallocated cells and out-of-bounds queries */
+  double resolution_;          /**< \brief The resolution of each dimension in meters */
+  double oo_resolution_;       /**< \brief 1.0/resolution_ */
+  double origin_[3];           /**< \brief The origin (minimum point) of each dimension in meters */
+  double origin_minus_[3];     /**< \brief origin - 0.5*resolution */
+  int num_cells_[3];           /**< \brief The number of cells in each dimension */
+  std::int64_t num_blocks_[3]; /**< \brief The number of blocks in each dimension */
+
+  std::unordered_map<std::int64_t, std::unique_ptr<T[]>> blocks_; /**< \brief Allocated blocks by key */
+};
+
+//////////////////////////// template function definitions follow //////////////////
+
+template <typename T>
+SparseVoxelGrid<T>::SparseVoxelGrid(double size_x, double size_y, double size_z, double resolution, double origin_x,
+                                    double origin_y, double origin_z, T default_object)
+  : default_object_(default_object), resolution_(resolution), oo_resolution_(1.0 / resolution)
+{
+  const double size[3] = { size_x, size_y, size_z };
+  origin_[DIM_X] = origin_x;
+  origin_[DIM_Y] = origin_y;
+  origin_[DIM_Z] = origin_z;
+  for (int i = DIM_X; i <= DIM_Z; ++i)
+  {
+    origin_minus_[i] = origin_[i] - 0.5 * resolution;
+    num_cells_[i] = size[i] * oo_resolution_;
+    num_blocks_[i] = (num_cells_[i] + BLOCK_SIZE - 1) / BLOCK_SIZE;
+  }
+}
+
+template <typename T>
+inline bool SparseVoxelGrid<T>::isCellValid(int x, int y, int z) const
+{
+  return (x >= 0 && x < num_cells_[DIM_X] && y >= 0 && y < num_cells_[DIM_Y] && z >= 0 && z < num_cells_[DIM_Z]);
+}
+
+template <typename T>
+inline std::int64_t SparseVoxelGrid<T>::blockKey(int x, int y, int z) const
+{
+  return (x / BLOCK_SIZE * num_blocks_[DIM_Y] + y / BLOCK_SIZE) * num_blocks_[DIM_Z] + z / BLOCK_SIZE;
+}
+
+template <typename T>
+inline int SparseVoxelGrid<T>::cellIndex(int x, int y, int z)
+{
+  return ((x % BLOCK_SIZE) * BLOCK_SIZE + y % BLOCK_SIZE) * BLOCK_SIZE + z % BLOCK_SIZE;
+}
+
+template <typename T>
+inline T& SparseVoxelGrid<T>::getCell(int x, int y, int z)
+{
+  std::unique_ptr<T[]>& block = blocks_[blockKey(x, y, z)];
+  if (!block)
+  {
+    block.reset(new T[BLOCK_CELLS]);
+    std::fill(block.get(), block.get() + BLOCK_CELLS, default_object_);
+  }
+  return block[cellIndex(x, y, z)];
+}
+
+template <typename T>
+inline const T* SparseVoxelGrid<T>::findCell(int x, int y, int z) const
+{
+  auto it = blocks_.find(blockKey(x, y, z));
+  return it == blocks_.end() ? nullptr : &it->second[cellIndex(x, y, z)];
+}
+
+template <typename T>
+inline const T& SparseVoxelGrid<T>::getCell(int x, int y, int z) const
+{
+  const T* cell = findCell(x, y, z);
+  return cell ? *cell : default_object_;
+}
+
+template <typename T>
+inline const T& SparseVoxelGrid<T>::operator()(double x, double y, double z) const
+{
+  int cell_x = getCellFromLocation(DIM_X, x);
+  int cell_y = getCellFromLocation(DIM_Y, y);
+  int cell_z = getCellFromLocation(DIM_Z, z);
+  if (!isCellValid(cell_x, cell_y, cell_z))
+    return default_object_;
+  return getCell(cell_x, cell_y, cell_z);
+}
+
+template <typename T>
+inline void SparseVoxelGrid<T>::reset()
+{
+  blocks_.clear();
+}
+
+template <typename T>
+inline int SparseVoxelGrid<T>::getCellFromLocation(Dimension dim, double loc) const
+{
+  // rounded quantized location, see VoxelGrid::getCellFromLocation
+  return int(floor((loc - origin_minus_[dim]) * oo_resolution_));
+}
+
+template <typename T>
+inline void SparseVoxelGrid<T>::gridToWorld(int x, int y, int z, double& world_x, double& world_y,
+                                            double& world_z) const
+{
+  world_x = origin_[DIM_X] + resolution_ * double(x);
+  world_y = origin_[DIM_Y] + resolution_ * double(y);
+  world_z = origin_[DIM_Z] + resolution_ * double(z);
+}
+
+template <typename T>
+inline bool SparseVoxelGrid<T>::worldToGrid(double world_x, double world_y, double world_z, int& x, int& y,
+                                            int& z) const
+{
+  x = getCellFromLocation(DIM_X, world_x);
+  y = getCellFromLocation(DIM_Y, world_y);
+  z = getCellFromLocation(DIM_Z, world_z);
+  return isCellValid(x, y, z);
+}
+}  // namespace distance_field
@@ -90,6 +90,11 @@ public:
    */
   VoxelGrid(double size_x, double size_y, double size_z, double resolution, double origin_x, double origin_y,
             double origin_z, T default_object);
+
+  /** \brief Copy constructor, copying all of the data */
+  VoxelGrid(const VoxelGrid& other);
+  VoxelGrid& operator=(const VoxelGrid& other);
+
   virtual ~VoxelGrid();
 
   /**
@@ -346,6 +351,25 @@ VoxelGrid<T>::VoxelGrid(double size_x, double size_y, double size_z, double reso
   resize(size_x, size_y, size_z, resolution, origin_x, origin_y, origin_z, default_object);
 }
 
+template <typename T>
+VoxelGrid<T>::VoxelGrid(const VoxelGrid& other) : data_(nullptr)
+{
+  *this = other;
+}
+
+template <typename T>
+VoxelGrid<T>& VoxelGrid<T>::operator=(const VoxelGrid& other)
+{
+  if (this == &other)
+    return *this;
+
+  resize(other.size_[DIM_X], other.size_[DIM_Y], other.size_[DIM_Z], other.resolution_, other.origin_[DIM_X],
+         other.origin_[DIM_Y], other.origin_[DIM_Z], other.default_object_);
+  if (data_)
+    std::copy(other.data_, other.data_ + num_cells_total_, data_);
+  return *this;
+}
+
 template <typename T>
 VoxelGrid<T>::VoxelGrid() : data_(nullptr)
 {
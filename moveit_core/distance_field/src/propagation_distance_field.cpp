@@ -41,12 +41,17 @@
 #include <boost/iostreams/filter/zlib.hpp>
 #include <rclcpp/logger.hpp>
 #include <rclcpp/logging.hpp>
+#include <algorithm>
+#include <thread>
 
 namespace distance_field
 {
 // Logger
 static const rclcpp::Logger LOGGER = rclcpp::get_logger("moveit_distance_field.propagation_distance_field");
 
+// Buckets smaller than this are not worth starting threads for
+static const std::size_t MIN_PARALLEL_BUCKET_SIZE = 4096;
+
 PropagationDistanceField::PropagationDistanceField(double size_x, double size_y, double size_z, double resolution,
                                                    double origin_x, double origin_y, double origin_z,
                                                    double max_distance, bool propagate_negative)
@@ -77,6 +82,21 @@ PropagationDistanceField::PropagationDistanceField(std::istream& is, double max_
   readFromStream(is);
 }
 
+PropagationDistanceField::PropagationDistanceField(const PropagationDistanceField& other)
+  : DistanceField(other)
+  , propagate_negative_(other.propagate_negative_)
+  , voxel_grid_(std::make_shared<VoxelGrid<PropDistanceFieldVoxel>>(*other.voxel_grid_))
+  , bucket_queue_(other.bucket_queue_)
+  , negative_bucket_queue_(other.negative_bucket_queue_)
+  , max_distance_(other.max_distance_)
+  , max_distance_sq_(other.max_distance_sq_)
+  , sqrt_table_(other.sqrt_table_)
+  , neighborhoods_(other.neighborhoods_)
+  , direction_number_to_direction_(other.direction_number_to_direction_)
+  , propagation_thread_count_(other.propagation_thread_count_)
+{
+}
+
 void PropagationDistanceField::initialize()
 {
   max_distance_sq_ = ceil(max_distance_ / resolution_) * ceil(max_distance_ / resolution_);
@@ -386,6 +406,14 @@ void PropagationDistanceField::propagatePositive()
   // now process the queue:
   for (unsigned int i = 0; i < bucket_queue_.size(); ++i)
   {
+    if (propagation_thread_count_ > 1 && bucket_queue_[i].size() >= MIN_PARALLEL_BUCKET_SIZE)
+    {
+      propagateBucketParallel(bucket_queue_, i, &PropDistanceFieldVoxel::distance_square_,
+                              &PropDistanceFieldVoxel::closest_point_, &PropDistanceFieldVoxel::update_direction_);
+      bucket_queue_[i].clear();
+      continue;
+    }
+
     EigenSTL::vector_Vector3i::iterator list_it = bucket_queue_[i].begin();
     EigenSTL::vector_Vector3i::iterator list_end = bucket_queue_[i].end();
     for (; list_it != list_end; ++list_it)
@@ -442,6 +470,15 @@ void PropagationDistanceField::propagateNegative()
   // now process the queue:
   for (unsigned int i = 0; i < negative_bucket_queue_.size(); ++i)
   {
+    if (propagation_thread_count_ > 1 && negative_bucket_queue_[i].size() >= MIN_PARALLEL_BUCKET_SIZE)
+    {
+      propagateBucketParallel(negative_bucket_queue_, i, &PropDistanceFieldVoxel::negative_distance_square_,
+                              &PropDistanceFieldVoxel::closest_negative_point_,
+                              &PropDistanceFieldVoxel::negative_update_direction_);
+      negative_bucket_queue_[i].clear();
+      continue;
+    }
+
     EigenSTL::vector_Vector3i::iterator list_it = negative_bucket_queue_[i].begin();
     EigenSTL::vector_Vector3i::iterator list_end = negative_bucket_queue_[i].end();
     for (; list_it != list_end; ++list_it)
@@ -497,6 +534,89 @@ void PropagationDistanceField::propagateNegative()
   }
 }
 
+void PropagationDistanceField::propagateBucketParallel(std::vector<EigenSTL::vector_Vector3i>& queue,
+                                                       unsigned int bucket, int PropDistanceFieldVoxel::*distance_sq,
+                                                       Eigen::Vector3i PropDistanceFieldVoxel::*closest_point,
+                                                       int PropDistanceFieldVoxel::*update_direction)
+{
+  struct Update
+  {
+    Eigen::Vector3i location;
+    Eigen::Vector3i closest_point;
+    int distance_sq;
+    int direction;
+  };
+
+  const EigenSTL::vector_Vector3i& voxels = queue[bucket];
+  const std::size_t thread_count =
+      std::min<std::size_t>(propagation_thread_count_, voxels.size() / (MIN_PARALLEL_BUCKET_SIZE / 4));
+  const std::size_t slice = (voxels.size() + thread_count - 1) / thread_count;
+  const EigenSTL::vector_Vector3i* neighborhoods = &neighborhoods_[bucket > 1 ? 1 : bucket][0];
+  std::vector<std::vector<Update>> updates(thread_count);
+
+  // Voxels of this bucket are never modified while it is expanded, since all updates lead to larger distances.
+  // Collecting the candidate updates therefore only reads the grid.
+  auto collect = [&](std::size_t thread) {
+    const std::size_t end = std::min(voxels.size(), (thread + 1) * slice);
+    std::vector<Update>& thread_updates = updates[thread];
+    thread_updates.reserve(2 * slice);
+    for (std::size_t v = thread * slice; v < end; ++v)
+    {
+      const Eigen::Vector3i& loc = voxels[v];
+      const PropDistanceFieldVoxel& voxel = voxel_grid_->getCell(loc.x(), loc.y(), loc.z());
+      const int direction = voxel.*update_direction;
+      if (direction < 0 || direction > 26)
+      {
+        RCLCPP_ERROR(LOGGER, "PROGRAMMING ERROR: Invalid update direction detected: %d", direction);
+        continue;
+      }
+
+      for (const Eigen::Vector3i& diff : neighborhoods[direction])
+      {
+        Eigen::Vector3i nloc(loc.x() + diff.x(), loc.y() + diff.y(), loc.z() + diff.z());
+        if (!isCellValid(nloc.x(), nloc.y(), nloc.z()))
+          continue;
+
+        const int new_distance_sq = (voxel.*closest_point - nloc).squaredNorm();
+        if (new_distance_sq > max_distance_sq_)
+          continue;
+        if (new_distance_sq < voxel_grid_->getCell(nloc.x(), nloc.y(), nloc.z()).*distance_sq)
+          thread_updates.push_back(
+              { nloc, voxel.*closest_point, new_distance_sq, getDirectionNumber(diff.x(), diff.y(), diff.z()) });
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (std::size_t t = 1; t < thread_count; ++t)
+    threads.emplace_back(collect, t);
+  collect(0);
+  for (std::thread& thread : threads)
+    thread.join();
+
+  // apply the updates in the order of the serial propagation; earlier updates may make later ones obsolete
+  for (const std::vector<Update>& thread_updates : updates)
+  {
+    for (const Update& update : thread_updates)
+    {
+      PropDistanceFieldVoxel& neighbor =
+          voxel_grid_->getCell(update.location.x(), update.location.y(), update.location.z());
+      if (update.distance_sq < neighbor.*distance_sq)
+      {
+        neighbor.*distance_sq = update.distance_sq;
+        neighbor.*closest_point = update.closest_point;
+        neighbor.*update_direction = update.direction;
+        queue[update.distance_sq].push_back(update.location);
+      }
+    }
+  }
+}
+
+void PropagationDistanceField::setPropagationThreadCount(unsigned int thread_count)
+{
+  propagation_thread_count_ = thread_count ? thread_count : std::max(1u, std::thread::hardware_concurrency());
+}
+
 void PropagationDistanceField::reset()
 {
   voxel_grid_->reset(PropDistanceFieldVoxel(max_distance_sq_, 0));
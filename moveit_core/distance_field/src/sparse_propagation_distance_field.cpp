@@ -0,0 +1,425 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/distance_field/sparse_propagation_distance_field.h>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/filter/zlib.hpp>
+#include <rclcpp/logging.hpp>
+#include <algorithm>
+#include <bitset>
+#include <iterator>
+
+namespace distance_field
+{
+// Logger
+static const rclcpp::Logger LOGGER = rclcpp::get_logger("moveit_distance_field.sparse_propagation_distance_field");
+
+namespace
+{
+int getDirectionNumber(int dx, int dy, int dz)
+{
+  return (dx + 1) * 9 + (dy + 1) * 3 + dz + 1;
+}
+}  // namespace
+
+SparsePropagationDistanceField::SparsePropagationDistanceField(double size_x, double size_y, double size_z,
+                                                               double resolution, double origin_x, double origin_y,
+                                                               double origin_z, double max_distance)
+  : DistanceField(size_x, size_y, size_z, resolution, origin_x, origin_y, origin_z), max_distance_(max_distance)
+{
+  initialize();
+}
+
+SparsePropagationDistanceField::SparsePropagationDistanceField(std::istream& is, double max_distance)
+  : DistanceField(0, 0, 0, 0, 0, 0, 0), max_distance_(max_distance), max_distance_sq_(0)
+{
+  readFromStream(is);
+}
+
+void SparsePropagationDistanceField::initialize()
+{
+  max_distance_sq_ = ceil(max_distance_ / resolution_) * ceil(max_distance_ / resolution_);
+
+  SparseDistanceFieldVoxel empty;
+  empty.distance_square_ = max_distance_sq_;
+  empty.closest_point_ = Eigen::Vector3i::Constant(PropDistanceFieldVoxel::UNINITIALIZED);
+  empty.update_direction_ = getDirectionNumber(0, 0, 0);
+  voxel_grid_ = std::make_shared<SparseVoxelGrid<SparseDistanceFieldVoxel>>(size_x_, size_y_, size_z_, resolution_,
+                                                                             origin_x_, origin_y_, origin_z_, empty);
+
+  initNeighborhoods();
+
+  bucket_queue_.resize(max_distance_sq_ + 1);
+
+  // create a sqrt table:
+  sqrt_table_.resize(max_distance_sq_ + 1);
+  for (int i = 0; i <= max_distance_sq_; ++i)
+    sqrt_table_[i] = sqrt(double(i)) * resolution_;
+}
+
+void SparsePropagationDistanceField::initNeighborhoods()
+{
+  neighborhoods_.assign(2, std::vector<EigenSTL::vector_Vector3i>(27));
+  for (int n = 0; n < 2; ++n)
+  {
+    // source directions
+    for (int dx = -1; dx <= 1; ++dx)
+      for (int dy = -1; dy <= 1; ++dy)
+        for (int dz = -1; dz <= 1; ++dz)
+        {
+          EigenSTL::vector_Vector3i& neighborhood = neighborhoods_[n][getDirectionNumber(dx, dy, dz)];
+          // target directions:
+          for (int tdx = -1; tdx <= 1; ++tdx)
+            for (int tdy = -1; tdy <= 1; ++tdy)
+              for (int tdz = -1; tdz <= 1; ++tdz)
+              {
+                if (tdx == 0 && tdy == 0 && tdz == 0)
+                  continue;
+                if (n >= 1 && ((abs(tdx) + abs(tdy) + abs(tdz)) != 1 || dx * tdx < 0 || dy * tdy < 0 || dz * tdz < 0))
+                  continue;
+                neighborhood.push_back(Eigen::Vector3i(tdx, tdy, tdz));
+              }
+        }
+  }
+}
+
+void SparsePropagationDistanceField::updatePointsInField(const EigenSTL::vector_Vector3d& old_points,
+                                                         const EigenSTL::vector_Vector3d& new_points)
+{
+  typedef std::set<Eigen::Vector3i, CompareEigenVector3i, Eigen::aligned_allocator<Eigen::Vector3i>> VoxelSet;
+  VoxelSet old_point_set;
+  VoxelSet new_point_set;
+  Eigen::Vector3i voxel_loc;
+  for (const Eigen::Vector3d& old_point : old_points)
+  {
+    if (worldToGrid(old_point.x(), old_point.y(), old_point.z(), voxel_loc.x(), voxel_loc.y(), voxel_loc.z()))
+      old_point_set.insert(voxel_loc);
+  }
+  for (const Eigen::Vector3d& new_point : new_points)
+  {
+    if (worldToGrid(new_point.x(), new_point.y(), new_point.z(), voxel_loc.x(), voxel_loc.y(), voxel_loc.z()))
+      new_point_set.insert(voxel_loc);
+  }
+  CompareEigenVector3i comp;
+
+  EigenSTL::vector_Vector3i old_not_new;
+  std::set_difference(old_point_set.begin(), old_point_set.end(), new_point_set.begin(), new_point_set.end(),
+                      std::inserter(old_not_new, old_not_new.end()), comp);
+
+  EigenSTL::vector_Vector3i new_not_old;
+  std::set_difference(new_point_set.begin(), new_point_set.end(), old_point_set.begin(), old_point_set.end(),
+                      std::inserter(new_not_old, new_not_old.end()), comp);
+
+  EigenSTL::vector_Vector3i new_not_in_current;
+  for (const Eigen::Vector3i& loc : new_not_old)
+  {
+    if (getCell(loc.x(), loc.y(), loc.z()).distance_square_ != 0)
+      new_not_in_current.push_back(loc);
+  }
+
+  removeObstacleVoxels(old_not_new);
+  addNewObstacleVoxels(new_not_in_current);
+}
+
+void SparsePropagationDistanceField::addPointsToField(const EigenSTL::vector_Vector3d& points)
+{
+  EigenSTL::vector_Vector3i voxel_points;
+  Eigen::Vector3i voxel_loc;
+  for (const Eigen::Vector3d& point : points)
+  {
+    if (worldToGrid(point.x(), point.y(), point.z(), voxel_loc.x(), voxel_loc.y(), voxel_loc.z()) &&
+        getCell(voxel_loc.x(), voxel_loc.y(), voxel_loc.z()).distance_square_ > 0)
+      voxel_points.push_back(voxel_loc);
+  }
+  addNewObstacleVoxels(voxel_points);
+}
+
+void SparsePropagationDistanceField::removePointsFromField(const EigenSTL::vector_Vector3d& points)
+{
+  EigenSTL::vector_Vector3i voxel_points;
+  Eigen::Vector3i voxel_loc;
+  for (const Eigen::Vector3d& point : points)
+  {
+    if (worldToGrid(point.x(), point.y(), point.z(), voxel_loc.x(), voxel_loc.y(), voxel_loc.z()))
+      voxel_points.push_back(voxel_loc);
+  }
+  removeObstacleVoxels(voxel_points);
+}
+
+void SparsePropagationDistanceField::addNewObstacleVoxels(const EigenSTL::vector_Vector3i& voxel_points)
+{
+  int initial_update_direction = getDirectionNumber(0, 0, 0);
+  bucket_queue_[0].reserve(voxel_points.size());
+  for (const Eigen::Vector3i& loc : voxel_points)
+  {
+    SparseDistanceFieldVoxel& voxel = voxel_grid_->getCell(loc.x(), loc.y(), loc.z());
+    voxel.distance_square_ = 0;
+    voxel.closest_point_ = loc;
+    voxel.update_direction_ = initial_update_direction;
+    bucket_queue_[0].push_back(loc);
+  }
+  propagate();
+}
+
+void SparsePropagationDistanceField::removeObstacleVoxels(const EigenSTL::vector_Vector3i& voxel_points)
+{
+  EigenSTL::vector_Vector3i stack;
+  int initial_update_direction = getDirectionNumber(0, 0, 0);
+
+  for (const Eigen::Vector3i& loc : voxel_points)
+  {
+    // cells that were never allocated are no obstacles
+    if (!voxel_grid_->findCell(loc.x(), loc.y(), loc.z()))
+      continue;
+    SparseDistanceFieldVoxel& voxel = voxel_grid_->getCell(loc.x(), loc.y(), loc.z());
+    voxel.distance_square_ = max_distance_sq_;
+    voxel.closest_point_ = loc;
+    voxel.update_direction_ = initial_update_direction;
+    stack.push_back(loc);
+  }
+
+  // Reset all neighbors whose closest point is now gone.
+  while (!stack.empty())
+  {
+    Eigen::Vector3i loc = stack.back();
+    stack.pop_back();
+
+    for (int dx = -1; dx <= 1; ++dx)
+      for (int dy = -1; dy <= 1; ++dy)
+        for (int dz = -1; dz <= 1; ++dz)
+        {
+          Eigen::Vector3i nloc(loc.x() + dx, loc.y() + dy, loc.z() + dz);
+          // unallocated cells are at maximum distance already and have nothing to propagate
+          if (!isCellValid(nloc.x(), nloc.y(), nloc.z()) || !voxel_grid_->findCell(nloc.x(), nloc.y(), nloc.z()))
+            continue;
+
+          SparseDistanceFieldVoxel& nvoxel = voxel_grid_->getCell(nloc.x(), nloc.y(), nloc.z());
+          const Eigen::Vector3i& close_point = nvoxel.closest_point_;
+          if (isCellValid(close_point.x(), close_point.y(), close_point.z()) &&
+              getCell(close_point.x(), close_point.y(), close_point.z()).distance_square_ == 0)
+          {
+            // add to queue so we can propagate the values
+            nvoxel.update_direction_ = initial_update_direction;
+            bucket_queue_[0].push_back(nloc);
+          }
+          else if (nvoxel.distance_square_ != max_distance_sq_)
+          {
+            // closest point no longer exists
+            nvoxel.distance_square_ = max_distance_sq_;
+            nvoxel.closest_point_ = nloc;
+            nvoxel.update_direction_ = initial_update_direction;
+            stack.push_back(nloc);
+          }
+        }
+  }
+  propagate();
+}
+
+void SparsePropagationDistanceField::propagate()
+{
+  for (unsigned int i = 0; i < bucket_queue_.size(); ++i)
+  {
+    const EigenSTL::vector_Vector3i* neighborhoods = &neighborhoods_[i > 1 ? 1 : i][0];
+    for (std::size_t v = 0; v < bucket_queue_[i].size(); ++v)
+    {
+      const Eigen::Vector3i loc = bucket_queue_[i][v];
+      const SparseDistanceFieldVoxel& voxel = getCell(loc.x(), loc.y(), loc.z());
+      if (voxel.update_direction_ < 0 || voxel.update_direction_ > 26)
+      {
+        RCLCPP_ERROR(LOGGER, "PROGRAMMING ERROR: Invalid update direction detected: %d", voxel.update_direction_);
+        continue;
+      }
+
+      for (const Eigen::Vector3i& diff : neighborhoods[voxel.update_direction_])
+      {
+        Eigen::Vector3i nloc(loc.x() + diff.x(), loc.y() + diff.y(), loc.z() + diff.z());
+        if (!isCellValid(nloc.x(), nloc.y(), nloc.z()))
+          continue;
+
+        // check before touching the neighbor, so no memory is allocated beyond the maximum distance
+        int new_distance_sq = (voxel.closest_point_ - nloc).squaredNorm();
+        if (new_distance_sq > max_distance_sq_ ||
+            new_distance_sq >= getCell(nloc.x(), nloc.y(), nloc.z()).distance_square_)
+          continue;
+
+        SparseDistanceFieldVoxel& neighbor = voxel_grid_->getCell(nloc.x(), nloc.y(), nloc.z());
+        neighbor.distance_square_ = new_distance_sq;
+        neighbor.closest_point_ = voxel.closest_point_;
+        neighbor.update_direction_ = getDirectionNumber(diff.x(), diff.y(), diff.z());
+        bucket_queue_[new_distance_sq].push_back(nloc);
+      }
+    }
+    bucket_queue_[i].clear();
+  }
+}
+
+void SparsePropagationDistanceField::reset()
+{
+  voxel_grid_->reset();
+}
+
+double SparsePropagationDistanceField::getDistance(double x, double y, double z) const
+{
+  return sqrt_table_[(*voxel_grid_)(x, y, z).distance_square_];
+}
+
+double SparsePropagationDistanceField::getDistance(int x, int y, int z) const
+{
+  return sqrt_table_[getCell(x, y, z).distance_square_];
+}
+
+bool SparsePropagationDistanceField::isCellValid(int x, int y, int z) const
+{
+  return voxel_grid_->isCellValid(x, y, z);
+}
+
+int SparsePropagationDistanceField::getXNumCells() const
+{
+  return voxel_grid_->getNumCells(DIM_X);
+}
+
+int SparsePropagationDistanceField::getYNumCells() const
+{
+  return voxel_grid_->getNumCells(DIM_Y);
+}
+
+int SparsePropagationDistanceField::getZNumCells() const
+{
+  return voxel_grid_->getNumCells(DIM_Z);
+}
+
+bool SparsePropagationDistanceField::gridToWorld(int x, int y, int z, double& world_x, double& world_y,
+                                                 double& world_z) const
+{
+  voxel_grid_->gridToWorld(x, y, z, world_x, world_y, world_z);
+  return true;
+}
+
+bool SparsePropagationDistanceField::worldToGrid(double world_x, double world_y, double world_z, int& x, int& y,
+                                                 int& z) const
+{
+  return voxel_grid_->worldToGrid(world_x, world_y, world_z, x, y, z);
+}
+
+bool SparsePropagationDistanceField::writeToStream(std::ostream& os) const
+{
+  os << "resolution: " << resolution_ << '\n';
+  os << "size_x: " << size_x_ << '\n';
+  os << "size_y: " << size_y_ << '\n';
+  os << "size_z: " << size_z_ << '\n';
+  os << "origin_x: " << origin_x_ << '\n';
+  os << "origin_y: " << origin_y_ << '\n';
+  os << "origin_z: " << origin_z_ << '\n';
+
+  // the occupancy bits use the dense layout of PropagationDistanceField, so files are interchangeable
+  boost::iostreams::filtering_ostream out;
+  out.push(boost::iostreams::zlib_compressor());
+  out.push(os);
+
+  for (int x = 0; x < getXNumCells(); ++x)
+  {
+    for (int y = 0; y < getYNumCells(); ++y)
+    {
+      for (int z = 0; z < getZNumCells(); z += 8)
+      {
+        std::bitset<8> bs(0);
+        int zv = std::min(8, getZNumCells() - z);
+        for (int zi = 0; zi < zv; ++zi)
+        {
+          if (getCell(x, y, z + zi).distance_square_ == 0)
+            bs[zi] = 1;
+        }
+        out.write((char*)&bs, sizeof(char));
+      }
+    }
+  }
+  out.flush();
+  return true;
+}
+
+bool SparsePropagationDistanceField::readFromStream(std::istream& is)
+{
+  if (!is.good())
+    return false;
+
+  std::string temp;
+  const std::pair<const char*, double*> header[] = { { "resolution:", &resolution_ }, { "size_x:", &size_x_ },
+                                                     { "size_y:", &size_y_ },         { "size_z:", &size_z_ },
+                                                     { "origin_x:", &origin_x_ },     { "origin_y:", &origin_y_ },
+                                                     { "origin_z:", &origin_z_ } };
+  for (const auto& entry : header)
+  {
+    is >> temp;
+    if (temp != entry.first)
+      return false;
+    is >> *entry.second;
+  }
+
+  // the previous value of max_distance_ will be used
+  initialize();
+
+  // this should be newline
+  char nl;
+  is.get(nl);
+
+  // now we start the compressed portion
+  boost::iostreams::filtering_istream in;
+  in.push(boost::iostreams::zlib_decompressor());
+  in.push(is);
+
+  EigenSTL::vector_Vector3i obs_points;
+  for (int x = 0; x < getXNumCells(); ++x)
+  {
+    for (int y = 0; y < getYNumCells(); ++y)
+    {
+      for (int z = 0; z < getZNumCells(); z += 8)
+      {
+        char inchar;
+        if (!in.good())
+          return false;
+        in.get(inchar);
+        std::bitset<8> inbit((unsigned long long)inchar);
+        int zv = std::min(8, getZNumCells() - z);
+        for (int zi = 0; zi < zv; ++zi)
+        {
+          if (inbit[zi] == 1)
+            obs_points.push_back(Eigen::Vector3i(x, y, z + zi));
+        }
+      }
+    }
+  }
+  addNewObstacleVoxels(obs_points);
+  return true;
+}
+}  // namespace distance_field
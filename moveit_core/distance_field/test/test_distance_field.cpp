@@ -38,6 +38,7 @@
 
 #include <moveit/distance_field/voxel_grid.h>
 #include <moveit/distance_field/propagation_distance_field.h>
+#include <moveit/distance_field/sparse_propagation_distance_field.h>
 #include <moveit/distance_field/find_internal_points.h>
 #include <geometric_shapes/body_operations.h>
 #if __has_include(<tf2_eigen/tf2_eigen.hpp>)
@@ -977,6 +978,110 @@ TEST(TestSignedPropagationDistanceField, TestReadWrite)
   EXPECT_FALSE(areDistanceFieldsDistancesEqual(df, df3));
 }
 
+TEST(TestSignedPropagationDistanceField, TestParallelPropagation)
+{
+  PropagationDistanceField serial_df(1.0, 1.0, 1.0, 0.01, 0.0, 0.0, 0.0, PERF_MAX_DIST, true);
+  PropagationDistanceField parallel_df(1.0, 1.0, 1.0, 0.01, 0.0, 0.0, 0.0, PERF_MAX_DIST, true);
+  parallel_df.setPropagationThreadCount(4);
+  EXPECT_EQ(parallel_df.getPropagationThreadCount(), 4u);
+
+  // a plane of obstacle points creates wavefronts that are large enough to be split across threads
+  EigenSTL::vector_Vector3d points;
+  for (double x = 0.2; x < 0.8; x += 0.01)
+    for (double y = 0.2; y < 0.8; y += 0.01)
+      for (double z = 0.45; z < 0.55; z += 0.01)
+        points.push_back(Eigen::Vector3d(x, y, z));
+  std::srand(42);
+  EigenSTL::vector_Vector3d random_points;
+  for (unsigned int i = 0; i < 200; ++i)
+    random_points.push_back(Eigen::Vector3d(std::rand() / (double)RAND_MAX, std::rand() / (double)RAND_MAX,
+                                            std::rand() / (double)RAND_MAX));
+  points.insert(points.end(), random_points.begin(), random_points.end());
+
+  auto expect_equal_fields = [&]() {
+    for (int x = 0; x < serial_df.getXNumCells(); ++x)
+      for (int y = 0; y < serial_df.getYNumCells(); ++y)
+        for (int z = 0; z < serial_df.getZNumCells(); ++z)
+        {
+          const PropDistanceFieldVoxel& serial = serial_df.getCell(x, y, z);
+          const PropDistanceFieldVoxel& parallel = parallel_df.getCell(x, y, z);
+          ASSERT_EQ(serial.distance_square_, parallel.distance_square_) << x << " " << y << " " << z;
+          ASSERT_EQ(serial.negative_distance_square_, parallel.negative_distance_square_) << x << " " << y << " " << z;
+          ASSERT_EQ(serial.closest_point_, parallel.closest_point_) << x << " " << y << " " << z;
+          ASSERT_EQ(serial.closest_negative_point_, parallel.closest_negative_point_) << x << " " << y << " " << z;
+        }
+  };
+
+  serial_df.addPointsToField(points);
+  parallel_df.addPointsToField(points);
+  expect_equal_fields();
+
+  serial_df.removePointsFromField(random_points);
+  parallel_df.removePointsFromField(random_points);
+  expect_equal_fields();
+}
+
+TEST(TestSparsePropagationDistanceField, TestMatchesDense)
+{
+  PropagationDistanceField dense_df(1.0, 1.2, 0.8, 0.02, 0.0, 0.0, 0.0, 0.2, false);
+  SparsePropagationDistanceField sparse_df(1.0, 1.2, 0.8, 0.02, 0.0, 0.0, 0.0, 0.2);
+
+  std::srand(42);
+  EigenSTL::vector_Vector3d points;
+  for (unsigned int i = 0; i < 100; ++i)
+    points.push_back(Eigen::Vector3d(std::rand() / (double)RAND_MAX, 1.2 * std::rand() / (double)RAND_MAX,
+                                     0.8 * std::rand() / (double)RAND_MAX));
+  EigenSTL::vector_Vector3d removed(points.begin(), points.begin() + 30);
+  EigenSTL::vector_Vector3d moved(points.begin() + 30, points.begin() + 60);
+  EigenSTL::vector_Vector3d moved_to = moved;
+  for (Eigen::Vector3d& point : moved_to)
+    point.x() *= 0.9;
+
+  auto expect_equal_fields = [&]() {
+    for (int x = 0; x < dense_df.getXNumCells(); ++x)
+      for (int y = 0; y < dense_df.getYNumCells(); ++y)
+        for (int z = 0; z < dense_df.getZNumCells(); ++z)
+          ASSERT_EQ(dense_df.getCell(x, y, z).distance_square_, sparse_df.getCell(x, y, z).distance_square_)
+              << x << " " << y << " " << z;
+  };
+
+  dense_df.addPointsToField(points);
+  sparse_df.addPointsToField(points);
+  expect_equal_fields();
+
+  dense_df.removePointsFromField(removed);
+  sparse_df.removePointsFromField(removed);
+  expect_equal_fields();
+
+  dense_df.updatePointsInField(moved, moved_to);
+  sparse_df.updatePointsInField(moved, moved_to);
+  expect_equal_fields();
+
+  EXPECT_EQ(sparse_df.getDistance(-1.0, 0.5, 0.5), sparse_df.getUninitializedDistance());
+}
+
+TEST(TestSparsePropagationDistanceField, TestMemoryScalesWithObstacles)
+{
+  // a 10m x 10m x 2m workspace with a single small box
+  SparsePropagationDistanceField df(10.0, 10.0, 2.0, 0.02, 0.0, 0.0, 0.0, 0.1);
+  EXPECT_EQ(df.getAllocatedCellCount(), 0u);
+  EXPECT_NEAR(df.getDistance(5.0, 5.0, 1.0), 0.1, 1e-9);
+
+  shapes::Box box(0.2, 0.2, 0.2);
+  df.addShapeToField(&box, Eigen::Isometry3d(Eigen::Translation3d(5.0, 5.0, 1.0)));
+  EXPECT_EQ(df.getDistance(5.0, 5.0, 1.0), 0.0);
+  EXPECT_NEAR(df.getDistance(5.16, 5.0, 1.0), 0.06, 0.021);
+  EXPECT_NEAR(df.getDistance(1.0, 1.0, 1.0), 0.1, 1e-9);
+
+  const std::size_t num_cells = static_cast<std::size_t>(df.getXNumCells()) * df.getYNumCells() * df.getZNumCells();
+  EXPECT_GT(df.getAllocatedCellCount(), 0u);
+  EXPECT_LT(df.getAllocatedCellCount() * 100, num_cells);
+
+  df.reset();
+  EXPECT_EQ(df.getAllocatedCellCount(), 0u);
+  EXPECT_NEAR(df.getDistance(5.0, 5.0, 1.0), 0.1, 1e-9);
+}
+
 int main(int argc, char** argv)
 {
   testing::InitGoogleTest(&argc, argv);
@@ -41,6 +41,7 @@
 #include <kdl/chainidsolver_recursive_newton_euler.hpp>
 
 #include <moveit/robot_state/robot_state.h>
+#include <moveit/robot_trajectory/robot_trajectory.h>
 #include <geometry_msgs/msg/vector3.hpp>
 #include <geometry_msgs/msg/wrench.hpp>
 #include <memory>
@@ -87,6 +88,20 @@ public:
                   const std::vector<double>& joint_accelerations,
                   const std::vector<geometry_msgs::msg::Wrench>& wrenches, std::vector<double>& torques) const;
 
+  /**
+   * @brief Get the torques for every waypoint of a trajectory, without external wrenches.
+   * The positions, velocities and accelerations of the group are read from each waypoint; missing velocities or
+   * accelerations are taken as zero. Waypoints are split across threads and every thread reuses its own
+   * preallocated KDL workspace, so this is much cheaper than calling getTorques() per waypoint.
+   * @param trajectory The trajectory to evaluate
+   * @param torques Resized to trajectory.size() * number of joints in the group. The torques of waypoint k
+   * occupy the range [k * n, (k + 1) * n), in the order of joints for this group in the RobotModel
+   * @param thread_count The number of threads to use (0 uses the hardware concurrency)
+   * @return False if the solver was not constructed properly or the inverse dynamics failed for any waypoint
+   */
+  bool getTorquesTrajectory(const robot_trajectory::RobotTrajectory& trajectory, std::vector<double>& torques,
+                            std::size_t thread_count = 0) const;
+
   /**
    * @brief Get the maximum payload for this group (in kg). Payload is
    * the weight that this group can hold when the weight is attached to the origin
@@ -146,6 +161,7 @@ private:
   unsigned int num_joints_, num_segments_;  // number of joints in group, number of segments in group
   std::vector<double> max_torques_;         // vector of max torques
 
-  double gravity_;  // Norm of the gravity vector passed in initialize()
+  KDL::Vector gravity_vector_;  // Gravity vector passed in initialize()
+  double gravity_;              // Norm of the gravity vector passed in initialize()
 };
 }  // namespace dynamics_solver
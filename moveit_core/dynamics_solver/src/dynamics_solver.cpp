@@ -41,6 +41,9 @@
 #include <kdl/tree.hpp>
 #include <rclcpp/logger.hpp>
 #include <rclcpp/logging.hpp>
+#include <algorithm>
+#include <atomic>
+#include <thread>
 
 namespace dynamics_solver
 {
@@ -132,12 +135,12 @@ DynamicsSolver::DynamicsSolver(const moveit::core::RobotModelConstPtr& robot_mod
       max_torques_.push_back(0.0);
   }
 
-  KDL::Vector gravity(gravity_vector.x, gravity_vector.y,
-                      gravity_vector.z);  // \todo Not sure if KDL expects the negative of this (Sachin)
-  gravity_ = gravity.Norm();
+  gravity_vector_ = KDL::Vector(gravity_vector.x, gravity_vector.y,
+                                gravity_vector.z);  // \todo Not sure if KDL expects the negative of this (Sachin)
+  gravity_ = gravity_vector_.Norm();
   RCLCPP_DEBUG(LOGGER, "Gravity norm set to %f", gravity_);
 
-  chain_id_solver_ = std::make_shared<KDL::ChainIdSolver_RNE>(kdl_chain_, gravity);
+  chain_id_solver_ = std::make_shared<KDL::ChainIdSolver_RNE>(kdl_chain_, gravity_vector_);
 }
 
 bool DynamicsSolver::getTorques(const std::vector<double>& joint_angles, const std::vector<double>& joint_velocities,
@@ -211,6 +214,73 @@ bool DynamicsSolver::getTorques(const std::vector<double>& joint_angles, const s
   return true;
 }
 
+bool DynamicsSolver::getTorquesTrajectory(const robot_trajectory::RobotTrajectory& trajectory,
+                                          std::vector<double>& torques, std::size_t thread_count) const
+{
+  if (!joint_model_group_)
+  {
+    RCLCPP_DEBUG(LOGGER, "Did not construct DynamicsSolver object properly. "
+                         "Check error logs.");
+    return false;
+  }
+  if (joint_model_group_->getVariableCount() != num_joints_)
+  {
+    RCLCPP_ERROR(LOGGER, "Group '%s' has %u variables but the KDL chain has %u joints",
+                 joint_model_group_->getName().c_str(), joint_model_group_->getVariableCount(), num_joints_);
+    return false;
+  }
+
+  const std::size_t count = trajectory.getWayPointCount();
+  torques.resize(count * num_joints_);
+  if (count == 0)
+    return true;
+
+  if (thread_count == 0)
+    thread_count = std::max(1u, std::thread::hardware_concurrency());
+  thread_count = std::min(thread_count, count);
+
+  std::atomic<bool> success(true);
+  auto evaluate = [&](std::size_t begin, std::size_t end) {
+    // The RNE solver keeps its recursion state in members, so each thread needs its own instance
+    KDL::ChainIdSolver_RNE solver(kdl_chain_, gravity_vector_);
+    KDL::JntArray kdl_angles(num_joints_), kdl_velocities(num_joints_), kdl_accelerations(num_joints_),
+        kdl_torques(num_joints_);
+    const KDL::Wrenches kdl_wrenches(num_segments_, KDL::Wrench::Zero());
+
+    for (std::size_t k = begin; k < end; ++k)
+    {
+      const moveit::core::RobotState& waypoint = trajectory.getWayPoint(k);
+      waypoint.copyJointGroupPositions(joint_model_group_, kdl_angles.data.data());
+      if (waypoint.hasVelocities())
+        waypoint.copyJointGroupVelocities(joint_model_group_, kdl_velocities.data.data());
+      else
+        kdl_velocities.data.setZero();
+      if (waypoint.hasAccelerations())
+        waypoint.copyJointGroupAccelerations(joint_model_group_, kdl_accelerations.data.data());
+      else
+        kdl_accelerations.data.setZero();
+
+      if (solver.CartToJnt(kdl_angles, kdl_velocities, kdl_accelerations, kdl_wrenches, kdl_torques) < 0)
+      {
+        RCLCPP_ERROR(LOGGER, "Something went wrong computing torques for waypoint %zu", k);
+        success = false;
+        return;
+      }
+      std::copy(kdl_torques.data.data(), kdl_torques.data.data() + num_joints_, torques.begin() + k * num_joints_);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(thread_count - 1);
+  for (std::size_t t = 1; t < thread_count; ++t)
+    threads.emplace_back(evaluate, t * count / thread_count, (t + 1) * count / thread_count);
+  evaluate(0, count / thread_count);
+  for (std::thread& thread : threads)
+    thread.join();
+
+  return success;
+}
+
 bool DynamicsSolver::getMaxPayload(const std::vector<double>& joint_angles, double& payload,
                                    unsigned int& joint_saturated) const
 {
@@ -108,6 +108,19 @@ public:
    */
   virtual ConstraintEvaluationResult decide(const moveit::core::RobotState& state, bool verbose = false) const = 0;
 
+  /**
+   * \brief Decide whether the constraint is satisfied in each of the indicated states
+   *
+   * The default implementation calls decide() once per state. Constraint types override it to
+   * hoist the work that does not depend on the state out of the per-state loop.
+   *
+   * @param [in] states The kinematic states used for evaluation
+   * @param [out] results One evaluation result per state, in the order of \e states
+   * @param [in] verbose Whether or not to print output
+   */
+  virtual void decideBatch(const std::vector<const moveit::core::RobotState*>& states,
+                           std::vector<ConstraintEvaluationResult>& results, bool verbose = false) const;
+
   /** \brief This function returns true if this constraint is
       configured and able to decide whether states do meet the
       constraint or not. If this function returns false it means
@@ -396,6 +409,15 @@ public:
 
   void clear() override;
   ConstraintEvaluationResult decide(const moveit::core::RobotState& state, bool verbose = false) const override;
+
+  /**
+   * \brief Decide the constraint for a batch of states
+   *
+   * The link orientations of all states are gathered into one contiguous matrix and brought into the
+   * constraint frame at once; the per-state work left is the tolerance check.
+   */
+  void decideBatch(const std::vector<const moveit::core::RobotState*>& states,
+                   std::vector<ConstraintEvaluationResult>& results, bool verbose = false) const override;
   bool enabled() const override;
   void print(std::ostream& out = std::cout) const override;
 
@@ -484,6 +506,18 @@ public:
   }
 
 protected:
+  /**
+   * \brief Compute the absolute rotation error per axis from the rotation between desired and actual orientation
+   *
+   * @param [in] diff Rotation of the link relative to the desired orientation
+   *
+   * @return The error per axis in the configured parameterization
+   */
+  Eigen::Vector3d computeRotationError(const Eigen::Matrix3d& diff) const;
+
+  /** \brief Whether a rotation error computed by computeRotationError() lies within the tolerances */
+  bool withinTolerance(const Eigen::Vector3d& xyz_rotation) const;
+
   const moveit::core::LinkModel* link_model_;   /**< \brief The target link model */
   Eigen::Matrix3d desired_rotation_matrix_;     /**< \brief The desired rotation matrix in the tf frame. Guaranteed to
                                                  * be valid rotation matrix. */
@@ -572,6 +606,15 @@ public:
 
   void clear() override;
   ConstraintEvaluationResult decide(const moveit::core::RobotState& state, bool verbose = false) const override;
+
+  /**
+   * \brief Decide the constraint for a batch of states
+   *
+   * The link positions of all states are gathered into one contiguous matrix and brought into the
+   * constraint frame at once; the per-state work left is the tolerance check.
+   */
+  void decideBatch(const std::vector<const moveit::core::RobotState*>& states,
+                   std::vector<ConstraintEvaluationResult>& results, bool verbose = false) const override;
   bool enabled() const override;
   void print(std::ostream& out = std::cout) const override;
 
@@ -842,6 +885,29 @@ protected:
    */
   bool decideContact(const collision_detection::Contact& contact) const;
 
+  /**
+   * \brief Conservative test whether the cone can touch the robot.
+   *
+   * Tests the bounding spheres of the link shapes against the planes of the
+   * cone approximation, so no mesh needs to be built.
+   *
+   * @param [in] state The state to test
+   * @param [in] sensor The sensor pose in the state
+   * @param [in] target The target pose in the state
+   *
+   * @return False if no link that decideContact() does not accept can touch the cone
+   */
+  bool mayTouchRobot(const moveit::core::RobotState& state, const Eigen::Isometry3d& sensor,
+                     const Eigen::Isometry3d& target) const;
+
+  /** \brief Bounding sphere of a collision shape of a link, in the link frame */
+  struct LinkShapeSphere
+  {
+    const moveit::core::LinkModel* link;
+    Eigen::Vector3d center;
+    double radius;
+  };
+
   collision_detection::CollisionEnvPtr collision_env_; /**< \brief A copy of the collision robot maintained for
                                                               collision checking the cone against robot links */
   bool mobile_sensor_frame_;      /**< \brief True if the sensor is a non-fixed frame relative to the transform frame */
@@ -856,6 +922,9 @@ protected:
   double target_radius_;             /**< \brief Storage for the target radius */
   double max_view_angle_;            /**< \brief Storage for the max view angle */
   double max_range_angle_;           /**< \brief Storage for the max range angle */
+  std::vector<LinkShapeSphere> link_shape_spheres_; /**< \brief The shapes the cone is tested against */
+  mutable shapes::ShapeConstPtr cone_mesh_;         /**< \brief The cone in the collision world, in the sensor frame */
+  mutable Eigen::Isometry3d cone_target_pose_;      /**< \brief The target pose relative to the sensor of cone_mesh_ */
 };
 
 MOVEIT_CLASS_FORWARD(KinematicConstraintSet);  // Defines KinematicConstraintSetPtr, ConstPtr, WeakPtr... etc
@@ -973,6 +1042,33 @@ public:
   ConstraintEvaluationResult decide(const moveit::core::RobotState& state,
                                     std::vector<ConstraintEvaluationResult>& results, bool verbose = false) const;
 
+  /**
+   * \brief Determines for each state of a batch, e.g. the waypoints of a
+   * trajectory, whether all constraints are satisfied.
+   *
+   * Constraints are evaluated one at a time over the whole batch through
+   * KinematicConstraint::decideBatch(). A state that violates a constraint
+   * is not evaluated against the remaining constraints, so its distance only
+   * sums the constraints up to and including the violated one.
+   *
+   * @param [in] states The states to test
+   *
+   * @param [out] results One summed result per state, in the order of \e states
+   *
+   * @param [out] first_violated For each state the index of the first
+   * violated constraint in the set, or -1 if the state satisfies all of them.
+   *
+   * @param [in] verbose Whether to print the results of each constraint
+   * check.
+   *
+   * @return A single constraint evaluation result, where it will report
+   * satisfied only if all states satisfy all constraints, and with a
+   * distance that is the sum of all per-state distances.
+   */
+  ConstraintEvaluationResult decide(const std::vector<const moveit::core::RobotState*>& states,
+                                    std::vector<ConstraintEvaluationResult>& results, std::vector<int>& first_violated,
+                                    bool verbose = false) const;
+
   /**
    * \brief Whether or not another KinematicConstraintSet is equal to
    * this one.
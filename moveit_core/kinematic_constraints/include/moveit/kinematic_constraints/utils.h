@@ -42,6 +42,8 @@
 #include <geometry_msgs/msg/quaternion_stamped.hpp>
 #include <moveit/robot_state/robot_state.h>
 #include <limits>
+#include <mutex>
+#include <unordered_map>
 
 namespace XmlRpc
 {
@@ -241,4 +243,42 @@ bool constructConstraints(const rclcpp::Node::SharedPtr& node, const std::string
  * @param [in] constraints The constraint to resolve.
  */
 bool resolveConstraintFrames(const moveit::core::RobotState& state, moveit_msgs::msg::Constraints& constraints);
+
+/**
+ * \brief Resolves frames used in constraints like resolveConstraintFrames(),
+ * remembering the robot link and the offset of every frame it resolved.
+ *
+ * The offsets of attached bodies and their subframes only change together
+ * with the attached bodies, so every call passes a version of the attached
+ * bodies, e.g. planning_scene::PlanningScene::getAttachedBodiesVersion().
+ * The remembered frames are dropped when the version changes. An instance can
+ * be shared by concurrent callers.
+ */
+class ConstraintFrameResolver
+{
+public:
+  /**
+   * \brief Resolve the frames in \e constraints to robot links.
+   *
+   * @param [in] state The RobotState used to resolve frames that are not known yet.
+   * @param [in] attached_bodies_version The version of the bodies attached to \e state.
+   * @param [in] constraints The constraint to resolve.
+   *
+   * @return False if a frame is not known in \e state.
+   */
+  bool resolve(const moveit::core::RobotState& state, std::uint64_t attached_bodies_version,
+               moveit_msgs::msg::Constraints& constraints);
+
+private:
+  struct ResolvedFrame
+  {
+    const moveit::core::LinkModel* link;
+    Eigen::Isometry3d link_to_frame;
+  };
+
+  std::mutex mutex_;
+  std::uint64_t attached_bodies_version_ = 0;
+  bool has_version_ = false;
+  std::unordered_map<std::string, ResolvedFrame> frames_;
+};
 }  // namespace kinematic_constraints
@@ -52,6 +52,7 @@
 #include <limits>
 #include <math.h>
 #include <memory>
+#include <numeric>
 #include <typeinfo>
 
 #include "rclcpp/clock.hpp"
@@ -131,6 +132,14 @@ KinematicConstraint::KinematicConstraint(const moveit::core::RobotModelConstPtr&
 
 KinematicConstraint::~KinematicConstraint() = default;
 
+void KinematicConstraint::decideBatch(const std::vector<const moveit::core::RobotState*>& states,
+                                      std::vector<ConstraintEvaluationResult>& results, bool verbose) const
+{
+  results.resize(states.size());
+  for (std::size_t i = 0; i < states.size(); ++i)
+    results[i] = decide(*states[i], verbose);
+}
+
 bool JointConstraint::configure(const moveit_msgs::msg::JointConstraint& jc)
 {
   // clearing before we configure to get rid of any old data
@@ -535,6 +544,47 @@ ConstraintEvaluationResult PositionConstraint::decide(const moveit::core::RobotS
   return ConstraintEvaluationResult(false, 0.0);
 }
 
+void PositionConstraint::decideBatch(const std::vector<const moveit::core::RobotState*>& states,
+                                     std::vector<ConstraintEvaluationResult>& results, bool verbose) const
+{
+  // the verbose output reports world coordinates, which only the per-state evaluation computes
+  if (!link_model_ || constraint_region_.empty() || verbose)
+  {
+    KinematicConstraint::decideBatch(states, results, verbose);
+    return;
+  }
+
+  // For a mobile frame the points are expressed in the constraint frame instead of moving the
+  // regions to every state, so the regions can be tested at their configured poses
+  Eigen::Matrix3Xd points(3, states.size());
+  for (std::size_t i = 0; i < states.size(); ++i)
+  {
+    points.col(i) = states[i]->getGlobalLinkTransform(link_model_) * offset_;
+    if (mobile_frame_)
+    {
+      // getFrameTransform() returns a valid isometry by contract
+      const Eigen::Isometry3d& frame = states[i]->getFrameTransform(constraint_frame_id_);
+      points.col(i) = frame.linear().transpose() * (points.col(i) - frame.translation());
+    }
+  }
+
+  results.resize(states.size());
+  for (std::size_t i = 0; i < states.size(); ++i)
+  {
+    const Eigen::Vector3d pt = points.col(i);
+    for (std::size_t j = 0; j < constraint_region_.size(); ++j)
+    {
+      bool result = constraint_region_[j]->containsPoint(pt);
+      if (result || (j + 1 == constraint_region_.size()))
+      {
+        results[i] = ConstraintEvaluationResult(
+            result, constraint_weight_ * (constraint_region_pose_[j].translation() - pt).norm());
+        break;
+      }
+    }
+  }
+}
+
 void PositionConstraint::print(std::ostream& out) const
 {
   if (enabled())
@@ -690,12 +740,33 @@ ConstraintEvaluationResult OrientationConstraint::decide(const moveit::core::Rob
     diff = Eigen::Isometry3d(desired_rotation_matrix_inv_ * state.getGlobalLinkTransform(link_model_).linear());
   }
 
+  const Eigen::Vector3d xyz_rotation = computeRotationError(diff.linear());
+
+  bool result = withinTolerance(xyz_rotation);
+
+  if (verbose)
+  {
+    Eigen::Quaterniond q_act(state.getGlobalLinkTransform(link_model_).linear());
+    Eigen::Quaterniond q_des(desired_rotation_matrix_);
+    RCLCPP_INFO(LOGGER,
+                "Orientation constraint %s for link '%s'. Quaternion desired: %f %f %f %f, quaternion "
+                "actual: %f %f %f %f, error: x=%f, y=%f, z=%f, tolerance: x=%f, y=%f, z=%f",
+                result ? "satisfied" : "violated", link_model_->getName().c_str(), q_des.x(), q_des.y(), q_des.z(),
+                q_des.w(), q_act.x(), q_act.y(), q_act.z(), q_act.w(), xyz_rotation(0), xyz_rotation(1),
+                xyz_rotation(2), absolute_x_axis_tolerance_, absolute_y_axis_tolerance_, absolute_z_axis_tolerance_);
+  }
+
+  return ConstraintEvaluationResult(result, constraint_weight_ * (xyz_rotation(0) + xyz_rotation(1) + xyz_rotation(2)));
+}
+
+Eigen::Vector3d OrientationConstraint::computeRotationError(const Eigen::Matrix3d& diff) const
+{
   // This needs to live outside the if-block scope (as xyz_rotation points to its data).
   std::tuple<Eigen::Vector3d, bool> euler_angles_error;
   Eigen::Vector3d xyz_rotation;
   if (parameterization_type_ == moveit_msgs::msg::OrientationConstraint::XYZ_EULER_ANGLES)
   {
-    euler_angles_error = CalcEulerAngles(diff.linear());
+    euler_angles_error = CalcEulerAngles(diff);
     // Converting from a rotation matrix to intrinsic XYZ Euler angles has 2 singularities:
     // pitch ~= pi/2 ==> roll + yaw = theta
     // pitch ~= -pi/2 ==> roll - yaw = theta
@@ -716,7 +787,7 @@ ConstraintEvaluationResult OrientationConstraint::decide(const moveit::core::Rob
   }
   else if (parameterization_type_ == moveit_msgs::msg::OrientationConstraint::ROTATION_VECTOR)
   {
-    Eigen::AngleAxisd aa(diff.linear());
+    Eigen::AngleAxisd aa(diff);
     xyz_rotation = aa.axis() * aa.angle();
     xyz_rotation(0) = fabs(xyz_rotation(0));
     xyz_rotation(1) = fabs(xyz_rotation(1));
@@ -727,24 +798,52 @@ ConstraintEvaluationResult OrientationConstraint::decide(const moveit::core::Rob
     /* The parameterization type should be validated in configure, so this should never happen. */
     RCLCPP_ERROR(LOGGER, "The parameterization type for the orientation constraints is invalid.");
   }
+  return xyz_rotation;
+}
 
-  bool result = xyz_rotation(2) < absolute_z_axis_tolerance_ + std::numeric_limits<double>::epsilon() &&
-                xyz_rotation(1) < absolute_y_axis_tolerance_ + std::numeric_limits<double>::epsilon() &&
-                xyz_rotation(0) < absolute_x_axis_tolerance_ + std::numeric_limits<double>::epsilon();
+bool OrientationConstraint::withinTolerance(const Eigen::Vector3d& xyz_rotation) const
+{
+  return xyz_rotation(2) < absolute_z_axis_tolerance_ + std::numeric_limits<double>::epsilon() &&
+         xyz_rotation(1) < absolute_y_axis_tolerance_ + std::numeric_limits<double>::epsilon() &&
+         xyz_rotation(0) < absolute_x_axis_tolerance_ + std::numeric_limits<double>::epsilon();
+}
 
-  if (verbose)
+void OrientationConstraint::decideBatch(const std::vector<const moveit::core::RobotState*>& states,
+                                        std::vector<ConstraintEvaluationResult>& results, bool verbose) const
+{
+  if (!link_model_ || verbose)
   {
-    Eigen::Quaterniond q_act(state.getGlobalLinkTransform(link_model_).linear());
-    Eigen::Quaterniond q_des(desired_rotation_matrix_);
-    RCLCPP_INFO(LOGGER,
-                "Orientation constraint %s for link '%s'. Quaternion desired: %f %f %f %f, quaternion "
-                "actual: %f %f %f %f, error: x=%f, y=%f, z=%f, tolerance: x=%f, y=%f, z=%f",
-                result ? "satisfied" : "violated", link_model_->getName().c_str(), q_des.x(), q_des.y(), q_des.z(),
-                q_des.w(), q_act.x(), q_act.y(), q_act.z(), q_act.w(), xyz_rotation(0), xyz_rotation(1),
-                xyz_rotation(2), absolute_x_axis_tolerance_, absolute_y_axis_tolerance_, absolute_z_axis_tolerance_);
+    KinematicConstraint::decideBatch(states, results, verbose);
+    return;
   }
 
-  return ConstraintEvaluationResult(result, constraint_weight_ * (xyz_rotation(0) + xyz_rotation(1) + xyz_rotation(2)));
+  // The link rotations are laid out side by side so a fixed frame rotates the whole batch in one product
+  const Eigen::Index n = static_cast<Eigen::Index>(states.size());
+  Eigen::Matrix<double, 3, Eigen::Dynamic> rotations(3, 3 * n);
+  for (Eigen::Index i = 0; i < n; ++i)
+  {
+    // getGlobalLinkTransform() returns a valid isometry by contract
+    const Eigen::Matrix3d& link = states[i]->getGlobalLinkTransform(link_model_).linear();
+    if (mobile_frame_)
+    {
+      // getFrameTransform() returns a valid isometry by contract
+      Eigen::Matrix3d tmp =
+          states[i]->getFrameTransform(desired_rotation_frame_id_).linear() * desired_rotation_matrix_;
+      rotations.middleCols<3>(3 * i).noalias() = tmp.transpose() * link;
+    }
+    else
+      rotations.middleCols<3>(3 * i) = link;
+  }
+  if (!mobile_frame_)
+    rotations = desired_rotation_matrix_inv_ * rotations;
+
+  results.resize(states.size());
+  for (Eigen::Index i = 0; i < n; ++i)
+  {
+    const Eigen::Vector3d xyz_rotation = computeRotationError(rotations.middleCols<3>(3 * i));
+    results[i] = ConstraintEvaluationResult(withinTolerance(xyz_rotation),
+                                            constraint_weight_ * (xyz_rotation(0) + xyz_rotation(1) + xyz_rotation(2)));
+  }
 }
 
 void OrientationConstraint::print(std::ostream& out) const
@@ -779,6 +878,10 @@ void VisibilityConstraint::clear()
   target_radius_ = -1.0;
   max_view_angle_ = 0.0;
   max_range_angle_ = 0.0;
+  link_shape_spheres_.clear();
+  if (cone_mesh_)
+    collision_env_->getWorld()->removeObject("cone");
+  cone_mesh_.reset();
 }
 
 bool VisibilityConstraint::configure(const moveit_msgs::msg::VisibilityConstraint& vc,
@@ -857,6 +960,22 @@ bool VisibilityConstraint::configure(const moveit_msgs::msg::VisibilityConstrain
   max_range_angle_ = vc.max_range_angle;
   sensor_view_direction_ = vc.sensor_view_direction;
 
+  // contacts of the cone with the sensor or target links are accepted by decideContact()
+  for (const moveit::core::LinkModel* link : robot_model_->getLinkModelsWithCollisionGeometry())
+  {
+    if (moveit::core::Transforms::sameFrame(link->getName(), sensor_frame_id_) ||
+        moveit::core::Transforms::sameFrame(link->getName(), target_frame_id_))
+      continue;
+    for (std::size_t i = 0; i < link->getShapes().size(); ++i)
+    {
+      LinkShapeSphere sphere;
+      sphere.link = link;
+      shapes::computeShapeBoundingSphere(link->getShapes()[i].get(), sphere.center, sphere.radius);
+      sphere.center = link->getCollisionOriginTransforms()[i] * sphere.center;
+      link_shape_spheres_.push_back(sphere);
+    }
+  }
+
   return target_radius_ > std::numeric_limits<double>::epsilon();
 }
 
@@ -1108,12 +1227,40 @@ ConstraintEvaluationResult VisibilityConstraint::decide(const moveit::core::Robo
     }
   }
 
-  shapes::Mesh* m = getVisibilityCone(state);
-  if (!m)
-    return ConstraintEvaluationResult(false, 0.0);
+  // getFrameTransform() returns a valid isometry by contract
+  const Eigen::Isometry3d sp =
+      mobile_sensor_frame_ ? state.getFrameTransform(sensor_frame_id_) * sensor_pose_ : sensor_pose_;
+  const Eigen::Isometry3d tp =
+      mobile_target_frame_ ? state.getFrameTransform(target_frame_id_) * target_pose_ : target_pose_;
+  if (!mayTouchRobot(state, sp, tp))
+  {
+    if (verbose)
+      RCLCPP_INFO(LOGGER, "Visibility constraint satisfied. The visibility cone is clear of all robot links.");
+    return ConstraintEvaluationResult(true, 0.0);
+  }
 
-  // add the visibility cone as an object
-  collision_env_->getWorld()->addToObject("cone", shapes::ShapeConstPtr(m), Eigen::Isometry3d::Identity());
+  // The cone stays in the collision world expressed in the sensor frame, so as long as the target does not move
+  // relative to the sensor only its pose is updated
+  const Eigen::Isometry3d target_in_sensor = sp.inverse() * tp;
+  if (cone_mesh_ && target_in_sensor.isApprox(cone_target_pose_, 1e-9))
+    collision_env_->getWorld()->setObjectPose("cone", sp);
+  else
+  {
+    shapes::Mesh* m = getVisibilityCone(state);
+    if (!m)
+      return ConstraintEvaluationResult(false, 0.0);
+    const Eigen::Isometry3d world_to_sensor = sp.inverse();
+    for (unsigned int i = 0; i < m->vertex_count; ++i)
+    {
+      Eigen::Map<Eigen::Vector3d> vertex(m->vertices + 3 * i);
+      vertex = world_to_sensor * Eigen::Vector3d(vertex);
+    }
+    if (cone_mesh_)
+      collision_env_->getWorld()->removeObject("cone");
+    cone_mesh_.reset(m);
+    cone_target_pose_ = target_in_sensor;
+    collision_env_->getWorld()->addToObject("cone", sp, cone_mesh_, Eigen::Isometry3d::Identity());
+  }
 
   // check for collisions between the robot and the cone
   collision_detection::CollisionRequest req;
@@ -1132,16 +1279,56 @@ ConstraintEvaluationResult VisibilityConstraint::decide(const moveit::core::Robo
   if (verbose)
   {
     std::stringstream ss;
-    m->print(ss);
-    RCLCPP_INFO(LOGGER, "Visibility constraint %ssatisfied. Visibility cone approximation:\n %s",
+    cone_mesh_->print(ss);
+    RCLCPP_INFO(LOGGER, "Visibility constraint %ssatisfied. Visibility cone approximation in the sensor frame:\n %s",
                 res.collision ? "not " : "", ss.str().c_str());
   }
 
-  collision_env_->getWorld()->removeObject("cone");
-
   return ConstraintEvaluationResult(!res.collision, res.collision ? res.contacts.begin()->second.front().depth : 0.0);
 }
 
+bool VisibilityConstraint::mayTouchRobot(const moveit::core::RobotState& state, const Eigen::Isometry3d& sensor,
+                                         const Eigen::Isometry3d& target) const
+{
+  // the corners of the cone approximation built by getVisibilityCone()
+  const Eigen::Vector3d& apex = sensor.translation();
+  EigenSTL::vector_Vector3d base(points_.size());
+  for (std::size_t i = 0; i < points_.size(); ++i)
+    base[i] = mobile_target_frame_ ? target * points_[i] : points_[i];
+
+  // Planes of the faces, with normals pointing out of the cone. Degenerate faces are skipped, which only makes the
+  // test more conservative.
+  const Eigen::Vector3d inside = 0.5 * (apex + target.translation());
+  EigenSTL::vector_Vector3d normals;
+  std::vector<double> offsets;
+  const auto add_plane = [&](const Eigen::Vector3d& a, const Eigen::Vector3d& b, const Eigen::Vector3d& c) {
+    Eigen::Vector3d normal = (b - a).cross(c - a);
+    const double norm = normal.norm();
+    if (norm < std::numeric_limits<double>::epsilon())
+      return;
+    normal /= norm;
+    if (normal.dot(inside - a) > 0.0)
+      normal = -normal;
+    normals.push_back(normal);
+    offsets.push_back(normal.dot(a));
+  };
+  for (std::size_t i = 0; i < base.size(); ++i)
+    add_plane(apex, base[i], base[(i + 1) % base.size()]);
+  add_plane(base[0], base[1], base[2]);
+
+  // a shape is clear of the cone if its bounding sphere lies entirely outside one of the face planes
+  for (const LinkShapeSphere& sphere : link_shape_spheres_)
+  {
+    const Eigen::Vector3d center = state.getGlobalLinkTransform(sphere.link) * sphere.center;
+    bool separated = false;
+    for (std::size_t i = 0; !separated && i < normals.size(); ++i)
+      separated = normals[i].dot(center) - offsets[i] > sphere.radius;
+    if (!separated)
+      return true;
+  }
+  return false;
+}
+
 bool VisibilityConstraint::decideContact(const collision_detection::Contact& contact) const
 {
   if (contact.body_type_1 == collision_detection::BodyTypes::ROBOT_ATTACHED ||
@@ -1289,6 +1476,51 @@ ConstraintEvaluationResult KinematicConstraintSet::decide(const moveit::core::Ro
   return result;
 }
 
+ConstraintEvaluationResult KinematicConstraintSet::decide(const std::vector<const moveit::core::RobotState*>& states,
+                                                          std::vector<ConstraintEvaluationResult>& results,
+                                                          std::vector<int>& first_violated, bool verbose) const
+{
+  results.assign(states.size(), ConstraintEvaluationResult(true, 0.0));
+  first_violated.assign(states.size(), -1);
+
+  // states still satisfying all constraints evaluated so far, with their index into the batch
+  std::vector<const moveit::core::RobotState*> pending(states);
+  std::vector<std::size_t> pending_index(states.size());
+  std::iota(pending_index.begin(), pending_index.end(), 0);
+
+  std::vector<ConstraintEvaluationResult> constraint_results;
+  for (std::size_t i = 0; i < kinematic_constraints_.size() && !pending.empty(); ++i)
+  {
+    kinematic_constraints_[i]->decideBatch(pending, constraint_results, verbose);
+    std::size_t kept = 0;
+    for (std::size_t j = 0; j < pending.size(); ++j)
+    {
+      ConstraintEvaluationResult& r = results[pending_index[j]];
+      r.distance += constraint_results[j].distance;
+      if (constraint_results[j].satisfied)
+      {
+        pending[kept] = pending[j];
+        pending_index[kept++] = pending_index[j];
+      }
+      else
+      {
+        r.satisfied = false;
+        first_violated[pending_index[j]] = static_cast<int>(i);
+      }
+    }
+    pending.resize(kept);
+    pending_index.resize(kept);
+  }
+
+  ConstraintEvaluationResult result(true, 0.0);
+  for (const ConstraintEvaluationResult& r : results)
+  {
+    result.satisfied = result.satisfied && r.satisfied;
+    result.distance += r.distance;
+  }
+  return result;
+}
+
 void KinematicConstraintSet::print(std::ostream& out) const
 {
   out << kinematic_constraints_.size() << " kinematic constraints" << '\n';
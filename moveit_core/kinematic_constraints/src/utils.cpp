@@ -53,6 +53,7 @@
 #else
 #include <tf2_eigen/tf2_eigen.h>
 #endif
+#include <functional>
 
 using namespace moveit::core;
 
@@ -543,22 +544,27 @@ bool constructConstraints(const rclcpp::Node::SharedPtr& node, const std::string
 }
 }  // namespace kinematic_constraints
 
-bool kinematic_constraints::resolveConstraintFrames(const moveit::core::RobotState& state,
-                                                    moveit_msgs::msg::Constraints& constraints)
+namespace kinematic_constraints
+{
+namespace
+{
+// Express the constraints in robot links, using \e resolve_frame to find the robot link of a frame and the offset of
+// the frame relative to that link.
+bool applyResolvedFrames(
+    moveit_msgs::msg::Constraints& constraints,
+    const std::function<bool(const std::string&, const moveit::core::LinkModel*&, Eigen::Isometry3d&)>& resolve_frame)
 {
+  const moveit::core::LinkModel* robot_link;
+  Eigen::Isometry3d robot_link_to_link_name;
   for (auto& c : constraints.position_constraints)
   {
-    bool frame_found;
-    const moveit::core::LinkModel* robot_link;
-    const Eigen::Isometry3d& transform = state.getFrameInfo(c.link_name, robot_link, frame_found);
-    if (!frame_found)
+    if (!resolve_frame(c.link_name, robot_link, robot_link_to_link_name))
       return false;
 
     // If the frame of the constraint is not part of the robot link model (but an attached body or subframe),
     // the constraint needs to be expressed in the frame of a robot link.
     if (c.link_name != robot_link->getName())
     {
-      Eigen::Isometry3d robot_link_to_link_name = state.getGlobalLinkTransform(robot_link).inverse() * transform;
       Eigen::Vector3d offset_link_name(c.target_point_offset.x, c.target_point_offset.y, c.target_point_offset.z);
       Eigen::Vector3d offset_robot_link = robot_link_to_link_name * offset_link_name;
 
@@ -569,11 +575,7 @@ bool kinematic_constraints::resolveConstraintFrames(const moveit::core::RobotSta
 
   for (auto& c : constraints.orientation_constraints)
   {
-    bool frame_found;
-    const moveit::core::LinkModel* robot_link;
-    // getFrameInfo() returns a valid isometry by contract
-    const Eigen::Isometry3d& transform = state.getFrameInfo(c.link_name, robot_link, frame_found);
-    if (!frame_found)
+    if (!resolve_frame(c.link_name, robot_link, robot_link_to_link_name))
       return false;
 
     // If the frame of the constraint is not part of the robot link model (but an attached body or subframe),
@@ -581,8 +583,7 @@ bool kinematic_constraints::resolveConstraintFrames(const moveit::core::RobotSta
     if (c.link_name != robot_link->getName())
     {
       c.link_name = robot_link->getName();
-      Eigen::Quaterniond link_name_to_robot_link(transform.linear().transpose() *
-                                                 state.getGlobalLinkTransform(robot_link).linear());
+      Eigen::Quaterniond link_name_to_robot_link(robot_link_to_link_name.linear().transpose());
       Eigen::Quaterniond quat_target;
       tf2::fromMsg(c.orientation, quat_target);
       c.orientation = tf2::toMsg(quat_target * link_name_to_robot_link);
@@ -590,3 +591,52 @@ bool kinematic_constraints::resolveConstraintFrames(const moveit::core::RobotSta
   }
   return true;
 }
+
+bool resolveFrame(const moveit::core::RobotState& state, const std::string& frame,
+                  const moveit::core::LinkModel*& robot_link, Eigen::Isometry3d& robot_link_to_frame)
+{
+  bool frame_found;
+  // getFrameInfo() returns a valid isometry by contract
+  const Eigen::Isometry3d& transform = state.getFrameInfo(frame, robot_link, frame_found);
+  if (!frame_found)
+    return false;
+  robot_link_to_frame = state.getGlobalLinkTransform(robot_link).inverse() * transform;
+  return true;
+}
+}  // namespace
+
+bool resolveConstraintFrames(const moveit::core::RobotState& state, moveit_msgs::msg::Constraints& constraints)
+{
+  return applyResolvedFrames(constraints, [&state](const std::string& frame, const moveit::core::LinkModel*& link,
+                                                   Eigen::Isometry3d& link_to_frame) {
+    return resolveFrame(state, frame, link, link_to_frame);
+  });
+}
+
+bool ConstraintFrameResolver::resolve(const moveit::core::RobotState& state, std::uint64_t attached_bodies_version,
+                                      moveit_msgs::msg::Constraints& constraints)
+{
+  std::scoped_lock lock(mutex_);
+  if (!has_version_ || attached_bodies_version != attached_bodies_version_)
+  {
+    frames_.clear();
+    attached_bodies_version_ = attached_bodies_version;
+    has_version_ = true;
+  }
+
+  return applyResolvedFrames(constraints, [this, &state](const std::string& frame, const moveit::core::LinkModel*& link,
+                                                         Eigen::Isometry3d& link_to_frame) {
+    const auto it = frames_.find(frame);
+    if (it != frames_.end())
+    {
+      link = it->second.link;
+      link_to_frame = it->second.link_to_frame;
+      return true;
+    }
+    if (!resolveFrame(state, frame, link, link_to_frame))
+      return false;
+    frames_[frame] = ResolvedFrame{ link, link_to_frame };
+    return true;
+  });
+}
+}  // namespace kinematic_constraints
@@ -35,6 +35,8 @@
 /* Author: Ioan Sucan, E. Gil Jones */
 
 #include <moveit/kinematic_constraints/kinematic_constraint.h>
+#include <moveit/kinematic_constraints/utils.h>
+#include <geometric_shapes/shapes.h>
 #include <gtest/gtest.h>
 #include <urdf_parser/urdf_parser.h>
 #include <fstream>
@@ -793,6 +795,60 @@ TEST_F(LoadPlanningModelsPr2, VisibilityConstraintsPR2)
   EXPECT_FALSE(vc.decide(robot_state, true).satisfied);
 }
 
+TEST_F(LoadPlanningModelsPr2, VisibilityConstraintsAlongPath)
+{
+  moveit::core::RobotState robot_state(robot_model_);
+  robot_state.setToDefaultValues();
+  robot_state.update();
+  moveit::core::Transforms tf(robot_model_->getModelFrame());
+
+  moveit_msgs::msg::VisibilityConstraint vcm;
+  vcm.sensor_pose.header.frame_id = "narrow_stereo_optical_frame";
+  vcm.sensor_pose.pose.position.z = 0.05;
+  vcm.sensor_pose.pose.orientation.w = 1.0;
+  vcm.target_pose.header.frame_id = "l_gripper_r_finger_tip_link";
+  vcm.target_pose.pose.position.z = 0.03;
+  vcm.target_pose.pose.orientation.w = 1.0;
+  vcm.target_radius = .05;
+  vcm.cone_sides = 10;
+  vcm.sensor_view_direction = moveit_msgs::msg::VisibilityConstraint::SENSOR_Z;
+  vcm.weight = 1.0;
+
+  kinematic_constraints::VisibilityConstraint vc(robot_model_);
+  EXPECT_TRUE(vc.configure(vcm, tf));
+
+  // The right arm sweeps through the cone. A constraint that is reused along the path has to agree with a freshly
+  // configured one in every state.
+  std::map<std::string, double> state_values;
+  state_values["l_shoulder_lift_joint"] = .5;
+  state_values["r_elbow_flex_joint"] = -1.4;
+  bool seen_satisfied = false;
+  bool seen_violated = false;
+  for (double pan = 0.0; pan < 0.8; pan += 0.05)
+  {
+    state_values["r_shoulder_pan_joint"] = pan;
+    robot_state.setVariablePositions(state_values);
+    robot_state.update();
+
+    kinematic_constraints::VisibilityConstraint fresh(robot_model_);
+    EXPECT_TRUE(fresh.configure(vcm, tf));
+    const bool satisfied = fresh.decide(robot_state).satisfied;
+    EXPECT_EQ(vc.decide(robot_state).satisfied, satisfied) << "r_shoulder_pan_joint = " << pan;
+    seen_satisfied = seen_satisfied || satisfied;
+    seen_violated = seen_violated || !satisfied;
+  }
+  EXPECT_TRUE(seen_satisfied);
+  EXPECT_TRUE(seen_violated);
+
+  // moving the target relative to the sensor rebuilds the cone
+  state_values["l_shoulder_lift_joint"] = 0.0;
+  state_values["r_shoulder_pan_joint"] = .5;
+  state_values["r_elbow_flex_joint"] = -.6;
+  robot_state.setVariablePositions(state_values);
+  robot_state.update();
+  EXPECT_TRUE(vc.decide(robot_state).satisfied);
+}
+
 TEST_F(LoadPlanningModelsPr2, TestKinematicConstraintSet)
 {
   moveit::core::RobotState robot_state(robot_model_);
@@ -859,6 +915,168 @@ TEST_F(LoadPlanningModelsPr2, TestKinematicConstraintSet)
   EXPECT_FALSE(kcs.decide(robot_state).satisfied);
 }
 
+TEST_F(LoadPlanningModelsPr2, TestKinematicConstraintSetBatch)
+{
+  moveit::core::RobotState robot_state(robot_model_);
+  robot_state.setToDefaultValues();
+  robot_state.update();
+  moveit::core::Transforms tf(robot_model_->getModelFrame());
+
+  kinematic_constraints::KinematicConstraintSet kcs(robot_model_);
+
+  moveit_msgs::msg::Constraints constraints;
+  constraints.joint_constraints.resize(1);
+  constraints.joint_constraints[0].joint_name = "head_pan_joint";
+  constraints.joint_constraints[0].position = 0.0;
+  constraints.joint_constraints[0].tolerance_above = 0.1;
+  constraints.joint_constraints[0].tolerance_below = 0.1;
+  constraints.joint_constraints[0].weight = 1.0;
+
+  geometry_msgs::msg::Pose p = tf2::toMsg(robot_state.getGlobalLinkTransform("r_wrist_roll_link"));
+  constraints.orientation_constraints.resize(1);
+  constraints.orientation_constraints[0].link_name = "r_wrist_roll_link";
+  constraints.orientation_constraints[0].header.frame_id = robot_model_->getModelFrame();
+  constraints.orientation_constraints[0].orientation = p.orientation;
+  constraints.orientation_constraints[0].absolute_x_axis_tolerance = 0.1;
+  constraints.orientation_constraints[0].absolute_y_axis_tolerance = 0.1;
+  constraints.orientation_constraints[0].absolute_z_axis_tolerance = 0.1;
+  constraints.orientation_constraints[0].weight = 1.0;
+
+  // a box around the wrist, expressed in the mobile torso frame
+  Eigen::Isometry3d torso_to_wrist = robot_state.getGlobalLinkTransform("torso_lift_link").inverse() *
+                                     robot_state.getGlobalLinkTransform("r_wrist_roll_link");
+  constraints.position_constraints.resize(1);
+  constraints.position_constraints[0].link_name = "r_wrist_roll_link";
+  constraints.position_constraints[0].header.frame_id = "torso_lift_link";
+  constraints.position_constraints[0].constraint_region.primitives.resize(1);
+  constraints.position_constraints[0].constraint_region.primitives[0].type = shape_msgs::msg::SolidPrimitive::BOX;
+  constraints.position_constraints[0].constraint_region.primitives[0].dimensions = { 0.2, 0.2, 0.2 };
+  constraints.position_constraints[0].constraint_region.primitive_poses.resize(1);
+  constraints.position_constraints[0].constraint_region.primitive_poses[0] = tf2::toMsg(torso_to_wrist);
+  constraints.position_constraints[0].weight = 1.0;
+
+  EXPECT_TRUE(kcs.add(constraints, tf));
+
+  // states that satisfy all constraints, violate the joint constraint, rotate the wrist or move the whole arm
+  std::vector<moveit::core::RobotState> waypoints(4, robot_state);
+  waypoints[1].setVariablePosition("head_pan_joint", 0.5);
+  waypoints[2].setVariablePosition("r_wrist_roll_joint", 0.5);
+  waypoints[3].setVariablePosition("r_shoulder_pan_joint", 0.3);
+  for (moveit::core::RobotState& waypoint : waypoints)
+    waypoint.update();
+
+  std::vector<const moveit::core::RobotState*> states;
+  for (const moveit::core::RobotState& waypoint : waypoints)
+    states.push_back(&waypoint);
+
+  std::vector<kinematic_constraints::ConstraintEvaluationResult> results;
+  std::vector<int> first_violated;
+  EXPECT_FALSE(kcs.decide(states, results, first_violated).satisfied);
+  ASSERT_EQ(results.size(), states.size());
+  ASSERT_EQ(first_violated.size(), states.size());
+
+  for (std::size_t i = 0; i < states.size(); ++i)
+  {
+    std::vector<kinematic_constraints::ConstraintEvaluationResult> single;
+    kinematic_constraints::ConstraintEvaluationResult expected = kcs.decide(*states[i], single);
+    EXPECT_EQ(results[i].satisfied, expected.satisfied);
+
+    // the batch stops evaluating a state at its first violated constraint
+    int expected_violation = -1;
+    double expected_distance = 0.0;
+    for (std::size_t j = 0; j < single.size() && expected_violation < 0; ++j)
+    {
+      expected_distance += single[j].distance;
+      if (!single[j].satisfied)
+        expected_violation = static_cast<int>(j);
+    }
+    EXPECT_EQ(first_violated[i], expected_violation);
+    EXPECT_NEAR(results[i].distance, expected_distance, 1e-9);
+  }
+  EXPECT_TRUE(results[0].satisfied);
+  EXPECT_FALSE(results[1].satisfied);
+  EXPECT_FALSE(results[2].satisfied);
+  EXPECT_FALSE(results[3].satisfied);
+
+  // a batch of satisfying states is satisfied as a whole
+  states = { &waypoints[0], &waypoints[0] };
+  EXPECT_TRUE(kcs.decide(states, results, first_violated).satisfied);
+  EXPECT_EQ(first_violated, std::vector<int>(2, -1));
+}
+
+TEST_F(LoadPlanningModelsPr2, ConstraintFrameResolver)
+{
+  moveit::core::RobotState robot_state(robot_model_);
+  robot_state.setToDefaultValues();
+  robot_state.update();
+
+  const auto attach = [&robot_state](double x) {
+    robot_state.clearAttachedBody("object");
+    moveit::core::FixedTransformsMap subframes;
+    subframes["tip"] = Eigen::Translation3d(0.0, 0.0, 0.05) * Eigen::AngleAxisd(M_PI / 2, Eigen::Vector3d::UnitZ());
+    robot_state.attachBody("object", Eigen::Isometry3d(Eigen::Translation3d(x, 0.0, 0.0)),
+                           { std::make_shared<const shapes::Box>(0.1, 0.1, 0.1) }, { Eigen::Isometry3d::Identity() },
+                           std::set<std::string>(), "r_wrist_roll_link", trajectory_msgs::msg::JointTrajectory(),
+                           subframes);
+    robot_state.update();
+  };
+  attach(0.1);
+
+  moveit_msgs::msg::Constraints constraints;
+  constraints.position_constraints.resize(1);
+  constraints.position_constraints[0].link_name = "object/tip";
+  constraints.position_constraints[0].target_point_offset.x = 0.01;
+  constraints.orientation_constraints.resize(1);
+  constraints.orientation_constraints[0].link_name = "object/tip";
+  constraints.orientation_constraints[0].orientation.w = 1.0;
+
+  const auto expect_resolved_like = [](const moveit_msgs::msg::Constraints& actual,
+                                       const moveit_msgs::msg::Constraints& expected) {
+    EXPECT_EQ(actual.position_constraints[0].link_name, "r_wrist_roll_link");
+    EXPECT_EQ(actual.position_constraints[0].link_name, expected.position_constraints[0].link_name);
+    EXPECT_NEAR(actual.position_constraints[0].target_point_offset.x,
+                expected.position_constraints[0].target_point_offset.x, 1e-9);
+    EXPECT_NEAR(actual.position_constraints[0].target_point_offset.y,
+                expected.position_constraints[0].target_point_offset.y, 1e-9);
+    EXPECT_NEAR(actual.position_constraints[0].target_point_offset.z,
+                expected.position_constraints[0].target_point_offset.z, 1e-9);
+    EXPECT_EQ(actual.orientation_constraints[0].link_name, expected.orientation_constraints[0].link_name);
+    Eigen::Quaterniond q_actual, q_expected;
+    tf2::fromMsg(actual.orientation_constraints[0].orientation, q_actual);
+    tf2::fromMsg(expected.orientation_constraints[0].orientation, q_expected);
+    EXPECT_NEAR(q_actual.angularDistance(q_expected), 0.0, 1e-9);
+  };
+
+  moveit_msgs::msg::Constraints expected = constraints;
+  EXPECT_TRUE(kinematic_constraints::resolveConstraintFrames(robot_state, expected));
+
+  kinematic_constraints::ConstraintFrameResolver resolver;
+  moveit_msgs::msg::Constraints resolved = constraints;
+  EXPECT_TRUE(resolver.resolve(robot_state, 1, resolved));
+  expect_resolved_like(resolved, expected);
+
+  // the arm pose does not matter, only the attached bodies do
+  robot_state.setVariablePosition("r_shoulder_pan_joint", 0.5);
+  robot_state.update();
+  resolved = constraints;
+  EXPECT_TRUE(resolver.resolve(robot_state, 1, resolved));
+  expect_resolved_like(resolved, expected);
+
+  // a new version of the attached bodies resolves the frames again
+  attach(0.2);
+  expected = constraints;
+  EXPECT_TRUE(kinematic_constraints::resolveConstraintFrames(robot_state, expected));
+  EXPECT_NEAR(expected.position_constraints[0].target_point_offset.x, 0.2, 1e-9);
+  resolved = constraints;
+  EXPECT_TRUE(resolver.resolve(robot_state, 2, resolved));
+  expect_resolved_like(resolved, expected);
+
+  // unknown frames cannot be resolved
+  resolved = constraints;
+  resolved.position_constraints[0].link_name = "object/no_such_subframe";
+  EXPECT_FALSE(resolver.resolve(robot_state, 2, resolved));
+}
+
 TEST_F(LoadPlanningModelsPr2, TestKinematicConstraintSetEquality)
 {
   moveit::core::RobotState robot_state(robot_model_);
@@ -112,6 +112,8 @@ struct KinematicsQueryOptions
     : lock_redundant_joints(false)
     , return_approximate_solution(false)
     , discretization_method(DiscretizationMethods::NO_DISCRETIZATION)
+    , parallel_restarts(0)
+    , rank_by_seed_distance(false)
   {
   }
 
@@ -119,6 +121,10 @@ struct KinematicsQueryOptions
   bool return_approximate_solution;           /**<  KinematicsQueryOptions#return_approximate_solution. */
   DiscretizationMethod discretization_method; /**<  Enumeration value that indicates the method for discretizing the
                                                     redundant. joints KinematicsQueryOptions#discretization_method. */
+  unsigned int parallel_restarts; /**<  Number of threads searching random restarts concurrently, the first solution
+                                        wins; 0 or 1 searches sequentially. Ignored by solvers without restarts. */
+  bool rank_by_seed_distance;     /**<  With parallel_restarts, wait for a solution of every thread (or the timeout)
+                                        and return the one closest to the seed instead of the first one. */
 };
 
 /*
@@ -366,6 +372,26 @@ public:
     return false;
   }
 
+  /**
+   * @brief Solve many independent single-tip IK queries in one call, e.g. for reachability maps or goal sampling.
+   *
+   * Every pose is solved as with searchPositionIK() for a single pose. The default implementation does exactly that
+   * in a loop; solvers may override it to reuse their workspace across poses and to solve them concurrently.
+   * @param ik_poses the desired pose of the tip link for each query
+   * @param ik_seed_states an initial guess for each pose, or a single one used for all poses
+   * @param timeout_per_pose The amount of time (in seconds) available to the solver for each pose
+   * @param solutions resized to the number of poses, the solution for each pose (undefined if it failed)
+   * @param error_codes resized to the number of poses, the result for each pose
+   * @param options container for other IK options. See definition of KinematicsQueryOptions for details.
+   * @return True if a valid solution was found for every pose, false otherwise
+   */
+  virtual bool
+  searchPositionIKBatch(const std::vector<geometry_msgs::msg::Pose>& ik_poses,
+                        const std::vector<std::vector<double> >& ik_seed_states, double timeout_per_pose,
+                        std::vector<std::vector<double> >& solutions,
+                        std::vector<moveit_msgs::msg::MoveItErrorCodes>& error_codes,
+                        const kinematics::KinematicsQueryOptions& options = kinematics::KinematicsQueryOptions()) const;
+
   /**
    * @brief Given a set of joint angles and a set of links, compute their pose
    * @param link_names A set of links for which FK needs to be computed
@@ -590,6 +616,48 @@ protected:
   std::map<int, double> redundant_joint_discretization_;
   std::vector<DiscretizationMethod> supported_methods_;
 
+  /**
+   * @brief Check the arguments of searchPositionIKBatch() and resize its outputs
+   * @return False, with all error codes set to INVALID_ROBOT_STATE, if the number of seeds does not match the poses
+   */
+  bool prepareBatch(const std::vector<geometry_msgs::msg::Pose>& ik_poses,
+                    const std::vector<std::vector<double> >& ik_seed_states,
+                    std::vector<std::vector<double> >& solutions,
+                    std::vector<moveit_msgs::msg::MoveItErrorCodes>& error_codes) const;
+
+  /**
+   * @brief Solve the queries [0, count) of a batch on up to std::thread::hardware_concurrency() threads.
+   *
+   * Every thread calls \e make_solver once and then solves its share of the queries with the returned function,
+   * so the solver can keep per-thread workspace, e.g. KDL solvers or a random number generator.
+   */
+  static void solveBatchConcurrently(std::size_t count,
+                                     const std::function<std::function<void(std::size_t)>()>& make_solver);
+
+  /**
+   * @brief One thread of searchRestartsConcurrently().
+   *
+   * Searches from the seed if \e from_seed is true, otherwise from random restarts only, until it finds a solution
+   * passing \e solution_callback, times out or \e stop returns true.
+   */
+  using RestartSearchFn = std::function<bool(bool from_seed, const IKCallbackFn& solution_callback,
+                                             const std::function<bool()>& stop, std::vector<double>& solution,
+                                             moveit_msgs::msg::MoveItErrorCodes& error_code)>;
+
+  /**
+   * @brief Run the random-restart search of searchPositionIK() on options.parallel_restarts threads.
+   *
+   * Every thread calls \e make_search once and runs the returned search; the first thread starts from the seed.
+   * The first solution cancels the other threads, unless options.rank_by_seed_distance requests the solution closest
+   * to \e ik_seed_state. \e solution_callback is called by one thread at a time.
+   */
+  static bool searchRestartsConcurrently(const std::vector<double>& ik_seed_state,
+                                         const IKCallbackFn& solution_callback,
+                                         const KinematicsQueryOptions& options,
+                                         const std::function<RestartSearchFn()>& make_search,
+                                         std::vector<double>& solution,
+                                         moveit_msgs::msg::MoveItErrorCodes& error_code);
+
   /**
    * @brief Enables kinematics plugins access to parameters that are defined
    * for the private namespace and inside 'robot_description_kinematics'.
@@ -37,6 +37,12 @@
 #include <moveit/kinematics_base/kinematics_base.h>
 #include <moveit/robot_model/joint_model_group.h>
 #include <rclcpp/logger.hpp>
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace kinematics
 {
@@ -150,6 +156,120 @@ KinematicsBase::KinematicsBase() : default_timeout_(DEFAULT_TIMEOUT)
 
 KinematicsBase::~KinematicsBase() = default;
 
+bool KinematicsBase::searchPositionIKBatch(const std::vector<geometry_msgs::msg::Pose>& ik_poses,
+                                          const std::vector<std::vector<double> >& ik_seed_states,
+                                          double timeout_per_pose, std::vector<std::vector<double> >& solutions,
+                                          std::vector<moveit_msgs::msg::MoveItErrorCodes>& error_codes,
+                                          const KinematicsQueryOptions& options) const
+{
+  if (!prepareBatch(ik_poses, ik_seed_states, solutions, error_codes))
+    return false;
+
+  bool all_solved = true;
+  for (std::size_t i = 0; i < ik_poses.size(); ++i)
+  {
+    const std::vector<double>& seed = ik_seed_states.size() == 1 ? ik_seed_states[0] : ik_seed_states[i];
+    all_solved &= searchPositionIK(ik_poses[i], seed, timeout_per_pose, solutions[i], error_codes[i], options);
+  }
+  return all_solved;
+}
+
+bool KinematicsBase::prepareBatch(const std::vector<geometry_msgs::msg::Pose>& ik_poses,
+                                  const std::vector<std::vector<double> >& ik_seed_states,
+                                  std::vector<std::vector<double> >& solutions,
+                                  std::vector<moveit_msgs::msg::MoveItErrorCodes>& error_codes) const
+{
+  solutions.resize(ik_poses.size());
+  error_codes.resize(ik_poses.size());
+  if (ik_seed_states.size() != 1 && ik_seed_states.size() != ik_poses.size())
+  {
+    RCLCPP_ERROR(LOGGER, "Expected one seed state or one per pose (%zu) instead of %zu", ik_poses.size(),
+                 ik_seed_states.size());
+    for (moveit_msgs::msg::MoveItErrorCodes& error_code : error_codes)
+      error_code.val = moveit_msgs::msg::MoveItErrorCodes::INVALID_ROBOT_STATE;
+    return false;
+  }
+  return true;
+}
+
+void KinematicsBase::solveBatchConcurrently(std::size_t count,
+                                            const std::function<std::function<void(std::size_t)>()>& make_solver)
+{
+  std::atomic<std::size_t> next{ 0 };
+  auto solve_next = [&]() {
+    const std::function<void(std::size_t)> solve = make_solver();
+    for (std::size_t i = next++; i < count; i = next++)
+      solve(i);
+  };
+
+  std::vector<std::thread> threads;
+  for (std::size_t i = 1; i < std::min<std::size_t>(std::max(1u, std::thread::hardware_concurrency()), count); ++i)
+    threads.emplace_back(solve_next);
+  solve_next();
+  for (std::thread& thread : threads)
+    thread.join();
+}
+
+bool KinematicsBase::searchRestartsConcurrently(const std::vector<double>& ik_seed_state,
+                                                const IKCallbackFn& solution_callback,
+                                                const KinematicsQueryOptions& options,
+                                                const std::function<RestartSearchFn()>& make_search,
+                                                std::vector<double>& solution,
+                                                moveit_msgs::msg::MoveItErrorCodes& error_code)
+{
+  // Callbacks like the one of RobotState::setFromIK() modify shared state, so they are never called concurrently
+  std::mutex callback_mutex;
+  IKCallbackFn serialized_callback;
+  if (solution_callback)
+    serialized_callback = [&](const geometry_msgs::msg::Pose& ik_pose, const std::vector<double>& candidate,
+                              moveit_msgs::msg::MoveItErrorCodes& candidate_error_code) {
+      std::lock_guard<std::mutex> lock(callback_mutex);
+      solution_callback(ik_pose, candidate, candidate_error_code);
+    };
+
+  std::mutex result_mutex;
+  std::atomic<bool> done{ false };
+  bool found = false;
+  double best_distance = std::numeric_limits<double>::infinity();
+  error_code.val = moveit_msgs::msg::MoveItErrorCodes::TIMED_OUT;
+  auto run_search = [&](bool from_seed) {
+    const RestartSearchFn search = make_search();
+    std::vector<double> candidate;
+    moveit_msgs::msg::MoveItErrorCodes candidate_error_code;
+    const bool solved =
+        search(from_seed, serialized_callback, [&done]() { return done.load(); }, candidate, candidate_error_code);
+
+    std::lock_guard<std::mutex> lock(result_mutex);
+    if (!solved)
+    {
+      if (!found)
+        error_code = candidate_error_code;
+      return;
+    }
+    double distance = 0.0;
+    if (options.rank_by_seed_distance)
+      for (std::size_t i = 0; i < candidate.size() && i < ik_seed_state.size(); ++i)
+        distance += (candidate[i] - ik_seed_state[i]) * (candidate[i] - ik_seed_state[i]);
+    if (!found || distance < best_distance)
+    {
+      found = true;
+      best_distance = distance;
+      solution.swap(candidate);
+      error_code = candidate_error_code;
+    }
+    if (!options.rank_by_seed_distance)
+      done = true;
+  };
+
+  std::vector<std::thread> threads;
+  for (unsigned int i = 1; i < options.parallel_restarts; ++i)
+    threads.emplace_back(run_search, false);
+  run_search(true);
+  for (std::thread& thread : threads)
+    thread.join();
+  return found;
+}
+
 bool KinematicsBase::getPositionIK(const std::vector<geometry_msgs::msg::Pose>& ik_poses,
                                    const std::vector<double>& ik_seed_state,
                                    std::vector<std::vector<double> >& solutions, KinematicsResult& result,
@@ -37,12 +37,33 @@
 #pragma once
 
 #include <moveit/robot_state/robot_state.h>
+#include <functional>
+#include <vector>
+
+namespace robot_trajectory
+{
+class RobotTrajectory;
+}
 
 /** @brief Namespace for kinematics metrics */
 namespace kinematics_metrics
 {
 MOVEIT_CLASS_FORWARD(KinematicsMetrics);  // Defines KinematicsMetricsPtr, ConstPtr, WeakPtr... etc
 
+/** @brief Manipulability measures of a sequence of states, one entry per state */
+struct ManipulabilityBatch
+{
+  /** @brief The manipulability index, as computed by getManipulabilityIndex() */
+  std::vector<double> manipulability_index;
+
+  /** @brief sigma_min/sigma_max, as computed by getManipulability() */
+  std::vector<double> manipulability;
+
+  /** @brief The smallest singular value of the Jacobian, without joint limits penalty. Goes to zero towards
+      singularities */
+  std::vector<double> min_singular_value;
+};
+
 /**
  * \brief Compute different kinds of metrics for kinematics evaluation. Currently includes
  * manipulability.
@@ -124,6 +145,35 @@ public:
   bool getManipulability(const moveit::core::RobotState& state, const moveit::core::JointModelGroup* joint_model_group,
                          double& condition_number, bool translation = false) const;
 
+  /**
+   * @brief Compute the manipulability measures of all waypoints of a trajectory
+   *
+   * Waypoints are evaluated in parallel, every thread reuses one state and Jacobian. The singular values are
+   * obtained from the eigenvalues of the (at most 6x6) Gram matrix of the Jacobian instead of an SVD.
+   * @param trajectory A trajectory of a chain group
+   * @param metrics The measures of every waypoint
+   * @param translation Only consider the translation part of the Jacobian
+   * @param thread_count Number of threads to use, 0 to use all workers of the shared task scheduler
+   * @return False if the trajectory has no group or the group is not a chain
+   */
+  bool getManipulabilityBatch(const robot_trajectory::RobotTrajectory& trajectory, ManipulabilityBatch& metrics,
+                              bool translation = false, std::size_t thread_count = 0) const;
+
+  /**
+   * @brief Compute the manipulability measures of many configurations of a group
+   * @param reference_state Provides the values of the variables outside of the group
+   * @param joint_model_group A chain group
+   * @param group_positions Positions of the variables of the group for every configuration, one after the other
+   * @param metrics The measures of every configuration
+   * @param translation Only consider the translation part of the Jacobian
+   * @param thread_count Number of threads to use, 0 to use all workers of the shared task scheduler
+   * @return False if the group is not a chain or \e group_positions is not a multiple of its variable count
+   */
+  bool getManipulabilityBatch(const moveit::core::RobotState& reference_state,
+                              const moveit::core::JointModelGroup* joint_model_group,
+                              const std::vector<double>& group_positions, ManipulabilityBatch& metrics,
+                              bool translation = false, std::size_t thread_count = 0) const;
+
   void setPenaltyMultiplier(double multiplier)
   {
     penalty_multiplier_ = fabs(multiplier);
@@ -153,6 +203,12 @@ private:
   double getJointLimitsPenalty(const moveit::core::RobotState& state,
                                const moveit::core::JointModelGroup* joint_model_group) const;
 
+  /** @brief Evaluate \e count states in parallel, \e set_state brings the scratch state of a thread to state \e i */
+  void computeManipulabilityBatch(const moveit::core::RobotState& reference_state,
+                                  const moveit::core::JointModelGroup* joint_model_group, std::size_t count,
+                                  const std::function<void(std::size_t, moveit::core::RobotState&)>& set_state,
+                                  ManipulabilityBatch& metrics, bool translation, std::size_t thread_count) const;
+
   double penalty_multiplier_;
 };
 }  // namespace kinematics_metrics
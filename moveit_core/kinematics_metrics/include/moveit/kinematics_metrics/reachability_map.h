@@ -0,0 +1,160 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#pragma once
+
+#include <moveit/macros/class_forward.h>
+#include <moveit/robot_model/robot_model.h>
+#include <Eigen/Geometry>
+#include <array>
+#include <string>
+#include <vector>
+
+namespace kinematics_metrics
+{
+MOVEIT_CLASS_FORWARD(ReachabilityMap);  // Defines ReachabilityMapPtr, ConstPtr, WeakPtr... etc
+
+/**
+ * \brief A voxelized map of the poses a tip link of a group reaches relative to a base link
+ *
+ * SE(3) is discretized into position voxels and, within each voxel, into orientation cells over the vector part of
+ * the orientation quaternion (with w >= 0). A cell stores the best manipulability index of the sampled configurations
+ * that put the tip into it, so queries are a single array lookup. As the map is built from samples, a pose in a cell
+ * that no sample reached may still have an IK solution.
+ */
+class ReachabilityMap
+{
+public:
+  struct Options
+  {
+    Options() : position_resolution(0.05), orientation_bins(4), num_samples(1000000)
+    {
+    }
+
+    double position_resolution;     ///< edge length of the position voxels (m)
+    unsigned int orientation_bins;  ///< cells per quaternion component; 0 keeps positions only
+    std::size_t num_samples;        ///< number of random configurations of the group to sample
+  };
+
+  /**
+   * \brief Offline generation: sample random configurations of a group on all cores and record the reached poses
+   * @param robot_model The robot model
+   * @param group_name The group whose configurations are sampled
+   * @param base_frame The link the poses are expressed in, usually the base frame of the IK solver of the group
+   * @param tip_frame The link whose poses are recorded, usually the tip frame of the IK solver of the group
+   * @return The map, or nullptr if the group or the links do not exist
+   */
+  static ReachabilityMapPtr generate(const moveit::core::RobotModelConstPtr& robot_model, const std::string& group_name,
+                                     const std::string& base_frame, const std::string& tip_frame,
+                                     const Options& options = Options());
+
+  /** \brief Load a map written by save(), returns nullptr on failure */
+  static ReachabilityMapPtr load(const std::string& filename);
+
+  /** \brief Write the map to \e filename */
+  bool save(const std::string& filename) const;
+
+  /** \brief Whether tip \e pose (relative to the base frame) lies in a cell reached by the sampled configurations */
+  bool isReachable(const Eigen::Isometry3d& pose) const
+  {
+    return getScore(pose) >= 0.0;
+  }
+
+  /** \brief Whether the tip reaches \e position (relative to the base frame) in any orientation */
+  bool isReachable(const Eigen::Vector3d& position) const
+  {
+    return getScore(position) >= 0.0;
+  }
+
+  /** \brief Best manipulability index reached in the cell of tip \e pose, negative if the cell was not reached */
+  double getScore(const Eigen::Isometry3d& pose) const;
+
+  /** \brief Best manipulability index reached at \e position in any orientation, negative if it was not reached */
+  double getScore(const Eigen::Vector3d& position) const;
+
+  /**
+   * \brief Inverse reachability: score the candidate base poses for reaching a target
+   * @param target Pose of the tip in the world frame
+   * @param base_poses Candidate poses of the base frame in the world frame
+   * @param scores For every candidate, the score of the target relative to it (negative if unreachable)
+   * @return The index of the best candidate, or -1 if the target is not reachable from any of them
+   */
+  int scoreBasePoses(const Eigen::Isometry3d& target, const std::vector<Eigen::Isometry3d>& base_poses,
+                     std::vector<double>& scores) const;
+
+  const std::string& getGroupName() const
+  {
+    return group_name_;
+  }
+
+  const std::string& getBaseFrame() const
+  {
+    return base_frame_;
+  }
+
+  const std::string& getTipFrame() const
+  {
+    return tip_frame_;
+  }
+
+  /** \brief Number of cells reached by the sampled configurations */
+  std::size_t getReachedCellCount() const;
+
+private:
+  ReachabilityMap() = default;
+
+  /** \brief Allocate unreached cells of the voxels of the box [min, max] */
+  void allocate(const Eigen::Vector3d& min, const Eigen::Vector3d& max, double position_resolution,
+                unsigned int orientation_bins);
+  /** \brief Compute the voxel scores as the best score of their orientation cells */
+  void updateVoxelScores();
+  /** \brief Index of the voxel of \e position, or -1 if it lies outside of the map */
+  long getVoxelIndex(const Eigen::Vector3d& position) const;
+  /** \brief Index of the orientation cell of \e orientation within a voxel */
+  std::size_t getOrientationIndex(const Eigen::Quaterniond& orientation) const;
+
+  std::string group_name_;
+  std::string base_frame_;
+  std::string tip_frame_;
+
+  Eigen::Vector3d origin_;  ///< Lower corner of the first voxel
+  double position_resolution_;
+  std::array<std::size_t, 3> size_;  ///< Number of voxels along every axis
+  unsigned int orientation_bins_;
+  std::size_t orientation_cells_;  ///< Number of orientation cells of a voxel
+
+  std::vector<float> cell_scores_;   ///< Scores of the orientation cells of all voxels
+  std::vector<float> voxel_scores_;  ///< Best score over the orientation cells of every voxel
+};
+}  // namespace kinematics_metrics
@@ -39,8 +39,11 @@
 #include <limits>
 #include <math.h>
 #include <moveit/kinematics_metrics/kinematics_metrics.h>
+#include <moveit/robot_trajectory/robot_trajectory.h>
+#include <moveit/utils/task_scheduler.h>
 #include <rclcpp/logger.hpp>
 #include <rclcpp/logging.hpp>
+#include <algorithm>
 
 namespace kinematics_metrics
 {
@@ -243,4 +246,100 @@ bool KinematicsMetrics::getManipulability(const moveit::core::RobotState& state,
   return true;
 }
 
+bool KinematicsMetrics::getManipulabilityBatch(const robot_trajectory::RobotTrajectory& trajectory,
+                                               ManipulabilityBatch& metrics, bool translation,
+                                               std::size_t thread_count) const
+{
+  const moveit::core::JointModelGroup* joint_model_group = trajectory.getGroup();
+  if (!joint_model_group || !joint_model_group->isChain())
+    return false;
+  if (trajectory.empty())
+  {
+    metrics = ManipulabilityBatch();
+    return true;
+  }
+
+  computeManipulabilityBatch(
+      trajectory.getWayPoint(0), joint_model_group, trajectory.getWayPointCount(),
+      [&trajectory](std::size_t i, moveit::core::RobotState& state) {
+        state.setVariablePositions(trajectory.getWayPoint(i).getVariablePositions());
+      },
+      metrics, translation, thread_count);
+  return true;
+}
+
+bool KinematicsMetrics::getManipulabilityBatch(const moveit::core::RobotState& reference_state,
+                                               const moveit::core::JointModelGroup* joint_model_group,
+                                               const std::vector<double>& group_positions,
+                                               ManipulabilityBatch& metrics, bool translation,
+                                               std::size_t thread_count) const
+{
+  if (!joint_model_group->isChain())
+    return false;
+  const std::size_t variable_count = joint_model_group->getVariableCount();
+  if (!variable_count || group_positions.size() % variable_count != 0)
+  {
+    RCLCPP_ERROR(LOGGER, "Expected a multiple of %zu positions for group '%s', got %zu", variable_count,
+                 joint_model_group->getName().c_str(), group_positions.size());
+    return false;
+  }
+
+  computeManipulabilityBatch(
+      reference_state, joint_model_group, group_positions.size() / variable_count,
+      [&](std::size_t i, moveit::core::RobotState& state) {
+        state.setJointGroupPositions(joint_model_group, &group_positions[i * variable_count]);
+      },
+      metrics, translation, thread_count);
+  return true;
+}
+
+void KinematicsMetrics::computeManipulabilityBatch(
+    const moveit::core::RobotState& reference_state, const moveit::core::JointModelGroup* joint_model_group,
+    std::size_t count, const std::function<void(std::size_t, moveit::core::RobotState&)>& set_state,
+    ManipulabilityBatch& metrics, bool translation, std::size_t thread_count) const
+{
+  metrics.manipulability_index.resize(count);
+  metrics.manipulability.resize(count);
+  metrics.min_singular_value.resize(count);
+
+  const auto evaluate = [&](std::size_t begin, std::size_t end) {
+    // Gram matrices are at most 6x6, so their eigenvalues need no dynamic allocation
+    using GramMatrix = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, 0, 6, 6>;
+    moveit::core::RobotState state(reference_state);
+    const moveit::core::LinkModel* tip = joint_model_group->getLinkModels().back();
+    Eigen::MatrixXd jacobian;
+    GramMatrix gram;
+    Eigen::SelfAdjointEigenSolver<GramMatrix> eigensolver(6);
+    for (std::size_t i = begin; i < end; ++i)
+    {
+      set_state(i, state);
+      state.updateLinkTransforms();
+      state.getJacobian(joint_model_group, tip, Eigen::Vector3d::Zero(), jacobian);
+      const auto rows = jacobian.topRows(translation ? 3 : jacobian.rows());
+
+      // the squared singular values of J are the eigenvalues of the smaller one of J J^T and J^T J
+      if (rows.rows() <= rows.cols())
+        gram.noalias() = rows * rows.transpose();
+      else
+        gram.noalias() = rows.transpose() * rows;
+      eigensolver.compute(gram, Eigen::EigenvaluesOnly);
+      const Eigen::Matrix<double, Eigen::Dynamic, 1, 0, 6, 1> singular_values =
+          eigensolver.eigenvalues().cwiseMax(0.0).cwiseSqrt();  // ascending
+
+      const double penalty = getJointLimitsPenalty(state, joint_model_group);
+      metrics.manipulability_index[i] = penalty * singular_values.prod();
+      metrics.manipulability[i] = penalty * singular_values(0) / singular_values(singular_values.size() - 1);
+      metrics.min_singular_value[i] = singular_values(0);
+    }
+  };
+
+  // the states of a block share one scratch state and solver, a few blocks per participant balance the load
+  const std::size_t block_count = std::min(count, 4 * (moveit::scheduling::getTaskScheduler().getThreadCount() + 1));
+  moveit::scheduling::getTaskScheduler().parallelFor(
+      block_count, thread_count, moveit::scheduling::TaskPriority::PLANNING,
+      [&](std::size_t /*participant*/, std::size_t block) {
+        evaluate(block * count / block_count, (block + 1) * count / block_count);
+      });
+}
+
 }  // end of namespace kinematics_metrics
@@ -0,0 +1,318 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/kinematics_metrics/reachability_map.h>
+#include <moveit/kinematics_metrics/kinematics_metrics.h>
+#include <moveit/robot_state/robot_state.h>
+#include <random_numbers/random_numbers.h>
+#include <rclcpp/logger.hpp>
+#include <rclcpp/logging.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+namespace kinematics_metrics
+{
+static const rclcpp::Logger LOGGER = rclcpp::get_logger("moveit_kinematics_metrics.reachability_map");
+
+namespace
+{
+const char MAGIC[8] = { 'M', 'V', 'R', 'E', 'A', 'C', 'H', '\0' };
+const std::uint32_t VERSION = 1;
+const float UNREACHED = -1.0f;
+
+struct Sample
+{
+  Eigen::Vector3d position;
+  Eigen::Quaterniond orientation;
+  double score;
+};
+
+template <typename T>
+void writeValue(std::ostream& out, const T& value)
+{
+  out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool readValue(std::istream& in, T& value)
+{
+  return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+void writeString(std::ostream& out, const std::string& value)
+{
+  writeValue(out, static_cast<std::uint32_t>(value.size()));
+  out.write(value.data(), value.size());
+}
+
+bool readString(std::istream& in, std::string& value)
+{
+  std::uint32_t size;
+  if (!readValue(in, size))
+    return false;
+  value.resize(size);
+  return static_cast<bool>(in.read(&value[0], size));
+}
+}  // namespace
+
+ReachabilityMapPtr ReachabilityMap::generate(const moveit::core::RobotModelConstPtr& robot_model,
+                                             const std::string& group_name, const std::string& base_frame,
+                                             const std::string& tip_frame, const Options& options)
+{
+  const moveit::core::JointModelGroup* group = robot_model->getJointModelGroup(group_name);
+  if (!group)
+  {
+    RCLCPP_ERROR(LOGGER, "Group '%s' does not exist in robot %s", group_name.c_str(), robot_model->getName().c_str());
+    return ReachabilityMapPtr();
+  }
+  if (!robot_model->hasLinkModel(base_frame) || !robot_model->hasLinkModel(tip_frame))
+  {
+    RCLCPP_ERROR(LOGGER, "The base and tip frames of the reachability map must be links of robot %s",
+                 robot_model->getName().c_str());
+    return ReachabilityMapPtr();
+  }
+  if (options.position_resolution <= 0.0 || options.num_samples == 0)
+  {
+    RCLCPP_ERROR(LOGGER, "A reachability map needs a positive resolution and at least one sample");
+    return ReachabilityMapPtr();
+  }
+
+  // every thread samples a contiguous range with its own state and random number generator
+  std::vector<Sample> samples(options.num_samples);
+  const auto sample = [&](std::size_t begin, std::size_t end) {
+    const KinematicsMetrics metrics(robot_model);
+    moveit::core::RobotState state(robot_model);
+    state.setToDefaultValues();
+    random_numbers::RandomNumberGenerator rng;
+    for (std::size_t i = begin; i < end; ++i)
+    {
+      state.setToRandomPositions(group, rng);
+      state.updateLinkTransforms();
+      const Eigen::Isometry3d tip =
+          state.getGlobalLinkTransform(base_frame).inverse() * state.getGlobalLinkTransform(tip_frame);
+      samples[i].position = tip.translation();
+      samples[i].orientation = Eigen::Quaterniond(tip.linear());
+      if (!metrics.getManipulabilityIndex(state, group, samples[i].score))
+        samples[i].score = 0.0;
+    }
+  };
+  const std::size_t num_threads =
+      std::min<std::size_t>(std::max(1u, std::thread::hardware_concurrency()), options.num_samples);
+  std::vector<std::thread> threads;
+  for (std::size_t i = 1; i < num_threads; ++i)
+    threads.emplace_back(sample, i * options.num_samples / num_threads, (i + 1) * options.num_samples / num_threads);
+  sample(0, options.num_samples / num_threads);
+  for (std::thread& thread : threads)
+    thread.join();
+
+  // the map covers the bounding box of the samples, padded by a voxel
+  Eigen::Vector3d min = samples.front().position;
+  Eigen::Vector3d max = samples.front().position;
+  for (const Sample& s : samples)
+  {
+    min = min.cwiseMin(s.position);
+    max = max.cwiseMax(s.position);
+  }
+  min.array() -= options.position_resolution;
+  max.array() += options.position_resolution;
+
+  ReachabilityMapPtr map(new ReachabilityMap());
+  map->group_name_ = group_name;
+  map->base_frame_ = base_frame;
+  map->tip_frame_ = tip_frame;
+  map->allocate(min, max, options.position_resolution, options.orientation_bins);
+  for (const Sample& s : samples)
+  {
+    float& score = map->cell_scores_[map->getVoxelIndex(s.position) * map->orientation_cells_ +
+                                     map->getOrientationIndex(s.orientation)];
+    score = std::max(score, static_cast<float>(s.score));
+  }
+  map->updateVoxelScores();
+
+  RCLCPP_INFO(LOGGER, "Generated reachability map of group '%s' with %zu of %zu cells reached by %zu samples",
+              group_name.c_str(), map->getReachedCellCount(), map->cell_scores_.size(), options.num_samples);
+  return map;
+}
+
+void ReachabilityMap::allocate(const Eigen::Vector3d& min, const Eigen::Vector3d& max, double position_resolution,
+                               unsigned int orientation_bins)
+{
+  origin_ = min;
+  position_resolution_ = position_resolution;
+  for (std::size_t i = 0; i < 3; ++i)
+    size_[i] = std::max<std::size_t>(1, std::ceil((max[i] - min[i]) / position_resolution));
+  orientation_bins_ = orientation_bins;
+  orientation_cells_ = orientation_bins ? orientation_bins * orientation_bins * orientation_bins : 1;
+  cell_scores_.assign(size_[0] * size_[1] * size_[2] * orientation_cells_, UNREACHED);
+}
+
+void ReachabilityMap::updateVoxelScores()
+{
+  voxel_scores_.resize(size_[0] * size_[1] * size_[2]);
+  for (std::size_t i = 0; i < voxel_scores_.size(); ++i)
+    voxel_scores_[i] = *std::max_element(cell_scores_.begin() + i * orientation_cells_,
+                                         cell_scores_.begin() + (i + 1) * orientation_cells_);
+}
+
+long ReachabilityMap::getVoxelIndex(const Eigen::Vector3d& position) const
+{
+  long index = 0;
+  for (std::size_t i = 0; i < 3; ++i)
+  {
+    const double cell = std::floor((position[i] - origin_[i]) / position_resolution_);
+    if (!(cell >= 0.0 && cell < static_cast<double>(size_[i])))  // also rejects NaN
+      return -1;
+    index = index * size_[i] + static_cast<long>(cell);
+  }
+  return index;
+}
+
+std::size_t ReachabilityMap::getOrientationIndex(const Eigen::Quaterniond& orientation) const
+{
+  if (!orientation_bins_)
+    return 0;
+  // q and -q are the same rotation, keep the one with w >= 0 and bin its vector part over [-1, 1]
+  const Eigen::Vector3d v = orientation.w() < 0.0 ? Eigen::Vector3d(-orientation.vec()) : orientation.vec();
+  std::size_t index = 0;
+  for (std::size_t i = 0; i < 3; ++i)
+  {
+    const double cell = std::floor((v[i] + 1.0) * 0.5 * orientation_bins_);
+    index = index * orientation_bins_ + std::min<std::size_t>(orientation_bins_ - 1, std::max(0.0, cell));
+  }
+  return index;
+}
+
+double ReachabilityMap::getScore(const Eigen::Isometry3d& pose) const
+{
+  const long voxel = getVoxelIndex(pose.translation());
+  if (voxel < 0)
+    return UNREACHED;
+  return cell_scores_[voxel * orientation_cells_ + getOrientationIndex(Eigen::Quaterniond(pose.linear()))];
+}
+
+double ReachabilityMap::getScore(const Eigen::Vector3d& position) const
+{
+  const long voxel = getVoxelIndex(position);
+  return voxel < 0 ? UNREACHED : voxel_scores_[voxel];
+}
+
+int ReachabilityMap::scoreBasePoses(const Eigen::Isometry3d& target, const std::vector<Eigen::Isometry3d>& base_poses,
+                                    std::vector<double>& scores) const
+{
+  scores.resize(base_poses.size());
+  int best = -1;
+  for (std::size_t i = 0; i < base_poses.size(); ++i)
+  {
+    scores[i] = getScore(Eigen::Isometry3d(base_poses[i].inverse() * target));
+    if (scores[i] >= 0.0 && (best < 0 || scores[i] > scores[best]))
+      best = i;
+  }
+  return best;
+}
+
+std::size_t ReachabilityMap::getReachedCellCount() const
+{
+  return std::count_if(cell_scores_.begin(), cell_scores_.end(), [](float score) { return score >= 0.0f; });
+}
+
+bool ReachabilityMap::save(const std::string& filename) const
+{
+  std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+  if (!out)
+  {
+    RCLCPP_ERROR(LOGGER, "Cannot open '%s' to write the reachability map", filename.c_str());
+    return false;
+  }
+  out.write(MAGIC, sizeof(MAGIC));
+  writeValue(out, VERSION);
+  writeValue(out, static_cast<std::uint32_t>(orientation_bins_));
+  writeValue(out, position_resolution_);
+  for (std::size_t i = 0; i < 3; ++i)
+    writeValue(out, origin_[i]);
+  for (std::size_t i = 0; i < 3; ++i)
+    writeValue(out, static_cast<std::uint64_t>(size_[i]));
+  writeString(out, group_name_);
+  writeString(out, base_frame_);
+  writeString(out, tip_frame_);
+  out.write(reinterpret_cast<const char*>(cell_scores_.data()), cell_scores_.size() * sizeof(float));
+  return static_cast<bool>(out);
+}
+
+ReachabilityMapPtr ReachabilityMap::load(const std::string& filename)
+{
+  std::ifstream in(filename, std::ios::binary);
+  char magic[sizeof(MAGIC)];
+  std::uint32_t version;
+  if (!in || !in.read(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 ||
+      !readValue(in, version) || version != VERSION)
+  {
+    RCLCPP_ERROR(LOGGER, "'%s' is not a reachability map", filename.c_str());
+    return ReachabilityMapPtr();
+  }
+
+  ReachabilityMapPtr map(new ReachabilityMap());
+  std::uint32_t orientation_bins;
+  double position_resolution;
+  Eigen::Vector3d origin;
+  std::uint64_t size[3];
+  bool ok = readValue(in, orientation_bins) && readValue(in, position_resolution);
+  for (std::size_t i = 0; ok && i < 3; ++i)
+    ok = readValue(in, origin[i]);
+  for (std::size_t i = 0; ok && i < 3; ++i)
+    ok = readValue(in, size[i]) && size[i] > 0;
+  ok = ok && position_resolution > 0.0 && readString(in, map->group_name_) && readString(in, map->base_frame_) &&
+       readString(in, map->tip_frame_);
+  if (ok)
+  {
+    const Eigen::Vector3d max = origin + position_resolution * Eigen::Vector3d(size[0], size[1], size[2]);
+    map->allocate(origin, max, position_resolution, orientation_bins);
+    // rounding may have changed the number of voxels, keep the stored one
+    std::copy(size, size + 3, map->size_.begin());
+    map->cell_scores_.resize(size[0] * size[1] * size[2] * map->orientation_cells_);
+    ok = static_cast<bool>(in.read(reinterpret_cast<char*>(map->cell_scores_.data()),
+                                   map->cell_scores_.size() * sizeof(float)));
+  }
+  if (!ok)
+  {
+    RCLCPP_ERROR(LOGGER, "Reachability map '%s' is truncated or corrupt", filename.c_str());
+    return ReachabilityMapPtr();
+  }
+  map->updateVoxelScores();
+  return map;
+}
+}  // namespace kinematics_metrics
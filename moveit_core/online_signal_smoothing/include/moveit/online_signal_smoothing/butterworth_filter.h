@@ -39,7 +39,9 @@
 #pragma once
 
 #include <cstddef>
+#include <optional>
 
+#include <Eigen/Core>
 #include <moveit/robot_model/robot_model.h>
 #include <moveit/online_signal_smoothing/smoothing_base_class.h>
 
@@ -76,12 +78,58 @@ private:
   double feedback_term_;
 };
 
+/**
+ * Class MultiChannelButterworthFilter - The ButterworthFilter above for many channels at once.
+ * The filter state of all channels is stored in contiguous arrays, so one update is a few vectorized array operations.
+ * Filters of a higher order are a series of first-order sections, so they still don't overshoot.
+ */
+class MultiChannelButterworthFilter
+{
+public:
+  /**
+   * Constructor.
+   * @param low_pass_filter_coeffs Filter coefficient of each channel, see ButterworthFilter
+   * @param orders Number of first-order sections of each channel, at least 1
+   */
+  MultiChannelButterworthFilter(const Eigen::ArrayXd& low_pass_filter_coeffs, const Eigen::ArrayXi& orders);
+  MultiChannelButterworthFilter() = delete;
+
+  /**
+   * Filter one new measurement of every channel
+   * @param measurements The measurements, overwritten with the filtered values
+   */
+  void filter(Eigen::Ref<Eigen::ArrayXd> measurements);
+
+  void reset(const Eigen::Ref<const Eigen::ArrayXd>& data);
+
+  Eigen::Index size() const
+  {
+    return scale_term_.size();
+  }
+
+private:
+  // Scale and feedback term are calculated from supplied filter coefficients
+  Eigen::ArrayXd scale_term_;
+  Eigen::ArrayXd feedback_term_;
+  // Column k holds the previous input and output of the k-th section of all channels
+  Eigen::ArrayXXd previous_measurements_;
+  Eigen::ArrayXXd previous_filtered_measurements_;
+  // Whether a channel has a k-th section, channels of a lower order pass the signal through
+  Eigen::Array<bool, Eigen::Dynamic, Eigen::Dynamic> active_sections_;
+  // Preallocated output of one section
+  Eigen::ArrayXd section_output_;
+};
+
 // Plugin
 class ButterworthFilterPlugin : public SmoothingBaseClass
 {
 public:
   /**
    * Initialize the smoothing algorithm
+   * Parameters (all optional):
+   * - butterworth_filter.filter_coeff: filter coefficient of all joints, should be >1
+   * - butterworth_filter.filter_coeffs: filter coefficient of each joint, overrides filter_coeff
+   * - butterworth_filter.filter_orders: number of first-order sections of each joint, 1 by default
    * @param node ROS node, used for parameter retrieval
    * @param robot_model typically used to retrieve vel/accel/jerk limits
    * @param num_joints number of actuated joints in the JointGroup Servo controls
@@ -106,7 +154,7 @@ public:
 
 private:
   rclcpp::Node::SharedPtr node_;
-  std::vector<ButterworthFilter> position_filters_;
+  std::optional<MultiChannelButterworthFilter> position_filter_;
   size_t num_joints_;
 };
 }  // namespace online_signal_smoothing
@@ -0,0 +1,103 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Description: An online, jerk-limited smoothing filter based on Ruckig.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+#include <ruckig/ruckig.hpp>
+
+#include <moveit/robot_model/robot_model.h>
+#include <moveit/online_signal_smoothing/smoothing_base_class.h>
+
+namespace online_signal_smoothing
+{
+/**
+ * Plugin that smooths streamed position commands with Ruckig.
+ * Every call to doSmoothing() advances a persistent Ruckig instance by one update period towards the newest command,
+ * so the output respects the velocity/acceleration/jerk limits of the robot. The Ruckig input and output are allocated
+ * once in initialize(), nothing is allocated per cycle.
+ *
+ * Parameters (all optional):
+ * - ruckig_filter.planning_group_name: group the joint limits are read from. Defaults are used if empty.
+ * - ruckig_filter.update_period: time between two calls to doSmoothing() [s].
+ */
+class RuckigFilterPlugin : public SmoothingBaseClass
+{
+public:
+  /**
+   * Initialize the smoothing algorithm
+   * @param node ROS node, used for parameter retrieval
+   * @param robot_model used to retrieve vel/accel/jerk limits
+   * @param num_joints number of actuated joints in the JointGroup Servo controls
+   * @return True if initialization was successful
+   */
+  bool initialize(rclcpp::Node::SharedPtr node, moveit::core::RobotModelConstPtr robot_model,
+                  size_t num_joints) override;
+
+  /**
+   * Smooth the command signals for all DOF
+   * @param position_vector array of joint position commands, overwritten with the next smoothed setpoint
+   * @return True if smoothing was successful
+   */
+  bool doSmoothing(std::vector<double>& position_vector) override;
+
+  /**
+   * Reset to a given joint state, at rest
+   * @param joint_positions reset the filter to these joint positions
+   * @return True if reset was successful
+   */
+  bool reset(const std::vector<double>& joint_positions) override;
+
+private:
+  /**
+   * Read the joint limits of a group into ruckig_input_
+   * @param group the limits are retrieved from this group, defaults are used if it is null
+   */
+  void getLimits(const moveit::core::JointModelGroup* group);
+
+  rclcpp::Node::SharedPtr node_;
+  size_t num_joints_;
+  double update_period_;
+  std::unique_ptr<ruckig::Ruckig<ruckig::DynamicDOFs>> ruckig_;
+  std::unique_ptr<ruckig::InputParameter<ruckig::DynamicDOFs>> ruckig_input_;
+  std::unique_ptr<ruckig::OutputParameter<ruckig::DynamicDOFs>> ruckig_output_;
+  // The previous command, used to estimate the target velocity of the streamed signal
+  std::vector<double> previous_target_;
+};
+}  // namespace online_signal_smoothing
@@ -45,7 +45,16 @@ namespace online_signal_smoothing
 namespace
 {
 constexpr double EPSILON = 1e-9;
+constexpr double DEFAULT_FILTER_COEFF = 1.5;
+
+template <typename T>
+T declareOrGetParam(const rclcpp::Node::SharedPtr& node, const std::string& param_name, const T& default_value)
+{
+  if (node->has_parameter(param_name))
+    return node->get_parameter(param_name).get_value<T>();
+  return node->declare_parameter<T>(param_name, default_value);
 }
+}  // namespace
 
 ButterworthFilter::ButterworthFilter(double low_pass_filter_coeff)
   : previous_measurements_{ 0., 0. }
@@ -91,49 +100,119 @@ void ButterworthFilter::reset(const double data)
   previous_filtered_measurement_ = data;
 }
 
+MultiChannelButterworthFilter::MultiChannelButterworthFilter(const Eigen::ArrayXd& low_pass_filter_coeffs,
+                                                             const Eigen::ArrayXi& orders)
+  : scale_term_(1. / (1. + low_pass_filter_coeffs)), feedback_term_(1. - low_pass_filter_coeffs)
+{
+  if (orders.size() != low_pass_filter_coeffs.size())
+    throw std::length_error("online_signal_smoothing::MultiChannelButterworthFilter: Need one order per channel");
+
+  if (!scale_term_.isFinite().all() || !feedback_term_.isFinite().all())
+    throw std::length_error("online_signal_smoothing::MultiChannelButterworthFilter: infinite filter terms");
+
+  if ((low_pass_filter_coeffs < 1).any())
+    throw std::length_error("online_signal_smoothing::MultiChannelButterworthFilter: Filter coefficient < 1. makes the "
+                            "lowpass filter unstable");
+
+  if ((feedback_term_.abs() < EPSILON).any())
+    throw std::length_error("online_signal_smoothing::MultiChannelButterworthFilter: Filter coefficient value resulted "
+                            "in feedback term of 0");
+
+  if ((orders < 1).any())
+    throw std::length_error("online_signal_smoothing::MultiChannelButterworthFilter: Filter order must be at least 1");
+
+  const Eigen::Index num_sections = orders.size() > 0 ? orders.maxCoeff() : 0;
+  active_sections_.resize(orders.size(), num_sections);
+  for (Eigen::Index k = 0; k < num_sections; ++k)
+    active_sections_.col(k) = orders > k;
+  previous_measurements_.setZero(orders.size(), num_sections);
+  previous_filtered_measurements_.setZero(orders.size(), num_sections);
+  section_output_.setZero(orders.size());
+}
+
+void MultiChannelButterworthFilter::filter(Eigen::Ref<Eigen::ArrayXd> measurements)
+{
+  for (Eigen::Index k = 0; k < active_sections_.cols(); ++k)
+  {
+    section_output_ = scale_term_ * (previous_measurements_.col(k) + measurements -
+                                     feedback_term_ * previous_filtered_measurements_.col(k));
+    previous_measurements_.col(k) = measurements;
+    previous_filtered_measurements_.col(k) = section_output_;
+    measurements = active_sections_.col(k).select(section_output_, measurements);
+  }
+}
+
+void MultiChannelButterworthFilter::reset(const Eigen::Ref<const Eigen::ArrayXd>& data)
+{
+  previous_measurements_.colwise() = data;
+  previous_filtered_measurements_.colwise() = data;
+}
+
 bool ButterworthFilterPlugin::initialize(rclcpp::Node::SharedPtr node, moveit::core::RobotModelConstPtr /* unused */,
                                          size_t num_joints)
 {
   node_ = node;
   num_joints_ = num_joints;
 
+  // Low-pass filters for the joint positions
+  const double filter_coeff =
+      declareOrGetParam<double>(node_, "butterworth_filter.filter_coeff", DEFAULT_FILTER_COEFF);
+  const std::vector<double> filter_coeffs =
+      declareOrGetParam<std::vector<double>>(node_, "butterworth_filter.filter_coeffs", {});
+  const std::vector<int64_t> filter_orders =
+      declareOrGetParam<std::vector<int64_t>>(node_, "butterworth_filter.filter_orders", {});
+  if ((!filter_coeffs.empty() && filter_coeffs.size() != num_joints_) ||
+      (!filter_orders.empty() && filter_orders.size() != num_joints_))
+  {
+    RCLCPP_ERROR(node_->get_logger(), "butterworth_filter.filter_coeffs and butterworth_filter.filter_orders need "
+                                      "one entry per joint.");
+    return false;
+  }
+
+  Eigen::ArrayXd coeffs = Eigen::ArrayXd::Constant(num_joints_, filter_coeff);
+  Eigen::ArrayXi orders = Eigen::ArrayXi::Ones(num_joints_);
   for (std::size_t i = 0; i < num_joints_; ++i)
   {
-    // Low-pass filters for the joint positions
-    // TODO(andyz): read a parameter
-    position_filters_.emplace_back(1.5 /* filter coefficient, should be >1 */);
+    if (!filter_coeffs.empty())
+      coeffs[i] = filter_coeffs[i];
+    if (!filter_orders.empty())
+      orders[i] = static_cast<int>(filter_orders[i]);
+  }
+
+  try
+  {
+    position_filter_.emplace(coeffs, orders);
+  }
+  catch (const std::length_error& e)
+  {
+    RCLCPP_ERROR(node_->get_logger(), "%s", e.what());
+    return false;
   }
   return true;
 };
 
 bool ButterworthFilterPlugin::doSmoothing(std::vector<double>& position_vector)
 {
-  if (position_vector.size() != position_filters_.size())
+  if (position_vector.size() != num_joints_)
   {
     RCLCPP_ERROR_THROTTLE(node_->get_logger(), *node_->get_clock(), 1000,
                           "Position vector to be smoothed does not have the right length.");
     return false;
   }
-  for (size_t i = 0; i < position_vector.size(); ++i)
-  {
-    // Lowpass filter the position command
-    position_vector[i] = position_filters_.at(i).filter(position_vector[i]);
-  }
+  // Lowpass filter the position command
+  position_filter_->filter(Eigen::Map<Eigen::ArrayXd>(position_vector.data(), position_vector.size()));
   return true;
 };
 
 bool ButterworthFilterPlugin::reset(const std::vector<double>& joint_positions)
 {
-  if (joint_positions.size() != position_filters_.size())
+  if (joint_positions.size() != num_joints_)
   {
     RCLCPP_ERROR_THROTTLE(node_->get_logger(), *node_->get_clock(), 1000,
                           "Position vector to be reset does not have the right length.");
     return false;
   }
-  for (size_t joint_idx = 0; joint_idx < joint_positions.size(); ++joint_idx)
-  {
-    position_filters_.at(joint_idx).reset(joint_positions.at(joint_idx));
-  }
+  position_filter_->reset(Eigen::Map<const Eigen::ArrayXd>(joint_positions.data(), joint_positions.size()));
   return true;
 };
 
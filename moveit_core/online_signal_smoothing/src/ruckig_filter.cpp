@@ -0,0 +1,173 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Description: An online, jerk-limited smoothing filter based on Ruckig.
+ */
+
+#include <algorithm>
+
+#include <moveit/online_signal_smoothing/ruckig_filter.h>
+#include <rclcpp/clock.hpp>
+#include <rclcpp/logging.hpp>
+
+namespace online_signal_smoothing
+{
+namespace
+{
+const rclcpp::Logger LOGGER = rclcpp::get_logger("moveit.core.ruckig_filter_plugin");
+constexpr double DEFAULT_MAX_VELOCITY = 5;       // rad/s
+constexpr double DEFAULT_MAX_ACCELERATION = 10;  // rad/s^2
+constexpr double DEFAULT_MAX_JERK = 1000;        // rad/s^3
+constexpr double DEFAULT_UPDATE_PERIOD = 0.01;   // s
+
+template <typename T>
+T declareOrGetParam(const rclcpp::Node::SharedPtr& node, const std::string& param_name, const T& default_value)
+{
+  if (node->has_parameter(param_name))
+    return node->get_parameter(param_name).get_value<T>();
+  return node->declare_parameter<T>(param_name, default_value);
+}
+}  // namespace
+
+bool RuckigFilterPlugin::initialize(rclcpp::Node::SharedPtr node, moveit::core::RobotModelConstPtr robot_model,
+                                    size_t num_joints)
+{
+  node_ = node;
+  num_joints_ = num_joints;
+
+  update_period_ = declareOrGetParam<double>(node_, "ruckig_filter.update_period", DEFAULT_UPDATE_PERIOD);
+  if (update_period_ <= 0.0)
+  {
+    RCLCPP_ERROR(LOGGER, "ruckig_filter.update_period must be positive.");
+    return false;
+  }
+
+  const moveit::core::JointModelGroup* group = nullptr;
+  const std::string group_name = declareOrGetParam<std::string>(node_, "ruckig_filter.planning_group_name", "");
+  if (!group_name.empty())
+  {
+    group = robot_model ? robot_model->getJointModelGroup(group_name) : nullptr;
+    if (!group || group->getVariableCount() != num_joints_)
+    {
+      RCLCPP_ERROR(LOGGER, "Planning group '%s' does not exist or does not have %zu variables.", group_name.c_str(),
+                   num_joints_);
+      return false;
+    }
+  }
+
+  ruckig_ = std::make_unique<ruckig::Ruckig<ruckig::DynamicDOFs>>(num_joints_, update_period_);
+  ruckig_input_ = std::make_unique<ruckig::InputParameter<ruckig::DynamicDOFs>>(num_joints_);
+  ruckig_output_ = std::make_unique<ruckig::OutputParameter<ruckig::DynamicDOFs>>(num_joints_);
+  previous_target_.assign(num_joints_, 0.0);
+  getLimits(group);
+
+  return reset(previous_target_);
+}
+
+void RuckigFilterPlugin::getLimits(const moveit::core::JointModelGroup* group)
+{
+  for (size_t i = 0; i < num_joints_; ++i)
+  {
+    ruckig_input_->max_velocity.at(i) = DEFAULT_MAX_VELOCITY;
+    ruckig_input_->max_acceleration.at(i) = DEFAULT_MAX_ACCELERATION;
+    ruckig_input_->max_jerk.at(i) = DEFAULT_MAX_JERK;
+    if (!group)
+      continue;
+
+    // This assumes min/max bounds are symmetric
+    const moveit::core::VariableBounds& bounds =
+        group->getParentModel().getVariableBounds(group->getVariableNames().at(i));
+    if (bounds.velocity_bounded_)
+      ruckig_input_->max_velocity.at(i) = bounds.max_velocity_;
+    if (bounds.acceleration_bounded_)
+      ruckig_input_->max_acceleration.at(i) = bounds.max_acceleration_;
+    if (bounds.jerk_bounded_)
+      ruckig_input_->max_jerk.at(i) = bounds.max_jerk_;
+  }
+}
+
+bool RuckigFilterPlugin::doSmoothing(std::vector<double>& position_vector)
+{
+  if (position_vector.size() != num_joints_)
+  {
+    RCLCPP_ERROR_THROTTLE(node_->get_logger(), *node_->get_clock(), 1000,
+                          "Position vector to be smoothed does not have the right length.");
+    return false;
+  }
+
+  // Track the newest command, moving with the velocity the command signal itself moves with
+  for (size_t i = 0; i < num_joints_; ++i)
+  {
+    const double max_velocity = ruckig_input_->max_velocity[i];
+    ruckig_input_->target_position[i] = position_vector[i];
+    ruckig_input_->target_velocity[i] =
+        std::clamp((position_vector[i] - previous_target_[i]) / update_period_, -max_velocity, max_velocity);
+    ruckig_input_->target_acceleration[i] = 0.0;
+    previous_target_[i] = position_vector[i];
+  }
+
+  const ruckig::Result result = ruckig_->update(*ruckig_input_, *ruckig_output_);
+  if (result != ruckig::Result::Working && result != ruckig::Result::Finished)
+  {
+    RCLCPP_ERROR_THROTTLE(node_->get_logger(), *node_->get_clock(), 1000, "Ruckig failed to smooth the command.");
+    return false;
+  }
+
+  ruckig_output_->pass_to_input(*ruckig_input_);
+  std::copy(ruckig_output_->new_position.begin(), ruckig_output_->new_position.end(), position_vector.begin());
+  return true;
+}
+
+bool RuckigFilterPlugin::reset(const std::vector<double>& joint_positions)
+{
+  if (joint_positions.size() != num_joints_)
+  {
+    RCLCPP_ERROR_THROTTLE(node_->get_logger(), *node_->get_clock(), 1000,
+                          "Position vector to be reset does not have the right length.");
+    return false;
+  }
+  for (size_t i = 0; i < num_joints_; ++i)
+  {
+    ruckig_input_->current_position[i] = joint_positions[i];
+    ruckig_input_->current_velocity[i] = 0.0;
+    ruckig_input_->current_acceleration[i] = 0.0;
+    previous_target_[i] = joint_positions[i];
+  }
+  return true;
+}
+
+}  // namespace online_signal_smoothing
+
+#include <pluginlib/class_list_macros.hpp>
+PLUGINLIB_EXPORT_CLASS(online_signal_smoothing::RuckigFilterPlugin, online_signal_smoothing::SmoothingBaseClass)
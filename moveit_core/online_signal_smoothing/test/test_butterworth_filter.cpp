@@ -71,3 +71,36 @@ TEST(SMOOTHING_PLUGINS, FilterReset)
   // Then check that a different measurement changes the value
   EXPECT_NE(5.0, lpf.filter(100.0));
 }
+
+TEST(SMOOTHING_PLUGINS, MultiChannelFilterMatchesScalarFilters)
+{
+  Eigen::ArrayXd coeffs(3);
+  coeffs << 1.5, 2.0, 3.0;
+  Eigen::ArrayXi orders(3);
+  orders << 1, 1, 2;
+  online_signal_smoothing::MultiChannelButterworthFilter multi_channel_lpf(coeffs, orders);
+  online_signal_smoothing::ButterworthFilter lpf_0(1.5), lpf_1(2.0), lpf_2_first(3.0), lpf_2_second(3.0);
+
+  Eigen::ArrayXd values(3);
+  for (size_t i = 0; i < 100; ++i)
+  {
+    const double measurement = (i < 50) ? 5.0 : -1.0;
+    values.setConstant(measurement);
+    multi_channel_lpf.filter(values);
+    EXPECT_DOUBLE_EQ(values[0], lpf_0.filter(measurement));
+    EXPECT_DOUBLE_EQ(values[1], lpf_1.filter(measurement));
+    // A second-order channel equals two first-order filters in series
+    EXPECT_DOUBLE_EQ(values[2], lpf_2_second.filter(lpf_2_first.filter(measurement)));
+  }
+
+  // Check that the filter was properly set to the desired value
+  multi_channel_lpf.reset(Eigen::ArrayXd::Constant(3, 5.0));
+  values.setConstant(5.0);
+  multi_channel_lpf.filter(values);
+  for (Eigen::Index i = 0; i < values.size(); ++i)
+    EXPECT_DOUBLE_EQ(5.0, values[i]);
+
+  // Unstable coefficients are rejected
+  coeffs[0] = 0.5;
+  EXPECT_THROW(online_signal_smoothing::MultiChannelButterworthFilter(coeffs, orders), std::length_error);
+}
@@ -0,0 +1,117 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Description: Unit test for online_signal_smoothing::RuckigFilterPlugin
+ */
+
+#include <cmath>
+
+#include <gtest/gtest.h>
+#include <moveit/online_signal_smoothing/ruckig_filter.h>
+#include <moveit/utils/robot_model_test_utils.h>
+#include <rclcpp/rclcpp.hpp>
+
+namespace
+{
+constexpr size_t NUM_JOINTS = 7;
+constexpr double UPDATE_PERIOD = 0.01;
+}  // namespace
+
+class RuckigFilterTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    rclcpp::NodeOptions options;
+    options.parameter_overrides({ { "ruckig_filter.planning_group_name", "panda_arm" },
+                                  { "ruckig_filter.update_period", UPDATE_PERIOD } });
+    node_ = std::make_shared<rclcpp::Node>("test_ruckig_filter", options);
+    robot_model_ = moveit::core::loadTestingRobotModel("panda");
+    ASSERT_TRUE(filter_.initialize(node_, robot_model_, NUM_JOINTS));
+  }
+
+  rclcpp::Node::SharedPtr node_;
+  moveit::core::RobotModelPtr robot_model_;
+  online_signal_smoothing::RuckigFilterPlugin filter_;
+};
+
+TEST_F(RuckigFilterTest, ConvergesWithinLimits)
+{
+  const std::vector<std::string>& joint_names = robot_model_->getJointModelGroup("panda_arm")->getVariableNames();
+  std::vector<double> previous(NUM_JOINTS, 0.0);
+  std::vector<double> command(NUM_JOINTS, 0.0);
+  for (size_t step = 0; step < 1000; ++step)
+  {
+    command.assign(NUM_JOINTS, 0.5);
+    ASSERT_TRUE(filter_.doSmoothing(command));
+    for (size_t i = 0; i < NUM_JOINTS; ++i)
+    {
+      // Check that the smoothed signal moves no faster than the joint velocity limits allow
+      const double max_velocity = robot_model_->getVariableBounds(joint_names[i]).max_velocity_;
+      EXPECT_LE(std::abs(command[i] - previous[i]) / UPDATE_PERIOD, max_velocity + 1e-6);
+    }
+    previous = command;
+  }
+  // Check that the filter converges to the commanded value
+  for (double position : command)
+    EXPECT_NEAR(0.5, position, 1e-6);
+}
+
+TEST_F(RuckigFilterTest, FilterReset)
+{
+  std::vector<double> command(NUM_JOINTS, 0.5);
+  ASSERT_TRUE(filter_.doSmoothing(command));
+  // The first step can not jump to the command
+  EXPECT_LT(command[0], 0.5);
+
+  ASSERT_TRUE(filter_.reset(std::vector<double>(NUM_JOINTS, 0.5)));
+  command.assign(NUM_JOINTS, 0.5);
+  ASSERT_TRUE(filter_.doSmoothing(command));
+  // Check that the filter was properly set to the desired value
+  EXPECT_NEAR(0.5, command[0], 1e-9);
+
+  // Wrongly sized vectors are rejected
+  std::vector<double> wrong_size(NUM_JOINTS + 1, 0.0);
+  EXPECT_FALSE(filter_.doSmoothing(wrong_size));
+  EXPECT_FALSE(filter_.reset(wrong_size));
+}
+
+int main(int argc, char** argv)
+{
+  rclcpp::init(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+  const int result = RUN_ALL_TESTS();
+  rclcpp::shutdown();
+  return result;
+}
@@ -37,6 +37,7 @@
 #pragma once
 
 #include <moveit/robot_trajectory/robot_trajectory.h>
+#include <moveit/utils/allocation_tracking.h>
 #include <moveit_msgs/msg/move_it_error_codes.hpp>
 #include <moveit_msgs/msg/motion_plan_response.hpp>
 #include <moveit_msgs/msg/motion_plan_detailed_response.hpp>
@@ -54,6 +55,22 @@ struct MotionPlanResponse
   robot_trajectory::RobotTrajectoryPtr trajectory_;
   double planning_time_;
   moveit_msgs::msg::MoveItErrorCodes error_code_;
+
+  /// The planning request adapters that processed the request, in the order of the adapter chain, and the time in
+  /// seconds each of them took, excluding the time spent in the adapters after it and in the planner
+  std::vector<std::string> adapter_descriptions_;
+  std::vector<double> adapter_times_;
+  /// The heap allocations each adapter made on the planning thread, excluding those of the later stages like the times.
+  /// All zero unless allocation tracking is enabled, see moveit/utils/allocation_tracking.h
+  std::vector<moveit::memory::AllocationStats> adapter_allocations_;
+
+  /// Named stages of processing the request and the time in seconds each of them took, in the order they ran.
+  /// Planners may report the parts of their solve here (e.g. "plan", "simplify", "interpolate"); the planning pipeline
+  /// adds the adapters, path validation and display
+  std::vector<std::string> stage_descriptions_;
+  std::vector<double> stage_times_;
+  /// The heap allocations each stage made on the planning thread, all zero unless allocation tracking is enabled
+  std::vector<moveit::memory::AllocationStats> stage_allocations_;
 };
 
 struct MotionPlanDetailedResponse
@@ -35,9 +35,11 @@
 /* Author: Ioan Sucan */
 
 #include <moveit/planning_request_adapter/planning_request_adapter.h>
+#include <moveit/utils/tracing.h>
 #include <rclcpp/logger.hpp>
 #include <functional>
 #include <algorithm>
+#include <chrono>
 
 namespace planning_request_adapter
 {
@@ -126,27 +128,59 @@ bool PlanningRequestAdapterChain::adaptAndPlan(const planning_interface::Planner
     // the index values added by each adapter
     std::vector<std::vector<std::size_t> > added_path_index_each(adapters_.size());
 
-    // if there are adapters, construct a function for each, in order,
-    // so that in the end we have a nested sequence of functions that calls all adapters
-    // and eventually the planner in the correct order.
-    PlanningRequestAdapter::PlannerFn fn = [&planner = *planner](const planning_scene::PlanningSceneConstPtr& scene,
-                                                                 const planning_interface::MotionPlanRequest& req,
-                                                                 planning_interface::MotionPlanResponse& res) {
-      return callPlannerInterfaceSolve(planner, scene, req, res);
+    // stage i calls adapter i with stage i + 1 as its planner, the last stage calls the planner itself. Every stage
+    // refers to the next one by reference, so no nested functions are copied, and each stage accumulates the time
+    // spent in it and in all stages after it
+    std::vector<PlanningRequestAdapter::PlannerFn> stages(adapters_.size() + 1);
+    std::vector<double> stage_times(adapters_.size() + 1, 0.0);
+    std::vector<moveit::memory::AllocationStats> stage_allocations(adapters_.size() + 1);
+    stages.back() = [&planner = *planner, &time = stage_times.back(),
+                     &allocations = stage_allocations.back()](const planning_scene::PlanningSceneConstPtr& scene,
+                                                              const planning_interface::MotionPlanRequest& req,
+                                                              planning_interface::MotionPlanResponse& res) {
+      const auto start = std::chrono::steady_clock::now();
+      const moveit::memory::ScopedAllocationTracker tracker;
+      MOVEIT_TRACE_STAGE_BEGIN("planner", &res);
+      const bool result = callPlannerInterfaceSolve(planner, scene, req, res);
+      MOVEIT_TRACE_STAGE_END("planner", &res, result);
+      allocations += tracker.getAllocations();
+      time += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      return result;
     };
 
     for (int i = adapters_.size() - 1; i >= 0; --i)
     {
-      fn = [&adapter = *adapters_[i], fn, &added_path_index = added_path_index_each[i]](
-               const planning_scene::PlanningSceneConstPtr& scene, const planning_interface::MotionPlanRequest& req,
-               planning_interface::MotionPlanResponse& res) {
-        return callAdapter(adapter, fn, scene, req, res, added_path_index);
+      stages[i] = [&adapter = *adapters_[i], &next = stages[i + 1], &added_path_index = added_path_index_each[i],
+                   &time = stage_times[i],
+                   &allocations = stage_allocations[i]](const planning_scene::PlanningSceneConstPtr& scene,
+                                                        const planning_interface::MotionPlanRequest& req,
+                                                        planning_interface::MotionPlanResponse& res) {
+        const auto start = std::chrono::steady_clock::now();
+        const moveit::memory::ScopedAllocationTracker tracker;
+        // the stage of an adapter contains the stages it calls
+        MOVEIT_TRACE_STAGE_BEGIN(adapter.getDescription().c_str(), &res);
+        const bool result = callAdapter(adapter, next, scene, req, res, added_path_index);
+        MOVEIT_TRACE_STAGE_END(adapter.getDescription().c_str(), &res, result);
+        allocations += tracker.getAllocations();
+        time += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return result;
       };
     }
 
-    bool result = fn(planning_scene, req, res);
+    bool result = stages.front()(planning_scene, req, res);
     added_path_index.clear();
 
+    // report the time of each adapter without the time of the stages it called
+    res.adapter_descriptions_.resize(adapters_.size());
+    res.adapter_times_.resize(adapters_.size());
+    res.adapter_allocations_.resize(adapters_.size());
+    for (std::size_t i = 0; i < adapters_.size(); ++i)
+    {
+      res.adapter_descriptions_[i] = adapters_[i]->getDescription();
+      res.adapter_times_[i] = stage_times[i] - stage_times[i + 1];
+      res.adapter_allocations_[i] = stage_allocations[i] - stage_allocations[i + 1];
+    }
+
     // merge the index values from each adapter
     for (std::vector<std::size_t>& added_states_by_each_adapter : added_path_index_each)
       for (std::size_t& added_index : added_states_by_each_adapter)
@@ -51,8 +51,10 @@
 #include <moveit_msgs/msg/constraints.hpp>
 #include <moveit_msgs/msg/planning_scene_components.hpp>
 #include <octomap_msgs/msg/octomap_with_pose.hpp>
+#include <cstdint>
 #include <memory>
 #include <functional>
+#include <set>
 #include <thread>
 #include <variant>
 #include "rclcpp/rclcpp.hpp"
@@ -63,6 +65,7 @@
 namespace planning_scene
 {
 MOVEIT_CLASS_FORWARD(PlanningScene);  // Defines PlanningScenePtr, ConstPtr, WeakPtr... etc
+MOVEIT_STRUCT_FORWARD(PlanningSceneCheckpoint);  // opaque snapshot, see PlanningScene::checkpoint()
 
 /** \brief This is the function signature for additional feasibility checks to be imposed on states (in addition to
    respecting constraints and collision avoidance).
@@ -70,6 +73,17 @@ MOVEIT_CLASS_FORWARD(PlanningScene);  // Defines PlanningScenePtr, ConstPtr, Wea
    or not. */
 typedef std::function<bool(const moveit::core::RobotState&, bool)> StateFeasibilityFn;
 
+/** \brief The order in which PlanningScene::isStateValid() and PlanningScene::isPathValid() run their checks on a
+   state. The checks stop at the first one that fails, except for verbose path checks, which explain every failure. */
+enum class StateCheckOrder
+{
+  /** \brief Collision, feasibility, then constraints (the default) */
+  COLLISION_FIRST,
+  /** \brief Constraints, feasibility, then collision, which avoids most collision checks when the constraints reject
+     many states */
+  CONSTRAINTS_FIRST
+};
+
 /** \brief This is the function signature for additional feasibility checks to be imposed on motions segments between
    states (in addition to respecting constraints and collision avoidance).
     The order of the arguments matters: the notion of feasibility is to be checked for motion segments that start at the
@@ -296,6 +310,53 @@ public:
 
   /**@}*/
 
+  /**
+   * \name Versions of the scene components, for invalidating caches built on top of a planning scene
+   * A version changes whenever its component may have been modified, in particular whenever the corresponding
+   * get*NonConst() function is called. Equal versions imply equal contents, also between a scene and its diffs.
+   * Versions of different components are unrelated.
+   */
+  /**@{*/
+
+  /** \brief Get the version of the world geometry, see collision_detection::World::getVersion() */
+  std::uint64_t getWorldVersion() const
+  {
+    return world_->getVersion();
+  }
+
+  /** \brief Add the ids of the world objects changed since the world had version \e world_version to \e object_ids.
+   * Returns false if the changes are not known, see collision_detection::World::getChangedObjectIds() */
+  bool getChangedObjectIds(std::uint64_t world_version, std::set<std::string>& object_ids) const
+  {
+    return world_->getChangedObjectIds(world_version, object_ids);
+  }
+
+  /** \brief Get the version of the allowed collision matrix */
+  std::uint64_t getAllowedCollisionMatrixVersion() const
+  {
+    return acm_ ? acm_version_ : parent_->getAllowedCollisionMatrixVersion();
+  }
+
+  /** \brief Get the version of the bodies attached to the current state */
+  std::uint64_t getAttachedBodiesVersion() const
+  {
+    return robot_state_ ? attached_bodies_version_ : parent_->getAttachedBodiesVersion();
+  }
+
+  /** \brief Get the version of the fixed frame transforms */
+  std::uint64_t getTransformsVersion() const
+  {
+    return scene_transforms_ ? transforms_version_ : parent_->getTransformsVersion();
+  }
+
+  /** \brief Get the version of the variable values of the current state */
+  std::uint64_t getCurrentStateVersion() const
+  {
+    return robot_state_ ? robot_state_version_ : parent_->getCurrentStateVersion();
+  }
+
+  /**@}*/
+
   /**
    * \name Collision checking with respect to this planning scene
    */
@@ -335,6 +396,14 @@ public:
   bool isStateColliding(const moveit_msgs::msg::RobotState& state, const std::string& group = "",
                         bool verbose = false) const;
 
+  /** \brief Check if the robot collides with the world anywhere on the motion from \e from to \e to.
+      Every robot body is swept continuously from its pose in \e from to its pose in \e to, so no intermediate
+      states need to be sampled. Self collisions are not checked between the two states. If a group name is specified,
+      only the links of that group are swept. It is expected that the collision body transforms of both states are up
+      to date. */
+  bool isSegmentColliding(const moveit::core::RobotState& from, const moveit::core::RobotState& to,
+                          const std::string& group = "", bool verbose = false) const;
+
   /** \brief Check whether the current state is in collision, and if needed, updates the collision transforms of the
    * current state before the computation. */
   void checkCollision(const collision_detection::CollisionRequest& req, collision_detection::CollisionResult& res);
@@ -652,6 +721,12 @@ public:
      */
   void getPlanningSceneDiffMsg(moveit_msgs::msg::PlanningScene& scene) const;
 
+  /** \brief Fill the message \e scene with the differences between this instance of PlanningScene with respect to the
+     parent, like getPlanningSceneDiffMsg(). If \e include_octomap is false, a changed octomap is not serialized, so the
+     differences can be extracted quickly and the octomap fetched later with getOctomapMsg().
+      Returns true if the octomap is among the differences. */
+  bool getPlanningSceneDiffMsg(moveit_msgs::msg::PlanningScene& scene, bool include_octomap) const;
+
   /** \brief Construct a message (\e scene) with all the necessary data so that the scene can be later reconstructed to
      be
       exactly the same using setPlanningSceneMsg() */
@@ -768,6 +843,20 @@ public:
       parent and the pointer to the parent is discarded. */
   void decoupleParent();
 
+  /** \brief Take a snapshot of this scene that rollback() can return to.
+   *
+   * The snapshot shares the world objects with this scene, so its cost does not depend on the size of their geometry.
+   * Components this (diff) scene still uses from its parent are not copied: rolling back makes the scene use the
+   * parent's ones again. A checkpoint can be rolled back to any number of times. */
+  PlanningSceneCheckpointConstPtr checkpoint() const;
+
+  /** \brief Restore the world, current state, allowed collision matrix, transforms, colors and types of a checkpoint.
+   *
+   * Only the world objects changed since the checkpoint are replaced, so collision environments and observers
+   * receive incremental updates. References obtained from get*NonConst() before the rollback may refer to discarded
+   * data afterwards. Returns false if \e checkpoint was not taken from this scene. */
+  bool rollback(const PlanningSceneCheckpointConstPtr& checkpoint);
+
   /** \brief Specify a predicate that decides whether states are considered valid or invalid for reasons beyond ones
      covered by collision checking and constraint evaluation.
       This is useful for setting up problem specific constraints (e.g., stability) */
@@ -783,6 +872,19 @@ public:
     return state_feasibility_;
   }
 
+  /** \brief Set the order in which isStateValid() and isPathValid() run the collision, feasibility and constraint
+   * checks of a state. */
+  void setStateCheckOrder(StateCheckOrder order)
+  {
+    state_check_order_ = order;
+  }
+
+  /** \brief Get the order set by setStateCheckOrder() */
+  StateCheckOrder getStateCheckOrder() const
+  {
+    return state_check_order_;
+  }
+
   /** \brief Specify a predicate that decides whether motion segments are considered valid or invalid for reasons beyond
    * ones covered by collision checking and constraint evaluation.  */
   void setMotionFeasibilityPredicate(const MotionFeasibilityFn& fn)
@@ -893,10 +995,39 @@ public:
                    const moveit_msgs::msg::Constraints& path_constraints, const std::string& group = "",
                    bool verbose = false, std::vector<std::size_t>* invalid_index = nullptr) const;
 
+  /** \brief Check if a given path is valid. Each state is checked for validity (collision avoidance, feasibility and
+   * constraint satisfaction), using the constraint set \e path_constraints that was built and resolved once by the
+   * caller. */
+  bool isPathValid(const robot_trajectory::RobotTrajectory& trajectory,
+                   const kinematic_constraints::KinematicConstraintSet& path_constraints, const std::string& group = "",
+                   bool verbose = false, std::vector<std::size_t>* invalid_index = nullptr) const;
+
   /** \brief Check if a given path is valid. Each state is checked for validity (collision avoidance and feasibility) */
   bool isPathValid(const robot_trajectory::RobotTrajectory& trajectory, const std::string& group = "",
                    bool verbose = false, std::vector<std::size_t>* invalid_index = nullptr) const;
 
+  /** \brief Check if a given path is valid like isPathValid(), but check the waypoints on \e thread_count threads
+   * (0 selects the hardware concurrency). Each thread works on its own RobotState and waypoints after the first
+   * invalid one found so far are skipped. The index of the first invalid waypoint is stored in \e invalid_index,
+   * independent of the number of threads. The state feasibility predicate has to be safe to call concurrently. */
+  bool isPathValidParallel(const robot_trajectory::RobotTrajectory& trajectory,
+                           const moveit_msgs::msg::Constraints& path_constraints,
+                           const std::vector<moveit_msgs::msg::Constraints>& goal_constraints,
+                           const std::string& group = "", std::size_t* invalid_index = nullptr,
+                           std::size_t thread_count = 0) const;
+
+  /** \brief Check if a given path is valid like isPathValid(), checking the waypoints on \e thread_count threads, see
+   * above */
+  bool isPathValidParallel(const robot_trajectory::RobotTrajectory& trajectory, const std::string& group = "",
+                           std::size_t* invalid_index = nullptr, std::size_t thread_count = 0) const;
+
+  /** \brief Check if a given path is valid. Each state is checked for validity (collision avoidance and feasibility),
+   * as isPathValid() does, and each segment between consecutive waypoints is checked for collisions with the world
+   * using isSegmentColliding(). A colliding segment adds the index of its second waypoint to \e invalid_index. This
+   * makes a handful of continuous queries validate a coarsely sampled trajectory without densifying it. */
+  bool isPathValidContinuous(const robot_trajectory::RobotTrajectory& trajectory, const std::string& group = "",
+                             bool verbose = false, std::vector<std::size_t>* invalid_index = nullptr) const;
+
   /** \brief Get the top \e max_costs cost sources for a specified trajectory. The resulting costs are stored in \e
    * costs */
   void getCostSources(const robot_trajectory::RobotTrajectory& trajectory, std::size_t max_costs,
@@ -920,6 +1051,11 @@ public:
   /** \brief Outputs debug information about the planning scene contents */
   void printKnownObjects(std::ostream& out = std::cout) const;
 
+  /** \brief Estimate of the memory in bytes this scene occupies: its world objects including octomaps, and the robot
+   *  state with attached bodies and the allowed collision matrix unless they are inherited from a parent. Shapes shared
+   *  with other scenes are counted; the robot model is not, see RobotModel::getMemoryUsage(). */
+  std::size_t getMemoryUsage() const;
+
   /** \brief Check if a message includes any information about a planning scene, or it is just a default, empty message.
    */
   [[deprecated("Use moveit/utils/message_checks.h instead")]] static bool
@@ -963,6 +1099,12 @@ private:
    * Requires a valid robot_model_ */
   void initialize();
 
+  /* Copy the current state of the parent if this scene does not have its own yet */
+  void ensureOwnCurrentState();
+
+  /* Install the attached body callback of robot_state_, which tracks attached_bodies_version_ */
+  void setCurrentStateAttachedBodyCallback();
+
   /* helper function to create a RobotModel from a urdf/srdf. */
   static moveit::core::RobotModelPtr createRobotModel(const urdf::ModelInterfaceSharedPtr& urdf_model,
                                                       const srdf::ModelConstSharedPtr& srdf_model);
@@ -1032,8 +1174,15 @@ private:
 
   collision_detection::AllowedCollisionMatrixPtr acm_;  // if nullptr use parent's
 
+  // versions of robot_state_, its attached bodies, scene_transforms_ and acm_, unused while they are nullptr
+  std::uint64_t robot_state_version_ = 0;
+  std::uint64_t attached_bodies_version_ = 0;
+  std::uint64_t transforms_version_ = 0;
+  std::uint64_t acm_version_ = 0;
+
   StateFeasibilityFn state_feasibility_;
   MotionFeasibilityFn motion_feasibility_;
+  StateCheckOrder state_check_order_ = StateCheckOrder::COLLISION_FIRST;
 
   std::unique_ptr<ObjectColorMap> object_colors_;
 
@@ -0,0 +1,195 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+#pragma once
+
+#include <moveit/planning_scene/planning_scene.h>
+#include <moveit/robot_model/aabb.h>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "moveit_planning_scene_export.h"
+
+namespace planning_scene
+{
+MOVEIT_CLASS_FORWARD(ShardedPlanningScene);  // Defines ShardedPlanningScenePtr, ConstPtr, WeakPtr... etc
+
+/** \brief A cell of several robots that share one World, with a planning scene per robot.
+ *
+ * Every robot is a shard: a PlanningScene of its own RobotModel over the shared World, with its own collision
+ * environment, allowed collision matrix and current state. Checking or updating one robot therefore only touches that
+ * robot, however many robots the cell has. The robot models must use the frame of the World as their model frame, the
+ * placement of a robot in the cell is part of its model (e.g. a fixed virtual joint).
+ *
+ * Collisions between robots are checked through bounding volumes: the axis-aligned boxes of the links and attached
+ * bodies of the other robots at their current states are kept per shard and only updated when that robot's state
+ * changes. Only the bodies whose boxes overlap a box of the checked robot are handed to the exact check. Their contacts
+ * name the other robot's body "<robot>/<link or attached body>" and report it as a world object.
+ *
+ * Checks may run concurrently with each other, but not with the functions that change shards or their states. The
+ * exact inter-robot checks of one robot are serialized. */
+class MOVEIT_PLANNING_SCENE_EXPORT ShardedPlanningScene
+{
+public:
+  /** \brief A pair of bodies of different robots, each named "<robot>/<link or attached body>" */
+  typedef std::pair<std::string, std::string> BodyPair;
+
+  explicit ShardedPlanningScene(
+      const collision_detection::WorldPtr& world = std::make_shared<collision_detection::World>());
+  ~ShardedPlanningScene();
+
+  ShardedPlanningScene(const ShardedPlanningScene&) = delete;
+  ShardedPlanningScene& operator=(const ShardedPlanningScene&) = delete;
+
+  /** \brief Add a robot named \e name and return its planning scene.
+   *
+   * If \e allocator is given, it is used for the collision environments of this robot, otherwise the default one of
+   * PlanningScene. Throws moveit::ConstructException if a robot of that name exists already. */
+  const PlanningScenePtr&
+  addShard(const std::string& name, const moveit::core::RobotModelConstPtr& robot_model,
+           const collision_detection::CollisionDetectorAllocatorPtr& allocator = nullptr);
+
+  /** \brief Remove the robot \e name, returns false if there is no such robot */
+  bool removeShard(const std::string& name);
+
+  /** \brief Whether there is a robot named \e name */
+  bool hasShard(const std::string& name) const;
+
+  /** \brief The names of the robots, in the order they were added */
+  std::vector<std::string> getShardNames() const;
+
+  /** \brief The planning scene of robot \e name, or nullptr if there is no such robot.
+   *
+   * Its current state must be changed through setCurrentState() of this class, which keeps the bounding volumes in
+   * sync. Changes to its world change the shared World. */
+  const PlanningScenePtr& getShard(const std::string& name) const;
+
+  const collision_detection::WorldConstPtr& getWorld() const
+  {
+    return world_const_;
+  }
+
+  const collision_detection::WorldPtr& getWorldNonConst()
+  {
+    return world_;
+  }
+
+  /** \brief Set the current state of robot \e name. Only the bounding volumes of this robot are updated */
+  bool setCurrentState(const std::string& name, const moveit::core::RobotState& state);
+
+  /** \brief Set the current state of robot \e name from a message, see setCurrentState() */
+  bool setCurrentState(const std::string& name, const moveit_msgs::msg::RobotState& state);
+
+  /** \brief Padding added to the bounding volumes before testing them for overlap (default 0) */
+  void setInterRobotPadding(double padding);
+
+  double getInterRobotPadding() const
+  {
+    return inter_robot_padding_;
+  }
+
+  /** \brief Check robot \e name at \e state for self collisions, collisions with the World and collisions with the
+   * other robots at their current states. \e state must have up to date link transforms. */
+  void checkCollision(const collision_detection::CollisionRequest& req, collision_detection::CollisionResult& res,
+                      const std::string& name, const moveit::core::RobotState& state) const;
+
+  /** \brief Check robot \e name at \e state against the other robots at their current states only */
+  void checkInterRobotCollision(const collision_detection::CollisionRequest& req,
+                                collision_detection::CollisionResult& res, const std::string& name,
+                                const moveit::core::RobotState& state) const;
+
+  /** \brief Check all robots at their current states against each other, every pair of robots once */
+  void checkInterRobotCollision(const collision_detection::CollisionRequest& req,
+                                collision_detection::CollisionResult& res) const;
+
+  /** \brief Return the pairs of bodies of robot \e name at \e state and of the other robots whose bounding volumes
+   * overlap, i.e. the pairs the exact inter-robot check considers */
+  void getCandidateBodyPairs(const std::string& name, const moveit::core::RobotState& state,
+                             std::vector<BodyPair>& pairs) const;
+
+private:
+  /** \brief The bounding box of a link or attached body, and for the other robots also its geometry */
+  struct BodyVolume
+  {
+    std::string id;  // "<robot>/<link or attached body>"
+    moveit::core::AABB box;
+    Eigen::Isometry3d pose;  // of the link the body moves with
+    std::vector<shapes::ShapeConstPtr> shapes;
+    EigenSTL::vector_Isometry3d shape_poses;  // relative to pose
+  };
+
+  struct Shard
+  {
+    std::string name;
+    PlanningScenePtr scene;
+
+    /// Bounding volumes at the current state of scene, and their union
+    std::vector<BodyVolume> volumes;
+    moveit::core::AABB bounds;
+
+    /// The overlapping bodies of the other robots, and the environment of this robot that checks against them
+    collision_detection::WorldPtr others_world;
+    collision_detection::CollisionEnvPtr others_env;
+    mutable std::mutex others_lock;
+  };
+
+  const Shard* findShard(const std::string& name) const;
+  Shard* findShard(const std::string& name);
+
+  /** \brief Compute the volumes of robot \e name at \e state, with their geometry if \e with_shapes */
+  void computeVolumes(const std::string& name, const moveit::core::RobotState& state, bool with_shapes,
+                      std::vector<BodyVolume>& volumes, moveit::core::AABB& bounds) const;
+
+  /** \brief Recompute the volumes of \e shard at its current state */
+  void updateVolumes(Shard& shard) const;
+
+  /** \brief Whether \e a and \e b overlap when padded by the inter-robot padding */
+  bool overlap(const moveit::core::AABB& a, const moveit::core::AABB& b) const;
+
+  /** \brief Collect the bodies of the shards from \e first_other on (except \e shard) that overlap \e volumes */
+  void collectOverlaps(const Shard& shard, const std::vector<BodyVolume>& volumes, const moveit::core::AABB& bounds,
+                       std::size_t first_other, std::vector<BodyPair>* pairs,
+                       std::vector<const BodyVolume*>* bodies) const;
+
+  void checkAgainstOthers(const collision_detection::CollisionRequest& req, collision_detection::CollisionResult& res,
+                          const Shard& shard, const moveit::core::RobotState& state, std::size_t first_other) const;
+
+  collision_detection::WorldPtr world_;
+  collision_detection::WorldConstPtr world_const_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+  double inter_robot_padding_ = 0.0;
+};
+}  // namespace planning_scene
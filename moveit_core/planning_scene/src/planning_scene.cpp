@@ -35,6 +35,7 @@
 /* Author: Ioan Sucan */
 
 #include <boost/algorithm/string.hpp>
+#include <algorithm>
 #include <moveit/planning_scene/planning_scene.h>
 #include <moveit/collision_detection/occupancy_map.h>
 #include <moveit/collision_detection_fcl/collision_detector_allocator_fcl.h>
@@ -44,6 +45,7 @@
 #include <moveit/robot_state/conversions.h>
 #include <moveit/exceptions/exceptions.h>
 #include <moveit/robot_state/attached_body.h>
+#include <moveit/robot_model/memory_usage.h>
 #include <moveit/utils/message_checks.h>
 #include <octomap_msgs/conversions.h>
 #include <rclcpp/logger.hpp>
@@ -53,8 +55,11 @@
 #else
 #include <tf2_eigen/tf2_eigen.h>
 #endif
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <set>
+#include <unordered_map>
 
 namespace planning_scene
 {
@@ -63,6 +68,15 @@ static const rclcpp::Logger LOGGER = rclcpp::get_logger("moveit_planning_scene.p
 const std::string PlanningScene::OCTOMAP_NS = "<octomap>";
 const std::string PlanningScene::DEFAULT_SCENE_NAME = "(noname)";
 
+namespace
+{
+std::uint64_t newVersion()
+{
+  static std::atomic<std::uint64_t> version(0);
+  return ++version;
+}
+}  // namespace
+
 class SceneTransforms : public moveit::core::Transforms
 {
 public:
@@ -157,9 +171,15 @@ void PlanningScene::initialize()
   robot_state_ = std::make_shared<moveit::core::RobotState>(robot_model_);
   robot_state_->setToDefaultValues();
   robot_state_->update();
+  setCurrentStateAttachedBodyCallback();
 
   acm_ = std::make_shared<collision_detection::AllowedCollisionMatrix>(*getRobotModel()->getSRDF());
 
+  robot_state_version_ = newVersion();
+  attached_bodies_version_ = newVersion();
+  transforms_version_ = newVersion();
+  acm_version_ = newVersion();
+
   allocateCollisionDetector(collision_detection::CollisionDetectorAllocatorFCL::create());
 }
 
@@ -478,15 +498,31 @@ const collision_detection::CollisionEnvPtr& PlanningScene::getCollisionEnvNonCon
 
 moveit::core::RobotState& PlanningScene::getCurrentStateNonConst()
 {
-  if (!robot_state_)
-  {
-    robot_state_ = std::make_shared<moveit::core::RobotState>(parent_->getCurrentState());
-    robot_state_->setAttachedBodyUpdateCallback(current_state_attached_body_callback_);
-  }
+  ensureOwnCurrentState();
   robot_state_->update();
+  robot_state_version_ = newVersion();
   return *robot_state_;
 }
 
+void PlanningScene::ensureOwnCurrentState()
+{
+  if (robot_state_)
+    return;
+  robot_state_ = std::make_shared<moveit::core::RobotState>(parent_->getCurrentState());
+  robot_state_version_ = parent_->getCurrentStateVersion();
+  attached_bodies_version_ = parent_->getAttachedBodiesVersion();
+  setCurrentStateAttachedBodyCallback();
+}
+
+void PlanningScene::setCurrentStateAttachedBodyCallback()
+{
+  robot_state_->setAttachedBodyUpdateCallback([this](moveit::core::AttachedBody* body, bool attached) {
+    attached_bodies_version_ = newVersion();
+    if (current_state_attached_body_callback_)
+      current_state_attached_body_callback_(body, attached);
+  });
+}
+
 moveit::core::RobotStatePtr PlanningScene::getCurrentStateUpdated(const moveit_msgs::msg::RobotState& update) const
 {
   auto state = std::make_shared<moveit::core::RobotState>(getCurrentState());
@@ -496,9 +532,8 @@ moveit::core::RobotStatePtr PlanningScene::getCurrentStateUpdated(const moveit_m
 
 void PlanningScene::setAttachedBodyUpdateCallback(const moveit::core::AttachedBodyCallback& callback)
 {
+  // robot_state_ forwards to this callback
   current_state_attached_body_callback_ = callback;
-  if (robot_state_)
-    robot_state_->setAttachedBodyUpdateCallback(callback);
 }
 
 void PlanningScene::setCollisionObjectUpdateCallback(const collision_detection::World::ObserverCallbackFn& callback)
@@ -514,20 +549,23 @@ collision_detection::AllowedCollisionMatrix& PlanningScene::getAllowedCollisionM
 {
   if (!acm_)
     acm_ = std::make_shared<collision_detection::AllowedCollisionMatrix>(parent_->getAllowedCollisionMatrix());
+  acm_version_ = newVersion();
   return *acm_;
 }
 
 const moveit::core::Transforms& PlanningScene::getTransforms()
 {
   // Trigger an update of the robot transforms
-  getCurrentStateNonConst().update();
+  ensureOwnCurrentState();
+  robot_state_->update();
   return static_cast<const PlanningScene*>(this)->getTransforms();
 }
 
 moveit::core::Transforms& PlanningScene::getTransformsNonConst()
 {
   // Trigger an update of the robot transforms
-  getCurrentStateNonConst().update();
+  ensureOwnCurrentState();
+  robot_state_->update();
   if (!scene_transforms_)
   {
     // The only case when there are no transforms is if this planning scene has a parent. When a non-const version of
@@ -535,10 +573,16 @@ moveit::core::Transforms& PlanningScene::getTransformsNonConst()
     scene_transforms_ = std::make_shared<SceneTransforms>(this);
     scene_transforms_->setAllTransforms(parent_->getTransforms().getAllTransforms());
   }
+  transforms_version_ = newVersion();
   return *scene_transforms_;
 }
 
 void PlanningScene::getPlanningSceneDiffMsg(moveit_msgs::msg::PlanningScene& scene_msg) const
+{
+  getPlanningSceneDiffMsg(scene_msg, true);
+}
+
+bool PlanningScene::getPlanningSceneDiffMsg(moveit_msgs::msg::PlanningScene& scene_msg, bool include_octomap) const
 {
   scene_msg.name = name_;
   scene_msg.robot_model_name = getRobotModel()->getName();
@@ -580,9 +624,9 @@ void PlanningScene::getPlanningSceneDiffMsg(moveit_msgs::msg::PlanningScene& sce
   scene_msg.world.collision_objects.clear();
   scene_msg.world.octomap = octomap_msgs::msg::OctomapWithPose();
 
+  bool do_omap = false;
   if (world_diff_)
   {
-    bool do_omap = false;
     for (const std::pair<const std::string, collision_detection::World::Action>& it : *world_diff_)
     {
       if (it.first == OCTOMAP_NS)
@@ -610,7 +654,7 @@ void PlanningScene::getPlanningSceneDiffMsg(moveit_msgs::msg::PlanningScene& sce
         getCollisionObjectMsg(scene_msg.world.collision_objects.back(), it.first);
       }
     }
-    if (do_omap)
+    if (do_omap && include_octomap)
       getOctomapMsg(scene_msg.world.octomap);
   }
 
@@ -627,10 +671,62 @@ void PlanningScene::getPlanningSceneDiffMsg(moveit_msgs::msg::PlanningScene& sce
       scene_msg.robot_state.attached_collision_objects.push_back(aco);
     }
   }
+  return do_omap;
 }
 
 namespace
 {
+// Caches the messages of mesh shapes, which are expensive to construct for large meshes.
+// World shapes are immutable once added, so a shape is identified by its address, guarded by a weak pointer
+// against the address being reused by a new shape.
+class MeshMsgCache
+{
+public:
+  static MeshMsgCache& instance()
+  {
+    static MeshMsgCache cache;
+    return cache;
+  }
+
+  bool constructMsg(const shapes::ShapeConstPtr& shape, shapes::ShapeMsg& shape_msg)
+  {
+    if (shape->type != shapes::MESH)
+      return constructMsgFromShape(shape.get(), shape_msg);
+
+    std::scoped_lock lock(mutex_);
+    auto it = entries_.find(shape.get());
+    if (it == entries_.end() || it->second.shape.lock() != shape)
+    {
+      shapes::ShapeMsg msg;
+      if (!constructMsgFromShape(shape.get(), msg))
+        return false;
+      if (entries_.size() >= 2 * prune_size_)
+        prune();
+      it = entries_.insert_or_assign(shape.get(), Entry{ shape, boost::get<shape_msgs::msg::Mesh>(msg) }).first;
+    }
+    shape_msg = it->second.msg;
+    return true;
+  }
+
+private:
+  struct Entry
+  {
+    std::weak_ptr<const shapes::Shape> shape;
+    shape_msgs::msg::Mesh msg;
+  };
+
+  void prune()
+  {
+    for (auto it = entries_.begin(); it != entries_.end();)
+      it = it->second.shape.expired() ? entries_.erase(it) : std::next(it);
+    prune_size_ = std::max<std::size_t>(entries_.size(), 16);
+  }
+
+  std::mutex mutex_;
+  std::unordered_map<const shapes::Shape*, Entry> entries_;
+  std::size_t prune_size_ = 16;
+};
+
 class ShapeVisitorAddToCollisionObject : public boost::static_visitor<void>
 {
 public:
@@ -681,7 +777,7 @@ bool PlanningScene::getCollisionObjectMsg(moveit_msgs::msg::CollisionObject& col
   for (std::size_t j = 0; j < obj->shapes_.size(); ++j)
   {
     shapes::ShapeMsg sm;
-    if (constructMsgFromShape(obj->shapes_[j].get(), sm))
+    if (MeshMsgCache::instance().constructMsg(obj->shapes_[j], sm))
     {
       geometry_msgs::msg::Pose p = tf2::toMsg(obj->shape_poses_[j]);
       sv.setPoseMessage(&p);
@@ -1069,15 +1165,12 @@ void PlanningScene::setCurrentState(const moveit_msgs::msg::RobotState& state)
 
   if (parent_)
   {
-    if (!robot_state_)
-    {
-      robot_state_ = std::make_shared<moveit::core::RobotState>(parent_->getCurrentState());
-      robot_state_->setAttachedBodyUpdateCallback(current_state_attached_body_callback_);
-    }
+    ensureOwnCurrentState();
     moveit::core::robotStateMsgToRobotState(getTransforms(), state_no_attached, *robot_state_);
   }
   else
     moveit::core::robotStateMsgToRobotState(*scene_transforms_, state_no_attached, *robot_state_);
+  robot_state_version_ = newVersion();
 
   for (std::size_t i = 0; i < state.attached_collision_objects.size(); ++i)
   {
@@ -1108,16 +1201,16 @@ void PlanningScene::decoupleParent()
   {
     scene_transforms_ = std::make_shared<SceneTransforms>(this);
     scene_transforms_->setAllTransforms(parent_->getTransforms().getAllTransforms());
+    transforms_version_ = parent_->getTransformsVersion();
   }
 
-  if (!robot_state_)
-  {
-    robot_state_ = std::make_shared<moveit::core::RobotState>(parent_->getCurrentState());
-    robot_state_->setAttachedBodyUpdateCallback(current_state_attached_body_callback_);
-  }
+  ensureOwnCurrentState();
 
   if (!acm_)
+  {
     acm_ = std::make_shared<collision_detection::AllowedCollisionMatrix>(parent_->getAllowedCollisionMatrix());
+    acm_version_ = parent_->getAllowedCollisionMatrixVersion();
+  }
 
   world_diff_.reset();
 
@@ -1125,7 +1218,7 @@ void PlanningScene::decoupleParent()
   {
     ObjectColorMap kc;
     parent_->getKnownObjectColors(kc);
-    object_colors_ = std::make_unique<ObjectColorMap>(kc);
+    object_colors_ = std::make_unique<ObjectColorMap>(std::move(kc));
   }
   else
   {
@@ -1140,7 +1233,7 @@ void PlanningScene::decoupleParent()
   {
     ObjectTypeMap kc;
     parent_->getKnownObjectTypes(kc);
-    object_types_ = std::make_unique<ObjectTypeMap>(kc);
+    object_types_ = std::make_unique<ObjectTypeMap>(std::move(kc));
   }
   else
   {
@@ -1154,6 +1247,100 @@ void PlanningScene::decoupleParent()
   parent_.reset();
 }
 
+struct PlanningSceneCheckpoint
+{
+  const PlanningScene* scene;
+  PlanningSceneConstPtr parent;
+  collision_detection::WorldConstPtr world;
+
+  // nullptr if the scene used the parent's component
+  moveit::core::RobotStateConstPtr robot_state;
+  std::unique_ptr<moveit::core::FixedTransformsMap> transforms;
+  collision_detection::AllowedCollisionMatrixConstPtr acm;
+  std::unique_ptr<ObjectColorMap> object_colors;
+  std::unique_ptr<ObjectTypeMap> object_types;
+
+  std::uint64_t robot_state_version;
+  std::uint64_t attached_bodies_version;
+  std::uint64_t transforms_version;
+  std::uint64_t acm_version;
+};
+
+PlanningSceneCheckpointConstPtr PlanningScene::checkpoint() const
+{
+  auto cp = std::make_shared<PlanningSceneCheckpoint>();
+  cp->scene = this;
+  cp->parent = parent_;
+  cp->world = std::make_shared<const collision_detection::World>(*world_);
+  if (robot_state_)
+    cp->robot_state = std::make_shared<const moveit::core::RobotState>(*robot_state_);
+  if (scene_transforms_)
+    cp->transforms = std::make_unique<moveit::core::FixedTransformsMap>(scene_transforms_->getAllTransforms());
+  if (acm_)
+    cp->acm = std::make_shared<const collision_detection::AllowedCollisionMatrix>(*acm_);
+  if (object_colors_)
+    cp->object_colors = std::make_unique<ObjectColorMap>(*object_colors_);
+  if (object_types_)
+    cp->object_types = std::make_unique<ObjectTypeMap>(*object_types_);
+  cp->robot_state_version = robot_state_version_;
+  cp->attached_bodies_version = attached_bodies_version_;
+  cp->transforms_version = transforms_version_;
+  cp->acm_version = acm_version_;
+  return cp;
+}
+
+bool PlanningScene::rollback(const PlanningSceneCheckpointConstPtr& checkpoint)
+{
+  if (!checkpoint || checkpoint->scene != this || checkpoint->parent != parent_)
+  {
+    RCLCPP_ERROR(LOGGER, "Cannot roll back to a checkpoint of another planning scene");
+    return false;
+  }
+
+  // only the objects changed since the checkpoint produce notifications (and collision environment updates)
+  world_->restore(*checkpoint->world);
+
+  if (!checkpoint->robot_state)
+    robot_state_.reset();
+  else if (robot_state_)
+    *robot_state_ = *checkpoint->robot_state;
+  else
+  {
+    robot_state_ = std::make_shared<moveit::core::RobotState>(*checkpoint->robot_state);
+    setCurrentStateAttachedBodyCallback();
+  }
+
+  if (!checkpoint->transforms)
+    scene_transforms_.reset();
+  else
+  {
+    if (!scene_transforms_)
+      scene_transforms_ = std::make_shared<SceneTransforms>(this);
+    scene_transforms_->setAllTransforms(*checkpoint->transforms);
+  }
+
+  if (checkpoint->acm)
+    acm_ = std::make_shared<collision_detection::AllowedCollisionMatrix>(*checkpoint->acm);
+  else
+    acm_.reset();
+
+  if (checkpoint->object_colors)
+    object_colors_ = std::make_unique<ObjectColorMap>(*checkpoint->object_colors);
+  else
+    object_colors_.reset();
+  if (checkpoint->object_types)
+    object_types_ = std::make_unique<ObjectTypeMap>(*checkpoint->object_types);
+  else
+    object_types_.reset();
+
+  // the contents equal those of the checkpoint again
+  robot_state_version_ = checkpoint->robot_state_version;
+  attached_bodies_version_ = checkpoint->attached_bodies_version;
+  transforms_version_ = checkpoint->transforms_version;
+  acm_version_ = checkpoint->acm_version;
+  return true;
+}
+
 bool PlanningScene::setPlanningSceneDiffMsg(const moveit_msgs::msg::PlanningScene& scene_msg)
 {
   bool result = true;
@@ -1173,6 +1360,7 @@ bool PlanningScene::setPlanningSceneDiffMsg(const moveit_msgs::msg::PlanningScen
     if (!scene_transforms_)
       scene_transforms_ = std::make_shared<SceneTransforms>(this);
     scene_transforms_->setTransforms(scene_msg.fixed_frame_transforms);
+    transforms_version_ = newVersion();
   }
 
   // if at least some joints have been specified, we set them
@@ -1182,7 +1370,10 @@ bool PlanningScene::setPlanningSceneDiffMsg(const moveit_msgs::msg::PlanningScen
 
   // if at least some links are mentioned in the allowed collision matrix, then we have an update
   if (!scene_msg.allowed_collision_matrix.entry_names.empty())
+  {
     acm_ = std::make_shared<collision_detection::AllowedCollisionMatrix>(scene_msg.allowed_collision_matrix);
+    acm_version_ = newVersion();
+  }
 
   if (!scene_msg.link_padding.empty() || !scene_msg.link_scale.empty())
   {
@@ -1219,8 +1410,10 @@ bool PlanningScene::setPlanningSceneMsg(const moveit_msgs::msg::PlanningScene& s
 
   object_types_.reset();
   scene_transforms_->setTransforms(scene_msg.fixed_frame_transforms);
+  transforms_version_ = newVersion();
   setCurrentState(scene_msg.robot_state);
   acm_ = std::make_shared<collision_detection::AllowedCollisionMatrix>(scene_msg.allowed_collision_matrix);
+  acm_version_ = newVersion();
   collision_detector_->cenv_->setPadding(scene_msg.link_padding);
   collision_detector_->cenv_->setScale(scene_msg.link_scale);
   object_colors_ = std::make_unique<ObjectColorMap>();
@@ -1342,6 +1535,9 @@ void PlanningScene::processOctomapPtr(const std::shared_ptr<const octomap::OcTre
         // if the pose changed, we update it
         if (map->shape_poses_[0].isApprox(t, std::numeric_limits<double>::epsilon() * 100.0))
         {
+          // the tree was modified in place; observers such as distance fields need to pick up the new contents
+          map.reset();
+          world_->notifyShapesUpdated(OCTOMAP_NS);
           if (world_diff_)
             world_diff_->set(OCTOMAP_NS, collision_detection::World::DESTROY | collision_detection::World::CREATE |
                                              collision_detection::World::ADD_SHAPE);
@@ -1376,11 +1572,7 @@ bool PlanningScene::processAttachedCollisionObjectMsg(const moveit_msgs::msg::At
     return false;
   }
 
-  if (!robot_state_)  // there must be a parent in this case
-  {
-    robot_state_ = std::make_shared<moveit::core::RobotState>(parent_->getCurrentState());
-    robot_state_->setAttachedBodyUpdateCallback(current_state_attached_body_callback_);
-  }
+  ensureOwnCurrentState();  // there must be a parent if robot_state_ is nullptr
   robot_state_->update();
 
   // The ADD/REMOVE operations follow this order:
@@ -1962,6 +2154,17 @@ bool PlanningScene::isStateColliding(const moveit::core::RobotState& state, cons
   return res.collision;
 }
 
+bool PlanningScene::isSegmentColliding(const moveit::core::RobotState& from, const moveit::core::RobotState& to,
+                                       const std::string& group, bool verbose) const
+{
+  collision_detection::CollisionRequest req;
+  req.verbose = verbose;
+  req.group_name = group;
+  collision_detection::CollisionResult res;
+  getCollisionEnv()->checkRobotCollision(req, res, from, to, getAllowedCollisionMatrix());
+  return res.collision;
+}
+
 bool PlanningScene::isStateFeasible(const moveit_msgs::msg::RobotState& state, bool verbose) const
 {
   if (state_feasibility_)
@@ -2037,6 +2240,14 @@ bool PlanningScene::isStateValid(const moveit_msgs::msg::RobotState& state, cons
 bool PlanningScene::isStateValid(const moveit::core::RobotState& state, const moveit_msgs::msg::Constraints& constr,
                                  const std::string& group, bool verbose) const
 {
+  if (state_check_order_ == StateCheckOrder::CONSTRAINTS_FIRST)
+  {
+    kinematic_constraints::KinematicConstraintSet ks(getRobotModel());
+    ks.add(constr, getTransforms());
+    return isStateValid(state, ks, group, verbose);
+  }
+
+  // the constraint set is only built for states that pass the other checks
   if (isStateColliding(state, group, verbose))
     return false;
   if (!isStateFeasible(state, verbose))
@@ -2048,6 +2259,15 @@ bool PlanningScene::isStateValid(const moveit::core::RobotState& state,
                                  const kinematic_constraints::KinematicConstraintSet& constr, const std::string& group,
                                  bool verbose) const
 {
+  if (state_check_order_ == StateCheckOrder::CONSTRAINTS_FIRST)
+  {
+    if (!isStateConstrained(state, constr, verbose))
+      return false;
+    if (!isStateFeasible(state, verbose))
+      return false;
+    return !isStateColliding(state, group, verbose);
+  }
+
   if (isStateColliding(state, group, verbose))
     return false;
   if (!isStateFeasible(state, verbose))
@@ -2100,24 +2320,64 @@ bool PlanningScene::isPathValid(const robot_trajectory::RobotTrajectory& traject
                                 const moveit_msgs::msg::Constraints& path_constraints,
                                 const std::vector<moveit_msgs::msg::Constraints>& goal_constraints,
                                 const std::string& group, bool verbose, std::vector<std::size_t>* invalid_index) const
+{
+  kinematic_constraints::KinematicConstraintSet ks_p(getRobotModel());
+  ks_p.add(path_constraints, getTransforms());
+  bool result = isPathValid(trajectory, ks_p, group, verbose, invalid_index);
+  if (!result && !invalid_index)
+    return false;
+
+  // check goal for last state
+  const std::size_t n_wp = trajectory.getWayPointCount();
+  if (n_wp > 0 && !goal_constraints.empty())
+  {
+    const moveit::core::RobotState& st = trajectory.getLastWayPoint();
+    bool found = false;
+    for (const moveit_msgs::msg::Constraints& goal_constraint : goal_constraints)
+    {
+      if (isStateConstrained(st, goal_constraint))
+      {
+        found = true;
+        break;
+      }
+    }
+    if (!found)
+    {
+      if (verbose)
+        RCLCPP_INFO(LOGGER, "Goal not satisfied");
+      if (invalid_index)
+        invalid_index->push_back(n_wp - 1);
+      result = false;
+    }
+  }
+  return result;
+}
+
+bool PlanningScene::isPathValid(const robot_trajectory::RobotTrajectory& trajectory,
+                                const kinematic_constraints::KinematicConstraintSet& path_constraints,
+                                const std::string& group, bool verbose, std::vector<std::size_t>* invalid_index) const
 {
   bool result = true;
   if (invalid_index)
     invalid_index->clear();
-  kinematic_constraints::KinematicConstraintSet ks_p(getRobotModel());
-  ks_p.add(path_constraints, getTransforms());
   std::size_t n_wp = trajectory.getWayPointCount();
   for (std::size_t i = 0; i < n_wp; ++i)
   {
     const moveit::core::RobotState& st = trajectory.getWayPoint(i);
 
     bool this_state_valid = true;
-    if (isStateColliding(st, group, verbose))
-      this_state_valid = false;
-    if (!isStateFeasible(st, verbose))
-      this_state_valid = false;
-    if (!ks_p.empty() && !ks_p.decide(st, verbose).satisfied)
-      this_state_valid = false;
+    if (verbose)
+    {
+      // explain every reason a state is invalid
+      if (isStateColliding(st, group, verbose))
+        this_state_valid = false;
+      if (!isStateFeasible(st, verbose))
+        this_state_valid = false;
+      if (!path_constraints.empty() && !path_constraints.decide(st, verbose).satisfied)
+        this_state_valid = false;
+    }
+    else
+      this_state_valid = isStateValid(st, path_constraints, group, false);
 
     if (!this_state_valid)
     {
@@ -2127,28 +2387,6 @@ bool PlanningScene::isPathValid(const robot_trajectory::RobotTrajectory& traject
         return false;
       result = false;
     }
-
-    // check goal for last state
-    if (i + 1 == n_wp && !goal_constraints.empty())
-    {
-      bool found = false;
-      for (const moveit_msgs::msg::Constraints& goal_constraint : goal_constraints)
-      {
-        if (isStateConstrained(st, goal_constraint))
-        {
-          found = true;
-          break;
-        }
-      }
-      if (!found)
-      {
-        if (verbose)
-          RCLCPP_INFO(LOGGER, "Goal not satisfied");
-        if (invalid_index)
-          invalid_index->push_back(i);
-        result = false;
-      }
-    }
   }
   return result;
 }
@@ -2178,6 +2416,109 @@ bool PlanningScene::isPathValid(const robot_trajectory::RobotTrajectory& traject
   return isPathValid(trajectory, EMP_CONSTRAINTS, EMP_CONSTRAINTS_VECTOR, group, verbose, invalid_index);
 }
 
+bool PlanningScene::isPathValidParallel(const robot_trajectory::RobotTrajectory& trajectory,
+                                        const moveit_msgs::msg::Constraints& path_constraints,
+                                        const std::vector<moveit_msgs::msg::Constraints>& goal_constraints,
+                                        const std::string& group, std::size_t* invalid_index,
+                                        std::size_t thread_count) const
+{
+  // spawning a thread costs about as much as checking a few waypoints
+  static const std::size_t MIN_WAYPOINTS_PER_THREAD = 16;
+
+  kinematic_constraints::KinematicConstraintSet ks_p(getRobotModel());
+  ks_p.add(path_constraints, getTransforms());
+  const std::size_t n_wp = trajectory.getWayPointCount();
+
+  if (thread_count == 0)
+    thread_count = std::thread::hardware_concurrency();
+  thread_count = std::max<std::size_t>(1, std::min(thread_count, n_wp / MIN_WAYPOINTS_PER_THREAD));
+
+  // waypoints are handed out in increasing order, so all waypoints before first_invalid have been checked once the
+  // workers are done, which makes the result independent of the scheduling
+  std::atomic<std::size_t> next(0);
+  std::atomic<std::size_t> first_invalid(n_wp);
+  auto worker = [&]() {
+    std::unique_ptr<moveit::core::RobotState> scratch;
+    for (std::size_t i = next++; i < first_invalid; i = next++)
+    {
+      const moveit::core::RobotState* st = &trajectory.getWayPoint(i);
+      if (st->dirtyCollisionBodyTransforms())
+      {
+        if (!scratch)
+          scratch = std::make_unique<moveit::core::RobotState>(*st);
+        else
+          *scratch = *st;
+        scratch->updateCollisionBodyTransforms();
+        st = scratch.get();
+      }
+      if (!isStateColliding(*st, group) && isStateFeasible(*st) && (ks_p.empty() || ks_p.decide(*st).satisfied))
+        continue;
+
+      std::size_t current = first_invalid;
+      while (i < current && !first_invalid.compare_exchange_weak(current, i))
+      {
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(thread_count - 1);
+  for (std::size_t t = 1; t < thread_count; ++t)
+    threads.emplace_back(worker);
+  worker();
+  for (std::thread& thread : threads)
+    thread.join();
+
+  std::size_t result = first_invalid;
+  // check goal for last state
+  if (result == n_wp && n_wp > 0 && !goal_constraints.empty())
+  {
+    const moveit::core::RobotState& st = trajectory.getLastWayPoint();
+    if (std::none_of(goal_constraints.begin(), goal_constraints.end(),
+                     [&](const moveit_msgs::msg::Constraints& goal) { return isStateConstrained(st, goal); }))
+      result = n_wp - 1;
+  }
+
+  if (result == n_wp)
+    return true;
+  if (invalid_index)
+    *invalid_index = result;
+  return false;
+}
+
+bool PlanningScene::isPathValidParallel(const robot_trajectory::RobotTrajectory& trajectory, const std::string& group,
+                                        std::size_t* invalid_index, std::size_t thread_count) const
+{
+  static const moveit_msgs::msg::Constraints EMP_CONSTRAINTS;
+  static const std::vector<moveit_msgs::msg::Constraints> EMP_CONSTRAINTS_VECTOR;
+  return isPathValidParallel(trajectory, EMP_CONSTRAINTS, EMP_CONSTRAINTS_VECTOR, group, invalid_index,
+                             thread_count);
+}
+
+bool PlanningScene::isPathValidContinuous(const robot_trajectory::RobotTrajectory& trajectory, const std::string& group,
+                                          bool verbose, std::vector<std::size_t>* invalid_index) const
+{
+  bool result = isPathValid(trajectory, group, verbose, invalid_index);
+  if (!result && !invalid_index)
+    return false;
+
+  for (std::size_t i = 1; i < trajectory.getWayPointCount(); ++i)
+  {
+    if (!isSegmentColliding(trajectory.getWayPoint(i - 1), trajectory.getWayPoint(i), group, verbose))
+      continue;
+    if (verbose)
+      RCLCPP_INFO(LOGGER, "Segment from waypoint %zu to %zu is in collision", i - 1, i);
+    if (!invalid_index)
+      return false;
+    if (std::find(invalid_index->begin(), invalid_index->end(), i) == invalid_index->end())
+      invalid_index->push_back(i);
+    result = false;
+  }
+  if (invalid_index)
+    std::sort(invalid_index->begin(), invalid_index->end());
+  return result;
+}
+
 void PlanningScene::getCostSources(const robot_trajectory::RobotTrajectory& trajectory, std::size_t max_costs,
                                    std::set<collision_detection::CostSource>& costs, double overlap_fraction) const
 {
@@ -2237,6 +2578,58 @@ void PlanningScene::getCostSources(const moveit::core::RobotState& state, std::s
   cres.cost_sources.swap(costs);
 }
 
+std::size_t PlanningScene::getMemoryUsage() const
+{
+  std::size_t size = sizeof(PlanningScene);
+  std::set<const shapes::Shape*> counted_shapes;
+  const auto add_shapes = [&size, &counted_shapes](const std::vector<shapes::ShapeConstPtr>& shapes) {
+    for (const shapes::ShapeConstPtr& shape : shapes)
+      if (shape && counted_shapes.insert(shape.get()).second)
+        size += moveit::core::getShapeMemoryUsage(*shape);
+  };
+
+  for (const auto& object : *world_)
+  {
+    size += sizeof(collision_detection::World::Object) + object.first.capacity() +
+            object.second->shapes_.size() * (sizeof(shapes::ShapeConstPtr) + 2 * sizeof(Eigen::Isometry3d)) +
+            (object.second->subframe_poses_.size() + object.second->global_subframe_poses_.size()) *
+                (sizeof(std::string) + sizeof(Eigen::Isometry3d));
+    add_shapes(object.second->shapes_);
+  }
+  if (world_diff_)
+    size += sizeof(collision_detection::WorldDiff) + world_diff_->size() * (sizeof(std::string) +
+                                                                            sizeof(collision_detection::World::Action) +
+                                                                            4 * sizeof(void*));
+
+  if (robot_state_)
+  {
+    // positions, velocities, accelerations and efforts, and the link, joint and collision body transforms
+    size += sizeof(moveit::core::RobotState) + robot_model_->getVariableCount() * 4 * sizeof(double) +
+            (robot_model_->getLinkModelCount() + robot_model_->getJointModelCount() +
+             robot_model_->getLinkGeometryCount()) *
+                sizeof(Eigen::Isometry3d);
+    std::vector<const moveit::core::AttachedBody*> attached_bodies;
+    robot_state_->getAttachedBodies(attached_bodies);
+    for (const moveit::core::AttachedBody* attached_body : attached_bodies)
+    {
+      size += sizeof(moveit::core::AttachedBody) +
+              attached_body->getShapes().size() * (sizeof(shapes::ShapeConstPtr) + 2 * sizeof(Eigen::Isometry3d));
+      add_shapes(attached_body->getShapes());
+    }
+  }
+
+  // a row of entries per name, in maps of strings
+  if (acm_)
+    size += acm_->getSize() * (acm_->getSize() + 1) * (sizeof(std::string) + 4 * sizeof(void*));
+
+  if (object_colors_)
+    size += object_colors_->size() * (sizeof(std::string) + sizeof(std_msgs::msg::ColorRGBA) + 4 * sizeof(void*));
+  if (object_types_)
+    size += object_types_->size() * (sizeof(std::string) + sizeof(object_recognition_msgs::msg::ObjectType) +
+                                     4 * sizeof(void*));
+  return size;
+}
+
 void PlanningScene::printKnownObjects(std::ostream& out) const
 {
   const std::vector<std::string>& objects = getWorld()->getObjectIds();
@@ -36,13 +36,50 @@
 
 #include <memory>
 #include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
 #include <pybind11/stl.h>
+#include <moveit/python/pybind_batch.h>
 #include <moveit/python/pybind_rosmsg_typecasters.h>
 #include <moveit/planning_scene/planning_scene.h>
 
 namespace py = pybind11;
 using namespace planning_scene;
 
+namespace
+{
+/** Check the current state with each row of \e positions as its variable positions, without holding the GIL */
+py::array_t<bool> checkCollisionBatch(const PlanningScene& scene,
+                                      const py::array_t<double, py::array::c_style | py::array::forcecast>& positions,
+                                      const collision_detection::CollisionRequest& req)
+{
+  const moveit::core::RobotState& current = scene.getCurrentState();
+  const std::size_t columns = current.getVariableCount();
+  const std::size_t count = moveit::python::checkBatchShape(positions, columns, "positions");
+
+  std::vector<std::unique_ptr<moveit::core::RobotState>> states(count);
+  std::vector<const moveit::core::RobotState*> state_ptrs(count);
+  const double* in = positions.data();
+  moveit::python::runBatch(count, 0, [&](std::size_t /*thread*/, std::size_t i) {
+    states[i] = std::make_unique<moveit::core::RobotState>(current);
+    states[i]->setVariablePositions(in + i * columns);
+    states[i]->updateCollisionBodyTransforms();
+    state_ptrs[i] = states[i].get();
+  });
+
+  std::vector<collision_detection::CollisionResult> results;
+  {
+    py::gil_scoped_release release;
+    scene.getCollisionEnv()->checkCollisionBatch(req, results, state_ptrs, scene.getAllowedCollisionMatrix());
+  }
+
+  py::array_t<bool> collision(count);
+  bool* out = collision.mutable_data();
+  for (std::size_t i = 0; i < count; ++i)
+    out[i] = results[i].collision;
+  return collision;
+}
+}  // namespace
+
 void def_planning_scene_bindings(py::module& m)
 {
   m.doc() = "The planning scene represents the state of the world and the robot, "
@@ -65,6 +102,10 @@ void def_planning_scene_bindings(py::module& m)
            py::overload_cast<const collision_detection::CollisionRequest&, collision_detection::CollisionResult&,
                              const robot_state::RobotState&, const collision_detection::AllowedCollisionMatrix&>(
                &PlanningScene::checkCollision, py::const_))
+      .def("checkCollisionBatch", &checkCollisionBatch, py::arg("positions"),
+           py::arg("req") = collision_detection::CollisionRequest(),
+           "Collision flags, shape (N,), for the current state with each row of an (N, variables) array as its "
+           "positions. The states are checked concurrently in C++ without holding the GIL.")
       .def("getCurrentStateNonConst", &PlanningScene::getCurrentStateNonConst)
       .def("getCurrentState", &PlanningScene::getCurrentState)
       .def("getAllowedCollisionMatrix", &PlanningScene::getAllowedCollisionMatrix)
@@ -0,0 +1,348 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/planning_scene/sharded_planning_scene.h>
+#include <moveit/collision_detection_fcl/collision_detector_allocator_fcl.h>
+#include <moveit/exceptions/exceptions.h>
+#include <moveit/robot_state/attached_body.h>
+#include <geometric_shapes/shape_operations.h>
+#include <rclcpp/logger.hpp>
+#include <rclcpp/logging.hpp>
+#include <algorithm>
+#include <set>
+
+namespace planning_scene
+{
+static const rclcpp::Logger LOGGER = rclcpp::get_logger("moveit_planning_scene.sharded_planning_scene");
+
+ShardedPlanningScene::ShardedPlanningScene(const collision_detection::WorldPtr& world)
+  : world_(world), world_const_(world)
+{
+}
+
+ShardedPlanningScene::~ShardedPlanningScene() = default;
+
+const PlanningScenePtr&
+ShardedPlanningScene::addShard(const std::string& name, const moveit::core::RobotModelConstPtr& robot_model,
+                               const collision_detection::CollisionDetectorAllocatorPtr& allocator)
+{
+  if (findShard(name))
+    throw moveit::ConstructException("A robot named '" + name + "' is part of the scene already");
+
+  auto shard = std::make_unique<Shard>();
+  shard->name = name;
+  shard->scene = std::make_shared<PlanningScene>(robot_model, world_);
+  if (allocator)
+    shard->scene->allocateCollisionDetector(allocator);
+
+  // the other robots are checked with the same collision detector, padding and scaling as the World is
+  const collision_detection::CollisionDetectorAllocatorPtr others_allocator =
+      allocator ? allocator : collision_detection::CollisionDetectorAllocatorFCL::create();
+  shard->others_world = std::make_shared<collision_detection::World>();
+  shard->others_env = others_allocator->allocateEnv(shard->others_world, robot_model);
+  shard->others_env->setLinkPadding(shard->scene->getCollisionEnv()->getLinkPadding());
+  shard->others_env->setLinkScale(shard->scene->getCollisionEnv()->getLinkScale());
+
+  updateVolumes(*shard);
+  shards_.push_back(std::move(shard));
+  return shards_.back()->scene;
+}
+
+bool ShardedPlanningScene::removeShard(const std::string& name)
+{
+  auto it = std::find_if(shards_.begin(), shards_.end(),
+                         [&name](const std::unique_ptr<Shard>& shard) { return shard->name == name; });
+  if (it == shards_.end())
+    return false;
+  shards_.erase(it);
+
+  // drop the bodies of the removed robot from the environments of the others
+  const std::string prefix = name + "/";
+  for (const std::unique_ptr<Shard>& shard : shards_)
+    for (const std::string& id : shard->others_world->getObjectIds())
+      if (id.compare(0, prefix.size(), prefix) == 0)
+        shard->others_world->removeObject(id);
+  return true;
+}
+
+bool ShardedPlanningScene::hasShard(const std::string& name) const
+{
+  return findShard(name) != nullptr;
+}
+
+std::vector<std::string> ShardedPlanningScene::getShardNames() const
+{
+  std::vector<std::string> names;
+  names.reserve(shards_.size());
+  for (const std::unique_ptr<Shard>& shard : shards_)
+    names.push_back(shard->name);
+  return names;
+}
+
+const PlanningScenePtr& ShardedPlanningScene::getShard(const std::string& name) const
+{
+  static const PlanningScenePtr EMPTY;
+  const Shard* shard = findShard(name);
+  return shard ? shard->scene : EMPTY;
+}
+
+bool ShardedPlanningScene::setCurrentState(const std::string& name, const moveit::core::RobotState& state)
+{
+  Shard* shard = findShard(name);
+  if (!shard)
+  {
+    RCLCPP_ERROR(LOGGER, "Unknown robot '%s'", name.c_str());
+    return false;
+  }
+  shard->scene->setCurrentState(state);
+  updateVolumes(*shard);
+  return true;
+}
+
+bool ShardedPlanningScene::setCurrentState(const std::string& name, const moveit_msgs::msg::RobotState& state)
+{
+  Shard* shard = findShard(name);
+  if (!shard)
+  {
+    RCLCPP_ERROR(LOGGER, "Unknown robot '%s'", name.c_str());
+    return false;
+  }
+  shard->scene->setCurrentState(state);
+  updateVolumes(*shard);
+  return true;
+}
+
+void ShardedPlanningScene::setInterRobotPadding(double padding)
+{
+  inter_robot_padding_ = std::max(0.0, padding);
+}
+
+void ShardedPlanningScene::checkCollision(const collision_detection::CollisionRequest& req,
+                                          collision_detection::CollisionResult& res, const std::string& name,
+                                          const moveit::core::RobotState& state) const
+{
+  const Shard* shard = findShard(name);
+  if (!shard)
+  {
+    RCLCPP_ERROR(LOGGER, "Unknown robot '%s'", name.c_str());
+    return;
+  }
+  shard->scene->checkCollision(req, res, state);
+  if (!res.collision || (req.contacts && res.contacts.size() < req.max_contacts))
+    checkAgainstOthers(req, res, *shard, state, 0);
+}
+
+void ShardedPlanningScene::checkInterRobotCollision(const collision_detection::CollisionRequest& req,
+                                                    collision_detection::CollisionResult& res,
+                                                    const std::string& name,
+                                                    const moveit::core::RobotState& state) const
+{
+  const Shard* shard = findShard(name);
+  if (!shard)
+  {
+    RCLCPP_ERROR(LOGGER, "Unknown robot '%s'", name.c_str());
+    return;
+  }
+  checkAgainstOthers(req, res, *shard, state, 0);
+}
+
+void ShardedPlanningScene::checkInterRobotCollision(const collision_detection::CollisionRequest& req,
+                                                    collision_detection::CollisionResult& res) const
+{
+  // every robot is checked against the ones after it only
+  for (std::size_t i = 0; i + 1 < shards_.size(); ++i)
+  {
+    if (res.collision && (!req.contacts || res.contacts.size() >= req.max_contacts))
+      return;
+    checkAgainstOthers(req, res, *shards_[i], shards_[i]->scene->getCurrentState(), i + 1);
+  }
+}
+
+void ShardedPlanningScene::getCandidateBodyPairs(const std::string& name, const moveit::core::RobotState& state,
+                                                 std::vector<BodyPair>& pairs) const
+{
+  pairs.clear();
+  const Shard* shard = findShard(name);
+  if (!shard)
+  {
+    RCLCPP_ERROR(LOGGER, "Unknown robot '%s'", name.c_str());
+    return;
+  }
+  std::vector<BodyVolume> volumes;
+  moveit::core::AABB bounds;
+  computeVolumes(name, state, false, volumes, bounds);
+  collectOverlaps(*shard, volumes, bounds, 0, &pairs, nullptr);
+}
+
+const ShardedPlanningScene::Shard* ShardedPlanningScene::findShard(const std::string& name) const
+{
+  for (const std::unique_ptr<Shard>& shard : shards_)
+    if (shard->name == name)
+      return shard.get();
+  return nullptr;
+}
+
+ShardedPlanningScene::Shard* ShardedPlanningScene::findShard(const std::string& name)
+{
+  return const_cast<Shard*>(static_cast<const ShardedPlanningScene*>(this)->findShard(name));
+}
+
+void ShardedPlanningScene::computeVolumes(const std::string& name, const moveit::core::RobotState& state,
+                                          bool with_shapes, std::vector<BodyVolume>& volumes,
+                                          moveit::core::AABB& bounds) const
+{
+  volumes.clear();
+  bounds = moveit::core::AABB();
+
+  for (const moveit::core::LinkModel* link : state.getRobotModel()->getLinkModelsWithCollisionGeometry())
+  {
+    volumes.emplace_back();
+    BodyVolume& volume = volumes.back();
+    volume.id = name + "/" + link->getName();
+    Eigen::Isometry3d transform = state.getGlobalLinkTransform(link);  // intentional copy, we will translate
+    if (with_shapes)
+    {
+      volume.pose = transform;
+      volume.shapes = link->getShapes();
+      volume.shape_poses = link->getCollisionOriginTransforms();
+    }
+    transform.translate(link->getCenteredBoundingBoxOffset());
+    volume.box.extendWithTransformedBox(transform, link->getShapeExtentsAtOrigin());
+    bounds.extend(volume.box);
+  }
+
+  std::vector<const moveit::core::AttachedBody*> attached_bodies;
+  state.getAttachedBodies(attached_bodies);
+  for (const moveit::core::AttachedBody* attached_body : attached_bodies)
+  {
+    volumes.emplace_back();
+    BodyVolume& volume = volumes.back();
+    volume.id = name + "/" + attached_body->getName();
+    const EigenSTL::vector_Isometry3d& transforms = attached_body->getGlobalCollisionBodyTransforms();
+    const std::vector<shapes::ShapeConstPtr>& shapes = attached_body->getShapes();
+    for (std::size_t i = 0; i < transforms.size(); ++i)
+      volume.box.extendWithTransformedBox(transforms[i], shapes::computeShapeExtents(shapes[i].get()));
+    if (with_shapes)
+    {
+      volume.pose = state.getGlobalLinkTransform(attached_body->getAttachedLink());
+      volume.shapes = shapes;
+      volume.shape_poses = attached_body->getShapePosesInLinkFrame();
+    }
+    bounds.extend(volume.box);
+  }
+}
+
+void ShardedPlanningScene::updateVolumes(Shard& shard) const
+{
+  computeVolumes(shard.name, shard.scene->getCurrentStateNonConst(), true, shard.volumes, shard.bounds);
+}
+
+bool ShardedPlanningScene::overlap(const moveit::core::AABB& a, const moveit::core::AABB& b) const
+{
+  // empty boxes have min > max and never overlap
+  return (a.min().array() - inter_robot_padding_ <= b.max().array()).all() &&
+         (b.min().array() <= a.max().array() + inter_robot_padding_).all();
+}
+
+void ShardedPlanningScene::collectOverlaps(const Shard& shard, const std::vector<BodyVolume>& volumes,
+                                           const moveit::core::AABB& bounds, std::size_t first_other,
+                                           std::vector<BodyPair>* pairs,
+                                           std::vector<const BodyVolume*>* bodies) const
+{
+  for (std::size_t i = first_other; i < shards_.size(); ++i)
+  {
+    const Shard& other = *shards_[i];
+    if (&other == &shard || !overlap(bounds, other.bounds))
+      continue;
+    for (const BodyVolume& body : other.volumes)
+    {
+      if (!overlap(bounds, body.box))
+        continue;
+      bool overlaps = false;
+      for (const BodyVolume& own : volumes)
+        if (overlap(own.box, body.box))
+        {
+          overlaps = true;
+          if (!pairs)
+            break;
+          pairs->emplace_back(own.id, body.id);
+        }
+      if (overlaps && bodies)
+        bodies->push_back(&body);
+    }
+  }
+}
+
+void ShardedPlanningScene::checkAgainstOthers(const collision_detection::CollisionRequest& req,
+                                              collision_detection::CollisionResult& res, const Shard& shard,
+                                              const moveit::core::RobotState& state, std::size_t first_other) const
+{
+  std::vector<BodyVolume> volumes;
+  moveit::core::AABB bounds;
+  computeVolumes(shard.name, state, false, volumes, bounds);
+  std::vector<const BodyVolume*> bodies;
+  collectOverlaps(shard, volumes, bounds, first_other, nullptr, &bodies);
+
+  std::scoped_lock lock(shard.others_lock);
+  collision_detection::World& world = *shard.others_world;
+
+  // keep only the overlapping bodies in the environment, moving the ones that are there already
+  std::set<std::string> ids;
+  for (const BodyVolume* body : bodies)
+    ids.insert(body->id);
+  for (const std::string& id : world.getObjectIds())
+    if (ids.find(id) == ids.end())
+      world.removeObject(id);
+  if (bodies.empty())
+    return;
+
+  for (const BodyVolume* body : bodies)
+  {
+    const collision_detection::World::ObjectConstPtr object = world.getObject(body->id);
+    if (object && object->shapes_ == body->shapes && object->shape_poses_.size() == body->shape_poses.size() &&
+        std::equal(object->shape_poses_.begin(), object->shape_poses_.end(), body->shape_poses.begin(),
+                   [](const Eigen::Isometry3d& a, const Eigen::Isometry3d& b) { return a.matrix() == b.matrix(); }))
+    {
+      // unchanged poses would still make the environment update the object
+      if (object->pose_.matrix() != body->pose.matrix())
+        world.setObjectPose(body->id, body->pose);
+      continue;
+    }
+    world.removeObject(body->id);
+    world.addToObject(body->id, body->pose, body->shapes, body->shape_poses);
+  }
+
+  shard.others_env->checkRobotCollision(req, res, state, shard.scene->getAllowedCollisionMatrix());
+}
+}  // namespace planning_scene
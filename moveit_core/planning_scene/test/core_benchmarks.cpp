@@ -0,0 +1,224 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Google Benchmark cases for the hot paths of moveit_core outside of collision checking, which is covered by
+   moveit_core_collision_benchmarks.
+
+   Run with --benchmark_out=<file>.json --benchmark_out_format=json to record results that can be compared between
+   releases. Robot state cases are parameterized by robot (0: Panda, 1: PR2), the other cases by problem size. */
+
+#include <benchmark/benchmark.h>
+
+#include <moveit/distance_field/propagation_distance_field.h>
+#include <moveit/planning_scene/planning_scene.h>
+#include <moveit/robot_model/robot_model.h>
+#include <moveit/robot_state/robot_state.h>
+#include <moveit/robot_trajectory/robot_trajectory.h>
+#include <moveit/trajectory_processing/ruckig_traj_smoothing.h>
+#include <moveit/trajectory_processing/time_optimal_trajectory_generation.h>
+#include <moveit/utils/robot_model_test_utils.h>
+
+#include <geometric_shapes/shapes.h>
+#include <random_numbers/random_numbers.h>
+
+namespace
+{
+const char* const ROBOT_NAMES[] = { "panda", "pr2" };
+// serial chains, so that the Jacobian of their tip is defined
+const char* const GROUP_NAMES[] = { "panda_arm", "right_arm" };
+
+constexpr std::size_t STATE_COUNT = 100;
+constexpr unsigned int SEED = 42;
+
+/** \brief A robot with a fixed set of random states of all its variables */
+struct RobotSetup
+{
+  moveit::core::RobotModelPtr robot_model;
+  const moveit::core::JointModelGroup* group;
+  std::vector<moveit::core::RobotState> states;
+};
+
+const RobotSetup& getRobotSetup(int robot)
+{
+  static std::map<int, RobotSetup> setups;
+  auto it = setups.find(robot);
+  if (it != setups.end())
+    return it->second;
+
+  RobotSetup& setup = setups[robot];
+  setup.robot_model = moveit::core::loadTestingRobotModel(ROBOT_NAMES[robot]);
+  setup.group = setup.robot_model->getJointModelGroup(GROUP_NAMES[robot]);
+
+  random_numbers::RandomNumberGenerator rng(SEED);
+  moveit::core::RobotState state(setup.robot_model);
+  for (std::size_t i = 0; i < STATE_COUNT; ++i)
+  {
+    state.setToRandomPositions(rng);
+    state.update();
+    setup.states.push_back(state);
+  }
+  return setup;
+}
+
+/** \brief A Panda arm trajectory through \e waypoint_count random states, without timing */
+robot_trajectory::RobotTrajectory createTrajectory(std::size_t waypoint_count)
+{
+  const RobotSetup& setup = getRobotSetup(0);
+  robot_trajectory::RobotTrajectory trajectory(setup.robot_model, setup.group);
+  for (std::size_t i = 0; i < waypoint_count; ++i)
+    trajectory.addSuffixWayPoint(setup.states[i % setup.states.size()], 0.0);
+  return trajectory;
+}
+
+/** \brief A scene of the Panda with \e count random boxes of 5 cm */
+planning_scene::PlanningScenePtr createScene(std::size_t count)
+{
+  auto scene = std::make_shared<planning_scene::PlanningScene>(getRobotSetup(0).robot_model);
+  random_numbers::RandomNumberGenerator rng(SEED);
+  const shapes::ShapeConstPtr box = std::make_shared<const shapes::Box>(0.05, 0.05, 0.05);
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    Eigen::Isometry3d pose = Eigen::Isometry3d::Identity();
+    pose.translation() =
+        Eigen::Vector3d(rng.uniformReal(-1.2, 1.2), rng.uniformReal(-1.2, 1.2), rng.uniformReal(0.0, 1.8));
+    scene->getWorldNonConst()->addToObject("box_" + std::to_string(i), pose, box, Eigen::Isometry3d::Identity());
+  }
+  return scene;
+}
+}  // namespace
+
+/** \brief Forward kinematics of all links for random states; args: robot */
+static void updateLinkTransforms(benchmark::State& st)
+{
+  const RobotSetup& setup = getRobotSetup(st.range(0));
+  moveit::core::RobotState state(setup.robot_model);
+  std::size_t i = 0;
+  for (auto _ : st)
+  {
+    state.setVariablePositions(setup.states[i++ % setup.states.size()].getVariablePositions());
+    state.updateLinkTransforms();
+    benchmark::DoNotOptimize(state.getGlobalLinkTransform(setup.robot_model->getLinkModels().back()));
+  }
+  st.SetLabel(ROBOT_NAMES[st.range(0)]);
+}
+
+/** \brief Jacobian of the tip of a serial group for random states; args: robot */
+static void jacobian(benchmark::State& st)
+{
+  const RobotSetup& setup = getRobotSetup(st.range(0));
+  const moveit::core::LinkModel* tip = setup.group->getLinkModels().back();
+  Eigen::MatrixXd jacobian;
+  std::size_t i = 0;
+  for (auto _ : st)
+  {
+    setup.states[i++ % setup.states.size()].getJacobian(setup.group, tip, Eigen::Vector3d::Zero(), jacobian);
+    benchmark::DoNotOptimize(jacobian.data());
+  }
+  st.SetLabel(std::string(ROBOT_NAMES[st.range(0)]) + "/" + GROUP_NAMES[st.range(0)]);
+}
+
+/** \brief Creating a diff of a scene with random boxes; args: box count */
+static void sceneDiff(benchmark::State& st)
+{
+  planning_scene::PlanningScenePtr scene = createScene(st.range(0));
+  for (auto _ : st)
+    benchmark::DoNotOptimize(scene->diff());
+}
+
+/** \brief Cloning a scene with random boxes; args: box count */
+static void sceneClone(benchmark::State& st)
+{
+  planning_scene::PlanningScenePtr scene = createScene(st.range(0));
+  for (auto _ : st)
+    benchmark::DoNotOptimize(planning_scene::PlanningScene::clone(scene));
+}
+
+/** \brief Time-optimal parameterization of a Panda arm trajectory; args: waypoint count */
+static void timeOptimalTrajectoryGeneration(benchmark::State& st)
+{
+  const robot_trajectory::RobotTrajectory input = createTrajectory(st.range(0));
+  trajectory_processing::TimeOptimalTrajectoryGeneration totg;
+  for (auto _ : st)
+  {
+    st.PauseTiming();
+    robot_trajectory::RobotTrajectory trajectory(input, true);
+    st.ResumeTiming();
+    benchmark::DoNotOptimize(totg.computeTimeStamps(trajectory));
+  }
+}
+
+/** \brief Ruckig smoothing of a time-parameterized Panda arm trajectory; args: waypoint count */
+static void ruckigSmoothing(benchmark::State& st)
+{
+  robot_trajectory::RobotTrajectory input = createTrajectory(st.range(0));
+  if (!trajectory_processing::TimeOptimalTrajectoryGeneration().computeTimeStamps(input))
+  {
+    st.SkipWithError("Time parameterization of the input trajectory failed");
+    return;
+  }
+  for (auto _ : st)
+  {
+    st.PauseTiming();
+    robot_trajectory::RobotTrajectory trajectory(input, true);
+    st.ResumeTiming();
+    benchmark::DoNotOptimize(trajectory_processing::RuckigSmoothing::applySmoothing(trajectory));
+  }
+}
+
+/** \brief Adding random obstacle points to a 2 m cube distance field of 2 cm voxels; args: point count */
+static void propagationDistanceField(benchmark::State& st)
+{
+  distance_field::PropagationDistanceField field(2.0, 2.0, 2.0, 0.02, -1.0, -1.0, 0.0, 0.4);
+  random_numbers::RandomNumberGenerator rng(SEED);
+  EigenSTL::vector_Vector3d points(st.range(0));
+  for (Eigen::Vector3d& point : points)
+    point = Eigen::Vector3d(rng.uniformReal(-1.0, 1.0), rng.uniformReal(-1.0, 1.0), rng.uniformReal(0.0, 2.0));
+  for (auto _ : st)
+  {
+    field.addPointsToField(points);
+    st.PauseTiming();
+    field.reset();
+    st.ResumeTiming();
+  }
+}
+
+BENCHMARK(updateLinkTransforms)->DenseRange(0, 1);
+BENCHMARK(jacobian)->DenseRange(0, 1);
+BENCHMARK(sceneDiff)->Arg(0)->Arg(100)->Arg(1000);
+BENCHMARK(sceneClone)->Arg(0)->Arg(100)->Arg(1000);
+BENCHMARK(timeOptimalTrajectoryGeneration)->Arg(10)->Arg(100);
+BENCHMARK(ruckigSmoothing)->Arg(10)->Arg(100);
+BENCHMARK(propagationDistanceField)->Arg(100)->Arg(10000);
+
+BENCHMARK_MAIN();
@@ -39,7 +39,9 @@
 #include <moveit/planning_scene/planning_scene.h>
 #include <moveit/utils/message_checks.h>
 #include <moveit/utils/robot_model_test_utils.h>
+#include <octomap/octomap.h>
 #include <urdf_parser/urdf_parser.h>
+#include <geometric_shapes/shapes.h>
 #include <fstream>
 #include <sstream>
 #include <string>
@@ -180,6 +182,27 @@ TEST(PlanningScene, MakeAttachedDiff)
   ps->checkCollision(req, res);
 }
 
+TEST(PlanningScene, DiffMsgWithoutOctomap)
+{
+  urdf::ModelInterfaceSharedPtr urdf_model = moveit::core::loadModelInterface("pr2");
+  srdf::ModelSharedPtr srdf_model = std::make_shared<srdf::Model>();
+  auto ps = std::make_shared<planning_scene::PlanningScene>(urdf_model, srdf_model);
+  planning_scene::PlanningScenePtr next = ps->diff();
+
+  moveit_msgs::msg::PlanningScene ps_msg;
+  EXPECT_FALSE(next->getPlanningSceneDiffMsg(ps_msg, false));
+
+  auto octree = std::make_shared<octomap::OcTree>(0.1);
+  octree->updateNode(1.0, 1.0, 1.0, true);
+  next->processOctomapPtr(octree, Eigen::Isometry3d::Identity());
+
+  /* the changed octomap is reported, but only serialized on request */
+  EXPECT_TRUE(next->getPlanningSceneDiffMsg(ps_msg, false));
+  EXPECT_TRUE(ps_msg.world.octomap.octomap.data.empty());
+  EXPECT_TRUE(next->getPlanningSceneDiffMsg(ps_msg, true));
+  EXPECT_FALSE(ps_msg.world.octomap.octomap.data.empty());
+}
+
 TEST(PlanningScene, isStateValid)
 {
   moveit::core::RobotModelPtr robot_model = moveit::core::loadTestingRobotModel("pr2");
@@ -303,6 +326,258 @@ TEST(PlanningScene, FailRetrievingNonExistentObject)
   EXPECT_FALSE(ps.getCollisionObjectMsg(obj, "non_existent_object"));
 }
 
+TEST(PlanningScene, MeshObjectMsg)
+{
+  moveit::core::RobotModelPtr robot_model = moveit::core::loadTestingRobotModel("pr2");
+  planning_scene::PlanningScene ps{ robot_model };
+
+  auto make_mesh = [](double size) {
+    auto mesh = std::make_shared<shapes::Mesh>(3, 1);
+    const double vertices[] = { 0.0, 0.0, 0.0, size, 0.0, 0.0, 0.0, size, 0.0 };
+    std::copy(std::begin(vertices), std::end(vertices), mesh->vertices);
+    const unsigned int triangles[] = { 0, 1, 2 };
+    std::copy(std::begin(triangles), std::end(triangles), mesh->triangles);
+    return mesh;
+  };
+
+  ps.getWorldNonConst()->addToObject("mesh", make_mesh(1.0), Eigen::Isometry3d::Identity());
+  moveit_msgs::msg::CollisionObject obj;
+  ASSERT_TRUE(ps.getCollisionObjectMsg(obj, "mesh"));
+  ASSERT_EQ(obj.meshes.size(), 1u);
+  EXPECT_EQ(obj.meshes[0].vertices.size(), 3u);
+  EXPECT_DOUBLE_EQ(obj.meshes[0].vertices[1].x, 1.0);
+
+  /* repeated requests return the same message */
+  moveit_msgs::msg::CollisionObject again;
+  ASSERT_TRUE(ps.getCollisionObjectMsg(again, "mesh"));
+  EXPECT_EQ(obj.meshes, again.meshes);
+
+  /* a replaced mesh is converted anew */
+  ps.getWorldNonConst()->removeObject("mesh");
+  ps.getWorldNonConst()->addToObject("mesh", make_mesh(2.0), Eigen::Isometry3d::Identity());
+  moveit_msgs::msg::CollisionObject replaced;
+  ASSERT_TRUE(ps.getCollisionObjectMsg(replaced, "mesh"));
+  ASSERT_EQ(replaced.meshes.size(), 1u);
+  EXPECT_DOUBLE_EQ(replaced.meshes[0].vertices[1].x, 2.0);
+}
+
+TEST(PlanningScene, PathValidParallel)
+{
+  moveit::core::RobotModelPtr robot_model = moveit::core::loadTestingRobotModel("pr2");
+  planning_scene::PlanningScene ps{ robot_model };
+  const std::string joint = "r_shoulder_pan_joint";
+
+  /* waypoints 60 and 80 are infeasible */
+  ps.setStateFeasibilityPredicate([&joint](const moveit::core::RobotState& state, bool /*verbose*/) {
+    const double position = state.getVariablePosition(joint);
+    return std::abs(position - 0.6) > 1e-6 && std::abs(position - 0.8) > 1e-6;
+  });
+  robot_trajectory::RobotTrajectory trajectory(robot_model);
+  moveit::core::RobotState state(robot_model);
+  state.setToDefaultValues();
+  for (std::size_t i = 0; i < 100; ++i)
+  {
+    state.setVariablePosition(joint, 0.01 * i);
+    state.update();
+    trajectory.addSuffixWayPoint(state, 0.1);
+  }
+
+  std::vector<std::size_t> serial_invalid;
+  EXPECT_FALSE(ps.isPathValid(trajectory, "", false, &serial_invalid));
+  ASSERT_FALSE(serial_invalid.empty());
+  for (std::size_t thread_count : { 1, 2, 4, 8 })
+  {
+    std::size_t invalid_index = 0;
+    EXPECT_FALSE(ps.isPathValidParallel(trajectory, "", &invalid_index, thread_count));
+    EXPECT_EQ(invalid_index, serial_invalid.front()) << thread_count << " threads";
+    EXPECT_EQ(invalid_index, 60u) << thread_count << " threads";
+  }
+
+  ps.setStateFeasibilityPredicate(planning_scene::StateFeasibilityFn());
+  EXPECT_EQ(ps.isPathValid(trajectory), ps.isPathValidParallel(trajectory, "", nullptr, 4));
+}
+
+TEST(PlanningScene, PathValidWithConstraintSet)
+{
+  moveit::core::RobotModelPtr robot_model = moveit::core::loadTestingRobotModel("pr2");
+  planning_scene::PlanningScene ps{ robot_model };
+  const std::string joint = "r_shoulder_pan_joint";
+
+  std::size_t feasibility_checks = 0;
+  ps.setStateFeasibilityPredicate([&feasibility_checks](const moveit::core::RobotState& /*state*/, bool /*verbose*/) {
+    ++feasibility_checks;
+    return true;
+  });
+  robot_trajectory::RobotTrajectory trajectory(robot_model);
+  moveit::core::RobotState state(robot_model);
+  state.setToDefaultValues();
+  for (std::size_t i = 0; i < 100; ++i)
+  {
+    state.setVariablePosition(joint, 0.01 * i);
+    state.update();
+    trajectory.addSuffixWayPoint(state, 0.1);
+  }
+
+  /* waypoints 20 to 40 satisfy the path constraints */
+  moveit_msgs::msg::Constraints path_constraints;
+  path_constraints.joint_constraints.resize(1);
+  path_constraints.joint_constraints[0].joint_name = joint;
+  path_constraints.joint_constraints[0].position = 0.3;
+  path_constraints.joint_constraints[0].tolerance_above = 0.105;
+  path_constraints.joint_constraints[0].tolerance_below = 0.105;
+  path_constraints.joint_constraints[0].weight = 1.0;
+  kinematic_constraints::KinematicConstraintSet constraint_set(robot_model);
+  constraint_set.add(path_constraints, ps.getTransforms());
+
+  std::vector<std::size_t> msg_invalid;
+  std::vector<std::size_t> set_invalid;
+  EXPECT_FALSE(ps.isPathValid(trajectory, path_constraints, "", false, &msg_invalid));
+  EXPECT_FALSE(ps.isPathValid(trajectory, constraint_set, "", false, &set_invalid));
+  EXPECT_EQ(msg_invalid, set_invalid);
+  EXPECT_EQ(set_invalid.size(), 79u);
+
+  /* checking the constraints first never reaches the feasibility check of the waypoints that violate them */
+  ps.setStateCheckOrder(planning_scene::StateCheckOrder::CONSTRAINTS_FIRST);
+  feasibility_checks = 0;
+  std::vector<std::size_t> ordered_invalid;
+  EXPECT_FALSE(ps.isPathValid(trajectory, constraint_set, "", false, &ordered_invalid));
+  EXPECT_EQ(ordered_invalid, set_invalid);
+  EXPECT_EQ(feasibility_checks, 21u);
+  EXPECT_TRUE(ps.isStateValid(trajectory.getWayPoint(30), path_constraints));
+  EXPECT_FALSE(ps.isStateValid(trajectory.getWayPoint(50), constraint_set));
+}
+
+TEST(PlanningScene, Versions)
+{
+  moveit::core::RobotModelPtr robot_model = moveit::core::loadTestingRobotModel("pr2");
+  auto ps = std::make_shared<planning_scene::PlanningScene>(robot_model);
+  planning_scene::PlanningScenePtr next = ps->diff();
+
+  /* a diff starts out with the versions of its parent */
+  EXPECT_EQ(ps->getWorldVersion(), next->getWorldVersion());
+  EXPECT_EQ(ps->getAllowedCollisionMatrixVersion(), next->getAllowedCollisionMatrixVersion());
+  EXPECT_EQ(ps->getCurrentStateVersion(), next->getCurrentStateVersion());
+  EXPECT_EQ(ps->getAttachedBodiesVersion(), next->getAttachedBodiesVersion());
+  EXPECT_EQ(ps->getTransformsVersion(), next->getTransformsVersion());
+
+  const std::uint64_t world_version = next->getWorldVersion();
+  const std::uint64_t acm_version = next->getAllowedCollisionMatrixVersion();
+  const std::uint64_t attached_version = next->getAttachedBodiesVersion();
+  const std::uint64_t transforms_version = next->getTransformsVersion();
+  next->getWorldNonConst()->addToObject("ball", std::make_shared<shapes::Sphere>(0.1),
+                                        Eigen::Isometry3d(Eigen::Translation3d(2.0, 0.0, 0.0)));
+  next->getAllowedCollisionMatrixNonConst().setEntry("ball", "r_gripper_palm_link", true);
+  EXPECT_NE(world_version, next->getWorldVersion());
+  EXPECT_NE(acm_version, next->getAllowedCollisionMatrixVersion());
+  EXPECT_EQ(acm_version, ps->getAllowedCollisionMatrixVersion());
+  EXPECT_EQ(transforms_version, next->getTransformsVersion());
+
+  std::set<std::string> ids;
+  EXPECT_TRUE(next->getChangedObjectIds(world_version, ids));
+  EXPECT_EQ(std::set<std::string>({ "ball" }), ids);
+
+  /* attaching changes the attached bodies, but not the joint values */
+  const std::uint64_t state_version = next->getCurrentStateVersion();
+  moveit_msgs::msg::AttachedCollisionObject aco;
+  aco.link_name = "r_gripper_palm_link";
+  aco.object.id = "ball";
+  aco.object.operation = moveit_msgs::msg::CollisionObject::ADD;
+  EXPECT_TRUE(next->processAttachedCollisionObjectMsg(aco));
+  EXPECT_NE(attached_version, next->getAttachedBodiesVersion());
+  EXPECT_EQ(attached_version, ps->getAttachedBodiesVersion());
+  EXPECT_EQ(state_version, next->getCurrentStateVersion());
+
+  next->getCurrentStateNonConst().setToDefaultValues();
+  EXPECT_NE(state_version, next->getCurrentStateVersion());
+
+  /* clearing the diffs restores the versions of the parent */
+  next->clearDiffs();
+  EXPECT_EQ(ps->getWorldVersion(), next->getWorldVersion());
+  EXPECT_EQ(ps->getAllowedCollisionMatrixVersion(), next->getAllowedCollisionMatrixVersion());
+  EXPECT_EQ(ps->getAttachedBodiesVersion(), next->getAttachedBodiesVersion());
+}
+
+TEST(PlanningScene, CheckpointRollback)
+{
+  moveit::core::RobotModelPtr robot_model = moveit::core::loadTestingRobotModel("pr2");
+  auto ps = std::make_shared<planning_scene::PlanningScene>(robot_model);
+  ps->getWorldNonConst()->addToObject("ball", std::make_shared<shapes::Sphere>(0.1),
+                                      Eigen::Isometry3d(Eigen::Translation3d(2.0, 0.0, 0.0)));
+  planning_scene::PlanningScenePtr next = ps->diff();
+
+  const planning_scene::PlanningSceneCheckpointConstPtr cp = next->checkpoint();
+  const std::uint64_t acm_version = next->getAllowedCollisionMatrixVersion();
+  const std::uint64_t attached_version = next->getAttachedBodiesVersion();
+  const std::vector<double> positions(next->getCurrentState().getVariablePositions(),
+                                      next->getCurrentState().getVariablePositions() +
+                                          robot_model->getVariableCount());
+
+  for (int i = 0; i < 2; ++i)
+  {
+    /* speculative changes: attach the ball, move the robot and add another object */
+    moveit_msgs::msg::AttachedCollisionObject aco;
+    aco.link_name = "r_gripper_palm_link";
+    aco.object.id = "ball";
+    aco.object.operation = moveit_msgs::msg::CollisionObject::ADD;
+    EXPECT_TRUE(next->processAttachedCollisionObjectMsg(aco));
+    next->getCurrentStateNonConst().setToRandomPositions();
+    next->getWorldNonConst()->addToObject("box", std::make_shared<shapes::Box>(0.1, 0.1, 0.1),
+                                          Eigen::Isometry3d::Identity());
+    next->getAllowedCollisionMatrixNonConst().setEntry("box", "r_gripper_palm_link", true);
+    next->setObjectColor("box", std_msgs::msg::ColorRGBA());
+    EXPECT_FALSE(next->getWorld()->hasObject("ball"));
+    EXPECT_TRUE(next->getCurrentState().hasAttachedBody("ball"));
+
+    EXPECT_TRUE(next->rollback(cp));
+    EXPECT_TRUE(next->getWorld()->hasObject("ball"));
+    EXPECT_FALSE(next->getWorld()->hasObject("box"));
+    EXPECT_FALSE(next->getCurrentState().hasAttachedBody("ball"));
+    EXPECT_FALSE(next->hasObjectColor("box"));
+    for (std::size_t j = 0; j < positions.size(); ++j)
+      EXPECT_EQ(positions[j], next->getCurrentState().getVariablePosition(j));
+    EXPECT_EQ(acm_version, next->getAllowedCollisionMatrixVersion());
+    EXPECT_EQ(attached_version, next->getAttachedBodiesVersion());
+    EXPECT_EQ(ps->getAllowedCollisionMatrixVersion(), next->getAllowedCollisionMatrixVersion());
+  }
+
+  /* the collision environment follows the restored world */
+  collision_detection::CollisionRequest req;
+  collision_detection::CollisionResult res;
+  next->getCurrentStateNonConst().setToDefaultValues();
+  next->checkCollision(req, res);
+  ps->getCurrentStateNonConst().setToDefaultValues();
+  collision_detection::CollisionResult parent_res;
+  ps->checkCollision(req, parent_res);
+  EXPECT_EQ(parent_res.collision, res.collision);
+
+  /* checkpoints only apply to the scene they were taken from */
+  EXPECT_FALSE(ps->rollback(cp));
+}
+
+TEST(PlanningScene, MemoryUsage)
+{
+  moveit::core::RobotModelPtr robot_model = moveit::core::loadTestingRobotModel("pr2");
+  EXPECT_GT(robot_model->getMemoryUsage(), robot_model->getLinkModelCount() * sizeof(moveit::core::LinkModel));
+
+  auto ps = std::make_shared<planning_scene::PlanningScene>(robot_model);
+  const std::size_t empty_size = ps->getMemoryUsage();
+  EXPECT_GT(empty_size, sizeof(planning_scene::PlanningScene));
+
+  /* a mesh occupies at least its vertex and triangle buffers */
+  auto mesh = std::make_shared<shapes::Mesh>(1000, 500);
+  ps->getWorldNonConst()->addToObject("mesh", mesh, Eigen::Isometry3d::Identity());
+  const std::size_t mesh_size = ps->getMemoryUsage();
+  EXPECT_GE(mesh_size - empty_size, 1000 * 3 * sizeof(double) + 500 * 3 * sizeof(unsigned int));
+
+  /* a shape added twice is counted once */
+  ps->getWorldNonConst()->addToObject("mesh_copy", mesh, Eigen::Isometry3d::Identity());
+  EXPECT_LT(ps->getMemoryUsage() - mesh_size, 1000 * 3 * sizeof(double));
+
+  /* a diff without changes of its own is small */
+  planning_scene::PlanningScenePtr diff = ps->diff();
+  EXPECT_LT(diff->getMemoryUsage(), ps->getMemoryUsage());
+}
+
 class CollisionDetectorTests : public testing::TestWithParam<const char*>
 {
 };
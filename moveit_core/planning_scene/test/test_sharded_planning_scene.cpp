@@ -0,0 +1,181 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <gtest/gtest.h>
+#include <moveit/exceptions/exceptions.h>
+#include <moveit/planning_scene/sharded_planning_scene.h>
+#include <moveit/utils/robot_model_test_utils.h>
+#include <geometric_shapes/shapes.h>
+#include <algorithm>
+
+namespace
+{
+/** A robot with a 0.2m cube that slides along x, starting at \e base_x */
+moveit::core::RobotModelPtr createSlider(double base_x)
+{
+  geometry_msgs::msg::Pose origin;
+  origin.orientation.w = 1.0;
+  geometry_msgs::msg::Pose base = origin;
+  base.position.x = base_x;
+
+  moveit::core::RobotModelBuilder builder("slider", "base_link");
+  builder.addChain("base_link->cube", "prismatic", { base });
+  builder.addCollisionBox("cube", { 0.2, 0.2, 0.2 }, origin);
+  return builder.build();
+}
+
+moveit::core::RobotState sliderAt(const planning_scene::PlanningScene& scene, double position)
+{
+  moveit::core::RobotState state(scene.getCurrentState());
+  state.setVariablePosition("base_link-cube-joint", position);
+  state.update();
+  return state;
+}
+}  // namespace
+
+class ShardedPlanningSceneTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    left_ = scene_.addShard("left", createSlider(0.0));
+    right_ = scene_.addShard("right", createSlider(1.0));
+  }
+
+  planning_scene::ShardedPlanningScene scene_;
+  planning_scene::PlanningScenePtr left_;
+  planning_scene::PlanningScenePtr right_;
+};
+
+TEST_F(ShardedPlanningSceneTest, Shards)
+{
+  EXPECT_EQ(scene_.getShardNames(), (std::vector<std::string>{ "left", "right" }));
+  EXPECT_EQ(scene_.getShard("left"), left_);
+  EXPECT_FALSE(scene_.getShard("middle"));
+  EXPECT_THROW(scene_.addShard("left", createSlider(2.0)), moveit::ConstructException);
+
+  // all shards see the same world
+  EXPECT_EQ(left_->getWorld(), scene_.getWorld());
+  EXPECT_EQ(right_->getWorld(), scene_.getWorld());
+
+  EXPECT_TRUE(scene_.removeShard("right"));
+  EXPECT_FALSE(scene_.removeShard("right"));
+  EXPECT_FALSE(scene_.hasShard("right"));
+}
+
+TEST_F(ShardedPlanningSceneTest, InterRobotCollision)
+{
+  collision_detection::CollisionRequest req;
+  collision_detection::CollisionResult res;
+  std::vector<planning_scene::ShardedPlanningScene::BodyPair> pairs;
+
+  scene_.checkCollision(req, res, "left", left_->getCurrentState());
+  EXPECT_FALSE(res.collision);
+  scene_.getCandidateBodyPairs("left", left_->getCurrentState(), pairs);
+  EXPECT_TRUE(pairs.empty());
+
+  // a candidate state of the left robot that reaches into the right one
+  const moveit::core::RobotState reaching = sliderAt(*left_, 0.9);
+  scene_.getCandidateBodyPairs("left", reaching, pairs);
+  ASSERT_EQ(pairs.size(), 1u);
+  EXPECT_EQ(pairs[0], planning_scene::ShardedPlanningScene::BodyPair("left/cube", "right/cube"));
+
+  req.contacts = true;
+  res.clear();
+  scene_.checkCollision(req, res, "left", reaching);
+  EXPECT_TRUE(res.collision);
+  ASSERT_EQ(res.contacts.size(), 1u);
+  EXPECT_EQ(res.contacts.begin()->first, std::make_pair(std::string("cube"), std::string("right/cube")));
+
+  // the robot itself does not collide with anything
+  res.clear();
+  left_->checkCollision(req, res, reaching);
+  EXPECT_FALSE(res.collision);
+
+  // once the right robot moved away, the same state is free again
+  ASSERT_TRUE(scene_.setCurrentState("right", sliderAt(*right_, 1.0)));
+  res.clear();
+  scene_.checkCollision(req, res, "left", reaching);
+  EXPECT_FALSE(res.collision);
+
+  // all robots at their current states
+  res.clear();
+  scene_.checkInterRobotCollision(req, res);
+  EXPECT_FALSE(res.collision);
+  ASSERT_TRUE(scene_.setCurrentState("left", sliderAt(*left_, 1.9)));
+  res.clear();
+  scene_.checkInterRobotCollision(req, res);
+  EXPECT_TRUE(res.collision);
+}
+
+TEST_F(ShardedPlanningSceneTest, Padding)
+{
+  std::vector<planning_scene::ShardedPlanningScene::BodyPair> pairs;
+  // 0.3m between the cubes
+  const moveit::core::RobotState close = sliderAt(*left_, 0.5);
+  scene_.getCandidateBodyPairs("left", close, pairs);
+  EXPECT_TRUE(pairs.empty());
+
+  scene_.setInterRobotPadding(0.5);
+  scene_.getCandidateBodyPairs("left", close, pairs);
+  EXPECT_EQ(pairs.size(), 1u);
+
+  // the candidates are checked exactly
+  collision_detection::CollisionRequest req;
+  collision_detection::CollisionResult res;
+  scene_.checkInterRobotCollision(req, res, "left", close);
+  EXPECT_FALSE(res.collision);
+}
+
+TEST_F(ShardedPlanningSceneTest, SharedWorld)
+{
+  Eigen::Isometry3d pose = Eigen::Isometry3d::Identity();
+  pose.translation().x() = 1.0;
+  scene_.getWorldNonConst()->addToObject("box", pose, std::make_shared<shapes::Box>(0.1, 0.1, 0.1),
+                                         Eigen::Isometry3d::Identity());
+
+  collision_detection::CollisionRequest req;
+  collision_detection::CollisionResult res;
+  scene_.checkCollision(req, res, "right", right_->getCurrentState());
+  EXPECT_TRUE(res.collision);
+  res.clear();
+  scene_.checkCollision(req, res, "left", left_->getCurrentState());
+  EXPECT_FALSE(res.collision);
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,112 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#pragma once
+
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+/** Helpers for bindings that process a batch of inputs in C++ without holding the GIL */
+
+namespace moveit
+{
+namespace python
+{
+/** \brief The number of worker threads to use for \e count items when \e requested threads were asked for
+ *  (0 meaning one per hardware thread) */
+inline std::size_t batchThreadCount(std::size_t count, std::size_t requested)
+{
+  std::size_t threads = requested ? requested : std::max(1u, std::thread::hardware_concurrency());
+  return std::max<std::size_t>(1, std::min(threads, count));
+}
+
+/** \brief Call \e fn(thread, i) for all i in [0, count), spread over batchThreadCount(count, threads) threads.
+ *
+ *  The GIL is released while the batch runs, so \e fn must not touch Python objects. \e thread is the index of the
+ *  calling worker, so callers can keep per-thread data such as a scratch RobotState. The first exception thrown by
+ *  \e fn is rethrown once all workers have stopped. */
+template <typename Fn>
+void runBatch(std::size_t count, std::size_t threads, const Fn& fn)
+{
+  pybind11::gil_scoped_release release;
+  const std::size_t thread_count = batchThreadCount(count, threads);
+
+  std::atomic<std::size_t> next(0);
+  std::exception_ptr error;
+  std::mutex error_lock;
+  auto worker = [&](std::size_t thread) {
+    try
+    {
+      for (std::size_t i = next++; i < count; i = next++)
+        fn(thread, i);
+    }
+    catch (...)
+    {
+      std::lock_guard<std::mutex> lock(error_lock);
+      if (!error)
+        error = std::current_exception();
+      next = count;
+    }
+  };
+
+  std::vector<std::thread> workers;
+  workers.reserve(thread_count - 1);
+  for (std::size_t t = 1; t < thread_count; ++t)
+    workers.emplace_back(worker, t);
+  worker(0);
+  for (std::thread& w : workers)
+    w.join();
+  if (error)
+    std::rethrow_exception(error);
+}
+
+/** \brief Check that \e array is two dimensional with \e columns columns and return its number of rows */
+inline std::size_t checkBatchShape(const pybind11::array_t<double>& array, std::size_t columns, const char* what)
+{
+  if (array.ndim() != 2 || static_cast<std::size_t>(array.shape(1)) != columns)
+    throw std::invalid_argument(std::string(what) + " must have shape (N, " + std::to_string(columns) + ")");
+  return array.shape(0);
+}
+
+}  // namespace python
+}  // namespace moveit
@@ -0,0 +1,94 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#pragma once
+
+#include <Eigen/Geometry>
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace moveit
+{
+namespace core
+{
+class RobotModel;
+
+/** \brief Signature of a generated forward kinematics kernel. Given the positions of all variables of a state,
+    compute the transforms w.r.t. the model frame of all links, indexed by LinkModel::getLinkIndex().
+    Only the upper 3x4 block of the transforms is written. */
+typedef void (*FKKernelFn)(const double* positions, Eigen::Isometry3d* link_transforms);
+
+/** \brief Signature of a generated Jacobian kernel for a chain group. Given the up-to-date link transforms of a state
+    and a point relative to the tip link of the group, compute the 6 x n Jacobian (column-major, n being the number of
+    variables of the group) expressed in the frame of the parent link of the group's root joint. */
+typedef void (*JacobianKernelFn)(const Eigen::Isometry3d* link_transforms, const Eigen::Vector3d& reference_point,
+                                 double* jacobian);
+
+/** \brief Forward kinematics and Jacobian kernels specialized for one particular robot model.
+
+    Kernels are generated at build time from URDF and SRDF with the CMake function moveit_generate_fk_kernel()
+    (see ConfigExtras.cmake) and register themselves on loading. A RobotModel picks up a registered kernel at
+    construction time if its kinematic structure hashes to the same value the kernel was generated for. */
+struct FKKernel
+{
+  /** \brief Name of the robot the kernel was generated for */
+  std::string robot_name;
+
+  /** \brief Hash of the kinematic structure, as computed by computeKinematicModelHash() */
+  std::uint64_t model_hash = 0;
+
+  /** \brief Computes all link transforms */
+  FKKernelFn compute_link_transforms = nullptr;
+
+  /** \brief Jacobian kernels, indexed by group name. Only chain groups consisting of revolute, prismatic and
+      fixed joints have a Jacobian kernel. */
+  std::map<std::string, JacobianKernelFn> jacobians;
+};
+
+/** \brief Compute a hash of everything forward kinematics depends on: the tree structure, joint types, axes,
+    joint origins and the order of variables. */
+std::uint64_t computeKinematicModelHash(const RobotModel& robot_model);
+
+/** \brief Make \e kernel available to robot models constructed afterwards.
+    If a kernel for the same hash is already registered, the call has no effect. */
+void registerFKKernel(const FKKernel& kernel);
+
+/** \brief Look up the kernel registered for \e model_hash. Returns nullptr if there is none. */
+const FKKernel* findFKKernel(std::uint64_t model_hash);
+
+/** \brief Generate the C++ source of a translation unit that defines and registers the kernels for \e robot_model */
+std::string generateFKKernelSource(const RobotModel& robot_model);
+}  // namespace core
+}  // namespace moveit
@@ -40,6 +40,7 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include <iostream>
 #include <moveit_msgs/msg/joint_limits.hpp>
 #include <random_numbers/random_numbers.h>
@@ -89,17 +90,18 @@ struct VariableBounds
 class LinkModel;
 class JointModel;
 
-/** \brief Data type for holding mappings from variable names to their position in a state vector */
-typedef std::map<std::string, size_t> VariableIndexMap;
+/** \brief Data type for holding mappings from variable names to their position in a state vector. Hashed, as it is
+    only used for lookups. */
+typedef std::unordered_map<std::string, size_t> VariableIndexMap;
 
 /** \brief Data type for holding mappings from variable names to their bounds */
 using VariableBoundsMap = std::map<std::string, VariableBounds>;
 
-/** \brief Map of names to instances for JointModel */
-using JointModelMap = std::map<std::string, JointModel*>;
+/** \brief Map of names to instances for JointModel (hashed, unordered) */
+using JointModelMap = std::unordered_map<std::string, JointModel*>;
 
-/** \brief Map of names to const instances for JointModel */
-using JointModelMapConst = std::map<std::string, const JointModel*>;
+/** \brief Map of names to const instances for JointModel (hashed, unordered) */
+using JointModelMapConst = std::unordered_map<std::string, const JointModel*>;
 
 /** \brief A joint from the robot. Models the transform that
     this joint applies in the kinematic chain. A joint
@@ -42,8 +42,11 @@
 #include <moveit/kinematics_base/kinematics_base.h>
 #include <srdfdom/model.h>
 #include <functional>
+#include <map>
+#include <mutex>
 #include <set>
 #include <string>
+#include <thread>
 
 namespace moveit
 {
@@ -534,8 +537,12 @@ public:
 
   void setSolverAllocators(const std::pair<SolverAllocatorFn, SolverAllocatorMapFn>& solvers);
 
+  /** \brief Get the solver of the group. With per-thread solver instances enabled, this is the instance of the calling
+      thread, see getThreadSolverInstance() */
   const kinematics::KinematicsBaseConstPtr getSolverInstance() const
   {
+    if (per_thread_solver_instances_)
+      return getThreadSolverInstance();
     return group_kinematics_.first.solver_instance_;
   }
 
@@ -544,15 +551,27 @@ public:
     return group_kinematics_.first.solver_instance_;
   }
 
-  bool canSetStateFromIK(const std::string& tip) const;
+  /** \brief Get the solver instance of the calling thread, which is allocated on first use like the shared instance.
+      Kinematics solvers are generally not thread-safe, so threads using the group concurrently need their own instance.
+      Falls back to the shared instance if the allocation fails. */
+  kinematics::KinematicsBaseConstPtr getThreadSolverInstance() const;
 
-  bool setRedundantJoints(const std::vector<std::string>& joints)
+  /** \brief Make getSolverInstance() const hand every thread its own solver instance instead of the shared one */
+  void setPerThreadSolverInstances(bool enable)
   {
-    if (group_kinematics_.first.solver_instance_)
-      return group_kinematics_.first.solver_instance_->setRedundantJoints(joints);
-    return false;
+    per_thread_solver_instances_ = enable;
   }
 
+  /** \brief Whether getSolverInstance() const hands every thread its own solver instance */
+  bool hasPerThreadSolverInstances() const
+  {
+    return per_thread_solver_instances_;
+  }
+
+  bool canSetStateFromIK(const std::string& tip) const;
+
+  bool setRedundantJoints(const std::vector<std::string>& joints);
+
   /** \brief Get the default IK timeout */
   double getDefaultIKTimeout() const
   {
@@ -745,6 +764,13 @@ protected:
 
   std::pair<KinematicsSolver, KinematicsSolverMap> group_kinematics_;
 
+  /** \brief Whether getSolverInstance() const returns the solver instance of the calling thread */
+  bool per_thread_solver_instances_;
+
+  /** \brief The solver instances allocated by getThreadSolverInstance(), by thread */
+  mutable std::map<std::thread::id, kinematics::KinematicsBasePtr> thread_solver_instances_;
+  mutable std::mutex thread_solver_instances_lock_;
+
   srdf::Model::Group config_;
 
   /** \brief The set of default states specified for this group in the SRDF */
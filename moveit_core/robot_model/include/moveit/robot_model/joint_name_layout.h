@@ -0,0 +1,84 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#pragma once
+
+#include <moveit/robot_model/robot_model.h>
+#include <string>
+#include <vector>
+
+namespace moveit
+{
+namespace core
+{
+/** \brief The joints and variables a list of names refers to, such as the name field of a JointState message.
+ *
+ * Publishers of joint states send the same names in the same order with every message. update() only looks the
+ * names up in the robot model when they differ from the ones it was last called with, so mapping a message with a
+ * known layout costs a comparison of the names instead of one map lookup per name. */
+class JointNameLayout
+{
+public:
+  explicit JointNameLayout(const RobotModelConstPtr& robot_model);
+
+  /** \brief Make the layout describe \e names. Returns true if the names differed from the previous ones and the
+      layout was rebuilt. */
+  bool update(const std::vector<std::string>& names);
+
+  /** \brief The names of the current layout */
+  const std::vector<std::string>& getNames() const
+  {
+    return names_;
+  }
+
+  /** \brief For each name, the joint of that name, or nullptr if the model has no such joint */
+  const std::vector<const JointModel*>& getJointModels() const
+  {
+    return joint_models_;
+  }
+
+  /** \brief For each name, the index of the variable of that name, or -1 if the model has no such variable */
+  const std::vector<int>& getVariableIndices() const
+  {
+    return variable_indices_;
+  }
+
+private:
+  RobotModelConstPtr robot_model_;
+  std::vector<std::string> names_;
+  std::vector<const JointModel*> joint_models_;
+  std::vector<int> variable_indices_;
+};
+}  // namespace core
+}  // namespace moveit
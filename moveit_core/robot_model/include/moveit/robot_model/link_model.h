@@ -40,6 +40,7 @@
 #include <vector>
 #include <utility>
 #include <map>
+#include <unordered_map>
 #include <Eigen/Geometry>
 #include <eigen_stl_containers/eigen_stl_vector_container.h>
 #include <moveit/macros/class_forward.h>
@@ -57,11 +58,11 @@ namespace core
 class JointModel;
 class LinkModel;
 
-/** \brief Map of names to instances for LinkModel */
-typedef std::map<std::string, LinkModel*> LinkModelMap;
+/** \brief Map of names to instances for LinkModel (hashed, unordered) */
+typedef std::unordered_map<std::string, LinkModel*> LinkModelMap;
 
-/** \brief Map of names to const instances for LinkModel */
-using LinkModelMapConst = std::map<std::string, const LinkModel*>;
+/** \brief Map of names to const instances for LinkModel (hashed, unordered) */
+using LinkModelMapConst = std::unordered_map<std::string, const LinkModel*>;
 
 /** \brief Map from link model instances to Eigen transforms */
 using LinkTransformMap = std::map<const LinkModel*, Eigen::Isometry3d, std::less<const LinkModel*>,
@@ -194,6 +195,13 @@ public:
     return centered_bounding_box_offset_;
   }
 
+  /** \brief Get the radius of a sphere centered at getCenteredBoundingBoxOffset() that encloses all shapes of this
+   *  link (zero if the link has no geometry). */
+  double getBoundingSphereRadius() const
+  {
+    return bounding_sphere_radius_;
+  }
+
   /** \brief Get the set of links that are attached to this one via fixed transforms. The returned transforms are
    * guaranteed to be valid isometries. */
   const LinkTransformMap& getAssociatedFixedTransforms() const
@@ -272,6 +280,9 @@ private:
   /** \brief Center of the axis aligned bounding box with size shape_extents_ (zero if symmetric along all axes). */
   Eigen::Vector3d centered_bounding_box_offset_;
 
+  /** \brief Radius of the sphere around centered_bounding_box_offset_ that encloses the bounding box */
+  double bounding_sphere_radius_;
+
   /** \brief Filename associated with the visual geometry mesh of this link. If empty, no mesh was used. */
   std::string visual_mesh_filename_;
 
@@ -48,6 +48,8 @@
 #include <moveit/robot_model/planar_joint_model.h>
 #include <moveit/robot_model/revolute_joint_model.h>
 #include <moveit/robot_model/prismatic_joint_model.h>
+#include <moveit/robot_model/fk_kernel.h>
+#include <moveit/robot_model/robot_model_snapshot.h>
 #include <rclcpp/logging.hpp>
 #include <Eigen/Geometry>
 #include <iostream>
@@ -78,6 +80,11 @@ public:
   /** \brief Construct a kinematic model from a parsed description and a list of planning groups */
   RobotModel(const urdf::ModelInterfaceSharedPtr& urdf_model, const srdf::ModelConstSharedPtr& srdf_model);
 
+  /** \brief Construct a kinematic model from a parsed description and a list of planning groups, taking meshes from
+      \e snapshot instead of loading them. Meshes missing in \e snapshot are loaded and added to it. */
+  RobotModel(const urdf::ModelInterfaceSharedPtr& urdf_model, const srdf::ModelConstSharedPtr& srdf_model,
+             RobotModelSnapshot& snapshot);
+
   /** \brief Destructor. Clear all memory. */
   ~RobotModel();
 
@@ -117,6 +124,10 @@ public:
   /** \brief Print information about the constructed model */
   void printModelInfo(std::ostream& out) const;
 
+  /** \brief Estimate of the memory in bytes the model occupies with its links, joints, groups and collision geometry.
+   *  Shapes shared between links are counted once; the URDF and SRDF the model was built from are not included. */
+  std::size_t getMemoryUsage() const;
+
   /** \name Access to joint models
    *  @{
    */
@@ -447,6 +458,16 @@ public:
   /** \brief Get the index of a variable in the robot state */
   size_t getVariableIndex(const std::string& variable) const;
 
+  /** \brief Get the index of a variable in the robot state, or -1 if \e variable is not a variable of this model */
+  int findVariableIndex(const std::string& variable) const;
+
+  /** \brief Get the forward kinematics kernel generated for this robot model, if one was registered when the model
+      was constructed. Returns nullptr otherwise. See FKKernel. */
+  const FKKernel* getFKKernel() const
+  {
+    return fk_kernel_;
+  }
+
   /** \brief Get the deepest joint in the kinematic tree that is a common parent of both joints passed as argument */
   const JointModel* getCommonRoot(const JointModel* a, const JointModel* b) const
   {
@@ -597,6 +618,12 @@ protected:
   /** \brief The array of end-effectors, in alphabetical order */
   std::vector<const JointModelGroup*> end_effectors_;
 
+  /** \brief The generated forward kinematics kernel matching this model, if any */
+  const FKKernel* fk_kernel_;
+
+  /** \brief The snapshot meshes are taken from while the model is built, or nullptr */
+  RobotModelSnapshot* snapshot_;
+
 private:
   /** \brief Given an URDF model and a SRDF model, build a full kinematic model */
   void buildModel(const urdf::ModelInterface& urdf_model, const srdf::Model& srdf_model);
@@ -0,0 +1,113 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#pragma once
+
+#include <moveit/macros/class_forward.h>
+#include <geometric_shapes/shapes.h>
+#include <Eigen/Core>
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace moveit
+{
+namespace core
+{
+MOVEIT_CLASS_FORWARD(RobotModelSnapshot);  // Defines RobotModelSnapshotPtr, ConstPtr, WeakPtr... etc
+
+/** \brief A cache of the data that is expensive to compute when building a RobotModel, stored in a versioned
+    binary file.
+
+    Building a RobotModel is dominated by loading the meshes referenced by the URDF through geometric_shapes.
+    A snapshot keeps the loaded meshes, keyed by resource name and scale, together with hashes of the URDF and SRDF
+    documents it was created for. Passing a snapshot to the RobotModel constructor makes it take meshes from the
+    snapshot instead of loading them, and add the meshes it had to load.
+
+    The file format is specific to the host: it stores doubles and integers in native byte order. A file written
+    with another FORMAT_VERSION or on a host with a different layout is rejected by load(). */
+class RobotModelSnapshot
+{
+public:
+  /** \brief Version of the binary format. Increase whenever the layout written by save() changes. */
+  static constexpr std::uint32_t FORMAT_VERSION = 1;
+
+  /** \brief Construct an empty snapshot for the URDF and SRDF documents with the given hashes */
+  RobotModelSnapshot(std::uint64_t urdf_hash = 0, std::uint64_t srdf_hash = 0);
+
+  /** \brief Compute the hash of a URDF or SRDF document identifying the snapshot created for it */
+  static std::uint64_t hashDescription(const std::string& description);
+
+  /** \brief Read the snapshot stored at \e path. Returns nullptr (and logs the reason) if the file does not exist,
+      is truncated or was written with a different format version. */
+  static RobotModelSnapshotPtr load(const std::string& path);
+
+  /** \brief Write the snapshot to \e path. The file is replaced atomically, so concurrent readers either see the
+      previous or the new snapshot. Returns false on failure. */
+  bool save(const std::string& path) const;
+
+  /** \brief Returns true if this snapshot was created for the URDF and SRDF documents with the given hashes */
+  bool matches(std::uint64_t urdf_hash, std::uint64_t srdf_hash) const
+  {
+    return urdf_hash_ == urdf_hash && srdf_hash_ == srdf_hash;
+  }
+
+  /** \brief Get a copy of the mesh stored for \e resource at \e scale, or nullptr if there is none */
+  shapes::Mesh* getMesh(const std::string& resource, const Eigen::Vector3d& scale) const;
+
+  /** \brief Store a copy of \e mesh, loaded from \e resource at \e scale */
+  void addMesh(const std::string& resource, const Eigen::Vector3d& scale, const shapes::Mesh& mesh);
+
+  /** \brief Get the number of stored meshes */
+  std::size_t getMeshCount() const
+  {
+    return meshes_.size();
+  }
+
+  /** \brief Returns true if meshes were added since the snapshot was constructed or loaded */
+  bool isModified() const
+  {
+    return modified_;
+  }
+
+private:
+  static std::string meshKey(const std::string& resource, const Eigen::Vector3d& scale);
+
+  std::uint64_t urdf_hash_;
+  std::uint64_t srdf_hash_;
+  std::map<std::string, shapes::ShapeConstPtr> meshes_;
+  bool modified_;
+};
+}  // namespace core
+}  // namespace moveit
@@ -0,0 +1,504 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/robot_model/fk_kernel.h>
+#include <moveit/robot_model/robot_model.h>
+#include <cmath>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace moveit
+{
+namespace core
+{
+namespace
+{
+// 64 bit FNV-1a: simple and independent of the standard library implementation
+class KinematicHash
+{
+public:
+  void addBytes(const void* data, std::size_t size)
+  {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (std::size_t i = 0; i < size; ++i)
+    {
+      hash_ ^= bytes[i];
+      hash_ *= 1099511628211ull;
+    }
+  }
+
+  void addInt(std::int64_t value)
+  {
+    addBytes(&value, sizeof(value));
+  }
+
+  void addDouble(double value)
+  {
+    addBytes(&value, sizeof(value));
+  }
+
+  void addString(const std::string& value)
+  {
+    addInt(value.size());
+    addBytes(value.data(), value.size());
+  }
+
+  void addTransform(const Eigen::Isometry3d& transform)
+  {
+    for (int r = 0; r < 3; ++r)
+      for (int c = 0; c < 4; ++c)
+        addDouble(transform.matrix()(r, c));
+  }
+
+  std::uint64_t get() const
+  {
+    return hash_;
+  }
+
+private:
+  std::uint64_t hash_ = 14695981039346656037ull;
+};
+
+// function-local statics, as kernels register themselves during static initialization
+std::mutex& registryMutex()
+{
+  static std::mutex registry_mutex;
+  return registry_mutex;
+}
+
+std::map<std::uint64_t, FKKernel>& registry()
+{
+  static std::map<std::uint64_t, FKKernel> kernels;
+  return kernels;
+}
+
+/* Code generation helpers. Expressions are C++ code strings; the literals 0, 1 and -1 are folded away
+   such that e.g. the rotation about a principal axis only computes its non-trivial entries. */
+constexpr double LITERAL_EPSILON = 1e-15;
+
+std::string number(double value)
+{
+  std::ostringstream ss;
+  ss << std::setprecision(17) << value;
+  std::string s = ss.str();
+  if (s.find_first_of(".e") == std::string::npos)
+    s += ".0";
+  return value < 0.0 ? "(" + s + ")" : s;
+}
+
+std::string literal(double value)
+{
+  if (std::fabs(value) < LITERAL_EPSILON)
+    return "0";
+  if (std::fabs(value - 1.0) < LITERAL_EPSILON)
+    return "1";
+  if (std::fabs(value + 1.0) < LITERAL_EPSILON)
+    return "-1";
+  return number(value);
+}
+
+std::string negate(const std::string& a)
+{
+  if (a == "0")
+    return a;
+  if (a == "1")
+    return "-1";
+  if (a == "-1")
+    return "1";
+  // a leading minus negates the whole (atomic, product or parenthesized) expression
+  if (a[0] == '-')
+    return a.substr(1);
+  return "-" + a;
+}
+
+std::string product(const std::string& a, const std::string& b)
+{
+  if (a == "0" || b == "0")
+    return "0";
+  if (a == "1")
+    return b;
+  if (b == "1")
+    return a;
+  if (a == "-1")
+    return negate(b);
+  if (b == "-1")
+    return negate(a);
+  return a + " * " + b;
+}
+
+std::string sum(const std::vector<std::string>& terms)
+{
+  std::vector<std::string> non_zero;
+  for (const std::string& term : terms)
+    if (term != "0")
+      non_zero.push_back(term);
+  if (non_zero.empty())
+    return "0";
+  if (non_zero.size() == 1)
+    return non_zero[0];
+  std::string result = "(" + non_zero[0];
+  for (std::size_t i = 1; i < non_zero.size(); ++i)
+    result += " + " + non_zero[i];
+  return result + ")";
+}
+
+// as generated code: "1" and "-1" are integer literals there
+std::string code(const std::string& expression)
+{
+  if (expression == "0" || expression == "1" || expression == "-1")
+    return expression + ".0";
+  return expression;
+}
+
+bool isLiteral(const std::string& expression)
+{
+  return expression == "0" || expression == "1" || expression == "-1" ||
+         expression.find_first_not_of("0123456789.e+-()") == std::string::npos;
+}
+
+// a rigid transform whose entries are expressions
+struct TransformExpression
+{
+  std::string r[3][3];
+  std::string t[3];
+};
+
+TransformExpression literalTransform(const Eigen::Isometry3d& transform)
+{
+  TransformExpression result;
+  for (int i = 0; i < 3; ++i)
+  {
+    for (int j = 0; j < 3; ++j)
+      result.r[i][j] = literal(transform.linear()(i, j));
+    result.t[i] = literal(transform.translation()[i]);
+  }
+  return result;
+}
+
+TransformExpression compose(const TransformExpression& a, const TransformExpression& b)
+{
+  TransformExpression result;
+  for (int i = 0; i < 3; ++i)
+  {
+    for (int j = 0; j < 3; ++j)
+      result.r[i][j] = sum({ product(a.r[i][0], b.r[0][j]), product(a.r[i][1], b.r[1][j]),
+                             product(a.r[i][2], b.r[2][j]) });
+    result.t[i] = sum({ product(a.r[i][0], b.t[0]), product(a.r[i][1], b.t[1]), product(a.r[i][2], b.t[2]), a.t[i] });
+  }
+  return result;
+}
+
+// emit the joint transform of joint into out and return it as expression
+TransformExpression jointTransform(const JointModel* joint, std::ostream& out)
+{
+  TransformExpression j = literalTransform(Eigen::Isometry3d::Identity());
+  const std::string v = std::to_string(joint->getFirstVariableIndex());
+  switch (joint->getType())
+  {
+    case JointModel::FIXED:
+      break;
+    case JointModel::REVOLUTE:
+    {
+      const Eigen::Vector3d& a = static_cast<const RevoluteJointModel*>(joint)->getAxis();
+      const double x = a.x(), y = a.y(), z = a.z();
+      out << "    const double c = std::cos(p[" << v << "]);\n";
+      out << "    const double s = std::sin(p[" << v << "]);\n";
+      out << "    [[maybe_unused]] const double t = 1.0 - c;\n";
+      j.r[0][0] = sum({ product("t", literal(x * x)), "c" });
+      j.r[0][1] = sum({ product("t", literal(x * y)), negate(product("s", literal(z))) });
+      j.r[0][2] = sum({ product("t", literal(x * z)), product("s", literal(y)) });
+      j.r[1][0] = sum({ product("t", literal(x * y)), product("s", literal(z)) });
+      j.r[1][1] = sum({ product("t", literal(y * y)), "c" });
+      j.r[1][2] = sum({ product("t", literal(y * z)), negate(product("s", literal(x))) });
+      j.r[2][0] = sum({ product("t", literal(x * z)), negate(product("s", literal(y))) });
+      j.r[2][1] = sum({ product("t", literal(y * z)), product("s", literal(x)) });
+      j.r[2][2] = sum({ product("t", literal(z * z)), "c" });
+      break;
+    }
+    case JointModel::PRISMATIC:
+    {
+      const Eigen::Vector3d& a = static_cast<const PrismaticJointModel*>(joint)->getAxis();
+      for (int i = 0; i < 3; ++i)
+        j.t[i] = product("p[" + v + "]", literal(a[i]));
+      break;
+    }
+    case JointModel::PLANAR:
+    {
+      const std::string theta = std::to_string(joint->getFirstVariableIndex() + 2);
+      out << "    const double c = std::cos(p[" << theta << "]);\n";
+      out << "    const double s = std::sin(p[" << theta << "]);\n";
+      j.r[0][0] = "c";
+      j.r[0][1] = "-s";
+      j.r[1][0] = "s";
+      j.r[1][1] = "c";
+      j.t[0] = "p[" + v + "]";
+      j.t[1] = "p[" + std::to_string(joint->getFirstVariableIndex() + 1) + "]";
+      break;
+    }
+    case JointModel::FLOATING:
+    {
+      const int first = joint->getFirstVariableIndex();
+      out << "    const Eigen::Matrix3d m = Eigen::Quaterniond(p[" << first + 6 << "], p[" << first + 3 << "], p["
+          << first + 4 << "], p[" << first + 5 << "]).normalized().toRotationMatrix();\n";
+      for (int r = 0; r < 3; ++r)
+      {
+        for (int c = 0; c < 3; ++c)
+          j.r[r][c] = "m(" + std::to_string(r) + ", " + std::to_string(c) + ")";
+        j.t[r] = "p[" + std::to_string(first + r) + "]";
+      }
+      break;
+    }
+    default:
+      throw Exception("Cannot generate forward kinematics for joint '" + joint->getName() + "' of unknown type");
+  }
+  return j;
+}
+
+void generateLinkTransforms(const RobotModel& robot_model, std::ostream& out)
+{
+  out << "void computeLinkTransforms(const double* p, Eigen::Isometry3d* links)\n{\n";
+  for (const LinkModel* link : robot_model.getRootJoint()->getDescendantLinkModels())
+  {
+    out << "  // " << link->getName() << '\n';
+    out << "  {\n";
+    TransformExpression local =
+        compose(literalTransform(link->getJointOriginTransform()), jointTransform(link->getParentJointModel(), out));
+
+    // materialize the local transform, so the composition with the parent stays small
+    for (int i = 0; i < 3; ++i)
+    {
+      for (int j = 0; j < 3; ++j)
+        if (!isLiteral(local.r[i][j]))
+        {
+          const std::string name = "l_r" + std::to_string(i) + std::to_string(j);
+          out << "    const double " << name << " = " << local.r[i][j] << ";\n";
+          local.r[i][j] = name;
+        }
+      if (!isLiteral(local.t[i]))
+      {
+        const std::string name = "l_t" + std::to_string(i);
+        out << "    const double " << name << " = " << local.t[i] << ";\n";
+        local.t[i] = name;
+      }
+    }
+
+    TransformExpression global = local;
+    if (const LinkModel* parent = link->getParentLinkModel())
+    {
+      out << "    const double* pt = links[" << parent->getLinkIndex() << "].data();\n";
+      TransformExpression parent_transform;
+      for (int i = 0; i < 3; ++i)
+      {
+        for (int j = 0; j < 3; ++j)
+          parent_transform.r[i][j] = "pt[" + std::to_string(j * 4 + i) + "]";
+        parent_transform.t[i] = "pt[" + std::to_string(12 + i) + "]";
+      }
+      global = compose(parent_transform, local);
+    }
+
+    out << "    double* d = links[" << link->getLinkIndex() << "].data();\n";
+    for (int j = 0; j < 3; ++j)
+      for (int i = 0; i < 3; ++i)
+        out << "    d[" << j * 4 + i << "] = " << code(global.r[i][j]) << ";\n";
+    for (int i = 0; i < 3; ++i)
+      out << "    d[" << 12 + i << "] = " << code(global.t[i]) << ";\n";
+    out << "  }\n";
+  }
+  out << "}\n";
+}
+
+// returns false if the group is not eligible for a Jacobian kernel
+bool generateJacobian(const JointModelGroup* group, const std::string& function_name, std::ostream& out)
+{
+  if (!group->isChain() || group->getLinkModels().empty() || group->getJointModels().empty())
+    return false;
+
+  // collect the contributing joints just like RobotState::getJacobian() does
+  struct Column
+  {
+    JointModel::JointType type;
+    int child_link_index;
+    int column;
+    Eigen::Vector3d axis;
+  };
+  std::vector<Column> columns;
+  const LinkModel* tip = group->getLinkModels().back();
+  const JointModel* root_joint_model = group->getJointModels()[0];
+  const LinkModel* root_link_model = root_joint_model->getParentLinkModel();
+  const LinkModel* link = tip;
+  while (link)
+  {
+    const JointModel* pjm = link->getParentJointModel();
+    if (pjm->getVariableCount() > 0)
+    {
+      if (!group->hasJointModel(pjm->getName()))
+      {
+        link = pjm->getParentLinkModel();
+        continue;
+      }
+      if (pjm->getType() == JointModel::REVOLUTE)
+        columns.push_back({ pjm->getType(), link->getLinkIndex(), group->getVariableGroupIndex(pjm->getName()),
+                            static_cast<const RevoluteJointModel*>(pjm)->getAxis() });
+      else if (pjm->getType() == JointModel::PRISMATIC)
+        columns.push_back({ pjm->getType(), link->getLinkIndex(), group->getVariableGroupIndex(pjm->getName()),
+                            static_cast<const PrismaticJointModel*>(pjm)->getAxis() });
+      else
+        return false;
+    }
+    if (pjm == root_joint_model)
+      break;
+    link = pjm->getParentLinkModel();
+  }
+
+  out << "// group " << group->getName() << ", tip link " << tip->getName() << '\n';
+  out << "void " << function_name
+      << "(const Eigen::Isometry3d* links, const Eigen::Vector3d& reference_point, double* jacobian)\n{\n";
+  out << "  Eigen::Map<Eigen::Matrix<double, 6, Eigen::Dynamic>> j(jacobian, 6, " << group->getVariableCount() << ");\n";
+  out << "  j.setZero();\n";
+  if (root_link_model)
+    out << "  const Eigen::Isometry3d reference = links[" << root_link_model->getLinkIndex() << "].inverse();\n";
+  else
+    out << "  const Eigen::Isometry3d reference = Eigen::Isometry3d::Identity();\n";
+  out << "  const Eigen::Vector3d point = reference * (links[" << tip->getLinkIndex() << "] * reference_point);\n";
+  for (const Column& column : columns)
+  {
+    const std::string col = std::to_string(column.column);
+    out << "  {\n";
+    out << "    const Eigen::Isometry3d joint = reference * links[" << column.child_link_index << "];\n";
+    out << "    const Eigen::Vector3d axis = joint.linear() * Eigen::Vector3d(" << number(column.axis.x()) << ", "
+        << number(column.axis.y()) << ", " << number(column.axis.z()) << ");\n";
+    if (column.type == JointModel::REVOLUTE)
+    {
+      out << "    j.block<3, 1>(0, " << col << ") += axis.cross(point - joint.translation());\n";
+      out << "    j.block<3, 1>(3, " << col << ") += axis;\n";
+    }
+    else
+      out << "    j.block<3, 1>(0, " << col << ") += axis;\n";
+    out << "  }\n";
+  }
+  out << "}\n";
+  return true;
+}
+
+std::string escape(const std::string& s)
+{
+  std::string result;
+  for (char c : s)
+  {
+    if (c == '"' || c == '\\')
+      result += '\\';
+    result += c;
+  }
+  return result;
+}
+}  // namespace
+
+std::uint64_t computeKinematicModelHash(const RobotModel& robot_model)
+{
+  KinematicHash hash;
+  hash.addInt(robot_model.getVariableCount());
+  for (const LinkModel* link : robot_model.getLinkModels())
+  {
+    const JointModel* joint = link->getParentJointModel();
+    hash.addString(link->getName());
+    hash.addInt(link->getLinkIndex());
+    hash.addInt(link->getParentLinkModel() ? link->getParentLinkModel()->getLinkIndex() : -1);
+    hash.addTransform(link->getJointOriginTransform());
+    hash.addString(joint->getName());
+    hash.addInt(joint->getType());
+    hash.addInt(joint->getFirstVariableIndex());
+    hash.addInt(joint->getVariableCount());
+    if (joint->getType() == JointModel::REVOLUTE)
+      for (int i = 0; i < 3; ++i)
+        hash.addDouble(static_cast<const RevoluteJointModel*>(joint)->getAxis()[i]);
+    else if (joint->getType() == JointModel::PRISMATIC)
+      for (int i = 0; i < 3; ++i)
+        hash.addDouble(static_cast<const PrismaticJointModel*>(joint)->getAxis()[i]);
+  }
+  return hash.get();
+}
+
+void registerFKKernel(const FKKernel& kernel)
+{
+  std::lock_guard<std::mutex> guard(registryMutex());
+  registry().emplace(kernel.model_hash, kernel);
+}
+
+const FKKernel* findFKKernel(std::uint64_t model_hash)
+{
+  std::lock_guard<std::mutex> guard(registryMutex());
+  auto it = registry().find(model_hash);
+  return it == registry().end() ? nullptr : &it->second;
+}
+
+std::string generateFKKernelSource(const RobotModel& robot_model)
+{
+  std::ostringstream out;
+  out << "// Forward kinematics kernels for robot '" << robot_model.getName() << "'.\n";
+  out << "// Generated by moveit_fk_kernel_generator, do not edit.\n\n";
+  out << "#include <moveit/robot_model/fk_kernel.h>\n";
+  out << "#include <cmath>\n\n";
+  out << "namespace\n{\n";
+  generateLinkTransforms(robot_model, out);
+
+  std::map<std::string, std::string> jacobians;
+  for (const JointModelGroup* group : robot_model.getJointModelGroups())
+  {
+    const std::string function_name = "computeJacobian" + std::to_string(jacobians.size());
+    std::ostringstream function;
+    if (generateJacobian(group, function_name, function))
+    {
+      out << '\n' << function.str();
+      jacobians[group->getName()] = function_name;
+    }
+  }
+
+  out << "\nstruct Registration\n{\n";
+  out << "  Registration()\n  {\n";
+  out << "    moveit::core::FKKernel kernel;\n";
+  out << "    kernel.robot_name = \"" << escape(robot_model.getName()) << "\";\n";
+  out << "    kernel.model_hash = 0x" << std::hex << computeKinematicModelHash(robot_model) << std::dec << "ull;\n";
+  out << "    kernel.compute_link_transforms = &computeLinkTransforms;\n";
+  for (const auto& jacobian : jacobians)
+    out << "    kernel.jacobians[\"" << escape(jacobian.first) << "\"] = &" << jacobian.second << ";\n";
+  out << "    moveit::core::registerFKKernel(kernel);\n";
+  out << "  }\n};\n\n";
+  out << "const Registration REGISTRATION;\n";
+  out << "}  // namespace\n";
+  return out.str();
+}
+}  // namespace core
+}  // namespace moveit
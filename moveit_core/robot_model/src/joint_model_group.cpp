@@ -111,6 +111,7 @@ JointModelGroup::JointModelGroup(const std::string& group_name, const srdf::Mode
   , is_contiguous_index_list_(true)
   , is_chain_(false)
   , is_single_dof_(true)
+  , per_thread_solver_instances_(false)
   , config_(config)
 {
   // sort joints in Depth-First order
@@ -563,6 +564,51 @@ void JointModelGroup::setDefaultIKTimeout(double ik_timeout)
     group_kinematics_.first.solver_instance_->setDefaultTimeout(ik_timeout);
   for (std::pair<const JointModelGroup* const, KinematicsSolver>& it : group_kinematics_.second)
     it.second.default_ik_timeout_ = ik_timeout;
+  std::scoped_lock slock(thread_solver_instances_lock_);
+  for (std::pair<const std::thread::id, kinematics::KinematicsBasePtr>& it : thread_solver_instances_)
+    it.second->setDefaultTimeout(ik_timeout);
+}
+
+bool JointModelGroup::setRedundantJoints(const std::vector<std::string>& joints)
+{
+  const kinematics::KinematicsBasePtr& solver = group_kinematics_.first.solver_instance_;
+  if (!solver || !solver->setRedundantJoints(joints))
+    return false;
+  std::scoped_lock slock(thread_solver_instances_lock_);
+  for (std::pair<const std::thread::id, kinematics::KinematicsBasePtr>& it : thread_solver_instances_)
+    it.second->setRedundantJoints(joints);
+  return true;
+}
+
+kinematics::KinematicsBaseConstPtr JointModelGroup::getThreadSolverInstance() const
+{
+  const KinematicsSolver& solver = group_kinematics_.first;
+  if (!solver.solver_instance_)
+    return solver.solver_instance_;
+  const std::thread::id thread = std::this_thread::get_id();
+  {
+    std::scoped_lock slock(thread_solver_instances_lock_);
+    std::map<std::thread::id, kinematics::KinematicsBasePtr>::const_iterator it = thread_solver_instances_.find(thread);
+    if (it != thread_solver_instances_.end())
+      return it->second;
+  }
+
+  // initializing a solver can take a while, so allocate it without holding the lock
+  kinematics::KinematicsBasePtr instance = solver.allocator_(this);
+  if (!instance)
+  {
+    RCLCPP_WARN(LOGGER, "Could not allocate a kinematics solver of group '%s' for this thread, using the shared one",
+                name_.c_str());
+    return solver.solver_instance_;
+  }
+  instance->setDefaultTimeout(solver.default_ik_timeout_);
+  std::vector<unsigned int> redundant_joints;
+  solver.solver_instance_->getRedundantJoints(redundant_joints);
+  if (!redundant_joints.empty())
+    instance->setRedundantJoints(redundant_joints);
+
+  std::scoped_lock slock(thread_solver_instances_lock_);
+  return thread_solver_instances_[thread] = instance;
 }
 
 bool JointModelGroup::computeIKIndexBijection(const std::vector<std::string>& ik_jnames,
@@ -592,6 +638,11 @@ bool JointModelGroup::computeIKIndexBijection(const std::vector<std::string>& ik
 
 void JointModelGroup::setSolverAllocators(const std::pair<SolverAllocatorFn, SolverAllocatorMapFn>& solvers)
 {
+  {
+    // instances of a previous allocator are not used anymore
+    std::scoped_lock slock(thread_solver_instances_lock_);
+    thread_solver_instances_.clear();
+  }
   if (solvers.first)
   {
     group_kinematics_.first.allocator_ = solvers.first;
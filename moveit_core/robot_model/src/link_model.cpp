@@ -51,6 +51,7 @@ LinkModel::LinkModel(const std::string& name, size_t link_index)
   , parent_link_model_(nullptr)
   , is_parent_joint_fixed_(false)
   , joint_origin_transform_is_identity_(true)
+  , bounding_sphere_radius_(0.0)
   , first_collision_body_transform_index_(-1)
 {
   joint_origin_transform_.setIdentity();
@@ -113,6 +114,7 @@ void LinkModel::setGeometry(const std::vector<shapes::ShapeConstPtr>& shapes, co
     shape_extents_.setZero();
   else
     shape_extents_ = aabb.sizes();
+  bounding_sphere_radius_ = 0.5 * shape_extents_.norm();
 }
 
 void LinkModel::setVisualMesh(const std::string& visual_mesh, const Eigen::Isometry3d& origin,
@@ -0,0 +1,77 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/robot_model/memory_usage.h>
+#include <octomap/OcTree.h>
+
+namespace moveit
+{
+namespace core
+{
+std::size_t getShapeMemoryUsage(const shapes::Shape& shape)
+{
+  switch (shape.type)
+  {
+    case shapes::MESH:
+    {
+      const auto& mesh = static_cast<const shapes::Mesh&>(shape);
+      std::size_t size = sizeof(shapes::Mesh) + mesh.vertex_count * 3 * sizeof(double) +
+                         mesh.triangle_count * 3 * sizeof(unsigned int);
+      if (mesh.triangle_normals)
+        size += mesh.triangle_count * 3 * sizeof(double);
+      if (mesh.vertex_normals)
+        size += mesh.vertex_count * 3 * sizeof(double);
+      return size;
+    }
+    case shapes::OCTREE:
+    {
+      const auto& octree = static_cast<const shapes::OcTree&>(shape);
+      return sizeof(shapes::OcTree) + (octree.octree ? octree.octree->memoryUsage() : 0);
+    }
+    case shapes::SPHERE:
+      return sizeof(shapes::Sphere);
+    case shapes::CYLINDER:
+      return sizeof(shapes::Cylinder);
+    case shapes::CONE:
+      return sizeof(shapes::Cone);
+    case shapes::BOX:
+      return sizeof(shapes::Box);
+    case shapes::PLANE:
+      return sizeof(shapes::Plane);
+    default:
+      return sizeof(shapes::Shape);
+  }
+}
+}  // namespace core
+}  // namespace moveit
@@ -36,12 +36,14 @@
 /* Author: Ioan Sucan */
 
 #include <moveit/robot_model/robot_model.h>
+#include <moveit/robot_model/memory_usage.h>
 #include <geometric_shapes/shape_operations.h>
 #include <rclcpp/logger.hpp>
 #include <algorithm>
 #include <limits>
 #include <cmath>
 #include <memory>
+#include <set>
 
 #include "order_robot_model_items.inc"
 
@@ -54,11 +56,25 @@ static const rclcpp::Logger LOGGER = rclcpp::get_logger("moveit_robot_model.robo
 RobotModel::RobotModel(const urdf::ModelInterfaceSharedPtr& urdf_model, const srdf::ModelConstSharedPtr& srdf_model)
 {
   root_joint_ = nullptr;
+  fk_kernel_ = nullptr;
+  snapshot_ = nullptr;
   urdf_ = urdf_model;
   srdf_ = srdf_model;
   buildModel(*urdf_model, *srdf_model);
 }
 
+RobotModel::RobotModel(const urdf::ModelInterfaceSharedPtr& urdf_model, const srdf::ModelConstSharedPtr& srdf_model,
+                       RobotModelSnapshot& snapshot)
+{
+  root_joint_ = nullptr;
+  fk_kernel_ = nullptr;
+  snapshot_ = &snapshot;
+  urdf_ = urdf_model;
+  srdf_ = srdf_model;
+  buildModel(*urdf_model, *srdf_model);
+  snapshot_ = nullptr;
+}
+
 RobotModel::~RobotModel()
 {
   for (std::pair<const std::string, JointModelGroup*>& it : joint_model_group_map_)
@@ -116,6 +132,12 @@ void RobotModel::buildModel(const urdf::ModelInterface& urdf_model, const srdf::
     RCLCPP_DEBUG(LOGGER, "... constructing joint group states");
     buildGroupStates(srdf_model);
 
+    fk_kernel_ = findFKKernel(computeKinematicModelHash(*this));
+    if (fk_kernel_)
+    {
+      RCLCPP_INFO(LOGGER, "... using generated forward kinematics kernel for '%s'", fk_kernel_->robot_name.c_str());
+    }
+
     // For debugging entire model
     // printModelInfo(std::cout);
   }
@@ -1192,7 +1214,13 @@ shapes::ShapePtr RobotModel::constructShape(const urdf::Geometry* geom)
       if (!mesh->filename.empty())
       {
         Eigen::Vector3d scale(mesh->scale.x, mesh->scale.y, mesh->scale.z);
-        shapes::Mesh* m = shapes::createMeshFromResource(mesh->filename, scale);
+        shapes::Mesh* m = snapshot_ ? snapshot_->getMesh(mesh->filename, scale) : nullptr;
+        if (!m)
+        {
+          m = shapes::createMeshFromResource(mesh->filename, scale);
+          if (m && snapshot_)
+            snapshot_->addMesh(mesh->filename, scale, *m);
+        }
         new_shape = m;
       }
     }
@@ -1353,6 +1381,12 @@ size_t RobotModel::getVariableIndex(const std::string& variable) const
   return it->second;
 }
 
+int RobotModel::findVariableIndex(const std::string& variable) const
+{
+  VariableIndexMap::const_iterator it = joint_variables_index_map_.find(variable);
+  return it == joint_variables_index_map_.end() ? -1 : static_cast<int>(it->second);
+}
+
 double RobotModel::getMaximumExtent(const JointBoundsVector& active_joint_bounds) const
 {
   double max_distance = 0.0;
@@ -1480,6 +1514,31 @@ void RobotModel::setKinematicsAllocators(const std::map<std::string, SolverAlloc
   }
 }
 
+std::size_t RobotModel::getMemoryUsage() const
+{
+  std::size_t size = sizeof(RobotModel);
+  std::set<const shapes::Shape*> shapes;
+  for (const LinkModel* link : link_model_vector_)
+  {
+    size += sizeof(LinkModel) + link->getName().capacity();
+    for (const shapes::ShapeConstPtr& shape : link->getShapes())
+      if (shape && shapes.insert(shape.get()).second)
+        size += getShapeMemoryUsage(*shape);
+  }
+  for (const JointModel* joint : joint_model_vector_)
+    size += sizeof(JointModel) + joint->getName().capacity() +
+            joint->getVariableCount() * (sizeof(VariableBounds) + sizeof(std::string));
+  for (const JointModelGroup* group : joint_model_groups_)
+    size += sizeof(JointModelGroup) + group->getName().capacity() +
+            group->getVariableCount() * (sizeof(int) + sizeof(std::string)) +
+            group->getLinkModels().size() * sizeof(const LinkModel*);
+  for (const std::string& name : variable_names_)
+    size += sizeof(std::string) + name.capacity();
+  // the common roots of all joint pairs
+  size += common_joint_roots_.capacity() * sizeof(int);
+  return size;
+}
+
 void RobotModel::printModelInfo(std::ostream& out) const
 {
   out << "Model " << model_name_ << " in frame " << model_frame_ << ", using " << getVariableCount() << " variables\n";
@@ -0,0 +1,282 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/robot_model/robot_model_snapshot.h>
+#include <rclcpp/logger.hpp>
+#include <rclcpp/logging.hpp>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+namespace moveit
+{
+namespace core
+{
+namespace
+{
+const rclcpp::Logger LOGGER = rclcpp::get_logger("moveit_robot_model.robot_model_snapshot");
+
+// identifies the file type, followed by the format version and the sizes of the stored types
+constexpr char MAGIC[8] = { 'M', 'V', 'T', 'S', 'N', 'A', 'P', '\0' };
+
+enum MeshFlags : std::uint8_t
+{
+  TRIANGLE_NORMALS = 1,
+  VERTEX_NORMALS = 2
+};
+
+template <typename T>
+void write(std::ostream& out, const T& value)
+{
+  out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+void writeArray(std::ostream& out, const T* values, std::size_t count)
+{
+  out.write(reinterpret_cast<const char*>(values), sizeof(T) * count);
+}
+
+// Reads from a buffer holding the whole file; all reads fail once the end is exceeded
+class Reader
+{
+public:
+  Reader(const std::string& buffer) : data_(buffer.data()), remaining_(buffer.size())
+  {
+  }
+
+  template <typename T>
+  bool read(T& value)
+  {
+    return readArray(&value, 1);
+  }
+
+  template <typename T>
+  bool readArray(T* values, std::size_t count)
+  {
+    const std::size_t bytes = sizeof(T) * count;
+    if (count > remaining_ / sizeof(T))
+      return false;
+    std::memcpy(values, data_, bytes);
+    data_ += bytes;
+    remaining_ -= bytes;
+    return true;
+  }
+
+  bool readString(std::string& value, std::size_t size)
+  {
+    if (size > remaining_)
+      return false;
+    value.assign(data_, size);
+    data_ += size;
+    remaining_ -= size;
+    return true;
+  }
+
+private:
+  const char* data_;
+  std::size_t remaining_;
+};
+}  // namespace
+
+RobotModelSnapshot::RobotModelSnapshot(std::uint64_t urdf_hash, std::uint64_t srdf_hash)
+  : urdf_hash_(urdf_hash), srdf_hash_(srdf_hash), modified_(false)
+{
+}
+
+std::uint64_t RobotModelSnapshot::hashDescription(const std::string& description)
+{
+  // FNV-1a
+  std::uint64_t hash = 14695981039346656037ull;
+  for (const char c : description)
+  {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+std::string RobotModelSnapshot::meshKey(const std::string& resource, const Eigen::Vector3d& scale)
+{
+  std::stringstream key;
+  key.precision(17);
+  key << resource << ' ' << scale.x() << ' ' << scale.y() << ' ' << scale.z();
+  return key.str();
+}
+
+shapes::Mesh* RobotModelSnapshot::getMesh(const std::string& resource, const Eigen::Vector3d& scale) const
+{
+  const auto it = meshes_.find(meshKey(resource, scale));
+  if (it == meshes_.end())
+    return nullptr;
+  return static_cast<shapes::Mesh*>(it->second->clone());
+}
+
+void RobotModelSnapshot::addMesh(const std::string& resource, const Eigen::Vector3d& scale, const shapes::Mesh& mesh)
+{
+  meshes_[meshKey(resource, scale)].reset(mesh.clone());
+  modified_ = true;
+}
+
+bool RobotModelSnapshot::save(const std::string& path) const
+{
+  const std::string tmp_path = path + ".tmp";
+  {
+    std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+    if (!out)
+    {
+      RCLCPP_ERROR(LOGGER, "Unable to write robot model snapshot '%s'", tmp_path.c_str());
+      return false;
+    }
+    out.write(MAGIC, sizeof(MAGIC));
+    write(out, FORMAT_VERSION);
+    write(out, static_cast<std::uint8_t>(sizeof(double)));
+    write(out, static_cast<std::uint8_t>(sizeof(unsigned int)));
+    write(out, urdf_hash_);
+    write(out, srdf_hash_);
+    write(out, static_cast<std::uint64_t>(meshes_.size()));
+    for (const auto& entry : meshes_)
+    {
+      const shapes::Mesh& mesh = static_cast<const shapes::Mesh&>(*entry.second);
+      write(out, static_cast<std::uint64_t>(entry.first.size()));
+      out.write(entry.first.data(), entry.first.size());
+      write(out, static_cast<std::uint32_t>(mesh.vertex_count));
+      write(out, static_cast<std::uint32_t>(mesh.triangle_count));
+      write(out, static_cast<std::uint8_t>((mesh.triangle_normals ? TRIANGLE_NORMALS : 0) |
+                                           (mesh.vertex_normals ? VERTEX_NORMALS : 0)));
+      writeArray(out, mesh.vertices, 3 * mesh.vertex_count);
+      writeArray(out, mesh.triangles, 3 * mesh.triangle_count);
+      if (mesh.triangle_normals)
+        writeArray(out, mesh.triangle_normals, 3 * mesh.triangle_count);
+      if (mesh.vertex_normals)
+        writeArray(out, mesh.vertex_normals, 3 * mesh.vertex_count);
+    }
+    if (!out)
+    {
+      RCLCPP_ERROR(LOGGER, "Failed writing robot model snapshot '%s'", tmp_path.c_str());
+      return false;
+    }
+  }
+
+  std::error_code error;
+  std::filesystem::rename(tmp_path, path, error);
+  if (error)
+  {
+    RCLCPP_ERROR(LOGGER, "Unable to replace robot model snapshot '%s': %s", path.c_str(), error.message().c_str());
+    std::remove(tmp_path.c_str());
+    return false;
+  }
+  return true;
+}
+
+RobotModelSnapshotPtr RobotModelSnapshot::load(const std::string& path)
+{
+  std::ifstream in(path, std::ios::binary);
+  if (!in)
+  {
+    RCLCPP_DEBUG(LOGGER, "No robot model snapshot at '%s'", path.c_str());
+    return RobotModelSnapshotPtr();
+  }
+  const std::string buffer((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  Reader reader(buffer);
+
+  char magic[sizeof(MAGIC)];
+  std::uint32_t version;
+  std::uint8_t double_size, index_size;
+  if (!reader.readArray(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 ||
+      !reader.read(version) || !reader.read(double_size) || !reader.read(index_size))
+  {
+    RCLCPP_WARN(LOGGER, "'%s' is not a robot model snapshot", path.c_str());
+    return RobotModelSnapshotPtr();
+  }
+  if (version != FORMAT_VERSION || double_size != sizeof(double) || index_size != sizeof(unsigned int))
+  {
+    RCLCPP_INFO(LOGGER, "Ignoring robot model snapshot '%s' written in an incompatible format", path.c_str());
+    return RobotModelSnapshotPtr();
+  }
+
+  std::uint64_t urdf_hash, srdf_hash, mesh_count;
+  if (!reader.read(urdf_hash) || !reader.read(srdf_hash) || !reader.read(mesh_count))
+  {
+    RCLCPP_WARN(LOGGER, "Robot model snapshot '%s' is truncated", path.c_str());
+    return RobotModelSnapshotPtr();
+  }
+
+  auto snapshot = std::make_shared<RobotModelSnapshot>(urdf_hash, srdf_hash);
+  for (std::uint64_t i = 0; i < mesh_count; ++i)
+  {
+    std::uint64_t key_size;
+    std::string key;
+    std::uint32_t vertex_count, triangle_count;
+    std::uint8_t flags;
+    if (!reader.read(key_size) || !reader.readString(key, key_size) || !reader.read(vertex_count) ||
+        !reader.read(triangle_count) || !reader.read(flags))
+    {
+      RCLCPP_WARN(LOGGER, "Robot model snapshot '%s' is truncated", path.c_str());
+      return RobotModelSnapshotPtr();
+    }
+
+    auto mesh = std::make_shared<shapes::Mesh>(vertex_count, triangle_count);
+    bool ok =
+        reader.readArray(mesh->vertices, 3 * vertex_count) && reader.readArray(mesh->triangles, 3 * triangle_count);
+    if (ok && (flags & TRIANGLE_NORMALS))
+    {
+      if (!mesh->triangle_normals)
+        mesh->triangle_normals = new double[3 * triangle_count];
+      ok = reader.readArray(mesh->triangle_normals, 3 * triangle_count);
+    }
+    else if (ok)
+      mesh->computeTriangleNormals();
+    if (ok && (flags & VERTEX_NORMALS))
+    {
+      if (!mesh->vertex_normals)
+        mesh->vertex_normals = new double[3 * vertex_count];
+      ok = reader.readArray(mesh->vertex_normals, 3 * vertex_count);
+    }
+    else if (ok)
+      mesh->computeVertexNormals();
+    if (!ok)
+    {
+      RCLCPP_WARN(LOGGER, "Robot model snapshot '%s' is truncated", path.c_str());
+      return RobotModelSnapshotPtr();
+    }
+    snapshot->meshes_[key] = mesh;
+  }
+  return snapshot;
+}
+}  // namespace core
+}  // namespace moveit
@@ -35,7 +35,10 @@
 /* Author: Ioan Sucan */
 
 #include <moveit/robot_model/robot_model.h>
+#include <moveit/robot_model/joint_name_layout.h>
+#include <moveit/robot_model/robot_model_snapshot.h>
 #include <urdf_parser/urdf_parser.h>
+#include <filesystem>
 #include <fstream>
 #include <gtest/gtest.h>
 
@@ -92,6 +95,26 @@ TEST_F(LoadPlanningModelsPr2, Model)
   EXPECT_FALSE(bounds.jerk_bounded_);
 }
 
+TEST_F(LoadPlanningModelsPr2, JointNameLayout)
+{
+  moveit::core::JointNameLayout layout(robot_model_);
+  const std::vector<std::string> names = { "r_shoulder_pan_joint", "not_a_joint", "torso_lift_joint" };
+  EXPECT_TRUE(layout.update(names));
+  ASSERT_EQ(layout.getJointModels().size(), 3u);
+  EXPECT_EQ(layout.getJointModels()[0], robot_model_->getJointModel("r_shoulder_pan_joint"));
+  EXPECT_EQ(layout.getJointModels()[1], nullptr);
+  EXPECT_EQ(layout.getJointModels()[2], robot_model_->getJointModel("torso_lift_joint"));
+  EXPECT_EQ(layout.getVariableIndices()[0], static_cast<int>(robot_model_->getVariableIndex("r_shoulder_pan_joint")));
+  EXPECT_EQ(layout.getVariableIndices()[1], -1);
+  EXPECT_EQ(layout.getVariableIndices()[2], static_cast<int>(robot_model_->getVariableIndex("torso_lift_joint")));
+
+  // the same layout is not looked up again, a different one is
+  EXPECT_FALSE(layout.update(names));
+  EXPECT_TRUE(layout.update({ "torso_lift_joint" }));
+  ASSERT_EQ(layout.getVariableIndices().size(), 1u);
+  EXPECT_EQ(layout.getJointModels()[0], robot_model_->getJointModel("torso_lift_joint"));
+}
+
 TEST(SiblingAssociateLinks, SimpleYRobot)
 {
   /* base_link - a - b - c
@@ -128,6 +151,55 @@ TEST(SiblingAssociateLinks, SimpleYRobot)
   }
 }
 
+TEST(RobotModelSnapshot, RoundTrip)
+{
+  urdf::ModelInterfaceSharedPtr urdf = moveit::core::loadModelInterface("panda");
+  srdf::ModelSharedPtr srdf = moveit::core::loadSRDFModel("panda");
+  ASSERT_TRUE(urdf && srdf);
+
+  // building a model fills an empty snapshot with the loaded meshes
+  moveit::core::RobotModelSnapshot snapshot(1, 2);
+  moveit::core::RobotModel model(urdf, srdf, snapshot);
+  EXPECT_TRUE(snapshot.isModified());
+  ASSERT_GT(snapshot.getMeshCount(), 0u);
+
+  const std::string path = (std::filesystem::temp_directory_path() / "test_robot_model.moveit_snapshot").string();
+  ASSERT_TRUE(snapshot.save(path));
+  moveit::core::RobotModelSnapshotPtr loaded = moveit::core::RobotModelSnapshot::load(path);
+  ASSERT_TRUE(loaded);
+  EXPECT_TRUE(loaded->matches(1, 2));
+  EXPECT_FALSE(loaded->matches(1, 3));
+  EXPECT_FALSE(loaded->isModified());
+  EXPECT_EQ(loaded->getMeshCount(), snapshot.getMeshCount());
+
+  // a model built from the loaded snapshot has the same geometry, without loading any mesh
+  moveit::core::RobotModel cached_model(urdf, srdf, *loaded);
+  EXPECT_FALSE(loaded->isModified());
+  for (const moveit::core::LinkModel* link : model.getLinkModels())
+  {
+    const moveit::core::LinkModel* cached_link = cached_model.getLinkModel(link->getName());
+    ASSERT_EQ(link->getShapes().size(), cached_link->getShapes().size());
+    for (std::size_t i = 0; i < link->getShapes().size(); ++i)
+    {
+      ASSERT_EQ(link->getShapes()[i]->type, cached_link->getShapes()[i]->type);
+      if (link->getShapes()[i]->type != shapes::MESH)
+        continue;
+      const auto& mesh = static_cast<const shapes::Mesh&>(*link->getShapes()[i]);
+      const auto& cached_mesh = static_cast<const shapes::Mesh&>(*cached_link->getShapes()[i]);
+      ASSERT_EQ(mesh.vertex_count, cached_mesh.vertex_count);
+      ASSERT_EQ(mesh.triangle_count, cached_mesh.triangle_count);
+      EXPECT_TRUE(std::equal(mesh.vertices, mesh.vertices + 3 * mesh.vertex_count, cached_mesh.vertices));
+      EXPECT_TRUE(std::equal(mesh.triangles, mesh.triangles + 3 * mesh.triangle_count, cached_mesh.triangles));
+    }
+  }
+
+  // truncated files are rejected
+  std::filesystem::resize_file(path, std::filesystem::file_size(path) / 2);
+  EXPECT_FALSE(moveit::core::RobotModelSnapshot::load(path));
+  std::filesystem::remove(path);
+  EXPECT_FALSE(moveit::core::RobotModelSnapshot::load(path));
+}
+
 int main(int argc, char** argv)
 {
   testing::InitGoogleTest(&argc, argv);
@@ -90,6 +90,25 @@ struct MaxEEFStep
   double rotation;     // Radians
 };
 
+/** \brief Struct for configuring computeCartesianPathParallel().
+    The path is first solved at every \e coarse_step_factor-th step of the regular resolution. The intervals between
+    consecutive coarse states are then refined in parallel: an interval is bisected until moving linearly in joint
+    space between its end states deviates from the Cartesian path by at most \e translation_tolerance and
+    \e rotation_tolerance (and, if non-zero, the joint-space distance of the end states is at most
+    \e max_joint_step), or until the interval is shorter than the MaxEEFStep. */
+struct AdaptiveRefinement
+{
+  std::size_t coarse_step_factor = 10;
+  double translation_tolerance = 0.001;  // Meters
+  double rotation_tolerance = 0.01;      // Radians
+  double max_joint_step = 0.0;           // as measured by RobotState::distance(); zero disables the check
+
+  /** \brief Number of threads refining intervals, zero to use std::thread::hardware_concurrency().
+      All threads call the group's kinematics solver and \e validCallback concurrently, so both need to be
+      thread-safe when this is not 1. */
+  std::size_t thread_count = 0;
+};
+
 class CartesianInterpolator
 {
   // TODO(mlautman): Eventually, this planner should be moved out of robot_state
@@ -211,6 +230,28 @@ public:
                        const kinematics::KinematicsQueryOptions& options = kinematics::KinematicsQueryOptions(),
                        kinematics::KinematicsBase::IKCostFn cost_function = kinematics::KinematicsBase::IKCostFn());
 
+  /** \brief Compute a general Cartesian path, like the waypoints variant of computeCartesianPath(), but with
+     adaptive resolution and in parallel.
+
+     The path is first solved sequentially at a coarse resolution (see AdaptiveRefinement), each IK query seeded
+     with the solution of the preceding coarse point. The intervals between coarse solutions are then refined
+     concurrently, each IK query seeded by interpolating its neighbouring solutions in joint space, and only where
+     the joint-space interpolation deviates from the Cartesian path. Consecutive states of \e traj are thus either
+     at most \e max_step apart, or moving linearly in joint space between them follows the path within the
+     tolerances of \e refinement.
+
+     The returned fraction has the same meaning as for computeCartesianPath(). Relative waypoints are resolved
+     with respect to the previous commanded waypoint. At the end of the call, \e start_state holds the last state
+     of \e traj. */
+  static Percentage computeCartesianPathParallel(
+      RobotState* start_state, const JointModelGroup* group, std::vector<std::shared_ptr<RobotState>>& traj,
+      const LinkModel* link, const EigenSTL::vector_Isometry3d& waypoints, bool global_reference_frame,
+      const MaxEEFStep& max_step, const JumpThreshold& jump_threshold,
+      const AdaptiveRefinement& refinement = AdaptiveRefinement(),
+      const GroupStateValidityCallbackFn& validCallback = GroupStateValidityCallbackFn(),
+      const kinematics::KinematicsQueryOptions& options = kinematics::KinematicsQueryOptions(),
+      kinematics::KinematicsBase::IKCostFn cost_function = kinematics::KinematicsBase::IKCostFn());
+
   /** \brief Tests joint space jumps of a trajectory.
 
      If \e jump_threshold_factor is non-zero, we test for relative jumps.
@@ -0,0 +1,160 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#pragma once
+
+#include <moveit/robot_state/robot_state.h>
+#include <eigen_stl_containers/eigen_stl_containers.h>
+#include <vector>
+
+namespace moveit
+{
+namespace core
+{
+MOVEIT_CLASS_FORWARD(GroupState);  // Defines GroupStatePtr, ConstPtr, WeakPtr... etc
+
+/** \brief A lightweight state that stores only the variables of one JointModelGroup.
+
+    Planners such as OMPL, CHOMP and Pilz only ever change the variables of the group they plan for, yet
+    a full RobotState carries all variables of the robot, all joint and link transforms and the collision
+    body transforms. Copying such a state for every sample is expensive. A GroupState holds the group's
+    variable values and shares one immutable background RobotState that provides the values of all other
+    variables. Forward kinematics are computed lazily and only for the links returned by
+    JointModelGroup::getUpdatedLinkModels(); the transforms of all other links are read from the background.
+
+    Copies share the background state and the precomputed link update order, so copying only duplicates
+    the group's values and, if already computed, the transforms of the updated links. */
+class GroupState
+{
+public:
+  /** \brief Construct a state for \e group, initialized from the group's values in \e background.
+      Throws moveit::Exception if \e group or \e background is null, if they belong to different robot models or
+      if the link transforms of \e background are not up to date. */
+  GroupState(const JointModelGroup* group, const RobotStateConstPtr& background);
+
+  const JointModelGroup* getJointModelGroup() const
+  {
+    return group_;
+  }
+
+  const RobotStateConstPtr& getBackground() const
+  {
+    return background_;
+  }
+
+  /** \brief Replace the background state. The group's values are kept, cached link transforms are discarded.
+      The same preconditions as for the constructor apply to \e background. */
+  void setBackground(const RobotStateConstPtr& background);
+
+  /** \brief The number of group variables, including mimic joints, i.e. JointModelGroup::getVariableCount() */
+  std::size_t getVariableCount() const
+  {
+    return positions_.size();
+  }
+
+  /** \brief The group's variable values, in the order of JointModelGroup::getVariableNames() */
+  const std::vector<double>& getPositions() const
+  {
+    return positions_;
+  }
+
+  double getPosition(std::size_t index) const
+  {
+    return positions_[index];
+  }
+
+  void setPosition(std::size_t index, double value)
+  {
+    positions_[index] = value;
+    dirty_ = true;
+  }
+
+  /** \brief Set all group variables from \e values, which must hold getVariableCount() entries */
+  void setPositions(const double* values);
+
+  void setPositions(const std::vector<double>& values)
+  {
+    assert(values.size() == positions_.size());
+    setPositions(values.data());
+  }
+
+  /** \brief Copy the group's values out of \e state */
+  void setFromRobotState(const RobotState& state);
+
+  /** \brief Write the group's values into \e state. The remaining variables of \e state are left untouched. */
+  void copyToRobotState(RobotState& state) const;
+
+  /** \brief Return a full RobotState: a copy of the background with the group's values applied */
+  RobotState toRobotState() const;
+
+  /** \brief Check whether the transform of \e link depends on the group's variables */
+  bool isLinkUpdated(const LinkModel* link) const;
+
+  /** \brief Compute the transforms of the links updated by the group, if the values changed since the last call */
+  void updateLinkTransforms();
+
+  /** \brief Get the transform of \e link w.r.t. the model frame, computing forward kinematics if needed */
+  const Eigen::Isometry3d& getGlobalLinkTransform(const LinkModel* link)
+  {
+    updateLinkTransforms();
+    return static_cast<const GroupState*>(this)->getGlobalLinkTransform(link);
+  }
+
+  /** \brief Get the transform of \e link w.r.t. the model frame. Requires up-to-date link transforms. */
+  const Eigen::Isometry3d& getGlobalLinkTransform(const LinkModel* link) const;
+
+  bool dirtyLinkTransforms() const
+  {
+    return dirty_;
+  }
+
+private:
+  struct Layout;
+  static std::shared_ptr<const Layout> buildLayout(const JointModelGroup* group);
+  void checkBackground(const RobotStateConstPtr& background) const;
+
+  const JointModelGroup* group_;
+  RobotStateConstPtr background_;
+
+  /** \brief The link update order and variable sources, shared by all copies of a state */
+  std::shared_ptr<const Layout> layout_;
+
+  std::vector<double> positions_;
+
+  /** \brief Transforms of the links in JointModelGroup::getUpdatedLinkModels(), allocated on first use */
+  EigenSTL::vector_Isometry3d link_transforms_;
+  bool dirty_;
+};
+}  // namespace core
+}  // namespace moveit
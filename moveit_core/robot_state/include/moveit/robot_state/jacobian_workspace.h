@@ -0,0 +1,165 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#pragma once
+
+#include <moveit/robot_state/robot_state.h>
+#include <moveit/robot_state/robot_state_batch.h>
+#include <Eigen/Core>
+#include <vector>
+
+namespace moveit
+{
+namespace core
+{
+MOVEIT_CLASS_FORWARD(JacobianWorkspace);  // Defines JacobianWorkspacePtr, ConstPtr, WeakPtr... etc
+
+/** \brief Precomputed data for repeatedly evaluating the Jacobians of one or more links of a chain group.
+
+    RobotState::getJacobian() validates its arguments, walks the chain and allocates its result on every call.
+    A JacobianWorkspace does the validation and the chain walk once, at construction, and stores the contributing
+    joints as a flat list. Evaluating the Jacobians for a state then only iterates that list and writes into
+    preallocated or caller-owned storage, so compute() does not allocate and is suitable for real-time loops.
+
+    The Jacobians of all links of a workspace are computed in one pass over the contributing joints; each joint's
+    axis is computed once and shared by all links below it. The result for link \e i occupies rows [6i, 6i+6) of
+    the output: linear velocity on top of angular velocity, expressed in the frame of the parent link of the group's
+    root joint, with one column per group variable, exactly as RobotState::getJacobian() computes it. */
+class JacobianWorkspace
+{
+public:
+  /** \brief Construct a workspace for the Jacobian of \e link at \e reference_point (w.r.t. \e link).
+      Throws moveit::Exception if \e group is not a chain or \e link is not updated by \e group. */
+  JacobianWorkspace(const JointModelGroup* group, const LinkModel* link,
+                    const Eigen::Vector3d& reference_point = Eigen::Vector3d::Zero());
+
+  /** \brief Construct a workspace for the Jacobians of several \e links of \e group, each at the corresponding
+      point of \e reference_points. \e reference_points may be empty, in which case the link origins are used.
+      Throws moveit::Exception if \e group is not a chain or one of \e links is not updated by \e group. */
+  JacobianWorkspace(const JointModelGroup* group, const std::vector<const LinkModel*>& links,
+                    const EigenSTL::vector_Vector3d& reference_points = EigenSTL::vector_Vector3d());
+
+  const JointModelGroup* getGroup() const
+  {
+    return group_;
+  }
+
+  const std::vector<const LinkModel*>& getLinks() const
+  {
+    return links_;
+  }
+
+  /** \brief Get the number of rows of the stacked Jacobians, 6 per link */
+  Eigen::Index rows() const
+  {
+    return 6 * static_cast<Eigen::Index>(links_.size());
+  }
+
+  /** \brief Get the number of columns of each Jacobian, the number of variables of the group */
+  Eigen::Index cols() const
+  {
+    return static_cast<Eigen::Index>(group_->getVariableCount());
+  }
+
+  const Eigen::Vector3d& getReferencePoint(std::size_t link_index = 0) const
+  {
+    return reference_points_[link_index];
+  }
+
+  /** \brief Change the reference point of link \e link_index. Does not allocate. */
+  void setReferencePoint(std::size_t link_index, const Eigen::Vector3d& reference_point)
+  {
+    reference_points_[link_index] = reference_point;
+  }
+
+  /** \brief Compute the Jacobians for \e state into the storage of this workspace and return them
+      (rows() x cols()). The link transforms of \e state need to be up to date. */
+  const Eigen::MatrixXd& compute(const RobotState& state);
+
+  /** \brief Compute the Jacobians for \e state into caller-owned storage of size rows() x cols(), e.g.
+      an Eigen::Matrix<double, 6, 7> for a single link of a 7 DOF arm. The link transforms of \e state need to be up
+      to date. */
+  void compute(const RobotState& state, Eigen::Ref<Eigen::MatrixXd> jacobians);
+
+  /** \brief Compute the Jacobians of all configurations in \e batch into caller-owned storage of size
+      rows() x (cols() * batch.size()). The Jacobians of configuration \e k occupy the columns
+      [k * cols(), (k + 1) * cols()). The link transforms of \e batch need to be up to date. */
+  void compute(const RobotStateBatch& batch, Eigen::Ref<Eigen::MatrixXd> jacobians);
+
+  /** \brief Get the Jacobian of link \e link_index computed by the last call to compute(const RobotState&) */
+  Eigen::Block<const Eigen::MatrixXd, 6, Eigen::Dynamic> getJacobian(std::size_t link_index = 0) const
+  {
+    return jacobians_.middleRows<6>(6 * link_index);
+  }
+
+private:
+  /** \brief A joint contributing to at least one of the Jacobians */
+  struct Column
+  {
+    JointModel::JointType type;
+
+    /** \brief The child link of the joint; its global transform is the joint frame */
+    const LinkModel* link;
+
+    /** \brief Group variable index of the (first) variable of the joint */
+    int column;
+
+    /** \brief Axis of revolute and prismatic joints, in the joint frame */
+    Eigen::Vector3d axis;
+
+    /** \brief Indices (into links_) of the links whose Jacobian this joint contributes to */
+    std::vector<std::size_t> targets;
+  };
+
+  /** \brief Fill \e jacobians, given the global transforms of one configuration through \e link_transform(link) */
+  template <typename LinkTransformFn>
+  void computeColumns(const LinkTransformFn& link_transform, Eigen::Ref<Eigen::MatrixXd> jacobians);
+
+  const JointModelGroup* group_;
+  std::vector<const LinkModel*> links_;
+  EigenSTL::vector_Vector3d reference_points_;
+
+  /** \brief The parent link of the group's root joint, nullptr for the model frame */
+  const LinkModel* root_link_;
+
+  std::vector<Column> columns_;
+
+  /** \brief Storage for compute(const RobotState&) */
+  Eigen::MatrixXd jacobians_;
+
+  /** \brief Scratch space for the reference points in the root link frame */
+  EigenSTL::vector_Vector3d points_;
+};
+}  // namespace core
+}  // namespace moveit
@@ -40,10 +40,12 @@
 #include <moveit/robot_model/robot_model.h>
 #include <moveit/robot_state/attached_body.h>
 #include <moveit/transforms/transforms.h>
+#include <moveit/utils/random_seed.h>
 #include <sensor_msgs/msg/joint_state.hpp>
 #include <visualization_msgs/msg/marker_array.hpp>
 #include <std_msgs/msg/color_rgba.hpp>
 #include <geometry_msgs/msg/twist.hpp>
+#include <array>
 #include <cassert>
 
 #include <rclcpp/duration.hpp>
@@ -59,7 +61,8 @@ namespace moveit
 {
 namespace core
 {
-MOVEIT_CLASS_FORWARD(RobotState);  // Defines RobotStatePtr, ConstPtr, WeakPtr... etc
+MOVEIT_CLASS_FORWARD(RobotState);      // Defines RobotStatePtr, ConstPtr, WeakPtr... etc
+MOVEIT_CLASS_FORWARD(RobotStatePool);  // Defines RobotStatePoolPtr, ConstPtr, WeakPtr... etc
 
 /** \brief Signature for functions that can verify that if the group \e joint_group in \e robot_state is set to \e
    joint_group_variable_values
@@ -92,9 +95,13 @@ public:
   /** \brief A state can be constructed from a specified robot model. No values are initialized.
       Call setToDefaultValues() if a state needs to provide valid information. */
   RobotState(const RobotModelConstPtr& robot_model);
+
+  /** \brief Construct a state for \e robot_model whose memory is taken from \e pool instead of the heap.
+      The pool needs to be constructed for the same robot model. Copies of this state use the same pool. */
+  RobotState(const RobotModelConstPtr& robot_model, const RobotStatePoolPtr& pool);
   ~RobotState();
 
-  /** \brief Copy constructor. */
+  /** \brief Copy constructor. The copy is allocated from the same pool as \e other, if any. */
   RobotState(const RobotState& other);
 
   /** \brief Copy operator */
@@ -106,6 +113,15 @@ public:
     return robot_model_;
   }
 
+  /** \brief Get the pool this state's memory is allocated from. Returns nullptr if allocated from the heap. */
+  const RobotStatePoolPtr& getPool() const
+  {
+    return pool_;
+  }
+
+  /** \brief Get the number of bytes of memory a state of \e robot_model allocates for its variables and transforms */
+  static std::size_t getMemorySize(const RobotModel& robot_model);
+
   /** \brief Get the number of variables that make up this state. */
   std::size_t getVariableCount() const
   {
@@ -1707,11 +1723,12 @@ public:
     static_cast<const RobotState*>(this)->computeAABB(aabb);
   }
 
-  /** \brief Return the instance of a random number generator */
+  /** \brief Return the instance of a random number generator, seeded reproducibly if moveit::core::setRandomSeed()
+   *  was called before its first use */
   random_numbers::RandomNumberGenerator& getRandomNumberGenerator()
   {
     if (!rng_)
-      rng_ = new random_numbers::RandomNumberGenerator();
+      rng_ = new random_numbers::RandomNumberGenerator(makeRandomNumberGenerator());
     return *rng_;
   }
 
@@ -1824,19 +1841,31 @@ private:
   void markDirtyJointTransforms(const JointModel* joint)
   {
     dirty_joint_transforms_[joint->getJointIndex()] = 1;
-    dirty_link_transforms_ =
-        dirty_link_transforms_ == nullptr ? joint : robot_model_->getCommonRoot(dirty_link_transforms_, joint);
+    markDirtyLinkTransforms(joint);
   }
 
   void markDirtyJointTransforms(const JointModelGroup* group)
   {
     for (const JointModel* jm : group->getActiveJointModels())
       dirty_joint_transforms_[jm->getJointIndex()] = 1;
-    dirty_link_transforms_ = dirty_link_transforms_ == nullptr ?
-                                 group->getCommonRoot() :
-                                 robot_model_->getCommonRoot(dirty_link_transforms_, group->getCommonRoot());
+    // mark the subtrees of the group individually: for a dual-arm group this avoids recomputing the torso
+    for (const JointModel* jm : group->getJointRoots())
+      markDirtyLinkTransforms(jm);
+  }
+
+  /** \brief Mark the link transforms of the subtree starting at \e joint as dirty */
+  void markDirtyLinkTransforms(const JointModel* joint);
+
+  /** \brief Mark the link transforms of the whole tree as dirty */
+  void markDirtyAllLinkTransforms()
+  {
+    dirty_link_transforms_ = robot_model_->getRootJoint();
+    dirty_link_transform_subtree_count_ = 0;
   }
 
+  /** \brief Mark the collision body transforms of the subtree starting at \e joint as dirty */
+  void markDirtyCollisionBodyTransforms(const JointModel* joint);
+
   void markVelocity();
   void markAcceleration();
   void markEffort();
@@ -1878,8 +1907,15 @@ private:
     markDirtyJointTransforms(group);
   }
 
+  /** \brief Update the link transforms of all links below \e start. Attached bodies are not updated. */
   void updateLinkTransformsInternal(const JointModel* start);
 
+  /** \brief Update the collision body transforms of all links below \e start */
+  void updateCollisionBodyTransformsInternal(const JointModel* start);
+
+  /** \brief Update the transforms of all attached bodies from their link's transform */
+  void updateAttachedBodyTransforms();
+
   void getMissingKeys(const std::map<std::string, double>& variable_map,
                       std::vector<std::string>& missing_variables) const;
   void getStateTreeJointString(std::ostream& ss, const JointModel* jm, const std::string& pfx0, bool last) const;
@@ -1894,6 +1930,7 @@ private:
   bool checkCollisionTransforms() const;
 
   RobotModelConstPtr robot_model_;
+  RobotStatePoolPtr pool_;
   void* memory_;
 
   double* position_;
@@ -1907,6 +1944,16 @@ private:
   const JointModel* dirty_link_transforms_;
   const JointModel* dirty_collision_body_transforms_;
 
+  /** \brief Maximum number of disjoint dirty subtrees tracked before falling back to their common root */
+  static constexpr std::size_t MAX_DIRTY_SUBTREES = 4;
+
+  // Roots of the disjoint subtrees below dirty_link_transforms_ (resp. dirty_collision_body_transforms_)
+  // that actually need an update. A count of zero means the whole subtree below the common root is dirty.
+  std::array<const JointModel*, MAX_DIRTY_SUBTREES> dirty_link_transform_subtrees_;
+  std::size_t dirty_link_transform_subtree_count_;
+  std::array<const JointModel*, MAX_DIRTY_SUBTREES> dirty_collision_body_transform_subtrees_;
+  std::size_t dirty_collision_body_transform_subtree_count_;
+
   // All the following transform variables point into aligned memory in memory_
   // They are updated lazily, based on the flags in dirty_joint_transforms_
   // resp. the pointers dirty_link_transforms_ and dirty_collision_body_transforms_
@@ -0,0 +1,163 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#pragma once
+
+#include <moveit/robot_model/robot_model.h>
+#include <moveit/robot_state/robot_state.h>
+#include <Eigen/StdVector>
+#include <vector>
+
+namespace moveit
+{
+namespace core
+{
+MOVEIT_CLASS_FORWARD(RobotStateBatch);  // Defines RobotStateBatchPtr, ConstPtr, WeakPtr... etc
+
+/** \brief A batch of robot configurations stored in structure-of-arrays layout.
+
+    Whereas a RobotState holds a single configuration and computes forward kinematics one link at a time
+    for that configuration, a RobotStateBatch holds \e N configurations and computes the global link
+    transforms of all of them in a single pass over the kinematic tree. For every variable, the \e N positions
+    are stored contiguously; for every link, each of the 12 non-trivial entries of its global transform
+    (9 rotation, 3 translation) is stored contiguously as well. This makes the inner loops over the batch
+    straight-line arithmetic on contiguous arrays, which the compiler vectorizes.
+
+    Only positions and link transforms are represented. Velocities, accelerations, efforts and attached
+    bodies are not part of a batch; use copyToRobotState() to obtain a full RobotState for a particular entry. */
+class RobotStateBatch
+{
+public:
+  /** \brief Construct a batch for \e robot_model holding \e size configurations.
+      Positions are not initialized. */
+  RobotStateBatch(const RobotModelConstPtr& robot_model, std::size_t size = 0);
+
+  /** \brief Get the robot model this batch is constructed for. */
+  const RobotModelConstPtr& getRobotModel() const
+  {
+    return robot_model_;
+  }
+
+  /** \brief Get the number of configurations in this batch. */
+  std::size_t size() const
+  {
+    return size_;
+  }
+
+  /** \brief Change the number of configurations in this batch. Existing positions are not preserved. */
+  void resize(std::size_t size);
+
+  /** \brief Get a pointer to the \e size() contiguous positions of variable \e variable_index.
+      If you change these values, call updateLinkTransforms() before querying transforms. */
+  double* getVariablePositions(std::size_t variable_index)
+  {
+    dirty_ = true;
+    return &positions_[variable_index * stride_];
+  }
+
+  /** \brief Get a pointer to the \e size() contiguous positions of variable \e variable_index. */
+  const double* getVariablePositions(std::size_t variable_index) const
+  {
+    return &positions_[variable_index * stride_];
+  }
+
+  /** \brief Set all variable positions of configuration \e index. \e positions is ordered as in the RobotModel. */
+  void setVariablePositions(std::size_t index, const double* positions);
+
+  /** \brief Copy all variable positions of configuration \e index into \e positions. */
+  void copyVariablePositions(std::size_t index, double* positions) const;
+
+  /** \brief Set the positions of \e group for configuration \e index. Mimic joints of the group are updated. */
+  void setJointGroupPositions(std::size_t index, const JointModelGroup* group, const double* gstate);
+
+  /** \brief Copy the variable positions of \e state into configuration \e index. */
+  void setFromRobotState(std::size_t index, const RobotState& state)
+  {
+    setVariablePositions(index, state.getVariablePositions());
+  }
+
+  /** \brief Copy the variable positions of configuration \e index into \e state. The transforms of
+      \e state are marked dirty and will be recomputed by \e state on demand. */
+  void copyToRobotState(std::size_t index, RobotState& state) const;
+
+  /** \brief Compute the global link transforms of all configurations in the batch. */
+  void updateLinkTransforms();
+
+  /** \brief Returns true if positions were modified since the last call to updateLinkTransforms() */
+  bool dirtyLinkTransforms() const
+  {
+    return dirty_;
+  }
+
+  /** \brief Get the transform of \e link w.r.t. the model frame for configuration \e index.
+      updateLinkTransforms() needs to be called first. */
+  Eigen::Isometry3d getGlobalLinkTransform(std::size_t index, const LinkModel* link) const;
+
+  /** \brief Get a pointer to the \e size() contiguous values of entry \e entry of the global transform of \e link.
+      Entries 0-8 are the rotation matrix in column-major order, entries 9-11 are the translation. */
+  const double* getGlobalLinkTransformEntry(const LinkModel* link, std::size_t entry) const
+  {
+    return &link_transforms_[(link->getLinkIndex() * TRANSFORM_ENTRIES + entry) * stride_];
+  }
+
+  /** \brief Number of values stored per link transform */
+  static constexpr std::size_t TRANSFORM_ENTRIES = 12;
+
+private:
+  /** \brief Compute the local transform (joint origin times joint transform) of \e link for all configurations
+      and store it in local_transform_ */
+  void computeLocalTransforms(const LinkModel* link);
+
+  RobotModelConstPtr robot_model_;
+  std::size_t size_;
+
+  /** \brief Distance between consecutive arrays; size_ rounded up so every array is aligned */
+  std::size_t stride_;
+
+  bool dirty_;
+
+  /** \brief Variable positions, one array of stride_ doubles per variable */
+  std::vector<double, Eigen::aligned_allocator<double>> positions_;
+
+  /** \brief Global link transforms, TRANSFORM_ENTRIES arrays of stride_ doubles per link */
+  std::vector<double, Eigen::aligned_allocator<double>> link_transforms_;
+
+  /** \brief Scratch space for one link's local transforms */
+  std::vector<double, Eigen::aligned_allocator<double>> local_transform_;
+
+  /** \brief Scratch space for non-specialized joint types */
+  Eigen::Isometry3d scratch_transform_;
+};
+}  // namespace core
+}  // namespace moveit
@@ -0,0 +1,115 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#pragma once
+
+#include <moveit/robot_model/robot_model.h>
+#include <moveit/robot_state/robot_state.h>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace moveit
+{
+namespace core
+{
+/** \brief A pool of memory blocks for RobotState instances of one RobotModel.
+
+    Every RobotState allocates a single block of memory holding its variables, transforms and dirty flags.
+    Code creating and destroying many states (trajectory copies, per-thread planner states, ...) can construct
+    them from a pool instead, so that blocks are recycled rather than returned to the heap. Blocks are carved
+    out of larger slabs and aligned to cache lines. States keep their pool alive, so a pool is destroyed only
+    after all states allocated from it. Memory is not returned to the heap before that.
+
+    All member functions are thread-safe. */
+class RobotStatePool
+{
+public:
+  /** \brief Construct a pool for states of \e robot_model. Memory is allocated in slabs of \e blocks_per_slab
+      states at a time. */
+  RobotStatePool(const RobotModelConstPtr& robot_model, std::size_t blocks_per_slab = 32);
+  ~RobotStatePool();
+
+  RobotStatePool(const RobotStatePool&) = delete;
+  RobotStatePool& operator=(const RobotStatePool&) = delete;
+
+  /** \brief Get the robot model this pool allocates states for */
+  const RobotModelConstPtr& getRobotModel() const
+  {
+    return robot_model_;
+  }
+
+  /** \brief Get the size in bytes of a single block */
+  std::size_t getBlockSize() const
+  {
+    return block_size_;
+  }
+
+  /** \brief Get a block of getBlockSize() bytes, allocating a new slab if no free block is available */
+  void* acquireBlock();
+
+  /** \brief Return a block previously obtained from acquireBlock() to the pool */
+  void releaseBlock(void* block);
+
+  /** \brief Get the total number of blocks allocated by this pool */
+  std::size_t getBlockCount() const;
+
+  /** \brief Get the number of blocks currently not in use */
+  std::size_t getFreeBlockCount() const;
+
+  /** \brief Alignment of blocks, chosen as a typical cache line size */
+  static constexpr std::size_t BLOCK_ALIGNMENT = 64;
+
+private:
+  struct SlabDeleter
+  {
+    void operator()(void* slab) const;
+  };
+
+  RobotModelConstPtr robot_model_;
+  std::size_t block_size_;
+  std::size_t blocks_per_slab_;
+
+  mutable std::mutex lock_;
+  std::vector<std::unique_ptr<void, SlabDeleter>> slabs_;
+  std::vector<void*> free_blocks_;
+};
+
+/** \brief Construct a new RobotState allocated from \e pool */
+inline RobotStatePtr makeRobotState(const RobotStatePoolPtr& pool)
+{
+  return std::make_shared<RobotState>(pool->getRobotModel(), pool);
+}
+}  // namespace core
+}  // namespace moveit
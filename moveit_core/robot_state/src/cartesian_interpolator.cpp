@@ -36,7 +36,9 @@
 
 /* Author: Ioan Sucan, Sachin Chitta, Acorn Pooley, Mario Prats, Dave Coleman */
 
+#include <atomic>
 #include <memory>
+#include <thread>
 #include <moveit/robot_state/cartesian_interpolator.h>
 #include <geometric_shapes/check_isometry.h>
 #include <rclcpp/logger.hpp>
@@ -54,6 +56,126 @@ static const std::size_t MIN_STEPS_FOR_JUMP_THRESH = 10;
 
 static const rclcpp::Logger LOGGER = rclcpp::get_logger("moveit_robot_state.cartesian_interpolator");
 
+namespace
+{
+// Number of steps of at most max_step needed to move between two poses
+std::size_t countSteps(const Eigen::Isometry3d& from, const Eigen::Isometry3d& to, const MaxEEFStep& max_step)
+{
+  double rotation_distance = Eigen::Quaterniond(from.linear()).angularDistance(Eigen::Quaterniond(to.linear()));
+  double translation_distance = (to.translation() - from.translation()).norm();
+
+  std::size_t translation_steps = 0;
+  if (max_step.translation > 0.0)
+    translation_steps = floor(translation_distance / max_step.translation);
+
+  std::size_t rotation_steps = 0;
+  if (max_step.rotation > 0.0)
+    rotation_steps = floor(rotation_distance / max_step.rotation);
+
+  return std::max(translation_steps, rotation_steps) + 1;
+}
+
+// To limit absolute joint-space jumps, we pass consistency limits to the IK solver
+std::vector<double> computeConsistencyLimits(const JointModelGroup* group, const JumpThreshold& jump_threshold)
+{
+  std::vector<double> consistency_limits;
+  if (jump_threshold.prismatic > 0 || jump_threshold.revolute > 0)
+    for (const JointModel* jm : group->getActiveJointModels())
+    {
+      double limit;
+      switch (jm->getType())
+      {
+        case JointModel::REVOLUTE:
+          limit = jump_threshold.revolute;
+          break;
+        case JointModel::PRISMATIC:
+          limit = jump_threshold.prismatic;
+          break;
+        default:
+          limit = 0.0;
+      }
+      if (limit == 0.0)
+        limit = jm->getMaximumExtent();
+      consistency_limits.push_back(limit);
+    }
+  return consistency_limits;
+}
+
+Eigen::Isometry3d interpolatePose(const Eigen::Isometry3d& from, const Eigen::Isometry3d& to, double t)
+{
+  Eigen::Isometry3d pose(Eigen::Quaterniond(from.linear()).slerp(t, Eigen::Quaterniond(to.linear())));
+  pose.translation() = t * to.translation() + (1 - t) * from.translation();
+  return pose;
+}
+
+// A solved point of a piecewise linear Cartesian path
+struct PathPoint
+{
+  double param;  // index of the path segment plus the fraction along that segment
+  Eigen::Isometry3d pose;
+  RobotStatePtr state;
+};
+
+// Adaptively bisects the interval between two solved points of the same path segment
+class IntervalRefiner
+{
+public:
+  IntervalRefiner(const JointModelGroup* group, const LinkModel* link, const MaxEEFStep& max_step,
+                  const AdaptiveRefinement& refinement, const std::vector<double>& consistency_limits,
+                  const GroupStateValidityCallbackFn& validCallback, const kinematics::KinematicsQueryOptions& options,
+                  const kinematics::KinematicsBase::IKCostFn& cost_function)
+    : group_(group)
+    , link_(link)
+    , max_step_(max_step)
+    , refinement_(refinement)
+    , consistency_limits_(consistency_limits)
+    , valid_callback_(validCallback)
+    , options_(options)
+    , cost_function_(cost_function)
+  {
+  }
+
+  // Append the points needed between a and b to out, in order. Returns false if IK failed; out then ends with the
+  // last point that could be solved.
+  bool refine(const PathPoint& a, const PathPoint& b, std::vector<PathPoint>& out, RobotState& work) const
+  {
+    if (countSteps(a.pose, b.pose, max_step_) <= 1)
+      return true;
+
+    // check whether moving linearly in joint space follows the path
+    a.state->interpolate(*b.state, 0.5, work, group_);
+    work.updateLinkTransforms();
+    const Eigen::Isometry3d pose = interpolatePose(a.pose, b.pose, 0.5);
+    const Eigen::Isometry3d& interpolated = work.getGlobalLinkTransform(link_);
+    if ((interpolated.translation() - pose.translation()).norm() <= refinement_.translation_tolerance &&
+        Eigen::Quaterniond(interpolated.linear()).angularDistance(Eigen::Quaterniond(pose.linear())) <=
+            refinement_.rotation_tolerance &&
+        (refinement_.max_joint_step <= 0.0 || a.state->distance(*b.state, group_) <= refinement_.max_joint_step))
+      return true;
+
+    // the interpolated state is the seed for the midpoint
+    if (!work.setFromIK(group_, pose, link_->getName(), consistency_limits_, 0.0, valid_callback_, options_,
+                        cost_function_))
+      return false;
+    PathPoint mid{ 0.5 * (a.param + b.param), pose, std::make_shared<RobotState>(work) };
+    if (!refine(a, mid, out, work))
+      return false;
+    out.push_back(mid);
+    return refine(mid, b, out, work);
+  }
+
+private:
+  const JointModelGroup* group_;
+  const LinkModel* link_;
+  const MaxEEFStep& max_step_;
+  const AdaptiveRefinement& refinement_;
+  const std::vector<double>& consistency_limits_;
+  const GroupStateValidityCallbackFn& valid_callback_;
+  const kinematics::KinematicsQueryOptions& options_;
+  const kinematics::KinematicsBase::IKCostFn& cost_function_;
+};
+}  // namespace
+
 CartesianInterpolator::Distance CartesianInterpolator::computeCartesianPath(
     RobotState* start_state, const JointModelGroup* group, std::vector<RobotStatePtr>& traj, const LinkModel* link,
     const Eigen::Vector3d& direction, bool global_reference_frame, double distance, const MaxEEFStep& max_step,
@@ -108,44 +230,14 @@ CartesianInterpolator::Percentage CartesianInterpolator::computeCartesianPath(
     return 0.0;
   }
 
-  double rotation_distance = start_quaternion.angularDistance(target_quaternion);
-  double translation_distance = (rotated_target.translation() - start_pose.translation()).norm();
-
   // decide how many steps we will need for this trajectory
-  std::size_t translation_steps = 0;
-  if (max_step.translation > 0.0)
-    translation_steps = floor(translation_distance / max_step.translation);
-
-  std::size_t rotation_steps = 0;
-  if (max_step.rotation > 0.0)
-    rotation_steps = floor(rotation_distance / max_step.rotation);
-
   // If we are testing for relative jumps, we always want at least MIN_STEPS_FOR_JUMP_THRESH steps
-  std::size_t steps = std::max(translation_steps, rotation_steps) + 1;
+  std::size_t steps = countSteps(start_pose, rotated_target, max_step);
   if (jump_threshold.factor > 0 && steps < MIN_STEPS_FOR_JUMP_THRESH)
     steps = MIN_STEPS_FOR_JUMP_THRESH;
 
   // To limit absolute joint-space jumps, we pass consistency limits to the IK solver
-  std::vector<double> consistency_limits;
-  if (jump_threshold.prismatic > 0 || jump_threshold.revolute > 0)
-    for (const JointModel* jm : group->getActiveJointModels())
-    {
-      double limit;
-      switch (jm->getType())
-      {
-        case JointModel::REVOLUTE:
-          limit = jump_threshold.revolute;
-          break;
-        case JointModel::PRISMATIC:
-          limit = jump_threshold.prismatic;
-          break;
-        default:
-          limit = 0.0;
-      }
-      if (limit == 0.0)
-        limit = jm->getMaximumExtent();
-      consistency_limits.push_back(limit);
-    }
+  const std::vector<double> consistency_limits = computeConsistencyLimits(group, jump_threshold);
 
   traj.clear();
   traj.push_back(std::make_shared<moveit::core::RobotState>(*start_state));
@@ -213,6 +305,133 @@ CartesianInterpolator::Percentage CartesianInterpolator::computeCartesianPath(
   return CartesianInterpolator::Percentage(percentage_solved);
 }
 
+CartesianInterpolator::Percentage CartesianInterpolator::computeCartesianPathParallel(
+    RobotState* start_state, const JointModelGroup* group, std::vector<RobotStatePtr>& traj, const LinkModel* link,
+    const EigenSTL::vector_Isometry3d& waypoints, bool global_reference_frame, const MaxEEFStep& max_step,
+    const JumpThreshold& jump_threshold, const AdaptiveRefinement& refinement,
+    const GroupStateValidityCallbackFn& validCallback, const kinematics::KinematicsQueryOptions& options,
+    kinematics::KinematicsBase::IKCostFn cost_function)
+{
+  if (max_step.translation <= 0.0 && max_step.rotation <= 0.0)
+  {
+    RCLCPP_ERROR(LOGGER, "Invalid MaxEEFStep passed into computeCartesianPathParallel. Both the MaxEEFStep.rotation "
+                         "and MaxEEFStep.translation components must be non-negative and at least one component must "
+                         "be greater than zero");
+    return 0.0;
+  }
+
+  // make sure that continuous joints wrap
+  for (const JointModel* joint : group->getContinuousJointModels())
+    start_state->enforceBounds(joint);
+
+  traj.clear();
+  traj.push_back(std::make_shared<moveit::core::RobotState>(*start_state));
+  if (waypoints.empty())
+    return 0.0;
+
+  // resolve the waypoints into poses in the global reference frame
+  EigenSTL::vector_Isometry3d poses;
+  poses.reserve(waypoints.size() + 1);
+  poses.push_back(start_state->getGlobalLinkTransform(link));
+  for (const Eigen::Isometry3d& waypoint : waypoints)
+  {
+    ASSERT_ISOMETRY(waypoint)  // unsanitized input, could contain a non-isometry
+    poses.push_back(global_reference_frame ? waypoint : poses.back() * waypoint);
+  }
+
+  const std::vector<double> consistency_limits = computeConsistencyLimits(group, jump_threshold);
+  const std::size_t factor = std::max<std::size_t>(refinement.coarse_step_factor, 1);
+  std::vector<double> coarse_consistency_limits = consistency_limits;
+  for (double& limit : coarse_consistency_limits)
+    limit *= factor;
+
+  // Solve the coarse points sequentially, each seeded with the solution of its predecessor.
+  // If IK fails, continue at the regular resolution from the last coarse point to find the end of the path.
+  std::vector<PathPoint> coarse = { { 0.0, poses[0], traj.back() } };
+  std::vector<PathPoint> tail;
+  bool coarse_failed = false;
+  for (std::size_t segment = 0; segment < waypoints.size() && !coarse_failed; ++segment)
+  {
+    const std::size_t steps = countSteps(poses[segment], poses[segment + 1], max_step);
+    const std::size_t coarse_steps = (steps + factor - 1) / factor;
+    for (std::size_t i = 1; i <= coarse_steps; ++i)
+    {
+      const double t = (double)i / (double)coarse_steps;
+      const Eigen::Isometry3d pose = interpolatePose(poses[segment], poses[segment + 1], t);
+      if (start_state->setFromIK(group, pose, link->getName(), coarse_consistency_limits, 0.0, validCallback, options,
+                                 cost_function))
+      {
+        coarse.push_back({ segment + t, pose, std::make_shared<moveit::core::RobotState>(*start_state) });
+        continue;
+      }
+
+      coarse_failed = true;
+      *start_state = *coarse.back().state;
+      for (std::size_t j = std::floor((coarse.back().param - segment) * steps + 1e-9) + 1; j <= steps; ++j)
+      {
+        const double fine_t = (double)j / (double)steps;
+        const Eigen::Isometry3d fine_pose = interpolatePose(poses[segment], poses[segment + 1], fine_t);
+        if (!start_state->setFromIK(group, fine_pose, link->getName(), consistency_limits, 0.0, validCallback, options,
+                                    cost_function))
+          break;
+        tail.push_back({ segment + fine_t, fine_pose, std::make_shared<moveit::core::RobotState>(*start_state) });
+      }
+      break;
+    }
+  }
+
+  // refine the intervals between coarse points in parallel
+  const std::size_t intervals = coarse.size() - 1;
+  std::vector<std::vector<PathPoint>> refined(intervals);
+  std::vector<char> refined_ok(intervals, 0);
+  const IntervalRefiner refiner(group, link, max_step, refinement, consistency_limits, validCallback, options,
+                                cost_function);
+  std::atomic<std::size_t> next_interval(0);
+  const auto worker = [&] {
+    RobotState work(*start_state);
+    for (std::size_t k = next_interval++; k < intervals; k = next_interval++)
+      refined_ok[k] = refiner.refine(coarse[k], coarse[k + 1], refined[k], work);
+  };
+  std::size_t thread_count = refinement.thread_count ? refinement.thread_count : std::thread::hardware_concurrency();
+  thread_count = std::min(std::max<std::size_t>(thread_count, 1), std::max<std::size_t>(intervals, 1));
+  std::vector<std::thread> threads;
+  for (std::size_t i = 1; i < thread_count; ++i)
+    threads.emplace_back(worker);
+  worker();
+  for (std::thread& thread : threads)
+    thread.join();
+
+  // assemble the trajectory up to the first failure
+  double last_valid_param = 0.0;
+  bool complete = true;
+  for (std::size_t k = 0; k < intervals && complete; ++k)
+  {
+    for (const PathPoint& point : refined[k])
+    {
+      traj.push_back(point.state);
+      last_valid_param = point.param;
+    }
+    complete = refined_ok[k];
+    if (complete)
+    {
+      traj.push_back(coarse[k + 1].state);
+      last_valid_param = coarse[k + 1].param;
+    }
+  }
+  if (complete)
+    for (const PathPoint& point : tail)
+    {
+      traj.push_back(point.state);
+      last_valid_param = point.param;
+    }
+
+  *start_state = *traj.back();
+  double percentage_solved = last_valid_param / (double)waypoints.size();
+  percentage_solved *= checkJointSpaceJump(group, traj, jump_threshold);
+
+  return CartesianInterpolator::Percentage(percentage_solved);
+}
+
 CartesianInterpolator::Percentage CartesianInterpolator::checkJointSpaceJump(const JointModelGroup* group,
                                                                              std::vector<RobotStatePtr>& traj,
                                                                              const JumpThreshold& jump_threshold)
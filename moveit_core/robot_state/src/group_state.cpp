@@ -0,0 +1,216 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/robot_state/group_state.h>
+#include <moveit/exceptions/exceptions.h>
+#include <algorithm>
+#include <array>
+
+namespace moveit
+{
+namespace core
+{
+struct GroupState::Layout
+{
+  /** \brief Where a joint variable takes its value from: the group values if group_index >= 0, otherwise the
+      background state. Mimic joints use the scaled value of their source variable. */
+  struct VariableSource
+  {
+    int group_index;
+    int state_index;
+    double factor;
+    double offset;
+  };
+
+  struct LinkUpdate
+  {
+    const LinkModel* link;
+    /** \brief The slot of the parent link in link_transforms_, or -1 if the parent is not updated by the group */
+    int parent_slot;
+    std::size_t first_source;
+    std::size_t source_count;
+  };
+
+  /** \brief The updated links, parents before children */
+  std::vector<LinkUpdate> links;
+  std::vector<VariableSource> sources;
+  /** \brief For each link of the model, its slot in link_transforms_ or -1 */
+  std::vector<int> link_slot;
+};
+
+std::shared_ptr<const GroupState::Layout> GroupState::buildLayout(const JointModelGroup* group)
+{
+  auto layout = std::make_shared<Layout>();
+  layout->link_slot.assign(group->getParentModel().getLinkModelCount(), -1);
+
+  auto add_source = [&](const JointModel* joint, std::size_t variable, double factor, double offset) {
+    const std::string& name = joint->getVariableNames()[variable];
+    int group_index = group->hasJointModel(joint->getName()) ? group->getVariableGroupIndex(name) : -1;
+    layout->sources.push_back({ group_index, static_cast<int>(joint->getFirstVariableIndex() + variable), factor,
+                                offset });
+  };
+
+  // getUpdatedLinkModels() is sorted by link index, which lists parents before their children
+  for (const LinkModel* link : group->getUpdatedLinkModels())
+  {
+    Layout::LinkUpdate update;
+    update.link = link;
+    const LinkModel* parent = link->getParentLinkModel();
+    update.parent_slot = parent ? layout->link_slot[parent->getLinkIndex()] : -1;
+    update.first_source = layout->sources.size();
+
+    const JointModel* joint = link->getParentJointModel();
+    if (!link->parentJointIsFixed())
+    {
+      const JointModel* source = joint->getMimic() ? joint->getMimic() : joint;
+      double factor = joint->getMimic() ? joint->getMimicFactor() : 1.0;
+      double offset = joint->getMimic() ? joint->getMimicOffset() : 0.0;
+      for (std::size_t i = 0; i < joint->getVariableCount(); ++i)
+        add_source(source, i, factor, offset);
+    }
+    update.source_count = layout->sources.size() - update.first_source;
+
+    layout->link_slot[link->getLinkIndex()] = static_cast<int>(layout->links.size());
+    layout->links.push_back(update);
+  }
+  return layout;
+}
+
+GroupState::GroupState(const JointModelGroup* group, const RobotStateConstPtr& background)
+  : group_(group), background_(background), dirty_(true)
+{
+  if (!group_)
+    throw Exception("GroupState requires a joint model group");
+  checkBackground(background_);
+  layout_ = buildLayout(group_);
+  positions_.resize(group_->getVariableCount());
+  background_->copyJointGroupPositions(group_, positions_.data());
+}
+
+void GroupState::checkBackground(const RobotStateConstPtr& background) const
+{
+  if (!background)
+    throw Exception("GroupState requires a background state");
+  if (background->getRobotModel().get() != &group_->getParentModel())
+    throw Exception("The background state of a GroupState must belong to the model of group '" + group_->getName() +
+                    "'");
+  if (background->dirtyLinkTransforms())
+    throw Exception("The background state of a GroupState must have up-to-date link transforms");
+}
+
+void GroupState::setBackground(const RobotStateConstPtr& background)
+{
+  checkBackground(background);
+  background_ = background;
+  dirty_ = true;
+}
+
+void GroupState::setPositions(const double* values)
+{
+  std::copy(values, values + positions_.size(), positions_.begin());
+  dirty_ = true;
+}
+
+void GroupState::setFromRobotState(const RobotState& state)
+{
+  state.copyJointGroupPositions(group_, positions_.data());
+  dirty_ = true;
+}
+
+void GroupState::copyToRobotState(RobotState& state) const
+{
+  state.setJointGroupPositions(group_, positions_.data());
+}
+
+RobotState GroupState::toRobotState() const
+{
+  RobotState state(*background_);
+  copyToRobotState(state);
+  return state;
+}
+
+bool GroupState::isLinkUpdated(const LinkModel* link) const
+{
+  return layout_->link_slot[link->getLinkIndex()] >= 0;
+}
+
+void GroupState::updateLinkTransforms()
+{
+  if (!dirty_)
+    return;
+  link_transforms_.resize(layout_->links.size());
+
+  std::array<double, 7> values;  // the largest joint, a floating joint, has 7 variables
+  Eigen::Isometry3d joint_transform;
+  for (std::size_t slot = 0; slot < layout_->links.size(); ++slot)
+  {
+    const Layout::LinkUpdate& update = layout_->links[slot];
+    const LinkModel* link = update.link;
+    const LinkModel* parent = link->getParentLinkModel();
+
+    Eigen::Isometry3d& transform = link_transforms_[slot];
+    if (update.parent_slot >= 0)
+      transform = link_transforms_[update.parent_slot] * link->getJointOriginTransform();
+    else if (parent)
+      transform = background_->getGlobalLinkTransform(parent) * link->getJointOriginTransform();
+    else
+      transform = link->getJointOriginTransform();
+
+    if (update.source_count > 0)
+    {
+      assert(update.source_count <= values.size());
+      for (std::size_t i = 0; i < update.source_count; ++i)
+      {
+        const Layout::VariableSource& source = layout_->sources[update.first_source + i];
+        double value = source.group_index >= 0 ? positions_[source.group_index] :
+                                                 background_->getVariablePosition(source.state_index);
+        values[i] = source.factor * value + source.offset;
+      }
+      link->getParentJointModel()->computeTransform(values.data(), joint_transform);
+      transform = transform * joint_transform;
+    }
+  }
+  dirty_ = false;
+}
+
+const Eigen::Isometry3d& GroupState::getGlobalLinkTransform(const LinkModel* link) const
+{
+  int slot = layout_->link_slot[link->getLinkIndex()];
+  if (slot < 0)
+    return background_->getGlobalLinkTransform(link);
+  assert(!dirty_);
+  return link_transforms_[slot];
+}
+}  // namespace core
+}  // namespace moveit
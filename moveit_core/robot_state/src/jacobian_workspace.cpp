@@ -0,0 +1,178 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/robot_state/jacobian_workspace.h>
+#include <moveit/exceptions/exceptions.h>
+#include <algorithm>
+
+namespace moveit
+{
+namespace core
+{
+JacobianWorkspace::JacobianWorkspace(const JointModelGroup* group, const LinkModel* link,
+                                     const Eigen::Vector3d& reference_point)
+  : JacobianWorkspace(group, std::vector<const LinkModel*>{ link }, EigenSTL::vector_Vector3d{ reference_point })
+{
+}
+
+JacobianWorkspace::JacobianWorkspace(const JointModelGroup* group, const std::vector<const LinkModel*>& links,
+                                     const EigenSTL::vector_Vector3d& reference_points)
+  : group_(group), links_(links), reference_points_(reference_points), root_link_(nullptr)
+{
+  if (!group_->isChain())
+    throw Exception("The group '" + group_->getName() + "' is not a chain. Cannot compute Jacobian.");
+  if (reference_points_.empty())
+    reference_points_.resize(links_.size(), Eigen::Vector3d::Zero());
+  else if (reference_points_.size() != links_.size())
+    throw Exception("Expected one reference point per link for the Jacobians of group '" + group_->getName() + "'");
+
+  const JointModel* root_joint_model = group_->getJointModels()[0];
+  root_link_ = root_joint_model->getParentLinkModel();
+
+  // walk the chain from every link towards the root, just like RobotState::getJacobian() does
+  for (std::size_t target = 0; target < links_.size(); ++target)
+  {
+    if (!group_->isLinkUpdated(links_[target]->getName()))
+      throw Exception("Link name '" + links_[target]->getName() + "' does not exist in the chain '" +
+                      group_->getName() + "' or is not a child for this chain");
+
+    const LinkModel* link = links_[target];
+    while (link)
+    {
+      const JointModel* pjm = link->getParentJointModel();
+      if (pjm->getVariableCount() > 0)
+      {
+        if (!group_->hasJointModel(pjm->getName()))
+        {
+          link = pjm->getParentLinkModel();
+          continue;
+        }
+        auto column = std::find_if(columns_.begin(), columns_.end(),
+                                   [link](const Column& column) { return column.link == link; });
+        if (column == columns_.end())
+        {
+          Column c;
+          c.type = pjm->getType();
+          c.link = link;
+          c.column = group_->getVariableGroupIndex(pjm->getName());
+          if (c.type == JointModel::REVOLUTE)
+            c.axis = static_cast<const RevoluteJointModel*>(pjm)->getAxis();
+          else if (c.type == JointModel::PRISMATIC)
+            c.axis = static_cast<const PrismaticJointModel*>(pjm)->getAxis();
+          else if (c.type == JointModel::PLANAR)
+            c.axis = Eigen::Vector3d::Zero();
+          else
+            throw Exception("Unknown type of joint '" + pjm->getName() + "' in Jacobian computation");
+          column = columns_.insert(columns_.end(), c);
+        }
+        column->targets.push_back(target);
+      }
+      if (pjm == root_joint_model)
+        break;
+      link = pjm->getParentLinkModel();
+    }
+  }
+
+  jacobians_.resize(rows(), cols());
+  points_.resize(links_.size());
+}
+
+template <typename LinkTransformFn>
+void JacobianWorkspace::computeColumns(const LinkTransformFn& link_transform, Eigen::Ref<Eigen::MatrixXd> jacobians)
+{
+  jacobians.setZero();
+  const Eigen::Isometry3d reference =
+      root_link_ ? Eigen::Isometry3d(link_transform(root_link_).inverse()) : Eigen::Isometry3d::Identity();
+  for (std::size_t target = 0; target < links_.size(); ++target)
+    points_[target] = reference * (link_transform(links_[target]) * reference_points_[target]);
+
+  for (const Column& c : columns_)
+  {
+    const Eigen::Isometry3d joint_transform = reference * link_transform(c.link);
+    if (c.type == JointModel::REVOLUTE)
+    {
+      const Eigen::Vector3d joint_axis = joint_transform.linear() * c.axis;
+      for (std::size_t target : c.targets)
+      {
+        jacobians.block<3, 1>(6 * target, c.column) +=
+            joint_axis.cross(points_[target] - joint_transform.translation());
+        jacobians.block<3, 1>(6 * target + 3, c.column) += joint_axis;
+      }
+    }
+    else if (c.type == JointModel::PRISMATIC)
+    {
+      const Eigen::Vector3d joint_axis = joint_transform.linear() * c.axis;
+      for (std::size_t target : c.targets)
+        jacobians.block<3, 1>(6 * target, c.column) += joint_axis;
+    }
+    else  // PLANAR, computed as in RobotState::getJacobian()
+    {
+      const Eigen::Vector3d x_axis = joint_transform * Eigen::Vector3d(1.0, 0.0, 0.0);
+      const Eigen::Vector3d y_axis = joint_transform * Eigen::Vector3d(0.0, 1.0, 0.0);
+      const Eigen::Vector3d z_axis = joint_transform * Eigen::Vector3d(0.0, 0.0, 1.0);
+      for (std::size_t target : c.targets)
+      {
+        jacobians.block<3, 1>(6 * target, c.column) += x_axis;
+        jacobians.block<3, 1>(6 * target, c.column + 1) += y_axis;
+        jacobians.block<3, 1>(6 * target, c.column + 2) +=
+            z_axis.cross(points_[target] - joint_transform.translation());
+        jacobians.block<3, 1>(6 * target + 3, c.column + 2) += z_axis;
+      }
+    }
+  }
+}
+
+const Eigen::MatrixXd& JacobianWorkspace::compute(const RobotState& state)
+{
+  compute(state, jacobians_);
+  return jacobians_;
+}
+
+void JacobianWorkspace::compute(const RobotState& state, Eigen::Ref<Eigen::MatrixXd> jacobians)
+{
+  assert(jacobians.rows() == rows() && jacobians.cols() == cols());
+  computeColumns(
+      [&state](const LinkModel* link) -> const Eigen::Isometry3d& { return state.getGlobalLinkTransform(link); },
+      jacobians);
+}
+
+void JacobianWorkspace::compute(const RobotStateBatch& batch, Eigen::Ref<Eigen::MatrixXd> jacobians)
+{
+  assert(jacobians.rows() == rows() && jacobians.cols() == cols() * static_cast<Eigen::Index>(batch.size()));
+  for (std::size_t index = 0; index < batch.size(); ++index)
+    computeColumns([&batch, index](const LinkModel* link) { return batch.getGlobalLinkTransform(index, link); },
+                   jacobians.middleCols(index * cols(), cols()));
+}
+}  // namespace core
+}  // namespace moveit
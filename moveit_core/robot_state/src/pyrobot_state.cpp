@@ -37,6 +37,7 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/numpy.h>
 #include <pybind11/stl.h>
+#include <moveit/python/pybind_batch.h>
 #include <moveit/python/pybind_rosmsg_typecasters.h>
 
 #include <moveit/robot_state/robot_state.h>
@@ -45,6 +46,36 @@
 namespace py = pybind11;
 using namespace robot_state;
 
+namespace
+{
+using InputArray = py::array_t<double, py::array::c_style | py::array::forcecast>;
+using RowMajorMatrix4d = Eigen::Matrix<double, 4, 4, Eigen::RowMajor>;
+
+/** A read-only NumPy view of \e data that keeps \e owner alive */
+py::array readOnlyView(const double* data, const std::vector<py::ssize_t>& shape,
+                       const std::vector<py::ssize_t>& strides, const py::handle& owner)
+{
+  py::array view(py::dtype::of<double>(), shape, strides, data, owner);
+  view.attr("setflags")(py::arg("write") = false);
+  return view;
+}
+
+const JointModelGroup* getGroupOrThrow(const RobotState& state, const std::string& group)
+{
+  const JointModelGroup* jmg = state.getRobotModel()->getJointModelGroup(group);
+  if (!jmg)
+    throw std::invalid_argument("Unknown joint model group '" + group + "'");
+  return jmg;
+}
+
+void setVariablesFromArray(RobotState& state, const InputArray& values, void (RobotState::*set)(const double*))
+{
+  if (values.ndim() != 1 || static_cast<std::size_t>(values.shape(0)) != state.getVariableCount())
+    throw std::invalid_argument("expected an array of " + std::to_string(state.getVariableCount()) + " values");
+  (state.*set)(values.data());
+}
+}  // namespace
+
 void def_robot_state_bindings(py::module& m)
 {
   m.doc() = "Representation of a robot's state. This includes position, velocity, acceleration and effort.";
@@ -60,6 +91,44 @@ void def_robot_state_bindings(py::module& m)
            py::return_value_policy::reference)
       .def("getVariableCount", &RobotState::getVariableCount)
       .def("hasVelocities", &RobotState::hasVelocities)
+      // Views share the memory of the state: they are read-only, because writing through them would bypass the
+      // dirty flags, and they follow later changes. Assigning an array copies it into the state.
+      .def_property(
+          "positions",
+          [](const py::object& self) {
+            const RobotState& s = self.cast<const RobotState&>();
+            return readOnlyView(s.getVariablePositions(), { py::ssize_t(s.getVariableCount()) },
+                                { py::ssize_t(sizeof(double)) }, self);
+          },
+          [](RobotState& s, const InputArray& positions) {
+            setVariablesFromArray(s, positions, &RobotState::setVariablePositions);
+          },
+          "View of the positions of all variables (read-only); assign an array to set them")
+      .def_property(
+          "velocities",
+          [](const py::object& self) -> py::object {
+            const RobotState& s = self.cast<const RobotState&>();
+            if (!s.hasVelocities())
+              return py::none();
+            return readOnlyView(s.getVariableVelocities(), { py::ssize_t(s.getVariableCount()) },
+                                { py::ssize_t(sizeof(double)) }, self);
+          },
+          [](RobotState& s, const InputArray& velocities) {
+            setVariablesFromArray(s, velocities, &RobotState::setVariableVelocities);
+          },
+          "View of the velocities of all variables (read-only), None if the state has no velocities")
+      .def(
+          "getGlobalLinkTransform",
+          [](const py::object& self, const std::string& link_name) {
+            RobotState& s = self.cast<RobotState&>();
+            if (!s.getRobotModel()->hasLinkModel(link_name))
+              throw std::invalid_argument("Unknown link '" + link_name + "'");
+            // the non-const overload brings the transforms up to date first; Eigen stores them column-major
+            const Eigen::Isometry3d& transform = s.getGlobalLinkTransform(link_name);
+            return readOnlyView(transform.data(), { 4, 4 },
+                                { py::ssize_t(sizeof(double)), py::ssize_t(4 * sizeof(double)) }, self);
+          },
+          py::arg("link_name"), "View of the 4x4 transform of a link in the model frame")
       .def("setJointGroupPositions",
            py::overload_cast<const std::string&, const std::vector<double>&>(&RobotState::setJointGroupPositions))
       .def("setJointGroupPositions",
@@ -89,6 +158,78 @@ void def_robot_state_bindings(py::module& m)
       //
       ;
 
+  m.def(
+      "computeForwardKinematics",
+      [](const RobotState& state, const InputArray& positions, const std::vector<std::string>& link_names,
+         const std::string& group, std::size_t threads) {
+        const JointModelGroup* jmg = group.empty() ? nullptr : getGroupOrThrow(state, group);
+        const std::size_t columns = jmg ? jmg->getVariableCount() : state.getVariableCount();
+        const std::size_t count = moveit::python::checkBatchShape(positions, columns, "positions");
+
+        std::vector<const LinkModel*> links;
+        for (const std::string& link_name : link_names)
+        {
+          if (!state.getRobotModel()->hasLinkModel(link_name))
+            throw std::invalid_argument("Unknown link '" + link_name + "'");
+          links.push_back(state.getRobotModel()->getLinkModel(link_name));
+        }
+
+        py::array_t<double> transforms({ count, links.size(), std::size_t(4), std::size_t(4) });
+        const double* in = positions.data();
+        double* out = transforms.mutable_data();
+        std::vector<RobotState> scratch(moveit::python::batchThreadCount(count, threads), state);
+        moveit::python::runBatch(count, threads, [&](std::size_t thread, std::size_t i) {
+          RobotState& s = scratch[thread];
+          if (jmg)
+            s.setJointGroupPositions(jmg, in + i * columns);
+          else
+            s.setVariablePositions(in + i * columns);
+          s.updateLinkTransforms();
+          double* row = out + i * links.size() * 16;
+          for (std::size_t l = 0; l < links.size(); ++l)
+            Eigen::Map<RowMajorMatrix4d>(row + l * 16) = s.getGlobalLinkTransform(links[l]).matrix();
+        });
+        return transforms;
+      },
+      py::arg("state"), py::arg("positions"), py::arg("link_names"), py::arg("group") = "", py::arg("threads") = 0,
+      "Transforms of the given links, shape (N, links, 4, 4), for each row of an (N, variables) array of positions. "
+      "The rows hold the variables of the group if one is given, of the whole state otherwise; all other variables "
+      "are taken from the state. Runs without the GIL on the given number of threads (0: one per hardware thread).");
+  m.def(
+      "computeInverseKinematics",
+      [](const RobotState& state, const std::string& group, const InputArray& poses, const std::string& tip,
+         double timeout, std::size_t threads) {
+        const JointModelGroup* jmg = getGroupOrThrow(state, group);
+        if (poses.ndim() != 3 || poses.shape(1) != 4 || poses.shape(2) != 4)
+          throw std::invalid_argument("poses must have shape (N, 4, 4)");
+        const std::size_t count = poses.shape(0);
+        const std::size_t columns = jmg->getVariableCount();
+
+        std::vector<double> seed;
+        state.copyJointGroupPositions(jmg, seed);
+        py::array_t<double> solutions({ count, columns });
+        py::array_t<bool> success(count);
+        const double* in = poses.data();
+        double* out = solutions.mutable_data();
+        bool* found = success.mutable_data();
+        std::vector<RobotState> scratch(moveit::python::batchThreadCount(count, threads), state);
+        moveit::python::runBatch(count, threads, [&](std::size_t thread, std::size_t i) {
+          RobotState& s = scratch[thread];
+          // every pose starts from the same seed, so the results do not depend on the order they are solved in
+          s.setJointGroupPositions(jmg, seed);
+          Eigen::Isometry3d pose;
+          pose.matrix() = Eigen::Map<const RowMajorMatrix4d>(in + i * 16);
+          found[i] = tip.empty() ? s.setFromIK(jmg, pose, timeout) : s.setFromIK(jmg, pose, tip, timeout);
+          s.copyJointGroupPositions(jmg, out + i * columns);
+        });
+        return py::make_tuple(solutions, success);
+      },
+      py::arg("state"), py::arg("group"), py::arg("poses"), py::arg("tip") = "", py::arg("timeout") = 0.0,
+      py::arg("threads") = 1,
+      "Solve IK for each of an (N, 4, 4) array of poses, seeded from the state. Returns an (N, variables) array of "
+      "group positions and an (N,) array telling which poses were solved. Runs without the GIL; use more than one "
+      "thread only with kinematics solvers that are safe to call concurrently.");
+
   m.def("jointStateToRobotState", &jointStateToRobotState);
   m.def(
       "robotStateToRobotStateMsg",
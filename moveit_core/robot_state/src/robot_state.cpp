@@ -39,6 +39,7 @@
 #include <geometric_shapes/shape_operations.h>
 #include <moveit/robot_state/cartesian_interpolator.h>
 #include <moveit/robot_state/robot_state.h>
+#include <moveit/robot_state/robot_state_pool.h>
 #include <moveit/transforms/transforms.h>
 #include <rclcpp/clock.hpp>
 #include <rclcpp/logger.hpp>
@@ -61,21 +62,32 @@ namespace core
 // Logger
 static const rclcpp::Logger LOGGER = rclcpp::get_logger("moveit_robot_state.robot_state");
 
-RobotState::RobotState(const RobotModelConstPtr& robot_model)
+RobotState::RobotState(const RobotModelConstPtr& robot_model) : RobotState(robot_model, nullptr)
+{
+}
+
+RobotState::RobotState(const RobotModelConstPtr& robot_model, const RobotStatePoolPtr& pool)
   : robot_model_(robot_model)
+  , pool_(pool)
   , has_velocity_(false)
   , has_acceleration_(false)
   , has_effort_(false)
   , dirty_link_transforms_(nullptr)
   , dirty_collision_body_transforms_(nullptr)
+  , dirty_link_transform_subtree_count_(0)
+  , dirty_collision_body_transform_subtree_count_(0)
   , rng_(nullptr)
 {
   if (robot_model == nullptr)
   {
     throw std::invalid_argument("RobotState cannot be constructed with nullptr RobotModelConstPtr");
   }
+  if (pool && pool->getRobotModel() != robot_model)
+  {
+    throw std::invalid_argument("RobotState cannot be constructed from a RobotStatePool for a different RobotModel");
+  }
 
-  dirty_link_transforms_ = robot_model_->getRootJoint();
+  markDirtyAllLinkTransforms();
   allocMemory();
   initTransforms();
 }
@@ -83,6 +95,7 @@ RobotState::RobotState(const RobotModelConstPtr& robot_model)
 RobotState::RobotState(const RobotState& other) : rng_(nullptr)
 {
   robot_model_ = other.robot_model_;
+  pool_ = other.pool_;
   allocMemory();
   copyFrom(other);
 }
@@ -90,11 +103,26 @@ RobotState::RobotState(const RobotState& other) : rng_(nullptr)
 RobotState::~RobotState()
 {
   clearAttachedBodies();
-  free(memory_);
+  if (pool_)
+    pool_->releaseBlock(memory_);
+  else
+    free(memory_);
   if (rng_)
     delete rng_;
 }
 
+std::size_t RobotState::getMemorySize(const RobotModel& robot_model)
+{
+  constexpr unsigned int extra_alignment_bytes = EIGEN_MAX_ALIGN_BYTES - 1;
+  // memory for the dirty joint transforms
+  const int nr_doubles_for_dirty_joint_transforms =
+      1 + robot_model.getJointModelCount() / (sizeof(double) / sizeof(unsigned char));
+  return sizeof(Eigen::Isometry3d) * (robot_model.getJointModelCount() + robot_model.getLinkModelCount() +
+                                      robot_model.getLinkGeometryCount()) +
+         sizeof(double) * (robot_model.getVariableCount() * 3 + nr_doubles_for_dirty_joint_transforms) +
+         extra_alignment_bytes;
+}
+
 void RobotState::allocMemory()
 {
   static_assert((sizeof(Eigen::Isometry3d) / EIGEN_MAX_ALIGN_BYTES) * EIGEN_MAX_ALIGN_BYTES == sizeof(Eigen::Isometry3d),
@@ -104,12 +132,7 @@ void RobotState::allocMemory()
   // memory for the dirty joint transforms
   const int nr_doubles_for_dirty_joint_transforms =
       1 + robot_model_->getJointModelCount() / (sizeof(double) / sizeof(unsigned char));
-  const size_t bytes =
-      sizeof(Eigen::Isometry3d) * (robot_model_->getJointModelCount() + robot_model_->getLinkModelCount() +
-                                   robot_model_->getLinkGeometryCount()) +
-      sizeof(double) * (robot_model_->getVariableCount() * 3 + nr_doubles_for_dirty_joint_transforms) +
-      extra_alignment_bytes;
-  memory_ = malloc(bytes);
+  memory_ = pool_ ? pool_->acquireBlock() : malloc(getMemorySize(*robot_model_));
 
   // make the memory for transforms align at EIGEN_MAX_ALIGN_BYTES
   // https://eigen.tuxfamily.org/dox/classEigen_1_1aligned__allocator.html
@@ -155,6 +178,10 @@ void RobotState::copyFrom(const RobotState& other)
 
   dirty_collision_body_transforms_ = other.dirty_collision_body_transforms_;
   dirty_link_transforms_ = other.dirty_link_transforms_;
+  dirty_link_transform_subtrees_ = other.dirty_link_transform_subtrees_;
+  dirty_link_transform_subtree_count_ = other.dirty_link_transform_subtree_count_;
+  dirty_collision_body_transform_subtrees_ = other.dirty_collision_body_transform_subtrees_;
+  dirty_collision_body_transform_subtree_count_ = other.dirty_collision_body_transform_subtree_count_;
 
   if (dirty_link_transforms_ == robot_model_->getRootJoint())
   {
@@ -290,7 +317,7 @@ void RobotState::setToRandomPositions()
   random_numbers::RandomNumberGenerator& rng = getRandomNumberGenerator();
   robot_model_->getVariableRandomPositions(rng, position_);
   memset(dirty_joint_transforms_, 1, robot_model_->getJointModelCount() * sizeof(unsigned char));
-  dirty_link_transforms_ = robot_model_->getRootJoint();
+  markDirtyAllLinkTransforms();
   // mimic values are correctly set in RobotModel
 }
 
@@ -368,7 +395,7 @@ void RobotState::setToDefaultValues()
   // set velocity & acceleration to 0
   memset(velocity_, 0, sizeof(double) * 2 * robot_model_->getVariableCount());
   memset(dirty_joint_transforms_, 1, robot_model_->getJointModelCount() * sizeof(unsigned char));
-  dirty_link_transforms_ = robot_model_->getRootJoint();
+  markDirtyAllLinkTransforms();
 }
 
 void RobotState::setVariablePositions(const double* position)
@@ -380,7 +407,7 @@ void RobotState::setVariablePositions(const double* position)
 
   // Since all joint values have potentially changed, we will need to recompute all transforms
   memset(dirty_joint_transforms_, 1, robot_model_->getJointModelCount() * sizeof(unsigned char));
-  dirty_link_transforms_ = robot_model_->getRootJoint();
+  markDirtyAllLinkTransforms();
 }
 
 void RobotState::setVariablePositions(const std::map<std::string, double>& variable_map)
@@ -532,8 +559,13 @@ void RobotState::setJointGroupPositions(const JointModelGroup* group, const doub
 void RobotState::setJointGroupPositions(const JointModelGroup* group, const Eigen::VectorXd& values)
 {
   const std::vector<int>& il = group->getVariableIndexList();
-  for (std::size_t i = 0; i < il.size(); ++i)
-    position_[il[i]] = values(i);
+  if (group->isContiguousWithinState())
+    memcpy(position_ + il[0], values.data(), group->getVariableCount() * sizeof(double));
+  else
+  {
+    for (std::size_t i = 0; i < il.size(); ++i)
+      position_[il[i]] = values(i);
+  }
   updateMimicJoints(group);
 }
 
@@ -575,8 +607,11 @@ void RobotState::copyJointGroupPositions(const JointModelGroup* group, Eigen::Ve
 {
   const std::vector<int>& il = group->getVariableIndexList();
   values.resize(il.size());
-  for (std::size_t i = 0; i < il.size(); ++i)
-    values(i) = position_[il[i]];
+  if (group->isContiguousWithinState())
+    memcpy(values.data(), position_ + il[0], group->getVariableCount() * sizeof(double));
+  else
+    for (std::size_t i = 0; i < il.size(); ++i)
+      values(i) = position_[il[i]];
 }
 
 void RobotState::setJointGroupVelocities(const JointModelGroup* group, const double* gstate)
@@ -663,13 +698,65 @@ void RobotState::update(bool force)
   if (force)
   {
     memset(dirty_joint_transforms_, 1, robot_model_->getJointModelCount() * sizeof(unsigned char));
-    dirty_link_transforms_ = robot_model_->getRootJoint();
+    markDirtyAllLinkTransforms();
   }
 
   // this actually triggers all needed updates
   updateCollisionBodyTransforms();
 }
 
+namespace
+{
+// Add the subtree starting at joint to the set of dirty subtrees whose common root is common_root.
+// If more than MAX_DIRTY_SUBTREES disjoint subtrees would result, fall back to considering
+// the whole subtree below common_root dirty, indicated by count == 0.
+template <std::size_t N>
+void addDirtySubtree(const RobotModel& model, const JointModel* joint, const JointModel*& common_root,
+                     std::array<const JointModel*, N>& subtrees, std::size_t& count)
+{
+  if (common_root == nullptr)
+  {
+    common_root = joint;
+    subtrees[0] = joint;
+    count = 1;
+    return;
+  }
+
+  common_root = model.getCommonRoot(common_root, joint);
+  if (count == 0)  // already tracking the whole subtree below common_root
+    return;
+
+  std::size_t i = 0;
+  while (i < count)
+  {
+    const JointModel* root = model.getCommonRoot(subtrees[i], joint);
+    if (root == subtrees[i])  // joint is already covered by this subtree
+      return;
+    if (root == joint)  // this subtree is covered by joint
+      subtrees[i] = subtrees[--count];
+    else
+      ++i;
+  }
+
+  if (count < N)
+    subtrees[count++] = joint;
+  else
+    count = 0;
+}
+}  // namespace
+
+void RobotState::markDirtyLinkTransforms(const JointModel* joint)
+{
+  addDirtySubtree(*robot_model_, joint, dirty_link_transforms_, dirty_link_transform_subtrees_,
+                  dirty_link_transform_subtree_count_);
+}
+
+void RobotState::markDirtyCollisionBodyTransforms(const JointModel* joint)
+{
+  addDirtySubtree(*robot_model_, joint, dirty_collision_body_transforms_, dirty_collision_body_transform_subtrees_,
+                  dirty_collision_body_transform_subtree_count_);
+}
+
 void RobotState::updateCollisionBodyTransforms()
 {
   if (dirty_link_transforms_ != nullptr)
@@ -677,23 +764,31 @@ void RobotState::updateCollisionBodyTransforms()
 
   if (dirty_collision_body_transforms_ != nullptr)
   {
-    const std::vector<const LinkModel*>& links = dirty_collision_body_transforms_->getDescendantLinkModels();
+    if (dirty_collision_body_transform_subtree_count_ == 0)
+      updateCollisionBodyTransformsInternal(dirty_collision_body_transforms_);
+    else
+      for (std::size_t i = 0; i < dirty_collision_body_transform_subtree_count_; ++i)
+        updateCollisionBodyTransformsInternal(dirty_collision_body_transform_subtrees_[i]);
     dirty_collision_body_transforms_ = nullptr;
+    dirty_collision_body_transform_subtree_count_ = 0;
+  }
+}
 
-    for (const LinkModel* link : links)
+void RobotState::updateCollisionBodyTransformsInternal(const JointModel* start)
+{
+  for (const LinkModel* link : start->getDescendantLinkModels())
+  {
+    const EigenSTL::vector_Isometry3d& ot = link->getCollisionOriginTransforms();
+    const std::vector<int>& ot_id = link->areCollisionOriginTransformsIdentity();
+    const int index_co = link->getFirstCollisionBodyTransformIndex();
+    const int index_l = link->getLinkIndex();
+    for (std::size_t j = 0, end = ot.size(); j != end; ++j)
     {
-      const EigenSTL::vector_Isometry3d& ot = link->getCollisionOriginTransforms();
-      const std::vector<int>& ot_id = link->areCollisionOriginTransformsIdentity();
-      const int index_co = link->getFirstCollisionBodyTransformIndex();
-      const int index_l = link->getLinkIndex();
-      for (std::size_t j = 0, end = ot.size(); j != end; ++j)
-      {
-        if (ot_id[j])
-          global_collision_body_transforms_[index_co + j] = global_link_transforms_[index_l];
-        else
-          global_collision_body_transforms_[index_co + j].affine().noalias() =
-              global_link_transforms_[index_l].affine() * ot[j].matrix();
-      }
+      if (ot_id[j])
+        global_collision_body_transforms_[index_co + j] = global_link_transforms_[index_l];
+      else
+        global_collision_body_transforms_[index_co + j].affine().noalias() =
+            global_link_transforms_[index_l].affine() * ot[j].matrix();
     }
   }
 }
@@ -702,16 +797,42 @@ void RobotState::updateLinkTransforms()
 {
   if (dirty_link_transforms_ != nullptr)
   {
-    updateLinkTransformsInternal(dirty_link_transforms_);
-    if (dirty_collision_body_transforms_)
-      dirty_collision_body_transforms_ =
-          robot_model_->getCommonRoot(dirty_collision_body_transforms_, dirty_link_transforms_);
+    const FKKernel* kernel = robot_model_->getFKKernel();
+    if (kernel && dirty_link_transforms_ == robot_model_->getRootJoint() && dirty_link_transform_subtree_count_ == 0)
+    {
+      // the whole tree is dirty: use the forward kinematics generated for this robot model.
+      // Joint transforms are not needed by the kernel and remain to be computed on demand.
+      kernel->compute_link_transforms(position_, global_link_transforms_);
+      markDirtyCollisionBodyTransforms(dirty_link_transforms_);
+    }
+    else if (dirty_link_transform_subtree_count_ == 0)
+    {
+      updateLinkTransformsInternal(dirty_link_transforms_);
+      markDirtyCollisionBodyTransforms(dirty_link_transforms_);
+    }
     else
-      dirty_collision_body_transforms_ = dirty_link_transforms_;
+    {
+      // the subtrees are disjoint, so their parent links are up to date and the order does not matter
+      for (std::size_t i = 0; i < dirty_link_transform_subtree_count_; ++i)
+      {
+        updateLinkTransformsInternal(dirty_link_transform_subtrees_[i]);
+        markDirtyCollisionBodyTransforms(dirty_link_transform_subtrees_[i]);
+      }
+    }
     dirty_link_transforms_ = nullptr;
+    dirty_link_transform_subtree_count_ = 0;
+    updateAttachedBodyTransforms();
   }
 }
 
+void RobotState::updateAttachedBodyTransforms()
+{
+  // update attached bodies tf; these are usually very few, so we update them all
+  for (const auto& attached_body : attached_body_map_)
+    attached_body.second->computeTransform(
+        global_link_transforms_[attached_body.second->getAttachedLink()->getLinkIndex()]);
+}
+
 void RobotState::updateLinkTransformsInternal(const JointModel* start)
 {
   for (const LinkModel* link : start->getDescendantLinkModels())
@@ -744,11 +865,6 @@ void RobotState::updateLinkTransformsInternal(const JointModel* start)
             link->getJointOriginTransform().affine() * getJointTransform(link->getParentJointModel()).matrix();
     }
   }
-
-  // update attached bodies tf; these are usually very few, so we update them all
-  for (const auto& attached_body : attached_body_map_)
-    attached_body.second->computeTransform(
-        global_link_transforms_[attached_body.second->getAttachedLink()->getLinkIndex()]);
 }
 
 void RobotState::updateStateWithLinkAt(const LinkModel* link, const Eigen::Isometry3d& transform, bool backward)
@@ -756,11 +872,7 @@ void RobotState::updateStateWithLinkAt(const LinkModel* link, const Eigen::Isome
   updateLinkTransforms();  // no link transforms must be dirty, otherwise the transform we set will be overwritten
 
   // update the fact that collision body transforms are out of date
-  if (dirty_collision_body_transforms_)
-    dirty_collision_body_transforms_ =
-        robot_model_->getCommonRoot(dirty_collision_body_transforms_, link->getParentJointModel());
-  else
-    dirty_collision_body_transforms_ = link->getParentJointModel();
+  markDirtyCollisionBodyTransforms(link->getParentJointModel());
 
   global_link_transforms_[link->getLinkIndex()] = transform;
 
@@ -782,9 +894,7 @@ void RobotState::updateStateWithLinkAt(const LinkModel* link, const Eigen::Isome
       // update the transform of the parent
       global_link_transforms_[parent_link->getLinkIndex()] =
           global_link_transforms_[child_link->getLinkIndex()] *
-          (child_link->getJointOriginTransform() *
-           variable_joint_transforms_[child_link->getParentJointModel()->getJointIndex()])
-              .inverse();
+          (child_link->getJointOriginTransform() * getJointTransform(child_link->getParentJointModel())).inverse();
 
       // update link transforms for descendant links only (leaving the transform for the current link untouched)
       // with the exception of the child link we are coming backwards from
@@ -795,12 +905,10 @@ void RobotState::updateStateWithLinkAt(const LinkModel* link, const Eigen::Isome
     }
     // all collision body transforms are invalid now
     dirty_collision_body_transforms_ = parent_link->getParentJointModel();
+    dirty_collision_body_transform_subtree_count_ = 0;
   }
 
-  // update attached bodies tf; these are usually very few, so we update them all
-  for (const auto& attached_body : attached_body_map_)
-    attached_body.second->computeTransform(
-        global_link_transforms_[attached_body.second->getAttachedLink()->getLinkIndex()]);
+  updateAttachedBodyTransforms();
 }
 
 const LinkModel* RobotState::getRigidlyConnectedParentLinkModel(const std::string& frame) const
@@ -957,7 +1065,7 @@ void RobotState::interpolate(const RobotState& to, double t, RobotState& state)
   robot_model_->interpolate(getVariablePositions(), to.getVariablePositions(), t, state.getVariablePositions());
 
   memset(state.dirty_joint_transforms_, 1, state.robot_model_->getJointModelCount() * sizeof(unsigned char));
-  state.dirty_link_transforms_ = state.robot_model_->getRootJoint();
+  state.markDirtyAllLinkTransforms();
 }
 
 void RobotState::interpolate(const RobotState& to, double t, RobotState& state, const JointModelGroup* joint_group) const
@@ -1320,58 +1428,81 @@ bool RobotState::getJacobian(const JointModelGroup* group, const LinkModel* link
            point_transform.z());
   */
 
-  Eigen::Vector3d joint_axis;
-  Eigen::Isometry3d joint_transform;
+  // use the Jacobian generated for this group, if any
+  JacobianKernelFn jacobian_kernel = nullptr;
+  if (robot_model_->getFKKernel() && link == group->getLinkModels().back())
+  {
+    const auto it = robot_model_->getFKKernel()->jacobians.find(group->getName());
+    if (it != robot_model_->getFKKernel()->jacobians.end())
+      jacobian_kernel = it->second;
+  }
 
-  while (link)
+  if (jacobian_kernel)
   {
-    /*
-    RCLCPP_DEBUG(LOGGER, "Link: %s, %f %f %f",link_state->getName().c_str(),
-             link_state->getGlobalLinkTransform().translation().x(),
-             link_state->getGlobalLinkTransform().translation().y(),
-             link_state->getGlobalLinkTransform().translation().z());
-    RCLCPP_DEBUG(LOGGER, "Joint: %s",link_state->getParentJointState()->getName().c_str());
-    */
-    const JointModel* pjm = link->getParentJointModel();
-    if (pjm->getVariableCount() > 0)
+    if (rows == 6)
+      jacobian_kernel(global_link_transforms_, reference_point_position, jacobian.data());
+    else
     {
-      if (!group->hasJointModel(pjm->getName()))
-      {
-        link = pjm->getParentLinkModel();
-        continue;
-      }
-      unsigned int joint_index = group->getVariableGroupIndex(pjm->getName());
-      // getGlobalLinkTransform() returns a valid isometry by contract
-      joint_transform = reference_transform * getGlobalLinkTransform(link);  // valid isometry
-      if (pjm->getType() == moveit::core::JointModel::REVOLUTE)
-      {
-        joint_axis = joint_transform.linear() * static_cast<const moveit::core::RevoluteJointModel*>(pjm)->getAxis();
-        jacobian.block<3, 1>(0, joint_index) =
-            jacobian.block<3, 1>(0, joint_index) + joint_axis.cross(point_transform - joint_transform.translation());
-        jacobian.block<3, 1>(3, joint_index) = jacobian.block<3, 1>(3, joint_index) + joint_axis;
-      }
-      else if (pjm->getType() == moveit::core::JointModel::PRISMATIC)
-      {
-        joint_axis = joint_transform.linear() * static_cast<const moveit::core::PrismaticJointModel*>(pjm)->getAxis();
-        jacobian.block<3, 1>(0, joint_index) = jacobian.block<3, 1>(0, joint_index) + joint_axis;
-      }
-      else if (pjm->getType() == moveit::core::JointModel::PLANAR)
+      Eigen::Matrix<double, 6, Eigen::Dynamic> jacobian6(6, columns);
+      jacobian_kernel(global_link_transforms_, reference_point_position, jacobian6.data());
+      jacobian.topRows<6>() = jacobian6;
+    }
+  }
+  else
+  {
+    Eigen::Vector3d joint_axis;
+    Eigen::Isometry3d joint_transform;
+
+    while (link)
+    {
+      /*
+      RCLCPP_DEBUG(LOGGER, "Link: %s, %f %f %f",link_state->getName().c_str(),
+               link_state->getGlobalLinkTransform().translation().x(),
+               link_state->getGlobalLinkTransform().translation().y(),
+               link_state->getGlobalLinkTransform().translation().z());
+      RCLCPP_DEBUG(LOGGER, "Joint: %s",link_state->getParentJointState()->getName().c_str());
+      */
+      const JointModel* pjm = link->getParentJointModel();
+      if (pjm->getVariableCount() > 0)
       {
-        joint_axis = joint_transform * Eigen::Vector3d(1.0, 0.0, 0.0);
-        jacobian.block<3, 1>(0, joint_index) = jacobian.block<3, 1>(0, joint_index) + joint_axis;
-        joint_axis = joint_transform * Eigen::Vector3d(0.0, 1.0, 0.0);
-        jacobian.block<3, 1>(0, joint_index + 1) = jacobian.block<3, 1>(0, joint_index + 1) + joint_axis;
-        joint_axis = joint_transform * Eigen::Vector3d(0.0, 0.0, 1.0);
-        jacobian.block<3, 1>(0, joint_index + 2) = jacobian.block<3, 1>(0, joint_index + 2) +
-                                                   joint_axis.cross(point_transform - joint_transform.translation());
-        jacobian.block<3, 1>(3, joint_index + 2) = jacobian.block<3, 1>(3, joint_index + 2) + joint_axis;
+        if (!group->hasJointModel(pjm->getName()))
+        {
+          link = pjm->getParentLinkModel();
+          continue;
+        }
+        unsigned int joint_index = group->getVariableGroupIndex(pjm->getName());
+        // getGlobalLinkTransform() returns a valid isometry by contract
+        joint_transform = reference_transform * getGlobalLinkTransform(link);  // valid isometry
+        if (pjm->getType() == moveit::core::JointModel::REVOLUTE)
+        {
+          joint_axis = joint_transform.linear() * static_cast<const moveit::core::RevoluteJointModel*>(pjm)->getAxis();
+          jacobian.block<3, 1>(0, joint_index) =
+              jacobian.block<3, 1>(0, joint_index) + joint_axis.cross(point_transform - joint_transform.translation());
+          jacobian.block<3, 1>(3, joint_index) = jacobian.block<3, 1>(3, joint_index) + joint_axis;
+        }
+        else if (pjm->getType() == moveit::core::JointModel::PRISMATIC)
+        {
+          joint_axis = joint_transform.linear() * static_cast<const moveit::core::PrismaticJointModel*>(pjm)->getAxis();
+          jacobian.block<3, 1>(0, joint_index) = jacobian.block<3, 1>(0, joint_index) + joint_axis;
+        }
+        else if (pjm->getType() == moveit::core::JointModel::PLANAR)
+        {
+          joint_axis = joint_transform * Eigen::Vector3d(1.0, 0.0, 0.0);
+          jacobian.block<3, 1>(0, joint_index) = jacobian.block<3, 1>(0, joint_index) + joint_axis;
+          joint_axis = joint_transform * Eigen::Vector3d(0.0, 1.0, 0.0);
+          jacobian.block<3, 1>(0, joint_index + 1) = jacobian.block<3, 1>(0, joint_index + 1) + joint_axis;
+          joint_axis = joint_transform * Eigen::Vector3d(0.0, 0.0, 1.0);
+          jacobian.block<3, 1>(0, joint_index + 2) = jacobian.block<3, 1>(0, joint_index + 2) +
+                                                     joint_axis.cross(point_transform - joint_transform.translation());
+          jacobian.block<3, 1>(3, joint_index + 2) = jacobian.block<3, 1>(3, joint_index + 2) + joint_axis;
+        }
+        else
+          RCLCPP_ERROR(LOGGER, "Unknown type of joint in Jacobian computation");
       }
-      else
-        RCLCPP_ERROR(LOGGER, "Unknown type of joint in Jacobian computation");
+      if (pjm == root_joint_model)
+        break;
+      link = pjm->getParentLinkModel();
     }
-    if (pjm == root_joint_model)
-      break;
-    link = pjm->getParentLinkModel();
   }
   if (use_quaternion_representation)
   {  // Quaternion representation
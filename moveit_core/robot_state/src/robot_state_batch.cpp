@@ -0,0 +1,311 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/robot_state/robot_state_batch.h>
+#include <algorithm>
+#include <cmath>
+
+namespace moveit
+{
+namespace core
+{
+namespace
+{
+// number of doubles per alignment unit, such that every array in the batch starts aligned
+constexpr std::size_t ALIGNMENT_DOUBLES =
+    EIGEN_MAX_ALIGN_BYTES > sizeof(double) ? EIGEN_MAX_ALIGN_BYTES / sizeof(double) : 1;
+
+// Entry layout of a transform: rotation in column-major order (0-8), then translation (9-11)
+inline std::size_t rot(std::size_t row, std::size_t col)
+{
+  return col * 3 + row;
+}
+
+inline std::size_t trans(std::size_t row)
+{
+  return 9 + row;
+}
+
+// out = parent * local, where both parent and local vary along the batch
+void composeVarying(const double* parent, const double* local, double* out, std::size_t stride, std::size_t n)
+{
+  for (std::size_t c = 0; c < 3; ++c)
+    for (std::size_t r = 0; r < 3; ++r)
+    {
+      const double* p0 = parent + rot(r, 0) * stride;
+      const double* p1 = parent + rot(r, 1) * stride;
+      const double* p2 = parent + rot(r, 2) * stride;
+      const double* l0 = local + rot(0, c) * stride;
+      const double* l1 = local + rot(1, c) * stride;
+      const double* l2 = local + rot(2, c) * stride;
+      double* o = out + rot(r, c) * stride;
+      for (std::size_t i = 0; i < n; ++i)
+        o[i] = p0[i] * l0[i] + p1[i] * l1[i] + p2[i] * l2[i];
+    }
+  for (std::size_t r = 0; r < 3; ++r)
+  {
+    const double* p0 = parent + rot(r, 0) * stride;
+    const double* p1 = parent + rot(r, 1) * stride;
+    const double* p2 = parent + rot(r, 2) * stride;
+    const double* pt = parent + trans(r) * stride;
+    const double* l0 = local + trans(0) * stride;
+    const double* l1 = local + trans(1) * stride;
+    const double* l2 = local + trans(2) * stride;
+    double* o = out + trans(r) * stride;
+    for (std::size_t i = 0; i < n; ++i)
+      o[i] = p0[i] * l0[i] + p1[i] * l1[i] + p2[i] * l2[i] + pt[i];
+  }
+}
+
+// out = parent * local, where only parent varies along the batch
+void composeConstant(const double* parent, const Eigen::Isometry3d& local, double* out, std::size_t stride,
+                     std::size_t n)
+{
+  const Eigen::Matrix3d& lr = local.linear();
+  const Eigen::Vector3d& lt = local.translation();
+  for (std::size_t c = 0; c < 3; ++c)
+    for (std::size_t r = 0; r < 3; ++r)
+    {
+      const double* p0 = parent + rot(r, 0) * stride;
+      const double* p1 = parent + rot(r, 1) * stride;
+      const double* p2 = parent + rot(r, 2) * stride;
+      const double l0 = lr(0, c), l1 = lr(1, c), l2 = lr(2, c);
+      double* o = out + rot(r, c) * stride;
+      for (std::size_t i = 0; i < n; ++i)
+        o[i] = p0[i] * l0 + p1[i] * l1 + p2[i] * l2;
+    }
+  for (std::size_t r = 0; r < 3; ++r)
+  {
+    const double* p0 = parent + rot(r, 0) * stride;
+    const double* p1 = parent + rot(r, 1) * stride;
+    const double* p2 = parent + rot(r, 2) * stride;
+    const double* pt = parent + trans(r) * stride;
+    const double l0 = lt.x(), l1 = lt.y(), l2 = lt.z();
+    double* o = out + trans(r) * stride;
+    for (std::size_t i = 0; i < n; ++i)
+      o[i] = p0[i] * l0 + p1[i] * l1 + p2[i] * l2 + pt[i];
+  }
+}
+
+// out = transform for every entry of the batch
+void broadcast(const Eigen::Isometry3d& transform, double* out, std::size_t stride, std::size_t n)
+{
+  for (std::size_t c = 0; c < 3; ++c)
+    for (std::size_t r = 0; r < 3; ++r)
+      std::fill(out + rot(r, c) * stride, out + rot(r, c) * stride + n, transform.linear()(r, c));
+  for (std::size_t r = 0; r < 3; ++r)
+    std::fill(out + trans(r) * stride, out + trans(r) * stride + n, transform.translation()[r]);
+}
+}  // namespace
+
+RobotStateBatch::RobotStateBatch(const RobotModelConstPtr& robot_model, std::size_t size)
+  : robot_model_(robot_model), size_(0), stride_(0), dirty_(true)
+{
+  if (robot_model == nullptr)
+  {
+    throw std::invalid_argument("RobotStateBatch cannot be constructed with nullptr RobotModelConstPtr");
+  }
+  scratch_transform_.setIdentity();
+  resize(size);
+}
+
+void RobotStateBatch::resize(std::size_t size)
+{
+  size_ = size;
+  stride_ = ((size + ALIGNMENT_DOUBLES - 1) / ALIGNMENT_DOUBLES) * ALIGNMENT_DOUBLES;
+  positions_.assign(robot_model_->getVariableCount() * stride_, 0.0);
+  link_transforms_.assign(robot_model_->getLinkModelCount() * TRANSFORM_ENTRIES * stride_, 0.0);
+  local_transform_.assign(TRANSFORM_ENTRIES * stride_, 0.0);
+  dirty_ = true;
+}
+
+void RobotStateBatch::setVariablePositions(std::size_t index, const double* positions)
+{
+  assert(index < size_);
+  for (std::size_t v = 0, end = robot_model_->getVariableCount(); v < end; ++v)
+    positions_[v * stride_ + index] = positions[v];
+  dirty_ = true;
+}
+
+void RobotStateBatch::copyVariablePositions(std::size_t index, double* positions) const
+{
+  assert(index < size_);
+  for (std::size_t v = 0, end = robot_model_->getVariableCount(); v < end; ++v)
+    positions[v] = positions_[v * stride_ + index];
+}
+
+void RobotStateBatch::setJointGroupPositions(std::size_t index, const JointModelGroup* group, const double* gstate)
+{
+  assert(index < size_);
+  const std::vector<int>& il = group->getVariableIndexList();
+  for (std::size_t i = 0; i < il.size(); ++i)
+    positions_[il[i] * stride_ + index] = gstate[i];
+  for (const JointModel* jm : group->getMimicJointModels())
+    positions_[jm->getFirstVariableIndex() * stride_ + index] =
+        jm->getMimicFactor() * positions_[jm->getMimic()->getFirstVariableIndex() * stride_ + index] +
+        jm->getMimicOffset();
+  dirty_ = true;
+}
+
+void RobotStateBatch::copyToRobotState(std::size_t index, RobotState& state) const
+{
+  std::vector<double> positions(robot_model_->getVariableCount());
+  copyVariablePositions(index, positions.data());
+  state.setVariablePositions(positions);
+}
+
+void RobotStateBatch::computeLocalTransforms(const LinkModel* link)
+{
+  const JointModel* joint = link->getParentJointModel();
+  const Eigen::Isometry3d& origin = link->getJointOriginTransform();
+  const Eigen::Matrix3d& ro = origin.linear();
+  const double* q = &positions_[joint->getFirstVariableIndex() * stride_];
+  double* out = local_transform_.data();
+  const std::size_t n = size_;
+  const std::size_t s = stride_;
+
+  if (joint->getType() == JointModel::REVOLUTE)
+  {
+    // local = origin * rotation about axis; the translation is the origin's translation
+    const Eigen::Vector3d& axis = static_cast<const RevoluteJointModel*>(joint)->getAxis();
+    const double x = axis.x(), y = axis.y(), z = axis.z();
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      const double c = std::cos(q[i]);
+      const double sn = std::sin(q[i]);
+      const double t = 1.0 - c;
+      // rotation about axis, row-major naming jRC
+      const double j00 = t * x * x + c, j01 = t * x * y - z * sn, j02 = t * x * z + y * sn;
+      const double j10 = t * x * y + z * sn, j11 = t * y * y + c, j12 = t * y * z - x * sn;
+      const double j20 = t * x * z - y * sn, j21 = t * y * z + x * sn, j22 = t * z * z + c;
+
+      out[rot(0, 0) * s + i] = ro(0, 0) * j00 + ro(0, 1) * j10 + ro(0, 2) * j20;
+      out[rot(1, 0) * s + i] = ro(1, 0) * j00 + ro(1, 1) * j10 + ro(1, 2) * j20;
+      out[rot(2, 0) * s + i] = ro(2, 0) * j00 + ro(2, 1) * j10 + ro(2, 2) * j20;
+      out[rot(0, 1) * s + i] = ro(0, 0) * j01 + ro(0, 1) * j11 + ro(0, 2) * j21;
+      out[rot(1, 1) * s + i] = ro(1, 0) * j01 + ro(1, 1) * j11 + ro(1, 2) * j21;
+      out[rot(2, 1) * s + i] = ro(2, 0) * j01 + ro(2, 1) * j11 + ro(2, 2) * j21;
+      out[rot(0, 2) * s + i] = ro(0, 0) * j02 + ro(0, 1) * j12 + ro(0, 2) * j22;
+      out[rot(1, 2) * s + i] = ro(1, 0) * j02 + ro(1, 1) * j12 + ro(1, 2) * j22;
+      out[rot(2, 2) * s + i] = ro(2, 0) * j02 + ro(2, 1) * j12 + ro(2, 2) * j22;
+    }
+    for (std::size_t r = 0; r < 3; ++r)
+      std::fill(out + trans(r) * s, out + trans(r) * s + n, origin.translation()[r]);
+  }
+  else if (joint->getType() == JointModel::PRISMATIC)
+  {
+    // local = origin * translation along axis; the rotation is the origin's rotation
+    const Eigen::Vector3d axis = ro * static_cast<const PrismaticJointModel*>(joint)->getAxis();
+    for (std::size_t c = 0; c < 3; ++c)
+      for (std::size_t r = 0; r < 3; ++r)
+        std::fill(out + rot(r, c) * s, out + rot(r, c) * s + n, ro(r, c));
+    for (std::size_t r = 0; r < 3; ++r)
+    {
+      const double a = axis[r];
+      const double o = origin.translation()[r];
+      double* t = out + trans(r) * s;
+      for (std::size_t i = 0; i < n; ++i)
+        t[i] = o + a * q[i];
+    }
+  }
+  else
+  {
+    // generic fallback: gather the joint's variables and use the joint model's own transform computation
+    const std::size_t nv = joint->getVariableCount();
+    std::vector<double> values(nv);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      for (std::size_t v = 0; v < nv; ++v)
+        values[v] = q[v * s + i];
+      joint->computeTransform(values.data(), scratch_transform_);
+      const Eigen::Isometry3d local = origin * scratch_transform_;
+      for (std::size_t c = 0; c < 3; ++c)
+        for (std::size_t r = 0; r < 3; ++r)
+          out[rot(r, c) * s + i] = local.linear()(r, c);
+      for (std::size_t r = 0; r < 3; ++r)
+        out[trans(r) * s + i] = local.translation()[r];
+    }
+  }
+}
+
+void RobotStateBatch::updateLinkTransforms()
+{
+  const std::size_t n = size_;
+  const std::size_t link_stride = TRANSFORM_ENTRIES * stride_;
+
+  // descendants of the root joint are ordered such that parents precede their children
+  for (const LinkModel* link : robot_model_->getRootJoint()->getDescendantLinkModels())
+  {
+    double* out = &link_transforms_[link->getLinkIndex() * link_stride];
+    const LinkModel* parent = link->getParentLinkModel();
+    const double* parent_transforms = parent ? &link_transforms_[parent->getLinkIndex() * link_stride] : nullptr;
+
+    if (link->parentJointIsFixed())
+    {
+      if (parent_transforms)
+        composeConstant(parent_transforms, link->getJointOriginTransform(), out, stride_, n);
+      else
+        broadcast(link->getJointOriginTransform(), out, stride_, n);
+    }
+    else
+    {
+      computeLocalTransforms(link);
+      if (parent_transforms)
+        composeVarying(parent_transforms, local_transform_.data(), out, stride_, n);
+      else
+        std::copy(local_transform_.begin(), local_transform_.end(), out);
+    }
+  }
+  dirty_ = false;
+}
+
+Eigen::Isometry3d RobotStateBatch::getGlobalLinkTransform(std::size_t index, const LinkModel* link) const
+{
+  assert(index < size_);
+  if (!link)
+  {
+    throw Exception("Invalid link");
+  }
+  const double* t = &link_transforms_[link->getLinkIndex() * TRANSFORM_ENTRIES * stride_ + index];
+  Eigen::Isometry3d result;
+  result.makeAffine();
+  for (std::size_t c = 0; c < 3; ++c)
+    for (std::size_t r = 0; r < 3; ++r)
+      result.linear()(r, c) = t[rot(r, c) * stride_];
+  for (std::size_t r = 0; r < 3; ++r)
+    result.translation()[r] = t[trans(r) * stride_];
+  return result;
+}
+}  // namespace core
+}  // namespace moveit
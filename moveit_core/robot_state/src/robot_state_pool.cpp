@@ -0,0 +1,97 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/robot_state/robot_state_pool.h>
+#include <algorithm>
+#include <new>
+
+namespace moveit
+{
+namespace core
+{
+RobotStatePool::RobotStatePool(const RobotModelConstPtr& robot_model, std::size_t blocks_per_slab)
+  : robot_model_(robot_model), blocks_per_slab_(std::max<std::size_t>(blocks_per_slab, 1))
+{
+  if (robot_model == nullptr)
+  {
+    throw std::invalid_argument("RobotStatePool cannot be constructed with nullptr RobotModelConstPtr");
+  }
+  // round up to whole cache lines, such that consecutive blocks of a slab do not share cache lines
+  block_size_ = (RobotState::getMemorySize(*robot_model_) + BLOCK_ALIGNMENT - 1) / BLOCK_ALIGNMENT * BLOCK_ALIGNMENT;
+}
+
+RobotStatePool::~RobotStatePool() = default;
+
+void RobotStatePool::SlabDeleter::operator()(void* slab) const
+{
+  ::operator delete(slab, std::align_val_t(BLOCK_ALIGNMENT));
+}
+
+void* RobotStatePool::acquireBlock()
+{
+  std::lock_guard<std::mutex> guard(lock_);
+  if (free_blocks_.empty())
+  {
+    void* slab = ::operator new(block_size_ * blocks_per_slab_, std::align_val_t(BLOCK_ALIGNMENT));
+    slabs_.emplace_back(slab);
+    free_blocks_.reserve(slabs_.size() * blocks_per_slab_);
+    // push in reverse order, such that blocks are handed out in address order
+    for (std::size_t i = blocks_per_slab_; i > 0; --i)
+      free_blocks_.push_back(static_cast<char*>(slab) + (i - 1) * block_size_);
+  }
+  void* block = free_blocks_.back();
+  free_blocks_.pop_back();
+  return block;
+}
+
+void RobotStatePool::releaseBlock(void* block)
+{
+  std::lock_guard<std::mutex> guard(lock_);
+  // most recently released blocks are reused first, as they are most likely still cached
+  free_blocks_.push_back(block);
+}
+
+std::size_t RobotStatePool::getBlockCount() const
+{
+  std::lock_guard<std::mutex> guard(lock_);
+  return slabs_.size() * blocks_per_slab_;
+}
+
+std::size_t RobotStatePool::getFreeBlockCount() const
+{
+  std::lock_guard<std::mutex> guard(lock_);
+  return free_blocks_.size();
+}
+}  // namespace core
+}  // namespace moveit
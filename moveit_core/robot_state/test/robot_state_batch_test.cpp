@@ -0,0 +1,115 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/robot_model/robot_model.h>
+#include <moveit/robot_state/robot_state.h>
+#include <moveit/robot_state/robot_state_batch.h>
+#include <moveit/utils/robot_model_test_utils.h>
+#include <gtest/gtest.h>
+
+namespace
+{
+constexpr double EPSILON{ 1.e-9 };
+
+void expectBatchMatchesRobotState(const moveit::core::RobotModelPtr& model, std::size_t batch_size)
+{
+  moveit::core::RobotStateBatch batch(model, batch_size);
+  std::vector<moveit::core::RobotState> states;
+  states.reserve(batch_size);
+  for (std::size_t i = 0; i < batch_size; ++i)
+  {
+    states.emplace_back(model);
+    states.back().setToRandomPositions();
+    batch.setFromRobotState(i, states.back());
+  }
+  EXPECT_TRUE(batch.dirtyLinkTransforms());
+  batch.updateLinkTransforms();
+  EXPECT_FALSE(batch.dirtyLinkTransforms());
+
+  for (std::size_t i = 0; i < batch_size; ++i)
+  {
+    states[i].updateLinkTransforms();
+    for (const moveit::core::LinkModel* link : model->getLinkModels())
+    {
+      const Eigen::Isometry3d expected = states[i].getGlobalLinkTransform(link);
+      const Eigen::Isometry3d actual = batch.getGlobalLinkTransform(i, link);
+      EXPECT_TRUE(expected.isApprox(actual, EPSILON)) << "link " << link->getName() << " of configuration " << i;
+    }
+  }
+}
+}  // namespace
+
+TEST(RobotStateBatch, MatchesRobotStatePR2)
+{
+  // 13 is deliberately not a multiple of the alignment to exercise the padded stride
+  expectBatchMatchesRobotState(moveit::core::loadTestingRobotModel("pr2"), 13);
+}
+
+TEST(RobotStateBatch, MatchesRobotStatePanda)
+{
+  expectBatchMatchesRobotState(moveit::core::loadTestingRobotModel("panda"), 64);
+}
+
+TEST(RobotStateBatch, JointGroupPositions)
+{
+  moveit::core::RobotModelPtr model = moveit::core::loadTestingRobotModel("panda");
+  const moveit::core::JointModelGroup* jmg = model->getJointModelGroup("panda_arm");
+  ASSERT_TRUE(jmg);
+
+  moveit::core::RobotState state(model);
+  state.setToDefaultValues();
+  moveit::core::RobotStateBatch batch(model, 2);
+  batch.setFromRobotState(0, state);
+  batch.setFromRobotState(1, state);
+
+  std::vector<double> gstate(jmg->getVariableCount(), 0.3);
+  state.setJointGroupPositions(jmg, gstate);
+  batch.setJointGroupPositions(1, jmg, gstate.data());
+  batch.updateLinkTransforms();
+
+  moveit::core::RobotState copy(model);
+  batch.copyToRobotState(1, copy);
+  for (std::size_t v = 0; v < model->getVariableCount(); ++v)
+    EXPECT_NEAR(copy.getVariablePosition(v), state.getVariablePosition(v), EPSILON);
+
+  const moveit::core::LinkModel* tip = jmg->getLinkModels().back();
+  EXPECT_TRUE(state.getGlobalLinkTransform(tip).isApprox(batch.getGlobalLinkTransform(1, tip), EPSILON));
+  EXPECT_FALSE(state.getGlobalLinkTransform(tip).isApprox(batch.getGlobalLinkTransform(0, tip), EPSILON));
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
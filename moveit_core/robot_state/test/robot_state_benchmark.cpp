@@ -35,6 +35,8 @@
 /* Author: Robert Haschke */
 #include <moveit/robot_model/robot_model.h>
 #include <moveit/robot_state/robot_state.h>
+#include <moveit/robot_state/robot_state_batch.h>
+#include <moveit/robot_state/jacobian_workspace.h>
 #include <moveit/utils/robot_model_test_utils.h>
 #include <eigen_stl_containers/eigen_stl_containers.h>
 #include <chrono>
@@ -106,6 +108,109 @@ TEST_F(Timing, stateUpdate)
   }
 }
 
+TEST_F(Timing, groupUpdate)
+{
+  // changing joints of two disjoint groups should only update the links below those groups
+  const std::vector<std::pair<std::string, std::vector<std::string>>> robots = {
+    { "pr2", { "left_arm", "right_arm" } }, { "panda", { "hand" } }
+  };
+  for (const auto& robot : robots)
+  {
+    moveit::core::RobotModelPtr model = moveit::core::loadTestingRobotModel(robot.first);
+    ASSERT_TRUE(bool(model));
+    std::vector<const moveit::core::JointModelGroup*> groups;
+    for (const std::string& name : robot.second)
+    {
+      groups.push_back(model->getJointModelGroup(name));
+      ASSERT_TRUE(groups.back()) << name;
+    }
+
+    moveit::core::RobotState state(model);
+    state.setToDefaultValues();
+    state.update();
+    std::vector<double> positions(model->getVariableCount());
+    double gold_standard = 0;
+    {
+      std::string msg = robot.first + ": full update: ";
+      ScopedTimer t(msg.c_str(), &gold_standard);
+      for (unsigned i = 0; i < 1e5; ++i)
+      {
+        for (const moveit::core::JointModelGroup* group : groups)
+          state.setToRandomPositions(group);
+        std::copy(state.getVariablePositions(), state.getVariablePositions() + positions.size(), positions.begin());
+        state.setVariablePositions(positions);
+        state.updateLinkTransforms();
+      }
+    }
+    {
+      std::string msg = robot.first + ": group update: ";
+      ScopedTimer t(msg.c_str(), &gold_standard);
+      for (unsigned i = 0; i < 1e5; ++i)
+      {
+        for (const moveit::core::JointModelGroup* group : groups)
+          state.setToRandomPositions(group);
+        std::copy(state.getVariablePositions(), state.getVariablePositions() + positions.size(), positions.begin());
+        state.updateLinkTransforms();
+      }
+    }
+  }
+}
+
+TEST_F(Timing, batchUpdate)
+{
+  moveit::core::RobotModelPtr model = moveit::core::loadTestingRobotModel("pr2");
+  ASSERT_TRUE(bool(model));
+  const std::size_t batch_size = 1000;
+  const std::size_t runs = 100;
+  std::vector<moveit::core::RobotState> states(batch_size, moveit::core::RobotState(model));
+  moveit::core::RobotStateBatch batch(model, batch_size);
+  for (std::size_t i = 0; i < batch_size; ++i)
+  {
+    states[i].setToRandomPositions();
+    batch.setFromRobotState(i, states[i]);
+  }
+
+  double gold_standard = 0;
+  {
+    ScopedTimer t("RobotState::update(true) per state: ", &gold_standard);
+    for (std::size_t r = 0; r < runs; ++r)
+      for (moveit::core::RobotState& state : states)
+        state.update(true);
+  }
+  {
+    ScopedTimer t("RobotStateBatch::updateLinkTransforms(): ", &gold_standard);
+    for (std::size_t r = 0; r < runs; ++r)
+      batch.updateLinkTransforms();
+  }
+}
+
+TEST_F(Timing, jacobian)
+{
+  moveit::core::RobotModelPtr model = moveit::core::loadTestingRobotModel("panda");
+  ASSERT_TRUE(bool(model));
+  const moveit::core::JointModelGroup* jmg = model->getJointModelGroup("panda_arm");
+  const moveit::core::LinkModel* tip = jmg->getLinkModels().back();
+  moveit::core::RobotState state(model);
+  state.setToRandomPositions();
+  state.update();
+
+  const unsigned runs = 1e5;
+  double gold_standard = 0;
+  {
+    ScopedTimer t("RobotState::getJacobian(): ", &gold_standard);
+    Eigen::MatrixXd jacobian;
+    for (unsigned i = 0; i < runs; ++i)
+      state.getJacobian(jmg, tip, Eigen::Vector3d::Zero(), jacobian);
+  }
+  {
+    ScopedTimer t("JacobianWorkspace::compute(): ", &gold_standard);
+    moveit::core::JacobianWorkspace workspace(jmg, tip);
+    Eigen::Matrix<double, 6, 7> jacobian;
+    for (unsigned i = 0; i < runs; ++i)
+      workspace.compute(state, jacobian);
+  }
+}
+
 TEST_F(Timing, multiply)
 {
   size_t runs = 1e7;
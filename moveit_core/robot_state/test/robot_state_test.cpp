@@ -35,6 +35,10 @@
 /* Author: Ioan Sucan */
 #include <moveit/robot_model/robot_model.h>
 #include <moveit/robot_state/robot_state.h>
+#include <moveit/robot_state/robot_state_pool.h>
+#include <moveit/robot_state/jacobian_workspace.h>
+#include <moveit/robot_state/group_state.h>
+#include <moveit/utils/random_seed.h>
 #include <moveit/utils/robot_model_test_utils.h>
 #include <urdf_parser/urdf_parser.h>
 #if __has_include(<tf2_geometry_msgs/tf2_geometry_msgs.hpp>)
@@ -716,6 +720,200 @@ TEST_F(OneRobot, rigidlyConnectedParent)
   EXPECT_EQ(nullptr, state.getRigidlyConnectedParentLinkModel("/"));
 }
 
+TEST(DirtyTracking, DisjointSubtrees)
+{
+  moveit::core::RobotModelPtr model = moveit::core::loadTestingRobotModel("pr2");
+  const moveit::core::JointModelGroup* left_arm = model->getJointModelGroup("left_arm");
+  const moveit::core::JointModelGroup* right_arm = model->getJointModelGroup("right_arm");
+  const moveit::core::JointModelGroup* arms = model->getJointModelGroup("arms");
+  ASSERT_TRUE(left_arm && right_arm && arms);
+
+  moveit::core::RobotState state(model);
+  state.setToRandomPositions();
+  state.update();
+
+  for (int i = 0; i < 10; ++i)
+  {
+    // dirty both arms individually, then both in one group, then additionally a single torso joint
+    state.setToRandomPositions(left_arm);
+    state.setToRandomPositions(right_arm);
+    state.update();
+
+    moveit::core::RobotState expected(model);
+    expected.setVariablePositions(state.getVariablePositions());
+    expected.update();
+    for (const moveit::core::LinkModel* link : model->getLinkModels())
+      EXPECT_TRUE(expected.getGlobalLinkTransform(link).isApprox(state.getGlobalLinkTransform(link), EPSILON))
+          << link->getName();
+    for (const moveit::core::LinkModel* link : model->getLinkModelsWithCollisionGeometry())
+      EXPECT_TRUE(
+          expected.getCollisionBodyTransform(link, 0).isApprox(state.getCollisionBodyTransform(link, 0), EPSILON))
+          << link->getName();
+
+    state.setToRandomPositions(arms);
+    state.setVariablePosition("torso_lift_joint", 0.1 * i);
+    state.updateLinkTransforms();
+
+    expected.setVariablePositions(state.getVariablePositions());
+    expected.update();
+    for (const moveit::core::LinkModel* link : model->getLinkModels())
+      EXPECT_TRUE(expected.getGlobalLinkTransform(link).isApprox(state.getGlobalLinkTransform(link), EPSILON))
+          << link->getName();
+  }
+}
+
+TEST(RobotStatePool, RecyclesBlocks)
+{
+  moveit::core::RobotModelPtr model = moveit::core::loadTestingRobotModel("panda");
+  auto pool = std::make_shared<moveit::core::RobotStatePool>(model, 4);
+  EXPECT_EQ(pool->getBlockSize() % moveit::core::RobotStatePool::BLOCK_ALIGNMENT, 0u);
+  EXPECT_GE(pool->getBlockSize(), moveit::core::RobotState::getMemorySize(*model));
+
+  moveit::core::RobotState reference(model);
+  reference.setToRandomPositions();
+  {
+    std::vector<moveit::core::RobotStatePtr> states;
+    for (int i = 0; i < 6; ++i)
+    {
+      states.push_back(moveit::core::makeRobotState(pool));
+      *states.back() = reference;
+      EXPECT_EQ(states.back()->getPool(), pool);
+    }
+    EXPECT_EQ(pool->getBlockCount(), 8u);
+    EXPECT_EQ(pool->getFreeBlockCount(), 2u);
+
+    // copies share the pool of the original
+    moveit::core::RobotState copy(*states.front());
+    EXPECT_EQ(copy.getPool(), pool);
+    EXPECT_EQ(pool->getFreeBlockCount(), 1u);
+    for (const moveit::core::LinkModel* link : model->getLinkModels())
+      EXPECT_TRUE(reference.getGlobalLinkTransform(link).isApprox(copy.getGlobalLinkTransform(link), EPSILON));
+  }
+  // all blocks are back in the pool, and are reused without allocating further slabs
+  EXPECT_EQ(pool->getFreeBlockCount(), 8u);
+  moveit::core::RobotState state(model, pool);
+  EXPECT_EQ(pool->getBlockCount(), 8u);
+  EXPECT_EQ(pool->getFreeBlockCount(), 7u);
+
+  // a state without pool stays on the heap
+  EXPECT_EQ(reference.getPool(), nullptr);
+  EXPECT_THROW(moveit::core::RobotState(moveit::core::loadTestingRobotModel("pr2"), pool), std::invalid_argument);
+}
+
+TEST(RandomSeed, ReproducibleRandomPositions)
+{
+  moveit::core::RobotModelPtr model = moveit::core::loadTestingRobotModel("panda");
+  const auto random_positions = [&model] {
+    moveit::core::RobotState state(model);
+    state.setToRandomPositions();
+    return std::vector<double>(state.getVariablePositions(), state.getVariablePositions() + model->getVariableCount());
+  };
+
+  moveit::core::setRandomSeed(42);
+  const std::vector<double> first = random_positions();
+  const std::vector<double> second = random_positions();
+  moveit::core::setRandomSeed(42);
+  EXPECT_EQ(random_positions(), first);
+  EXPECT_EQ(random_positions(), second);
+  EXPECT_NE(first, second);
+  ASSERT_TRUE(moveit::core::getRandomSeed());
+  EXPECT_EQ(*moveit::core::getRandomSeed(), 42u);
+
+  moveit::core::clearRandomSeed();
+  EXPECT_FALSE(moveit::core::getRandomSeed());
+  EXPECT_NE(random_positions(), first);
+}
+
+TEST(JacobianWorkspace, MatchesGetJacobian)
+{
+  moveit::core::RobotModelPtr model = moveit::core::loadTestingRobotModel("pr2");
+  const moveit::core::JointModelGroup* jmg = model->getJointModelGroup("left_arm");
+  ASSERT_TRUE(jmg);
+  const std::vector<const moveit::core::LinkModel*> links = { jmg->getLinkModels().back(), jmg->getLinkModels()[2] };
+  const EigenSTL::vector_Vector3d points = { Eigen::Vector3d(0.1, 0.0, 0.05), Eigen::Vector3d(0.0, 0.2, 0.0) };
+
+  moveit::core::JacobianWorkspace workspace(jmg, links, points);
+  ASSERT_EQ(workspace.rows(), 12);
+  ASSERT_EQ(workspace.cols(), 7);
+
+  moveit::core::RobotStateBatch batch(model, 3);
+  std::vector<moveit::core::RobotState> states(batch.size(), moveit::core::RobotState(model));
+  Eigen::MatrixXd expected;
+  for (std::size_t i = 0; i < states.size(); ++i)
+  {
+    states[i].setToRandomPositions();
+    states[i].update();
+    batch.setFromRobotState(i, states[i]);
+
+    workspace.compute(states[i]);
+    for (std::size_t l = 0; l < links.size(); ++l)
+    {
+      ASSERT_TRUE(states[i].getJacobian(jmg, links[l], points[l], expected));
+      EXPECT_TRUE(workspace.getJacobian(l).isApprox(expected, EPSILON)) << "link " << links[l]->getName();
+    }
+  }
+
+  // all configurations of a batch at once
+  batch.updateLinkTransforms();
+  Eigen::MatrixXd batch_jacobians(workspace.rows(), workspace.cols() * batch.size());
+  workspace.compute(batch, batch_jacobians);
+  for (std::size_t i = 0; i < states.size(); ++i)
+  {
+    ASSERT_TRUE(states[i].getJacobian(jmg, links[0], points[0], expected));
+    EXPECT_TRUE(batch_jacobians.block(0, i * workspace.cols(), 6, workspace.cols()).isApprox(expected, EPSILON));
+  }
+
+  // caller-owned fixed-size storage
+  moveit::core::JacobianWorkspace tip_workspace(jmg, links[0], points[0]);
+  Eigen::Matrix<double, 6, 7> fixed_jacobian;
+  tip_workspace.compute(states.back(), fixed_jacobian);
+  ASSERT_TRUE(states.back().getJacobian(jmg, links[0], points[0], expected));
+  EXPECT_TRUE(fixed_jacobian.isApprox(expected, EPSILON));
+
+  EXPECT_THROW(moveit::core::JacobianWorkspace(model->getJointModelGroup("arms"), links[0]), moveit::Exception);
+  EXPECT_THROW(moveit::core::JacobianWorkspace(jmg, model->getLinkModel("r_gripper_palm_link")), moveit::Exception);
+}
+
+TEST(GroupState, MatchesRobotState)
+{
+  moveit::core::RobotModelPtr model = moveit::core::loadTestingRobotModel("pr2");
+  const moveit::core::JointModelGroup* jmg = model->getJointModelGroup("right_arm");
+  ASSERT_TRUE(jmg);
+
+  auto background = std::make_shared<moveit::core::RobotState>(model);
+  background->setToRandomPositions();
+  background->update();
+  moveit::core::GroupState group_state(jmg, background);
+  EXPECT_EQ(group_state.getVariableCount(), jmg->getVariableCount());
+
+  moveit::core::RobotState expected(*background);
+  for (int i = 0; i < 5; ++i)
+  {
+    expected.setToRandomPositions(jmg);
+    expected.update();
+    group_state.setFromRobotState(expected);
+    EXPECT_TRUE(group_state.dirtyLinkTransforms());
+
+    // copies share the background and compute their own transforms
+    moveit::core::GroupState copy(group_state);
+    for (const moveit::core::LinkModel* link : model->getLinkModels())
+    {
+      EXPECT_TRUE(copy.getGlobalLinkTransform(link).isApprox(expected.getGlobalLinkTransform(link), EPSILON))
+          << link->getName();
+      EXPECT_EQ(copy.isLinkUpdated(link), jmg->isLinkUpdated(link->getName())) << link->getName();
+    }
+    EXPECT_TRUE(group_state.dirtyLinkTransforms());
+  }
+
+  moveit::core::RobotState full = group_state.toRobotState();
+  for (std::size_t i = 0; i < model->getVariableCount(); ++i)
+    EXPECT_DOUBLE_EQ(full.getVariablePosition(i), expected.getVariablePosition(i));
+
+  background->setVariablePosition(0, 1.0);
+  EXPECT_THROW(group_state.setBackground(background), moveit::Exception);
+  EXPECT_THROW(moveit::core::GroupState(jmg, nullptr), moveit::Exception);
+}
+
 int main(int argc, char** argv)
 {
   testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,134 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/robot_model/robot_model.h>
+#include <moveit/robot_state/robot_state.h>
+#include <moveit/robot_state/robot_state_batch.h>
+#include <moveit/utils/robot_model_test_utils.h>
+#include <gtest/gtest.h>
+
+// This test links the kernel moveit_generate_fk_kernel() generated for the panda (see CMakeLists.txt)
+
+namespace
+{
+constexpr double EPSILON{ 1.e-9 };
+}  // namespace
+
+TEST(FKKernel, Registration)
+{
+  moveit::core::RobotModelPtr panda = moveit::core::loadTestingRobotModel("panda");
+  ASSERT_TRUE(panda->getFKKernel());
+  EXPECT_EQ(panda->getFKKernel()->robot_name, "panda");
+  EXPECT_EQ(panda->getFKKernel()->model_hash, moveit::core::computeKinematicModelHash(*panda));
+  EXPECT_EQ(panda->getFKKernel()->jacobians.count("panda_arm"), 1u);
+
+  moveit::core::RobotModelPtr pr2 = moveit::core::loadTestingRobotModel("pr2");
+  EXPECT_FALSE(pr2->getFKKernel());
+  EXPECT_NE(moveit::core::computeKinematicModelHash(*pr2), moveit::core::computeKinematicModelHash(*panda));
+}
+
+TEST(FKKernel, LinkTransforms)
+{
+  moveit::core::RobotModelPtr model = moveit::core::loadTestingRobotModel("panda");
+  const moveit::core::JointModelGroup* hand = model->getJointModelGroup("hand");
+  ASSERT_TRUE(hand);
+
+  // RobotStateBatch implements forward kinematics independently of the generated kernel
+  moveit::core::RobotState state(model);
+  moveit::core::RobotStateBatch batch(model, 1);
+  const auto expect_match = [&] {
+    state.updateLinkTransforms();
+    batch.setFromRobotState(0, state);
+    batch.updateLinkTransforms();
+    for (const moveit::core::LinkModel* link : model->getLinkModels())
+      EXPECT_TRUE(state.getGlobalLinkTransform(link).isApprox(batch.getGlobalLinkTransform(0, link), EPSILON))
+          << "link " << link->getName();
+    EXPECT_TRUE(state.getGlobalLinkTransform("panda_hand").matrix().row(3).isApprox(Eigen::RowVector4d(0, 0, 0, 1)));
+  };
+
+  for (unsigned int i = 0; i < 10; ++i)
+  {
+    // the whole tree is dirty: uses the kernel
+    state.setToRandomPositions();
+    expect_match();
+    // only the hand is dirty: uses the generic implementation on top of the kernel's link transforms
+    state.setToRandomPositions(hand);
+    expect_match();
+  }
+}
+
+TEST(FKKernel, Jacobian)
+{
+  moveit::core::RobotModelPtr model = moveit::core::loadTestingRobotModel("panda");
+  const moveit::core::JointModelGroup* jmg = model->getJointModelGroup("panda_arm");
+  ASSERT_TRUE(jmg);
+  const moveit::core::LinkModel* tip = jmg->getLinkModels().back();
+  const Eigen::Vector3d reference_point(0.0, 0.0, 0.1);
+  const double delta = 1e-6;
+
+  moveit::core::RobotState state(model);
+  state.setToRandomPositions();
+  state.update();
+  Eigen::MatrixXd jacobian;
+  ASSERT_TRUE(state.getJacobian(jmg, tip, reference_point, jacobian));
+  ASSERT_EQ(jacobian.rows(), 6);
+  ASSERT_EQ(jacobian.cols(), static_cast<int>(jmg->getVariableCount()));
+
+  // compare the linear part against finite differences
+  std::vector<double> positions;
+  state.copyJointGroupPositions(jmg, positions);
+  const Eigen::Vector3d point = state.getGlobalLinkTransform(tip) * reference_point;
+  for (std::size_t i = 0; i < positions.size(); ++i)
+  {
+    moveit::core::RobotState perturbed(state);
+    std::vector<double> perturbed_positions = positions;
+    perturbed_positions[i] += delta;
+    perturbed.setJointGroupPositions(jmg, perturbed_positions);
+    perturbed.update();
+    const Eigen::Vector3d derivative = (perturbed.getGlobalLinkTransform(tip) * reference_point - point) / delta;
+    EXPECT_TRUE(jacobian.block<3, 1>(0, i).isApprox(derivative, 1e-4)) << "column " << i;
+  }
+
+  // the quaternion representation keeps working on top of the kernel
+  Eigen::MatrixXd quaternion_jacobian;
+  ASSERT_TRUE(state.getJacobian(jmg, tip, reference_point, quaternion_jacobian, true));
+  ASSERT_EQ(quaternion_jacobian.rows(), 7);
+  EXPECT_TRUE(quaternion_jacobian.topRows<3>().isApprox(jacobian.topRows<3>(), EPSILON));
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,178 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#pragma once
+
+#include <moveit/macros/class_forward.h>
+#include <moveit/robot_trajectory/robot_trajectory.h>
+#include <moveit_msgs/msg/robot_trajectory.hpp>
+#include <vector>
+
+namespace robot_trajectory
+{
+MOVEIT_CLASS_FORWARD(CompactRobotTrajectory);  // Defines CompactRobotTrajectoryPtr, ConstPtr, WeakPtr... etc
+
+/** \brief A memory-efficient sequence of waypoints and the time durations between these waypoints.
+
+    In contrast to RobotTrajectory, which keeps a full RobotState (including link transforms) per waypoint, this
+    class only stores the positions, velocities and accelerations of the variables of its group, in one contiguous
+    array per field. Variables outside the group are taken from a single reference state. A RobotState is only
+    constructed when a waypoint is explicitly requested. */
+class CompactRobotTrajectory
+{
+public:
+  /** @brief Construct a trajectory for \e group, or for the whole robot if \e group is null.
+   *  All variables outside the group are taken from \e reference_state. */
+  CompactRobotTrajectory(const moveit::core::RobotState& reference_state, const moveit::core::JointModelGroup* group);
+
+  /** @brief Copy the waypoints of \e trajectory. Its first waypoint serves as reference state. */
+  explicit CompactRobotTrajectory(const RobotTrajectory& trajectory);
+
+  const moveit::core::RobotModelConstPtr& getRobotModel() const
+  {
+    return reference_state_.getRobotModel();
+  }
+
+  const moveit::core::JointModelGroup* getGroup() const
+  {
+    return group_;
+  }
+
+  const moveit::core::RobotState& getReferenceState() const
+  {
+    return reference_state_;
+  }
+
+  /** @brief The number of variables stored per waypoint */
+  std::size_t getVariableCount() const
+  {
+    return variable_indices_.size();
+  }
+
+  /** @brief The indices of the stored variables within a RobotState */
+  const std::vector<int>& getVariableIndices() const
+  {
+    return variable_indices_;
+  }
+
+  std::size_t getWayPointCount() const
+  {
+    return duration_from_previous_.size();
+  }
+
+  bool empty() const
+  {
+    return duration_from_previous_.empty();
+  }
+
+  /** @brief Whether all waypoints have velocities, respectively accelerations */
+  bool hasVelocities() const
+  {
+    return has_velocities_;
+  }
+  bool hasAccelerations() const
+  {
+    return has_accelerations_;
+  }
+
+  /** @brief Pointers to the getVariableCount() values of a waypoint, in the order of getVariableIndices() */
+  const double* getWayPointPositions(std::size_t index) const
+  {
+    return positions_.data() + index * getVariableCount();
+  }
+  const double* getWayPointVelocities(std::size_t index) const
+  {
+    return velocities_.data() + index * getVariableCount();
+  }
+  const double* getWayPointAccelerations(std::size_t index) const
+  {
+    return accelerations_.data() + index * getVariableCount();
+  }
+
+  const std::vector<double>& getWayPointDurations() const
+  {
+    return duration_from_previous_;
+  }
+
+  double getWayPointDurationFromPrevious(std::size_t index) const
+  {
+    return duration_from_previous_[index];
+  }
+
+  double getDuration() const;
+
+  /** @brief Reserve memory for \e count waypoints */
+  void reserve(std::size_t count);
+
+  /** @brief Add a waypoint at the end of the trajectory.
+   *  @param positions getVariableCount() positions, in the order of getVariableIndices()
+   *  @param velocities If not null, getVariableCount() velocities
+   *  @param accelerations If not null, getVariableCount() accelerations
+   *  @param dt The duration from the previous waypoint */
+  CompactRobotTrajectory& addSuffixWayPoint(const double* positions, const double* velocities,
+                                            const double* accelerations, double dt);
+
+  /** @brief Add the values of the stored variables of \e state at the end of the trajectory */
+  CompactRobotTrajectory& addSuffixWayPoint(const moveit::core::RobotState& state, double dt);
+
+  CompactRobotTrajectory& clear();
+
+  /** @brief Construct the full RobotState of a waypoint from the reference state and the stored values */
+  moveit::core::RobotStatePtr getWayPoint(std::size_t index) const;
+
+  /** @brief Write the full RobotState of a waypoint into \e state, which is expected to share the robot model */
+  void getWayPoint(std::size_t index, moveit::core::RobotState& state) const;
+
+  /** @brief Construct a RobotTrajectory holding a RobotState per waypoint */
+  RobotTrajectoryPtr toRobotTrajectory() const;
+
+  /** @brief Fill a trajectory message directly from the stored arrays, without constructing RobotStates.
+   *  The output matches RobotTrajectory::getRobotTrajectoryMsg(), except that multi-DOF points only contain
+   *  transforms. */
+  void getRobotTrajectoryMsg(moveit_msgs::msg::RobotTrajectory& trajectory,
+                             const std::vector<std::string>& joint_filter = std::vector<std::string>()) const;
+
+private:
+  moveit::core::RobotState reference_state_;
+  const moveit::core::JointModelGroup* group_;
+  std::vector<int> variable_indices_;
+  bool has_velocities_;
+  bool has_accelerations_;
+  // Waypoint i occupies the range [i * getVariableCount(), (i + 1) * getVariableCount()) of each array
+  std::vector<double> positions_;
+  std::vector<double> velocities_;
+  std::vector<double> accelerations_;
+  std::vector<double> duration_from_previous_;
+};
+}  // namespace robot_trajectory
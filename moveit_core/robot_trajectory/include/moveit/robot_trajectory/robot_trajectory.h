@@ -82,6 +82,8 @@ public:
   /** @brief  Copy constructor allowing a shallow or deep copy of waypoints
    *  @param  other - RobotTrajectory to copy from
    *  @param  deepcopy - copy waypoints by value (true) or by pointer (false)?
+   *
+   *  Deep-copied waypoints are allocated from the same moveit::core::RobotStatePool as the original ones, if any.
    */
   RobotTrajectory(const RobotTrajectory& other, bool deepcopy = false);
 
@@ -240,6 +242,22 @@ public:
   RobotTrajectory& append(const RobotTrajectory& source, double dt, size_t start_index = 0,
                           size_t end_index = std::numeric_limits<std::size_t>::max());
 
+  /**
+   * \brief Replace the rest of this trajectory after \p splice_time by a time-parameterized \p segment.
+   *
+   * The segment starts at \p splice_time. During the first \p blend_duration of the segment, a quintic polynomial
+   * per variable blends from the position, velocity and acceleration of this trajectory at \p splice_time to those
+   * of the segment at \p blend_duration, so the result is continuous up to the acceleration at both ends of the
+   * blend. The waypoints of the segment inside the blend are replaced by samples of the polynomials, the later ones
+   * are appended unchanged. Neither trajectory needs to be re-timed, but the blend should be long enough to stay
+   * within the joint limits. Velocities and accelerations missing in a waypoint are taken as zero.
+   * \param splice_time - duration from start of this trajectory at which the segment starts, clamped to the duration
+   * \param segment - the new trajectory of the same robot model, usually planned from the state at \p splice_time
+   * \param blend_duration - duration of the blend from this trajectory into the segment, greater than 0
+   * \return false, leaving this trajectory unchanged, if either trajectory is empty or blend_duration is not positive
+   */
+  bool splice(double splice_time, const RobotTrajectory& segment, double blend_duration);
+
   void swap(robot_trajectory::RobotTrajectory& other);
 
   RobotTrajectory& clear()
@@ -307,6 +325,22 @@ public:
    */
   bool getStateAtDurationFromStart(const double request_duration, moveit::core::RobotStatePtr& output_state) const;
 
+  /** @brief Interpolate the positions of all variables at several durations from start in one call.
+   *
+   * Gives the same results as getStateAtDurationFromStart() for each entry of \e request_durations, but
+   * without constructing a RobotState per sample. All variables whose joints interpolate linearly, including
+   * continuous revolute joints, are blended together as one vector operation per sample; only joints with
+   * non-linear interpolation (e.g. the rotation of floating joints) fall back to JointModel::interpolate().
+   * The durations do not need to be sorted.
+   *  @param request_durations The durations from start to sample at.
+   *  @param positions Resized to request_durations.size() * RobotModel::getVariableCount(). Sample k occupies
+   *         the range [k * n, (k + 1) * n) in the variable order of the robot model, so it can be passed directly
+   *         to RobotState::setVariablePositions().
+   *  @return True if the positions were computed, false otherwise (trajectory is empty).
+   */
+  bool getPositionsAtDurationsFromStart(const std::vector<double>& request_durations,
+                                        std::vector<double>& positions) const;
+
   class Iterator
   {
     std::deque<moveit::core::RobotStatePtr>::iterator waypoint_iterator;
@@ -0,0 +1,275 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/robot_trajectory/compact_robot_trajectory.h>
+#include <rclcpp/duration.hpp>
+#include <rclcpp/time.hpp>
+#if __has_include(<tf2_eigen/tf2_eigen.hpp>)
+#include <tf2_eigen/tf2_eigen.hpp>
+#else
+#include <tf2_eigen/tf2_eigen.h>
+#endif
+#include <algorithm>
+#include <numeric>
+
+namespace robot_trajectory
+{
+namespace
+{
+moveit::core::RobotState getDefaultReferenceState(const RobotTrajectory& trajectory)
+{
+  if (!trajectory.empty())
+    return trajectory.getFirstWayPoint();
+  moveit::core::RobotState state(trajectory.getRobotModel());
+  state.setToDefaultValues();
+  return state;
+}
+}  // namespace
+
+CompactRobotTrajectory::CompactRobotTrajectory(const moveit::core::RobotState& reference_state,
+                                               const moveit::core::JointModelGroup* group)
+  : reference_state_(reference_state), group_(group), has_velocities_(true), has_accelerations_(true)
+{
+  if (group_)
+  {
+    variable_indices_ = group_->getVariableIndexList();
+  }
+  else
+  {
+    variable_indices_.resize(reference_state_.getVariableCount());
+    std::iota(variable_indices_.begin(), variable_indices_.end(), 0);
+  }
+}
+
+CompactRobotTrajectory::CompactRobotTrajectory(const RobotTrajectory& trajectory)
+  : CompactRobotTrajectory(getDefaultReferenceState(trajectory), trajectory.getGroup())
+{
+  reserve(trajectory.getWayPointCount());
+  for (std::size_t i = 0; i < trajectory.getWayPointCount(); ++i)
+    addSuffixWayPoint(trajectory.getWayPoint(i), trajectory.getWayPointDurationFromPrevious(i));
+}
+
+double CompactRobotTrajectory::getDuration() const
+{
+  return std::accumulate(duration_from_previous_.begin(), duration_from_previous_.end(), 0.0);
+}
+
+void CompactRobotTrajectory::reserve(std::size_t count)
+{
+  positions_.reserve(count * getVariableCount());
+  velocities_.reserve(count * getVariableCount());
+  accelerations_.reserve(count * getVariableCount());
+  duration_from_previous_.reserve(count);
+}
+
+CompactRobotTrajectory& CompactRobotTrajectory::addSuffixWayPoint(const double* positions, const double* velocities,
+                                                                  const double* accelerations, double dt)
+{
+  const std::size_t count = getVariableCount();
+  positions_.insert(positions_.end(), positions, positions + count);
+  has_velocities_ = has_velocities_ && velocities;
+  if (velocities)
+    velocities_.insert(velocities_.end(), velocities, velocities + count);
+  else
+    velocities_.resize(velocities_.size() + count, 0.0);
+  has_accelerations_ = has_accelerations_ && accelerations;
+  if (accelerations)
+    accelerations_.insert(accelerations_.end(), accelerations, accelerations + count);
+  else
+    accelerations_.resize(accelerations_.size() + count, 0.0);
+  duration_from_previous_.push_back(dt);
+  return *this;
+}
+
+CompactRobotTrajectory& CompactRobotTrajectory::addSuffixWayPoint(const moveit::core::RobotState& state, double dt)
+{
+  const std::size_t count = getVariableCount();
+  const std::size_t offset = positions_.size();
+  positions_.resize(offset + count);
+  velocities_.resize(offset + count, 0.0);
+  accelerations_.resize(offset + count, 0.0);
+  for (std::size_t j = 0; j < count; ++j)
+  {
+    positions_[offset + j] = state.getVariablePosition(variable_indices_[j]);
+    if (state.hasVelocities())
+      velocities_[offset + j] = state.getVariableVelocity(variable_indices_[j]);
+    if (state.hasAccelerations())
+      accelerations_[offset + j] = state.getVariableAcceleration(variable_indices_[j]);
+  }
+  has_velocities_ = has_velocities_ && state.hasVelocities();
+  has_accelerations_ = has_accelerations_ && state.hasAccelerations();
+  duration_from_previous_.push_back(dt);
+  return *this;
+}
+
+CompactRobotTrajectory& CompactRobotTrajectory::clear()
+{
+  positions_.clear();
+  velocities_.clear();
+  accelerations_.clear();
+  duration_from_previous_.clear();
+  has_velocities_ = true;
+  has_accelerations_ = true;
+  return *this;
+}
+
+moveit::core::RobotStatePtr CompactRobotTrajectory::getWayPoint(std::size_t index) const
+{
+  auto state = std::make_shared<moveit::core::RobotState>(reference_state_);
+  getWayPoint(index, *state);
+  return state;
+}
+
+void CompactRobotTrajectory::getWayPoint(std::size_t index, moveit::core::RobotState& state) const
+{
+  state = reference_state_;
+  const double* positions = getWayPointPositions(index);
+  const double* velocities = getWayPointVelocities(index);
+  const double* accelerations = getWayPointAccelerations(index);
+  for (std::size_t j = 0; j < getVariableCount(); ++j)
+  {
+    state.setVariablePosition(variable_indices_[j], positions[j]);
+    if (has_velocities_)
+      state.setVariableVelocity(variable_indices_[j], velocities[j]);
+    if (has_accelerations_)
+      state.setVariableAcceleration(variable_indices_[j], accelerations[j]);
+  }
+  state.update();
+}
+
+RobotTrajectoryPtr CompactRobotTrajectory::toRobotTrajectory() const
+{
+  auto trajectory = std::make_shared<RobotTrajectory>(getRobotModel(), group_);
+  for (std::size_t i = 0; i < getWayPointCount(); ++i)
+    trajectory->addSuffixWayPoint(getWayPoint(i), duration_from_previous_[i]);
+  return trajectory;
+}
+
+void CompactRobotTrajectory::getRobotTrajectoryMsg(moveit_msgs::msg::RobotTrajectory& trajectory,
+                                                   const std::vector<std::string>& joint_filter) const
+{
+  trajectory = moveit_msgs::msg::RobotTrajectory();
+  if (empty())
+    return;
+  const moveit::core::RobotModel& robot_model = *getRobotModel();
+  const std::vector<const moveit::core::JointModel*>& jnts =
+      group_ ? group_->getActiveJointModels() : robot_model.getActiveJointModels();
+
+  // column of each robot state variable within the stored arrays
+  std::vector<int> columns(robot_model.getVariableCount(), -1);
+  for (std::size_t j = 0; j < variable_indices_.size(); ++j)
+    columns[variable_indices_[j]] = j;
+
+  std::vector<int> onedof;
+  std::vector<const moveit::core::JointModel*> mdof;
+  for (const moveit::core::JointModel* active_joint : jnts)
+  {
+    // only consider joints listed in joint_filter
+    if (!joint_filter.empty() &&
+        std::find(joint_filter.begin(), joint_filter.end(), active_joint->getName()) == joint_filter.end())
+      continue;
+
+    if (active_joint->getVariableCount() == 1)
+    {
+      trajectory.joint_trajectory.joint_names.push_back(active_joint->getName());
+      onedof.push_back(columns[active_joint->getFirstVariableIndex()]);
+    }
+    else
+    {
+      trajectory.multi_dof_joint_trajectory.joint_names.push_back(active_joint->getName());
+      mdof.push_back(active_joint);
+    }
+  }
+
+  const std::size_t count = getWayPointCount();
+  if (!onedof.empty())
+  {
+    trajectory.joint_trajectory.header.frame_id = robot_model.getModelFrame();
+    trajectory.joint_trajectory.header.stamp = rclcpp::Time(0, 0, RCL_ROS_TIME);
+    trajectory.joint_trajectory.points.resize(count);
+  }
+  if (!mdof.empty())
+  {
+    trajectory.multi_dof_joint_trajectory.header.frame_id = robot_model.getModelFrame();
+    trajectory.multi_dof_joint_trajectory.header.stamp = rclcpp::Time(0, 0, RCL_ROS_TIME);
+    trajectory.multi_dof_joint_trajectory.points.resize(count);
+  }
+
+  std::vector<double> joint_positions;
+  Eigen::Isometry3d joint_transform;
+  double total_time = 0.0;
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    total_time += duration_from_previous_[i];
+    const rclcpp::Duration time_from_start = rclcpp::Duration::from_seconds(total_time);
+    const double* positions = getWayPointPositions(i);
+    if (!onedof.empty())
+    {
+      trajectory_msgs::msg::JointTrajectoryPoint& point = trajectory.joint_trajectory.points[i];
+      point.positions.resize(onedof.size());
+      for (std::size_t j = 0; j < onedof.size(); ++j)
+        point.positions[j] = positions[onedof[j]];
+      if (has_velocities_)
+      {
+        const double* velocities = getWayPointVelocities(i);
+        point.velocities.resize(onedof.size());
+        for (std::size_t j = 0; j < onedof.size(); ++j)
+          point.velocities[j] = velocities[onedof[j]];
+      }
+      if (has_accelerations_)
+      {
+        const double* accelerations = getWayPointAccelerations(i);
+        point.accelerations.resize(onedof.size());
+        for (std::size_t j = 0; j < onedof.size(); ++j)
+          point.accelerations[j] = accelerations[onedof[j]];
+      }
+      point.time_from_start = time_from_start;
+    }
+    if (!mdof.empty())
+    {
+      trajectory_msgs::msg::MultiDOFJointTrajectoryPoint& point = trajectory.multi_dof_joint_trajectory.points[i];
+      point.transforms.resize(mdof.size());
+      for (std::size_t j = 0; j < mdof.size(); ++j)
+      {
+        joint_positions.resize(mdof[j]->getVariableCount());
+        for (std::size_t k = 0; k < joint_positions.size(); ++k)
+          joint_positions[k] = positions[columns[mdof[j]->getFirstVariableIndex() + k]];
+        mdof[j]->computeTransform(joint_positions.data(), joint_transform);
+        point.transforms[j] = tf2::eigenToTransform(joint_transform).transform;
+      }
+      point.time_from_start = time_from_start;
+    }
+  }
+}
+}  // namespace robot_trajectory
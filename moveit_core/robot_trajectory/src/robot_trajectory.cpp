@@ -37,6 +37,8 @@
 #include <math.h>
 #include <moveit/robot_trajectory/robot_trajectory.h>
 #include <moveit/robot_state/conversions.h>
+#include <moveit/robot_model/revolute_joint_model.h>
+#include <moveit/robot_model/planar_joint_model.h>
 #include <rclcpp/duration.hpp>
 #include <rclcpp/logger.hpp>
 #include <rclcpp/logging.hpp>
@@ -46,10 +48,55 @@
 #else
 #include <tf2_eigen/tf2_eigen.h>
 #endif
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <numeric>
 
 namespace robot_trajectory
 {
+namespace
+{
+// Segment waypoints closer than this to the end of a splice blend are replaced by it
+constexpr double SPLICE_TIME_EPSILON = 1e-9;
+
+// The state at a duration from start, with velocities and accelerations interpolated linearly in time
+moveit::core::RobotState getStateWithDerivatives(const RobotTrajectory& trajectory, const double duration)
+{
+  int before = 0, after = 0;
+  double blend = 1.0;
+  trajectory.findWayPointIndicesForDurationAfterStart(duration, before, after, blend);
+  const moveit::core::RobotState& from = trajectory.getWayPoint(before);
+  const moveit::core::RobotState& to = trajectory.getWayPoint(after);
+  moveit::core::RobotState state(from);
+  from.interpolate(to, blend, state);
+  for (std::size_t i = 0; i < state.getVariableCount(); ++i)
+  {
+    const double from_velocity = from.hasVelocities() ? from.getVariableVelocity(i) : 0.0;
+    const double to_velocity = to.hasVelocities() ? to.getVariableVelocity(i) : 0.0;
+    const double from_acceleration = from.hasAccelerations() ? from.getVariableAcceleration(i) : 0.0;
+    const double to_acceleration = to.hasAccelerations() ? to.getVariableAcceleration(i) : 0.0;
+    state.setVariableVelocity(i, from_velocity + blend * (to_velocity - from_velocity));
+    state.setVariableAcceleration(i, from_acceleration + blend * (to_acceleration - from_acceleration));
+  }
+  return state;
+}
+
+// Coefficients of the quintic polynomial with the given position, velocity and acceleration at 0 and at duration
+std::array<double, 6> getQuinticCoefficients(const double p0, const double v0, const double a0, const double p1,
+                                            const double v1, const double a1, const double duration)
+{
+  const double t = duration;
+  const double distance = p1 - p0;
+  return { p0,
+           v0,
+           0.5 * a0,
+           (20.0 * distance - (8.0 * v1 + 12.0 * v0) * t - (3.0 * a0 - a1) * t * t) / (2.0 * std::pow(t, 3)),
+           (-30.0 * distance + (14.0 * v1 + 16.0 * v0) * t + (3.0 * a0 - 2.0 * a1) * t * t) / (2.0 * std::pow(t, 4)),
+           (12.0 * distance - 6.0 * (v1 + v0) * t + (a1 - a0) * t * t) / (2.0 * std::pow(t, 5)) };
+}
+}  // namespace
+
 RobotTrajectory::RobotTrajectory(const moveit::core::RobotModelConstPtr& robot_model)
   : robot_model_(robot_model), group_(nullptr)
 {
@@ -140,6 +187,97 @@ RobotTrajectory& RobotTrajectory::append(const RobotTrajectory& source, double d
   return *this;
 }
 
+bool RobotTrajectory::splice(double splice_time, const RobotTrajectory& segment, double blend_duration)
+{
+  if (waypoints_.empty() || segment.empty())
+  {
+    RCLCPP_ERROR(rclcpp::get_logger("RobotTrajectory"), "Cannot splice empty trajectories.");
+    return false;
+  }
+  if (blend_duration <= 0.0)
+  {
+    RCLCPP_ERROR(rclcpp::get_logger("RobotTrajectory"), "Invalid blend duration %f, must be greater than 0.0",
+                 blend_duration);
+    return false;
+  }
+  splice_time = std::clamp(splice_time, 0.0, getDuration());
+  const moveit::core::RobotState blend_start = getStateWithDerivatives(*this, splice_time);
+  const moveit::core::RobotState blend_end = getStateWithDerivatives(segment, blend_duration);
+
+  std::vector<int> variables;
+  if (group_)
+  {
+    variables = group_->getVariableIndexList();
+  }
+  else
+  {
+    variables.resize(robot_model_->getVariableCount());
+    std::iota(variables.begin(), variables.end(), 0);
+  }
+  std::vector<std::array<double, 6>> coefficients;
+  coefficients.reserve(variables.size());
+  for (int variable : variables)
+  {
+    coefficients.push_back(getQuinticCoefficients(
+        blend_start.getVariablePosition(variable), blend_start.getVariableVelocity(variable),
+        blend_start.getVariableAcceleration(variable), blend_end.getVariablePosition(variable),
+        blend_end.getVariableVelocity(variable), blend_end.getVariableAcceleration(variable), blend_duration));
+  }
+  // Sample the blend at t seconds into the segment, the other variables are taken from the segment state
+  auto sample_blend = [&](moveit::core::RobotState& state, const double t) {
+    for (std::size_t i = 0; i < variables.size(); ++i)
+    {
+      const std::array<double, 6>& c = coefficients[i];
+      state.setVariablePosition(variables[i],
+                                c[0] + t * (c[1] + t * (c[2] + t * (c[3] + t * (c[4] + t * c[5])))));
+      state.setVariableVelocity(variables[i],
+                                c[1] + t * (2.0 * c[2] + t * (3.0 * c[3] + t * (4.0 * c[4] + t * 5.0 * c[5]))));
+      state.setVariableAcceleration(variables[i],
+                                    2.0 * c[2] + t * (6.0 * c[3] + t * (12.0 * c[4] + t * 20.0 * c[5])));
+    }
+  };
+
+  // Keep the waypoints before the splice time, the state at the splice time starts the blend
+  double time = 0.0;
+  std::size_t kept = 0;
+  while (kept < waypoints_.size() && time + duration_from_previous_[kept] < splice_time)
+    time += duration_from_previous_[kept++];
+  waypoints_.resize(kept);
+  duration_from_previous_.resize(kept);
+  addSuffixWayPoint(blend_start, splice_time - time);
+
+  double segment_time = 0.0;
+  double previous_time = 0.0;
+  bool blend_end_added = false;
+  for (std::size_t i = 1; i < segment.getWayPointCount(); ++i)
+  {
+    segment_time += segment.getWayPointDurationFromPrevious(i);
+    if (segment_time < blend_duration - SPLICE_TIME_EPSILON)
+    {
+      auto state = std::make_shared<moveit::core::RobotState>(segment.getWayPoint(i));
+      sample_blend(*state, segment_time);
+      addSuffixWayPoint(state, segment_time - previous_time);
+      previous_time = segment_time;
+      continue;
+    }
+    if (!blend_end_added)
+    {
+      addSuffixWayPoint(blend_end, blend_duration - previous_time);
+      previous_time = blend_duration;
+      blend_end_added = true;
+    }
+    if (segment_time > blend_duration + SPLICE_TIME_EPSILON)
+    {
+      addSuffixWayPoint(segment.getWayPoint(i), segment_time - previous_time);
+      previous_time = segment_time;
+    }
+  }
+  // The blend ends after the end of the segment
+  if (!blend_end_added)
+    addSuffixWayPoint(blend_end, blend_duration - previous_time);
+  return true;
+}
+
 RobotTrajectory& RobotTrajectory::reverse()
 {
   std::reverse(waypoints_.begin(), waypoints_.end());
@@ -485,12 +623,14 @@ void RobotTrajectory::findWayPointIndicesForDurationAfterStart(const double& dur
   before = std::max<int>(index - 1, 0);
   after = std::min<int>(index, num_points - 1);
 
-  // Compute duration blend
-  double before_time = running_duration - duration_from_previous_[index];
+  // Compute duration blend; index is past the last waypoint if duration exceeds the trajectory duration
   if (after == before)
     blend = 1.0;
   else
+  {
+    double before_time = running_duration - duration_from_previous_[index];
     blend = (duration - before_time) / duration_from_previous_[index];
+  }
 }
 
 double RobotTrajectory::getWayPointDurationFromStart(std::size_t index) const
@@ -527,6 +667,97 @@ bool RobotTrajectory::getStateAtDurationFromStart(const double request_duration,
   return true;
 }
 
+bool RobotTrajectory::getPositionsAtDurationsFromStart(const std::vector<double>& request_durations,
+                                                       std::vector<double>& positions) const
+{
+  if (waypoints_.empty())
+    return false;
+
+  // Sort the active joints into variables that wrap around at +/-pi and joints that need their own
+  // interpolation; all remaining variables interpolate linearly.
+  std::vector<int> wrapping_variables;
+  std::vector<const moveit::core::JointModel*> other_joints;
+  for (const moveit::core::JointModel* joint : robot_model_->getActiveJointModels())
+  {
+    switch (joint->getType())
+    {
+      case moveit::core::JointModel::REVOLUTE:
+        if (static_cast<const moveit::core::RevoluteJointModel*>(joint)->isContinuous())
+          wrapping_variables.push_back(joint->getFirstVariableIndex());
+        break;
+      case moveit::core::JointModel::PLANAR:
+        if (static_cast<const moveit::core::PlanarJointModel*>(joint)->getMotionModel() ==
+            moveit::core::PlanarJointModel::HOLONOMIC)
+          wrapping_variables.push_back(joint->getFirstVariableIndex() + 2);
+        else
+          other_joints.push_back(joint);
+        break;
+      case moveit::core::JointModel::FLOATING:
+        other_joints.push_back(joint);
+        break;
+      default:
+        break;
+    }
+  }
+
+  // Durations from start of each waypoint, for a binary search per sample
+  std::vector<double> waypoint_times(duration_from_previous_.size());
+  std::partial_sum(duration_from_previous_.begin(), duration_from_previous_.end(), waypoint_times.begin());
+
+  const std::size_t variable_count = robot_model_->getVariableCount();
+  const int last = waypoints_.size() - 1;
+  positions.resize(request_durations.size() * variable_count);
+  for (std::size_t k = 0; k < request_durations.size(); ++k)
+  {
+    // Same waypoint selection as findWayPointIndicesForDurationAfterStart()
+    const double duration = request_durations[k];
+    int before = 0, after = 0;
+    double blend = 0.0;
+    if (duration >= 0.0)
+    {
+      int index = std::lower_bound(waypoint_times.begin(), waypoint_times.end(), duration) - waypoint_times.begin();
+      before = std::max(index - 1, 0);
+      after = std::min(index, last);
+      blend = (after == before) ? 1.0 : (duration - waypoint_times[index] + duration_from_previous_[index]) /
+                                            duration_from_previous_[index];
+    }
+
+    const double* from = waypoints_[before]->getVariablePositions();
+    const double* to = waypoints_[after]->getVariablePositions();
+    double* sample = positions.data() + k * variable_count;
+    Eigen::Map<Eigen::VectorXd> result(sample, variable_count);
+    if (before == after)
+    {
+      result = Eigen::Map<const Eigen::VectorXd>(to, variable_count);
+      continue;
+    }
+
+    const Eigen::Map<const Eigen::VectorXd> from_vector(from, variable_count);
+    result = from_vector + blend * (Eigen::Map<const Eigen::VectorXd>(to, variable_count) - from_vector);
+
+    // take the short way around for wrapping variables, as RevoluteJointModel::interpolate() does
+    for (int index : wrapping_variables)
+    {
+      double diff = to[index] - from[index];
+      if (fabs(diff) <= M_PI)
+        continue;
+      diff += (diff > 0.0) ? -2.0 * M_PI : 2.0 * M_PI;
+      sample[index] = from[index] + diff * blend;
+      if (sample[index] > M_PI)
+        sample[index] -= 2.0 * M_PI;
+      else if (sample[index] < -M_PI)
+        sample[index] += 2.0 * M_PI;
+    }
+    for (const moveit::core::JointModel* joint : other_joints)
+    {
+      const int index = joint->getFirstVariableIndex();
+      joint->interpolate(from + index, to + index, blend, sample + index);
+    }
+    robot_model_->updateMimicJoints(sample);
+  }
+  return true;
+}
+
 void RobotTrajectory::print(std::ostream& out, std::vector<int> variable_indexes) const
 {
   size_t num_points = getWayPointCount();
@@ -36,6 +36,7 @@
 
 #include <moveit/robot_model/robot_model.h>
 #include <moveit/robot_state/robot_state.h>
+#include <moveit/robot_trajectory/compact_robot_trajectory.h>
 #include <moveit/robot_trajectory/robot_trajectory.h>
 #include <moveit/utils/robot_model_test_utils.h>
 #include <gtest/gtest.h>
@@ -297,6 +298,123 @@ TEST_F(RobotTrajectoryTestFixture, RobotTrajectoryIterator)
   EXPECT_EQ(++(++(++(++(++trajectory->begin())))), trajectory->end());
 }
 
+TEST_F(RobotTrajectoryTestFixture, InterpolatePositionsInBulk)
+{
+  auto trajectory = std::make_shared<robot_trajectory::RobotTrajectory>(robot_model_, arm_jmg_name_);
+  moveit::core::RobotState waypoint(*robot_state_);
+  const std::vector<double> durations_from_previous = { 0.0, 0.1, 0.25, 0.05, 0.3 };
+  for (double duration_from_previous : durations_from_previous)
+  {
+    waypoint.setToRandomPositions();
+    trajectory->addSuffixWayPoint(waypoint, duration_from_previous);
+  }
+
+  // unsorted, including samples before the start, on waypoints and past the end
+  const std::vector<double> request_durations = { 0.42, -0.1, 0.0, 0.1, 0.2, 0.35, 0.7, 0.01, 5.0 };
+  std::vector<double> positions;
+  ASSERT_TRUE(trajectory->getPositionsAtDurationsFromStart(request_durations, positions));
+  const std::size_t variable_count = robot_model_->getVariableCount();
+  ASSERT_EQ(positions.size(), request_durations.size() * variable_count);
+
+  auto expected = std::make_shared<moveit::core::RobotState>(robot_model_);
+  for (std::size_t k = 0; k < request_durations.size(); ++k)
+  {
+    ASSERT_TRUE(trajectory->getStateAtDurationFromStart(request_durations[k], expected));
+    for (std::size_t i = 0; i < variable_count; ++i)
+      EXPECT_NEAR(positions[k * variable_count + i], expected->getVariablePosition(i), 1e-12)
+          << "duration " << request_durations[k] << ", variable " << robot_model_->getVariableNames()[i];
+  }
+
+  robot_trajectory::RobotTrajectory empty(robot_model_, arm_jmg_name_);
+  EXPECT_FALSE(empty.getPositionsAtDurationsFromStart(request_durations, positions));
+}
+
+TEST_F(RobotTrajectoryTestFixture, CompactRobotTrajectory)
+{
+  auto trajectory = std::make_shared<robot_trajectory::RobotTrajectory>(robot_model_, arm_jmg_name_);
+  moveit::core::RobotState waypoint(*robot_state_);
+  for (double duration_from_previous : { 0.0, 0.1, 0.25, 0.05 })
+  {
+    waypoint.setToRandomPositions(robot_model_->getJointModelGroup(arm_jmg_name_));
+    trajectory->addSuffixWayPoint(waypoint, duration_from_previous);
+  }
+
+  const robot_trajectory::CompactRobotTrajectory compact(*trajectory);
+  ASSERT_EQ(compact.getWayPointCount(), trajectory->getWayPointCount());
+  EXPECT_EQ(compact.getVariableCount(), robot_model_->getJointModelGroup(arm_jmg_name_)->getVariableCount());
+  EXPECT_DOUBLE_EQ(compact.getDuration(), trajectory->getDuration());
+  EXPECT_TRUE(compact.hasVelocities());
+  EXPECT_TRUE(compact.hasAccelerations());
+
+  // Reconstructed waypoints match the original ones
+  for (std::size_t i = 0; i < trajectory->getWayPointCount(); ++i)
+  {
+    const moveit::core::RobotStatePtr state = compact.getWayPoint(i);
+    for (std::size_t j = 0; j < robot_model_->getVariableCount(); ++j)
+    {
+      EXPECT_EQ(state->getVariablePosition(j), trajectory->getWayPoint(i).getVariablePosition(j));
+      EXPECT_EQ(state->getVariableVelocity(j), trajectory->getWayPoint(i).getVariableVelocity(j));
+    }
+  }
+
+  // The message matches the one generated from the full trajectory
+  moveit_msgs::msg::RobotTrajectory expected_msg, msg;
+  trajectory->getRobotTrajectoryMsg(expected_msg);
+  compact.getRobotTrajectoryMsg(msg);
+  EXPECT_EQ(msg.joint_trajectory, expected_msg.joint_trajectory);
+  EXPECT_EQ(msg.multi_dof_joint_trajectory, expected_msg.multi_dof_joint_trajectory);
+
+  EXPECT_EQ(compact.toRobotTrajectory()->getWayPointCount(), trajectory->getWayPointCount());
+}
+
+TEST_F(RobotTrajectoryTestFixture, Splice)
+{
+  // The active trajectory moves the first joint at constant velocity, the new segment ends at rest
+  robot_trajectory::RobotTrajectory trajectory(robot_model_, arm_jmg_name_);
+  robot_trajectory::RobotTrajectory segment(robot_model_, arm_jmg_name_);
+  moveit::core::RobotState waypoint(*robot_state_);
+  waypoint.zeroAccelerations();
+  for (std::size_t i = 0; i <= 10; ++i)
+  {
+    waypoint.setVariablePosition(0, 0.1 * i);
+    waypoint.setVariableVelocity(0, 1.0);
+    trajectory.addSuffixWayPoint(waypoint, i == 0 ? 0.0 : 0.1);
+  }
+  waypoint.zeroVelocities();
+  for (std::size_t i = 0; i <= 100; ++i)
+  {
+    waypoint.setVariablePosition(0, 0.8);
+    segment.addSuffixWayPoint(waypoint, i == 0 ? 0.0 : 0.01);
+  }
+
+  EXPECT_FALSE(trajectory.splice(0.55, segment, 0.0));
+  ASSERT_TRUE(trajectory.splice(0.55, segment, 0.2));
+  EXPECT_NEAR(trajectory.getDuration(), 0.55 + segment.getDuration(), 1e-9);
+
+  // The blend starts from the state of the active trajectory at the splice time
+  const std::size_t splice_index = 6;
+  EXPECT_NEAR(trajectory.getWayPointDurationFromStart(splice_index), 0.55, 1e-9);
+  EXPECT_NEAR(trajectory.getWayPoint(splice_index).getVariablePosition(0), 0.55, 1e-9);
+  EXPECT_NEAR(trajectory.getWayPoint(splice_index).getVariableVelocity(0), 1.0, 1e-9);
+  EXPECT_NEAR(trajectory.getWayPoint(splice_index).getVariableAcceleration(0), 0.0, 1e-9);
+
+  // Neighboring samples of the blend are continuous up to the acceleration, at both ends
+  const moveit::core::RobotState& after_start = trajectory.getWayPoint(splice_index + 1);
+  EXPECT_NEAR(after_start.getVariablePosition(0), 0.56, 1e-3);
+  EXPECT_NEAR(after_start.getVariableVelocity(0), 1.0, 0.1);
+  const std::size_t blend_end_index = splice_index + 20;
+  EXPECT_NEAR(trajectory.getWayPointDurationFromStart(blend_end_index), 0.75, 1e-9);
+  const moveit::core::RobotState& before_end = trajectory.getWayPoint(blend_end_index - 1);
+  EXPECT_NEAR(before_end.getVariablePosition(0), 0.8, 1e-3);
+  EXPECT_NEAR(before_end.getVariableVelocity(0), 0.0, 0.1);
+  for (std::size_t i = blend_end_index; i < trajectory.getWayPointCount(); ++i)
+  {
+    EXPECT_NEAR(trajectory.getWayPoint(i).getVariablePosition(0), 0.8, 1e-9);
+    EXPECT_NEAR(trajectory.getWayPoint(i).getVariableVelocity(0), 0.0, 1e-9);
+    EXPECT_NEAR(trajectory.getWayPoint(i).getVariableAcceleration(0), 0.0, 1e-9);
+  }
+}
+
 int main(int argc, char** argv)
 {
   testing::InitGoogleTest(&argc, argv);
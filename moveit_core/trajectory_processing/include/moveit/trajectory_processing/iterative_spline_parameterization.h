@@ -72,6 +72,41 @@ namespace trajectory_processing
 class IterativeSplineParameterization : public TimeParameterization
 {
 public:
+  /// @brief Scratch memory of computeTimeStamps().
+  /// The positions, velocities and accelerations of all joints are stored in one column-major buffer each,
+  /// so a workspace that is reused for several calls only allocates when a trajectory is longer than all before.
+  /// A workspace must not be used by several threads at once.
+  class Workspace
+  {
+  private:
+    friend class IterativeSplineParameterization;
+
+    /// @brief Boundary conditions and scaled bounds of a single joint
+    struct JointParameters
+    {
+      double initial_acceleration_;
+      double final_acceleration_;
+      double min_velocity_;
+      double max_velocity_;
+      double min_acceleration_;
+      double max_acceleration_;
+    };
+
+    void resize(std::size_t num_points, std::size_t num_joints);
+
+    std::vector<JointParameters> joints_;
+    // joint j occupies the range [j * num_points, (j + 1) * num_points)
+    std::vector<double> positions_;
+    std::vector<double> velocities_;
+    std::vector<double> accelerations_;
+    std::vector<double> time_diff_;
+    std::vector<double> time_factor_;
+    // Coefficients of the tridiagonal spline system, they only depend on the time intervals which all joints share
+    std::vector<double> spline_c_;
+    std::vector<double> spline_a_;
+    std::vector<double> spline_denom_;
+  };
+
   IterativeSplineParameterization(bool add_points = true);
 
   bool computeTimeStamps(robot_trajectory::RobotTrajectory& trajectory, const double max_velocity_scaling_factor = 1.0,
@@ -81,7 +116,34 @@ public:
                          const std::unordered_map<std::string, double>& velocity_limits,
                          const std::unordered_map<std::string, double>& acceleration_limits) const override;
 
+  /// @brief Compute the time stamps of a trajectory using caller-provided scratch memory
+  bool computeTimeStamps(robot_trajectory::RobotTrajectory& trajectory, Workspace& workspace,
+                         const double max_velocity_scaling_factor = 1.0,
+                         const double max_acceleration_scaling_factor = 1.0) const;
+
+  /// @brief Compute the time stamps of many trajectories concurrently.
+  /// The limits of each group are looked up in the robot model only once for all of its trajectories.
+  /// @return Whether the time parameterization of each trajectory succeeded
+  std::vector<bool> computeTimeStamps(const std::vector<robot_trajectory::RobotTrajectoryPtr>& trajectories,
+                                      const std::vector<double>& max_velocity_scaling_factors,
+                                      const std::vector<double>& max_acceleration_scaling_factors) const;
+
 private:
+  /// @brief Unscaled velocity and acceleration bounds of a single joint
+  struct JointLimits
+  {
+    double min_velocity_;
+    double max_velocity_;
+    double min_acceleration_;
+    double max_acceleration_;
+  };
+
+  static std::vector<JointLimits> getJointLimits(const moveit::core::JointModelGroup& group);
+
+  bool computeTimeStamps(robot_trajectory::RobotTrajectory& trajectory, const std::vector<JointLimits>& limits,
+                         Workspace& workspace, const double max_velocity_scaling_factor,
+                         const double max_acceleration_scaling_factor) const;
+
   bool add_points_;  /// @brief If true, add two points to trajectory (first and last segments).
                      /// If false, move the 2nd and 2nd-last points.
 };
@@ -37,6 +37,7 @@
 
 #include <Eigen/Core>
 #include <list>
+#include <vector>
 #include <moveit/robot_trajectory/robot_trajectory.h>
 #include <ruckig/ruckig.hpp>
 
@@ -54,6 +55,17 @@ public:
                              const std::unordered_map<std::string, double>& acceleration_limits,
                              const std::unordered_map<std::string, double>& jerk_limits);
 
+  /**
+   * \brief Smooth many trajectories concurrently. The limits of each group are looked up in the RobotModel only once.
+   * \param[in, out] trajectories      Trajectories to smooth.
+   * \param max_velocity_scaling_factors      Velocity scaling factor of each trajectory.
+   * \param max_acceleration_scaling_factors      Acceleration scaling factor of each trajectory.
+   * \return Whether smoothing succeeded for each trajectory.
+   */
+  static std::vector<bool> applySmoothing(const std::vector<robot_trajectory::RobotTrajectoryPtr>& trajectories,
+                                          const std::vector<double>& max_velocity_scaling_factors,
+                                          const std::vector<double>& max_acceleration_scaling_factors);
+
 private:
   /**
    * \brief A utility function to check if the group is defined.
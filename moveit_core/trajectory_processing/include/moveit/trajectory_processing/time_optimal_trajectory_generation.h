@@ -40,53 +40,50 @@
 
 #include <Eigen/Core>
 #include <list>
+#include <optional>
+#include <vector>
 #include <moveit/robot_trajectory/robot_trajectory.h>
 #include <moveit/trajectory_processing/time_parameterization.h>
 
 namespace trajectory_processing
 {
-class PathSegment
+/// @brief A linear or circular segment of a Path, its vectors are stored in the columns of the Path
+struct PathSegment
 {
-public:
-  PathSegment(double length = 0.0) : length_(length)
-  {
-  }
-  virtual ~PathSegment()  // is required for destructing derived classes
-  {
-  }
-  double getLength() const
-  {
-    return length_;
-  }
-  virtual Eigen::VectorXd getConfig(double s) const = 0;
-  virtual Eigen::VectorXd getTangent(double s) const = 0;
-  virtual Eigen::VectorXd getCurvature(double s) const = 0;
-  virtual std::list<double> getSwitchingPoints() const = 0;
-  virtual PathSegment* clone() const = 0;
-
+  bool circular_;
   double position_;
-
-protected:
   double length_;
+  double radius_;
+  /// first of the three columns of this segment: start, end and direction if linear, center, x and y if circular
+  Eigen::Index column_;
 };
 
 class Path
 {
 public:
   Path(const std::list<Eigen::VectorXd>& path, double max_deviation = 0.0);
-  Path(const Path& path);
   double getLength() const;
   Eigen::VectorXd getConfig(double s) const;
   Eigen::VectorXd getTangent(double s) const;
   Eigen::VectorXd getCurvature(double s) const;
+  /// @brief Versions of the getters above which write into a preallocated vector of the path's dimension
+  void getConfig(double s, Eigen::Ref<Eigen::VectorXd> config) const;
+  void getTangent(double s, Eigen::Ref<Eigen::VectorXd> tangent) const;
+  void getCurvature(double s, Eigen::Ref<Eigen::VectorXd> curvature) const;
   double getNextSwitchingPoint(double s, bool& discontinuity) const;
-  std::list<std::pair<double, bool>> getSwitchingPoints() const;
+  const std::vector<std::pair<double, bool>>& getSwitchingPoints() const;
+  /// @brief The segments of the path and the index of the one at path position s
+  const std::vector<PathSegment>& getPathSegments() const;
+  std::size_t getPathSegmentIndex(double s) const;
+  /// @brief The vectors of all segments, see PathSegment::column_
+  const Eigen::MatrixXd& getSegmentVectors() const;
 
 private:
-  PathSegment* getPathSegment(double& s) const;
+  const PathSegment& getPathSegment(double& s) const;
   double length_;
-  std::list<std::pair<double, bool>> switching_points_;
-  std::list<std::unique_ptr<PathSegment>> path_segments_;
+  std::vector<std::pair<double, bool>> switching_points_;
+  std::vector<PathSegment> path_segments_;
+  Eigen::MatrixXd segment_vectors_;
 };
 
 class Trajectory
@@ -143,6 +140,12 @@ private:
   double getVelocityMaxPathVelocity(double path_pos) const;
   double getAccelerationMaxPathVelocityDeriv(double path_pos);
   double getVelocityMaxPathVelocityDeriv(double path_pos);
+  /// @brief Evaluate the limit curves for the given path tangent and curvature
+  double computeAccelerationMaxPathVelocity(const Eigen::VectorXd& config_deriv,
+                                            const Eigen::VectorXd& config_deriv2) const;
+  double computeVelocityMaxPathVelocity(const Eigen::VectorXd& tangent) const;
+  /// @brief Fill segment_limits_ for all segments of the path
+  void computeSegmentLimits();
 
   std::list<TrajectoryStep>::const_iterator getTrajectorySegment(double time) const;
 
@@ -158,12 +161,62 @@ private:
 
   mutable double cached_time_;
   mutable std::list<TrajectoryStep>::const_iterator cached_trajectory_segment_;
+
+  // Preallocated path tangent and curvature for the limit computations
+  mutable Eigen::VectorXd config_deriv_;
+  mutable Eigen::VectorXd config_deriv2_;
+  // Preallocated per-joint terms of computeAccelerationMaxPathVelocity()
+  mutable Eigen::ArrayXd curvature_ratio_;
+  mutable Eigen::ArrayXd acceleration_ratio_;
+
+  /// The limit curves are constant along linear segments, so they are computed once per segment before integrating
+  struct SegmentLimits
+  {
+    bool constant_;
+    double velocity_max_path_velocity_;
+  };
+  std::vector<SegmentLimits> segment_limits_;
 };
 
 MOVEIT_CLASS_FORWARD(TimeOptimalTrajectoryGeneration);
 class TimeOptimalTrajectoryGeneration : public TimeParameterization
 {
+private:
+  /// Limits of the variables of a group, variables without limits in the model keep their default
+  struct GroupLimits
+  {
+    Eigen::ArrayXd max_velocity_;
+    Eigen::ArrayXd max_acceleration_;
+    Eigen::Array<bool, Eigen::Dynamic, 1> velocity_bounded_;
+    Eigen::Array<bool, Eigen::Dynamic, 1> acceleration_bounded_;
+  };
+
 public:
+  /**
+   * @brief The geometric path and the last phase-plane solution of one trajectory
+   *
+   * Filled by the first computeTimeStamps() call it is passed to. Later calls with the same cache re-time the cached
+   * path and ignore the waypoints of the trajectory, so call clear() before using it for a different trajectory.
+   * A cache must not be used by several threads at once.
+   */
+  class Cache
+  {
+  public:
+    /// @brief Forget the cached path, e.g. to use the cache for another trajectory
+    void clear();
+    bool empty() const;
+
+  private:
+    friend class TimeOptimalTrajectoryGeneration;
+    const moveit::core::JointModelGroup* group_ = nullptr;
+    GroupLimits limits_;
+    std::optional<moveit::core::RobotState> reference_waypoint_;
+    std::optional<Path> path_;  // unset if the trajectory consists of a single diverse waypoint
+    std::optional<Trajectory> trajectory_;
+    double velocity_scaling_factor_ = 0.0;
+    double acceleration_scaling_factor_ = 0.0;
+  };
+
   TimeOptimalTrajectoryGeneration(const double path_tolerance = 0.1, const double resample_dt = 0.1,
                                   const double min_angle_change = 0.001);
 
@@ -174,11 +227,60 @@ public:
                          const std::unordered_map<std::string, double>& velocity_limits,
                          const std::unordered_map<std::string, double>& acceleration_limits) const override;
 
+  /**
+   * @brief Compute the time stamps of many trajectories concurrently
+   *
+   * The limits of each group are looked up in the robot model only once for all of its trajectories.
+   * @param trajectories The trajectories to parameterize in place
+   * @param max_velocity_scaling_factors The velocity scaling factor of each trajectory
+   * @param max_acceleration_scaling_factors The acceleration scaling factor of each trajectory
+   * @return Whether the time parameterization of each trajectory succeeded
+   */
+  std::vector<bool> computeTimeStamps(const std::vector<robot_trajectory::RobotTrajectoryPtr>& trajectories,
+                                      const std::vector<double>& max_velocity_scaling_factors,
+                                      const std::vector<double>& max_acceleration_scaling_factors) const;
+
+  /**
+   * @brief Compute the time stamps of a trajectory, reusing the path cached from previous calls
+   *
+   * Meant for changing the scaling factors of an already parameterized trajectory, e.g. for a speed override.
+   * Only the first call builds the path from the waypoints of the trajectory. If the acceleration scaling changes
+   * with the square of the velocity scaling and all limits are defined in the model, the cached solution is only
+   * stretched in time, which is exact. Otherwise only the phase-plane integration is repeated on the cached path.
+   * @param trajectory The trajectory to parameterize, its waypoints are replaced by the resampled result
+   * @param cache The cache of this trajectory, filled by the first call
+   * @param max_velocity_scaling_factor The velocity scaling factor
+   * @param max_acceleration_scaling_factor The acceleration scaling factor
+   * @return Whether the time parameterization succeeded
+   */
+  bool computeTimeStamps(robot_trajectory::RobotTrajectory& trajectory, Cache& cache,
+                         const double max_velocity_scaling_factor = 1.0,
+                         const double max_acceleration_scaling_factor = 1.0) const;
+
 private:
+  static bool getGroupLimits(const moveit::core::JointModelGroup& group, GroupLimits& limits);
+
+  /// Scale the limits that are defined in the model, the default limits stay unscaled
+  static void getScaledLimits(const GroupLimits& limits, const double velocity_scaling_factor,
+                              const double acceleration_scaling_factor, Eigen::VectorXd& max_velocity,
+                              Eigen::VectorXd& max_acceleration);
+
+  bool computeTimeStamps(robot_trajectory::RobotTrajectory& trajectory, const GroupLimits& limits,
+                         const double max_velocity_scaling_factor, const double max_acceleration_scaling_factor) const;
+
   bool doTimeParameterizationCalculations(robot_trajectory::RobotTrajectory& trajectory,
                                           const Eigen::VectorXd& max_velocity,
                                           const Eigen::VectorXd& max_acceleration) const;
 
+  /// Collect the group positions of the waypoints, without repeated points
+  void getPathPoints(const robot_trajectory::RobotTrajectory& trajectory, std::list<Eigen::VectorXd>& points) const;
+
+  /** Replace the waypoints of the trajectory with samples of the parameterized trajectory, played back time_scale
+      times faster. Variables outside the group are taken from reference_waypoint. */
+  void sampleTrajectory(const Trajectory& parameterized, double time_scale,
+                        const moveit::core::RobotState& reference_waypoint,
+                        robot_trajectory::RobotTrajectory& trajectory) const;
+
   const double path_tolerance_;
   const double resample_dt_;
   const double min_angle_change_;
@@ -0,0 +1,62 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#pragma once
+
+#include <moveit/robot_trajectory/robot_trajectory.h>
+#include <trajectory_msgs/msg/joint_trajectory.hpp>
+
+namespace trajectory_processing
+{
+/** \brief Resample a trajectory at a fixed period in a single sweep over its waypoints.
+ *
+ *  Only the single-DOF active joints of the trajectory's group (or of the whole robot without a group) are written.
+ *  Samples are taken every \e period seconds from the start, the end of the trajectory is always sampled as well.
+ *  Positions are interpolated with JointModel::interpolate(), velocities and accelerations linearly, if all
+ *  waypoints have them. The points of \e joint_trajectory are reused, so no memory is allocated once it has been
+ *  filled with a trajectory of the same size before.
+ *  \return False if the trajectory is empty or the period is not positive */
+bool resampleTrajectory(const robot_trajectory::RobotTrajectory& trajectory, const double period,
+                        trajectory_msgs::msg::JointTrajectory& joint_trajectory);
+
+/** \brief Replace the waypoints of a trajectory by samples taken every \e period seconds, see above.
+ *  All joints are interpolated, including multi-DOF joints.
+ *  \return False if the trajectory is empty or the period is not positive */
+bool resampleTrajectory(robot_trajectory::RobotTrajectory& trajectory, const double period);
+
+/** \brief Remove the waypoints that deviate at most \e tolerance from the linear interpolation between the waypoints
+ *  that are kept, in every variable of the trajectory's group. The first and the last waypoint are always kept.
+ *  \return The number of removed waypoints */
+std::size_t decimateTrajectory(robot_trajectory::RobotTrajectory& trajectory, const double tolerance);
+}  // namespace trajectory_processing
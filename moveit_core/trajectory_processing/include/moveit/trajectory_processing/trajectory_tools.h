@@ -36,10 +36,17 @@
 
 #pragma once
 
+#include <functional>
+#include <vector>
+
 #include <moveit_msgs/msg/robot_trajectory.hpp>
 
 namespace trajectory_processing
 {
 bool isTrajectoryEmpty(const moveit_msgs::msg::RobotTrajectory& trajectory);
 std::size_t trajectoryWaypointCount(const moveit_msgs::msg::RobotTrajectory& trajectory);
+
+/** \brief Call process(i) for every i in [0, count) on up to std::thread::hardware_concurrency() threads.
+ *  \return The result of every call, in order */
+std::vector<bool> processConcurrently(std::size_t count, const std::function<bool(std::size_t)>& process);
 }  // namespace trajectory_processing
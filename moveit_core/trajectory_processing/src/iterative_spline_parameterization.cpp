@@ -35,9 +35,13 @@
 /* Author: Ken Anderson */
 
 #include <moveit/trajectory_processing/iterative_spline_parameterization.h>
+#include <moveit/trajectory_processing/trajectory_tools.h>
 #include <moveit/robot_state/conversions.h>
 #include <rclcpp/logger.hpp>
 #include <rclcpp/logging.hpp>
+#include <algorithm>
+#include <limits>
+#include <map>
 #include <vector>
 
 static const double VLIMIT = 1.0;  // default if not specified in model
@@ -48,30 +52,29 @@ namespace trajectory_processing
 static const rclcpp::Logger LOGGER =
     rclcpp::get_logger("moveit_trajectory_processing.iterative_spline_parameterization");
 
-static void fit_cubic_spline(const int n, const double dt[], const double x[], double x1[], double x2[]);
-static void adjust_two_positions(const int n, const double dt[], double x[], double x1[], double x2[],
-                                 const double x2_i, const double x2_f);
+static void compute_spline_coefficients(const int n, const double dt[], double c[], double a[], double denom[]);
+static void fit_cubic_spline(const int n, const double dt[], const double c[], const double a[], const double denom[],
+                             const double x[], double x1[], double x2[]);
+static void adjust_two_positions(const int n, const double dt[], const double c[], const double a[],
+                                 const double denom[], double x[], double x1[], double x2[], const double x2_i,
+                                 const double x2_f);
 static void init_times(const int n, double dt[], const double x[], const double max_velocity, const double min_velocity);
 static double global_adjustment_factor(const int n, double x1[], double x2[], const double max_velocity,
                                        const double min_velocity, const double max_acceleration,
                                        const double min_acceleration);
 
-// The path of a single joint: positions, velocities, and accelerations
-struct SingleJointTrajectory
+void IterativeSplineParameterization::Workspace::resize(std::size_t num_points, std::size_t num_joints)
 {
-  std::vector<double> positions_;  // joint's position at time[x]
-  std::vector<double> velocities_;
-  std::vector<double> accelerations_;
-  double initial_acceleration_;
-  double final_acceleration_;
-  double min_velocity_;
-  double max_velocity_;
-  double min_acceleration_;
-  double max_acceleration_;
-};
-
-void globalAdjustment(std::vector<SingleJointTrajectory>& t2, robot_trajectory::RobotTrajectory& trajectory,
-                      std::vector<double>& time_diff);
+  joints_.resize(num_joints);
+  positions_.resize(num_points * num_joints);
+  velocities_.assign(num_points * num_joints, 0.0);
+  accelerations_.assign(num_points * num_joints, 0.0);
+  time_diff_.assign(num_points - 1, std::numeric_limits<double>::epsilon());
+  time_factor_.resize(num_points - 1);
+  spline_c_.resize(num_points);
+  spline_a_.resize(num_points);
+  spline_denom_.resize(num_points);
+}
 
 IterativeSplineParameterization::IterativeSplineParameterization(bool add_points) : add_points_(add_points)
 {
@@ -91,9 +94,108 @@ bool IterativeSplineParameterization::computeTimeStamps(robot_trajectory::RobotT
                          "the group the plan was computed for");
     return false;
   }
-  const moveit::core::RobotModel& rmodel = group->getParentModel();
+  Workspace workspace;
+  return computeTimeStamps(trajectory, getJointLimits(*group), workspace, max_velocity_scaling_factor,
+                           max_acceleration_scaling_factor);
+}
+
+bool IterativeSplineParameterization::computeTimeStamps(robot_trajectory::RobotTrajectory& trajectory,
+                                                        Workspace& workspace,
+                                                        const double max_velocity_scaling_factor,
+                                                        const double max_acceleration_scaling_factor) const
+{
+  if (trajectory.empty())
+    return true;
+
+  const moveit::core::JointModelGroup* group = trajectory.getGroup();
+  if (!group)
+  {
+    RCLCPP_ERROR(LOGGER, "It looks like the planner did not set "
+                         "the group the plan was computed for");
+    return false;
+  }
+  return computeTimeStamps(trajectory, getJointLimits(*group), workspace, max_velocity_scaling_factor,
+                           max_acceleration_scaling_factor);
+}
+
+std::vector<bool> IterativeSplineParameterization::computeTimeStamps(
+    const std::vector<robot_trajectory::RobotTrajectoryPtr>& trajectories,
+    const std::vector<double>& max_velocity_scaling_factors,
+    const std::vector<double>& max_acceleration_scaling_factors) const
+{
+  if (max_velocity_scaling_factors.size() != trajectories.size() ||
+      max_acceleration_scaling_factors.size() != trajectories.size())
+  {
+    RCLCPP_ERROR(LOGGER, "Expected a velocity and an acceleration scaling factor for each trajectory");
+    return std::vector<bool>(trajectories.size(), false);
+  }
+
+  // Look up the limits of each group only once
+  std::map<const moveit::core::JointModelGroup*, std::vector<JointLimits>> group_limits;
+  for (const robot_trajectory::RobotTrajectoryPtr& trajectory : trajectories)
+  {
+    const moveit::core::JointModelGroup* group = trajectory->getGroup();
+    if (group && group_limits.find(group) == group_limits.end())
+      group_limits[group] = getJointLimits(*group);
+  }
+
+  return processConcurrently(trajectories.size(), [&](std::size_t i) {
+    robot_trajectory::RobotTrajectory& trajectory = *trajectories[i];
+    if (trajectory.empty())
+      return true;
+    if (!trajectory.getGroup())
+    {
+      RCLCPP_ERROR(LOGGER, "It looks like the planner did not set "
+                           "the group the plan was computed for");
+      return false;
+    }
+    Workspace workspace;
+    return computeTimeStamps(trajectory, group_limits.at(trajectory.getGroup()), workspace,
+                             max_velocity_scaling_factors[i], max_acceleration_scaling_factors[i]);
+  });
+}
+
+std::vector<IterativeSplineParameterization::JointLimits>
+IterativeSplineParameterization::getJointLimits(const moveit::core::JointModelGroup& group)
+{
+  const moveit::core::RobotModel& rmodel = group.getParentModel();
+  const std::vector<std::string>& vars = group.getVariableNames();
+  std::vector<JointLimits> limits(vars.size());
+  for (std::size_t j = 0; j < vars.size(); ++j)
+  {
+    // Set bounds based on model, or default limits
+    const moveit::core::VariableBounds& bounds = rmodel.getVariableBounds(vars[j]);
+    limits[j].max_velocity_ = VLIMIT;
+    limits[j].min_velocity_ = -VLIMIT;
+    if (bounds.velocity_bounded_)
+    {
+      limits[j].max_velocity_ = bounds.max_velocity_;
+      limits[j].min_velocity_ = bounds.min_velocity_;
+      if (limits[j].min_velocity_ == 0.0)
+        limits[j].min_velocity_ = -limits[j].max_velocity_;
+    }
+
+    limits[j].max_acceleration_ = ALIMIT;
+    limits[j].min_acceleration_ = -ALIMIT;
+    if (bounds.acceleration_bounded_)
+    {
+      limits[j].max_acceleration_ = bounds.max_acceleration_;
+      limits[j].min_acceleration_ = bounds.min_acceleration_;
+      if (limits[j].min_acceleration_ == 0.0)
+        limits[j].min_acceleration_ = -limits[j].max_acceleration_;
+    }
+  }
+  return limits;
+}
+
+bool IterativeSplineParameterization::computeTimeStamps(robot_trajectory::RobotTrajectory& trajectory,
+                                                        const std::vector<JointLimits>& limits,
+                                                        Workspace& workspace,
+                                                        const double max_velocity_scaling_factor,
+                                                        const double max_acceleration_scaling_factor) const
+{
+  const moveit::core::JointModelGroup* group = trajectory.getGroup();
   const std::vector<int>& idx = group->getVariableIndexList();
-  const std::vector<std::string>& vars = group->getVariableNames();
   double velocity_scaling_factor = 1.0;
   double acceleration_scaling_factor = 1.0;
   unsigned int num_points = trajectory.getWayPointCount();
@@ -160,114 +262,91 @@ bool IterativeSplineParameterization::computeTimeStamps(robot_trajectory::RobotT
     }
   }
 
+  // Error check
+  if (num_points < 4)
+  {
+    RCLCPP_ERROR(LOGGER, "number of waypoints %d, needs to be greater than 3.\n", num_points);
+    return false;
+  }
+
   // JointTrajectory indexes in [point][joint] order.
   // We need [joint][point] order to solve efficiently,
-  // so convert form here.
-
-  std::vector<SingleJointTrajectory> t2(num_joints);
+  // so convert into the column-major buffers of the workspace.
+  workspace.resize(num_points, num_joints);
+  const moveit::core::RobotState& first_waypoint = trajectory.getWayPoint(0);
+  const moveit::core::RobotState& last_waypoint = trajectory.getWayPoint(num_points - 1);
+  for (unsigned int i = 0; i < num_points; ++i)
+  {
+    const moveit::core::RobotState& waypoint = trajectory.getWayPoint(i);
+    for (unsigned int j = 0; j < num_joints; ++j)
+      workspace.positions_[j * num_points + i] = waypoint.getVariablePosition(idx[j]);
+  }
 
   for (unsigned int j = 0; j < num_joints; ++j)
   {
-    // Copy positions
-    t2[j].positions_.resize(num_points, 0.0);
-    for (unsigned int i = 0; i < num_points; ++i)
-    {
-      t2[j].positions_[i] = trajectory.getWayPointPtr(i)->getVariablePosition(idx[j]);
-    }
+    Workspace::JointParameters& joint = workspace.joints_[j];
+    double* velocities = &workspace.velocities_[j * num_points];
+    double* accelerations = &workspace.accelerations_[j * num_points];
 
-    // Initialize velocities
-    t2[j].velocities_.resize(num_points, 0.0);
     // Copy initial/final velocities if specified
-    if (trajectory.getWayPointPtr(0)->hasVelocities())
-      t2[j].velocities_[0] = trajectory.getWayPointPtr(0)->getVariableVelocity(idx[j]);
-    if (trajectory.getWayPointPtr(num_points - 1)->hasVelocities())
-      t2[j].velocities_[num_points - 1] = trajectory.getWayPointPtr(num_points - 1)->getVariableVelocity(idx[j]);
-
-    // Initialize accelerations
-    t2[j].accelerations_.resize(num_points, 0.0);
-    t2[j].initial_acceleration_ = 0.0;
-    t2[j].final_acceleration_ = 0.0;
-    // Copy initial/final accelerations if specified
-    if (trajectory.getWayPointPtr(0)->hasAccelerations())
-      t2[j].initial_acceleration_ = trajectory.getWayPointPtr(0)->getVariableAcceleration(idx[j]);
-    t2[j].accelerations_[0] = t2[j].initial_acceleration_;
-    if (trajectory.getWayPointPtr(num_points - 1)->hasAccelerations())
-      t2[j].final_acceleration_ = trajectory.getWayPointPtr(num_points - 1)->getVariableAcceleration(idx[j]);
-    t2[j].accelerations_[num_points - 1] = t2[j].final_acceleration_;
+    if (first_waypoint.hasVelocities())
+      velocities[0] = first_waypoint.getVariableVelocity(idx[j]);
+    if (last_waypoint.hasVelocities())
+      velocities[num_points - 1] = last_waypoint.getVariableVelocity(idx[j]);
 
-    // Set bounds based on model, or default limits
-    const moveit::core::VariableBounds& bounds = rmodel.getVariableBounds(vars[j]);
-    t2[j].max_velocity_ = VLIMIT;
-    t2[j].min_velocity_ = -VLIMIT;
-    if (bounds.velocity_bounded_)
-    {
-      t2[j].max_velocity_ = bounds.max_velocity_;
-      t2[j].min_velocity_ = bounds.min_velocity_;
-      if (t2[j].min_velocity_ == 0.0)
-        t2[j].min_velocity_ = -t2[j].max_velocity_;
-    }
-    t2[j].max_velocity_ *= velocity_scaling_factor;
-    t2[j].min_velocity_ *= velocity_scaling_factor;
-
-    t2[j].max_acceleration_ = ALIMIT;
-    t2[j].min_acceleration_ = -ALIMIT;
-    if (bounds.acceleration_bounded_)
-    {
-      t2[j].max_acceleration_ = bounds.max_acceleration_;
-      t2[j].min_acceleration_ = bounds.min_acceleration_;
-      if (t2[j].min_acceleration_ == 0.0)
-        t2[j].min_acceleration_ = -t2[j].max_acceleration_;
-    }
-    t2[j].max_acceleration_ *= acceleration_scaling_factor;
-    t2[j].min_acceleration_ *= acceleration_scaling_factor;
+    // Copy initial/final accelerations if specified
+    joint.initial_acceleration_ = 0.0;
+    joint.final_acceleration_ = 0.0;
+    if (first_waypoint.hasAccelerations())
+      joint.initial_acceleration_ = first_waypoint.getVariableAcceleration(idx[j]);
+    accelerations[0] = joint.initial_acceleration_;
+    if (last_waypoint.hasAccelerations())
+      joint.final_acceleration_ = last_waypoint.getVariableAcceleration(idx[j]);
+    accelerations[num_points - 1] = joint.final_acceleration_;
+
+    // Scale the bounds of the model, or the default limits
+    joint.max_velocity_ = limits[j].max_velocity_ * velocity_scaling_factor;
+    joint.min_velocity_ = limits[j].min_velocity_ * velocity_scaling_factor;
+    joint.max_acceleration_ = limits[j].max_acceleration_ * acceleration_scaling_factor;
+    joint.min_acceleration_ = limits[j].min_acceleration_ * acceleration_scaling_factor;
 
     // Error out if bounds don't make sense
-    if (t2[j].max_velocity_ <= 0.0 || t2[j].max_acceleration_ <= 0.0)
+    if (joint.max_velocity_ <= 0.0 || joint.max_acceleration_ <= 0.0)
     {
       RCLCPP_ERROR(LOGGER,
                    "Joint %d max velocity %f and max acceleration %f must be greater than zero "
                    "or a solution won't be found.\n",
-                   j, t2[j].max_velocity_, t2[j].max_acceleration_);
+                   j, joint.max_velocity_, joint.max_acceleration_);
       return false;
     }
-    if (t2[j].min_velocity_ >= 0.0 || t2[j].min_acceleration_ >= 0.0)
+    if (joint.min_velocity_ >= 0.0 || joint.min_acceleration_ >= 0.0)
     {
       RCLCPP_ERROR(LOGGER,
                    "Joint %d min velocity %f and min acceleration %f must be less than zero "
                    "or a solution won't be found.\n",
-                   j, t2[j].min_velocity_, t2[j].min_acceleration_);
+                   j, joint.min_velocity_, joint.min_acceleration_);
       return false;
     }
-  }
 
-  // Error check
-  if (num_points < 4)
-  {
-    RCLCPP_ERROR(LOGGER, "number of waypoints %d, needs to be greater than 3.\n", num_points);
-    return false;
-  }
-  for (unsigned int j = 0; j < num_joints; ++j)
-  {
-    if (t2[j].velocities_[0] > t2[j].max_velocity_ || t2[j].velocities_[0] < t2[j].min_velocity_)
+    if (velocities[0] > joint.max_velocity_ || velocities[0] < joint.min_velocity_)
     {
-      RCLCPP_ERROR(LOGGER, "Initial velocity %f out of bounds\n", t2[j].velocities_[0]);
+      RCLCPP_ERROR(LOGGER, "Initial velocity %f out of bounds\n", velocities[0]);
       return false;
     }
-    else if (t2[j].velocities_[num_points - 1] > t2[j].max_velocity_ ||
-             t2[j].velocities_[num_points - 1] < t2[j].min_velocity_)
+    else if (velocities[num_points - 1] > joint.max_velocity_ || velocities[num_points - 1] < joint.min_velocity_)
     {
-      RCLCPP_ERROR(LOGGER, "Final velocity %f out of bounds\n", t2[j].velocities_[num_points - 1]);
+      RCLCPP_ERROR(LOGGER, "Final velocity %f out of bounds\n", velocities[num_points - 1]);
       return false;
     }
-    else if (t2[j].accelerations_[0] > t2[j].max_acceleration_ || t2[j].accelerations_[0] < t2[j].min_acceleration_)
+    else if (accelerations[0] > joint.max_acceleration_ || accelerations[0] < joint.min_acceleration_)
     {
-      RCLCPP_ERROR(LOGGER, "Initial acceleration %f out of bounds\n", t2[j].accelerations_[0]);
+      RCLCPP_ERROR(LOGGER, "Initial acceleration %f out of bounds\n", accelerations[0]);
       return false;
     }
-    else if (t2[j].accelerations_[num_points - 1] > t2[j].max_acceleration_ ||
-             t2[j].accelerations_[num_points - 1] < t2[j].min_acceleration_)
+    else if (accelerations[num_points - 1] > joint.max_acceleration_ ||
+             accelerations[num_points - 1] < joint.min_acceleration_)
     {
-      RCLCPP_ERROR(LOGGER, "Final acceleration %f out of bounds\n", t2[j].accelerations_[num_points - 1]);
+      RCLCPP_ERROR(LOGGER, "Final acceleration %f out of bounds\n", accelerations[num_points - 1]);
       return false;
     }
   }
@@ -275,42 +354,56 @@ bool IterativeSplineParameterization::computeTimeStamps(robot_trajectory::RobotT
   // Initialize times
   // start with valid velocities, then expand intervals
   // epsilon to prevent divide-by-zero
-  std::vector<double> time_diff(trajectory.getWayPointCount() - 1, std::numeric_limits<double>::epsilon());
+  double* time_diff = workspace.time_diff_.data();
   for (unsigned int j = 0; j < num_joints; ++j)
-    init_times(num_points, &time_diff[0], &t2[j].positions_[0], t2[j].max_velocity_, t2[j].min_velocity_);
+  {
+    init_times(num_points, time_diff, &workspace.positions_[j * num_points], workspace.joints_[j].max_velocity_,
+               workspace.joints_[j].min_velocity_);
+  }
 
   // Stretch intervals until close to the bounds
+  double* c = workspace.spline_c_.data();
+  double* a = workspace.spline_a_.data();
+  double* denom = workspace.spline_denom_.data();
   while (1)
   {
     int loop = 0;
 
+    // The intervals are the same for all joints, so the spline system is only factorized once
+    compute_spline_coefficients(num_points, time_diff, c, a, denom);
+
     // Calculate the interval stretches due to acceleration
-    std::vector<double> time_factor(num_points - 1, 1.00);
+    std::fill(workspace.time_factor_.begin(), workspace.time_factor_.end(), 1.00);
     for (unsigned j = 0; j < num_joints; ++j)
     {
+      const Workspace::JointParameters& joint = workspace.joints_[j];
+      double* positions = &workspace.positions_[j * num_points];
+      double* velocities = &workspace.velocities_[j * num_points];
+      double* accelerations = &workspace.accelerations_[j * num_points];
+
       // Move points to satisfy initial/final acceleration
       if (add_points_)
       {
-        adjust_two_positions(num_points, &time_diff[0], &t2[j].positions_[0], &t2[j].velocities_[0],
-                             &t2[j].accelerations_[0], t2[j].initial_acceleration_, t2[j].final_acceleration_);
+        adjust_two_positions(num_points, time_diff, c, a, denom, positions, velocities, accelerations,
+                             joint.initial_acceleration_, joint.final_acceleration_);
       }
 
-      fit_cubic_spline(num_points, &time_diff[0], &t2[j].positions_[0], &t2[j].velocities_[0], &t2[j].accelerations_[0]);
+      fit_cubic_spline(num_points, time_diff, c, a, denom, positions, velocities, accelerations);
       for (unsigned i = 0; i < num_points; ++i)
       {
-        const double acc = t2[j].accelerations_[i];
+        const double acc = accelerations[i];
         double atfactor = 1.0;
-        if (acc > t2[j].max_acceleration_)
-          atfactor = sqrt(acc / t2[j].max_acceleration_);
-        if (acc < t2[j].min_acceleration_)
-          atfactor = sqrt(acc / t2[j].min_acceleration_);
+        if (acc > joint.max_acceleration_)
+          atfactor = sqrt(acc / joint.max_acceleration_);
+        if (acc < joint.min_acceleration_)
+          atfactor = sqrt(acc / joint.min_acceleration_);
         if (atfactor > 1.01)  // within 1%
           loop = 1;
         atfactor = (atfactor - 1.0) / 16.0 + 1.0;  // 1/16th
         if (i > 0)
-          time_factor[i - 1] = std::max(time_factor[i - 1], atfactor);
+          workspace.time_factor_[i - 1] = std::max(workspace.time_factor_[i - 1], atfactor);
         if (i < num_points - 1)
-          time_factor[i] = std::max(time_factor[i], atfactor);
+          workspace.time_factor_[i] = std::max(workspace.time_factor_[i], atfactor);
       }
     }
 
@@ -319,29 +412,47 @@ bool IterativeSplineParameterization::computeTimeStamps(robot_trajectory::RobotT
 
     // Stretch
     for (unsigned i = 0; i < num_points - 1; ++i)
-      time_diff[i] *= time_factor[i];
+      time_diff[i] *= workspace.time_factor_[i];
   }
 
-  // Final adjustment forces the trajectory within bounds
-  globalAdjustment(t2, trajectory, time_diff);
+  // Final adjustment forces the trajectory within bounds, by expanding the entire trajectory
+  double gtfactor = 1.0;
+  for (unsigned int j = 0; j < num_joints; ++j)
+  {
+    const Workspace::JointParameters& joint = workspace.joints_[j];
+    const double tfactor = global_adjustment_factor(
+        num_points, &workspace.velocities_[j * num_points], &workspace.accelerations_[j * num_points],
+        joint.max_velocity_, joint.min_velocity_, joint.max_acceleration_, joint.min_acceleration_);
+    if (tfactor > gtfactor)
+      gtfactor = tfactor;
+  }
+  for (unsigned int i = 0; i < num_points - 1; ++i)
+    time_diff[i] *= gtfactor;
+  compute_spline_coefficients(num_points, time_diff, c, a, denom);
+  for (unsigned int j = 0; j < num_joints; ++j)
+  {
+    fit_cubic_spline(num_points, time_diff, c, a, denom, &workspace.positions_[j * num_points],
+                     &workspace.velocities_[j * num_points], &workspace.accelerations_[j * num_points]);
+  }
 
   // Convert back to JointTrajectory form
   for (unsigned int i = 1; i < num_points; ++i)
     trajectory.setWayPointDurationFromPrevious(i, time_diff[i - 1]);
   for (unsigned int i = 0; i < num_points; ++i)
   {
+    moveit::core::RobotState& waypoint = *trajectory.getWayPointPtr(i);
     for (unsigned int j = 0; j < num_joints; ++j)
     {
-      trajectory.getWayPointPtr(i)->setVariableVelocity(idx[j], t2[j].velocities_[i]);
-      trajectory.getWayPointPtr(i)->setVariableAcceleration(idx[j], t2[j].accelerations_[i]);
+      waypoint.setVariableVelocity(idx[j], workspace.velocities_[j * num_points + i]);
+      waypoint.setVariableAcceleration(idx[j], workspace.accelerations_[j * num_points + i]);
     }
 
     // Only update position of additionally inserted points (at second and next-to-last position)
     if (add_points_ && (i == 1 || i == num_points - 2))
     {
       for (unsigned int j = 0; j < num_joints; ++j)
-        trajectory.getWayPointPtr(i)->setVariablePosition(idx[j], t2[j].positions_[i]);
-      trajectory.getWayPointPtr(i)->update();
+        waypoint.setVariablePosition(idx[j], workspace.positions_[j * num_points + i]);
+      waypoint.update();
     }
   }
 
@@ -391,29 +502,44 @@ bool IterativeSplineParameterization::computeTimeStamps(
   x1 and x2 are filled in by the algorithm.
 */
 
-static void fit_cubic_spline(const int n, const double dt[], const double x[], double x1[], double x2[])
+/*
+  The forward sweep of the tridiagonal algorithm splits into coefficients that only depend on dt,
+  and are computed once here for all joints, and the right-hand side that is computed per joint.
+  c, a and denom have size n.
+*/
+
+static void compute_spline_coefficients(const int n, const double dt[], double c[], double a[], double denom[])
+{
+  c[0] = 0.5;
+  for (int i = 1; i <= n - 2; ++i)
+  {
+    const double dt2 = dt[i - 1] + dt[i];
+    a[i] = dt[i - 1] / dt2;
+    denom[i] = 2.0 - a[i] * c[i - 1];
+    c[i] = (1.0 - a[i]) / denom[i];
+  }
+  denom[n - 1] = dt[n - 2] * (2.0 - c[n - 2]);
+}
+
+static void fit_cubic_spline(const int n, const double dt[], const double c[], const double a[], const double denom[],
+                             const double x[], double x1[], double x2[])
 {
   int i;
   const double x1_i = x1[0], x1_f = x1[n - 1];
 
   // Tridiagonal alg - forward sweep
-  // x1 and x2 used to store the temporary coefficients c and d
+  // x2 used to store the temporary coefficients d
   // (will get overwritten during backsubstitution)
-  double *c = x1, *d = x2;
-  c[0] = 0.5;
+  double* d = x2;
   d[0] = 3.0 * ((x[1] - x[0]) / dt[0] - x1_i) / dt[0];
   for (i = 1; i <= n - 2; ++i)
   {
     const double dt2 = dt[i - 1] + dt[i];
-    const double a = dt[i - 1] / dt2;
-    const double denom = 2.0 - a * c[i - 1];
-    c[i] = (1.0 - a) / denom;
     d[i] = 6.0 * ((x[i + 1] - x[i]) / dt[i] - (x[i] - x[i - 1]) / dt[i - 1]) / dt2;
-    d[i] = (d[i] - a * d[i - 1]) / denom;
+    d[i] = (d[i] - a[i] * d[i - 1]) / denom[i];
   }
-  const double denom = dt[n - 2] * (2.0 - c[n - 2]);
   d[n - 1] = 6.0 * (x1_f - (x[n - 1] - x[n - 2]) / dt[n - 2]);
-  d[n - 1] = (d[n - 1] - dt[n - 2] * d[n - 2]) / denom;
+  d[n - 1] = (d[n - 1] - dt[n - 2] * d[n - 2]) / denom[n - 1];
 
   // Tridiagonal alg - backsubstitution sweep
   // 2nd derivative
@@ -437,18 +563,19 @@ static void fit_cubic_spline(const int n, const double dt[], const double x[], d
   x2_i and x2_f are the (initial and final) 2nd derivative at 0 and N-1
 */
 
-static void adjust_two_positions(const int n, const double dt[], double x[], double x1[], double x2[],
-                                 const double x2_i, const double x2_f)
+static void adjust_two_positions(const int n, const double dt[], const double c[], const double a[],
+                                 const double denom[], double x[], double x1[], double x2[], const double x2_i,
+                                 const double x2_f)
 {
   x[1] = x[0];
   x[n - 2] = x[n - 3];
-  fit_cubic_spline(n, dt, x, x1, x2);
+  fit_cubic_spline(n, dt, c, a, denom, x, x1, x2);
   double a0 = x2[0];
   double b0 = x2[n - 1];
 
   x[1] = x[2];
   x[n - 2] = x[n - 1];
-  fit_cubic_spline(n, dt, x, x1, x2);
+  fit_cubic_spline(n, dt, c, a, denom, x, x1, x2);
   double a2 = x2[0];
   double b2 = x2[n - 1];
 
@@ -580,32 +707,4 @@ static double global_adjustment_factor(const int n, double x1[], double x2[], co
   return tfactor2;
 }
 
-// Expands the entire trajectory to fit exactly within bounds
-void globalAdjustment(std::vector<SingleJointTrajectory>& t2, robot_trajectory::RobotTrajectory& trajectory,
-                      std::vector<double>& time_diff)
-{
-  const moveit::core::JointModelGroup* group = trajectory.getGroup();
-
-  const unsigned int num_points = trajectory.getWayPointCount();
-  const unsigned int num_joints = group->getVariableCount();
-
-  double gtfactor = 1.0;
-  for (unsigned int j = 0; j < num_joints; ++j)
-  {
-    double tfactor;
-    tfactor = global_adjustment_factor(num_points, &t2[j].velocities_[0], &t2[j].accelerations_[0], t2[j].max_velocity_,
-                                       t2[j].min_velocity_, t2[j].max_acceleration_, t2[j].min_acceleration_);
-    if (tfactor > gtfactor)
-      gtfactor = tfactor;
-  }
-
-  // printf("# Global adjustment: %0.4f%%\n", 100.0 * (gtfactor - 1.0));
-  for (unsigned int i = 0; i < num_points - 1; ++i)
-    time_diff[i] *= gtfactor;
-
-  for (unsigned int j = 0; j < num_joints; ++j)
-  {
-    fit_cubic_spline(num_points, &time_diff[0], &t2[j].positions_[0], &t2[j].velocities_[0], &t2[j].accelerations_[0]);
-  }
-}
 }  // namespace trajectory_processing
@@ -39,7 +39,10 @@
 #include <cmath>
 #include <Eigen/Geometry>
 #include <limits>
+#include <map>
 #include <moveit/trajectory_processing/ruckig_traj_smoothing.h>
+#include <moveit/trajectory_processing/trajectory_tools.h>
+#include <optional>
 #include <vector>
 
 namespace trajectory_processing
@@ -142,6 +145,62 @@ bool RuckigSmoothing::applySmoothing(robot_trajectory::RobotTrajectory& trajecto
   return runRuckig(trajectory, ruckig_input);
 }
 
+std::vector<bool>
+RuckigSmoothing::applySmoothing(const std::vector<robot_trajectory::RobotTrajectoryPtr>& trajectories,
+                                const std::vector<double>& max_velocity_scaling_factors,
+                                const std::vector<double>& max_acceleration_scaling_factors)
+{
+  if (max_velocity_scaling_factors.size() != trajectories.size() ||
+      max_acceleration_scaling_factors.size() != trajectories.size())
+  {
+    RCLCPP_ERROR(LOGGER, "Expected a velocity and an acceleration scaling factor for each trajectory.");
+    return std::vector<bool>(trajectories.size(), false);
+  }
+
+  // Unscaled kinematic limits (vels/accels/jerks) of each group, retrieved from the RobotModel only once
+  std::map<const moveit::core::JointModelGroup*, std::optional<ruckig::InputParameter<ruckig::DynamicDOFs>>>
+      group_limits;
+  for (const robot_trajectory::RobotTrajectoryPtr& trajectory : trajectories)
+  {
+    moveit::core::JointModelGroup const* const group = trajectory->getGroup();
+    if (group && group_limits.find(group) == group_limits.end())
+    {
+      ruckig::InputParameter<ruckig::DynamicDOFs> ruckig_input{ group->getVariableCount() };
+      group_limits[group] =
+          getRobotModelBounds(1.0, 1.0, group, ruckig_input) ? std::make_optional(ruckig_input) : std::nullopt;
+    }
+  }
+
+  return processConcurrently(trajectories.size(), [&](std::size_t i) {
+    robot_trajectory::RobotTrajectory& trajectory = *trajectories[i];
+    if (!validateGroup(trajectory))
+    {
+      return false;
+    }
+
+    if (trajectory.getWayPointCount() < 2)
+    {
+      RCLCPP_WARN(LOGGER,
+                  "Trajectory does not have enough points to smooth with Ruckig. Returning an unmodified trajectory.");
+      return true;
+    }
+
+    const std::optional<ruckig::InputParameter<ruckig::DynamicDOFs>>& limits = group_limits.at(trajectory.getGroup());
+    if (!limits)
+    {
+      RCLCPP_ERROR(LOGGER, "Error while retrieving kinematic limits (vel/accel/jerk) from RobotModel.");
+      return false;
+    }
+    ruckig::InputParameter<ruckig::DynamicDOFs> ruckig_input{ *limits };
+    for (size_t j = 0; j < trajectory.getGroup()->getVariableCount(); ++j)
+    {
+      ruckig_input.max_velocity.at(j) *= max_velocity_scaling_factors[i];
+      ruckig_input.max_acceleration.at(j) *= max_acceleration_scaling_factors[i];
+    }
+    return runRuckig(trajectory, ruckig_input);
+  });
+}
+
 bool RuckigSmoothing::validateGroup(const robot_trajectory::RobotTrajectory& trajectory)
 {
   moveit::core::JointModelGroup const* const group = trajectory.getGroup();
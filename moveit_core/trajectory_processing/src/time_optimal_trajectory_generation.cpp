@@ -42,7 +42,10 @@
 #include <Eigen/Geometry>
 #include <algorithm>
 #include <cmath>
+#include <map>
 #include <moveit/trajectory_processing/time_optimal_trajectory_generation.h>
+#include <moveit/trajectory_processing/trajectory_tools.h>
+#include <optional>
 #include <vector>
 
 namespace trajectory_processing
@@ -53,194 +56,212 @@ static const rclcpp::Logger LOGGER =
     rclcpp::get_logger("moveit_trajectory_processing.time_optimal_trajectory_generation");
 constexpr double DEFAULT_TIMESTEP = 1e-3;
 constexpr double EPS = 1e-6;
-}  // namespace
+// Number of path segments per task when computing the limit curves of the segments concurrently
+constexpr std::size_t SEGMENT_LIMITS_CHUNK_SIZE = 1024;
 
-class LinearPathSegment : public PathSegment
+// Returns the scaling factor if it is in (0, 1], otherwise the default of 1.0
+double verifyScalingFactor(const double scaling_factor, const char* name)
 {
-public:
-  LinearPathSegment(const Eigen::VectorXd& start, const Eigen::VectorXd& end)
-    : PathSegment((end - start).norm()), end_(end), start_(start)
-  {
-  }
-
-  Eigen::VectorXd getConfig(double s) const override
+  constexpr double DEFAULT_SCALING_FACTOR = 1.0;
+  if (scaling_factor > 0.0 && scaling_factor <= 1.0)
+    return scaling_factor;
+  if (scaling_factor == 0.0)
   {
-    s /= length_;
-    s = std::max(0.0, std::min(1.0, s));
-    return (1.0 - s) * start_ + s * end_;
+    RCLCPP_DEBUG(LOGGER, "A %s of 0.0 was specified, defaulting to %f instead.", name, DEFAULT_SCALING_FACTOR);
   }
-
-  Eigen::VectorXd getTangent(double /* s */) const override
+  else
   {
-    return (end_ - start_) / length_;
+    RCLCPP_WARN(LOGGER, "Invalid %s %f specified, defaulting to %f instead.", name, scaling_factor,
+                DEFAULT_SCALING_FACTOR);
   }
+  return DEFAULT_SCALING_FACTOR;
+}
+}  // namespace
 
-  Eigen::VectorXd getCurvature(double /* s */) const override
-  {
-    return Eigen::VectorXd::Zero(start_.size());
-  }
+namespace
+{
+using SegmentColumns = Eigen::Ref<Eigen::MatrixXd, 0, Eigen::OuterStride<>>;
+using ConstSegmentColumns = Eigen::Ref<const Eigen::MatrixXd, 0, Eigen::OuterStride<>>;
 
-  std::list<double> getSwitchingPoints() const override
-  {
-    return std::list<double>();
-  }
+PathSegment makeLinearSegment(const Eigen::VectorXd& start, const Eigen::VectorXd& end, SegmentColumns columns)
+{
+  const double length = (end - start).norm();
+  columns.col(0) = start;
+  columns.col(1) = end;
+  columns.col(2) = (end - start) / length;
+  return PathSegment{ false, 0.0, length, 0.0, 0 };
+}
 
-  LinearPathSegment* clone() const override
+PathSegment makeCircularSegment(const Eigen::VectorXd& start, const Eigen::VectorXd& intersection,
+                                const Eigen::VectorXd& end, double max_deviation, SegmentColumns columns)
+{
+  PathSegment segment{ true, 0.0, 0.0, 1.0, 0 };
+  auto center = columns.col(0);
+  auto x = columns.col(1);
+  auto y = columns.col(2);
+  if ((intersection - start).norm() < 0.000001 || (end - intersection).norm() < 0.000001)
   {
-    return new LinearPathSegment(*this);
+    center = intersection;
+    x.setZero();
+    y.setZero();
+    return segment;
   }
 
-private:
-  Eigen::VectorXd end_;
-  Eigen::VectorXd start_;
-};
+  const Eigen::VectorXd start_direction = (intersection - start).normalized();
+  const Eigen::VectorXd end_direction = (end - intersection).normalized();
+  const double start_dot_end = start_direction.dot(end_direction);
 
-class CircularPathSegment : public PathSegment
-{
-public:
-  CircularPathSegment(const Eigen::VectorXd& start, const Eigen::VectorXd& intersection, const Eigen::VectorXd& end,
-                      double max_deviation)
+  // catch division by 0 in computations below
+  if (start_dot_end > 0.999999 || start_dot_end < -0.999999)
   {
-    if ((intersection - start).norm() < 0.000001 || (end - intersection).norm() < 0.000001)
-    {
-      length_ = 0.0;
-      radius = 1.0;
-      center = intersection;
-      x = Eigen::VectorXd::Zero(start.size());
-      y = Eigen::VectorXd::Zero(start.size());
-      return;
-    }
-
-    const Eigen::VectorXd start_direction = (intersection - start).normalized();
-    const Eigen::VectorXd end_direction = (end - intersection).normalized();
-    const double start_dot_end = start_direction.dot(end_direction);
+    center = intersection;
+    x.setZero();
+    y.setZero();
+    return segment;
+  }
 
-    // catch division by 0 in computations below
-    if (start_dot_end > 0.999999 || start_dot_end < -0.999999)
-    {
-      length_ = 0.0;
-      radius = 1.0;
-      center = intersection;
-      x = Eigen::VectorXd::Zero(start.size());
-      y = Eigen::VectorXd::Zero(start.size());
-      return;
-    }
+  const double angle = acos(start_dot_end);
+  const double start_distance = (start - intersection).norm();
+  const double end_distance = (end - intersection).norm();
 
-    const double angle = acos(start_dot_end);
-    const double start_distance = (start - intersection).norm();
-    const double end_distance = (end - intersection).norm();
+  // enforce max deviation
+  double distance = std::min(start_distance, end_distance);
+  distance = std::min(distance, max_deviation * sin(0.5 * angle) / (1.0 - cos(0.5 * angle)));
 
-    // enforce max deviation
-    double distance = std::min(start_distance, end_distance);
-    distance = std::min(distance, max_deviation * sin(0.5 * angle) / (1.0 - cos(0.5 * angle)));
+  segment.radius_ = distance / tan(0.5 * angle);
+  segment.length_ = angle * segment.radius_;
 
-    radius = distance / tan(0.5 * angle);
-    length_ = angle * radius;
+  center = intersection + (end_direction - start_direction).normalized() * segment.radius_ / cos(0.5 * angle);
+  x = (intersection - distance * start_direction - center).normalized();
+  y = start_direction;
+  return segment;
+}
 
-    center = intersection + (end_direction - start_direction).normalized() * radius / cos(0.5 * angle);
-    x = (intersection - distance * start_direction - center).normalized();
-    y = start_direction;
+void getSegmentConfig(const PathSegment& segment, const ConstSegmentColumns& columns, double s,
+                      Eigen::Ref<Eigen::VectorXd> config)
+{
+  if (segment.circular_)
+  {
+    const double angle = s / segment.radius_;
+    config = columns.col(0) + segment.radius_ * (columns.col(1) * cos(angle) + columns.col(2) * sin(angle));
+    return;
   }
+  s /= segment.length_;
+  s = std::max(0.0, std::min(1.0, s));
+  config = (1.0 - s) * columns.col(0) + s * columns.col(1);
+}
 
-  Eigen::VectorXd getConfig(double s) const override
+void getSegmentTangent(const PathSegment& segment, const ConstSegmentColumns& columns, double s,
+                       Eigen::Ref<Eigen::VectorXd> tangent)
+{
+  if (segment.circular_)
   {
-    const double angle = s / radius;
-    return center + radius * (x * cos(angle) + y * sin(angle));
+    const double angle = s / segment.radius_;
+    tangent = -columns.col(1) * sin(angle) + columns.col(2) * cos(angle);
+    return;
   }
+  tangent = columns.col(2);
+}
 
-  Eigen::VectorXd getTangent(double s) const override
+void getSegmentCurvature(const PathSegment& segment, const ConstSegmentColumns& columns, double s,
+                         Eigen::Ref<Eigen::VectorXd> curvature)
+{
+  if (segment.circular_)
   {
-    const double angle = s / radius;
-    return -x * sin(angle) + y * cos(angle);
+    const double angle = s / segment.radius_;
+    curvature = -1.0 / segment.radius_ * (columns.col(1) * cos(angle) + columns.col(2) * sin(angle));
+    return;
   }
+  curvature.setZero();
+}
 
-  Eigen::VectorXd getCurvature(double s) const override
+void getSegmentSwitchingPoints(const PathSegment& segment, const ConstSegmentColumns& columns,
+                               std::vector<double>& switching_points)
+{
+  switching_points.clear();
+  if (!segment.circular_)
   {
-    const double angle = s / radius;
-    return -1.0 / radius * (x * cos(angle) + y * sin(angle));
+    return;
   }
-
-  std::list<double> getSwitchingPoints() const override
+  for (Eigen::Index i = 0; i < columns.rows(); ++i)
   {
-    std::list<double> switching_points;
-    const double dim = x.size();
-    for (unsigned int i = 0; i < dim; ++i)
+    double switching_angle = atan2(columns(i, 2), columns(i, 1));
+    if (switching_angle < 0.0)
     {
-      double switching_angle = atan2(y[i], x[i]);
-      if (switching_angle < 0.0)
-      {
-        switching_angle += M_PI;
-      }
-      const double switching_point = switching_angle * radius;
-      if (switching_point < length_)
-      {
-        switching_points.push_back(switching_point);
-      }
+      switching_angle += M_PI;
+    }
+    const double switching_point = switching_angle * segment.radius_;
+    if (switching_point < segment.length_)
+    {
+      switching_points.push_back(switching_point);
     }
-    switching_points.sort();
-    return switching_points;
-  }
-
-  CircularPathSegment* clone() const override
-  {
-    return new CircularPathSegment(*this);
   }
-
-private:
-  double radius;
-  Eigen::VectorXd center;
-  Eigen::VectorXd x;
-  Eigen::VectorXd y;
-};
+  std::sort(switching_points.begin(), switching_points.end());
+}
+}  // namespace
 
 Path::Path(const std::list<Eigen::VectorXd>& path, double max_deviation) : length_(0.0)
 {
   if (path.size() < 2)
     return;
+  // Every waypoint adds at most a linear and a circular segment of three columns each
+  segment_vectors_.resize(path.front().size(), 6 * path.size());
+  path_segments_.reserve(2 * path.size());
+  auto add_segment = [this](const PathSegment& segment, const ConstSegmentColumns& columns) {
+    path_segments_.push_back(segment);
+    path_segments_.back().column_ = 3 * (path_segments_.size() - 1);
+    segment_vectors_.middleCols<3>(path_segments_.back().column_) = columns;
+  };
+
   std::list<Eigen::VectorXd>::const_iterator path_iterator1 = path.begin();
   std::list<Eigen::VectorXd>::const_iterator path_iterator2 = path_iterator1;
   ++path_iterator2;
   std::list<Eigen::VectorXd>::const_iterator path_iterator3;
   Eigen::VectorXd start_config = *path_iterator1;
+  Eigen::VectorXd end_config(start_config.size());
+  Eigen::MatrixXd columns(start_config.size(), 3);
   while (path_iterator2 != path.end())
   {
     path_iterator3 = path_iterator2;
     ++path_iterator3;
     if (max_deviation > 0.0 && path_iterator3 != path.end())
     {
-      CircularPathSegment* blend_segment =
-          new CircularPathSegment(0.5 * (*path_iterator1 + *path_iterator2), *path_iterator2,
-                                  0.5 * (*path_iterator2 + *path_iterator3), max_deviation);
-      Eigen::VectorXd end_config = blend_segment->getConfig(0.0);
+      Eigen::MatrixXd blend_columns(start_config.size(), 3);
+      const PathSegment blend_segment =
+          makeCircularSegment(0.5 * (*path_iterator1 + *path_iterator2), *path_iterator2,
+                              0.5 * (*path_iterator2 + *path_iterator3), max_deviation, blend_columns);
+      getSegmentConfig(blend_segment, blend_columns, 0.0, end_config);
       if ((end_config - start_config).norm() > 0.000001)
       {
-        path_segments_.push_back(std::make_unique<LinearPathSegment>(start_config, end_config));
+        add_segment(makeLinearSegment(start_config, end_config, columns), columns);
       }
-      path_segments_.emplace_back(blend_segment);
+      add_segment(blend_segment, blend_columns);
 
-      start_config = blend_segment->getConfig(blend_segment->getLength());
+      getSegmentConfig(blend_segment, blend_columns, blend_segment.length_, start_config);
     }
     else
     {
-      path_segments_.push_back(std::make_unique<LinearPathSegment>(start_config, *path_iterator2));
+      add_segment(makeLinearSegment(start_config, *path_iterator2, columns), columns);
       start_config = *path_iterator2;
     }
     path_iterator1 = path_iterator2;
     ++path_iterator2;
   }
+  segment_vectors_.conservativeResize(Eigen::NoChange, 3 * path_segments_.size());
 
   // Create list of switching point candidates, calculate total path length and
   // absolute positions of path segments
-  for (std::unique_ptr<PathSegment>& path_segment : path_segments_)
+  std::vector<double> local_switching_points;
+  for (PathSegment& path_segment : path_segments_)
   {
-    path_segment->position_ = length_;
-    std::list<double> local_switching_points = path_segment->getSwitchingPoints();
-    for (std::list<double>::const_iterator point = local_switching_points.begin();
-         point != local_switching_points.end(); ++point)
+    path_segment.position_ = length_;
+    getSegmentSwitchingPoints(path_segment, segment_vectors_.middleCols<3>(path_segment.column_),
+                              local_switching_points);
+    for (const double point : local_switching_points)
     {
-      switching_points_.push_back(std::make_pair(length_ + *point, false));
+      switching_points_.push_back(std::make_pair(length_ + point, false));
     }
-    length_ += path_segment->getLength();
+    length_ += path_segment.length_;
     while (!switching_points_.empty() && switching_points_.back().first >= length_)
       switching_points_.pop_back();
     switching_points_.push_back(std::make_pair(length_, true));
@@ -248,58 +269,79 @@ Path::Path(const std::list<Eigen::VectorXd>& path, double max_deviation) : lengt
   switching_points_.pop_back();
 }
 
-Path::Path(const Path& path) : length_(path.length_), switching_points_(path.switching_points_)
+double Path::getLength() const
 {
-  for (const std::unique_ptr<PathSegment>& path_segment : path.path_segments_)
-  {
-    path_segments_.emplace_back(path_segment->clone());
-  }
+  return length_;
 }
 
-double Path::getLength() const
+const PathSegment& Path::getPathSegment(double& s) const
 {
-  return length_;
+  const PathSegment& segment = path_segments_[getPathSegmentIndex(s)];
+  s -= segment.position_;
+  return segment;
 }
 
-PathSegment* Path::getPathSegment(double& s) const
+std::size_t Path::getPathSegmentIndex(double s) const
 {
-  std::list<std::unique_ptr<PathSegment>>::const_iterator it = path_segments_.begin();
-  std::list<std::unique_ptr<PathSegment>>::const_iterator next = it;
-  ++next;
-  while (next != path_segments_.end() && s >= (*next)->position_)
-  {
-    it = next;
-    ++next;
-  }
-  s -= (*it)->position_;
-  return (*it).get();
+  // The last segment starting at or before s, or the first one
+  auto it = std::upper_bound(path_segments_.cbegin() + 1, path_segments_.cend(), s,
+                             [](double s, const PathSegment& segment) { return s < segment.position_; });
+  return (it - path_segments_.cbegin()) - 1;
+}
+
+const std::vector<PathSegment>& Path::getPathSegments() const
+{
+  return path_segments_;
+}
+
+const Eigen::MatrixXd& Path::getSegmentVectors() const
+{
+  return segment_vectors_;
 }
 
 Eigen::VectorXd Path::getConfig(double s) const
 {
-  const PathSegment* path_segment = getPathSegment(s);
-  return path_segment->getConfig(s);
+  Eigen::VectorXd config(segment_vectors_.rows());
+  getConfig(s, config);
+  return config;
 }
 
 Eigen::VectorXd Path::getTangent(double s) const
 {
-  const PathSegment* path_segment = getPathSegment(s);
-  return path_segment->getTangent(s);
+  Eigen::VectorXd tangent(segment_vectors_.rows());
+  getTangent(s, tangent);
+  return tangent;
 }
 
 Eigen::VectorXd Path::getCurvature(double s) const
 {
-  const PathSegment* path_segment = getPathSegment(s);
-  return path_segment->getCurvature(s);
+  Eigen::VectorXd curvature(segment_vectors_.rows());
+  getCurvature(s, curvature);
+  return curvature;
+}
+
+void Path::getConfig(double s, Eigen::Ref<Eigen::VectorXd> config) const
+{
+  const PathSegment& path_segment = getPathSegment(s);
+  getSegmentConfig(path_segment, segment_vectors_.middleCols<3>(path_segment.column_), s, config);
+}
+
+void Path::getTangent(double s, Eigen::Ref<Eigen::VectorXd> tangent) const
+{
+  const PathSegment& path_segment = getPathSegment(s);
+  getSegmentTangent(path_segment, segment_vectors_.middleCols<3>(path_segment.column_), s, tangent);
+}
+
+void Path::getCurvature(double s, Eigen::Ref<Eigen::VectorXd> curvature) const
+{
+  const PathSegment& path_segment = getPathSegment(s);
+  getSegmentCurvature(path_segment, segment_vectors_.middleCols<3>(path_segment.column_), s, curvature);
 }
 
 double Path::getNextSwitchingPoint(double s, bool& discontinuity) const
 {
-  std::list<std::pair<double, bool>>::const_iterator it = switching_points_.begin();
-  while (it != switching_points_.end() && it->first <= s)
-  {
-    ++it;
-  }
+  auto it = std::upper_bound(switching_points_.cbegin(), switching_points_.cend(), s,
+                             [](double s, const std::pair<double, bool>& point) { return s < point.first; });
   if (it == switching_points_.end())
   {
     discontinuity = true;
@@ -309,7 +351,7 @@ double Path::getNextSwitchingPoint(double s, bool& discontinuity) const
   return it->first;
 }
 
-std::list<std::pair<double, bool>> Path::getSwitchingPoints() const
+const std::vector<std::pair<double, bool>>& Path::getSwitchingPoints() const
 {
   return switching_points_;
 }
@@ -323,7 +365,12 @@ Trajectory::Trajectory(const Path& path, const Eigen::VectorXd& max_velocity, co
   , valid_(true)
   , time_step_(time_step)
   , cached_time_(std::numeric_limits<double>::max())
+  , config_deriv_(max_velocity.size())
+  , config_deriv2_(max_velocity.size())
+  , curvature_ratio_(max_velocity.size())
+  , acceleration_ratio_(max_velocity.size())
 {
+  computeSegmentLimits();
   trajectory_.push_back(TrajectoryStep(0.0, 0.0));
   double after_acceleration = getMinMaxPathAcceleration(0.0, 0.0, true);
   while (valid_ && !integrateForward(trajectory_, after_acceleration) && valid_)
@@ -364,6 +411,29 @@ Trajectory::~Trajectory()
 {
 }
 
+void Trajectory::computeSegmentLimits()
+{
+  const std::vector<PathSegment>& segments = path_.getPathSegments();
+  segment_limits_.resize(segments.size());
+  const std::size_t chunk_count = (segments.size() + SEGMENT_LIMITS_CHUNK_SIZE - 1) / SEGMENT_LIMITS_CHUNK_SIZE;
+  processConcurrently(chunk_count, [&](std::size_t chunk) {
+    Eigen::VectorXd tangent(joint_num_);
+    const std::size_t end = std::min(segments.size(), (chunk + 1) * SEGMENT_LIMITS_CHUNK_SIZE);
+    for (std::size_t i = chunk * SEGMENT_LIMITS_CHUNK_SIZE; i < end; ++i)
+    {
+      SegmentLimits& limits = segment_limits_[i];
+      // Circular segments are evaluated at every path position during integration
+      limits.constant_ = !segments[i].circular_;
+      if (limits.constant_)
+      {
+        tangent = path_.getSegmentVectors().col(segments[i].column_ + 2);
+        limits.velocity_max_path_velocity_ = computeVelocityMaxPathVelocity(tangent);
+      }
+    }
+    return true;
+  });
+}
+
 // Returns true if end of path is reached.
 bool Trajectory::getNextSwitchingPoint(double path_pos, TrajectoryStep& next_switching_point,
                                        double& before_acceleration, double& after_acceleration)
@@ -513,8 +583,8 @@ bool Trajectory::integrateForward(std::list<TrajectoryStep>& trajectory, double
   double path_pos = trajectory.back().path_pos_;
   double path_vel = trajectory.back().path_vel_;
 
-  std::list<std::pair<double, bool>> switching_points = path_.getSwitchingPoints();
-  std::list<std::pair<double, bool>>::iterator next_discontinuity = switching_points.begin();
+  const std::vector<std::pair<double, bool>>& switching_points = path_.getSwitchingPoints();
+  std::vector<std::pair<double, bool>>::const_iterator next_discontinuity = switching_points.begin();
 
   while (true)
   {
@@ -683,8 +753,10 @@ void Trajectory::integrateBackward(std::list<TrajectoryStep>& start_trajectory,
 
 double Trajectory::getMinMaxPathAcceleration(double path_pos, double path_vel, bool max)
 {
-  Eigen::VectorXd config_deriv = path_.getTangent(path_pos);
-  Eigen::VectorXd config_deriv2 = path_.getCurvature(path_pos);
+  const Eigen::VectorXd& config_deriv = config_deriv_;
+  const Eigen::VectorXd& config_deriv2 = config_deriv2_;
+  path_.getTangent(path_pos, config_deriv_);
+  path_.getCurvature(path_pos, config_deriv2_);
   double factor = max ? 1.0 : -1.0;
   double max_path_acceleration = std::numeric_limits<double>::max();
   for (unsigned int i = 0; i < joint_num_; ++i)
@@ -706,9 +778,21 @@ double Trajectory::getMinMaxPhaseSlope(double path_pos, double path_vel, bool ma
 
 double Trajectory::getAccelerationMaxPathVelocity(double path_pos) const
 {
+  // Without curvature there is no acceleration limit on the path velocity
+  if (segment_limits_[path_.getPathSegmentIndex(path_pos)].constant_)
+    return std::numeric_limits<double>::infinity();
+  path_.getTangent(path_pos, config_deriv_);
+  path_.getCurvature(path_pos, config_deriv2_);
+  return computeAccelerationMaxPathVelocity(config_deriv_, config_deriv2_);
+}
+
+double Trajectory::computeAccelerationMaxPathVelocity(const Eigen::VectorXd& config_deriv,
+                                                      const Eigen::VectorXd& config_deriv2) const
+{
+  // The terms of each joint are only used if its tangent is non-zero
+  curvature_ratio_ = config_deriv2.array() / config_deriv.array();
+  acceleration_ratio_ = max_acceleration_.array() / config_deriv.array().abs();
   double max_path_velocity = std::numeric_limits<double>::infinity();
-  const Eigen::VectorXd config_deriv = path_.getTangent(path_pos);
-  const Eigen::VectorXd config_deriv2 = path_.getCurvature(path_pos);
   for (unsigned int i = 0; i < joint_num_; ++i)
   {
     if (config_deriv[i] != 0.0)
@@ -717,12 +801,11 @@ double Trajectory::getAccelerationMaxPathVelocity(double path_pos) const
       {
         if (config_deriv[j] != 0.0)
         {
-          double a_ij = config_deriv2[i] / config_deriv[i] - config_deriv2[j] / config_deriv[j];
+          double a_ij = curvature_ratio_[i] - curvature_ratio_[j];
           if (a_ij != 0.0)
           {
-            max_path_velocity = std::min(max_path_velocity, sqrt((max_acceleration_[i] / std::abs(config_deriv[i]) +
-                                                                  max_acceleration_[j] / std::abs(config_deriv[j])) /
-                                                                 std::abs(a_ij)));
+            max_path_velocity =
+                std::min(max_path_velocity, sqrt((acceleration_ratio_[i] + acceleration_ratio_[j]) / std::abs(a_ij)));
           }
         }
       }
@@ -737,13 +820,16 @@ double Trajectory::getAccelerationMaxPathVelocity(double path_pos) const
 
 double Trajectory::getVelocityMaxPathVelocity(double path_pos) const
 {
-  const Eigen::VectorXd tangent = path_.getTangent(path_pos);
-  double max_path_velocity = std::numeric_limits<double>::max();
-  for (unsigned int i = 0; i < joint_num_; ++i)
-  {
-    max_path_velocity = std::min(max_path_velocity, max_velocity_[i] / std::abs(tangent[i]));
-  }
-  return max_path_velocity;
+  const SegmentLimits& limits = segment_limits_[path_.getPathSegmentIndex(path_pos)];
+  if (limits.constant_)
+    return limits.velocity_max_path_velocity_;
+  path_.getTangent(path_pos, config_deriv_);
+  return computeVelocityMaxPathVelocity(config_deriv_);
+}
+
+double Trajectory::computeVelocityMaxPathVelocity(const Eigen::VectorXd& tangent) const
+{
+  return std::min(std::numeric_limits<double>::max(), (max_velocity_.array() / tangent.array().abs()).minCoeff());
 }
 
 double Trajectory::getAccelerationMaxPathVelocityDeriv(double path_pos)
@@ -754,7 +840,10 @@ double Trajectory::getAccelerationMaxPathVelocityDeriv(double path_pos)
 
 double Trajectory::getVelocityMaxPathVelocityDeriv(double path_pos)
 {
-  const Eigen::VectorXd tangent = path_.getTangent(path_pos);
+  if (segment_limits_[path_.getPathSegmentIndex(path_pos)].constant_)
+    return 0.0;
+  const Eigen::VectorXd& tangent = config_deriv_;
+  path_.getTangent(path_pos, config_deriv_);
   double max_path_velocity = std::numeric_limits<double>::max();
   unsigned int active_constraint;
   for (unsigned int i = 0; i < joint_num_; ++i)
@@ -766,7 +855,8 @@ double Trajectory::getVelocityMaxPathVelocityDeriv(double path_pos)
       active_constraint = i;
     }
   }
-  return -(max_velocity_[active_constraint] * path_.getCurvature(path_pos)[active_constraint]) /
+  path_.getCurvature(path_pos, config_deriv2_);
+  return -(max_velocity_[active_constraint] * config_deriv2_[active_constraint]) /
          (tangent[active_constraint] * std::abs(tangent[active_constraint]));
 }
 
@@ -879,52 +969,70 @@ bool TimeOptimalTrajectoryGeneration::computeTimeStamps(robot_trajectory::RobotT
     return false;
   }
 
-  // Validate scaling
-  double velocity_scaling_factor = 1.0;
-  if (max_velocity_scaling_factor > 0.0 && max_velocity_scaling_factor <= 1.0)
-  {
-    velocity_scaling_factor = max_velocity_scaling_factor;
-  }
-  else if (max_velocity_scaling_factor == 0.0)
-  {
-    RCLCPP_DEBUG(LOGGER, "A max_velocity_scaling_factor of 0.0 was specified, defaulting to %f instead.",
-                 velocity_scaling_factor);
-  }
-  else
-  {
-    RCLCPP_WARN(LOGGER, "Invalid max_velocity_scaling_factor %f specified, defaulting to %f instead.",
-                max_velocity_scaling_factor, velocity_scaling_factor);
-  }
+  GroupLimits limits;
+  if (!getGroupLimits(*group, limits))
+    return false;
 
-  double acceleration_scaling_factor = 1.0;
-  if (max_acceleration_scaling_factor > 0.0 && max_acceleration_scaling_factor <= 1.0)
-  {
-    acceleration_scaling_factor = max_acceleration_scaling_factor;
-  }
-  else if (max_acceleration_scaling_factor == 0.0)
+  return computeTimeStamps(trajectory, limits, max_velocity_scaling_factor, max_acceleration_scaling_factor);
+}
+
+std::vector<bool> TimeOptimalTrajectoryGeneration::computeTimeStamps(
+    const std::vector<robot_trajectory::RobotTrajectoryPtr>& trajectories,
+    const std::vector<double>& max_velocity_scaling_factors,
+    const std::vector<double>& max_acceleration_scaling_factors) const
+{
+  if (max_velocity_scaling_factors.size() != trajectories.size() ||
+      max_acceleration_scaling_factors.size() != trajectories.size())
   {
-    RCLCPP_DEBUG(LOGGER, "A max_acceleration_scaling_factor of 0.0 was specified, defaulting to %f instead.",
-                 acceleration_scaling_factor);
+    RCLCPP_ERROR(LOGGER, "Expected a velocity and an acceleration scaling factor for each trajectory");
+    return std::vector<bool>(trajectories.size(), false);
   }
-  else
+
+  // Look up the limits of each group only once
+  std::map<const moveit::core::JointModelGroup*, std::optional<GroupLimits>> group_limits;
+  for (const robot_trajectory::RobotTrajectoryPtr& trajectory : trajectories)
   {
-    RCLCPP_WARN(LOGGER, "Invalid max_acceleration_scaling_factor %f specified, defaulting to %f instead.",
-                max_acceleration_scaling_factor, acceleration_scaling_factor);
+    const moveit::core::JointModelGroup* group = trajectory->getGroup();
+    if (group && !trajectory->empty() && group_limits.find(group) == group_limits.end())
+    {
+      GroupLimits limits;
+      group_limits[group] = getGroupLimits(*group, limits) ? std::make_optional(limits) : std::nullopt;
+    }
   }
 
-  const std::vector<std::string>& vars = group->getVariableNames();
-  const moveit::core::RobotModel& rmodel = group->getParentModel();
-  const unsigned num_joints = group->getVariableCount();
+  return processConcurrently(trajectories.size(), [&](std::size_t i) {
+    robot_trajectory::RobotTrajectory& trajectory = *trajectories[i];
+    if (trajectory.empty())
+      return true;
+    if (!trajectory.getGroup())
+    {
+      RCLCPP_ERROR(LOGGER, "It looks like the planner did not set the group the plan was computed for");
+      return false;
+    }
+    const std::optional<GroupLimits>& limits = group_limits.at(trajectory.getGroup());
+    return limits && computeTimeStamps(trajectory, *limits, max_velocity_scaling_factors[i],
+                                       max_acceleration_scaling_factors[i]);
+  });
+}
+
+bool TimeOptimalTrajectoryGeneration::getGroupLimits(const moveit::core::JointModelGroup& group, GroupLimits& limits)
+{
+  const std::vector<std::string>& vars = group.getVariableNames();
+  const moveit::core::RobotModel& rmodel = group.getParentModel();
+  const unsigned num_joints = group.getVariableCount();
 
   // Get the vel/accel limits
-  Eigen::VectorXd max_velocity(num_joints);
-  Eigen::VectorXd max_acceleration(num_joints);
+  limits.max_velocity_.resize(num_joints);
+  limits.max_acceleration_.resize(num_joints);
+  limits.velocity_bounded_.resize(num_joints);
+  limits.acceleration_bounded_.resize(num_joints);
   for (size_t j = 0; j < num_joints; ++j)
   {
     const moveit::core::VariableBounds& bounds = rmodel.getVariableBounds(vars[j]);
 
     // Limits need to be non-zero, otherwise we never exit
-    max_velocity[j] = 1.0;
+    limits.max_velocity_[j] = 1.0;
+    limits.velocity_bounded_[j] = bounds.velocity_bounded_;
     if (bounds.velocity_bounded_)
     {
       if (bounds.max_velocity_ <= 0.0)
@@ -933,17 +1041,18 @@ bool TimeOptimalTrajectoryGeneration::computeTimeStamps(robot_trajectory::RobotT
                      bounds.max_velocity_, vars[j].c_str());
         return false;
       }
-      max_velocity[j] =
-          std::min(std::fabs(bounds.max_velocity_), std::fabs(bounds.min_velocity_)) * velocity_scaling_factor;
+      limits.max_velocity_[j] = std::min(std::fabs(bounds.max_velocity_), std::fabs(bounds.min_velocity_));
     }
     else
     {
-      RCLCPP_WARN_STREAM_ONCE(
-          LOGGER, "Joint velocity limits are not defined. Using the default "
-                      << max_velocity[j] << " rad/s. You can define velocity limits in the URDF or joint_limits.yaml.");
+      RCLCPP_WARN_STREAM_ONCE(LOGGER,
+                              "Joint velocity limits are not defined. Using the default "
+                                  << limits.max_velocity_[j]
+                                  << " rad/s. You can define velocity limits in the URDF or joint_limits.yaml.");
     }
 
-    max_acceleration[j] = 1.0;
+    limits.max_acceleration_[j] = 1.0;
+    limits.acceleration_bounded_[j] = bounds.acceleration_bounded_;
     if (bounds.acceleration_bounded_)
     {
       if (bounds.max_acceleration_ < 0.0)
@@ -952,21 +1061,136 @@ bool TimeOptimalTrajectoryGeneration::computeTimeStamps(robot_trajectory::RobotT
                      bounds.max_acceleration_, vars[j].c_str());
         return false;
       }
-      max_acceleration[j] = std::min(std::fabs(bounds.max_acceleration_), std::fabs(bounds.min_acceleration_)) *
-                            acceleration_scaling_factor;
+      limits.max_acceleration_[j] = std::min(std::fabs(bounds.max_acceleration_), std::fabs(bounds.min_acceleration_));
     }
     else
     {
       RCLCPP_WARN_STREAM_ONCE(LOGGER,
                               "Joint acceleration limits are not defined. Using the default "
-                                  << max_acceleration[j]
+                                  << limits.max_acceleration_[j]
                                   << " rad/s^2. You can define acceleration limits in the URDF or joint_limits.yaml.");
     }
   }
+  return true;
+}
 
+void TimeOptimalTrajectoryGeneration::getScaledLimits(const GroupLimits& limits, const double velocity_scaling_factor,
+                                                      const double acceleration_scaling_factor,
+                                                      Eigen::VectorXd& max_velocity, Eigen::VectorXd& max_acceleration)
+{
+  // Only the limits from the model are scaled
+  max_velocity =
+      limits.velocity_bounded_.select(limits.max_velocity_ * velocity_scaling_factor, limits.max_velocity_).matrix();
+  max_acceleration =
+      limits.acceleration_bounded_
+          .select(limits.max_acceleration_ * acceleration_scaling_factor, limits.max_acceleration_)
+          .matrix();
+}
+
+bool TimeOptimalTrajectoryGeneration::computeTimeStamps(robot_trajectory::RobotTrajectory& trajectory,
+                                                        const GroupLimits& limits,
+                                                        const double max_velocity_scaling_factor,
+                                                        const double max_acceleration_scaling_factor) const
+{
+  const double velocity_scaling_factor =
+      verifyScalingFactor(max_velocity_scaling_factor, "max_velocity_scaling_factor");
+  const double acceleration_scaling_factor =
+      verifyScalingFactor(max_acceleration_scaling_factor, "max_acceleration_scaling_factor");
+  Eigen::VectorXd max_velocity, max_acceleration;
+  getScaledLimits(limits, velocity_scaling_factor, acceleration_scaling_factor, max_velocity, max_acceleration);
   return doTimeParameterizationCalculations(trajectory, max_velocity, max_acceleration);
 }
 
+void TimeOptimalTrajectoryGeneration::Cache::clear()
+{
+  group_ = nullptr;
+  reference_waypoint_.reset();
+  path_.reset();
+  trajectory_.reset();
+}
+
+bool TimeOptimalTrajectoryGeneration::Cache::empty() const
+{
+  return group_ == nullptr;
+}
+
+bool TimeOptimalTrajectoryGeneration::computeTimeStamps(robot_trajectory::RobotTrajectory& trajectory, Cache& cache,
+                                                        const double max_velocity_scaling_factor,
+                                                        const double max_acceleration_scaling_factor) const
+{
+  if (cache.empty())
+  {
+    if (trajectory.empty())
+      return true;
+
+    const moveit::core::JointModelGroup* group = trajectory.getGroup();
+    if (!group)
+    {
+      RCLCPP_ERROR(LOGGER, "It looks like the planner did not set the group the plan was computed for");
+      return false;
+    }
+    if (!getGroupLimits(*group, cache.limits_))
+      return false;
+
+    // This lib does not actually work properly when angles wrap around, so we need to unwind the path first
+    trajectory.unwind();
+    std::list<Eigen::VectorXd> points;
+    getPathPoints(trajectory, points);
+    cache.reference_waypoint_.emplace(trajectory.getWayPoint(0));
+    if (points.size() > 1)
+      cache.path_.emplace(points, path_tolerance_);
+    cache.group_ = group;
+  }
+  else if (trajectory.getGroup() != cache.group_)
+  {
+    RCLCPP_ERROR(LOGGER, "The cached path was computed for a different group than the one of the trajectory");
+    return false;
+  }
+
+  // Return trajectory with only the first waypoint if there are not multiple diverse points
+  if (!cache.path_)
+  {
+    moveit::core::RobotState waypoint(*cache.reference_waypoint_);
+    waypoint.zeroVelocities();
+    waypoint.zeroAccelerations();
+    trajectory.clear();
+    trajectory.addSuffixWayPoint(waypoint, 0.0);
+    return true;
+  }
+
+  const double velocity_scaling_factor =
+      verifyScalingFactor(max_velocity_scaling_factor, "max_velocity_scaling_factor");
+  const double acceleration_scaling_factor =
+      verifyScalingFactor(max_acceleration_scaling_factor, "max_acceleration_scaling_factor");
+
+  // Scaling all velocity limits by k and all acceleration limits by k^2 turns the time-optimal trajectory q(t) into
+  // q(k * t), so the cached solution only needs to be played back k times faster
+  if (cache.trajectory_ && cache.limits_.velocity_bounded_.all() && cache.limits_.acceleration_bounded_.all())
+  {
+    const double time_scale = velocity_scaling_factor / cache.velocity_scaling_factor_;
+    if (std::fabs(acceleration_scaling_factor / cache.acceleration_scaling_factor_ - time_scale * time_scale) < EPS)
+    {
+      sampleTrajectory(*cache.trajectory_, time_scale, *cache.reference_waypoint_, trajectory);
+      return true;
+    }
+  }
+
+  Eigen::VectorXd max_velocity, max_acceleration;
+  getScaledLimits(cache.limits_, velocity_scaling_factor, acceleration_scaling_factor, max_velocity, max_acceleration);
+  cache.trajectory_.emplace(*cache.path_, max_velocity, max_acceleration, DEFAULT_TIMESTEP);
+  if (!cache.trajectory_->isValid())
+  {
+    cache.trajectory_.reset();
+    RCLCPP_ERROR(LOGGER, "Unable to parameterize trajectory.");
+    return false;
+  }
+  cache.velocity_scaling_factor_ = velocity_scaling_factor;
+  cache.acceleration_scaling_factor_ = acceleration_scaling_factor;
+
+  sampleTrajectory(*cache.trajectory_, 1.0, *cache.reference_waypoint_, trajectory);
+  return true;
+}
+
 bool TimeOptimalTrajectoryGeneration::computeTimeStamps(
     robot_trajectory::RobotTrajectory& trajectory, const std::unordered_map<std::string, double>& velocity_limits,
     const std::unordered_map<std::string, double>& acceleration_limits) const
@@ -1071,23 +1295,51 @@ bool TimeOptimalTrajectoryGeneration::doTimeParameterizationCalculations(robot_t
     return false;
   }
 
+  std::list<Eigen::VectorXd> points;
+  getPathPoints(trajectory, points);
+
+  // Return trajectory with only the first waypoint if there are not multiple diverse points
+  if (points.size() == 1)
+  {
+    moveit::core::RobotState waypoint = moveit::core::RobotState(trajectory.getWayPoint(0));
+    waypoint.zeroVelocities();
+    waypoint.zeroAccelerations();
+    trajectory.clear();
+    trajectory.addSuffixWayPoint(waypoint, 0.0);
+    return true;
+  }
+
+  // Now actually call the algorithm
+  Trajectory parameterized(Path(points, path_tolerance_), max_velocity, max_acceleration, DEFAULT_TIMESTEP);
+  if (!parameterized.isValid())
+  {
+    RCLCPP_ERROR(LOGGER, "Unable to parameterize trajectory.");
+    return false;
+  }
+
+  sampleTrajectory(parameterized, 1.0, moveit::core::RobotState(trajectory.getWayPoint(0)), trajectory);
+  return true;
+}
+
+void TimeOptimalTrajectoryGeneration::getPathPoints(const robot_trajectory::RobotTrajectory& trajectory,
+                                                    std::list<Eigen::VectorXd>& points) const
+{
   const unsigned num_points = trajectory.getWayPointCount();
-  const std::vector<int>& idx = group->getVariableIndexList();
-  const unsigned num_joints = group->getVariableCount();
+  const std::vector<int>& idx = trajectory.getGroup()->getVariableIndexList();
+  const unsigned num_joints = trajectory.getGroup()->getVariableCount();
 
   // Have to convert into Eigen data structs and remove repeated points
   //  (https://github.com/tobiaskunz/trajectories/issues/3)
-  std::list<Eigen::VectorXd> points;
   for (size_t p = 0; p < num_points; ++p)
   {
-    moveit::core::RobotStatePtr waypoint = trajectory.getWayPointPtr(p);
+    const moveit::core::RobotState& waypoint = trajectory.getWayPoint(p);
     Eigen::VectorXd new_point(num_joints);
     // The first point should always be kept
     bool diverse_point = (p == 0);
 
     for (size_t j = 0; j < num_joints; ++j)
     {
-      new_point[j] = waypoint->getVariablePosition(idx[j]);
+      new_point[j] = waypoint.getVariablePosition(idx[j]);
       // If any joint angle is different, it's a unique waypoint
       if (p > 0 && std::fabs(new_point[j] - points.back()[j]) > min_angle_change_)
       {
@@ -1102,40 +1354,31 @@ bool TimeOptimalTrajectoryGeneration::doTimeParameterizationCalculations(robot_t
     else if (p == num_points - 1)
       points.back() = new_point;
   }
+}
 
-  // Return trajectory with only the first waypoint if there are not multiple diverse points
-  if (points.size() == 1)
-  {
-    moveit::core::RobotState waypoint = moveit::core::RobotState(trajectory.getWayPoint(0));
-    waypoint.zeroVelocities();
-    waypoint.zeroAccelerations();
-    trajectory.clear();
-    trajectory.addSuffixWayPoint(waypoint, 0.0);
-    return true;
-  }
-
-  // Now actually call the algorithm
-  Trajectory parameterized(Path(points, path_tolerance_), max_velocity, max_acceleration, DEFAULT_TIMESTEP);
-  if (!parameterized.isValid())
-  {
-    RCLCPP_ERROR(LOGGER, "Unable to parameterize trajectory.");
-    return false;
-  }
+void TimeOptimalTrajectoryGeneration::sampleTrajectory(const Trajectory& parameterized, double time_scale,
+                                                       const moveit::core::RobotState& reference_waypoint,
+                                                       robot_trajectory::RobotTrajectory& trajectory) const
+{
+  const std::vector<int>& idx = trajectory.getGroup()->getVariableIndexList();
+  const unsigned num_joints = trajectory.getGroup()->getVariableCount();
 
   // Compute sample count
-  size_t sample_count = std::ceil(parameterized.getDuration() / resample_dt_);
+  const double duration = parameterized.getDuration() / time_scale;
+  size_t sample_count = std::ceil(duration / resample_dt_);
 
   // Resample and fill in trajectory
-  moveit::core::RobotState waypoint = moveit::core::RobotState(trajectory.getWayPoint(0));
+  moveit::core::RobotState waypoint(reference_waypoint);
   trajectory.clear();
   double last_t = 0;
   for (size_t sample = 0; sample <= sample_count; ++sample)
   {
     // always sample the end of the trajectory as well
-    double t = std::min(parameterized.getDuration(), sample * resample_dt_);
-    Eigen::VectorXd position = parameterized.getPosition(t);
-    Eigen::VectorXd velocity = parameterized.getVelocity(t);
-    Eigen::VectorXd acceleration = parameterized.getAcceleration(t);
+    double t = std::min(duration, sample * resample_dt_);
+    const double parameterized_t = std::min(parameterized.getDuration(), t * time_scale);
+    Eigen::VectorXd position = parameterized.getPosition(parameterized_t);
+    Eigen::VectorXd velocity = parameterized.getVelocity(parameterized_t) * time_scale;
+    Eigen::VectorXd acceleration = parameterized.getAcceleration(parameterized_t) * (time_scale * time_scale);
 
     for (size_t j = 0; j < num_joints; ++j)
     {
@@ -1147,7 +1390,5 @@ bool TimeOptimalTrajectoryGeneration::doTimeParameterizationCalculations(robot_t
     trajectory.addSuffixWayPoint(waypoint, t - last_t);
     last_t = t;
   }
-
-  return true;
 }
 }  // namespace trajectory_processing
@@ -0,0 +1,284 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/trajectory_processing/trajectory_resampling.h>
+#include <rclcpp/duration.hpp>
+#include <rclcpp/logger.hpp>
+#include <rclcpp/logging.hpp>
+#include <rclcpp/time.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace trajectory_processing
+{
+namespace
+{
+static const rclcpp::Logger LOGGER = rclcpp::get_logger("moveit_trajectory_processing.trajectory_resampling");
+// Avoids a duplicate last sample if the duration is a multiple of the period up to rounding errors
+constexpr double SAMPLE_COUNT_EPSILON = 1e-9;
+
+// Walks along the waypoints of a trajectory for non-decreasing sample times
+class WaypointCursor
+{
+public:
+  explicit WaypointCursor(const robot_trajectory::RobotTrajectory& trajectory)
+    : durations_(trajectory.getWayPointDurations()), after_(0), after_time_(durations_.front())
+  {
+  }
+
+  // Find the waypoints before and after time, and the progress (0 to 1) between them
+  void advance(const double time, std::size_t& before, std::size_t& after, double& blend)
+  {
+    while (after_ + 1 < durations_.size() && after_time_ < time)
+    {
+      ++after_;
+      after_time_ += durations_[after_];
+    }
+    after = after_;
+    before = after_ > 0 ? after_ - 1 : 0;
+    const double segment_duration = durations_[after_];
+    blend = (after_ == 0 || segment_duration <= 0.0) ?
+                1.0 :
+                std::clamp(1.0 - (after_time_ - time) / segment_duration, 0.0, 1.0);
+  }
+
+private:
+  const std::deque<double>& durations_;
+  std::size_t after_;
+  double after_time_;
+};
+
+bool checkResamplingInput(const robot_trajectory::RobotTrajectory& trajectory, const double period)
+{
+  if (trajectory.empty())
+  {
+    RCLCPP_ERROR(LOGGER, "Cannot resample an empty trajectory.");
+    return false;
+  }
+  if (period <= 0.0)
+  {
+    RCLCPP_ERROR(LOGGER, "Invalid resampling period %f, must be greater than 0.0", period);
+    return false;
+  }
+  return true;
+}
+
+std::size_t getSampleCount(const robot_trajectory::RobotTrajectory& trajectory, const double period)
+{
+  return static_cast<std::size_t>(std::ceil(trajectory.getDuration() / period - SAMPLE_COUNT_EPSILON)) + 1;
+}
+}  // namespace
+
+bool resampleTrajectory(const robot_trajectory::RobotTrajectory& trajectory, const double period,
+                        trajectory_msgs::msg::JointTrajectory& joint_trajectory)
+{
+  if (!checkResamplingInput(trajectory, period))
+    return false;
+
+  const moveit::core::RobotModel& robot_model = *trajectory.getRobotModel();
+  const std::vector<const moveit::core::JointModel*>& active_joints =
+      trajectory.getGroup() ? trajectory.getGroup()->getActiveJointModels() : robot_model.getActiveJointModels();
+  std::vector<const moveit::core::JointModel*> joints;
+  joint_trajectory.joint_names.clear();
+  for (const moveit::core::JointModel* joint : active_joints)
+  {
+    if (joint->getVariableCount() == 1)
+    {
+      joints.push_back(joint);
+      joint_trajectory.joint_names.push_back(joint->getName());
+    }
+  }
+
+  bool has_velocities = true;
+  bool has_accelerations = true;
+  for (std::size_t i = 0; i < trajectory.getWayPointCount(); ++i)
+  {
+    has_velocities = has_velocities && trajectory.getWayPoint(i).hasVelocities();
+    has_accelerations = has_accelerations && trajectory.getWayPoint(i).hasAccelerations();
+  }
+
+  joint_trajectory.header.frame_id = robot_model.getModelFrame();
+  joint_trajectory.header.stamp = rclcpp::Time(0, 0, RCL_ROS_TIME);
+  joint_trajectory.points.resize(getSampleCount(trajectory, period));
+
+  const double duration = trajectory.getDuration();
+  WaypointCursor cursor(trajectory);
+  std::size_t before, after;
+  double blend;
+  for (std::size_t sample = 0; sample < joint_trajectory.points.size(); ++sample)
+  {
+    // always sample the end of the trajectory as well
+    const double time = std::min(duration, sample * period);
+    cursor.advance(time, before, after, blend);
+    const moveit::core::RobotState& from = trajectory.getWayPoint(before);
+    const moveit::core::RobotState& to = trajectory.getWayPoint(after);
+
+    trajectory_msgs::msg::JointTrajectoryPoint& point = joint_trajectory.points[sample];
+    point.positions.resize(joints.size());
+    point.velocities.resize(has_velocities ? joints.size() : 0);
+    point.accelerations.resize(has_accelerations ? joints.size() : 0);
+    point.effort.clear();
+    for (std::size_t j = 0; j < joints.size(); ++j)
+    {
+      const int index = joints[j]->getFirstVariableIndex();
+      joints[j]->interpolate(from.getVariablePositions() + index, to.getVariablePositions() + index, blend,
+                             &point.positions[j]);
+      if (has_velocities)
+        point.velocities[j] = from.getVariableVelocity(index) +
+                              blend * (to.getVariableVelocity(index) - from.getVariableVelocity(index));
+      if (has_accelerations)
+        point.accelerations[j] = from.getVariableAcceleration(index) +
+                                 blend * (to.getVariableAcceleration(index) - from.getVariableAcceleration(index));
+    }
+    point.time_from_start = rclcpp::Duration::from_seconds(time);
+  }
+  return true;
+}
+
+bool resampleTrajectory(robot_trajectory::RobotTrajectory& trajectory, const double period)
+{
+  if (!checkResamplingInput(trajectory, period))
+    return false;
+
+  const std::size_t sample_count = getSampleCount(trajectory, period);
+  const double duration = trajectory.getDuration();
+  std::vector<moveit::core::RobotStatePtr> samples;
+  samples.reserve(sample_count);
+  WaypointCursor cursor(trajectory);
+  std::size_t before, after;
+  double blend;
+  for (std::size_t sample = 0; sample < sample_count; ++sample)
+  {
+    const double time = std::min(duration, sample * period);
+    cursor.advance(time, before, after, blend);
+    const moveit::core::RobotState& from = trajectory.getWayPoint(before);
+    const moveit::core::RobotState& to = trajectory.getWayPoint(after);
+
+    auto state = std::make_shared<moveit::core::RobotState>(from);
+    from.interpolate(to, blend, *state);
+    for (std::size_t i = 0; i < from.getVariableCount(); ++i)
+    {
+      if (from.hasVelocities() && to.hasVelocities())
+      {
+        const double velocity = from.getVariableVelocity(i);
+        state->setVariableVelocity(i, velocity + blend * (to.getVariableVelocity(i) - velocity));
+      }
+      if (from.hasAccelerations() && to.hasAccelerations())
+      {
+        const double acceleration = from.getVariableAcceleration(i);
+        state->setVariableAcceleration(i, acceleration + blend * (to.getVariableAcceleration(i) - acceleration));
+      }
+    }
+    samples.push_back(state);
+  }
+
+  // The durations are measured between consecutive samples
+  trajectory.clear();
+  double last_time = 0.0;
+  for (std::size_t sample = 0; sample < samples.size(); ++sample)
+  {
+    const double time = std::min(duration, sample * period);
+    trajectory.addSuffixWayPoint(samples[sample], time - last_time);
+    last_time = time;
+  }
+  return true;
+}
+
+std::size_t decimateTrajectory(robot_trajectory::RobotTrajectory& trajectory, const double tolerance)
+{
+  const std::size_t num_points = trajectory.getWayPointCount();
+  if (num_points < 3)
+    return 0;
+
+  const moveit::core::JointModelGroup* group = trajectory.getGroup();
+  std::vector<int> indices;
+  if (group)
+  {
+    indices = group->getVariableIndexList();
+  }
+  else
+  {
+    for (std::size_t i = 0; i < trajectory.getRobotModel()->getVariableCount(); ++i)
+      indices.push_back(i);
+  }
+
+  std::vector<double> times(num_points);
+  double time = 0.0;
+  for (std::size_t i = 0; i < num_points; ++i)
+  {
+    time += trajectory.getWayPointDurationFromPrevious(i);
+    times[i] = time;
+  }
+
+  // Whether all waypoints between anchor and candidate are within tolerance of the line between those two
+  auto can_skip_to = [&](std::size_t anchor, std::size_t candidate) {
+    const moveit::core::RobotState& from = trajectory.getWayPoint(anchor);
+    const moveit::core::RobotState& to = trajectory.getWayPoint(candidate);
+    const double span = times[candidate] - times[anchor];
+    for (std::size_t k = anchor + 1; k < candidate; ++k)
+    {
+      const double blend = span > 0.0 ? (times[k] - times[anchor]) / span :
+                                        static_cast<double>(k - anchor) / static_cast<double>(candidate - anchor);
+      const moveit::core::RobotState& waypoint = trajectory.getWayPoint(k);
+      for (int index : indices)
+      {
+        const double interpolated = from.getVariablePosition(index) +
+                                    blend * (to.getVariablePosition(index) - from.getVariablePosition(index));
+        if (std::fabs(waypoint.getVariablePosition(index) - interpolated) > tolerance)
+          return false;
+      }
+    }
+    return true;
+  };
+
+  std::vector<std::size_t> kept{ 0 };
+  for (std::size_t candidate = 2; candidate < num_points; ++candidate)
+  {
+    if (!can_skip_to(kept.back(), candidate))
+      kept.push_back(candidate - 1);
+  }
+  kept.push_back(num_points - 1);
+
+  std::vector<moveit::core::RobotStatePtr> waypoints;
+  waypoints.reserve(kept.size());
+  for (std::size_t index : kept)
+    waypoints.push_back(trajectory.getWayPointPtr(index));
+  const double first_duration = trajectory.getWayPointDurationFromPrevious(0);
+
+  trajectory.clear();
+  for (std::size_t i = 0; i < kept.size(); ++i)
+    trajectory.addSuffixWayPoint(waypoints[i], i == 0 ? first_duration : times[kept[i]] - times[kept[i - 1]]);
+  return num_points - kept.size();
+}
+}  // namespace trajectory_processing
@@ -36,6 +36,10 @@
 
 #include <moveit/trajectory_processing/trajectory_tools.h>
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
 namespace trajectory_processing
 {
 bool isTrajectoryEmpty(const moveit_msgs::msg::RobotTrajectory& trajectory)
@@ -47,4 +51,29 @@ std::size_t trajectoryWaypointCount(const moveit_msgs::msg::RobotTrajectory& tra
 {
   return std::max(trajectory.joint_trajectory.points.size(), trajectory.multi_dof_joint_trajectory.points.size());
 }
+
+std::vector<bool> processConcurrently(std::size_t count, const std::function<bool(std::size_t)>& process)
+{
+  // std::vector<bool> packs its elements, so the threads write to a byte each
+  std::vector<char> results(count, false);
+  std::atomic<std::size_t> next{ 0 };
+  auto process_next = [&]() {
+    for (std::size_t i = next++; i < count; i = next++)
+    {
+      results[i] = process(i);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (std::size_t i = 1; i < std::min<std::size_t>(std::max(1u, std::thread::hardware_concurrency()), count); ++i)
+  {
+    threads.emplace_back(process_next);
+  }
+  process_next();
+  for (std::thread& thread : threads)
+  {
+    thread.join();
+  }
+  return std::vector<bool>(results.begin(), results.end());
+}
 }  // namespace trajectory_processing
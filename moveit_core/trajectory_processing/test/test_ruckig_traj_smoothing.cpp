@@ -126,6 +126,39 @@ TEST_F(RuckigTests, trajectory_duration)
   EXPECT_LT(trajectory_->getWayPointDurationFromStart(trajectory_->getWayPointCount() - 1), 1.5 * ideal_duration);
 }
 
+TEST_F(RuckigTests, batch)
+{
+  moveit::core::RobotState robot_state(robot_model_);
+  robot_state.setToDefaultValues();
+  robot_state.setVariablePosition("panda_joint1", 0.0);
+  robot_state.update();
+  trajectory_->addSuffixWayPoint(robot_state, 0.0);
+
+  robot_state.setVariablePosition("panda_joint1", 0.1);
+  robot_state.update();
+  trajectory_->addSuffixWayPoint(robot_state, DEFAULT_TIMESTEP);
+
+  // A batch of copies with different scaling factors gives the same result as one call per trajectory
+  const std::vector<double> velocity_scaling_factors{ 1.0, 0.5, 0.1 };
+  const std::vector<double> acceleration_scaling_factors{ 1.0, 0.5, 0.1 };
+  std::vector<robot_trajectory::RobotTrajectoryPtr> trajectories;
+  for (size_t i = 0; i < velocity_scaling_factors.size(); ++i)
+  {
+    trajectories.push_back(std::make_shared<robot_trajectory::RobotTrajectory>(*trajectory_, true /* deep copy */));
+  }
+
+  const std::vector<bool> results =
+      smoother_.applySmoothing(trajectories, velocity_scaling_factors, acceleration_scaling_factors);
+  ASSERT_EQ(results.size(), trajectories.size());
+  for (size_t i = 0; i < trajectories.size(); ++i)
+  {
+    EXPECT_TRUE(results[i]);
+    robot_trajectory::RobotTrajectory expected(*trajectory_, true /* deep copy */);
+    ASSERT_TRUE(smoother_.applySmoothing(expected, velocity_scaling_factors[i], acceleration_scaling_factors[i]));
+    EXPECT_DOUBLE_EQ(trajectories[i]->getDuration(), expected.getDuration());
+  }
+}
+
 TEST_F(RuckigTests, single_waypoint)
 {
   // With only one waypoint, Ruckig cannot smooth the trajectory.
@@ -114,6 +114,33 @@ TEST(time_optimal_trajectory_generation, test2)
   EXPECT_DOUBLE_EQ(90.0, trajectory.getPosition(trajectory.getDuration())[3]);
 }
 
+TEST(time_optimal_trajectory_generation, path_segments_are_continuous)
+{
+  // A zig-zag path alternating between linear and circular blend segments
+  std::list<Eigen::VectorXd> waypoints;
+  Eigen::VectorXd waypoint(3);
+  for (int i = 0; i < 50; ++i)
+  {
+    waypoint << 0.1 * i, (i % 2) * 0.2, 0.05 * (i % 3);
+    waypoints.push_back(waypoint);
+  }
+  const Path path(waypoints, 0.05);
+
+  Eigen::VectorXd config(3);
+  Eigen::VectorXd previous_config = path.getConfig(0.0);
+  EXPECT_TRUE(previous_config.isApprox(waypoints.front()));
+  const double step = 1e-4;
+  for (double s = step; s < path.getLength(); s += step)
+  {
+    path.getConfig(s, config);
+    EXPECT_TRUE(config.isApprox(path.getConfig(s)));
+    EXPECT_LT((config - previous_config).norm(), 2 * step) << "Jump at path position " << s;
+    EXPECT_NEAR(path.getTangent(s).norm(), 1.0, 1e-9);
+    previous_config = config;
+  }
+  EXPECT_TRUE(path.getConfig(path.getLength()).isApprox(waypoints.back()));
+}
+
 TEST(time_optimal_trajectory_generation, test3)
 {
   Eigen::VectorXd waypoint(4);
@@ -377,6 +404,100 @@ TEST(time_optimal_trajectory_generation, testLastWaypoint)
                          }));
 }
 
+TEST(time_optimal_trajectory_generation, testBatch)
+{
+  constexpr auto robot_name{ "panda" };
+  constexpr auto group_name{ "panda_arm" };
+
+  auto robot_model = moveit::core::loadTestingRobotModel(robot_name);
+  ASSERT_TRUE((bool)robot_model) << "Failed to load robot model" << robot_name;
+  auto group = robot_model->getJointModelGroup(group_name);
+  ASSERT_TRUE((bool)group) << "Failed to load joint model group " << group_name;
+  moveit::core::RobotState waypoint_state(robot_model);
+  waypoint_state.setToDefaultValues();
+
+  robot_trajectory::RobotTrajectory trajectory(robot_model, group);
+  waypoint_state.setJointGroupPositions(group, std::vector<double>{ -0.5, -3.52, 1.35, -2.51, -0.88, 0.63, 0.0 });
+  trajectory.addSuffixWayPoint(waypoint_state, 0.1);
+  waypoint_state.setJointGroupPositions(group, std::vector<double>{ 0.0, -3.5, 1.4, -1.2, -1.0, -0.2, 0.0 });
+  trajectory.addSuffixWayPoint(waypoint_state, 0.1);
+  waypoint_state.setJointGroupPositions(group, std::vector<double>{ -0.5, -3.52, 1.35, -2.51, -0.88, 0.63, 0.0 });
+  trajectory.addSuffixWayPoint(waypoint_state, 0.1);
+
+  // A batch of copies with different scaling factors gives the same result as one call per trajectory
+  const std::vector<double> velocity_scaling_factors{ 1.0, 0.5, 0.25, 0.1 };
+  const std::vector<double> acceleration_scaling_factors{ 1.0, 0.1, 0.5, 0.1 };
+  std::vector<robot_trajectory::RobotTrajectoryPtr> trajectories;
+  for (size_t i = 0; i < velocity_scaling_factors.size(); ++i)
+  {
+    trajectories.push_back(std::make_shared<robot_trajectory::RobotTrajectory>(trajectory, true /* deep copy */));
+  }
+
+  TimeOptimalTrajectoryGeneration totg;
+  const std::vector<bool> results =
+      totg.computeTimeStamps(trajectories, velocity_scaling_factors, acceleration_scaling_factors);
+  ASSERT_EQ(results.size(), trajectories.size());
+  for (size_t i = 0; i < trajectories.size(); ++i)
+  {
+    EXPECT_TRUE(results[i]);
+    robot_trajectory::RobotTrajectory expected(trajectory, true /* deep copy */);
+    ASSERT_TRUE(totg.computeTimeStamps(expected, velocity_scaling_factors[i], acceleration_scaling_factors[i]));
+    EXPECT_EQ(trajectories[i]->getWayPointCount(), expected.getWayPointCount());
+    EXPECT_DOUBLE_EQ(trajectories[i]->getDuration(), expected.getDuration());
+  }
+  EXPECT_GT(trajectories[3]->getDuration(), trajectories[0]->getDuration());
+
+  // Scaling factors have to be given for every trajectory
+  EXPECT_FALSE(totg.computeTimeStamps(trajectories, { 1.0 }, { 1.0 }).front());
+}
+
+TEST(time_optimal_trajectory_generation, testCachedRetiming)
+{
+  constexpr auto robot_name{ "panda" };
+  constexpr auto group_name{ "panda_arm" };
+
+  auto robot_model = moveit::core::loadTestingRobotModel(robot_name);
+  ASSERT_TRUE((bool)robot_model) << "Failed to load robot model" << robot_name;
+  auto group = robot_model->getJointModelGroup(group_name);
+  ASSERT_TRUE((bool)group) << "Failed to load joint model group " << group_name;
+  moveit::core::RobotState waypoint_state(robot_model);
+  waypoint_state.setToDefaultValues();
+
+  robot_trajectory::RobotTrajectory trajectory(robot_model, group);
+  waypoint_state.setJointGroupPositions(group, std::vector<double>{ -0.5, -3.52, 1.35, -2.51, -0.88, 0.63, 0.0 });
+  trajectory.addSuffixWayPoint(waypoint_state, 0.1);
+  waypoint_state.setJointGroupPositions(group, std::vector<double>{ 0.0, -3.5, 1.4, -1.2, -1.0, -0.2, 0.0 });
+  trajectory.addSuffixWayPoint(waypoint_state, 0.1);
+  waypoint_state.setJointGroupPositions(group, std::vector<double>{ -0.5, -3.52, 1.35, -2.51, -0.88, 0.63, 0.0 });
+  trajectory.addSuffixWayPoint(waypoint_state, 0.1);
+
+  TimeOptimalTrajectoryGeneration totg;
+  TimeOptimalTrajectoryGeneration::Cache cache;
+  robot_trajectory::RobotTrajectory retimed(trajectory, true /* deep copy */);
+  ASSERT_TRUE(totg.computeTimeStamps(retimed, cache, 1.0, 1.0));
+  EXPECT_FALSE(cache.empty());
+
+  // Re-timing the cached path gives the same result as parameterizing the original waypoints again
+  for (const auto& [velocity_scaling_factor, acceleration_scaling_factor] :
+       std::vector<std::pair<double, double>>{ { 0.5, 1.0 }, { 0.5, 0.25 }, { 0.1, 0.01 }, { 1.0, 1.0 } })
+  {
+    ASSERT_TRUE(totg.computeTimeStamps(retimed, cache, velocity_scaling_factor, acceleration_scaling_factor));
+    robot_trajectory::RobotTrajectory expected(trajectory, true /* deep copy */);
+    ASSERT_TRUE(totg.computeTimeStamps(expected, velocity_scaling_factor, acceleration_scaling_factor));
+    EXPECT_NEAR(retimed.getDuration(), expected.getDuration(), 0.01 * expected.getDuration());
+    for (size_t i = 0; i < group->getVariableCount(); ++i)
+    {
+      EXPECT_NEAR(retimed.getFirstWayPoint().getVariablePosition(i), expected.getFirstWayPoint().getVariablePosition(i),
+                  1e-9);
+      EXPECT_NEAR(retimed.getLastWayPoint().getVariablePosition(i), expected.getLastWayPoint().getVariablePosition(i),
+                  1e-9);
+    }
+  }
+
+  cache.clear();
+  EXPECT_TRUE(cache.empty());
+}
+
 TEST(time_optimal_trajectory_generation, testPluginAPI)
 {
   constexpr auto robot_name{ "panda" };
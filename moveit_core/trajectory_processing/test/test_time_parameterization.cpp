@@ -164,6 +164,33 @@ TEST(TestTimeParameterization, TestRepeatedPoint)
   ASSERT_LT(TRAJECTORY.getWayPointDurationFromStart(TRAJECTORY.getWayPointCount() - 1), 0.001);
 }
 
+TEST(TestTimeParameterization, TestIterativeSplineWorkspace)
+{
+  trajectory_processing::IterativeSplineParameterization time_parameterization(true);
+  trajectory_processing::IterativeSplineParameterization::Workspace workspace;
+  robot_trajectory::RobotTrajectory expected(RMODEL, "right_arm");
+  EXPECT_EQ(initStraightTrajectory(expected), 0);
+  EXPECT_TRUE(time_parameterization.computeTimeStamps(expected));
+
+  // Reusing a workspace, also after a shorter trajectory, gives the same result as a fresh one
+  for (auto init : { initStraightTrajectory, initRepeatedPointTrajectory, initStraightTrajectory })
+  {
+    EXPECT_EQ(init(TRAJECTORY), 0);
+    EXPECT_TRUE(time_parameterization.computeTimeStamps(TRAJECTORY, workspace));
+  }
+  ASSERT_EQ(TRAJECTORY.getWayPointCount(), expected.getWayPointCount());
+  for (size_t i = 0; i < expected.getWayPointCount(); ++i)
+  {
+    EXPECT_EQ(TRAJECTORY.getWayPointDurationFromPrevious(i), expected.getWayPointDurationFromPrevious(i));
+    for (int j : expected.getGroup()->getVariableIndexList())
+    {
+      EXPECT_EQ(TRAJECTORY.getWayPoint(i).getVariableVelocity(j), expected.getWayPoint(i).getVariableVelocity(j));
+      EXPECT_EQ(TRAJECTORY.getWayPoint(i).getVariableAcceleration(j),
+                expected.getWayPoint(i).getVariableAcceleration(j));
+    }
+  }
+}
+
 int main(int argc, char** argv)
 {
   testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,131 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <gtest/gtest.h>
+#include <moveit/robot_state/robot_state.h>
+#include <moveit/trajectory_processing/trajectory_resampling.h>
+#include <moveit/utils/robot_model_test_utils.h>
+
+namespace
+{
+constexpr auto GROUP_NAME{ "panda_arm" };
+}  // namespace
+
+class TrajectoryResamplingTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    robot_model_ = moveit::core::loadTestingRobotModel("panda");
+    group_ = robot_model_->getJointModelGroup(GROUP_NAME);
+    trajectory_ = std::make_shared<robot_trajectory::RobotTrajectory>(robot_model_, group_);
+
+    // A straight line in the first joint, with irregular spacing and a constant velocity
+    moveit::core::RobotState waypoint(robot_model_);
+    waypoint.setToDefaultValues();
+    waypoint.zeroVelocities();
+    waypoint.zeroAccelerations();
+    double time = 0.0;
+    for (double duration_from_previous : { 0.0, 0.013, 0.007, 0.021, 0.009, 0.01 })
+    {
+      time += duration_from_previous;
+      waypoint.setVariablePosition(0, time);
+      waypoint.setVariableVelocity(0, 1.0);
+      trajectory_->addSuffixWayPoint(waypoint, duration_from_previous);
+    }
+  }
+
+  moveit::core::RobotModelPtr robot_model_;
+  const moveit::core::JointModelGroup* group_;
+  robot_trajectory::RobotTrajectoryPtr trajectory_;
+};
+
+TEST_F(TrajectoryResamplingTest, ResampleToJointTrajectory)
+{
+  trajectory_msgs::msg::JointTrajectory joint_trajectory;
+  ASSERT_TRUE(trajectory_processing::resampleTrajectory(*trajectory_, 0.004, joint_trajectory));
+  EXPECT_EQ(joint_trajectory.joint_names.size(), group_->getActiveJointModels().size());
+
+  // 0.06 s at 4 ms gives 16 samples, including both ends
+  ASSERT_EQ(joint_trajectory.points.size(), 16u);
+  for (std::size_t i = 0; i < joint_trajectory.points.size(); ++i)
+  {
+    const trajectory_msgs::msg::JointTrajectoryPoint& point = joint_trajectory.points[i];
+    const double time = rclcpp::Duration(point.time_from_start).seconds();
+    EXPECT_NEAR(time, std::min(0.06, i * 0.004), 1e-9);
+    EXPECT_NEAR(point.positions[0], time, 1e-9);
+    ASSERT_EQ(point.velocities.size(), point.positions.size());
+    EXPECT_NEAR(point.velocities[0], 1.0, 1e-9);
+  }
+
+  // Resampling into the same message again gives the same result
+  const trajectory_msgs::msg::JointTrajectory expected = joint_trajectory;
+  ASSERT_TRUE(trajectory_processing::resampleTrajectory(*trajectory_, 0.004, joint_trajectory));
+  EXPECT_EQ(joint_trajectory, expected);
+
+  EXPECT_FALSE(trajectory_processing::resampleTrajectory(*trajectory_, 0.0, joint_trajectory));
+}
+
+TEST_F(TrajectoryResamplingTest, ResampleRobotTrajectory)
+{
+  ASSERT_TRUE(trajectory_processing::resampleTrajectory(*trajectory_, 0.004));
+  ASSERT_EQ(trajectory_->getWayPointCount(), 16u);
+  EXPECT_NEAR(trajectory_->getDuration(), 0.06, 1e-9);
+  for (std::size_t i = 1; i < trajectory_->getWayPointCount(); ++i)
+  {
+    EXPECT_NEAR(trajectory_->getWayPoint(i).getVariablePosition(0), trajectory_->getWayPointDurationFromStart(i), 1e-9);
+    EXPECT_NEAR(trajectory_->getWayPoint(i).getVariableVelocity(0), 1.0, 1e-9);
+  }
+}
+
+TEST_F(TrajectoryResamplingTest, Decimate)
+{
+  // All inner waypoints are on the line between the first and the last one
+  EXPECT_EQ(trajectory_processing::decimateTrajectory(*trajectory_, 1e-6), 4u);
+  ASSERT_EQ(trajectory_->getWayPointCount(), 2u);
+  EXPECT_NEAR(trajectory_->getDuration(), 0.06, 1e-9);
+
+  // A waypoint off the line is kept
+  moveit::core::RobotState waypoint(trajectory_->getLastWayPoint());
+  waypoint.setVariablePosition(0, 0.0);
+  trajectory_->addSuffixWayPoint(waypoint, 0.06);
+  EXPECT_EQ(trajectory_processing::decimateTrajectory(*trajectory_, 1e-6), 0u);
+  EXPECT_EQ(trajectory_->getWayPointCount(), 3u);
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
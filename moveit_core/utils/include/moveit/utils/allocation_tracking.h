@@ -0,0 +1,111 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#pragma once
+
+#include <cstddef>
+
+namespace moveit
+{
+namespace memory
+{
+/** \brief Number and total size in bytes of heap allocations */
+struct AllocationStats
+{
+  std::size_t count = 0;
+  std::size_t bytes = 0;
+
+  AllocationStats& operator+=(const AllocationStats& other)
+  {
+    count += other.count;
+    bytes += other.bytes;
+    return *this;
+  }
+
+  AllocationStats& operator-=(const AllocationStats& other)
+  {
+    count -= other.count;
+    bytes -= other.bytes;
+    return *this;
+  }
+};
+
+inline AllocationStats operator+(AllocationStats a, const AllocationStats& b)
+{
+  return a += b;
+}
+
+inline AllocationStats operator-(AllocationStats a, const AllocationStats& b)
+{
+  return a -= b;
+}
+
+/** \brief The allocations the calling thread made through operator new so far.
+ *
+ * Allocations are only counted if the moveit_allocation_tracking library, which replaces the global operator new, is
+ * loaded first, e.g. with LD_PRELOAD=libmoveit_allocation_tracking.so. Without it, all counts stay zero at no cost.
+ * Memory that is freed is not subtracted. */
+AllocationStats getThreadAllocationStats();
+
+/** \brief Whether allocations are counted, i.e. moveit_allocation_tracking is loaded */
+bool isAllocationTrackingEnabled();
+
+/** \brief Measures the allocations of the calling thread since its construction */
+class ScopedAllocationTracker
+{
+public:
+  ScopedAllocationTracker() : start_(getThreadAllocationStats())
+  {
+  }
+
+  /** \brief The allocations of the calling thread since the construction of the tracker */
+  AllocationStats getAllocations() const
+  {
+    return getThreadAllocationStats() - start_;
+  }
+
+private:
+  AllocationStats start_;
+};
+
+namespace detail
+{
+/** \brief Count an allocation of the calling thread, called by the operator new of moveit_allocation_tracking */
+void countAllocation(std::size_t bytes) noexcept;
+
+/** \brief Called when moveit_allocation_tracking is loaded */
+void enableAllocationTracking() noexcept;
+}  // namespace detail
+}  // namespace memory
+}  // namespace moveit
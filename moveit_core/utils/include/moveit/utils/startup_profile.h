@@ -0,0 +1,92 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+
+/** \file
+ * Wall clock time of the phases of a node's initialization, e.g. loading the robot model, the kinematics solvers,
+ * the planning pipelines and the move_group capabilities. Phases may be nested and may run concurrently, each is
+ * recorded with its start relative to the first phase of the process, so overlaps show up in the report.
+ */
+
+namespace moveit
+{
+namespace profiling
+{
+using StartupClock = std::chrono::steady_clock;
+
+struct StartupPhase
+{
+  std::string name;
+  /** \brief Seconds since the start of the first recorded phase */
+  double start;
+  /** \brief Seconds the phase took */
+  double duration;
+};
+
+/** \brief Record that \e phase ran from \e start to \e end, thread safe */
+void recordStartupPhase(const std::string& phase, StartupClock::time_point start, StartupClock::time_point end);
+
+/** \brief All recorded phases, ordered by their start */
+std::vector<StartupPhase> getStartupPhases();
+
+/** \brief A table of the recorded phases with their start offset, duration and share of the total startup time */
+std::string formatStartupProfile();
+
+/** \brief Records the time from its construction to its destruction as startup \e phase */
+class ScopedStartupPhase
+{
+public:
+  explicit ScopedStartupPhase(std::string phase) : phase_(std::move(phase)), start_(StartupClock::now())
+  {
+  }
+
+  ~ScopedStartupPhase()
+  {
+    recordStartupPhase(phase_, start_, StartupClock::now());
+  }
+
+  ScopedStartupPhase(const ScopedStartupPhase&) = delete;
+  ScopedStartupPhase& operator=(const ScopedStartupPhase&) = delete;
+
+private:
+  std::string phase_;
+  StartupClock::time_point start_;
+};
+}  // namespace profiling
+}  // namespace moveit
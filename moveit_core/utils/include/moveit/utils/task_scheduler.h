@@ -0,0 +1,134 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/** \file
+ * A process-wide pool of worker threads that the parallel parts of MoveIt submit their work to, instead of starting
+ * threads of their own. The number of workers is the core budget of the process: MOVEIT_TASK_SCHEDULER_THREADS if set
+ * in the environment, one per hardware thread otherwise. Every worker has a queue per priority class and takes the most
+ * urgent task it finds, first from its own queues, then from the shared ones and finally by stealing from the other
+ * workers. Tasks are not preempted, so long running tasks should be split into parts.
+ */
+
+namespace moveit
+{
+namespace scheduling
+{
+/** \brief Priority classes, most urgent first */
+enum class TaskPriority
+{
+  REALTIME = 0,  // e.g. servoing
+  EXECUTION,     // e.g. trajectory execution monitoring
+  PLANNING,      // motion planning, collision checking and IK
+  PERCEPTION,    // e.g. octomap updates
+  BACKGROUND,
+};
+
+class TaskScheduler
+{
+public:
+  /** \brief Start \e thread_count workers, at least one */
+  explicit TaskScheduler(std::size_t thread_count);
+
+  /** \brief Finish the queued tasks and stop the workers */
+  ~TaskScheduler();
+
+  TaskScheduler(const TaskScheduler&) = delete;
+  TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+  /** \brief Queue \e task to run on a worker. Tasks submitted from a worker are queued on that worker */
+  void submit(TaskPriority priority, std::function<void()> task);
+
+  /** \brief Call \e fn(participant, i) for every i in [0, \e count) and return when all calls finished.
+   *
+   * The calling thread takes part, together with up to \e max_participants - 1 workers (0 means all workers), so this
+   * makes progress even if all workers are busy and may be called from within tasks. \e participant is in
+   * [0, max_participants) and is the same for all calls on one thread, so callers can keep data per participant. If
+   * calls throw, the first exception is rethrown once all calls finished. */
+  void parallelFor(std::size_t count, std::size_t max_participants, TaskPriority priority,
+                   const std::function<void(std::size_t, std::size_t)>& fn);
+
+  /** \brief The number of workers */
+  std::size_t getThreadCount() const
+  {
+    return workers_.size();
+  }
+
+  /** \brief Whether the calling thread is one of the workers of this scheduler */
+  bool isWorkerThread() const;
+
+private:
+  static constexpr std::size_t PRIORITY_COUNT = static_cast<std::size_t>(TaskPriority::BACKGROUND) + 1;
+
+  struct TaskQueue
+  {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks[PRIORITY_COUNT];
+  };
+
+  struct Worker
+  {
+    TaskQueue queue;
+    std::thread thread;
+  };
+
+  void run(std::size_t index);
+
+  /** \brief Take the most urgent task for worker \e index (shared queues only if it is not a worker) */
+  bool takeTask(std::size_t index, std::function<void()>& task);
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  TaskQueue shared_queue_;
+
+  /// Number of queued tasks, guarded by wake_mutex_ for the sleeping workers
+  std::atomic<std::size_t> queued_tasks_{ 0 };
+  std::mutex wake_mutex_;
+  std::condition_variable wake_condition_;
+  bool stop_ = false;
+};
+
+/** \brief The scheduler shared by the whole process, started on first use */
+TaskScheduler& getTaskScheduler();
+}  // namespace scheduling
+}  // namespace moveit
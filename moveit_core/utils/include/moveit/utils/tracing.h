@@ -0,0 +1,109 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#pragma once
+
+#include <moveit/utils/tracing_config.h>
+
+/** \file
+ * LTTng tracepoints at the stage boundaries of planning and execution, for latency analysis of a request from the
+ * scene lock to the controller start. MoveIt has to be configured with -DMOVEIT_ENABLE_TRACING=ON for them to be
+ * compiled in, otherwise the macros expand to nothing and their arguments are not evaluated.
+ *
+ * Every stage emits moveit:stage_begin and moveit:stage_end with the name of the stage and a context pointer that
+ * identifies the request it belongs to. Record a session with
+ *
+ *   lttng create moveit && lttng enable-event -u 'moveit:*' && lttng add-context -u -t vtid && lttng start
+ *
+ * and analyze it with moveit_trace_latency.py of moveit_ros_benchmarks.
+ */
+
+#ifdef MOVEIT_TRACING_ENABLED
+
+namespace moveit
+{
+namespace tracing
+{
+/** \brief Emit moveit:stage_begin for \e stage, the string is copied into the trace */
+void stageBegin(const char* stage, const void* context);
+
+/** \brief Emit moveit:stage_end for \e stage */
+void stageEnd(const char* stage, const void* context, bool success);
+
+/** \brief Emits the begin of a stage on construction and its end on destruction, \e stage must outlive it */
+class ScopedStage
+{
+public:
+  ScopedStage(const char* stage, const void* context) : stage_(stage), context_(context), success_(true)
+  {
+    stageBegin(stage_, context_);
+  }
+
+  ~ScopedStage()
+  {
+    stageEnd(stage_, context_, success_);
+  }
+
+  ScopedStage(const ScopedStage&) = delete;
+  ScopedStage& operator=(const ScopedStage&) = delete;
+
+  /** \brief Set the success reported by the end of the stage */
+  void setSuccess(bool success)
+  {
+    success_ = success;
+  }
+
+private:
+  const char* stage_;
+  const void* context_;
+  bool success_;
+};
+}  // namespace tracing
+}  // namespace moveit
+
+#define MOVEIT_TRACE_STAGE_BEGIN(stage, context) ::moveit::tracing::stageBegin(stage, context)
+#define MOVEIT_TRACE_STAGE_END(stage, context, success) ::moveit::tracing::stageEnd(stage, context, success)
+/// Trace the remainder of the enclosing scope as \e stage, always reported as successful
+#define MOVEIT_TRACE_SCOPE(stage, context)                                                                             \
+  const ::moveit::tracing::ScopedStage MOVEIT_TRACE_CONCAT(moveit_trace_scope_, __LINE__)(stage, context)
+#define MOVEIT_TRACE_CONCAT(a, b) MOVEIT_TRACE_CONCAT_IMPL(a, b)
+#define MOVEIT_TRACE_CONCAT_IMPL(a, b) a##b
+
+#else
+
+#define MOVEIT_TRACE_STAGE_BEGIN(stage, context) ((void)0)
+#define MOVEIT_TRACE_STAGE_END(stage, context, success) ((void)0)
+#define MOVEIT_TRACE_SCOPE(stage, context) ((void)0)
+
+#endif
@@ -0,0 +1,95 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/utils/random_seed.h>
+#include <mutex>
+#include <random>
+
+namespace moveit
+{
+namespace core
+{
+namespace
+{
+struct SeedSequence
+{
+  std::mutex mutex;
+  std::optional<std::uint32_t> seed;
+  std::mt19937 generator;
+};
+
+SeedSequence& getSeedSequence()
+{
+  static SeedSequence sequence;
+  return sequence;
+}
+}  // namespace
+
+void setRandomSeed(std::uint32_t seed)
+{
+  SeedSequence& sequence = getSeedSequence();
+  std::scoped_lock lock(sequence.mutex);
+  sequence.seed = seed;
+  sequence.generator.seed(seed);
+}
+
+void clearRandomSeed()
+{
+  SeedSequence& sequence = getSeedSequence();
+  std::scoped_lock lock(sequence.mutex);
+  sequence.seed.reset();
+}
+
+std::optional<std::uint32_t> getRandomSeed()
+{
+  SeedSequence& sequence = getSeedSequence();
+  std::scoped_lock lock(sequence.mutex);
+  return sequence.seed;
+}
+
+random_numbers::RandomNumberGenerator makeRandomNumberGenerator()
+{
+  SeedSequence& sequence = getSeedSequence();
+  std::unique_lock lock(sequence.mutex);
+  if (!sequence.seed)
+  {
+    lock.unlock();
+    return random_numbers::RandomNumberGenerator();
+  }
+  const std::uint32_t seed = sequence.generator();
+  lock.unlock();
+  return random_numbers::RandomNumberGenerator(seed);
+}
+}  // namespace core
+}  // namespace moveit
@@ -0,0 +1,123 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+#include <moveit/utils/startup_profile.h>
+#include <algorithm>
+#include <cstdio>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+
+namespace moveit
+{
+namespace profiling
+{
+namespace
+{
+struct RecordedPhase
+{
+  std::string name;
+  StartupClock::time_point start;
+  StartupClock::time_point end;
+};
+
+struct StartupRecord
+{
+  std::mutex mutex;
+  std::vector<RecordedPhase> phases;
+};
+
+StartupRecord& getStartupRecord()
+{
+  static StartupRecord record;
+  return record;
+}
+
+double toSeconds(StartupClock::duration duration)
+{
+  return std::chrono::duration<double>(duration).count();
+}
+}  // namespace
+
+void recordStartupPhase(const std::string& phase, StartupClock::time_point start, StartupClock::time_point end)
+{
+  StartupRecord& record = getStartupRecord();
+  std::scoped_lock lock(record.mutex);
+  record.phases.push_back({ phase, start, end });
+}
+
+std::vector<StartupPhase> getStartupPhases()
+{
+  std::vector<RecordedPhase> recorded;
+  {
+    StartupRecord& record = getStartupRecord();
+    std::scoped_lock lock(record.mutex);
+    recorded = record.phases;
+  }
+  // phases are recorded when they end, so enclosing phases come after the phases nested in them
+  std::stable_sort(recorded.begin(), recorded.end(),
+                   [](const RecordedPhase& a, const RecordedPhase& b) { return a.start < b.start; });
+
+  std::vector<StartupPhase> phases;
+  phases.reserve(recorded.size());
+  for (const RecordedPhase& phase : recorded)
+    phases.push_back(
+        { phase.name, toSeconds(phase.start - recorded.front().start), toSeconds(phase.end - phase.start) });
+  return phases;
+}
+
+std::string formatStartupProfile()
+{
+  const std::vector<StartupPhase> phases = getStartupPhases();
+  double total = 0.0;
+  std::size_t name_width = 5;
+  for (const StartupPhase& phase : phases)
+  {
+    total = std::max(total, phase.start + phase.duration);
+    name_width = std::max(name_width, phase.name.size());
+  }
+
+  std::stringstream ss;
+  char line[64];
+  ss << std::fixed << std::setprecision(3) << "Startup profile (" << phases.size() << " phases, " << total << " s total)\n";
+  ss << "phase" << std::string(name_width - 5, ' ') << "    start [s]  duration [s]  share\n";
+  for (const StartupPhase& phase : phases)
+  {
+    std::snprintf(line, sizeof(line), "  %11.3f  %12.3f  %4.0f%%\n", phase.start, phase.duration,
+                  total > 0.0 ? 100.0 * phase.duration / total : 0.0);
+    ss << phase.name << std::string(name_width - phase.name.size(), ' ') << line;
+  }
+  return ss.str();
+}
+}  // namespace profiling
+}  // namespace moveit
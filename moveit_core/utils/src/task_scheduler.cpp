@@ -0,0 +1,248 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/utils/task_scheduler.h>
+#include <algorithm>
+#include <cstdlib>
+#include <exception>
+
+namespace moveit
+{
+namespace scheduling
+{
+namespace
+{
+// the scheduler and worker index of the calling thread, if it is a worker
+thread_local const TaskScheduler* current_scheduler = nullptr;
+thread_local std::size_t current_worker = 0;
+
+std::size_t getConfiguredThreadCount()
+{
+  if (const char* threads = std::getenv("MOVEIT_TASK_SCHEDULER_THREADS"))
+  {
+    const long count = std::strtol(threads, nullptr, 10);
+    if (count > 0)
+      return static_cast<std::size_t>(count);
+  }
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+bool popFront(std::deque<std::function<void()>>& tasks, std::function<void()>& task)
+{
+  if (tasks.empty())
+    return false;
+  task = std::move(tasks.front());
+  tasks.pop_front();
+  return true;
+}
+}  // namespace
+
+TaskScheduler::TaskScheduler(std::size_t thread_count)
+{
+  thread_count = std::max<std::size_t>(1, thread_count);
+  workers_.reserve(thread_count);
+  for (std::size_t i = 0; i < thread_count; ++i)
+    workers_.push_back(std::make_unique<Worker>());
+  // start the workers only once workers_ is complete, they steal from each other
+  for (std::size_t i = 0; i < thread_count; ++i)
+    workers_[i]->thread = std::thread(&TaskScheduler::run, this, i);
+}
+
+TaskScheduler::~TaskScheduler()
+{
+  {
+    std::scoped_lock lock(wake_mutex_);
+    stop_ = true;
+  }
+  wake_condition_.notify_all();
+  for (std::unique_ptr<Worker>& worker : workers_)
+    worker->thread.join();
+}
+
+bool TaskScheduler::isWorkerThread() const
+{
+  return current_scheduler == this;
+}
+
+void TaskScheduler::submit(TaskPriority priority, std::function<void()> task)
+{
+  TaskQueue& queue = isWorkerThread() ? workers_[current_worker]->queue : shared_queue_;
+  {
+    std::scoped_lock lock(queue.mutex);
+    queue.tasks[static_cast<std::size_t>(priority)].push_back(std::move(task));
+  }
+  {
+    // counted under the wake mutex, so that no worker misses it between checking the count and going to sleep
+    std::scoped_lock lock(wake_mutex_);
+    ++queued_tasks_;
+  }
+  wake_condition_.notify_one();
+}
+
+bool TaskScheduler::takeTask(std::size_t index, std::function<void()>& task)
+{
+  const bool is_worker = index < workers_.size();
+  for (std::size_t priority = 0; priority < PRIORITY_COUNT; ++priority)
+  {
+    if (is_worker)
+    {
+      // the most recently queued own task is the one most likely to still be in cache
+      TaskQueue& own = workers_[index]->queue;
+      std::scoped_lock lock(own.mutex);
+      if (!own.tasks[priority].empty())
+      {
+        task = std::move(own.tasks[priority].back());
+        own.tasks[priority].pop_back();
+        --queued_tasks_;
+        return true;
+      }
+    }
+    {
+      std::scoped_lock lock(shared_queue_.mutex);
+      if (popFront(shared_queue_.tasks[priority], task))
+      {
+        --queued_tasks_;
+        return true;
+      }
+    }
+    // steal the oldest task, starting at the next worker to spread the thieves
+    for (std::size_t k = 1; k < workers_.size(); ++k)
+    {
+      TaskQueue& victim = workers_[(index + k) % workers_.size()]->queue;
+      std::scoped_lock lock(victim.mutex);
+      if (popFront(victim.tasks[priority], task))
+      {
+        --queued_tasks_;
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+void TaskScheduler::run(std::size_t index)
+{
+  current_scheduler = this;
+  current_worker = index;
+
+  std::function<void()> task;
+  while (true)
+  {
+    if (takeTask(index, task))
+    {
+      task();
+      task = nullptr;  // release the captures before sleeping
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(wake_mutex_);
+    wake_condition_.wait(lock, [this] { return stop_ || queued_tasks_ > 0; });
+    // the queued tasks are finished before stopping
+    if (stop_ && queued_tasks_ == 0)
+      return;
+  }
+}
+
+void TaskScheduler::parallelFor(std::size_t count, std::size_t max_participants, TaskPriority priority,
+                                const std::function<void(std::size_t, std::size_t)>& fn)
+{
+  if (max_participants == 0)
+    max_participants = workers_.size() + 1;
+  const std::size_t participants = std::min({ max_participants, workers_.size() + 1, count });
+  if (participants <= 1)
+  {
+    for (std::size_t i = 0; i < count; ++i)
+      fn(0, i);
+    return;
+  }
+
+  // shared with the helper tasks, which may only start after this call returned
+  struct SharedState
+  {
+    const std::function<void(std::size_t, std::size_t)>* fn;
+    std::size_t count;
+    std::atomic<std::size_t> next{ 0 };
+    std::atomic<std::size_t> finished{ 0 };
+    std::atomic<std::size_t> next_participant{ 1 };
+    std::mutex mutex;
+    std::condition_variable all_finished;
+    std::exception_ptr error;
+  };
+  auto state = std::make_shared<SharedState>();
+  state->fn = &fn;
+  state->count = count;
+
+  const auto work = [](SharedState& state, std::size_t participant) {
+    for (std::size_t i = state.next++; i < state.count; i = state.next++)
+    {
+      try
+      {
+        (*state.fn)(participant, i);
+      }
+      catch (...)
+      {
+        std::scoped_lock lock(state.mutex);
+        if (!state.error)
+          state.error = std::current_exception();
+      }
+      if (++state.finished == state.count)
+      {
+        std::scoped_lock lock(state.mutex);
+        state.all_finished.notify_all();
+      }
+    }
+  };
+
+  for (std::size_t p = 1; p < participants; ++p)
+    submit(priority, [state, work] {
+      // all calls were claimed already, fn may not even exist anymore
+      if (state->next >= state->count)
+        return;
+      work(*state, state->next_participant++);
+    });
+
+  work(*state, 0);
+  std::unique_lock<std::mutex> lock(state->mutex);
+  state->all_finished.wait(lock, [&state] { return state->finished == state->count; });
+  if (state->error)
+    std::rethrow_exception(state->error);
+}
+
+TaskScheduler& getTaskScheduler()
+{
+  static TaskScheduler scheduler(getConfiguredThreadCount());
+  return scheduler;
+}
+}  // namespace scheduling
+}  // namespace moveit
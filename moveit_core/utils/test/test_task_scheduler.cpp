@@ -0,0 +1,138 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <gtest/gtest.h>
+#include <moveit/utils/task_scheduler.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using moveit::scheduling::TaskPriority;
+using moveit::scheduling::TaskScheduler;
+
+TEST(TaskScheduler, ParallelForVisitsEveryIndexOnce)
+{
+  TaskScheduler scheduler(4);
+  EXPECT_EQ(scheduler.getThreadCount(), 4u);
+  EXPECT_FALSE(scheduler.isWorkerThread());
+
+  const std::size_t count = 10000;
+  std::vector<std::atomic<int>> visits(count);
+  std::vector<std::atomic<int>> participants(3);
+  scheduler.parallelFor(count, 3, TaskPriority::PLANNING, [&](std::size_t participant, std::size_t i) {
+    ASSERT_LT(participant, 3u);
+    ++participants[participant];
+    ++visits[i];
+  });
+  for (const std::atomic<int>& visit : visits)
+    EXPECT_EQ(visit, 1);
+  EXPECT_EQ(participants[0] + participants[1] + participants[2], static_cast<int>(count));
+}
+
+TEST(TaskScheduler, ParallelForRethrows)
+{
+  TaskScheduler scheduler(2);
+  std::atomic<std::size_t> calls{ 0 };
+  EXPECT_THROW(scheduler.parallelFor(100, 0, TaskPriority::PLANNING,
+                                     [&](std::size_t /*participant*/, std::size_t i) {
+                                       ++calls;
+                                       if (i == 42)
+                                         throw std::runtime_error("failed");
+                                     }),
+               std::runtime_error);
+  EXPECT_EQ(calls, 100u);
+}
+
+TEST(TaskScheduler, NestedParallelFor)
+{
+  TaskScheduler scheduler(2);
+  std::atomic<std::size_t> calls{ 0 };
+  scheduler.parallelFor(8, 0, TaskPriority::PLANNING, [&](std::size_t /*participant*/, std::size_t /*i*/) {
+    scheduler.parallelFor(8, 0, TaskPriority::PLANNING, [&](std::size_t, std::size_t) { ++calls; });
+  });
+  EXPECT_EQ(calls, 64u);
+}
+
+TEST(TaskScheduler, UrgentTasksRunFirst)
+{
+  // a single worker, blocked until all tasks are queued, takes them by priority
+  TaskScheduler scheduler(1);
+  std::mutex gate;
+  std::unique_lock<std::mutex> lock(gate);
+  scheduler.submit(TaskPriority::REALTIME, [&gate] { std::scoped_lock wait(gate); });
+  // give the worker time to take the gate task
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+  std::mutex order_mutex;
+  std::vector<TaskPriority> order;
+  for (TaskPriority priority : { TaskPriority::BACKGROUND, TaskPriority::PLANNING, TaskPriority::REALTIME,
+                                 TaskPriority::PERCEPTION, TaskPriority::EXECUTION })
+    scheduler.submit(priority, [&order_mutex, &order, priority] {
+      std::scoped_lock order_lock(order_mutex);
+      order.push_back(priority);
+    });
+  lock.unlock();
+
+  while (true)
+  {
+    {
+      std::scoped_lock order_lock(order_mutex);
+      if (order.size() == 5)
+        break;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(order, (std::vector<TaskPriority>{ TaskPriority::REALTIME, TaskPriority::EXECUTION, TaskPriority::PLANNING,
+                                               TaskPriority::PERCEPTION, TaskPriority::BACKGROUND }));
+}
+
+TEST(TaskScheduler, DestructorFinishesQueuedTasks)
+{
+  std::atomic<std::size_t> calls{ 0 };
+  {
+    TaskScheduler scheduler(2);
+    for (std::size_t i = 0; i < 100; ++i)
+      scheduler.submit(TaskPriority::BACKGROUND, [&calls] { ++calls; });
+  }
+  EXPECT_EQ(calls, 100u);
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -61,6 +61,7 @@ void CachedIKKinematicsPlugin<KinematicsPlugin>::initCache(const std::string& ro
   kinematics::KinematicsBase::lookupParam(node_, "min_pose_distance", opts.min_pose_distance, 1.0);
   kinematics::KinematicsBase::lookupParam(node_, "min_joint_config_distance", opts.min_joint_config_distance, 1.0);
   kinematics::KinematicsBase::lookupParam<std::string>(node_, "cached_ik_path", opts.cached_ik_path, "");
+  kinematics::KinematicsBase::lookupParam<std::string>(node_, "mapped_ik_cache_file", opts.mapped_cache_file, "");
 
   cache_.initializeCache(robot_id, group_name, cache_name, KinematicsPlugin::getJointNames().size(), opts);
 
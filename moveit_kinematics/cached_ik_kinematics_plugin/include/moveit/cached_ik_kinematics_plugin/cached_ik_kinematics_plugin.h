@@ -42,6 +42,8 @@
 #include <moveit/robot_model/robot_model.h>
 #include <tf2/LinearMath/Quaternion.h>
 #include <tf2/LinearMath/Vector3.h>
+#include <cstdint>
+#include <memory>
 #include <mutex>
 #include <unordered_map>
 #include <utility>
@@ -52,19 +54,28 @@ namespace cached_ik_kinematics_plugin
 static const rclcpp::Logger LOGGER =
     rclcpp::get_logger("moveit_cached_ik_kinematics_plugin.cached_ik_kinematics_plugin");
 
+class MappedIKCache;
+
 /** \brief A cache of inverse kinematic solutions */
 class IKCache
 {
 public:
   struct Options
   {
-    Options() : max_cache_size(5000), min_pose_distance(1.0), min_joint_config_distance(1.0), cached_ik_path("")
+    Options()
+      : max_cache_size(5000)
+      , min_pose_distance(1.0)
+      , min_joint_config_distance(1.0)
+      , cached_ik_path("")
+      , mapped_cache_file("")
     {
     }
     unsigned int max_cache_size;
     double min_pose_distance;
     double min_joint_config_distance;
     std::string cached_ik_path;
+    /** read-only cache written by MappedIKCache, looked up in addition to the cache entries */
+    std::string mapped_cache_file;
   };
 
   /**
@@ -114,6 +125,8 @@ public:
   void updateCache(const IKEntry& nearest, const std::vector<Pose>& poses, const std::vector<double>& config) const;
   /** verify with forward kinematics that the cache entries are correct */
   void verifyCache(kdl_kinematics_plugin::KDLKinematicsPlugin& fk) const;
+  /** write the cache entries to a file that can be used as Options::mapped_cache_file */
+  bool exportMappedCache(const std::filesystem::path& file_name) const;
 
 protected:
   /** compute the distance between two joint configurations */
@@ -146,6 +159,78 @@ protected:
   mutable unsigned int last_saved_cache_size_{ 0 };
   /** mutex for changing IK cache */
   mutable std::mutex lock_;
+  /** read-only cache shared with other processes, if Options::mapped_cache_file is set */
+  std::unique_ptr<MappedIKCache> mapped_cache_;
+};
+
+/**
+  \brief A read-only cache of IK solutions in a memory-mapped file
+
+  All processes that map the same file share its pages, so a large cache
+  generated offline is neither loaded nor copied by every process. The
+  entries are stored in the order of an implicit, balanced kd-tree over the
+  tip positions, which answers nearest-neighbor queries under the metric of
+  IKCache::Pose::distance directly from the mapped memory.
+*/
+class MappedIKCache
+{
+public:
+  using IKEntry = IKCache::IKEntry;
+  using Pose = IKCache::Pose;
+
+  MappedIKCache() = default;
+  ~MappedIKCache();
+  MappedIKCache(const MappedIKCache&) = delete;
+  MappedIKCache& operator=(const MappedIKCache&) = delete;
+
+  /** map a file written by write(), fails if its configurations do not have num_joints joints */
+  bool open(const std::filesystem::path& file_name, unsigned int num_joints);
+  /** number of entries in the mapped file */
+  std::size_t size() const
+  {
+    return num_entries_;
+  }
+  /**
+    find the entry closest to poses and its distance to them, fails if
+    nothing is mapped or the entries have a different number of tips
+  */
+  bool nearest(const std::vector<Pose>& poses, IKEntry& nearest_entry, double& nearest_distance) const;
+
+  /** write entries with equal numbers of tips and joints to a file in the mapped format */
+  static bool write(const std::filesystem::path& file_name, const std::vector<IKEntry>& entries);
+  /**
+    offline cache generation: sample num_samples random configurations of a
+    group on all cores and write the poses of tip_frames relative to
+    base_frame with the group's joint values to a file in the mapped format
+  */
+  static bool generate(const moveit::core::RobotModelConstPtr& robot_model, const std::string& group_name,
+                       const std::string& base_frame, const std::vector<std::string>& tip_frames,
+                       std::size_t num_samples, const std::filesystem::path& file_name);
+
+protected:
+  /** pointer to the tip poses of an entry, followed by its configuration */
+  const double* entry(std::size_t index) const
+  {
+    return entries_ + index * entry_size_;
+  }
+  /** distance between poses and the tip poses of an entry */
+  double distance(const std::vector<Pose>& poses, std::size_t index) const;
+  /** search the kd-tree of the entries [begin, end) for a closer entry than best */
+  void search(const std::vector<Pose>& poses, std::size_t begin, std::size_t end, std::size_t& best,
+              double& best_distance) const;
+
+  void* data_{ nullptr };
+  std::size_t data_size_{ 0 };
+  std::size_t num_entries_{ 0 };
+  unsigned int num_tips_{ 0 };
+  unsigned int num_joints_{ 0 };
+  /** entries of the same size as the leaves of the kd-tree are searched linearly */
+  unsigned int leaf_size_{ 0 };
+  /** number of values of an entry: 7 per tip pose, followed by the joint values */
+  std::size_t entry_size_{ 0 };
+  const double* entries_{ nullptr };
+  /** position coordinate along which the kd-tree node of each entry splits its subtree */
+  const std::uint32_t* split_dims_{ nullptr };
 };
 
 /** a container of IK caches for cases where there is no fixed base frame */
@@ -42,15 +42,22 @@
 
 namespace cached_ik_kinematics_plugin
 {
+namespace
+{
+double posesDistance(const std::vector<IKCache::Pose>& poses1, const std::vector<IKCache::Pose>& poses2)
+{
+  double dist = 0.;
+  for (unsigned int i = 0; i < poses1.size(); ++i)
+    dist += poses1[i].distance(poses2[i]);
+  return dist;
+}
+}  // namespace
+
 IKCache::IKCache()
 {
   // set distance function for nearest-neighbor queries
-  ik_nn_.setDistanceFunction([](const IKEntry* entry1, const IKEntry* entry2) {
-    double dist = 0.;
-    for (unsigned int i = 0; i < entry1->first.size(); ++i)
-      dist += entry1->first[i].distance(entry2->first[i]);
-    return dist;
-  });
+  ik_nn_.setDistanceFunction(
+      [](const IKEntry* entry1, const IKEntry* entry2) { return posesDistance(entry1->first, entry2->first); });
 }
 
 IKCache::~IKCache()
@@ -134,6 +141,17 @@ void IKCache::initializeCache(const std::string& robot_id, const std::string& gr
 
   num_joints_ = num_joints;
 
+  mapped_cache_.reset();
+  if (!opts.mapped_cache_file.empty())
+  {
+    auto mapped_cache = std::make_unique<MappedIKCache>();
+    if (mapped_cache->open(opts.mapped_cache_file, num_joints))
+    {
+      RCLCPP_INFO(LOGGER, "Mapped %zu IK solutions from %s", mapped_cache->size(), opts.mapped_cache_file.c_str());
+      mapped_cache_ = std::move(mapped_cache);
+    }
+  }
+
   RCLCPP_INFO(LOGGER, "cache file %s initialized!", cache_file_name_.string().c_str());
 }
 
@@ -150,6 +168,8 @@ double IKCache::configDistance2(const std::vector<double>& config1, const std::v
 
 const IKCache::IKEntry& IKCache::getBestApproximateIKSolution(const Pose& pose) const
 {
+  if (mapped_cache_)
+    return getBestApproximateIKSolution(std::vector<Pose>(1, pose));
   if (ik_cache_.empty())
   {
     static IKEntry dummy = std::make_pair(std::vector<Pose>(1, pose), std::vector<double>(num_joints_, 0.));
@@ -161,13 +181,27 @@ const IKCache::IKEntry& IKCache::getBestApproximateIKSolution(const Pose& pose)
 
 const IKCache::IKEntry& IKCache::getBestApproximateIKSolution(const std::vector<Pose>& poses) const
 {
-  if (ik_cache_.empty())
+  const IKEntry* nearest = nullptr;
+  if (!ik_cache_.empty())
+  {
+    IKEntry query = std::make_pair(poses, std::vector<double>());
+    nearest = ik_nn_.nearest(&query);
+  }
+  if (mapped_cache_)
+  {
+    // the mapped entry is copied into memory of the calling thread, which stays valid until its next query
+    thread_local IKEntry mapped_nearest;
+    double mapped_distance;
+    if (mapped_cache_->nearest(poses, mapped_nearest, mapped_distance) &&
+        (!nearest || mapped_distance < posesDistance(nearest->first, poses)))
+      return mapped_nearest;
+  }
+  if (!nearest)
   {
     static IKEntry dummy = std::make_pair(poses, std::vector<double>(num_joints_, 0.));
     return dummy;
   }
-  IKEntry query = std::make_pair(poses, std::vector<double>());
-  return *ik_nn_.nearest(&query);
+  return *nearest;
 }
 
 void IKCache::updateCache(const IKEntry& nearest, const Pose& pose, const std::vector<double>& config) const
@@ -271,6 +305,12 @@ void IKCache::verifyCache(kdl_kinematics_plugin::KDLKinematicsPlugin& fk) const
   RCLCPP_INFO(LOGGER, "Max. error in cache entries is %g", max_error);
 }
 
+bool IKCache::exportMappedCache(const std::filesystem::path& file_name) const
+{
+  std::lock_guard<std::mutex> slock(lock_);
+  return MappedIKCache::write(file_name, ik_cache_);
+}
+
 IKCache::Pose::Pose(const geometry_msgs::msg::Pose& pose)
 {
   position.setX(pose.position.x);
@@ -0,0 +1,379 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/cached_ik_kinematics_plugin/cached_ik_kinematics_plugin.h>
+#include <moveit/robot_state/robot_state.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <numeric>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace cached_ik_kinematics_plugin
+{
+namespace
+{
+const char MAGIC[8] = { 'M', 'V', 'I', 'K', 'M', 'A', 'P', '\0' };
+const std::uint32_t FORMAT_VERSION = 1;
+const std::uint32_t KD_TREE_LEAF_SIZE = 8;
+// number of values of a pose: position followed by the orientation quaternion (x, y, z, w)
+const std::size_t POSE_SIZE = 7;
+
+// header of the files of MappedIKCache, followed by the entries in kd-tree order and the split dimension of each entry
+struct MappedFileHeader
+{
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t num_tips;
+  std::uint32_t num_joints;
+  std::uint32_t leaf_size;
+  std::uint64_t num_entries;
+};
+
+double positionCoordinate(const IKCache::IKEntry& entry, std::uint32_t dim)
+{
+  return entry.first[dim / 3].position[dim % 3];
+}
+
+// Arrange order[begin, end) as an implicit kd-tree: the middle entry of a range splits the range along its split_dims
+void buildKdTree(const std::vector<IKCache::IKEntry>& entries, std::vector<std::size_t>& order,
+                 std::vector<std::uint32_t>& split_dims, std::size_t begin, std::size_t end)
+{
+  if (end - begin <= KD_TREE_LEAF_SIZE)
+    return;
+
+  // split along the position coordinate with the largest extent
+  const std::uint32_t num_dims = 3 * entries[order[begin]].first.size();
+  std::uint32_t split_dim = 0;
+  double max_extent = -1.0;
+  for (std::uint32_t dim = 0; dim < num_dims; ++dim)
+  {
+    double min = std::numeric_limits<double>::infinity();
+    double max = -min;
+    for (std::size_t i = begin; i < end; ++i)
+    {
+      const double value = positionCoordinate(entries[order[i]], dim);
+      min = std::min(min, value);
+      max = std::max(max, value);
+    }
+    if (max - min > max_extent)
+    {
+      max_extent = max - min;
+      split_dim = dim;
+    }
+  }
+
+  const std::size_t middle = begin + (end - begin) / 2;
+  std::nth_element(order.begin() + begin, order.begin() + middle, order.begin() + end,
+                   [&](std::size_t a, std::size_t b) {
+                     return positionCoordinate(entries[a], split_dim) < positionCoordinate(entries[b], split_dim);
+                   });
+  split_dims[middle] = split_dim;
+  buildKdTree(entries, order, split_dims, begin, middle);
+  buildKdTree(entries, order, split_dims, middle + 1, end);
+}
+
+IKCache::Pose poseFromValues(const double* values)
+{
+  IKCache::Pose pose;
+  pose.position.setValue(values[0], values[1], values[2]);
+  pose.orientation = tf2::Quaternion(values[3], values[4], values[5], values[6]);
+  return pose;
+}
+}  // namespace
+
+MappedIKCache::~MappedIKCache()
+{
+  if (data_)
+    munmap(data_, data_size_);
+}
+
+bool MappedIKCache::open(const std::filesystem::path& file_name, unsigned int num_joints)
+{
+  if (data_)
+    munmap(data_, data_size_);
+  data_ = nullptr;
+  num_entries_ = 0;
+
+  int fd = ::open(file_name.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    RCLCPP_ERROR(LOGGER, "Unable to open %s: %s", file_name.string().c_str(), std::strerror(errno));
+    return false;
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0 || static_cast<std::size_t>(file_stat.st_size) < sizeof(MappedFileHeader))
+  {
+    ::close(fd);
+    RCLCPP_ERROR(LOGGER, "%s is not a mapped IK cache", file_name.string().c_str());
+    return false;
+  }
+  const std::size_t data_size = file_stat.st_size;
+  void* data = mmap(nullptr, data_size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (data == MAP_FAILED)
+  {
+    RCLCPP_ERROR(LOGGER, "Unable to map %s: %s", file_name.string().c_str(), std::strerror(errno));
+    return false;
+  }
+
+  MappedFileHeader header;
+  std::memcpy(&header, data, sizeof(header));
+  // the counts are checked against the file size before computing the section sizes, to avoid overflows
+  const std::uint64_t max_count = data_size / sizeof(double);
+  const std::uint64_t entry_size = POSE_SIZE * std::uint64_t(header.num_tips) + header.num_joints;
+  std::string error;
+  if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0)
+    error = "is not a mapped IK cache";
+  else if (header.version != FORMAT_VERSION)
+    error = "has format version " + std::to_string(header.version) + " instead of " + std::to_string(FORMAT_VERSION);
+  else if (header.num_joints != num_joints)
+    error = "holds configurations of " + std::to_string(header.num_joints) + " instead of " +
+            std::to_string(num_joints) + " joints";
+  else if (header.num_tips == 0 || header.leaf_size == 0 || entry_size > max_count ||
+           header.num_entries > data_size / (entry_size * sizeof(double) + sizeof(std::uint32_t)) ||
+           sizeof(MappedFileHeader) + header.num_entries * (entry_size * sizeof(double) + sizeof(std::uint32_t)) !=
+               data_size)
+    error = "is truncated";
+  if (!error.empty())
+  {
+    munmap(data, data_size);
+    RCLCPP_ERROR(LOGGER, "%s %s", file_name.string().c_str(), error.c_str());
+    return false;
+  }
+
+  data_ = data;
+  data_size_ = data_size;
+  num_entries_ = header.num_entries;
+  num_tips_ = header.num_tips;
+  num_joints_ = header.num_joints;
+  leaf_size_ = header.leaf_size;
+  entry_size_ = entry_size;
+  entries_ = reinterpret_cast<const double*>(static_cast<const char*>(data_) + sizeof(MappedFileHeader));
+  split_dims_ = reinterpret_cast<const std::uint32_t*>(entries_ + num_entries_ * entry_size_);
+  return true;
+}
+
+double MappedIKCache::distance(const std::vector<Pose>& poses, std::size_t index) const
+{
+  const double* values = entry(index);
+  double dist = 0.;
+  for (std::size_t i = 0; i < poses.size(); ++i)
+    dist += poseFromValues(values + i * POSE_SIZE).distance(poses[i]);
+  return dist;
+}
+
+void MappedIKCache::search(const std::vector<Pose>& poses, std::size_t begin, std::size_t end, std::size_t& best,
+                           double& best_distance) const
+{
+  const auto visit = [&](std::size_t index) {
+    const double dist = distance(poses, index);
+    if (dist < best_distance)
+    {
+      best_distance = dist;
+      best = index;
+    }
+  };
+  if (end - begin <= leaf_size_)
+  {
+    for (std::size_t i = begin; i < end; ++i)
+      visit(i);
+    return;
+  }
+
+  const std::size_t middle = begin + (end - begin) / 2;
+  visit(middle);
+  // the distance to any entry beyond the split is at least the distance of the query to the split, as the distance
+  // of a tip position along one coordinate is a lower bound of the pose distance
+  const std::uint32_t dim = split_dims_[middle];
+  const double offset = poses[dim / 3].position[dim % 3] - entry(middle)[(dim / 3) * POSE_SIZE + dim % 3];
+  if (offset < 0.)
+  {
+    search(poses, begin, middle, best, best_distance);
+    if (-offset < best_distance)
+      search(poses, middle + 1, end, best, best_distance);
+  }
+  else
+  {
+    search(poses, middle + 1, end, best, best_distance);
+    if (offset < best_distance)
+      search(poses, begin, middle, best, best_distance);
+  }
+}
+
+bool MappedIKCache::nearest(const std::vector<Pose>& poses, IKEntry& nearest_entry, double& nearest_distance) const
+{
+  if (num_entries_ == 0 || poses.size() != num_tips_)
+    return false;
+
+  std::size_t best = 0;
+  nearest_distance = std::numeric_limits<double>::infinity();
+  search(poses, 0, num_entries_, best, nearest_distance);
+
+  const double* values = entry(best);
+  nearest_entry.first.resize(num_tips_);
+  for (unsigned int i = 0; i < num_tips_; ++i)
+    nearest_entry.first[i] = poseFromValues(values + i * POSE_SIZE);
+  nearest_entry.second.assign(values + num_tips_ * POSE_SIZE, values + entry_size_);
+  return true;
+}
+
+bool MappedIKCache::write(const std::filesystem::path& file_name, const std::vector<IKEntry>& entries)
+{
+  if (entries.empty())
+  {
+    RCLCPP_ERROR(LOGGER, "Not writing an empty IK cache to %s", file_name.string().c_str());
+    return false;
+  }
+  const std::size_t num_tips = entries[0].first.size();
+  const std::size_t num_joints = entries[0].second.size();
+  for (const IKEntry& entry : entries)
+    if (entry.first.size() != num_tips || entry.second.size() != num_joints)
+    {
+      RCLCPP_ERROR(LOGGER, "IK cache entries differ in their number of tips or joints");
+      return false;
+    }
+
+  std::vector<std::size_t> order(entries.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::vector<std::uint32_t> split_dims(entries.size(), 0);
+  buildKdTree(entries, order, split_dims, 0, entries.size());
+
+  MappedFileHeader header;
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = FORMAT_VERSION;
+  header.num_tips = num_tips;
+  header.num_joints = num_joints;
+  header.leaf_size = KD_TREE_LEAF_SIZE;
+  header.num_entries = entries.size();
+
+  std::filesystem::path temporary = file_name;
+  temporary += ".tmp";
+  {
+    std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    std::vector<double> values;
+    values.reserve(num_tips * POSE_SIZE + num_joints);
+    for (std::size_t index : order)
+    {
+      values.clear();
+      for (const Pose& pose : entries[index].first)
+        values.insert(values.end(), { pose.position.x(), pose.position.y(), pose.position.z(), pose.orientation.x(),
+                                      pose.orientation.y(), pose.orientation.z(), pose.orientation.w() });
+      values.insert(values.end(), entries[index].second.begin(), entries[index].second.end());
+      out.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(double));
+    }
+    out.write(reinterpret_cast<const char*>(split_dims.data()), split_dims.size() * sizeof(std::uint32_t));
+    if (!out.good())
+    {
+      RCLCPP_ERROR(LOGGER, "Unable to write %s", temporary.string().c_str());
+      out.close();
+      std::error_code ec;
+      std::filesystem::remove(temporary, ec);
+      return false;
+    }
+  }
+
+  // replace the file instead of overwriting it, which would modify the cache of processes that mapped it
+  std::error_code ec;
+  std::filesystem::rename(temporary, file_name, ec);
+  if (ec)
+  {
+    RCLCPP_ERROR(LOGGER, "Unable to write %s: %s", file_name.string().c_str(), ec.message().c_str());
+    std::filesystem::remove(temporary, ec);
+    return false;
+  }
+  RCLCPP_INFO(LOGGER, "Wrote %zu IK solutions to %s", entries.size(), file_name.string().c_str());
+  return true;
+}
+
+bool MappedIKCache::generate(const moveit::core::RobotModelConstPtr& robot_model, const std::string& group_name,
+                             const std::string& base_frame, const std::vector<std::string>& tip_frames,
+                             std::size_t num_samples, const std::filesystem::path& file_name)
+{
+  const moveit::core::JointModelGroup* group = robot_model->getJointModelGroup(group_name);
+  if (!group)
+    return false;
+  if (!robot_model->hasLinkModel(base_frame) ||
+      !std::all_of(tip_frames.begin(), tip_frames.end(),
+                   [&](const std::string& tip_frame) { return robot_model->hasLinkModel(tip_frame); }))
+  {
+    RCLCPP_ERROR(LOGGER, "The base and tip frames of the IK cache must be links of robot %s",
+                 robot_model->getName().c_str());
+    return false;
+  }
+
+  std::vector<IKEntry> entries(num_samples);
+  const auto sample = [&](std::size_t begin, std::size_t end) {
+    moveit::core::RobotState state(robot_model);
+    state.setToDefaultValues();
+    random_numbers::RandomNumberGenerator rng;
+    for (std::size_t i = begin; i < end; ++i)
+    {
+      state.setToRandomPositions(group, rng);
+      state.updateLinkTransforms();
+      const Eigen::Isometry3d base_inverse = state.getGlobalLinkTransform(base_frame).inverse();
+      entries[i].first.resize(tip_frames.size());
+      for (std::size_t j = 0; j < tip_frames.size(); ++j)
+      {
+        const Eigen::Isometry3d tip = base_inverse * state.getGlobalLinkTransform(tip_frames[j]);
+        const Eigen::Quaterniond orientation(tip.linear());
+        entries[i].first[j].position.setValue(tip.translation().x(), tip.translation().y(), tip.translation().z());
+        entries[i].first[j].orientation =
+            tf2::Quaternion(orientation.x(), orientation.y(), orientation.z(), orientation.w());
+      }
+      state.copyJointGroupPositions(group, entries[i].second);
+    }
+  };
+
+  // every thread samples a contiguous range of the entries with its own state and random number generator
+  const std::size_t num_threads = std::min<std::size_t>(std::max(1u, std::thread::hardware_concurrency()), num_samples);
+  std::vector<std::thread> threads;
+  for (std::size_t i = 1; i < num_threads; ++i)
+    threads.emplace_back(sample, i * num_samples / num_threads, (i + 1) * num_samples / num_threads);
+  sample(0, num_samples / std::max<std::size_t>(num_threads, 1));
+  for (std::thread& thread : threads)
+    thread.join();
+
+  return write(file_name, entries);
+}
+}  // namespace cached_ik_kinematics_plugin
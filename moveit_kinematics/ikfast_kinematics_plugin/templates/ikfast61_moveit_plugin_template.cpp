@@ -45,6 +45,8 @@
 #include <moveit/kinematics_base/kinematics_base.h>
 #include <moveit/robot_state/robot_state.h>
 #include <Eigen/Geometry>
+#include <limits>
+#include <numeric>
 #if __has_include(<tf2_kdl/tf2_kdl.hpp>)
 #include <tf2_kdl/tf2_kdl.hpp>
 #else
@@ -304,6 +306,15 @@ public:
       const IKCallbackFn& solution_callback, moveit_msgs::msg::MoveItErrorCodes& error_code,
       const kinematics::KinematicsQueryOptions& options = kinematics::KinematicsQueryOptions()) const override;
 
+  /**
+   * @brief Solves the poses concurrently. The analytic solver keeps no state between calls, so the threads share it.
+   */
+  bool searchPositionIKBatch(
+      const std::vector<geometry_msgs::msg::Pose>& ik_poses, const std::vector<std::vector<double>>& ik_seed_states,
+      double timeout_per_pose, std::vector<std::vector<double>>& solutions,
+      std::vector<moveit_msgs::msg::MoveItErrorCodes>& error_codes,
+      const kinematics::KinematicsQueryOptions& options = kinematics::KinematicsQueryOptions()) const override;
+
   /**
    * @brief Given a set of joint angles and a set of links, compute their pose
    *
@@ -358,6 +369,14 @@ private:
    */
   double enforceLimits(double val, double min, double max) const;
 
+  /**
+   * @brief Solves for all discretizations of the free joint, in the order of the search, and returns the solutions
+   * (rotated towards the seed state) that obey the joint limits as the columns of a matrix
+   */
+  Eigen::MatrixXd enumerateSolutions(KDL::Frame& frame, const std::vector<double>& ik_seed_state, double initial_guess,
+                                     double search_discretization, int num_positive_increments,
+                                     int num_negative_increments) const;
+
   void fillFreeParams(int count, int* array);
   bool getCount(int& count, const int& max_count, const int& min_count) const;
 
@@ -771,6 +790,27 @@ bool IKFastKinematicsPlugin::getCount(int& count, const int& max_count, const in
   }
 }
 
+bool IKFastKinematicsPlugin::searchPositionIKBatch(const std::vector<geometry_msgs::msg::Pose>& ik_poses,
+                                                   const std::vector<std::vector<double>>& ik_seed_states,
+                                                   double timeout_per_pose,
+                                                   std::vector<std::vector<double>>& solutions,
+                                                   std::vector<moveit_msgs::msg::MoveItErrorCodes>& error_codes,
+                                                   const kinematics::KinematicsQueryOptions& options) const
+{
+  if (!prepareBatch(ik_poses, ik_seed_states, solutions, error_codes))
+    return false;
+
+  // std::vector<bool> packs its elements, so the threads write to a byte each
+  std::vector<char> solved(ik_poses.size(), false);
+  solveBatchConcurrently(ik_poses.size(), [&]() -> std::function<void(std::size_t)> {
+    return [&](std::size_t i) {
+      const std::vector<double>& seed = ik_seed_states.size() == 1 ? ik_seed_states[0] : ik_seed_states[i];
+      solved[i] = searchPositionIK(ik_poses[i], seed, timeout_per_pose, solutions[i], error_codes[i], options);
+    };
+  });
+  return std::all_of(solved.begin(), solved.end(), [](char s) { return s; });
+}
+
 bool IKFastKinematicsPlugin::getPositionFK(const std::vector<std::string>& link_names,
                                            const std::vector<double>& joint_angles,
                                            std::vector<geometry_msgs::msg::Pose>& poses) const
@@ -994,9 +1034,39 @@ bool IKFastKinematicsPlugin::searchPositionIK(const geometry_msgs::msg::Pose& ik
   if ((search_mode & OPTIMIZE_MAX_JOINT) && (num_positive_increments + num_negative_increments) > 1000)
     RCLCPP_WARN_STREAM_ONCE(LOGGER, "Large search space, consider increasing the search discretization");
 
-  double best_costs = -1.0;
-  std::vector<double> best_solution;
-  int nattempts = 0, nvalid = 0;
+  if (search_mode & OPTIMIZE_MAX_JOINT)
+  {
+    // Evaluate the callback (usually a collision check) in the order of increasing costs, so that it only runs until
+    // the best feasible solution instead of for all solutions of all discretizations
+    const Eigen::MatrixXd candidates = enumerateSolutions(frame, ik_seed_state, initial_guess, search_discretization,
+                                                          num_positive_increments, num_negative_increments);
+    RCLCPP_DEBUG_STREAM(LOGGER, "Solutions within the joint limits: " << candidates.cols());
+
+    // Costs for solution: Largest joint motion
+    const Eigen::Map<const Eigen::VectorXd> seed(ik_seed_state.data(), num_joints_);
+    const Eigen::VectorXd costs = (candidates.colwise() - seed).cwiseAbs().colwise().maxCoeff().transpose();
+    std::vector<Eigen::Index> order(candidates.cols());
+    std::iota(order.begin(), order.end(), 0);
+    // keep the search order among equal costs
+    std::stable_sort(order.begin(), order.end(),
+                     [&costs](Eigen::Index a, Eigen::Index b) { return costs[a] < costs[b]; });
+
+    for (Eigen::Index index : order)
+    {
+      solution.assign(candidates.col(index).data(), candidates.col(index).data() + num_joints_);
+      if (solution_callback)
+        solution_callback(ik_pose, solution, error_code);
+      else
+        error_code.val = error_code.SUCCESS;
+      if (error_code.val == error_code.SUCCESS)
+        return true;
+    }
+
+    error_code.val = moveit_msgs::msg::MoveItErrorCodes::NO_IK_SOLUTION;
+    return false;
+  }
+
+  int nattempts = 0;
 
   while (true)
   {
@@ -1005,70 +1075,38 @@ bool IKFastKinematicsPlugin::searchPositionIK(const geometry_msgs::msg::Pose& ik
 
     RCLCPP_DEBUG_STREAM(LOGGER, "Found " << numsol << " solutions from IKFast");
 
-    if (numsol > 0)
+    for (size_t s = 0; s < numsol; ++s)
     {
-      for (size_t s = 0; s < numsol; ++s)
-      {
-        nattempts++;
-        std::vector<double> sol;
-        getSolution(solutions, ik_seed_state, s, sol);
+      nattempts++;
+      getSolution(solutions, ik_seed_state, s, solution);
 
-        bool obeys_limits = true;
-        for (size_t i = 0; i < sol.size(); ++i)
-        {
-          if (joint_has_limits_vector_[i] && (sol[i] < joint_min_vector_[i] || sol[i] > joint_max_vector_[i]))
-          {
-            obeys_limits = false;
-            break;
-          }
-          // RCLCPP_INFO_STREAM(LOGGER,"Num " << i << " value " << sol[i] << " has limits " <<
-          // joint_has_limits_vector_[i] << " " << joint_min_vector_[i] << " " << joint_max_vector_[i]);
-        }
-        if (obeys_limits)
+      bool obeys_limits = true;
+      for (size_t i = 0; i < solution.size(); ++i)
+      {
+        if (joint_has_limits_vector_[i] &&
+            (solution[i] < joint_min_vector_[i] || solution[i] > joint_max_vector_[i]))
         {
-          getSolution(solutions, ik_seed_state, s, solution);
-
-          // This solution is within joint limits, now check if in collision (if callback provided)
-          if (solution_callback)
-          {
-            solution_callback(ik_pose, solution, error_code);
-          }
-          else
-          {
-            error_code.val = error_code.SUCCESS;
-          }
-
-          if (error_code.val == error_code.SUCCESS)
-          {
-            nvalid++;
-            if (search_mode & OPTIMIZE_MAX_JOINT)
-            {
-              // Costs for solution: Largest joint motion
-              double costs = 0.0;
-              for (unsigned int i = 0; i < solution.size(); ++i)
-              {
-                double d = fabs(ik_seed_state[i] - solution[i]);
-                if (d > costs)
-                  costs = d;
-              }
-              if (costs < best_costs || best_costs == -1.0)
-              {
-                best_costs = costs;
-                best_solution = solution;
-              }
-            }
-            else
-              // Return first feasible solution
-              return true;
-          }
+          obeys_limits = false;
+          break;
         }
       }
+      if (!obeys_limits)
+        continue;
+
+      // This solution is within joint limits, now check if in collision (if callback provided)
+      if (solution_callback)
+        solution_callback(ik_pose, solution, error_code);
+      else
+        error_code.val = error_code.SUCCESS;
+
+      // Return first feasible solution
+      if (error_code.val == error_code.SUCCESS)
+        return true;
     }
 
     if (!getCount(counter, num_positive_increments, -num_negative_increments))
     {
       // Everything searched
-      error_code.val = moveit_msgs::msg::MoveItErrorCodes::NO_IK_SOLUTION;
       break;
     }
 
@@ -1076,20 +1114,55 @@ bool IKFastKinematicsPlugin::searchPositionIK(const geometry_msgs::msg::Pose& ik
     // RCLCPP_DEBUG_STREAM(LOGGER,"Attempt " << counter << " with 0th free joint having value " << vfree[0]);
   }
 
-  RCLCPP_DEBUG_STREAM(LOGGER, "Valid solutions: " << nvalid << "/" << nattempts);
-
-  if ((search_mode & OPTIMIZE_MAX_JOINT) && best_costs != -1.0)
-  {
-    solution = best_solution;
-    error_code.val = error_code.SUCCESS;
-    return true;
-  }
+  RCLCPP_DEBUG_STREAM(LOGGER, "No valid solution among " << nattempts << " attempts");
 
   // No solution found
   error_code.val = moveit_msgs::msg::MoveItErrorCodes::NO_IK_SOLUTION;
   return false;
 }
 
+Eigen::MatrixXd IKFastKinematicsPlugin::enumerateSolutions(KDL::Frame& frame, const std::vector<double>& ik_seed_state,
+                                                           double initial_guess, double search_discretization,
+                                                           int num_positive_increments,
+                                                           int num_negative_increments) const
+{
+  std::vector<double> values;  // the solutions, one after the other
+  std::vector<double> vfree(free_params_.size());
+  std::vector<double> solution;
+  int counter = 0;
+  do
+  {
+    vfree[0] = initial_guess + search_discretization * counter;
+    IkSolutionList<IkReal> solutions;
+    const size_t numsol = solve(frame, vfree, solutions);
+    for (size_t s = 0; s < numsol; ++s)
+    {
+      getSolution(solutions, ik_seed_state, s, solution);
+      values.insert(values.end(), solution.begin(), solution.end());
+    }
+  } while (getCount(counter, num_positive_increments, -num_negative_increments));
+  const Eigen::Map<const Eigen::MatrixXd> candidates(values.data(), num_joints_, values.size() / num_joints_);
+
+  // filter all joint limit violations at once, joints without limits accept any value
+  Eigen::ArrayXd lower(num_joints_);
+  Eigen::ArrayXd upper(num_joints_);
+  for (std::size_t i = 0; i < num_joints_; ++i)
+  {
+    lower[i] = joint_has_limits_vector_[i] ? joint_min_vector_[i] : -std::numeric_limits<double>::infinity();
+    upper[i] = joint_has_limits_vector_[i] ? joint_max_vector_[i] : std::numeric_limits<double>::infinity();
+  }
+  const Eigen::Array<bool, 1, Eigen::Dynamic> obeys_limits =
+      (((candidates.array().colwise() - lower) >= 0.0) && ((candidates.array().colwise() - upper) <= 0.0))
+          .colwise()
+          .all();
+
+  Eigen::MatrixXd valid(num_joints_, obeys_limits.count());
+  for (Eigen::Index i = 0, j = 0; i < candidates.cols(); ++i)
+    if (obeys_limits[i])
+      valid.col(j++) = candidates.col(i);
+  return valid;
+}
+
 // Used when there are no redundant joints - aka no free params
 bool IKFastKinematicsPlugin::getPositionIK(const geometry_msgs::msg::Pose& ik_pose,
                                            const std::vector<double>& ik_seed_state, std::vector<double>& solution,
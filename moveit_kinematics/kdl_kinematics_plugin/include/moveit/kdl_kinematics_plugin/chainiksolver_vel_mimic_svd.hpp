@@ -94,6 +94,8 @@ public:
 
 private:
   bool jacToJacReduced(const Jacobian& jac, Jacobian& jac_reduced);
+  /// Equivalent of svd_.solve(rhs) into preallocated memory
+  void solve(const Eigen::Ref<const Eigen::VectorXd>& rhs, Eigen::VectorXd& solution);
 
   // Mimic joint specific
   const std::vector<kdl_kinematics_plugin::JointMimic>& mimic_joints_;
@@ -104,6 +106,10 @@ private:
 
   Eigen::JacobiSVD<Eigen::MatrixXd> svd_;
   Eigen::VectorXd qdot_out_reduced_;
+  // The position rows of the weighted Jacobian for position-only IK, so the SVD does not copy them on every call
+  Eigen::MatrixXd jac_position_;
+  // Intermediate result of solve(), at most one entry per Cartesian dimension
+  Eigen::Matrix<double, Eigen::Dynamic, 1, 0, 6, 1> solve_tmp_;
 
   Jacobian jac_;          // full Jacobian
   Jacobian jac_reduced_;  // reduced Jacobian with contributions of mimic joints mapped onto active DoFs
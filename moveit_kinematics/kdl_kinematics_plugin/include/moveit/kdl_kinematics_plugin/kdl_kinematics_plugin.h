@@ -59,6 +59,7 @@
 #include <moveit/robot_state/robot_state.h>
 
 #include <cfloat>
+#include <mutex>
 
 namespace KDL
 {
@@ -78,6 +79,7 @@ public:
    *  @brief Default constructor
    */
   KDLKinematicsPlugin();
+  ~KDLKinematicsPlugin() override;
 
   bool
   getPositionIK(const geometry_msgs::msg::Pose& ik_pose, const std::vector<double>& ik_seed_state,
@@ -107,6 +109,13 @@ public:
       const IKCallbackFn& solution_callback, moveit_msgs::msg::MoveItErrorCodes& error_code,
       const kinematics::KinematicsQueryOptions& options = kinematics::KinematicsQueryOptions()) const override;
 
+  /// @brief Solves the poses concurrently, every thread reuses its own solvers for all the poses it solves
+  bool searchPositionIKBatch(
+      const std::vector<geometry_msgs::msg::Pose>& ik_poses, const std::vector<std::vector<double>>& ik_seed_states,
+      double timeout_per_pose, std::vector<std::vector<double>>& solutions,
+      std::vector<moveit_msgs::msg::MoveItErrorCodes>& error_codes,
+      const kinematics::KinematicsQueryOptions& options = kinematics::KinematicsQueryOptions()) const override;
+
   bool getPositionFK(const std::vector<std::string>& link_names, const std::vector<double>& joint_angles,
                      std::vector<geometry_msgs::msg::Pose>& poses) const override;
 
@@ -127,13 +136,39 @@ public:
 protected:
   typedef Eigen::Matrix<double, 6, 1> Twist;
 
+  /// Buffers of the CartToJnt() iterations, allocated once so the iterations do not allocate memory
+  struct CartToJntBuffers
+  {
+    CartToJntBuffers(unsigned int num_joints, Eigen::Index num_weights);
+
+    KDL::JntArray delta_q, q_backup;
+    Eigen::ArrayXd extra_joint_weights;
+    Eigen::VectorXd weights;  ///< joint weights combined with extra_joint_weights
+  };
+
   /// Solve position IK given initial joint values
   // NOLINTNEXTLINE(readability-identifier-naming)
   int CartToJnt(KDL::ChainIkSolverVelMimicSVD& ik_solver, const KDL::JntArray& q_init, const KDL::Frame& p_in,
                 KDL::JntArray& q_out, const unsigned int max_iter, const Eigen::VectorXd& joint_weights,
                 const Twist& cartesian_weights) const;
+  /// Version of the above using the given FK solver and buffers instead of allocating its own
+  // NOLINTNEXTLINE(readability-identifier-naming)
+  int CartToJnt(KDL::ChainIkSolverVelMimicSVD& ik_solver, KDL::ChainFkSolverPos& fk_solver,
+                const KDL::JntArray& q_init, const KDL::Frame& p_in, KDL::JntArray& q_out, const unsigned int max_iter,
+                const Eigen::VectorXd& joint_weights, const Twist& cartesian_weights,
+                CartToJntBuffers& buffers) const;
 
 private:
+  /// Solvers and buffers of an IK query, only used by one thread at a time
+  struct SolverWorkspace;
+
+  /// Take an idle workspace from the pool, or create one if all of them are in use
+  std::unique_ptr<SolverWorkspace> acquireWorkspace() const;
+  /// Return a workspace to the pool for reuse by later queries
+  void releaseWorkspace(std::unique_ptr<SolverWorkspace> workspace) const;
+  /// acquireWorkspace() for a thread, the workspace returns to the pool when the last copy is destroyed
+  std::shared_ptr<SolverWorkspace> acquireSharedWorkspace() const;
+
   void getJointWeights();
   bool timedOut(const rclcpp::Time& start_time, double duration) const;
 
@@ -146,15 +181,28 @@ private:
   bool checkConsistency(const Eigen::VectorXd& seed_state, const std::vector<double>& consistency_limits,
                         const Eigen::VectorXd& solution) const;
 
-  void getRandomConfiguration(Eigen::VectorXd& jnt_array) const;
+  void getRandomConfiguration(moveit::core::RobotState& state, Eigen::VectorXd& jnt_array) const;
 
   /** @brief Get a random configuration within consistency limits close to the seed state
+   *  @param state Provides the random number generator
    *  @param seed_state Seed state
    *  @param consistency_limits
    *  @param jnt_array Returned random configuration
    */
-  void getRandomConfiguration(const Eigen::VectorXd& seed_state, const std::vector<double>& consistency_limits,
-                              Eigen::VectorXd& jnt_array) const;
+  void getRandomConfiguration(moveit::core::RobotState& state, const Eigen::VectorXd& seed_state,
+                              const std::vector<double>& consistency_limits, Eigen::VectorXd& jnt_array) const;
+
+  /** @brief Implementation of searchPositionIK() for an initialized solver
+   *  @param workspace Solvers and buffers used for the query, only used by one thread at a time
+   *  @param from_seed Start from the seed state, otherwise only from random restarts
+   *  @param stop Cancels the search when it returns true, e.g. because another thread found a solution
+   */
+  bool solvePositionIK(SolverWorkspace& workspace, const geometry_msgs::msg::Pose& ik_pose,
+                       const std::vector<double>& ik_seed_state, double timeout,
+                       const std::vector<double>& consistency_limits, std::vector<double>& solution,
+                       const IKCallbackFn& solution_callback, moveit_msgs::msg::MoveItErrorCodes& error_code,
+                       const kinematics::KinematicsQueryOptions& options, bool from_seed = true,
+                       const std::function<bool()>& stop = std::function<bool()>()) const;
 
   /// clip q_delta such that joint limits will not be violated
   void clipToJointLimits(const KDL::JntArray& q, KDL::JntArray& q_delta, Eigen::ArrayXd& weighting) const;
@@ -167,7 +215,6 @@ private:
   moveit_msgs::msg::KinematicSolverInfo solver_info_;  ///< Stores information for the inverse kinematics solver
 
   const moveit::core::JointModelGroup* joint_model_group_;
-  moveit::core::RobotStatePtr state_;
   KDL::Chain kdl_chain_;
   std::unique_ptr<KDL::ChainFkSolverPos> fk_solver_;
   std::vector<JointMimic> mimic_joints_;
@@ -182,5 +229,8 @@ private:
    * > 1.0: orientation has more importance than position
    * = 0.0: perform position-only IK */
   double orientation_vs_position_weight_;
+
+  mutable std::mutex workspaces_mutex_;
+  mutable std::vector<std::unique_ptr<SolverWorkspace>> workspaces_;  ///< idle workspaces of finished queries
 };
 }  // namespace kdl_kinematics_plugin
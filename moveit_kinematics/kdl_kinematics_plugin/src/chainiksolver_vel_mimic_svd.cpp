@@ -60,6 +60,9 @@ ChainIkSolverVelMimicSVD::ChainIkSolverVelMimicSVD(const Chain& chain,
     assert(item.map_index < chain_.getNrOfJoints());
 #endif
   svd_.setThreshold(threshold);
+  qdot_out_reduced_.resize(svd_.cols());
+  if (position_ik)
+    jac_position_.resize(3, svd_.cols());
 }
 
 void ChainIkSolverVelMimicSVD::updateInternalDataStructures()
@@ -110,21 +113,36 @@ int ChainIkSolverVelMimicSVD::CartToJnt(const JntArray& q_in, const Twist& v_in,
   vin.bottomRows<3>() = Eigen::Map<const Eigen::Array3d>(v_in.rot.data, 3) * cartesian_weights.bottomRows<3>().array();
 
   // Do a singular value decomposition: J = U*S*V^t
-  svd_.compute(jac.topRows(rows));
+  if (isPositionOnly())
+  {
+    jac_position_ = jac.topRows(rows);
+    svd_.compute(jac_position_);
+  }
+  else
+    svd_.compute(jac);
 
   if (num_mimic_joints_ > 0)
   {
-    qdot_out_reduced_.noalias() = svd_.solve(vin.topRows(rows));
+    solve(vin.topRows(rows), qdot_out_reduced_);
     qdot_out_reduced_.array() *= joint_weights.array();
     for (unsigned int i = 0; i < chain_.getNrOfJoints(); ++i)
       qdot_out(i) = qdot_out_reduced_[mimic_joints_[i].map_index] * mimic_joints_[i].multiplier;
   }
   else
   {
-    qdot_out.data.noalias() = svd_.solve(vin.topRows(rows));
+    solve(vin.topRows(rows), qdot_out.data);
     qdot_out.data.array() *= joint_weights.array();
   }
 
   return 0;
 }
+
+void ChainIkSolverVelMimicSVD::solve(const Eigen::Ref<const Eigen::VectorXd>& rhs, Eigen::VectorXd& solution)
+{
+  // Same steps as Eigen::SVDBase::_solve_impl(), which allocates its intermediate result on every call
+  const Eigen::Index rank = svd_.rank();
+  solve_tmp_.noalias() = svd_.matrixU().leftCols(rank).adjoint() * rhs;
+  solve_tmp_ = svd_.singularValues().head(rank).asDiagonal().inverse() * solve_tmp_;
+  solution.noalias() = svd_.matrixV().leftCols(rank) * solve_tmp_;
+}
 }  // namespace KDL
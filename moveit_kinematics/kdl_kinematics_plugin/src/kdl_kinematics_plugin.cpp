@@ -49,27 +49,87 @@
 #include <kdl/frames_io.hpp>
 #include <kdl/kinfam_io.hpp>
 
+#include <algorithm>
+
 namespace kdl_kinematics_plugin
 {
 static rclcpp::Logger LOGGER = rclcpp::get_logger("moveit_kdl_kinematics_plugin.kdl_kinematics_plugin");
 
 rclcpp::Clock KDLKinematicsPlugin::steady_clock_{ RCL_STEADY_TIME };
 
+struct KDLKinematicsPlugin::SolverWorkspace
+{
+  explicit SolverWorkspace(const KDLKinematicsPlugin& plugin)
+    : fk_solver(plugin.kdl_chain_)
+    , ik_solver_vel(plugin.kdl_chain_, plugin.mimic_joints_, plugin.orientation_vs_position_weight_ == 0.0)
+    , state(plugin.robot_model_)
+    , jnt_seed_state(plugin.dimension_)
+    , jnt_pos_in(plugin.dimension_)
+    , jnt_pos_out(plugin.dimension_)
+    , joint_weights(Eigen::Map<const Eigen::VectorXd>(plugin.joint_weights_.data(), plugin.joint_weights_.size()))
+    , buffers(plugin.dimension_, joint_weights.size())
+  {
+    consistency_limits_mimic.reserve(plugin.dimension_);
+  }
+
+  KDL::ChainFkSolverPos_recursive fk_solver;
+  KDL::ChainIkSolverVelMimicSVD ik_solver_vel;
+  moveit::core::RobotState state;  ///< provides the random number generator for re-seeding
+  KDL::JntArray jnt_seed_state, jnt_pos_in, jnt_pos_out;
+  Eigen::VectorXd joint_weights;
+  std::vector<double> consistency_limits_mimic;
+  CartToJntBuffers buffers;
+};
+
+KDLKinematicsPlugin::CartToJntBuffers::CartToJntBuffers(unsigned int num_joints, Eigen::Index num_weights)
+  : delta_q(num_joints), q_backup(num_joints), extra_joint_weights(num_weights), weights(num_weights)
+{
+}
+
 KDLKinematicsPlugin::KDLKinematicsPlugin() : initialized_(false)
 {
 }
 
-void KDLKinematicsPlugin::getRandomConfiguration(Eigen::VectorXd& jnt_array) const
+KDLKinematicsPlugin::~KDLKinematicsPlugin() = default;
+
+std::unique_ptr<KDLKinematicsPlugin::SolverWorkspace> KDLKinematicsPlugin::acquireWorkspace() const
 {
-  state_->setToRandomPositions(joint_model_group_);
-  state_->copyJointGroupPositions(joint_model_group_, &jnt_array[0]);
+  {
+    std::lock_guard<std::mutex> lock(workspaces_mutex_);
+    if (!workspaces_.empty())
+    {
+      std::unique_ptr<SolverWorkspace> workspace = std::move(workspaces_.back());
+      workspaces_.pop_back();
+      return workspace;
+    }
+  }
+  return std::make_unique<SolverWorkspace>(*this);
+}
+
+void KDLKinematicsPlugin::releaseWorkspace(std::unique_ptr<SolverWorkspace> workspace) const
+{
+  std::lock_guard<std::mutex> lock(workspaces_mutex_);
+  workspaces_.push_back(std::move(workspace));
+}
+
+std::shared_ptr<KDLKinematicsPlugin::SolverWorkspace> KDLKinematicsPlugin::acquireSharedWorkspace() const
+{
+  return std::shared_ptr<SolverWorkspace>(acquireWorkspace().release(), [this](SolverWorkspace* finished) {
+    releaseWorkspace(std::unique_ptr<SolverWorkspace>(finished));
+  });
 }
 
-void KDLKinematicsPlugin::getRandomConfiguration(const Eigen::VectorXd& seed_state,
+void KDLKinematicsPlugin::getRandomConfiguration(moveit::core::RobotState& state, Eigen::VectorXd& jnt_array) const
+{
+  state.setToRandomPositions(joint_model_group_);
+  state.copyJointGroupPositions(joint_model_group_, &jnt_array[0]);
+}
+
+void KDLKinematicsPlugin::getRandomConfiguration(moveit::core::RobotState& state, const Eigen::VectorXd& seed_state,
                                                  const std::vector<double>& consistency_limits,
                                                  Eigen::VectorXd& jnt_array) const
 {
-  joint_model_group_->getVariableRandomPositionsNearBy(state_->getRandomNumberGenerator(), &jnt_array[0],
+  joint_model_group_->getVariableRandomPositionsNearBy(state.getRandomNumberGenerator(), &jnt_array[0],
                                                        &seed_state[0], consistency_limits);
 }
 
@@ -262,11 +322,14 @@ bool KDLKinematicsPlugin::initialize(const rclcpp::Node::SharedPtr& node, const
     }
   }
 
-  // Setup the joint state groups that we need
-  state_ = std::make_shared<moveit::core::RobotState>(robot_model_);
-
   fk_solver_ = std::make_unique<KDL::ChainFkSolverPos_recursive>(kdl_chain_);
 
+  // Workspaces of a previous initialization do not match the current chain
+  {
+    std::lock_guard<std::mutex> lock(workspaces_mutex_);
+    workspaces_.clear();
+  }
+
   initialized_ = true;
   RCLCPP_DEBUG(LOGGER, "KDL solver initialized");
   return true;
@@ -329,7 +392,6 @@ bool KDLKinematicsPlugin::searchPositionIK(const geometry_msgs::msg::Pose& ik_po
                                            moveit_msgs::msg::MoveItErrorCodes& error_code,
                                            const kinematics::KinematicsQueryOptions& options) const
 {
-  const rclcpp::Time start_time = steady_clock_.now();
   if (!initialized_)
   {
     RCLCPP_ERROR(LOGGER, "kinematics solver not initialized");
@@ -337,6 +399,68 @@ bool KDLKinematicsPlugin::searchPositionIK(const geometry_msgs::msg::Pose& ik_po
     return false;
   }
 
+  if (options.parallel_restarts > 1)
+  {
+    return searchRestartsConcurrently(
+        ik_seed_state, solution_callback, options,
+        [&]() -> RestartSearchFn {
+          std::shared_ptr<SolverWorkspace> workspace = acquireSharedWorkspace();
+          return [&, workspace](bool from_seed, const IKCallbackFn& callback, const std::function<bool()>& stop,
+                                std::vector<double>& candidate, moveit_msgs::msg::MoveItErrorCodes& candidate_code) {
+            return solvePositionIK(*workspace, ik_pose, ik_seed_state, timeout, consistency_limits, candidate,
+                                   callback, candidate_code, options, from_seed, stop);
+          };
+        },
+        solution, error_code);
+  }
+
+  // Reuse the solvers and buffers of a finished query instead of allocating them again
+  std::unique_ptr<SolverWorkspace> workspace = acquireWorkspace();
+  const bool solved = solvePositionIK(*workspace, ik_pose, ik_seed_state, timeout, consistency_limits, solution,
+                                      solution_callback, error_code, options);
+  releaseWorkspace(std::move(workspace));
+  return solved;
+}
+
+bool KDLKinematicsPlugin::searchPositionIKBatch(const std::vector<geometry_msgs::msg::Pose>& ik_poses,
+                                                const std::vector<std::vector<double>>& ik_seed_states,
+                                                double timeout_per_pose, std::vector<std::vector<double>>& solutions,
+                                                std::vector<moveit_msgs::msg::MoveItErrorCodes>& error_codes,
+                                                const kinematics::KinematicsQueryOptions& options) const
+{
+  if (!prepareBatch(ik_poses, ik_seed_states, solutions, error_codes))
+    return false;
+  if (!initialized_)
+  {
+    RCLCPP_ERROR(LOGGER, "kinematics solver not initialized");
+    for (moveit_msgs::msg::MoveItErrorCodes& error_code : error_codes)
+      error_code.val = error_code.NO_IK_SOLUTION;
+    return false;
+  }
+
+  // std::vector<bool> packs its elements, so the threads write to a byte each
+  std::vector<char> solved(ik_poses.size(), false);
+  solveBatchConcurrently(ik_poses.size(), [&]() -> std::function<void(std::size_t)> {
+    // The workspace returns to the pool once the thread has finished its share of the batch
+    std::shared_ptr<SolverWorkspace> workspace = acquireSharedWorkspace();
+    return [&, workspace](std::size_t i) {
+      const std::vector<double>& seed = ik_seed_states.size() == 1 ? ik_seed_states[0] : ik_seed_states[i];
+      solved[i] = solvePositionIK(*workspace, ik_poses[i], seed, timeout_per_pose, std::vector<double>(),
+                                  solutions[i], IKCallbackFn(), error_codes[i], options);
+    };
+  });
+  return std::all_of(solved.begin(), solved.end(), [](char s) { return s; });
+}
+
+bool KDLKinematicsPlugin::solvePositionIK(SolverWorkspace& workspace, const geometry_msgs::msg::Pose& ik_pose,
+                                          const std::vector<double>& ik_seed_state, double timeout,
+                                          const std::vector<double>& consistency_limits, std::vector<double>& solution,
+                                          const IKCallbackFn& solution_callback,
+                                          moveit_msgs::msg::MoveItErrorCodes& error_code,
+                                          const kinematics::KinematicsQueryOptions& options, bool from_seed,
+                                          const std::function<bool()>& stop) const
+{
+  const rclcpp::Time start_time = steady_clock_.now();
   if (ik_seed_state.size() != dimension_)
   {
     RCLCPP_ERROR(LOGGER, "Seed state must have size %d instead of size %zu\n", dimension_, ik_seed_state.size());
@@ -345,7 +469,8 @@ bool KDLKinematicsPlugin::searchPositionIK(const geometry_msgs::msg::Pose& ik_po
   }
 
   // Resize consistency limits to remove mimic joints
-  std::vector<double> consistency_limits_mimic;
+  std::vector<double>& consistency_limits_mimic = workspace.consistency_limits_mimic;
+  consistency_limits_mimic.clear();
   if (!consistency_limits.empty())
   {
     if (consistency_limits.size() != dimension_)
@@ -366,13 +491,12 @@ bool KDLKinematicsPlugin::searchPositionIK(const geometry_msgs::msg::Pose& ik_po
   cartesian_weights.topRows<3>().setConstant(1.0);
   cartesian_weights.bottomRows<3>().setConstant(orientation_vs_position_weight_);
 
-  KDL::JntArray jnt_seed_state(dimension_);
-  KDL::JntArray jnt_pos_in(dimension_);
-  KDL::JntArray jnt_pos_out(dimension_);
+  KDL::JntArray& jnt_seed_state = workspace.jnt_seed_state;
+  KDL::JntArray& jnt_pos_in = workspace.jnt_pos_in;
+  KDL::JntArray& jnt_pos_out = workspace.jnt_pos_out;
   jnt_seed_state.data = Eigen::Map<const Eigen::VectorXd>(ik_seed_state.data(), ik_seed_state.size());
   jnt_pos_in = jnt_seed_state;
 
-  KDL::ChainIkSolverVelMimicSVD ik_solver_vel(kdl_chain_, mimic_joints_, orientation_vs_position_weight_ == 0.0);
   solution.resize(dimension_);
 
   KDL::Frame pose_desired;
@@ -387,18 +511,17 @@ bool KDLKinematicsPlugin::searchPositionIK(const geometry_msgs::msg::Pose& ik_po
   do
   {
     ++attempt;
-    if (attempt > 1)  // randomly re-seed after first attempt
+    if (attempt > 1 || !from_seed)  // randomly re-seed after first attempt
     {
       if (!consistency_limits_mimic.empty())
-        getRandomConfiguration(jnt_seed_state.data, consistency_limits_mimic, jnt_pos_in.data);
+        getRandomConfiguration(workspace.state, jnt_seed_state.data, consistency_limits_mimic, jnt_pos_in.data);
       else
-        getRandomConfiguration(jnt_pos_in.data);
+        getRandomConfiguration(workspace.state, jnt_pos_in.data);
       RCLCPP_DEBUG_STREAM(LOGGER, "New random configuration (" << attempt << "): " << jnt_pos_in);
     }
 
-    int ik_valid =
-        CartToJnt(ik_solver_vel, jnt_pos_in, pose_desired, jnt_pos_out, max_solver_iterations_,
-                  Eigen::Map<const Eigen::VectorXd>(joint_weights_.data(), joint_weights_.size()), cartesian_weights);
+    int ik_valid = CartToJnt(workspace.ik_solver_vel, workspace.fk_solver, jnt_pos_in, pose_desired, jnt_pos_out,
+                             max_solver_iterations_, workspace.joint_weights, cartesian_weights, workspace.buffers);
     if (ik_valid == 0 || options.return_approximate_solution)  // found acceptable solution
     {
       if (!consistency_limits_mimic.empty() &&
@@ -419,7 +542,7 @@ bool KDLKinematicsPlugin::searchPositionIK(const geometry_msgs::msg::Pose& ik_po
                                                   << "s and " << attempt << " attempts");
       return true;
     }
-  } while (!timedOut(start_time, timeout));
+  } while (!timedOut(start_time, timeout) && !(stop && stop()));
 
   RCLCPP_DEBUG_STREAM(LOGGER, "IK timed out after " << (steady_clock_.now() - start_time).seconds() << " > " << timeout
                                                     << "s and " << attempt << " attempts");
@@ -431,13 +554,24 @@ bool KDLKinematicsPlugin::searchPositionIK(const geometry_msgs::msg::Pose& ik_po
 int KDLKinematicsPlugin::CartToJnt(KDL::ChainIkSolverVelMimicSVD& ik_solver, const KDL::JntArray& q_init,
                                    const KDL::Frame& p_in, KDL::JntArray& q_out, const unsigned int max_iter,
                                    const Eigen::VectorXd& joint_weights, const Twist& cartesian_weights) const
+{
+  CartToJntBuffers buffers(q_out.rows(), joint_weights.rows());
+  return CartToJnt(ik_solver, *fk_solver_, q_init, p_in, q_out, max_iter, joint_weights, cartesian_weights, buffers);
+}
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+int KDLKinematicsPlugin::CartToJnt(KDL::ChainIkSolverVelMimicSVD& ik_solver, KDL::ChainFkSolverPos& fk_solver,
+                                   const KDL::JntArray& q_init, const KDL::Frame& p_in, KDL::JntArray& q_out,
+                                   const unsigned int max_iter, const Eigen::VectorXd& joint_weights,
+                                   const Twist& cartesian_weights, CartToJntBuffers& buffers) const
 {
   double last_delta_twist_norm = DBL_MAX;
   double step_size = 1.0;
   KDL::Frame f;
   KDL::Twist delta_twist;
-  KDL::JntArray delta_q(q_out.rows()), q_backup(q_out.rows());
-  Eigen::ArrayXd extra_joint_weights(joint_weights.rows());
+  KDL::JntArray& delta_q = buffers.delta_q;
+  KDL::JntArray& q_backup = buffers.q_backup;
+  Eigen::ArrayXd& extra_joint_weights = buffers.extra_joint_weights;
   extra_joint_weights.setOnes();
 
   q_out = q_init;
@@ -447,7 +581,7 @@ int KDLKinematicsPlugin::CartToJnt(KDL::ChainIkSolverVelMimicSVD& ik_solver, con
   bool success = false;
   for (i = 0; i < max_iter; ++i)
   {
-    fk_solver_->JntToCart(q_out, f);
+    fk_solver.JntToCart(q_out, f);
     delta_twist = diff(f, p_in);
     RCLCPP_DEBUG_STREAM(LOGGER, "[" << std::setw(3) << i << "] delta_twist: " << delta_twist);
 
@@ -477,7 +611,8 @@ int KDLKinematicsPlugin::CartToJnt(KDL::ChainIkSolverVelMimicSVD& ik_solver, con
       step_size = 1.0;   // reset step size
       last_delta_twist_norm = delta_twist_norm;
 
-      ik_solver.CartToJnt(q_out, delta_twist, delta_q, extra_joint_weights * joint_weights.array(), cartesian_weights);
+      buffers.weights.array() = extra_joint_weights * joint_weights.array();
+      ik_solver.CartToJnt(q_out, delta_twist, delta_q, buffers.weights, cartesian_weights);
     }
 
     clipToJointLimits(q_out, delta_q, extra_joint_weights);
@@ -0,0 +1,239 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#pragma once
+
+#include <kdl/chain.hpp>
+#include <kdl/chainiksolver.hpp>
+#include <kdl/chainiksolverpos_lma.hpp>
+#include <Eigen/Cholesky>
+#include <Eigen/Geometry>
+#include <Eigen/StdVector>
+#include <algorithm>
+#include <vector>
+
+namespace lma_kinematics_plugin
+{
+/** \brief Joint of a ReducedChain */
+struct ChainJoint
+{
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  Eigen::Isometry3d origin;  ///< Joint frame at zero position, relative to the joint frame of the previous joint
+  Eigen::Vector3d axis;      ///< Unit axis of the joint motion, in the joint frame
+  bool revolute;             ///< Rotation about the axis, otherwise translation along it
+};
+
+/** \brief A kinematic chain as alternating constant transforms and single-axis joint motions.
+    Consecutive fixed segments are folded into the constant transforms. */
+struct ReducedChain
+{
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  std::vector<ChainJoint, Eigen::aligned_allocator<ChainJoint>> joints;
+  Eigen::Isometry3d tip = Eigen::Isometry3d::Identity();  ///< Tip of the chain, relative to the last joint frame
+};
+
+/** \brief Convert \e chain to a ReducedChain. Returns false if a joint does not move by exactly its position about
+    or along a constant axis, which ChainIkSolverPosLMAFixed relies on. */
+bool reduceChain(const KDL::Chain& chain, ReducedChain& reduced);
+
+inline Eigen::Isometry3d toEigen(const KDL::Frame& frame)
+{
+  Eigen::Isometry3d transform = Eigen::Isometry3d::Identity();
+  transform.linear() = Eigen::Map<const Eigen::Matrix<double, 3, 3, Eigen::RowMajor>>(frame.M.data);
+  transform.translation() = Eigen::Map<const Eigen::Vector3d>(frame.p.data);
+  return transform;
+}
+
+/**
+ * \brief Levenberg-Marquardt position IK for chains of \e N joints with fixed-size Eigen types
+ *
+ * Follows the algorithm of KDL::ChainIkSolverPos_LMA step by step, but computes forward kinematics and the
+ * (geometric) Jacobian in a single pass over a ReducedChain and all vectors and matrices have compile-time sizes.
+ * The damped least squares step (J^T J + lambda I)^-1 J^T e is computed as J^T (J J^T + lambda I)^-1 e, which
+ * takes the Cholesky decomposition of a 6x6 matrix instead of an SVD of the Jacobian for every iteration.
+ */
+template <int N>
+class ChainIkSolverPosLMAFixed : public KDL::ChainIkSolverPos
+{
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  using JointVector = Eigen::Matrix<double, N, 1>;
+  using Jacobian = Eigen::Matrix<double, 6, N>;
+  using Vector6d = Eigen::Matrix<double, 6, 1>;
+  using Matrix6d = Eigen::Matrix<double, 6, 6>;
+
+  /**
+   * @param chain Chain of exactly \e N joints
+   * @param weights Weights of the position and orientation error components, as for KDL::ChainIkSolverPos_LMA
+   * @param eps Converged once the weighted error norm is below \e eps
+   * @param max_iter Maximum number of iterations
+   * @param eps_joints Stop once the joint increments or the gradient fall below \e eps_joints
+   */
+  ChainIkSolverPosLMAFixed(const ReducedChain& chain, const Vector6d& weights, double eps = 1e-5, int max_iter = 500,
+                           double eps_joints = 1e-15)
+    : chain_(chain), weights_(weights), eps_(eps), max_iter_(max_iter), eps_joints_(eps_joints)
+  {
+  }
+
+  int CartToJnt(const KDL::JntArray& q_init, const KDL::Frame& p_in, KDL::JntArray& q_out) override
+  {
+    if (q_init.rows() != N || q_out.rows() != N || chain_.joints.size() != N)
+      return (error = E_SIZE_MISMATCH);
+
+    const Eigen::Isometry3d goal = toEigen(p_in);
+    JointVector q = q_init.data;
+    Eigen::Isometry3d tip;
+    Jacobian jac;
+    forwardKinematics(q, tip, &jac);
+    Vector6d delta = weights_.cwiseProduct(poseError(tip, goal));
+    double delta_norm = delta.norm();
+    if (delta_norm < eps_)
+    {
+      q_out.data = q;
+      return (error = E_NOERROR);
+    }
+    jac = weights_.asDiagonal() * jac;
+
+    double lambda = 10.0;
+    double v = 2.0;
+    for (int i = 0; i < max_iter_; ++i)
+    {
+      const Matrix6d damped = jac * jac.transpose() + lambda * Matrix6d::Identity();
+      const JointVector diffq = jac.transpose() * damped.llt().solve(delta);
+      const JointVector grad = jac.transpose() * delta;
+      if (diffq.template lpNorm<Eigen::Infinity>() < eps_joints_)
+      {
+        q_out.data = q;
+        return (error = KDL::ChainIkSolverPos_LMA::E_INCREMENT_JOINTS_TOO_SMALL);
+      }
+      if (grad.squaredNorm() < eps_joints_ * eps_joints_)
+      {
+        q_out.data = q;
+        return (error = KDL::ChainIkSolverPos_LMA::E_GRADIENT_JOINTS_TOO_SMALL);
+      }
+
+      const JointVector q_new = q + diffq;
+      forwardKinematics(q_new, tip, nullptr);
+      const Vector6d delta_new = weights_.cwiseProduct(poseError(tip, goal));
+      const double delta_new_norm = delta_new.norm();
+      const double rho = (delta_norm * delta_norm - delta_new_norm * delta_new_norm) / diffq.dot(lambda * diffq + grad);
+      if (rho > 0)
+      {
+        q = q_new;
+        delta = delta_new;
+        delta_norm = delta_new_norm;
+        if (delta_norm < eps_)
+        {
+          q_out.data = q;
+          return (error = E_NOERROR);
+        }
+        forwardKinematics(q, tip, &jac);
+        jac = weights_.asDiagonal() * jac;
+        const double tmp = 2 * rho - 1;
+        lambda = lambda * std::max(1 / 3.0, 1 - tmp * tmp * tmp);
+        v = 2;
+      }
+      else
+      {
+        lambda = lambda * v;
+        v = 2 * v;
+      }
+    }
+    q_out.data = q;
+    return (error = E_MAX_ITERATIONS_EXCEEDED);
+  }
+
+  void updateInternalDataStructures() override
+  {
+  }
+
+private:
+  /** \brief Compute the pose of the tip and, if \e jacobian is given, the Jacobian w.r.t. the tip position */
+  void forwardKinematics(const JointVector& q, Eigen::Isometry3d& tip, Jacobian* jacobian) const
+  {
+    Eigen::Matrix<double, 3, N> axes;
+    Eigen::Matrix<double, 3, N> points;
+    Eigen::Isometry3d frame = Eigen::Isometry3d::Identity();
+    for (int j = 0; j < N; ++j)
+    {
+      const ChainJoint& joint = chain_.joints[j];
+      frame = frame * joint.origin;
+      axes.col(j) = frame.linear() * joint.axis;
+      points.col(j) = frame.translation();
+      if (joint.revolute)
+        frame.linear() = frame.linear() * Eigen::AngleAxisd(q[j], joint.axis).toRotationMatrix();
+      else
+        frame.translation() += q[j] * axes.col(j);
+    }
+    tip = frame * chain_.tip;
+    if (!jacobian)
+      return;
+    for (int j = 0; j < N; ++j)
+    {
+      if (chain_.joints[j].revolute)
+      {
+        jacobian->template block<3, 1>(0, j) = axes.col(j).cross(tip.translation() - points.col(j));
+        jacobian->template block<3, 1>(3, j) = axes.col(j);
+      }
+      else
+      {
+        jacobian->template block<3, 1>(0, j) = axes.col(j);
+        jacobian->template block<3, 1>(3, j).setZero();
+      }
+    }
+  }
+
+  /** \brief Twist from \e tip to \e goal in the base frame, like KDL::diff() */
+  static Vector6d poseError(const Eigen::Isometry3d& tip, const Eigen::Isometry3d& goal)
+  {
+    Vector6d error;
+    error.template head<3>() = goal.translation() - tip.translation();
+    const Eigen::AngleAxisd rotation(tip.linear().transpose() * goal.linear());
+    error.template tail<3>() = tip.linear() * (rotation.angle() * rotation.axis());
+    return error;
+  }
+
+  ReducedChain chain_;
+  Vector6d weights_;
+  double eps_;
+  int max_iter_;
+  double eps_joints_;
+};
+
+extern template class ChainIkSolverPosLMAFixed<6>;
+extern template class ChainIkSolverPosLMAFixed<7>;
+}  // namespace lma_kinematics_plugin
@@ -56,6 +56,7 @@
 #include <moveit/kinematics_base/kinematics_base.h>
 #include <moveit/robot_model/robot_model.h>
 #include <moveit/robot_state/robot_state.h>
+#include <moveit/lma_kinematics_plugin/chain_ik_solver_pos_lma_fixed.h>
 
 namespace lma_kinematics_plugin
 {
@@ -99,6 +100,13 @@ public:
       const IKCallbackFn& solution_callback, moveit_msgs::msg::MoveItErrorCodes& error_code,
       const kinematics::KinematicsQueryOptions& options = kinematics::KinematicsQueryOptions()) const override;
 
+  /// @brief Solves the poses concurrently, every thread reuses its own solver for all the poses it solves
+  bool searchPositionIKBatch(
+      const std::vector<geometry_msgs::msg::Pose>& ik_poses, const std::vector<std::vector<double>>& ik_seed_states,
+      double timeout_per_pose, std::vector<std::vector<double>>& solutions,
+      std::vector<moveit_msgs::msg::MoveItErrorCodes>& error_codes,
+      const kinematics::KinematicsQueryOptions& options = kinematics::KinematicsQueryOptions()) const override;
+
   bool getPositionFK(const std::vector<std::string>& link_names, const std::vector<double>& joint_angles,
                      std::vector<geometry_msgs::msg::Pose>& poses) const override;
 
@@ -132,15 +140,32 @@ private:
   /** Harmonize revolute joint values into the range -2 Pi .. 2 Pi */
   void harmonize(Eigen::VectorXd& values) const;
 
-  void getRandomConfiguration(Eigen::VectorXd& jnt_array) const;
+  void getRandomConfiguration(moveit::core::RobotState& state, Eigen::VectorXd& jnt_array) const;
 
   /** @brief Get a random configuration within consistency limits close to the seed state
+   *  @param state Provides the random number generator
    *  @param seed_state Seed state
    *  @param consistency_limits
    *  @param jnt_array Returned random configuration
    */
-  void getRandomConfiguration(const Eigen::VectorXd& seed_state, const std::vector<double>& consistency_limits,
-                              Eigen::VectorXd& jnt_array) const;
+  void getRandomConfiguration(moveit::core::RobotState& state, const Eigen::VectorXd& seed_state,
+                              const std::vector<double>& consistency_limits, Eigen::VectorXd& jnt_array) const;
+
+  /** @brief Create the LMA solver of the kinematic chain, the fixed-size one for chains of 6 or 7 joints */
+  std::unique_ptr<KDL::ChainIkSolverPos> createSolver() const;
+
+  /** @brief Implementation of searchPositionIK() for an initialized solver
+   *  @param ik_solver_pos Solver of the kinematic chain, only used by one thread at a time
+   *  @param state Scratch state for random re-seeding, only used by one thread at a time
+   *  @param from_seed Start from the seed state, otherwise only from random restarts
+   *  @param stop Cancels the search when it returns true, e.g. because another thread found a solution
+   */
+  bool solvePositionIK(KDL::ChainIkSolverPos& ik_solver_pos, moveit::core::RobotState& state,
+                       const geometry_msgs::msg::Pose& ik_pose, const std::vector<double>& ik_seed_state,
+                       double timeout, const std::vector<double>& consistency_limits, std::vector<double>& solution,
+                       const IKCallbackFn& solution_callback, moveit_msgs::msg::MoveItErrorCodes& error_code,
+                       const kinematics::KinematicsQueryOptions& options, bool from_seed = true,
+                       const std::function<bool()>& stop = std::function<bool()>()) const;
 
   bool initialized_;  ///< Internal variable that indicates whether solver is configured and ready
 
@@ -150,6 +175,7 @@ private:
   const moveit::core::JointModelGroup* joint_model_group_;
   moveit::core::RobotStatePtr state_;
   KDL::Chain kdl_chain_;
+  ReducedChain reduced_chain_;  ///< The chain for ChainIkSolverPosLMAFixed, empty if that solver is not used
   std::unique_ptr<KDL::ChainFkSolverPos> fk_solver_;
   std::vector<const moveit::core::JointModel*> joints_;
   std::vector<std::string> joint_names_;
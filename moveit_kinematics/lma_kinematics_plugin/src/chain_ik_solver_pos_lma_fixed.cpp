@@ -0,0 +1,90 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/lma_kinematics_plugin/chain_ik_solver_pos_lma_fixed.h>
+
+namespace lma_kinematics_plugin
+{
+bool reduceChain(const KDL::Chain& chain, ReducedChain& reduced)
+{
+  reduced.joints.clear();
+  Eigen::Isometry3d pending = Eigen::Isometry3d::Identity();
+  for (const KDL::Segment& segment : chain.segments)
+  {
+    const KDL::Joint& joint = segment.getJoint();
+    bool revolute;
+    switch (joint.getType())
+    {
+      case KDL::Joint::RotAxis:
+      case KDL::Joint::RotX:
+      case KDL::Joint::RotY:
+      case KDL::Joint::RotZ:
+        revolute = true;
+        break;
+      case KDL::Joint::TransAxis:
+      case KDL::Joint::TransX:
+      case KDL::Joint::TransY:
+      case KDL::Joint::TransZ:
+        revolute = false;
+        break;
+      default:
+        pending = pending * toEigen(segment.pose(0.0));
+        continue;
+    }
+
+    ChainJoint reduced_joint;
+    const Eigen::Isometry3d origin = toEigen(joint.pose(0.0));
+    const KDL::Vector axis = joint.JointAxis();  // in the parent frame
+    reduced_joint.origin = pending * origin;
+    reduced_joint.axis = (origin.linear().transpose() * Eigen::Map<const Eigen::Vector3d>(axis.data)).normalized();
+    reduced_joint.revolute = revolute;
+
+    // joints with a scale or offset do not move by their position about the axis
+    const double q = 0.7;
+    const Eigen::Isometry3d expected =
+        revolute ? Eigen::Isometry3d(origin * Eigen::AngleAxisd(q, reduced_joint.axis)) :
+                   Eigen::Isometry3d(origin * Eigen::Translation3d(q * reduced_joint.axis));
+    if (!expected.isApprox(toEigen(joint.pose(q)), 1e-9))
+      return false;
+
+    reduced.joints.push_back(reduced_joint);
+    pending = origin.inverse() * toEigen(segment.pose(0.0));
+  }
+  reduced.tip = pending;
+  return true;
+}
+
+template class ChainIkSolverPosLMAFixed<6>;
+template class ChainIkSolverPosLMAFixed<7>;
+}  // namespace lma_kinematics_plugin
@@ -47,6 +47,8 @@
 #include <kdl/frames_io.hpp>
 #include <kdl/kinfam_io.hpp>
 
+#include <algorithm>
+
 // register as a KinematicsBase implementation
 #include <class_loader/class_loader.hpp>
 CLASS_LOADER_REGISTER_CLASS(lma_kinematics_plugin::LMAKinematicsPlugin, kinematics::KinematicsBase)
@@ -59,17 +61,17 @@ LMAKinematicsPlugin::LMAKinematicsPlugin() : initialized_(false)
 {
 }
 
-void LMAKinematicsPlugin::getRandomConfiguration(Eigen::VectorXd& jnt_array) const
+void LMAKinematicsPlugin::getRandomConfiguration(moveit::core::RobotState& state, Eigen::VectorXd& jnt_array) const
 {
-  state_->setToRandomPositions(joint_model_group_);
-  state_->copyJointGroupPositions(joint_model_group_, &jnt_array[0]);
+  state.setToRandomPositions(joint_model_group_);
+  state.copyJointGroupPositions(joint_model_group_, &jnt_array[0]);
 }
 
-void LMAKinematicsPlugin::getRandomConfiguration(const Eigen::VectorXd& seed_state,
+void LMAKinematicsPlugin::getRandomConfiguration(moveit::core::RobotState& state, const Eigen::VectorXd& seed_state,
                                                  const std::vector<double>& consistency_limits,
                                                  Eigen::VectorXd& jnt_array) const
 {
-  joint_model_group_->getVariableRandomPositionsNearBy(state_->getRandomNumberGenerator(), &jnt_array[0],
+  joint_model_group_->getVariableRandomPositionsNearBy(state.getRandomNumberGenerator(), &jnt_array[0],
                                                        &seed_state[0], consistency_limits);
 }
 
@@ -139,6 +141,17 @@ bool LMAKinematicsPlugin::initialize(const rclcpp::Node::SharedPtr& node, const
   if (orientation_vs_position_weight_ == 0.0)
     RCLCPP_INFO(LOGGER, "Using position only ik");
 
+  // the common arms of 6 and 7 joints use the solver with fixed-size matrices
+  bool fixed_size_solver;
+  lookupParam(node_, "fixed_size_solver", fixed_size_solver, true);
+  reduced_chain_.joints.clear();
+  if (fixed_size_solver && (dimension_ == 6 || dimension_ == 7) && kdl_chain_.getNrOfJoints() == dimension_ &&
+      !reduceChain(kdl_chain_, reduced_chain_))
+  {
+    RCLCPP_DEBUG(LOGGER, "Chain of group '%s' is not supported by the fixed-size solver", group_name.c_str());
+    reduced_chain_.joints.clear();
+  }
+
   // Setup the joint state groups that we need
   state_ = std::make_shared<moveit::core::RobotState>(robot_model_);
 
@@ -222,7 +235,6 @@ bool LMAKinematicsPlugin::searchPositionIK(const geometry_msgs::msg::Pose& ik_po
                                            moveit_msgs::msg::MoveItErrorCodes& error_code,
                                            const kinematics::KinematicsQueryOptions& options) const
 {
-  rclcpp::Time start_time = node_->now();
   if (!initialized_)
   {
     RCLCPP_ERROR(LOGGER, "kinematics solver not initialized");
@@ -230,21 +242,59 @@ bool LMAKinematicsPlugin::searchPositionIK(const geometry_msgs::msg::Pose& ik_po
     return false;
   }
 
-  if (ik_seed_state.size() != dimension_)
+  if (options.parallel_restarts > 1)
   {
-    RCLCPP_ERROR(LOGGER, "Seed state must have size %d instead of size %zu", dimension_, ik_seed_state.size());
-    error_code.val = error_code.NO_IK_SOLUTION;
-    return false;
+    return searchRestartsConcurrently(
+        ik_seed_state, solution_callback, options,
+        [&]() -> RestartSearchFn {
+          std::shared_ptr<KDL::ChainIkSolverPos> ik_solver_pos = createSolver();
+          auto state = std::make_shared<moveit::core::RobotState>(robot_model_);
+          return [&, ik_solver_pos, state](bool from_seed, const IKCallbackFn& callback,
+                                           const std::function<bool()>& stop, std::vector<double>& candidate,
+                                           moveit_msgs::msg::MoveItErrorCodes& candidate_code) {
+            return solvePositionIK(*ik_solver_pos, *state, ik_pose, ik_seed_state, timeout, consistency_limits,
+                                   candidate, callback, candidate_code, options, from_seed, stop);
+          };
+        },
+        solution, error_code);
   }
 
-  if (!consistency_limits.empty() && consistency_limits.size() != dimension_)
+  return solvePositionIK(*createSolver(), *state_, ik_pose, ik_seed_state, timeout, consistency_limits, solution,
+                         solution_callback, error_code, options);
+}
+
+bool LMAKinematicsPlugin::searchPositionIKBatch(const std::vector<geometry_msgs::msg::Pose>& ik_poses,
+                                                const std::vector<std::vector<double>>& ik_seed_states,
+                                                double timeout_per_pose, std::vector<std::vector<double>>& solutions,
+                                                std::vector<moveit_msgs::msg::MoveItErrorCodes>& error_codes,
+                                                const kinematics::KinematicsQueryOptions& options) const
+{
+  if (!prepareBatch(ik_poses, ik_seed_states, solutions, error_codes))
+    return false;
+  if (!initialized_)
   {
-    RCLCPP_ERROR_STREAM(LOGGER, "Consistency limits be empty or must have size " << dimension_ << " instead of size "
-                                                                                 << consistency_limits.size());
-    error_code.val = error_code.NO_IK_SOLUTION;
+    RCLCPP_ERROR(LOGGER, "kinematics solver not initialized");
+    for (moveit_msgs::msg::MoveItErrorCodes& error_code : error_codes)
+      error_code.val = error_code.NO_IK_SOLUTION;
     return false;
   }
 
+  // std::vector<bool> packs its elements, so the threads write to a byte each
+  std::vector<char> solved(ik_poses.size(), false);
+  solveBatchConcurrently(ik_poses.size(), [&]() -> std::function<void(std::size_t)> {
+    std::shared_ptr<KDL::ChainIkSolverPos> ik_solver_pos = createSolver();
+    auto state = std::make_shared<moveit::core::RobotState>(robot_model_);
+    return [&, ik_solver_pos, state](std::size_t i) {
+      const std::vector<double>& seed = ik_seed_states.size() == 1 ? ik_seed_states[0] : ik_seed_states[i];
+      solved[i] = solvePositionIK(*ik_solver_pos, *state, ik_poses[i], seed, timeout_per_pose, std::vector<double>(),
+                                  solutions[i], IKCallbackFn(), error_codes[i], options);
+    };
+  });
+  return std::all_of(solved.begin(), solved.end(), [](char s) { return s; });
+}
+
+std::unique_ptr<KDL::ChainIkSolverPos> LMAKinematicsPlugin::createSolver() const
+{
   Eigen::Matrix<double, 6, 1> cartesian_weights;
   cartesian_weights(0) = 1;
   cartesian_weights(1) = 1;
@@ -252,6 +302,44 @@ bool LMAKinematicsPlugin::searchPositionIK(const geometry_msgs::msg::Pose& ik_po
   cartesian_weights(3) = orientation_vs_position_weight_;
   cartesian_weights(4) = orientation_vs_position_weight_;
   cartesian_weights(5) = orientation_vs_position_weight_;
+  switch (reduced_chain_.joints.size())
+  {
+    case 6:
+      return std::make_unique<ChainIkSolverPosLMAFixed<6>>(reduced_chain_, cartesian_weights, epsilon_,
+                                                           max_solver_iterations_);
+    case 7:
+      return std::make_unique<ChainIkSolverPosLMAFixed<7>>(reduced_chain_, cartesian_weights, epsilon_,
+                                                           max_solver_iterations_);
+    default:
+      return std::make_unique<KDL::ChainIkSolverPos_LMA>(kdl_chain_, cartesian_weights, epsilon_,
+                                                         max_solver_iterations_);
+  }
+}
+
+bool LMAKinematicsPlugin::solvePositionIK(KDL::ChainIkSolverPos& ik_solver_pos, moveit::core::RobotState& state,
+                                          const geometry_msgs::msg::Pose& ik_pose,
+                                          const std::vector<double>& ik_seed_state, double timeout,
+                                          const std::vector<double>& consistency_limits, std::vector<double>& solution,
+                                          const IKCallbackFn& solution_callback,
+                                          moveit_msgs::msg::MoveItErrorCodes& error_code,
+                                          const kinematics::KinematicsQueryOptions& options, bool from_seed,
+                                          const std::function<bool()>& stop) const
+{
+  rclcpp::Time start_time = node_->now();
+  if (ik_seed_state.size() != dimension_)
+  {
+    RCLCPP_ERROR(LOGGER, "Seed state must have size %d instead of size %zu", dimension_, ik_seed_state.size());
+    error_code.val = error_code.NO_IK_SOLUTION;
+    return false;
+  }
+
+  if (!consistency_limits.empty() && consistency_limits.size() != dimension_)
+  {
+    RCLCPP_ERROR_STREAM(LOGGER, "Consistency limits be empty or must have size " << dimension_ << " instead of size "
+                                                                                 << consistency_limits.size());
+    error_code.val = error_code.NO_IK_SOLUTION;
+    return false;
+  }
 
   KDL::JntArray jnt_seed_state(dimension_);
   KDL::JntArray jnt_pos_in(dimension_);
@@ -259,7 +347,6 @@ bool LMAKinematicsPlugin::searchPositionIK(const geometry_msgs::msg::Pose& ik_po
   jnt_seed_state.data = Eigen::Map<const Eigen::VectorXd>(ik_seed_state.data(), ik_seed_state.size());
   jnt_pos_in = jnt_seed_state;
 
-  KDL::ChainIkSolverPos_LMA ik_solver_pos(kdl_chain_, cartesian_weights, epsilon_, max_solver_iterations_);
   solution.resize(dimension_);
 
   KDL::Frame pose_desired;
@@ -273,12 +360,12 @@ bool LMAKinematicsPlugin::searchPositionIK(const geometry_msgs::msg::Pose& ik_po
   do
   {
     ++attempt;
-    if (attempt > 1)  // randomly re-seed after first attempt
+    if (attempt > 1 || !from_seed)  // randomly re-seed after first attempt
     {
       if (!consistency_limits.empty())
-        getRandomConfiguration(jnt_seed_state.data, consistency_limits, jnt_pos_in.data);
+        getRandomConfiguration(state, jnt_seed_state.data, consistency_limits, jnt_pos_in.data);
       else
-        getRandomConfiguration(jnt_pos_in.data);
+        getRandomConfiguration(state, jnt_pos_in.data);
       RCLCPP_DEBUG_STREAM(LOGGER, "New random configuration (" << attempt << "): " << jnt_pos_in);
     }
 
@@ -305,7 +392,7 @@ bool LMAKinematicsPlugin::searchPositionIK(const geometry_msgs::msg::Pose& ik_po
                                                   << "s and " << attempt << " attempts");
       return true;
     }
-  } while (!timedOut(start_time, timeout));
+  } while (!timedOut(start_time, timeout) && !(stop && stop()));
 
   RCLCPP_DEBUG_STREAM(LOGGER, "IK timed out after " << (node_->now() - start_time).seconds() << " > " << timeout
                                                     << "s and " << attempt << " attempts");
@@ -564,6 +564,84 @@ TEST_F(KinematicsTest, searchIK)
   EXPECT_GE(success, EXPECTED_SUCCESS_RATE * num_ik_tests_);
 }
 
+TEST_F(KinematicsTest, searchIKParallelRestarts)
+{
+  std::vector<double> fk_values, solution;
+  moveit_msgs::msg::MoveItErrorCodes error_code;
+  const std::vector<double> seed(kinematics_solver_->getJointNames().size(), 0.0);
+  const std::vector<std::string>& fk_names = kinematics_solver_->getTipFrames();
+  moveit::core::RobotState robot_state(robot_model_);
+  robot_state.setToDefaultValues();
+
+  kinematics::KinematicsQueryOptions options;
+  options.parallel_restarts = 4;
+  unsigned int success = 0;
+  for (unsigned int i = 0; i < num_ik_tests_; ++i)
+  {
+    robot_state.setToRandomPositions(jmg_, this->rng_);
+    robot_state.copyJointGroupPositions(jmg_, fk_values);
+    std::vector<geometry_msgs::msg::Pose> poses;
+    ASSERT_TRUE(kinematics_solver_->getPositionFK(fk_names, fk_values, poses));
+
+    // Alternate between the first solution and the one closest to the seed
+    options.rank_by_seed_distance = i % 2;
+    kinematics_solver_->searchPositionIK(poses[0], seed, timeout_, solution, error_code, options);
+    if (error_code.val == error_code.SUCCESS)
+      success++;
+    else
+      continue;
+
+    std::vector<geometry_msgs::msg::Pose> reached_poses;
+    kinematics_solver_->getPositionFK(fk_names, solution, reached_poses);
+    EXPECT_NEAR_POSES(poses, reached_poses, tolerance_);
+  }
+  EXPECT_GE(success, EXPECTED_SUCCESS_RATE * num_ik_tests_);
+}
+
+TEST_F(KinematicsTest, searchIKBatch)
+{
+  const std::vector<std::string>& fk_names = kinematics_solver_->getTipFrames();
+  moveit::core::RobotState robot_state(robot_model_);
+  robot_state.setToDefaultValues();
+
+  std::vector<geometry_msgs::msg::Pose> poses;
+  std::vector<double> fk_values;
+  for (unsigned int i = 0; i < num_ik_tests_; ++i)
+  {
+    robot_state.setToRandomPositions(jmg_, this->rng_);
+    robot_state.copyJointGroupPositions(jmg_, fk_values);
+    std::vector<geometry_msgs::msg::Pose> fk_poses;
+    ASSERT_TRUE(kinematics_solver_->getPositionFK(fk_names, fk_values, fk_poses));
+    poses.push_back(fk_poses[0]);
+  }
+
+  // A single seed is used for all poses
+  const std::vector<std::vector<double>> seeds(1, std::vector<double>(kinematics_solver_->getJointNames().size(), 0.0));
+  std::vector<std::vector<double>> solutions;
+  std::vector<moveit_msgs::msg::MoveItErrorCodes> error_codes;
+  kinematics_solver_->searchPositionIKBatch(poses, seeds, timeout_, solutions, error_codes);
+  ASSERT_EQ(solutions.size(), poses.size());
+  ASSERT_EQ(error_codes.size(), poses.size());
+
+  unsigned int success = 0;
+  for (std::size_t i = 0; i < poses.size(); ++i)
+  {
+    if (error_codes[i].val != moveit_msgs::msg::MoveItErrorCodes::SUCCESS)
+      continue;
+    success++;
+
+    std::vector<geometry_msgs::msg::Pose> reached_poses;
+    kinematics_solver_->getPositionFK(fk_names, solutions[i], reached_poses);
+    const std::vector<geometry_msgs::msg::Pose> expected_poses(1, poses[i]);
+    EXPECT_NEAR_POSES(expected_poses, reached_poses, tolerance_);
+  }
+  EXPECT_GE(success, EXPECTED_SUCCESS_RATE * num_ik_tests_);
+
+  // The number of seeds must match the number of poses
+  EXPECT_FALSE(kinematics_solver_->searchPositionIKBatch(poses, std::vector<std::vector<double>>(2, seeds[0]),
+                                                         timeout_, solutions, error_codes));
+}
+
 TEST_F(KinematicsTest, searchIKWithCallback)
 {
   std::vector<double> seed, fk_values, solution;
@@ -66,6 +66,13 @@ void CHOMPInterface::loadParams()
   node_->get_parameter_or("chomp.collision_clearance", params_.min_clearance_, 0.2);
   node_->get_parameter_or("chomp.collision_threshold", params_.collision_threshold_, 0.07);
   node_->get_parameter_or("chomp.use_stochastic_descent", params_.use_stochastic_descent_, true);
+  node_->get_parameter_or("chomp.convergence_threshold", params_.convergence_threshold_, 0.0);
+  node_->get_parameter_or("chomp.multiresolution_levels", params_.multiresolution_levels_, 1);
+  node_->get_parameter_or("chomp.multiresolution_decimation", params_.multiresolution_decimation_, 2);
+  node_->get_parameter_or("chomp.multiresolution_max_iterations", params_.multiresolution_max_iterations_, 20);
+  node_->get_parameter_or("chomp.multiresolution_convergence_threshold",
+                          params_.multiresolution_convergence_threshold_, 1e-3);
+  node_->get_parameter_or("chomp.refinement_max_iterations", params_.refinement_max_iterations_, 10);
   params_.trajectory_initialization_method_ = "quintic-spline";
   std::string method;
   if (node_->get_parameter("chomp.trajectory_initialization_method", method) &&
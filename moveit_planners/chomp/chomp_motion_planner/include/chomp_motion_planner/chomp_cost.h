@@ -45,6 +45,10 @@ namespace chomp
 {
 /**
  * \brief Represents the smoothness cost for CHOMP, for a single joint
+ *
+ * The quadratic cost is a sum of squared finite-difference matrices and therefore banded. It is stored in band form
+ * and its free-variable block is factorized as LDL^T once, so that products and solves are linear in the number of
+ * waypoints instead of requiring a dense inverse.
  */
 class ChompCost
 {
@@ -56,9 +60,30 @@ public:
   template <typename Derived>
   void getDerivative(const Eigen::MatrixXd::ColXpr& joint_trajectory, Eigen::MatrixBase<Derived>& derivative) const;
 
-  const Eigen::MatrixXd& getQuadraticCostInverse() const;
+  /**
+   * \brief Overwrites every column of \a rhs (one row per free variable) with the quadratic cost inverse times it
+   */
+  void solve(Eigen::Ref<Eigen::MatrixXd> rhs) const;
+
+  /**
+   * \brief Gets a single column of the quadratic cost inverse without forming the full inverse
+   */
+  void getQuadraticCostInverseColumn(int index, Eigen::VectorXd& column) const;
+
+  /**
+   * \brief Gets a single diagonal element of the quadratic cost inverse
+   */
+  double getQuadraticCostInverseDiagonal(int index) const;
+
+  /**
+   * \brief Builds the dense quadratic cost inverse; this is quadratic in the number of free variables
+   */
+  Eigen::MatrixXd getQuadraticCostInverse() const;
 
-  const Eigen::MatrixXd& getQuadraticCost() const;
+  /**
+   * \brief Builds the dense quadratic cost of the free variables
+   */
+  Eigen::MatrixXd getQuadraticCost() const;
 
   double getCost(const Eigen::MatrixXd::ColXpr& joint_trajectory) const;
 
@@ -67,34 +92,53 @@ public:
   void scale(double scale);
 
 private:
-  Eigen::MatrixXd quad_cost_full_;
-  Eigen::MatrixXd quad_cost_;
-  // Eigen::VectorXd linear_cost_;
-  Eigen::MatrixXd quad_cost_inv_;
+  int num_vars_all_;
+  int num_vars_free_;
+  int free_vars_start_;
+  int bandwidth_;
 
-  Eigen::MatrixXd getDiffMatrix(int size, const double* diff_rule) const;
+  /** Upper band of the quadratic cost over all variables: element (k, i) holds Q(i, i + k) */
+  Eigen::MatrixXd quad_cost_full_band_;
+  /** LDL^T factorization of the free block: row 0 holds D, element (k, j) holds L(j + k, j) for k > 0 */
+  Eigen::MatrixXd quad_cost_factor_band_;
+  Eigen::VectorXd quad_cost_inv_diagonal_;
+
+  void factorize();
+  void computeInverseDiagonal();
+  double getQuadraticCostElement(int row, int col) const;
+
+  template <typename Derived>
+  double getFullRowProduct(int row, const Eigen::MatrixBase<Derived>& joint_trajectory) const;
 };
 
 template <typename Derived>
-void ChompCost::getDerivative(const Eigen::MatrixXd::ColXpr& joint_trajectory,
-                              Eigen::MatrixBase<Derived>& derivative) const
-{
-  derivative = (quad_cost_full_ * (2.0 * joint_trajectory));
-}
-
-inline const Eigen::MatrixXd& ChompCost::getQuadraticCostInverse() const
+double ChompCost::getFullRowProduct(int row, const Eigen::MatrixBase<Derived>& joint_trajectory) const
 {
-  return quad_cost_inv_;
+  double value = quad_cost_full_band_(0, row) * joint_trajectory(row);
+  for (int k = 1; k <= bandwidth_; ++k)
+  {
+    if (row + k < num_vars_all_)
+      value += quad_cost_full_band_(k, row) * joint_trajectory(row + k);
+    if (row - k >= 0)
+      value += quad_cost_full_band_(k, row - k) * joint_trajectory(row - k);
+  }
+  return value;
 }
 
-inline const Eigen::MatrixXd& ChompCost::getQuadraticCost() const
+template <typename Derived>
+void ChompCost::getDerivative(const Eigen::MatrixXd::ColXpr& joint_trajectory,
+                              Eigen::MatrixBase<Derived>& derivative) const
 {
-  return quad_cost_;
+  for (int i = 0; i < num_vars_all_; ++i)
+    derivative(i) = 2.0 * getFullRowProduct(i, joint_trajectory);
 }
 
 inline double ChompCost::getCost(const Eigen::MatrixXd::ColXpr& joint_trajectory) const
 {
-  return joint_trajectory.dot(quad_cost_full_ * joint_trajectory);
+  double cost = 0.0;
+  for (int i = 0; i < num_vars_all_; ++i)
+    cost += joint_trajectory(i) * getFullRowProduct(i, joint_trajectory);
+  return cost;
 }
 
 }  // namespace chomp
@@ -46,6 +46,7 @@
 
 #include <Eigen/Core>
 #include <Eigen/StdVector>
+#include <functional>
 #include <vector>
 
 namespace chomp
@@ -108,7 +109,29 @@ private:
   //                     const std::string& group_name,
   //                     Eigen::VectorXd& state_vec);
 
-  void setRobotStateFromPoint(ChompTrajectory& group_trajectory, int i);
+  void setRobotStateFromPoint(ChompTrajectory& group_trajectory, int i, moveit::core::RobotState& state);
+
+  /**
+   * \brief Buffers owned by one worker thread while trajectory points are processed in parallel
+   */
+  struct ThreadBuffers
+  {
+    ThreadBuffers(const moveit::core::RobotState& robot_state, int num_joints);
+
+    moveit::core::RobotState state;
+    collision_detection::GroupStateRepresentationPtr gsr;
+    Eigen::MatrixXd jacobian;
+    Eigen::MatrixXd jacobian_pseudo_inverse;
+    Eigen::MatrixXd jacobian_jacobian_tranpose;
+  };
+
+  /**
+   * \brief Calls \a function for every trajectory point in [start, end], distributed over the worker threads.
+   *
+   * \a function must only write data belonging to its trajectory point, so that the result does not depend on the
+   * number of threads or the order in which the points are processed.
+   */
+  void forEachTrajectoryPoint(int start, int end, const std::function<void(int, ThreadBuffers&)>& function);
 
   // collision_proximity::CollisionProximitySpace::TrajectorySafety checkCurrentIterValidity();
 
@@ -134,6 +157,7 @@ private:
 
   std::vector<ChompCost> joint_costs_;
   collision_detection::GroupStateRepresentationPtr gsr_;
+  std::vector<ThreadBuffers> thread_buffers_;
   bool initialized_;
 
   std::vector<std::vector<std::string> > collision_point_joint_names_;
@@ -170,9 +194,6 @@ private:
 
   // temporary variables for all functions:
   Eigen::VectorXd smoothness_derivative_;
-  Eigen::MatrixXd jacobian_;
-  Eigen::MatrixXd jacobian_pseudo_inverse_;
-  Eigen::MatrixXd jacobian_jacobian_tranpose_;
   Eigen::VectorXd random_state_;
   Eigen::VectorXd joint_state_velocities_;
 
@@ -199,6 +220,7 @@ private:
   void initialize();
   void calculateSmoothnessIncrements();
   void calculateCollisionIncrements();
+  void calculateCollisionIncrements(int trajectory_point, ThreadBuffers& buffers);
   void calculateTotalIncrements();
   void performForwardKinematics();
   void addIncrementsToTrajectory();
@@ -212,8 +234,8 @@ private:
   void getRandomMomentum();
   void updateMomentum();
   void updatePositionFromMomentum();
-  void calculatePseudoInverse();
-  void computeJointProperties(int trajectoryPoint);
+  void calculatePseudoInverse(ThreadBuffers& buffers) const;
+  void computeJointProperties(int trajectoryPoint, const moveit::core::RobotState& state);
   bool isCurrentTrajectoryMeshToMeshCollisionFree() const;
 };
 }  // namespace chomp
@@ -90,6 +90,16 @@ public:
   double min_clearance_;        /// the minimum distance that needs to be maintained to avoid obstacles
   double collision_threshold_;  /// the collision threshold cost that needs to be mainted to avoid collisions
   bool filter_mode_;
+  double convergence_threshold_;  /// stop once an iteration improves the total cost by less than this fraction of the
+                                 /// previous cost; 0 disables the check
+
+  int multiresolution_levels_;  /// number of resolution levels to optimize on, coarsest first; 1 optimizes at full
+                                /// resolution only
+  int multiresolution_decimation_;  /// factor by which the number of trajectory segments shrinks per coarser level
+  int multiresolution_max_iterations_;  /// maximum number of iterations on each coarse level
+  double multiresolution_convergence_threshold_;  /// convergence_threshold_ used on the coarse levels
+  int refinement_max_iterations_;  /// maximum number of iterations at full resolution after the coarse levels, replaces
+                                   /// max_iterations_ when multiresolution_levels_ > 1
 
   static const std::vector<std::string> VALID_INITIALIZATION_METHODS;
   std::string trajectory_initialization_method_;  /// trajectory initialization method to be specified
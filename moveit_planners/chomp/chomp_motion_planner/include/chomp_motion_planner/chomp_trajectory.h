@@ -135,6 +135,15 @@ public:
    */
   bool fillInFromTrajectory(const robot_trajectory::RobotTrajectory& trajectory);
 
+  /**
+   * \brief Fills the whole trajectory by linearly interpolating \a source, which spans the same duration at a different
+   * discretization
+   *
+   * Used to move a solution between the levels of a multiresolution optimization. The first and last points are
+   * copied from \a source exactly.
+   */
+  void fillInFromTrajectory(const ChompTrajectory& source);
+
   /**
    * \brief This function assigns the given \a source RobotState to the row at index \a chomp_trajectory_point
    *
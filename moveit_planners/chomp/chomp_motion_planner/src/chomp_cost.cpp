@@ -37,7 +37,7 @@
 #include <chomp_motion_planner/chomp_cost.h>
 #include <chomp_motion_planner/chomp_utils.h>
 
-#include <eigen3/Eigen/LU>
+#include <algorithm>
 
 using namespace Eigen;
 using namespace std;
@@ -46,60 +46,163 @@ namespace chomp
 {
 ChompCost::ChompCost(const ChompTrajectory& trajectory, int /* joint_number */,
                      const std::vector<double>& derivative_costs, double ridge_factor)
+  : num_vars_all_(trajectory.getNumPoints())
+  , num_vars_free_(num_vars_all_ - 2 * (DIFF_RULE_LENGTH - 1))
+  , free_vars_start_(DIFF_RULE_LENGTH - 1)
+  , bandwidth_(2 * (DIFF_RULE_LENGTH / 2))
 {
-  int num_vars_all = trajectory.getNumPoints();
-  int num_vars_free = num_vars_all - 2 * (DIFF_RULE_LENGTH - 1);
-  MatrixXd diff_matrix = MatrixXd::Zero(num_vars_all, num_vars_all);
-  quad_cost_full_ = MatrixXd::Zero(num_vars_all, num_vars_all);
+  quad_cost_full_band_ = MatrixXd::Zero(bandwidth_ + 1, num_vars_all_);
 
-  // construct the quad cost for all variables, as a sum of squared differentiation matrices
+  // construct the quad cost for all variables, as a sum of squared differentiation matrices. Row m of a
+  // differentiation matrix only touches the variables m - DIFF_RULE_LENGTH / 2 ... m + DIFF_RULE_LENGTH / 2, so
+  // each row contributes a small dense block to the band.
+  const int half_length = DIFF_RULE_LENGTH / 2;
   double multiplier = 1.0;
-  for (unsigned int i = 0; i < derivative_costs.size(); ++i)
+  for (unsigned int r = 0; r < derivative_costs.size(); ++r)
   {
     multiplier *= trajectory.getDiscretization();
-    diff_matrix = getDiffMatrix(num_vars_all, &DIFF_RULES[i][0]);
-    quad_cost_full_ += (derivative_costs[i] * multiplier) * (diff_matrix.transpose() * diff_matrix);
+    const double weight = derivative_costs[r] * multiplier;
+    const double* diff_rule = &DIFF_RULES[r][0];
+    for (int m = 0; m < num_vars_all_; ++m)
+    {
+      const int first = std::max(0, m - half_length);
+      const int last = std::min(num_vars_all_ - 1, m + half_length);
+      for (int i = first; i <= last; ++i)
+      {
+        for (int j = i; j <= last; ++j)
+          quad_cost_full_band_(j - i, i) += weight * diff_rule[i - m + half_length] * diff_rule[j - m + half_length];
+      }
+    }
   }
-  quad_cost_full_ += MatrixXd::Identity(num_vars_all, num_vars_all) * ridge_factor;
+  quad_cost_full_band_.row(0).array() += ridge_factor;
 
-  // extract the quad cost just for the free variables:
-  quad_cost_ = quad_cost_full_.block(DIFF_RULE_LENGTH - 1, DIFF_RULE_LENGTH - 1, num_vars_free, num_vars_free);
+  factorize();
+  computeInverseDiagonal();
+}
+
+double ChompCost::getQuadraticCostElement(int row, int col) const
+{
+  // element of the free block, which starts at free_vars_start_ in the full band
+  if (row > col)
+    std::swap(row, col);
+  if (col - row > bandwidth_)
+    return 0.0;
+  return quad_cost_full_band_(col - row, free_vars_start_ + row);
+}
+
+void ChompCost::factorize()
+{
+  // banded LDL^T factorization of the free block, O(n * bandwidth^2)
+  quad_cost_factor_band_ = MatrixXd::Zero(bandwidth_ + 1, num_vars_free_);
+  for (int j = 0; j < num_vars_free_; ++j)
+  {
+    double d = getQuadraticCostElement(j, j);
+    for (int p = std::max(0, j - bandwidth_); p < j; ++p)
+    {
+      const double l = quad_cost_factor_band_(j - p, p);
+      d -= l * l * quad_cost_factor_band_(0, p);
+    }
+    quad_cost_factor_band_(0, j) = d;
 
-  // invert the matrix:
-  quad_cost_inv_ = quad_cost_.inverse();
+    for (int i = j + 1; i <= std::min(num_vars_free_ - 1, j + bandwidth_); ++i)
+    {
+      double value = getQuadraticCostElement(i, j);
+      for (int p = std::max(0, i - bandwidth_); p < j; ++p)
+        value -= quad_cost_factor_band_(i - p, p) * quad_cost_factor_band_(j - p, p) * quad_cost_factor_band_(0, p);
+      quad_cost_factor_band_(i - j, j) = value / d;
+    }
+  }
+}
 
-  // cout << quad_cost_inv_ << endl;
+void ChompCost::computeInverseDiagonal()
+{
+  // Takahashi recurrence: the elements of the inverse inside the band only depend on the factorization and on
+  // elements of the inverse inside the band further down, so the diagonal is computed without the full inverse
+  MatrixXd inverse_band = MatrixXd::Zero(bandwidth_ + 1, num_vars_free_);
+  auto inverse = [&inverse_band](int row, int col) {
+    return row <= col ? inverse_band(col - row, row) : inverse_band(row - col, col);
+  };
+  for (int i = num_vars_free_ - 1; i >= 0; --i)
+  {
+    const int last = std::min(num_vars_free_ - 1, i + bandwidth_);
+    for (int j = last; j > i; --j)
+    {
+      double value = 0.0;
+      for (int q = i + 1; q <= last; ++q)
+        value -= quad_cost_factor_band_(q - i, i) * inverse(q, j);
+      inverse_band(j - i, i) = value;
+    }
+    double value = 1.0 / quad_cost_factor_band_(0, i);
+    for (int q = i + 1; q <= last; ++q)
+      value -= quad_cost_factor_band_(q - i, i) * inverse_band(q - i, i);
+    inverse_band(0, i) = value;
+  }
+  quad_cost_inv_diagonal_ = inverse_band.row(0).transpose();
 }
 
-Eigen::MatrixXd ChompCost::getDiffMatrix(int size, const double* diff_rule) const
+void ChompCost::solve(Eigen::Ref<Eigen::MatrixXd> rhs) const
 {
-  MatrixXd matrix = MatrixXd::Zero(size, size);
-  for (int i = 0; i < size; ++i)
+  for (int c = 0; c < rhs.cols(); ++c)
   {
-    for (int j = -DIFF_RULE_LENGTH / 2; j <= DIFF_RULE_LENGTH / 2; ++j)
+    auto x = rhs.col(c);
+    // forward substitution with L
+    for (int i = 0; i < num_vars_free_; ++i)
     {
-      int index = i + j;
-      if (index < 0)
-        continue;
-      if (index >= size)
-        continue;
-      matrix(i, index) = diff_rule[j + DIFF_RULE_LENGTH / 2];
+      for (int p = std::max(0, i - bandwidth_); p < i; ++p)
+        x(i) -= quad_cost_factor_band_(i - p, p) * x(p);
     }
+    // diagonal
+    x.array() /= quad_cost_factor_band_.row(0).transpose().array();
+    // backward substitution with L^T
+    for (int i = num_vars_free_ - 1; i >= 0; --i)
+    {
+      for (int q = i + 1; q <= std::min(num_vars_free_ - 1, i + bandwidth_); ++q)
+        x(i) -= quad_cost_factor_band_(q - i, i) * x(q);
+    }
+  }
+}
+
+void ChompCost::getQuadraticCostInverseColumn(int index, Eigen::VectorXd& column) const
+{
+  column = VectorXd::Unit(num_vars_free_, index);
+  solve(column);
+}
+
+double ChompCost::getQuadraticCostInverseDiagonal(int index) const
+{
+  return quad_cost_inv_diagonal_(index);
+}
+
+Eigen::MatrixXd ChompCost::getQuadraticCostInverse() const
+{
+  MatrixXd inverse = MatrixXd::Identity(num_vars_free_, num_vars_free_);
+  solve(inverse);
+  return inverse;
+}
+
+Eigen::MatrixXd ChompCost::getQuadraticCost() const
+{
+  MatrixXd quad_cost = MatrixXd::Zero(num_vars_free_, num_vars_free_);
+  for (int i = 0; i < num_vars_free_; ++i)
+  {
+    for (int j = std::max(0, i - bandwidth_); j <= std::min(num_vars_free_ - 1, i + bandwidth_); ++j)
+      quad_cost(i, j) = getQuadraticCostElement(i, j);
   }
-  return matrix;
+  return quad_cost;
 }
 
 double ChompCost::getMaxQuadCostInvValue() const
 {
-  return quad_cost_inv_.maxCoeff();
+  // the inverse is symmetric positive definite, so its largest element lies on the diagonal
+  return quad_cost_inv_diagonal_.maxCoeff();
 }
 
 void ChompCost::scale(double scale)
 {
-  double inv_scale = 1.0 / scale;
-  quad_cost_inv_ *= inv_scale;
-  quad_cost_ *= scale;
-  quad_cost_full_ *= scale;
+  // scaling Q scales D of its LDL^T factorization and leaves L unchanged
+  quad_cost_full_band_ *= scale;
+  quad_cost_factor_band_.row(0) *= scale;
+  quad_cost_inv_diagonal_ /= scale;
 }
 
 ChompCost::~ChompCost() = default;
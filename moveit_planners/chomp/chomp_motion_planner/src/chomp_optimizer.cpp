@@ -44,7 +44,11 @@
 #include <rclcpp/logging.hpp>
 #include <eigen3/Eigen/Core>
 #include <eigen3/Eigen/LU>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <random>
+#include <thread>
 #include <visualization_msgs/msg/marker_array.hpp>
 
 namespace chomp
@@ -108,6 +112,22 @@ void ChompOptimizer::initialize()
     num_collision_points_ += gradient.gradients.size();
   }
 
+  // every worker thread needs its own robot state and group state representation to evaluate gradients;
+  // the first one reuses the representation generated above
+  const size_t thread_count =
+      std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), static_cast<size_t>(num_vars_all_));
+  thread_buffers_.clear();
+  thread_buffers_.reserve(thread_count);
+  for (size_t t = 0; t < thread_count; ++t)
+  {
+    thread_buffers_.emplace_back(state_, num_joints_);
+    if (t == 0)
+      thread_buffers_.back().gsr = gsr_;
+    else
+      hy_env_->getCollisionGradients(req, res, thread_buffers_.back().state,
+                                     &planning_scene_->getAllowedCollisionMatrix(), thread_buffers_.back().gsr);
+  }
+
   // set up the joint costs:
   joint_costs_.reserve(num_joints_);
 
@@ -141,9 +161,6 @@ void ChompOptimizer::initialize()
   collision_increments_ = Eigen::MatrixXd::Zero(num_vars_free_, num_joints_);
   final_increments_ = Eigen::MatrixXd::Zero(num_vars_free_, num_joints_);
   smoothness_derivative_ = Eigen::VectorXd::Zero(num_vars_all_);
-  jacobian_ = Eigen::MatrixXd::Zero(3, num_joints_);
-  jacobian_pseudo_inverse_ = Eigen::MatrixXd::Zero(num_joints_, 3);
-  jacobian_jacobian_tranpose_ = Eigen::MatrixXd::Zero(3, 3);
   random_state_ = Eigen::VectorXd::Zero(num_joints_);
   joint_state_velocities_ = Eigen::VectorXd::Zero(num_joints_);
 
@@ -175,13 +192,14 @@ void ChompOptimizer::initialize()
   // momentum_ = Eigen::MatrixXd::Zero(num_vars_free_, num_joints_);
   // random_momentum_ = Eigen::MatrixXd::Zero(num_vars_free_, num_joints_);
   // random_joint_momentum_ = Eigen::VectorXd::Zero(num_vars_free_);
-  multivariate_gaussian_.clear();
+  // The samplers need the dense quadratic cost inverse, so they are only built together with the HMC code above.
+  // multivariate_gaussian_.clear();
+  // for (int i = 0; i < num_joints_; ++i)
+  // {
+  //   multivariate_gaussian_.push_back(
+  //       MultivariateGaussian(Eigen::VectorXd::Zero(num_vars_free_), joint_costs_[i].getQuadraticCostInverse()));
+  // }
   stochasticity_factor_ = 1.0;
-  for (int i = 0; i < num_joints_; ++i)
-  {
-    multivariate_gaussian_.push_back(
-        MultivariateGaussian(Eigen::VectorXd::Zero(num_vars_free_), joint_costs_[i].getQuadraticCostInverse()));
-  }
 
   std::map<std::string, std::string> fixed_link_resolution_map;
   for (int i = 0; i < num_joints_; ++i)
@@ -309,6 +327,7 @@ bool ChompOptimizer::optimize()
   std::vector<double> costs(cost_window, 0.0);
   // double minimaThreshold = 0.05;
   bool should_break_out = false;
+  double previous_cost = 0.0;
 
   // iterate
   for (iteration_ = 0; iteration_ < parameters_->max_iterations_; ++iteration_)
@@ -352,6 +371,15 @@ bool ChompOptimizer::optimize()
       best_group_trajectory_cost_ = cost;
       last_improvement_iteration_ = iteration_;
     }
+
+    if (parameters_->convergence_threshold_ > 0.0 && iteration_ > 0 &&
+        previous_cost - cost < parameters_->convergence_threshold_ * std::abs(previous_cost))
+    {
+      RCLCPP_INFO(LOGGER, "Cost converged at iteration %d. Breaking out early.", iteration_);
+      break;
+    }
+    previous_cost = cost;
+
     calculateSmoothnessIncrements();
     calculateCollisionIncrements();
     calculateTotalIncrements();
@@ -592,15 +620,6 @@ void ChompOptimizer::calculateSmoothnessIncrements()
 
 void ChompOptimizer::calculateCollisionIncrements()
 {
-  double potential;
-  double vel_mag_sq;
-  double vel_mag;
-  Eigen::Vector3d potential_gradient;
-  Eigen::Vector3d normalized_velocity;
-  Eigen::Matrix3d orthogonal_projector;
-  Eigen::Vector3d curvature_vector;
-  Eigen::Vector3d cartesian_gradient;
-
   collision_increments_.setZero(num_vars_free_, num_joints_);
 
   int start_point = 0;
@@ -622,67 +641,78 @@ void ChompOptimizer::calculateCollisionIncrements()
     start_point = free_vars_start_;
   }
 
-  for (int i = start_point; i <= end_point; ++i)
+  // every point only writes its own row of the increments
+  forEachTrajectoryPoint(start_point, end_point,
+                         [this](int i, ThreadBuffers& buffers) { calculateCollisionIncrements(i, buffers); });
+  // cout << collision_increments_ << endl;
+}
+
+void ChompOptimizer::calculateCollisionIncrements(int i, ThreadBuffers& buffers)
+{
+  double potential;
+  double vel_mag_sq;
+  double vel_mag;
+  Eigen::Vector3d potential_gradient;
+  Eigen::Vector3d normalized_velocity;
+  Eigen::Matrix3d orthogonal_projector;
+  Eigen::Vector3d curvature_vector;
+  Eigen::Vector3d cartesian_gradient;
+
+  for (int j = 0; j < num_collision_points_; ++j)
   {
-    for (int j = 0; j < num_collision_points_; ++j)
-    {
-      potential = collision_point_potential_[i][j];
+    potential = collision_point_potential_[i][j];
 
-      if (potential < 0.0001)
-        continue;
+    if (potential < 0.0001)
+      continue;
 
-      potential_gradient = -collision_point_potential_gradient_[i][j];
+    potential_gradient = -collision_point_potential_gradient_[i][j];
 
-      vel_mag = collision_point_vel_mag_[i][j];
-      vel_mag_sq = vel_mag * vel_mag;
+    vel_mag = collision_point_vel_mag_[i][j];
+    vel_mag_sq = vel_mag * vel_mag;
 
-      // all math from the CHOMP paper:
+    // all math from the CHOMP paper:
 
-      normalized_velocity = collision_point_vel_eigen_[i][j] / vel_mag;
-      orthogonal_projector = Eigen::Matrix3d::Identity() - (normalized_velocity * normalized_velocity.transpose());
-      curvature_vector = (orthogonal_projector * collision_point_acc_eigen_[i][j]) / vel_mag_sq;
-      cartesian_gradient = vel_mag * (orthogonal_projector * potential_gradient - potential * curvature_vector);
+    normalized_velocity = collision_point_vel_eigen_[i][j] / vel_mag;
+    orthogonal_projector = Eigen::Matrix3d::Identity() - (normalized_velocity * normalized_velocity.transpose());
+    curvature_vector = (orthogonal_projector * collision_point_acc_eigen_[i][j]) / vel_mag_sq;
+    cartesian_gradient = vel_mag * (orthogonal_projector * potential_gradient - potential * curvature_vector);
 
-      // pass it through the jacobian transpose to get the increments
-      getJacobian(i, collision_point_pos_eigen_[i][j], collision_point_joint_names_[i][j], jacobian_);
+    // pass it through the jacobian transpose to get the increments
+    getJacobian(i, collision_point_pos_eigen_[i][j], collision_point_joint_names_[i][j], buffers.jacobian);
 
-      if (parameters_->use_pseudo_inverse_)
-      {
-        calculatePseudoInverse();
-        collision_increments_.row(i - free_vars_start_).transpose() -= jacobian_pseudo_inverse_ * cartesian_gradient;
-      }
-      else
+    if (parameters_->use_pseudo_inverse_)
+    {
+      calculatePseudoInverse(buffers);
+      collision_increments_.row(i - free_vars_start_).transpose() -=
+          buffers.jacobian_pseudo_inverse * cartesian_gradient;
+    }
+    else
+    {
+      collision_increments_.row(i - free_vars_start_).transpose() -= buffers.jacobian.transpose() * cartesian_gradient;
+    }
+
+    /*
+      if(point_is_in_collision_[i][j])
       {
-        collision_increments_.row(i - free_vars_start_).transpose() -= jacobian_.transpose() * cartesian_gradient;
+      break;
       }
-
-      /*
-        if(point_is_in_collision_[i][j])
-        {
-        break;
-        }
-      */
-    }
+    */
   }
-  // cout << collision_increments_ << endl;
 }
 
-void ChompOptimizer::calculatePseudoInverse()
+void ChompOptimizer::calculatePseudoInverse(ThreadBuffers& buffers) const
 {
-  jacobian_jacobian_tranpose_ =
-      jacobian_ * jacobian_.transpose() + Eigen::MatrixXd::Identity(3, 3) * parameters_->pseudo_inverse_ridge_factor_;
-  jacobian_pseudo_inverse_ = jacobian_.transpose() * jacobian_jacobian_tranpose_.inverse();
+  buffers.jacobian_jacobian_tranpose = buffers.jacobian * buffers.jacobian.transpose() +
+                                       Eigen::MatrixXd::Identity(3, 3) * parameters_->pseudo_inverse_ridge_factor_;
+  buffers.jacobian_pseudo_inverse = buffers.jacobian.transpose() * buffers.jacobian_jacobian_tranpose.inverse();
 }
 
 void ChompOptimizer::calculateTotalIncrements()
 {
+  final_increments_ = parameters_->learning_rate_ * (parameters_->smoothness_cost_weight_ * smoothness_increments_ +
+                                                     parameters_->obstacle_cost_weight_ * collision_increments_);
   for (int i = 0; i < num_joints_; ++i)
-  {
-    final_increments_.col(i) =
-        parameters_->learning_rate_ * (joint_costs_[i].getQuadraticCostInverse() *
-                                       (parameters_->smoothness_cost_weight_ * smoothness_increments_.col(i) +
-                                        parameters_->obstacle_cost_weight_ * collision_increments_.col(i)));
-  }
+    joint_costs_[i].solve(final_increments_.col(i));
 }
 
 void ChompOptimizer::addIncrementsToTrajectory()
@@ -759,11 +789,11 @@ double ChompOptimizer::getCollisionCost()
   return parameters_->obstacle_cost_weight_ * collision_cost;
 }
 
-void ChompOptimizer::computeJointProperties(int trajectory_point)
+void ChompOptimizer::computeJointProperties(int trajectory_point, const moveit::core::RobotState& state)
 {
   for (int j = 0; j < num_joints_; ++j)
   {
-    const moveit::core::JointModel* joint_model = state_.getJointModel(joint_names_[j]);
+    const moveit::core::JointModel* joint_model = state.getJointModel(joint_names_[j]);
     const moveit::core::RevoluteJointModel* revolute_joint =
         dynamic_cast<const moveit::core::RevoluteJointModel*>(joint_model);
     const moveit::core::PrismaticJointModel* prismatic_joint =
@@ -771,9 +801,9 @@ void ChompOptimizer::computeJointProperties(int trajectory_point)
 
     std::string parent_link_name = joint_model->getParentLinkModel()->getName();
     std::string child_link_name = joint_model->getChildLinkModel()->getName();
-    Eigen::Isometry3d joint_transform = state_.getGlobalLinkTransform(parent_link_name) *
+    Eigen::Isometry3d joint_transform = state.getGlobalLinkTransform(parent_link_name) *
                                         (robot_model_->getLinkModel(child_link_name)->getJointOriginTransform() *
-                                         (state_.getJointTransform(joint_model)));
+                                         (state.getJointTransform(joint_model)));
 
     // joint_transform = inverseWorldTransform * jointTransform;
     Eigen::Vector3d axis;
@@ -826,6 +856,7 @@ void ChompOptimizer::getJacobian(int trajectory_point, Eigen::Vector3d& collisio
 void ChompOptimizer::handleJointLimits()
 {
   const std::vector<const moveit::core::JointModel*> joint_models = joint_model_group_->getActiveJointModels();
+  Eigen::VectorXd inverse_column;
   for (size_t joint_i = 0; joint_i < joint_models.size(); ++joint_i)
   {
     const moveit::core::JointModel* joint_model = joint_models[joint_i];
@@ -893,10 +924,9 @@ void ChompOptimizer::handleJointLimits()
       if (violation)
       {
         int free_var_index = max_violation_index - free_vars_start_;
-        double multiplier =
-            max_violation / joint_costs_[joint_i].getQuadraticCostInverse()(free_var_index, free_var_index);
-        group_trajectory_.getFreeJointTrajectoryBlock(joint_i) +=
-            multiplier * joint_costs_[joint_i].getQuadraticCostInverse().col(free_var_index);
+        double multiplier = max_violation / joint_costs_[joint_i].getQuadraticCostInverseDiagonal(free_var_index);
+        joint_costs_[joint_i].getQuadraticCostInverseColumn(free_var_index, inverse_column);
+        group_trajectory_.getFreeJointTrajectoryBlock(joint_i) += multiplier * inverse_column;
       }
       if (++count > 10)
         break;
@@ -918,29 +948,22 @@ void ChompOptimizer::performForwardKinematics()
     end = num_vars_all_ - 1;
   }
 
-  is_collision_free_ = true;
-
-  auto total_dur = std::chrono::duration<double>::zero();
-
-  // for each point in the trajectory
-  for (int i = start; i <= end; ++i)
-  {
+  // for each point in the trajectory; the points are independent and only write their own entries
+  forEachTrajectoryPoint(start, end, [this](int i, ThreadBuffers& buffers) {
     // Set Robot state from trajectory point...
     collision_detection::CollisionRequest req;
     collision_detection::CollisionResult res;
     req.group_name = planning_group_;
-    setRobotStateFromPoint(group_trajectory_, i);
-    auto grad = std::chrono::system_clock::now();
+    setRobotStateFromPoint(group_trajectory_, i, buffers.state);
 
-    hy_env_->getCollisionGradients(req, res, state_, nullptr, gsr_);
-    total_dur += (std::chrono::system_clock::now() - grad);
-    computeJointProperties(i);
+    hy_env_->getCollisionGradients(req, res, buffers.state, nullptr, buffers.gsr);
+    computeJointProperties(i, buffers.state);
     state_is_in_collision_[i] = false;
 
     // Keep vars in scope
     {
       size_t j = 0;
-      for (const collision_detection::GradientInfo& info : gsr_->gradients_)
+      for (const collision_detection::GradientInfo& info : buffers.gsr->gradients_)
       {
         for (size_t k = 0; k < info.sphere_locations.size(); ++k)
         {
@@ -968,16 +991,16 @@ void ChompOptimizer::performForwardKinematics()
             //   RCLCPP_INFO(LOGGER,"Radius " << info.sphere_radii[k] << " potential " <<
             //   collision_point_potential_[i][j]);
             // }
-
-            is_collision_free_ = false;
           }
           j++;
         }
       }
     }
-  }
+  });
 
-  // RCLCPP_INFO(LOGGER,"Total dur " << total_dur << " total checks " << end-start+1);
+  // reduce the per-point results in trajectory order
+  is_collision_free_ = std::none_of(state_is_in_collision_.begin() + start, state_is_in_collision_.begin() + end + 1,
+                                    [](int in_collision) { return in_collision; });
 
   // now, get the vel and acc for each collision point (using finite differencing)
   for (int i = free_vars_start_; i <= free_vars_end_; ++i)
@@ -1000,7 +1023,7 @@ void ChompOptimizer::performForwardKinematics()
   }
 }
 
-void ChompOptimizer::setRobotStateFromPoint(ChompTrajectory& group_trajectory, int i)
+void ChompOptimizer::setRobotStateFromPoint(ChompTrajectory& group_trajectory, int i, moveit::core::RobotState& state)
 {
   const Eigen::MatrixXd::RowXpr& point = group_trajectory.getTrajectoryPoint(i);
 
@@ -1009,8 +1032,34 @@ void ChompOptimizer::setRobotStateFromPoint(ChompTrajectory& group_trajectory, i
   for (size_t j = 0; j < group_trajectory.getNumJoints(); ++j)
     joint_states.emplace_back(point(0, j));
 
-  state_.setJointGroupPositions(planning_group_, joint_states);
-  state_.update();
+  state.setJointGroupPositions(planning_group_, joint_states);
+  state.update();
+}
+
+ChompOptimizer::ThreadBuffers::ThreadBuffers(const moveit::core::RobotState& robot_state, int num_joints)
+  : state(robot_state)
+  , jacobian(Eigen::MatrixXd::Zero(3, num_joints))
+  , jacobian_pseudo_inverse(Eigen::MatrixXd::Zero(num_joints, 3))
+  , jacobian_jacobian_tranpose(Eigen::MatrixXd::Zero(3, 3))
+{
+}
+
+void ChompOptimizer::forEachTrajectoryPoint(int start, int end,
+                                            const std::function<void(int, ThreadBuffers&)>& function)
+{
+  const size_t thread_count = std::min(thread_buffers_.size(), static_cast<size_t>(std::max(0, end - start + 1)));
+  std::atomic<int> next{ start };
+  auto work = [&next, end, &function](ThreadBuffers& buffers) {
+    for (int i = next++; i <= end; i = next++)
+      function(i, buffers);
+  };
+
+  std::vector<std::thread> threads;
+  for (size_t t = 1; t < thread_count; ++t)
+    threads.emplace_back(work, std::ref(thread_buffers_[t]));
+  work(thread_buffers_[0]);
+  for (std::thread& thread : threads)
+    thread.join();
 }
 
 void ChompOptimizer::perturbTrajectory()
@@ -1039,10 +1088,11 @@ void ChompOptimizer::perturbTrajectory()
                   random_matrix;
 
   int mp_free_vars_index = mid_point - free_vars_start_;
+  Eigen::VectorXd inverse_column;
   for (int i = 0; i < num_joints_; ++i)
   {
-    group_trajectory_.getFreeJointTrajectoryBlock(i) +=
-        joint_costs_[i].getQuadraticCostInverse().col(mp_free_vars_index) * random_state_(i);
+    joint_costs_[i].getQuadraticCostInverseColumn(mp_free_vars_index, inverse_column);
+    group_trajectory_.getFreeJointTrajectoryBlock(i) += inverse_column * random_state_(i);
   }
 }
 
@@ -61,6 +61,12 @@ ChompParameters::ChompParameters()
   collision_threshold_ = 0.07;
   use_stochastic_descent_ = true;
   filter_mode_ = false;
+  convergence_threshold_ = 0.0;
+  multiresolution_levels_ = 1;
+  multiresolution_decimation_ = 2;
+  multiresolution_max_iterations_ = 20;
+  multiresolution_convergence_threshold_ = 1e-3;
+  refinement_max_iterations_ = 10;
   trajectory_initialization_method_ = std::string("quintic-spline");
   enable_failure_recovery_ = false;
   max_recovery_attempts_ = 5;
@@ -60,6 +60,43 @@ namespace chomp
 {
 static const rclcpp::Logger LOGGER = rclcpp::get_logger("chomp_planner");
 
+/* Optimizes decimated copies of trajectory, coarsest level first, and upsamples each level's solution into the next
+ * finer one. trajectory receives the upsampled solution of the finest coarse level. Levels with too few segments for
+ * the finite differencing rules are skipped. */
+static bool optimizeCoarseLevels(const planning_scene::PlanningSceneConstPtr& planning_scene,
+                                 const std::string& group_name, const ChompParameters& params,
+                                 const moveit::core::RobotState& start_state, ChompTrajectory& trajectory)
+{
+  ChompParameters level_params = params;
+  level_params.max_iterations_ = params.multiresolution_max_iterations_;
+  level_params.convergence_threshold_ = params.multiresolution_convergence_threshold_;
+
+  size_t decimation = 1;
+  for (int level = 1; level < params.multiresolution_levels_; ++level)
+    decimation *= params.multiresolution_decimation_;
+
+  const size_t num_segments = trajectory.getNumPoints() - 1;
+  for (; decimation > 1; decimation /= params.multiresolution_decimation_)
+  {
+    const size_t level_segments = num_segments / decimation;
+    if (level_segments < static_cast<size_t>(DIFF_RULE_LENGTH))
+      continue;
+
+    ChompTrajectory level_trajectory(planning_scene->getRobotModel(), level_segments + 1,
+                                     trajectory.getDuration() / level_segments, group_name);
+    level_trajectory.fillInFromTrajectory(trajectory);
+
+    ChompOptimizer optimizer(&level_trajectory, planning_scene, group_name, &level_params, start_state);
+    if (!optimizer.isInitialized())
+      return false;
+    optimizer.optimize();
+
+    trajectory.fillInFromTrajectory(level_trajectory);
+    RCLCPP_DEBUG(LOGGER, "Optimized coarse level with %zu points", level_trajectory.getNumPoints());
+  }
+  return true;
+}
+
 bool ChompPlanner::solve(const planning_scene::PlanningSceneConstPtr& planning_scene,
                          const planning_interface::MotionPlanRequest& req, const ChompParameters& params,
                          planning_interface::MotionPlanDetailedResponse& res) const
@@ -178,6 +215,18 @@ bool ChompPlanner::solve(const planning_scene::PlanningSceneConstPtr& planning_s
   // create a non_const_params variable which stores the non constant version of the const params variable
   ChompParameters params_nonconst = params;
 
+  // solve on decimated trajectories first, so that the full resolution only needs a few refinement iterations
+  if (params.multiresolution_levels_ > 1 && params.multiresolution_decimation_ > 1)
+  {
+    if (!optimizeCoarseLevels(planning_scene, req.group_name, params, start_state, trajectory))
+    {
+      RCLCPP_ERROR(LOGGER, "Could not initialize optimizer");
+      res.error_code_.val = moveit_msgs::msg::MoveItErrorCodes::PLANNING_FAILED;
+      return false;
+    }
+    params_nonconst.max_iterations_ = params.refinement_max_iterations_;
+  }
+
   // while loop for replanning (recovery behaviour) if collision free optimized solution not found
   while (true)
   {
@@ -208,6 +208,21 @@ bool ChompTrajectory::fillInFromTrajectory(const robot_trajectory::RobotTrajecto
   return true;
 }
 
+void ChompTrajectory::fillInFromTrajectory(const ChompTrajectory& source)
+{
+  const size_t max_output_index = num_points_ - 1;
+  const size_t max_input_index = source.num_points_ - 1;
+  for (size_t i = 0; i <= max_output_index; ++i)
+  {
+    double fraction = static_cast<double>(i * max_input_index) / max_output_index;
+    const size_t prev_idx = std::trunc(fraction);  // integer part
+    fraction = fraction - prev_idx;                // fractional part
+    const size_t next_idx = prev_idx == max_input_index ? prev_idx : prev_idx + 1;
+    trajectory_.row(i) =
+        (1.0 - fraction) * source.trajectory_.row(prev_idx) + fraction * source.trajectory_.row(next_idx);
+  }
+}
+
 void ChompTrajectory::assignCHOMPTrajectoryPointFromRobotState(const moveit::core::RobotState& source,
                                                                size_t chomp_trajectory_point_index,
                                                                const moveit::core::JointModelGroup* group)
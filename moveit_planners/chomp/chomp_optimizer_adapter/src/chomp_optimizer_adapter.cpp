@@ -155,6 +155,43 @@ public:
       RCLCPP_DEBUG(LOGGER, "Param use_stochastic_descent was not set. Using default value: %d",
                    params_.use_stochastic_descent_);
     }
+    if (!node->get_parameter("chomp.convergence_threshold", params_.convergence_threshold_))
+    {
+      params_.convergence_threshold_ = 0.0;
+      RCLCPP_DEBUG(LOGGER, "Param convergence_threshold was not set. Using default value: %f",
+                   params_.convergence_threshold_);
+    }
+    if (!node->get_parameter("chomp.multiresolution_levels", params_.multiresolution_levels_))
+    {
+      params_.multiresolution_levels_ = 1;
+      RCLCPP_DEBUG(LOGGER, "Param multiresolution_levels was not set. Using default value: %d",
+                   params_.multiresolution_levels_);
+    }
+    if (!node->get_parameter("chomp.multiresolution_decimation", params_.multiresolution_decimation_))
+    {
+      params_.multiresolution_decimation_ = 2;
+      RCLCPP_DEBUG(LOGGER, "Param multiresolution_decimation was not set. Using default value: %d",
+                   params_.multiresolution_decimation_);
+    }
+    if (!node->get_parameter("chomp.multiresolution_max_iterations", params_.multiresolution_max_iterations_))
+    {
+      params_.multiresolution_max_iterations_ = 20;
+      RCLCPP_DEBUG(LOGGER, "Param multiresolution_max_iterations was not set. Using default value: %d",
+                   params_.multiresolution_max_iterations_);
+    }
+    if (!node->get_parameter("chomp.multiresolution_convergence_threshold",
+                             params_.multiresolution_convergence_threshold_))
+    {
+      params_.multiresolution_convergence_threshold_ = 1e-3;
+      RCLCPP_DEBUG(LOGGER, "Param multiresolution_convergence_threshold was not set. Using default value: %f",
+                   params_.multiresolution_convergence_threshold_);
+    }
+    if (!node->get_parameter("chomp.refinement_max_iterations", params_.refinement_max_iterations_))
+    {
+      params_.refinement_max_iterations_ = 10;
+      RCLCPP_DEBUG(LOGGER, "Param refinement_max_iterations was not set. Using default value: %d",
+                   params_.refinement_max_iterations_);
+    }
     params_.trajectory_initialization_method_ = "quintic-spline";
     std::string method;
     if (node->get_parameter("chomp.trajectory_initialization_method", method) &&
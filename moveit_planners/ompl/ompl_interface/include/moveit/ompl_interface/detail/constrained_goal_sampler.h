@@ -43,20 +43,38 @@
 #include <moveit/robot_state/robot_state.h>
 #include <moveit/robot_model/joint_model_group.h>
 
+#include <boost/lockfree/queue.hpp>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
 namespace ompl_interface
 {
 class ModelBasedPlanningContext;
 
 /** @class ConstrainedGoalSampler
- *  An interface to the OMPL goal lazy sampler*/
+ *  An interface to the OMPL goal lazy sampler
+ *
+ *  With the \e goal_sampling_threads planner parameter, additional threads sample goals with their own constraint
+ *  samplers and kinematics solvers while the planner runs. Their valid goals are handed to the goal through a
+ *  lock-free queue holding at most \e goal_sampling_queue_size states. */
 class ConstrainedGoalSampler : public ompl::base::GoalLazySamples
 {
 public:
   ConstrainedGoalSampler(const ModelBasedPlanningContext* pc, kinematic_constraints::KinematicConstraintSetPtr ks,
                          constraint_samplers::ConstraintSamplerPtr cs = constraint_samplers::ConstraintSamplerPtr());
+  ~ConstrainedGoalSampler() override;
 
 private:
   bool sampleUsingConstraintSampler(const ompl::base::GoalLazySamples* gls, ompl::base::State* new_goal);
+  bool sampleGoal(constraint_samplers::ConstraintSampler& sampler, moveit::core::RobotState& work_state,
+                  ompl::base::State* new_goal, unsigned int attempts_so_far, bool verbose);
+  bool keepSampling() const;
+  void startWorkers();
+  void stopWorkers();
+  void sampleInBackground(std::size_t index);
   bool stateValidityCallback(ompl::base::State* new_goal, moveit::core::RobotState const* state,
                              const moveit::core::JointModelGroup* /*jmg*/, const double* /*jpos*/,
                              bool verbose = false) const;
@@ -68,8 +86,17 @@ private:
   constraint_samplers::ConstraintSamplerPtr constraint_sampler_;
   ompl::base::StateSamplerPtr default_sampler_;
   moveit::core::RobotState work_state_;
-  unsigned int invalid_sampled_constraints_;
-  bool warned_invalid_samples_;
+  std::atomic<unsigned int> invalid_sampled_constraints_;
+  std::atomic<bool> warned_invalid_samples_;
   unsigned int verbose_display_;
+
+  /** \brief The constraint samplers of the background threads, each using its own kinematics solvers */
+  std::vector<constraint_samplers::ConstraintSamplerPtr> worker_samplers_;
+  std::vector<std::thread> workers_;
+  std::atomic<bool> stop_workers_;
+  std::atomic<std::size_t> active_workers_;
+  std::atomic<unsigned int> worker_attempts_;
+  std::atomic<unsigned int> queued_goals_;
+  std::unique_ptr<boost::lockfree::queue<ompl::base::State*>> goal_queue_;
 };
 }  // namespace ompl_interface
@@ -36,6 +36,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <map>
 #include <moveit/macros/class_forward.h>
 #include <moveit/ompl_interface/model_based_planning_context.h>
@@ -49,6 +50,87 @@ typedef std::pair<std::vector<std::size_t>, std::map<std::size_t, std::pair<std:
     ConstrainedStateMetadata;
 typedef ompl::base::StateStorageWithMetadata<ConstrainedStateMetadata> ConstraintApproximationStateStorage;
 
+MOVEIT_CLASS_FORWARD(MappedConstraintApproximationStorage);
+
+/** \brief Read-only view of the states and connections of a constraint approximation, stored in a flat binary file
+ *
+ * The file is mapped into memory, so processes loading the same file share its pages and nothing is deserialized at
+ * load time. Use store() to write a ConstraintApproximationStateStorage in this format. The layout (all integers in
+ * host byte order, sections aligned to 8 bytes) is:
+ *   - header: MAGIC, FORMAT_VERSION, serialized state size, and the number of states, connections and motions
+ *   - the signature of the state space
+ *   - per state, the offset of its first connection (one extra entry for the end), and the connected state indices
+ *   - per state, the offset of its first explicit motion (one extra entry for the end), and the motions as
+ *     (target index, first state, end state) triplets sorted by target index
+ *   - the states as serialized by ompl::base::StateSpace::serialize() */
+class MappedConstraintApproximationStorage
+{
+public:
+  static constexpr char MAGIC[8] = { 'M', 'V', 'I', 'T', 'C', 'A', 'P', 'X' };
+  static constexpr std::uint32_t FORMAT_VERSION = 1;
+
+  /** \brief Map \e filename for states of \e space. Throws std::runtime_error if the file cannot be mapped, or if it
+   * has a different format version or state space signature. */
+  MappedConstraintApproximationStorage(const std::string& filename, ompl::base::StateSpacePtr space);
+  ~MappedConstraintApproximationStorage();
+
+  MappedConstraintApproximationStorage(const MappedConstraintApproximationStorage&) = delete;
+  MappedConstraintApproximationStorage& operator=(const MappedConstraintApproximationStorage&) = delete;
+
+  /** \brief Write \e storage to \e filename in the mapped format. Returns false if the file cannot be written. */
+  static bool store(const std::string& filename, const ConstraintApproximationStateStorage& storage);
+
+  const ompl::base::StateSpacePtr& getStateSpace() const
+  {
+    return space_;
+  }
+
+  std::size_t size() const
+  {
+    return state_count_;
+  }
+
+  /** \brief Deserialize the state at \e index into \e state */
+  void getState(std::size_t index, ompl::base::State* state) const;
+
+  std::size_t getConnectionCount(std::size_t index) const
+  {
+    return connection_offsets_[index + 1] - connection_offsets_[index];
+  }
+
+  /** \brief The number of connections of all states */
+  std::size_t getConnectionCount() const
+  {
+    return connection_offsets_[state_count_];
+  }
+
+  std::size_t getConnection(std::size_t index, std::size_t k) const
+  {
+    return connections_[connection_offsets_[index] + k];
+  }
+
+  /** \brief Find the range of stored states on the explicit motion from state \e from to state \e to */
+  bool getMotion(std::size_t from, std::size_t to, std::pair<std::size_t, std::size_t>& range) const;
+
+  const std::string& getFilename() const
+  {
+    return filename_;
+  }
+
+private:
+  std::string filename_;
+  ompl::base::StateSpacePtr space_;
+  void* data_;
+  std::size_t data_size_;
+  std::size_t state_size_;
+  std::size_t state_count_;
+  const std::uint64_t* connection_offsets_;
+  const std::uint64_t* connections_;
+  const std::uint64_t* motion_offsets_;
+  const std::uint64_t* motions_;
+  const char* states_;
+};
+
 MOVEIT_CLASS_FORWARD(ConstraintApproximation);
 
 class ConstraintApproximation
@@ -58,6 +140,11 @@ public:
                           moveit_msgs::msg::Constraints msg, std::string filename, ompl::base::StateStoragePtr storage,
                           std::size_t milestones = 0);
 
+  /** \brief Construct an approximation whose states are read from a MappedConstraintApproximationStorage */
+  ConstraintApproximation(std::string group, std::string state_space_parameterization, bool explicit_motions,
+                          moveit_msgs::msg::Constraints msg, std::string filename,
+                          MappedConstraintApproximationStoragePtr storage, std::size_t milestones = 0);
+
   virtual ~ConstraintApproximation()
   {
   }
@@ -101,11 +188,18 @@ public:
     return constraint_msg_;
   }
 
+  /** \brief The states of the approximation, or nullptr if they are only available in a mapped storage */
   const ompl::base::StateStoragePtr& getStateStorage() const
   {
     return state_storage_ptr_;
   }
 
+  /** \brief The mapped states of the approximation, or nullptr if they are held in a state storage */
+  const MappedConstraintApproximationStoragePtr& getMappedStateStorage() const
+  {
+    return mapped_storage_;
+  }
+
   const std::string& getFilename() const
   {
     return ompldb_filename_;
@@ -123,6 +217,7 @@ protected:
   std::string ompldb_filename_;
   ompl::base::StateStoragePtr state_storage_ptr_;
   ConstraintApproximationStateStorage* state_storage_;
+  MappedConstraintApproximationStoragePtr mapped_storage_;
   std::size_t milestones_;
 };
 
@@ -135,6 +230,7 @@ struct ConstraintApproximationConstructionOptions
     , explicit_motions(false)
     , explicit_points_resolution(0.0)
     , max_explicit_points(0)
+    , thread_count(0)
   {
   }
 
@@ -145,6 +241,8 @@ struct ConstraintApproximationConstructionOptions
   bool explicit_motions;
   double explicit_points_resolution;
   unsigned int max_explicit_points;
+  /// number of threads sampling states and computing connections, 0 for the number of hardware threads
+  unsigned int thread_count;
 };
 
 struct ConstraintApproximationConstructionResults
@@ -165,9 +263,16 @@ public:
   {
   }
 
+  /** \brief Load the approximations listed in the manifest in \e path. Files ending in MAPPED_FILE_EXTENSION are
+   * mapped into memory, see MappedConstraintApproximationStorage. */
   void loadConstraintApproximations(const std::string& path);
 
-  void saveConstraintApproximations(const std::string& path);
+  /** \brief Save the approximations and their manifest to \e path. If \e mapped is true, the states are written in
+   * the format of MappedConstraintApproximationStorage instead of as ompl::base::StateStorage. */
+  void saveConstraintApproximations(const std::string& path, bool mapped = false);
+
+  /// file extension of approximations stored in the format of MappedConstraintApproximationStorage
+  static const std::string MAPPED_FILE_EXTENSION;
 
   ConstraintApproximationConstructionResults
   addConstraintApproximation(const moveit_msgs::msg::Constraints& constr_sampling,
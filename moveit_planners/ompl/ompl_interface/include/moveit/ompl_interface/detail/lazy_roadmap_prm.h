@@ -0,0 +1,131 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#pragma once
+
+#include <ompl/geometric/planners/prm/LazyPRM.h>
+#include <boost/range/iterator_range.hpp>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <vector>
+
+namespace ompl_interface
+{
+/** @class LazyRoadmapPRM
+ *  @brief LazyPRM that can reset the validity of part of its roadmap.
+ *
+ *  LazyPRM checks vertices and edges only when they are on a candidate path, and remembers which ones were found
+ *  valid across queries of a multi-query context. After the environment changed, clearValidity(...) forgets only
+ *  the parts of the roadmap that may be affected by the change. Invalid vertices and edges are removed from the
+ *  roadmap when they are found, so there is nothing to restore after obstacles were removed. */
+class LazyRoadmapPRM : public ompl::geometric::LazyPRM
+{
+public:
+  LazyRoadmapPRM(const ompl::base::SpaceInformationPtr& si, bool star_strategy = false);
+
+  /** @brief Constructor for a roadmap loaded with ompl::base::PlannerDataStorage */
+  LazyRoadmapPRM(const ompl::base::PlannerData& data, bool star_strategy = false);
+
+  /** @brief The planning scene the validity information of the roadmap refers to */
+  struct ValidatedEnvironment
+  {
+    std::uint64_t world_version;
+    std::uint64_t acm_version;
+    std::uint64_t transforms_version;
+    std::uint64_t attached_bodies_version;
+    /// the positions of the variables that are not planned for
+    std::vector<double> fixed_positions;
+    /// the shapes of the bodies attached to the start state, compared by address
+    std::vector<const void*> attached_shapes;
+  };
+
+  /** @brief Get the environment the roadmap was last validated in, if it is known */
+  const std::optional<ValidatedEnvironment>& getValidatedEnvironment() const
+  {
+    return validated_environment_;
+  }
+
+  /** @brief Set the environment the validity information of the roadmap refers to from now on */
+  void setValidatedEnvironment(std::optional<ValidatedEnvironment> environment)
+  {
+    validated_environment_ = std::move(environment);
+  }
+
+  void clear() override;
+
+  using ompl::geometric::LazyPRM::clearValidity;
+
+  /** @brief Reset the validity of the vertices and edges affected by a change of the environment.
+   *  @param vertex_data Computes the data needed to decide whether a state is affected, at most once per vertex
+   *  @param vertex_affected Decides whether a vertex is affected, given the data of its state
+   *  @param edge_affected Decides whether an edge is affected, given the data of its end states
+   *
+   *  Only vertices and edges that were found valid before are considered. */
+  template <typename VertexDataFn, typename VertexFn, typename EdgeFn>
+  void clearValidity(const VertexDataFn& vertex_data, const VertexFn& vertex_affected, const EdgeFn& edge_affected)
+  {
+    using Data = decltype(vertex_data(static_cast<const ompl::base::State*>(nullptr)));
+    std::map<Vertex, Data> data;
+    const auto get_data = [&](Vertex v) -> const Data& {
+      auto it = data.find(v);
+      if (it == data.end())
+        it = data.emplace(v, vertex_data(stateProperty_[v])).first;
+      return it->second;
+    };
+
+    for (Vertex v : boost::make_iterator_range(boost::vertices(g_)))
+      if (vertexValidityProperty_[v] != VALIDITY_UNKNOWN && vertex_affected(get_data(v)))
+        vertexValidityProperty_[v] = VALIDITY_UNKNOWN;
+    for (Edge e : boost::make_iterator_range(boost::edges(g_)))
+      if (edgeValidityProperty_[e] != VALIDITY_UNKNOWN &&
+          edge_affected(get_data(boost::source(e, g_)), get_data(boost::target(e, g_))))
+        edgeValidityProperty_[e] = VALIDITY_UNKNOWN;
+  }
+
+private:
+  std::optional<ValidatedEnvironment> validated_environment_;
+};
+
+/** @class LazyRoadmapPRMstar
+ *  @brief LazyPRMstar that can reset the validity of part of its roadmap, see LazyRoadmapPRM */
+class LazyRoadmapPRMstar : public LazyRoadmapPRM
+{
+public:
+  LazyRoadmapPRMstar(const ompl::base::SpaceInformationPtr& si);
+
+  /** @brief Constructor for a roadmap loaded with ompl::base::PlannerDataStorage */
+  LazyRoadmapPRMstar(const ompl::base::PlannerData& data);
+};
+}  // namespace ompl_interface
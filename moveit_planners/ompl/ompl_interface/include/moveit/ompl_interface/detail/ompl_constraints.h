@@ -148,9 +148,8 @@ public:
 
   /** \brief Wrapper for forward kinematics calculated by MoveIt's Robot State.
    *
-   * TODO(jeroendm) Are these actually const, as the robot state is modified? How come it works?
-   * Also, output arguments could be significantly more performant,
-   * but MoveIt's robot state does not support passing Eigen::Ref objects at the moment.
+   * Only the robot state of the calling thread is modified, which is why this can be const. Output arguments could be
+   * more performant, but MoveIt's robot state does not support passing Eigen::Ref objects at the moment.
    * */
   Eigen::Isometry3d forwardKinematics(const Eigen::Ref<const Eigen::VectorXd>& joint_values) const;
 
@@ -219,6 +218,18 @@ protected:
   TSStateStorage state_storage_;
   const moveit::core::JointModelGroup* joint_model_group_;
 
+  /** \brief Get the robot state of the calling thread, set to \e joint_values.
+   *
+   * The joint values are only written, and the link transforms recomputed, when they differ from the ones already in
+   * the state. OMPL's projection evaluates the function and the Jacobian at the same joint values in every Newton step,
+   * and the error and error Jacobian are computed from the same values as well, so this saves most of the forward
+   * kinematics.
+   * */
+  moveit::core::RobotState* getUpdatedState(const Eigen::Ref<const Eigen::VectorXd>& joint_values) const;
+
+  /** \brief Robot link model the constraints are applied to, looked up from link_name_ in init(). */
+  const moveit::core::LinkModel* link_model_;
+
   // all attributes below can be considered const as soon as the constraint message is parsed
   // but I (jeroendm) do not know how to elegantly express this in C++
   // parsing the constraints message and passing all this data members separately to the constructor
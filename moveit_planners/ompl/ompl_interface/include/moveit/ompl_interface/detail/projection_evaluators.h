@@ -50,9 +50,11 @@ typedef ompl::base::EuclideanProjection& OMPLProjection;
 namespace ompl_interface
 {
 class ModelBasedPlanningContext;
+class StateValidityChecker;
 
 /** @class ProjectionEvaluatorLinkPose
-    @brief */
+    @brief Projects states onto the position of a link. If the state was just checked for validity by the same thread,
+    the link transform computed by the validity checker is reused instead of running forward kinematics again. */
 class ProjectionEvaluatorLinkPose : public ompl::base::ProjectionEvaluator
 {
 public:
@@ -66,6 +68,7 @@ private:
   const ModelBasedPlanningContext* planning_context_;
   const moveit::core::LinkModel* link_;
   TSStateStorage tss_;
+  std::shared_ptr<const StateValidityChecker> validity_checker_;
 };
 
 /** @class ProjectionEvaluatorJointValue
@@ -82,4 +85,27 @@ public:
 private:
   std::vector<unsigned int> variables_;
 };
+
+/** @class ProjectionEvaluatorPCA
+    @brief Projects states onto the principal components of a set of sample states, such as the waypoints of past
+    solutions. This follows the directions the solutions actually move along, e.g. through a narrow passage. */
+class ProjectionEvaluatorPCA : public ompl::base::ProjectionEvaluator
+{
+public:
+  ProjectionEvaluatorPCA(const ModelBasedPlanningContext* pc, const std::vector<Eigen::VectorXd>& samples,
+                         unsigned int dimension);
+
+  unsigned int getDimension() const override;
+  void project(const ompl::base::State* state, OMPLProjection projection) const override;
+
+  /** \brief Read sample states from \e path: one line of whitespace separated group variable values per state.
+      Lines with a different number of values than \e variable_count are skipped. Return false if no sample was read. */
+  static bool loadSamples(const std::string& path, std::size_t variable_count, std::vector<Eigen::VectorXd>& samples);
+
+private:
+  Eigen::VectorXd mean_;
+
+  /** \brief The principal components, as columns ordered by decreasing variance */
+  Eigen::MatrixXd basis_;
+};
 }  // namespace ompl_interface
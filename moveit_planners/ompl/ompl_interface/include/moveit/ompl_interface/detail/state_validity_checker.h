@@ -34,12 +34,12 @@
 
 /* Author: Ioan Sucan, Jeroen De Maeyer  */
 
-/** A state validity checker checks:
+/** A state validity checker checks, cheapest first:
  *
  * - Bounds (joint limits).
- * - Collision.
  * - Kinematic path constraints.
  * - Generic user-specified feasibility using the `isStateFeasible` of the planning scene.
+ * - Collision.
  *
  * IMPORTANT: Although the isValid method takes the state as `const ompl::base::State* state`,
  * it uses const_cast to modify the validity of the state with `markInvalid` and `markValid` for caching.
@@ -48,7 +48,10 @@
 #pragma once
 
 #include <moveit/ompl_interface/detail/threadsafe_state_storage.h>
+#include <moveit/ompl_interface/parameterization/model_based_state_space.h>
 #include <moveit/collision_detection/collision_common.h>
+#include <moveit/collision_detection/collision_result_cache.h>
+#include <ompl/base/MotionValidator.h>
 #include <ompl/base/StateValidityChecker.h>
 
 namespace ompl_interface
@@ -86,7 +89,21 @@ public:
 
   void setVerbose(bool flag);
 
+  /** \brief The robot state the calling thread last used to check \e state, with up-to-date link transforms, or nullptr
+      if that thread has checked a different state since */
+  const moveit::core::RobotState* getCachedRobotState(const ompl::base::State* state) const;
+
 protected:
+  /** \brief Check bounds, path constraints and feasibility of \e state and leave it in \e robot_state.
+
+      \e cache is the state the results are remembered on. On failure, \e dist is set to the distance reported by the
+      failing check. Success is remembered, so a later full check of the same state only checks collisions. */
+  bool checkConstraints(const ompl::base::State* state, ModelBasedStateSpace::StateType* cache,
+                        moveit::core::RobotState& robot_state, double& dist, bool verbose) const;
+
+  /** \brief Simple collision check of \e robot_state, using the collision result cache if enabled */
+  bool checkCollision(const moveit::core::RobotState& robot_state, bool verbose) const;
+
   const ModelBasedPlanningContext* planning_context_;
   std::string group_name_;
   TSStateStorage tss_;
@@ -96,6 +113,9 @@ protected:
   collision_detection::CollisionRequest collision_request_with_distance_verbose_;
 
   collision_detection::CollisionRequest collision_request_with_cost_;
+
+  /** \brief Results of simple collision checks, if enabled with the \e collision_cache_size planner parameter */
+  collision_detection::CollisionResultCachePtr collision_cache_;
   bool verbose_;
 };
 
@@ -154,4 +174,53 @@ public:
   bool isValid(const ompl::base::State* wrapped_state, bool verbose) const override;
   bool isValid(const ompl::base::State* wrapped_state, double& dist, bool verbose) const override;
 };
+
+/** \brief A StateValidityChecker for lazy planners such as LazyPRM or LBKPIECE1, enabled with the
+ * \e lazy_collision_checking planner parameter.
+ *
+ * isValid() only performs the checks that do not need the collision checker and reports states passing them as
+ * valid, without caching that outcome. Collision checks are deferred to LazyCollisionMotionValidator, which calls
+ * isFullyValid() when the planner evaluates an edge, so roadmap vertices that never end up on a candidate path are
+ * never collision checked. The distance variant of isValid() always performs the full check.
+ **/
+class LazyCollisionStateValidityChecker : public StateValidityChecker
+{
+public:
+  using StateValidityChecker::isValid;
+
+  LazyCollisionStateValidityChecker(const ModelBasedPlanningContext* planning_context)
+    : StateValidityChecker(planning_context)
+  {
+  }
+
+  bool isValid(const ompl::base::State* state, bool verbose) const override;
+
+  /** \brief Check all conditions, including collisions */
+  bool isFullyValid(const ompl::base::State* state, bool verbose = false) const
+  {
+    return StateValidityChecker::isValid(state, verbose);
+  }
+};
+
+/** \brief Discrete motion validator that performs the collision checks deferred by a
+ * LazyCollisionStateValidityChecker.
+ *
+ * Like ompl::base::DiscreteMotionValidator, the start of a motion is assumed to be valid and the end as well as the
+ * interpolated states are checked. */
+class LazyCollisionMotionValidator : public ompl::base::MotionValidator
+{
+public:
+  LazyCollisionMotionValidator(const ompl::base::SpaceInformationPtr& si,
+                               std::shared_ptr<const LazyCollisionStateValidityChecker> checker)
+    : ompl::base::MotionValidator(si), checker_(std::move(checker))
+  {
+  }
+
+  bool checkMotion(const ompl::base::State* s1, const ompl::base::State* s2) const override;
+  bool checkMotion(const ompl::base::State* s1, const ompl::base::State* s2,
+                   std::pair<ompl::base::State*, double>& last_valid) const override;
+
+private:
+  std::shared_ptr<const LazyCollisionStateValidityChecker> checker_;
+};
 }  // namespace ompl_interface
@@ -40,10 +40,12 @@
 #include <moveit/ompl_interface/detail/constrained_valid_state_sampler.h>
 #include <moveit/constraint_samplers/constraint_sampler_manager.h>
 #include <moveit/planning_interface/planning_interface.h>
+#include <moveit/robot_state/robot_state_pool.h>
 
 #include <ompl/geometric/SimpleSetup.h>
 #include <ompl/tools/benchmark/Benchmark.h>
 #include <ompl/tools/multiplan/ParallelPlan.h>
+#include <ompl/tools/experience/ExperienceSetup.h>
 #include <ompl/base/StateStorage.h>
 #include <ompl/base/spaces/constraint/ConstrainedStateSpace.h>
 
@@ -83,6 +85,11 @@ struct ModelBasedPlanningContextSpecification
    * ConstrainedSpaceInformation object from it).
    * */
   ob::ConstrainedStateSpacePtr constrained_state_space_;
+
+  /** \brief Names and settings of the planner configurations listed by the "portfolio" attribute of config_.
+   *
+   * The planners of these configurations race each other on the problem, see ModelBasedPlanningContext::solve(). */
+  std::vector<std::pair<std::string, std::map<std::string, std::string>>> portfolio_;
 };
 
 class ModelBasedPlanningContext : public planning_interface::PlanningContext
@@ -236,6 +243,16 @@ public:
     return spec_.constraint_sampler_manager_;
   }
 
+  const constraint_samplers::ConstraintSamplerManagerPtr& getConstraintSamplerManager() const
+  {
+    return spec_.constraint_sampler_manager_;
+  }
+
+  /** \brief Get the kinematics solver instance used by the goal sampling thread \e index for group \e jmg.
+      Solvers are allocated on first use and kept for later planning requests; nullptr if \e jmg has no solver. */
+  kinematics::KinematicsBaseConstPtr getGoalSamplingSolver(const moveit::core::JointModelGroup* jmg,
+                                                           std::size_t index) const;
+
   void setConstraintSamplerManager(const constraint_samplers::ConstraintSamplerManagerPtr& csm)
   {
     spec_.constraint_sampler_manager_ = csm;
@@ -293,6 +310,10 @@ public:
   /* @brief Solve the planning problem. Return true if the problem is solved
      @param timeout The time to spend on solving
      @param count The number of runs to combine the paths of, in an attempt to generate better quality paths
+
+     If the configuration lists a portfolio of planner configurations, one planner of each runs concurrently instead
+     and \e count is ignored. The first exact solution stops all of them, unless "portfolio_best_solution" is set: then
+     the planners run until each found a solution or the time is up, and the best solution is returned.
   */
   bool solve(double timeout, unsigned int count);
 
@@ -317,11 +338,15 @@ public:
   }
 
   /* @brief Apply smoothing and try to simplify the plan
-     @param timeout The amount of time allowed to be spent on simplifying the plan*/
+     @param timeout The amount of time allowed to be spent on simplifying the plan
+
+     If "simplification_count" is larger than one and several solutions were found, up to that many of the best
+     solutions are simplified concurrently and the shortest result replaces the solution path. */
   void simplifySolution(double timeout);
 
-  /* @brief Interpolate the solution*/
-  void interpolateSolution();
+  /* @brief Interpolate the solution. Return false if "verify_interpolation" is set and an interpolated state is
+     invalid; the states are checked concurrently. */
+  bool interpolateSolution();
 
   /* @brief Get the solution as a RobotTrajectory object*/
   bool getSolutionPath(robot_trajectory::RobotTrajectory& traj) const;
@@ -349,6 +374,18 @@ protected:
   void preSolve();
   void postSolve();
 
+  /* @brief Simplify several of the best solutions concurrently and keep the shortest one as solution path */
+  void simplifySolutionsInParallel(std::vector<og::PathGeometric> paths, const ob::PlannerTerminationCondition& ptc);
+
+  /* @brief Check the validity of all states of \e path concurrently */
+  bool verifySolutionStates(const og::PathGeometric& path) const;
+
+  /** \brief Reset the validity information of a multi-query roadmap that may be outdated in the current planning scene
+   *
+   * Roadmaps of LazyRoadmapPRM planners remember the environment they were validated in. If only world objects changed
+   * since then, only the vertices and edges whose bounding boxes intersect the changed objects are reset. */
+  void updateRoadmapValidity();
+
   void startSampling();
   void stopSampling();
 
@@ -390,11 +427,22 @@ protected:
 
   ModelBasedPlanningContextSpecification spec_;
 
+  /// memory for the states created by this context (and copies thereof), recycled across planning requests
+  moveit::core::RobotStatePoolPtr robot_state_pool_;
+
   moveit::core::RobotState complete_initial_robot_state_;
 
   /// the OMPL planning context; this contains the problem definition and the planner used
   og::SimpleSetupPtr ompl_simple_setup_;
 
+  /// the experience-based (Thunder or Lightning) view of ompl_simple_setup_, if the configuration uses experience
+  ot::ExperienceSetupPtr experience_setup_;
+
+  /// kinematics solvers of the goal sampling threads, as the solver instance of a group is not thread-safe
+  mutable std::map<const moveit::core::JointModelGroup*, std::vector<kinematics::KinematicsBaseConstPtr>>
+      goal_sampling_solvers_;
+  mutable std::mutex goal_sampling_solvers_lock_;
+
   /// the OMPL tool for benchmarking planners
   ot::Benchmark ompl_benchmark_;
 
@@ -441,14 +489,29 @@ protected:
   /// when false, clears planners before running solve()
   bool multi_query_planning_enabled_;
 
+  /// padding added to the bounding boxes of roadmap edges when deciding whether changed world objects affect them
+  double roadmap_edge_padding_;
+
   ConstraintsLibraryPtr constraints_library_;
 
   bool simplify_solutions_;
 
+  /// the number of best solutions that are simplified concurrently, keeping the shortest result
+  unsigned int simplification_count_;
+
   // if false the final solution is not interpolated
   bool interpolate_;
 
+  // if true the states of the interpolated solution are validated again
+  bool verify_interpolation_;
+
   // if false parallel plan returns the first solution found
   bool hybridize_;
+
+  // allocators for the planners of the portfolio configurations, empty unless the configuration lists a portfolio
+  std::vector<ob::PlannerAllocator> portfolio_allocators_;
+
+  // if true the portfolio planners run until each found a solution, instead of stopping at the first one
+  bool portfolio_best_solution_;
 };
 }  // namespace ompl_interface
@@ -83,7 +83,8 @@ public:
       GOAL_DISTANCE_KNOWN = 2,
       VALIDITY_TRUE = 4,
       IS_START_STATE = 8,
-      IS_GOAL_STATE = 16
+      IS_GOAL_STATE = 16,
+      CONSTRAINTS_SATISFIED = 32
     };
 
     StateType() : ompl::base::State(), values(nullptr), tag(-1), flags(0), distance(0.0)
@@ -130,6 +131,17 @@ public:
       return flags & VALIDITY_TRUE;
     }
 
+    /** \brief Remember that bounds, path constraints and feasibility hold; only collisions remain to be checked */
+    void markConstraintsSatisfied()
+    {
+      flags |= CONSTRAINTS_SATISFIED;
+    }
+
+    bool areConstraintsSatisfied() const
+    {
+      return flags & CONSTRAINTS_SATISFIED;
+    }
+
     bool isGoalDistanceKnown() const
     {
       return flags & GOAL_DISTANCE_KNOWN;
@@ -264,6 +276,9 @@ protected:
   unsigned int variable_count_;
   size_t state_values_size_;
 
+  /// distance factor of each variable if the group only has bounded revolute or prismatic joints, empty otherwise
+  std::vector<double> linear_distance_factors_;
+
   InterpolationFunction interpolation_function_;
   DistanceFunction distance_function_;
 
@@ -76,6 +76,20 @@ private:
   ob::PlannerDataStorage storage_;
 };
 
+/** \brief Statistics about the creation of contexts, see PlanningContextManager::getPlanningContextStatistics() */
+struct PlanningContextStatistics
+{
+  /// number of planning contexts created, including the ones created to fill the pools
+  std::size_t created_count = 0;
+  /// number of requests served by an idle pooled context
+  std::size_t reused_count = 0;
+  /// number of requests that had to create a context, because no pooled context was idle
+  std::size_t cold_count = 0;
+  /// total and maximum time spent creating contexts, in seconds
+  double total_creation_time = 0.0;
+  double max_creation_time = 0.0;
+};
+
 class PlanningContextManager
 {
 public:
@@ -84,7 +98,9 @@ public:
   ~PlanningContextManager();
 
   /** @brief Specify configurations for the planners.
-      @param pconfig Configurations for the different planners */
+      @param pconfig Configurations for the different planners
+
+      The context pools of the configurations are filled, see setContextPoolSize(). */
   void setPlannerConfigurations(const planning_interface::PlannerConfigurationMap& pconfig);
 
   /** @brief Return the previously set planner configurations */
@@ -153,6 +169,28 @@ public:
     max_solution_segment_length_ = mssl;
   }
 
+  /* \brief Get the default number of planning contexts kept per planner configuration and state space */
+  std::size_t getContextPoolSize() const
+  {
+    return context_pool_size_;
+  }
+
+  /* \brief Set the default number of planning contexts kept per planner configuration and state space
+   *
+   * Configurations may override it with their "context_pool_size" parameter. The pools are filled by
+   * setPlannerConfigurations() and fillContextPools(), so requests find an idle context instead of creating one.
+   * Contexts created while all pooled ones are in use are not kept. A size of 0 keeps every context created. */
+  void setContextPoolSize(std::size_t context_pool_size)
+  {
+    context_pool_size_ = context_pool_size;
+  }
+
+  /** \brief Create planning contexts until the pools of all planner configurations have their configured size */
+  void fillContextPools();
+
+  /** \brief Get statistics about the creation of planning contexts */
+  PlanningContextStatistics getPlanningContextStatistics() const;
+
   unsigned int getMinimumWaypointCount() const
   {
     return minimum_waypoint_count_;
@@ -220,6 +258,18 @@ protected:
                                                   const ModelBasedStateSpaceFactoryPtr& factory,
                                                   const moveit_msgs::msg::MotionPlanRequest& req) const;
 
+  /** \brief Construct a new planning context, and record the time it took */
+  ModelBasedPlanningContextPtr createPlanningContext(const planning_interface::PlannerConfigurationSettings& config,
+                                                     const ModelBasedStateSpaceFactoryPtr& factory,
+                                                     const moveit_msgs::msg::MotionPlanRequest& req) const;
+
+  /** \brief Select the state space factory for solving \e req with the planner configuration \e config */
+  ModelBasedStateSpaceFactoryPtr selectStateSpaceFactory(const planning_interface::PlannerConfigurationSettings& config,
+                                                         const moveit_msgs::msg::MotionPlanRequest& req) const;
+
+  /** \brief The number of contexts to keep for \e config, see setContextPoolSize() */
+  std::size_t getContextPoolSize(const planning_interface::PlannerConfigurationSettings& config) const;
+
   const ModelBasedStateSpaceFactoryPtr& getStateSpaceFactory(const std::string& factory_type) const;
   const ModelBasedStateSpaceFactoryPtr& getStateSpaceFactory(const std::string& group_name,
                                                              const moveit_msgs::msg::MotionPlanRequest& req) const;
@@ -260,6 +310,9 @@ protected:
   /// needed)
   unsigned int minimum_waypoint_count_;
 
+  /// default number of planning contexts kept per planner configuration and state space, 0 for no limit
+  std::size_t context_pool_size_;
+
   /// Multi-query planner allocator
   MultiQueryPlannerAllocator planner_allocator_;
 
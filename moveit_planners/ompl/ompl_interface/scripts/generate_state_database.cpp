@@ -55,7 +55,7 @@ static const std::string ROBOT_DESCRIPTION = "robot_description";
 static const std::string CONSTRAINT_PARAMETER = "constraints";
 
 static bool get_uint_parameter_or(const rclcpp::Node::SharedPtr& node, const std::string& param_name,
-                                  size_t&& result_value, const size_t default_value)
+                                  unsigned int& result_value, const unsigned int default_value)
 {
   int param_value;
   if (node->get_parameter(param_name, param_value))
@@ -101,6 +101,12 @@ struct GenerateStateDatabaseParameters
 
     node->get_parameter_or("output_folder", output_folder, std::string("constraint_approximation_database"));
 
+    // store the database in the format that is mapped into memory when loading
+    node->get_parameter_or("mapped_format", mapped_format, false);
+
+    // threads sampling states and computing connections, 0 for one per core
+    get_uint_parameter_or(node, "thread_count", construction_opts.thread_count, 0);
+
     if (!node->get_parameter("planning_group", planning_group))
     {
       RCLCPP_FATAL(LOGGER, "~planning_group parameter has to be specified.");
@@ -125,6 +131,9 @@ struct GenerateStateDatabaseParameters
   // path to folder for generated database
   std::string output_folder;
 
+  // write the database in the mapped format
+  bool mapped_format;
+
   // request the current scene via get_planning_scene service
   bool use_current_scene;
 
@@ -163,7 +172,7 @@ void computeDB(const rclcpp::Node::SharedPtr& node, const planning_scene::Planni
     RCLCPP_FATAL(LOGGER, "Failed to generate approximation.");
     return;
   }
-  context->getConstraintsLibraryNonConst()->saveConstraintApproximations(params.output_folder);
+  context->getConstraintsLibraryNonConst()->saveConstraintApproximations(params.output_folder, params.mapped_format);
   RCLCPP_INFO_STREAM(LOGGER, "Successfully generated Joint Space Constraint Approximation Database for constraint:\n"
                                  << params.constraints.name);
   RCLCPP_INFO_STREAM(LOGGER, "The database has been saved in your local folder '" << params.output_folder << "'");
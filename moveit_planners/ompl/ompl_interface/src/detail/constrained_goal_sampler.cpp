@@ -37,12 +37,41 @@
 #include <moveit/ompl_interface/detail/constrained_goal_sampler.h>
 #include <moveit/ompl_interface/model_based_planning_context.h>
 #include <moveit/ompl_interface/detail/state_validity_checker.h>
+#include <moveit/constraint_samplers/default_constraint_samplers.h>
+#include <moveit/constraint_samplers/reservoir_constraint_sampler.h>
+#include <moveit/constraint_samplers/union_constraint_sampler.h>
 
+#include <chrono>
 #include <utility>
 
 namespace ompl_interface
 {
 static const rclcpp::Logger LOGGER = rclcpp::get_logger("moveit.ompl_planning.constrained_goal_sampler");
+
+/// default capacity of the queue between the background goal sampling threads and the goal
+static const std::size_t DEFAULT_GOAL_SAMPLING_QUEUE_SIZE = 16;
+
+// Give the IK samplers in \e sampler the solvers of background thread \e index. Samplers of unknown type may use the
+// shared solver instance of their group internally, so they cannot be used concurrently.
+static bool useOwnSolvers(const constraint_samplers::ConstraintSamplerPtr& sampler, const ModelBasedPlanningContext* pc,
+                          std::size_t index)
+{
+  if (auto ik_sampler = std::dynamic_pointer_cast<constraint_samplers::IKConstraintSampler>(sampler))
+  {
+    kinematics::KinematicsBaseConstPtr solver = pc->getGoalSamplingSolver(ik_sampler->getJointModelGroup(), index);
+    return solver && ik_sampler->setKinematicsSolver(solver);
+  }
+  if (auto reservoir_sampler = std::dynamic_pointer_cast<constraint_samplers::ReservoirConstraintSampler>(sampler))
+    return useOwnSolvers(reservoir_sampler->getSampler(), pc, index);
+  if (auto union_sampler = std::dynamic_pointer_cast<constraint_samplers::UnionConstraintSampler>(sampler))
+  {
+    for (const constraint_samplers::ConstraintSamplerPtr& member : union_sampler->getSamplers())
+      if (!useOwnSolvers(member, pc, index))
+        return false;
+    return true;
+  }
+  return std::dynamic_pointer_cast<constraint_samplers::JointConstraintSampler>(sampler) != nullptr;
+}
 }  // namespace ompl_interface
 
 ompl_interface::ConstrainedGoalSampler::ConstrainedGoalSampler(const ModelBasedPlanningContext* pc,
@@ -61,13 +90,102 @@ ompl_interface::ConstrainedGoalSampler::ConstrainedGoalSampler(const ModelBasedP
   , invalid_sampled_constraints_(0)
   , warned_invalid_samples_(false)
   , verbose_display_(0)
+  , stop_workers_(false)
+  , active_workers_(0)
+  , worker_attempts_(0)
+  , queued_goals_(0)
 {
   if (!constraint_sampler_)
     default_sampler_ = si_->allocStateSampler();
+
+  // optionally sample goals in background threads, each with its own constraint sampler
+  const std::map<std::string, std::string>& config = pc->getSpecificationConfig();
+  auto it = config.find("goal_sampling_threads");
+  const std::size_t thread_count = it != config.end() ? std::stoul(it->second) : 0;
+  if (constraint_sampler_ && thread_count > 0 && pc->getConstraintSamplerManager())
+  {
+    for (std::size_t i = 0; i < thread_count; ++i)
+    {
+      constraint_samplers::ConstraintSamplerPtr sampler = pc->getConstraintSamplerManager()->selectSampler(
+          pc->getPlanningScene(), pc->getGroupName(), kinematic_constraint_set_->getAllConstraints());
+      if (!sampler || !useOwnSolvers(sampler, pc, i))
+      {
+        RCLCPP_WARN(LOGGER, "The goal constraints cannot be sampled concurrently, sampling goals in a single thread");
+        worker_samplers_.clear();
+        break;
+      }
+      worker_samplers_.push_back(sampler);
+    }
+  }
+  if (!worker_samplers_.empty())
+  {
+    it = config.find("goal_sampling_queue_size");
+    const std::size_t queue_size = it != config.end() ? std::stoul(it->second) : DEFAULT_GOAL_SAMPLING_QUEUE_SIZE;
+    goal_queue_ = std::make_unique<boost::lockfree::queue<ob::State*>>(std::max<std::size_t>(queue_size, 1));
+  }
+
   RCLCPP_DEBUG(LOGGER, "Constructed a ConstrainedGoalSampler instance at address %p", this);
   startSampling();
 }
 
+ompl_interface::ConstrainedGoalSampler::~ConstrainedGoalSampler()
+{
+  // the sampling thread has to stop first, as it restarts the background threads
+  stopSampling();
+  stopWorkers();
+  if (goal_queue_)
+  {
+    goal_queue_->consume_all([this](ob::State* state) { si_->freeState(state); });
+  }
+}
+
+void ompl_interface::ConstrainedGoalSampler::startWorkers()
+{
+  stopWorkers();
+  stop_workers_ = false;
+  active_workers_ = worker_samplers_.size();
+  for (std::size_t i = 0; i < worker_samplers_.size(); ++i)
+    workers_.emplace_back([this, i] { sampleInBackground(i); });
+}
+
+void ompl_interface::ConstrainedGoalSampler::stopWorkers()
+{
+  stop_workers_ = true;
+  for (std::thread& worker : workers_)
+    worker.join();
+  workers_.clear();
+}
+
+bool ompl_interface::ConstrainedGoalSampler::keepSampling() const
+{
+  return samplingAttemptsCount() + worker_attempts_ < planning_context_->getMaximumGoalSamplingAttempts() &&
+         getStateCount() + queued_goals_ < planning_context_->getMaximumGoalSamples() &&
+         !planning_context_->getOMPLSimpleSetup()->getProblemDefinition()->hasSolution();
+}
+
+void ompl_interface::ConstrainedGoalSampler::sampleInBackground(std::size_t index)
+{
+  moveit::core::RobotState work_state(planning_context_->getCompleteInitialRobotState());
+  ob::State* goal = si_->allocState();
+  while (!stop_workers_ && isSampling() && keepSampling())
+  {
+    if (!sampleGoal(*worker_samplers_[index], work_state, goal, worker_attempts_++, false))
+      continue;
+
+    // wait for the goal to consume queued states
+    bool queued = false;
+    while (!(queued = goal_queue_->bounded_push(goal)) && !stop_workers_ && isSampling())
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    if (queued)
+    {
+      ++queued_goals_;
+      goal = si_->allocState();
+    }
+  }
+  si_->freeState(goal);
+  --active_workers_;
+}
+
 bool ompl_interface::ConstrainedGoalSampler::checkStateValidity(ob::State* new_goal,
                                                                 const moveit::core::RobotState& state,
                                                                 bool verbose) const
@@ -88,6 +206,42 @@ bool ompl_interface::ConstrainedGoalSampler::stateValidityCallback(ob::State* ne
   return checkStateValidity(new_goal, solution_state, verbose);
 }
 
+bool ompl_interface::ConstrainedGoalSampler::sampleGoal(constraint_samplers::ConstraintSampler& sampler,
+                                                        moveit::core::RobotState& work_state, ob::State* new_goal,
+                                                        unsigned int attempts_so_far, bool verbose)
+{
+  // makes the constraint sampler also perform a validity callback
+  moveit::core::GroupStateValidityCallbackFn gsvcf = [this, new_goal,
+                                                      verbose](moveit::core::RobotState* robot_state,
+                                                               const moveit::core::JointModelGroup* joint_group,
+                                                               const double* joint_group_variable_values) {
+    return stateValidityCallback(new_goal, robot_state, joint_group, joint_group_variable_values, verbose);
+  };
+  sampler.setGroupStateValidityCallback(gsvcf);
+
+  if (sampler.sample(work_state, planning_context_->getMaximumStateSamplingAttempts()))
+  {
+    work_state.update();
+    if (kinematic_constraint_set_->decide(work_state, verbose).satisfied)
+    {
+      if (checkStateValidity(new_goal, work_state, verbose))
+        return true;
+    }
+    else
+    {
+      invalid_sampled_constraints_++;
+      if (!warned_invalid_samples_ && invalid_sampled_constraints_ >= (attempts_so_far * 8) / 10)
+      {
+        warned_invalid_samples_ = true;
+        RCLCPP_WARN(LOGGER, "More than 80%% of the sampled goal states "
+                            "fail to satisfy the constraints imposed on the goal sampler. "
+                            "Is the constrained sampler working correctly?");
+      }
+    }
+  }
+  return false;
+}
+
 bool ompl_interface::ConstrainedGoalSampler::sampleUsingConstraintSampler(const ob::GoalLazySamples* gls,
                                                                           ob::State* new_goal)
 {
@@ -106,9 +260,25 @@ bool ompl_interface::ConstrainedGoalSampler::sampleUsingConstraintSampler(const
   if (planning_context_->getOMPLSimpleSetup()->getProblemDefinition()->hasSolution())
     return false;
 
+  // goals found by the background threads are handed out first
+  const auto pop_queued_goal = [this, new_goal] {
+    ob::State* queued = nullptr;
+    if (!goal_queue_ || !goal_queue_->pop(queued))
+      return false;
+    --queued_goals_;
+    si_->copyState(new_goal, queued);
+    si_->freeState(queued);
+    return true;
+  };
+  if (!worker_samplers_.empty() && active_workers_ == 0)
+    startWorkers();
+
   unsigned int max_attempts_div2 = max_attempts / 2;
   for (unsigned int a = gls->samplingAttemptsCount(); a < max_attempts && gls->isSampling(); ++a)
   {
+    if (pop_queued_goal())
+      return true;
+
     bool verbose = false;
     if (gls->getStateCount() == 0 && a >= max_attempts_div2)
       if (verbose_display_ < 1)
@@ -119,35 +289,8 @@ bool ompl_interface::ConstrainedGoalSampler::sampleUsingConstraintSampler(const
 
     if (constraint_sampler_)
     {
-      // makes the constraint sampler also perform a validity callback
-      moveit::core::GroupStateValidityCallbackFn gsvcf = [this, new_goal,
-                                                          verbose](moveit::core::RobotState* robot_state,
-                                                                   const moveit::core::JointModelGroup* joint_group,
-                                                                   const double* joint_group_variable_values) {
-        return stateValidityCallback(new_goal, robot_state, joint_group, joint_group_variable_values, verbose);
-      };
-      constraint_sampler_->setGroupStateValidityCallback(gsvcf);
-
-      if (constraint_sampler_->sample(work_state_, planning_context_->getMaximumStateSamplingAttempts()))
-      {
-        work_state_.update();
-        if (kinematic_constraint_set_->decide(work_state_, verbose).satisfied)
-        {
-          if (checkStateValidity(new_goal, work_state_, verbose))
-            return true;
-        }
-        else
-        {
-          invalid_sampled_constraints_++;
-          if (!warned_invalid_samples_ && invalid_sampled_constraints_ >= (attempts_so_far * 8) / 10)
-          {
-            warned_invalid_samples_ = true;
-            RCLCPP_WARN(LOGGER, "More than 80%% of the sampled goal states "
-                                "fail to satisfy the constraints imposed on the goal sampler. "
-                                "Is the constrained sampler working correctly?");
-          }
-        }
-      }
+      if (sampleGoal(*constraint_sampler_, work_state_, new_goal, attempts_so_far, verbose))
+        return true;
     }
     else
     {
@@ -160,5 +303,5 @@ bool ompl_interface::ConstrainedGoalSampler::sampleUsingConstraintSampler(const
       }
     }
   }
-  return false;
+  return pop_queued_goal();
 }
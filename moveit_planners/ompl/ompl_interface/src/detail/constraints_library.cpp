@@ -35,14 +35,25 @@
 /* Author: Ioan Sucan */
 
 #include <boost/date_time/posix_time/posix_time.hpp>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
+#include <functional>
+#include <mutex>
+#include <thread>
 #include <moveit/ompl_interface/detail/constrained_sampler.h>
 #include <moveit/ompl_interface/detail/constraints_library.h>
 
 #include <ompl/tools/config/SelfConfig.h>
 #include <utility>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 namespace ompl_interface
 {
 static const rclcpp::Logger LOGGER = rclcpp::get_logger("moveit.ompl_planning.constraints_library");
@@ -101,20 +112,316 @@ void hexToMsg(const std::string& hex, T& msg)
 }
 }  // namespace
 
+namespace
+{
+// header of the files of MappedConstraintApproximationStorage, followed by the sections described there
+struct MappedFileHeader
+{
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t state_size;
+  std::uint64_t state_count;
+  std::uint64_t connection_count;
+  std::uint64_t motion_count;
+  std::uint64_t signature_size;
+};
+
+std::uint64_t alignedSize(std::uint64_t size)
+{
+  return (size + 7) & ~std::uint64_t(7);
+}
+
+template <typename T>
+void writeArray(std::ofstream& out, const std::vector<T>& values)
+{
+  out.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+  static const char PADDING[8] = {};
+  out.write(PADDING, alignedSize(values.size() * sizeof(T)) - values.size() * sizeof(T));
+}
+
+// replace \e destination by \e source, without modifying a file other processes may have mapped
+bool replaceFile(const std::string& source, const std::string& destination)
+{
+  std::error_code ec;
+  std::filesystem::rename(source, destination, ec);
+  if (ec)
+  {
+    RCLCPP_ERROR(LOGGER, "Unable to write '%s': %s", destination.c_str(), ec.message().c_str());
+    std::filesystem::remove(source, ec);
+    return false;
+  }
+  return true;
+}
+}  // namespace
+
+MappedConstraintApproximationStorage::MappedConstraintApproximationStorage(const std::string& filename,
+                                                                           ompl::base::StateSpacePtr space)
+  : filename_(filename), space_(std::move(space)), data_(nullptr), data_size_(0)
+{
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+    throw std::runtime_error("Unable to open '" + filename + "': " + std::strerror(errno));
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0 || static_cast<std::size_t>(file_stat.st_size) < sizeof(MappedFileHeader))
+  {
+    close(fd);
+    throw std::runtime_error("'" + filename + "' is not a mapped constraint approximation");
+  }
+  data_size_ = file_stat.st_size;
+  data_ = mmap(nullptr, data_size_, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (data_ == MAP_FAILED)
+  {
+    data_ = nullptr;
+    throw std::runtime_error("Unable to map '" + filename + "': " + std::strerror(errno));
+  }
+
+  const auto fail = [this](const std::string& reason) {
+    munmap(data_, data_size_);
+    throw std::runtime_error("'" + filename_ + "' " + reason);
+  };
+  const char* data = static_cast<const char*>(data_);
+  MappedFileHeader header;
+  std::memcpy(&header, data, sizeof(header));
+  if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0)
+    fail("is not a mapped constraint approximation");
+  if (header.version != FORMAT_VERSION)
+    fail("has format version " + std::to_string(header.version) + " instead of " + std::to_string(FORMAT_VERSION));
+  if (header.state_size != space_->getSerializationLength())
+    fail("holds states of a different size");
+
+  // the counts are checked against the file size before computing the sizes of the sections, to avoid overflows
+  const std::uint64_t max_count = data_size_ / sizeof(std::uint64_t);
+  if (header.signature_size > max_count || header.state_count >= max_count || header.connection_count > max_count ||
+      header.motion_count > max_count || (header.state_size > 0 && header.state_count > data_size_ / header.state_size))
+    fail("is truncated");
+  const std::uint64_t signature_offset = sizeof(MappedFileHeader);
+  const std::uint64_t connection_offsets_offset = signature_offset + alignedSize(header.signature_size * sizeof(int));
+  const std::uint64_t connections_offset = connection_offsets_offset + (header.state_count + 1) * sizeof(std::uint64_t);
+  const std::uint64_t motion_offsets_offset = connections_offset + header.connection_count * sizeof(std::uint64_t);
+  const std::uint64_t motions_offset = motion_offsets_offset + (header.state_count + 1) * sizeof(std::uint64_t);
+  const std::uint64_t states_offset = motions_offset + 3 * header.motion_count * sizeof(std::uint64_t);
+  if (states_offset + header.state_count * header.state_size != data_size_)
+    fail("is truncated");
+
+  std::vector<int> signature(header.signature_size), expected_signature;
+  std::memcpy(signature.data(), data + signature_offset, signature.size() * sizeof(int));
+  space_->computeSignature(expected_signature);
+  if (signature != expected_signature)
+    fail("holds states of a different state space");
+
+  state_size_ = header.state_size;
+  state_count_ = header.state_count;
+  connection_offsets_ = reinterpret_cast<const std::uint64_t*>(data + connection_offsets_offset);
+  connections_ = reinterpret_cast<const std::uint64_t*>(data + connections_offset);
+  motion_offsets_ = reinterpret_cast<const std::uint64_t*>(data + motion_offsets_offset);
+  motions_ = reinterpret_cast<const std::uint64_t*>(data + motions_offset);
+  states_ = data + states_offset;
+  if (connection_offsets_[state_count_] != header.connection_count ||
+      motion_offsets_[state_count_] != header.motion_count)
+    fail("is corrupted");
+}
+
+MappedConstraintApproximationStorage::~MappedConstraintApproximationStorage()
+{
+  munmap(data_, data_size_);
+}
+
+void MappedConstraintApproximationStorage::getState(std::size_t index, ompl::base::State* state) const
+{
+  space_->deserialize(state, states_ + index * state_size_);
+}
+
+bool MappedConstraintApproximationStorage::getMotion(std::size_t from, std::size_t to,
+                                                     std::pair<std::size_t, std::size_t>& range) const
+{
+  // the motions of a state are sorted by their target state
+  std::uint64_t begin = motion_offsets_[from];
+  std::uint64_t end = motion_offsets_[from + 1];
+  while (begin < end)
+  {
+    const std::uint64_t middle = begin + (end - begin) / 2;
+    if (motions_[3 * middle] < to)
+      begin = middle + 1;
+    else
+      end = middle;
+  }
+  if (begin == motion_offsets_[from + 1] || motions_[3 * begin] != to)
+    return false;
+  range.first = motions_[3 * begin + 1];
+  range.second = motions_[3 * begin + 2];
+  return true;
+}
+
+bool MappedConstraintApproximationStorage::store(const std::string& filename,
+                                                 const ConstraintApproximationStateStorage& storage)
+{
+  const ob::StateSpacePtr& space = storage.getStateSpace();
+  MappedFileHeader header;
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = FORMAT_VERSION;
+  header.state_size = space->getSerializationLength();
+  header.state_count = storage.size();
+
+  std::vector<int> signature;
+  space->computeSignature(signature);
+  header.signature_size = signature.size();
+
+  std::vector<std::uint64_t> connection_offsets, connections, motion_offsets, motions;
+  connection_offsets.reserve(storage.size() + 1);
+  motion_offsets.reserve(storage.size() + 1);
+  for (std::size_t i = 0; i < storage.size(); ++i)
+  {
+    const ConstrainedStateMetadata& md = storage.getMetadata(i);
+    connection_offsets.push_back(connections.size());
+    connections.insert(connections.end(), md.first.begin(), md.first.end());
+    motion_offsets.push_back(motions.size() / 3);
+    for (const auto& motion : md.second)
+      motions.insert(motions.end(), { motion.first, motion.second.first, motion.second.second });
+  }
+  connection_offsets.push_back(connections.size());
+  motion_offsets.push_back(motions.size() / 3);
+  header.connection_count = connections.size();
+  header.motion_count = motions.size() / 3;
+
+  const std::string temporary = filename + ".tmp";
+  {
+    std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    writeArray(out, signature);
+    writeArray(out, connection_offsets);
+    writeArray(out, connections);
+    writeArray(out, motion_offsets);
+    writeArray(out, motions);
+    std::vector<char> state(header.state_size);
+    for (std::size_t i = 0; i < storage.size(); ++i)
+    {
+      space->serialize(state.data(), storage.getState(i));
+      out.write(state.data(), state.size());
+    }
+    if (!out.good())
+    {
+      RCLCPP_ERROR(LOGGER, "Unable to write '%s'", temporary.c_str());
+      out.close();
+      std::error_code ec;
+      std::filesystem::remove(temporary, ec);
+      return false;
+    }
+  }
+  return replaceFile(temporary, filename);
+}
+
+// Access to the states of a ConstraintApproximationStateStorage, see MappedStates for the mapped equivalent
+class StoredStates
+{
+public:
+  StoredStates(const ConstraintApproximationStateStorage* state_storage) : state_storage_(state_storage)
+  {
+  }
+
+  const ob::StateSpacePtr& getStateSpace() const
+  {
+    return state_storage_->getStateSpace();
+  }
+
+  // the stored states are accessed directly, so no scratch state is needed
+  const ob::State* getState(std::size_t index, ob::State* /*scratch*/) const
+  {
+    return state_storage_->getState(index);
+  }
+
+  void copyState(std::size_t index, ob::State* state) const
+  {
+    getStateSpace()->copyState(state, state_storage_->getState(index));
+  }
+
+  std::size_t getConnectionCount(std::size_t index) const
+  {
+    return state_storage_->getMetadata(index).first.size();
+  }
+
+  std::size_t getConnection(std::size_t index, std::size_t k) const
+  {
+    return state_storage_->getMetadata(index).first[k];
+  }
+
+  bool getMotion(std::size_t from, std::size_t to, std::pair<std::size_t, std::size_t>& range) const
+  {
+    const ConstrainedStateMetadata& md = state_storage_->getMetadata(from);
+    auto it = md.second.find(to);
+    if (it == md.second.end())
+      return false;
+    range = it->second;
+    return true;
+  }
+
+private:
+  const ConstraintApproximationStateStorage* state_storage_;
+};
+
+// Access to the states of a MappedConstraintApproximationStorage, which are deserialized on demand
+class MappedStates
+{
+public:
+  MappedStates(const MappedConstraintApproximationStorage* storage) : storage_(storage)
+  {
+  }
+
+  const ob::StateSpacePtr& getStateSpace() const
+  {
+    return storage_->getStateSpace();
+  }
+
+  const ob::State* getState(std::size_t index, ob::State* scratch) const
+  {
+    copyState(index, scratch);
+    return scratch;
+  }
+
+  void copyState(std::size_t index, ob::State* state) const
+  {
+    storage_->getState(index, state);
+    state->as<ModelBasedStateSpace::StateType>()->clearKnownInformation();
+  }
+
+  std::size_t getConnectionCount(std::size_t index) const
+  {
+    return storage_->getConnectionCount(index);
+  }
+
+  std::size_t getConnection(std::size_t index, std::size_t k) const
+  {
+    return storage_->getConnection(index, k);
+  }
+
+  bool getMotion(std::size_t from, std::size_t to, std::pair<std::size_t, std::size_t>& range) const
+  {
+    return storage_->getMotion(from, to, range);
+  }
+
+private:
+  const MappedConstraintApproximationStorage* storage_;
+};
+
+template <typename States>
 class ConstraintApproximationStateSampler : public ob::StateSampler
 {
 public:
-  ConstraintApproximationStateSampler(const ob::StateSpace* space,
-                                      const ConstraintApproximationStateStorage* state_storage, std::size_t milestones)
-    : ob::StateSampler(space), state_storage_(state_storage)
+  ConstraintApproximationStateSampler(const ob::StateSpace* space, const States& states, std::size_t milestones)
+    : ob::StateSampler(space), states_(states), scratch_(space->allocState())
   {
     max_index_ = milestones - 1;
     inv_dim_ = space->getDimension() > 0 ? 1.0 / (double)space->getDimension() : 1.0;
   }
 
+  ~ConstraintApproximationStateSampler() override
+  {
+    space_->freeState(scratch_);
+  }
+
   void sampleUniform(ob::State* state) override
   {
-    space_->copyState(state, state_storage_->getState(rng_.uniformInt(0, max_index_)));
+    states_.copyState(rng_.uniformInt(0, max_index_), state);
   }
 
   void sampleUniformNear(ob::State* state, const ob::State* near, const double distance) override
@@ -124,14 +431,14 @@ public:
 
     if (tag >= 0)
     {
-      const ConstrainedStateMetadata& md = state_storage_->getMetadata(tag);
-      if (!md.first.empty())
+      const std::size_t connections = states_.getConnectionCount(tag);
+      if (connections > 0)
       {
-        std::size_t matt = md.first.size() / 3;
+        std::size_t matt = connections / 3;
         std::size_t att = 0;
         do
         {
-          index = md.first[rng_.uniformInt(0, md.first.size() - 1)];
+          index = states_.getConnection(tag, rng_.uniformInt(0, connections - 1));
         } while (dirty_.find(index) != dirty_.end() && ++att < matt);
         if (att >= matt)
           index = -1;
@@ -142,15 +449,16 @@ public:
     if (index < 0)
       index = rng_.uniformInt(0, max_index_);
 
-    double dist = space_->distance(near, state_storage_->getState(index));
+    const ob::State* stored = states_.getState(index, scratch_);
+    double dist = space_->distance(near, stored);
 
     if (dist > distance)
     {
       double d = pow(rng_.uniform01(), inv_dim_) * distance;
-      space_->interpolate(near, state_storage_->getState(index), d / dist, state);
+      space_->interpolate(near, stored, d / dist, state);
     }
     else
-      space_->copyState(state, state_storage_->getState(index));
+      space_->copyState(state, stored);
   }
 
   void sampleGaussian(ob::State* state, const ob::State* mean, const double stdDev) override
@@ -160,14 +468,17 @@ public:
 
 protected:
   /** \brief The states to sample from */
-  const ConstraintApproximationStateStorage* state_storage_;
+  States states_;
+  /** \brief Holds a stored state if the states are not directly accessible */
+  ob::State* scratch_;
   std::set<std::size_t> dirty_;
   unsigned int max_index_;
   double inv_dim_;
 };
 
-bool interpolateUsingStoredStates(const ConstraintApproximationStateStorage* state_storage, const ob::State* from,
-                                  const ob::State* to, const double t, ob::State* state)
+template <typename States>
+bool interpolateUsingStoredStates(const States& states, const ob::State* from, const ob::State* to, const double t,
+                                  ob::State* state)
 {
   int tag_from = from->as<ModelBasedStateSpace::StateType>()->tag;
   int tag_to = to->as<ModelBasedStateSpace::StateType>()->tag;
@@ -176,26 +487,23 @@ bool interpolateUsingStoredStates(const ConstraintApproximationStateStorage* sta
     return false;
 
   if (tag_from == tag_to)
-    state_storage->getStateSpace()->copyState(state, to);
+    states.getStateSpace()->copyState(state, to);
   else
   {
-    const ConstrainedStateMetadata& md = state_storage->getMetadata(tag_from);
-
-    auto it = md.second.find(tag_to);
-    if (it == md.second.end())
+    std::pair<std::size_t, std::size_t> istates;
+    if (!states.getMotion(tag_from, tag_to, istates))
       return false;
-    const std::pair<std::size_t, std::size_t>& istates = it->second;
     std::size_t index = (std::size_t)((istates.second - istates.first + 2) * t + 0.5);
 
     if (index == 0)
-      state_storage->getStateSpace()->copyState(state, from);
+      states.getStateSpace()->copyState(state, from);
     else
     {
       --index;
       if (index >= istates.second - istates.first)
-        state_storage->getStateSpace()->copyState(state, to);
+        states.getStateSpace()->copyState(state, to);
       else
-        state_storage->getStateSpace()->copyState(state, state_storage->getState(istates.first + index));
+        states.copyState(istates.first + index, state);
     }
   }
   return true;
@@ -203,25 +511,34 @@ bool interpolateUsingStoredStates(const ConstraintApproximationStateStorage* sta
 
 ompl_interface::InterpolationFunction ompl_interface::ConstraintApproximation::getInterpolationFunction() const
 {
+  if (mapped_storage_)
+  {
+    if (explicit_motions_ && milestones_ > 0 && milestones_ < mapped_storage_->size())
+      return [states = MappedStates(mapped_storage_.get())](const ompl::base::State* from, const ompl::base::State* to,
+                                                            const double t, ompl::base::State* state) {
+        return interpolateUsingStoredStates(states, from, to, t, state);
+      };
+    return InterpolationFunction();
+  }
   if (explicit_motions_ && milestones_ > 0 && milestones_ < state_storage_->size())
-    return
-        [this](const ompl::base::State* from, const ompl::base::State* to, const double t, ompl::base::State* state) {
-          return interpolateUsingStoredStates(state_storage_, from, to, t, state);
-        };
+    return [states = StoredStates(state_storage_)](const ompl::base::State* from, const ompl::base::State* to,
+                                                   const double t, ompl::base::State* state) {
+      return interpolateUsingStoredStates(states, from, to, t, state);
+    };
   return InterpolationFunction();
 }
 
-ompl::base::StateSamplerPtr
-allocConstraintApproximationStateSampler(const ob::StateSpace* space, const std::vector<int>& expected_signature,
-                                         const ConstraintApproximationStateStorage* state_storage,
-                                         std::size_t milestones)
+template <typename States>
+ompl::base::StateSamplerPtr allocConstraintApproximationStateSampler(const ob::StateSpace* space,
+                                                                     const std::vector<int>& expected_signature,
+                                                                     const States& states, std::size_t milestones)
 {
   std::vector<int> sig;
   space->computeSignature(sig);
   if (sig != expected_signature)
     return ompl::base::StateSamplerPtr();
   else
-    return std::make_shared<ConstraintApproximationStateSampler>(space, state_storage, milestones);
+    return std::make_shared<ConstraintApproximationStateSampler<States>>(space, states, milestones);
 }
 }  // namespace ompl_interface
 
@@ -243,13 +560,40 @@ ompl_interface::ConstraintApproximation::ConstraintApproximation(
     milestones_ = state_storage_->size();
 }
 
+ompl_interface::ConstraintApproximation::ConstraintApproximation(
+    std::string group, std::string state_space_parameterization, bool explicit_motions,
+    moveit_msgs::msg::Constraints msg, std::string filename, MappedConstraintApproximationStoragePtr storage,
+    std::size_t milestones)
+  : group_(std::move(group))
+  , state_space_parameterization_(std::move(state_space_parameterization))
+  , explicit_motions_(explicit_motions)
+  , constraint_msg_(std::move(msg))
+  , ompldb_filename_(std::move(filename))
+  , state_storage_(nullptr)
+  , mapped_storage_(std::move(storage))
+  , milestones_(milestones)
+{
+  mapped_storage_->getStateSpace()->computeSignature(space_signature_);
+  if (milestones_ == 0)
+    milestones_ = mapped_storage_->size();
+}
+
 ompl::base::StateSamplerAllocator
 ompl_interface::ConstraintApproximation::getStateSamplerAllocator(const moveit_msgs::msg::Constraints& /*unused*/) const
 {
+  if (mapped_storage_)
+  {
+    if (mapped_storage_->size() == 0)
+      return ompl::base::StateSamplerAllocator();
+    return [this](const ompl::base::StateSpace* ss) {
+      return allocConstraintApproximationStateSampler(ss, space_signature_, MappedStates(mapped_storage_.get()),
+                                                      milestones_);
+    };
+  }
   if (state_storage_->size() == 0)
     return ompl::base::StateSamplerAllocator();
   return [this](const ompl::base::StateSpace* ss) {
-    return allocConstraintApproximationStateSampler(ss, space_signature_, state_storage_, milestones_);
+    return allocConstraintApproximationStateSampler(ss, space_signature_, StoredStates(state_storage_), milestones_);
   };
 }
 /*
@@ -344,26 +688,54 @@ void ompl_interface::ConstraintsLibrary::loadConstraintApproximations(const std:
                 state_space_parameterization.c_str(), group.c_str(), filename.c_str());
     moveit_msgs::msg::Constraints msg;
     hexToMsg(serialization, msg);
-    auto* cass = new ConstraintApproximationStateStorage(context_->getOMPLSimpleSetup()->getStateSpace());
-    cass->load((std::string{ path }.append("/").append(filename)).c_str());
-    auto cap = std::make_shared<ConstraintApproximation>(group, state_space_parameterization, explicit_motions, msg,
-                                                         filename, ompl::base::StateStoragePtr(cass), milestones);
+    const std::string file_path = std::string{ path }.append("/").append(filename);
+    ConstraintApproximationPtr cap;
+    std::size_t state_count, connection_count;
+    if (std::filesystem::path(filename).extension() == MAPPED_FILE_EXTENSION)
+    {
+      MappedConstraintApproximationStoragePtr storage;
+      try
+      {
+        storage = std::make_shared<MappedConstraintApproximationStorage>(
+            file_path, context_->getOMPLSimpleSetup()->getStateSpace());
+      }
+      catch (std::runtime_error& e)
+      {
+        RCLCPP_ERROR(LOGGER, "Unable to load constraint approximation: %s", e.what());
+        continue;
+      }
+      cap = std::make_shared<ConstraintApproximation>(group, state_space_parameterization, explicit_motions, msg,
+                                                      filename, storage, milestones);
+      state_count = storage->size();
+      connection_count = storage->getConnectionCount();
+    }
+    else
+    {
+      auto* cass = new ConstraintApproximationStateStorage(context_->getOMPLSimpleSetup()->getStateSpace());
+      cass->load(file_path.c_str());
+      cap = std::make_shared<ConstraintApproximation>(group, state_space_parameterization, explicit_motions, msg,
+                                                      filename, ompl::base::StateStoragePtr(cass), milestones);
+      state_count = cass->size();
+      connection_count = 0;
+      for (std::size_t i = 0; i < cass->size(); ++i)
+        connection_count += cass->getMetadata(i).first.size();
+    }
     if (constraint_approximations_.find(cap->getName()) != constraint_approximations_.end())
       RCLCPP_WARN(LOGGER, "Overwriting constraint approximation named '%s'", cap->getName().c_str());
     constraint_approximations_[cap->getName()] = cap;
-    std::size_t sum = 0;
-    for (std::size_t i = 0; i < cass->size(); ++i)
-      sum += cass->getMetadata(i).first.size();
     RCLCPP_INFO(LOGGER,
                 "Loaded %lu states (%lu milestones) and %lu connections (%0.1lf per state) "
                 "for constraint named '%s'%s",
-                cass->size(), cap->getMilestoneCount(), sum, (double)sum / (double)cap->getMilestoneCount(),
-                msg.name.c_str(), explicit_motions ? ". Explicit motions included." : "");
+                state_count, cap->getMilestoneCount(), connection_count,
+                (double)connection_count / (double)cap->getMilestoneCount(), msg.name.c_str(),
+                explicit_motions ? ". Explicit motions included." : "");
   }
   RCLCPP_INFO(LOGGER, "Done loading constrained space approximations.");
 }
 
-void ompl_interface::ConstraintsLibrary::saveConstraintApproximations(const std::string& path)
+const std::string ompl_interface::ConstraintsLibrary::MAPPED_FILE_EXTENSION = ".mapped";
+
+void ompl_interface::ConstraintsLibrary::saveConstraintApproximations(const std::string& path, bool mapped)
 {
   RCLCPP_INFO(LOGGER, "Saving %u constrained space approximations to '%s'",
               (unsigned int)constraint_approximations_.size(), path.c_str());
@@ -380,6 +752,10 @@ void ompl_interface::ConstraintsLibrary::saveConstraintApproximations(const std:
     for (std::map<std::string, ConstraintApproximationPtr>::const_iterator it = constraint_approximations_.begin();
          it != constraint_approximations_.end(); ++it)
     {
+      // mapped approximations are copied as they are, the others are written in the requested format
+      std::string filename = it->second->getFilename();
+      if (mapped && it->second->getStateStorage())
+        filename = std::filesystem::path(filename).replace_extension(MAPPED_FILE_EXTENSION).string();
       fout << it->second->getGroup() << '\n';
       fout << it->second->getStateSpaceParameterization() << '\n';
       fout << it->second->hasExplicitMotions() << '\n';
@@ -387,9 +763,29 @@ void ompl_interface::ConstraintsLibrary::saveConstraintApproximations(const std:
       std::string serialization;
       msgToHex(it->second->getConstraintsMsg(), serialization);
       fout << serialization << '\n';
-      fout << it->second->getFilename() << '\n';
-      if (it->second->getStateStorage())
-        it->second->getStateStorage()->store((path + "/" + it->second->getFilename()).c_str());
+      fout << filename << '\n';
+      const std::string file_path = path + "/" + filename;
+      if (const MappedConstraintApproximationStoragePtr& storage = it->second->getMappedStateStorage())
+      {
+        std::error_code ec;
+        if (!std::filesystem::equivalent(storage->getFilename(), file_path, ec))
+        {
+          std::filesystem::copy_file(storage->getFilename(), file_path + ".tmp",
+                                     std::filesystem::copy_options::overwrite_existing, ec);
+          if (ec)
+            RCLCPP_ERROR(LOGGER, "Unable to copy '%s': %s", storage->getFilename().c_str(), ec.message().c_str());
+          else
+            replaceFile(file_path + ".tmp", file_path);
+        }
+      }
+      else if (it->second->getStateStorage())
+      {
+        if (mapped)
+          MappedConstraintApproximationStorage::store(
+              file_path, *static_cast<ConstraintApproximationStateStorage*>(it->second->getStateStorage().get()));
+        else
+          it->second->getStateStorage()->store(file_path.c_str());
+      }
     }
   else
     RCLCPP_ERROR(LOGGER, "Unable to save constraint approximation to '%s'", path.c_str());
@@ -501,67 +897,97 @@ ompl::base::StateStoragePtr ompl_interface::ConstraintsLibrary::constructConstra
                                                    bounds_val);
   pcontext->getOMPLStateSpace()->setup();
 
-  // construct the constrained states
+  // sampling and connecting states is distributed over several threads, each using its own samplers and states
+  std::size_t thread_count = options.thread_count ? options.thread_count : std::thread::hardware_concurrency();
+  thread_count = std::max<std::size_t>(1, std::min<std::size_t>(thread_count, options.samples));
+  const auto run_threads = [thread_count](const std::function<void()>& worker) {
+    std::vector<std::thread> threads;
+    threads.reserve(thread_count - 1);
+    for (std::size_t t = 1; t < thread_count; ++t)
+      threads.emplace_back(worker);
+    worker();
+    for (std::thread& thread : threads)
+      thread.join();
+  };
 
-  moveit::core::RobotState robot_state(default_state);
+  // construct the constrained states
   const constraint_samplers::ConstraintSamplerManagerPtr& csmng = pcontext->getConstraintSamplerManager();
-  ConstrainedSampler* constrained_sampler = nullptr;
-  if (csmng)
+  std::vector<ConstrainedSampler*> constrained_samplers;
+  std::vector<ob::StateSamplerPtr> samplers;
+  for (std::size_t t = 0; t < thread_count; ++t)
   {
-    constraint_samplers::ConstraintSamplerPtr constraint_sampler =
-        csmng->selectSampler(pcontext->getPlanningScene(), pcontext->getJointModelGroup()->getName(), constr_sampling);
-    if (constraint_sampler)
-      constrained_sampler = new ConstrainedSampler(pcontext, constraint_sampler);
+    ConstrainedSampler* constrained_sampler = nullptr;
+    if (csmng)
+    {
+      constraint_samplers::ConstraintSamplerPtr constraint_sampler = csmng->selectSampler(
+          pcontext->getPlanningScene(), pcontext->getJointModelGroup()->getName(), constr_sampling);
+      if (constraint_sampler)
+      {
+        constrained_sampler = new ConstrainedSampler(pcontext, constraint_sampler);
+        constrained_samplers.push_back(constrained_sampler);
+      }
+    }
+    samplers.push_back(constrained_sampler ? ob::StateSamplerPtr(constrained_sampler) :
+                                             pcontext->getOMPLStateSpace()->allocDefaultStateSampler());
   }
 
-  ob::StateSamplerPtr ss(constrained_sampler ? ob::StateSamplerPtr(constrained_sampler) :
-                                               pcontext->getOMPLStateSpace()->allocDefaultStateSampler());
-
-  ompl::base::ScopedState<> temp(pcontext->getOMPLStateSpace());
+  std::mutex storage_lock;
+  std::atomic<std::size_t> next_sampler(0);
   int done = -1;
   bool slow_warn = false;
+  bool failed = false;
   ompl::time::point start = ompl::time::now();
-  while (state_storage->size() < options.samples)
-  {
-    ++attempts;
-    int done_now = 100 * state_storage->size() / options.samples;
-    if (done != done_now)
+  run_threads([&]() {
+    const ob::StateSamplerPtr& ss = samplers[next_sampler++];
+    moveit::core::RobotState robot_state(default_state);
+    ompl::base::ScopedState<> temp(pcontext->getOMPLStateSpace());
+    while (true)
     {
-      done = done_now;
-      RCLCPP_INFO(LOGGER, "%d%% complete (kept %0.1lf%% sampled states)", done,
-                  100.0 * (double)state_storage->size() / (double)attempts);
-    }
+      ss->sampleUniform(temp.get());
+      pcontext->getOMPLStateSpace()->copyToRobotState(robot_state, temp.get());
+      const bool satisfied = kset.decide(robot_state).satisfied;
+
+      std::scoped_lock slock(storage_lock);
+      if (failed || state_storage->size() >= options.samples)
+        break;
+      ++attempts;
+      int done_now = 100 * state_storage->size() / options.samples;
+      if (done != done_now)
+      {
+        done = done_now;
+        RCLCPP_INFO(LOGGER, "%d%% complete (kept %0.1lf%% sampled states)", done,
+                    100.0 * (double)state_storage->size() / (double)attempts);
+      }
 
-    if (!slow_warn && attempts > 10 && attempts > state_storage->size() * 100)
-    {
-      slow_warn = true;
-      RCLCPP_WARN(LOGGER, "Computation of valid state database is very slow...");
-    }
+      if (!slow_warn && attempts > 10 && attempts > state_storage->size() * 100)
+      {
+        slow_warn = true;
+        RCLCPP_WARN(LOGGER, "Computation of valid state database is very slow...");
+      }
 
-    if (attempts > options.samples && state_storage->size() == 0)
-    {
-      RCLCPP_ERROR(LOGGER, "Unable to generate any samples");
-      break;
-    }
+      if (attempts > options.samples && state_storage->size() == 0)
+      {
+        RCLCPP_ERROR(LOGGER, "Unable to generate any samples");
+        failed = true;
+        break;
+      }
 
-    ss->sampleUniform(temp.get());
-    pcontext->getOMPLStateSpace()->copyToRobotState(robot_state, temp.get());
-    if (kset.decide(robot_state).satisfied)
-    {
-      if (state_storage->size() < options.samples)
+      if (satisfied)
       {
         temp->as<ModelBasedStateSpace::StateType>()->tag = state_storage->size();
         state_storage->addState(temp.get());
       }
     }
-  }
+  });
 
   result.state_sampling_time = ompl::time::seconds(ompl::time::now() - start);
   RCLCPP_INFO(LOGGER, "Generated %u states in %lf seconds", (unsigned int)state_storage->size(),
               result.state_sampling_time);
-  if (constrained_sampler)
+  if (!constrained_samplers.empty())
   {
-    result.sampling_success_rate = constrained_sampler->getConstrainedSamplingRate();
+    result.sampling_success_rate = 0.0;
+    for (const ConstrainedSampler* constrained_sampler : constrained_samplers)
+      result.sampling_success_rate += constrained_sampler->getConstrainedSamplingRate() / constrained_samplers.size();
     RCLCPP_INFO(LOGGER, "Constrained sampling rate: %lf", result.sampling_success_rate);
   }
 
@@ -572,79 +998,102 @@ ompl::base::StateStoragePtr ompl_interface::ConstraintsLibrary::constructConstra
 
     // construct connections
     const ob::StateSpacePtr& space = pcontext->getOMPLSimpleSetup()->getStateSpace();
+    const ob::SpaceInformationPtr& si = pcontext->getOMPLSimpleSetup()->getSpaceInformation();
     unsigned int milestones = state_storage->size();
-    std::vector<ob::State*> int_states(options.max_explicit_points, nullptr);
-    pcontext->getOMPLSimpleSetup()->getSpaceInformation()->allocStates(int_states);
 
+    // interpolate the motion from milestone i to state sj into int_states, returns the number of interpolated states
+    const auto interpolate = [&](std::size_t i, const ob::State* sj, std::vector<ob::State*>& int_states,
+                                 moveit::core::RobotState* robot_state) {
+      double d = space->distance(state_storage->getState(i), sj);
+      unsigned int isteps = std::min<unsigned int>(options.max_explicit_points, d / options.explicit_points_resolution);
+      double step = 1.0 / (double)isteps;
+      space->interpolate(state_storage->getState(i), sj, step, int_states[0]);
+      for (unsigned int k = 1; k < isteps; ++k)
+      {
+        double this_step = step / (1.0 - (k - 1) * step);
+        space->interpolate(int_states[k - 1], sj, this_step, int_states[k]);
+        if (robot_state)
+        {
+          pcontext->getOMPLStateSpace()->copyToRobotState(*robot_state, int_states[k]);
+          if (!kset.decide(*robot_state).satisfied)
+            return 0u;
+        }
+      }
+      return isteps;
+    };
+
+    // The motions are checked in parallel: each milestone is checked against the following milestones until
+    // edges_per_sample valid motions are found. Connecting them happens in order afterwards, skipping milestones
+    // that already have edges_per_sample connections.
     ompl::time::point start = ompl::time::now();
-    int good = 0;
-    int done = -1;
+    std::vector<std::vector<std::size_t>> candidates(milestones);
+    std::atomic<std::size_t> next(0);
+    std::atomic<int> connected(-1);
+    run_threads([&]() {
+      moveit::core::RobotState robot_state(default_state);
+      std::vector<ob::State*> int_states(options.max_explicit_points, nullptr);
+      si->allocStates(int_states);
+      for (std::size_t j = next++; j < milestones; j = next++)
+      {
+        int done_now = 100 * j / milestones;
+        int reported = connected;
+        while (reported < done_now && !connected.compare_exchange_weak(reported, done_now))
+        {
+        }
+        if (reported < done_now)
+          RCLCPP_INFO(LOGGER, "%d%% complete", done_now);
 
+        const ob::State* sj = state_storage->getState(j);
+        for (std::size_t i = j + 1; i < milestones && candidates[j].size() < options.edges_per_sample; ++i)
+        {
+          if (space->distance(state_storage->getState(i), sj) < options.max_edge_length &&
+              interpolate(i, sj, int_states, &robot_state) > 0)
+            candidates[j].push_back(i);
+        }
+      }
+      si->freeStates(int_states);
+    });
+
+    std::vector<ob::State*> int_states(options.max_explicit_points, nullptr);
+    si->allocStates(int_states);
+    int good = 0;
     for (std::size_t j = 0; j < milestones; ++j)
     {
-      int done_now = 100 * j / milestones;
-      if (done != done_now)
-      {
-        done = done_now;
-        RCLCPP_INFO(LOGGER, "%d%% complete", done);
-      }
       if (cass->getMetadata(j).first.size() >= options.edges_per_sample)
         continue;
 
       const ob::State* sj = state_storage->getState(j);
-
-      for (std::size_t i = j + 1; i < milestones; ++i)
+      for (std::size_t i : candidates[j])
       {
         if (cass->getMetadata(i).first.size() >= options.edges_per_sample)
           continue;
-        double d = space->distance(state_storage->getState(i), sj);
-        if (d >= options.max_edge_length)
-          continue;
-        unsigned int isteps =
-            std::min<unsigned int>(options.max_explicit_points, d / options.explicit_points_resolution);
-        double step = 1.0 / (double)isteps;
-        bool ok = true;
-        space->interpolate(state_storage->getState(i), sj, step, int_states[0]);
-        for (unsigned int k = 1; k < isteps; ++k)
-        {
-          double this_step = step / (1.0 - (k - 1) * step);
-          space->interpolate(int_states[k - 1], sj, this_step, int_states[k]);
-          pcontext->getOMPLStateSpace()->copyToRobotState(robot_state, int_states[k]);
-          if (!kset.decide(robot_state).satisfied)
-          {
-            ok = false;
-            break;
-          }
-        }
 
-        if (ok)
-        {
-          cass->getMetadata(i).first.push_back(j);
-          cass->getMetadata(j).first.push_back(i);
+        cass->getMetadata(i).first.push_back(j);
+        cass->getMetadata(j).first.push_back(i);
 
-          if (options.explicit_motions)
+        if (options.explicit_motions)
+        {
+          unsigned int isteps = interpolate(i, sj, int_states, nullptr);
+          cass->getMetadata(i).second[j].first = state_storage->size();
+          for (unsigned int k = 0; k < isteps; ++k)
           {
-            cass->getMetadata(i).second[j].first = state_storage->size();
-            for (unsigned int k = 0; k < isteps; ++k)
-            {
-              int_states[k]->as<ModelBasedStateSpace::StateType>()->tag = -1;
-              state_storage->addState(int_states[k]);
-            }
-            cass->getMetadata(i).second[j].second = state_storage->size();
-            cass->getMetadata(j).second[i] = cass->getMetadata(i).second[j];
+            int_states[k]->as<ModelBasedStateSpace::StateType>()->tag = -1;
+            state_storage->addState(int_states[k]);
           }
-
-          good++;
-          if (cass->getMetadata(j).first.size() >= options.edges_per_sample)
-            break;
+          cass->getMetadata(i).second[j].second = state_storage->size();
+          cass->getMetadata(j).second[i] = cass->getMetadata(i).second[j];
         }
+
+        good++;
+        if (cass->getMetadata(j).first.size() >= options.edges_per_sample)
+          break;
       }
     }
 
     result.state_connection_time = ompl::time::seconds(ompl::time::now() - start);
     RCLCPP_INFO(LOGGER, "Computed possible connexions in %lf seconds. Added %d connexions",
                 result.state_connection_time, good);
-    pcontext->getOMPLSimpleSetup()->getSpaceInformation()->freeStates(int_states);
+    si->freeStates(int_states);
 
     return state_storage;
   }
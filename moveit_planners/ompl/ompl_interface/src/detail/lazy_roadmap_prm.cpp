@@ -0,0 +1,64 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/ompl_interface/detail/lazy_roadmap_prm.h>
+
+namespace ompl_interface
+{
+LazyRoadmapPRM::LazyRoadmapPRM(const ompl::base::SpaceInformationPtr& si, bool star_strategy)
+  : ompl::geometric::LazyPRM(si, star_strategy)
+{
+}
+
+LazyRoadmapPRM::LazyRoadmapPRM(const ompl::base::PlannerData& data, bool star_strategy)
+  : ompl::geometric::LazyPRM(data, star_strategy)
+{
+}
+
+void LazyRoadmapPRM::clear()
+{
+  ompl::geometric::LazyPRM::clear();
+  validated_environment_.reset();
+}
+
+LazyRoadmapPRMstar::LazyRoadmapPRMstar(const ompl::base::SpaceInformationPtr& si) : LazyRoadmapPRM(si, true)
+{
+  setName("LazyPRMstar");
+}
+
+LazyRoadmapPRMstar::LazyRoadmapPRMstar(const ompl::base::PlannerData& data) : LazyRoadmapPRM(data, true)
+{
+  setName("LazyPRMstar");
+}
+}  // namespace ompl_interface
@@ -129,13 +129,14 @@ BaseConstraint::BaseConstraint(const moveit::core::RobotModelConstPtr& robot_mod
   : ompl::base::Constraint(num_dofs, num_cons_)
   , state_storage_(robot_model)
   , joint_model_group_(robot_model->getJointModelGroup(group))
-
+  , link_model_(nullptr)
 {
 }
 
 void BaseConstraint::init(const moveit_msgs::msg::Constraints& constraints)
 {
   parseConstraintMsg(constraints);
+  link_model_ = joint_model_group_->getParentModel().getLinkModel(link_name_);
 }
 
 void BaseConstraint::function(const Eigen::Ref<const Eigen::VectorXd>& joint_values,
@@ -150,28 +151,46 @@ void BaseConstraint::jacobian(const Eigen::Ref<const Eigen::VectorXd>& joint_val
 {
   const Eigen::VectorXd constraint_error = calcError(joint_values);
   const Eigen::VectorXd constraint_derivative = bounds_.derivative(constraint_error);
-  const Eigen::MatrixXd robot_jacobian = calcErrorJacobian(joint_values);
   for (std::size_t i = 0; i < bounds_.size(); ++i)
   {
-    out.row(i) = constraint_derivative[i] * robot_jacobian.row(i);
+    // rows in the bounds get a zero derivative, so the error Jacobian is only needed when a bound is violated
+    if (constraint_derivative[i] != 0.0)
+    {
+      out = constraint_derivative.asDiagonal() * calcErrorJacobian(joint_values);
+      return;
+    }
   }
+  out.setZero();
 }
 
-Eigen::Isometry3d BaseConstraint::forwardKinematics(const Eigen::Ref<const Eigen::VectorXd>& joint_values) const
+moveit::core::RobotState*
+BaseConstraint::getUpdatedState(const Eigen::Ref<const Eigen::VectorXd>& joint_values) const
 {
   moveit::core::RobotState* robot_state = state_storage_.getStateStorage();
-  robot_state->setJointGroupPositions(joint_model_group_, joint_values);
-  return robot_state->getGlobalLinkTransform(link_name_);
+  const std::vector<int>& variable_index = joint_model_group_->getVariableIndexList();
+  const double* positions = robot_state->getVariablePositions();
+  for (std::size_t i = 0; i < variable_index.size(); ++i)
+  {
+    if (positions[variable_index[i]] != joint_values[i])
+    {
+      robot_state->setJointGroupPositions(joint_model_group_, joint_values);
+      break;
+    }
+  }
+  robot_state->updateLinkTransforms();
+  return robot_state;
+}
+
+Eigen::Isometry3d BaseConstraint::forwardKinematics(const Eigen::Ref<const Eigen::VectorXd>& joint_values) const
+{
+  return getUpdatedState(joint_values)->getGlobalLinkTransform(link_model_);
 }
 
 Eigen::MatrixXd BaseConstraint::robotGeometricJacobian(const Eigen::Ref<const Eigen::VectorXd>& joint_values) const
 {
-  moveit::core::RobotState* robot_state = state_storage_.getStateStorage();
-  robot_state->setJointGroupPositions(joint_model_group_, joint_values);
   Eigen::MatrixXd jacobian;
   // return value (success) not used, could return a garbage jacobian.
-  robot_state->getJacobian(joint_model_group_, joint_model_group_->getLinkModel(link_name_),
-                           Eigen::Vector3d(0.0, 0.0, 0.0), jacobian);
+  getUpdatedState(joint_values)->getJacobian(joint_model_group_, link_model_, Eigen::Vector3d::Zero(), jacobian);
   return jacobian;
 }
 
@@ -217,12 +236,14 @@ void BoxConstraint::parseConstraintMsg(const moveit_msgs::msg::Constraints& cons
 
 Eigen::VectorXd BoxConstraint::calcError(const Eigen::Ref<const Eigen::VectorXd>& x) const
 {
-  return target_orientation_.matrix().transpose() * (forwardKinematics(x).translation() - target_position_);
+  const Eigen::Vector3d error =
+      target_orientation_.matrix().transpose() * (forwardKinematics(x).translation() - target_position_);
+  return error;
 }
 
 Eigen::MatrixXd BoxConstraint::calcErrorJacobian(const Eigen::Ref<const Eigen::VectorXd>& x) const
 {
-  return target_orientation_.matrix().transpose() * robotGeometricJacobian(x).topRows(3);
+  return target_orientation_.matrix().transpose() * robotGeometricJacobian(x).topRows<3>();
 }
 
 /******************************************
@@ -291,7 +312,8 @@ void EqualityPositionConstraint::jacobian(const Eigen::Ref<const Eigen::VectorXd
                                           Eigen::Ref<Eigen::MatrixXd> out) const
 {
   out.setZero();
-  Eigen::MatrixXd jac = target_orientation_.matrix().transpose() * robotGeometricJacobian(joint_values).topRows(3);
+  const Eigen::MatrixXd jac =
+      target_orientation_.matrix().transpose() * robotGeometricJacobian(joint_values).topRows<3>();
   for (std::size_t dim = 0; dim < 3; ++dim)
   {
     if (is_dim_constrained_.at(dim))
@@ -315,16 +337,17 @@ void OrientationConstraint::parseConstraintMsg(const moveit_msgs::msg::Constrain
 
 Eigen::VectorXd OrientationConstraint::calcError(const Eigen::Ref<const Eigen::VectorXd>& x) const
 {
-  Eigen::Matrix3d orientation_difference = forwardKinematics(x).linear().transpose() * target_orientation_;
-  Eigen::AngleAxisd aa(orientation_difference);
-  return aa.axis() * aa.angle();
+  const Eigen::Matrix3d orientation_difference = forwardKinematics(x).linear().transpose() * target_orientation_;
+  const Eigen::AngleAxisd aa(orientation_difference);
+  const Eigen::Vector3d error = aa.axis() * aa.angle();
+  return error;
 }
 
 Eigen::MatrixXd OrientationConstraint::calcErrorJacobian(const Eigen::Ref<const Eigen::VectorXd>& x) const
 {
-  Eigen::Matrix3d orientation_difference = forwardKinematics(x).linear().transpose() * target_orientation_;
-  Eigen::AngleAxisd aa{ orientation_difference };
-  return -angularVelocityToAngleAxis(aa.angle(), aa.axis()) * robotGeometricJacobian(x).bottomRows(3);
+  const Eigen::Matrix3d orientation_difference = forwardKinematics(x).linear().transpose() * target_orientation_;
+  const Eigen::AngleAxisd aa{ orientation_difference };
+  return -angularVelocityToAngleAxis(aa.angle(), aa.axis()) * robotGeometricJacobian(x).bottomRows<3>();
 }
 
 /************************************
@@ -35,9 +35,13 @@
 /* Author: Ioan Sucan */
 
 #include <moveit/ompl_interface/detail/projection_evaluators.h>
+#include <moveit/ompl_interface/detail/state_validity_checker.h>
 #include <moveit/ompl_interface/model_based_planning_context.h>
 #include <moveit/ompl_interface/parameterization/model_based_state_space.h>
 
+#include <Eigen/Eigenvalues>
+#include <fstream>
+#include <sstream>
 #include <utility>
 
 ompl_interface::ProjectionEvaluatorLinkPose::ProjectionEvaluatorLinkPose(const ModelBasedPlanningContext* pc,
@@ -46,6 +50,8 @@ ompl_interface::ProjectionEvaluatorLinkPose::ProjectionEvaluatorLinkPose(const M
   , planning_context_(pc)
   , link_(planning_context_->getJointModelGroup()->getLinkModel(link))
   , tss_(planning_context_->getCompleteInitialRobotState())
+  , validity_checker_(std::dynamic_pointer_cast<const StateValidityChecker>(
+        planning_context_->getOMPLSimpleSetup()->getStateValidityChecker()))
 {
 }
 
@@ -65,8 +71,14 @@ void ompl_interface::ProjectionEvaluatorLinkPose::defaultCellSizes()
 void ompl_interface::ProjectionEvaluatorLinkPose::project(const ompl::base::State* state,
                                                           OMPLProjection projection) const
 {
-  moveit::core::RobotState* s = tss_.getStateStorage();
-  planning_context_->getOMPLStateSpace()->copyToRobotState(*s, state);
+  // planners usually project a state right after checking it, so its link transforms are often already known
+  const moveit::core::RobotState* s = validity_checker_ ? validity_checker_->getCachedRobotState(state) : nullptr;
+  if (!s)
+  {
+    moveit::core::RobotState* storage = tss_.getStateStorage();
+    planning_context_->getOMPLStateSpace()->copyToRobotState(*storage, state);
+    s = storage;
+  }
 
   const Eigen::Vector3d& o = s->getGlobalLinkTransform(link_).translation();
   projection(0) = o.x();
@@ -97,3 +109,59 @@ void ompl_interface::ProjectionEvaluatorJointValue::project(const ompl::base::St
   for (std::size_t i = 0; i < variables_.size(); ++i)
     projection(i) = state->as<ModelBasedStateSpace::StateType>()->values[variables_[i]];
 }
+
+ompl_interface::ProjectionEvaluatorPCA::ProjectionEvaluatorPCA(const ModelBasedPlanningContext* pc,
+                                                               const std::vector<Eigen::VectorXd>& samples,
+                                                               unsigned int dimension)
+  : ompl::base::ProjectionEvaluator(pc->getOMPLStateSpace())
+{
+  assert(!samples.empty());
+  const std::size_t variable_count = samples.front().size();
+  dimension = std::min<std::size_t>(std::max(1u, dimension), variable_count);
+
+  mean_ = Eigen::VectorXd::Zero(variable_count);
+  for (const Eigen::VectorXd& sample : samples)
+    mean_ += sample;
+  mean_ /= samples.size();
+
+  Eigen::MatrixXd covariance = Eigen::MatrixXd::Zero(variable_count, variable_count);
+  for (const Eigen::VectorXd& sample : samples)
+    covariance.noalias() += (sample - mean_) * (sample - mean_).transpose();
+  covariance /= samples.size();
+
+  // eigenvalues are sorted in increasing order, so the principal components are the last columns
+  Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> solver(covariance);
+  basis_ = solver.eigenvectors().rightCols(dimension).rowwise().reverse();
+}
+
+unsigned int ompl_interface::ProjectionEvaluatorPCA::getDimension() const
+{
+  return basis_.cols();
+}
+
+void ompl_interface::ProjectionEvaluatorPCA::project(const ompl::base::State* state, OMPLProjection projection) const
+{
+  Eigen::Map<const Eigen::VectorXd> values(state->as<ModelBasedStateSpace::StateType>()->values, mean_.size());
+  Eigen::VectorXd projected = basis_.transpose() * (values - mean_);
+  for (unsigned int i = 0; i < projected.size(); ++i)
+    projection(i) = projected(i);
+}
+
+bool ompl_interface::ProjectionEvaluatorPCA::loadSamples(const std::string& path, std::size_t variable_count,
+                                                         std::vector<Eigen::VectorXd>& samples)
+{
+  std::ifstream in(path);
+  std::string line;
+  std::vector<double> values;
+  while (std::getline(in, line))
+  {
+    std::stringstream ss(line);
+    values.clear();
+    double value;
+    while (ss >> value)
+      values.push_back(value);
+    if (values.size() == variable_count)
+      samples.push_back(Eigen::Map<Eigen::VectorXd>(values.data(), values.size()));
+  }
+  return !samples.empty();
+}
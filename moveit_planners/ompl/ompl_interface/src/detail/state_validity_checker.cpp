@@ -36,10 +36,13 @@
 
 #include <moveit/ompl_interface/detail/state_validity_checker.h>
 #include <moveit/ompl_interface/model_based_planning_context.h>
+#include <moveit/utils/lexical_casts.h>
 #include <ompl/base/spaces/constraint/ConstrainedStateSpace.h>
 #include <rclcpp/logger.hpp>
 #include <rclcpp/logging.hpp>
 
+#include <queue>
+
 namespace ompl_interface
 {
 static const rclcpp::Logger LOGGER = rclcpp::get_logger("moveit.ompl_planning.state_validity_checker");
@@ -66,6 +69,21 @@ ompl_interface::StateValidityChecker::StateValidityChecker(const ModelBasedPlann
 
   collision_request_with_distance_verbose_ = collision_request_with_distance_;
   collision_request_with_distance_verbose_.verbose = true;
+
+  // optionally remember the results of simple collision checks, as planners revisit the same states repeatedly
+  const std::map<std::string, std::string>& config = pc->getSpecificationConfig();
+  auto it = config.find("collision_cache_size");
+  if (it != config.end())
+  {
+    const double cache_size = moveit::core::toDouble(it->second);
+    double resolution = collision_detection::CollisionResultCache::DEFAULT_RESOLUTION;
+    auto jt = config.find("collision_cache_resolution");
+    if (jt != config.end())
+      resolution = moveit::core::toDouble(jt->second);
+    if (cache_size >= 1.0)
+      collision_cache_ =
+          std::make_shared<collision_detection::CollisionResultCache>(static_cast<std::size_t>(cache_size), resolution);
+  }
 }
 
 void ompl_interface::StateValidityChecker::setVerbose(bool flag)
@@ -73,107 +91,135 @@ void ompl_interface::StateValidityChecker::setVerbose(bool flag)
   verbose_ = flag;
 }
 
+const moveit::core::RobotState* StateValidityChecker::getCachedRobotState(const ompl::base::State* state) const
+{
+  const moveit::core::RobotState* robot_state = tss_.getStateStorage();
+  if (robot_state->dirtyLinkTransforms())
+    return nullptr;
+
+  // the stored state is only overwritten by the checks of this thread, so equal group values mean equal transforms
+  const double* values = state->as<ModelBasedStateSpace::StateType>()->values;
+  const double* positions = robot_state->getVariablePositions();
+  const std::vector<int>& il = planning_context_->getJointModelGroup()->getVariableIndexList();
+  for (std::size_t i = 0; i < il.size(); ++i)
+    if (positions[il[i]] != values[i])
+      return nullptr;
+  return robot_state;
+}
+
 bool StateValidityChecker::isValid(const ompl::base::State* state, bool verbose) const
 {
   assert(state != nullptr);
   // Use cached validity if it is available
-  if (state->as<ModelBasedStateSpace::StateType>()->isValidityKnown())
+  auto* cache = const_cast<ob::State*>(state)->as<ModelBasedStateSpace::StateType>();
+  if (cache->isValidityKnown())
   {
-    return state->as<ModelBasedStateSpace::StateType>()->isMarkedValid();
+    return cache->isMarkedValid();
   }
 
-  if (!si_->satisfiesBounds(state))
+  moveit::core::RobotState* robot_state = tss_.getStateStorage();
+  double dist;
+  if (!checkConstraints(state, cache, *robot_state, dist, verbose))
   {
-    if (verbose)
-    {
-      RCLCPP_INFO(LOGGER, "State outside bounds");
-    }
-    const_cast<ob::State*>(state)->as<ModelBasedStateSpace::StateType>()->markInvalid();
+    cache->markInvalid();
     return false;
   }
 
-  moveit::core::RobotState* robot_state = tss_.getStateStorage();
-  planning_context_->getOMPLStateSpace()->copyToRobotState(*robot_state, state);
+  // check collision avoidance
+  if (checkCollision(*robot_state, verbose))
+  {
+    cache->markValid();
+    return true;
+  }
+  cache->markInvalid();
+  return false;
+}
 
-  // check path constraints
-  const kinematic_constraints::KinematicConstraintSetPtr& kset = planning_context_->getPathConstraints();
-  if (kset && !kset->decide(*robot_state, verbose).satisfied)
+bool StateValidityChecker::isValid(const ompl::base::State* state, double& dist, bool verbose) const
+{
+  assert(state != nullptr);
+  // Use cached validity and distance if they are available
+  auto* cache = const_cast<ob::State*>(state)->as<ModelBasedStateSpace::StateType>();
+  if (cache->isValidityKnown() && cache->isGoalDistanceKnown())
   {
-    const_cast<ob::State*>(state)->as<ModelBasedStateSpace::StateType>()->markInvalid();
-    return false;
+    dist = cache->distance;
+    return cache->isMarkedValid();
   }
 
-  // check feasibility
-  if (!planning_context_->getPlanningScene()->isStateFeasible(*robot_state, verbose))
+  moveit::core::RobotState* robot_state = tss_.getStateStorage();
+  if (!checkConstraints(state, cache, *robot_state, dist, verbose))
   {
-    const_cast<ob::State*>(state)->as<ModelBasedStateSpace::StateType>()->markInvalid();
+    cache->markInvalid(dist);
     return false;
   }
 
   // check collision avoidance
   collision_detection::CollisionResult res;
   planning_context_->getPlanningScene()->checkCollision(
-      verbose ? collision_request_simple_verbose_ : collision_request_simple_, res, *robot_state);
-  if (!res.collision)
-  {
-    const_cast<ob::State*>(state)->as<ModelBasedStateSpace::StateType>()->markValid();
-  }
+      verbose ? collision_request_with_distance_verbose_ : collision_request_with_distance_, res, *robot_state);
+  dist = res.distance;
+  if (res.collision)
+    cache->markInvalid(dist);
   else
-  {
-    const_cast<ob::State*>(state)->as<ModelBasedStateSpace::StateType>()->markInvalid();
-  }
+    cache->markValid(dist);
   return !res.collision;
 }
 
-bool StateValidityChecker::isValid(const ompl::base::State* state, double& dist, bool verbose) const
+bool StateValidityChecker::checkConstraints(const ompl::base::State* state, ModelBasedStateSpace::StateType* cache,
+                                            moveit::core::RobotState& robot_state, double& dist, bool verbose) const
 {
-  assert(state != nullptr);
-  // Use cached validity and distance if they are available
-  if (state->as<ModelBasedStateSpace::StateType>()->isValidityKnown() &&
-      state->as<ModelBasedStateSpace::StateType>()->isGoalDistanceKnown())
+  dist = 0.0;
+  if (cache->areConstraintsSatisfied())
   {
-    dist = state->as<ModelBasedStateSpace::StateType>()->distance;
-    return state->as<ModelBasedStateSpace::StateType>()->isMarkedValid();
+    planning_context_->getOMPLStateSpace()->copyToRobotState(robot_state, state);
+    return true;
   }
 
+  // bounds are checked before computing forward kinematics
   if (!si_->satisfiesBounds(state))
   {
     if (verbose)
     {
       RCLCPP_INFO(LOGGER, "State outside bounds");
     }
-    const_cast<ob::State*>(state)->as<ModelBasedStateSpace::StateType>()->markInvalid(0.0);
     return false;
   }
 
-  moveit::core::RobotState* robot_state = tss_.getStateStorage();
-  planning_context_->getOMPLStateSpace()->copyToRobotState(*robot_state, state);
+  planning_context_->getOMPLStateSpace()->copyToRobotState(robot_state, state);
 
   // check path constraints
   const kinematic_constraints::KinematicConstraintSetPtr& kset = planning_context_->getPathConstraints();
   if (kset)
   {
-    kinematic_constraints::ConstraintEvaluationResult cer = kset->decide(*robot_state, verbose);
+    kinematic_constraints::ConstraintEvaluationResult cer = kset->decide(robot_state, verbose);
     if (!cer.satisfied)
     {
       dist = cer.distance;
-      const_cast<ob::State*>(state)->as<ModelBasedStateSpace::StateType>()->markInvalid(dist);
       return false;
     }
   }
 
   // check feasibility
-  if (!planning_context_->getPlanningScene()->isStateFeasible(*robot_state, verbose))
-  {
-    dist = 0.0;
+  if (!planning_context_->getPlanningScene()->isStateFeasible(robot_state, verbose))
     return false;
-  }
 
-  // check collision avoidance
+  cache->markConstraintsSatisfied();
+  return true;
+}
+
+bool StateValidityChecker::checkCollision(const moveit::core::RobotState& robot_state, bool verbose) const
+{
   collision_detection::CollisionResult res;
-  planning_context_->getPlanningScene()->checkCollision(
-      verbose ? collision_request_with_distance_verbose_ : collision_request_with_distance_, res, *robot_state);
-  dist = res.distance;
+  const collision_detection::AllowedCollisionMatrix& acm =
+      planning_context_->getPlanningScene()->getAllowedCollisionMatrix();
+  const moveit::core::JointModelGroup* jmg = planning_context_->getJointModelGroup();
+  if (verbose || !collision_cache_ || !collision_cache_->lookup(jmg, robot_state, acm, res.collision))
+  {
+    planning_context_->getPlanningScene()->checkCollision(
+        verbose ? collision_request_simple_verbose_ : collision_request_simple_, res, robot_state);
+    if (collision_cache_)
+      collision_cache_->insert(jmg, robot_state, acm, res.collision);
+  }
   return !res.collision;
 }
 
@@ -216,103 +262,174 @@ bool ConstrainedPlanningStateValidityChecker::isValid(const ompl::base::State* w
   assert(wrapped_state != nullptr);
   // Unwrap the state from a ConstrainedStateSpace::StateType
   auto state = wrapped_state->as<ompl::base::ConstrainedStateSpace::StateType>()->getState();
+  auto* cache = const_cast<ob::State*>(state)->as<ModelBasedStateSpace::StateType>();
 
   // Use cached validity if it is available
-  if (state->as<ModelBasedStateSpace::StateType>()->isValidityKnown())
+  if (cache->isValidityKnown())
   {
-    return state->as<ModelBasedStateSpace::StateType>()->isMarkedValid();
+    return cache->isMarkedValid();
   }
 
-  // do not use the unwrapped state here, as satisfiesBounds expects a state of type ConstrainedStateSpace::StateType
-  if (!si_->satisfiesBounds(wrapped_state))  // si_ = ompl::base::SpaceInformation
+  // do not use the unwrapped state here, as satisfiesBounds and copyToRobotState expect a state of type
+  // ConstrainedStateSpace::StateType
+  moveit::core::RobotState* robot_state = tss_.getStateStorage();
+  double dist;
+  if (!checkConstraints(wrapped_state, cache, *robot_state, dist, verbose))
   {
-    RCLCPP_DEBUG(LOGGER, "State outside bounds");
-    const_cast<ob::State*>(state)->as<ModelBasedStateSpace::StateType>()->markInvalid();
+    cache->markInvalid();
     return false;
   }
 
-  moveit::core::RobotState* robot_state = tss_.getStateStorage();
-  // do not use the unwrapped state here, as copyToRobotState expects a state of type ConstrainedStateSpace::StateType
-  planning_context_->getOMPLStateSpace()->copyToRobotState(*robot_state, wrapped_state);
+  // check collision avoidance
+  if (checkCollision(*robot_state, verbose))
+  {
+    cache->markValid();
+    return true;
+  }
+  cache->markInvalid();
+  return false;
+}
 
-  // check path constraints
-  const kinematic_constraints::KinematicConstraintSetPtr& kset = planning_context_->getPathConstraints();
-  if (kset && !kset->decide(*robot_state, verbose).satisfied)
+bool ConstrainedPlanningStateValidityChecker::isValid(const ompl::base::State* wrapped_state, double& dist,
+                                                      bool verbose) const
+{
+  assert(wrapped_state != nullptr);
+  // Unwrap the state from a ConstrainedStateSpace::StateType
+  auto state = wrapped_state->as<ompl::base::ConstrainedStateSpace::StateType>()->getState();
+  auto* cache = const_cast<ob::State*>(state)->as<ModelBasedStateSpace::StateType>();
+
+  // Use cached validity and distance if they are available
+  if (cache->isValidityKnown() && cache->isGoalDistanceKnown())
   {
-    const_cast<ob::State*>(state)->as<ModelBasedStateSpace::StateType>()->markInvalid();
-    return false;
+    dist = cache->distance;
+    return cache->isMarkedValid();
   }
 
-  // check feasibility
-  if (!planning_context_->getPlanningScene()->isStateFeasible(*robot_state, verbose))
+  // do not use the unwrapped state here, as satisfiesBounds and copyToRobotState expect a state of type
+  // ConstrainedStateSpace::StateType
+  moveit::core::RobotState* robot_state = tss_.getStateStorage();
+  if (!checkConstraints(wrapped_state, cache, *robot_state, dist, verbose))
   {
-    const_cast<ob::State*>(state)->as<ModelBasedStateSpace::StateType>()->markInvalid();
+    cache->markInvalid(dist);
     return false;
   }
 
   // check collision avoidance
   collision_detection::CollisionResult res;
   planning_context_->getPlanningScene()->checkCollision(
-      verbose ? collision_request_simple_verbose_ : collision_request_simple_, res, *robot_state);
-  if (!res.collision)
-  {
-    const_cast<ob::State*>(state)->as<ModelBasedStateSpace::StateType>()->markValid();
-  }
+      verbose ? collision_request_with_distance_verbose_ : collision_request_with_distance_, res, *robot_state);
+  dist = res.distance;
+  if (res.collision)
+    cache->markInvalid(dist);
   else
-  {
-    const_cast<ob::State*>(state)->as<ModelBasedStateSpace::StateType>()->markInvalid();
-  }
+    cache->markValid(dist);
   return !res.collision;
 }
 
-bool ConstrainedPlanningStateValidityChecker::isValid(const ompl::base::State* wrapped_state, double& dist,
-                                                      bool verbose) const
+/*******************************************
+ * Lazy collision checking
+ * *****************************************/
+bool LazyCollisionStateValidityChecker::isValid(const ompl::base::State* state, bool verbose) const
 {
-  assert(wrapped_state != nullptr);
-  // Unwrap the state from a ConstrainedStateSpace::StateType
-  auto state = wrapped_state->as<ompl::base::ConstrainedStateSpace::StateType>()->getState();
+  assert(state != nullptr);
+  auto* cache = const_cast<ob::State*>(state)->as<ModelBasedStateSpace::StateType>();
+  if (cache->isValidityKnown())
+  {
+    return cache->isMarkedValid();
+  }
 
-  // Use cached validity and distance if they are available
-  if (state->as<ModelBasedStateSpace::StateType>()->isValidityKnown() &&
-      state->as<ModelBasedStateSpace::StateType>()->isGoalDistanceKnown())
+  // the collision check is left to LazyCollisionMotionValidator, so success is not cached as validity
+  moveit::core::RobotState* robot_state = tss_.getStateStorage();
+  double dist;
+  if (!checkConstraints(state, cache, *robot_state, dist, verbose))
   {
-    dist = state->as<ModelBasedStateSpace::StateType>()->distance;
-    return state->as<ModelBasedStateSpace::StateType>()->isMarkedValid();
+    cache->markInvalid();
+    return false;
   }
+  return true;
+}
 
-  // do not use the unwrapped state here, as satisfiesBounds expects a state of type ConstrainedStateSpace::StateType
-  if (!si_->satisfiesBounds(wrapped_state))  // si_ = ompl::base::SpaceInformation
+bool LazyCollisionMotionValidator::checkMotion(const ompl::base::State* s1, const ompl::base::State* s2) const
+{
+  if (!checker_->isFullyValid(s2))
   {
-    RCLCPP_DEBUG(LOGGER, "State outside bounds");
-    const_cast<ob::State*>(state)->as<ModelBasedStateSpace::StateType>()->markInvalid(0.0);
+    invalid_++;
     return false;
   }
 
-  moveit::core::RobotState* robot_state = tss_.getStateStorage();
+  bool result = true;
+  const ompl::base::StateSpacePtr& space = si_->getStateSpace();
+  const int nd = space->validSegmentCount(s1, s2);
+  if (nd > 1)
+  {
+    // check the interpolated states by bisection, which tends to find collisions early
+    ompl::base::State* test = si_->allocState();
+    std::queue<std::pair<int, int>> intervals;
+    intervals.emplace(1, nd - 1);
+    while (!intervals.empty())
+    {
+      const auto [first, last] = intervals.front();
+      intervals.pop();
+      const int mid = (first + last) / 2;
+      space->interpolate(s1, s2, static_cast<double>(mid) / nd, test);
+      if (!checker_->isFullyValid(test))
+      {
+        result = false;
+        break;
+      }
+      if (first < mid)
+        intervals.emplace(first, mid - 1);
+      if (last > mid)
+        intervals.emplace(mid + 1, last);
+    }
+    si_->freeState(test);
+  }
 
-  // do not use the unwrapped state here, as copyToRobotState expects a state of type ConstrainedStateSpace::StateType
-  planning_context_->getOMPLStateSpace()->copyToRobotState(*robot_state, wrapped_state);
+  if (result)
+    valid_++;
+  else
+    invalid_++;
+  return result;
+}
 
-  // check path constraints
-  const kinematic_constraints::KinematicConstraintSetPtr& kset = planning_context_->getPathConstraints();
-  if (kset && !kset->decide(*robot_state, verbose).satisfied)
+bool LazyCollisionMotionValidator::checkMotion(const ompl::base::State* s1, const ompl::base::State* s2,
+                                               std::pair<ompl::base::State*, double>& last_valid) const
+{
+  bool result = true;
+  const ompl::base::StateSpacePtr& space = si_->getStateSpace();
+  const int nd = space->validSegmentCount(s1, s2);
+  if (nd > 1)
   {
-    const_cast<ob::State*>(state)->as<ModelBasedStateSpace::StateType>()->markInvalid();
-    return false;
+    ompl::base::State* test = si_->allocState();
+    for (int j = 1; j < nd; ++j)
+    {
+      space->interpolate(s1, s2, static_cast<double>(j) / nd, test);
+      if (!checker_->isFullyValid(test))
+      {
+        last_valid.second = static_cast<double>(j - 1) / nd;
+        result = false;
+        break;
+      }
+    }
+    si_->freeState(test);
   }
 
-  // check feasibility
-  if (!planning_context_->getPlanningScene()->isStateFeasible(*robot_state, verbose))
+  if (result && !checker_->isFullyValid(s2))
   {
-    dist = 0.0;
-    return false;
+    last_valid.second = static_cast<double>(nd - 1) / nd;
+    result = false;
   }
 
-  // check collision avoidance
-  collision_detection::CollisionResult res;
-  planning_context_->getPlanningScene()->checkCollision(
-      verbose ? collision_request_with_distance_verbose_ : collision_request_with_distance_, res, *robot_state);
-  dist = res.distance;
-  return !res.collision;
+  if (result)
+  {
+    valid_++;
+  }
+  else
+  {
+    if (last_valid.first)
+      space->interpolate(s1, s2, last_valid.second, last_valid.first);
+    invalid_++;
+  }
+  return result;
 }
 }  // namespace ompl_interface
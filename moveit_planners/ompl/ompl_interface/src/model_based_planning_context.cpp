@@ -34,6 +34,10 @@
 
 /* Author: Ioan Sucan */
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
 #include <boost/algorithm/string/trim.hpp>
 #include <boost/algorithm/string/split.hpp>
 #include <boost/algorithm/string/replace.hpp>
@@ -46,15 +50,22 @@
 #include <moveit/ompl_interface/detail/goal_union.h>
 #include <moveit/ompl_interface/detail/projection_evaluators.h>
 #include <moveit/ompl_interface/detail/constraints_library.h>
+#include <moveit/ompl_interface/detail/lazy_roadmap_prm.h>
 
 #include <moveit/kinematic_constraints/utils.h>
+#include <moveit/robot_model/aabb.h>
+
+#include <geometric_shapes/shape_operations.h>
 
+#include <moveit/utils/allocation_tracking.h>
 #include <moveit/utils/lexical_casts.h>
+#include <moveit/utils/tracing.h>
 
 #include <ompl/config.h>
 #include <ompl/base/samplers/UniformValidStateSampler.h>
 #include <ompl/base/goals/GoalLazySamples.h>
 #include <ompl/tools/config/SelfConfig.h>
+#include <ompl/geometric/PathSimplifier.h>
 #include <ompl/base/spaces/SE3StateSpace.h>
 #include <ompl/datastructures/PDF.h>
 #include <ompl/base/terminationconditions/IterationTerminationCondition.h>
@@ -76,8 +87,10 @@ ompl_interface::ModelBasedPlanningContext::ModelBasedPlanningContext(const std::
                                                                      const ModelBasedPlanningContextSpecification& spec)
   : planning_interface::PlanningContext(name, spec.state_space_->getJointModelGroup()->getName())
   , spec_(spec)
-  , complete_initial_robot_state_(spec.state_space_->getRobotModel())
+  , robot_state_pool_(std::make_shared<moveit::core::RobotStatePool>(spec.state_space_->getRobotModel()))
+  , complete_initial_robot_state_(spec.state_space_->getRobotModel(), robot_state_pool_)
   , ompl_simple_setup_(spec.ompl_simple_setup_)
+  , experience_setup_(std::dynamic_pointer_cast<ot::ExperienceSetup>(spec.ompl_simple_setup_))
   , ompl_benchmark_(*ompl_simple_setup_)
   , ompl_parallel_plan_(ompl_simple_setup_->getProblemDefinition())
   , ptc_(nullptr)
@@ -90,9 +103,13 @@ ompl_interface::ModelBasedPlanningContext::ModelBasedPlanningContext(const std::
   , max_solution_segment_length_(0.0)
   , minimum_waypoint_count_(0)
   , multi_query_planning_enabled_(false)  // maintain "old" behavior by default
+  , roadmap_edge_padding_(0.05)
   , simplify_solutions_(true)
+  , simplification_count_(1)
   , interpolate_(true)
+  , verify_interpolation_(false)
   , hybridize_(true)
+  , portfolio_best_solution_(false)
 {
   complete_initial_robot_state_.setToDefaultValues();  // avoid uninitialized memory
   complete_initial_robot_state_.update();
@@ -127,7 +144,20 @@ void ompl_interface::ModelBasedPlanningContext::configure(const rclcpp::Node::Sh
     ompl::base::ScopedState<> ompl_start_state(spec_.state_space_);
     spec_.state_space_->copyToOMPLState(ompl_start_state.get(), getCompleteInitialRobotState());
     ompl_simple_setup_->setStartState(ompl_start_state);
-    ompl_simple_setup_->setStateValidityChecker(std::make_shared<StateValidityChecker>(this));
+
+    // lazy planners may defer collision checks until edges are evaluated, which the motion validator then performs
+    auto it = spec_.config_.find("lazy_collision_checking");
+    if (it != spec_.config_.end() && boost::lexical_cast<bool>(it->second))
+    {
+      auto checker = std::make_shared<LazyCollisionStateValidityChecker>(this);
+      ompl_simple_setup_->setStateValidityChecker(checker);
+      const ob::SpaceInformationPtr& si = ompl_simple_setup_->getSpaceInformation();
+      si->setMotionValidator(std::make_shared<LazyCollisionMotionValidator>(si, checker));
+    }
+    else
+    {
+      ompl_simple_setup_->setStateValidityChecker(std::make_shared<StateValidityChecker>(this));
+    }
   }
 
   if (path_constraints_ && constraints_library_)
@@ -215,6 +245,21 @@ ompl_interface::ModelBasedPlanningContext::getProjectionEvaluator(const std::str
       return std::make_shared<ProjectionEvaluatorJointValue>(this, j);
     }
   }
+  else if (peval.find("pca(") == 0 && peval[peval.length() - 1] == ')')
+  {
+    // pca(<samples file>[, <dimension>]), where the samples are states of past solutions
+    std::string args = peval.substr(4, peval.length() - 5);
+    std::string path = boost::trim_copy(args.substr(0, args.find(',')));
+    unsigned int dimension = 2;
+    if (args.find(',') != std::string::npos)
+      dimension = std::stoul(args.substr(args.find(',') + 1));
+    std::vector<Eigen::VectorXd> samples;
+    if (ProjectionEvaluatorPCA::loadSamples(path, getJointModelGroup()->getVariableCount(), samples))
+      return std::make_shared<ProjectionEvaluatorPCA>(this, samples, dimension);
+    else
+      RCLCPP_ERROR(LOGGER, "%s: Unable to read sample states of group '%s' for PCA projection from '%s'",
+                   name_.c_str(), getGroupName().c_str(), path.c_str());
+  }
   else
   {
     RCLCPP_ERROR(LOGGER, "Unable to allocate projection evaluator based on description: '%s'", peval.c_str());
@@ -304,6 +349,16 @@ void ompl_interface::ModelBasedPlanningContext::useConfig()
     cfg["longest_valid_segment_fraction"] = moveit::core::toString(longest_valid_segment_fraction_final);
   }
 
+  // the collision result cache is set up by the state validity checker, not by OMPL
+  cfg.erase("collision_cache_size");
+  cfg.erase("collision_cache_resolution");
+  cfg.erase("context_pool_size");
+  cfg.erase("lazy_collision_checking");
+  cfg.erase("goal_sampling_threads");
+  cfg.erase("goal_sampling_queue_size");
+  cfg.erase("experience");
+  cfg.erase("experience_database_path");
+
   // set the projection evaluator
   it = cfg.find("projection_evaluator");
   if (it != cfg.end())
@@ -364,6 +419,14 @@ void ompl_interface::ModelBasedPlanningContext::useConfig()
     multi_query_planning_enabled_ = boost::lexical_cast<bool>(it->second);
   }
 
+  // padding of the edge bounding boxes used to re-validate multi-query roadmaps after world objects changed
+  it = cfg.find("roadmap_edge_padding");
+  if (it != cfg.end())
+  {
+    roadmap_edge_padding_ = moveit::core::toDouble(it->second);
+    cfg.erase(it);
+  }
+
   // check whether the path returned by the planner should be interpolated
   it = cfg.find("interpolate");
   if (it != cfg.end())
@@ -372,6 +435,22 @@ void ompl_interface::ModelBasedPlanningContext::useConfig()
     cfg.erase(it);
   }
 
+  // number of solutions that are simplified concurrently
+  it = cfg.find("simplification_count");
+  if (it != cfg.end())
+  {
+    simplification_count_ = std::max(1ul, std::stoul(it->second));
+    cfg.erase(it);
+  }
+
+  // check whether the states of the interpolated path should be validated again
+  it = cfg.find("verify_interpolation");
+  if (it != cfg.end())
+  {
+    verify_interpolation_ = boost::lexical_cast<bool>(it->second);
+    cfg.erase(it);
+  }
+
   // check whether solution paths from parallel planning should be hybridized
   it = cfg.find("hybridize");
   if (it != cfg.end())
@@ -380,11 +459,43 @@ void ompl_interface::ModelBasedPlanningContext::useConfig()
     cfg.erase(it);
   }
 
+  // race the planners of other configurations, each configured with its own parameters
+  portfolio_allocators_.clear();
+  const bool is_portfolio = cfg.erase("portfolio") > 0;
+  if (is_portfolio)
+  {
+    for (const std::pair<std::string, std::map<std::string, std::string>>& member : spec_.portfolio_)
+    {
+      auto type = member.second.find("type");
+      if (type == member.second.end())
+      {
+        RCLCPP_WARN(LOGGER, "%s: Portfolio configuration '%s' does not specify a 'type', skipping it", name_.c_str(),
+                    member.first.c_str());
+        continue;
+      }
+      ModelBasedPlanningContextSpecification member_spec = spec_;
+      member_spec.config_ = member.second;
+      member_spec.portfolio_.clear();
+      portfolio_allocators_.push_back(
+          [planner_name = getGroupName() + "/" + member.first, member_spec = std::move(member_spec),
+           allocator = spec_.planner_selector_(type->second)](const ompl::base::SpaceInformationPtr& si) {
+            return allocator(si, planner_name, member_spec);
+          });
+    }
+    RCLCPP_INFO(LOGGER, "Planner configuration '%s' races %zu planners", name_.c_str(), portfolio_allocators_.size());
+  }
+  it = cfg.find("portfolio_best_solution");
+  if (it != cfg.end())
+  {
+    portfolio_best_solution_ = boost::lexical_cast<bool>(it->second);
+    cfg.erase(it);
+  }
+
   // remove the 'type' parameter; the rest are parameters for the planner itself
   it = cfg.find("type");
   if (it == cfg.end())
   {
-    if (name_ != getGroupName())
+    if (name_ != getGroupName() && !is_portfolio)
       RCLCPP_WARN(LOGGER, "%s: Attribute 'type' not specified in planner configuration", name_.c_str());
   }
   else
@@ -429,16 +540,70 @@ void ompl_interface::ModelBasedPlanningContext::setPlanningVolume(const moveit_m
 
 void ompl_interface::ModelBasedPlanningContext::simplifySolution(double timeout)
 {
+  MOVEIT_TRACE_SCOPE("ompl.simplify", this);
   ompl::time::point start = ompl::time::now();
   ob::PlannerTerminationCondition ptc = constructPlannerTerminationCondition(timeout, start);
   registerTerminationCondition(ptc);
-  ompl_simple_setup_->simplifySolution(ptc);
-  last_simplify_time_ = ompl_simple_setup_->getLastSimplificationTime();
+
+  // solutions are ordered best first; approximate ones only compete with each other
+  std::vector<og::PathGeometric> paths;
+  if (simplification_count_ > 1)
+  {
+    const std::vector<ob::PlannerSolution> solutions = ompl_simple_setup_->getProblemDefinition()->getSolutions();
+    for (const ob::PlannerSolution& solution : solutions)
+    {
+      if (paths.size() >= simplification_count_ || solution.approximate_ != solutions.front().approximate_)
+        break;
+      paths.push_back(*std::static_pointer_cast<og::PathGeometric>(solution.path_));
+    }
+  }
+
+  if (paths.size() > 1)
+  {
+    simplifySolutionsInParallel(std::move(paths), ptc);
+    last_simplify_time_ = ompl::time::seconds(ompl::time::now() - start);
+  }
+  else
+  {
+    ompl_simple_setup_->simplifySolution(ptc);
+    last_simplify_time_ = ompl_simple_setup_->getLastSimplificationTime();
+  }
   unregisterTerminationCondition();
 }
 
-void ompl_interface::ModelBasedPlanningContext::interpolateSolution()
+void ompl_interface::ModelBasedPlanningContext::simplifySolutionsInParallel(std::vector<og::PathGeometric> paths,
+                                                                           const ob::PlannerTerminationCondition& ptc)
 {
+  const ob::SpaceInformationPtr& si = ompl_simple_setup_->getSpaceInformation();
+  const ob::ProblemDefinitionPtr& pdef = ompl_simple_setup_->getProblemDefinition();
+
+  // each thread uses its own simplifier, as they are not thread-safe
+  std::atomic<std::size_t> next(0);
+  auto simplify = [&] {
+    og::PathSimplifier simplifier(si, pdef->getGoal(), pdef->getOptimizationObjective());
+    for (std::size_t i = next++; i < paths.size(); i = next++)
+      simplifier.simplify(paths[i], ptc);
+  };
+  const std::size_t thread_count = std::min<std::size_t>(std::max(1u, max_planning_threads_), paths.size());
+  std::vector<std::thread> threads;
+  for (std::size_t i = 1; i < thread_count; ++i)
+    threads.emplace_back(simplify);
+  simplify();
+  for (std::thread& thread : threads)
+    thread.join();
+
+  auto shortest =
+      std::min_element(paths.begin(), paths.end(), [](const og::PathGeometric& a, const og::PathGeometric& b) {
+        return a.length() < b.length();
+      });
+  RCLCPP_DEBUG(LOGGER, "%s: Simplified %zu solutions using %zu threads, keeping one of length %f", name_.c_str(),
+               paths.size(), thread_count, shortest->length());
+  ompl_simple_setup_->getSolutionPath() = *shortest;
+}
+
+bool ompl_interface::ModelBasedPlanningContext::interpolateSolution()
+{
+  MOVEIT_TRACE_SCOPE("ompl.interpolate", this);
   if (ompl_simple_setup_->haveSolutionPath())
   {
     og::PathGeometric& pg = ompl_simple_setup_->getSolutionPath();
@@ -462,17 +627,53 @@ void ompl_interface::ModelBasedPlanningContext::interpolateSolution()
       // Interpolate the path to have as the exact states that are checked when validating motions.
       pg.interpolate();
     }
+
+    if (verify_interpolation_ && !verifySolutionStates(pg))
+    {
+      RCLCPP_ERROR(LOGGER, "%s: The interpolated solution contains invalid states", name_.c_str());
+      return false;
+    }
   }
+  return true;
+}
+
+bool ompl_interface::ModelBasedPlanningContext::verifySolutionStates(const og::PathGeometric& path) const
+{
+  // the lazy validity checker leaves collision checking to motion validation, which is bypassed here
+  const ob::StateValidityCheckerPtr& checker = ompl_simple_setup_->getStateValidityChecker();
+  auto lazy_checker = std::dynamic_pointer_cast<const LazyCollisionStateValidityChecker>(checker);
+  const std::vector<ob::State*>& states = path.getStates();
+
+  // states are handed out one at a time, and all threads stop at the first invalid one
+  std::atomic<std::size_t> next(0);
+  std::atomic<bool> valid(true);
+  auto verify = [&] {
+    for (std::size_t i = next++; i < states.size() && valid; i = next++)
+    {
+      if (lazy_checker ? !lazy_checker->isFullyValid(states[i]) : !checker->isValid(states[i]))
+        valid = false;
+    }
+  };
+  const std::size_t thread_count = std::min<std::size_t>(std::max(1u, max_planning_threads_), states.size());
+  std::vector<std::thread> threads;
+  for (std::size_t i = 1; i < thread_count; ++i)
+    threads.emplace_back(verify);
+  verify();
+  for (std::thread& thread : threads)
+    thread.join();
+  return valid;
 }
 
 void ompl_interface::ModelBasedPlanningContext::convertPath(const ompl::geometric::PathGeometric& pg,
                                                             robot_trajectory::RobotTrajectory& traj) const
 {
-  moveit::core::RobotState ks = complete_initial_robot_state_;
+  // each waypoint is built in place from the initial state: only the group's variables (a single memcpy for
+  // contiguous groups) and the transforms below the group are updated, and no intermediate state is copied
   for (std::size_t i = 0; i < pg.getStateCount(); ++i)
   {
-    spec_.state_space_->copyToRobotState(ks, pg.getState(i));
-    traj.addSuffixWayPoint(ks, 0.0);
+    auto waypoint = std::make_shared<moveit::core::RobotState>(complete_initial_robot_state_);
+    spec_.state_space_->copyToRobotState(*waypoint, pg.getState(i));
+    traj.addSuffixWayPoint(waypoint, 0.0);
   }
 }
 
@@ -494,6 +695,23 @@ void ompl_interface::ModelBasedPlanningContext::setVerboseStateValidityChecks(bo
   }
 }
 
+kinematics::KinematicsBaseConstPtr
+ompl_interface::ModelBasedPlanningContext::getGoalSamplingSolver(const moveit::core::JointModelGroup* jmg,
+                                                                 std::size_t index) const
+{
+  std::lock_guard<std::mutex> slock(goal_sampling_solvers_lock_);
+  std::vector<kinematics::KinematicsBaseConstPtr>& solvers = goal_sampling_solvers_[jmg];
+  const moveit::core::SolverAllocatorFn& allocator = jmg->getGroupKinematics().first.allocator_;
+  while (solvers.size() <= index && allocator)
+  {
+    kinematics::KinematicsBaseConstPtr solver = allocator(jmg);
+    if (!solver)
+      break;
+    solvers.push_back(solver);
+  }
+  return index < solvers.size() ? solvers[index] : kinematics::KinematicsBaseConstPtr();
+}
+
 ompl::base::GoalPtr ompl_interface::ModelBasedPlanningContext::constructGoal()
 {
   // ******************* set up the goal representation, based on goal constraints
@@ -562,72 +780,6 @@ ompl_interface::ModelBasedPlanningContext::constructPlannerTerminationCondition(
       RCLCPP_ERROR(LOGGER, "Missing argument to Iteration termination condition");
     }
   }
-// TODO: remove when ROS Melodic and older are no longer supported
-#if OMPL_VERSION_VALUE >= 1005000
-  // Terminate if the cost has converged or a timeout occurs.
-  // Only useful for anytime/optimizing planners.
-  else if (termination_and_params[0] == "CostConvergence")
-  {
-    std::size_t solutions_window = 10u;
-    double epsilon = 0.1;
-    if (termination_and_params.size() > 1)
-    {
-      solutions_window = std::stoul(termination_and_params[1]);
-      if (termination_and_params.size() > 2)
-      {
-        epsilon = moveit::core::toDouble(termination_and_params[2]);
-      }
-    }
-    return ob::plannerOrTerminationCondition(
-        ob::timedPlannerTerminationCondition(timeout - ompl::time::seconds(ompl::time::now() - start)),
-        ob::CostConvergenceTerminationCondition(ompl_simple_setup_->getProblemDefinition(), solutions_window, epsilon));
-  }
-#endif
-  // Terminate as soon as an exact solution is found or a timeout occurs.
-  // This modifies the behavior of anytime/optimizing planners to terminate upon discovering
-  // the first feasible solution.
-  else if (termination_and_params[0] == "ExactSolution")
-  {
-    return ob::plannerOrTerminationCondition(
-        ob::timedPlannerTerminationCondition(timeout - ompl::time::seconds(ompl::time::now() - start)),
-        ob::exactSolnPlannerTerminationCondition(ompl_simple_setup_->getProblemDefinition()));
-  }
-  else
-  {
-    RCLCPP_ERROR(LOGGER, "Unknown planner termination condition");
-  }
-  // return a planner termination condition to suppress compiler warning
-  return ob::plannerAlwaysTerminatingCondition();
-}
-
-void ompl_interface::ModelBasedPlanningContext::setCompleteInitialState(
-    const moveit::core::RobotState& complete_initial_robot_state)
-{
-  complete_initial_robot_state_ = complete_initial_robot_state;
-  complete_initial_robot_state_.update();
-}
-
-void ompl_interface::ModelBasedPlanningContext::clear()
-{
-  if (!multi_query_planning_enabled_)
-  {
-    ompl_simple_setup_->clear();
-  }
-// TODO: remove when ROS Melodic and older are no longer supported
-#if OMPL_VERSION_VALUE >= 1005000
-  else
-  {
-    // For LazyPRM and LazyPRMstar we assume that the environment *could* have changed
-    // This means that we need to reset the validity flags for every node and edge in
-    // the roadmap. For PRM and PRMstar we assume that the environment is static. If
-    // this is not the case, then multi-query planning should not be enabled.
-    auto planner = dynamic_cast<ompl::geometric::LazyPRM*>(ompl_simple_setup_->getPlanner().get());
-    if (planner != nullptr)
-    {
-      planner->clearValidity();
-    }
-  }
-#endif
   ompl_simple_setup_->clearStartStates();
   ompl_simple_setup_->setGoal(ob::GoalPtr());
   ompl_simple_setup_->setStateValidityChecker(ob::StateValidityCheckerPtr());
@@ -726,6 +878,147 @@ void ompl_interface::ModelBasedPlanningContext::stopSampling()
   }
 }
 
+void ompl_interface::ModelBasedPlanningContext::updateRoadmapValidity()
+{
+  // PRM and PRMstar assume that the environment is static. If this is not the case, then multi-query planning should
+  // not be enabled. LazyPRM and LazyPRMstar check the validity of their roadmap lazily, so it can be reset whenever the
+  // environment *could* have changed.
+  auto lazy_planner = dynamic_cast<og::LazyPRM*>(ompl_simple_setup_->getPlanner().get());
+  if (lazy_planner == nullptr)
+  {
+    return;
+  }
+  auto planner = dynamic_cast<LazyRoadmapPRM*>(lazy_planner);
+  if (planner == nullptr || (path_constraints_ && !path_constraints_->empty()))
+  {
+    lazy_planner->clearValidity();
+    if (planner != nullptr)
+    {
+      planner->setValidatedEnvironment(std::nullopt);
+    }
+    return;
+  }
+
+  const planning_scene::PlanningSceneConstPtr& scene = getPlanningScene();
+  LazyRoadmapPRM::ValidatedEnvironment environment;
+  environment.world_version = scene->getWorldVersion();
+  environment.acm_version = scene->getAllowedCollisionMatrixVersion();
+  environment.transforms_version = scene->getTransformsVersion();
+  environment.attached_bodies_version = scene->getAttachedBodiesVersion();
+  const moveit::core::JointModelGroup* jmg = getJointModelGroup();
+  std::vector<bool> planned(getRobotModel()->getVariableCount(), false);
+  for (int index : jmg->getVariableIndexList())
+  {
+    planned[index] = true;
+  }
+  for (std::size_t i = 0; i < planned.size(); ++i)
+  {
+    if (!planned[i])
+    {
+      environment.fixed_positions.push_back(complete_initial_robot_state_.getVariablePosition(i));
+    }
+  }
+  std::vector<const moveit::core::AttachedBody*> attached_bodies;
+  complete_initial_robot_state_.getAttachedBodies(attached_bodies);
+  for (const moveit::core::AttachedBody* body : attached_bodies)
+  {
+    for (const shapes::ShapeConstPtr& shape : body->getShapes())
+    {
+      environment.attached_shapes.push_back(shape.get());
+    }
+  }
+
+  // Only changes of world objects are handled selectively, any other change resets the whole roadmap
+  const std::optional<LazyRoadmapPRM::ValidatedEnvironment>& validated = planner->getValidatedEnvironment();
+  std::set<std::string> changed_ids;
+  if (!validated || validated->acm_version != environment.acm_version ||
+      validated->transforms_version != environment.transforms_version ||
+      validated->attached_bodies_version != environment.attached_bodies_version ||
+      validated->fixed_positions != environment.fixed_positions ||
+      validated->attached_shapes != environment.attached_shapes ||
+      !scene->getChangedObjectIds(validated->world_version, changed_ids))
+  {
+    planner->clearValidity();
+    planner->setValidatedEnvironment(std::move(environment));
+    return;
+  }
+
+  // Removed objects can only make invalid states valid, and invalid vertices and edges are no longer in the roadmap
+  std::vector<moveit::core::AABB> obstacles;
+  for (const std::string& id : changed_ids)
+  {
+    const collision_detection::World::ObjectConstPtr object = scene->getWorld()->getObject(id);
+    if (!object)
+    {
+      continue;
+    }
+    moveit::core::AABB box;
+    for (std::size_t i = 0; i < object->shapes_.size(); ++i)
+    {
+      box.extendWithTransformedBox(object->global_shape_poses_[i],
+                                   shapes::computeShapeExtents(object->shapes_[i].get()));
+    }
+    obstacles.push_back(box);
+  }
+  if (!obstacles.empty())
+  {
+    RCLCPP_DEBUG(LOGGER, "%s: Re-validating the roadmap near %zu changed objects", name_.c_str(), obstacles.size());
+
+    // The bounding boxes of the moving links and their attached bodies, per roadmap vertex
+    const std::vector<const moveit::core::LinkModel*>& links = jmg->getUpdatedLinkModelsWithGeometry();
+    moveit::core::RobotState state(complete_initial_robot_state_);
+    const auto vertex_boxes = [&](const ob::State* vertex_state) {
+      getOMPLStateSpace()->copyToRobotState(state, vertex_state);
+      std::vector<moveit::core::AABB> boxes(links.size());
+      for (std::size_t i = 0; i < links.size(); ++i)
+      {
+        boxes[i].extendWithTransformedBox(state.getGlobalLinkTransform(links[i]) *
+                                              Eigen::Translation3d(links[i]->getCenteredBoundingBoxOffset()),
+                                          links[i]->getShapeExtentsAtOrigin());
+      }
+      std::vector<const moveit::core::AttachedBody*> moving_bodies;
+      state.getAttachedBodies(moving_bodies, jmg);
+      for (const moveit::core::AttachedBody* body : moving_bodies)
+      {
+        moveit::core::AABB& box = boxes.emplace_back();
+        for (std::size_t i = 0; i < body->getShapes().size(); ++i)
+        {
+          box.extendWithTransformedBox(body->getGlobalCollisionBodyTransforms()[i],
+                                       shapes::computeShapeExtents(body->getShapes()[i].get()));
+        }
+      }
+      return boxes;
+    };
+    const auto intersects_obstacle = [&](const moveit::core::AABB& box) {
+      return std::any_of(obstacles.begin(), obstacles.end(),
+                         [&](const moveit::core::AABB& obstacle) { return obstacle.intersects(box); });
+    };
+
+    // Edges are approximated by the union of the boxes at both end states, enlarged by roadmap_edge_padding
+    const Eigen::Vector3d padding = Eigen::Vector3d::Constant(roadmap_edge_padding_);
+    planner->clearValidity(
+        vertex_boxes,
+        [&](const std::vector<moveit::core::AABB>& boxes) {
+          return std::any_of(boxes.begin(), boxes.end(), intersects_obstacle);
+        },
+        [&](const std::vector<moveit::core::AABB>& source, const std::vector<moveit::core::AABB>& target) {
+          for (std::size_t i = 0; i < source.size() && i < target.size(); ++i)
+          {
+            moveit::core::AABB box = source[i];
+            box.extend(target[i]);
+            box.min() -= padding;
+            box.max() += padding;
+            if (intersects_obstacle(box))
+            {
+              return true;
+            }
+          }
+          return source.size() != target.size();
+        });
+  }
+  planner->setValidatedEnvironment(std::move(environment));
+}
+
 void ompl_interface::ModelBasedPlanningContext::preSolve()
 {
   // clear previously computed solutions
@@ -735,6 +1028,10 @@ void ompl_interface::ModelBasedPlanningContext::preSolve()
   {
     planner->clear();
   }
+  else if (planner)
+  {
+    updateRoadmapValidity();
+  }
   startSampling();
   ompl_simple_setup_->getSpaceInformation()->getMotionValidator()->resetMotionCounter();
 }
@@ -751,6 +1048,18 @@ void ompl_interface::ModelBasedPlanningContext::postSolve()
     RCLCPP_WARN(LOGGER, "Computed solution is approximate");
   }
 
+  // add the solution to the experience database and store it, so other contexts and robots can recall it
+  if (experience_setup_)
+  {
+    experience_setup_->doPostProcessing();
+    if (spec_.config_.count("experience_database_path") && !experience_setup_->saveIfChanged())
+    {
+      RCLCPP_WARN(LOGGER, "%s: Unable to store the experience database", name_.c_str());
+    }
+    RCLCPP_DEBUG(LOGGER, "%s: The experience database holds %zu experiences", name_.c_str(),
+                 experience_setup_->getExperiencesCount());
+  }
+
   // Debug OMPL setup and solution
   std::stringstream debug_out;
   ompl_simple_setup_->print(debug_out);
@@ -759,18 +1068,35 @@ void ompl_interface::ModelBasedPlanningContext::postSolve()
 
 bool ompl_interface::ModelBasedPlanningContext::solve(planning_interface::MotionPlanResponse& res)
 {
+  const moveit::memory::ScopedAllocationTracker plan_allocations;
   if (solve(request_.allowed_planning_time, request_.num_planning_attempts))
   {
     double ptime = getLastPlanTime();
+    res.stage_descriptions_.emplace_back("plan");
+    res.stage_times_.push_back(ptime);
+    res.stage_allocations_.push_back(plan_allocations.getAllocations());
     if (simplify_solutions_)
     {
+      const moveit::memory::ScopedAllocationTracker simplify_allocations;
       simplifySolution(request_.allowed_planning_time - ptime);
       ptime += getLastSimplifyTime();
+      res.stage_descriptions_.emplace_back("simplify");
+      res.stage_times_.push_back(getLastSimplifyTime());
+      res.stage_allocations_.push_back(simplify_allocations.getAllocations());
     }
 
     if (interpolate_)
     {
-      interpolateSolution();
+      const moveit::memory::ScopedAllocationTracker interpolate_allocations;
+      ompl::time::point start_interpolate = ompl::time::now();
+      if (!interpolateSolution())
+      {
+        res.error_code_.val = moveit_msgs::msg::MoveItErrorCodes::INVALID_MOTION_PLAN;
+        return false;
+      }
+      res.stage_descriptions_.emplace_back("interpolate");
+      res.stage_times_.push_back(ompl::time::seconds(ompl::time::now() - start_interpolate));
+      res.stage_allocations_.push_back(interpolate_allocations.getAllocations());
     }
 
     // fill the response
@@ -818,7 +1144,11 @@ bool ompl_interface::ModelBasedPlanningContext::solve(planning_interface::Motion
     if (interpolate_)
     {
       ompl::time::point start_interpolate = ompl::time::now();
-      interpolateSolution();
+      if (!interpolateSolution())
+      {
+        res.error_code_.val = moveit_msgs::msg::MoveItErrorCodes::INVALID_MOTION_PLAN;
+        return false;
+      }
       res.processing_time_.push_back(ompl::time::seconds(ompl::time::now() - start_interpolate));
       res.description_.emplace_back("interpolate");
       res.trajectory_.resize(res.trajectory_.size() + 1);
@@ -841,12 +1171,31 @@ bool ompl_interface::ModelBasedPlanningContext::solve(planning_interface::Motion
 
 bool ompl_interface::ModelBasedPlanningContext::solve(double timeout, unsigned int count)
 {
+  MOVEIT_TRACE_SCOPE("ompl.plan", this);
   ompl::time::point start = ompl::time::now();
   preSolve();
 
   bool result = false;
-  if (count <= 1 || multi_query_planning_enabled_)  // multi-query planners should always run in single instances
+  if (!portfolio_allocators_.empty())
+  {
+    RCLCPP_DEBUG(LOGGER, "%s: Racing %zu planners...", name_.c_str(), portfolio_allocators_.size());
+    ompl_parallel_plan_.clearHybridizationPaths();
+    ompl_parallel_plan_.clearPlanners();
+    for (const ob::PlannerAllocator& allocator : portfolio_allocators_)
+      ompl_parallel_plan_.addPlannerAllocator(allocator);
+
+    // ParallelPlan stops all planners once the requested number of solutions is found
+    const std::size_t n = portfolio_allocators_.size();
+    ob::PlannerTerminationCondition ptc = constructPlannerTerminationCondition(timeout, start);
+    registerTerminationCondition(ptc);
+    result = ompl_parallel_plan_.solve(ptc, portfolio_best_solution_ ? n : 1, n, hybridize_) ==
+             ompl::base::PlannerStatus::EXACT_SOLUTION;
+    last_plan_time_ = ompl::time::seconds(ompl::time::now() - start);
+    unregisterTerminationCondition();
+  }
+  else if (count <= 1 || multi_query_planning_enabled_ || experience_setup_)
   {
+    // multi-query and experience-based planners should always run in single instances
     RCLCPP_DEBUG(LOGGER, "%s: Solving the planning problem once...", name_.c_str());
     ob::PlannerTerminationCondition ptc = constructPlannerTerminationCondition(timeout, start);
     registerTerminationCondition(ptc);
@@ -175,7 +175,8 @@ void OMPLInterface::loadPlannerConfigurations()
       { "projection_evaluator", rclcpp::ParameterType::PARAMETER_STRING },
       { "longest_valid_segment_fraction", rclcpp::ParameterType::PARAMETER_DOUBLE },
       { "enforce_joint_model_state_space", rclcpp::ParameterType::PARAMETER_BOOL },
-      { "enforce_constrained_state_space", rclcpp::ParameterType::PARAMETER_BOOL }
+      { "enforce_constrained_state_space", rclcpp::ParameterType::PARAMETER_BOOL },
+      { "context_pool_size", rclcpp::ParameterType::PARAMETER_INTEGER }
     };
 
     const std::string group_name_param = parameter_namespace_ + "." + group_name;
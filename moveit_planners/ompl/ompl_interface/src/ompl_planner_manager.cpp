@@ -37,8 +37,10 @@
 #include <moveit/ompl_interface/ompl_interface.h>
 #include <moveit/planning_interface/planning_interface.h>
 #include <moveit/planning_scene/planning_scene.h>
+#include <moveit/utils/random_seed.h>
 
 #include <ompl/util/Console.h>
+#include <ompl/util/RandomNumbers.h>
 
 namespace ompl_interface
 {
@@ -85,6 +87,12 @@ public:
   bool initialize(const moveit::core::RobotModelConstPtr& model, const rclcpp::Node::SharedPtr& node,
                   const std::string& parameter_namespace) override
   {
+    // OMPL seeds all its generators from one sequence, whose seed only takes effect before the first generator exists
+    if (const std::optional<std::uint32_t> seed = moveit::core::getRandomSeed())
+    {
+      RCLCPP_INFO(LOGGER, "Seeding the OMPL random number generators with %u", *seed);
+      ompl::RNG::setSeed(*seed);
+    }
     ompl_interface_ = std::make_unique<OMPLInterface>(model, node, parameter_namespace);
     setPlannerConfigurations(ompl_interface_->getPlannerConfigurations());
     return true;
@@ -35,6 +35,7 @@
 /* Author: Ioan Sucan */
 
 #include <moveit/ompl_interface/parameterization/model_based_state_space.h>
+#include <moveit/utils/random_seed.h>
 #include <utility>
 
 namespace ompl_interface
@@ -71,6 +72,22 @@ ompl_interface::ModelBasedStateSpace::ModelBasedStateSpace(ModelBasedStateSpaceS
     spec_.joint_bounds_[i] = &joint_bounds_storage_[i];
   }
 
+  // groups made only of bounded single-variable joints (no mimics) have a plain per-variable metric; distance() and
+  // interpolate() then work directly on the value arrays instead of going through every JointModel
+  bool linear =
+      spec_.joint_model_group_->getMimicJointModels().empty() && variable_count_ == joint_model_vector_.size();
+  for (std::size_t i = 0; linear && i < joint_model_vector_.size(); ++i)
+  {
+    const moveit::core::JointModel* jm = joint_model_vector_[i];
+    if (jm->getType() == moveit::core::JointModel::REVOLUTE)
+      linear = !static_cast<const moveit::core::RevoluteJointModel*>(jm)->isContinuous();
+    else
+      linear = jm->getType() == moveit::core::JointModel::PRISMATIC;
+  }
+  if (linear)
+    for (const moveit::core::JointModel* jm : joint_model_vector_)
+      linear_distance_factors_.push_back(jm->getDistanceFactor());
+
   // default settings
   setTagSnapToSegment(0.95);
 
@@ -171,6 +188,15 @@ double ompl_interface::ModelBasedStateSpace::distance(const ompl::base::State* s
 {
   if (distance_function_)
     return distance_function_(state1, state2);
+  else if (!linear_distance_factors_.empty())
+  {
+    const double* values1 = state1->as<StateType>()->values;
+    const double* values2 = state2->as<StateType>()->values;
+    double d = 0.0;
+    for (unsigned int i = 0; i < variable_count_; ++i)
+      d += linear_distance_factors_[i] * fabs(values1[i] - values2[i]);
+    return d;
+  }
   else
     return spec_.joint_model_group_->distance(state1->as<StateType>()->values, state2->as<StateType>()->values);
 }
@@ -205,8 +231,17 @@ void ompl_interface::ModelBasedStateSpace::interpolate(const ompl::base::State*
   if (!interpolation_function_ || !interpolation_function_(from, to, t, state))
   {
     // perform the actual interpolation
-    spec_.joint_model_group_->interpolate(from->as<StateType>()->values, to->as<StateType>()->values, t,
-                                          state->as<StateType>()->values);
+    if (!linear_distance_factors_.empty())
+    {
+      const double* values_from = from->as<StateType>()->values;
+      const double* values_to = to->as<StateType>()->values;
+      double* values = state->as<StateType>()->values;
+      for (unsigned int i = 0; i < variable_count_; ++i)
+        values[i] = values_from[i] + (values_to[i] - values_from[i]) * t;
+    }
+    else
+      spec_.joint_model_group_->interpolate(from->as<StateType>()->values, to->as<StateType>()->values, t,
+                                            state->as<StateType>()->values);
 
     // compute tag
     if (from->as<StateType>()->tag >= 0 && t < 1.0 - tag_snap_to_segment_)
@@ -255,7 +290,10 @@ ompl::base::StateSamplerPtr ompl_interface::ModelBasedStateSpace::allocDefaultSt
   public:
     DefaultStateSampler(const ompl::base::StateSpace* space, const moveit::core::JointModelGroup* group,
                         const moveit::core::JointBoundsVector* joint_bounds)
-      : ompl::base::StateSampler(space), joint_model_group_(group), joint_bounds_(joint_bounds)
+      : ompl::base::StateSampler(space)
+      , moveit_rng_(moveit::core::makeRandomNumberGenerator())
+      , joint_model_group_(group)
+      , joint_bounds_(joint_bounds)
     {
     }
 
@@ -37,6 +37,9 @@
 #include <moveit/ompl_interface/planning_context_manager.h>
 #include <moveit/robot_state/conversions.h>
 
+#include <algorithm>
+#include <chrono>
+#include <sstream>
 #include <utility>
 
 #include <ompl/geometric/planners/AnytimePathShortening.h>
@@ -62,11 +65,12 @@
 #include <ompl/geometric/planners/rrt/LBTRRT.h>
 #include <ompl/geometric/planners/est/BiEST.h>
 #include <ompl/geometric/planners/est/ProjEST.h>
-#include <ompl/geometric/planners/prm/LazyPRM.h>
-#include <ompl/geometric/planners/prm/LazyPRMstar.h>
 #include <ompl/geometric/planners/prm/SPARS.h>
 #include <ompl/geometric/planners/prm/SPARStwo.h>
 
+#include <ompl/tools/thunder/Thunder.h>
+#include <ompl/tools/lightning/Lightning.h>
+
 #include <ompl/base/ConstrainedSpaceInformation.h>
 #include <ompl/base/spaces/constraint/ProjectedStateSpace.h>
 
@@ -76,6 +80,7 @@
 #include <moveit/ompl_interface/parameterization/joint_space/constrained_planning_state_space.h>
 #include <moveit/ompl_interface/parameterization/work_space/pose_model_state_space_factory.h>
 #include <moveit/ompl_interface/detail/ompl_constraints.h>
+#include <moveit/ompl_interface/detail/lazy_roadmap_prm.h>
 
 using namespace std::placeholders;
 
@@ -86,6 +91,7 @@ static const rclcpp::Logger LOGGER = rclcpp::get_logger("moveit.ompl_planning.pl
 struct PlanningContextManager::CachedContexts
 {
   std::map<std::pair<std::string, std::string>, std::vector<ModelBasedPlanningContextPtr> > contexts_;
+  PlanningContextStatistics statistics_;
   std::mutex lock_;
 };
 
@@ -129,6 +135,7 @@ ompl::base::PlannerPtr MultiQueryPlannerAllocator::allocatePlanner(const ob::Spa
     // 'store_planner_data'. The storage file path is set using the parameter 'planner_data_path'.
     // File read and write access are handled by the PlannerDataStorage class. If the file path is invalid
     // an error message is printed and the planner is constructed/destructed with default values.
+    // A path ending with '/' names a directory that holds one roadmap file per group and planner configuration.
     it = cfg.find("load_planner_data");
     bool load_planner_data = false;
     if (it != cfg.end())
@@ -150,6 +157,12 @@ ompl::base::PlannerPtr MultiQueryPlannerAllocator::allocatePlanner(const ob::Spa
       planner_data_path = it->second;
       cfg.erase(it);
     }
+    if (!planner_data_path.empty() && planner_data_path.back() == '/')
+    {
+      std::string file_name = new_name;
+      std::replace(file_name.begin(), file_name.end(), '/', '_');
+      planner_data_path += file_name + ".graph";
+    }
     // Store planner instance for multi-query use
     planners_[new_name] =
         allocatePlannerImpl<T>(si, new_name, spec, load_planner_data, store_planner_data, planner_data_path);
@@ -225,15 +238,15 @@ MultiQueryPlannerAllocator::allocatePersistentPlanner<ompl::geometric::PRMstar>(
 };
 template <>
 inline ompl::base::Planner*
-MultiQueryPlannerAllocator::allocatePersistentPlanner<ompl::geometric::LazyPRM>(const ob::PlannerData& data)
+MultiQueryPlannerAllocator::allocatePersistentPlanner<LazyRoadmapPRM>(const ob::PlannerData& data)
 {
-  return new og::LazyPRM(data);
+  return new LazyRoadmapPRM(data);
 };
 template <>
 inline ompl::base::Planner*
-MultiQueryPlannerAllocator::allocatePersistentPlanner<ompl::geometric::LazyPRMstar>(const ob::PlannerData& data)
+MultiQueryPlannerAllocator::allocatePersistentPlanner<LazyRoadmapPRMstar>(const ob::PlannerData& data)
 {
-  return new og::LazyPRMstar(data);
+  return new LazyRoadmapPRMstar(data);
 };
 
 PlanningContextManager::PlanningContextManager(moveit::core::RobotModelConstPtr robot_model,
@@ -246,6 +259,7 @@ PlanningContextManager::PlanningContextManager(moveit::core::RobotModelConstPtr
   , max_planning_threads_(4)
   , max_solution_segment_length_(0.0)
   , minimum_waypoint_count_(2)
+  , context_pool_size_(0)
 {
   cached_contexts_ = std::make_shared<CachedContexts>();
   registerDefaultPlanners();
@@ -287,8 +301,8 @@ void PlanningContextManager::registerDefaultPlanners()
   registerPlannerAllocatorHelper<og::EST>("geometric::EST");
   registerPlannerAllocatorHelper<og::FMT>("geometric::FMT");
   registerPlannerAllocatorHelper<og::KPIECE1>("geometric::KPIECE");
-  registerPlannerAllocatorHelper<og::LazyPRM>("geometric::LazyPRM");
-  registerPlannerAllocatorHelper<og::LazyPRMstar>("geometric::LazyPRMstar");
+  registerPlannerAllocatorHelper<LazyRoadmapPRM>("geometric::LazyPRM");
+  registerPlannerAllocatorHelper<LazyRoadmapPRMstar>("geometric::LazyPRMstar");
   registerPlannerAllocatorHelper<og::LazyRRT>("geometric::LazyRRT");
   registerPlannerAllocatorHelper<og::LBKPIECE1>("geometric::LBKPIECE");
   registerPlannerAllocatorHelper<og::LBTRRT>("geometric::LBTRRT");
@@ -321,6 +335,177 @@ ConfiguredPlannerSelector PlanningContextManager::getPlannerSelector() const
 void PlanningContextManager::setPlannerConfigurations(const planning_interface::PlannerConfigurationMap& pconfig)
 {
   planner_configs_ = pconfig;
+  fillContextPools();
+}
+
+std::size_t
+PlanningContextManager::getContextPoolSize(const planning_interface::PlannerConfigurationSettings& config) const
+{
+  auto it = config.config.find("context_pool_size");
+  if (it == config.config.end())
+    return context_pool_size_;
+  try
+  {
+    return boost::lexical_cast<std::size_t>(it->second);
+  }
+  catch (boost::bad_lexical_cast&)
+  {
+    RCLCPP_ERROR(LOGGER, "Invalid context_pool_size '%s' for planner configuration '%s'", it->second.c_str(),
+                 config.name.c_str());
+    return context_pool_size_;
+  }
+}
+
+void PlanningContextManager::fillContextPools()
+{
+  for (const auto& [name, config] : planner_configs_)
+  {
+    const std::size_t pool_size = getContextPoolSize(config);
+    if (pool_size == 0)
+      continue;
+
+    // pool the contexts for requests without path constraints, contexts of constrained state spaces are never reused
+    moveit_msgs::msg::MotionPlanRequest req;
+    req.group_name = config.group;
+    const ModelBasedStateSpaceFactoryPtr factory = selectStateSpaceFactory(config, req);
+    if (!factory || factory->getType() == ConstrainedPlanningStateSpace::PARAMETERIZATION_TYPE)
+      continue;
+
+    const auto key = std::make_pair(config.name, factory->getType());
+    std::size_t pooled;
+    {
+      std::lock_guard<std::mutex> slock(cached_contexts_->lock_);
+      pooled = cached_contexts_->contexts_[key].size();
+    }
+    for (; pooled < pool_size; ++pooled)
+    {
+      ModelBasedPlanningContextPtr context = createPlanningContext(config, factory, req);
+      std::lock_guard<std::mutex> slock(cached_contexts_->lock_);
+      cached_contexts_->contexts_[key].push_back(context);
+    }
+    RCLCPP_DEBUG(LOGGER, "Pooled %zu planning contexts for '%s'", pool_size, name.c_str());
+  }
+}
+
+PlanningContextStatistics PlanningContextManager::getPlanningContextStatistics() const
+{
+  std::lock_guard<std::mutex> slock(cached_contexts_->lock_);
+  return cached_contexts_->statistics_;
+}
+
+// Create the experience-based setup named by the 'experience' parameter. Its database is stored at the
+// 'experience_database_path', where a path ending with '/' names a directory holding one database per group and
+// planner configuration. Pointing several robots at a shared directory lets them recall each other's experiences.
+static ompl::geometric::SimpleSetupPtr
+createExperienceSetup(const planning_interface::PlannerConfigurationSettings& config, const std::string& type,
+                      const ob::StateSpacePtr& state_space)
+{
+  ompl::tools::ExperienceSetupPtr setup;
+  if (type == "thunder")
+  {
+    setup = std::make_shared<ompl::tools::Thunder>(state_space);
+  }
+  else if (type == "lightning")
+  {
+    setup = std::make_shared<ompl::tools::Lightning>(state_space);
+  }
+  else
+  {
+    RCLCPP_ERROR(LOGGER, "Unknown experience type '%s' in planner configuration '%s', use 'thunder' or 'lightning'",
+                 type.c_str(), config.name.c_str());
+    return std::make_shared<ompl::geometric::SimpleSetup>(state_space);
+  }
+
+  auto it = config.config.find("experience_database_path");
+  if (it != config.config.end())
+  {
+    std::string path = it->second;
+    if (!path.empty() && path.back() == '/')
+    {
+      std::string file_name = config.name;
+      std::replace(file_name.begin(), file_name.end(), '/', '_');
+      path += file_name + "_" + type + ".db";
+    }
+    setup->setFilePath(path);
+  }
+  return setup;
+}
+
+ModelBasedPlanningContextPtr
+PlanningContextManager::createPlanningContext(const planning_interface::PlannerConfigurationSettings& config,
+                                              const ModelBasedStateSpaceFactoryPtr& factory,
+                                              const moveit_msgs::msg::MotionPlanRequest& req) const
+{
+  const auto start = std::chrono::steady_clock::now();
+  ModelBasedStateSpaceSpecification space_spec(robot_model_, config.group);
+  ModelBasedPlanningContextSpecification context_spec;
+  context_spec.config_ = config.config;
+  context_spec.planner_selector_ = getPlannerSelector();
+  context_spec.constraint_sampler_manager_ = constraint_sampler_manager_;
+  context_spec.state_space_ = factory->getNewStateSpace(space_spec);
+
+  // the planner configurations of a portfolio are referred to by name, alone or with the group prefix
+  auto portfolio = config.config.find("portfolio");
+  if (portfolio != config.config.end())
+  {
+    std::string names = portfolio->second;
+    std::replace(names.begin(), names.end(), ',', ' ');
+    std::istringstream names_stream(names);
+    std::string name;
+    while (names_stream >> name)
+    {
+      auto member = planner_configs_.find(config.group + "[" + name + "]");
+      if (member == planner_configs_.end())
+        member = planner_configs_.find(name);
+      if (member == planner_configs_.end())
+        RCLCPP_WARN(LOGGER, "Planner configuration '%s' of portfolio '%s' not found", name.c_str(),
+                    config.name.c_str());
+      else
+        context_spec.portfolio_.emplace_back(name, member->second.config);
+    }
+  }
+
+  if (factory->getType() == ConstrainedPlanningStateSpace::PARAMETERIZATION_TYPE)
+  {
+    RCLCPP_DEBUG_STREAM(LOGGER, "planning_context_manager: Using OMPL's constrained state space for planning.");
+
+    // Select the correct type of constraints based on the path constraints in the planning request.
+    ompl::base::ConstraintPtr ompl_constraint =
+        createOMPLConstraints(robot_model_, config.group, req.path_constraints);
+
+    // Create a constrained state space of type "projected state space".
+    // Other types are available, so we probably should add another setting to ompl_planning.yaml
+    // to choose between them.
+    context_spec.constrained_state_space_ =
+        std::make_shared<ob::ProjectedStateSpace>(context_spec.state_space_, ompl_constraint);
+
+    // Pass the constrained state space to ompl simple setup through the creation of a
+    // ConstrainedSpaceInformation object. This makes sure the state space is properly initialized.
+    context_spec.ompl_simple_setup_ = std::make_shared<ompl::geometric::SimpleSetup>(
+        std::make_shared<ob::ConstrainedSpaceInformation>(context_spec.constrained_state_space_));
+  }
+  else
+  {
+    // Choose the correct simple setup type to load
+    auto experience = config.config.find("experience");
+    if (experience != config.config.end())
+      context_spec.ompl_simple_setup_ = createExperienceSetup(config, experience->second, context_spec.state_space_);
+    else
+      context_spec.ompl_simple_setup_ = std::make_shared<ompl::geometric::SimpleSetup>(context_spec.state_space_);
+  }
+
+  ModelBasedPlanningContextPtr context = std::make_shared<ModelBasedPlanningContext>(config.name, context_spec);
+
+  const double creation_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  {
+    std::lock_guard<std::mutex> slock(cached_contexts_->lock_);
+    PlanningContextStatistics& statistics = cached_contexts_->statistics_;
+    ++statistics.created_count;
+    statistics.total_creation_time += creation_time;
+    statistics.max_creation_time = std::max(statistics.max_creation_time, creation_time);
+  }
+  RCLCPP_DEBUG(LOGGER, "Created planning context '%s' in %.1f ms", config.name.c_str(), creation_time * 1000.0);
+  return context;
 }
 
 ModelBasedPlanningContextPtr
@@ -330,68 +515,40 @@ PlanningContextManager::getPlanningContext(const planning_interface::PlannerConf
 {
   // Check for a cached planning context
   ModelBasedPlanningContextPtr context;
+  const auto key = std::make_pair(config.name, factory->getType());
 
   {
     std::unique_lock<std::mutex> slock(cached_contexts_->lock_);
-    auto cached_contexts = cached_contexts_->contexts_.find(std::make_pair(config.name, factory->getType()));
+    auto cached_contexts = cached_contexts_->contexts_.find(key);
     if (cached_contexts != cached_contexts_->contexts_.end())
     {
       for (const ModelBasedPlanningContextPtr& cached_context : cached_contexts->second)
-        if (cached_context.unique())
+        if (cached_context.use_count() == 1)
         {
           RCLCPP_DEBUG(LOGGER, "Reusing cached planning context");
           context = cached_context;
+          ++cached_contexts_->statistics_.reused_count;
           break;
         }
     }
+    if (!context)
+      ++cached_contexts_->statistics_.cold_count;
   }
 
   // Create a new planning context
   if (!context)
   {
-    ModelBasedStateSpaceSpecification space_spec(robot_model_, config.group);
-    ModelBasedPlanningContextSpecification context_spec;
-    context_spec.config_ = config.config;
-    context_spec.planner_selector_ = getPlannerSelector();
-    context_spec.constraint_sampler_manager_ = constraint_sampler_manager_;
-    context_spec.state_space_ = factory->getNewStateSpace(space_spec);
-
-    if (factory->getType() == ConstrainedPlanningStateSpace::PARAMETERIZATION_TYPE)
-    {
-      RCLCPP_DEBUG_STREAM(LOGGER, "planning_context_manager: Using OMPL's constrained state space for planning.");
-
-      // Select the correct type of constraints based on the path constraints in the planning request.
-      ompl::base::ConstraintPtr ompl_constraint =
-          createOMPLConstraints(robot_model_, config.group, req.path_constraints);
-
-      // Create a constrained state space of type "projected state space".
-      // Other types are available, so we probably should add another setting to ompl_planning.yaml
-      // to choose between them.
-      context_spec.constrained_state_space_ =
-          std::make_shared<ob::ProjectedStateSpace>(context_spec.state_space_, ompl_constraint);
-
-      // Pass the constrained state space to ompl simple setup through the creation of a
-      // ConstrainedSpaceInformation object. This makes sure the state space is properly initialized.
-      context_spec.ompl_simple_setup_ = std::make_shared<ompl::geometric::SimpleSetup>(
-          std::make_shared<ob::ConstrainedSpaceInformation>(context_spec.constrained_state_space_));
-    }
-    else
-    {
-      // Choose the correct simple setup type to load
-      context_spec.ompl_simple_setup_ = std::make_shared<ompl::geometric::SimpleSetup>(context_spec.state_space_);
-    }
-
-    RCLCPP_DEBUG(LOGGER, "Creating new planning context");
-    context = std::make_shared<ModelBasedPlanningContext>(config.name, context_spec);
+    context = createPlanningContext(config, factory, req);
 
     // Do not cache a constrained planning context, as the constraints could be changed
-    // and need to be parsed again.
+    // and need to be parsed again. Contexts beyond the pool size are dropped after use.
     if (factory->getType() != ConstrainedPlanningStateSpace::PARAMETERIZATION_TYPE)
     {
-      {
-        std::lock_guard<std::mutex> slock(cached_contexts_->lock_);
-        cached_contexts_->contexts_[std::make_pair(config.name, factory->getType())].push_back(context);
-      }
+      const std::size_t pool_size = getContextPoolSize(config);
+      std::lock_guard<std::mutex> slock(cached_contexts_->lock_);
+      std::vector<ModelBasedPlanningContextPtr>& contexts = cached_contexts_->contexts_[key];
+      if (pool_size == 0 || contexts.size() < pool_size)
+        contexts.push_back(context);
     }
   }
 
@@ -458,6 +615,33 @@ PlanningContextManager::getStateSpaceFactory(const std::string& group,
   }
 }
 
+ModelBasedStateSpaceFactoryPtr
+PlanningContextManager::selectStateSpaceFactory(const planning_interface::PlannerConfigurationSettings& config,
+                                                const moveit_msgs::msg::MotionPlanRequest& req) const
+{
+  auto constrained_planning_iterator = config.config.find("enforce_constrained_state_space");
+  auto joint_space_planning_iterator = config.config.find("enforce_joint_model_state_space");
+
+  // Use ConstrainedPlanningStateSpace if there is exactly one position constraint or one orientation constraint
+  // Mixed constraints are not supported
+  if (constrained_planning_iterator != config.config.end() &&
+      boost::lexical_cast<bool>(constrained_planning_iterator->second) &&
+      ((req.path_constraints.position_constraints.size() == 1) !=
+       (req.path_constraints.orientation_constraints.size() == 1)))
+  {
+    return getStateSpaceFactory(ConstrainedPlanningStateSpace::PARAMETERIZATION_TYPE);
+  }
+  else if (joint_space_planning_iterator != config.config.end() &&
+           boost::lexical_cast<bool>(joint_space_planning_iterator->second))
+  {
+    return getStateSpaceFactory(JointModelStateSpace::PARAMETERIZATION_TYPE);
+  }
+  else
+  {
+    return getStateSpaceFactory(config.group, req);
+  }
+}
+
 ModelBasedPlanningContextPtr PlanningContextManager::getPlanningContext(
     const planning_scene::PlanningSceneConstPtr& planning_scene, const moveit_msgs::msg::MotionPlanRequest& req,
     moveit_msgs::msg::MoveItErrorCodes& error_code, const rclcpp::Node::SharedPtr& node,
@@ -532,29 +716,7 @@ ModelBasedPlanningContextPtr PlanningContextManager::getPlanningContext(
   // However consecutive IK solutions are not checked for proximity at the moment and sometimes happen to be flipped,
   // leading to invalid trajectories. This workaround lets the user prevent this problem by forcing rejection sampling
   // in JointModelStateSpace.
-  ModelBasedStateSpaceFactoryPtr factory;
-  auto constrained_planning_iterator = pc->second.config.find("enforce_constrained_state_space");
-  auto joint_space_planning_iterator = pc->second.config.find("enforce_joint_model_state_space");
-
-  // Use ConstrainedPlanningStateSpace if there is exactly one position constraint or one orientation constraint
-  // Mixed constraints are not supported
-  if (constrained_planning_iterator != pc->second.config.end() &&
-      boost::lexical_cast<bool>(constrained_planning_iterator->second) &&
-      ((req.path_constraints.position_constraints.size() == 1) !=
-       (req.path_constraints.orientation_constraints.size() == 1)))
-  {
-    factory = getStateSpaceFactory(ConstrainedPlanningStateSpace::PARAMETERIZATION_TYPE);
-  }
-  else if (joint_space_planning_iterator != pc->second.config.end() &&
-           boost::lexical_cast<bool>(joint_space_planning_iterator->second))
-  {
-    factory = getStateSpaceFactory(JointModelStateSpace::PARAMETERIZATION_TYPE);
-  }
-  else
-  {
-    factory = getStateSpaceFactory(pc->second.group, req);
-  }
-
+  const ModelBasedStateSpaceFactoryPtr factory = selectStateSpaceFactory(pc->second, req);
   ModelBasedPlanningContextPtr context = getPlanningContext(pc->second, factory, req);
 
   if (context)
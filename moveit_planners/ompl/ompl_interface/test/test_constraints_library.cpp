@@ -0,0 +1,139 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/ompl_interface/detail/constraints_library.h>
+#include <moveit/ompl_interface/parameterization/joint_space/joint_model_state_space.h>
+#include <moveit/utils/robot_model_test_utils.h>
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+
+class MappedConstraintApproximation : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    robot_model_ = moveit::core::loadTestingRobotModel("pr2");
+    ompl_interface::ModelBasedStateSpaceSpecification spec(robot_model_, "right_arm");
+    space_ = std::make_shared<ompl_interface::JointModelStateSpace>(spec);
+    space_->setup();
+    filename_ = testing::TempDir() + "test_constraints_library.mapped";
+  }
+
+  void TearDown() override
+  {
+    std::remove(filename_.c_str());
+  }
+
+  moveit::core::RobotModelPtr robot_model_;
+  ompl::base::StateSpacePtr space_;
+  std::string filename_;
+};
+
+TEST_F(MappedConstraintApproximation, StoreAndMap)
+{
+  // three milestones connected in a chain, with one explicit motion state between the first two
+  ompl_interface::ConstraintApproximationStateStorage storage(space_);
+  ompl::base::ScopedState<> state(space_);
+  for (int i = 0; i < 4; ++i)
+  {
+    state.random();
+    state->as<ompl_interface::ModelBasedStateSpace::StateType>()->tag = i < 3 ? i : -1;
+    storage.addState(state.get());
+  }
+  storage.getMetadata(0).first = { 1 };
+  storage.getMetadata(1).first = { 0, 2 };
+  storage.getMetadata(2).first = { 1 };
+  storage.getMetadata(0).second[1] = { 3, 4 };
+  storage.getMetadata(1).second[0] = { 3, 4 };
+
+  ASSERT_TRUE(ompl_interface::MappedConstraintApproximationStorage::store(filename_, storage));
+  ompl_interface::MappedConstraintApproximationStorage mapped(filename_, space_);
+  ASSERT_EQ(mapped.size(), storage.size());
+  EXPECT_EQ(mapped.getConnectionCount(), 4u);
+  for (std::size_t i = 0; i < storage.size(); ++i)
+  {
+    mapped.getState(i, state.get());
+    EXPECT_TRUE(space_->equalStates(state.get(), storage.getState(i))) << i;
+    EXPECT_EQ(state->as<ompl_interface::ModelBasedStateSpace::StateType>()->tag,
+              storage.getState(i)->as<ompl_interface::ModelBasedStateSpace::StateType>()->tag);
+    ASSERT_EQ(mapped.getConnectionCount(i), storage.getMetadata(i).first.size());
+    for (std::size_t k = 0; k < mapped.getConnectionCount(i); ++k)
+      EXPECT_EQ(mapped.getConnection(i, k), storage.getMetadata(i).first[k]);
+  }
+
+  std::pair<std::size_t, std::size_t> range;
+  ASSERT_TRUE(mapped.getMotion(1, 0, range));
+  EXPECT_EQ(range, std::pair<std::size_t, std::size_t>(3, 4));
+  EXPECT_FALSE(mapped.getMotion(1, 2, range));
+  EXPECT_FALSE(mapped.getMotion(2, 1, range));
+}
+
+TEST_F(MappedConstraintApproximation, RejectInvalidFiles)
+{
+  ompl_interface::ConstraintApproximationStateStorage storage(space_);
+  ompl::base::ScopedState<> state(space_);
+  state.random();
+  storage.addState(state.get());
+  ASSERT_TRUE(ompl_interface::MappedConstraintApproximationStorage::store(filename_, storage));
+
+  // states of a group with more joints
+  ompl_interface::ModelBasedStateSpaceSpecification spec(robot_model_, "arms");
+  auto other_space = std::make_shared<ompl_interface::JointModelStateSpace>(spec);
+  other_space->setup();
+  EXPECT_THROW(std::make_shared<ompl_interface::MappedConstraintApproximationStorage>(filename_, other_space),
+               std::runtime_error);
+
+  // a newer format version
+  {
+    std::fstream file(filename_, std::ios::in | std::ios::out | std::ios::binary);
+    const std::uint32_t version = ompl_interface::MappedConstraintApproximationStorage::FORMAT_VERSION + 1;
+    file.seekp(sizeof(ompl_interface::MappedConstraintApproximationStorage::MAGIC));
+    file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+  }
+  EXPECT_THROW(std::make_shared<ompl_interface::MappedConstraintApproximationStorage>(filename_, space_),
+               std::runtime_error);
+
+  // no file at all
+  std::remove(filename_.c_str());
+  EXPECT_THROW(std::make_shared<ompl_interface::MappedConstraintApproximationStorage>(filename_, space_),
+               std::runtime_error);
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -217,6 +217,25 @@ protected:
     }
   }
 
+  /** \brief The constraint error must follow the joint values when they alternate, as the robot state inside the
+   * constraint is only updated when they differ. */
+  void testAlternatingEvaluation()
+  {
+    SCOPED_TRACE("testAlternatingEvaluation");
+
+    const Eigen::Matrix3d rotation = constraint_->getTargetOrientation().matrix().transpose();
+    const Eigen::Vector3d target = constraint_->getTargetPosition();
+    const Eigen::VectorXd q1 = getRandomState();
+    const Eigen::VectorXd q2 = getRandomState();
+    for (const Eigen::VectorXd& q : { q1, q2, q2, q1 })
+    {
+      const Eigen::Vector3d expected = rotation * (fk(q, constraint_->getLinkName()).translation() - target);
+      EXPECT_TRUE(constraint_->calcError(q).isApprox(expected));
+      EXPECT_TRUE(constraint_->calcErrorJacobian(q).isApprox(numericalJacobianPosition(q, constraint_->getLinkName()),
+                                                             JAC_ERROR_TOLERANCE));
+    }
+  }
+
   void testOMPLProjectedStateSpaceConstruction()
   {
     SCOPED_TRACE("testOMPLProjectedStateSpaceConstruction");
@@ -324,6 +343,12 @@ TEST_F(PandaConstraintTest, PositionConstraintJacobian)
   testJacobian();
 }
 
+TEST_F(PandaConstraintTest, PositionConstraintAlternatingEvaluation)
+{
+  setPositionConstraints();
+  testAlternatingEvaluation();
+}
+
 TEST_F(PandaConstraintTest, PositionConstraintOMPLCheck)
 {
   setPositionConstraints();
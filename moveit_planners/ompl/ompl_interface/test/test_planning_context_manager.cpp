@@ -67,6 +67,14 @@
 #include <moveit/kinematic_constraints/utils.h>
 #include <moveit/constraint_samplers/constraint_sampler_manager.h>
 #include <moveit/ompl_interface/parameterization/joint_space/joint_model_state_space.h>
+#include <moveit/ompl_interface/detail/lazy_roadmap_prm.h>
+#include <moveit/ompl_interface/detail/projection_evaluators.h>
+
+#include <geometric_shapes/shapes.h>
+#include <ompl/tools/experience/ExperienceSetup.h>
+
+#include <cstdio>
+#include <fstream>
 
 // static const rclcpp::Logger LOGGER = rclcpp::get_logger("moveit.ompl_planning.test.test_planning_context_manager");
 
@@ -114,6 +122,263 @@ public:
     ASSERT_TRUE(pc->solve(res));
   }
 
+  void testPortfolio(const std::vector<double>& start, const std::vector<double>& goal)
+  {
+    SCOPED_TRACE("testPortfolio");
+
+    // a configuration racing two other configurations, one of them referred to with the group prefix
+    planning_interface::PlannerConfigurationSettings rrt_connect;
+    rrt_connect.group = group_name_;
+    rrt_connect.name = group_name_ + "[RRTConnect]";
+    rrt_connect.config = { { "type", "geometric::RRTConnect" } };
+    planning_interface::PlannerConfigurationSettings kpiece;
+    kpiece.group = group_name_;
+    kpiece.name = "KPIECE";
+    kpiece.config = { { "type", "geometric::KPIECE" } };
+    planning_interface::PlannerConfigurationSettings portfolio;
+    portfolio.group = group_name_;
+    portfolio.name = group_name_ + "[Portfolio]";
+    portfolio.config = { { "enforce_joint_model_state_space", "0" }, { "portfolio", "RRTConnect, KPIECE" } };
+
+    planning_interface::PlannerConfigurationMap pconfig_map{ { rrt_connect.name, rrt_connect },
+                                                             { kpiece.name, kpiece },
+                                                             { portfolio.name, portfolio } };
+    moveit_msgs::msg::MoveItErrorCodes error_code;
+    planning_interface::MotionPlanRequest request = createRequest(start, goal);
+    request.planner_id = "Portfolio";
+
+    ompl_interface::PlanningContextManager pcm(robot_model_, constraint_sampler_manager_);
+    pcm.setPlannerConfigurations(pconfig_map);
+    auto pc = pcm.getPlanningContext(planning_scene_, request, error_code, node_, false);
+    ASSERT_NE(pc, nullptr);
+    EXPECT_EQ(pc->getSpecification().portfolio_.size(), 2u);
+
+    planning_interface::MotionPlanDetailedResponse res;
+    ASSERT_TRUE(pc->solve(res));
+
+    // waiting for the best of both solutions succeeds as well
+    portfolio.config["portfolio_best_solution"] = "1";
+    pconfig_map[portfolio.name] = portfolio;
+    pcm.setPlannerConfigurations(pconfig_map);
+    pc = pcm.getPlanningContext(planning_scene_, request, error_code, node_, false);
+    ASSERT_NE(pc, nullptr);
+    planning_interface::MotionPlanDetailedResponse best_res;
+    ASSERT_TRUE(pc->solve(best_res));
+  }
+
+  void testMultiQueryRoadmap(const std::vector<double>& start, const std::vector<double>& goal)
+  {
+    SCOPED_TRACE("testMultiQueryRoadmap");
+
+    planning_interface::PlannerConfigurationSettings pconfig_settings;
+    pconfig_settings.group = group_name_;
+    pconfig_settings.name = group_name_ + "[LazyPRM]";
+    pconfig_settings.config = { { "enforce_joint_model_state_space", "0" },
+                                { "type", "geometric::LazyPRM" },
+                                { "multi_query_planning_enabled", "1" } };
+
+    planning_interface::PlannerConfigurationMap pconfig_map{ { pconfig_settings.name, pconfig_settings } };
+    moveit_msgs::msg::MoveItErrorCodes error_code;
+    planning_interface::MotionPlanRequest request = createRequest(start, goal);
+    request.planner_id = "LazyPRM";
+
+    ompl_interface::PlanningContextManager pcm(robot_model_, constraint_sampler_manager_);
+    pcm.setPlannerConfigurations(pconfig_map);
+    auto pc = pcm.getPlanningContext(planning_scene_, request, error_code, node_, false);
+    ASSERT_NE(pc, nullptr);
+    planning_interface::MotionPlanDetailedResponse res;
+    ASSERT_TRUE(pc->solve(res));
+
+    // the roadmap remembers the scene it was validated in
+    auto planner = std::dynamic_pointer_cast<ompl_interface::LazyRoadmapPRM>(pc->getOMPLSimpleSetup()->getPlanner());
+    ASSERT_NE(planner, nullptr);
+    ASSERT_TRUE(planner->getValidatedEnvironment());
+    EXPECT_EQ(planner->getValidatedEnvironment()->world_version, planning_scene_->getWorldVersion());
+
+    // after adding an object far away from the robot, the roadmap is re-validated for the new scene
+    planning_scene_->getWorldNonConst()->addToObject("far_box", std::make_shared<shapes::Box>(0.1, 0.1, 0.1),
+                                                     Eigen::Isometry3d(Eigen::Translation3d(10.0, 0.0, 0.0)));
+    pc = pcm.getPlanningContext(planning_scene_, request, error_code, node_, false);
+    ASSERT_NE(pc, nullptr);
+    planning_interface::MotionPlanDetailedResponse second_res;
+    ASSERT_TRUE(pc->solve(second_res));
+    EXPECT_EQ(pc->getOMPLSimpleSetup()->getPlanner(), planner);
+    ASSERT_TRUE(planner->getValidatedEnvironment());
+    EXPECT_EQ(planner->getValidatedEnvironment()->world_version, planning_scene_->getWorldVersion());
+    planning_scene_->getWorldNonConst()->removeObject("far_box");
+  }
+
+  void testExperienceDatabase(const std::vector<double>& start, const std::vector<double>& goal)
+  {
+    SCOPED_TRACE("testExperienceDatabase");
+
+    const std::string database = testing::TempDir() + group_name_ + "_thunder.db";
+    std::remove(database.c_str());
+
+    planning_interface::PlannerConfigurationSettings pconfig_settings;
+    pconfig_settings.group = group_name_;
+    pconfig_settings.name = group_name_;
+    pconfig_settings.config = { { "enforce_joint_model_state_space", "1" },
+                                { "experience", "thunder" },
+                                { "experience_database_path", testing::TempDir() } };
+
+    planning_interface::PlannerConfigurationMap pconfig_map{ { pconfig_settings.name, pconfig_settings } };
+    moveit_msgs::msg::MoveItErrorCodes error_code;
+    planning_interface::MotionPlanRequest request = createRequest(start, goal);
+
+    ompl_interface::PlanningContextManager pcm(robot_model_, constraint_sampler_manager_);
+    pcm.setPlannerConfigurations(pconfig_map);
+    auto pc = pcm.getPlanningContext(planning_scene_, request, error_code, node_, false);
+    ASSERT_NE(pc, nullptr);
+    auto experience = std::dynamic_pointer_cast<ompl::tools::ExperienceSetup>(pc->getOMPLSimpleSetup());
+    ASSERT_NE(experience, nullptr);
+
+    // solving the problem records the solution as experience and stores the database
+    planning_interface::MotionPlanDetailedResponse res;
+    ASSERT_TRUE(pc->solve(res));
+    EXPECT_GE(experience->getExperiencesCount(), 1u);
+    std::ifstream file(database);
+    EXPECT_TRUE(file.good());
+    file.close();
+    std::remove(database.c_str());
+  }
+
+  void testPCAProjection(const std::vector<double>& start, const std::vector<double>& goal)
+  {
+    SCOPED_TRACE("testPCAProjection");
+
+    // sample states along the straight line from start to goal, as waypoints of a past solution would be
+    const std::string samples = testing::TempDir() + group_name_ + "_projection_samples.txt";
+    std::ofstream file(samples);
+    for (int i = 0; i <= 10; ++i)
+    {
+      for (std::size_t j = 0; j < start.size(); ++j)
+        file << start[j] + (goal[j] - start[j]) * i / 10.0 << ' ';
+      file << '\n';
+    }
+    file.close();
+
+    planning_interface::PlannerConfigurationSettings pconfig_settings;
+    pconfig_settings.group = group_name_;
+    pconfig_settings.name = group_name_;
+    pconfig_settings.config = { { "enforce_joint_model_state_space", "1" },
+                                { "type", "geometric::KPIECE" },
+                                { "projection_evaluator", "pca(" + samples + ", 2)" } };
+
+    planning_interface::PlannerConfigurationMap pconfig_map{ { pconfig_settings.name, pconfig_settings } };
+    moveit_msgs::msg::MoveItErrorCodes error_code;
+    planning_interface::MotionPlanRequest request = createRequest(start, goal);
+
+    ompl_interface::PlanningContextManager pcm(robot_model_, constraint_sampler_manager_);
+    pcm.setPlannerConfigurations(pconfig_map);
+    auto pc = pcm.getPlanningContext(planning_scene_, request, error_code, node_, false);
+    ASSERT_NE(pc, nullptr);
+    std::remove(samples.c_str());
+
+    auto projection = std::dynamic_pointer_cast<ompl_interface::ProjectionEvaluatorPCA>(
+        pc->getOMPLStateSpace()->getDefaultProjection());
+    ASSERT_NE(projection, nullptr);
+    EXPECT_EQ(projection->getDimension(), 2u);
+
+    // the samples only vary along the line, so projecting start and goal shows their distance on the first component
+    ompl::base::ScopedState<> from(pc->getOMPLStateSpace());
+    ompl::base::ScopedState<> to(pc->getOMPLStateSpace());
+    for (std::size_t j = 0; j < start.size(); ++j)
+    {
+      from->as<ompl_interface::ModelBasedStateSpace::StateType>()->values[j] = start[j];
+      to->as<ompl_interface::ModelBasedStateSpace::StateType>()->values[j] = goal[j];
+    }
+    Eigen::VectorXd projected_from(2), projected_to(2);
+    projection->project(from.get(), projected_from);
+    projection->project(to.get(), projected_to);
+    double length = 0.0;
+    for (std::size_t j = 0; j < start.size(); ++j)
+      length += (goal[j] - start[j]) * (goal[j] - start[j]);
+    EXPECT_NEAR(std::abs(projected_to(0) - projected_from(0)), std::sqrt(length), 1e-6);
+    EXPECT_NEAR(projected_to(1) - projected_from(1), 0.0, 1e-6);
+
+    planning_interface::MotionPlanDetailedResponse res;
+    ASSERT_TRUE(pc->solve(res));
+  }
+
+  void testContextPool(const std::vector<double>& start, const std::vector<double>& goal)
+  {
+    SCOPED_TRACE("testContextPool");
+
+    planning_interface::PlannerConfigurationSettings pconfig_settings;
+    pconfig_settings.group = group_name_;
+    pconfig_settings.name = group_name_;
+    pconfig_settings.config = { { "enforce_joint_model_state_space", "1" }, { "context_pool_size", "2" } };
+
+    planning_interface::PlannerConfigurationMap pconfig_map{ { pconfig_settings.name, pconfig_settings } };
+    moveit_msgs::msg::MoveItErrorCodes error_code;
+    planning_interface::MotionPlanRequest request = createRequest(start, goal);
+
+    // the pool is filled when the configurations are set
+    ompl_interface::PlanningContextManager pcm(robot_model_, constraint_sampler_manager_);
+    pcm.setPlannerConfigurations(pconfig_map);
+    EXPECT_EQ(pcm.getPlanningContextStatistics().created_count, 2u);
+
+    // concurrent requests use the pooled contexts until all of them are in use
+    auto pc1 = pcm.getPlanningContext(planning_scene_, request, error_code, node_, false);
+    auto pc2 = pcm.getPlanningContext(planning_scene_, request, error_code, node_, false);
+    ASSERT_NE(pc1, nullptr);
+    ASSERT_NE(pc2, nullptr);
+    EXPECT_NE(pc1, pc2);
+    auto statistics = pcm.getPlanningContextStatistics();
+    EXPECT_EQ(statistics.created_count, 2u);
+    EXPECT_EQ(statistics.reused_count, 2u);
+    EXPECT_EQ(statistics.cold_count, 0u);
+
+    // a third request creates a context that is not kept
+    auto pc3 = pcm.getPlanningContext(planning_scene_, request, error_code, node_, false);
+    ASSERT_NE(pc3, nullptr);
+    statistics = pcm.getPlanningContextStatistics();
+    EXPECT_EQ(statistics.created_count, 3u);
+    EXPECT_EQ(statistics.cold_count, 1u);
+    EXPECT_GE(statistics.max_creation_time, 0.0);
+
+    planning_interface::MotionPlanDetailedResponse res;
+    ASSERT_TRUE(pc3->solve(res));
+    pc1.reset();
+    pc2.reset();
+    pc3.reset();
+    auto pc4 = pcm.getPlanningContext(planning_scene_, request, error_code, node_, false);
+    ASSERT_NE(pc4, nullptr);
+    statistics = pcm.getPlanningContextStatistics();
+    EXPECT_EQ(statistics.created_count, 3u);
+    EXPECT_EQ(statistics.reused_count, 3u);
+  }
+
+  void testParallelSimplification(const std::vector<double>& start, const std::vector<double>& goal)
+  {
+    SCOPED_TRACE("testParallelSimplification");
+
+    planning_interface::PlannerConfigurationSettings pconfig_settings;
+    pconfig_settings.group = group_name_;
+    pconfig_settings.name = group_name_;
+    pconfig_settings.config = { { "enforce_joint_model_state_space", "1" },
+                                { "simplification_count", "3" },
+                                { "verify_interpolation", "1" } };
+
+    planning_interface::PlannerConfigurationMap pconfig_map{ { pconfig_settings.name, pconfig_settings } };
+    moveit_msgs::msg::MoveItErrorCodes error_code;
+    planning_interface::MotionPlanRequest request = createRequest(start, goal);
+    request.num_planning_attempts = 3;
+
+    ompl_interface::PlanningContextManager pcm(robot_model_, constraint_sampler_manager_);
+    pcm.setPlannerConfigurations(pconfig_map);
+    auto pc = pcm.getPlanningContext(planning_scene_, request, error_code, node_, false);
+    ASSERT_NE(pc, nullptr);
+
+    // the simplified and interpolated solution is still valid
+    planning_interface::MotionPlanDetailedResponse res;
+    ASSERT_TRUE(pc->solve(res));
+    ASSERT_EQ(res.description_.size(), 3u);
+    EXPECT_EQ(res.description_[1], "simplify");
+    EXPECT_TRUE(planning_scene_->isPathValid(*res.trajectory_.back(), group_name_));
+  }
+
   void testPathConstraints(const std::vector<double>& start, const std::vector<double>& goal)
   {
     SCOPED_TRACE("testPathConstraints");
@@ -320,6 +585,36 @@ TEST_F(PandaTestPlanningContext, testSimpleRequest)
   testSimpleRequest({ 0., -0.785, 0., -2.356, 0, 1.571, 0.785 }, { 0., -0.785, 0., -2.356, 0, 1.571, 0.685 });
 }
 
+TEST_F(PandaTestPlanningContext, testPortfolio)
+{
+  testPortfolio({ 0., -0.785, 0., -2.356, 0, 1.571, 0.785 }, { 0., -0.785, 0., -2.356, 0, 1.571, 0.685 });
+}
+
+TEST_F(PandaTestPlanningContext, testMultiQueryRoadmap)
+{
+  testMultiQueryRoadmap({ 0., -0.785, 0., -2.356, 0, 1.571, 0.785 }, { 0., -0.785, 0., -2.356, 0, 1.571, 0.685 });
+}
+
+TEST_F(PandaTestPlanningContext, testExperienceDatabase)
+{
+  testExperienceDatabase({ 0., -0.785, 0., -2.356, 0, 1.571, 0.785 }, { 0., -0.785, 0., -2.356, 0, 1.571, 0.685 });
+}
+
+TEST_F(PandaTestPlanningContext, testPCAProjection)
+{
+  testPCAProjection({ 0., -0.785, 0., -2.356, 0, 1.571, 0.785 }, { 0., -0.785, 0., -2.356, 0, 1.571, 0.685 });
+}
+
+TEST_F(PandaTestPlanningContext, testContextPool)
+{
+  testContextPool({ 0., -0.785, 0., -2.356, 0, 1.571, 0.785 }, { 0., -0.785, 0., -2.356, 0, 1.571, 0.685 });
+}
+
+TEST_F(PandaTestPlanningContext, testParallelSimplification)
+{
+  testParallelSimplification({ 0., -0.785, 0., -2.356, 0, 1.571, 0.785 }, { 0., -0.785, 0., -2.356, 0, 1.571, 0.685 });
+}
+
 TEST_F(PandaTestPlanningContext, testPathConstraints)
 {
   testPathConstraints({ 0., -0.785, 0., -2.356, 0., 1.571, 0.785 }, { .0, -0.785, 0., -2.356, 0., 1.571, 0.685 });
@@ -184,6 +184,38 @@ TEST_F(LoadPlanningModelsPr2, StateSpaceCopy)
   joint_model_state_space.freeState(state);
 }
 
+// The panda arm only has bounded revolute joints, so distance() and interpolate() skip the per-joint model calls
+TEST(TestPanda, LinearStateSpaceMatchesJointModelGroup)
+{
+  moveit::core::RobotModelPtr robot_model = moveit::core::loadTestingRobotModel("panda");
+  ompl_interface::ModelBasedStateSpaceSpecification spec(robot_model, "panda_arm");
+  ompl_interface::JointModelStateSpace state_space(spec);
+  state_space.setup();
+  const moveit::core::JointModelGroup* jmg = robot_model->getJointModelGroup("panda_arm");
+
+  ompl::base::StateSamplerPtr sampler = state_space.allocDefaultStateSampler();
+  ompl::base::State* from = state_space.allocState();
+  ompl::base::State* to = state_space.allocState();
+  ompl::base::State* state = state_space.allocState();
+  std::vector<double> expected(jmg->getVariableCount());
+  for (int i = 0; i < 10; ++i)
+  {
+    sampler->sampleUniform(from);
+    sampler->sampleUniform(to);
+    const double* values_from = from->as<ompl_interface::ModelBasedStateSpace::StateType>()->values;
+    const double* values_to = to->as<ompl_interface::ModelBasedStateSpace::StateType>()->values;
+    EXPECT_NEAR(state_space.distance(from, to), jmg->distance(values_from, values_to), EPSILON);
+
+    state_space.interpolate(from, to, 0.3, state);
+    jmg->interpolate(values_from, values_to, 0.3, expected.data());
+    for (std::size_t j = 0; j < expected.size(); ++j)
+      EXPECT_NEAR(state->as<ompl_interface::ModelBasedStateSpace::StateType>()->values[j], expected[j], EPSILON);
+  }
+  state_space.freeState(state);
+  state_space.freeState(to);
+  state_space.freeState(from);
+}
+
 // Run the OMPL sanity checks on the diff drive model
 TEST(TestDiffDrive, TestStateSpace)
 {
@@ -192,6 +192,46 @@ public:
     EXPECT_FALSE(checker->isValid(ompl_state.get()));
   }
 
+  /** Collision checks of the lazy validity checker are deferred until motions are validated. **/
+  void testLazyCollisionChecking(const std::vector<double>& position_valid,
+                                 const std::vector<double>& position_in_self_collision)
+  {
+    SCOPED_TRACE("testLazyCollisionChecking");
+
+    auto checker = std::make_shared<ompl_interface::LazyCollisionStateValidityChecker>(planning_context_.get());
+    checker->setVerbose(VERBOSE);
+    const ompl::base::SpaceInformationPtr& si = planning_context_->getOMPLSimpleSetup()->getSpaceInformation();
+    // motions are discretized according to the longest valid segment computed on setup
+    state_space_->setup();
+    ompl_interface::LazyCollisionMotionValidator motion_validator(si, checker);
+
+    ompl::base::ScopedState<> valid_state(state_space_);
+    robot_state_->setJointGroupPositions(joint_model_group_, position_valid);
+    state_space_->copyToOMPLState(valid_state.get(), *robot_state_);
+
+    ompl::base::ScopedState<> colliding_state(state_space_);
+    robot_state_->setJointGroupPositions(joint_model_group_, position_in_self_collision);
+    state_space_->copyToOMPLState(colliding_state.get(), *robot_state_);
+    auto* colliding = colliding_state->as<ompl_interface::ModelBasedStateSpace::StateType>();
+
+    // only the cheap checks run, their success is remembered without deciding validity
+    EXPECT_TRUE(checker->isValid(colliding_state.get()));
+    EXPECT_TRUE(colliding->areConstraintsSatisfied());
+    EXPECT_FALSE(colliding->isValidityKnown());
+
+    // the motion validator performs the deferred collision check
+    EXPECT_TRUE(motion_validator.checkMotion(valid_state.get(), valid_state.get()));
+    EXPECT_FALSE(motion_validator.checkMotion(valid_state.get(), colliding_state.get()));
+    EXPECT_TRUE(colliding->isValidityKnown());
+    EXPECT_FALSE(checker->isValid(colliding_state.get()));
+    EXPECT_EQ(motion_validator.getValidMotionCount(), 1u);
+    EXPECT_EQ(motion_validator.getInvalidMotionCount(), 1u);
+
+    std::pair<ompl::base::State*, double> last_valid(nullptr, 1.0);
+    EXPECT_FALSE(motion_validator.checkMotion(valid_state.get(), colliding_state.get(), last_valid));
+    EXPECT_LT(last_valid.second, 1.0);
+  }
+
 protected:
   void SetUp() override
   {
@@ -292,6 +332,12 @@ TEST_F(PandaValidity, testPathConstraints)
   testPathConstraints({ 0., -0.785, 0., -2.356, 0., 1.571, 0.785 });
 }
 
+TEST_F(PandaValidity, testLazyCollisionChecking)
+{
+  testLazyCollisionChecking({ 0., -0.785, 0., -2.356, 0., 1.571, 0.785 },
+                            { 2.31827, -0.169668, 2.5225, -2.98568, -0.36355, 0.808339, 0.0843406 });
+}
+
 /***************************************************************************
  * Run all tests on the Fanuc robot
  * ************************************************************************/
@@ -38,6 +38,7 @@
 
 #include <memory>
 #include <functional>
+#include <optional>
 
 #include <moveit/planning_interface/planning_interface.h>
 #include <moveit/planning_pipeline/planning_pipeline.h>
@@ -106,11 +107,37 @@ public:
                       const planning_pipeline::PlanningPipelinePtr& planning_pipeline,
                       const moveit_msgs::msg::MotionSequenceRequest& req_list);
 
+  //! Called with every trajectory of a streamed solve() as soon as it is final
+  using TrajectoryCallback = std::function<void(const robot_trajectory::RobotTrajectoryPtr&)>;
+
+  /**
+   * @brief Generates trajectories for the specified list of motion commands
+   * and streams them while the rest of the list is still being planned.
+   *
+   * The same rules as for solve() without callback apply, except that every
+   * chain of blended commands becomes a trajectory element of its own. A
+   * chain ends with a blend radius of zero, i.e. the robot is at rest at the
+   * end of every element. Each element is passed to the callback as soon as
+   * the chain is blended, so that it can be executed while the following
+   * commands are planned.
+   *
+   * @param trajectory_callback Called from the calling thread with every
+   * trajectory element, in order.
+   *
+   * @return Contains all trajectory elements passed to the callback.
+   */
+  RobotTrajCont solve(const planning_scene::PlanningSceneConstPtr& planning_scene,
+                      const planning_pipeline::PlanningPipelinePtr& planning_pipeline,
+                      const moveit_msgs::msg::MotionSequenceRequest& req_list,
+                      const TrajectoryCallback& trajectory_callback);
+
 private:
   using MotionResponseCont = std::vector<planning_interface::MotionPlanResponse>;
+  using SolvedItemCallback = std::function<void(const MotionResponseCont&)>;
   using RobotState_OptRef = const std::optional<std::reference_wrapper<const moveit::core::RobotState>>;
   using RadiiCont = std::vector<double>;
   using GroupNamesCont = std::vector<std::string>;
+  using StartStateCont = std::vector<std::optional<moveit_msgs::msg::RobotState>>;
 
 private:
   /**
@@ -122,18 +149,43 @@ private:
    */
   void checkForOverlappingRadii(const MotionResponseCont& resp_cont, const RadiiCont& radii) const;
 
+  /**
+   * @brief Validates that the blending radii of the specified command and its
+   * successor do not overlap.
+   */
+  void checkForOverlappingRadii(const MotionResponseCont& resp_cont, const RadiiCont& radii,
+                                const MotionResponseCont::size_type index) const;
+
   /**
    * @brief Solve each sequence item individually.
    *
+   * Items whose start state is known in advance (see predictStartStates())
+   * are planned concurrently. Their result is only kept if it starts where
+   * the previous item of the group actually ends, all other items are planned
+   * serially from the end state of the previous item.
+   *
    * @param planning_scene The planning_scene to be used for trajectory
    * generation.
    * @param req_list Container of requests for calculation/generation.
+   * @param solved_item_callback Called with the responses solved so far
+   * whenever the next item is solved.
    *
    * @return Container of generated trajectories.
    */
-  MotionResponseCont solveSequenceItems(const planning_scene::PlanningSceneConstPtr& planning_scene,
-                                        const planning_pipeline::PlanningPipelinePtr& planning_pipeline,
-                                        const moveit_msgs::msg::MotionSequenceRequest& req_list) const;
+  MotionResponseCont
+  solveSequenceItems(const planning_scene::PlanningSceneConstPtr& planning_scene,
+                     const planning_pipeline::PlanningPipelinePtr& planning_pipeline,
+                     const moveit_msgs::msg::MotionSequenceRequest& req_list,
+                     const SolvedItemCallback& solved_item_callback = SolvedItemCallback()) const;
+
+  /**
+   * @return The start state of each item, if it is known before planning.
+   * This is the case for the first item of a group and for items following
+   * an item of the same group with a joint space goal for all joints of the
+   * group.
+   */
+  StartStateCont predictStartStates(const planning_scene::PlanningScene& planning_scene,
+                                    const moveit_msgs::msg::MotionSequenceRequest& req_list) const;
 
   /**
    * @return TRUE if the blending radii of specified trajectories overlap,
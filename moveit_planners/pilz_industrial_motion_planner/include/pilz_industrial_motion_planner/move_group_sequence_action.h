@@ -34,6 +34,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
 
 #include <rclcpp_action/rclcpp_action.hpp>
@@ -69,6 +70,8 @@ private:
   void
   executeSequenceCallbackPlanAndExecute(const moveit_msgs::action::MoveGroupSequence::Goal::ConstSharedPtr& goal,
                                         const moveit_msgs::action::MoveGroupSequence::Result::SharedPtr& action_res);
+  void executeSequenceCallbackStreaming(const moveit_msgs::action::MoveGroupSequence::Goal::ConstSharedPtr& goal,
+                                        const moveit_msgs::action::MoveGroupSequence::Result::SharedPtr& action_res);
   void executeMoveCallbackPlanOnly(const moveit_msgs::action::MoveGroupSequence::Goal::ConstSharedPtr& goal,
                                    const moveit_msgs::action::MoveGroupSequence::Result::SharedPtr& res);
   void startMoveExecutionCallback();
@@ -90,5 +93,9 @@ private:
 
   move_group::MoveGroupState move_state_{ move_group::IDLE };
   std::unique_ptr<pilz_industrial_motion_planner::CommandListManager> command_list_manager_;
+
+  //! Execute the first trajectories of a sequence while the rest is still being planned
+  bool stream_execution_{ false };
+  std::atomic<bool> preempt_requested_{ false };
 };
 }  // namespace pilz_industrial_motion_planner
@@ -46,6 +46,7 @@
 
 #include <atomic>
 #include <thread>
+#include <utility>
 
 namespace pilz_industrial_motion_planner
 {
@@ -56,14 +57,21 @@ template <typename GeneratorT>
 class PlanningContextBase : public planning_interface::PlanningContext
 {
 public:
+  /**
+   * @brief Constructs the context and its generator
+   * @param generator_args additional arguments passed on to the generator constructor after model, limits and group,
+   * e.g. data precomputed by the context loader
+   */
+  template <typename... GeneratorArgs>
   PlanningContextBase<GeneratorT>(const std::string& name, const std::string& group,
                                   const moveit::core::RobotModelConstPtr& model,
-                                  const pilz_industrial_motion_planner::LimitsContainer& limits)
+                                  const pilz_industrial_motion_planner::LimitsContainer& limits,
+                                  GeneratorArgs&&... generator_args)
     : planning_interface::PlanningContext(name, group)
     , terminated_(false)
     , model_(model)
     , limits_(limits)
-    , generator_(model, limits_, group)
+    , generator_(model, limits_, group, std::forward<GeneratorArgs>(generator_args)...)
   {
   }
 
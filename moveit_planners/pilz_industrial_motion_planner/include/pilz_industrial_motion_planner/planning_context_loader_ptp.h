@@ -38,6 +38,9 @@
 
 #include <moveit/planning_interface/planning_interface.h>
 
+#include <map>
+#include <string>
+
 namespace pilz_industrial_motion_planner
 {
 /**
@@ -60,6 +63,19 @@ public:
    */
   bool loadContext(planning_interface::PlanningContextPtr& planning_context, const std::string& name,
                    const std::string& group) const override;
+
+  /// Sets the robot model and updates the limit table of the groups
+  bool setModel(const moveit::core::RobotModelConstPtr& model) override;
+
+  /// Sets the limits and updates the limit table of the groups
+  bool setLimits(const pilz_industrial_motion_planner::LimitsContainer& limits) override;
+
+private:
+  /// Computes the most strict limit of every group once model and limits are known
+  void updateGroupLimits();
+
+  /// Most strict limit of each group with complete PTP limits, so contexts don't derive it for every request
+  std::map<std::string, pilz_industrial_motion_planner::JointLimit> group_limits_;
 };
 
 typedef std::shared_ptr<PlanningContextLoaderPTP> PlanningContextLoaderPTPPtr;
@@ -62,6 +62,16 @@ public:
     : pilz_industrial_motion_planner::PlanningContextBase<TrajectoryGeneratorPTP>(name, group, model, limits)
   {
   }
+
+  /**
+   * @brief Uses the most strict limit of the group precomputed by PlanningContextLoaderPTP instead of deriving it again
+   */
+  PlanningContextPTP(const std::string& name, const std::string& group, const moveit::core::RobotModelConstPtr& model,
+                     const pilz_industrial_motion_planner::LimitsContainer& limits, const JointLimit& most_strict_limit)
+    : pilz_industrial_motion_planner::PlanningContextBase<TrajectoryGeneratorPTP>(name, group, model, limits,
+                                                                                  most_strict_limit)
+  {
+  }
 };
 
 }  // namespace pilz_industrial_motion_planner
@@ -40,6 +40,11 @@
 #include "pilz_industrial_motion_planner/trajectory_blend_request.h"
 #include "pilz_industrial_motion_planner/trajectory_blender.h"
 #include "pilz_industrial_motion_planner/trajectory_functions.h"
+#include "pilz_industrial_motion_planner/trajectory_pose_index.h"
+
+#include <map>
+#include <memory>
+#include <tuple>
 
 namespace pilz_industrial_motion_planner
 {
@@ -91,6 +96,14 @@ public:
    * outside of the blend sphere.
    *                         The first waypoint has non-zero time from start.
    * error_code: information of failed blend
+   *
+   * The link positions along the trajectories are indexed once and the index
+   * of the returned second trajectory is derived from the index of the
+   * requested one, so blending a chain of trajectories evaluates every link
+   * transform once. Blending the same trajectory objects again returns the
+   * previous result, so after changing one segment of a chain only the blends
+   * next to it are recomputed. Trajectories must therefore not be modified
+   * after they were blended.
    * @return true if succeed
    */
   bool blend(const planning_scene::PlanningSceneConstPtr& planning_scene,
@@ -117,7 +130,26 @@ private:
    * trajectory that is still inside the blend sphere
    */
   bool searchIntersectionPoints(const pilz_industrial_motion_planner::TrajectoryBlendRequest& req,
-                                std::size_t& first_interse_index, std::size_t& second_interse_index) const;
+                                std::size_t& first_interse_index, std::size_t& second_interse_index);
+
+  /**
+   * @return The index of the positions of link_name along trajectory, reused
+   * if the same trajectory was indexed before.
+   */
+  std::shared_ptr<const TrajectoryPoseIndex> getPoseIndex(const robot_trajectory::RobotTrajectoryPtr& trajectory,
+                                                          const std::string& link_name);
+
+  /**
+   * @brief Remember the index of link_name along trajectory.
+   */
+  void addPoseIndex(const robot_trajectory::RobotTrajectoryPtr& trajectory, const std::string& link_name,
+                    std::shared_ptr<const TrajectoryPoseIndex> index);
+
+  /**
+   * @brief Forget indexes and blend results of trajectories which no longer
+   * exist.
+   */
+  void removeExpiredCacheEntries();
 
   /**
    * @brief Determine how the second trajectory should be aligned with the first
@@ -176,6 +208,32 @@ private:
 private:  // static members
   // Constant to check for equality of values.
   static constexpr double EPSILON = 1e-4;
+
+private:
+  struct CachedPoseIndex
+  {
+    std::weak_ptr<const robot_trajectory::RobotTrajectory> trajectory;
+    std::size_t waypoint_count;
+    std::shared_ptr<const TrajectoryPoseIndex> index;
+  };
+
+  struct CachedBlend
+  {
+    std::weak_ptr<const robot_trajectory::RobotTrajectory> first_trajectory;
+    std::weak_ptr<const robot_trajectory::RobotTrajectory> second_trajectory;
+    std::weak_ptr<const planning_scene::PlanningScene> planning_scene;
+    pilz_industrial_motion_planner::TrajectoryBlendResponse response;
+  };
+
+  using PoseIndexKey = std::pair<const robot_trajectory::RobotTrajectory*, std::string>;
+  using BlendKey = std::tuple<const robot_trajectory::RobotTrajectory*, const robot_trajectory::RobotTrajectory*,
+                              const planning_scene::PlanningScene*, std::string, std::string, double>;
+
+  //! Link position indexes of the trajectories blended so far
+  std::map<PoseIndexKey, CachedPoseIndex> pose_indexes_;
+
+  //! Results of the blends so far
+  std::map<BlendKey, CachedBlend> blends_;
 };
 
 }  // namespace pilz_industrial_motion_planner
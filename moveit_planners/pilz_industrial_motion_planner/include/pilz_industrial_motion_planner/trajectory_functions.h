@@ -73,6 +73,28 @@ bool computePoseIK(const planning_scene::PlanningSceneConstPtr& scene, const std
                    const std::map<std::string, double>& seed, std::map<std::string, double>& solution,
                    bool check_self_collision = true, const double timeout = 0.0);
 
+/**
+ * @brief compute the inverse kinematics of a given pose in the model frame,
+ * seeded with and stored in the given robot state, also check robot self
+ * collision
+ *
+ * No robot state is created and the request is not validated, so following a
+ * sampled Cartesian path by calling this for each sample with the same state
+ * warm-starts every solve from the solution of the previous sample.
+ * @param scene: planning scene
+ * @param group: planning group, which can set state from IK for link_name
+ * @param link_name: name of target link
+ * @param pose: target pose in the model frame
+ * @param rstate: seed of the IK solver, set to the solution on success
+ * @param check_self_collision: true to enable self collision checking after IK
+ * computation
+ * @param timeout: timeout for IK, if not set the default solver timeout is used
+ * @return true if succeed
+ */
+bool computePoseIK(const planning_scene::PlanningSceneConstPtr& scene, const moveit::core::JointModelGroup* group,
+                   const std::string& link_name, const Eigen::Isometry3d& pose, moveit::core::RobotState& rstate,
+                   bool check_self_collision = true, const double timeout = 0.0);
+
 /**
  * @brief compute the pose of a link at give robot state
  * @param robot_model: kinematic model of the robot
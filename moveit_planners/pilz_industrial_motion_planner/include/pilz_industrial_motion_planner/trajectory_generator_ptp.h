@@ -64,12 +64,35 @@ public:
                          const pilz_industrial_motion_planner::LimitsContainer& planner_limits,
                          const std::string& group_name);
 
+  /**
+   * @brief Constructor of PTP Trajectory Generator with the most strict joint limit of the group already computed,
+   * e.g. by PlanningContextLoaderPTP at load time
+   * @throw TrajectoryGeneratorInvalidLimitsException
+   * @param most_strict_limit: common limit of all active joints of the group, must contain velocity, acceleration and
+   * deceleration limits
+   */
+  TrajectoryGeneratorPTP(const moveit::core::RobotModelConstPtr& robot_model,
+                         const pilz_industrial_motion_planner::LimitsContainer& planner_limits,
+                         const std::string& group_name, const JointLimit& most_strict_limit);
+
+  /**
+   * @brief Computes the most strict limit of all active joints of a group
+   * @throw TrajectoryGeneratorInvalidLimitsException if the group is invalid or misses velocity, acceleration or
+   * deceleration limits
+   */
+  static JointLimit getMostStrictLimit(const moveit::core::RobotModelConstPtr& robot_model,
+                                       const JointLimitsContainer& joint_limits, const std::string& group_name);
+
 private:
   void extractMotionPlanInfo(const planning_scene::PlanningSceneConstPtr& scene,
                              const planning_interface::MotionPlanRequest& req, MotionPlanInfo& info) const override;
 
   /**
    * @brief plan ptp joint trajectory with zero start velocity
+   *
+   * All joints share the most strict limit, so after full synchronization every joint follows the profile of the
+   * leading axis scaled by its own distance. The trajectory is therefore filled in one pass from a single normalized
+   * profile instead of evaluating one velocity profile per joint and sample.
    * @param start_pos
    * @param goal_pos
    * @param joint_trajectory
@@ -0,0 +1,91 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <eigen_stl_containers/eigen_stl_vector_container.h>
+#include <moveit/robot_trajectory/robot_trajectory.h>
+
+namespace pilz_industrial_motion_planner
+{
+/**
+ * @brief Positions of a link along a robot trajectory, together with the
+ * path length from the first waypoint up to each waypoint.
+ *
+ * The link transforms are only evaluated once. Searches for the intersection
+ * with a blend sphere skip the part of the trajectory which is too short to
+ * leave the sphere, found by binary search on the path length.
+ */
+class TrajectoryPoseIndex
+{
+public:
+  TrajectoryPoseIndex(const robot_trajectory::RobotTrajectory& trajectory, const std::string& link_name);
+
+  /**
+   * @brief Index of the waypoints [first_waypoint, end] of the trajectory
+   * indexed by other, without evaluating any link transform.
+   */
+  TrajectoryPoseIndex(const TrajectoryPoseIndex& other, std::size_t first_waypoint);
+
+  std::size_t size() const
+  {
+    return positions_.size();
+  }
+
+  const Eigen::Vector3d& getPosition(std::size_t index) const
+  {
+    return positions_.at(index);
+  }
+
+  double getDistanceFromStart(std::size_t index) const
+  {
+    return distances_from_start_.at(index);
+  }
+
+  /**
+   * @brief Same result as linearSearchIntersectionPoint() on the indexed
+   * trajectory.
+   */
+  bool searchIntersectionPoint(const Eigen::Vector3d& center_position, double r, bool inverse_order,
+                               std::size_t& index) const;
+
+private:
+  EigenSTL::vector_Vector3d positions_;
+  std::vector<double> distances_from_start_;
+};
+
+}  // namespace pilz_industrial_motion_planner
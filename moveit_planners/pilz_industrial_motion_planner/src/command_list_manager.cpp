@@ -36,15 +36,21 @@
 
 #include <rclcpp/logger.hpp>
 #include <rclcpp/logging.hpp>
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <functional>
+#include <future>
+#include <map>
 #include <sstream>
+#include <thread>
 
 #include <moveit/planning_pipeline/planning_pipeline.h>
 #include <moveit/robot_state/conversions.h>
 #include "pilz_industrial_motion_planner/cartesian_limits_aggregator.h"
 #include "pilz_industrial_motion_planner/joint_limits_aggregator.h"
 #include "pilz_industrial_motion_planner/tip_frame_getter.h"
+#include "pilz_industrial_motion_planner/trajectory_functions.h"
 #include "pilz_industrial_motion_planner/trajectory_blend_request.h"
 #include "pilz_industrial_motion_planner/trajectory_blender_transition_window.h"
 
@@ -52,6 +58,8 @@ namespace pilz_industrial_motion_planner
 {
 static const std::string PARAM_NAMESPACE_LIMITS = "robot_description_planning";
 static const rclcpp::Logger LOGGER = rclcpp::get_logger("moveit.pilz_industrial_motion_planner.command_list_manager");
+//! Tolerance on the start state of an item planned from a predicted start state
+static constexpr double ROBOT_STATE_EQUALITY_EPSILON = 1e-4;
 
 CommandListManager::CommandListManager(const rclcpp::Node::SharedPtr& node,
                                        const moveit::core::RobotModelConstPtr& model)
@@ -107,6 +115,48 @@ RobotTrajCont CommandListManager::solve(const planning_scene::PlanningSceneConst
   return plan_comp_builder_.build();
 }
 
+RobotTrajCont CommandListManager::solve(const planning_scene::PlanningSceneConstPtr& planning_scene,
+                                        const planning_pipeline::PlanningPipelinePtr& planning_pipeline,
+                                        const moveit_msgs::msg::MotionSequenceRequest& req_list,
+                                        const TrajectoryCallback& trajectory_callback)
+{
+  if (req_list.items.empty())
+  {
+    return RobotTrajCont();
+  }
+
+  checkForNegativeRadii(req_list);
+  checkLastBlendRadiusZero(req_list);
+  checkStartStates(req_list);
+
+  assert(model_);
+  RadiiCont radii{ extractBlendRadii(*model_, req_list) };
+
+  RobotTrajCont traj_cont;
+  plan_comp_builder_.reset();
+  solveSequenceItems(planning_scene, planning_pipeline, req_list, [&](const MotionResponseCont& resp_cont) {
+    const MotionResponseCont::size_type i{ resp_cont.size() - 1 };
+    // The radii of the previous item can be checked as soon as its successor is known
+    if (i > 0 && i + 2 <= radii.size())
+    {
+      checkForOverlappingRadii(resp_cont, radii, i - 1);
+    }
+    plan_comp_builder_.append(planning_scene, resp_cont.back().trajectory_, (i > 0 ? radii.at(i - 1) : 0.));
+
+    // Without blending into the next item the chain of blended items is final
+    if (radii.at(i) == 0.)
+    {
+      for (const robot_trajectory::RobotTrajectoryPtr& traj : plan_comp_builder_.build())
+      {
+        traj_cont.push_back(traj);
+        trajectory_callback(traj);
+      }
+      plan_comp_builder_.reset();
+    }
+  });
+  return traj_cont;
+}
+
 bool CommandListManager::checkRadiiForOverlap(const robot_trajectory::RobotTrajectory& traj_A, const double radii_A,
                                               const robot_trajectory::RobotTrajectory& traj_B,
                                               const double radii_B) const
@@ -143,13 +193,19 @@ void CommandListManager::checkForOverlappingRadii(const MotionResponseCont& resp
 
   for (MotionResponseCont::size_type i = 0; i < resp_cont.size() - 2; ++i)
   {
-    if (checkRadiiForOverlap(*(resp_cont.at(i).trajectory_), radii.at(i), *(resp_cont.at(i + 1).trajectory_),
-                             radii.at(i + 1)))
-    {
-      std::ostringstream os;
-      os << "Overlapping blend radii between command [" << i << "] and [" << i + 1 << "].";
-      throw OverlappingBlendRadiiException(os.str());
-    }
+    checkForOverlappingRadii(resp_cont, radii, i);
+  }
+}
+
+void CommandListManager::checkForOverlappingRadii(const MotionResponseCont& resp_cont, const RadiiCont& radii,
+                                                  const MotionResponseCont::size_type index) const
+{
+  if (checkRadiiForOverlap(*(resp_cont.at(index).trajectory_), radii.at(index),
+                           *(resp_cont.at(index + 1).trajectory_), radii.at(index + 1)))
+  {
+    std::ostringstream os;
+    os << "Overlapping blend radii between command [" << index << "] and [" << index + 1 << "].";
+    throw OverlappingBlendRadiiException(os.str());
   }
 }
 
@@ -227,30 +283,160 @@ CommandListManager::extractBlendRadii(const moveit::core::RobotModel& model,
 CommandListManager::MotionResponseCont
 CommandListManager::solveSequenceItems(const planning_scene::PlanningSceneConstPtr& planning_scene,
                                        const planning_pipeline::PlanningPipelinePtr& planning_pipeline,
-                                       const moveit_msgs::msg::MotionSequenceRequest& req_list) const
+                                       const moveit_msgs::msg::MotionSequenceRequest& req_list,
+                                       const SolvedItemCallback& solved_item_callback) const
 {
-  MotionResponseCont motion_plan_responses;
-  size_t curr_req_index{ 0 };
   const size_t num_req{ req_list.items.size() };
-  for (const auto& seq_item : req_list.items)
+
+  // Plan all items whose start state is known in advance concurrently in the background
+  StartStateCont start_states{ predictStartStates(*planning_scene, req_list) };
+  MotionResponseCont predicted_responses(num_req);
+  std::vector<std::promise<void>> predicted(num_req);
+  std::vector<std::future<void>> predicted_ready;
+  for (std::promise<void>& promise : predicted)
   {
-    planning_interface::MotionPlanRequest req{ seq_item.req };
-    setStartState(motion_plan_responses, req.group_name, req.start_state);
+    predicted_ready.emplace_back(promise.get_future());
+  }
+  std::atomic<size_t> next{ 0 };
+  auto plan_predicted = [&]() {
+    for (size_t i = next++; i < num_req; i = next++)
+    {
+      if (start_states.at(i))
+      {
+        planning_interface::MotionPlanRequest req{ req_list.items.at(i).req };
+        req.start_state = start_states.at(i).value();
+        planning_pipeline->generatePlan(planning_scene, req, predicted_responses.at(i));
+      }
+      predicted.at(i).set_value();
+    }
+  };
+  const size_t num_predicted = std::count_if(start_states.cbegin(), start_states.cend(),
+                                             [](const auto& start_state) { return start_state.has_value(); });
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), num_predicted); ++i)
+  {
+    threads.emplace_back(plan_predicted);
+  }
+  auto join_threads = [&]() {
+    for (std::thread& thread : threads)
+    {
+      thread.join();
+    }
+  };
 
-    planning_interface::MotionPlanResponse res;
-    planning_pipeline->generatePlan(planning_scene, req, res);
-    if (res.error_code_.val != res.error_code_.SUCCESS)
+  // Keep the concurrent results that really start where the previous item of their group ends, plan the rest serially
+  MotionResponseCont motion_plan_responses;
+  try
+  {
+    size_t curr_req_index{ 0 };
+    for (size_t i = 0; i < num_req; ++i)
     {
-      std::ostringstream os;
-      os << "Could not solve request\n";  // TODO(henning): re-enable "---\n" << req << "\n---\n";
-      throw PlanningPipelineException(os.str(), res.error_code_.val);
+      planning_interface::MotionPlanRequest req{ req_list.items.at(i).req };
+      RobotState_OptRef previous_end_state{ getPreviousEndState(motion_plan_responses, req.group_name) };
+
+      if (!threads.empty())
+      {
+        predicted_ready.at(i).wait();
+      }
+      planning_interface::MotionPlanResponse res{ predicted_responses.at(i) };
+      const bool reuse{ start_states.at(i) &&
+                        (!previous_end_state ||
+                         (res.error_code_.val == res.error_code_.SUCCESS &&
+                          isRobotStateEqual(previous_end_state.value(), res.trajectory_->getFirstWayPoint(),
+                                            req.group_name, ROBOT_STATE_EQUALITY_EPSILON))) };
+      if (!reuse)
+      {
+        setStartState(motion_plan_responses, req.group_name, req.start_state);
+        res = planning_interface::MotionPlanResponse();
+        planning_pipeline->generatePlan(planning_scene, req, res);
+      }
+      if (res.error_code_.val != res.error_code_.SUCCESS)
+      {
+        std::ostringstream os;
+        os << "Could not solve request\n";  // TODO(henning): re-enable "---\n" << req << "\n---\n";
+        throw PlanningPipelineException(os.str(), res.error_code_.val);
+      }
+      motion_plan_responses.emplace_back(res);
+      RCLCPP_DEBUG_STREAM(LOGGER, "Solved [" << ++curr_req_index << "/" << num_req << "]"
+                                             << (reuse ? " (planned concurrently)" : ""));
+      if (solved_item_callback)
+      {
+        solved_item_callback(motion_plan_responses);
+      }
     }
-    motion_plan_responses.emplace_back(res);
-    RCLCPP_DEBUG_STREAM(LOGGER, "Solved [" << ++curr_req_index << "/" << num_req << "]");
   }
+  catch (...)
+  {
+    // Let the background threads stop after their current item
+    next = num_req;
+    join_threads();
+    throw;
+  }
+  join_threads();
   return motion_plan_responses;
 }
 
+CommandListManager::StartStateCont
+CommandListManager::predictStartStates(const planning_scene::PlanningScene& planning_scene,
+                                       const moveit_msgs::msg::MotionSequenceRequest& req_list) const
+{
+  StartStateCont start_states;
+  // End state of the last item of each group, if it is known before planning
+  std::map<std::string, std::optional<moveit::core::RobotState>> end_states;
+  for (const moveit_msgs::msg::MotionSequenceItem& item : req_list.items)
+  {
+    const std::string& group_name{ item.req.group_name };
+    auto end_state_it{ end_states.find(group_name) };
+    if (end_state_it == end_states.end())
+    {
+      // The first item of a group starts in its own start state
+      start_states.emplace_back(item.req.start_state);
+      moveit::core::RobotState start_state{ planning_scene.getCurrentState() };
+      if (item.req.start_state.is_diff || !item.req.start_state.joint_state.name.empty() ||
+          !item.req.start_state.multi_dof_joint_state.joint_names.empty())
+      {
+        moveit::core::robotStateMsgToRobotState(item.req.start_state, start_state);
+      }
+      end_state_it = end_states.emplace(group_name, start_state).first;
+    }
+    else if (end_state_it->second)
+    {
+      start_states.emplace_back(moveit_msgs::msg::RobotState());
+      moveit::core::robotStateToRobotStateMsg(end_state_it->second.value(), start_states.back().value());
+    }
+    else
+    {
+      start_states.emplace_back();
+    }
+
+    // Only a goal in joint space for all joints of the group tells where the item ends
+    const moveit::core::JointModelGroup* group{ model_->getJointModelGroup(group_name) };
+    if (!end_state_it->second || !group || item.req.goal_constraints.size() != 1 ||
+        !item.req.goal_constraints.front().position_constraints.empty() ||
+        !item.req.goal_constraints.front().orientation_constraints.empty())
+    {
+      end_state_it->second.reset();
+      continue;
+    }
+    std::map<std::string, double> goal_positions;
+    for (const moveit_msgs::msg::JointConstraint& joint_constraint :
+         item.req.goal_constraints.front().joint_constraints)
+    {
+      goal_positions[joint_constraint.joint_name] = joint_constraint.position;
+    }
+    const std::vector<std::string>& joint_names{ group->getActiveJointModelNames() };
+    if (!std::all_of(joint_names.cbegin(), joint_names.cend(),
+                     [&goal_positions](const std::string& name) { return goal_positions.count(name) > 0; }))
+    {
+      end_state_it->second.reset();
+      continue;
+    }
+    end_state_it->second->setVariablePositions(goal_positions);
+    end_state_it->second->update();
+  }
+  return start_states;
+}
+
 void CommandListManager::checkForNegativeRadii(const moveit_msgs::msg::MotionSequenceRequest& req_list)
 {
   if (!std::all_of(req_list.items.begin(), req_list.items.end(),
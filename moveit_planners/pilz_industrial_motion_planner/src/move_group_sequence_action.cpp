@@ -40,6 +40,11 @@
 
 #include <time.h>
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
 #include <moveit/kinematic_constraints/utils.h>
 #include <moveit/plan_execution/plan_execution.h>
 #include <moveit/plan_execution/plan_with_sensing.h>
@@ -87,6 +92,12 @@ void MoveGroupSequenceAction::initialize()
 
   command_list_manager_ = std::make_unique<pilz_industrial_motion_planner::CommandListManager>(
       context_->moveit_cpp_->getNode(), context_->planning_scene_monitor_->getRobotModel());
+
+  context_->moveit_cpp_->getNode()->get_parameter_or("stream_sequence_execution", stream_execution_, false);
+  if (stream_execution_)
+  {
+    RCLCPP_INFO(LOGGER, "Sequences are executed while they are planned");
+  }
 }
 
 void MoveGroupSequenceAction::executeSequenceCallback(const std::shared_ptr<MoveGroupSequenceGoalHandle> goal_handle)
@@ -124,6 +135,10 @@ void MoveGroupSequenceAction::executeSequenceCallback(const std::shared_ptr<Move
     }
     executeMoveCallbackPlanOnly(goal, action_res);
   }
+  else if (stream_execution_)
+  {
+    executeSequenceCallbackStreaming(goal, action_res);
+  }
   else
   {
     executeSequenceCallbackPlanAndExecute(goal, action_res);
@@ -163,7 +178,7 @@ void MoveGroupSequenceAction::executeSequenceCallbackPlanAndExecute(
   opt.replan_delay_ = goal->planning_options.replan_delay;
   opt.before_execution_callback_ = [this] { startMoveExecutionCallback(); };
 
-  [this, &request = goal->request](plan_execution::ExecutableMotionPlan& plan) {
+  opt.plan_callback_ = [this, &request = goal->request](plan_execution::ExecutableMotionPlan& plan) {
     return planUsingSequenceManager(request, plan);
   };
   if (goal->planning_options.look_around && context_->plan_with_sensing_)
@@ -187,6 +202,158 @@ void MoveGroupSequenceAction::executeSequenceCallbackPlanAndExecute(
   action_res->response.error_code = plan.error_code_;
 }
 
+void MoveGroupSequenceAction::executeSequenceCallbackStreaming(
+    const moveit_msgs::action::MoveGroupSequence::Goal::ConstSharedPtr& goal,
+    const moveit_msgs::action::MoveGroupSequence::Result::SharedPtr& action_res)
+{
+  RCLCPP_INFO(LOGGER, "Streaming planning and execution request received for MoveGroupSequenceAction.");
+
+  if (goal->planning_options.look_around && context_->plan_with_sensing_)
+  {
+    RCLCPP_WARN(LOGGER, "Plan with sensing not yet implemented/tested. This option is ignored.");  // LCOV_EXCL_LINE
+  }
+  if (goal->planning_options.replan)
+  {
+    RCLCPP_WARN(LOGGER, "Replanning is not supported while streaming. This option is ignored.");
+  }
+
+  // Plan on a copy of the scene, the monitor must keep updating the scene while the robot moves
+  planning_scene::PlanningScenePtr the_scene;
+  {
+    planning_scene_monitor::LockedPlanningSceneRO lscene(context_->planning_scene_monitor_);
+    the_scene = planning_scene::PlanningScene::clone(lscene);
+  }
+  if (!moveit::core::isEmpty(goal->planning_options.planning_scene_diff))
+  {
+    the_scene->setPlanningSceneDiffMsg(
+        moveit::core::isEmpty(goal->planning_options.planning_scene_diff.robot_state) ?
+            goal->planning_options.planning_scene_diff :
+            clearSceneRobotState(goal->planning_options.planning_scene_diff));
+  }
+
+  // Select planning_pipeline to handle request
+  // All motions in the SequenceRequest need to use the same planning pipeline (but can use different planners)
+  const planning_pipeline::PlanningPipelinePtr planning_pipeline =
+      resolvePlanningPipeline(goal->request.items[0].req.pipeline_id);
+  if (!planning_pipeline)
+  {
+    RCLCPP_ERROR_STREAM(LOGGER, "Could not load planning pipeline " << goal->request.items[0].req.pipeline_id);
+    action_res->response.error_code.val = moveit_msgs::msg::MoveItErrorCodes::FAILURE;
+    return;
+  }
+
+  // Planning runs in the background and hands over every trajectory as soon as it is final
+  std::mutex queue_mutex;
+  std::condition_variable queue_condition;
+  std::deque<robot_trajectory::RobotTrajectoryPtr> queue;
+  bool planning_done{ false };
+  moveit_msgs::msg::MoveItErrorCodes planning_error_code;
+  planning_error_code.val = moveit_msgs::msg::MoveItErrorCodes::SUCCESS;
+  double planning_time{ 0. };
+
+  preempt_requested_ = false;
+  const rclcpp::Time planning_start = context_->moveit_cpp_->getNode()->now();
+  std::thread planning_thread([&]() {
+    try
+    {
+      command_list_manager_->solve(the_scene, planning_pipeline, goal->request,
+                                   [&](const robot_trajectory::RobotTrajectoryPtr& traj) {
+                                     std::scoped_lock lock(queue_mutex);
+                                     queue.push_back(traj);
+                                     queue_condition.notify_one();
+                                   });
+    }
+    catch (const MoveItErrorCodeException& ex)
+    {
+      RCLCPP_ERROR_STREAM(LOGGER, "Planning pipeline threw an exception (error code: " << ex.getErrorCode()
+                                                                                       << "): " << ex.what());
+      planning_error_code.val = ex.getErrorCode();
+    }
+    // LCOV_EXCL_START // Keep MoveIt up even if lower parts throw
+    catch (const std::exception& ex)
+    {
+      RCLCPP_ERROR_STREAM(LOGGER, "Planning pipeline threw an exception: " << ex.what());
+      planning_error_code.val = moveit_msgs::msg::MoveItErrorCodes::FAILURE;
+    }
+    // LCOV_EXCL_STOP
+    std::scoped_lock lock(queue_mutex);
+    planning_time = (context_->moveit_cpp_->getNode()->now() - planning_start).seconds();
+    planning_done = true;
+    queue_condition.notify_one();
+  });
+
+  // Execute the trajectories one after the other, the robot is at rest between them
+  RobotTrajCont executed_trajs;
+  moveit_controller_manager::ExecutionStatus execution_status{ moveit_controller_manager::ExecutionStatus::SUCCEEDED };
+  while (true)
+  {
+    robot_trajectory::RobotTrajectoryPtr traj;
+    {
+      std::unique_lock<std::mutex> lock(queue_mutex);
+      queue_condition.wait(lock, [&]() { return !queue.empty() || planning_done; });
+      if (queue.empty())
+      {
+        break;
+      }
+      traj = queue.front();
+      queue.pop_front();
+    }
+    // Once execution failed, the remaining trajectories are only collected until planning finishes
+    if (execution_status != moveit_controller_manager::ExecutionStatus::SUCCEEDED || preempt_requested_)
+    {
+      continue;
+    }
+
+    startMoveExecutionCallback();
+    moveit_msgs::msg::RobotTrajectory traj_msg;
+    traj->getRobotTrajectoryMsg(traj_msg);
+    if (!context_->trajectory_execution_manager_->push(traj_msg))
+    {
+      RCLCPP_ERROR(LOGGER, "Failed to push trajectory for execution");
+      execution_status = moveit_controller_manager::ExecutionStatus::ABORTED;
+      continue;
+    }
+    executed_trajs.push_back(traj);
+    execution_status = context_->trajectory_execution_manager_->executeAndWait();
+  }
+  planning_thread.join();
+
+  StartStatesMsg start_states_msg;
+  start_states_msg.resize(executed_trajs.size());
+  action_res->response.planned_trajectories.resize(executed_trajs.size());
+  for (RobotTrajCont::size_type i = 0; i < executed_trajs.size(); ++i)
+  {
+    move_group::MoveGroupCapability::convertToMsg(executed_trajs.at(i), start_states_msg.at(i),
+                                                  action_res->response.planned_trajectories.at(i));
+  }
+  try
+  {
+    action_res->response.sequence_start = start_states_msg.at(0);
+  }
+  catch (std::out_of_range&)
+  {
+    RCLCPP_WARN(LOGGER, "Can not determine start state from empty sequence.");
+  }
+  action_res->response.planning_time = planning_time;
+
+  if (preempt_requested_)
+  {
+    action_res->response.error_code.val = moveit_msgs::msg::MoveItErrorCodes::PREEMPTED;
+  }
+  else if (execution_status == moveit_controller_manager::ExecutionStatus::SUCCEEDED)
+  {
+    action_res->response.error_code = planning_error_code;
+  }
+  else if (execution_status == moveit_controller_manager::ExecutionStatus::TIMED_OUT)
+  {
+    action_res->response.error_code.val = moveit_msgs::msg::MoveItErrorCodes::TIMED_OUT;
+  }
+  else
+  {
+    action_res->response.error_code.val = moveit_msgs::msg::MoveItErrorCodes::CONTROL_FAILED;
+  }
+}
+
 void MoveGroupSequenceAction::convertToMsg(const ExecutableTrajs& trajs, StartStatesMsg& start_states_msg,
                                            PlannedTrajMsgs& planned_trajs_msgs)
 {
@@ -325,7 +492,12 @@ void MoveGroupSequenceAction::startMoveExecutionCallback()
 
 void MoveGroupSequenceAction::preemptMoveCallback()
 {
+  preempt_requested_ = true;
   context_->plan_execution_->stop();
+  if (stream_execution_)
+  {
+    context_->trajectory_execution_manager_->stopExecution();
+  }
 }
 
 void MoveGroupSequenceAction::setMoveState(move_group::MoveGroupState state)
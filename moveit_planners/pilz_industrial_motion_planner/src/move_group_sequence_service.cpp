@@ -63,7 +63,8 @@ void MoveGroupSequenceService::initialize()
   sequence_service_ = context_->moveit_cpp_->getNode()->create_service<moveit_msgs::srv::GetMotionSequence>(
       SEQUENCE_SERVICE_NAME,
       [this](const moveit_msgs::srv::GetMotionSequence::Request::SharedPtr req,
-             moveit_msgs::srv::GetMotionSequence::Response::SharedPtr res) { return plan(req, res); });
+             moveit_msgs::srv::GetMotionSequence::Response::SharedPtr res) { return plan(req, res); },
+      rmw_qos_profile_services_default, callback_group_);
 }
 
 bool MoveGroupSequenceService::plan(const moveit_msgs::srv::GetMotionSequence::Request::SharedPtr req,
@@ -58,7 +58,11 @@ bool pilz_industrial_motion_planner::PlanningContextLoaderPTP::loadContext(
 {
   if (limits_set_ && model_set_)
   {
-    planning_context = std::make_shared<PlanningContextPTP>(name, group, model_, limits_);
+    const auto group_limit = group_limits_.find(group);
+    if (group_limit != group_limits_.end())
+      planning_context = std::make_shared<PlanningContextPTP>(name, group, model_, limits_, group_limit->second);
+    else
+      planning_context = std::make_shared<PlanningContextPTP>(name, group, model_, limits_);
     return true;
   }
   else
@@ -76,5 +80,41 @@ bool pilz_industrial_motion_planner::PlanningContextLoaderPTP::loadContext(
   }
 }
 
+bool pilz_industrial_motion_planner::PlanningContextLoaderPTP::setModel(const moveit::core::RobotModelConstPtr& model)
+{
+  PlanningContextLoader::setModel(model);
+  updateGroupLimits();
+  return true;
+}
+
+bool pilz_industrial_motion_planner::PlanningContextLoaderPTP::setLimits(
+    const pilz_industrial_motion_planner::LimitsContainer& limits)
+{
+  PlanningContextLoader::setLimits(limits);
+  updateGroupLimits();
+  return true;
+}
+
+void pilz_industrial_motion_planner::PlanningContextLoaderPTP::updateGroupLimits()
+{
+  group_limits_.clear();
+  if (!limits_set_ || !model_set_ || !limits_.hasJointLimits())
+    return;
+
+  for (const std::string& group : model_->getJointModelGroupNames())
+  {
+    try
+    {
+      group_limits_[group] =
+          TrajectoryGeneratorPTP::getMostStrictLimit(model_, limits_.getJointLimitContainer(), group);
+    }
+    catch (const std::exception& ex)
+    {
+      // contexts of this group derive the limit themselves and report the problem on construction
+      RCLCPP_DEBUG_STREAM(LOGGER, "No PTP limit table entry for group " << group << ": " << ex.what());
+    }
+  }
+}
+
 PLUGINLIB_EXPORT_CLASS(pilz_industrial_motion_planner::PlanningContextLoaderPTP,
                        pilz_industrial_motion_planner::PlanningContextLoader)
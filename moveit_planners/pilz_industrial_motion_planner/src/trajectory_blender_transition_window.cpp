@@ -57,6 +57,17 @@ bool pilz_industrial_motion_planner::TrajectoryBlenderTransitionWindow::blend(
 {
   RCLCPP_INFO(LOGGER, "Start trajectory blending using transition window.");
 
+  removeExpiredCacheEntries();
+  const BlendKey blend_key{ req.first_trajectory.get(), req.second_trajectory.get(), planning_scene.get(),
+                            req.group_name,             req.link_name,             req.blend_radius };
+  auto cached_blend = blends_.find(blend_key);
+  if (cached_blend != blends_.end())
+  {
+    RCLCPP_INFO(LOGGER, "Reusing the previous blend of the same trajectories.");
+    res = cached_blend->second.response;
+    return true;
+  }
+
   double sampling_time = 0.;
   if (!validateRequest(req, sampling_time, res.error_code))
   {
@@ -139,6 +150,12 @@ bool pilz_industrial_motion_planner::TrajectoryBlenderTransitionWindow::blend(
   res.second_trajectory->setWayPointDurationFromPrevious(0, sampling_time);
 
   res.error_code.val = moveit_msgs::msg::MoveItErrorCodes::SUCCESS;
+
+  // the remaining second trajectory is the first trajectory of the next blend in a chain
+  addPoseIndex(res.second_trajectory, req.link_name,
+               std::make_shared<TrajectoryPoseIndex>(*getPoseIndex(req.second_trajectory, req.link_name),
+                                                     second_intersection_index + 1));
+  blends_[blend_key] = { req.first_trajectory, req.second_trajectory, planning_scene, res };
   return true;
 }
 
@@ -267,25 +284,25 @@ void pilz_industrial_motion_planner::TrajectoryBlenderTransitionWindow::blendTra
 
 bool pilz_industrial_motion_planner::TrajectoryBlenderTransitionWindow::searchIntersectionPoints(
     const pilz_industrial_motion_planner::TrajectoryBlendRequest& req, std::size_t& first_interse_index,
-    std::size_t& second_interse_index) const
+    std::size_t& second_interse_index)
 {
   RCLCPP_INFO(LOGGER, "Search for start and end point of blending trajectory.");
 
   // compute the position of the center of the blend sphere
   // (last point of the first trajectory, first point of the second trajectory)
-  Eigen::Isometry3d circ_pose = req.first_trajectory->getLastWayPoint().getFrameTransform(req.link_name);
+  std::shared_ptr<const TrajectoryPoseIndex> first_index{ getPoseIndex(req.first_trajectory, req.link_name) };
+  std::shared_ptr<const TrajectoryPoseIndex> second_index{ getPoseIndex(req.second_trajectory, req.link_name) };
+  const Eigen::Vector3d circ_position{ first_index->getPosition(first_index->size() - 1) };
 
   // Searh for intersection points according to distance
-  if (!linearSearchIntersectionPoint(req.link_name, circ_pose.translation(), req.blend_radius, req.first_trajectory,
-                                     true, first_interse_index))
+  if (!first_index->searchIntersectionPoint(circ_position, req.blend_radius, true, first_interse_index))
   {
     RCLCPP_ERROR_STREAM(LOGGER, "Intersection point of first trajectory not found.");
     return false;
   }
   RCLCPP_INFO_STREAM(LOGGER, "Intersection point of first trajectory found, index: " << first_interse_index);
 
-  if (!linearSearchIntersectionPoint(req.link_name, circ_pose.translation(), req.blend_radius, req.second_trajectory,
-                                     false, second_interse_index))
+  if (!second_index->searchIntersectionPoint(circ_position, req.blend_radius, false, second_interse_index))
   {
     RCLCPP_ERROR_STREAM(LOGGER, "Intersection point of second trajectory not found.");
     return false;
@@ -311,3 +328,39 @@ void pilz_industrial_motion_planner::TrajectoryBlenderTransitionWindow::determin
     blend_align_index = first_interse_index;
   }
 }
+
+std::shared_ptr<const pilz_industrial_motion_planner::TrajectoryPoseIndex>
+pilz_industrial_motion_planner::TrajectoryBlenderTransitionWindow::getPoseIndex(
+    const robot_trajectory::RobotTrajectoryPtr& trajectory, const std::string& link_name)
+{
+  auto cached_index = pose_indexes_.find({ trajectory.get(), link_name });
+  if (cached_index != pose_indexes_.end() && !cached_index->second.trajectory.expired() &&
+      cached_index->second.waypoint_count == trajectory->getWayPointCount())
+  {
+    return cached_index->second.index;
+  }
+  auto index = std::make_shared<const TrajectoryPoseIndex>(*trajectory, link_name);
+  addPoseIndex(trajectory, link_name, index);
+  return index;
+}
+
+void pilz_industrial_motion_planner::TrajectoryBlenderTransitionWindow::addPoseIndex(
+    const robot_trajectory::RobotTrajectoryPtr& trajectory, const std::string& link_name,
+    std::shared_ptr<const TrajectoryPoseIndex> index)
+{
+  pose_indexes_[{ trajectory.get(), link_name }] = { trajectory, trajectory->getWayPointCount(), std::move(index) };
+}
+
+void pilz_industrial_motion_planner::TrajectoryBlenderTransitionWindow::removeExpiredCacheEntries()
+{
+  for (auto it = pose_indexes_.begin(); it != pose_indexes_.end();)
+  {
+    it = it->second.trajectory.expired() ? pose_indexes_.erase(it) : std::next(it);
+  }
+  for (auto it = blends_.begin(); it != blends_.end();)
+  {
+    const bool expired{ it->second.first_trajectory.expired() || it->second.second_trajectory.expired() ||
+                        it->second.planning_scene.expired() };
+    it = expired ? blends_.erase(it) : std::next(it);
+  }
+}
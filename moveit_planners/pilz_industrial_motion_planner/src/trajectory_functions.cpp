@@ -51,30 +51,52 @@ namespace
 static const rclcpp::Logger LOGGER = rclcpp::get_logger("moveit.pilz_industrial_motion_planner.trajectory_functions");
 }
 
-bool pilz_industrial_motion_planner::computePoseIK(const planning_scene::PlanningSceneConstPtr& scene,
-                                                   const std::string& group_name, const std::string& link_name,
-                                                   const Eigen::Isometry3d& pose, const std::string& frame_id,
-                                                   const std::map<std::string, double>& seed,
-                                                   std::map<std::string, double>& solution, bool check_self_collision,
-                                                   const double timeout)
+namespace
 {
-  const moveit::core::RobotModelConstPtr& robot_model = scene->getRobotModel();
-  if (!robot_model->hasJointModelGroup(group_name))
+bool validateIKRequest(const moveit::core::RobotModel& robot_model, const std::string& group_name,
+                       const std::string& link_name, const std::string& frame_id)
+{
+  if (!robot_model.hasJointModelGroup(group_name))
   {
     RCLCPP_ERROR_STREAM(LOGGER, "Robot model has no planning group named as " << group_name);
     return false;
   }
 
-  if (!robot_model->getJointModelGroup(group_name)->canSetStateFromIK(link_name))
+  if (!robot_model.getJointModelGroup(group_name)->canSetStateFromIK(link_name))
   {
     RCLCPP_ERROR_STREAM(LOGGER, "No valid IK solver exists for " << link_name << " in planning group " << group_name);
     return false;
   }
 
-  if (frame_id != robot_model->getModelFrame())
+  if (frame_id != robot_model.getModelFrame())
   {
     RCLCPP_ERROR_STREAM(LOGGER, "Given frame (" << frame_id << ") is unequal to model frame("
-                                                << robot_model->getModelFrame() << ")");
+                                                << robot_model.getModelFrame() << ")");
+    return false;
+  }
+  return true;
+}
+
+void copyGroupPositions(const moveit::core::RobotState& rstate, const std::vector<std::string>& joint_names,
+                        std::map<std::string, double>& positions)
+{
+  for (const auto& joint_name : joint_names)
+  {
+    positions[joint_name] = rstate.getVariablePosition(joint_name);
+  }
+}
+}  // namespace
+
+bool pilz_industrial_motion_planner::computePoseIK(const planning_scene::PlanningSceneConstPtr& scene,
+                                                   const std::string& group_name, const std::string& link_name,
+                                                   const Eigen::Isometry3d& pose, const std::string& frame_id,
+                                                   const std::map<std::string, double>& seed,
+                                                   std::map<std::string, double>& solution, bool check_self_collision,
+                                                   const double timeout)
+{
+  const moveit::core::RobotModelConstPtr& robot_model = scene->getRobotModel();
+  if (!validateIKRequest(*robot_model, group_name, link_name, frame_id))
+  {
     return false;
   }
 
@@ -84,6 +106,22 @@ bool pilz_industrial_motion_planner::computePoseIK(const planning_scene::Plannin
   rstate.setToDefaultValues();
   rstate.setVariablePositions(seed);
 
+  const moveit::core::JointModelGroup* group = robot_model->getJointModelGroup(group_name);
+  if (!computePoseIK(scene, group, link_name, pose, rstate, check_self_collision, timeout))
+  {
+    return false;
+  }
+  // copy the solution
+  copyGroupPositions(rstate, group->getActiveJointModelNames(), solution);
+  return true;
+}
+
+bool pilz_industrial_motion_planner::computePoseIK(const planning_scene::PlanningSceneConstPtr& scene,
+                                                   const moveit::core::JointModelGroup* group,
+                                                   const std::string& link_name, const Eigen::Isometry3d& pose,
+                                                   moveit::core::RobotState& rstate, bool check_self_collision,
+                                                   const double timeout)
+{
   moveit::core::GroupStateValidityCallbackFn ik_constraint_function;
   ik_constraint_function = [check_self_collision, scene](moveit::core::RobotState* robot_state,
                                                          const moveit::core::JointModelGroup* joint_group,
@@ -93,13 +131,8 @@ bool pilz_industrial_motion_planner::computePoseIK(const planning_scene::Plannin
   };
 
   // call ik
-  if (rstate.setFromIK(robot_model->getJointModelGroup(group_name), pose, link_name, timeout, ik_constraint_function))
+  if (rstate.setFromIK(group, pose, link_name, timeout, ik_constraint_function))
   {
-    // copy the solution
-    for (const auto& joint_name : robot_model->getJointModelGroup(group_name)->getActiveJointModelNames())
-    {
-      solution[joint_name] = rstate.getVariablePosition(joint_name);
-    }
     return true;
   }
   else
@@ -242,13 +275,28 @@ bool pilz_industrial_motion_planner::generateJointTrajectory(
     joint_velocity_last[item.first] = 0.0;
   }
 
+  // the same robot state is the seed of every sample, so each solve starts at the previous solution
+  if (!validateIKRequest(*robot_model, group_name, link_name, robot_model->getModelFrame()))
+  {
+    error_code.val = moveit_msgs::msg::MoveItErrorCodes::NO_IK_SOLUTION;
+    joint_trajectory.points.clear();
+    return false;
+  }
+  const moveit::core::JointModelGroup* group = robot_model->getJointModelGroup(group_name);
+  moveit::core::RobotState ik_state(robot_model);
+  ik_state.setToDefaultValues();
+  ik_state.setVariablePositions(initial_joint_position);
+
   for (std::vector<double>::const_iterator time_iter = time_samples.begin(); time_iter != time_samples.end();
        ++time_iter)
   {
     tf2::transformKDLToEigen(trajectory.Pos(*time_iter), pose_sample);
 
-    if (!computePoseIK(scene, group_name, link_name, pose_sample, robot_model->getModelFrame(), ik_solution_last,
-                       ik_solution, check_self_collision))
+    if (computePoseIK(scene, group, link_name, pose_sample, ik_state, check_self_collision))
+    {
+      copyGroupPositions(ik_state, group->getActiveJointModelNames(), ik_solution);
+    }
+    else
     {
       RCLCPP_ERROR(LOGGER, "Failed to compute inverse kinematics solution for sampled Cartesian pose.");
       error_code.val = moveit_msgs::msg::MoveItErrorCodes::NO_IK_SOLUTION;
@@ -352,11 +400,29 @@ bool pilz_industrial_motion_planner::generateJointTrajectory(
     joint_trajectory.joint_names.push_back(joint_position.first);
   }
   std::map<std::string, double> ik_solution;
+
+  // the same robot state is the seed of every sample, so each solve starts at the previous solution
+  if (!validateIKRequest(*robot_model, group_name, link_name, robot_model->getModelFrame()))
+  {
+    error_code.val = moveit_msgs::msg::MoveItErrorCodes::NO_IK_SOLUTION;
+    joint_trajectory.points.clear();
+    return false;
+  }
+  const moveit::core::JointModelGroup* group = robot_model->getJointModelGroup(group_name);
+  moveit::core::RobotState ik_state(robot_model);
+  ik_state.setToDefaultValues();
+  ik_state.setVariablePositions(initial_joint_position);
+  Eigen::Isometry3d pose_sample;
+
   for (size_t i = 0; i < trajectory.points.size(); ++i)
   {
     // compute inverse kinematics
-    if (!computePoseIK(scene, group_name, link_name, trajectory.points.at(i).pose, robot_model->getModelFrame(),
-                       ik_solution_last, ik_solution, check_self_collision))
+    tf2::fromMsg(trajectory.points.at(i).pose, pose_sample);
+    if (computePoseIK(scene, group, link_name, pose_sample, ik_state, check_self_collision))
+    {
+      copyGroupPositions(ik_state, group->getActiveJointModelNames(), ik_solution);
+    }
+    else
     {
       RCLCPP_ERROR(LOGGER, "Failed to compute inverse kinematics solution for sampled "
                            "Cartesian pose.");
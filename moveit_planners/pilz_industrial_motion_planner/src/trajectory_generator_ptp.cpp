@@ -68,6 +68,30 @@ TrajectoryGeneratorPTP::TrajectoryGeneratorPTP(const moveit::core::RobotModelCon
   joint_limits_ = planner_limits_.getJointLimitContainer();
 
   // collect most strict joint limits for each group in robot model
+  most_strict_limit_ = getMostStrictLimit(robot_model, joint_limits_, group_name);
+
+  RCLCPP_INFO(LOGGER, "Initialized Point-to-Point Trajectory Generator.");
+}
+
+TrajectoryGeneratorPTP::TrajectoryGeneratorPTP(const moveit::core::RobotModelConstPtr& robot_model,
+                                               const LimitsContainer& planner_limits, const std::string& group_name,
+                                               const JointLimit& most_strict_limit)
+  : TrajectoryGenerator::TrajectoryGenerator(robot_model, planner_limits), most_strict_limit_(most_strict_limit)
+{
+  if (!planner_limits_.hasJointLimits())
+  {
+    throw TrajectoryGeneratorInvalidLimitsException("joint limit not set");
+  }
+  if (!robot_model->hasJointModelGroup(group_name))
+    throw TrajectoryGeneratorInvalidLimitsException("invalid group: " + group_name);
+
+  RCLCPP_DEBUG(LOGGER, "Initialized Point-to-Point Trajectory Generator from precomputed limits.");
+}
+
+JointLimit TrajectoryGeneratorPTP::getMostStrictLimit(const moveit::core::RobotModelConstPtr& robot_model,
+                                                      const JointLimitsContainer& joint_limits,
+                                                      const std::string& group_name)
+{
   const auto* jmg = robot_model->getJointModelGroup(group_name);
   if (!jmg)
     throw TrajectoryGeneratorInvalidLimitsException("invalid group: " + group_name);
@@ -75,25 +99,25 @@ TrajectoryGeneratorPTP::TrajectoryGeneratorPTP(const moveit::core::RobotModelCon
   const auto& active_joints = jmg->getActiveJointModelNames();
 
   // no active joints
+  JointLimit most_strict_limit;
   if (!active_joints.empty())
   {
-    most_strict_limit_ = joint_limits_.getCommonLimit(active_joints);
+    most_strict_limit = joint_limits.getCommonLimit(active_joints);
 
-    if (!most_strict_limit_.has_velocity_limits)
+    if (!most_strict_limit.has_velocity_limits)
     {
       throw TrajectoryGeneratorInvalidLimitsException("velocity limit not set for group " + group_name);
     }
-    if (!most_strict_limit_.has_acceleration_limits)
+    if (!most_strict_limit.has_acceleration_limits)
     {
       throw TrajectoryGeneratorInvalidLimitsException("acceleration limit not set for group " + group_name);
     }
-    if (!most_strict_limit_.has_deceleration_limits)
+    if (!most_strict_limit.has_deceleration_limits)
     {
       throw TrajectoryGeneratorInvalidLimitsException("deceleration limit not set for group " + group_name);
     }
   }
-
-  RCLCPP_INFO(LOGGER, "Initialized Point-to-Point Trajectory Generator.");
+  return most_strict_limit;
 }
 
 void TrajectoryGeneratorPTP::planPTP(const std::map<std::string, double>& start_pos,
@@ -136,60 +160,40 @@ void TrajectoryGeneratorPTP::planPTP(const std::map<std::string, double>& start_
     return;
   }
 
-  // compute the fastest trajectory and choose the slowest joint as leading axis
-  std::string leading_axis = joint_trajectory.joint_names.front();
-  double max_duration = -1.0;
-
-  std::map<std::string, VelocityProfileATrap> velocity_profile;
-  for (const auto& joint_name : joint_trajectory.joint_names)
+  // all joints have the same limits, so the joint with the longest distance is the slowest one and leads
+  const std::size_t num_joints = joint_trajectory.joint_names.size();
+  Eigen::VectorXd start(num_joints), distance(num_joints);
+  std::size_t leading_axis = 0;
+  for (std::size_t i = 0; i < num_joints; ++i)
   {
-    // create vecocity profile if necessary
-    velocity_profile.insert(std::make_pair(
-        joint_name, VelocityProfileATrap(velocity_scaling_factor * most_strict_limit_.max_velocity,
-                                         acceleration_scaling_factor * most_strict_limit_.max_acceleration,
-                                         acceleration_scaling_factor * most_strict_limit_.max_deceleration)));
-
-    velocity_profile.at(joint_name).SetProfile(start_pos.at(joint_name), goal_pos.at(joint_name));
-    if (velocity_profile.at(joint_name).Duration() > max_duration)
-    {
-      max_duration = velocity_profile.at(joint_name).Duration();
-      leading_axis = joint_name;
-    }
+    const std::string& joint_name = joint_trajectory.joint_names[i];
+    start[i] = start_pos.at(joint_name);
+    distance[i] = goal_pos.at(joint_name) - start[i];
+    if (fabs(distance[i]) > fabs(distance[leading_axis]))
+      leading_axis = i;
   }
 
-  // Full Synchronization
-  // This should only work if all axes have same max_vel, max_acc, max_dec
-  // values
-  // reset the velocity profile for other joints
-  double acc_time = velocity_profile.at(leading_axis).firstPhaseDuration();
-  double const_time = velocity_profile.at(leading_axis).secondPhaseDuration();
-  double dec_time = velocity_profile.at(leading_axis).thirdPhaseDuration();
+  VelocityProfileATrap leading_profile(velocity_scaling_factor * most_strict_limit_.max_velocity,
+                                       acceleration_scaling_factor * most_strict_limit_.max_acceleration,
+                                       acceleration_scaling_factor * most_strict_limit_.max_deceleration);
+  leading_profile.SetProfile(start[leading_axis], start[leading_axis] + distance[leading_axis]);
+  const double max_duration = leading_profile.Duration();
 
-  for (const auto& joint_name : joint_trajectory.joint_names)
-  {
-    if (joint_name != leading_axis)
-    {
-      // make full synchronization
-      // causes the program to terminate if acc_time<=0 or dec_time<=0 (should
-      // be prevented by goal_reached block above)
-      // by using the most strict limit, the following should always return true
-      if (!velocity_profile.at(joint_name)
-               .setProfileAllDurations(start_pos.at(joint_name), goal_pos.at(joint_name), acc_time, const_time,
-                                       dec_time))
-      // LCOV_EXCL_START
-      {
-        std::stringstream error_str;
-        error_str << "TrajectoryGeneratorPTP::planPTP(): Can not synchronize "
-                     "velocity profile of axis "
-                  << joint_name << " with leading axis " << leading_axis;
-        throw PtpVelocityProfileSyncFailed(error_str.str());
-      }
-      // LCOV_EXCL_STOP
-    }
-  }
+  // Full Synchronization
+  // Every joint uses the phase durations of the leading axis, which makes its profile the normalized profile u(t)
+  // (from 0 to 1) scaled by the joint distance: q(t) = q_start + distance * u(t)
+  const double acc_time = leading_profile.firstPhaseDuration();
+  const double const_time = leading_profile.secondPhaseDuration();
+  const double dec_time = leading_profile.thirdPhaseDuration();
+  const double const_vel = 1.0 / (const_time + acc_time / 2.0 + dec_time / 2.0);
+  const double acc = const_vel / acc_time;
+  const double dec = const_vel / dec_time;
+  const double acc_end_pos = 0.5 * acc * acc_time * acc_time;
+  const double const_end_pos = acc_end_pos + const_vel * const_time;
 
   // first generate the time samples
   std::vector<double> time_samples;
+  time_samples.reserve(static_cast<std::size_t>(max_duration / sampling_time) + 2);
   for (double t_sample = 0.0; t_sample < max_duration; t_sample += sampling_time)
   {
     time_samples.push_back(t_sample);
@@ -198,17 +202,53 @@ void TrajectoryGeneratorPTP::planPTP(const std::map<std::string, double>& start_
   time_samples.push_back(max_duration);
 
   // construct joint trajectory point
+  joint_trajectory.points.reserve(joint_trajectory.points.size() + time_samples.size());
   for (double time_stamp : time_samples)
   {
-    trajectory_msgs::msg::JointTrajectoryPoint point;
-    point.time_from_start = rclcpp::Duration::from_seconds(time_stamp);
-    for (std::string& joint_name : joint_trajectory.joint_names)
+    // normalized position and velocity, the phase boundaries match VelocityProfileATrap::Pos() and Vel()
+    double u, u_vel, u_acc;
+    if (time_stamp < acc_time)
+    {
+      u = 0.5 * acc * time_stamp * time_stamp;
+      u_vel = acc * time_stamp;
+    }
+    else if (time_stamp < acc_time + const_time)
+    {
+      u = acc_end_pos + const_vel * (time_stamp - acc_time);
+      u_vel = const_vel;
+    }
+    else if (time_stamp <= max_duration)
     {
-      point.positions.push_back(velocity_profile.at(joint_name).Pos(time_stamp));
-      point.velocities.push_back(velocity_profile.at(joint_name).Vel(time_stamp));
-      point.accelerations.push_back(velocity_profile.at(joint_name).Acc(time_stamp));
+      const double dec_elapsed = time_stamp - acc_time - const_time;
+      u = const_end_pos + dec_elapsed * (const_vel - 0.5 * dec * dec_elapsed);
+      u_vel = const_vel - dec * dec_elapsed;
     }
-    joint_trajectory.points.push_back(point);
+    else
+    {
+      u = 1.0;
+      u_vel = 0.0;
+    }
+    // normalized acceleration, the phase boundaries match VelocityProfileATrap::Acc()
+    if (time_stamp <= 0.0)
+      u_acc = 0.0;
+    else if (time_stamp <= acc_time)
+      u_acc = acc;
+    else if (time_stamp <= acc_time + const_time)
+      u_acc = 0.0;
+    else if (time_stamp <= max_duration)
+      u_acc = -dec;
+    else
+      u_acc = 0.0;
+
+    trajectory_msgs::msg::JointTrajectoryPoint point;
+    point.time_from_start = rclcpp::Duration::from_seconds(time_stamp);
+    point.positions.resize(num_joints);
+    point.velocities.resize(num_joints);
+    point.accelerations.resize(num_joints);
+    Eigen::VectorXd::Map(point.positions.data(), num_joints) = start + u * distance;
+    Eigen::VectorXd::Map(point.velocities.data(), num_joints) = u_vel * distance;
+    Eigen::VectorXd::Map(point.accelerations.data(), num_joints) = u_acc * distance;
+    joint_trajectory.points.push_back(std::move(point));
   }
 
   // Set last point velocity and acceleration to zero
@@ -0,0 +1,120 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include "pilz_industrial_motion_planner/trajectory_pose_index.h"
+
+#include <algorithm>
+
+#include "pilz_industrial_motion_planner/trajectory_functions.h"
+
+namespace pilz_industrial_motion_planner
+{
+// Slack on the path length bounds, to not skip waypoints due to rounding
+static constexpr double LENGTH_BOUND_SLACK = 1e-9;
+
+TrajectoryPoseIndex::TrajectoryPoseIndex(const robot_trajectory::RobotTrajectory& trajectory,
+                                         const std::string& link_name)
+{
+  positions_.reserve(trajectory.getWayPointCount());
+  distances_from_start_.reserve(trajectory.getWayPointCount());
+  for (std::size_t i = 0; i < trajectory.getWayPointCount(); ++i)
+  {
+    positions_.push_back(trajectory.getWayPoint(i).getFrameTransform(link_name).translation());
+    distances_from_start_.push_back(i == 0 ? 0. :
+                                             distances_from_start_.back() + (positions_[i] - positions_[i - 1]).norm());
+  }
+}
+
+TrajectoryPoseIndex::TrajectoryPoseIndex(const TrajectoryPoseIndex& other, std::size_t first_waypoint)
+{
+  first_waypoint = std::min(first_waypoint, other.size());
+  positions_.assign(other.positions_.begin() + first_waypoint, other.positions_.end());
+  distances_from_start_.reserve(positions_.size());
+  for (std::size_t i = first_waypoint; i < other.size(); ++i)
+  {
+    distances_from_start_.push_back(other.distances_from_start_[i] - other.distances_from_start_[first_waypoint]);
+  }
+}
+
+bool TrajectoryPoseIndex::searchIntersectionPoint(const Eigen::Vector3d& center_position, double r,
+                                                  bool inverse_order, std::size_t& index) const
+{
+  if (positions_.size() < 2)
+  {
+    return false;
+  }
+
+  // A waypoint can only be outside of the sphere if the path from the start
+  // (respectively the end) of the trajectory is long enough to leave it
+  if (inverse_order)
+  {
+    // Searching from the end, waypoint i - 1 has to be outside of the sphere
+    const double length{ distances_from_start_.back() };
+    const double offset{ (positions_.back() - center_position).norm() };
+    auto last_outside = std::upper_bound(distances_from_start_.cbegin(), distances_from_start_.cend(),
+                                         length - r + offset + LENGTH_BOUND_SLACK);
+    if (last_outside == distances_from_start_.cbegin())
+    {
+      return false;
+    }
+    const std::size_t start = std::min<std::size_t>(last_outside - distances_from_start_.cbegin(), size() - 1);
+    for (std::size_t i = start; i > 0; --i)
+    {
+      if (intersectionFound(center_position, positions_[i], positions_[i - 1], r))
+      {
+        index = i;
+        return true;
+      }
+    }
+  }
+  else
+  {
+    // Searching from the start, waypoint i + 1 has to be outside of the sphere
+    const double offset{ (positions_.front() - center_position).norm() };
+    auto first_outside = std::lower_bound(distances_from_start_.cbegin(), distances_from_start_.cend(),
+                                          r - offset - LENGTH_BOUND_SLACK);
+    const std::size_t first = first_outside - distances_from_start_.cbegin();
+    for (std::size_t i = (first > 0 ? first - 1 : 0); i + 1 < size(); ++i)
+    {
+      if (intersectionFound(center_position, positions_[i], positions_[i + 1], r))
+      {
+        index = i;
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+}  // namespace pilz_industrial_motion_planner
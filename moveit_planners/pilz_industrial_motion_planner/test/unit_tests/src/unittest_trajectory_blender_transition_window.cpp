@@ -556,6 +556,57 @@ TEST_F(TrajectoryBlenderTransitionWindowTest, testLinLinBlending)
                                           cartesian_angular_velocity_tolerance_));
 }
 
+/**
+ * @brief  Tests the reuse of link position indexes and blend results.
+ *
+ * Test Sequence:
+ *    1. Generate two linear trajectories from the test data set.
+ *    2. Search the intersection points with the pose index and linearly.
+ *    3. Blend the trajectories twice.
+ *
+ * Expected Results:
+ *    1. Two linear trajectories generated.
+ *    2. Both searches find the same intersection points.
+ *    3. The second blend returns the trajectories of the first blend.
+ */
+TEST_F(TrajectoryBlenderTransitionWindowTest, testCachedBlending)
+{
+  Sequence seq{ data_loader_->getSequence("SimpleSequence") };
+
+  std::vector<planning_interface::MotionPlanResponse> res{ generateLinTrajs(seq, 2) };
+
+  const double blend_radius{ seq.getBlendRadius(0) };
+  const Eigen::Vector3d center{
+    res.at(0).trajectory_->getLastWayPoint().getFrameTransform(target_link_).translation()
+  };
+  std::size_t linear_index, indexed_index;
+  ASSERT_TRUE(linearSearchIntersectionPoint(target_link_, center, blend_radius, res.at(0).trajectory_, true,
+                                            linear_index));
+  ASSERT_TRUE(TrajectoryPoseIndex(*res.at(0).trajectory_, target_link_)
+                  .searchIntersectionPoint(center, blend_radius, true, indexed_index));
+  EXPECT_EQ(linear_index, indexed_index);
+  ASSERT_TRUE(linearSearchIntersectionPoint(target_link_, center, blend_radius, res.at(1).trajectory_, false,
+                                            linear_index));
+  ASSERT_TRUE(TrajectoryPoseIndex(*res.at(1).trajectory_, target_link_)
+                  .searchIntersectionPoint(center, blend_radius, false, indexed_index));
+  EXPECT_EQ(linear_index, indexed_index);
+
+  pilz_industrial_motion_planner::TrajectoryBlendRequest blend_req;
+  pilz_industrial_motion_planner::TrajectoryBlendResponse blend_res, cached_blend_res;
+
+  blend_req.group_name = planning_group_;
+  blend_req.link_name = target_link_;
+  blend_req.blend_radius = blend_radius;
+
+  blend_req.first_trajectory = res.at(0).trajectory_;
+  blend_req.second_trajectory = res.at(1).trajectory_;
+
+  EXPECT_TRUE(blender_->blend(planning_scene_, blend_req, blend_res));
+  EXPECT_TRUE(blender_->blend(planning_scene_, blend_req, cached_blend_res));
+  EXPECT_EQ(blend_res.blend_trajectory, cached_blend_res.blend_trajectory);
+  EXPECT_EQ(blend_res.second_trajectory, cached_blend_res.second_trajectory);
+}
+
 /**
  * @brief  Tests the blending of two cartesian linear trajectories which have
  * an overlap in the blending sphere using robot model. To be precise,
@@ -374,6 +374,40 @@ TEST_F(TrajectoryFunctionsTestFlangeAndGripper, testComputePoseIK)
   }
 }
 
+/**
+ * @brief Test computePoseIK seeded with a robot state along a path of close
+ * poses, as done when generating a joint trajectory from Cartesian samples
+ */
+TEST_F(TrajectoryFunctionsTestFlangeAndGripper, testComputePoseIKWarmStart)
+{
+  moveit::core::RobotState rstate(robot_model_);
+  const moveit::core::JointModelGroup* jmg = robot_model_->getJointModelGroup(planning_group_);
+  rstate.setToDefaultValues();
+  rstate.setToRandomPositions(jmg, rng_);
+  rstate.update();
+
+  // the IK state starts at the beginning of the path and follows it
+  moveit::core::RobotState ik_state(rstate);
+  std::vector<double> positions;
+  rstate.copyJointGroupPositions(jmg, positions);
+  for (int i = 0; i < 10; ++i)
+  {
+    for (double& position : positions)
+    {
+      position += IK_SEED_OFFSET;
+    }
+    rstate.setJointGroupPositions(jmg, positions);
+    rstate.enforceBounds(jmg);
+    rstate.update();
+    Eigen::Isometry3d pose_expect = rstate.getFrameTransform(tcp_link_);
+
+    EXPECT_TRUE(pilz_industrial_motion_planner::computePoseIK(planning_scene_, jmg, tcp_link_, pose_expect, ik_state,
+                                                              false));
+    ik_state.update();
+    EXPECT_TRUE(tfNear(pose_expect, ik_state.getFrameTransform(tcp_link_), EPSILON));
+  }
+}
+
 /**
  * @brief Test computePoseIK for invalid group_name
  */
@@ -971,6 +971,48 @@ TEST_F(TrajectoryGeneratorPTPTest, testJointGoalNoStartVel)
                           [this](double v) { return std::fabs(v) < this->joint_acceleration_tolerance_; }));
 }
 
+/**
+ * @brief A generator constructed from the precomputed most strict limit of the group plans the same trajectory as a
+ * generator deriving the limit itself
+ */
+TEST_F(TrajectoryGeneratorPTPTest, testPrecomputedLimit)
+{
+  const JointLimit most_strict_limit = TrajectoryGeneratorPTP::getMostStrictLimit(
+      robot_model_, planner_limits_.getJointLimitContainer(), planning_group_);
+  TrajectoryGeneratorPTP precomputed_ptp(robot_model_, planner_limits_, planning_group_, most_strict_limit);
+
+  planning_interface::MotionPlanRequest req;
+  testutils::createDummyRequest(robot_model_, planning_group_, req);
+  moveit_msgs::msg::Constraints gc;
+  moveit_msgs::msg::JointConstraint jc;
+  jc.joint_name = "prbt_joint_1";
+  jc.position = 1.5;
+  gc.joint_constraints.push_back(jc);
+  jc.joint_name = "prbt_joint_2";
+  jc.position = -0.7;
+  gc.joint_constraints.push_back(jc);
+  req.goal_constraints.push_back(gc);
+
+  planning_interface::MotionPlanResponse res, precomputed_res;
+  ASSERT_TRUE(ptp_->generate(planning_scene_, req, res));
+  ASSERT_TRUE(precomputed_ptp.generate(planning_scene_, req, precomputed_res));
+
+  moveit_msgs::msg::MotionPlanResponse res_msg, precomputed_res_msg;
+  res.getMessage(res_msg);
+  precomputed_res.getMessage(precomputed_res_msg);
+  const auto& points = res_msg.trajectory.joint_trajectory.points;
+  const auto& precomputed_points = precomputed_res_msg.trajectory.joint_trajectory.points;
+  ASSERT_EQ(points.size(), precomputed_points.size());
+  for (std::size_t i = 0; i < points.size(); ++i)
+  {
+    EXPECT_EQ(points[i].positions, precomputed_points[i].positions);
+    EXPECT_EQ(points[i].velocities, precomputed_points[i].velocities);
+    EXPECT_EQ(points[i].accelerations, precomputed_points[i].accelerations);
+  }
+  EXPECT_TRUE(checkTrajectory(precomputed_res_msg.trajectory.joint_trajectory, req,
+                              planner_limits_.getJointLimitContainer()));
+}
+
 int main(int argc, char** argv)
 {
   rclcpp::init(argc, argv);
@@ -60,6 +60,29 @@ struct CartPoseErrCalculator : public sco::VectorOfVector
   Eigen::VectorXd operator()(const Eigen::VectorXd& dof_vals) const override;
 };
 
+/**
+ * @brief Used to calculate the error for CollisionTermInfo
+ * The robot is swept from the state at one timestep to the state at the next one with the continuous check of the
+ * planning scene's collision environment. With the Bullet collision detector this casts the convex hull of every link
+ * between the two poses, so obstacles cannot be tunneled through between timesteps. The error of the pair is the hinge
+ * max(0, safety_margin - distance) of the closest contact.
+ */
+struct CollisionErrCalculator : public sco::VectorOfVector
+{
+  planning_scene::PlanningSceneConstPtr planning_scene_;
+  std::string planning_group_;
+  double safety_margin_;
+
+  CollisionErrCalculator(const planning_scene::PlanningSceneConstPtr& planning_scene, const std::string& group,
+                         double safety_margin)
+    : planning_scene_(planning_scene), planning_group_(group), safety_margin_(safety_margin)
+  {
+  }
+
+  /** @brief dof_vals holds the joint values of the first timestep followed by the ones of the second timestep */
+  Eigen::VectorXd operator()(const Eigen::VectorXd& dof_vals) const override;
+};
+
 // TODO(omid): The following should be added and adjusted from trajopt
 // JointPosEqCost
 // JointPosIneqCost
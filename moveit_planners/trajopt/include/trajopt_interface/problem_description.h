@@ -52,6 +52,9 @@ MOVEIT_CLASS_FORWARD(CartPoseTermInfo);  // Defines CartPoseTermInfoPtr, ConstPt
 struct JointVelTermInfo;
 MOVEIT_CLASS_FORWARD(JointVelTermInfo);  // Defines JointVelTermInfoPtr, ConstPtr, WeakPtr... etc
 
+struct CollisionTermInfo;
+MOVEIT_CLASS_FORWARD(CollisionTermInfo);  // Defines CollisionTermInfoPtr, ConstPtr, WeakPtr... etc
+
 struct ProblemInfo;
 TrajOptProblemPtr ConstructProblem(const ProblemInfo&);
 
@@ -224,6 +227,10 @@ public:
   {
     return planning_scene_;
   }
+  const std::string& GetPlanningGroup()
+  {
+    return planning_group_;
+  }
   void SetInitTraj(const trajopt::TrajArray& x)
   {
     matrix_init_traj = x;
@@ -358,6 +365,41 @@ struct JointVelTermInfo : public TermInfo
   }
 };
 
+/**
+  \brief Continuous collision cost between consecutive timesteps
+    The convex hulls of the robot links are swept from each timestep to the next one (see CollisionErrCalculator), so
+    the term also covers the motion in between the discrete timesteps.
+
+  \f{align*}{
+  \sum_{t} c \max(0, d_{safe} - d_t)
+  \f}
+  where \f$d_t\f$ is the distance to the closest obstacle over the swept motion from timestep t to t + 1
+ */
+struct CollisionTermInfo : public TermInfo
+{
+  /** @brief Coefficient that scales the cost. Default: 20 */
+  double coeff = 20.0;
+  /** @brief Distance to obstacles below which the term becomes active. Default: 0.025 */
+  double safety_margin = 0.025;
+  /** @brief First time step to which the term is applied. Default: 0 */
+  int first_step = 0;
+  /** @brief Last time step to which the term is applied. Default: prob.GetNumSteps() - 1*/
+  int last_step = -1;
+
+  /** @brief Initialize term with it's supported types */
+  CollisionTermInfo() : TermInfo(TT_COST | TT_CNT)
+  {
+  }
+
+  /** @brief Converts term info into cost/constraint and adds it to trajopt problem */
+  void addObjectiveTerms(TrajOptProblem& prob) override;
+
+  static TermInfoPtr create()
+  {
+    return std::make_shared<CollisionTermInfo>();
+  }
+};
+
 void generateInitialTrajectory(const ProblemInfo& pci, const std::vector<double>& current_joint_values,
                                trajopt::TrajArray& init_traj);
 
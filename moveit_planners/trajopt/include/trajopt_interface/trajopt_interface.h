@@ -65,12 +65,20 @@ protected:
   void setJointPoseTermInfoParams(JointPoseTermInfoPtr& jp, std::string name);
   trajopt::DblVec extractStartJointValues(const planning_interface::MotionPlanRequest& req,
                                           const std::vector<std::string>& group_joint_names);
+  /** @brief Resamples the first reference trajectory of the request to n_steps timesteps of the group joints.
+   *  Returns false if the request has no usable reference trajectory. */
+  bool extractSeedTrajectory(const planning_interface::MotionPlanRequest& req,
+                             const std::vector<std::string>& group_joint_names, int n_steps,
+                             trajopt::TrajArray& seed_trajectory) const;
 
   ros::NodeHandle nh_;  /// The ROS node handle
   sco::BasicTrustRegionSQPParameters params_;
   std::vector<sco::Optimizer::Callback> optimizer_callbacks_;
   TrajOptProblemPtr trajopt_problem_;
   std::string name_;
+  /// Joint values of the last solution and the group they belong to, used for warm-starting
+  trajopt::TrajArray last_solution_;
+  std::string last_solution_group_;
 };
 
 void callBackFunc(sco::OptProb* opt_prob, sco::OptResults& opt_res);
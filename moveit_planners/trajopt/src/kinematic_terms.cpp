@@ -1,5 +1,6 @@
 #include <Eigen/Geometry>
 #include <boost/format.hpp>
+#include <algorithm>
 
 #include <trajopt_sco/expr_ops.hpp>
 #include <trajopt_sco/modeling_utils.hpp>
@@ -19,6 +20,31 @@ VectorXd CartPoseErrCalculator::operator()(const VectorXd& dof_vals) const
   return err;
 }
 
+VectorXd CollisionErrCalculator::operator()(const VectorXd& dof_vals) const
+{
+  assert(dof_vals.rows() % 2 == 0);
+  const int n_dof = static_cast<int>(dof_vals.rows() / 2);
+
+  moveit::core::RobotState start_state = planning_scene_->getCurrentState();
+  moveit::core::RobotState end_state = start_state;
+  const moveit::core::JointModelGroup* joint_model_group = start_state.getJointModelGroup(planning_group_);
+  start_state.setJointGroupPositions(joint_model_group, VectorXd(dof_vals.head(n_dof)));
+  end_state.setJointGroupPositions(joint_model_group, VectorXd(dof_vals.tail(n_dof)));
+  start_state.update();
+  end_state.update();
+
+  collision_detection::CollisionRequest req;
+  req.group_name = planning_group_;
+  req.distance = true;
+  collision_detection::CollisionResult res;
+  planning_scene_->getCollisionEnv()->checkRobotCollision(req, res, start_state, end_state,
+                                                          planning_scene_->getAllowedCollisionMatrix());
+
+  VectorXd err(1);
+  err(0) = std::max(0.0, safety_margin_ - res.distance);
+  return err;
+}
+
 VectorXd JointVelErrCalculator::operator()(const VectorXd& var_vals) const
 {
   assert(var_vals.rows() % 2 == 0);
@@ -545,6 +545,45 @@ void JointVelTermInfo::addObjectiveTerms(TrajOptProblem& prob)
   }
 }
 
+void CollisionTermInfo::addObjectiveTerms(TrajOptProblem& prob)
+{
+  unsigned int n_dof = prob.GetActiveGroupNumDOF();
+
+  if (last_step <= -1 || (prob.GetNumSteps() - 1) <= last_step)
+    last_step = prob.GetNumSteps() - 1;
+  if (last_step < first_step)
+  {
+    int tmp = first_step;
+    first_step = last_step;
+    last_step = tmp;
+    ROS_WARN("Last time step for CollisionTerm comes before first step. Reversing them.");
+  }
+
+  // One term per swept motion between two consecutive timesteps
+  for (int i = first_step; i < last_step; ++i)
+  {
+    sco::VectorOfVectorPtr f =
+        std::make_shared<CollisionErrCalculator>(prob.GetPlanningScene(), prob.GetPlanningGroup(), safety_margin);
+    sco::VarVector vars = concatVector(prob.GetVarRow(i, 0, n_dof), prob.GetVarRow(i + 1, 0, n_dof));
+    const std::string term_name = name + "_" + std::to_string(i);
+    if ((term_type & TT_COST) && ~(term_type | ~TT_USE_TIME))
+    {
+      prob.addCost(
+          std::make_shared<sco::CostFromErrFunc>(f, vars, Eigen::VectorXd::Constant(1, coeff), sco::ABS, term_name));
+    }
+    else if ((term_type & TT_CNT) && ~(term_type | ~TT_USE_TIME))
+    {
+      prob.addConstraint(std::make_shared<sco::ConstraintFromErrFunc>(f, vars, Eigen::VectorXd::Constant(1, coeff),
+                                                                      sco::INEQ, term_name));
+    }
+    else
+    {
+      ROS_WARN("CollisionTermInfo does not have a valid term_type defined. No cost/constraint applied");
+      return;
+    }
+  }
+}
+
 void generateInitialTrajectory(const ProblemInfo& pci, const std::vector<double>& current_joint_values,
                                trajopt::TrajArray& init_traj)
 {
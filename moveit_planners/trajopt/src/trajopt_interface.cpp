@@ -48,6 +48,8 @@
 #include <ros/ros.h>
 #include <rosparam_shortcuts/rosparam_shortcuts.h>
 
+#include <algorithm>
+#include <cmath>
 #include <limits>
 #include <vector>
 #include <Eigen/Geometry>
@@ -122,7 +124,7 @@ bool TrajOptInterface::solve(const planning_scene::PlanningSceneConstPtr& planni
   setProblemInfoParam(problem_info);
 
   ROS_INFO(" ======================================= Populate init info, hard-coded");
-  // TODO: init info should be defined by user. To this end, we need to add seed trajectories to MotionPlanRequest.
+  // Without a warm start seed (see below) the init info type comes from the parameters:
   // JOINT_INTERPOLATED: data is the current joint values
   // GIVEN_TRAJ: data is the joint values of the current state copied to all timesteps
   Eigen::VectorXd current_joint_values_eigen(dof);
@@ -131,7 +133,34 @@ bool TrajOptInterface::solve(const planning_scene::PlanningSceneConstPtr& planni
     current_joint_values_eigen(joint_index) = current_joint_values[joint_index];
   }
 
-  if (problem_info.init_info.type == InitInfo::JOINT_INTERPOLATED)
+  // Warm start: a seed trajectory from the request (e.g. an OMPL path to be polished) takes precedence over the
+  // solution of the previous request for the same group
+  trajopt::TrajArray seed_trajectory;
+  bool warm_start;
+  nh_.param("problem_info/init_info/warm_start", warm_start, true);
+  bool has_seed = false;
+  if (warm_start && extractSeedTrajectory(req, group_joint_names, problem_info.basic_info.n_steps, seed_trajectory))
+  {
+    ROS_INFO(" ======================================= Warm start from the request's reference trajectory");
+    has_seed = true;
+  }
+  else if (warm_start && last_solution_group_ == req.group_name &&
+           last_solution_.rows() == problem_info.basic_info.n_steps && last_solution_.cols() == dof)
+  {
+    ROS_INFO(" ======================================= Warm start from the previous solution");
+    seed_trajectory = last_solution_;
+    has_seed = true;
+  }
+
+  if (has_seed)
+  {
+    // the first timestep is fixed to the initial trajectory, so it has to be the requested start state
+    for (int joint_index = 0; joint_index < dof; ++joint_index)
+      seed_trajectory(0, joint_index) = start_joint_values[joint_index];
+    problem_info.init_info.type = InitInfo::GIVEN_TRAJ;
+    problem_info.init_info.data = seed_trajectory;
+  }
+  else if (problem_info.init_info.type == InitInfo::JOINT_INTERPOLATED)
   {
     problem_info.init_info.data = current_joint_values_eigen;
   }
@@ -210,6 +239,19 @@ bool TrajOptInterface::solve(const planning_scene::PlanningSceneConstPtr& planni
   joint_vel->term_type = trajopt_interface::TT_COST;
   problem_info.cost_infos.push_back(joint_vel);
 
+  ROS_INFO(" ======================================= Collision Costs");
+  bool use_collision_term;
+  nh_.param("collision_term_info/enabled", use_collision_term, true);
+  if (use_collision_term)
+  {
+    auto collision = std::make_shared<CollisionTermInfo>();
+    nh_.param("collision_term_info/coeff", collision->coeff, 20.0);
+    nh_.param("collision_term_info/safety_margin", collision->safety_margin, 0.025);
+    collision->name = "collision";
+    collision->term_type = trajopt_interface::TT_COST;
+    problem_info.cost_infos.push_back(collision);
+  }
+
   ROS_INFO(" ======================================= Visibility Constraints");
   if (!req.goal_constraints[0].visibility_constraints.empty())
   {
@@ -281,6 +323,10 @@ bool TrajOptInterface::solve(const planning_scene::PlanningSceneConstPtr& planni
   ROS_INFO_STREAM_NAMED("num_rows", opt_solution.rows());
   ROS_INFO_STREAM_NAMED("num_cols", opt_solution.cols());
 
+  // keep the joint values for warm-starting the next request
+  last_solution_ = opt_solution.leftCols(dof);
+  last_solution_group_ = req.group_name;
+
   res.trajectory.resize(1);
   res.trajectory[0].joint_trajectory.joint_names = group_joint_names;
   res.trajectory[0].joint_trajectory.header = req.start_state.joint_state.header;
@@ -374,7 +420,7 @@ void TrajOptInterface::setProblemInfoParam(ProblemInfo& problem_info)
   nh_.param("problem_info/basic_info/start_fixed", problem_info.basic_info.start_fixed, true);
   nh_.param("problem_info/basic_info/use_time", problem_info.basic_info.use_time, false);
   int convex_solver_index;
-  nh_.param("problem_info/basic_info/convex_solver", convex_solver_index, 1);
+  nh_.param("problem_info/basic_info/convex_solver", convex_solver_index, 3);
   switch (convex_solver_index)
   {
     case 1:
@@ -455,6 +501,50 @@ trajopt::DblVec TrajOptInterface::extractStartJointValues(const planning_interfa
   return start_joint_vals;
 }
 
+bool TrajOptInterface::extractSeedTrajectory(const planning_interface::MotionPlanRequest& req,
+                                             const std::vector<std::string>& group_joint_names, int n_steps,
+                                             trajopt::TrajArray& seed_trajectory) const
+{
+  if (req.reference_trajectories.empty() || req.reference_trajectories[0].joint_trajectory.empty())
+    return false;
+  const trajectory_msgs::JointTrajectory& reference = req.reference_trajectories[0].joint_trajectory[0];
+  if (reference.points.size() < 2)
+    return false;
+
+  // column of each group joint in the reference trajectory
+  std::vector<std::size_t> columns;
+  for (const std::string& joint_name : group_joint_names)
+  {
+    auto it = std::find(reference.joint_names.begin(), reference.joint_names.end(), joint_name);
+    if (it == reference.joint_names.end())
+    {
+      ROS_WARN_STREAM_NAMED(name_, "Reference trajectory does not contain joint " << joint_name << ", ignoring it");
+      return false;
+    }
+    columns.push_back(it - reference.joint_names.begin());
+  }
+
+  // resample the waypoints uniformly to n_steps timesteps
+  const std::size_t max_input_index = reference.points.size() - 1;
+  seed_trajectory.resize(n_steps, group_joint_names.size());
+  for (int i = 0; i < n_steps; ++i)
+  {
+    double fraction = static_cast<double>(i * max_input_index) / (n_steps - 1);
+    const std::size_t prev_idx = std::trunc(fraction);
+    fraction = fraction - prev_idx;
+    const std::size_t next_idx = prev_idx == max_input_index ? prev_idx : prev_idx + 1;
+    for (std::size_t j = 0; j < columns.size(); ++j)
+    {
+      if (reference.points[prev_idx].positions.size() <= columns[j] ||
+          reference.points[next_idx].positions.size() <= columns[j])
+        return false;
+      seed_trajectory(i, j) = (1.0 - fraction) * reference.points[prev_idx].positions[columns[j]] +
+                              fraction * reference.points[next_idx].positions[columns[j]];
+    }
+  }
+  return true;
+}
+
 void callBackFunc(sco::OptProb* opt_prob, sco::OptResults& opt_res)
 {
   // TODO: Create the actual implementation
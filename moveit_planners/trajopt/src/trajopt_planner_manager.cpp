@@ -38,7 +38,7 @@
 
 #include <moveit/planning_interface/planning_interface.h>
 
-#include "moveit/collision_detection_fcl/collision_detector_allocator_fcl.h"
+#include "moveit/collision_detection_bullet/collision_detector_allocator_bullet.h"
 
 #include <class_loader/class_loader.hpp>
 
@@ -111,8 +111,8 @@ public:
     // create PlanningScene using hybrid collision detector
     planning_scene::PlanningScenePtr ps = planning_scene->diff();
 
-    // set FCL for the collision
-    ps->allocateCollisionDetector(collision_detection::CollisionDetectorAllocatorFCL::create());
+    // set Bullet for the collision, its cast managers provide the continuous checks of the collision term
+    ps->allocateCollisionDetector(collision_detection::CollisionDetectorAllocatorBullet::create());
 
     // retrieve and configure existing context
     const TrajOptPlanningContextPtr& context = planning_contexts_.at(req.group_name);
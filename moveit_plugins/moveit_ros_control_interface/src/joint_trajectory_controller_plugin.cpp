@@ -37,13 +37,183 @@
 #include <moveit_ros_control_interface/ControllerHandle.h>
 #include <pluginlib/class_list_macros.hpp>
 #include <moveit_simple_controller_manager/follow_joint_trajectory_controller_handle.h>
+#include <control_msgs/msg/joint_trajectory_controller_state.hpp>
+#include <trajectory_msgs/msg/joint_trajectory.hpp>
 #include <rclcpp/node.hpp>
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 
 namespace moveit_ros_control_interface
 {
+static const rclcpp::Logger LOGGER = rclcpp::get_logger("moveit.plugins.ros_control_interface");
+
+// selects the topic interface of the controllers instead of their follow_joint_trajectory action
+static const std::string INTRA_PROCESS_PARAMETER = "ros_control_intra_process";
+
+/**
+ * \brief Controller handle that uses the topic interface of joint_trajectory_controller/JointTrajectoryController.
+ *
+ * Trajectories are published on ~/joint_trajectory and the execution is followed on ~/state, without the
+ * goal/result round trips of the action interface. Both use intra-process communication: if the controller manager
+ * runs in the same process with intra-process communication enabled, messages are handed over without serialization.
+ */
+class JointTrajectoryTopicControllerHandle : public moveit_controller_manager::MoveItControllerHandle
+{
+public:
+  JointTrajectoryTopicControllerHandle(const rclcpp::Node::SharedPtr& node, const std::string& name)
+    : moveit_controller_manager::MoveItControllerHandle(name), node_(node)
+  {
+    rclcpp::PublisherOptions publisher_options;
+    publisher_options.use_intra_process_comm = rclcpp::IntraProcessSetting::Enable;
+    trajectory_publisher_ = node_->create_publisher<trajectory_msgs::msg::JointTrajectory>(
+        rclcpp::names::append(name, "joint_trajectory"), rclcpp::QoS(1), publisher_options);
+
+    rclcpp::SubscriptionOptions subscription_options;
+    subscription_options.use_intra_process_comm = rclcpp::IntraProcessSetting::Enable;
+    state_subscriber_ = node_->create_subscription<control_msgs::msg::JointTrajectoryControllerState>(
+        rclcpp::names::append(name, "state"), rclcpp::QoS(1),
+        [this](const control_msgs::msg::JointTrajectoryControllerState::ConstSharedPtr& state) {
+          stateCallback(state);
+        },
+        subscription_options);
+  }
+
+  bool sendTrajectory(const moveit_msgs::msg::RobotTrajectory& trajectory) override
+  {
+    if (!trajectory.multi_dof_joint_trajectory.points.empty())
+    {
+      RCLCPP_ERROR_STREAM(LOGGER, name_ << " cannot execute multi-dof trajectories.");
+      return false;
+    }
+    const std::vector<trajectory_msgs::msg::JointTrajectoryPoint>& points = trajectory.joint_trajectory.points;
+    if (points.empty())
+    {
+      RCLCPP_ERROR_STREAM(LOGGER, name_ << " received an empty trajectory.");
+      return false;
+    }
+
+    auto message = std::make_unique<trajectory_msgs::msg::JointTrajectory>(trajectory.joint_trajectory);
+    // the controller starts a trajectory without stamp on arrival
+    rclcpp::Time start(message->header.stamp, node_->get_clock()->get_clock_type());
+    if (start.nanoseconds() == 0)
+      start = node_->now();
+
+    RCLCPP_INFO_STREAM(LOGGER, "publishing trajectory to " << name_);
+    {
+      std::scoped_lock lock(mutex_);
+      goal_positions_ = points.back().positions;
+      goal_joint_names_ = message->joint_names;
+      end_time_ = start + rclcpp::Duration(points.back().time_from_start);
+      done_ = false;
+      last_exec_ = moveit_controller_manager::ExecutionStatus::RUNNING;
+    }
+    trajectory_publisher_->publish(std::move(message));
+    return true;
+  }
+
+  bool cancelExecution() override
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (done_)
+      return true;
+    if (!last_state_)
+    {
+      RCLCPP_ERROR_STREAM(LOGGER, "No state received from " << name_ << ", cannot stop it.");
+      return false;
+    }
+
+    // the topic interface has no cancel request; replace the trajectory by holding the current position instead
+    auto hold = std::make_unique<trajectory_msgs::msg::JointTrajectory>();
+    hold->joint_names = last_state_->joint_names;
+    hold->points.resize(1);
+    hold->points[0].positions = last_state_->actual.positions;
+    hold->points[0].time_from_start = rclcpp::Duration::from_seconds(HOLD_DURATION);
+    finish(moveit_controller_manager::ExecutionStatus::PREEMPTED);
+    lock.unlock();
+
+    RCLCPP_INFO_STREAM(LOGGER, "Stopping trajectory on " << name_);
+    trajectory_publisher_->publish(std::move(hold));
+    return true;
+  }
+
+  bool waitForExecution(const rclcpp::Duration& timeout = rclcpp::Duration::from_nanoseconds(-1)) override
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (timeout < rclcpp::Duration::from_nanoseconds(0))
+    {
+      done_condition_.wait(lock, [this] { return done_; });
+      return true;
+    }
+    return done_condition_.wait_for(lock, timeout.to_chrono<std::chrono::nanoseconds>(), [this] { return done_; });
+  }
+
+  moveit_controller_manager::ExecutionStatus getLastExecutionStatus() override
+  {
+    std::scoped_lock lock(mutex_);
+    return last_exec_;
+  }
+
+private:
+  // time given to the controller to come to a halt at the current position
+  static constexpr double HOLD_DURATION = 0.1;
+  // the desired positions count as the final point's positions when they are this close
+  static constexpr double GOAL_POSITION_TOLERANCE = 1e-6;
+
+  void stateCallback(const control_msgs::msg::JointTrajectoryControllerState::ConstSharedPtr& state)
+  {
+    std::scoped_lock lock(mutex_);
+    last_state_ = state;
+    if (done_)
+      return;
+
+    rclcpp::Time stamp(state->header.stamp, end_time_.get_clock_type());
+    if (stamp < end_time_ || !reachedGoal(*state))
+      return;
+    finish(moveit_controller_manager::ExecutionStatus::SUCCEEDED);
+  }
+
+  /** \brief Whether the controller samples the final point of the trajectory. Call with mutex_ locked. */
+  bool reachedGoal(const control_msgs::msg::JointTrajectoryControllerState& state) const
+  {
+    for (std::size_t i = 0; i < goal_joint_names_.size() && i < goal_positions_.size(); ++i)
+    {
+      const auto it = std::find(state.joint_names.begin(), state.joint_names.end(), goal_joint_names_[i]);
+      const std::size_t index = it - state.joint_names.begin();
+      if (it == state.joint_names.end() || index >= state.desired.positions.size() ||
+          std::fabs(state.desired.positions[index] - goal_positions_[i]) > GOAL_POSITION_TOLERANCE)
+        return false;
+    }
+    return true;
+  }
+
+  /** \brief Mark the execution as done with \e status. Call with mutex_ locked. */
+  void finish(moveit_controller_manager::ExecutionStatus status)
+  {
+    last_exec_ = status;
+    done_ = true;
+    done_condition_.notify_all();
+  }
+
+  const rclcpp::Node::SharedPtr node_;
+  rclcpp::Publisher<trajectory_msgs::msg::JointTrajectory>::SharedPtr trajectory_publisher_;
+  rclcpp::Subscription<control_msgs::msg::JointTrajectoryControllerState>::SharedPtr state_subscriber_;
+
+  std::mutex mutex_;
+  std::condition_variable done_condition_;
+  bool done_ = true;
+  moveit_controller_manager::ExecutionStatus last_exec_ = moveit_controller_manager::ExecutionStatus::SUCCEEDED;
+  control_msgs::msg::JointTrajectoryControllerState::ConstSharedPtr last_state_;
+  std::vector<std::string> goal_joint_names_;
+  std::vector<double> goal_positions_;
+  rclcpp::Time end_time_;
+};
+
 /**
  * \brief Simple allocator for moveit_simple_controller_manager::FollowJointTrajectoryControllerHandle instances.
+ * With the ros_control_intra_process parameter set, JointTrajectoryTopicControllerHandle instances are allocated.
  */
 class JointTrajectoryControllerAllocator : public ControllerHandleAllocator
 {
@@ -52,6 +222,11 @@ public:
                                                              const std::string& name,
                                                              const std::vector<std::string>& /* resources */) override
   {
+    if (!node->has_parameter(INTRA_PROCESS_PARAMETER))
+      node->declare_parameter<bool>(INTRA_PROCESS_PARAMETER, false);
+    if (node->get_parameter(INTRA_PROCESS_PARAMETER).as_bool())
+      return std::make_shared<JointTrajectoryTopicControllerHandle>(node, name);
+
     return std::make_shared<moveit_simple_controller_manager::FollowJointTrajectoryControllerHandle>(
         node, name, "follow_joint_trajectory");
   }
@@ -40,7 +40,11 @@
 #include <moveit_simple_controller_manager/action_based_controller_handle.h>
 #include <control_msgs/action/follow_joint_trajectory.hpp>
 #include <control_msgs/msg/joint_tolerance.hpp>
+#include <atomic>
+#include <condition_variable>
 #include <functional>
+#include <mutex>
+#include <thread>
 
 namespace moveit_simple_controller_manager
 {
@@ -56,10 +60,26 @@ public:
                                         const std::string& action_ns)
     : ActionBasedControllerHandle<control_msgs::action::FollowJointTrajectory>(
           node, name, action_ns, "moveit.simple_controller_manager.follow_joint_trajectory_controller_handle")
+    , node_(node)
   {
   }
 
+  ~FollowJointTrajectoryControllerHandle() override;
+
   bool sendTrajectory(const moveit_msgs::msg::RobotTrajectory& trajectory) override;
+  bool cancelExecution() override;
+  bool waitForExecution(const rclcpp::Duration& timeout = rclcpp::Duration::from_seconds(-1.0)) override;
+
+  /**
+   * @brief Enable streaming of long trajectories in chunks.
+   *
+   * Trajectories longer than \e chunk_duration are split: the first chunk is sent right away and every later chunk is
+   * sent \e lead_time before the controller reaches it. All chunks share the same absolute header stamp, so each new
+   * goal replaces the remainder of the previous one without shifting its timing.
+   * @param chunk_duration Duration of trajectory covered by each chunk [s]. Zero or negative disables streaming.
+   * @param lead_time How far ahead of the controller's playback position a chunk is sent [s].
+   */
+  void setStreaming(double chunk_duration, double lead_time);
 
   // TODO(JafarAbdi): Revise parameter lookup
   // void configure(XmlRpc::XmlRpcValue& config) override;
@@ -72,7 +92,28 @@ protected:
       const rclcpp_action::ClientGoalHandle<control_msgs::action::FollowJointTrajectory>::WrappedResult& wrapped_result)
       override;
 
+  /** @brief Send a goal and block until the action server accepted or rejected it. */
+  bool sendGoal(const control_msgs::action::FollowJointTrajectory::Goal& goal);
+
+  /** @brief Send all chunks after the first one, each \e stream_lead_time_ ahead of its start. */
+  void streamChunks(trajectory_msgs::msg::JointTrajectory trajectory, std::vector<double> chunk_starts);
+
+  /** @brief Stop and join the streaming thread, if any. */
+  void stopStreaming();
+
   control_msgs::action::FollowJointTrajectory::Goal goal_template_;
+
+  rclcpp::Node::SharedPtr node_;
+
+  double stream_chunk_duration_ = 0.0;
+  double stream_lead_time_ = 0.5;
+
+  std::thread stream_thread_;
+  std::mutex stream_mutex_;
+  std::condition_variable stream_cv_;
+  bool stream_stop_ = false;
+  bool stream_done_ = true;
+  std::atomic<bool> stream_failed_{ false };
 };
 
 }  // end namespace moveit_simple_controller_manager
@@ -36,11 +36,53 @@
 /* Author: Michael Ferguson, Ioan Sucan, E. Gil Jones */
 
 #include <moveit_simple_controller_manager/follow_joint_trajectory_controller_handle.h>
+#include <algorithm>
 
 using namespace std::placeholders;
 
 namespace moveit_simple_controller_manager
 {
+namespace
+{
+double timeFromStart(const trajectory_msgs::msg::JointTrajectoryPoint& point)
+{
+  return rclcpp::Duration(point.time_from_start).seconds();
+}
+
+/**
+ * Extract the points covering [from, to]: the last point at or before \e from up to the first point at or after \e to.
+ * Timing (header stamp and time_from_start) is left untouched so chunks line up on the controller's time axis.
+ */
+trajectory_msgs::msg::JointTrajectory extractChunk(const trajectory_msgs::msg::JointTrajectory& trajectory, double from,
+                                                   double to)
+{
+  trajectory_msgs::msg::JointTrajectory chunk;
+  chunk.header = trajectory.header;
+  chunk.joint_names = trajectory.joint_names;
+
+  const auto& points = trajectory.points;
+  std::size_t begin = 0;
+  while (begin + 1 < points.size() && timeFromStart(points[begin + 1]) <= from)
+    ++begin;
+  std::size_t end = begin;
+  while (end + 1 < points.size() && timeFromStart(points[end]) < to)
+    ++end;
+  chunk.points.assign(points.begin() + begin, points.begin() + end + 1);
+  return chunk;
+}
+}  // namespace
+
+FollowJointTrajectoryControllerHandle::~FollowJointTrajectoryControllerHandle()
+{
+  stopStreaming();
+}
+
+void FollowJointTrajectoryControllerHandle::setStreaming(double chunk_duration, double lead_time)
+{
+  stream_chunk_duration_ = chunk_duration;
+  stream_lead_time_ = std::max(0.0, lead_time);
+}
+
 bool FollowJointTrajectoryControllerHandle::sendTrajectory(const moveit_msgs::msg::RobotTrajectory& trajectory)
 {
   RCLCPP_DEBUG_STREAM(LOGGER, "new trajectory to " << name_);
@@ -59,10 +101,51 @@ bool FollowJointTrajectoryControllerHandle::sendTrajectory(const moveit_msgs::ms
   else
     RCLCPP_INFO_STREAM(LOGGER, "sending continuation for the currently executed trajectory to " << name_);
 
+  // A new trajectory supersedes whatever is still being streamed
+  stopStreaming();
+
   control_msgs::action::FollowJointTrajectory::Goal goal = goal_template_;
-  goal.trajectory = trajectory.joint_trajectory;
   goal.multi_dof_trajectory = trajectory.multi_dof_joint_trajectory;
 
+  const auto& points = trajectory.joint_trajectory.points;
+  const bool stream = stream_chunk_duration_ > 0.0 && trajectory.multi_dof_joint_trajectory.points.empty() &&
+                      !points.empty() && timeFromStart(points.back()) > stream_chunk_duration_ + stream_lead_time_;
+  if (!stream)
+  {
+    goal.trajectory = trajectory.joint_trajectory;
+    return sendGoal(goal);
+  }
+
+  // All chunks need a common absolute start time, otherwise each would be played relative to its own arrival
+  trajectory_msgs::msg::JointTrajectory joint_trajectory = trajectory.joint_trajectory;
+  if (rclcpp::Time(joint_trajectory.header.stamp).nanoseconds() == 0)
+    joint_trajectory.header.stamp = node_->now();
+
+  std::vector<double> chunk_starts;
+  const double duration = timeFromStart(points.back());
+  for (double t = 0.0; t < duration; t += stream_chunk_duration_)
+    chunk_starts.push_back(t);
+  chunk_starts.push_back(duration);
+
+  RCLCPP_INFO_STREAM(LOGGER, "streaming trajectory to " << name_ << " in " << chunk_starts.size() - 1 << " chunks");
+
+  goal.trajectory = extractChunk(joint_trajectory, 0.0, chunk_starts[1]);
+  if (!sendGoal(goal))
+    return false;
+
+  {
+    std::lock_guard<std::mutex> lock(stream_mutex_);
+    stream_stop_ = false;
+    stream_done_ = false;
+  }
+  stream_failed_ = false;
+  stream_thread_ = std::thread(&FollowJointTrajectoryControllerHandle::streamChunks, this, std::move(joint_trajectory),
+                               std::move(chunk_starts));
+  return true;
+}
+
+bool FollowJointTrajectoryControllerHandle::sendGoal(const control_msgs::action::FollowJointTrajectory::Goal& goal)
+{
   rclcpp_action::Client<control_msgs::action::FollowJointTrajectory>::SendGoalOptions send_goal_options;
   // Active callback
   send_goal_options.goal_response_callback =
@@ -79,15 +162,103 @@ bool FollowJointTrajectoryControllerHandle::sendTrajectory(const moveit_msgs::ms
 
   // Send goal
   auto current_goal_future = controller_action_client_->async_send_goal(goal, send_goal_options);
-  current_goal_ = current_goal_future.get();
-  if (!current_goal_)
+  auto goal_handle = current_goal_future.get();
+  if (!goal_handle)
   {
     RCLCPP_ERROR(LOGGER, "Goal was rejected by server");
     return false;
   }
+  std::lock_guard<std::mutex> lock(stream_mutex_);
+  current_goal_ = goal_handle;
   return true;
 }
 
+void FollowJointTrajectoryControllerHandle::streamChunks(trajectory_msgs::msg::JointTrajectory trajectory,
+                                                           std::vector<double> chunk_starts)
+{
+  const rclcpp::Time start(trajectory.header.stamp);
+  for (std::size_t i = 1; i + 1 < chunk_starts.size(); ++i)
+  {
+    // The chunk overlaps the previous one by the lead time, so playback continues seamlessly when it replaces it
+    const double send_offset = chunk_starts[i] - stream_lead_time_;
+    {
+      std::unique_lock<std::mutex> lock(stream_mutex_);
+      const rclcpp::Duration wait_time = (start + rclcpp::Duration::from_seconds(send_offset)) - node_->now();
+      if (stream_cv_.wait_for(lock, wait_time.to_chrono<std::chrono::nanoseconds>(), [this] { return stream_stop_; }))
+        break;
+    }
+
+    control_msgs::action::FollowJointTrajectory::Goal goal = goal_template_;
+    goal.trajectory = extractChunk(trajectory, send_offset, chunk_starts[i + 1]);
+    RCLCPP_DEBUG_STREAM(LOGGER, "sending chunk " << i << " (" << goal.trajectory.points.size() << " points) to "
+                                                  << name_);
+    if (!sendGoal(goal))
+    {
+      RCLCPP_ERROR_STREAM(LOGGER, "Streaming to " << name_ << " failed at chunk " << i);
+      stream_failed_ = true;
+      break;
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(stream_mutex_);
+  stream_done_ = true;
+  stream_cv_.notify_all();
+}
+
+void FollowJointTrajectoryControllerHandle::stopStreaming()
+{
+  {
+    std::lock_guard<std::mutex> lock(stream_mutex_);
+    stream_stop_ = true;
+    stream_cv_.notify_all();
+  }
+  if (stream_thread_.joinable())
+    stream_thread_.join();
+}
+
+bool FollowJointTrajectoryControllerHandle::cancelExecution()
+{
+  stopStreaming();
+  return ActionBasedControllerHandle<control_msgs::action::FollowJointTrajectory>::cancelExecution();
+}
+
+bool FollowJointTrajectoryControllerHandle::waitForExecution(const rclcpp::Duration& timeout)
+{
+  rclcpp::Duration remaining = timeout;
+  if (stream_thread_.joinable())
+  {
+    // The final goal only exists once the last chunk has been sent
+    const auto wait_start = std::chrono::steady_clock::now();
+    {
+      std::unique_lock<std::mutex> lock(stream_mutex_);
+      if (timeout < std::chrono::nanoseconds(0))
+        stream_cv_.wait(lock, [this] { return stream_done_; });
+      else if (!stream_cv_.wait_for(lock, timeout.to_chrono<std::chrono::nanoseconds>(),
+                                    [this] { return stream_done_; }))
+      {
+        RCLCPP_WARN(LOGGER, "waitForExecution timed out while streaming");
+        return false;
+      }
+    }
+    stream_thread_.join();
+    if (timeout >= std::chrono::nanoseconds(0))
+    {
+      remaining = timeout - rclcpp::Duration(std::chrono::steady_clock::now() - wait_start);
+      if (remaining < std::chrono::nanoseconds(0))
+        remaining = rclcpp::Duration::from_seconds(0.0);
+    }
+
+    if (stream_failed_)
+    {
+      // Don't let the controller finish a truncated trajectory as if it were a success
+      ActionBasedControllerHandle<control_msgs::action::FollowJointTrajectory>::cancelExecution();
+      last_exec_ = moveit_controller_manager::ExecutionStatus::ABORTED;
+      return true;
+    }
+  }
+  return ActionBasedControllerHandle<control_msgs::action::FollowJointTrajectory>::waitForExecution(remaining);
+}
+
 // TODO(JafarAbdi): Revise parameter lookup
 // void FollowJointTrajectoryControllerHandle::configure(XmlRpc::XmlRpcValue& config)
 //{
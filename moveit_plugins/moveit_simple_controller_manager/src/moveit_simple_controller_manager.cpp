@@ -178,7 +178,19 @@ public:
         }
         else if (type == "FollowJointTrajectory")
         {
-          new_handle = std::make_shared<FollowJointTrajectoryControllerHandle>(node_, controller_name, action_ns);
+          auto trajectory_handle =
+              std::make_shared<FollowJointTrajectoryControllerHandle>(node_, controller_name, action_ns);
+
+          // Optionally stream long trajectories in chunks to reduce the time until motion starts
+          double stream_chunk_duration;
+          double stream_lead_time;
+          node_->get_parameter_or(makeParameterName(PARAM_BASE_NAME, controller_name, "stream_chunk_duration"),
+                                  stream_chunk_duration, 0.0);
+          node_->get_parameter_or(makeParameterName(PARAM_BASE_NAME, controller_name, "stream_lead_time"),
+                                  stream_lead_time, 0.5);
+          trajectory_handle->setStreaming(stream_chunk_duration, stream_lead_time);
+
+          new_handle = trajectory_handle;
           RCLCPP_INFO_STREAM(LOGGER, "Added FollowJointTrajectory controller for " << controller_name);
           controllers_[controller_name] = new_handle;
         }
@@ -0,0 +1,88 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+
+struct sqlite3;
+
+namespace moveit_ros_benchmarks
+{
+/// Writes benchmark results to an SQLite database while the benchmark runs, using the schema that
+/// moveit_benchmark_statistics.py creates from benchmark log files, so Planner Arena can open the database directly.
+/// Every run is inserted as soon as it completes, with a column of the declared type (REAL, INTEGER, BOOLEAN) for each
+/// of its properties. The writer is not thread safe.
+class BenchmarkDatabaseWriter
+{
+public:
+  /// Open (or create) the database at \e filename and create the tables that do not exist yet
+  BenchmarkDatabaseWriter(const std::string& filename);
+  ~BenchmarkDatabaseWriter();
+
+  BenchmarkDatabaseWriter(const BenchmarkDatabaseWriter&) = delete;
+  BenchmarkDatabaseWriter& operator=(const BenchmarkDatabaseWriter&) = delete;
+
+  /// Whether the database could be opened and its tables created
+  bool isValid() const
+  {
+    return db_ != nullptr;
+  }
+
+  /// Add an experiment, returning its id or -1 on failure. The total time is set by finishExperiment().
+  std::int64_t addExperiment(const std::string& name, double time_limit, int run_count, const std::string& version,
+                             const std::string& hostname, const std::string& date, const std::string& setup,
+                             unsigned int seed = 0);
+
+  /// Set the total time in seconds it took to collect the data of an experiment
+  void finishExperiment(std::int64_t experiment_id, double total_time);
+
+  /// Get the id of the planner configuration named \e name, adding it if needed. Returns -1 on failure.
+  std::int64_t getPlannerId(const std::string& name);
+
+  /// Insert a run, given as "<property> <TYPE>" keys mapped to values as in the benchmark log. Columns that do not
+  /// exist yet are added. Returns false if the run could not be inserted.
+  bool addRun(std::int64_t experiment_id, std::int64_t planner_id, const std::map<std::string, std::string>& run);
+
+private:
+  bool execute(const std::string& sql);
+
+  sqlite3* db_;
+  /// The columns of the runs table
+  std::set<std::string> run_columns_;
+};
+}  // namespace moveit_ros_benchmarks
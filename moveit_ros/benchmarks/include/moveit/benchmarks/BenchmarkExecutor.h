@@ -37,6 +37,7 @@
 #pragma once
 
 #include <moveit/benchmarks/BenchmarkOptions.h>
+#include <moveit/benchmarks/BenchmarkDatabaseWriter.h>
 
 #include <moveit/planning_scene_monitor/planning_scene_monitor.h>
 
@@ -50,6 +51,7 @@
 #include <pluginlib/class_loader.hpp>
 
 #include <map>
+#include <memory>
 #include <vector>
 #include <string>
 #include <functional>
@@ -195,7 +197,11 @@ protected:
                                  const std::vector<PathConstraints>& path_constraints,
                                  std::vector<BenchmarkRequest>& combos);
 
-  /// Execute the given motion plan request on the set of planners for the set number of runs
+  /// Execute the given motion plan request on the set of planners for the set number of runs.
+  /// With more than one worker configured, the runs of each planner are distributed over worker threads that plan on
+  /// their own clone of the planning scene and their own copy of the request. Run events are called from the worker
+  /// threads one at a time, collectMetrics() is called concurrently. The results are stored by run index, so they are
+  /// laid out as in a serial benchmark.
   void runBenchmark(moveit_msgs::msg::MotionPlanRequest request,
                     const std::map<std::string, std::vector<std::string>>& planners, int runs);
 
@@ -216,6 +222,11 @@ protected:
 
   std::vector<PlannerBenchmarkData> benchmark_data_;
 
+  /// Streams every run to the output database as it completes, if one is configured
+  std::unique_ptr<BenchmarkDatabaseWriter> database_;
+  /// The database id of the experiment (query) that is benchmarked
+  std::int64_t database_experiment_id_ = -1;
+
   std::vector<PreRunEventFunction> pre_event_fns_;
   std::vector<PostRunEventFunction> post_event_fns_;
   std::vector<PlannerStartEventFunction> planner_start_fns_;
@@ -68,12 +68,18 @@ public:
   int getNumRuns() const;
   /** \brief Get the maximum timeout per planning attempt */
   double getTimeout() const;
+  /** \brief Get the number of worker threads that execute the runs of a planner concurrently */
+  int getNumWorkers() const;
+  /** \brief Get the seed of the random number generators for reproducible runs, 0 if they are seeded randomly */
+  unsigned int getSeed() const;
   /** \brief Get the reference name of the benchmark */
   const std::string& getBenchmarkName() const;
   /** \brief Get the name of the planning group to run the benchmark with */
   const std::string& getGroupName() const;
   /** \brief Get the target directory for the generated benchmark result data */
   const std::string& getOutputDirectory() const;
+  /** \brief Get the SQLite database the results are streamed to while benchmarking (empty if disabled) */
+  const std::string& getOutputDatabase() const;
   /** \brief Get the regex expression for matching the names of all queries to run */
   const std::string& getQueryRegex() const;
   /** \brief Get the regex expression for matching the names of all start states to plan from */
@@ -118,9 +124,12 @@ protected:
   /// benchmark parameters
   int runs_;
   double timeout_;
+  int num_workers_;
+  int seed_;
   std::string benchmark_name_;
   std::string group_name_;
   std::string output_directory_;
+  std::string output_database_;
   std::string query_regex_;
   std::string start_state_regex_;
   std::string goal_constraint_regex_;
@@ -0,0 +1,211 @@
+#!/usr/bin/env python3
+
+######################################################################
+# Software License Agreement (BSD License)
+#
+#  Copyright (c) 2026, PickNik Robotics
+#  All rights reserved.
+#
+#  Redistribution and use in source and binary forms, with or without
+#  modification, are permitted provided that the following conditions
+#  are met:
+#
+#   * Redistributions of source code must retain the above copyright
+#     notice, this list of conditions and the following disclaimer.
+#   * Redistributions in binary form must reproduce the above
+#     copyright notice, this list of conditions and the following
+#     disclaimer in the documentation and/or other materials provided
+#     with the distribution.
+#   * Neither the name of PickNik Robotics nor the names of its
+#     contributors may be used to endorse or promote products derived
+#     from this software without specific prior written permission.
+#
+#  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+#  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+#  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+#  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+#  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+#  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+#  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+#  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+#  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+#  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+#  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+#  POSSIBILITY OF SUCH DAMAGE.
+######################################################################
+
+
+# Compares a benchmark database against a baseline database and reports the planners that got significantly worse.
+# Both databases are created by moveit_benchmark_statistics.py or by the output_database option of the benchmark
+# executor; runs are matched by experiment (query) and planner name. Seed the benchmarks (the seed parameter) to
+# reduce the noise between both sets of runs.
+#
+# A metric regresses if the one-sided Mann-Whitney U test finds the candidate runs larger than the baseline runs with
+# a p-value below --alpha, and its median grew by more than --min-change. The success rate regresses if a one-sided
+# two-proportion z-test finds it lower. The exit status is 1 if anything regressed.
+
+from math import erfc, sqrt
+from optparse import OptionParser
+import sqlite3
+import sys
+
+
+def normalUpperTail(z):
+    return 0.5 * erfc(z / sqrt(2.0))
+
+
+def median(values):
+    ordered = sorted(values)
+    n = len(ordered)
+    if n == 0:
+        return float("nan")
+    if n % 2:
+        return ordered[n // 2]
+    return 0.5 * (ordered[n // 2 - 1] + ordered[n // 2])
+
+
+def mannWhitneyGreater(baseline, candidate):
+    """p-value of the hypothesis that candidate values tend to be larger than baseline values, using the normal
+    approximation with tie correction"""
+    n1 = len(candidate)
+    n2 = len(baseline)
+    if n1 == 0 or n2 == 0:
+        return 1.0
+    values = sorted([(v, 0) for v in candidate] + [(v, 1) for v in baseline])
+    n = n1 + n2
+    # assign average ranks to ties
+    rank_sum = 0.0
+    tie_term = 0.0
+    i = 0
+    while i < n:
+        j = i
+        while j + 1 < n and values[j + 1][0] == values[i][0]:
+            j += 1
+        rank = 0.5 * (i + j) + 1.0
+        rank_sum += rank * sum(1 for k in range(i, j + 1) if values[k][1] == 0)
+        ties = j - i + 1
+        tie_term += ties**3 - ties
+        i = j + 1
+    u = rank_sum - n1 * (n1 + 1) / 2.0
+    mean = n1 * n2 / 2.0
+    variance = n1 * n2 / 12.0 * ((n + 1) - tie_term / (n * (n - 1))) if n > 1 else 0.0
+    if variance <= 0.0:
+        return 1.0
+    # continuity correction
+    return normalUpperTail((u - mean - 0.5) / sqrt(variance))
+
+
+def proportionLower(baseline_successes, baseline_count, candidate_successes, candidate_count):
+    """p-value of the hypothesis that the candidate success rate is lower than the baseline success rate"""
+    if baseline_count == 0 or candidate_count == 0:
+        return 1.0
+    pooled = (baseline_successes + candidate_successes) / float(baseline_count + candidate_count)
+    variance = pooled * (1.0 - pooled) * (1.0 / baseline_count + 1.0 / candidate_count)
+    if variance <= 0.0:
+        return 1.0
+    difference = baseline_successes / float(baseline_count) - candidate_successes / float(candidate_count)
+    return normalUpperTail(difference / sqrt(variance))
+
+
+def readRuns(dbname, metrics):
+    """Map (experiment name, planner name) to the success flags and metric values of its runs"""
+    conn = sqlite3.connect(dbname)
+    c = conn.cursor()
+    columns = [row[1] for row in c.execute("PRAGMA table_info(runs)")]
+    available = [m for m in metrics if m in columns]
+    selected = ", ".join('runs."%s"' % m for m in available)
+    solved = 'runs."solved"' if "solved" in columns else "1"
+    query = (
+        "SELECT experiments.name, plannerConfigs.name, %s%s FROM runs"
+        " INNER JOIN experiments ON experiments.id = runs.experimentid"
+        " INNER JOIN plannerConfigs ON plannerConfigs.id = runs.plannerid"
+        % (solved, ", " + selected if selected else "")
+    )
+    runs = {}
+    for row in c.execute(query):
+        entry = runs.setdefault((row[0], row[1]), {"solved": [], "metrics": {m: [] for m in available}})
+        entry["solved"].append(bool(row[2]))
+        for m, value in zip(available, row[3:]):
+            # only solved runs have meaningful metric values
+            if value is not None and row[2]:
+                entry["metrics"][m].append(float(value))
+    conn.close()
+    return runs
+
+
+def compare(baseline_db, candidate_db, metrics, alpha, min_change):
+    baseline = readRuns(baseline_db, metrics)
+    candidate = readRuns(candidate_db, metrics)
+    regressions = 0
+    for key in sorted(set(baseline) & set(candidate)):
+        experiment, planner = key
+        b = baseline[key]
+        c = candidate[key]
+        lines = []
+
+        p = proportionLower(sum(b["solved"]), len(b["solved"]), sum(c["solved"]), len(c["solved"]))
+        b_rate = sum(b["solved"]) / float(len(b["solved"]))
+        c_rate = sum(c["solved"]) / float(len(c["solved"]))
+        if p < alpha:
+            lines.append("  success rate %.3f -> %.3f (p = %.4f)" % (b_rate, c_rate, p))
+
+        for m in metrics:
+            b_values = b["metrics"].get(m, [])
+            c_values = c["metrics"].get(m, [])
+            if not b_values or not c_values:
+                continue
+            b_median = median(b_values)
+            c_median = median(c_values)
+            change = (c_median - b_median) / abs(b_median) if b_median != 0.0 else float("inf")
+            if c_median <= b_median or change <= min_change:
+                continue
+            p = mannWhitneyGreater(b_values, c_values)
+            if p < alpha:
+                lines.append("  %s median %g -> %g (%+.1f%%, p = %.4f)" % (m, b_median, c_median, 100.0 * change, p))
+
+        if lines:
+            regressions += 1
+            print("REGRESSION %s / %s" % (experiment, planner))
+            for line in lines:
+                print(line)
+
+    for key in sorted(set(baseline) - set(candidate)):
+        print("missing from candidate: %s / %s" % key)
+    print("%d of %d planner configurations regressed" % (regressions, len(set(baseline) & set(candidate))))
+    return regressions
+
+
+if __name__ == "__main__":
+    usage = """%prog [options] <baseline.db> <candidate.db>"""
+    parser = OptionParser("A script to find performance regressions between benchmark databases.\n" + usage)
+    parser.add_option(
+        "-m",
+        "--metric",
+        dest="metrics",
+        action="append",
+        default=None,
+        help="Metric to compare, lower is better, can be repeated [default: time]",
+    )
+    parser.add_option(
+        "-a",
+        "--alpha",
+        dest="alpha",
+        type="float",
+        default=0.01,
+        help="Significance level of the tests [default: %default]",
+    )
+    parser.add_option(
+        "-c",
+        "--min-change",
+        dest="min_change",
+        type="float",
+        default=0.05,
+        help="Minimal relative growth of the median to count as a regression [default: %default]",
+    )
+    (options, args) = parser.parse_args()
+
+    if len(args) != 2:
+        parser.error("Please provide a baseline and a candidate database")
+
+    regressions = compare(args[0], args[1], options.metrics or ["time"], options.alpha, options.min_change)
+    sys.exit(1 if regressions else 0)
@@ -0,0 +1,223 @@
+#!/usr/bin/env python3
+
+######################################################################
+# Software License Agreement (BSD License)
+#
+#  Copyright (c) 2026, PickNik Robotics
+#  All rights reserved.
+#
+#  Redistribution and use in source and binary forms, with or without
+#  modification, are permitted provided that the following conditions
+#  are met:
+#
+#   * Redistributions of source code must retain the above copyright
+#     notice, this list of conditions and the following disclaimer.
+#   * Redistributions in binary form must reproduce the above
+#     copyright notice, this list of conditions and the following
+#     disclaimer in the documentation and/or other materials provided
+#     with the distribution.
+#   * Neither the name of PickNik Robotics nor the names of its
+#     contributors may be used to endorse or promote products derived
+#     from this software without specific prior written permission.
+#
+#  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+#  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+#  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+#  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+#  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+#  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+#  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+#  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+#  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+#  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+#  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+#  POSSIBILITY OF SUCH DAMAGE.
+######################################################################
+
+# Turns an LTTng trace of the moveit:stage_begin / moveit:stage_end tracepoints (see moveit/utils/tracing.h) into
+# latency breakdowns. Stages are nested per thread, so record the trace with the vtid context:
+#
+#   lttng create moveit && lttng enable-event -u 'moveit:*' && lttng add-context -u -t vtid && lttng start
+#   ... run the requests ...
+#   lttng stop && lttng destroy
+#   moveit_trace_latency.py ~/lttng-traces/moveit-<date>
+#
+# Reading traces requires the babeltrace2 Python bindings (python3-bt2).
+
+import csv
+import sys
+from optparse import OptionParser
+
+
+class Stage(object):
+    """One traced execution of a stage"""
+
+    def __init__(self, name, thread, context, begin, depth, parent):
+        self.name = name
+        self.thread = thread
+        self.context = context
+        self.begin = begin
+        self.end = None
+        self.depth = depth
+        self.parent = parent
+        self.children_time = 0
+        self.success = None
+
+    def duration(self):
+        return self.end - self.begin
+
+    def selfTime(self):
+        return self.duration() - self.children_time
+
+    def root(self):
+        stage = self
+        while stage.parent is not None:
+            stage = stage.parent
+        return stage
+
+
+def readEvents(trace_path):
+    """Yield (timestamp [ns], thread, event name, stage, context, success) of the MoveIt events of a trace"""
+    import bt2
+
+    for msg in bt2.TraceCollectionMessageIterator(trace_path):
+        if type(msg) is not bt2._EventMessageConst:
+            continue
+        event = msg.event
+        if event.name not in ("moveit:stage_begin", "moveit:stage_end"):
+            continue
+        thread = 0
+        if event.common_context_field is not None and "vtid" in event.common_context_field:
+            thread = int(event.common_context_field["vtid"])
+        success = int(event.payload_field["success"]) if "success" in event.payload_field else None
+        yield (
+            msg.default_clock_snapshot.ns_from_origin,
+            thread,
+            event.name,
+            str(event.payload_field["stage"]),
+            int(event.payload_field["context"]),
+            success,
+        )
+
+
+def pairStages(events):
+    """Match the begin and end events of each thread, returning the completed stages in the order they began.
+    An end event closes the innermost open stage of the same name, stages left open in between are dropped."""
+    open_stages = {}
+    stages = []
+    for timestamp, thread, event_name, name, context, success in events:
+        stack = open_stages.setdefault(thread, [])
+        if event_name == "moveit:stage_begin":
+            parent = stack[-1] if stack else None
+            stage = Stage(name, thread, context, timestamp, len(stack), parent)
+            stack.append(stage)
+            stages.append(stage)
+            continue
+        for i in range(len(stack) - 1, -1, -1):
+            if stack[i].name == name:
+                stage = stack[i]
+                del stack[i:]
+                stage.end = timestamp
+                stage.success = success
+                if stage.parent is not None:
+                    stage.parent.children_time += stage.duration()
+                break
+    return [stage for stage in stages if stage.end is not None]
+
+
+def percentile(sorted_values, fraction):
+    index = min(len(sorted_values) - 1, int(round(fraction * (len(sorted_values) - 1))))
+    return sorted_values[index]
+
+
+def summarize(stages, root=None):
+    """Per stage name: count, total and self time statistics in ms, only of stages below \\e root if given"""
+    summary = {}
+    for stage in stages:
+        if root is not None and stage.root().name != root:
+            continue
+        entry = summary.setdefault(stage.name, ([], [], [stage.depth]))
+        entry[0].append(stage.duration() * 1e-6)
+        entry[1].append(stage.selfTime() * 1e-6)
+    rows = []
+    for name, (durations, self_times, depth) in summary.items():
+        durations.sort()
+        rows.append(
+            (
+                name,
+                depth[0],
+                len(durations),
+                sum(durations) / len(durations),
+                percentile(durations, 0.5),
+                percentile(durations, 0.95),
+                durations[-1],
+                sum(self_times) / len(self_times),
+            )
+        )
+    # callers before the stages they contain
+    rows.sort(key=lambda row: (row[1], -row[3]))
+    return rows
+
+
+def printSummary(rows, out=sys.stdout):
+    header = ("stage", "count", "mean [ms]", "median", "p95", "max", "self mean")
+    width = max([len(header[0])] + [len(row[0]) + 2 * row[1] for row in rows])
+    out.write("%-*s %7s %10s %10s %10s %10s %10s\n" % ((width,) + header))
+    for name, depth, count, mean, median, p95, maximum, self_mean in rows:
+        out.write(
+            "%-*s %7d %10.3f %10.3f %10.3f %10.3f %10.3f\n"
+            % (width, "  " * depth + name, count, mean, median, p95, maximum, self_mean)
+        )
+
+
+def writeCsv(stages, filename):
+    with open(filename, "w") as f:
+        writer = csv.writer(f)
+        writer.writerow(
+            ["root", "thread", "stage", "depth", "context", "begin_ns", "duration_ms", "self_ms", "success"]
+        )
+        for stage in stages:
+            writer.writerow(
+                [
+                    stage.root().name,
+                    stage.thread,
+                    stage.name,
+                    stage.depth,
+                    "0x%x" % stage.context,
+                    stage.begin,
+                    stage.duration() * 1e-6,
+                    stage.selfTime() * 1e-6,
+                    stage.success,
+                ]
+            )
+
+
+if __name__ == "__main__":
+    usage = """%prog [options] <trace directory>"""
+    parser = OptionParser("Latency breakdown of the MoveIt stages in an LTTng trace.\n" + usage)
+    parser.add_option(
+        "-r",
+        "--root",
+        dest="root",
+        default=None,
+        help="Only include stages called within the given outermost stage, e.g. move_group.move",
+    )
+    parser.add_option(
+        "-c",
+        "--csv",
+        dest="csv",
+        default=None,
+        help="Write every traced stage with its total and self time to the given CSV file",
+    )
+    (options, args) = parser.parse_args()
+
+    if len(args) != 1:
+        parser.error("Expected exactly one trace directory")
+
+    stages = pairStages(readEvents(args[0]))
+    if not stages:
+        print("No MoveIt stages found in the trace. Was MoveIt built with MOVEIT_ENABLE_TRACING=ON?")
+        sys.exit(1)
+    printSummary(summarize(stages, options.root))
+    if options.csv:
+        writeCsv(stages, options.csv)
@@ -0,0 +1,280 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/benchmarks/BenchmarkDatabaseWriter.h>
+#include <rclcpp/logging.hpp>
+#include <sqlite3.h>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+using namespace moveit_ros_benchmarks;
+
+static const rclcpp::Logger LOGGER = rclcpp::get_logger("moveit.ros.benchmarks.BenchmarkDatabaseWriter");
+
+namespace
+{
+// the tables created by moveit_benchmark_statistics.py
+const char* const SCHEMA = "CREATE TABLE IF NOT EXISTS experiments"
+                           " (id INTEGER PRIMARY KEY ON CONFLICT REPLACE AUTOINCREMENT, name VARCHAR(512),"
+                           " totaltime REAL, timelimit REAL, memorylimit REAL, runcount INTEGER,"
+                           " version VARCHAR(128), hostname VARCHAR(1024), cpuinfo TEXT,"
+                           " date DATETIME, seed INTEGER, setup TEXT);"
+                           "CREATE TABLE IF NOT EXISTS plannerConfigs"
+                           " (id INTEGER PRIMARY KEY AUTOINCREMENT,"
+                           " name VARCHAR(512) NOT NULL, settings TEXT);"
+                           "CREATE TABLE IF NOT EXISTS enums"
+                           " (name VARCHAR(512), value INTEGER, description TEXT,"
+                           " PRIMARY KEY (name, value));"
+                           "CREATE TABLE IF NOT EXISTS runs"
+                           " (id INTEGER PRIMARY KEY AUTOINCREMENT, experimentid INTEGER, plannerid INTEGER,"
+                           " FOREIGN KEY (experimentid) REFERENCES experiments(id) ON DELETE CASCADE,"
+                           " FOREIGN KEY (plannerid) REFERENCES plannerConfigs(id) ON DELETE CASCADE);"
+                           "CREATE TABLE IF NOT EXISTS progress"
+                           " (runid INTEGER, time REAL, PRIMARY KEY (runid, time),"
+                           " FOREIGN KEY (runid) REFERENCES runs(id) ON DELETE CASCADE);";
+
+using Statement = std::unique_ptr<sqlite3_stmt, decltype(&sqlite3_finalize)>;
+
+Statement prepare(sqlite3* db, const std::string& sql)
+{
+  sqlite3_stmt* statement = nullptr;
+  if (sqlite3_prepare_v2(db, sql.c_str(), -1, &statement, nullptr) != SQLITE_OK)
+    RCLCPP_ERROR(LOGGER, "Failed to prepare '%s': %s", sql.c_str(), sqlite3_errmsg(db));
+  return Statement(statement, &sqlite3_finalize);
+}
+
+void bindText(const Statement& statement, int index, const std::string& text)
+{
+  sqlite3_bind_text(statement.get(), index, text.c_str(), -1, SQLITE_TRANSIENT);
+}
+
+std::string quoteIdentifier(const std::string& identifier)
+{
+  std::string quoted = "\"";
+  for (char c : identifier)
+  {
+    if (c == '"')
+      quoted += '"';
+    quoted += c;
+  }
+  return quoted + "\"";
+}
+
+// the column name and type of a "<property> <TYPE>" key, named like moveit_benchmark_statistics.py does
+void splitProperty(const std::string& key, std::string& name, std::string& type)
+{
+  std::istringstream fields(key);
+  std::vector<std::string> tokens;
+  for (std::string token; fields >> token;)
+    tokens.push_back(token);
+  type = tokens.size() > 1 ? tokens.back() : "TEXT";
+  name.clear();
+  for (std::size_t i = 0; i + (tokens.size() > 1 ? 1 : 0) < tokens.size(); ++i)
+    name += (name.empty() ? "" : "_") + tokens[i];
+}
+
+bool isInvalidValue(const std::string& value)
+{
+  return value.empty() || value == "nan" || value == "-nan" || value == "inf" || value == "-inf";
+}
+
+void bindValue(const Statement& statement, int index, const std::string& type, const std::string& value)
+{
+  if (isInvalidValue(value))
+    sqlite3_bind_null(statement.get(), index);
+  else if (type == "BOOLEAN")
+    sqlite3_bind_int(statement.get(), index, value == "true" || value == "1" ? 1 : 0);
+  else
+  {
+    try
+    {
+      if (type == "REAL")
+        sqlite3_bind_double(statement.get(), index, std::stod(value));
+      else if (type == "INTEGER")
+        sqlite3_bind_int64(statement.get(), index, std::stoll(value));
+      else
+        bindText(statement, index, value);
+    }
+    catch (const std::logic_error&)
+    {
+      bindText(statement, index, value);
+    }
+  }
+}
+}  // namespace
+
+BenchmarkDatabaseWriter::BenchmarkDatabaseWriter(const std::string& filename) : db_(nullptr)
+{
+  if (sqlite3_open(filename.c_str(), &db_) != SQLITE_OK)
+  {
+    RCLCPP_ERROR(LOGGER, "Failed to open benchmark database '%s': %s", filename.c_str(), sqlite3_errmsg(db_));
+    sqlite3_close(db_);
+    db_ = nullptr;
+    return;
+  }
+  if (!execute("PRAGMA FOREIGN_KEYS = ON") || !execute(SCHEMA))
+  {
+    sqlite3_close(db_);
+    db_ = nullptr;
+    return;
+  }
+
+  Statement columns = prepare(db_, "PRAGMA table_info(runs)");
+  while (columns && sqlite3_step(columns.get()) == SQLITE_ROW)
+    run_columns_.insert(reinterpret_cast<const char*>(sqlite3_column_text(columns.get(), 1)));
+}
+
+BenchmarkDatabaseWriter::~BenchmarkDatabaseWriter()
+{
+  sqlite3_close(db_);
+}
+
+bool BenchmarkDatabaseWriter::execute(const std::string& sql)
+{
+  char* error = nullptr;
+  if (sqlite3_exec(db_, sql.c_str(), nullptr, nullptr, &error) == SQLITE_OK)
+    return true;
+  RCLCPP_ERROR(LOGGER, "Failed to execute '%s': %s", sql.c_str(), error ? error : "unknown error");
+  sqlite3_free(error);
+  return false;
+}
+
+std::int64_t BenchmarkDatabaseWriter::addExperiment(const std::string& name, double time_limit, int run_count,
+                                                    const std::string& version, const std::string& hostname,
+                                                    const std::string& date, const std::string& setup,
+                                                    unsigned int seed)
+{
+  if (!db_)
+    return -1;
+  Statement insert = prepare(db_, "INSERT INTO experiments (name, totaltime, timelimit, memorylimit, runcount, version,"
+                                  " hostname, cpuinfo, date, seed, setup) VALUES (?, 0, ?, -1, ?, ?, ?, '', ?, ?, ?)");
+  if (!insert)
+    return -1;
+  bindText(insert, 1, name);
+  sqlite3_bind_double(insert.get(), 2, time_limit);
+  sqlite3_bind_int(insert.get(), 3, run_count);
+  bindText(insert, 4, version);
+  bindText(insert, 5, hostname);
+  bindText(insert, 6, date);
+  sqlite3_bind_int64(insert.get(), 7, seed);
+  bindText(insert, 8, setup);
+  if (sqlite3_step(insert.get()) != SQLITE_DONE)
+  {
+    RCLCPP_ERROR(LOGGER, "Failed to add experiment '%s': %s", name.c_str(), sqlite3_errmsg(db_));
+    return -1;
+  }
+  return sqlite3_last_insert_rowid(db_);
+}
+
+void BenchmarkDatabaseWriter::finishExperiment(std::int64_t experiment_id, double total_time)
+{
+  if (!db_)
+    return;
+  Statement update = prepare(db_, "UPDATE experiments SET totaltime = ? WHERE id = ?");
+  if (!update)
+    return;
+  sqlite3_bind_double(update.get(), 1, total_time);
+  sqlite3_bind_int64(update.get(), 2, experiment_id);
+  if (sqlite3_step(update.get()) != SQLITE_DONE)
+    RCLCPP_ERROR(LOGGER, "Failed to set the total time of experiment %ld: %s", static_cast<long>(experiment_id),
+                 sqlite3_errmsg(db_));
+}
+
+std::int64_t BenchmarkDatabaseWriter::getPlannerId(const std::string& name)
+{
+  if (!db_)
+    return -1;
+  Statement select = prepare(db_, "SELECT id FROM plannerConfigs WHERE (name = ? AND settings = '')");
+  if (!select)
+    return -1;
+  bindText(select, 1, name);
+  if (sqlite3_step(select.get()) == SQLITE_ROW)
+    return sqlite3_column_int64(select.get(), 0);
+
+  Statement insert = prepare(db_, "INSERT INTO plannerConfigs (name, settings) VALUES (?, '')");
+  if (!insert)
+    return -1;
+  bindText(insert, 1, name);
+  if (sqlite3_step(insert.get()) != SQLITE_DONE)
+  {
+    RCLCPP_ERROR(LOGGER, "Failed to add planner '%s': %s", name.c_str(), sqlite3_errmsg(db_));
+    return -1;
+  }
+  return sqlite3_last_insert_rowid(db_);
+}
+
+bool BenchmarkDatabaseWriter::addRun(std::int64_t experiment_id, std::int64_t planner_id,
+                                     const std::map<std::string, std::string>& run)
+{
+  if (!db_)
+    return false;
+
+  std::vector<std::string> types;
+  std::vector<const std::string*> values;
+  std::string columns = "experimentid, plannerid";
+  std::string placeholders = "?, ?";
+  std::set<std::string> run_names;
+  for (const std::pair<const std::string, std::string>& property : run)
+  {
+    std::string name, type;
+    splitProperty(property.first, name, type);
+    if (name.empty() || !run_names.insert(name).second)
+      continue;
+    if (run_columns_.count(name) == 0)
+    {
+      if (!execute("ALTER TABLE runs ADD " + quoteIdentifier(name) + " " + type))
+        return false;
+      run_columns_.insert(name);
+    }
+    columns += ", " + quoteIdentifier(name);
+    placeholders += ", ?";
+    types.push_back(type);
+    values.push_back(&property.second);
+  }
+
+  Statement insert = prepare(db_, "INSERT INTO runs (" + columns + ") VALUES (" + placeholders + ")");
+  if (!insert)
+    return false;
+  sqlite3_bind_int64(insert.get(), 1, experiment_id);
+  sqlite3_bind_int64(insert.get(), 2, planner_id);
+  for (std::size_t i = 0; i < values.size(); ++i)
+    bindValue(insert, i + 3, types[i], *values[i]);
+  if (sqlite3_step(insert.get()) != SQLITE_DONE)
+  {
+    RCLCPP_ERROR(LOGGER, "Failed to add a run: %s", sqlite3_errmsg(db_));
+    return false;
+  }
+  return true;
+}
@@ -35,7 +35,9 @@
 /* Author: Ryan Luna */
 
 #include <moveit/benchmarks/BenchmarkExecutor.h>
+#include <moveit/utils/allocation_tracking.h>
 #include <moveit/utils/lexical_casts.h>
+#include <moveit/utils/random_seed.h>
 #include <moveit/version.h>
 #if __has_include(<tf2_eigen/tf2_eigen.hpp>)
 #include <tf2_eigen/tf2_eigen.hpp>
@@ -52,8 +54,13 @@
 #undef BOOST_ALLOW_DEPRECATED_HEADERS
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <math.h>
+#include <atomic>
+#include <cctype>
 #include <limits>
 #include <filesystem>
+#include <mutex>
+#include <sstream>
+#include <thread>
 #ifndef _WIN32
 #include <unistd.h>
 #else
@@ -184,6 +191,7 @@ void BenchmarkExecutor::clear()
   }
 
   benchmark_data_.clear();
+  database_.reset();
   pre_event_fns_.clear();
   post_event_fns_.clear();
   planner_start_fns_.clear();
@@ -238,6 +246,20 @@ bool BenchmarkExecutor::runBenchmarks(const BenchmarkOptions& opts)
     if (!queriesAndPlannersCompatible(queries, opts.getPlanningPipelineConfigurations()))
       return false;
 
+    database_.reset();
+    if (!options_.getOutputDatabase().empty())
+    {
+      std::filesystem::path database_path(options_.getOutputDatabase());
+      if (database_path.has_parent_path())
+        std::filesystem::create_directories(database_path.parent_path());
+      database_ = std::make_unique<BenchmarkDatabaseWriter>(options_.getOutputDatabase());
+      if (!database_->isValid())
+        database_.reset();
+    }
+    std::string hostname = getHostname();
+    if (hostname.empty())
+      hostname = "UNKNOWN";
+
     for (std::size_t i = 0; i < queries.size(); ++i)
     {
       // Configure planning scene
@@ -259,9 +281,29 @@ bool BenchmarkExecutor::runBenchmarks(const BenchmarkOptions& opts)
 
       RCLCPP_INFO(LOGGER, "Benchmarking query '%s' (%lu of %lu)", queries[i].name.c_str(), i + 1, queries.size());
       std::chrono::system_clock::time_point start_time = std::chrono::system_clock::now();
+      if (database_)
+      {
+        const moveit_msgs::msg::MotionPlanRequest& request = queries[i].request;
+        std::stringstream setup;
+        setup << "Motion plan request:" << '\n'
+              << "  group_name: " << request.group_name << '\n'
+              << "  num_planning_attempts: " << request.num_planning_attempts << '\n'
+              << "  allowed_planning_time: " << request.allowed_planning_time << '\n'
+              << "Planning scene:" << '\n'
+              << "  scene_name: " << scene_msg.name << '\n'
+              << "  robot_model_name: " << scene_msg.robot_model_name << '\n';
+        database_experiment_id_ = database_->addExperiment(
+            queries[i].name, request.allowed_planning_time, options_.getNumRuns(),
+            std::string("MoveIt ") + MOVEIT_VERSION_STR, hostname,
+            boost::posix_time::to_iso_extended_string(toBoost(start_time)), setup.str(), options_.getSeed());
+      }
       runBenchmark(queries[i].request, options_.getPlanningPipelineConfigurations(), options_.getNumRuns());
       std::chrono::duration<double> dt = std::chrono::system_clock::now() - start_time;
       double duration = dt.count();
+      RCLCPP_INFO(LOGGER, "Query '%s' took %f seconds of wall time with %d worker(s)", queries[i].name.c_str(),
+                  duration, std::max(options_.getNumWorkers(), 1));
+      if (database_)
+        database_->finishExperiment(database_experiment_id_, duration);
 
       for (QueryCompletionEventFunction& query_end_fn : query_end_fns_)
         query_end_fn(queries[i].request, planning_scene_);
@@ -807,32 +849,43 @@ void BenchmarkExecutor::runBenchmark(moveit_msgs::msg::MotionPlanRequest request
 
       request.planner_id = planner_id;
 
+      std::int64_t database_planner_id = -1;
+      if (database_)
+        database_planner_id = database_->getPlannerId(planner_id + " (" + pipeline_entry.first + ")");
+
       // Planner start events
       for (PlannerStartEventFunction& planner_start_fn : planner_start_fns_)
         planner_start_fn(request, planner_data);
 
-      planning_interface::PlanningContextPtr planning_context;
-      if (use_planning_context)
-        planning_context = planning_pipeline->getPlannerManager()->getPlanningContext(planning_scene_, request);
+      // Serializes the run events and the progress display between workers
+      std::mutex run_events_mutex;
+      const auto execute_run = [&](int j, moveit_msgs::msg::MotionPlanRequest& run_request,
+                                   const planning_scene::PlanningScenePtr& scene,
+                                   const planning_interface::PlanningContextPtr& planning_context) {
+        // Every run of a planner draws the same random numbers in the generators it creates, so a query is planned
+        // the same way in every benchmark and regressions stand out from the noise
+        if (options_.getSeed() > 0)
+          moveit::core::setRandomSeed(options_.getSeed() + j);
 
-      // Iterate runs
-      for (int j = 0; j < runs; ++j)
-      {
-        // Pre-run events
-        for (PreRunEventFunction& pre_event_fn : pre_event_fns_)
-          pre_event_fn(request);
+        {
+          // Pre-run events
+          std::scoped_lock lock(run_events_mutex);
+          for (PreRunEventFunction& pre_event_fn : pre_event_fns_)
+            pre_event_fn(run_request);
+        }
 
-        // Solve problem
+        // Solve problem, std::vector<bool> elements must not be written concurrently
+        bool run_solved;
         std::chrono::system_clock::time_point start = std::chrono::system_clock::now();
         if (use_planning_context)
         {
-          solved[j] = planning_context->solve(responses[j]);
+          run_solved = planning_context->solve(responses[j]);
         }
         else
         {
           // The planning pipeline does not support MotionPlanDetailedResponse
           planning_interface::MotionPlanResponse response;
-          solved[j] = planning_pipeline->generatePlan(planning_scene_, request, response);
+          run_solved = planning_pipeline->generatePlan(scene, run_request, response);
           responses[j].error_code_ = response.error_code_;
           if (response.trajectory_)
           {
@@ -840,6 +893,27 @@ void BenchmarkExecutor::runBenchmark(moveit_msgs::msg::MotionPlanRequest request
             responses[j].trajectory_.push_back(response.trajectory_);
             responses[j].processing_time_.push_back(response.planning_time_);
           }
+
+          // Time spent in each stage of the pipeline, e.g. stage_fix_start_state_bounds_time, and the allocations made
+          // in it if moveit_allocation_tracking is preloaded
+          const bool tracking_allocations = moveit::memory::isAllocationTrackingEnabled();
+          for (std::size_t k = 0; k < response.stage_descriptions_.size() && k < response.stage_times_.size(); ++k)
+          {
+            std::string stage = response.stage_descriptions_[k];
+            for (char& c : stage)
+              c = std::isalnum(static_cast<unsigned char>(c)) ? std::tolower(static_cast<unsigned char>(c)) : '_';
+            planner_data[j]["stage_" + stage + "_time REAL"] = moveit::core::toString(response.stage_times_[k]);
+            if (tracking_allocations && k < response.stage_allocations_.size())
+            {
+              planner_data[j]["stage_" + stage + "_allocations INTEGER"] =
+                  std::to_string(response.stage_allocations_[k].count);
+              planner_data[j]["stage_" + stage + "_allocated_bytes INTEGER"] =
+                  std::to_string(response.stage_allocations_[k].bytes);
+            }
+          }
+          planner_data[j]["scene_memory_bytes INTEGER"] = std::to_string(scene->getMemoryUsage());
+          planner_data[j]["robot_model_memory_bytes INTEGER"] =
+              std::to_string(scene->getRobotModel()->getMemoryUsage());
         }
         std::chrono::duration<double> dt = std::chrono::system_clock::now() - start;
         double total_time = dt.count();
@@ -847,15 +921,53 @@ void BenchmarkExecutor::runBenchmark(moveit_msgs::msg::MotionPlanRequest request
         // Collect data
         start = std::chrono::system_clock::now();
 
-        // Post-run events
-        for (PostRunEventFunction& post_event_fn : post_event_fns_)
-          post_event_fn(request, responses[j], planner_data[j]);
-        collectMetrics(planner_data[j], responses[j], solved[j], total_time);
+        {
+          // Post-run events
+          std::scoped_lock lock(run_events_mutex);
+          solved[j] = run_solved;
+          for (PostRunEventFunction& post_event_fn : post_event_fns_)
+            post_event_fn(run_request, responses[j], planner_data[j]);
+        }
+        collectMetrics(planner_data[j], responses[j], run_solved, total_time);
         dt = std::chrono::system_clock::now() - start;
         double metrics_time = dt.count();
         RCLCPP_DEBUG(LOGGER, "Spent %lf seconds collecting metrics", metrics_time);
 
+        std::scoped_lock lock(run_events_mutex);
+        if (database_ && database_experiment_id_ >= 0 && database_planner_id >= 0)
+          database_->addRun(database_experiment_id_, database_planner_id, planner_data[j]);
         ++progress;
+      };
+
+      const int num_workers = std::min(std::max(options_.getNumWorkers(), 1), std::max(runs, 1));
+      if (num_workers == 1)
+      {
+        planning_interface::PlanningContextPtr planning_context;
+        if (use_planning_context)
+          planning_context = planning_pipeline->getPlannerManager()->getPlanningContext(planning_scene_, request);
+
+        // Iterate runs
+        for (int j = 0; j < runs; ++j)
+          execute_run(j, request, planning_scene_, planning_context);
+      }
+      else
+      {
+        // Every worker plans on its own scene clone with its own planning context, taking the next run index
+        std::atomic<int> next_run(0);
+        std::vector<std::thread> workers;
+        for (int w = 0; w < num_workers; ++w)
+        {
+          workers.emplace_back([&, worker_request = request]() mutable {
+            planning_scene::PlanningScenePtr scene = planning_scene::PlanningScene::clone(planning_scene_);
+            planning_interface::PlanningContextPtr planning_context;
+            if (use_planning_context)
+              planning_context = planning_pipeline->getPlannerManager()->getPlanningContext(scene, worker_request);
+            for (int j = next_run++; j < runs; j = next_run++)
+              execute_run(j, worker_request, scene, planning_context);
+          });
+        }
+        for (std::thread& worker : workers)
+          worker.join();
       }
 
       computeAveragePathSimilarities(planner_data, responses, solved);
@@ -1135,8 +1247,8 @@ void BenchmarkExecutor::writeOutput(const BenchmarkRequest& brequest, const std:
 
   // Not writing optional cpu information
 
-  // The real random seed is unknown.  Writing a fake value
-  out << "0 is the random seed" << '\n';
+  // Without a configured seed the real random seed is unknown, writing 0 then
+  out << options_.getSeed() << " is the random seed" << '\n';
   out << brequest.request.allowed_planning_time << " seconds per run" << '\n';
   // There is no memory cap
   out << "-1 MB per run" << '\n';
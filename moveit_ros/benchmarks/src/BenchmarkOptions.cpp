@@ -35,6 +35,7 @@
 /* Author: Ryan Luna */
 
 #include <moveit/benchmarks/BenchmarkOptions.h>
+#include <algorithm>
 
 using namespace moveit_ros_benchmarks;
 
@@ -95,6 +96,16 @@ double BenchmarkOptions::getTimeout() const
   return timeout_;
 }
 
+int BenchmarkOptions::getNumWorkers() const
+{
+  return num_workers_;
+}
+
+unsigned int BenchmarkOptions::getSeed() const
+{
+  return static_cast<unsigned int>(std::max(seed_, 0));
+}
+
 const std::string& BenchmarkOptions::getBenchmarkName() const
 {
   return benchmark_name_;
@@ -110,6 +121,11 @@ const std::string& BenchmarkOptions::getOutputDirectory() const
   return output_directory_;
 }
 
+const std::string& BenchmarkOptions::getOutputDatabase() const
+{
+  return output_database_;
+}
+
 const std::string& BenchmarkOptions::getQueryRegex() const
 {
   return query_regex_;
@@ -191,8 +207,12 @@ void BenchmarkOptions::readBenchmarkParameters(const rclcpp::Node::SharedPtr& no
   node->get_parameter_or(std::string("benchmark_config.parameters.name"), benchmark_name_, std::string(""));
   node->get_parameter_or(std::string("benchmark_config.parameters.runs"), runs_, 10);
   node->get_parameter_or(std::string("benchmark_config.parameters.timeout"), timeout_, 10.0);
+  node->get_parameter_or(std::string("benchmark_config.parameters.num_workers"), num_workers_, 1);
+  node->get_parameter_or(std::string("benchmark_config.parameters.seed"), seed_, 0);
   node->get_parameter_or(std::string("benchmark_config.parameters.output_directory"), output_directory_,
                          std::string(""));
+  node->get_parameter_or(std::string("benchmark_config.parameters.output_database"), output_database_,
+                         std::string(""));
   node->get_parameter_or(std::string("benchmark_config.parameters.queries"), query_regex_, std::string(".*"));
   node->get_parameter_or(std::string("benchmark_config.parameters.start_states"), start_state_regex_, std::string(""));
   node->get_parameter_or(std::string("benchmark_config.parameters.goal_constraints"), goal_constraint_regex_,
@@ -222,6 +242,16 @@ void BenchmarkOptions::readBenchmarkParameters(const rclcpp::Node::SharedPtr& no
   RCLCPP_INFO(LOGGER, "Benchmark name: '%s'", benchmark_name_.c_str());
   RCLCPP_INFO(LOGGER, "Benchmark #runs: %d", runs_);
   RCLCPP_INFO(LOGGER, "Benchmark timeout: %f secs", timeout_);
+  RCLCPP_INFO(LOGGER, "Benchmark #workers: %d", num_workers_);
+  if (seed_ > 0)
+  {
+    RCLCPP_INFO(LOGGER, "Benchmark seed: %d", seed_);
+    if (num_workers_ > 1)
+    {
+      RCLCPP_WARN(LOGGER, "Seeded benchmarks are only reproducible when run sequentially, using a single worker");
+      num_workers_ = 1;
+    }
+  }
   RCLCPP_INFO(LOGGER, "Benchmark group: %s", group_name_.c_str());
   RCLCPP_INFO(LOGGER, "Benchmark query regex: '%s'", query_regex_.c_str());
   RCLCPP_INFO(LOGGER, "Benchmark start state regex: '%s':", start_state_regex_.c_str());
@@ -230,6 +260,8 @@ void BenchmarkOptions::readBenchmarkParameters(const rclcpp::Node::SharedPtr& no
   RCLCPP_INFO(LOGGER, "Benchmark goal offsets (%f %f %f, %f %f %f)", goal_offsets[0], goal_offsets[1], goal_offsets[2],
               goal_offsets[3], goal_offsets[4], goal_offsets[5]);
   RCLCPP_INFO(LOGGER, "Benchmark output directory: %s", output_directory_.c_str());
+  if (!output_database_.empty())
+    RCLCPP_INFO(LOGGER, "Benchmark output database: %s", output_database_.c_str());
   RCLCPP_INFO_STREAM(LOGGER, "Benchmark workspace: min_corner: ["
                                  << workspace_.min_corner.x << ", " << workspace_.min_corner.y << ", "
                                  << workspace_.min_corner.z << "], "
@@ -0,0 +1,392 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Description: Checks sampled robot states in a corpus of planning scenes with every collision detector, comparing
+ * their results for agreement and their speed. The runs are written to a benchmark database. */
+
+#include <moveit/benchmarks/BenchmarkDatabaseWriter.h>
+#include <moveit/collision_detection/collision_plugin.h>
+#include <moveit/collision_detection/collision_plugin_cache.h>
+#include <moveit/collision_distance_field/collision_detector_allocator_distance_field.h>
+#include <moveit/collision_distance_field/collision_detector_allocator_hybrid.h>
+#include <moveit/planning_scene/planning_scene.h>
+#include <moveit/robot_model_loader/robot_model_loader.h>
+#include <moveit/utils/random_seed.h>
+#include <moveit/version.h>
+#include <moveit/warehouse/planning_scene_storage.h>
+#include <pluginlib/class_loader.hpp>
+#include <rclcpp/rclcpp.hpp>
+#include <warehouse_ros/database_loader.h>
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <sstream>
+#ifndef _WIN32
+#include <unistd.h>
+#else
+#include <winsock2.h>
+#endif
+
+static const rclcpp::Logger LOGGER = rclcpp::get_logger("moveit.ros.benchmarks.collision_backend_benchmark");
+
+namespace moveit_ros_benchmarks
+{
+namespace
+{
+struct Scene
+{
+  std::string name;
+  moveit_msgs::msg::PlanningScene msg;
+  std::string geometry;  // the contents of a .scene file, used instead of msg if set
+};
+
+struct BackendResult
+{
+  std::vector<bool> collisions;
+  std::vector<double> times;  // per check in seconds
+};
+}  // namespace
+
+class CollisionBackendBenchmark
+{
+public:
+  CollisionBackendBenchmark(const rclcpp::Node::SharedPtr& node) : node_(node)
+  {
+  }
+
+  bool initialize()
+  {
+    robot_model_loader::RobotModelLoader loader(node_, "robot_description");
+    robot_model_ = loader.getModel();
+    if (!robot_model_)
+    {
+      RCLCPP_ERROR(LOGGER, "Failed to load the robot model");
+      return false;
+    }
+
+    node_->get_parameter_or(std::string("collision_benchmark.states"), num_states_, 1000);
+    node_->get_parameter_or(std::string("collision_benchmark.repeats"), repeats_, 10);
+    node_->get_parameter_or(std::string("collision_benchmark.group"), group_name_, std::string(""));
+    node_->get_parameter_or(std::string("collision_benchmark.output_database"), output_database_,
+                            std::string("/tmp/moveit_collision_benchmark.db"));
+    if (!group_name_.empty() && !robot_model_->hasJointModelGroup(group_name_))
+    {
+      RCLCPP_ERROR(LOGGER, "Robot model has no joint model group named '%s'", group_name_.c_str());
+      return false;
+    }
+
+    // the collision plugins, and the distance field detectors that have no plugin
+    using collision_detection::CollisionDetectorAllocatorDistanceField;
+    using collision_detection::CollisionDetectorAllocatorHybrid;
+    backends_[CollisionDetectorAllocatorDistanceField::NAME] = [](const planning_scene::PlanningScenePtr& scene) {
+      scene->allocateCollisionDetector(CollisionDetectorAllocatorDistanceField::create());
+      return true;
+    };
+    backends_[CollisionDetectorAllocatorHybrid::NAME] = [](const planning_scene::PlanningScenePtr& scene) {
+      scene->allocateCollisionDetector(CollisionDetectorAllocatorHybrid::create());
+      return true;
+    };
+    try
+    {
+      pluginlib::ClassLoader<collision_detection::CollisionPlugin> plugin_loader(
+          "moveit_core", "collision_detection::CollisionPlugin");
+      for (const std::string& plugin : plugin_loader.getDeclaredClasses())
+        backends_[plugin] = [this, plugin](const planning_scene::PlanningScenePtr& scene) {
+          return plugin_cache_.activate(plugin, scene);
+        };
+    }
+    catch (pluginlib::PluginlibException& ex)
+    {
+      RCLCPP_ERROR(LOGGER, "Failed to list the collision plugins: %s", ex.what());
+    }
+
+    std::vector<std::string> backends;
+    node_->get_parameter_or(std::string("collision_benchmark.backends"), backends, {});
+    if (backends.empty())
+    {
+      // compare against FCL, the default of MoveIt, if it is there
+      if (backends_.count("FCL"))
+        backend_order_.push_back("FCL");
+      for (const auto& backend : backends_)
+        if (backend.first != "FCL")
+          backend_order_.push_back(backend.first);
+    }
+    else
+    {
+      for (const std::string& backend : backends)
+      {
+        if (backends_.count(backend))
+          backend_order_.push_back(backend);
+        else
+          RCLCPP_ERROR(LOGGER, "Unknown collision detector '%s'", backend.c_str());
+      }
+    }
+    if (backend_order_.empty())
+    {
+      RCLCPP_ERROR(LOGGER, "No collision detectors to compare");
+      return false;
+    }
+    return loadScenes();
+  }
+
+  void run()
+  {
+    BenchmarkDatabaseWriter database(output_database_);
+    if (!database.isValid())
+      return;
+    std::map<std::string, std::int64_t> planner_ids;
+    for (const std::string& backend : backend_order_)
+      planner_ids[backend] = database.getPlannerId(backend);
+
+    char hostname[256] = "UNKNOWN";
+    gethostname(hostname, sizeof(hostname) - 1);
+    hostname[sizeof(hostname) - 1] = '\0';
+
+    for (const Scene& scene_data : scenes_)
+    {
+      auto scene = std::make_shared<planning_scene::PlanningScene>(robot_model_);
+      if (!scene_data.geometry.empty())
+      {
+        std::istringstream geometry(scene_data.geometry);
+        scene->loadGeometryFromStream(geometry);
+      }
+      else if (scene_data.msg.robot_model_name == robot_model_->getName())
+        scene->usePlanningSceneMsg(scene_data.msg);
+      else
+        scene->processPlanningSceneWorldMsg(scene_data.msg.world);
+
+      const std::vector<moveit::core::RobotState> states = sampleStates(*scene);
+      RCLCPP_INFO(LOGGER, "Scene '%s': %zu objects, checking %zu states %d times with %zu collision detectors",
+                  scene_data.name.c_str(), scene->getWorld()->size(), states.size(), repeats_, backend_order_.size());
+
+      std::ostringstream setup;
+      setup << "Planning scene:" << '\n'
+            << "  scene_name: " << scene_data.name << '\n'
+            << "  robot_model_name: " << robot_model_->getName() << '\n'
+            << "  objects: " << scene->getWorld()->size() << '\n'
+            << "  group: " << (group_name_.empty() ? "all" : group_name_) << '\n'
+            << "  repeats: " << repeats_ << '\n';
+      const auto start_time = std::chrono::system_clock::now();
+      const std::int64_t experiment_id = database.addExperiment(
+          scene_data.name, 0.0, states.size(), std::string("MoveIt ") + MOVEIT_VERSION_STR, hostname,
+          boost::posix_time::to_iso_extended_string(boost::posix_time::from_time_t(
+              std::chrono::system_clock::to_time_t(start_time))),
+          setup.str(), moveit::core::getRandomSeed().value_or(0));
+
+      std::vector<bool> reference;
+      for (const std::string& backend : backend_order_)
+      {
+        if (!backends_[backend](scene))
+        {
+          RCLCPP_ERROR(LOGGER, "Failed to activate the collision detector '%s'", backend.c_str());
+          continue;
+        }
+        const BackendResult result = check(*scene, states);
+        // the first collision detector is the reference of all others
+        if (reference.empty())
+          reference = result.collisions;
+
+        std::size_t disagreements = 0;
+        double total_time = 0.0;
+        for (std::size_t i = 0; i < states.size(); ++i)
+        {
+          const bool agrees = result.collisions[i] == reference[i];
+          disagreements += agrees ? 0 : 1;
+          total_time += result.times[i];
+          database.addRun(experiment_id, planner_ids[backend],
+                          { { "time REAL", std::to_string(result.times[i]) },
+                            { "collision BOOLEAN", result.collisions[i] ? "true" : "false" },
+                            { "agrees BOOLEAN", agrees ? "true" : "false" },
+                            { "solved BOOLEAN", "true" },
+                            { "state INTEGER", std::to_string(i) } });
+        }
+        RCLCPP_INFO(LOGGER, "  %-16s %10.1f checks/s, %zu of %zu states in collision, %zu disagreements with %s",
+                    backend.c_str(), total_time > 0.0 ? states.size() / total_time : 0.0,
+                    static_cast<std::size_t>(std::count(result.collisions.begin(), result.collisions.end(), true)),
+                    states.size(), disagreements, backend_order_.front().c_str());
+      }
+      database.finishExperiment(
+          experiment_id, std::chrono::duration<double>(std::chrono::system_clock::now() - start_time).count());
+    }
+    RCLCPP_INFO(LOGGER, "Results written to '%s'", output_database_.c_str());
+  }
+
+private:
+  /// Load the scene files and the warehouse scenes matching the configured regex
+  bool loadScenes()
+  {
+    std::vector<std::string> scene_files;
+    node_->get_parameter_or(std::string("collision_benchmark.scene_files"), scene_files, {});
+    for (const std::string& file : scene_files)
+    {
+      std::ifstream in(file);
+      if (!in)
+      {
+        RCLCPP_ERROR(LOGGER, "Failed to open scene file '%s'", file.c_str());
+        continue;
+      }
+      Scene scene;
+      scene.name = file;
+      scene.geometry.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+      scenes_.push_back(scene);
+    }
+
+    std::string regex;
+    node_->get_parameter_or(std::string("collision_benchmark.warehouse.scenes"), regex, std::string(""));
+    if (!regex.empty())
+    {
+      std::string host;
+      int port;
+      node_->get_parameter_or(std::string("collision_benchmark.warehouse.host"), host, std::string("127.0.0.1"));
+      node_->get_parameter_or(std::string("collision_benchmark.warehouse.port"), port, 33829);
+      try
+      {
+        warehouse_ros::DatabaseLoader dbloader(node_);
+        warehouse_ros::DatabaseConnection::Ptr connection = dbloader.loadDatabase();
+        connection->setParams(host, port, 20);
+        if (!connection->connect())
+        {
+          RCLCPP_ERROR(LOGGER, "Failed to connect to the warehouse at %s:%d", host.c_str(), port);
+          return false;
+        }
+        moveit_warehouse::PlanningSceneStorage storage(connection);
+        std::vector<std::string> names;
+        storage.getPlanningSceneNames(regex, names);
+        for (const std::string& name : names)
+        {
+          moveit_warehouse::PlanningSceneWithMetadata scene_m;
+          if (!storage.getPlanningScene(scene_m, name))
+            continue;
+          Scene scene;
+          scene.name = name;
+          scene.msg = static_cast<moveit_msgs::msg::PlanningScene>(*scene_m);
+          scenes_.push_back(scene);
+        }
+      }
+      catch (std::exception& ex)
+      {
+        RCLCPP_ERROR(LOGGER, "Failed to load scenes from the warehouse: %s", ex.what());
+        return false;
+      }
+    }
+
+    if (scenes_.empty())
+    {
+      // without a corpus, the robot alone still compares the self collision checks
+      RCLCPP_WARN(LOGGER, "No scenes configured, checking the robot in an empty world");
+      scenes_.emplace_back();
+      scenes_.back().name = "empty";
+    }
+    return true;
+  }
+
+  /// Random states of the group, or of the whole robot, starting from the current state of \e scene
+  std::vector<moveit::core::RobotState> sampleStates(const planning_scene::PlanningScene& scene) const
+  {
+    random_numbers::RandomNumberGenerator rng = moveit::core::makeRandomNumberGenerator();
+    std::vector<moveit::core::RobotState> states(num_states_, scene.getCurrentState());
+    for (moveit::core::RobotState& state : states)
+    {
+      if (group_name_.empty())
+        state.setToRandomPositions();
+      else
+        state.setToRandomPositions(robot_model_->getJointModelGroup(group_name_), rng);
+      state.update();
+    }
+    return states;
+  }
+
+  BackendResult check(const planning_scene::PlanningScene& scene,
+                      const std::vector<moveit::core::RobotState>& states) const
+  {
+    BackendResult result;
+    collision_detection::CollisionRequest request;
+    collision_detection::CollisionResult response;
+    for (const moveit::core::RobotState& state : states)
+    {
+      const auto start = std::chrono::steady_clock::now();
+      for (int i = 0; i < repeats_; ++i)
+      {
+        response.clear();
+        scene.checkCollision(request, response, state);
+      }
+      result.times.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() /
+                             std::max(repeats_, 1));
+      result.collisions.push_back(response.collision);
+    }
+    return result;
+  }
+
+  rclcpp::Node::SharedPtr node_;
+  moveit::core::RobotModelConstPtr robot_model_;
+  collision_detection::CollisionPluginCache plugin_cache_;
+  std::map<std::string, std::function<bool(const planning_scene::PlanningScenePtr&)>> backends_;
+  std::vector<std::string> backend_order_;
+  std::vector<Scene> scenes_;
+
+  int num_states_;
+  int repeats_;
+  std::string group_name_;
+  std::string output_database_;
+};
+}  // namespace moveit_ros_benchmarks
+
+int main(int argc, char** argv)
+{
+  rclcpp::init(argc, argv);
+  rclcpp::NodeOptions node_options;
+  node_options.allow_undeclared_parameters(true);
+  node_options.automatically_declare_parameters_from_overrides(true);
+  rclcpp::Node::SharedPtr node = rclcpp::Node::make_shared("moveit_collision_backend_benchmark", node_options);
+
+  // Seeding samples the same states every time
+  int seed;
+  node->get_parameter_or(std::string("collision_benchmark.seed"), seed, 0);
+  if (seed > 0)
+    moveit::core::setRandomSeed(seed);
+
+  moveit_ros_benchmarks::CollisionBackendBenchmark benchmark(node);
+  if (!benchmark.initialize())
+  {
+    rclcpp::shutdown();
+    return 1;
+  }
+  benchmark.run();
+  rclcpp::shutdown();
+  return 0;
+}
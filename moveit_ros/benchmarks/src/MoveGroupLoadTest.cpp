@@ -0,0 +1,456 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Description: Drives the planning, cartesian path, IK and state validity capabilities of a running move_group from
+ * concurrent clients at fixed rates, with planning scene updates in the background, and reports the throughput and
+ * latency percentiles of every capability */
+
+#include <moveit/robot_model_loader/robot_model_loader.h>
+#include <moveit/robot_state/conversions.h>
+#include <moveit/robot_state/robot_state.h>
+#include <moveit/kinematic_constraints/utils.h>
+#include <moveit_msgs/action/move_group.hpp>
+#include <moveit_msgs/msg/planning_scene.hpp>
+#include <moveit_msgs/srv/get_cartesian_path.hpp>
+#include <moveit_msgs/srv/get_position_ik.hpp>
+#include <moveit_msgs/srv/get_state_validity.hpp>
+#include <rclcpp/rclcpp.hpp>
+#include <rclcpp_action/rclcpp_action.hpp>
+#if __has_include(<tf2_eigen/tf2_eigen.hpp>)
+#include <tf2_eigen/tf2_eigen.hpp>
+#else
+#include <tf2_eigen/tf2_eigen.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+static const rclcpp::Logger LOGGER = rclcpp::get_logger("moveit.ros.benchmarks.move_group_load_test");
+
+namespace moveit_ros_benchmarks
+{
+namespace
+{
+// the names of moveit/move_group/capability_names.h
+const std::string MOVE_ACTION = "move_action";
+const std::string CARTESIAN_PATH_SERVICE_NAME = "compute_cartesian_path";
+const std::string IK_SERVICE_NAME = "compute_ik";
+const std::string STATE_VALIDITY_SERVICE_NAME = "check_state_validity";
+
+enum class Outcome
+{
+  SUCCEEDED,
+  FAILED,
+  TIMED_OUT
+};
+
+/// The outcomes of the requests to one capability, from all clients
+struct CapabilityStats
+{
+  std::string name;
+  double rate = 0.0;  // requests per second and client, 0 disables the capability
+  std::mutex mutex;
+  std::vector<double> latencies;  // of all answered requests, in seconds
+  std::size_t succeeded = 0;
+  std::size_t failed = 0;
+  std::size_t timed_out = 0;
+
+  void add(Outcome outcome, double latency)
+  {
+    std::scoped_lock lock(mutex);
+    if (outcome == Outcome::TIMED_OUT)
+    {
+      ++timed_out;
+      return;
+    }
+    latencies.push_back(latency);
+    ++(outcome == Outcome::SUCCEEDED ? succeeded : failed);
+  }
+};
+
+// nearest-rank percentile of sorted values
+double percentile(const std::vector<double>& sorted, double p)
+{
+  if (sorted.empty())
+    return 0.0;
+  const std::size_t rank = static_cast<std::size_t>(std::ceil(p / 100.0 * sorted.size()));
+  return sorted[std::min(std::max<std::size_t>(rank, 1), sorted.size()) - 1];
+}
+}  // namespace
+
+class MoveGroupLoadTest
+{
+public:
+  MoveGroupLoadTest(const rclcpp::Node::SharedPtr& node) : node_(node)
+  {
+    node_->get_parameter_or(std::string("load_test.clients"), clients_, 4);
+    node_->get_parameter_or(std::string("load_test.duration"), duration_, 30.0);
+    node_->get_parameter_or(std::string("load_test.timeout"), timeout_, 10.0);
+    node_->get_parameter_or(std::string("load_test.planning_time"), planning_time_, 1.0);
+    node_->get_parameter_or(std::string("load_test.group"), group_name_, std::string(""));
+    node_->get_parameter_or(std::string("load_test.tip_link"), tip_link_, std::string(""));
+    node_->get_parameter_or(std::string("load_test.scene_update_rate"), scene_update_rate_, 10.0);
+    node_->get_parameter_or(std::string("load_test.output_file"), output_file_, std::string(""));
+
+    plan_.name = "plan";
+    cartesian_path_.name = "cartesian_path";
+    ik_.name = "ik";
+    state_validity_.name = "state_validity";
+    node_->get_parameter_or(std::string("load_test.rates.plan"), plan_.rate, 1.0);
+    node_->get_parameter_or(std::string("load_test.rates.cartesian_path"), cartesian_path_.rate, 1.0);
+    node_->get_parameter_or(std::string("load_test.rates.ik"), ik_.rate, 10.0);
+    node_->get_parameter_or(std::string("load_test.rates.state_validity"), state_validity_.rate, 10.0);
+  }
+
+  bool initialize()
+  {
+    robot_model_loader::RobotModelLoader loader(node_, "robot_description");
+    robot_model_ = loader.getModel();
+    if (!robot_model_)
+    {
+      RCLCPP_ERROR(LOGGER, "Failed to load the robot model");
+      return false;
+    }
+    joint_model_group_ = robot_model_->getJointModelGroup(group_name_);
+    if (!joint_model_group_)
+    {
+      RCLCPP_ERROR(LOGGER, "Robot model has no joint model group named '%s', set load_test.group",
+                   group_name_.c_str());
+      return false;
+    }
+    if (tip_link_.empty())
+      tip_link_ = joint_model_group_->getLinkModelNames().back();
+    if (!robot_model_->hasLinkModel(tip_link_))
+    {
+      RCLCPP_ERROR(LOGGER, "Robot model has no link named '%s'", tip_link_.c_str());
+      return false;
+    }
+    return true;
+  }
+
+  void run()
+  {
+    // Every client has a node of its own, all of them are spun by one executor
+    rclcpp::executors::MultiThreadedExecutor executor;
+    std::vector<rclcpp::Node::SharedPtr> client_nodes;
+    for (int i = 0; i < clients_; ++i)
+    {
+      client_nodes.push_back(rclcpp::Node::make_shared("load_test_client_" + std::to_string(i)));
+      executor.add_node(client_nodes.back());
+    }
+    std::thread spinner([&executor] { executor.spin(); });
+
+    RCLCPP_INFO(LOGGER, "Running %d clients for %f seconds", clients_, duration_);
+    stop_ = false;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < clients_; ++i)
+    {
+      const rclcpp::Node::SharedPtr& client_node = client_nodes[i];
+      if (plan_.rate > 0.0)
+      {
+        auto client = rclcpp_action::create_client<moveit_msgs::action::MoveGroup>(client_node, MOVE_ACTION);
+        if (waitFor(plan_, client->wait_for_action_server(std::chrono::seconds(10))))
+          threads.emplace_back([this, client] {
+            drive(plan_, [&](moveit::core::RobotState& state) { return plan(*client, state); });
+          });
+      }
+      if (cartesian_path_.rate > 0.0)
+      {
+        auto client = client_node->create_client<moveit_msgs::srv::GetCartesianPath>(CARTESIAN_PATH_SERVICE_NAME);
+        if (waitFor(cartesian_path_, client->wait_for_service(std::chrono::seconds(10))))
+          threads.emplace_back([this, client] {
+            drive(cartesian_path_, [&](moveit::core::RobotState& state) { return cartesianPath(*client, state); });
+          });
+      }
+      if (ik_.rate > 0.0)
+      {
+        auto client = client_node->create_client<moveit_msgs::srv::GetPositionIK>(IK_SERVICE_NAME);
+        if (waitFor(ik_, client->wait_for_service(std::chrono::seconds(10))))
+          threads.emplace_back(
+              [this, client] { drive(ik_, [&](moveit::core::RobotState& state) { return ik(*client, state); }); });
+      }
+      if (state_validity_.rate > 0.0)
+      {
+        auto client = client_node->create_client<moveit_msgs::srv::GetStateValidity>(STATE_VALIDITY_SERVICE_NAME);
+        if (waitFor(state_validity_, client->wait_for_service(std::chrono::seconds(10))))
+          threads.emplace_back([this, client] {
+            drive(state_validity_, [&](moveit::core::RobotState& state) { return stateValidity(*client, state); });
+          });
+      }
+    }
+    if (scene_update_rate_ > 0.0)
+      threads.emplace_back([this] { publishSceneUpdates(); });
+
+    const auto start = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(std::chrono::duration<double>(duration_));
+    stop_ = true;
+    for (std::thread& thread : threads)
+      thread.join();
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    executor.cancel();
+    spinner.join();
+    report(elapsed);
+  }
+
+private:
+  bool waitFor(const CapabilityStats& capability, bool available) const
+  {
+    if (!available)
+      RCLCPP_ERROR(LOGGER, "The %s capability is not available, not testing it", capability.name.c_str());
+    return available;
+  }
+
+  /// Send requests at the rate of \e capability until the test is stopped, a request is sent immediately if the
+  /// previous one took longer than the period
+  void drive(CapabilityStats& capability, const std::function<Outcome(moveit::core::RobotState&)>& send)
+  {
+    moveit::core::RobotState state(robot_model_);
+    state.setToDefaultValues();
+    const auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(1.0 / capability.rate));
+    auto next = std::chrono::steady_clock::now();
+    while (!stop_)
+    {
+      state.setToRandomPositions(joint_model_group_);
+      state.update();
+      const auto start = std::chrono::steady_clock::now();
+      const Outcome outcome = send(state);
+      const auto end = std::chrono::steady_clock::now();
+      capability.add(outcome, std::chrono::duration<double>(end - start).count());
+
+      next = std::max(next + period, end);
+      std::this_thread::sleep_until(next);
+    }
+  }
+
+  Outcome plan(rclcpp_action::Client<moveit_msgs::action::MoveGroup>& client, const moveit::core::RobotState& goal)
+  {
+    moveit_msgs::action::MoveGroup::Goal request;
+    request.request.group_name = group_name_;
+    request.request.num_planning_attempts = 1;
+    request.request.allowed_planning_time = planning_time_;
+    request.request.goal_constraints.push_back(
+        kinematic_constraints::constructGoalConstraints(goal, joint_model_group_));
+    request.planning_options.plan_only = true;
+    request.planning_options.planning_scene_diff.is_diff = true;
+    request.planning_options.planning_scene_diff.robot_state.is_diff = true;
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(timeout_);
+    auto goal_handle_future = client.async_send_goal(request);
+    if (goal_handle_future.wait_until(deadline) != std::future_status::ready)
+      return Outcome::TIMED_OUT;
+    auto goal_handle = goal_handle_future.get();
+    if (!goal_handle)
+      return Outcome::FAILED;
+    auto result_future = client.async_get_result(goal_handle);
+    if (result_future.wait_until(deadline) != std::future_status::ready)
+    {
+      client.async_cancel_goal(goal_handle);
+      return Outcome::TIMED_OUT;
+    }
+    const auto result = result_future.get();
+    return result.code == rclcpp_action::ResultCode::SUCCEEDED &&
+                   result.result->error_code.val == moveit_msgs::msg::MoveItErrorCodes::SUCCESS ?
+               Outcome::SUCCEEDED :
+               Outcome::FAILED;
+  }
+
+  template <typename ServiceT>
+  Outcome call(rclcpp::Client<ServiceT>& client, const std::shared_ptr<typename ServiceT::Request>& request,
+               const std::function<bool(const typename ServiceT::Response&)>& succeeded)
+  {
+    auto future = client.async_send_request(request);
+    if (future.wait_for(std::chrono::duration<double>(timeout_)) != std::future_status::ready)
+      return Outcome::TIMED_OUT;
+    return succeeded(*future.get()) ? Outcome::SUCCEEDED : Outcome::FAILED;
+  }
+
+  Outcome cartesianPath(rclcpp::Client<moveit_msgs::srv::GetCartesianPath>& client,
+                        const moveit::core::RobotState& start)
+  {
+    // move the tip 5cm up from a random start state
+    auto request = std::make_shared<moveit_msgs::srv::GetCartesianPath::Request>();
+    moveit::core::robotStateToRobotStateMsg(start, request->start_state);
+    request->header.frame_id = robot_model_->getModelFrame();
+    request->group_name = group_name_;
+    request->link_name = tip_link_;
+    Eigen::Isometry3d target = start.getGlobalLinkTransform(tip_link_);
+    target.translation().z() += 0.05;
+    request->waypoints.push_back(tf2::toMsg(target));
+    request->max_step = 0.01;
+    request->avoid_collisions = true;
+    return call<moveit_msgs::srv::GetCartesianPath>(client, request, [](const auto& response) {
+      return response.error_code.val == moveit_msgs::msg::MoveItErrorCodes::SUCCESS;
+    });
+  }
+
+  Outcome ik(rclcpp::Client<moveit_msgs::srv::GetPositionIK>& client, const moveit::core::RobotState& state)
+  {
+    // solve for the tip pose of a random state, so a solution exists
+    auto request = std::make_shared<moveit_msgs::srv::GetPositionIK::Request>();
+    request->ik_request.group_name = group_name_;
+    request->ik_request.ik_link_name = tip_link_;
+    request->ik_request.pose_stamped.header.frame_id = robot_model_->getModelFrame();
+    request->ik_request.pose_stamped.pose = tf2::toMsg(state.getGlobalLinkTransform(tip_link_));
+    request->ik_request.robot_state.is_diff = true;
+    request->ik_request.timeout = rclcpp::Duration::from_seconds(0.1);
+    return call<moveit_msgs::srv::GetPositionIK>(client, request, [](const auto& response) {
+      return response.error_code.val == moveit_msgs::msg::MoveItErrorCodes::SUCCESS;
+    });
+  }
+
+  Outcome stateValidity(rclcpp::Client<moveit_msgs::srv::GetStateValidity>& client,
+                        const moveit::core::RobotState& state)
+  {
+    // an answer is a success, whether the state is valid or not
+    auto request = std::make_shared<moveit_msgs::srv::GetStateValidity::Request>();
+    request->group_name = group_name_;
+    moveit::core::robotStateToRobotStateMsg(state, request->robot_state);
+    return call<moveit_msgs::srv::GetStateValidity>(client, request, [](const auto&) { return true; });
+  }
+
+  /// Move a box around the robot, far enough not to affect the requests, to keep move_group busy with scene updates
+  void publishSceneUpdates()
+  {
+    auto publisher = node_->create_publisher<moveit_msgs::msg::PlanningScene>("planning_scene", 100);
+    moveit_msgs::msg::PlanningScene scene;
+    scene.is_diff = true;
+    scene.robot_state.is_diff = true;
+    scene.world.collision_objects.resize(1);
+    moveit_msgs::msg::CollisionObject& object = scene.world.collision_objects[0];
+    object.header.frame_id = robot_model_->getModelFrame();
+    object.id = "load_test_obstacle";
+    object.primitives.resize(1);
+    object.primitives[0].type = shape_msgs::msg::SolidPrimitive::BOX;
+    object.primitives[0].dimensions = { 0.1, 0.1, 0.1 };
+    object.primitive_poses.resize(1);
+    object.primitive_poses[0].orientation.w = 1.0;
+
+    const auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(1.0 / scene_update_rate_));
+    auto next = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; !stop_; ++i)
+    {
+      object.operation = i == 0 ? moveit_msgs::msg::CollisionObject::ADD : moveit_msgs::msg::CollisionObject::MOVE;
+      object.primitive_poses[0].position.x = 5.0 * std::cos(0.1 * i);
+      object.primitive_poses[0].position.y = 5.0 * std::sin(0.1 * i);
+      publisher->publish(scene);
+      next += period;
+      std::this_thread::sleep_until(next);
+    }
+    object.operation = moveit_msgs::msg::CollisionObject::REMOVE;
+    publisher->publish(scene);
+  }
+
+  void report(double elapsed)
+  {
+    std::ofstream csv;
+    if (!output_file_.empty())
+    {
+      csv.open(output_file_);
+      if (csv)
+        csv << "capability,clients,rate,requests,succeeded,failed,timed_out,throughput,p50,p90,p99,max\n";
+      else
+        RCLCPP_ERROR(LOGGER, "Failed to open '%s' for the load test results", output_file_.c_str());
+    }
+
+    for (CapabilityStats* capability : { &plan_, &cartesian_path_, &ik_, &state_validity_ })
+    {
+      if (capability->rate <= 0.0)
+        continue;
+      std::sort(capability->latencies.begin(), capability->latencies.end());
+      const std::vector<double>& latencies = capability->latencies;
+      const std::size_t requests = latencies.size() + capability->timed_out;
+      const double throughput = latencies.size() / elapsed;
+      const double max = latencies.empty() ? 0.0 : latencies.back();
+      RCLCPP_INFO(LOGGER,
+                  "%s: %zu requests, %zu succeeded, %zu failed, %zu timed out, %.2f answers/s, latency p50 %.4fs "
+                  "p90 %.4fs p99 %.4fs max %.4fs",
+                  capability->name.c_str(), requests, capability->succeeded, capability->failed,
+                  capability->timed_out, throughput, percentile(latencies, 50), percentile(latencies, 90),
+                  percentile(latencies, 99), max);
+      if (csv)
+        csv << capability->name << ',' << clients_ << ',' << capability->rate << ',' << requests << ','
+            << capability->succeeded << ',' << capability->failed << ',' << capability->timed_out << ',' << throughput
+            << ',' << percentile(latencies, 50) << ',' << percentile(latencies, 90) << ','
+            << percentile(latencies, 99) << ',' << max << '\n';
+    }
+  }
+
+  rclcpp::Node::SharedPtr node_;
+  moveit::core::RobotModelConstPtr robot_model_;
+  const moveit::core::JointModelGroup* joint_model_group_ = nullptr;
+
+  int clients_;
+  double duration_;
+  double timeout_;
+  double planning_time_;
+  std::string group_name_;
+  std::string tip_link_;
+  double scene_update_rate_;
+  std::string output_file_;
+
+  CapabilityStats plan_;
+  CapabilityStats cartesian_path_;
+  CapabilityStats ik_;
+  CapabilityStats state_validity_;
+  std::atomic<bool> stop_{ false };
+};
+}  // namespace moveit_ros_benchmarks
+
+int main(int argc, char** argv)
+{
+  rclcpp::init(argc, argv);
+  rclcpp::NodeOptions node_options;
+  node_options.allow_undeclared_parameters(true);
+  node_options.automatically_declare_parameters_from_overrides(true);
+  rclcpp::Node::SharedPtr node = rclcpp::Node::make_shared("moveit_move_group_load_test", node_options);
+
+  moveit_ros_benchmarks::MoveGroupLoadTest load_test(node);
+  if (!load_test.initialize())
+  {
+    rclcpp::shutdown();
+    return 1;
+  }
+  load_test.run();
+  rclcpp::shutdown();
+  return 0;
+}
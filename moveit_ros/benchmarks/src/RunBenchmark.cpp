@@ -38,6 +38,7 @@
 
 #include <moveit/benchmarks/BenchmarkOptions.h>
 #include <moveit/benchmarks/BenchmarkExecutor.h>
+#include <moveit/utils/random_seed.h>
 #include <rclcpp/executors.hpp>
 #include <rclcpp/logger.hpp>
 #include <rclcpp/logging.hpp>
@@ -57,6 +58,9 @@ int main(int argc, char** argv)
 
   // Read benchmark options from param server
   moveit_ros_benchmarks::BenchmarkOptions opts(node);
+  // Seed before the planners are loaded, OMPL only accepts a seed before it created its first generator
+  if (opts.getSeed() > 0)
+    moveit::core::setRandomSeed(opts.getSeed());
   // Setup benchmark server
   moveit_ros_benchmarks::BenchmarkExecutor server(node);
 
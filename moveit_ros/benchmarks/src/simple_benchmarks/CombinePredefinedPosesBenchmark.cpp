@@ -33,7 +33,8 @@
  *********************************************************************/
 
 /* Author: Henning Kayser */
-/* Description: A simple benchmark that plans trajectories for all combinations of specified predefined poses */
+/* Description: A simple benchmark that plans trajectories for all combinations of specified predefined poses and
+ * random valid states, optionally in several randomly cluttered variants of the scene */
 
 // MoveIt Benchmark
 #include <moveit/benchmarks/BenchmarkOptions.h>
@@ -42,7 +43,10 @@
 // MoveIt
 #include <moveit/planning_scene_monitor/planning_scene_monitor.h>
 #include <moveit/kinematic_constraints/utils.h>
+#include <moveit/planning_scene/planning_scene.h>
 #include <moveit/robot_state/conversions.h>
+#include <moveit/utils/random_seed.h>
+#include <geometric_shapes/solid_primitive_dims.h>
 
 static const rclcpp::Logger LOGGER = rclcpp::get_logger("moveit.ros.benchmarks.combine_predefined_poses_benchmark");
 
@@ -55,6 +59,26 @@ public:
   {
   }
 
+  bool runBenchmarks(const BenchmarkOptions& opts) override
+  {
+    int scene_variants;
+    node_->get_parameter_or(std::string("benchmark_config.parameters.scene_variants"), scene_variants, 0);
+    if (scene_variants <= 0)
+    {
+      scene_variant_ = -1;
+      return BenchmarkExecutor::runBenchmarks(opts);
+    }
+
+    // Benchmark all states in every cluttered variant of the scene, the variants are listed as separate queries
+    bool success = true;
+    for (scene_variant_ = 0; scene_variant_ < scene_variants; ++scene_variant_)
+    {
+      RCLCPP_INFO(LOGGER, "Benchmarking scene variant %d of %d", scene_variant_ + 1, scene_variants);
+      success &= BenchmarkExecutor::runBenchmarks(opts);
+    }
+    return success;
+  }
+
   bool loadBenchmarkQueryData(const BenchmarkOptions& opts, moveit_msgs::msg::PlanningScene& scene_msg,
                               std::vector<StartState>& start_states, std::vector<PathConstraints>& path_constraints,
                               std::vector<PathConstraints>& goal_constraints,
@@ -91,31 +115,72 @@ public:
       return false;
     }
 
-    // Iterate over all predefined poses and use each as start and goal states
+    // The scenario is random, but reproducible if the benchmark is seeded. The runs reseed the generators, so every
+    // scene variant starts its own sequence
+    if (opts.getSeed() > 0)
+      moveit::core::setRandomSeed(opts.getSeed() + scene_variant_ + 1);
+    random_numbers::RandomNumberGenerator rng = moveit::core::makeRandomNumberGenerator();
+    planning_scene::PlanningScene scene(psm_->getRobotModel());
+    std::string prefix;
+    if (scene_variant_ >= 0)
+    {
+      addClutter(opts, scene, scene_msg, rng);
+      prefix = scene_msg.name + "/";
+    }
+
+    // Iterate over all predefined poses and random valid states and use each as start and goal states
     moveit::core::RobotState robot_state(psm_->getRobotModel());
     start_states.clear();
     goal_constraints.clear();
-    for (const auto& pose_id : opts.getPredefinedPoses())
-    {
-      if (!robot_state.setToDefaultValues(joint_model_group, pose_id))
-      {
-        RCLCPP_WARN_STREAM(LOGGER, "Failed to set robot state to named target '" << pose_id << "'");
-        continue;
-      }
+    const auto add_state = [&](const std::string& name) {
       // Create start state
       start_states.emplace_back();
-      start_states.back().name = pose_id;
+      start_states.back().name = prefix + name;
       moveit::core::robotStateToRobotStateMsg(robot_state, start_states.back().state);
 
       // Create goal constraints
       goal_constraints.emplace_back();
-      goal_constraints.back().name = pose_id;
+      goal_constraints.back().name = prefix + name;
       goal_constraints.back().constraints.push_back(
           kinematic_constraints::constructGoalConstraints(robot_state, joint_model_group));
+    };
+    const auto is_valid = [&] {
+      robot_state.update();
+      return robot_state.satisfiesBounds(joint_model_group) && !scene.isStateColliding(robot_state);
+    };
+
+    for (const auto& pose_id : opts.getPredefinedPoses())
+    {
+      if (!robot_state.setToDefaultValues(joint_model_group, pose_id))
+      {
+        RCLCPP_WARN_STREAM(LOGGER, "Failed to set robot state to named target '" << pose_id << "'");
+        continue;
+      }
+      if (scene_variant_ >= 0 && !is_valid())
+      {
+        RCLCPP_WARN_STREAM(LOGGER, "Named target '" << pose_id << "' is in collision in " << scene_msg.name);
+        continue;
+      }
+      add_state(pose_id);
     }
+
+    int random_states;
+    node_->get_parameter_or(std::string("benchmark_config.parameters.random_states"), random_states, 0);
+    const int max_attempts = 100 * random_states;
+    int added = 0;
+    for (int attempt = 0; added < random_states && attempt < max_attempts; ++attempt)
+    {
+      robot_state.setToDefaultValues();
+      robot_state.setToRandomPositions(joint_model_group, rng);
+      if (is_valid())
+        add_state("random_" + std::to_string(added++));
+    }
+    if (added < random_states)
+      RCLCPP_WARN(LOGGER, "Only found %d of %d random valid states", added, random_states);
+
     if (start_states.empty() || goal_constraints.empty())
     {
-      RCLCPP_ERROR_STREAM(LOGGER, "Failed to init start and goal states from predefined_poses");
+      RCLCPP_ERROR_STREAM(LOGGER, "Failed to init start and goal states from predefined_poses and random_states");
       return false;
     }
 
@@ -127,7 +192,69 @@ public:
   }
 
 private:
+  /// Add randomly placed boxes to \e scene and \e scene_msg, keeping the robot in its default state collision free
+  void addClutter(const BenchmarkOptions& opts, planning_scene::PlanningScene& scene,
+                  moveit_msgs::msg::PlanningScene& scene_msg, random_numbers::RandomNumberGenerator& rng) const
+  {
+    int clutter_objects;
+    std::vector<double> clutter_size;
+    node_->get_parameter_or(std::string("benchmark_config.parameters.clutter_objects"), clutter_objects, 5);
+    node_->get_parameter_or(std::string("benchmark_config.parameters.clutter_size"), clutter_size, { 0.05, 0.2 });
+    if (clutter_size.size() != 2)
+      clutter_size = { 0.05, 0.2 };
+
+    // Place the boxes in the workspace, or within a meter around the robot without one
+    moveit_msgs::msg::WorkspaceParameters workspace = opts.getWorkspaceParameters();
+    if (workspace.min_corner.x == workspace.max_corner.x && workspace.min_corner.y == workspace.max_corner.y &&
+        workspace.min_corner.z == workspace.max_corner.z)
+    {
+      workspace.min_corner.x = workspace.min_corner.y = workspace.min_corner.z = -1.0;
+      workspace.max_corner.x = workspace.max_corner.y = workspace.max_corner.z = 1.0;
+    }
+
+    scene_msg.name = "clutter_" + std::to_string(scene_variant_);
+    moveit::core::RobotState default_state(scene.getRobotModel());
+    default_state.setToDefaultValues();
+    default_state.update();
+    int added = 0;
+    for (int attempt = 0; added < clutter_objects && attempt < 100 * clutter_objects; ++attempt)
+    {
+      moveit_msgs::msg::CollisionObject object;
+      object.header.frame_id = scene.getPlanningFrame();
+      object.id = "clutter_" + std::to_string(added);
+      object.operation = moveit_msgs::msg::CollisionObject::ADD;
+      object.primitives.resize(1);
+      object.primitives[0].type = shape_msgs::msg::SolidPrimitive::BOX;
+      object.primitives[0].dimensions.resize(
+          geometric_shapes::solidPrimitiveDimCount<shape_msgs::msg::SolidPrimitive::BOX>());
+      for (double& dimension : object.primitives[0].dimensions)
+        dimension = rng.uniformReal(clutter_size[0], clutter_size[1]);
+      object.primitive_poses.resize(1);
+      object.primitive_poses[0].position.x = rng.uniformReal(workspace.min_corner.x, workspace.max_corner.x);
+      object.primitive_poses[0].position.y = rng.uniformReal(workspace.min_corner.y, workspace.max_corner.y);
+      object.primitive_poses[0].position.z = rng.uniformReal(workspace.min_corner.z, workspace.max_corner.z);
+      double quaternion[4];
+      rng.quaternion(quaternion);
+      object.primitive_poses[0].orientation.x = quaternion[0];
+      object.primitive_poses[0].orientation.y = quaternion[1];
+      object.primitive_poses[0].orientation.z = quaternion[2];
+      object.primitive_poses[0].orientation.w = quaternion[3];
+
+      scene.processCollisionObjectMsg(object);
+      if (scene.isStateColliding(default_state))
+      {
+        scene.getWorldNonConst()->removeObject(object.id);
+        continue;
+      }
+      scene_msg.world.collision_objects.push_back(object);
+      ++added;
+    }
+    RCLCPP_INFO(LOGGER, "Added %d clutter objects to %s", added, scene_msg.name.c_str());
+  }
+
   planning_scene_monitor::PlanningSceneMonitorPtr psm_;
+  /// The cluttered scene variant that is benchmarked, -1 to use the scene as it is
+  int scene_variant_ = -1;
 };
 }  // namespace moveit_ros_benchmarks
 
@@ -49,6 +49,8 @@
 #include <moveit_msgs/msg/motion_plan_request.hpp>
 #include <moveit_msgs/msg/motion_plan_response.hpp>
 
+#include <atomic>
+
 namespace moveit::hybrid_planning
 {
 // Component node containing the global planner
@@ -62,6 +64,7 @@ public:
   ~GlobalPlannerComponent()
   {
     // Join the thread used for long-running callbacks
+    stop_replanning_ = true;
     if (long_callback_thread_.joinable())
     {
       long_callback_thread_.join();
@@ -100,6 +103,19 @@ private:
   // Initialize planning scene monitor and load pipelines
   bool initializeGlobalPlanner();
 
+  // Keep planning from the current state until the goal is preempted, publishing every better or still valid solution.
+  // Returns the best solution found.
+  moveit_msgs::msg::MotionPlanResponse
+  replan(const std::shared_ptr<rclcpp_action::ServerGoalHandle<moveit_msgs::action::GlobalPlanner>>& goal_handle,
+         moveit_msgs::msg::MotionPlanResponse best_solution);
+
+  // Anytime replanning configuration
+  bool anytime_replanning_;
+  double anytime_min_improvement_;  // Relative duration decrease required to replace the best solution
+
+  // Set to preempt anytime replanning
+  std::atomic<bool> stop_replanning_{ false };
+
   // This thread is used for long-running callbacks. It's a member so they do not go out of scope.
   std::thread long_callback_thread_;
 
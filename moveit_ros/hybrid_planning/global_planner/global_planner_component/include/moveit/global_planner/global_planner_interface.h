@@ -69,6 +69,17 @@ public:
   virtual moveit_msgs::msg::MotionPlanResponse plan(
       const std::shared_ptr<rclcpp_action::ServerGoalHandle<moveit_msgs::action::GlobalPlanner>> global_goal_handle) = 0;
 
+  /**
+   * Check a previously computed solution against the latest planning scene. Used to re-validate the best solution
+   * during anytime replanning. The default implementation accepts every solution.
+   * @param solution Motion plan returned by plan()
+   * @return True if the solution is still valid
+   */
+  virtual bool isSolutionValid(const moveit_msgs::msg::MotionPlanResponse& /* solution */)
+  {
+    return true;
+  }
+
   /**
    * Reset global planner plugin. This should never fail.
    * @return True if reset was successful
@@ -37,6 +37,7 @@
 #include <moveit/robot_state/conversions.h>
 #include <moveit_msgs/msg/move_it_error_codes.h>
 
+#include <algorithm>
 #include <chrono>
 #include <thread>
 
@@ -44,6 +45,17 @@ namespace
 {
 const rclcpp::Logger LOGGER = rclcpp::get_logger("global_planner_component");
 const auto JOIN_THREAD_TIMEOUT = std::chrono::seconds(1);
+
+// Duration of a planned trajectory
+double solutionDuration(const moveit_msgs::msg::MotionPlanResponse& solution)
+{
+  const auto& points = solution.trajectory.joint_trajectory.points;
+  const auto& mdof_points = solution.trajectory.multi_dof_joint_trajectory.points;
+  double duration = points.empty() ? 0.0 : rclcpp::Duration(points.back().time_from_start).seconds();
+  if (!mdof_points.empty())
+    duration = std::max(duration, rclcpp::Duration(mdof_points.back().time_from_start).seconds());
+  return duration;
+}
 }  // namespace
 
 namespace moveit::hybrid_planning
@@ -81,6 +93,7 @@ bool GlobalPlannerComponent::initializeGlobalPlanner()
         // If another goal is active, cancel it and reject this goal
         if (long_callback_thread_.joinable())
         {
+          stop_replanning_ = true;
           // Try to terminate the execution thread
           auto future = std::async(std::launch::async, &std::thread::join, &long_callback_thread_);
           if (future.wait_for(JOIN_THREAD_TIMEOUT) == std::future_status::timeout)
@@ -98,6 +111,8 @@ bool GlobalPlannerComponent::initializeGlobalPlanner()
       // Cancel callback
       [this](const std::shared_ptr<rclcpp_action::ServerGoalHandle<moveit_msgs::action::GlobalPlanner>>& /*unused*/) {
         RCLCPP_INFO(LOGGER, "Received request to cancel global planning goal");
+        // Anytime replanning finishes with the best solution found so far
+        stop_replanning_ = true;
         if (long_callback_thread_.joinable())
         {
           long_callback_thread_.join();
@@ -116,12 +131,17 @@ bool GlobalPlannerComponent::initializeGlobalPlanner()
           long_callback_thread_.join();
           global_planner_instance_->reset();
         }
+        stop_replanning_ = false;
         long_callback_thread_ = std::thread(&GlobalPlannerComponent::globalPlanningRequestCallback, this, goal_handle);
       },
       rcl_action_server_get_default_options(), cb_group_);
 
   global_trajectory_pub_ = node_->create_publisher<moveit_msgs::msg::MotionPlanResponse>("global_trajectory", 1);
 
+  // Anytime replanning keeps improving the solution until the goal is canceled
+  anytime_replanning_ = node_->declare_parameter<bool>("anytime_replanning", false);
+  anytime_min_improvement_ = node_->declare_parameter<double>("anytime_min_improvement", 0.1);
+
   // Load global planner plugin
   planner_plugin_name_ = node_->declare_parameter<std::string>("global_planner_name", UNDEFINED);
 
@@ -160,15 +180,21 @@ void GlobalPlannerComponent::globalPlanningRequestCallback(
 {
   // Plan global trajectory
   moveit_msgs::msg::MotionPlanResponse planning_solution = global_planner_instance_->plan(goal_handle);
+  const bool success = planning_solution.error_code.val == moveit_msgs::msg::MoveItErrorCodes::SUCCESS;
+  if (success)
+  {
+    // Publish global planning solution to the local planner
+    global_trajectory_pub_->publish(planning_solution);
+    if (anytime_replanning_)
+      planning_solution = replan(goal_handle, planning_solution);
+  }
 
   // Send action response
   auto result = std::make_shared<moveit_msgs::action::GlobalPlanner::Result>();
   result->response = planning_solution;
 
-  if (planning_solution.error_code.val == moveit_msgs::msg::MoveItErrorCodes::SUCCESS)
+  if (success)
   {
-    // Publish global planning solution to the local planner
-    global_trajectory_pub_->publish(planning_solution);
     goal_handle->succeed(result);
   }
   else
@@ -179,6 +205,34 @@ void GlobalPlannerComponent::globalPlanningRequestCallback(
   // Reset the global planner
   global_planner_instance_->reset();
 };
+
+moveit_msgs::msg::MotionPlanResponse GlobalPlannerComponent::replan(
+    const std::shared_ptr<rclcpp_action::ServerGoalHandle<moveit_msgs::action::GlobalPlanner>>& goal_handle,
+    moveit_msgs::msg::MotionPlanResponse best_solution)
+{
+  RCLCPP_INFO(LOGGER, "Replanning in the background until the global planning goal is preempted");
+  rclcpp::Time best_solution_time = node_->now();
+  while (!stop_replanning_ && !goal_handle->is_canceling() && rclcpp::ok())
+  {
+    // Every attempt starts at the current state, so it competes with the part of the best solution that is left
+    const bool best_solution_valid = global_planner_instance_->isSolutionValid(best_solution);
+    moveit_msgs::msg::MotionPlanResponse candidate = global_planner_instance_->plan(goal_handle);
+    if (stop_replanning_ || candidate.error_code.val != moveit_msgs::msg::MoveItErrorCodes::SUCCESS)
+      continue;
+
+    const double remaining_duration =
+        std::max(0.0, solutionDuration(best_solution) - (node_->now() - best_solution_time).seconds());
+    if (best_solution_valid && solutionDuration(candidate) >= (1.0 - anytime_min_improvement_) * remaining_duration)
+      continue;
+
+    if (!best_solution_valid)
+      RCLCPP_INFO(LOGGER, "The global solution became invalid, replacing it");
+    best_solution = std::move(candidate);
+    best_solution_time = node_->now();
+    global_trajectory_pub_->publish(best_solution);
+  }
+  return best_solution;
+}
 }  // namespace moveit::hybrid_planning
 
 // Register the component with class_loader
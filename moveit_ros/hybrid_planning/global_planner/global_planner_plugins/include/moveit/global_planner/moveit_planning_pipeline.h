@@ -56,6 +56,7 @@ public:
   moveit_msgs::msg::MotionPlanResponse
   plan(const std::shared_ptr<rclcpp_action::ServerGoalHandle<moveit_msgs::action::GlobalPlanner>> global_goal_handle)
       override;
+  bool isSolutionValid(const moveit_msgs::msg::MotionPlanResponse& solution) override;
 
 private:
   rclcpp::Node::SharedPtr node_ptr_;
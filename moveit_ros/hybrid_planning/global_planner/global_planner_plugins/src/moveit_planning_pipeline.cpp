@@ -146,6 +146,18 @@ moveit_msgs::msg::MotionPlanResponse MoveItPlanningPipeline::plan(
 
   return response;
 }
+
+bool MoveItPlanningPipeline::isSolutionValid(const moveit_msgs::msg::MotionPlanResponse& solution)
+{
+  const moveit::core::RobotModelConstPtr robot_model = moveit_cpp_->getRobotModel();
+  moveit::core::RobotState start_state(robot_model);
+  moveit::core::robotStateMsgToRobotState(solution.trajectory_start, start_state);
+  robot_trajectory::RobotTrajectory trajectory(robot_model, solution.group_name);
+  trajectory.setRobotTrajectoryMsg(start_state, solution.trajectory);
+
+  planning_scene_monitor::LockedPlanningSceneRO planning_scene(moveit_cpp_->getPlanningSceneMonitor());
+  return planning_scene->isPathValid(trajectory, solution.group_name);
+}
 }  // namespace moveit::hybrid_planning
 
 #include <pluginlib/class_list_macros.hpp>
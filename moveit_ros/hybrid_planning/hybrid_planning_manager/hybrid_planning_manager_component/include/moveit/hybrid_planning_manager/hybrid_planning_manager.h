@@ -103,6 +103,19 @@ public:
    */
   bool sendGlobalPlannerAction();
 
+  /**
+   * Preempt the global planner. An anytime replanning global planner finishes with its best solution
+   */
+  void cancelGlobalPlannerAction();
+
+  /**
+   * Whether a global planning goal was accepted and has not finished yet
+   */
+  bool isGlobalPlanningActive() const
+  {
+    return global_planning_active_;
+  }
+
   /**
    * Send local planning request to local planner component
    * @return Local planner successfully started yes/no
@@ -131,6 +144,9 @@ private:
   // Flag that indicates hybrid planning has been canceled
   std::atomic<bool> stop_hybrid_planning_;
 
+  // Flag that indicates a global planning goal is running
+  std::atomic<bool> global_planning_active_{ false };
+
   // Shared hybrid planning goal handle
   std::shared_ptr<rclcpp_action::ServerGoalHandle<moveit_msgs::action::HybridPlanner>> hybrid_planning_goal_handle_;
 
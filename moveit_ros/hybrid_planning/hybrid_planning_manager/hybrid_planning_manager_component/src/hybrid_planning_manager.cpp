@@ -241,6 +241,7 @@ bool HybridPlanningManager::sendGlobalPlannerAction()
         else
         {
           feedback = "Global goal accepted by server";
+          global_planning_active_ = true;
         }
         hybrid_planning_goal_handle_->publish_feedback(planning_progress);
       };
@@ -250,6 +251,7 @@ bool HybridPlanningManager::sendGlobalPlannerAction()
         // Reaction result from the latest event
         ReactionResult reaction_result =
             ReactionResult(HybridPlanningEvent::UNDEFINED, "", moveit_msgs::msg::MoveItErrorCodes::FAILURE);
+        global_planning_active_ = false;
         switch (global_result.code)
         {
           case rclcpp_action::ResultCode::SUCCEEDED:
@@ -292,6 +294,11 @@ bool HybridPlanningManager::sendGlobalPlannerAction()
   return true;  // return always success TODO(sjahr) add more error checking
 };
 
+void HybridPlanningManager::cancelGlobalPlannerAction()
+{
+  global_planner_action_client_->async_cancel_all_goals();
+}
+
 bool HybridPlanningManager::sendLocalPlannerAction()
 {
   // Setup empty dummy goal (Global trajectory is subscribed by the local planner) TODO(sjahr) pass goal as function argument
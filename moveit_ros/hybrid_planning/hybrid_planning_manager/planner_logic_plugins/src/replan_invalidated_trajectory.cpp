@@ -47,6 +47,11 @@ ReactionResult ReplanInvalidatedTrajectory::react(const std::string& event)
   if ((event == toString(LocalFeedbackEnum::COLLISION_AHEAD)) ||
       (event == toString(LocalFeedbackEnum::LOCAL_PLANNER_STUCK)))
   {
+    // A running global planner replans against the latest scene on its own and publishes a valid solution
+    if (hybrid_planning_manager_->isGlobalPlanningActive())
+    {
+      return ReactionResult(event, "", moveit_msgs::msg::MoveItErrorCodes::SUCCESS);
+    }
     if (!hybrid_planning_manager_->sendGlobalPlannerAction())  // Start global planning
     {
       hybrid_planning_manager_->sendHybridPlanningResponse(false);
@@ -61,10 +61,9 @@ ReactionResult SinglePlanExecution::react(const HybridPlanningEvent& event)
       local_planner_started_ = false;
       return ReactionResult(event, "", moveit_msgs::msg::MoveItErrorCodes::SUCCESS);
     case HybridPlanningEvent::GLOBAL_SOLUTION_AVAILABLE:
-      // Do nothing since we wait for the global planning action to finish
-      return ReactionResult(event, "Do nothing", moveit_msgs::msg::MoveItErrorCodes::SUCCESS);
     case HybridPlanningEvent::GLOBAL_PLANNING_ACTION_SUCCESSFUL:
-      // Activate local planner once global solution is available
+      // Activate local planner once global solution is available. An anytime replanning global planner keeps its
+      // action running and only publishes its solutions
       if (!local_planner_started_)
       {                                                           // ensure the local planner is not started twice
         if (!hybrid_planning_manager_->sendLocalPlannerAction())  // Start local planning
@@ -80,10 +79,12 @@ ReactionResult SinglePlanExecution::react(const HybridPlanningEvent& event)
                             moveit_msgs::msg::MoveItErrorCodes::PLANNING_FAILED);
     case HybridPlanningEvent::LOCAL_PLANNING_ACTION_SUCCESSFUL:
       // Finish hybrid planning action successfully because local planning action succeeded
+      hybrid_planning_manager_->cancelGlobalPlannerAction();
       hybrid_planning_manager_->sendHybridPlanningResponse(true);
       return ReactionResult(event, "", moveit_msgs::msg::MoveItErrorCodes::SUCCESS);
     case HybridPlanningEvent::LOCAL_PLANNING_ACTION_ABORTED:
       // Local planning failed so abort hybrid planning
+      hybrid_planning_manager_->cancelGlobalPlannerAction();
       return ReactionResult(event, "Local planner failed to find a solution",
                             moveit_msgs::msg::MoveItErrorCodes::PLANNING_FAILED);
     default:
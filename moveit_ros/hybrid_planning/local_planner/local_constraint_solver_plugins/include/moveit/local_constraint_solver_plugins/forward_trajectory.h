@@ -35,7 +35,7 @@
 /* Author: Sebastian Jahr
    Description: Simple local solver plugin that forwards the next waypoint of the sampled local trajectory.
    The local solver stops for two conditions: invalid waypoint (likely due to collision) or if it has been stuck for
-   several iterations.
+   several iterations. If a later waypoint of the local trajectory is invalid, it slows down instead.
  */
 
 #pragma once
@@ -61,6 +61,13 @@ public:
         trajectory_msgs::msg::JointTrajectory& local_solution) override;
 
 private:
+  /**
+   * Check the waypoints of the local trajectory for collisions with one batched collision query
+   * @return The number of leading waypoints that are valid
+   */
+  std::size_t countValidWaypoints(const planning_scene::PlanningScene& planning_scene,
+                                  const robot_trajectory::RobotTrajectory& local_trajectory);
+
   rclcpp::Node::SharedPtr node_;
   planning_scene_monitor::PlanningSceneMonitorPtr planning_scene_monitor_;
   bool path_invalidation_event_send_;  // Send path invalidation event only once
@@ -69,5 +76,16 @@ private:
   // Detect when the local planner gets stuck
   size_t num_iterations_stuck_;
   moveit::core::RobotStatePtr prev_waypoint_target_;
+
+  // Copy of the current state, reused by every call to solve()
+  moveit::core::RobotStatePtr current_state_;
+
+  // Command towards the next waypoint when slowing down before a collision
+  moveit::core::RobotStatePtr slowed_command_;
+
+  // Buffers of the batched collision check of the local trajectory
+  std::vector<moveit::core::RobotStatePtr> lookahead_states_;
+  std::vector<const moveit::core::RobotState*> lookahead_state_ptrs_;
+  std::vector<collision_detection::CollisionResult> lookahead_results_;
 };
 }  // namespace moveit::hybrid_planning
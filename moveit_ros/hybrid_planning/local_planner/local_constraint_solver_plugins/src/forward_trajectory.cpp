@@ -37,12 +37,55 @@
 #include <moveit/planning_scene/planning_scene.h>
 #include <moveit/robot_state/conversions.h>
 
+#include <algorithm>
+
 namespace
 {
 const rclcpp::Logger LOGGER = rclcpp::get_logger("local_planner_component");
 // If stuck for this many iterations or more, abort the local planning action
 constexpr size_t STUCK_ITERATIONS_THRESHOLD = 5;
 constexpr double STUCK_THRESHOLD_RAD = 1e-4;  // L1-norm sum across all joints
+
+// Write \e state as the single point of \e local_solution, like RobotTrajectory::getRobotTrajectoryMsg() but reusing
+// the memory of the message
+void toJointTrajectoryMsg(const moveit::core::RobotState& state, const moveit::core::JointModelGroup* group,
+                          double duration, trajectory_msgs::msg::JointTrajectory& local_solution)
+{
+  const moveit::core::RobotModelConstPtr& robot_model = state.getRobotModel();
+  const std::vector<const moveit::core::JointModel*>& joints =
+      group ? group->getActiveJointModels() : robot_model->getActiveJointModels();
+  const std::size_t joint_count =
+      std::count_if(joints.begin(), joints.end(),
+                    [](const moveit::core::JointModel* joint) { return joint->getVariableCount() == 1; });
+
+  local_solution.header.frame_id = robot_model->getModelFrame();
+  local_solution.header.stamp = rclcpp::Time(0, 0, RCL_ROS_TIME);
+  local_solution.joint_names.resize(joint_count);
+  local_solution.points.resize(1);
+  trajectory_msgs::msg::JointTrajectoryPoint& point = local_solution.points[0];
+  point.positions.resize(joint_count);
+  point.velocities.resize(state.hasVelocities() ? joint_count : 0);
+  point.accelerations.resize(state.hasAccelerations() ? joint_count : 0);
+  point.effort.resize(state.hasEffort() ? joint_count : 0);
+  point.time_from_start = rclcpp::Duration::from_seconds(duration);
+
+  std::size_t i = 0;
+  for (const moveit::core::JointModel* joint : joints)
+  {
+    if (joint->getVariableCount() != 1)
+      continue;
+    const int index = joint->getFirstVariableIndex();
+    local_solution.joint_names[i] = joint->getName();
+    point.positions[i] = state.getVariablePosition(index);
+    if (state.hasVelocities())
+      point.velocities[i] = state.getVariableVelocity(index);
+    if (state.hasAccelerations())
+      point.accelerations[i] = state.getVariableAcceleration(index);
+    if (state.hasEffort())
+      point.effort[i] = state.getVariableEffort(index);
+    ++i;
+  }
+}
 }  // namespace
 
 namespace moveit::hybrid_planning
@@ -79,40 +122,39 @@ ForwardTrajectory::solve(const robot_trajectory::RobotTrajectory& local_trajecto
   // A message every once in awhile is useful in case the local planner gets stuck
   RCLCPP_INFO_THROTTLE(LOGGER, *node_->get_clock(), 2000 /* ms */, "The local planner is solving...");
 
-  // Create controller command trajectory
-  robot_trajectory::RobotTrajectory robot_command(local_trajectory.getRobotModel(), local_trajectory.getGroupName());
+  // Controller command, either the next waypoint or the current state. It is not copied into a trajectory, so that
+  // this runs without allocations in the control loop
+  const moveit::core::RobotState* robot_command = &local_trajectory.getWayPoint(0);
+  double robot_command_duration = 0.0;
 
   // Feedback
   moveit_msgs::action::LocalPlanner::Feedback feedback_result;
 
   // If this flag is set, ignore collisions
-  if (!stop_before_collision_)
-  {
-    robot_command.addSuffixWayPoint(local_trajectory.getWayPoint(0), 0.0);
-  }
-  else
+  if (stop_before_collision_)
   {
     // Get current planning scene
     planning_scene_monitor_->updateFrameTransforms();
 
-    moveit::core::RobotStatePtr current_state;
-    bool is_path_valid = false;
+    std::size_t valid_waypoints = 0;
     // Lock the planning scene as briefly as possible
     {
       planning_scene_monitor::LockedPlanningSceneRO locked_planning_scene(planning_scene_monitor_);
-      current_state = std::make_shared<moveit::core::RobotState>(locked_planning_scene->getCurrentState());
-      is_path_valid = locked_planning_scene->isPathValid(local_trajectory, local_trajectory.getGroupName(), false);
+      if (current_state_)
+        *current_state_ = locked_planning_scene->getCurrentState();
+      else
+        current_state_ = std::make_shared<moveit::core::RobotState>(locked_planning_scene->getCurrentState());
+      valid_waypoints = countValidWaypoints(*locked_planning_scene, local_trajectory);
     }
 
     // Check if path is valid
-    if (is_path_valid)
+    if (valid_waypoints == local_trajectory.getWayPointCount())
     {
       if (path_invalidation_event_send_)
       {
         path_invalidation_event_send_ = false;  // Reset flag
       }
-      // Forward next waypoint to the robot controller
-      robot_command.addSuffixWayPoint(local_trajectory.getWayPoint(0), 0.0);
+      // Forward next waypoint to the robot controller, robot_command already refers to it
     }
     else
     {
@@ -121,52 +163,103 @@ ForwardTrajectory::solve(const robot_trajectory::RobotTrajectory& local_trajecto
         feedback_result.feedback = toString(LocalFeedbackEnum::COLLISION_AHEAD);
         path_invalidation_event_send_ = true;  // Set feedback flag
       }
-      RCLCPP_INFO(LOGGER, "Collision ahead, holding current position");
-      // Keep current position
-      moveit::core::RobotState current_state_command(*current_state);
-      if (current_state_command.hasVelocities())
+      if (valid_waypoints > 0)
       {
-        current_state_command.zeroVelocities();
+        // Slow down in proportion to the collision free part of the lookahead horizon
+        const double fraction = static_cast<double>(valid_waypoints) / local_trajectory.getWayPointCount();
+        RCLCPP_INFO_THROTTLE(LOGGER, *node_->get_clock(), 1000 /* ms */, "Collision ahead, slowing down to %.0f%%",
+                             100.0 * fraction);
+        const moveit::core::RobotState& next_waypoint = local_trajectory.getWayPoint(0);
+        if (slowed_command_)
+          *slowed_command_ = *current_state_;
+        else
+          slowed_command_ = std::make_shared<moveit::core::RobotState>(*current_state_);
+        current_state_->interpolate(next_waypoint, fraction, *slowed_command_);
+        if (next_waypoint.hasVelocities())
+        {
+          for (std::size_t i = 0; i < next_waypoint.getVariableCount(); ++i)
+            slowed_command_->setVariableVelocity(i, fraction * next_waypoint.getVariableVelocity(i));
+        }
+        if (slowed_command_->hasAccelerations())
+        {
+          slowed_command_->zeroAccelerations();
+        }
+        robot_command = slowed_command_.get();
       }
-      if (current_state_command.hasAccelerations())
+      else
       {
-        current_state_command.zeroAccelerations();
+        RCLCPP_INFO(LOGGER, "Collision ahead, holding current position");
+        // Keep current position
+        if (current_state_->hasVelocities())
+        {
+          current_state_->zeroVelocities();
+        }
+        if (current_state_->hasAccelerations())
+        {
+          current_state_->zeroAccelerations();
+        }
+        robot_command = current_state_.get();
       }
-      robot_command.empty();
-      robot_command.addSuffixWayPoint(*current_state, local_trajectory.getWayPointDurationFromPrevious(0));
+      robot_command_duration = local_trajectory.getWayPointDurationFromPrevious(0);
     }
 
     // Detect if the local solver is stuck
     if (!prev_waypoint_target_)
     {
       // Just initialize if this is the first iteration
-      prev_waypoint_target_ = robot_command.getFirstWayPointPtr();
+      prev_waypoint_target_ = std::make_shared<moveit::core::RobotState>(*robot_command);
     }
     else
     {
-      if (prev_waypoint_target_->distance(*robot_command.getFirstWayPointPtr()) <= STUCK_THRESHOLD_RAD)
+      if (prev_waypoint_target_->distance(*robot_command) <= STUCK_THRESHOLD_RAD)
       {
         ++num_iterations_stuck_;
         if (num_iterations_stuck_ > STUCK_ITERATIONS_THRESHOLD)
         {
           num_iterations_stuck_ = 0;
-          prev_waypoint_target_ = nullptr;
           feedback_result.feedback = toString(LocalFeedbackEnum::LOCAL_PLANNER_STUCK);
           path_invalidation_event_send_ = true;  // Set feedback flag
           RCLCPP_INFO(LOGGER, "The local planner has been stuck for several iterations. Aborting.");
         }
       }
-      prev_waypoint_target_ = robot_command.getFirstWayPointPtr();
+      *prev_waypoint_target_ = *robot_command;
     }
   }
 
-  // Transform robot trajectory into joint_trajectory message
-  moveit_msgs::msg::RobotTrajectory robot_command_msg;
-  robot_command.getRobotTrajectoryMsg(robot_command_msg);
-  local_solution = robot_command_msg.joint_trajectory;
+  // Transform the command into the joint_trajectory message
+  toJointTrajectoryMsg(*robot_command, local_trajectory.getGroup(), robot_command_duration, local_solution);
 
   return feedback_result;
 }
+
+std::size_t ForwardTrajectory::countValidWaypoints(const planning_scene::PlanningScene& planning_scene,
+                                                   const robot_trajectory::RobotTrajectory& local_trajectory)
+{
+  const std::size_t waypoint_count = local_trajectory.getWayPointCount();
+  while (lookahead_states_.size() < waypoint_count)
+    lookahead_states_.push_back(std::make_shared<moveit::core::RobotState>(local_trajectory.getRobotModel()));
+  lookahead_state_ptrs_.resize(waypoint_count);
+  for (std::size_t i = 0; i < waypoint_count; ++i)
+  {
+    // The batched check needs up-to-date collision body transforms, which the shared waypoints may not have
+    *lookahead_states_[i] = local_trajectory.getWayPoint(i);
+    lookahead_states_[i]->updateCollisionBodyTransforms();
+    lookahead_state_ptrs_[i] = lookahead_states_[i].get();
+  }
+
+  collision_detection::CollisionRequest request;
+  request.group_name = local_trajectory.getGroupName();
+  planning_scene.getCollisionEnv()->checkCollisionBatch(request, lookahead_results_, lookahead_state_ptrs_,
+                                                        planning_scene.getAllowedCollisionMatrix());
+
+  const moveit::core::JointModelGroup* group = local_trajectory.getGroup();
+  for (std::size_t i = 0; i < waypoint_count; ++i)
+  {
+    if (lookahead_results_[i].collision || !lookahead_states_[i]->satisfiesBounds(group))
+      return i;
+  }
+  return waypoint_count;
+}
 }  // namespace moveit::hybrid_planning
 
 #include <pluginlib/class_list_macros.hpp>
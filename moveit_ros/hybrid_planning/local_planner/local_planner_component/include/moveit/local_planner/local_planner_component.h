@@ -113,6 +113,7 @@ public:
                                      undefined, node);
       declareOrGetParam<std::string>("local_planning_action_name", local_planning_action_name, undefined, node);
       declareOrGetParam<double>("local_planning_frequency", local_planning_frequency, 1.0, node);
+      declareOrGetParam<bool>("use_loop_thread", use_loop_thread, false, node);
       declareOrGetParam<std::string>("global_solution_topic", global_solution_topic, undefined, node);
       declareOrGetParam<std::string>("local_solution_topic", local_solution_topic, undefined, node);
       declareOrGetParam<std::string>("local_solution_topic_type", local_solution_topic_type, undefined, node);
@@ -137,6 +138,7 @@ public:
     bool publish_joint_positions;
     bool publish_joint_velocities;
     double local_planning_frequency;
+    bool use_loop_thread;  // Run the iterations in a dedicated thread on fixed deadlines instead of a ROS timer
     std::string monitored_planning_scene_topic;
     std::string collision_object_topic;
     std::string joint_states_topic;
@@ -149,10 +151,12 @@ public:
   ~LocalPlannerComponent()
   {
     // Join the thread used for long-running callbacks
+    loop_active_ = false;
     if (long_callback_thread_.joinable())
     {
       long_callback_thread_.join();
     }
+    delete pending_global_trajectory_.exchange(nullptr);
   }
 
   /**
@@ -176,9 +180,27 @@ public:
   }
 
 private:
+  /// Durations of the planning iterations of the current goal
+  struct IterationStatistics
+  {
+    std::size_t count = 0;
+    std::size_t overruns = 0;  // iterations that took longer than the planning period
+    double total_duration = 0.0;
+    double max_duration = 0.0;
+  };
+
   /** \brief Reset internal data members including state_ = LocalPlannerState::AWAIT_GLOBAL_TRAJECTORY */
   void reset();
 
+  /** \brief Call executeIteration() at local_planning_frequency on absolute deadlines until the goal is finished */
+  void runLoop();
+
+  /** \brief Run executeIteration() and record its duration */
+  void timedIteration();
+
+  /** \brief Pass a new global trajectory, received by the subscriber, on to the trajectory operator */
+  void addPendingGlobalTrajectory();
+
   std::shared_ptr<rclcpp::Node> node_;
 
   // Planner configuration
@@ -190,6 +212,19 @@ private:
   // Timer to periodically call executeIteration()
   rclcpp::TimerBase::SharedPtr timer_;
 
+  // Keeps the loop thread running while a goal is active (use_loop_thread)
+  std::atomic<bool> loop_active_{ false };
+
+  // Latest global trajectory, handed over from the subscriber without blocking the planning iterations
+  std::atomic<robot_trajectory::RobotTrajectory*> pending_global_trajectory_{ nullptr };
+
+  // Buffers reused by every iteration, so that planning does not allocate them each cycle
+  moveit::core::RobotStatePtr current_robot_state_;
+  robot_trajectory::RobotTrajectoryPtr local_trajectory_;
+  trajectory_msgs::msg::JointTrajectory local_solution_;
+
+  IterationStatistics iteration_statistics_;
+
   // Latest action goal handle
   std::shared_ptr<rclcpp_action::ServerGoalHandle<moveit_msgs::action::LocalPlanner>> local_planning_goal_handle_;
 
@@ -41,6 +41,9 @@
 
 #include <moveit_msgs/msg/constraints.hpp>
 
+#include <algorithm>
+#include <chrono>
+
 namespace moveit::hybrid_planning
 {
 using namespace std::chrono_literals;
@@ -189,11 +192,18 @@ bool LocalPlannerComponent::initialize()
         {
           long_callback_thread_.join();
         }
+        iteration_statistics_ = IterationStatistics();
         // Start a local planning loop.
         // This needs to return quickly to avoid blocking the executor, so run the local planner in a new thread.
+        if (config_.use_loop_thread)
+        {
+          loop_active_ = true;
+          long_callback_thread_ = std::thread([this]() { runLoop(); });
+          return;
+        }
         auto local_planner_timer = [&]() {
           timer_ =
-              node_->create_wall_timer(1s / config_.local_planning_frequency, [this]() { return executeIteration(); });
+              node_->create_wall_timer(1s / config_.local_planning_frequency, [this]() { return timedIteration(); });
         };
         long_callback_thread_ = std::thread(local_planner_timer);
       },
@@ -202,19 +212,15 @@ bool LocalPlannerComponent::initialize()
   // Initialize global trajectory listener
   global_solution_subscriber_ = node_->create_subscription<moveit_msgs::msg::MotionPlanResponse>(
       config_.global_solution_topic, 1, [this](const moveit_msgs::msg::MotionPlanResponse::SharedPtr msg) {
-        // Add received trajectory to internal reference trajectory
-        robot_trajectory::RobotTrajectory new_trajectory(planning_scene_monitor_->getRobotModel(), msg->group_name);
+        // Convert the received trajectory here, the planning iteration only swaps it in
+        auto new_trajectory =
+            std::make_unique<robot_trajectory::RobotTrajectory>(planning_scene_monitor_->getRobotModel(),
+                                                                msg->group_name);
         moveit::core::RobotState start_state(planning_scene_monitor_->getRobotModel());
         moveit::core::robotStateMsgToRobotState(msg->trajectory_start, start_state);
-        new_trajectory.setRobotTrajectoryMsg(start_state, msg->trajectory);
-        *local_planner_feedback_ = trajectory_operator_instance_->addTrajectorySegment(new_trajectory);
-
-        // Feedback is only send when the hybrid planning architecture should react to a discrete event that occurred
-        // when the reference trajectory is updated
-        if (!local_planner_feedback_->feedback.empty())
-        {
-          local_planning_goal_handle_->publish_feedback(local_planner_feedback_);
-        }
+        new_trajectory->setRobotTrajectoryMsg(start_state, msg->trajectory);
+        // A trajectory that was not picked up yet is superseded by the new one
+        delete pending_global_trajectory_.exchange(new_trajectory.release());
 
         // Update local planner state
         state_ = LocalPlannerState::LOCAL_PLANNING_ACTIVE;
@@ -237,10 +243,62 @@ bool LocalPlannerComponent::initialize()
     // Local solution publisher is defined by the local constraint solver plugin
   }
 
+  current_robot_state_ = std::make_shared<moveit::core::RobotState>(planning_scene_monitor_->getRobotModel());
+  local_trajectory_ =
+      std::make_shared<robot_trajectory::RobotTrajectory>(planning_scene_monitor_->getRobotModel(), config_.group_name);
+
   state_ = LocalPlannerState::AWAIT_GLOBAL_TRAJECTORY;
   return true;
 }
 
+void LocalPlannerComponent::runLoop()
+{
+  const auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::duration<double>(1.0 / config_.local_planning_frequency));
+  auto deadline = std::chrono::steady_clock::now();
+  while (loop_active_ && rclcpp::ok())
+  {
+    timedIteration();
+
+    // Missed deadlines are skipped rather than caught up on, so an overrun does not cause a burst of iterations
+    deadline += period;
+    const auto now = std::chrono::steady_clock::now();
+    if (now > deadline)
+      deadline += ((now - deadline) / period + 1) * period;
+    std::this_thread::sleep_until(deadline);
+  }
+}
+
+void LocalPlannerComponent::timedIteration()
+{
+  const auto start = std::chrono::steady_clock::now();
+  executeIteration();
+  const double duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  ++iteration_statistics_.count;
+  iteration_statistics_.total_duration += duration;
+  iteration_statistics_.max_duration = std::max(iteration_statistics_.max_duration, duration);
+  if (duration * config_.local_planning_frequency > 1.0)
+    ++iteration_statistics_.overruns;
+}
+
+void LocalPlannerComponent::addPendingGlobalTrajectory()
+{
+  std::unique_ptr<robot_trajectory::RobotTrajectory> new_trajectory(pending_global_trajectory_.exchange(nullptr));
+  if (!new_trajectory)
+    return;
+
+  // Add received trajectory to internal reference trajectory
+  *local_planner_feedback_ = trajectory_operator_instance_->addTrajectorySegment(*new_trajectory);
+
+  // Feedback is only send when the hybrid planning architecture should react to a discrete event that occurred
+  // when the reference trajectory is updated
+  if (!local_planner_feedback_->feedback.empty())
+  {
+    local_planning_goal_handle_->publish_feedback(local_planner_feedback_);
+  }
+}
+
 void LocalPlannerComponent::executeIteration()
 {
   auto result = std::make_shared<moveit_msgs::action::LocalPlanner::Result>();
@@ -264,13 +322,15 @@ void LocalPlannerComponent::executeIteration()
     // If the planner received an action request and a global solution it starts to plan locally
     case LocalPlannerState::LOCAL_PLANNING_ACTIVE:
     {
+      addPendingGlobalTrajectory();
       planning_scene_monitor_->updateSceneWithCurrentState();
 
       // Read current robot state
-      const moveit::core::RobotState current_robot_state = [this] {
+      {
         planning_scene_monitor::LockedPlanningSceneRO ls(planning_scene_monitor_);
-        return ls->getCurrentState();
-      }();
+        *current_robot_state_ = ls->getCurrentState();
+      }
+      const moveit::core::RobotState& current_robot_state = *current_robot_state_;
 
       // Check if the global goal is reached
       if (trajectory_operator_instance_->getTrajectoryProgress(current_robot_state) > PROGRESS_THRESHOLD)
@@ -281,8 +341,7 @@ void LocalPlannerComponent::executeIteration()
       }
 
       // Get local goal trajectory to follow
-      robot_trajectory::RobotTrajectory local_trajectory =
-          robot_trajectory::RobotTrajectory(planning_scene_monitor_->getRobotModel(), config_.group_name);
+      robot_trajectory::RobotTrajectory& local_trajectory = *local_trajectory_;
       *local_planner_feedback_ =
           trajectory_operator_instance_->getLocalTrajectory(current_robot_state, local_trajectory);
 
@@ -297,7 +356,7 @@ void LocalPlannerComponent::executeIteration()
       }
 
       // Solve local planning problem
-      trajectory_msgs::msg::JointTrajectory local_solution;
+      trajectory_msgs::msg::JointTrajectory& local_solution = local_solution_;
 
       // Feedback is only send when the hybrid planning architecture should react to a discrete event that occurred
       // while computing a local solution
@@ -358,8 +417,18 @@ void LocalPlannerComponent::reset()
 {
   local_constraint_solver_instance_->reset();
   trajectory_operator_instance_->reset();
-  timer_->cancel();
+  if (timer_)
+    timer_->cancel();
+  loop_active_ = false;
+  delete pending_global_trajectory_.exchange(nullptr);
   state_ = LocalPlannerState::AWAIT_GLOBAL_TRAJECTORY;
+
+  if (iteration_statistics_.count > 0)
+  {
+    RCLCPP_INFO(LOGGER, "Local planning took %zu iterations: mean %.3f ms, max %.3f ms, %zu overran the period",
+                iteration_statistics_.count, 1e3 * iteration_statistics_.total_duration / iteration_statistics_.count,
+                1e3 * iteration_statistics_.max_duration, iteration_statistics_.overruns);
+  }
 }
 }  // namespace moveit::hybrid_planning
 
@@ -36,6 +36,8 @@
    Description: Simple trajectory operator that samples the next global trajectory waypoint as local goal constraint
    based on the current robot state. When the waypoint is reached the index that marks the current local goal constraint
    is updated to the next global trajectory waypoint. Global trajectory updates simply replace the reference trajectory.
+   The local trajectory also contains the following waypoints up to the lookahead_waypoints horizon, so that the local
+   solver can react to collisions ahead.
  */
 
 #include <moveit/local_planner/trajectory_operator_interface.h>
@@ -65,5 +67,6 @@ private:
   moveit_msgs::action::LocalPlanner::Feedback feedback_;  // Empty feedback
   trajectory_processing::TimeOptimalTrajectoryGeneration time_parametrization_;
   const moveit::core::JointModelGroup* joint_group_;
+  std::size_t lookahead_waypoints_;  // Number of reference waypoints in the local trajectory
 };
 }  // namespace moveit::hybrid_planning
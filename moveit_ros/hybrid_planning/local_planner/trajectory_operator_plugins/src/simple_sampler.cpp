@@ -36,6 +36,8 @@
 
 #include <moveit/kinematic_constraints/utils.h>
 
+#include <algorithm>
+
 namespace moveit::hybrid_planning
 {
 namespace
@@ -44,9 +46,16 @@ const rclcpp::Logger LOGGER = rclcpp::get_logger("local_planner_component");
 constexpr double WAYPOINT_RADIAN_TOLERANCE = 0.2;  // rad: L1-norm sum for all joints
 }  // namespace
 
-bool SimpleSampler::initialize([[maybe_unused]] const rclcpp::Node::SharedPtr& node,
-                               const moveit::core::RobotModelConstPtr& robot_model, const std::string& group_name)
+bool SimpleSampler::initialize(const rclcpp::Node::SharedPtr& node, const moveit::core::RobotModelConstPtr& robot_model,
+                               const std::string& group_name)
 {
+  int lookahead_waypoints;
+  if (node->has_parameter("lookahead_waypoints"))
+    node->get_parameter<int>("lookahead_waypoints", lookahead_waypoints);
+  else
+    lookahead_waypoints = node->declare_parameter<int>("lookahead_waypoints", 1);
+  lookahead_waypoints_ = static_cast<std::size_t>(std::max(lookahead_waypoints, 1));
+
   reference_trajectory_ = std::make_shared<robot_trajectory::RobotTrajectory>(robot_model, group_name);
   next_waypoint_index_ = 0;
   joint_group_ = robot_model->getJointModelGroup(group_name);
@@ -90,7 +99,7 @@ SimpleSampler::getLocalTrajectory(const moveit::core::RobotState& current_state,
   local_trajectory.clear();
 
   // Get next desired robot state
-  const moveit::core::RobotState next_desired_goal_state = reference_trajectory_->getWayPoint(next_waypoint_index_);
+  const moveit::core::RobotState& next_desired_goal_state = reference_trajectory_->getWayPoint(next_waypoint_index_);
 
   // Check if state is reached
   if (next_desired_goal_state.distance(current_state, joint_group_) <= WAYPOINT_RADIAN_TOLERANCE)
@@ -99,9 +108,14 @@ SimpleSampler::getLocalTrajectory(const moveit::core::RobotState& current_state,
     next_waypoint_index_ = std::min(next_waypoint_index_ + 1, reference_trajectory_->getWayPointCount() - 1);
   }
 
-  // Construct local trajectory containing the next global trajectory waypoint
-  local_trajectory.addSuffixWayPoint(reference_trajectory_->getWayPoint(next_waypoint_index_),
-                                     reference_trajectory_->getWayPointDurationFromPrevious(next_waypoint_index_));
+  // Construct local trajectory containing the next global trajectory waypoints, sharing them instead of copying them
+  const std::size_t end_index =
+      std::min(next_waypoint_index_ + lookahead_waypoints_, reference_trajectory_->getWayPointCount());
+  for (std::size_t index = next_waypoint_index_; index < end_index; ++index)
+  {
+    local_trajectory.addSuffixWayPoint(reference_trajectory_->getWayPointPtr(index),
+                                       reference_trajectory_->getWayPointDurationFromPrevious(index));
+  }
 
   // Return empty feedback
   return feedback_;
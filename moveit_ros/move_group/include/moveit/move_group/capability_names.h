@@ -42,6 +42,10 @@ namespace move_group
 {
 static const std::string PLANNER_SERVICE_NAME =
     "plan_kinematic_path";  // name of the advertised service (within the ~ namespace)
+static const std::string BATCH_PLANNER_SERVICE_NAME =
+    "plan_kinematic_path_batch";  // name of the service that plans many requests concurrently
+static const std::string DISTRIBUTED_PLANNER_SERVICE_NAME =
+    "plan_kinematic_path_distributed";  // name of the service that forwards requests to planning workers
 static const std::string EXECUTE_ACTION_NAME = "execute_trajectory";  // name of 'execute' action
 static const std::string QUERY_PLANNERS_SERVICE_NAME =
     "query_planner_interface";  // name of the advertised query planners service
@@ -52,8 +56,11 @@ static const std::string SET_PLANNER_PARAMS_SERVICE_NAME =
 static const std::string MOVE_ACTION = "move_action";     // name of 'move' action
 static const std::string IK_SERVICE_NAME = "compute_ik";  // name of ik service
 static const std::string FK_SERVICE_NAME = "compute_fk";  // name of fk service
+static const std::string IK_BATCH_SERVICE_NAME = "compute_ik_batch";  // name of the service solving many ik requests
 static const std::string STATE_VALIDITY_SERVICE_NAME =
     "check_state_validity";  // name of the service that validates states
+static const std::string STATE_VALIDITY_BATCH_SERVICE_NAME =
+    "check_state_validity_batch";  // name of the service that validates many states at once
 static const std::string CARTESIAN_PATH_SERVICE_NAME =
     "compute_cartesian_path";  // name of the service that computes cartesian paths
 static const std::string GET_PLANNING_SCENE_SERVICE_NAME =
@@ -42,6 +42,8 @@
 #include <moveit/plan_execution/plan_representation.h>
 #include <moveit/move_group/move_group_context.h>
 
+#include <functional>
+
 namespace move_group
 {
 enum MoveGroupState
@@ -65,6 +67,10 @@ public:
   {
   }
 
+  /** \brief Set the context and create the callback group of this capability.
+   *
+   * The callback group is mutually exclusive unless the ROS parameter capability_max_concurrency.<name> is set to a
+   * value other than 1, in which case the callbacks of this capability may run concurrently on the executor threads. */
   void setContext(const MoveGroupContextPtr& context);
 
   virtual void initialize() = 0;
@@ -96,7 +102,14 @@ protected:
 
   planning_pipeline::PlanningPipelinePtr resolvePlanningPipeline(const std::string& pipeline_id) const;
 
+  /** \brief Call \e fn for every index in [0, \e count) on the workers of the shared task scheduler */
+  static void parallelFor(std::size_t count, const std::function<void(std::size_t)>& fn);
+
   std::string capability_name_;
   MoveGroupContextPtr context_;
+
+  // All services and actions of this capability are registered in this group, so that long running callbacks of one
+  // capability do not delay the others
+  rclcpp::CallbackGroup::SharedPtr callback_group_;
 };
 }  // namespace move_group
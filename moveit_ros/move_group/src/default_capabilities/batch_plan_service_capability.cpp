@@ -0,0 +1,196 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include "batch_plan_service_capability.h"
+
+#include <moveit/moveit_cpp/moveit_cpp.h>
+#include <moveit/planning_pipeline/planning_pipeline.h>
+#include <moveit/move_group/capability_names.h>
+#include <moveit/robot_state/conversions.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace move_group
+{
+static const rclcpp::Logger LOGGER =
+    rclcpp::get_logger("moveit_move_group_default_capabilities.batch_plan_service_capability");
+
+MoveGroupBatchPlanService::MoveGroupBatchPlanService()
+  : MoveGroupCapability("BatchMotionPlanService"), max_successes_(0), max_threads_(0)
+{
+}
+
+void MoveGroupBatchPlanService::initialize()
+{
+  const rclcpp::Node::SharedPtr& node = context_->moveit_cpp_->getNode();
+  node->get_parameter_or("batch_planning.max_successes", max_successes_, 0);
+  node->get_parameter_or("batch_planning.max_threads", max_threads_, 0);
+
+  batch_plan_service_ = node->create_service<moveit_msgs::srv::GetMotionSequence>(
+      BATCH_PLANNER_SERVICE_NAME, [this](const std::shared_ptr<rmw_request_id_t> request_header,
+                                         const std::shared_ptr<moveit_msgs::srv::GetMotionSequence::Request> req,
+                                         std::shared_ptr<moveit_msgs::srv::GetMotionSequence::Response> res) {
+        return computeBatchPlanService(request_header, req, res);
+      },
+      rmw_qos_profile_services_default, callback_group_);
+}
+
+bool MoveGroupBatchPlanService::computeBatchPlanService(
+    const std::shared_ptr<rmw_request_id_t> /* unused */,
+    const std::shared_ptr<moveit_msgs::srv::GetMotionSequence::Request> req,
+    std::shared_ptr<moveit_msgs::srv::GetMotionSequence::Response> res)
+{
+  const std::vector<moveit_msgs::msg::MotionSequenceItem>& items = req->request.items;
+  RCLCPP_INFO(LOGGER, "Received batch planning service request with %zu motion plan requests", items.size());
+  const auto start_time = std::chrono::steady_clock::now();
+  moveit_msgs::msg::MotionSequenceResponse& response = res->response;
+  response.planned_trajectories.assign(items.size(), moveit_msgs::msg::RobotTrajectory());
+  if (items.empty())
+  {
+    response.error_code.val = moveit_msgs::msg::MoveItErrorCodes::INVALID_MOTION_PLAN;
+    return true;
+  }
+
+  // Resolve all pipelines up front, the planning threads only read from this vector
+  std::vector<planning_pipeline::PlanningPipelinePtr> pipelines;
+  pipelines.reserve(items.size());
+  double allowed_planning_time = 0.0;
+  bool wait_for_current_state = false;
+  for (const moveit_msgs::msg::MotionSequenceItem& item : items)
+  {
+    pipelines.push_back(resolvePlanningPipeline(item.req.pipeline_id));
+    allowed_planning_time = std::max(allowed_planning_time, item.req.allowed_planning_time);
+    wait_for_current_state |= static_cast<bool>(item.req.start_state.is_diff);
+  }
+
+  // before we start planning, ensure that we have the latest robot state received...
+  if (wait_for_current_state)
+    context_->planning_scene_monitor_->waitForCurrentRobotState(context_->moveit_cpp_->getNode()->get_clock()->now());
+  context_->planning_scene_monitor_->updateFrameTransforms();
+
+  // All requests are planned against the same snapshot, so the scene monitor is only locked for the copy
+  planning_scene::PlanningScenePtr scene;
+  {
+    planning_scene_monitor::LockedPlanningSceneRO ps(context_->planning_scene_monitor_);
+    scene = planning_scene::PlanningScene::clone(ps);
+  }
+  moveit::core::robotStateToRobotStateMsg(scene->getCurrentState(), response.sequence_start);
+
+  const std::size_t max_successes = max_successes_ > 0 ? static_cast<std::size_t>(max_successes_) : items.size();
+  const std::size_t hardware_threads = std::max(1u, std::thread::hardware_concurrency());
+  const std::size_t thread_count =
+      std::min(items.size(), max_threads_ > 0 ? static_cast<std::size_t>(max_threads_) : hardware_threads);
+
+  std::atomic<std::size_t> next_item{ 0 };
+  std::atomic<std::size_t> success_count{ 0 };
+  std::atomic<bool> stop{ false };
+  std::mutex done_mutex;
+  std::condition_variable done_condition;
+  std::size_t finished_threads = 0;
+
+  const auto plan_items = [&]() {
+    for (std::size_t i = next_item++; i < items.size() && !stop; i = next_item++)
+    {
+      if (!pipelines[i])
+        continue;
+      try
+      {
+        planning_interface::MotionPlanResponse mp_res;
+        if (pipelines[i]->generatePlan(scene, items[i].req, mp_res) && mp_res.trajectory_)
+        {
+          mp_res.trajectory_->getRobotTrajectoryMsg(response.planned_trajectories[i]);
+          if (++success_count >= max_successes)
+            stop = true;
+        }
+      }
+      catch (std::exception& ex)
+      {
+        RCLCPP_ERROR(LOGGER, "Planning pipeline threw an exception: %s", ex.what());
+      }
+    }
+    std::scoped_lock lock(done_mutex);
+    ++finished_threads;
+    done_condition.notify_all();
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(thread_count);
+  for (std::size_t i = 0; i < thread_count; ++i)
+    threads.emplace_back(plan_items);
+
+  // Wait for all threads, but terminate running planners once enough items were solved or the deadline passed.
+  // Requests without an allowed planning time rely on the default time limit of their planner.
+  const auto deadline = start_time + std::chrono::duration<double>(allowed_planning_time);
+  bool terminate = false;
+  {
+    std::unique_lock<std::mutex> lock(done_mutex);
+    while (finished_threads < thread_count && !terminate)
+    {
+      if (allowed_planning_time > 0.0)
+        terminate = done_condition.wait_until(lock, deadline) == std::cv_status::timeout;
+      else
+        done_condition.wait(lock);
+      terminate = finished_threads < thread_count && (terminate || stop);
+    }
+  }
+  if (terminate)
+  {
+    RCLCPP_DEBUG(LOGGER, "Terminating the remaining motion plan requests");
+    stop = true;
+    for (const planning_pipeline::PlanningPipelinePtr& pipeline : pipelines)
+    {
+      if (pipeline)
+        pipeline->terminate();
+    }
+  }
+  for (std::thread& thread : threads)
+    thread.join();
+
+  response.error_code.val = success_count > 0 ? moveit_msgs::msg::MoveItErrorCodes::SUCCESS :
+                                                moveit_msgs::msg::MoveItErrorCodes::PLANNING_FAILED;
+  response.planning_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+  RCLCPP_INFO(LOGGER, "Solved %zu of %zu motion plan requests in %f seconds", success_count.load(), items.size(),
+              response.planning_time);
+  return true;
+}
+}  // namespace move_group
+
+#include <pluginlib/class_list_macros.hpp>
+
+PLUGINLIB_EXPORT_CLASS(move_group::MoveGroupBatchPlanService, move_group::MoveGroupCapability)
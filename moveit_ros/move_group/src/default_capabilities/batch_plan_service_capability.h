@@ -0,0 +1,65 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#pragma once
+
+#include <moveit/move_group/move_group_capability.h>
+#include <moveit_msgs/srv/get_motion_sequence.hpp>
+
+namespace move_group
+{
+/** \brief Plan many independent motion plan requests concurrently against one planning scene snapshot.
+ *
+ * The items of the sequence request are planned independently of each other (blend radii are ignored) and the
+ * response contains one trajectory per item, which is empty if planning that item failed. All items share the
+ * deadline given by the longest allowed planning time among them. Planning stops early once
+ * batch_planning.max_successes items were solved (0 plans all). batch_planning.max_threads bounds the number of
+ * concurrent planners (0 uses one per hardware thread). */
+class MoveGroupBatchPlanService : public MoveGroupCapability
+{
+public:
+  MoveGroupBatchPlanService();
+
+  void initialize() override;
+
+private:
+  bool computeBatchPlanService(const std::shared_ptr<rmw_request_id_t> request_header,
+                               const std::shared_ptr<moveit_msgs::srv::GetMotionSequence::Request> req,
+                               std::shared_ptr<moveit_msgs::srv::GetMotionSequence::Response> res);
+
+  rclcpp::Service<moveit_msgs::srv::GetMotionSequence>::SharedPtr batch_plan_service_;
+  int max_successes_;
+  int max_threads_;
+};
+}  // namespace move_group
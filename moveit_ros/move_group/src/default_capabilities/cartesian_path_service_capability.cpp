@@ -51,6 +51,9 @@
 #include <moveit_msgs/msg/display_trajectory.hpp>
 #include <moveit/trajectory_processing/time_optimal_trajectory_generation.h>
 
+#include <algorithm>
+#include <thread>
+
 namespace
 {
 bool isStateValid(const planning_scene::PlanningScene* planning_scene,
@@ -62,6 +65,25 @@ bool isStateValid(const planning_scene::PlanningScene* planning_scene,
   return (!planning_scene || !planning_scene->isStateColliding(*state, group->getName())) &&
          (!constraint_set || constraint_set->decide(*state).satisfied);
 }
+
+// Weight of the squared joint-space distance to the preferred posture of a variant in the IK cost
+constexpr double POSTURE_COST_WEIGHT = 0.1;
+
+struct CartesianPathVariant
+{
+  moveit::core::RobotState end_state;
+  std::vector<moveit::core::RobotStatePtr> traj;
+  double fraction = 0.0;
+  double length = 0.0;
+};
+
+double pathLength(const std::vector<moveit::core::RobotStatePtr>& traj, const moveit::core::JointModelGroup* group)
+{
+  double length = 0.0;
+  for (std::size_t i = 1; i < traj.size(); ++i)
+    length += traj[i - 1]->distance(*traj[i], group);
+  return length;
+}
 }  // namespace
 
 namespace move_group
@@ -70,12 +92,15 @@ static const rclcpp::Logger LOGGER =
     rclcpp::get_logger("moveit_move_group_default_capabilities.cartersian_path_service_capability");
 
 MoveGroupCartesianPathService::MoveGroupCartesianPathService()
-  : MoveGroupCapability("CartesianPathService"), display_computed_paths_(true)
+  : MoveGroupCapability("CartesianPathService"), display_computed_paths_(true), path_variants_(1)
 {
 }
 
 void MoveGroupCartesianPathService::initialize()
 {
+  context_->moveit_cpp_->getNode()->get_parameter_or("cartesian_path_variants", path_variants_, 1);
+  path_variants_ = std::max(path_variants_, 1);
+
   display_path_ = context_->moveit_cpp_->getNode()->create_publisher<moveit_msgs::msg::DisplayTrajectory>(
       planning_pipeline::PlanningPipeline::DISPLAY_PATH_TOPIC, 10);
 
@@ -86,7 +111,8 @@ void MoveGroupCartesianPathService::initialize()
              const std::shared_ptr<moveit_msgs::srv::GetCartesianPath::Request> req,
              std::shared_ptr<moveit_msgs::srv::GetCartesianPath::Response> res) -> bool {
         return computeService(req_id, req, res);
-      });
+      },
+      rmw_qos_profile_services_default, callback_group_);
 }
 
 bool MoveGroupCartesianPathService::computeService(const std::shared_ptr<rmw_request_id_t> /* unused */,
@@ -167,11 +193,54 @@ bool MoveGroupCartesianPathService::computeService(const std::shared_ptr<rmw_req
                       "and jump threshold %lf (in %s reference frame)",
                       (unsigned int)waypoints.size(), link_name.c_str(), req->max_step, req->jump_threshold,
                       global_frame ? "global" : "link");
-          std::vector<moveit::core::RobotStatePtr> traj;
-          res->fraction = moveit::core::CartesianInterpolator::computeCartesianPath(
-              &start_state, jmg, traj, start_state.getLinkModel(link_name), waypoints, global_frame,
-              moveit::core::MaxEEFStep(req->max_step), moveit::core::JumpThreshold(req->jump_threshold), constraint_fn);
-          moveit::core::robotStateToRobotStateMsg(start_state, res->start_state);
+          std::vector<CartesianPathVariant> variants(path_variants_, CartesianPathVariant{ start_state, {} });
+          const auto compute_variant = [&](std::size_t index) {
+            CartesianPathVariant& variant = variants[index];
+            moveit::core::MaxEEFStep max_step(req->max_step);
+            kinematics::KinematicsBase::IKCostFn cost_function;
+            if (index > 0)
+            {
+              // Finer steps keep the IK solutions on one branch more easily, and IK solvers that support cost
+              // functions resolve the redundancy towards a different random posture for every variant
+              max_step = moveit::core::MaxEEFStep(req->max_step / static_cast<double>(index + 1));
+              random_numbers::RandomNumberGenerator rng(static_cast<std::uint32_t>(index));
+              moveit::core::RobotState posture(start_state);
+              posture.setToRandomPositions(jmg, rng);
+              std::vector<double> preferred;
+              posture.copyJointGroupPositions(jmg, preferred);
+              cost_function = [preferred](const geometry_msgs::msg::Pose& /*unused*/,
+                                          const moveit::core::RobotState& solution_state,
+                                          moveit::core::JointModelGroup* group, const std::vector<double>& /*unused*/) {
+                std::vector<double> positions;
+                solution_state.copyJointGroupPositions(group, positions);
+                double cost = 0.0;
+                for (std::size_t i = 0; i < positions.size(); ++i)
+                  cost += (positions[i] - preferred[i]) * (positions[i] - preferred[i]);
+                return POSTURE_COST_WEIGHT * cost;
+              };
+            }
+            variant.fraction = moveit::core::CartesianInterpolator::computeCartesianPath(
+                &variant.end_state, jmg, variant.traj, start_state.getLinkModel(link_name), waypoints, global_frame,
+                max_step, moveit::core::JumpThreshold(req->jump_threshold), constraint_fn,
+                kinematics::KinematicsQueryOptions(), cost_function);
+            variant.length = pathLength(variant.traj, jmg);
+          };
+
+          std::vector<std::thread> threads;
+          for (std::size_t i = 1; i < variants.size(); ++i)
+            threads.emplace_back(compute_variant, i);
+          compute_variant(0);
+          for (std::thread& thread : threads)
+            thread.join();
+
+          // Prefer the variant that followed most of the path, then the shortest one in joint space
+          const CartesianPathVariant& best = *std::min_element(
+              variants.begin(), variants.end(), [](const CartesianPathVariant& a, const CartesianPathVariant& b) {
+                return a.fraction != b.fraction ? a.fraction > b.fraction : a.length < b.length;
+              });
+          const std::vector<moveit::core::RobotStatePtr>& traj = best.traj;
+          res->fraction = best.fraction;
+          moveit::core::robotStateToRobotStateMsg(best.end_state, res->start_state);
 
           robot_trajectory::RobotTrajectory rt(context_->planning_scene_monitor_->getRobotModel(), req->group_name);
           for (const moveit::core::RobotStatePtr& traj_state : traj)
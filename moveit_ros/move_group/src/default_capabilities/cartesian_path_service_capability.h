@@ -58,5 +58,7 @@ private:
   rclcpp::Publisher<moveit_msgs::msg::DisplayTrajectory>::SharedPtr display_path_;
 
   bool display_computed_paths_;
+  // Number of differently seeded Cartesian paths computed in parallel for every request
+  int path_variants_;
 };
 }  // namespace move_group
@@ -0,0 +1,306 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include "distributed_plan_service_capability.h"
+
+#include <moveit/moveit_cpp/moveit_cpp.h>
+#include <moveit/planning_pipeline/planning_pipeline.h>
+#include <moveit/move_group/capability_names.h>
+#include <moveit/robot_state/conversions.h>
+
+#include <algorithm>
+#include <set>
+
+namespace move_group
+{
+static const rclcpp::Logger LOGGER =
+    rclcpp::get_logger("moveit_move_group_default_capabilities.distributed_plan_service_capability");
+
+MoveGroupDistributedPlanService::MoveGroupDistributedPlanService()
+  : MoveGroupCapability("DistributedMotionPlanService")
+  , next_worker_(0)
+  , max_requests_per_worker_(1)
+  , timeout_margin_(1.0)
+  , retry_period_(std::chrono::seconds(5))
+  , plan_locally_(true)
+{
+}
+
+void MoveGroupDistributedPlanService::initialize()
+{
+  const rclcpp::Node::SharedPtr& node = context_->moveit_cpp_->getNode();
+  std::vector<std::string> worker_namespaces;
+  node->get_parameter_or("distributed_planning.workers", worker_namespaces, std::vector<std::string>());
+  node->get_parameter_or("distributed_planning.max_requests_per_worker", max_requests_per_worker_, 1);
+  double timeout_margin, retry_period;
+  node->get_parameter_or("distributed_planning.timeout_margin", timeout_margin, 1.0);
+  node->get_parameter_or("distributed_planning.retry_period", retry_period, 5.0);
+  node->get_parameter_or("distributed_planning.plan_locally", plan_locally_, true);
+  timeout_margin_ = std::chrono::duration<double>(timeout_margin);
+  retry_period_ =
+      std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(retry_period));
+
+  client_callback_group_ = node->create_callback_group(rclcpp::CallbackGroupType::Reentrant);
+  for (const std::string& worker_namespace : worker_namespaces)
+  {
+    auto worker = std::make_unique<Worker>();
+    worker->name = worker_namespace;
+    worker->plan_client = node->create_client<moveit_msgs::srv::GetMotionPlan>(
+        worker_namespace + "/" + PLANNER_SERVICE_NAME, rmw_qos_profile_services_default, client_callback_group_);
+    worker->scene_client = node->create_client<moveit_msgs::srv::ApplyPlanningScene>(
+        worker_namespace + "/" + APPLY_PLANNING_SCENE_SERVICE_NAME, rmw_qos_profile_services_default,
+        client_callback_group_);
+    workers_.push_back(std::move(worker));
+  }
+  if (workers_.empty())
+    RCLCPP_WARN(LOGGER, "No planning workers configured in distributed_planning.workers, all requests are planned "
+                        "locally");
+  else
+    RCLCPP_INFO(LOGGER, "Distributing motion plan requests over %zu planning workers", workers_.size());
+
+  plan_service_ = node->create_service<moveit_msgs::srv::GetMotionPlan>(
+      DISTRIBUTED_PLANNER_SERVICE_NAME, [this](const std::shared_ptr<rmw_request_id_t> request_header,
+                                               const std::shared_ptr<moveit_msgs::srv::GetMotionPlan::Request> req,
+                                               std::shared_ptr<moveit_msgs::srv::GetMotionPlan::Response> res) {
+        return computePlanService(request_header, req, res);
+      },
+      rmw_qos_profile_services_default, callback_group_);
+}
+
+MoveGroupDistributedPlanService::Worker* MoveGroupDistributedPlanService::acquireWorker()
+{
+  std::scoped_lock lock(workers_mutex_);
+  const auto now = std::chrono::steady_clock::now();
+  const std::size_t max_requests = static_cast<std::size_t>(std::max(max_requests_per_worker_, 1));
+  std::size_t best = workers_.size();
+  // start the search after the last chosen worker, so that idle workers take turns
+  for (std::size_t k = 0; k < workers_.size(); ++k)
+  {
+    const std::size_t index = (next_worker_ + k) % workers_.size();
+    Worker& worker = *workers_[index];
+    if (worker.unavailable_until > now || worker.active_requests >= max_requests)
+      continue;
+    if (!worker.plan_client->service_is_ready() || !worker.scene_client->service_is_ready())
+    {
+      RCLCPP_DEBUG(LOGGER, "Planning worker '%s' is not ready", worker.name.c_str());
+      worker.unavailable_until = now + retry_period_;
+      continue;
+    }
+    if (best == workers_.size() || worker.active_requests < workers_[best]->active_requests)
+      best = index;
+  }
+  if (best == workers_.size())
+    return nullptr;
+
+  next_worker_ = (best + 1) % workers_.size();
+  ++workers_[best]->active_requests;
+  return workers_[best].get();
+}
+
+void MoveGroupDistributedPlanService::releaseWorker(Worker* worker, bool failed)
+{
+  if (failed)
+  {
+    // the scene of the worker is unknown after a failure, so it is sent completely the next time
+    std::scoped_lock lock(worker->scene_mutex);
+    worker->scene_synchronized = false;
+  }
+  std::scoped_lock lock(workers_mutex_);
+  --worker->active_requests;
+  if (failed)
+    worker->unavailable_until = std::chrono::steady_clock::now() + retry_period_;
+}
+
+bool MoveGroupDistributedPlanService::synchronizeScene(Worker& worker, const planning_scene::PlanningScene& scene)
+{
+  std::scoped_lock lock(worker.scene_mutex);
+  const collision_detection::World& world = *scene.getWorld();
+
+  // world versions only increase, so a worker that was already sent a later version has a more recent scene
+  if (worker.scene_synchronized && world.getVersion() < worker.world_version)
+    return true;
+
+  auto request = std::make_shared<moveit_msgs::srv::ApplyPlanningScene::Request>();
+  std::set<std::string> changed_ids;
+  bool send_diff = worker.scene_synchronized && world.getChangedObjectIds(worker.world_version, changed_ids);
+  if (send_diff)
+  {
+    moveit_msgs::msg::PlanningSceneComponents components;
+    components.components = moveit_msgs::msg::PlanningSceneComponents::ALLOWED_COLLISION_MATRIX |
+                            moveit_msgs::msg::PlanningSceneComponents::TRANSFORMS;
+    scene.getPlanningSceneMsg(request->scene, components);
+    request->scene.is_diff = true;
+    for (const std::string& id : changed_ids)
+    {
+      if (id == planning_scene::PlanningScene::OCTOMAP_NS)
+      {
+        // a removed octomap can not be expressed as a diff
+        send_diff = scene.getOctomapMsg(request->scene.world.octomap);
+        if (!send_diff)
+          break;
+        continue;
+      }
+      moveit_msgs::msg::CollisionObject object;
+      if (!scene.getCollisionObjectMsg(object, id))
+      {
+        object.id = id;
+        object.operation = moveit_msgs::msg::CollisionObject::REMOVE;
+      }
+      request->scene.world.collision_objects.push_back(object);
+    }
+  }
+  if (!send_diff)
+  {
+    request->scene = moveit_msgs::msg::PlanningScene();
+    scene.getPlanningSceneMsg(request->scene);
+  }
+  RCLCPP_DEBUG(LOGGER, "Sending %s scene with %zu objects to planning worker '%s'",
+               send_diff ? "a diff of the" : "the", request->scene.world.collision_objects.size(),
+               worker.name.c_str());
+
+  auto result_future = worker.scene_client->async_send_request(request);
+  if (result_future.wait_for(timeout_margin_) == std::future_status::timeout)
+  {
+    RCLCPP_WARN(LOGGER, "Planning worker '%s' did not accept the planning scene within %f seconds",
+                worker.name.c_str(), timeout_margin_.count());
+    worker.scene_synchronized = false;
+    return false;
+  }
+  if (!result_future.get()->success)
+  {
+    RCLCPP_WARN(LOGGER, "Planning worker '%s' failed to apply the planning scene", worker.name.c_str());
+    worker.scene_synchronized = false;
+    return false;
+  }
+  worker.scene_synchronized = true;
+  worker.world_version = world.getVersion();
+  return true;
+}
+
+bool MoveGroupDistributedPlanService::planOnWorker(Worker& worker, const moveit_msgs::msg::MotionPlanRequest& request,
+                                                   moveit_msgs::msg::MotionPlanResponse& response)
+{
+  auto plan_request = std::make_shared<moveit_msgs::srv::GetMotionPlan::Request>();
+  plan_request->motion_plan_request = request;
+  auto result_future = worker.plan_client->async_send_request(plan_request);
+
+  // requests without an allowed planning time get the default time of MoveGroupInterface
+  const double planning_time = request.allowed_planning_time > 0.0 ? request.allowed_planning_time : 5.0;
+  const std::chrono::duration<double> timeout = std::chrono::duration<double>(planning_time) + timeout_margin_;
+  if (result_future.wait_for(timeout) == std::future_status::timeout)
+  {
+    RCLCPP_WARN(LOGGER, "Planning worker '%s' did not answer within %f seconds", worker.name.c_str(), timeout.count());
+    return false;
+  }
+  response = result_future.get()->motion_plan_response;
+  return true;
+}
+
+void MoveGroupDistributedPlanService::planLocally(const planning_scene::PlanningScenePtr& scene,
+                                                  const moveit_msgs::msg::MotionPlanRequest& request,
+                                                  moveit_msgs::msg::MotionPlanResponse& response)
+{
+  const planning_pipeline::PlanningPipelinePtr planning_pipeline = resolvePlanningPipeline(request.pipeline_id);
+  if (!planning_pipeline)
+  {
+    response.error_code.val = moveit_msgs::msg::MoveItErrorCodes::FAILURE;
+    return;
+  }
+  try
+  {
+    planning_interface::MotionPlanResponse mp_res;
+    planning_pipeline->generatePlan(scene, request, mp_res);
+    mp_res.getMessage(response);
+  }
+  catch (std::exception& ex)
+  {
+    RCLCPP_ERROR(LOGGER, "Planning pipeline threw an exception: %s", ex.what());
+    response.error_code.val = moveit_msgs::msg::MoveItErrorCodes::FAILURE;
+  }
+}
+
+bool MoveGroupDistributedPlanService::computePlanService(
+    const std::shared_ptr<rmw_request_id_t> /* unused */,
+    const std::shared_ptr<moveit_msgs::srv::GetMotionPlan::Request> req,
+    std::shared_ptr<moveit_msgs::srv::GetMotionPlan::Response> res)
+{
+  RCLCPP_INFO(LOGGER, "Received new distributed planning service request...");
+  // before we start planning, ensure that we have the latest robot state received...
+  if (static_cast<bool>(req->motion_plan_request.start_state.is_diff))
+    context_->planning_scene_monitor_->waitForCurrentRobotState(context_->moveit_cpp_->getNode()->get_clock()->now());
+  context_->planning_scene_monitor_->updateFrameTransforms();
+
+  // the request is planned against a copy, so the scene monitor is not locked while waiting for the workers
+  planning_scene::PlanningScenePtr scene;
+  {
+    planning_scene_monitor::LockedPlanningSceneRO ps(context_->planning_scene_monitor_);
+    scene = planning_scene::PlanningScene::clone(ps);
+  }
+
+  // workers do not monitor the robot, so they are sent the complete start state
+  moveit_msgs::msg::MotionPlanRequest request = req->motion_plan_request;
+  if (static_cast<bool>(request.start_state.is_diff))
+  {
+    moveit::core::RobotState start_state = scene->getCurrentState();
+    moveit::core::robotStateMsgToRobotState(scene->getTransforms(), request.start_state, start_state);
+    moveit::core::robotStateToRobotStateMsg(start_state, request.start_state, true);
+  }
+
+  for (Worker* worker = acquireWorker(); worker; worker = acquireWorker())
+  {
+    const bool answered =
+        synchronizeScene(*worker, *scene) && planOnWorker(*worker, request, res->motion_plan_response);
+    releaseWorker(worker, !answered);
+    if (answered)
+    {
+      RCLCPP_DEBUG(LOGGER, "Request was planned by worker '%s'", worker->name.c_str());
+      return true;
+    }
+  }
+
+  if (!plan_locally_)
+  {
+    RCLCPP_ERROR(LOGGER, "No planning worker is available");
+    res->motion_plan_response.error_code.val = moveit_msgs::msg::MoveItErrorCodes::FAILURE;
+    return true;
+  }
+  RCLCPP_DEBUG(LOGGER, "No planning worker is available, planning locally");
+  planLocally(scene, request, res->motion_plan_response);
+  return true;
+}
+}  // namespace move_group
+
+#include <pluginlib/class_list_macros.hpp>
+
+PLUGINLIB_EXPORT_CLASS(move_group::MoveGroupDistributedPlanService, move_group::MoveGroupCapability)
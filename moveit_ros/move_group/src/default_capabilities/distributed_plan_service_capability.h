@@ -0,0 +1,122 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#pragma once
+
+#include <moveit/move_group/move_group_capability.h>
+#include <moveit_msgs/srv/apply_planning_scene.hpp>
+#include <moveit_msgs/srv/get_motion_plan.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace move_group
+{
+/** \brief Forward motion plan requests to a pool of planning workers, typically on other machines.
+ *
+ * A worker is a move_group instance in its own namespace that loads the MotionPlanService and
+ * ApplyPlanningSceneService capabilities; the namespaces of its node are listed in distributed_planning.workers.
+ * Workers keep no state besides their planning scene. Before a request is forwarded, the worker receives the changes
+ * of the world since the world version it was last sent (or the complete scene if that version is no longer in the
+ * history of the world), together with the allowed collision matrix and the fixed transforms. The start state of the
+ * request is filled in from the current state, so the worker does not need to monitor the robot.
+ *
+ * Requests go to the available worker with the fewest requests in flight, at most
+ * distributed_planning.max_requests_per_worker (default 1) at a time. A worker that does not answer within the
+ * allowed planning time plus distributed_planning.timeout_margin seconds (default 1.0), or whose services are not
+ * ready, is skipped for distributed_planning.retry_period seconds (default 5.0). If no worker can take a request, it is
+ * planned locally unless distributed_planning.plan_locally is false. Waiting for workers takes an executor thread, so
+ * move_group needs at least two executor threads. */
+class MoveGroupDistributedPlanService : public MoveGroupCapability
+{
+public:
+  MoveGroupDistributedPlanService();
+
+  void initialize() override;
+
+private:
+  struct Worker
+  {
+    std::string name;
+    rclcpp::Client<moveit_msgs::srv::GetMotionPlan>::SharedPtr plan_client;
+    rclcpp::Client<moveit_msgs::srv::ApplyPlanningScene>::SharedPtr scene_client;
+
+    /// Guarded by workers_mutex_
+    std::size_t active_requests = 0;
+    std::chrono::steady_clock::time_point unavailable_until;
+
+    /// Serializes scene updates; the versions are guarded by it
+    std::mutex scene_mutex;
+    bool scene_synchronized = false;
+    std::uint64_t world_version = 0;
+  };
+
+  bool computePlanService(const std::shared_ptr<rmw_request_id_t> request_header,
+                          const std::shared_ptr<moveit_msgs::srv::GetMotionPlan::Request> req,
+                          std::shared_ptr<moveit_msgs::srv::GetMotionPlan::Response> res);
+
+  /** \brief Reserve the available worker with the fewest requests in flight, or return nullptr */
+  Worker* acquireWorker();
+
+  /** \brief Release a worker reserved by acquireWorker(), skipping it for the retry period if it \e failed */
+  void releaseWorker(Worker* worker, bool failed);
+
+  /** \brief Send the worker the parts of \e scene it does not know yet */
+  bool synchronizeScene(Worker& worker, const planning_scene::PlanningScene& scene);
+
+  /** \brief Forward \e request to the worker. Returns false if the worker did not answer in time */
+  bool planOnWorker(Worker& worker, const moveit_msgs::msg::MotionPlanRequest& request,
+                    moveit_msgs::msg::MotionPlanResponse& response);
+
+  void planLocally(const planning_scene::PlanningScenePtr& scene, const moveit_msgs::msg::MotionPlanRequest& request,
+                   moveit_msgs::msg::MotionPlanResponse& response);
+
+  rclcpp::Service<moveit_msgs::srv::GetMotionPlan>::SharedPtr plan_service_;
+
+  /// The worker clients wait for their responses on other executor threads than the service callback
+  rclcpp::CallbackGroup::SharedPtr client_callback_group_;
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::mutex workers_mutex_;
+  std::size_t next_worker_;
+
+  int max_requests_per_worker_;
+  std::chrono::duration<double> timeout_margin_;
+  std::chrono::steady_clock::duration retry_period_;
+  bool plan_locally_;
+};
+}  // namespace move_group
@@ -61,13 +61,23 @@ void MoveGroupKinematicsService::initialize()
                               const std::shared_ptr<moveit_msgs::srv::GetPositionFK::Request> req,
                               std::shared_ptr<moveit_msgs::srv::GetPositionFK::Response> res) {
         return computeFKService(req_header, req, res);
-      });
+      },
+      rmw_qos_profile_services_default, callback_group_);
   ik_service_ = context_->moveit_cpp_->getNode()->create_service<moveit_msgs::srv::GetPositionIK>(
       IK_SERVICE_NAME, [this](const std::shared_ptr<rmw_request_id_t> req_header,
                               const std::shared_ptr<moveit_msgs::srv::GetPositionIK::Request> req,
                               std::shared_ptr<moveit_msgs::srv::GetPositionIK::Response> res) {
         return computeIKService(req_header, req, res);
-      });
+      },
+      rmw_qos_profile_services_default, callback_group_);
+  ik_batch_service_ = context_->moveit_cpp_->getNode()->create_service<moveit_ros_move_group::srv::GetPositionIKBatch>(
+      IK_BATCH_SERVICE_NAME,
+      [this](const std::shared_ptr<rmw_request_id_t> req_header,
+             const std::shared_ptr<moveit_ros_move_group::srv::GetPositionIKBatch::Request> req,
+             std::shared_ptr<moveit_ros_move_group::srv::GetPositionIKBatch::Response> res) {
+        return computeIKBatchService(req_header, req, res);
+      },
+      rmw_qos_profile_services_default, callback_group_);
 }
 
 namespace
@@ -196,6 +206,39 @@ bool MoveGroupKinematicsService::computeIKService(const std::shared_ptr<rmw_requ
   return true;
 }
 
+bool MoveGroupKinematicsService::computeIKBatchService(
+    const std::shared_ptr<rmw_request_id_t> /* unused */,
+    const std::shared_ptr<moveit_ros_move_group::srv::GetPositionIKBatch::Request> req,
+    std::shared_ptr<moveit_ros_move_group::srv::GetPositionIKBatch::Response> res)
+{
+  context_->planning_scene_monitor_->updateFrameTransforms();
+
+  // All requests are solved against the same copy of the scene, so the scene monitor is only locked for the copy
+  planning_scene::PlanningScenePtr scene;
+  {
+    planning_scene_monitor::LockedPlanningSceneRO ls(context_->planning_scene_monitor_);
+    scene = planning_scene::PlanningScene::clone(ls);
+  }
+
+  res->solutions.resize(req->ik_requests.size());
+  res->error_codes.resize(req->ik_requests.size());
+  parallelFor(req->ik_requests.size(), [&](std::size_t i) {
+    moveit_msgs::msg::PositionIKRequest& ik_request = req->ik_requests[i];
+    moveit::core::RobotState rs = scene->getCurrentState();
+    kinematic_constraints::KinematicConstraintSet kset(scene->getRobotModel());
+    kset.add(ik_request.constraints, scene->getTransforms());
+    computeIK(ik_request, res->solutions[i], res->error_codes[i], rs,
+              [collision_scene = ik_request.avoid_collisions ? scene.get() : nullptr,
+               kset_ptr = kset.empty() ? nullptr : &kset](moveit::core::RobotState* robot_state,
+                                                          const moveit::core::JointModelGroup* joint_group,
+                                                          const double* joint_group_variable_values) {
+                return isIKSolutionValid(collision_scene, kset_ptr, robot_state, joint_group,
+                                         joint_group_variable_values);
+              });
+  });
+  return true;
+}
+
 bool MoveGroupKinematicsService::computeFKService(const std::shared_ptr<rmw_request_id_t> /* unused */,
                                                   const std::shared_ptr<moveit_msgs::srv::GetPositionFK::Request> req,
                                                   std::shared_ptr<moveit_msgs::srv::GetPositionFK::Response> res)
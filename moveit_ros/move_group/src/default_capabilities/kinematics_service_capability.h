@@ -39,6 +39,7 @@
 #include <moveit/move_group/move_group_capability.h>
 #include <moveit_msgs/srv/get_position_ik.hpp>
 #include <moveit_msgs/srv/get_position_fk.hpp>
+#include <moveit_ros_move_group/srv/get_position_ik_batch.hpp>
 
 namespace move_group
 {
@@ -56,6 +57,9 @@ private:
   bool computeFKService(const std::shared_ptr<rmw_request_id_t> request_header,
                         const std::shared_ptr<moveit_msgs::srv::GetPositionFK::Request> req,
                         std::shared_ptr<moveit_msgs::srv::GetPositionFK::Response> res);
+  bool computeIKBatchService(const std::shared_ptr<rmw_request_id_t> request_header,
+                             const std::shared_ptr<moveit_ros_move_group::srv::GetPositionIKBatch::Request> req,
+                             std::shared_ptr<moveit_ros_move_group::srv::GetPositionIKBatch::Response> res);
 
   void computeIK(moveit_msgs::msg::PositionIKRequest& req, moveit_msgs::msg::RobotState& solution,
                  moveit_msgs::msg::MoveItErrorCodes& error_code, moveit::core::RobotState& rs,
@@ -64,5 +68,6 @@ private:
 
   rclcpp::Service<moveit_msgs::srv::GetPositionFK>::SharedPtr fk_service_;
   rclcpp::Service<moveit_msgs::srv::GetPositionIK>::SharedPtr ik_service_;
+  rclcpp::Service<moveit_ros_move_group::srv::GetPositionIKBatch>::SharedPtr ik_batch_service_;
 };
 }  // namespace move_group
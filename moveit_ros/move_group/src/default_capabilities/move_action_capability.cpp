@@ -43,6 +43,7 @@
 #include <moveit/trajectory_processing/trajectory_tools.h>
 #include <moveit/kinematic_constraints/utils.h>
 #include <moveit/utils/message_checks.h>
+#include <moveit/utils/tracing.h>
 #include <moveit/move_group/capability_names.h>
 
 namespace move_group
@@ -69,17 +70,21 @@ void MoveGroupMoveAction::initialize()
         RCLCPP_INFO(LOGGER, "Received request to cancel goal");
         return rclcpp_action::CancelResponse::ACCEPT;
       },
-      [this](std::shared_ptr<MGActionGoal> goal) { return executeMoveCallback(goal); });
+      [this](std::shared_ptr<MGActionGoal> goal) { return executeMoveCallback(goal); },
+      rcl_action_server_get_default_options(), callback_group_);
 }
 
 void MoveGroupMoveAction::executeMoveCallback(std::shared_ptr<MGActionGoal> goal)
 {
+  MOVEIT_TRACE_SCOPE("move_group.move", goal.get());
   RCLCPP_INFO(LOGGER, "executing..");
   setMoveState(PLANNING, goal);
   // before we start planning, ensure that we have the latest robot state received...
+  MOVEIT_TRACE_STAGE_BEGIN("move_group.wait_for_state", goal.get());
   auto node = context_->moveit_cpp_->getNode();
   context_->planning_scene_monitor_->waitForCurrentRobotState(node->get_clock()->now());
   context_->planning_scene_monitor_->updateFrameTransforms();
+  MOVEIT_TRACE_STAGE_END("move_group.wait_for_state", goal.get(), true);
 
   auto action_res = std::make_shared<MGAction::Result>();
   if (goal->get_goal()->planning_options.plan_only || !context_->allow_trajectory_execution_)
@@ -206,6 +211,7 @@ void MoveGroupMoveAction::executeMoveCallbackPlanOnly(const std::shared_ptr<MGAc
     return;
   }
 
+  MOVEIT_TRACE_STAGE_BEGIN("move_group.plan", goal.get());
   try
   {
     planning_pipeline->generatePlan(the_scene, goal->get_goal()->request, res);
@@ -215,6 +221,8 @@ void MoveGroupMoveAction::executeMoveCallbackPlanOnly(const std::shared_ptr<MGAc
     RCLCPP_ERROR(LOGGER, "Planning pipeline threw an exception: %s", ex.what());
     res.error_code_.val = moveit_msgs::msg::MoveItErrorCodes::FAILURE;
   }
+  MOVEIT_TRACE_STAGE_END("move_group.plan", goal.get(),
+                         res.error_code_.val == moveit_msgs::msg::MoveItErrorCodes::SUCCESS);
 
   convertToMsg(res.trajectory_, action_res->trajectory_start, action_res->planned_trajectory);
   action_res->error_code = res.error_code_;
@@ -237,6 +245,7 @@ bool MoveGroupMoveAction::planUsingPlanningPipeline(const planning_interface::Mo
     return solved;
   }
 
+  MOVEIT_TRACE_STAGE_BEGIN("move_group.plan", &plan);
   planning_scene_monitor::LockedPlanningSceneRO lscene(plan.planning_scene_monitor_);
   try
   {
@@ -247,6 +256,7 @@ bool MoveGroupMoveAction::planUsingPlanningPipeline(const planning_interface::Mo
     RCLCPP_ERROR(LOGGER, "Planning pipeline threw an exception: %s", ex.what());
     res.error_code_.val = moveit_msgs::msg::MoveItErrorCodes::FAILURE;
   }
+  MOVEIT_TRACE_STAGE_END("move_group.plan", &plan, solved);
   if (res.trajectory_)
   {
     plan.plan_components_.resize(1);
@@ -56,7 +56,8 @@ void MoveGroupPlanService::initialize()
                                    const std::shared_ptr<moveit_msgs::srv::GetMotionPlan::Request> req,
                                    std::shared_ptr<moveit_msgs::srv::GetMotionPlan::Response> res) {
         return computePlanService(request_header, req, res);
-      });
+      },
+      rmw_qos_profile_services_default, callback_group_);
 }
 
 bool MoveGroupPlanService::computePlanService(const std::shared_ptr<rmw_request_id_t> /* unused */,
@@ -54,7 +54,17 @@ void MoveGroupStateValidationService::initialize()
                                           const std::shared_ptr<moveit_msgs::srv::GetStateValidity::Request> req,
                                           std::shared_ptr<moveit_msgs::srv::GetStateValidity::Response> res) {
         return computeService(request_header, req, res);
-      });
+      },
+      rmw_qos_profile_services_default, callback_group_);
+  validity_batch_service_ =
+      context_->moveit_cpp_->getNode()->create_service<moveit_ros_move_group::srv::GetStateValidityBatch>(
+          STATE_VALIDITY_BATCH_SERVICE_NAME,
+          [this](const std::shared_ptr<rmw_request_id_t> request_header,
+                 const std::shared_ptr<moveit_ros_move_group::srv::GetStateValidityBatch::Request> req,
+                 std::shared_ptr<moveit_ros_move_group::srv::GetStateValidityBatch::Response> res) {
+            return computeBatchService(request_header, req, res);
+          },
+          rmw_qos_profile_services_default, callback_group_);
 }
 
 bool MoveGroupStateValidationService::computeService(
@@ -127,6 +137,32 @@ bool MoveGroupStateValidationService::computeService(
 
   return true;
 }
+
+bool MoveGroupStateValidationService::computeBatchService(
+    const std::shared_ptr<rmw_request_id_t> /* unused */,
+    const std::shared_ptr<moveit_ros_move_group::srv::GetStateValidityBatch::Request> req,
+    std::shared_ptr<moveit_ros_move_group::srv::GetStateValidityBatch::Response> res)
+{
+  // All states are checked against the same copy of the scene, so the scene monitor is only locked for the copy
+  planning_scene::PlanningScenePtr scene;
+  {
+    planning_scene_monitor::LockedPlanningSceneRO ls(context_->planning_scene_monitor_);
+    scene = planning_scene::PlanningScene::clone(ls);
+  }
+
+  kinematic_constraints::KinematicConstraintSet kset(scene->getRobotModel());
+  kset.add(req->constraints, scene->getTransforms());
+
+  // std::vector<bool> cannot be written concurrently
+  std::vector<char> valid(req->robot_states.size());
+  parallelFor(req->robot_states.size(), [&](std::size_t i) {
+    moveit::core::RobotState rs = scene->getCurrentState();
+    moveit::core::robotStateMsgToRobotState(req->robot_states[i], rs);
+    valid[i] = !scene->isStateColliding(rs, req->group_name) && (kset.empty() || kset.decide(rs).satisfied);
+  });
+  res->valid.assign(valid.begin(), valid.end());
+  return true;
+}
 }  // namespace move_group
 
 #include <pluginlib/class_list_macros.hpp>
@@ -38,6 +38,7 @@
 
 #include <moveit/move_group/move_group_capability.h>
 #include <moveit_msgs/srv/get_state_validity.hpp>
+#include <moveit_ros_move_group/srv/get_state_validity_batch.hpp>
 
 namespace move_group
 {
@@ -53,6 +54,11 @@ private:
                       const std::shared_ptr<moveit_msgs::srv::GetStateValidity::Request> req,
                       std::shared_ptr<moveit_msgs::srv::GetStateValidity::Response> res);
 
+  bool computeBatchService(const std::shared_ptr<rmw_request_id_t> request_header,
+                           const std::shared_ptr<moveit_ros_move_group::srv::GetStateValidityBatch::Request> req,
+                           std::shared_ptr<moveit_ros_move_group::srv::GetStateValidityBatch::Response> res);
+
   rclcpp::Service<moveit_msgs::srv::GetStateValidity>::SharedPtr validity_service_;
+  rclcpp::Service<moveit_ros_move_group::srv::GetStateValidityBatch>::SharedPtr validity_batch_service_;
 };
 }  // namespace move_group
@@ -42,7 +42,10 @@
 #include <boost/tokenizer.hpp>
 #include <moveit/macros/console_colors.h>
 #include <moveit/move_group/move_group_context.h>
+#include <moveit/utils/startup_profile.h>
+#include <future>
 #include <memory>
+#include <mutex>
 #include <set>
 
 static const std::string ROBOT_DESCRIPTION =
@@ -117,6 +120,7 @@ public:
 private:
   void configureCapabilities()
   {
+    moveit::profiling::ScopedStartupPhase phase("move_group capabilities");
     try
     {
       capability_plugin_loader_ = std::make_shared<pluginlib::ClassLoader<MoveGroupCapability>>(
@@ -167,21 +171,38 @@ private:
         capabilities.erase(*cap_name);
     }
 
+    // the capabilities only share the context, so they are initialized concurrently. The plugin loader itself is not
+    // thread safe, only the instantiation is serialized
+    std::mutex plugin_loader_lock;
+    std::vector<std::future<MoveGroupCapabilityPtr>> initialized_capabilities;
     for (const std::string& capability : capabilities)
     {
-      try
-      {
-        printf(MOVEIT_CONSOLE_COLOR_CYAN "Loading '%s'...\n" MOVEIT_CONSOLE_COLOR_RESET, capability.c_str());
-        MoveGroupCapabilityPtr cap = capability_plugin_loader_->createUniqueInstance(capability);
-        cap->setContext(context_);
-        cap->initialize();
+      initialized_capabilities.push_back(std::async(std::launch::async, [this, &plugin_loader_lock, capability] {
+        moveit::profiling::ScopedStartupPhase phase("capability '" + capability + "'");
+        try
+        {
+          MoveGroupCapabilityPtr cap;
+          {
+            std::scoped_lock lock(plugin_loader_lock);
+            printf(MOVEIT_CONSOLE_COLOR_CYAN "Loading '%s'...\n" MOVEIT_CONSOLE_COLOR_RESET, capability.c_str());
+            cap = capability_plugin_loader_->createUniqueInstance(capability);
+          }
+          cap->setContext(context_);
+          cap->initialize();
+          return cap;
+        }
+        catch (pluginlib::PluginlibException& ex)
+        {
+          RCLCPP_ERROR_STREAM(LOGGER,
+                              "Exception while loading move_group capability '" << capability << "': " << ex.what());
+          return MoveGroupCapabilityPtr();
+        }
+      }));
+    }
+    for (std::future<MoveGroupCapabilityPtr>& initialized_capability : initialized_capabilities)
+    {
+      if (MoveGroupCapabilityPtr cap = initialized_capability.get())
         capabilities_.push_back(cap);
-      }
-      catch (pluginlib::PluginlibException& ex)
-      {
-        RCLCPP_ERROR_STREAM(LOGGER,
-                            "Exception while loading move_group capability '" << capability << "': " << ex.what());
-      }
     }
 
     std::stringstream ss;
@@ -273,7 +294,10 @@ int main(int argc, char** argv)
 
   // Initialize MoveItCpp
   const auto tf_buffer = std::make_shared<tf2_ros::Buffer>(nh->get_clock(), tf2::durationFromSec(10.0));
-  const auto moveit_cpp = std::make_shared<moveit_cpp::MoveItCpp>(nh, moveit_cpp_options, tf_buffer);
+  const auto moveit_cpp = [&] {
+    moveit::profiling::ScopedStartupPhase phase("MoveItCpp");
+    return std::make_shared<moveit_cpp::MoveItCpp>(nh, moveit_cpp_options, tf_buffer);
+  }();
   const auto planning_scene_monitor = moveit_cpp->getPlanningSceneMonitor();
 
   if (planning_scene_monitor->getPlanningScene())
@@ -291,7 +315,11 @@ int main(int argc, char** argv)
     else
       RCLCPP_INFO(LOGGER, "MoveGroup debug mode is OFF");
 
-    rclcpp::executors::MultiThreadedExecutor executor;
+    // Every capability has its own callback group, the executor threads bound how many of them run concurrently
+    int executor_threads;
+    nh->get_parameter_or("executor_threads", executor_threads, 0);
+    rclcpp::executors::MultiThreadedExecutor executor(rclcpp::ExecutorOptions(),
+                                                      static_cast<std::size_t>(std::max(executor_threads, 0)));
 
     move_group::MoveGroupExe mge(moveit_cpp, default_planning_pipeline, debug);
 
@@ -304,6 +332,9 @@ int main(int argc, char** argv)
 
     planning_scene_monitor->publishDebugInformation(debug);
 
+    // time per initialization phase, concurrent phases overlap
+    RCLCPP_INFO(LOGGER, "%s", moveit::profiling::formatStartupProfile().c_str());
+
     mge.status();
     executor.add_node(nh);
     executor.spin();
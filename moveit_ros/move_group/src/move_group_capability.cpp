@@ -37,6 +37,7 @@
 #include <moveit/moveit_cpp/moveit_cpp.h>
 #include <moveit/move_group/move_group_capability.h>
 #include <moveit/robot_state/conversions.h>
+#include <moveit/utils/task_scheduler.h>
 #if __has_include(<tf2_geometry_msgs/tf2_geometry_msgs.hpp>)
 #include <tf2_geometry_msgs/tf2_geometry_msgs.hpp>
 #else
@@ -51,6 +52,18 @@ static const rclcpp::Logger LOGGER = rclcpp::get_logger("moveit_move_group_capab
 void move_group::MoveGroupCapability::setContext(const MoveGroupContextPtr& context)
 {
   context_ = context;
+
+  const rclcpp::Node::SharedPtr& node = context_->moveit_cpp_->getNode();
+  int max_concurrency;
+  node->get_parameter_or("capability_max_concurrency." + capability_name_, max_concurrency, 1);
+  callback_group_ = node->create_callback_group(max_concurrency == 1 ? rclcpp::CallbackGroupType::MutuallyExclusive :
+                                                                       rclcpp::CallbackGroupType::Reentrant);
+}
+
+void move_group::MoveGroupCapability::parallelFor(std::size_t count, const std::function<void(std::size_t)>& fn)
+{
+  moveit::scheduling::getTaskScheduler().parallelFor(count, 0, moveit::scheduling::TaskPriority::PLANNING,
+                                                     [&fn](std::size_t /*participant*/, std::size_t i) { fn(i); });
 }
 
 void move_group::MoveGroupCapability::convertToMsg(const std::vector<plan_execution::ExecutableTrajectory>& trajectory,
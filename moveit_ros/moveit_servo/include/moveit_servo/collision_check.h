@@ -38,7 +38,11 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <memory>
 #include <mutex>
+#include <thread>
 
 #include <rclcpp/rclcpp.hpp>
 
@@ -47,10 +51,19 @@
 #include <sensor_msgs/msg/joint_state.hpp>
 #include <std_msgs/msg/float64.hpp>
 
+#include <moveit_servo/proximity_check.h>
 #include <moveit_servo/servo_parameters.h>
 
 namespace moveit_servo
 {
+/**
+ * \brief Time until the next collision check, so that the robot closes at most half of its clearance in between
+ * \param clearance distance left before a proximity threshold is breached [m]
+ * \param speed upper bound of the speed of any point of the robot [m/s]
+ * \return the period in [min_period, max_period]. min_period once the clearance is used up
+ */
+double adaptiveCollisionCheckPeriod(double clearance, double speed, double min_period, double max_period);
+
 class CollisionCheck
 {
 public:
@@ -62,24 +75,33 @@ public:
   CollisionCheck(rclcpp::Node::SharedPtr node, const ServoParameters::SharedConstPtr& parameters,
                  const planning_scene_monitor::PlanningSceneMonitorPtr& planning_scene_monitor);
 
-  ~CollisionCheck()
-  {
-    if (timer_)
-    {
-      timer_->cancel();
-    }
-  }
+  ~CollisionCheck();
 
-  /** \brief start the Timer that regulates collision check rate */
+  /**
+   * \brief start the Timer that regulates collision check rate.
+   * With adaptive_collision_check_rate, the checks run on their own thread instead
+   */
   void start();
 
   /** \brief Pause or unpause processing servo commands while keeping the timers alive */
   void setPaused(bool paused);
 
+  /** \brief The distance field based scene proximity check. nullptr unless check_collisions and use_proximity_field */
+  const std::shared_ptr<ProximityCheck>& getProximityCheck() const
+  {
+    return proximity_check_;
+  }
+
 private:
   /** \brief Run one iteration of collision checking */
   void run();
 
+  /** \brief Run the collision checks at a rate that adapts to the clearance and the joint speed */
+  void adaptiveLoop();
+
+  /** \brief Upper bound of the speed of any link origin, from the joint velocities of the current state */
+  double getMaxLinkSpeed() const;
+
   /** \brief Get a read-only copy of the planning scene */
   planning_scene_monitor::LockedPlanningSceneRO getLockedPlanningSceneRO() const;
 
@@ -113,13 +135,22 @@ private:
   const double self_velocity_scale_coefficient_;
   const double scene_velocity_scale_coefficient_;
 
+  // Scene distance estimate, which replaces the FCL scene check while the robot is far from the world
+  std::shared_ptr<ProximityCheck> proximity_check_;
+
   // collision request
   collision_detection::CollisionRequest collision_request_;
   collision_detection::CollisionResult collision_result_;
 
   // ROS
   rclcpp::TimerBase::SharedPtr timer_;
-  double period_;  // The loop period, in seconds
+  double period_;  // The loop period, in seconds. The longest period with adaptive_collision_check_rate
+
+  // Thread of the adaptive rate, woken up early by the destructor
+  std::thread thread_;
+  std::mutex thread_mutex_;
+  std::condition_variable stop_cv_;
+  bool stop_requested_ = false;
   rclcpp::Publisher<std_msgs::msg::Float64>::SharedPtr collision_velocity_scale_pub_;
   rclcpp::Subscription<std_msgs::msg::Float64>::SharedPtr worst_case_stop_time_sub_;
 
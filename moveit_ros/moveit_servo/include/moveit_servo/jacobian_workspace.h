@@ -0,0 +1,117 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#pragma once
+
+#include <array>
+
+#include <Eigen/Core>
+#include <Eigen/SVD>
+
+#include <moveit/robot_state/robot_state.h>
+
+namespace moveit_servo
+{
+/**
+ * \brief Preallocated storage for the inverse Jacobian step of servo.
+ * All matrices are sized for the group at construction, so update() and lookAheadCondition() do not allocate as
+ * long as the set of drifting dimensions stays the same between calls.
+ */
+class JacobianWorkspace
+{
+public:
+  /** \brief Size the workspace for a chain group. The Jacobian is computed at the last link of the group */
+  explicit JacobianWorkspace(const moveit::core::JointModelGroup* group);
+
+  /**
+   * \brief Compute the Jacobian of the group, drop the rows of the drifting dimensions and decompose it
+   * \param state The robot state to compute the Jacobian at
+   * \param drift_dimensions True for each of [x, y, z, roll, pitch, yaw] that is allowed to drift
+   * \param delta_x The commanded Cartesian step. The entries of drifting dimensions are dropped as well
+   * \return False if the Jacobian could not be computed
+   */
+  bool update(moveit::core::RobotState& state, const std::array<bool, 6>& drift_dimensions,
+              const Eigen::Matrix<double, 6, 1>& delta_x);
+
+  /**
+   * \brief Move the group in \e state by the joint step that realizes the Cartesian step \e direction / \e scale,
+   * and estimate the condition number of the reduced Jacobian there. Requires a prior call to update()
+   *
+   * The step is small, so the singular values at the new state are estimated to first order from the singular
+   * vectors of the last update(), i.e. sigma_i' = u_i^T J' v_i. This replaces a second SVD per servo cycle.
+   * \return The estimated condition number, or infinity if the smallest singular value would vanish
+   */
+  double lookAheadCondition(moveit::core::RobotState& state, const Eigen::VectorXd& direction, double scale);
+
+  /** \brief The Jacobian, without the rows of drifting dimensions */
+  const Eigen::MatrixXd& getJacobian() const
+  {
+    return jacobian_;
+  }
+
+  /** \brief The commanded Cartesian step, without the entries of drifting dimensions */
+  const Eigen::VectorXd& getDeltaX() const
+  {
+    return delta_x_;
+  }
+
+  const Eigen::JacobiSVD<Eigen::MatrixXd>& getSVD() const
+  {
+    return svd_;
+  }
+
+  const Eigen::MatrixXd& getPseudoInverse() const
+  {
+    return pseudo_inverse_;
+  }
+
+private:
+  const moveit::core::JointModelGroup* group_;
+  const moveit::core::LinkModel* tip_;
+
+  Eigen::MatrixXd full_jacobian_;
+  Eigen::MatrixXd jacobian_;
+  Eigen::VectorXd delta_x_;
+  Eigen::JacobiSVD<Eigen::MatrixXd> svd_;
+  Eigen::MatrixXd scaled_v_;  // V * S^-1
+  Eigen::MatrixXd pseudo_inverse_;
+
+  // Indices of the rows of the full Jacobian that were kept by the last update()
+  std::array<Eigen::Index, 6> kept_rows_;
+
+  Eigen::VectorXd look_ahead_positions_;
+  Eigen::MatrixXd look_ahead_jacobian_;
+  Eigen::VectorXd look_ahead_image_;  // J' * v_i
+};
+}  // namespace moveit_servo
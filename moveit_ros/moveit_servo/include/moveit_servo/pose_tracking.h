@@ -43,6 +43,7 @@
 #include <moveit_servo/make_shared_from_pool.h>
 #include <moveit_servo/servo_parameters.h>
 #include <moveit_servo/servo.h>
+#include <moveit_servo/target_motion.h>
 #include <optional>
 #if __has_include(<tf2_geometry_msgs/tf2_geometry_msgs.hpp>)
 #include <tf2_geometry_msgs/tf2_geometry_msgs.hpp>
@@ -121,6 +122,24 @@ public:
   /** \brief Re-initialize the target pose to an empty message. Can be used to reset motion between waypoints. */
   void resetTargetPose();
 
+  /**
+   * \brief Lookahead mode for a target that moves with a known velocity, e.g. on a conveyor.
+   * Each target pose is extrapolated with \e velocity from its stamp, and \e velocity is fed forward so that the PID
+   * controllers only correct the residual error. The twist is expressed in its header frame.
+   * \return False if the twist could not be transformed to the planning frame
+   */
+  bool setTargetVelocity(const geometry_msgs::msg::TwistStamped& velocity);
+
+  /**
+   * \brief Lookahead mode for a target with a known time-parameterized path. The waypoints replace the target pose
+   * topic until clearTargetMotion(). Their stamps must be strictly increasing.
+   * \return False if the stamps are invalid or a waypoint could not be transformed to the planning frame
+   */
+  bool setTargetTrajectory(const std::vector<geometry_msgs::msg::PoseStamped>& waypoints);
+
+  /** \brief Leave lookahead mode, only the PID controllers are used afterwards */
+  void clearTargetMotion();
+
   // moveit_servo::Servo instance. Public so we can access member functions like setPaused()
   std::unique_ptr<moveit_servo::Servo> servo_;
 
@@ -152,6 +171,19 @@ private:
   /** \brief Use PID controllers to calculate a full spatial velocity toward a pose */
   geometry_msgs::msg::TwistStamped::ConstSharedPtr calculateTwistCommand();
 
+  /**
+   * \brief The target pose in the planning frame at \e time, and its twist to feed forward. The twist is zero when
+   * not in lookahead mode. target_pose_mtx_ must be locked
+   */
+  void predictTargetPose(const rclcpp::Time& time, Eigen::Isometry3d& pose,
+                         Eigen::Matrix<double, 6, 1>& feedforward_twist) const;
+
+  /**
+   * \brief Transform from \e frame to the planning frame. The last lookup is reused for
+   * target_transform_cache_duration_ seconds, so a target stream in a static frame does not query TF every message
+   */
+  bool lookupPlanningFrameTransform(const std::string& frame, geometry_msgs::msg::TransformStamped& transform);
+
   /** \brief Reset flags and PID controllers after a motion completes */
   void doPostMotionReset();
 
@@ -192,6 +224,19 @@ private:
   std::atomic<bool> stop_requested_;
 
   std::optional<double> angular_error_;
+
+  // Lookahead mode, guarded by target_pose_mtx_
+  TargetMotion target_motion_;
+  std::optional<Eigen::Matrix<double, 6, 1>> target_velocity_;
+  // The target is evaluated this far ahead of the current time, to make up for the servo latency [s]
+  double target_lookahead_time_ = 0.0;
+
+  // Cached transform from the frame of the target to the planning frame
+  double target_transform_cache_duration_ = 0.0;
+  std::string cached_target_frame_;
+  geometry_msgs::msg::TransformStamped cached_target_transform_;
+  rclcpp::Time cached_target_transform_time_ = rclcpp::Time(0, 0, RCL_ROS_TIME);
+  std::mutex transform_cache_mtx_;
 };
 
 // using alias
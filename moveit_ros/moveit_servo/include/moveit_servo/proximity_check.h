@@ -0,0 +1,110 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <moveit/collision_detection/world.h>
+#include <moveit/distance_field/propagation_distance_field.h>
+#include <moveit/robot_state/robot_state.h>
+
+namespace moveit_servo
+{
+/**
+ * \brief Fast estimate of the distance between a move group and the world of the planning scene.
+ *
+ * The world is voxelized into a propagation distance field. updateWorld() keeps the field in sync with the scene by
+ * only adding or removing the objects that changed. Each link of the group is approximated by spheres, so
+ * getDistance() costs one field lookup per sphere and can run every servo cycle. The distance is accurate up to the
+ * field resolution, so precise collision checks are only needed once it gets small.
+ */
+class ProximityCheck
+{
+public:
+  /**
+   * \param group The links moved by this group are checked
+   * \param size Edge length of the cubic field, centered on the model frame [m]
+   * \param resolution Voxel size of the field [m]
+   * \param proximity_threshold Start decelerating when the world is this far [m]. Larger distances are saturated
+   */
+  ProximityCheck(const moveit::core::JointModelGroup* group, double size, double resolution,
+                 double proximity_threshold);
+
+  /** \brief Add the objects that are new or changed in \e world to the field, and remove the ones that are gone */
+  void updateWorld(const collision_detection::World& world);
+
+  /**
+   * \brief Smallest clearance between the link spheres of the group and the world, in [m].
+   * The link transforms of \e state must be up to date. This never blocks: while updateWorld() modifies the field,
+   * the previous distance is returned.
+   */
+  double getDistance(const moveit::core::RobotState& state);
+
+  /** \brief Velocity scale for the distance of getDistance(), decreasing exponentially below the threshold */
+  double getVelocityScale(const moveit::core::RobotState& state);
+
+  /** \brief Distances at least this large are not affected by the discretization of the field */
+  double getReliableDistance() const
+  {
+    return proximity_threshold_ + resolution_;
+  }
+
+private:
+  struct WorldObject
+  {
+    collision_detection::World::ObjectConstPtr object;
+    EigenSTL::vector_Vector3d points;
+  };
+
+  const double resolution_;
+  const double proximity_threshold_;
+  const double velocity_scale_coefficient_;
+
+  // Sphere i has its center sphere_centers_[i] in the frame of link sphere_links_[i]
+  std::vector<const moveit::core::LinkModel*> sphere_links_;
+  EigenSTL::vector_Vector3d sphere_centers_;
+  std::vector<double> sphere_radii_;
+
+  std::mutex field_mutex_;
+  distance_field::PropagationDistanceField field_;
+  // World objects in the field. World modifies objects copy-on-write, so a changed object has a new pointer
+  std::map<std::string, WorldObject> world_objects_;
+  std::atomic<double> last_distance_;
+};
+}  // namespace moveit_servo
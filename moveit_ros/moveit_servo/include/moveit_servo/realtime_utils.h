@@ -0,0 +1,277 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+#include <rclcpp/logger.hpp>
+#include <rcutils/logging.h>
+
+namespace moveit_servo
+{
+/**
+ * \brief Bounded lock-free queue for exactly one producer thread and one consumer thread.
+ * Neither push() nor pop() blocks or allocates, so the consumer can run on a real-time thread.
+ */
+template <typename T, std::size_t Capacity>
+class SPSCQueue
+{
+  static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+  /** \brief Append an element. Returns false and drops the element if the queue is full */
+  bool push(T value)
+  {
+    const std::size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_.load(std::memory_order_acquire) == Capacity)
+      return false;
+    buffer_[tail & (Capacity - 1)] = std::move(value);
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /** \brief Remove the oldest element. Returns false if the queue is empty */
+  bool pop(T& value)
+  {
+    const std::size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire))
+      return false;
+    value = std::move(buffer_[head & (Capacity - 1)]);
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /** \brief Drain the queue, keeping only the newest element. Returns false if the queue was empty */
+  bool popLatest(T& value)
+  {
+    bool popped = false;
+    while (pop(value))
+      popped = true;
+    return popped;
+  }
+
+private:
+  std::array<T, Capacity> buffer_;
+  // Producer and consumer indices live on separate cache lines to avoid false sharing
+  alignas(64) std::atomic<std::size_t> head_{ 0 };
+  alignas(64) std::atomic<std::size_t> tail_{ 0 };
+};
+
+/**
+ * \brief Wait-free slot holding the latest value, for exactly one writer thread and one reader thread.
+ * This is a triple buffer: writer and reader each own a buffer and swap it with the shared middle one, so neither
+ * waits for the other. A value the reader has not taken yet is overwritten by the next write(). Values are copied
+ * into the preallocated buffers, so this does not allocate for types like Eigen vectors of a fixed size.
+ */
+template <typename T>
+class LatestValueSlot
+{
+public:
+  explicit LatestValueSlot(const T& initial_value = T())
+  {
+    buffers_.fill(initial_value);
+  }
+
+  /** \brief Replace the latest value */
+  void write(const T& value)
+  {
+    buffers_[write_index_] = value;
+    write_index_ = middle_.exchange(write_index_ | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+  }
+
+  /** \brief Take the latest value. Returns false if nothing was written since the last read */
+  bool read(T& value)
+  {
+    if (!(middle_.load(std::memory_order_relaxed) & FRESH))
+      return false;
+    read_index_ = middle_.exchange(read_index_, std::memory_order_acq_rel) & INDEX_MASK;
+    value = buffers_[read_index_];
+    return true;
+  }
+
+private:
+  // The middle index carries a flag for a value that was written but not read yet
+  static constexpr unsigned int INDEX_MASK = 3;
+  static constexpr unsigned int FRESH = 4;
+
+  std::array<T, 3> buffers_;
+  // Writer and reader indices live on separate cache lines to avoid false sharing
+  alignas(64) unsigned int write_index_ = 0;
+  alignas(64) std::atomic<unsigned int> middle_{ 1 };
+  alignas(64) unsigned int read_index_ = 2;
+};
+
+/**
+ * \brief Throttled logger that can defer formatting output to a non real-time thread.
+ * Messages are formatted into fixed-size records, so log() never allocates. In deferred mode the records are
+ * queued and emitted by flush(), which must be called from a single other thread; otherwise they are emitted
+ * immediately. Messages are throttled per text with all digits ignored, so a message that only differs in its
+ * numbers counts as the same message. This replaces the per call site throttling of the RCLCPP_*_THROTTLE macros.
+ */
+class DeferredLogger
+{
+public:
+  using Severity = RCUTILS_LOG_SEVERITY;
+
+  DeferredLogger(const rclcpp::Logger& logger, std::chrono::nanoseconds throttle_period);
+
+  /** \brief Switch between deferred and immediate output. Must not be called while log() or flush() run */
+  void setDeferred(bool deferred)
+  {
+    deferred_ = deferred;
+  }
+
+  /** \brief Log a printf-style message. Only call from one thread */
+  void log(Severity severity, const char* format, ...) __attribute__((format(printf, 3, 4)));
+
+  /** \brief Emit all queued records. Only call from one thread, and only in deferred mode */
+  void flush();
+
+  /** \brief Number of records dropped because the queue was full */
+  std::uint64_t getDroppedCount() const
+  {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
+private:
+  struct Record
+  {
+    Severity severity;
+    char text[256];
+  };
+
+  void emit(const Record& record);
+
+  rclcpp::Logger logger_;
+  std::chrono::nanoseconds throttle_period_;
+  bool deferred_ = false;
+  SPSCQueue<Record, 64> queue_;
+  std::atomic<std::uint64_t> dropped_{ 0 };
+  // Last output time per message, only accessed by the thread emitting records
+  std::unordered_map<std::uint64_t, std::chrono::steady_clock::time_point> last_emitted_;
+};
+
+/** \brief Wake-up jitter statistics of the servo main loop, in seconds */
+struct LoopJitter
+{
+  double last = 0.0;
+  double max = 0.0;
+  double mean = 0.0;
+  std::uint64_t iterations = 0;
+  // Iterations whose computation ran past the next deadline
+  std::uint64_t overruns = 0;
+};
+
+/** \brief Stages of one servo iteration that are timed separately */
+enum class ServoStage : std::size_t
+{
+  INPUT,              // Reading the robot state and the incoming commands
+  KINEMATICS,         // Jacobian, SVD, IK and singularity scaling
+  FILTER,             // Smoothing plugin and velocity calculation
+  COLLISION_SCALING,  // Applying the collision velocity scale
+  LIMITS,             // Velocity and position limit enforcement
+  PUBLISH,            // Composing and publishing the outgoing command
+  ITERATION,          // The whole iteration
+  COUNT
+};
+
+constexpr std::size_t SERVO_STAGE_COUNT = static_cast<std::size_t>(ServoStage::COUNT);
+
+/** \brief Lower case name of a stage, e.g. "collision_scaling" */
+const char* servoStageName(ServoStage stage);
+
+/** \brief Latency percentiles of a stage, in nanoseconds. Percentiles are rounded up to their histogram bucket */
+struct LatencyStatistics
+{
+  std::uint64_t count = 0;
+  std::int64_t p50 = 0;
+  std::int64_t p99 = 0;
+  std::int64_t max = 0;
+};
+
+/**
+ * \brief Fixed-size latency histogram with four buckets per power of two, i.e. at most 25% quantization error.
+ * record() is lock-free and does not allocate. It must be called from one thread, while getStatistics() may be
+ * called from any thread.
+ */
+class LatencyHistogram
+{
+public:
+  /** \brief Add a sample, in nanoseconds. Samples beyond about four seconds fall into the last bucket */
+  void record(std::int64_t nanoseconds) noexcept;
+
+  LatencyStatistics getStatistics() const;
+
+  /** \brief Discard all samples. Must not run concurrently with record() */
+  void reset() noexcept;
+
+private:
+  static constexpr std::size_t BUCKET_COUNT = 128;
+
+  static std::size_t bucketIndex(std::uint64_t nanoseconds) noexcept;
+  static std::int64_t bucketUpperBound(std::size_t bucket) noexcept;
+
+  std::array<std::atomic<std::uint64_t>, BUCKET_COUNT> buckets_{};
+  std::atomic<std::int64_t> max_{ 0 };
+};
+
+/**
+ * \brief Records the time from construction until stop() or destruction into the histogram of a stage. When built
+ * with MOVEIT_SERVO_LTTNG_TRACEPOINTS, it also emits LTTng events when the stage begins and ends.
+ */
+class ScopedStageTimer
+{
+public:
+  ScopedStageTimer(std::array<LatencyHistogram, SERVO_STAGE_COUNT>& histograms, ServoStage stage) noexcept;
+  ~ScopedStageTimer();
+
+  /** \brief End the stage before the end of the scope. Later calls do nothing */
+  void stop() noexcept;
+
+  ScopedStageTimer(const ScopedStageTimer&) = delete;
+  ScopedStageTimer& operator=(const ScopedStageTimer&) = delete;
+
+private:
+  LatencyHistogram& histogram_;
+  ServoStage stage_;
+  std::chrono::steady_clock::time_point start_;
+  bool stopped_ = false;
+};
+}  // namespace moveit_servo
@@ -40,6 +40,7 @@
 
 // System
 #include <memory>
+#include <vector>
 
 // Moveit2
 #include <moveit_servo/collision_check.h>
@@ -57,6 +58,15 @@ public:
   Servo(const rclcpp::Node::SharedPtr& node, ServoParameters::SharedConstPtr parameters,
         planning_scene_monitor::PlanningSceneMonitorPtr planning_scene_monitor);
 
+  /**
+   * Servo several joint model groups of one robot, e.g. the arms of a dual-arm cell.
+   * The groups share the planning scene monitor and one collision check of the whole robot, which includes the
+   * collisions between the groups. All groups are calculated in the loop of the first one, so they need the same
+   * publish_period. Each group reads its commands from the topics in its own parameter namespace.
+   */
+  Servo(const rclcpp::Node::SharedPtr& node, const std::vector<ServoParameters::SharedConstPtr>& group_parameters,
+        planning_scene_monitor::PlanningSceneMonitorPtr planning_scene_monitor);
+
   ~Servo();
 
   /** \brief start servo node */
@@ -70,24 +80,50 @@ public:
    * The transform from the MoveIt planning frame to robot_link_command_frame
    *
    * @param transform the transform that will be calculated
+   * @param group index of the servoed group
    * @return true if a valid transform was available
    */
-  bool getCommandFrameTransform(Eigen::Isometry3d& transform);
-  bool getCommandFrameTransform(geometry_msgs::msg::TransformStamped& transform);
+  bool getCommandFrameTransform(Eigen::Isometry3d& transform, std::size_t group = 0);
+  bool getCommandFrameTransform(geometry_msgs::msg::TransformStamped& transform, std::size_t group = 0);
 
   /**
    * Get the End Effector link transform.
    * The transform from the MoveIt planning frame to EE link
    *
    * @param transform the transform that will be calculated
+   * @param group index of the servoed group
    * @return true if a valid transform was available
    */
-  bool getEEFrameTransform(Eigen::Isometry3d& transform);
-  bool getEEFrameTransform(geometry_msgs::msg::TransformStamped& transform);
+  bool getEEFrameTransform(Eigen::Isometry3d& transform, std::size_t group = 0);
+  bool getEEFrameTransform(geometry_msgs::msg::TransformStamped& transform, std::size_t group = 0);
+
+  /**
+   * Set a Cartesian command of \e group directly, without a message on cartesian_command_in_topic.
+   * See ServoCalcs::setTwistCommand()
+   */
+  void setTwistCommand(const Eigen::Matrix<double, 6, 1>& twist, std::size_t group = 0);
+
+  /**
+   * Set a joint command of \e group directly, without a message on joint_command_in_topic.
+   * See ServoCalcs::setJointCommand()
+   */
+  bool setJointCommand(const Eigen::VectorXd& velocities, std::size_t group = 0);
+
+  /** \brief Pass the outgoing joint commands of \e group to \e callback instead of publishing them */
+  void setCommandCallback(ServoCalcs::CommandCallback callback, std::size_t group = 0);
 
   /** \brief Get the parameters used by servo node. */
   const ServoParameters::SharedConstPtr& getParameters() const;
 
+  /** \brief Get the number of servoed joint model groups */
+  std::size_t getGroupCount() const;
+
+  /** \brief Get the wake-up jitter of the servo loop, measured since start() */
+  LoopJitter getLoopJitter() const;
+
+  /** \brief Get the latency of one stage of a servo iteration of \e group, measured since construction */
+  LatencyStatistics getLatencyStatistics(ServoStage stage, std::size_t group = 0) const;
+
   // Give test access to private/protected methods
   friend class ServoFixture;
 
@@ -95,10 +131,12 @@ private:
   // Pointer to the collision environment
   planning_scene_monitor::PlanningSceneMonitorPtr planning_scene_monitor_;
 
-  // The stored servo parameters
+  // The stored servo parameters, of the first group
   ServoParameters::SharedConstPtr parameters_;
+  std::vector<ServoParameters::SharedConstPtr> group_parameters_;
 
-  ServoCalcs servo_calcs_;
+  // One calculation per group. The first one runs the loop for all of them
+  std::vector<std::unique_ptr<ServoCalcs>> servo_calcs_;
   CollisionCheck collision_checker_;
 };
 
@@ -40,12 +40,14 @@
 
 // C++
 #include <condition_variable>
+#include <functional>
 #include <mutex>
 #include <thread>
 #include <atomic>
 
 // ROS
 #include <control_msgs/msg/joint_jog.hpp>
+#include <diagnostic_msgs/msg/diagnostic_array.hpp>
 #include <geometry_msgs/msg/twist_stamped.hpp>
 #include <moveit/planning_scene_monitor/planning_scene_monitor.h>
 #include <moveit/robot_model_loader/robot_model_loader.h>
@@ -69,6 +71,9 @@
 #include <moveit/kinematics_base/kinematics_base.h>
 
 // moveit_servo
+#include <moveit_servo/jacobian_workspace.h>
+#include <moveit_servo/proximity_check.h>
+#include <moveit_servo/realtime_utils.h>
 #include <moveit_servo/servo_parameters.h>
 #include <moveit_servo/status_codes.h>
 #include <moveit/online_signal_smoothing/smoothing_base_class.h>
@@ -84,13 +89,23 @@ enum class ServoType
 class ServoCalcs
 {
 public:
+  /** \brief Receives each outgoing joint command in place of publishing it */
+  using CommandCallback = std::function<void(const trajectory_msgs::msg::JointTrajectory&)>;
+
   ServoCalcs(rclcpp::Node::SharedPtr node, const std::shared_ptr<const moveit_servo::ServoParameters>& parameters,
              const planning_scene_monitor::PlanningSceneMonitorPtr& planning_scene_monitor);
 
   ~ServoCalcs();
 
-  /** \brief Start the timer where we do work and publish outputs */
-  void start();
+  /**
+   * Start the timer where we do work and publish outputs
+   *
+   * @param run_loop false if the iterations are run by the loop of another group, see setCombinedGroups()
+   */
+  void start(bool run_loop = true);
+
+  /** \brief Stop the currently running thread */
+  void stop();
 
   /**
    * Get the MoveIt planning link transform.
@@ -115,15 +130,78 @@ public:
   /** \brief Pause or unpause processing servo commands while keeping the timers alive */
   void setPaused(bool paused);
 
+  /** \brief Get the wake-up jitter of the main loop, measured since start() */
+  LoopJitter getLoopJitter() const;
+
+  /** \brief Get the latency of one stage of calculateSingleIteration(), measured since construction */
+  LatencyStatistics getLatencyStatistics(ServoStage stage) const;
+
+  /** \brief Also scale velocities by the scene distance of \e proximity_check, evaluated every iteration */
+  void setProximityCheck(const std::shared_ptr<ProximityCheck>& proximity_check);
+
+  /**
+   * Run one iteration of each of \e groups after every iteration of this loop, so several groups are servoed
+   * in one loop. The groups are started with start(false) and have to outlive this loop.
+   */
+  void setCombinedGroups(const std::vector<ServoCalcs*>& groups);
+
+  /**
+   * Set a Cartesian command directly, e.g. from a teleoperation loop in the same process, without a message on
+   * cartesian_command_in_topic. It is interpreted like such a message with an empty frame_id, i.e. in
+   * robot_link_command_frame and according to command_in_type. The command is handed to the servo loop through a
+   * wait-free slot, so one thread may call this at any rate. The newest command of either path is used.
+   *
+   * @param twist linear and angular command [x, y, z, roll, pitch, yaw]
+   */
+  void setTwistCommand(const Eigen::Matrix<double, 6, 1>& twist);
+
+  /**
+   * Set a joint command directly, without a message on joint_command_in_topic. See setTwistCommand()
+   *
+   * @param velocities command for each active joint of move_group_name, in the order of the joint model group
+   * @return false if the number of velocities does not match the group
+   */
+  bool setJointCommand(const Eigen::VectorXd& velocities);
+
+  /**
+   * Pass each outgoing joint command to \e callback instead of publishing it on command_out_topic.
+   * The callback runs on the servo loop thread, so it must return quickly. An empty callback publishes again.
+   */
+  void setCommandCallback(CommandCallback callback);
+
 protected:
   /** \brief Run the main calculation loop */
   void mainCalcLoop();
 
+  /** \brief Publish the stage latencies as diagnostics, from the executor rather than the main loop */
+  void publishDiagnostics();
+
+  /** \brief Run the main calculation loop on absolute deadlines of the monotonic clock (realtime_mode) */
+  void realtimeCalcLoop();
+
+  /** \brief Record the deviation of one wake-up from its deadline */
+  void recordLoopJitter(int64_t jitter_ns, bool overrun);
+
+  /** \brief Take the newest commands from the lock-free input queues (realtime_mode) */
+  void popLatestCommands();
+
+  /** \brief Pass a message to the housekeeping thread to be freed there (realtime_mode) */
+  void retireMessage(std::shared_ptr<const void> message);
+
+  /** \brief Free the retired messages. Called from the housekeeping thread */
+  void releaseRetiredMessages();
+
   /** \brief Do calculations for a single iteration. Publish one outgoing command */
   void calculateSingleIteration();
 
-  /** \brief Stop the currently running thread */
-  void stop();
+  /** \brief Do calculations for a single iteration of every combined group */
+  void calculateCombinedGroups();
+
+  /** \brief Take the newest commands of setTwistCommand() and setJointCommand() */
+  void popDirectCommands();
+
+  /** \brief Wake up a loop in low_latency_mode after a direct command */
+  void notifyDirectCommand();
 
   /** \brief Do servoing calculations for Cartesian twist commands. */
   bool cartesianServoCalcs(geometry_msgs::msg::TwistStamped& cmd,
@@ -153,7 +231,7 @@ protected:
    * Also, multiply by timestep to calculate a position change.
    * @return a vector of position deltas
    */
-  Eigen::VectorXd scaleCartesianCommand(const geometry_msgs::msg::TwistStamped& command);
+  Eigen::Matrix<double, 6, 1> scaleCartesianCommand(const geometry_msgs::msg::TwistStamped& command);
 
   /** \brief If incoming velocity commands are from a unitless joystick, scale them to physical units.
    * Also, multiply by timestep to calculate a position change.
@@ -161,6 +239,9 @@ protected:
    */
   Eigen::VectorXd scaleJointCommand(const control_msgs::msg::JointJog& command);
 
+  /** \brief Like scaleJointCommand(), but writes the position deltas into \e result without reallocating it */
+  void scaleJointCommand(const control_msgs::msg::JointJog& command, Eigen::ArrayXd& result);
+
   /** \brief Come to a halt in a smooth way. Apply a smoothing plugin, if one is configured.
    */
   void filteredHalt(trajectory_msgs::msg::JointTrajectory& joint_trajectory);
@@ -177,11 +258,10 @@ protected:
   std::vector<const moveit::core::JointModel*> enforcePositionLimits(sensor_msgs::msg::JointState& joint_state) const;
 
   /** \brief Possibly calculate a velocity scaling factor, due to proximity of
-   * singularity and direction of motion
+   * singularity and direction of motion. The look-ahead step uses the pseudo-inverse in jacobian_workspace_
    */
   double velocityScalingFactorForSingularity(const Eigen::VectorXd& commanded_velocity,
-                                             const Eigen::JacobiSVD<Eigen::MatrixXd>& svd,
-                                             const Eigen::MatrixXd& pseudo_inverse);
+                                             const Eigen::JacobiSVD<Eigen::MatrixXd>& svd);
 
   /** \brief Compose the outgoing JointTrajectory message */
   void composeJointTrajMessage(const sensor_msgs::msg::JointState& joint_state,
@@ -243,6 +323,7 @@ protected:
   /* \brief Command callbacks */
   void twistStampedCB(const geometry_msgs::msg::TwistStamped::SharedPtr msg);
   void jointCmdCB(const control_msgs::msg::JointJog::SharedPtr msg);
+  void jointStateCB(const sensor_msgs::msg::JointState::SharedPtr msg);
   void collisionVelocityScaleCB(const std_msgs::msg::Float64::SharedPtr msg);
 
   /**
@@ -319,13 +400,15 @@ protected:
   rclcpp::Publisher<trajectory_msgs::msg::JointTrajectory>::SharedPtr trajectory_outgoing_cmd_pub_;
   rclcpp::Publisher<std_msgs::msg::Float64MultiArray>::SharedPtr multiarray_outgoing_cmd_pub_;
   rclcpp::Publisher<std_msgs::msg::Float64>::SharedPtr condition_pub_;
+  rclcpp::Publisher<diagnostic_msgs::msg::DiagnosticArray>::SharedPtr diagnostics_pub_;
+  rclcpp::TimerBase::SharedPtr diagnostics_timer_;
   rclcpp::Service<moveit_msgs::srv::ChangeControlDimensions>::SharedPtr control_dimensions_server_;
   rclcpp::Service<moveit_msgs::srv::ChangeDriftDimensions>::SharedPtr drift_dimensions_server_;
   rclcpp::Service<std_srvs::srv::Empty>::SharedPtr reset_servo_status_;
 
   // Main tracking / result publisher loop
   std::thread thread_;
-  bool stop_requested_;
+  std::atomic<bool> stop_requested_;
   std::atomic<bool> done_stopping_;
 
   // Status
@@ -335,10 +418,21 @@ protected:
   bool joint_command_is_stale_ = false;
   bool ok_to_publish_ = false;
   double collision_velocity_scale_ = 1.0;
+  std::shared_ptr<ProximityCheck> proximity_check_;
+
+  // Groups whose iterations run in this loop
+  std::vector<ServoCalcs*> combined_groups_;
 
   // Use ArrayXd type to enable more coefficient-wise operations
   Eigen::ArrayXd delta_theta_;
 
+  // Workspaces sized at startup, so that an iteration does not allocate
+  std::unique_ptr<JacobianWorkspace> jacobian_workspace_;
+  Eigen::VectorXd singular_vector_;
+  std::vector<double> ik_solution_;
+  trajectory_msgs::msg::JointTrajectory joint_trajectory_;
+  std_msgs::msg::Float64MultiArray multiarray_cmd_;
+
   const int gazebo_redundant_message_count_ = 30;
 
   unsigned int num_joints_;
@@ -360,6 +454,15 @@ protected:
   bool latest_twist_cmd_is_nonzero_ = false;
   bool latest_joint_cmd_is_nonzero_ = false;
 
+  // Direct commands of the C++ API. The messages are allocated once and refilled by the main loop
+  LatestValueSlot<Eigen::Matrix<double, 6, 1>> direct_twist_slot_{ Eigen::Matrix<double, 6, 1>::Zero() };
+  std::unique_ptr<LatestValueSlot<Eigen::VectorXd>> direct_joint_slot_;
+  Eigen::Matrix<double, 6, 1> direct_twist_;
+  Eigen::VectorXd direct_joint_velocities_;
+  std::shared_ptr<geometry_msgs::msg::TwistStamped> direct_twist_cmd_;
+  std::shared_ptr<control_msgs::msg::JointJog> direct_joint_cmd_;
+  CommandCallback command_callback_;
+
   // input condition variable used for low latency mode
   std::condition_variable input_cv_;
   bool new_input_cmd_ = false;
@@ -374,5 +477,25 @@ protected:
   kinematics::KinematicsBaseConstPtr ik_solver_;
   Eigen::Isometry3d ik_base_to_tip_frame_;
   bool use_inv_jacobian_ = false;
+
+  // Realtime mode: the callbacks pass their messages through lock-free queues instead of taking main_loop_mutex_.
+  // Each queue has a single producer because the subscriptions are in the default mutually exclusive callback group
+  SPSCQueue<geometry_msgs::msg::TwistStamped::ConstSharedPtr, 16> twist_queue_;
+  SPSCQueue<control_msgs::msg::JointJog::ConstSharedPtr, 16> joint_cmd_queue_;
+  SPSCQueue<sensor_msgs::msg::JointState::ConstSharedPtr, 16> joint_state_queue_;
+  // Messages released by the main loop, freed on the housekeeping thread
+  SPSCQueue<std::shared_ptr<const void>, 64> retired_messages_;
+  // Throttled logging of the main loop, emitted by the housekeeping thread in realtime mode
+  DeferredLogger deferred_logger_;
+  std::thread housekeeping_thread_;
+
+  // Loop jitter statistics, written by the main loop and read by getLoopJitter()
+  std::atomic<double> jitter_last_{ 0.0 };
+  std::atomic<double> jitter_max_{ 0.0 };
+  std::atomic<double> jitter_mean_{ 0.0 };
+  std::atomic<std::uint64_t> loop_iterations_{ 0 };
+  // Per stage latency of calculateSingleIteration(), written by the main loop
+  std::array<LatencyHistogram, SERVO_STAGE_COUNT> latency_histograms_;
+  std::atomic<std::uint64_t> loop_overruns_{ 0 };
 };
 }  // namespace moveit_servo
@@ -99,11 +99,17 @@ struct ServoParameters
   double hard_stop_singularity_threshold{ 30.0 };
   double joint_limit_margin{ 0.1 };
   bool low_latency_mode{ false };
+  bool realtime_mode{ false };
   // Collision checking
   bool check_collisions{ true };
   double collision_check_rate{ 10.0 };
+  bool adaptive_collision_check_rate{ false };
+  double max_collision_check_rate{ 100.0 };
   double self_collision_proximity_threshold{ 0.01 };
   double scene_collision_proximity_threshold{ 0.02 };
+  bool use_proximity_field{ false };
+  double proximity_field_size{ 3.0 };
+  double proximity_field_resolution{ 0.02 };
 
   /**
    * Declares, reads, and validates parameters used for moveit_servo
@@ -0,0 +1,94 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#pragma once
+
+#include <vector>
+
+#include <Eigen/Geometry>
+#include <eigen_stl_containers/eigen_stl_vector_container.h>
+
+namespace moveit_servo
+{
+/**
+ * \brief Motion model of a moving pose tracking target, e.g. a part on a conveyor.
+ * The target either moves with a constant twist from a reference pose, or follows a time-parameterized list of
+ * waypoints. predict() gives the pose and the twist of the target at any time, so that a controller can feed the
+ * twist forward and only correct the residual error. Times are in seconds, twists are [vx, vy, vz, wx, wy, wz] in
+ * the frame of the poses.
+ */
+class TargetMotion
+{
+public:
+  /** \brief Forget the motion. predict() returns false afterwards */
+  void clear();
+
+  /** \brief The target is at \e pose at \e time, and moves with a constant \e twist */
+  void setConstantVelocity(double time, const Eigen::Isometry3d& pose, const Eigen::Matrix<double, 6, 1>& twist);
+
+  /**
+   * \brief The target follows the waypoints, interpolated linearly in position and spherically in orientation.
+   * It rests at the first waypoint before the first time and at the last waypoint after the last time.
+   * \return False, and the motion is cleared, if the sizes differ, there are no waypoints or the times are not
+   * strictly increasing
+   */
+  bool setTrajectory(const std::vector<double>& times, const EigenSTL::vector_Isometry3d& poses);
+
+  bool empty() const
+  {
+    return poses_.empty();
+  }
+
+  /** \brief True if the motion follows waypoints, false for a constant twist */
+  bool isTrajectory() const
+  {
+    return is_trajectory_;
+  }
+
+  /** \brief Time of the last waypoint, or of the reference pose for a constant twist */
+  double getEndTime() const
+  {
+    return times_.empty() ? 0.0 : times_.back();
+  }
+
+  /** \brief Pose and twist of the target at \e time. Returns false if no motion is set */
+  bool predict(double time, Eigen::Isometry3d& pose, Eigen::Matrix<double, 6, 1>& twist) const;
+
+private:
+  bool is_trajectory_ = false;
+  std::vector<double> times_;
+  EigenSTL::vector_Isometry3d poses_;
+  Eigen::Matrix<double, 6, 1> twist_ = Eigen::Matrix<double, 6, 1>::Zero();
+};
+}  // namespace moveit_servo
@@ -0,0 +1,48 @@
+from launch import LaunchDescription
+from launch.actions import DeclareLaunchArgument
+from launch.substitutions import LaunchConfiguration
+from launch_ros.actions import Node
+from moveit_configs_utils import MoveItConfigsBuilder
+from launch_param_builder import ParameterBuilder
+
+
+def generate_launch_description():
+    moveit_config = (
+        MoveItConfigsBuilder("moveit_resources_panda")
+        .robot_description(file_path="config/panda.urdf.xacro")
+        .to_moveit_configs()
+    )
+
+    # Get parameters for the Servo node
+    servo_params = {
+        "moveit_servo": ParameterBuilder("moveit_servo")
+        .yaml("config/panda_simulated_config.yaml")
+        .to_dict()
+    }
+
+    benchmark_args = [
+        DeclareLaunchArgument("duration", default_value="10.0"),
+        DeclareLaunchArgument("command_rate", default_value="100.0"),
+        DeclareLaunchArgument("joint_state_rate", default_value="500.0"),
+        DeclareLaunchArgument("use_topics", default_value="false"),
+    ]
+    benchmark_params = {
+        "benchmark." + arg.name: LaunchConfiguration(arg.name) for arg in benchmark_args
+    }
+
+    # The benchmark simulates the robot itself, so no ros2_control is needed
+    benchmark_node = Node(
+        package="moveit_servo",
+        executable="servo_benchmark",
+        output="screen",
+        parameters=[
+            servo_params,
+            benchmark_params,
+            moveit_config.robot_description,
+            moveit_config.robot_description_semantic,
+            moveit_config.robot_description_kinematics,
+            moveit_config.joint_limits,
+        ],
+    )
+
+    return LaunchDescription(benchmark_args + [benchmark_node])
@@ -37,6 +37,8 @@
  *      Author    : Brian O'Neil, Andy Zelenak, Blake Anderson
  */
 
+#include <algorithm>
+#include <chrono>
 #include <std_msgs/msg/float64.hpp>
 
 #include <moveit_servo/collision_check.h>
@@ -48,6 +50,15 @@ constexpr size_t ROS_LOG_THROTTLE_PERIOD = 30 * 1000;  // Milliseconds to thrott
 
 namespace moveit_servo
 {
+double adaptiveCollisionCheckPeriod(double clearance, double speed, double min_period, double max_period)
+{
+  if (clearance <= 0.0)
+    return min_period;
+  if (speed <= 0.0)
+    return max_period;
+  return std::clamp(0.5 * clearance / speed, min_period, max_period);
+}
+
 // Constructor for the class that handles collision checking
 CollisionCheck::CollisionCheck(rclcpp::Node::SharedPtr node, const ServoParameters::SharedConstPtr& parameters,
                                const planning_scene_monitor::PlanningSceneMonitorPtr& planning_scene_monitor)
@@ -79,6 +90,15 @@ CollisionCheck::CollisionCheck(rclcpp::Node::SharedPtr node, const ServoParamete
       [this](const std_msgs::msg::Float64::SharedPtr msg) { return worstCaseStopTimeCB(msg); });
 
   current_state_ = planning_scene_monitor_->getStateMonitor()->getCurrentState();
+
+  if (parameters_->check_collisions && parameters_->use_proximity_field)
+  {
+    const moveit::core::JointModelGroup* group =
+        planning_scene_monitor_->getRobotModel()->getJointModelGroup(parameters_->move_group_name);
+    proximity_check_ = std::make_shared<ProximityCheck>(group, parameters_->proximity_field_size,
+                                                        parameters_->proximity_field_resolution,
+                                                        parameters_->scene_collision_proximity_threshold);
+  }
 }
 
 planning_scene_monitor::LockedPlanningSceneRO CollisionCheck::getLockedPlanningSceneRO() const
@@ -86,11 +106,95 @@ planning_scene_monitor::LockedPlanningSceneRO CollisionCheck::getLockedPlanningS
   return planning_scene_monitor::LockedPlanningSceneRO(planning_scene_monitor_);
 }
 
+CollisionCheck::~CollisionCheck()
+{
+  if (timer_)
+  {
+    timer_->cancel();
+  }
+  {
+    const std::lock_guard<std::mutex> lock(thread_mutex_);
+    stop_requested_ = true;
+  }
+  stop_cv_.notify_all();
+  if (thread_.joinable())
+  {
+    thread_.join();
+  }
+}
+
 void CollisionCheck::start()
 {
+  if (parameters_->adaptive_collision_check_rate)
+  {
+    if (!thread_.joinable())
+      thread_ = std::thread([this] { adaptiveLoop(); });
+    return;
+  }
   timer_ = node_->create_wall_timer(std::chrono::duration<double>(period_), [this]() { return run(); });
 }
 
+void CollisionCheck::adaptiveLoop()
+{
+  const double min_period = 1. / parameters_->max_collision_check_rate;
+  std::unique_lock<std::mutex> lock(thread_mutex_);
+  while (rclcpp::ok() && !stop_requested_)
+  {
+    lock.unlock();
+    // The steady clock keeps the interval independent of jumps of the system time
+    const auto check_start = std::chrono::steady_clock::now();
+    run();
+
+    // Check at the longest period while paused, since the robot does not move
+    double period = period_;
+    if (!paused_)
+    {
+      const double clearance =
+          std::min(scene_collision_distance_ - parameters_->scene_collision_proximity_threshold,
+                   self_collision_distance_ - parameters_->self_collision_proximity_threshold);
+      period = collision_detected_ ? min_period :
+                                     adaptiveCollisionCheckPeriod(clearance, getMaxLinkSpeed(), min_period, period_);
+    }
+
+    lock.lock();
+    stop_cv_.wait_until(lock, check_start + std::chrono::duration<double>(period), [this] { return stop_requested_; });
+  }
+}
+
+double CollisionCheck::getMaxLinkSpeed() const
+{
+  const moveit::core::JointModelGroup* group = current_state_->getJointModelGroup(parameters_->move_group_name);
+  double speed = 0.0;
+  for (const moveit::core::JointModel* joint : group->getActiveJointModels())
+  {
+    // Without measured velocities, assume that each joint moves at its limit
+    double joint_speed = 0.0;
+    if (current_state_->hasVelocities())
+      joint_speed = std::abs(current_state_->getJointVelocities(joint)[0]);
+    else if (joint->getVariableBounds()[0].velocity_bounded_)
+      joint_speed = joint->getVariableBounds()[0].max_velocity_;
+
+    if (joint->getType() == moveit::core::JointModel::PRISMATIC)
+    {
+      speed += joint_speed;
+    }
+    else if (joint->getType() == moveit::core::JointModel::REVOLUTE)
+    {
+      // The farthest link origin driven by this joint moves fastest
+      const Eigen::Vector3d axis_point =
+          current_state_->getGlobalLinkTransform(joint->getChildLinkModel()).translation();
+      double lever_arm = 0.0;
+      for (const moveit::core::LinkModel* link : joint->getDescendantLinkModels())
+      {
+        const Eigen::Vector3d link_point = current_state_->getGlobalLinkTransform(link).translation();
+        lever_arm = std::max(lever_arm, (link_point - axis_point).norm());
+      }
+      speed += joint_speed * lever_arm;
+    }
+  }
+  return speed;
+}
+
 void CollisionCheck::run()
 {
   if (paused_)
@@ -103,13 +207,25 @@ void CollisionCheck::run()
   current_state_->updateCollisionBodyTransforms();
   collision_detected_ = false;
 
+  // The distance field is far cheaper than FCL, and only loses precision once the world is near
+  bool check_scene_collision = true;
+  if (proximity_check_)
+  {
+    proximity_check_->updateWorld(*getLockedPlanningSceneRO()->getWorld());
+    scene_collision_distance_ = proximity_check_->getDistance(*current_state_);
+    check_scene_collision = scene_collision_distance_ < proximity_check_->getReliableDistance();
+  }
+
   // Do a timer-safe distance-based collision detection
-  collision_result_.clear();
-  getLockedPlanningSceneRO()->getCollisionEnv()->checkRobotCollision(collision_request_, collision_result_,
-                                                                     *current_state_);
-  scene_collision_distance_ = collision_result_.distance;
-  collision_detected_ |= collision_result_.collision;
-  collision_result_.print();
+  if (check_scene_collision)
+  {
+    collision_result_.clear();
+    getLockedPlanningSceneRO()->getCollisionEnv()->checkRobotCollision(collision_request_, collision_result_,
+                                                                       *current_state_);
+    scene_collision_distance_ = collision_result_.distance;
+    collision_detected_ |= collision_result_.collision;
+    collision_result_.print();
+  }
 
   collision_result_.clear();
   // Self-collisions and scene collisions are checked separately so different thresholds can be used
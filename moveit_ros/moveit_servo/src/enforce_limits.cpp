@@ -47,7 +47,8 @@ namespace moveit_servo
 {
 namespace
 {
-double getVelocityScalingFactor(const moveit::core::JointModelGroup* joint_model_group, const Eigen::VectorXd& velocity)
+double getVelocityScalingFactor(const moveit::core::JointModelGroup* joint_model_group,
+                                const Eigen::Ref<const Eigen::VectorXd>& velocity)
 {
   std::size_t joint_delta_index{ 0 };
   double velocity_scaling_factor{ 1.0 };
@@ -72,9 +73,8 @@ double getVelocityScalingFactor(const moveit::core::JointModelGroup* joint_model
 void enforceVelocityLimits(const moveit::core::JointModelGroup* joint_model_group, const double publish_period,
                            sensor_msgs::msg::JointState& joint_state, const double override_velocity_scaling_factor)
 {
-  // Get the velocity scaling factor
-  Eigen::VectorXd velocity =
-      Eigen::Map<Eigen::VectorXd, Eigen::Unaligned>(joint_state.velocity.data(), joint_state.velocity.size());
+  // Get the velocity scaling factor. The maps modify the joint state in place, which avoids any allocation
+  Eigen::Map<Eigen::VectorXd, Eigen::Unaligned> velocity(joint_state.velocity.data(), joint_state.velocity.size());
   double velocity_scaling_factor = override_velocity_scaling_factor;
   // if the override velocity scaling factor is approximately zero then the user is not overriding the value.
   if (override_velocity_scaling_factor < 0.01)
@@ -83,15 +83,10 @@ void enforceVelocityLimits(const moveit::core::JointModelGroup* joint_model_grou
   // Take a smaller step if the velocity scaling factor is less than 1
   if (velocity_scaling_factor < 1)
   {
-    Eigen::VectorXd velocity_residuals = (1 - velocity_scaling_factor) * velocity;
-    Eigen::VectorXd positions =
-        Eigen::Map<Eigen::VectorXd, Eigen::Unaligned>(joint_state.position.data(), joint_state.position.size());
-    positions -= velocity_residuals * publish_period;
+    Eigen::Map<Eigen::VectorXd, Eigen::Unaligned> positions(joint_state.position.data(), joint_state.position.size());
+    positions -= ((1 - velocity_scaling_factor) * publish_period) * velocity;
 
     velocity *= velocity_scaling_factor;
-    // Back to sensor_msgs type
-    joint_state.velocity = std::vector<double>(velocity.data(), velocity.data() + velocity.size());
-    joint_state.position = std::vector<double>(positions.data(), positions.data() + positions.size());
   }
 }
 
@@ -0,0 +1,120 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <moveit_servo/jacobian_workspace.h>
+
+namespace moveit_servo
+{
+namespace
+{
+constexpr unsigned int SVD_OPTIONS = Eigen::ComputeThinU | Eigen::ComputeThinV;
+}  // namespace
+
+JacobianWorkspace::JacobianWorkspace(const moveit::core::JointModelGroup* group)
+  : group_(group)
+  , tip_(group->getLinkModels().back())
+  , full_jacobian_(6, group->getVariableCount())
+  , jacobian_(6, group->getVariableCount())
+  , delta_x_(6)
+  , svd_(6, group->getVariableCount(), SVD_OPTIONS)
+  , scaled_v_(group->getVariableCount(), 6)
+  , pseudo_inverse_(group->getVariableCount(), 6)
+  , look_ahead_positions_(group->getVariableCount())
+  , look_ahead_jacobian_(6, group->getVariableCount())
+  , look_ahead_image_(6)
+{
+}
+
+bool JacobianWorkspace::update(moveit::core::RobotState& state, const std::array<bool, 6>& drift_dimensions,
+                               const Eigen::Matrix<double, 6, 1>& delta_x)
+{
+  if (!state.getJacobian(group_, tip_, Eigen::Vector3d::Zero(), full_jacobian_))
+    return false;
+
+  // Like ServoCalcs::removeDriftDimensions(), one row is kept when every dimension drifts
+  Eigen::Index rows = 0;
+  for (bool drift : drift_dimensions)
+    rows += drift ? 0 : 1;
+  const bool all_drift = rows == 0;
+  rows = std::max<Eigen::Index>(rows, 1);
+
+  // resize() only reallocates when the number of drifting dimensions changed
+  jacobian_.resize(rows, full_jacobian_.cols());
+  delta_x_.resize(rows);
+  Eigen::Index row = 0;
+  for (Eigen::Index dimension = 0; dimension < 6; ++dimension)
+  {
+    if (drift_dimensions[dimension] && !(all_drift && dimension == 0))
+      continue;
+    jacobian_.row(row) = full_jacobian_.row(dimension);
+    delta_x_(row) = delta_x(dimension);
+    kept_rows_[row] = dimension;
+    ++row;
+  }
+
+  svd_.compute(jacobian_, SVD_OPTIONS);
+  scaled_v_.noalias() = svd_.matrixV() * svd_.singularValues().cwiseInverse().asDiagonal();
+  pseudo_inverse_.noalias() = scaled_v_ * svd_.matrixU().transpose();
+  return true;
+}
+
+double JacobianWorkspace::lookAheadCondition(moveit::core::RobotState& state, const Eigen::VectorXd& direction,
+                                             double scale)
+{
+  state.copyJointGroupPositions(group_, look_ahead_positions_);
+  look_ahead_positions_.noalias() += (1.0 / scale) * (pseudo_inverse_ * direction);
+  state.setJointGroupPositions(group_, look_ahead_positions_);
+  state.getJacobian(group_, tip_, Eigen::Vector3d::Zero(), look_ahead_jacobian_);
+
+  // First-order perturbation of the largest and smallest singular values, sigma_i' = u_i^T J' v_i, restricted to the
+  // rows kept by update() so that the estimate compares with the condition of the reduced Jacobian
+  const Eigen::Index last = jacobian_.rows() - 1;
+  const auto perturbed_singular_value = [this](Eigen::Index i) {
+    look_ahead_image_.noalias() = look_ahead_jacobian_ * svd_.matrixV().col(i);
+    double value = 0.0;
+    for (Eigen::Index row = 0; row < jacobian_.rows(); ++row)
+      value += svd_.matrixU()(row, i) * look_ahead_image_(kept_rows_[row]);
+    return value;
+  };
+  const double largest = perturbed_singular_value(0);
+  const double smallest = perturbed_singular_value(last);
+  if (smallest <= std::numeric_limits<double>::epsilon() * std::abs(largest))
+    return std::numeric_limits<double>::infinity();
+  return std::abs(largest) / smallest;
+}
+}  // namespace moveit_servo
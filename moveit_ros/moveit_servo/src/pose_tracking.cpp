@@ -219,6 +219,10 @@ void PoseTracking::readROSParams()
   declareOrGetParam(angular_pid_config_.k_p, ns + ".angular_proportional_gain", node_, LOGGER);
   declareOrGetParam(angular_pid_config_.k_i, ns + ".angular_integral_gain", node_, LOGGER);
   declareOrGetParam(angular_pid_config_.k_d, ns + ".angular_derivative_gain", node_, LOGGER);
+
+  // Lookahead mode
+  declareOrGetParam(target_lookahead_time_, ns + ".target_lookahead_time", node_, LOGGER, publish_period);
+  declareOrGetParam(target_transform_cache_duration_, ns + ".target_transform_cache_duration", node_, LOGGER, 0.0);
 }
 
 void PoseTracking::initializePID(const PIDConfig& pid_config, std::vector<control_toolbox::Pid>& pid_vector)
@@ -231,6 +235,9 @@ void PoseTracking::initializePID(const PIDConfig& pid_config, std::vector<contro
 bool PoseTracking::haveRecentTargetPose(const double timespan)
 {
   std::lock_guard<std::mutex> lock(target_pose_mtx_);
+  // A target trajectory stays valid until its last waypoint
+  if (target_motion_.isTrajectory())
+    return (node_->now().seconds() - target_motion_.getEndTime()) < timespan;
   return ((node_->now() - target_pose_.header.stamp).seconds() < timespan);
 }
 
@@ -242,9 +249,12 @@ bool PoseTracking::haveRecentEndEffectorPose(const double timespan)
 bool PoseTracking::satisfiesPoseTolerance(const Eigen::Vector3d& positional_tolerance, const double angular_tolerance)
 {
   std::lock_guard<std::mutex> lock(target_pose_mtx_);
-  double x_error = target_pose_.pose.position.x - command_frame_transform_.translation()(0);
-  double y_error = target_pose_.pose.position.y - command_frame_transform_.translation()(1);
-  double z_error = target_pose_.pose.position.z - command_frame_transform_.translation()(2);
+  Eigen::Isometry3d target_pose;
+  Eigen::Matrix<double, 6, 1> feedforward_twist;
+  predictTargetPose(node_->now(), target_pose, feedforward_twist);
+  double x_error = target_pose.translation()(0) - command_frame_transform_.translation()(0);
+  double y_error = target_pose.translation()(1) - command_frame_transform_.translation()(1);
+  double z_error = target_pose.translation()(2) - command_frame_transform_.translation()(2);
 
   // If uninitialized, likely haven't received the target pose yet.
   if (!angular_error_)
@@ -257,25 +267,127 @@ bool PoseTracking::satisfiesPoseTolerance(const Eigen::Vector3d& positional_tole
 void PoseTracking::targetPoseCallback(const geometry_msgs::msg::PoseStamped::ConstSharedPtr msg)
 {
   std::lock_guard<std::mutex> lock(target_pose_mtx_);
+  // The waypoints of a target trajectory take precedence
+  if (target_motion_.isTrajectory())
+    return;
+
   target_pose_ = *msg;
   // If the target pose is not defined in planning frame, transform the target pose.
   if (target_pose_.header.frame_id != planning_frame_)
   {
-    try
-    {
-      geometry_msgs::msg::TransformStamped target_to_planning_frame = transform_buffer_.lookupTransform(
-          planning_frame_, target_pose_.header.frame_id, rclcpp::Time(0), rclcpp::Duration(100ms));
-      tf2::doTransform(target_pose_, target_pose_, target_to_planning_frame);
+    geometry_msgs::msg::TransformStamped target_to_planning_frame;
+    if (!lookupPlanningFrameTransform(target_pose_.header.frame_id, target_to_planning_frame))
+      return;
+    tf2::doTransform(target_pose_, target_pose_, target_to_planning_frame);
 
-      // Prevent doTransform from copying a stamp of 0, which will cause the haveRecentTargetPose check to fail servo motions
-      target_pose_.header.stamp = node_->now();
-    }
-    catch (const tf2::TransformException& ex)
+    // Prevent doTransform from copying a stamp of 0, which will cause the haveRecentTargetPose check to fail servo motions
+    target_pose_.header.stamp = node_->now();
+  }
+
+  // Extrapolate the new pose with the known target velocity
+  if (target_velocity_)
+  {
+    Eigen::Isometry3d pose;
+    tf2::fromMsg(target_pose_.pose, pose);
+    target_motion_.setConstantVelocity(rclcpp::Time(target_pose_.header.stamp).seconds(), pose, *target_velocity_);
+  }
+}
+
+bool PoseTracking::lookupPlanningFrameTransform(const std::string& frame,
+                                                geometry_msgs::msg::TransformStamped& transform)
+{
+  std::lock_guard<std::mutex> lock(transform_cache_mtx_);
+  const rclcpp::Time now = node_->now();
+  if (frame == cached_target_frame_ &&
+      (now - cached_target_transform_time_).seconds() < target_transform_cache_duration_)
+  {
+    transform = cached_target_transform_;
+    return true;
+  }
+
+  try
+  {
+    transform = transform_buffer_.lookupTransform(planning_frame_, frame, rclcpp::Time(0), rclcpp::Duration(100ms));
+  }
+  catch (const tf2::TransformException& ex)
+  {
+    RCLCPP_WARN_STREAM(LOGGER, ex.what());
+    return false;
+  }
+  cached_target_frame_ = frame;
+  cached_target_transform_ = transform;
+  cached_target_transform_time_ = now;
+  return true;
+}
+
+bool PoseTracking::setTargetVelocity(const geometry_msgs::msg::TwistStamped& velocity)
+{
+  Eigen::Matrix<double, 6, 1> twist;
+  twist << velocity.twist.linear.x, velocity.twist.linear.y, velocity.twist.linear.z, velocity.twist.angular.x,
+      velocity.twist.angular.y, velocity.twist.angular.z;
+  if (velocity.header.frame_id != planning_frame_)
+  {
+    geometry_msgs::msg::TransformStamped transform;
+    if (!lookupPlanningFrameTransform(velocity.header.frame_id, transform))
+      return false;
+    const Eigen::Matrix3d rotation = tf2::transformToEigen(transform).rotation();
+    twist.head<3>() = rotation * twist.head<3>();
+    twist.tail<3>() = rotation * twist.tail<3>();
+  }
+
+  std::lock_guard<std::mutex> lock(target_pose_mtx_);
+  target_velocity_ = twist;
+  Eigen::Isometry3d pose;
+  tf2::fromMsg(target_pose_.pose, pose);
+  target_motion_.setConstantVelocity(rclcpp::Time(target_pose_.header.stamp).seconds(), pose, twist);
+  return true;
+}
+
+bool PoseTracking::setTargetTrajectory(const std::vector<geometry_msgs::msg::PoseStamped>& waypoints)
+{
+  std::vector<double> times;
+  EigenSTL::vector_Isometry3d poses;
+  times.reserve(waypoints.size());
+  poses.reserve(waypoints.size());
+  for (const geometry_msgs::msg::PoseStamped& waypoint : waypoints)
+  {
+    geometry_msgs::msg::PoseStamped waypoint_in_planning_frame = waypoint;
+    if (waypoint.header.frame_id != planning_frame_)
     {
-      RCLCPP_WARN_STREAM(LOGGER, ex.what());
-      return;
+      geometry_msgs::msg::TransformStamped transform;
+      if (!lookupPlanningFrameTransform(waypoint.header.frame_id, transform))
+        return false;
+      tf2::doTransform(waypoint, waypoint_in_planning_frame, transform);
     }
+    times.push_back(rclcpp::Time(waypoint.header.stamp).seconds());
+    poses.emplace_back();
+    tf2::fromMsg(waypoint_in_planning_frame.pose, poses.back());
   }
+
+  std::lock_guard<std::mutex> lock(target_pose_mtx_);
+  target_velocity_.reset();
+  if (!target_motion_.setTrajectory(times, poses))
+  {
+    RCLCPP_ERROR_STREAM(LOGGER, "A target trajectory needs at least one waypoint and strictly increasing stamps");
+    return false;
+  }
+  return true;
+}
+
+void PoseTracking::clearTargetMotion()
+{
+  std::lock_guard<std::mutex> lock(target_pose_mtx_);
+  target_motion_.clear();
+  target_velocity_.reset();
+}
+
+void PoseTracking::predictTargetPose(const rclcpp::Time& time, Eigen::Isometry3d& pose,
+                                     Eigen::Matrix<double, 6, 1>& feedforward_twist) const
+{
+  if (target_motion_.predict(time.seconds(), pose, feedforward_twist))
+    return;
+  tf2::fromMsg(target_pose_.pose, pose);
+  feedforward_twist.setZero();
 }
 
 geometry_msgs::msg::TwistStamped::ConstSharedPtr PoseTracking::calculateTwistCommand()
@@ -286,28 +398,39 @@ geometry_msgs::msg::TwistStamped::ConstSharedPtr PoseTracking::calculateTwistCom
   // Get twist components from PID controllers
   geometry_msgs::msg::Twist& twist = msg->twist;
   Eigen::Quaterniond q_desired;
+  Eigen::Isometry3d target_pose;
+  Eigen::Matrix<double, 6, 1> feedforward_twist;
 
   // Scope mutex locking only to operations which require access to target pose.
   {
     std::lock_guard<std::mutex> lock(target_pose_mtx_);
-    msg->header.frame_id = target_pose_.header.frame_id;
+    msg->header.frame_id = target_motion_.empty() ? target_pose_.header.frame_id : planning_frame_;
 
-    // Position
-    twist.linear.x = cartesian_position_pids_[0].computeCommand(
-        target_pose_.pose.position.x - command_frame_transform_.translation()(0), loop_rate_.period().count());
-    twist.linear.y = cartesian_position_pids_[1].computeCommand(
-        target_pose_.pose.position.y - command_frame_transform_.translation()(1), loop_rate_.period().count());
-    twist.linear.z = cartesian_position_pids_[2].computeCommand(
-        target_pose_.pose.position.z - command_frame_transform_.translation()(2), loop_rate_.period().count());
-
-    // Orientation algorithm:
-    // - Find the orientation error as a quaternion: q_error = q_desired * q_current ^ -1
-    // - Use the angle-axis PID controller to calculate an angular rate
-    // - Convert to angular velocity for the TwistStamped message
-    q_desired = Eigen::Quaterniond(target_pose_.pose.orientation.w, target_pose_.pose.orientation.x,
-                                   target_pose_.pose.orientation.y, target_pose_.pose.orientation.z);
+    // In lookahead mode, aim at where the target will be when servo executes the command
+    const double lookahead_time = target_motion_.empty() ? 0.0 : target_lookahead_time_;
+    predictTargetPose(node_->now() + rclcpp::Duration::from_seconds(lookahead_time), target_pose, feedforward_twist);
   }
 
+  // Position. The PID controllers only correct the error that remains after the feedforward twist
+  twist.linear.x = cartesian_position_pids_[0].computeCommand(
+                       target_pose.translation()(0) - command_frame_transform_.translation()(0),
+                       loop_rate_.period().count()) +
+                   feedforward_twist(0);
+  twist.linear.y = cartesian_position_pids_[1].computeCommand(
+                       target_pose.translation()(1) - command_frame_transform_.translation()(1),
+                       loop_rate_.period().count()) +
+                   feedforward_twist(1);
+  twist.linear.z = cartesian_position_pids_[2].computeCommand(
+                       target_pose.translation()(2) - command_frame_transform_.translation()(2),
+                       loop_rate_.period().count()) +
+                   feedforward_twist(2);
+
+  // Orientation algorithm:
+  // - Find the orientation error as a quaternion: q_error = q_desired * q_current ^ -1
+  // - Use the angle-axis PID controller to calculate an angular rate
+  // - Convert to angular velocity for the TwistStamped message
+  q_desired = Eigen::Quaterniond(target_pose.rotation());
+
   Eigen::Quaterniond q_current(command_frame_transform_.rotation());
   Eigen::Quaterniond q_error = q_desired * q_current.inverse();
 
@@ -318,9 +441,9 @@ geometry_msgs::msg::TwistStamped::ConstSharedPtr PoseTracking::calculateTwistCom
 
   double ang_vel_magnitude =
       cartesian_orientation_pids_[0].computeCommand(*angular_error_, loop_rate_.period().count());
-  twist.angular.x = ang_vel_magnitude * axis_angle.axis()[0];
-  twist.angular.y = ang_vel_magnitude * axis_angle.axis()[1];
-  twist.angular.z = ang_vel_magnitude * axis_angle.axis()[2];
+  twist.angular.x = ang_vel_magnitude * axis_angle.axis()[0] + feedforward_twist(3);
+  twist.angular.y = ang_vel_magnitude * axis_angle.axis()[1] + feedforward_twist(4);
+  twist.angular.z = ang_vel_magnitude * axis_angle.axis()[2] + feedforward_twist(5);
 
   msg->header.stamp = node_->now();
 
@@ -0,0 +1,132 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <algorithm>
+#include <cmath>
+
+#include <moveit/collision_distance_field/collision_distance_field_types.h>
+#include <moveit_servo/proximity_check.h>
+
+namespace moveit_servo
+{
+ProximityCheck::ProximityCheck(const moveit::core::JointModelGroup* group, double size, double resolution,
+                               double proximity_threshold)
+  : resolution_(resolution)
+  , proximity_threshold_(proximity_threshold)
+  , velocity_scale_coefficient_(-std::log(0.001) / proximity_threshold)
+  , field_(size, size, size, resolution, -0.5 * size, -0.5 * size, -0.5 * size, proximity_threshold + 2 * resolution)
+  , last_distance_(proximity_threshold + 2 * resolution)
+{
+  // Approximate the collision geometry of every link that the group moves by spheres
+  for (const moveit::core::LinkModel* link : group->getUpdatedLinkModelsWithGeometry())
+  {
+    collision_detection::BodyDecomposition decomposition(link->getShapes(), link->getCollisionOriginTransforms(),
+                                                         resolution, 0.0);
+    for (const collision_detection::CollisionSphere& sphere : decomposition.getCollisionSpheres())
+    {
+      sphere_links_.push_back(link);
+      sphere_centers_.push_back(sphere.relative_vec_);
+      sphere_radii_.push_back(sphere.radius_);
+    }
+  }
+}
+
+void ProximityCheck::updateWorld(const collision_detection::World& world)
+{
+  const std::lock_guard<std::mutex> lock(field_mutex_);
+
+  // Remove the objects that are gone or changed
+  bool removed = false;
+  for (auto it = world_objects_.begin(); it != world_objects_.end();)
+  {
+    if (world.getObject(it->first) == it->second.object)
+    {
+      ++it;
+      continue;
+    }
+    field_.removePointsFromField(it->second.points);
+    it = world_objects_.erase(it);
+    removed = true;
+  }
+  // Voxels shared with a removed object were cleared as well
+  if (removed)
+  {
+    for (const auto& world_object : world_objects_)
+      field_.addPointsToField(world_object.second.points);
+  }
+
+  // Add the new and changed objects
+  EigenSTL::vector_Vector3d shape_points;
+  for (const auto& object : world)
+  {
+    if (world_objects_.count(object.first))
+      continue;
+    WorldObject& world_object = world_objects_[object.first];
+    world_object.object = object.second;
+    for (std::size_t i = 0; i < object.second->shapes_.size(); ++i)
+    {
+      shape_points.clear();
+      field_.getShapePoints(object.second->shapes_[i].get(), object.second->global_shape_poses_[i], &shape_points);
+      world_object.points.insert(world_object.points.end(), shape_points.begin(), shape_points.end());
+    }
+    field_.addPointsToField(world_object.points);
+  }
+}
+
+double ProximityCheck::getDistance(const moveit::core::RobotState& state)
+{
+  std::unique_lock<std::mutex> lock(field_mutex_, std::try_to_lock);
+  if (!lock.owns_lock())
+    return last_distance_.load();
+
+  // Outside of the field and beyond the maximum distance, getDistance() returns the maximum distance
+  double distance = field_.getUninitializedDistance();
+  for (std::size_t i = 0; i < sphere_centers_.size(); ++i)
+  {
+    const Eigen::Vector3d center = state.getGlobalLinkTransform(sphere_links_[i]) * sphere_centers_[i];
+    distance = std::min(distance, field_.getDistance(center.x(), center.y(), center.z()) - sphere_radii_[i]);
+  }
+  last_distance_.store(distance);
+  return distance;
+}
+
+double ProximityCheck::getVelocityScale(const moveit::core::RobotState& state)
+{
+  const double distance = getDistance(state);
+  if (distance >= proximity_threshold_)
+    return 1.0;
+  // Same profile as CollisionCheck: 1 at the threshold, 0.001 when in contact
+  return std::exp(velocity_scale_coefficient_ * (distance - proximity_threshold_));
+}
+}  // namespace moveit_servo
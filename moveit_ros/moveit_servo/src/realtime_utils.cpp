@@ -0,0 +1,232 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+
+#include <rclcpp/logging.hpp>
+
+#include <moveit_servo/realtime_utils.h>
+
+#ifdef MOVEIT_SERVO_LTTNG_TRACEPOINTS
+#include <lttng/tracef.h>
+#define MOVEIT_SERVO_TRACE_STAGE(stage, event) tracef("moveit_servo:%s:%s", servoStageName(stage), event)
+#else
+#define MOVEIT_SERVO_TRACE_STAGE(stage, event) static_cast<void>(stage)
+#endif
+
+namespace moveit_servo
+{
+DeferredLogger::DeferredLogger(const rclcpp::Logger& logger, std::chrono::nanoseconds throttle_period)
+  : logger_(logger), throttle_period_(throttle_period)
+{
+}
+
+void DeferredLogger::log(Severity severity, const char* format, ...)
+{
+  Record record;
+  record.severity = severity;
+  va_list args;
+  va_start(args, format);
+  std::vsnprintf(record.text, sizeof(record.text), format, args);
+  va_end(args);
+
+  if (!deferred_)
+    emit(record);
+  else if (!queue_.push(record))
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void DeferredLogger::flush()
+{
+  Record record;
+  while (queue_.pop(record))
+    emit(record);
+}
+
+void DeferredLogger::emit(const Record& record)
+{
+  // FNV-1a hash of the text without digits
+  std::uint64_t key = 14695981039346656037ull;
+  for (const char* c = record.text; *c != '\0'; ++c)
+  {
+    if (*c < '0' || *c > '9')
+      key = (key ^ static_cast<unsigned char>(*c)) * 1099511628211ull;
+  }
+
+  const auto now = std::chrono::steady_clock::now();
+  auto [it, inserted] = last_emitted_.emplace(key, now);
+  if (!inserted)
+  {
+    if (now - it->second < throttle_period_)
+      return;
+    it->second = now;
+  }
+
+  switch (record.severity)
+  {
+    case RCUTILS_LOG_SEVERITY_DEBUG:
+      RCLCPP_DEBUG(logger_, "%s", record.text);
+      break;
+    case RCUTILS_LOG_SEVERITY_INFO:
+      RCLCPP_INFO(logger_, "%s", record.text);
+      break;
+    case RCUTILS_LOG_SEVERITY_WARN:
+      RCLCPP_WARN(logger_, "%s", record.text);
+      break;
+    case RCUTILS_LOG_SEVERITY_ERROR:
+      RCLCPP_ERROR(logger_, "%s", record.text);
+      break;
+    default:
+      RCLCPP_FATAL(logger_, "%s", record.text);
+      break;
+  }
+}
+
+const char* servoStageName(ServoStage stage)
+{
+  switch (stage)
+  {
+    case ServoStage::INPUT:
+      return "input";
+    case ServoStage::KINEMATICS:
+      return "kinematics";
+    case ServoStage::FILTER:
+      return "filter";
+    case ServoStage::COLLISION_SCALING:
+      return "collision_scaling";
+    case ServoStage::LIMITS:
+      return "limits";
+    case ServoStage::PUBLISH:
+      return "publish";
+    case ServoStage::ITERATION:
+      return "iteration";
+    default:
+      return "unknown";
+  }
+}
+
+std::size_t LatencyHistogram::bucketIndex(std::uint64_t nanoseconds) noexcept
+{
+  // Values below 4 have a bucket each. Above, bucket 4 * (msb - 1) + sub holds the values whose most significant
+  // bit is msb and whose next two bits are sub
+  if (nanoseconds < 4)
+    return nanoseconds;
+  const std::size_t msb = 63 - __builtin_clzll(nanoseconds);
+  const std::size_t sub = (nanoseconds >> (msb - 2)) & 3;
+  return std::min(4 * (msb - 1) + sub, BUCKET_COUNT - 1);
+}
+
+std::int64_t LatencyHistogram::bucketUpperBound(std::size_t bucket) noexcept
+{
+  if (bucket < 4)
+    return static_cast<std::int64_t>(bucket);
+  const std::size_t shift = bucket / 4 - 1;
+  const std::int64_t lower = static_cast<std::int64_t>(4 + bucket % 4) << shift;
+  return lower + (std::int64_t{ 1 } << shift) - 1;
+}
+
+void LatencyHistogram::record(std::int64_t nanoseconds) noexcept
+{
+  const std::uint64_t sample = nanoseconds > 0 ? static_cast<std::uint64_t>(nanoseconds) : 0;
+  buckets_[bucketIndex(sample)].fetch_add(1, std::memory_order_relaxed);
+  if (nanoseconds > max_.load(std::memory_order_relaxed))
+    max_.store(nanoseconds, std::memory_order_relaxed);
+}
+
+LatencyStatistics LatencyHistogram::getStatistics() const
+{
+  LatencyStatistics statistics;
+  std::array<std::uint64_t, BUCKET_COUNT> counts;
+  for (std::size_t i = 0; i < BUCKET_COUNT; ++i)
+  {
+    counts[i] = buckets_[i].load(std::memory_order_relaxed);
+    statistics.count += counts[i];
+  }
+  statistics.max = max_.load(std::memory_order_relaxed);
+  if (statistics.count == 0)
+    return statistics;
+
+  // Smallest buckets that hold at least 50% and 99% of the samples
+  const std::uint64_t p50_rank = (statistics.count + 1) / 2;
+  const std::uint64_t p99_rank = statistics.count - statistics.count / 100;
+  std::uint64_t cumulative = 0;
+  for (std::size_t i = 0; i < BUCKET_COUNT; ++i)
+  {
+    const std::uint64_t previous = cumulative;
+    cumulative += counts[i];
+    if (previous < p50_rank && cumulative >= p50_rank)
+      statistics.p50 = bucketUpperBound(i);
+    if (previous < p99_rank && cumulative >= p99_rank)
+    {
+      statistics.p99 = bucketUpperBound(i);
+      break;
+    }
+  }
+  // The bucket bound can exceed the largest sample
+  statistics.p50 = std::min(statistics.p50, statistics.max);
+  statistics.p99 = std::min(statistics.p99, statistics.max);
+  return statistics;
+}
+
+void LatencyHistogram::reset() noexcept
+{
+  for (auto& bucket : buckets_)
+    bucket.store(0, std::memory_order_relaxed);
+  max_.store(0, std::memory_order_relaxed);
+}
+
+ScopedStageTimer::ScopedStageTimer(std::array<LatencyHistogram, SERVO_STAGE_COUNT>& histograms,
+                                   ServoStage stage) noexcept
+  : histogram_(histograms[static_cast<std::size_t>(stage)]), stage_(stage), start_(std::chrono::steady_clock::now())
+{
+  MOVEIT_SERVO_TRACE_STAGE(stage_, "begin");
+}
+
+ScopedStageTimer::~ScopedStageTimer()
+{
+  stop();
+}
+
+void ScopedStageTimer::stop() noexcept
+{
+  if (stopped_)
+    return;
+  stopped_ = true;
+  histogram_.record(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_)
+                        .count());
+  MOVEIT_SERVO_TRACE_STAGE(stage_, "end");
+}
+}  // namespace moveit_servo
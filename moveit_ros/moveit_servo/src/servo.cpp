@@ -50,26 +50,62 @@ constexpr double ROBOT_STATE_WAIT_TIME = 10.0;  // seconds
 
 Servo::Servo(const rclcpp::Node::SharedPtr& node, ServoParameters::SharedConstPtr parameters,
              planning_scene_monitor::PlanningSceneMonitorPtr planning_scene_monitor)
+  : Servo(node, std::vector<ServoParameters::SharedConstPtr>{ parameters }, planning_scene_monitor)
+{
+}
+
+Servo::Servo(const rclcpp::Node::SharedPtr& node, const std::vector<ServoParameters::SharedConstPtr>& group_parameters,
+             planning_scene_monitor::PlanningSceneMonitorPtr planning_scene_monitor)
   : planning_scene_monitor_{ planning_scene_monitor }
-  , parameters_{ parameters }
-  , servo_calcs_{ node, parameters, planning_scene_monitor_ }
-  , collision_checker_{ node, parameters, planning_scene_monitor_ }
+  , parameters_{ group_parameters.at(0) }
+  , group_parameters_{ group_parameters }
+  , collision_checker_{ node, parameters_, planning_scene_monitor_ }
 {
+  for (const ServoParameters::SharedConstPtr& parameters : group_parameters_)
+  {
+    if (parameters->publish_period != parameters_->publish_period)
+    {
+      RCLCPP_ERROR_STREAM(LOGGER, "All servoed groups need the same publish_period, but group `"
+                                      << parameters->move_group_name << "` differs from `"
+                                      << parameters_->move_group_name << "`");
+      throw std::runtime_error("Servoed groups with different publish_period");
+    }
+    servo_calcs_.push_back(std::make_unique<ServoCalcs>(node, parameters, planning_scene_monitor_));
+    if (parameters_->check_collisions)
+      servo_calcs_.back()->setProximityCheck(collision_checker_.getProximityCheck());
+  }
+
+  if (servo_calcs_.size() > 1)
+  {
+    // A low latency loop only wakes up for commands of the first group
+    if (parameters_->low_latency_mode)
+      RCLCPP_WARN(LOGGER, "low_latency_mode of the first group also delays the other groups until it gets a command");
+    std::vector<ServoCalcs*> combined_groups;
+    for (std::size_t i = 1; i < servo_calcs_.size(); ++i)
+      combined_groups.push_back(servo_calcs_[i].get());
+    servo_calcs_.front()->setCombinedGroups(combined_groups);
+  }
 }
 
 void Servo::start()
 {
-  if (!planning_scene_monitor_->getStateMonitor()->waitForCompleteState(parameters_->move_group_name,
-                                                                        ROBOT_STATE_WAIT_TIME))
+  for (const ServoParameters::SharedConstPtr& parameters : group_parameters_)
   {
-    RCLCPP_ERROR(LOGGER, "Timeout waiting for current state");
-    return;
+    if (!planning_scene_monitor_->getStateMonitor()->waitForCompleteState(parameters->move_group_name,
+                                                                          ROBOT_STATE_WAIT_TIME))
+    {
+      RCLCPP_ERROR(LOGGER, "Timeout waiting for current state");
+      return;
+    }
   }
 
   setPaused(false);
 
-  // Crunch the numbers in this timer
-  servo_calcs_.start();
+  // Crunch the numbers in this timer. The loop of the first group also calculates the other groups
+  servo_calcs_.front()->stop();
+  for (std::size_t i = 1; i < servo_calcs_.size(); ++i)
+    servo_calcs_[i]->start(false);
+  servo_calcs_.front()->start();
 
   // Check collisions in this timer
   if (parameters_->check_collisions)
@@ -79,32 +115,50 @@ void Servo::start()
 Servo::~Servo()
 {
   setPaused(true);
+  // Stop the loop before the combined groups it calculates are destroyed
+  servo_calcs_.front()->stop();
 }
 
 void Servo::setPaused(bool paused)
 {
-  servo_calcs_.setPaused(paused);
+  for (const std::unique_ptr<ServoCalcs>& servo_calcs : servo_calcs_)
+    servo_calcs->setPaused(paused);
   collision_checker_.setPaused(paused);
 }
 
-bool Servo::getCommandFrameTransform(Eigen::Isometry3d& transform)
+bool Servo::getCommandFrameTransform(Eigen::Isometry3d& transform, std::size_t group)
 {
-  return servo_calcs_.getCommandFrameTransform(transform);
+  return servo_calcs_.at(group)->getCommandFrameTransform(transform);
 }
 
-bool Servo::getCommandFrameTransform(geometry_msgs::msg::TransformStamped& transform)
+bool Servo::getCommandFrameTransform(geometry_msgs::msg::TransformStamped& transform, std::size_t group)
 {
-  return servo_calcs_.getCommandFrameTransform(transform);
+  return servo_calcs_.at(group)->getCommandFrameTransform(transform);
 }
 
-bool Servo::getEEFrameTransform(Eigen::Isometry3d& transform)
+bool Servo::getEEFrameTransform(Eigen::Isometry3d& transform, std::size_t group)
 {
-  return servo_calcs_.getEEFrameTransform(transform);
+  return servo_calcs_.at(group)->getEEFrameTransform(transform);
 }
 
-bool Servo::getEEFrameTransform(geometry_msgs::msg::TransformStamped& transform)
+bool Servo::getEEFrameTransform(geometry_msgs::msg::TransformStamped& transform, std::size_t group)
 {
-  return servo_calcs_.getEEFrameTransform(transform);
+  return servo_calcs_.at(group)->getEEFrameTransform(transform);
+}
+
+void Servo::setTwistCommand(const Eigen::Matrix<double, 6, 1>& twist, std::size_t group)
+{
+  servo_calcs_.at(group)->setTwistCommand(twist);
+}
+
+bool Servo::setJointCommand(const Eigen::VectorXd& velocities, std::size_t group)
+{
+  return servo_calcs_.at(group)->setJointCommand(velocities);
+}
+
+void Servo::setCommandCallback(ServoCalcs::CommandCallback callback, std::size_t group)
+{
+  servo_calcs_.at(group)->setCommandCallback(std::move(callback));
 }
 
 const ServoParameters::SharedConstPtr& Servo::getParameters() const
@@ -112,4 +166,19 @@ const ServoParameters::SharedConstPtr& Servo::getParameters() const
   return parameters_;
 }
 
+std::size_t Servo::getGroupCount() const
+{
+  return servo_calcs_.size();
+}
+
+LoopJitter Servo::getLoopJitter() const
+{
+  return servo_calcs_.front()->getLoopJitter();
+}
+
+LatencyStatistics Servo::getLatencyStatistics(ServoStage stage, std::size_t group) const
+{
+  return servo_calcs_.at(group)->getLatencyStatistics(stage);
+}
+
 }  // namespace moveit_servo
@@ -37,16 +37,19 @@
  *      Author    : Brian O'Neil, Andy Zelenak, Blake Anderson
  */
 
+#include <algorithm>
 #include <cassert>
+#include <cerrno>
+#include <cmath>
 #include <thread>
 #include <chrono>
 #include <mutex>
+#include <time.h>
 
 #include <controller_manager/realtime.hpp>
 #include <std_msgs/msg/bool.h>
 #include <tf2_geometry_msgs/tf2_geometry_msgs.hpp>
 
-// #include <moveit_servo/make_shared_from_pool.h> // TODO(adamp): create an issue about this
 #include <moveit_servo/servo_calcs.h>
 #include <moveit_servo/enforce_limits.hpp>
 
@@ -56,6 +59,23 @@ namespace moveit_servo
 {
 namespace
 {
+// Publish from a middleware-owned buffer when the RMW supports loaning, so the preallocated message is not handed
+// over. Otherwise the const reference overload serializes the message in place.
+template <typename PublisherT, typename MessageT>
+void publishMessage(PublisherT& publisher, const MessageT& msg)
+{
+  if (publisher->can_loan_messages())
+  {
+    auto loaned_msg = publisher->borrow_loaned_message();
+    loaned_msg.get() = msg;
+    publisher->publish(std::move(loaned_msg));
+  }
+  else
+  {
+    publisher->publish(msg);
+  }
+}
+
 // Helper function for detecting zeroed message
 bool isNonZero(const geometry_msgs::msg::TwistStamped& msg)
 {
@@ -87,13 +107,46 @@ geometry_msgs::msg::TransformStamped convertIsometryToTransform(const Eigen::Iso
 }
 
 static const rclcpp::Logger LOGGER = rclcpp::get_logger("moveit_servo.servo_calcs");
-constexpr auto ROS_LOG_THROTTLE_PERIOD = std::chrono::milliseconds(3000).count();
+constexpr auto ROS_LOG_THROTTLE_PERIOD = std::chrono::milliseconds(3000);
 static constexpr double STOPPED_VELOCITY_EPS = 1e-4;  // rad/s
 
 // This value is used when configuring the main loop to use SCHED_FIFO scheduling
 // We use a slightly lower priority than the ros2_control default in order to reduce jitter
 // Reference: https://man7.org/linux/man-pages/man2/sched_setparam.2.html
 int const THREAD_PRIORITY = 40;
+
+// Period at which the housekeeping thread of the realtime mode emits deferred logs and frees retired messages
+constexpr auto HOUSEKEEPING_PERIOD = std::chrono::milliseconds(10);
+constexpr auto DIAGNOSTICS_PERIOD = std::chrono::seconds(1);
+
+// Current time of the monotonic clock that the realtime loop deadlines are measured on
+int64_t monotonicNanoseconds()
+{
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<int64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+}
+
+// Sleep until an absolute deadline, so time spent computing does not drift the loop period
+void sleepUntil(int64_t deadline_ns)
+{
+  timespec deadline;
+  deadline.tv_sec = deadline_ns / 1000000000;
+  deadline.tv_nsec = deadline_ns % 1000000000;
+  while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr) == EINTR)
+  {
+  }
+}
+
+// Private topic and service prefix of a group. Several groups servoed by one node are kept apart by their namespace
+std::string groupPrefix(const std::string& ns)
+{
+  if (ns == "moveit_servo")
+    return "~/";
+  std::string prefix = "~/" + ns + "/";
+  std::replace(prefix.begin(), prefix.end(), '.', '/');
+  return prefix;
+}
 }  // namespace
 
 // Constructor for the class that handles servoing calculations
@@ -108,6 +161,7 @@ ServoCalcs::ServoCalcs(rclcpp::Node::SharedPtr node,
   , paused_(false)
   , robot_link_command_frame_(parameters->robot_link_command_frame)
   , smoothing_loader_("moveit_core", "online_signal_smoothing::SmoothingBaseClass")
+  , deferred_logger_(LOGGER, ROS_LOG_THROTTLE_PERIOD)
 {
   // Register callback for changes in robot_link_command_frame
   bool callback_success = parameters_->registerSetParameterCallback(parameters->ns + ".robot_link_command_frame",
@@ -137,16 +191,28 @@ ServoCalcs::ServoCalcs(rclcpp::Node::SharedPtr node,
       parameters_->joint_command_in_topic, rclcpp::SystemDefaultsQoS(),
       [this](const control_msgs::msg::JointJog::SharedPtr msg) { return jointCmdCB(msg); });
 
+  // In realtime mode the robot state is updated from the joint states passed through a lock-free queue, instead of
+  // copying it from the planning scene monitor each iteration
+  if (parameters_->realtime_mode)
+  {
+    joint_state_sub_ = node_->create_subscription<sensor_msgs::msg::JointState>(
+        parameters_->joint_topic, rclcpp::SystemDefaultsQoS(),
+        [this](const sensor_msgs::msg::JointState::SharedPtr msg) { return jointStateCB(msg); });
+  }
+
+  const std::string prefix = groupPrefix(parameters_->ns);
+
   // ROS Server for allowing drift in some dimensions
   drift_dimensions_server_ = node_->create_service<moveit_msgs::srv::ChangeDriftDimensions>(
-      "~/change_drift_dimensions", [this](const std::shared_ptr<moveit_msgs::srv::ChangeDriftDimensions::Request> req,
-                                          std::shared_ptr<moveit_msgs::srv::ChangeDriftDimensions::Response> res) {
+      prefix + "change_drift_dimensions",
+      [this](const std::shared_ptr<moveit_msgs::srv::ChangeDriftDimensions::Request> req,
+             std::shared_ptr<moveit_msgs::srv::ChangeDriftDimensions::Response> res) {
         return changeDriftDimensions(req, res);
       });
 
   // ROS Server for changing the control dimensions
   control_dimensions_server_ = node_->create_service<moveit_msgs::srv::ChangeControlDimensions>(
-      "~/change_control_dimensions",
+      prefix + "change_control_dimensions",
       [this](const std::shared_ptr<moveit_msgs::srv::ChangeControlDimensions::Request> req,
              std::shared_ptr<moveit_msgs::srv::ChangeControlDimensions::Response> res) {
         return changeControlDimensions(req, res);
@@ -154,11 +220,11 @@ ServoCalcs::ServoCalcs(rclcpp::Node::SharedPtr node,
 
   // ROS Server to reset the status, e.g. so the arm can move again after a collision
   reset_servo_status_ = node_->create_service<std_srvs::srv::Empty>(
-      "~/reset_servo_status",
+      prefix + "reset_servo_status",
       [this](const std::shared_ptr<std_srvs::srv::Empty::Request> req,
              std::shared_ptr<std_srvs::srv::Empty::Response> res) { return resetServoStatus(req, res); });
 
-  // Subscribe to the collision_check topic
+  // Subscribe to the collision_check topic. It is shared by all groups, as one check covers the whole robot
   collision_velocity_scale_sub_ = node_->create_subscription<std_msgs::msg::Float64>(
       "~/collision_velocity_scale", rclcpp::SystemDefaultsQoS(),
       [this](const std_msgs::msg::Float64::SharedPtr msg) { return collisionVelocityScaleCB(msg); });
@@ -178,13 +244,29 @@ ServoCalcs::ServoCalcs(rclcpp::Node::SharedPtr node,
 
   // Publish status
   status_pub_ = node_->create_publisher<std_msgs::msg::Int8>(parameters_->status_topic, rclcpp::SystemDefaultsQoS());
-  condition_pub_ = node_->create_publisher<std_msgs::msg::Float64>("~/condition", rclcpp::SystemDefaultsQoS());
+  condition_pub_ = node_->create_publisher<std_msgs::msg::Float64>(prefix + "condition", rclcpp::SystemDefaultsQoS());
+
+  // Publish stage latencies on the standard diagnostics topic
+  diagnostics_pub_ =
+      node_->create_publisher<diagnostic_msgs::msg::DiagnosticArray>("/diagnostics", rclcpp::SystemDefaultsQoS());
+  diagnostics_timer_ = node_->create_wall_timer(DIAGNOSTICS_PERIOD, [this]() { return publishDiagnostics(); });
 
   internal_joint_state_.name = joint_model_group_->getActiveJointModelNames();
   num_joints_ = internal_joint_state_.name.size();
   internal_joint_state_.position.resize(num_joints_);
   internal_joint_state_.velocity.resize(num_joints_);
   delta_theta_.setZero(num_joints_);
+  jacobian_workspace_ = std::make_unique<JacobianWorkspace>(joint_model_group_);
+  singular_vector_.setZero(6);
+  ik_solution_.resize(num_joints_);
+  multiarray_cmd_.data.reserve(num_joints_);
+
+  direct_joint_slot_ = std::make_unique<LatestValueSlot<Eigen::VectorXd>>(Eigen::VectorXd::Zero(num_joints_));
+  direct_joint_velocities_.setZero(num_joints_);
+  direct_twist_cmd_ = std::make_shared<geometry_msgs::msg::TwistStamped>();
+  direct_joint_cmd_ = std::make_shared<control_msgs::msg::JointJog>();
+  direct_joint_cmd_->joint_names = internal_joint_state_.name;
+  direct_joint_cmd_->velocities.resize(num_joints_);
 
   for (std::size_t i = 0; i < num_joints_; ++i)
   {
@@ -242,7 +324,7 @@ ServoCalcs::~ServoCalcs()
   stop();
 }
 
-void ServoCalcs::start()
+void ServoCalcs::start(bool run_loop)
 {
   // Stop the thread if we are currently running
   stop();
@@ -271,6 +353,8 @@ void ServoCalcs::start()
   }
   initial_joint_trajectory->points.push_back(point);
   last_sent_command_ = std::move(initial_joint_trajectory);
+  // Reuse the storage of this message for every outgoing command
+  joint_trajectory_ = *last_sent_command_;
 
   current_state_ = planning_scene_monitor_->getStateMonitor()->getCurrentState();
   tf_moveit_to_ee_frame_ = current_state_->getGlobalLinkTransform(parameters_->planning_frame).inverse() *
@@ -284,9 +368,28 @@ void ServoCalcs::start()
   }
 
   stop_requested_ = false;
+  deferred_logger_.setDeferred(parameters_->realtime_mode);
+  if (parameters_->realtime_mode)
+  {
+    housekeeping_thread_ = std::thread([this] {
+      while (!stop_requested_)
+      {
+        std::this_thread::sleep_for(HOUSEKEEPING_PERIOD);
+        deferred_logger_.flush();
+        releaseRetiredMessages();
+      }
+    });
+  }
+  new_input_cmd_ = false;
+
+  // The iterations of a combined group are run by the loop of another group
+  if (!run_loop)
+    return;
+
   thread_ = std::thread([this] {
-    // Check if a realtime kernel is installed. Set a higher thread priority, if so
-    if (controller_manager::has_realtime_kernel())
+    // Check if a realtime kernel is installed. Set a higher thread priority, if so.
+    // Realtime mode always requests SCHED_FIFO, which also reduces jitter on a standard kernel
+    if (controller_manager::has_realtime_kernel() || parameters_->realtime_mode)
     {
       if (!controller_manager::configure_sched_fifo(THREAD_PRIORITY))
       {
@@ -299,7 +402,6 @@ void ServoCalcs::start()
     }
     mainCalcLoop();
   });
-  new_input_cmd_ = false;
 }
 
 void ServoCalcs::stop()
@@ -321,14 +423,38 @@ void ServoCalcs::stop()
   {
     thread_.join();
   }
+
+  if (housekeeping_thread_.joinable())
+  {
+    housekeeping_thread_.join();
+  }
+  // Emit what the realtime loop logged last and free the retired messages
+  deferred_logger_.flush();
+  releaseRetiredMessages();
 }
 
 void ServoCalcs::mainCalcLoop()
 {
+  if (parameters_->realtime_mode)
+  {
+    realtimeCalcLoop();
+    return;
+  }
+
   rclcpp::Rate rate(1.0 / parameters_->publish_period);
+  const int64_t period_ns = static_cast<int64_t>(parameters_->publish_period * 1e9);
+  int64_t expected_wake_ns = monotonicNanoseconds();
 
   while (rclcpp::ok() && !stop_requested_)
   {
+    // The jitter is only meaningful when the loop is paced by the rate
+    if (!parameters_->low_latency_mode)
+    {
+      const int64_t wake_ns = monotonicNanoseconds();
+      recordLoopJitter(wake_ns - expected_wake_ns, false);
+      expected_wake_ns = wake_ns + period_ns;
+    }
+
     // lock the input state mutex
     std::unique_lock<std::mutex> main_loop_lock(main_loop_mutex_);
 
@@ -344,15 +470,14 @@ void ServoCalcs::mainCalcLoop()
     // run servo calcs
     const auto start_time = node_->now();
     calculateSingleIteration();
+    calculateCombinedGroups();
     const auto run_duration = node_->now() - start_time;
 
     // Log warning when the run duration was longer than the period
     if (run_duration.seconds() > parameters_->publish_period)
     {
-      rclcpp::Clock& clock = *node_->get_clock();
-      RCLCPP_WARN_STREAM_THROTTLE(LOGGER, clock, ROS_LOG_THROTTLE_PERIOD,
-                                  "run_duration: " << run_duration.seconds() << " (" << parameters_->publish_period
-                                                   << ")");
+      deferred_logger_.log(RCUTILS_LOG_SEVERITY_WARN, "run_duration: %f (%f)", run_duration.seconds(),
+                           parameters_->publish_period);
     }
 
     // normal mode, unlock input mutex and wait for the period of the loop
@@ -364,12 +489,137 @@ void ServoCalcs::mainCalcLoop()
   }
 }
 
+void ServoCalcs::realtimeCalcLoop()
+{
+  const int64_t period_ns = static_cast<int64_t>(parameters_->publish_period * 1e9);
+  int64_t deadline_ns = monotonicNanoseconds();
+
+  while (rclcpp::ok() && !stop_requested_)
+  {
+    {
+      // The callbacks no longer take this mutex, so it is only contended by the short transform getters
+      const std::lock_guard<std::mutex> lock(main_loop_mutex_);
+      popLatestCommands();
+      calculateSingleIteration();
+      calculateCombinedGroups();
+    }
+
+    // Missed deadlines are skipped rather than caught up on, so an overrun does not cause a burst of iterations
+    deadline_ns += period_ns;
+    const int64_t now_ns = monotonicNanoseconds();
+    const bool overrun = now_ns > deadline_ns;
+    if (overrun)
+      deadline_ns += ((now_ns - deadline_ns) / period_ns + 1) * period_ns;
+
+    sleepUntil(deadline_ns);
+    recordLoopJitter(monotonicNanoseconds() - deadline_ns, overrun);
+    if (overrun)
+      deferred_logger_.log(RCUTILS_LOG_SEVERITY_WARN, "Iteration overran the publish_period of %f s",
+                           parameters_->publish_period);
+  }
+}
+
+void ServoCalcs::calculateCombinedGroups()
+{
+  for (ServoCalcs* group : combined_groups_)
+  {
+    const std::lock_guard<std::mutex> lock(group->main_loop_mutex_);
+    if (group->parameters_->realtime_mode)
+      group->popLatestCommands();
+    group->new_input_cmd_ = false;
+    group->calculateSingleIteration();
+  }
+}
+
+void ServoCalcs::setCombinedGroups(const std::vector<ServoCalcs*>& groups)
+{
+  const std::lock_guard<std::mutex> lock(main_loop_mutex_);
+  combined_groups_ = groups;
+}
+
+void ServoCalcs::recordLoopJitter(int64_t jitter_ns, bool overrun)
+{
+  const double jitter = std::abs(static_cast<double>(jitter_ns)) * 1e-9;
+  const std::uint64_t iterations = loop_iterations_.load(std::memory_order_relaxed) + 1;
+  const double mean = jitter_mean_.load(std::memory_order_relaxed);
+  jitter_last_.store(jitter, std::memory_order_relaxed);
+  jitter_mean_.store(mean + (jitter - mean) / static_cast<double>(iterations), std::memory_order_relaxed);
+  if (jitter > jitter_max_.load(std::memory_order_relaxed))
+    jitter_max_.store(jitter, std::memory_order_relaxed);
+  if (overrun)
+    loop_overruns_.fetch_add(1, std::memory_order_relaxed);
+  loop_iterations_.store(iterations, std::memory_order_relaxed);
+}
+
+void ServoCalcs::setProximityCheck(const std::shared_ptr<ProximityCheck>& proximity_check)
+{
+  const std::lock_guard<std::mutex> lock(main_loop_mutex_);
+  proximity_check_ = proximity_check;
+}
+
+LoopJitter ServoCalcs::getLoopJitter() const
+{
+  LoopJitter jitter;
+  jitter.last = jitter_last_.load(std::memory_order_relaxed);
+  jitter.max = jitter_max_.load(std::memory_order_relaxed);
+  jitter.mean = jitter_mean_.load(std::memory_order_relaxed);
+  jitter.iterations = loop_iterations_.load(std::memory_order_relaxed);
+  jitter.overruns = loop_overruns_.load(std::memory_order_relaxed);
+  return jitter;
+}
+
+LatencyStatistics ServoCalcs::getLatencyStatistics(ServoStage stage) const
+{
+  return latency_histograms_[static_cast<std::size_t>(stage)].getStatistics();
+}
+
+void ServoCalcs::publishDiagnostics()
+{
+  diagnostic_msgs::msg::DiagnosticStatus status;
+  status.name = std::string(node_->get_name()) + ": servo loop latency";
+  status.hardware_id = parameters_->move_group_name;
+  status.level = diagnostic_msgs::msg::DiagnosticStatus::OK;
+  status.message = "OK";
+
+  const auto add_value = [&status](const std::string& key, const std::string& value) {
+    diagnostic_msgs::msg::KeyValue key_value;
+    key_value.key = key;
+    key_value.value = value;
+    status.values.push_back(key_value);
+  };
+  for (std::size_t i = 0; i < SERVO_STAGE_COUNT; ++i)
+  {
+    const ServoStage stage = static_cast<ServoStage>(i);
+    const LatencyStatistics statistics = getLatencyStatistics(stage);
+    const std::string name = servoStageName(stage);
+    add_value(name + " count", std::to_string(statistics.count));
+    add_value(name + " p50 [us]", std::to_string(statistics.p50 * 1e-3));
+    add_value(name + " p99 [us]", std::to_string(statistics.p99 * 1e-3));
+    add_value(name + " max [us]", std::to_string(statistics.max * 1e-3));
+  }
+
+  // An iteration that regularly takes longer than a period misses its deadline
+  if (getLatencyStatistics(ServoStage::ITERATION).p99 * 1e-9 > parameters_->publish_period)
+  {
+    status.level = diagnostic_msgs::msg::DiagnosticStatus::WARN;
+    status.message = "99th percentile iteration time exceeds publish_period";
+  }
+
+  diagnostic_msgs::msg::DiagnosticArray diagnostics;
+  diagnostics.header.stamp = node_->now();
+  diagnostics.status.push_back(status);
+  diagnostics_pub_->publish(diagnostics);
+}
+
 void ServoCalcs::calculateSingleIteration()
 {
+  ScopedStageTimer iteration_timer(latency_histograms_, ServoStage::ITERATION);
+  ScopedStageTimer input_timer(latency_histograms_, ServoStage::INPUT);
+
   // Publish status each loop iteration
-  auto status_msg = std::make_unique<std_msgs::msg::Int8>();
-  status_msg->data = static_cast<int8_t>(status_);
-  status_pub_->publish(std::move(status_msg));
+  std_msgs::msg::Int8 status_msg;
+  status_msg.data = static_cast<int8_t>(status_);
+  publishMessage(status_pub_, status_msg);
 
   // After we publish, status, reset it back to no warnings
   status_ = StatusCode::NO_WARNING;
@@ -379,9 +629,7 @@ void ServoCalcs::calculateSingleIteration()
   // 2) so the low-pass filters are up to date and don't cause a jump
   updateJoints();
 
-  // Update from latest state
-  current_state_ = planning_scene_monitor_->getStateMonitor()->getCurrentState();
-
+  popDirectCommands();
   if (latest_twist_stamped_)
     twist_stamped_cmd_ = *latest_twist_stamped_;
   if (latest_joint_cmd_)
@@ -415,6 +663,7 @@ void ServoCalcs::calculateSingleIteration()
   }
 
   have_nonzero_command_ = have_nonzero_twist_stamped_ || have_nonzero_joint_command_;
+  input_timer.stop();
 
   // Don't end this function without updating the filters
   updated_filters_ = false;
@@ -435,8 +684,8 @@ void ServoCalcs::calculateSingleIteration()
 
   // If not waiting for initial command, and not paused.
   // Do servoing calculations only if the robot should move, for efficiency
-  // Create new outgoing joint trajectory command message
-  auto joint_trajectory = std::make_unique<trajectory_msgs::msg::JointTrajectory>();
+  // The outgoing joint trajectory command message keeps its storage between iterations
+  trajectory_msgs::msg::JointTrajectory* joint_trajectory = &joint_trajectory_;
 
   // Prioritize cartesian servoing above joint servoing
   // Only run commands if not stale and nonzero
@@ -482,16 +731,13 @@ void ServoCalcs::calculateSingleIteration()
       (zero_velocity_count_ > parameters_->num_outgoing_halt_msgs_to_publish))
   {
     ok_to_publish_ = false;
-    rclcpp::Clock& clock = *node_->get_clock();
-    RCLCPP_DEBUG_STREAM_THROTTLE(LOGGER, clock, ROS_LOG_THROTTLE_PERIOD, "All-zero command. Doing nothing.");
+    deferred_logger_.log(RCUTILS_LOG_SEVERITY_DEBUG, "All-zero command. Doing nothing.");
   }
   // Skip servoing publication if both types of commands are stale.
   else if (twist_command_is_stale_ && joint_command_is_stale_)
   {
     ok_to_publish_ = false;
-    rclcpp::Clock& clock = *node_->get_clock();
-    RCLCPP_DEBUG_STREAM_THROTTLE(LOGGER, clock, ROS_LOG_THROTTLE_PERIOD,
-                                 "Skipping publishing because incoming commands are stale.");
+    deferred_logger_.log(RCUTILS_LOG_SEVERITY_DEBUG, "Skipping publishing because incoming commands are stale.");
   }
   else
   {
@@ -513,6 +759,8 @@ void ServoCalcs::calculateSingleIteration()
 
   if (ok_to_publish_ && !paused_)
   {
+    ScopedStageTimer publish_timer(latency_histograms_, ServoStage::PUBLISH);
+
     // Clear out position commands if user did not request them (can cause interpolation issues)
     if (!parameters_->publish_joint_positions)
     {
@@ -530,23 +778,28 @@ void ServoCalcs::calculateSingleIteration()
 
     // Put the outgoing msg in the right format
     // (trajectory_msgs/JointTrajectory or std_msgs/Float64MultiArray).
-    if (parameters_->command_out_type == "trajectory_msgs/JointTrajectory")
+    if (command_callback_)
+    {
+      joint_trajectory->header.stamp = rclcpp::Time(0);
+      *last_sent_command_ = *joint_trajectory;
+      command_callback_(*joint_trajectory);
+    }
+    else if (parameters_->command_out_type == "trajectory_msgs/JointTrajectory")
     {
       // When a joint_trajectory_controller receives a new command, a stamp of 0 indicates "begin immediately"
       // See http://wiki.ros.org/joint_trajectory_controller#Trajectory_replacement
       joint_trajectory->header.stamp = rclcpp::Time(0);
       *last_sent_command_ = *joint_trajectory;
-      trajectory_outgoing_cmd_pub_->publish(std::move(joint_trajectory));
+      publishMessage(trajectory_outgoing_cmd_pub_, *joint_trajectory);
     }
     else if (parameters_->command_out_type == "std_msgs/Float64MultiArray")
     {
-      auto joints = std::make_unique<std_msgs::msg::Float64MultiArray>();
       if (parameters_->publish_joint_positions && !joint_trajectory->points.empty())
-        joints->data = joint_trajectory->points[0].positions;
+        multiarray_cmd_.data = joint_trajectory->points[0].positions;
       else if (parameters_->publish_joint_velocities && !joint_trajectory->points.empty())
-        joints->data = joint_trajectory->points[0].velocities;
+        multiarray_cmd_.data = joint_trajectory->points[0].velocities;
       *last_sent_command_ = *joint_trajectory;
-      multiarray_outgoing_cmd_pub_->publish(std::move(joints));
+      publishMessage(multiarray_outgoing_cmd_pub_, multiarray_cmd_);
     }
   }
 
@@ -569,6 +822,8 @@ rcl_interfaces::msg::SetParametersResult ServoCalcs::robotLinkCommandFrameCallba
 bool ServoCalcs::cartesianServoCalcs(geometry_msgs::msg::TwistStamped& cmd,
                                      trajectory_msgs::msg::JointTrajectory& joint_trajectory)
 {
+  ScopedStageTimer kinematics_timer(latency_histograms_, ServoStage::KINEMATICS);
+
   // Check for nan's in the incoming command
   if (!checkValidCommand(cmd))
     return false;
@@ -615,16 +870,14 @@ bool ServoCalcs::cartesianServoCalcs(geometry_msgs::msg::TwistStamped& cmd,
     cmd.twist.angular.z = angular_vector(2);
   }
 
-  Eigen::VectorXd delta_x = scaleCartesianCommand(cmd);
+  const Eigen::Matrix<double, 6, 1> delta_x = scaleCartesianCommand(cmd);
 
-  Eigen::MatrixXd jacobian = current_state_->getJacobian(joint_model_group_);
-
-  removeDriftDimensions(jacobian, delta_x);
-
-  Eigen::JacobiSVD<Eigen::MatrixXd> svd =
-      Eigen::JacobiSVD<Eigen::MatrixXd>(jacobian, Eigen::ComputeThinU | Eigen::ComputeThinV);
-  Eigen::MatrixXd matrix_s = svd.singularValues().asDiagonal();
-  Eigen::MatrixXd pseudo_inverse = svd.matrixV() * matrix_s.inverse() * svd.matrixU().transpose();
+  // Jacobian without the drift dimensions, its SVD and its pseudo-inverse, all in preallocated storage
+  if (!jacobian_workspace_->update(*current_state_, drift_dimensions_, delta_x))
+  {
+    deferred_logger_.log(RCUTILS_LOG_SEVERITY_WARN, "Could not compute the Jacobian of the move group");
+    return false;
+  }
 
   // Convert from cartesian commands to joint commands
   // Use an IK solver plugin if we have one, otherwise use inverse Jacobian.
@@ -666,17 +919,16 @@ bool ServoCalcs::cartesianServoCalcs(geometry_msgs::msg::TwistStamped& cmd,
     geometry_msgs::msg::Pose next_pose = tf2::toMsg(tf);
 
     // setup for IK call
-    std::vector<double> solution(num_joints_);
     moveit_msgs::msg::MoveItErrorCodes err;
     kinematics::KinematicsQueryOptions opts;
     opts.return_approximate_solution = true;
     if (ik_solver_->searchPositionIK(next_pose, internal_joint_state_.position, parameters_->publish_period / 2.0,
-                                     solution, err, opts))
+                                     ik_solution_, err, opts))
     {
       // find the difference in joint positions that will get us to the desired pose
       for (size_t i = 0; i < num_joints_; ++i)
       {
-        delta_theta_.coeffRef(i) = solution.at(i) - internal_joint_state_.position.at(i);
+        delta_theta_.coeffRef(i) = ik_solution_.at(i) - internal_joint_state_.position.at(i);
       }
     }
     else
@@ -688,10 +940,11 @@ bool ServoCalcs::cartesianServoCalcs(geometry_msgs::msg::TwistStamped& cmd,
   else
   {
     // no supported IK plugin, use inverse Jacobian
-    delta_theta_ = pseudo_inverse * delta_x;
+    delta_theta_.matrix().noalias() = jacobian_workspace_->getPseudoInverse() * jacobian_workspace_->getDeltaX();
   }
 
-  delta_theta_ *= velocityScalingFactorForSingularity(delta_x, svd, pseudo_inverse);
+  delta_theta_ *= velocityScalingFactorForSingularity(jacobian_workspace_->getDeltaX(), jacobian_workspace_->getSVD());
+  kinematics_timer.stop();
 
   return internalServoUpdate(delta_theta_, joint_trajectory, ServoType::CARTESIAN_SPACE);
 }
@@ -704,7 +957,7 @@ bool ServoCalcs::jointServoCalcs(const control_msgs::msg::JointJog& cmd,
     return false;
 
   // Apply user-defined scaling
-  delta_theta_ = scaleJointCommand(cmd);
+  scaleJointCommand(cmd, delta_theta_);
 
   // Perform internal servo with the command
   return internalServoUpdate(delta_theta_, joint_trajectory, ServoType::JOINT_SPACE);
@@ -725,29 +978,38 @@ bool ServoCalcs::internalServoUpdate(Eigen::ArrayXd& delta_theta,
   internal_joint_state_ = original_joint_state_;
 
   // Apply collision scaling
+  ScopedStageTimer collision_timer(latency_histograms_, ServoStage::COLLISION_SCALING);
   double collision_scale = collision_velocity_scale_;
+  if (proximity_check_)
+  {
+    // The scene distance is cheap enough to refresh every iteration, between the collision checks
+    current_state_->updateLinkTransforms();
+    collision_scale = std::min(collision_scale, proximity_check_->getVelocityScale(*current_state_));
+  }
   if (collision_scale > 0 && collision_scale < 1)
   {
     status_ = StatusCode::DECELERATE_FOR_COLLISION;
-    rclcpp::Clock& clock = *node_->get_clock();
-    RCLCPP_WARN_STREAM_THROTTLE(LOGGER, clock, ROS_LOG_THROTTLE_PERIOD, SERVO_STATUS_CODE_MAP.at(status_));
+    deferred_logger_.log(RCUTILS_LOG_SEVERITY_WARN, "%s", SERVO_STATUS_CODE_MAP.at(status_).c_str());
   }
   else if (collision_scale == 0)
   {
     status_ = StatusCode::HALT_FOR_COLLISION;
-    rclcpp::Clock& clock = *node_->get_clock();
-    RCLCPP_ERROR_STREAM_THROTTLE(LOGGER, clock, ROS_LOG_THROTTLE_PERIOD, "Halting for collision!");
+    deferred_logger_.log(RCUTILS_LOG_SEVERITY_ERROR, "Halting for collision!");
   }
   delta_theta *= collision_scale;
+  collision_timer.stop();
 
   // Loop thru joints and update them, calculate velocities, and filter
+  ScopedStageTimer filter_timer(latency_histograms_, ServoStage::FILTER);
   if (!applyJointUpdate(delta_theta, internal_joint_state_))
     return false;
+  filter_timer.stop();
 
   // Mark the lowpass filters as updated for this cycle
   updated_filters_ = true;
 
   // Enforce SRDF velocity limits
+  ScopedStageTimer limits_timer(latency_histograms_, ServoStage::LIMITS);
   enforceVelocityLimits(joint_model_group_, parameters_->publish_period, internal_joint_state_,
                         parameters_->override_velocity_scaling_factor);
 
@@ -766,6 +1028,7 @@ bool ServoCalcs::internalServoUpdate(Eigen::ArrayXd& delta_theta,
       suddenHalt(internal_joint_state_, joint_model_group_->getActiveJointModels());
     }
   }
+  limits_timer.stop();
 
   // compose outgoing message
   composeJointTrajMessage(internal_joint_state_, joint_trajectory);
@@ -785,9 +1048,7 @@ bool ServoCalcs::applyJointUpdate(const Eigen::ArrayXd& delta_theta, sensor_msgs
   if (joint_state.position.size() != static_cast<std::size_t>(delta_theta.size()) ||
       joint_state.velocity.size() != joint_state.position.size())
   {
-    rclcpp::Clock& clock = *node_->get_clock();
-    RCLCPP_ERROR_STREAM_THROTTLE(LOGGER, clock, ROS_LOG_THROTTLE_PERIOD,
-                                 "Lengths of output and increments do not match.");
+    deferred_logger_.log(RCUTILS_LOG_SEVERITY_ERROR, "Lengths of output and increments do not match.");
     return false;
   }
 
@@ -842,7 +1103,9 @@ void ServoCalcs::composeJointTrajMessage(const sensor_msgs::msg::JointState& joi
   joint_trajectory.header.frame_id = parameters_->planning_frame;
   joint_trajectory.joint_names = joint_state.name;
 
-  trajectory_msgs::msg::JointTrajectoryPoint point;
+  // Assign into the existing point, so that a reused message keeps its storage
+  joint_trajectory.points.resize(1);
+  trajectory_msgs::msg::JointTrajectoryPoint& point = joint_trajectory.points[0];
   point.time_from_start = rclcpp::Duration::from_seconds(parameters_->publish_period);
   if (parameters_->publish_joint_positions)
     point.positions = joint_state.position;
@@ -853,16 +1116,13 @@ void ServoCalcs::composeJointTrajMessage(const sensor_msgs::msg::JointState& joi
     // I do not know of a robot that takes acceleration commands.
     // However, some controllers check that this data is non-empty.
     // Send all zeros, for now.
-    std::vector<double> acceleration(num_joints_);
-    point.accelerations = acceleration;
+    point.accelerations.assign(num_joints_, 0.0);
   }
-  joint_trajectory.points.push_back(point);
 }
 
 // Possibly calculate a velocity scaling factor, due to proximity of singularity and direction of motion
 double ServoCalcs::velocityScalingFactorForSingularity(const Eigen::VectorXd& commanded_velocity,
-                                                       const Eigen::JacobiSVD<Eigen::MatrixXd>& svd,
-                                                       const Eigen::MatrixXd& pseudo_inverse)
+                                                       const Eigen::JacobiSVD<Eigen::MatrixXd>& svd)
 {
   double velocity_scale = 1;
   std::size_t num_dimensions = commanded_velocity.size();
@@ -871,31 +1131,24 @@ double ServoCalcs::velocityScalingFactorForSingularity(const Eigen::VectorXd& co
   // The last column of U from the SVD of the Jacobian points directly toward or away from the singularity.
   // The sign can flip at any time, so we have to do some extra checking.
   // Look ahead to see if the Jacobian's condition will decrease.
-  Eigen::VectorXd vector_toward_singularity = svd.matrixU().col(num_dimensions - 1);
+  // resize() is a no-op unless the number of drift dimensions changed
+  Eigen::VectorXd& vector_toward_singularity = singular_vector_;
+  vector_toward_singularity.resize(num_dimensions);
+  vector_toward_singularity = svd.matrixU().col(num_dimensions - 1);
 
   double ini_condition = svd.singularValues()(0) / svd.singularValues()(svd.singularValues().size() - 1);
 
-  auto condition_msg = std::make_unique<std_msgs::msg::Float64>();
-  condition_msg->data = ini_condition;
-  condition_pub_->publish(std::move(condition_msg));
+  std_msgs::msg::Float64 condition_msg;
+  condition_msg.data = ini_condition;
+  publishMessage(condition_pub_, condition_msg);
 
   // This singular vector tends to flip direction unpredictably. See R. Bro,
   // "Resolving the Sign Ambiguity in the Singular Value Decomposition".
   // Look ahead to see if the Jacobian's condition will decrease in this
-  // direction. Start with a scaled version of the singular vector
-  Eigen::VectorXd delta_x(num_dimensions);
+  // direction. Start with a scaled version of the singular vector, and
+  // apply the small change in joints it maps to
   double scale = 100;
-  delta_x = vector_toward_singularity / scale;
-
-  // Calculate a small change in joints
-  Eigen::VectorXd new_theta;
-  current_state_->copyJointGroupPositions(joint_model_group_, new_theta);
-  new_theta += pseudo_inverse * delta_x;
-  current_state_->setJointGroupPositions(joint_model_group_, new_theta);
-  Eigen::MatrixXd new_jacobian = current_state_->getJacobian(joint_model_group_);
-
-  Eigen::JacobiSVD<Eigen::MatrixXd> new_svd(new_jacobian);
-  double new_condition = new_svd.singularValues()(0) / new_svd.singularValues()(new_svd.singularValues().size() - 1);
+  double new_condition = jacobian_workspace_->lookAheadCondition(*current_state_, vector_toward_singularity, scale);
   // If new_condition < ini_condition, the singular vector does point towards a
   // singularity. Otherwise, flip its direction.
   if (ini_condition >= new_condition)
@@ -916,8 +1169,7 @@ double ServoCalcs::velocityScalingFactorForSingularity(const Eigen::VectorXd& co
           1. - (ini_condition - parameters_->lower_singularity_threshold) /
                    (parameters_->hard_stop_singularity_threshold - parameters_->lower_singularity_threshold);
       status_ = StatusCode::DECELERATE_FOR_SINGULARITY;
-      rclcpp::Clock& clock = *node_->get_clock();
-      RCLCPP_WARN_STREAM_THROTTLE(LOGGER, clock, ROS_LOG_THROTTLE_PERIOD, SERVO_STATUS_CODE_MAP.at(status_));
+      deferred_logger_.log(RCUTILS_LOG_SEVERITY_WARN, "%s", SERVO_STATUS_CODE_MAP.at(status_).c_str());
     }
 
     // Very close to singularity, so halt.
@@ -925,8 +1177,7 @@ double ServoCalcs::velocityScalingFactorForSingularity(const Eigen::VectorXd& co
     {
       velocity_scale = 0;
       status_ = StatusCode::HALT_FOR_SINGULARITY;
-      rclcpp::Clock& clock = *node_->get_clock();
-      RCLCPP_WARN_STREAM_THROTTLE(LOGGER, clock, ROS_LOG_THROTTLE_PERIOD, SERVO_STATUS_CODE_MAP.at(status_));
+      deferred_logger_.log(RCUTILS_LOG_SEVERITY_WARN, "%s", SERVO_STATUS_CODE_MAP.at(status_).c_str());
     }
   }
 
@@ -979,9 +1230,8 @@ ServoCalcs::enforcePositionLimits(sensor_msgs::msg::JointState& joint_state) con
                    std::ostream_iterator<std::string>(joints_names, ", "),
                    [](const auto& joint) { return joint->getName(); });
     joints_names << joints_to_halt.back()->getName();
-    RCLCPP_WARN_STREAM_THROTTLE(LOGGER, *node_->get_clock(), ROS_LOG_THROTTLE_PERIOD,
-                                node_->get_name()
-                                    << " " << joints_names.str() << " close to a position limit. Halting.");
+    deferred_logger_.log(RCUTILS_LOG_SEVERITY_WARN, "%s %s close to a position limit. Halting.", node_->get_name(),
+                         joints_names.str().c_str());
   }
   return joints_to_halt;
 }
@@ -989,8 +1239,7 @@ ServoCalcs::enforcePositionLimits(sensor_msgs::msg::JointState& joint_state) con
 void ServoCalcs::filteredHalt(trajectory_msgs::msg::JointTrajectory& joint_trajectory)
 {
   // Prepare the joint trajectory message to stop the robot
-  joint_trajectory.points.clear();
-  joint_trajectory.points.emplace_back();
+  joint_trajectory.points.resize(1);
 
   // Deceleration algorithm:
   // Set positions to original_joint_state_
@@ -1004,7 +1253,7 @@ void ServoCalcs::filteredHalt(trajectory_msgs::msg::JointTrajectory& joint_traje
   done_stopping_ = true;
   if (parameters_->publish_joint_velocities)
   {
-    joint_trajectory.points[0].velocities = std::vector<double>(num_joints_, 0);
+    joint_trajectory.points[0].velocities.assign(num_joints_, 0);
     for (std::size_t i = 0; i < num_joints_; ++i)
     {
       joint_trajectory.points[0].velocities.at(i) =
@@ -1025,7 +1274,7 @@ void ServoCalcs::filteredHalt(trajectory_msgs::msg::JointTrajectory& joint_traje
 
   if (parameters_->publish_joint_accelerations)
   {
-    joint_trajectory.points[0].accelerations = std::vector<double>(num_joints_, 0);
+    joint_trajectory.points[0].accelerations.assign(num_joints_, 0);
     for (std::size_t i = 0; i < num_joints_; ++i)
     {
       joint_trajectory.points[0].accelerations.at(i) =
@@ -1056,7 +1305,21 @@ void ServoCalcs::suddenHalt(sensor_msgs::msg::JointState& joint_state,
 void ServoCalcs::updateJoints()
 {
   // Get the latest joint group positions
-  current_state_ = planning_scene_monitor_->getStateMonitor()->getCurrentState();
+  if (parameters_->realtime_mode)
+  {
+    // Apply the joint states received since the last iteration to the persistent state
+    sensor_msgs::msg::JointState::ConstSharedPtr joint_state;
+    while (joint_state_queue_.pop(joint_state))
+    {
+      current_state_->setVariableValues(*joint_state);
+      retireMessage(std::move(joint_state));
+    }
+    current_state_->update();
+  }
+  else
+  {
+    current_state_ = planning_scene_monitor_->getStateMonitor()->getCurrentState();
+  }
   current_state_->copyJointGroupPositions(joint_model_group_, internal_joint_state_.position);
   current_state_->copyJointGroupVelocities(joint_model_group_, internal_joint_state_.velocity);
 
@@ -1070,9 +1333,7 @@ bool ServoCalcs::checkValidCommand(const control_msgs::msg::JointJog& cmd)
   {
     if (std::isnan(velocity))
     {
-      rclcpp::Clock& clock = *node_->get_clock();
-      RCLCPP_WARN_STREAM_THROTTLE(LOGGER, clock, ROS_LOG_THROTTLE_PERIOD,
-                                  "nan in incoming command. Skipping this datapoint.");
+      deferred_logger_.log(RCUTILS_LOG_SEVERITY_WARN, "nan in incoming command. Skipping this datapoint.");
       return false;
     }
   }
@@ -1084,9 +1345,7 @@ bool ServoCalcs::checkValidCommand(const geometry_msgs::msg::TwistStamped& cmd)
   if (std::isnan(cmd.twist.linear.x) || std::isnan(cmd.twist.linear.y) || std::isnan(cmd.twist.linear.z) ||
       std::isnan(cmd.twist.angular.x) || std::isnan(cmd.twist.angular.y) || std::isnan(cmd.twist.angular.z))
   {
-    rclcpp::Clock& clock = *node_->get_clock();
-    RCLCPP_WARN_STREAM_THROTTLE(LOGGER, clock, ROS_LOG_THROTTLE_PERIOD,
-                                "nan in incoming command. Skipping this datapoint.");
+    deferred_logger_.log(RCUTILS_LOG_SEVERITY_WARN, "nan in incoming command. Skipping this datapoint.");
     return false;
   }
 
@@ -1096,9 +1355,7 @@ bool ServoCalcs::checkValidCommand(const geometry_msgs::msg::TwistStamped& cmd)
     if ((fabs(cmd.twist.linear.x) > 1) || (fabs(cmd.twist.linear.y) > 1) || (fabs(cmd.twist.linear.z) > 1) ||
         (fabs(cmd.twist.angular.x) > 1) || (fabs(cmd.twist.angular.y) > 1) || (fabs(cmd.twist.angular.z) > 1))
     {
-      rclcpp::Clock& clock = *node_->get_clock();
-      RCLCPP_WARN_STREAM_THROTTLE(LOGGER, clock, ROS_LOG_THROTTLE_PERIOD,
-                                  "Component of incoming command is >1. Skipping this datapoint.");
+      deferred_logger_.log(RCUTILS_LOG_SEVERITY_WARN, "Component of incoming command is >1. Skipping this datapoint.");
       return false;
     }
   }
@@ -1107,9 +1364,9 @@ bool ServoCalcs::checkValidCommand(const geometry_msgs::msg::TwistStamped& cmd)
 }
 
 // Scale the incoming jog command. Returns a vector of position deltas
-Eigen::VectorXd ServoCalcs::scaleCartesianCommand(const geometry_msgs::msg::TwistStamped& command)
+Eigen::Matrix<double, 6, 1> ServoCalcs::scaleCartesianCommand(const geometry_msgs::msg::TwistStamped& command)
 {
-  Eigen::VectorXd result(6);
+  Eigen::Matrix<double, 6, 1> result;
   result.setZero();  // Or the else case below leads to misery
 
   // Apply user-defined scaling if inputs are unitless [-1:1]
@@ -1134,8 +1391,7 @@ Eigen::VectorXd ServoCalcs::scaleCartesianCommand(const geometry_msgs::msg::Twis
   }
   else
   {
-    rclcpp::Clock& clock = *node_->get_clock();
-    RCLCPP_ERROR_STREAM_THROTTLE(LOGGER, clock, ROS_LOG_THROTTLE_PERIOD, "Unexpected command_in_type");
+    deferred_logger_.log(RCUTILS_LOG_SEVERITY_ERROR, "Unexpected command_in_type");
   }
 
   return result;
@@ -1143,8 +1399,15 @@ Eigen::VectorXd ServoCalcs::scaleCartesianCommand(const geometry_msgs::msg::Twis
 
 Eigen::VectorXd ServoCalcs::scaleJointCommand(const control_msgs::msg::JointJog& command)
 {
-  Eigen::VectorXd result(num_joints_);
-  result.setZero();
+  Eigen::ArrayXd result;
+  scaleJointCommand(command, result);
+  return result.matrix();
+}
+
+void ServoCalcs::scaleJointCommand(const control_msgs::msg::JointJog& command, Eigen::ArrayXd& result)
+{
+  // setZero() keeps the storage when the size is unchanged
+  result.setZero(num_joints_);
 
   std::size_t c;
   for (std::size_t m = 0; m < command.joint_names.size(); ++m)
@@ -1155,8 +1418,7 @@ Eigen::VectorXd ServoCalcs::scaleJointCommand(const control_msgs::msg::JointJog&
     }
     catch (const std::out_of_range& e)
     {
-      rclcpp::Clock& clock = *node_->get_clock();
-      RCLCPP_WARN_STREAM_THROTTLE(LOGGER, clock, ROS_LOG_THROTTLE_PERIOD, "Ignoring joint " << command.joint_names[m]);
+      deferred_logger_.log(RCUTILS_LOG_SEVERITY_WARN, "Ignoring joint %s", command.joint_names[m].c_str());
       continue;
     }
     // Apply user-defined scaling if inputs are unitless [-1:1]
@@ -1167,13 +1429,9 @@ Eigen::VectorXd ServoCalcs::scaleJointCommand(const control_msgs::msg::JointJog&
       result[c] = command.velocities[m] * parameters_->publish_period;
     else
     {
-      rclcpp::Clock& clock = *node_->get_clock();
-      RCLCPP_ERROR_STREAM_THROTTLE(LOGGER, clock, ROS_LOG_THROTTLE_PERIOD,
-                                   "Unexpected command_in_type, check yaml file.");
+      deferred_logger_.log(RCUTILS_LOG_SEVERITY_ERROR, "Unexpected command_in_type, check yaml file.");
     }
   }
-
-  return result;
 }
 
 void ServoCalcs::removeDimension(Eigen::MatrixXd& jacobian, Eigen::VectorXd& delta_x, unsigned int row_to_remove) const
@@ -1272,6 +1530,16 @@ bool ServoCalcs::getEEFrameTransform(geometry_msgs::msg::TransformStamped& trans
 
 void ServoCalcs::twistStampedCB(const geometry_msgs::msg::TwistStamped::SharedPtr msg)
 {
+  if (parameters_->realtime_mode)
+  {
+    if (!twist_queue_.push(msg))
+    {
+      rclcpp::Clock& clock = *node_->get_clock();
+      RCLCPP_WARN_THROTTLE(LOGGER, clock, ROS_LOG_THROTTLE_PERIOD.count(), "Twist command queue is full");
+    }
+    return;
+  }
+
   const std::lock_guard<std::mutex> lock(main_loop_mutex_);
   latest_twist_stamped_ = msg;
   latest_twist_cmd_is_nonzero_ = isNonZero(*latest_twist_stamped_.get());
@@ -1286,6 +1554,16 @@ void ServoCalcs::twistStampedCB(const geometry_msgs::msg::TwistStamped::SharedPt
 
 void ServoCalcs::jointCmdCB(const control_msgs::msg::JointJog::SharedPtr msg)
 {
+  if (parameters_->realtime_mode)
+  {
+    if (!joint_cmd_queue_.push(msg))
+    {
+      rclcpp::Clock& clock = *node_->get_clock();
+      RCLCPP_WARN_THROTTLE(LOGGER, clock, ROS_LOG_THROTTLE_PERIOD.count(), "Joint command queue is full");
+    }
+    return;
+  }
+
   const std::lock_guard<std::mutex> lock(main_loop_mutex_);
   latest_joint_cmd_ = msg;
   latest_joint_cmd_is_nonzero_ = isNonZero(*latest_joint_cmd_.get());
@@ -1298,6 +1576,139 @@ void ServoCalcs::jointCmdCB(const control_msgs::msg::JointJog::SharedPtr msg)
   input_cv_.notify_all();
 }
 
+void ServoCalcs::jointStateCB(const sensor_msgs::msg::JointState::SharedPtr msg)
+{
+  // The loop only consumes joint states while running
+  if (stop_requested_)
+    return;
+
+  // Drop the joints that are not part of the robot model here, so the realtime loop can apply the message directly
+  const moveit::core::RobotModelConstPtr& robot_model = planning_scene_monitor_->getRobotModel();
+  auto filtered = std::make_shared<sensor_msgs::msg::JointState>();
+  const bool has_velocities = msg->velocity.size() == msg->name.size();
+  for (std::size_t i = 0; i < msg->name.size() && i < msg->position.size(); ++i)
+  {
+    if (!robot_model->hasJointModel(msg->name[i]) || robot_model->getJointModel(msg->name[i])->getVariableCount() != 1)
+      continue;
+    filtered->name.push_back(msg->name[i]);
+    filtered->position.push_back(msg->position[i]);
+    if (has_velocities)
+      filtered->velocity.push_back(msg->velocity[i]);
+  }
+
+  if (!joint_state_queue_.push(std::move(filtered)))
+  {
+    rclcpp::Clock& clock = *node_->get_clock();
+    RCLCPP_WARN_THROTTLE(LOGGER, clock, ROS_LOG_THROTTLE_PERIOD.count(), "Joint state queue is full");
+  }
+}
+
+void ServoCalcs::popLatestCommands()
+{
+  geometry_msgs::msg::TwistStamped::ConstSharedPtr twist;
+  while (twist_queue_.pop(twist))
+  {
+    retireMessage(std::move(latest_twist_stamped_));
+    latest_twist_stamped_ = std::move(twist);
+    latest_twist_cmd_is_nonzero_ = isNonZero(*latest_twist_stamped_);
+    if (latest_twist_stamped_->header.stamp != rclcpp::Time(0.))
+      latest_twist_command_stamp_ = latest_twist_stamped_->header.stamp;
+  }
+
+  control_msgs::msg::JointJog::ConstSharedPtr joint_cmd;
+  while (joint_cmd_queue_.pop(joint_cmd))
+  {
+    retireMessage(std::move(latest_joint_cmd_));
+    latest_joint_cmd_ = std::move(joint_cmd);
+    latest_joint_cmd_is_nonzero_ = isNonZero(*latest_joint_cmd_);
+    if (latest_joint_cmd_->header.stamp != rclcpp::Time(0.))
+      latest_joint_command_stamp_ = latest_joint_cmd_->header.stamp;
+  }
+}
+
+void ServoCalcs::popDirectCommands()
+{
+  if (direct_twist_slot_.read(direct_twist_))
+  {
+    direct_twist_cmd_->header.stamp = node_->now();
+    direct_twist_cmd_->twist.linear.x = direct_twist_[0];
+    direct_twist_cmd_->twist.linear.y = direct_twist_[1];
+    direct_twist_cmd_->twist.linear.z = direct_twist_[2];
+    direct_twist_cmd_->twist.angular.x = direct_twist_[3];
+    direct_twist_cmd_->twist.angular.y = direct_twist_[4];
+    direct_twist_cmd_->twist.angular.z = direct_twist_[5];
+    if (parameters_->realtime_mode)
+      retireMessage(std::move(latest_twist_stamped_));
+    latest_twist_stamped_ = direct_twist_cmd_;
+    latest_twist_cmd_is_nonzero_ = isNonZero(*direct_twist_cmd_);
+    latest_twist_command_stamp_ = direct_twist_cmd_->header.stamp;
+  }
+
+  if (direct_joint_slot_->read(direct_joint_velocities_))
+  {
+    direct_joint_cmd_->header.stamp = node_->now();
+    for (std::size_t i = 0; i < num_joints_; ++i)
+      direct_joint_cmd_->velocities[i] = direct_joint_velocities_[i];
+    if (parameters_->realtime_mode)
+      retireMessage(std::move(latest_joint_cmd_));
+    latest_joint_cmd_ = direct_joint_cmd_;
+    latest_joint_cmd_is_nonzero_ = isNonZero(*direct_joint_cmd_);
+    latest_joint_command_stamp_ = direct_joint_cmd_->header.stamp;
+  }
+}
+
+void ServoCalcs::setTwistCommand(const Eigen::Matrix<double, 6, 1>& twist)
+{
+  direct_twist_slot_.write(twist);
+  notifyDirectCommand();
+}
+
+bool ServoCalcs::setJointCommand(const Eigen::VectorXd& velocities)
+{
+  if (static_cast<std::size_t>(velocities.size()) != num_joints_)
+  {
+    rclcpp::Clock& clock = *node_->get_clock();
+    RCLCPP_WARN_STREAM_THROTTLE(LOGGER, clock, ROS_LOG_THROTTLE_PERIOD.count(),
+                                "Joint command has " << velocities.size() << " velocities for " << num_joints_
+                                                     << " joints. Ignoring it");
+    return false;
+  }
+  direct_joint_slot_->write(velocities);
+  notifyDirectCommand();
+  return true;
+}
+
+void ServoCalcs::notifyDirectCommand()
+{
+  // The other loops poll the slots every iteration
+  if (!parameters_->low_latency_mode || parameters_->realtime_mode)
+    return;
+  const std::lock_guard<std::mutex> lock(main_loop_mutex_);
+  new_input_cmd_ = true;
+  input_cv_.notify_all();
+}
+
+void ServoCalcs::setCommandCallback(CommandCallback callback)
+{
+  const std::lock_guard<std::mutex> lock(main_loop_mutex_);
+  command_callback_ = std::move(callback);
+}
+
+void ServoCalcs::retireMessage(std::shared_ptr<const void> message)
+{
+  // Hand the last reference to the housekeeping thread, so the message is not freed on the realtime thread.
+  // If that queue is full the message is freed here, which is slower but still correct
+  if (message)
+    retired_messages_.push(std::move(message));
+}
+
+void ServoCalcs::releaseRetiredMessages()
+{
+  std::shared_ptr<const void> message;
+  while (retired_messages_.pop(message))
+    message.reset();
+}
+
 void ServoCalcs::collisionVelocityScaleCB(const std_msgs::msg::Float64::SharedPtr msg)
 {
   collision_velocity_scale_ = msg.get()->data;
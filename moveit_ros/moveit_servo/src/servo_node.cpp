@@ -76,14 +76,29 @@ ServoNode::ServoNode(const rclcpp::NodeOptions& options)
   std::string robot_description_name = "robot_description";
   node_->get_parameter_or("robot_description_name", robot_description_name, robot_description_name);
 
-  // Get the servo parameters
-  auto servo_parameters = moveit_servo::ServoParameters::makeServoParameters(node_);
-  if (servo_parameters == nullptr)
+  // Several groups, e.g. the arms of a dual-arm cell, can be servoed by one node. Each has its own parameter namespace
+  std::vector<std::string> group_namespaces = { "moveit_servo" };
+  node_->get_parameter_or("servo_group_namespaces", group_namespaces, group_namespaces);
+  if (group_namespaces.empty())
   {
-    RCLCPP_ERROR(LOGGER, "Failed to load the servo parameters");
+    RCLCPP_ERROR(LOGGER, "servo_group_namespaces needs at least one parameter namespace");
     throw std::runtime_error("Failed to load the servo parameters");
   }
 
+  // Get the servo parameters
+  std::vector<moveit_servo::ServoParameters::SharedConstPtr> group_parameters;
+  for (const std::string& ns : group_namespaces)
+  {
+    group_parameters.push_back(moveit_servo::ServoParameters::makeServoParameters(node_, ns));
+    if (group_parameters.back() == nullptr)
+    {
+      RCLCPP_ERROR_STREAM(LOGGER, "Failed to load the servo parameters in namespace `" << ns << "`");
+      throw std::runtime_error("Failed to load the servo parameters");
+    }
+  }
+  // The shared planning scene and state monitors are configured by the first group
+  const auto& servo_parameters = group_parameters.front();
+
   // Set up planning_scene_monitor
   planning_scene_monitor_ = std::make_shared<planning_scene_monitor::PlanningSceneMonitor>(
       node_, robot_description_name, "planning_scene_monitor");
@@ -103,7 +118,7 @@ ServoNode::ServoNode(const rclcpp::NodeOptions& options)
     planning_scene_monitor_->requestPlanningSceneState();
 
   // Create Servo
-  servo_ = std::make_unique<moveit_servo::Servo>(node_, servo_parameters, planning_scene_monitor_);
+  servo_ = std::make_unique<moveit_servo::Servo>(node_, group_parameters, planning_scene_monitor_);
 }
 
 void ServoNode::startCB(const std::shared_ptr<std_srvs::srv::Trigger::Request> /* unused */,
@@ -176,6 +176,11 @@ void ServoParameters::declare(const std::string& ns,
           .description("What to publish? Can save some bandwidth as most robots only require positions or velocities"));
   node_parameters->declare_parameter(ns + ".low_latency_mode", ParameterValue{ parameters.low_latency_mode },
                                      ParameterDescriptorBuilder{}.type(PARAMETER_BOOL).description("Low latency mode"));
+  node_parameters->declare_parameter(
+      ns + ".realtime_mode", ParameterValue{ parameters.realtime_mode },
+      ParameterDescriptorBuilder{}
+          .type(PARAMETER_BOOL)
+          .description("Run the main loop on absolute deadlines and pass inputs through lock-free queues"));
 
   // Incoming Joint State properties
   node_parameters->declare_parameter(ns + ".joint_topic", ParameterValue{ parameters.joint_topic },
@@ -245,6 +250,18 @@ void ServoParameters::declare(const std::string& ns,
           .type(PARAMETER_DOUBLE)
           .description("[Hz] Collision-checking can easily bog down a CPU if done too often. Collision checking begins "
                        "slowing down when nearer than a specified distance."));
+  node_parameters->declare_parameter(
+      ns + ".adaptive_collision_check_rate", ParameterValue{ parameters.adaptive_collision_check_rate },
+      ParameterDescriptorBuilder{}
+          .type(PARAMETER_BOOL)
+          .description("Adapt the collision check rate to the clearance and the joint speed, between "
+                       "collision_check_rate far from obstacles and max_collision_check_rate near them"));
+  node_parameters->declare_parameter(ns + ".max_collision_check_rate",
+                                     ParameterValue{ parameters.max_collision_check_rate },
+                                     ParameterDescriptorBuilder{}
+                                         .type(PARAMETER_DOUBLE)
+                                         .description("[Hz] Collision check rate near obstacles, if "
+                                                      "adaptive_collision_check_rate"));
   node_parameters->declare_parameter(ns + ".self_collision_proximity_threshold",
                                      ParameterValue{ parameters.self_collision_proximity_threshold },
                                      ParameterDescriptorBuilder{}
@@ -255,6 +272,22 @@ void ServoParameters::declare(const std::string& ns,
                                      ParameterDescriptorBuilder{}
                                          .type(PARAMETER_DOUBLE)
                                          .description("Start decelerating when a scene collision is this far [m]"));
+  node_parameters->declare_parameter(
+      ns + ".use_proximity_field", ParameterValue{ parameters.use_proximity_field },
+      ParameterDescriptorBuilder{}
+          .type(PARAMETER_BOOL)
+          .description("Estimate the scene collision distance every servo cycle from a distance field of the world. "
+                       "Scene collision checks with FCL then only run when the robot is near an obstacle."));
+  node_parameters->declare_parameter(ns + ".proximity_field_size", ParameterValue{ parameters.proximity_field_size },
+                                     ParameterDescriptorBuilder{}
+                                         .type(PARAMETER_DOUBLE)
+                                         .description("Edge length of the distance field, centered on the robot "
+                                                      "model frame [m]"));
+  node_parameters->declare_parameter(ns + ".proximity_field_resolution",
+                                     ParameterValue{ parameters.proximity_field_resolution },
+                                     ParameterDescriptorBuilder{}
+                                         .type(PARAMETER_DOUBLE)
+                                         .description("Voxel size of the distance field [m]"));
 }
 
 ServoParameters ServoParameters::get(const std::string& ns,
@@ -289,6 +322,7 @@ ServoParameters ServoParameters::get(const std::string& ns,
   parameters.publish_joint_accelerations =
       node_parameters->get_parameter(ns + ".publish_joint_accelerations").as_bool();
   parameters.low_latency_mode = node_parameters->get_parameter(ns + ".low_latency_mode").as_bool();
+  parameters.realtime_mode = node_parameters->get_parameter(ns + ".realtime_mode").as_bool();
 
   // Incoming Joint State properties
   parameters.joint_topic = node_parameters->get_parameter(ns + ".joint_topic").as_string();
@@ -323,10 +357,18 @@ ServoParameters ServoParameters::get(const std::string& ns,
   // Collision checking
   parameters.check_collisions = node_parameters->get_parameter(ns + ".check_collisions").as_bool();
   parameters.collision_check_rate = node_parameters->get_parameter(ns + ".collision_check_rate").as_double();
+  parameters.adaptive_collision_check_rate =
+      node_parameters->get_parameter(ns + ".adaptive_collision_check_rate").as_bool();
+  parameters.max_collision_check_rate =
+      node_parameters->get_parameter(ns + ".max_collision_check_rate").as_double();
   parameters.self_collision_proximity_threshold =
       node_parameters->get_parameter(ns + ".self_collision_proximity_threshold").as_double();
   parameters.scene_collision_proximity_threshold =
       node_parameters->get_parameter(ns + ".scene_collision_proximity_threshold").as_double();
+  parameters.use_proximity_field = node_parameters->get_parameter(ns + ".use_proximity_field").as_bool();
+  parameters.proximity_field_size = node_parameters->get_parameter(ns + ".proximity_field_size").as_double();
+  parameters.proximity_field_resolution =
+      node_parameters->get_parameter(ns + ".proximity_field_resolution").as_double();
 
   return parameters;
 }
@@ -370,6 +412,11 @@ std::optional<ServoParameters> ServoParameters::validate(ServoParameters paramet
                         "although negative values can be used if the specified joint limits are actually soft. "
                         "Check yaml file.");
   }
+  if (parameters.realtime_mode && parameters.low_latency_mode)
+  {
+    RCLCPP_WARN(LOGGER, "Parameter 'low_latency_mode' is ignored when 'realtime_mode' is enabled. "
+                        "The main loop runs at 'publish_period'.");
+  }
   if (parameters.command_in_type != "unitless" && parameters.command_in_type != "speed_units")
   {
     RCLCPP_WARN(LOGGER, "command_in_type should be 'unitless' or "
@@ -424,6 +471,20 @@ std::optional<ServoParameters> ServoParameters::validate(ServoParameters paramet
                         "greater than zero. Check yaml file.");
     return std::nullopt;
   }
+  if (parameters.adaptive_collision_check_rate &&
+      parameters.max_collision_check_rate < parameters.collision_check_rate)
+  {
+    RCLCPP_WARN(LOGGER, "Parameter 'max_collision_check_rate' should be greater than or equal to "
+                        "'collision_check_rate'. Check yaml file.");
+    return std::nullopt;
+  }
+  if (parameters.use_proximity_field &&
+      (parameters.proximity_field_size <= 0. || parameters.proximity_field_resolution <= 0.))
+  {
+    RCLCPP_WARN(LOGGER, "Parameters 'proximity_field_size' and 'proximity_field_resolution' should be "
+                        "greater than zero. Check yaml file.");
+    return std::nullopt;
+  }
   return parameters;
 }
 
@@ -0,0 +1,133 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+
+#include <moveit_servo/target_motion.h>
+
+namespace moveit_servo
+{
+namespace
+{
+// Rotation by the angular velocity \e omega applied for \e duration, expressed in the frame of \e omega
+Eigen::Matrix3d integrateAngularVelocity(const Eigen::Vector3d& omega, double duration)
+{
+  const double speed = omega.norm();
+  if (speed < 1e-12)
+    return Eigen::Matrix3d::Identity();
+  return Eigen::AngleAxisd(speed * duration, omega / speed).toRotationMatrix();
+}
+}  // namespace
+
+void TargetMotion::clear()
+{
+  is_trajectory_ = false;
+  times_.clear();
+  poses_.clear();
+  twist_.setZero();
+}
+
+void TargetMotion::setConstantVelocity(double time, const Eigen::Isometry3d& pose,
+                                       const Eigen::Matrix<double, 6, 1>& twist)
+{
+  is_trajectory_ = false;
+  times_.assign(1, time);
+  poses_.assign(1, pose);
+  twist_ = twist;
+}
+
+bool TargetMotion::setTrajectory(const std::vector<double>& times, const EigenSTL::vector_Isometry3d& poses)
+{
+  clear();
+  if (times.empty() || times.size() != poses.size() ||
+      std::adjacent_find(times.begin(), times.end(), std::greater_equal<double>()) != times.end())
+    return false;
+
+  is_trajectory_ = true;
+  times_ = times;
+  poses_ = poses;
+  return true;
+}
+
+bool TargetMotion::predict(double time, Eigen::Isometry3d& pose, Eigen::Matrix<double, 6, 1>& twist) const
+{
+  if (empty())
+    return false;
+
+  if (!is_trajectory_)
+  {
+    const double duration = time - times_.front();
+    pose = poses_.front();
+    pose.translation() += twist_.head<3>() * duration;
+    pose.linear() = integrateAngularVelocity(twist_.tail<3>(), duration) * poses_.front().linear();
+    twist = twist_;
+    return true;
+  }
+
+  // At rest outside of the time span of the waypoints
+  twist.setZero();
+  if (time <= times_.front())
+  {
+    pose = poses_.front();
+    return true;
+  }
+  if (time >= times_.back())
+  {
+    pose = poses_.back();
+    return true;
+  }
+
+  // Interpolate within the segment [before, after] that contains time
+  const auto after = std::upper_bound(times_.begin(), times_.end(), time);
+  const std::size_t segment = std::distance(times_.begin(), after) - 1;
+  const double duration = times_[segment + 1] - times_[segment];
+  const double fraction = (time - times_[segment]) / duration;
+  const Eigen::Isometry3d& start = poses_[segment];
+  const Eigen::Isometry3d& end = poses_[segment + 1];
+
+  const Eigen::Quaterniond start_rotation(start.linear());
+  const Eigen::Quaterniond end_rotation(end.linear());
+  pose = Eigen::Isometry3d::Identity();
+  pose.translation() = start.translation() + fraction * (end.translation() - start.translation());
+  pose.linear() = start_rotation.slerp(fraction, end_rotation).toRotationMatrix();
+
+  // Constant twist along the segment
+  const Eigen::AngleAxisd rotation(end.linear() * start.linear().transpose());
+  twist.head<3>() = (end.translation() - start.translation()) / duration;
+  twist.tail<3>() = rotation.axis() * rotation.angle() / duration;
+  return true;
+}
+}  // namespace moveit_servo
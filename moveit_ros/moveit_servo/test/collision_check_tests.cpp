@@ -0,0 +1,72 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Desc: Unit tests of the adaptive collision check rate
+ */
+
+#include <gtest/gtest.h>
+#include <moveit_servo/collision_check.h>
+
+namespace
+{
+constexpr double MIN_PERIOD = 0.01;
+constexpr double MAX_PERIOD = 0.1;
+}  // namespace
+
+TEST(CollisionCheckTests, AdaptivePeriodShrinksWithClearance)
+{
+  // Half of the clearance is closed within a period
+  EXPECT_DOUBLE_EQ(moveit_servo::adaptiveCollisionCheckPeriod(0.1, 1.0, MIN_PERIOD, MAX_PERIOD), 0.05);
+  EXPECT_DOUBLE_EQ(moveit_servo::adaptiveCollisionCheckPeriod(0.05, 1.0, MIN_PERIOD, MAX_PERIOD), 0.025);
+
+  // Faster motion checks more often
+  EXPECT_DOUBLE_EQ(moveit_servo::adaptiveCollisionCheckPeriod(0.1, 2.0, MIN_PERIOD, MAX_PERIOD), 0.025);
+}
+
+TEST(CollisionCheckTests, AdaptivePeriodIsBounded)
+{
+  EXPECT_DOUBLE_EQ(moveit_servo::adaptiveCollisionCheckPeriod(10.0, 1.0, MIN_PERIOD, MAX_PERIOD), MAX_PERIOD);
+  EXPECT_DOUBLE_EQ(moveit_servo::adaptiveCollisionCheckPeriod(0.001, 1.0, MIN_PERIOD, MAX_PERIOD), MIN_PERIOD);
+
+  // A robot at rest is checked at the lowest rate, a breached threshold at the highest
+  EXPECT_DOUBLE_EQ(moveit_servo::adaptiveCollisionCheckPeriod(0.1, 0.0, MIN_PERIOD, MAX_PERIOD), MAX_PERIOD);
+  EXPECT_DOUBLE_EQ(moveit_servo::adaptiveCollisionCheckPeriod(0.0, 0.0, MIN_PERIOD, MAX_PERIOD), MIN_PERIOD);
+  EXPECT_DOUBLE_EQ(moveit_servo::adaptiveCollisionCheckPeriod(-0.01, 1.0, MIN_PERIOD, MAX_PERIOD), MIN_PERIOD);
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,130 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Desc: Distance field based proximity check unit tests
+ */
+
+#include <gtest/gtest.h>
+#include <geometric_shapes/shapes.h>
+#include <moveit/collision_detection/world.h>
+#include <moveit/robot_state/robot_state.h>
+#include <moveit/utils/robot_model_test_utils.h>
+#include <moveit_servo/proximity_check.h>
+
+#include <memory>
+#include <vector>
+
+namespace
+{
+constexpr double FIELD_SIZE = 3.0;
+constexpr double RESOLUTION = 0.02;
+constexpr double PROXIMITY_THRESHOLD = 0.2;
+
+class ProximityCheckTests : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    robot_model_ = moveit::core::loadTestingRobotModel("panda");
+    joint_model_group_ = robot_model_->getJointModelGroup("panda_arm");
+    robot_state_ = std::make_shared<moveit::core::RobotState>(robot_model_);
+    robot_state_->setToDefaultValues();
+    const std::vector<double> ready_positions{ 0, -0.785, 0, -2.356, 0, 1.571, 0.785 };
+    robot_state_->setJointGroupPositions(joint_model_group_, ready_positions);
+    robot_state_->update();
+    flange_pose_ = robot_state_->getGlobalLinkTransform("panda_link8");
+  }
+
+  // Pose of a box that is \e offset away from the flange, along the direction the hand points to
+  Eigen::Isometry3d boxPose(double offset) const
+  {
+    return flange_pose_ * Eigen::Translation3d(0.0, 0.0, offset);
+  }
+
+  moveit::core::RobotModelPtr robot_model_;
+  const moveit::core::JointModelGroup* joint_model_group_;
+  moveit::core::RobotStatePtr robot_state_;
+  Eigen::Isometry3d flange_pose_;
+};
+
+}  // namespace
+
+TEST_F(ProximityCheckTests, EmptyWorldIsFar)
+{
+  moveit_servo::ProximityCheck proximity_check(joint_model_group_, FIELD_SIZE, RESOLUTION, PROXIMITY_THRESHOLD);
+  collision_detection::World world;
+  proximity_check.updateWorld(world);
+
+  EXPECT_GE(proximity_check.getDistance(*robot_state_), proximity_check.getReliableDistance());
+  EXPECT_DOUBLE_EQ(proximity_check.getVelocityScale(*robot_state_), 1.0);
+}
+
+TEST_F(ProximityCheckTests, FollowsWorldChanges)
+{
+  moveit_servo::ProximityCheck proximity_check(joint_model_group_, FIELD_SIZE, RESOLUTION, PROXIMITY_THRESHOLD);
+  collision_detection::World world;
+  const auto box = std::make_shared<const shapes::Box>(0.1, 0.1, 0.1);
+
+  // A box enclosing the flange is in contact
+  world.addToObject("box", boxPose(0.0), box, Eigen::Isometry3d::Identity());
+  proximity_check.updateWorld(world);
+  const double contact_distance = proximity_check.getDistance(*robot_state_);
+  EXPECT_LT(contact_distance, RESOLUTION);
+  EXPECT_LT(proximity_check.getVelocityScale(*robot_state_), 0.01);
+
+  // Move it in front of the fingers, within the proximity threshold
+  world.setObjectPose("box", boxPose(0.3));
+  proximity_check.updateWorld(world);
+  const double near_distance = proximity_check.getDistance(*robot_state_);
+  EXPECT_GT(near_distance, contact_distance);
+  EXPECT_LT(near_distance, proximity_check.getReliableDistance());
+
+  // Move it out of range, then remove it
+  world.setObjectPose("box", boxPose(0.7));
+  proximity_check.updateWorld(world);
+  EXPECT_GE(proximity_check.getDistance(*robot_state_), proximity_check.getReliableDistance());
+
+  world.setObjectPose("box", boxPose(0.0));
+  proximity_check.updateWorld(world);
+  EXPECT_LT(proximity_check.getDistance(*robot_state_), RESOLUTION);
+  world.removeObject("box");
+  proximity_check.updateWorld(world);
+  EXPECT_GE(proximity_check.getDistance(*robot_state_), proximity_check.getReliableDistance());
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,185 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Desc: Lock-free queue and deferred logger unit tests
+ */
+
+#include <gtest/gtest.h>
+#include <moveit_servo/realtime_utils.h>
+
+#include <array>
+#include <memory>
+#include <thread>
+
+TEST(SPSCQueueTests, FifoOrderAndCapacity)
+{
+  moveit_servo::SPSCQueue<int, 4> queue;
+  int value = 0;
+  EXPECT_FALSE(queue.pop(value));
+
+  for (int i = 0; i < 4; ++i)
+    EXPECT_TRUE(queue.push(i));
+  EXPECT_FALSE(queue.push(4)) << "A full queue must reject new elements";
+
+  for (int i = 0; i < 4; ++i)
+  {
+    ASSERT_TRUE(queue.pop(value));
+    EXPECT_EQ(value, i);
+  }
+  EXPECT_FALSE(queue.pop(value));
+}
+
+TEST(SPSCQueueTests, PopLatestDrainsQueue)
+{
+  moveit_servo::SPSCQueue<std::shared_ptr<int>, 8> queue;
+  for (int i = 0; i < 5; ++i)
+    queue.push(std::make_shared<int>(i));
+
+  std::shared_ptr<int> latest;
+  ASSERT_TRUE(queue.popLatest(latest));
+  EXPECT_EQ(*latest, 4);
+  EXPECT_FALSE(queue.popLatest(latest));
+  EXPECT_EQ(*latest, 4) << "An empty queue must leave the value untouched";
+}
+
+TEST(SPSCQueueTests, ConcurrentProducerConsumer)
+{
+  constexpr int COUNT = 100000;
+  moveit_servo::SPSCQueue<int, 64> queue;
+
+  std::thread producer([&queue] {
+    for (int i = 0; i < COUNT; ++i)
+    {
+      while (!queue.push(i))
+        std::this_thread::yield();
+    }
+  });
+
+  int expected = 0;
+  int value;
+  while (expected < COUNT)
+  {
+    if (queue.pop(value))
+    {
+      ASSERT_EQ(value, expected);
+      ++expected;
+    }
+  }
+  producer.join();
+}
+
+TEST(LatestValueSlotTests, KeepsOnlyTheLatestValue)
+{
+  moveit_servo::LatestValueSlot<int> slot;
+  int value = -1;
+  EXPECT_FALSE(slot.read(value));
+  EXPECT_EQ(value, -1) << "An empty slot must leave the value untouched";
+
+  slot.write(1);
+  slot.write(2);
+  ASSERT_TRUE(slot.read(value));
+  EXPECT_EQ(value, 2);
+  EXPECT_FALSE(slot.read(value)) << "A value must only be read once";
+
+  slot.write(3);
+  ASSERT_TRUE(slot.read(value));
+  EXPECT_EQ(value, 3);
+}
+
+TEST(LatestValueSlotTests, ConcurrentWriterReader)
+{
+  // The two halves of a value are written together, so a torn read would show different halves
+  constexpr int COUNT = 100000;
+  moveit_servo::LatestValueSlot<std::array<int, 2>> slot({ 0, 0 });
+
+  std::thread writer([&slot] {
+    for (int i = 1; i <= COUNT; ++i)
+      slot.write({ i, -i });
+  });
+
+  std::array<int, 2> value = { 0, 0 };
+  int last = 0;
+  while (last < COUNT)
+  {
+    if (slot.read(value))
+    {
+      ASSERT_EQ(value[0], -value[1]);
+      ASSERT_GT(value[0], last) << "Values must be read in the order they were written";
+      last = value[0];
+    }
+  }
+  writer.join();
+}
+
+TEST(DeferredLoggerTests, DropsWhenQueueIsFull)
+{
+  moveit_servo::DeferredLogger logger(rclcpp::get_logger("realtime_utils_tests"), std::chrono::seconds(0));
+  logger.setDeferred(true);
+  for (int i = 0; i < 100; ++i)
+    logger.log(RCUTILS_LOG_SEVERITY_DEBUG, "message %d", i);
+  EXPECT_GT(logger.getDroppedCount(), 0u);
+
+  logger.flush();
+  const auto dropped = logger.getDroppedCount();
+  logger.log(RCUTILS_LOG_SEVERITY_DEBUG, "message after flush");
+  EXPECT_EQ(logger.getDroppedCount(), dropped);
+}
+
+TEST(LatencyHistogramTests, Percentiles)
+{
+  moveit_servo::LatencyHistogram histogram;
+  EXPECT_EQ(histogram.getStatistics().count, 0u);
+
+  // 1 to 1000 microseconds
+  for (std::int64_t i = 1; i <= 1000; ++i)
+    histogram.record(i * 1000);
+  const moveit_servo::LatencyStatistics statistics = histogram.getStatistics();
+  EXPECT_EQ(statistics.count, 1000u);
+  EXPECT_EQ(statistics.max, 1000000);
+  // Percentiles are rounded up to a bucket that is at most 25% wide
+  EXPECT_GE(statistics.p50, 500000);
+  EXPECT_LE(statistics.p50, 625000);
+  EXPECT_GE(statistics.p99, 990000);
+  EXPECT_LE(statistics.p99, 1000000);
+
+  histogram.reset();
+  EXPECT_EQ(histogram.getStatistics().count, 0u);
+  EXPECT_EQ(histogram.getStatistics().max, 0);
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
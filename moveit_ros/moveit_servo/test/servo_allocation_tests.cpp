@@ -0,0 +1,178 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Desc: Check that the steady-state servo calculations do not allocate
+ */
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <moveit/robot_state/robot_state.h>
+#include <moveit/utils/robot_model_test_utils.h>
+#include <moveit_servo/enforce_limits.hpp>
+#include <moveit_servo/jacobian_workspace.h>
+
+namespace
+{
+std::atomic<std::size_t> g_allocation_count{ 0 };
+}  // namespace
+
+// Count every heap allocation of the test process
+void* operator new(std::size_t size)
+{
+  ++g_allocation_count;
+  if (void* ptr = std::malloc(size == 0 ? 1 : size))
+    return ptr;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t /*size*/) noexcept
+{
+  std::free(ptr);
+}
+
+namespace
+{
+constexpr double PUBLISH_PERIOD = 0.01;
+
+class ServoAllocationTests : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    robot_model_ = moveit::core::loadTestingRobotModel("panda");
+    joint_model_group_ = robot_model_->getJointModelGroup("panda_arm");
+    robot_state_ = std::make_shared<moveit::core::RobotState>(robot_model_);
+    robot_state_->setToDefaultValues();
+    const std::vector<double> ready_positions{ 0, -0.785, 0, -2.356, 0, 1.571, 0.785 };
+    robot_state_->setJointGroupPositions(joint_model_group_, ready_positions);
+    robot_state_->update();
+  }
+
+  moveit::core::RobotModelPtr robot_model_;
+  const moveit::core::JointModelGroup* joint_model_group_;
+  moveit::core::RobotStatePtr robot_state_;
+};
+
+}  // namespace
+
+TEST_F(ServoAllocationTests, JacobianWorkspaceDoesNotAllocate)
+{
+  moveit_servo::JacobianWorkspace workspace(joint_model_group_);
+  std::array<bool, 6> drift_dimensions = { { false, false, false, false, false, true } };
+  Eigen::Matrix<double, 6, 1> delta_x;
+  delta_x << 0.001, 0.0, -0.001, 0.0, 0.002, 0.0;
+  Eigen::VectorXd direction(5);
+  Eigen::VectorXd delta_theta(joint_model_group_->getVariableCount());
+
+  // The first iteration may still size internal buffers
+  ASSERT_TRUE(workspace.update(*robot_state_, drift_dimensions, delta_x));
+  direction = workspace.getSVD().matrixU().col(4);
+  workspace.lookAheadCondition(*robot_state_, direction, 100);
+
+  const std::size_t allocations_before = g_allocation_count.load();
+  for (std::size_t i = 0; i < 100; ++i)
+  {
+    ASSERT_TRUE(workspace.update(*robot_state_, drift_dimensions, delta_x));
+    delta_theta.noalias() = workspace.getPseudoInverse() * workspace.getDeltaX();
+    direction = workspace.getSVD().matrixU().col(4);
+    EXPECT_GE(workspace.lookAheadCondition(*robot_state_, direction, 100), 1.0);
+  }
+  EXPECT_EQ(g_allocation_count.load(), allocations_before);
+
+  // The reduced Jacobian only has the rows of the controlled dimensions
+  EXPECT_EQ(workspace.getJacobian().rows(), 5);
+  EXPECT_EQ(workspace.getPseudoInverse().cols(), 5);
+}
+
+TEST_F(ServoAllocationTests, JacobianWorkspaceMatchesPseudoInverse)
+{
+  moveit_servo::JacobianWorkspace workspace(joint_model_group_);
+  std::array<bool, 6> drift_dimensions = { { false, false, false, false, false, false } };
+  Eigen::Matrix<double, 6, 1> delta_x;
+  delta_x << 0.001, 0.0, -0.001, 0.0, 0.002, 0.0;
+  ASSERT_TRUE(workspace.update(*robot_state_, drift_dimensions, delta_x));
+
+  // J * J^+ is the identity for a full-rank 6xN Jacobian
+  const Eigen::MatrixXd identity = workspace.getJacobian() * workspace.getPseudoInverse();
+  EXPECT_TRUE(identity.isIdentity(1e-6));
+}
+
+TEST_F(ServoAllocationTests, LookAheadConditionMatchesFullDecomposition)
+{
+  moveit_servo::JacobianWorkspace workspace(joint_model_group_);
+  std::array<bool, 6> drift_dimensions = { { false, false, false, false, false, false } };
+  Eigen::Matrix<double, 6, 1> delta_x = Eigen::Matrix<double, 6, 1>::Zero();
+  ASSERT_TRUE(workspace.update(*robot_state_, drift_dimensions, delta_x));
+
+  // Step along the direction towards the nearest singularity, then decompose the Jacobian at the new state
+  const Eigen::VectorXd direction = workspace.getSVD().matrixU().col(5);
+  const double estimated_condition = workspace.lookAheadCondition(*robot_state_, direction, 100);
+  Eigen::JacobiSVD<Eigen::MatrixXd> svd(robot_state_->getJacobian(joint_model_group_));
+  const double condition = svd.singularValues()(0) / svd.singularValues()(5);
+
+  EXPECT_NEAR(estimated_condition, condition, 1e-2 * condition);
+}
+
+TEST_F(ServoAllocationTests, EnforceVelocityLimitsDoesNotAllocate)
+{
+  sensor_msgs::msg::JointState joint_state;
+  joint_state.position.assign(joint_model_group_->getVariableCount(), 0.0);
+  joint_state.velocity.assign(joint_model_group_->getVariableCount(), 0.0);
+
+  const std::size_t allocations_before = g_allocation_count.load();
+  for (std::size_t i = 0; i < 100; ++i)
+  {
+    // Request velocities that are too fast, so that both the positions and the velocities are scaled
+    std::fill(joint_state.velocity.begin(), joint_state.velocity.end(), 10.0);
+    moveit_servo::enforceVelocityLimits(joint_model_group_, PUBLISH_PERIOD, joint_state);
+  }
+  EXPECT_EQ(g_allocation_count.load(), allocations_before);
+  EXPECT_LT(joint_state.velocity[0], 10.0);
+  EXPECT_LT(joint_state.position[0], 0.0);
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
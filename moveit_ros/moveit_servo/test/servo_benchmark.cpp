@@ -0,0 +1,286 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Desc: Repeatable performance benchmark of the servo loop. A synthetic twist stream drives Servo while a
+ *       simulated robot feeds the commanded positions back as joint states. Reports the stage latencies and
+ *       loop jitter of Servo, the latency from a command to the first output after it, and the CPU usage.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include <moveit_servo/servo.h>
+#include <moveit_servo/servo_parameters.h>
+
+static const rclcpp::Logger LOGGER = rclcpp::get_logger("moveit_servo.servo_benchmark");
+
+namespace
+{
+// Current time of the monotonic clock, in nanoseconds
+std::int64_t monotonicNanoseconds()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// CPU time used by all threads of this process, in seconds
+double processCpuTime()
+{
+  rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return static_cast<double>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+         static_cast<double>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1e-6;
+}
+
+void printStatistics(const std::string& name, const moveit_servo::LatencyStatistics& statistics)
+{
+  std::cout << std::left << std::setw(28) << name << std::right << std::setw(10) << statistics.count << std::fixed
+            << std::setprecision(1) << std::setw(12) << statistics.p50 * 1e-3 << std::setw(12)
+            << statistics.p99 * 1e-3 << std::setw(12) << statistics.max * 1e-3 << '\n';
+}
+
+/**
+ * Simulated robot that follows the outgoing commands perfectly. It publishes the last commanded positions, or
+ * integrates the commanded velocities, as joint states at a fixed rate. That closes the loop through servo's state
+ * monitor like a real joint state broadcaster would.
+ */
+class SimulatedRobot
+{
+public:
+  SimulatedRobot(const rclcpp::Node::SharedPtr& node, const moveit::core::JointModelGroup* joint_model_group,
+                 const std::string& joint_topic, double rate)
+    : node_(node), period_(1.0 / rate), command_slot_(trajectory_msgs::msg::JointTrajectoryPoint())
+  {
+    joint_state_pub_ = node_->create_publisher<sensor_msgs::msg::JointState>(joint_topic, rclcpp::SystemDefaultsQoS());
+    joint_state_.name = joint_model_group->getActiveJointModelNames();
+    joint_state_.velocity.assign(joint_state_.name.size(), 0.0);
+
+    // Start in the "ready" pose of the Panda, away from singularities and joint limits
+    std::map<std::string, double> ready_state;
+    joint_model_group->getVariableDefaultPositions("ready", ready_state);
+    for (const std::string& name : joint_state_.name)
+      joint_state_.position.push_back(ready_state.count(name) ? ready_state.at(name) : 0.0);
+  }
+
+  ~SimulatedRobot()
+  {
+    stop_requested_ = true;
+    if (thread_.joinable())
+      thread_.join();
+  }
+
+  void start()
+  {
+    thread_ = std::thread([this] {
+      rclcpp::WallRate rate(1.0 / period_);
+      while (rclcpp::ok() && !stop_requested_)
+      {
+        step();
+        rate.sleep();
+      }
+    });
+  }
+
+  /** \brief Called with each outgoing command, on the servo loop thread */
+  void setCommand(const trajectory_msgs::msg::JointTrajectory& command)
+  {
+    if (!command.points.empty())
+      command_slot_.write(command.points[0]);
+  }
+
+private:
+  void step()
+  {
+    if (command_slot_.read(command_))
+    {
+      if (command_.positions.size() == joint_state_.position.size())
+        joint_state_.position = command_.positions;
+      if (command_.velocities.size() == joint_state_.velocity.size())
+        joint_state_.velocity = command_.velocities;
+    }
+    else
+    {
+      // Keep moving with the last commanded velocities until the next command
+      for (std::size_t i = 0; i < joint_state_.position.size(); ++i)
+        joint_state_.position[i] += joint_state_.velocity[i] * period_;
+    }
+    joint_state_.header.stamp = node_->now();
+    joint_state_pub_->publish(joint_state_);
+  }
+
+  rclcpp::Node::SharedPtr node_;
+  const double period_;
+  rclcpp::Publisher<sensor_msgs::msg::JointState>::SharedPtr joint_state_pub_;
+  sensor_msgs::msg::JointState joint_state_;
+  moveit_servo::LatestValueSlot<trajectory_msgs::msg::JointTrajectoryPoint> command_slot_;
+  trajectory_msgs::msg::JointTrajectoryPoint command_;
+  std::atomic<bool> stop_requested_{ false };
+  std::thread thread_;
+};
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  rclcpp::init(argc, argv);
+  rclcpp::Node::SharedPtr node = rclcpp::Node::make_shared("servo_benchmark");
+
+  const double duration = node->declare_parameter<double>("benchmark.duration", 10.0);
+  const double command_rate = node->declare_parameter<double>("benchmark.command_rate", 100.0);
+  const double joint_state_rate = node->declare_parameter<double>("benchmark.joint_state_rate", 500.0);
+  const double twist_amplitude = node->declare_parameter<double>("benchmark.twist_amplitude", 0.5);
+  const double twist_frequency = node->declare_parameter<double>("benchmark.twist_frequency", 0.25);
+  // Send the commands and receive the outputs through topics instead of the direct C++ API
+  const bool use_topics = node->declare_parameter<bool>("benchmark.use_topics", false);
+
+  rclcpp::executors::MultiThreadedExecutor executor;
+  executor.add_node(node);
+  std::thread executor_thread([&executor]() { executor.spin(); });
+
+  auto servo_parameters = moveit_servo::ServoParameters::makeServoParameters(node);
+  if (servo_parameters == nullptr)
+  {
+    RCLCPP_FATAL(LOGGER, "Could not get servo parameters!");
+    exit(EXIT_FAILURE);
+  }
+
+  auto planning_scene_monitor =
+      std::make_shared<planning_scene_monitor::PlanningSceneMonitor>(node, "robot_description");
+  if (!planning_scene_monitor->getPlanningScene())
+  {
+    RCLCPP_ERROR_STREAM(LOGGER, "Error in setting up the PlanningSceneMonitor.");
+    exit(EXIT_FAILURE);
+  }
+  planning_scene_monitor->startStateMonitor(servo_parameters->joint_topic);
+  planning_scene_monitor->getStateMonitor()->enableCopyDynamics(true);
+
+  const moveit::core::JointModelGroup* joint_model_group =
+      planning_scene_monitor->getRobotModel()->getJointModelGroup(servo_parameters->move_group_name);
+  SimulatedRobot robot(node, joint_model_group, servo_parameters->joint_topic, joint_state_rate);
+  robot.start();
+
+  moveit_servo::Servo servo(node, servo_parameters, planning_scene_monitor);
+
+  // Measure the time from sending a command to the first output after it
+  moveit_servo::LatencyHistogram command_latency;
+  std::atomic<std::int64_t> command_time_ns{ 0 };
+  std::atomic<bool> command_pending{ false };
+  const auto on_output = [&](const trajectory_msgs::msg::JointTrajectory& command) {
+    if (command_pending.exchange(false))
+      command_latency.record(monotonicNanoseconds() - command_time_ns.load());
+    robot.setCommand(command);
+  };
+
+  rclcpp::Publisher<geometry_msgs::msg::TwistStamped>::SharedPtr twist_pub;
+  rclcpp::Subscription<trajectory_msgs::msg::JointTrajectory>::SharedPtr output_sub;
+  if (use_topics)
+  {
+    twist_pub = node->create_publisher<geometry_msgs::msg::TwistStamped>(servo_parameters->cartesian_command_in_topic,
+                                                                         rclcpp::SystemDefaultsQoS());
+    output_sub = node->create_subscription<trajectory_msgs::msg::JointTrajectory>(
+        servo_parameters->command_out_topic, rclcpp::SystemDefaultsQoS(),
+        [&on_output](const trajectory_msgs::msg::JointTrajectory::ConstSharedPtr msg) { on_output(*msg); });
+  }
+  else
+  {
+    servo.setCommandCallback(on_output);
+  }
+
+  servo.start();
+
+  // Stream a smooth twist through all six dimensions, so the Jacobian keeps changing
+  rclcpp::WallRate rate(command_rate);
+  const double start_cpu_time = processCpuTime();
+  const std::int64_t start_ns = monotonicNanoseconds();
+  geometry_msgs::msg::TwistStamped twist;
+  twist.header.frame_id = servo_parameters->robot_link_command_frame;
+  for (double t = 0.0; rclcpp::ok() && t < duration; t = (monotonicNanoseconds() - start_ns) * 1e-9)
+  {
+    Eigen::Matrix<double, 6, 1> command;
+    for (std::size_t i = 0; i < 6; ++i)
+      command[i] = twist_amplitude * std::sin(2.0 * M_PI * twist_frequency * t + static_cast<double>(i));
+
+    command_time_ns = monotonicNanoseconds();
+    command_pending = true;
+    if (use_topics)
+    {
+      twist.header.stamp = node->now();
+      twist.twist.linear.x = command[0];
+      twist.twist.linear.y = command[1];
+      twist.twist.linear.z = command[2];
+      twist.twist.angular.x = command[3];
+      twist.twist.angular.y = command[4];
+      twist.twist.angular.z = command[5];
+      twist_pub->publish(twist);
+    }
+    else
+    {
+      servo.setTwistCommand(command);
+    }
+    rate.sleep();
+  }
+  const double wall_time = (monotonicNanoseconds() - start_ns) * 1e-9;
+  const double cpu_time = processCpuTime() - start_cpu_time;
+
+  servo.setPaused(true);
+  servo.setCommandCallback(nullptr);
+
+  std::cout << "\nServo benchmark: " << wall_time << " s, publish_period " << servo_parameters->publish_period
+            << " s, commands at " << command_rate << " Hz through " << (use_topics ? "topics" : "the C++ API")
+            << "\n\n";
+  std::cout << std::left << std::setw(28) << "[us]" << std::right << std::setw(10) << "count" << std::setw(12)
+            << "p50" << std::setw(12) << "p99" << std::setw(12) << "max" << '\n';
+  for (std::size_t i = 0; i < moveit_servo::SERVO_STAGE_COUNT; ++i)
+  {
+    const auto stage = static_cast<moveit_servo::ServoStage>(i);
+    printStatistics(moveit_servo::servoStageName(stage), servo.getLatencyStatistics(stage));
+  }
+  printStatistics("command to output", command_latency.getStatistics());
+
+  const moveit_servo::LoopJitter jitter = servo.getLoopJitter();
+  std::cout << "\nLoop jitter [us]: mean " << jitter.mean * 1e6 << ", max " << jitter.max * 1e6 << ", overruns "
+            << jitter.overruns << " of " << jitter.iterations << " iterations\n";
+  std::cout << "CPU usage of the process: " << 100.0 * cpu_time / wall_time << " % of one core\n";
+
+  executor.cancel();
+  executor_thread.join();
+  rclcpp::shutdown();
+  return EXIT_SUCCESS;
+}
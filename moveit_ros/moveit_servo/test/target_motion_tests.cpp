@@ -0,0 +1,122 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Desc: Pose tracking target motion model unit tests
+ */
+
+#include <gtest/gtest.h>
+#include <moveit_servo/target_motion.h>
+
+namespace
+{
+constexpr double EPS = 1e-9;
+
+Eigen::Isometry3d makePose(double x, double y, double z, double yaw)
+{
+  Eigen::Isometry3d pose = Eigen::Isometry3d::Identity();
+  pose.translation() = Eigen::Vector3d(x, y, z);
+  pose.linear() = Eigen::AngleAxisd(yaw, Eigen::Vector3d::UnitZ()).toRotationMatrix();
+  return pose;
+}
+}  // namespace
+
+TEST(TargetMotionTests, EmptyMotion)
+{
+  moveit_servo::TargetMotion motion;
+  Eigen::Isometry3d pose;
+  Eigen::Matrix<double, 6, 1> twist;
+  EXPECT_TRUE(motion.empty());
+  EXPECT_FALSE(motion.predict(1.0, pose, twist));
+}
+
+TEST(TargetMotionTests, ConstantVelocity)
+{
+  moveit_servo::TargetMotion motion;
+  Eigen::Matrix<double, 6, 1> velocity;
+  velocity << 0.1, 0.0, 0.0, 0.0, 0.0, 0.5;
+  motion.setConstantVelocity(10.0, makePose(1.0, 2.0, 0.5, 0.0), velocity);
+  EXPECT_FALSE(motion.isTrajectory());
+
+  Eigen::Isometry3d pose;
+  Eigen::Matrix<double, 6, 1> twist;
+  ASSERT_TRUE(motion.predict(12.0, pose, twist));
+  EXPECT_TRUE(pose.isApprox(makePose(1.2, 2.0, 0.5, 1.0), EPS));
+  EXPECT_TRUE(twist.isApprox(velocity));
+
+  // Extrapolating backwards is allowed as well
+  ASSERT_TRUE(motion.predict(9.0, pose, twist));
+  EXPECT_TRUE(pose.isApprox(makePose(0.9, 2.0, 0.5, -0.5), EPS));
+}
+
+TEST(TargetMotionTests, Trajectory)
+{
+  moveit_servo::TargetMotion motion;
+  const std::vector<double> times{ 1.0, 3.0 };
+  const EigenSTL::vector_Isometry3d poses{ makePose(0.0, 0.0, 0.0, 0.0), makePose(1.0, 0.0, 0.0, 1.0) };
+  ASSERT_TRUE(motion.setTrajectory(times, poses));
+  EXPECT_TRUE(motion.isTrajectory());
+  EXPECT_DOUBLE_EQ(motion.getEndTime(), 3.0);
+
+  Eigen::Isometry3d pose;
+  Eigen::Matrix<double, 6, 1> twist;
+  ASSERT_TRUE(motion.predict(2.0, pose, twist));
+  EXPECT_TRUE(pose.isApprox(makePose(0.5, 0.0, 0.0, 0.5), EPS));
+  Eigen::Matrix<double, 6, 1> expected_twist;
+  expected_twist << 0.5, 0.0, 0.0, 0.0, 0.0, 0.5;
+  EXPECT_TRUE(twist.isApprox(expected_twist, EPS));
+
+  // At rest outside of the waypoint times
+  ASSERT_TRUE(motion.predict(0.0, pose, twist));
+  EXPECT_TRUE(pose.isApprox(poses.front(), EPS));
+  EXPECT_TRUE(twist.isZero());
+  ASSERT_TRUE(motion.predict(4.0, pose, twist));
+  EXPECT_TRUE(pose.isApprox(poses.back(), EPS));
+  EXPECT_TRUE(twist.isZero());
+}
+
+TEST(TargetMotionTests, RejectsInvalidTrajectory)
+{
+  moveit_servo::TargetMotion motion;
+  const EigenSTL::vector_Isometry3d poses{ makePose(0.0, 0.0, 0.0, 0.0), makePose(1.0, 0.0, 0.0, 0.0) };
+  EXPECT_FALSE(motion.setTrajectory({ 1.0, 1.0 }, poses));
+  EXPECT_FALSE(motion.setTrajectory({ 1.0 }, poses));
+  EXPECT_FALSE(motion.setTrajectory({}, {}));
+  EXPECT_TRUE(motion.empty());
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,154 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#pragma once
+
+#include <moveit/macros/class_forward.h>
+#include <rclcpp/time.hpp>
+
+#include <Eigen/Geometry>
+#include <eigen_stl_containers/eigen_stl_containers.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace occupancy_map_monitor
+{
+MOVEIT_CLASS_FORWARD(LinkTransformCache);  // Defines LinkTransformCachePtr, ConstPtr, WeakPtr... etc
+
+/**
+ * @brief      Preallocated ring buffer of timestamped link poses that can be queried without taking locks.
+ *
+ * A single producer (typically the joint state callback of the planning scene monitor) pushes the poses of all
+ * frames relative to a common reference frame. Any number of consumers (the octomap updaters) can then interpolate
+ * the pose of a frame at the time stamp of their sensor data, without waiting on the mutex of a tf2 buffer. Each slot
+ * is protected by a sequence counter: readers retry if the slot they copied from was overwritten meanwhile. Pose
+ * values are stored as relaxed atomics, so concurrent reads and writes are well defined.
+ */
+class LinkTransformCache
+{
+public:
+  /**
+   * @brief      Constructor
+   *
+   * @param[in]  reference_frame  The frame all poses are expressed in
+   * @param[in]  frames           The names of the cached frames, poses are pushed in this order
+   * @param[in]  capacity         The number of snapshots kept, older ones are overwritten
+   */
+  LinkTransformCache(const std::string& reference_frame, const std::vector<std::string>& frames,
+                     std::size_t capacity = 128);
+
+  const std::string& getReferenceFrame() const
+  {
+    return reference_frame_;
+  }
+
+  const std::vector<std::string>& getFrames() const
+  {
+    return frames_;
+  }
+
+  /**
+   * @brief      Gets the index of a cached frame.
+   *
+   * @param[in]  frame  The frame name
+   *
+   * @return     The index of the frame in getFrames(), -1 if the frame is not cached.
+   */
+  int getFrameIndex(const std::string& frame) const;
+
+  /**
+   * @brief      Store the poses of all frames at a point in time. Must only be called from a single thread.
+   *
+   * @param[in]  stamp  The time stamp of the poses; snapshots older than the newest one are dropped
+   * @param[in]  poses  The poses of the frames relative to the reference frame, in the order of getFrames()
+   *
+   * @return     True if the snapshot was stored.
+   */
+  bool push(const rclcpp::Time& stamp, const EigenSTL::vector_Isometry3d& poses);
+
+  /**
+   * @brief      Interpolate the poses of all frames relative to the reference frame.
+   *
+   * @param[in]  time   The time to interpolate the poses at
+   * @param[out] poses  The poses, in the order of getFrames()
+   *
+   * @return     False if @e time is outside of the buffered interval.
+   */
+  bool getTransforms(const rclcpp::Time& time, EigenSTL::vector_Isometry3d& poses) const;
+
+  /**
+   * @brief      Look up the transform from @e source_frame to @e target_frame, each being either a cached frame or the
+   *             reference frame.
+   *
+   * @param[in]  target_frame  The target frame
+   * @param[in]  source_frame  The source frame
+   * @param[in]  time          The time to interpolate the transform at
+   * @param[out] transform     The pose of @e source_frame in @e target_frame
+   *
+   * @return     False if a frame is unknown or @e time is outside of the buffered interval.
+   */
+  bool lookupTransform(const std::string& target_frame, const std::string& source_frame, const rclcpp::Time& time,
+                       Eigen::Isometry3d& transform) const;
+
+private:
+  /** @brief Pose stored as quaternion (w, x, y, z) followed by the translation */
+  struct Pose
+  {
+    std::atomic<double> values[7];
+  };
+
+  struct Slot
+  {
+    std::atomic<std::uint64_t> sequence{ 0 };
+    std::atomic<std::int64_t> stamp{ 0 };
+  };
+
+  /** @brief Interpolate the frames in @e indices (all frames if nullptr) at @e time into @e poses */
+  bool interpolate(std::int64_t time, const int* indices, std::size_t count, Eigen::Isometry3d* poses) const;
+
+  std::string reference_frame_;
+  std::vector<std::string> frames_;
+  std::unordered_map<std::string, int> frame_indices_;
+
+  std::size_t capacity_;
+  std::unique_ptr<Slot[]> slots_;
+  std::unique_ptr<Pose[]> poses_;   /*!< capacity_ x frames_ poses, one row per slot */
+  std::atomic<std::uint64_t> head_; /*!< Number of snapshots pushed so far */
+};
+}  // namespace occupancy_map_monitor
@@ -37,6 +37,7 @@
 #pragma once
 
 #include <moveit/collision_detection/occupancy_map.h>
+#include <moveit/occupancy_map_monitor/link_transform_cache.h>
 #include <moveit/occupancy_map_monitor/occupancy_map_updater.h>
 #include <moveit_msgs/srv/load_map.hpp>
 #include <moveit_msgs/srv/save_map.hpp>
@@ -44,6 +45,7 @@
 #include <rclcpp/rclcpp.hpp>
 #include <tf2_ros/buffer.h>
 
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -64,6 +66,8 @@ public:
     double map_resolution;
     std::string map_frame;
     std::vector<std::pair<std::string, std::string>> sensor_plugins;
+    /// publish an immutable copy of the octree after every update, see collision_detection::OccMapTree
+    bool double_buffered = false;
   };
 
   /**
@@ -249,6 +253,44 @@ public:
     tree_->setUpdateCallback(update_callback);
   }
 
+  /**
+   * @brief      Enable or disable tracking of the octree leaves whose occupancy changes, so that consumers can forward
+   *             only the modified part of the map (see getChangedLeaves()).
+   *
+   * @param[in]  flag  True to start tracking changes
+   */
+  void setChangeTracking(bool flag);
+
+  /**
+   * @brief      Determines if changes to the octree are being tracked.
+   *
+   * @return     True if change tracking is enabled, False otherwise.
+   */
+  bool isTrackingChanges() const
+  {
+    return tree_->isChangeDetectionEnabled();
+  }
+
+  /**
+   * @brief      Copy the leaves that changed since the previous call into @e changes and start tracking anew. The tree
+   *             must be locked for reading while calling this function.
+   *
+   * @param[out] changes  Tree with the resolution of the monitored map that receives the changed leaves
+   *
+   * @return     True if @e changes describes all modifications, False if the changes cannot be expressed as a diff
+   *             (tracking disabled, or the map was cleared or replaced) and the full map has to be sent instead.
+   */
+  bool getChangedLeaves(octomap::OcTree& changes);
+
+  /**
+   * @brief      Discard the tracked changes, e.g. because the octree was cleared or replaced. The next call to
+   *             getChangedLeaves() reports that the full map is required.
+   */
+  void resetChangeTracking()
+  {
+    full_map_required_ = true;
+  }
+
   /**
    * @brief      Sets the transform cache callback.
    *
@@ -256,6 +298,27 @@ public:
    */
   void setTransformCacheCallback(const TransformCacheProvider& transform_cache_callback);
 
+  /**
+   * @brief      Share a cache of timestamped link poses with the updaters, so they can look up sensor poses without
+   *             querying tf2. Must be called before startMonitor().
+   *
+   * @param[in]  link_transform_cache  The link transform cache, nullptr to use tf2 only
+   */
+  void setLinkTransformCache(const LinkTransformCacheConstPtr& link_transform_cache)
+  {
+    link_transform_cache_ = link_transform_cache;
+  }
+
+  /**
+   * @brief      Gets the link transform cache shared with the updaters.
+   *
+   * @return     The link transform cache, nullptr if none was set.
+   */
+  const LinkTransformCacheConstPtr& getLinkTransformCache() const
+  {
+    return link_transform_cache_;
+  }
+
   /**
    * @brief      Set the debug flag on the updaters.
    *
@@ -324,10 +387,13 @@ private:
   std::vector<OccupancyMapUpdaterPtr> map_updaters_;             /*!< The Occupancy map updaters */
   std::vector<std::map<ShapeHandle, ShapeHandle>> mesh_handles_; /*!< The mesh handles */
   TransformCacheProvider transform_cache_callback_;              /*!< Callback for the transform cache */
+  LinkTransformCacheConstPtr link_transform_cache_;              /*!< Link poses shared with the updaters */
   bool debug_info_;                                              /*!< Enable/disable debug output */
 
   std::size_t mesh_handle_count_; /*!< Count of mesh handles */
 
   bool active_; /*!< True when actively monitoring updaters */
+
+  std::atomic<bool> full_map_required_; /*!< True when the tracked changes do not describe the map anymore */
 };
 }  // namespace occupancy_map_monitor
@@ -112,6 +112,11 @@ protected:
 
   bool updateTransformCache(const std::string& target_frame, const rclcpp::Time& target_time);
 
+  /** @brief Look up the pose of \e source_frame in \e target_frame at \e time in the link transform cache of the
+   * monitor. Returns false if there is no cache or it cannot provide the transform, callers then fall back to tf2. */
+  bool lookupCachedTransform(const std::string& target_frame, const std::string& source_frame,
+                             const rclcpp::Time& time, Eigen::Isometry3d& transform) const;
+
   // TODO rework this function
   // static void readXmlParam(XmlRpc::XmlRpcValue& params, const std::string& param_name, double* value);
   // static void readXmlParam(XmlRpc::XmlRpcValue& params, const std::string& param_name, unsigned int* value);
@@ -0,0 +1,202 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/occupancy_map_monitor/link_transform_cache.h>
+
+#include <algorithm>
+
+namespace occupancy_map_monitor
+{
+namespace
+{
+// number of times a reader retries when the producer overwrites the slots it is reading from
+constexpr int MAX_READ_ATTEMPTS = 8;
+}  // namespace
+
+LinkTransformCache::LinkTransformCache(const std::string& reference_frame, const std::vector<std::string>& frames,
+                                       std::size_t capacity)
+  : reference_frame_(reference_frame)
+  , frames_(frames)
+  , capacity_(std::max<std::size_t>(capacity, 2))
+  , slots_(new Slot[capacity_])
+  , poses_(new Pose[capacity_ * frames.size()])
+  , head_(0)
+{
+  for (std::size_t i = 0; i < frames_.size(); ++i)
+    frame_indices_[frames_[i]] = static_cast<int>(i);
+}
+
+int LinkTransformCache::getFrameIndex(const std::string& frame) const
+{
+  const auto it = frame_indices_.find(frame);
+  return it == frame_indices_.end() ? -1 : it->second;
+}
+
+bool LinkTransformCache::push(const rclcpp::Time& stamp, const EigenSTL::vector_Isometry3d& poses)
+{
+  if (poses.size() != frames_.size())
+    return false;
+
+  const std::int64_t stamp_ns = stamp.nanoseconds();
+  const std::uint64_t head = head_.load(std::memory_order_relaxed);
+  if (head > 0 && stamp_ns < slots_[(head - 1) % capacity_].stamp.load(std::memory_order_relaxed))
+    return false;
+
+  // an odd sequence number marks the slot as being written
+  Slot& slot = slots_[head % capacity_];
+  const std::uint64_t sequence = slot.sequence.load(std::memory_order_relaxed);
+  slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  slot.stamp.store(stamp_ns, std::memory_order_relaxed);
+  Pose* row = &poses_[(head % capacity_) * frames_.size()];
+  for (std::size_t i = 0; i < poses.size(); ++i)
+  {
+    const Eigen::Quaterniond rotation(poses[i].linear());
+    const Eigen::Vector3d translation = poses[i].translation();
+    const double values[7] = { rotation.w(),    rotation.x(),    rotation.y(),   rotation.z(),
+                               translation.x(), translation.y(), translation.z() };
+    for (int j = 0; j < 7; ++j)
+      row[i].values[j].store(values[j], std::memory_order_relaxed);
+  }
+
+  slot.sequence.store(sequence + 2, std::memory_order_release);
+  head_.store(head + 1, std::memory_order_release);
+  return true;
+}
+
+bool LinkTransformCache::getTransforms(const rclcpp::Time& time, EigenSTL::vector_Isometry3d& poses) const
+{
+  poses.resize(frames_.size());
+  return interpolate(time.nanoseconds(), nullptr, poses.size(), poses.data());
+}
+
+bool LinkTransformCache::lookupTransform(const std::string& target_frame, const std::string& source_frame,
+                                         const rclcpp::Time& time, Eigen::Isometry3d& transform) const
+{
+  const int target = getFrameIndex(target_frame);
+  const int source = getFrameIndex(source_frame);
+  if ((target < 0 && target_frame != reference_frame_) || (source < 0 && source_frame != reference_frame_))
+    return false;
+
+  int indices[2];
+  std::size_t count = 0;
+  if (target >= 0)
+    indices[count++] = target;
+  if (source >= 0)
+    indices[count++] = source;
+
+  Eigen::Isometry3d poses[2];
+  if (count > 0 && !interpolate(time.nanoseconds(), indices, count, poses))
+    return false;
+
+  Eigen::Isometry3d reference_to_target = Eigen::Isometry3d::Identity();
+  Eigen::Isometry3d reference_to_source = Eigen::Isometry3d::Identity();
+  std::size_t i = 0;
+  if (target >= 0)
+    reference_to_target = poses[i++];
+  if (source >= 0)
+    reference_to_source = poses[i];
+  transform = reference_to_target.inverse() * reference_to_source;
+  return true;
+}
+
+bool LinkTransformCache::interpolate(std::int64_t time, const int* indices, std::size_t count,
+                                     Eigen::Isometry3d* poses) const
+{
+  const std::size_t frame_count = frames_.size();
+  for (int attempt = 0; attempt < MAX_READ_ATTEMPTS; ++attempt)
+  {
+    const std::uint64_t head = head_.load(std::memory_order_acquire);
+    if (head == 0)
+      return false;
+
+    // find the newest snapshot not after the requested time; the oldest slot is skipped as it is overwritten next
+    const std::uint64_t oldest = head > capacity_ - 1 ? head - (capacity_ - 1) : 0;
+    std::uint64_t before = head - 1;
+    if (slots_[before % capacity_].stamp.load(std::memory_order_relaxed) < time)
+      return false;  // no extrapolation into the future
+    while (before > oldest && slots_[before % capacity_].stamp.load(std::memory_order_relaxed) > time)
+      --before;
+    const std::uint64_t after = before + 1 < head ? before + 1 : before;
+
+    const Slot& slot_before = slots_[before % capacity_];
+    const Slot& slot_after = slots_[after % capacity_];
+    const std::uint64_t sequence_before = slot_before.sequence.load(std::memory_order_acquire);
+    const std::uint64_t sequence_after = slot_after.sequence.load(std::memory_order_acquire);
+    if ((sequence_before | sequence_after) & 1)
+      continue;
+
+    const std::int64_t stamp_before = slot_before.stamp.load(std::memory_order_relaxed);
+    const std::int64_t stamp_after = slot_after.stamp.load(std::memory_order_relaxed);
+    if (stamp_before > time)
+    {
+      // the requested time is older than the buffer, unless the slots were overwritten while searching
+      if (head_.load(std::memory_order_acquire) == head)
+        return false;
+      continue;
+    }
+    if (stamp_after < time)
+      continue;
+    const double ratio =
+        stamp_after > stamp_before ? static_cast<double>(time - stamp_before) / (stamp_after - stamp_before) : 0.0;
+
+    const Pose* row_before = &poses_[(before % capacity_) * frame_count];
+    const Pose* row_after = &poses_[(after % capacity_) * frame_count];
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      const std::size_t index = indices ? indices[i] : i;
+      double a[7], b[7];
+      for (int j = 0; j < 7; ++j)
+      {
+        a[j] = row_before[index].values[j].load(std::memory_order_relaxed);
+        b[j] = row_after[index].values[j].load(std::memory_order_relaxed);
+      }
+      const Eigen::Quaterniond rotation_a(a[0], a[1], a[2], a[3]);
+      const Eigen::Quaterniond rotation_b(b[0], b[1], b[2], b[3]);
+      const Eigen::Vector3d translation_a(a[4], a[5], a[6]);
+      const Eigen::Vector3d translation_b(b[4], b[5], b[6]);
+      poses[i] = Eigen::Translation3d(translation_a + ratio * (translation_b - translation_a)) *
+                 rotation_a.slerp(ratio, rotation_b);
+    }
+
+    // the copy is only valid if neither slot was modified while reading it
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot_before.sequence.load(std::memory_order_relaxed) == sequence_before &&
+        slot_after.sequence.load(std::memory_order_relaxed) == sequence_after)
+      return true;
+  }
+  return false;
+}
+}  // namespace occupancy_map_monitor
@@ -76,6 +76,7 @@ OccupancyMapMonitor::OccupancyMapMonitor(std::unique_ptr<MiddlewareHandle> middl
   , debug_info_{ false }
   , mesh_handle_count_{ 0 }
   , active_{ false }
+  , full_map_required_{ true }
 {
   if (middleware_handle_ == nullptr)
   {
@@ -98,6 +99,7 @@ OccupancyMapMonitor::OccupancyMapMonitor(std::unique_ptr<MiddlewareHandle> middl
   }
 
   tree_ = std::make_shared<collision_detection::OccMapTree>(parameters_.map_resolution);
+  tree_->setDoubleBuffered(parameters_.double_buffered);
   tree_const_ = tree_;
 
   for (const auto& [sensor_name, sensor_type] : parameters_.sensor_plugins)
@@ -307,11 +309,49 @@ bool OccupancyMapMonitor::loadMapCallback(const std::shared_ptr<rmw_request_id_t
   tree_->unlockWrite();
 
   if (response->success)
+  {
+    resetChangeTracking();
     tree_->triggerUpdateCallback();
+  }
 
   return true;
 }
 
+void OccupancyMapMonitor::setChangeTracking(bool flag)
+{
+  tree_->lockWrite();
+  tree_->enableChangeDetection(flag);
+  tree_->resetChangeDetection();
+  tree_->unlockWrite();
+  resetChangeTracking();
+}
+
+bool OccupancyMapMonitor::getChangedLeaves(octomap::OcTree& changes)
+{
+  changes.clear();
+  changes.setResolution(tree_->getResolution());
+
+  // updaters are the only other users of the changed key set and they are excluded by the caller's read lock
+  const bool full_map_required = full_map_required_.exchange(false);
+  if (!tree_->isChangeDetectionEnabled())
+    return false;
+
+  if (!full_map_required)
+  {
+    for (octomap::KeyBoolMap::const_iterator it = tree_->changedKeysBegin(); it != tree_->changedKeysEnd(); ++it)
+    {
+      // the key may now be covered by a pruned inner node; search() returns that node in this case
+      const collision_detection::OccMapNode* node = tree_->search(it->first);
+      if (node)
+        changes.setNodeValue(it->first, node->getLogOdds(), true);
+    }
+    // leaves were inserted lazily so that they are never pruned and stay at full depth for the receiver
+    changes.updateInnerOccupancy();
+  }
+  tree_->resetChangeDetection();
+  return !full_map_required;
+}
+
 void OccupancyMapMonitor::startMonitor()
 {
   active_ = true;
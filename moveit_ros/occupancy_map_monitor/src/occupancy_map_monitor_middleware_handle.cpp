@@ -88,6 +88,8 @@ OccupancyMapMonitorMiddlewareHandle::OccupancyMapMonitorMiddlewareHandle(const r
     }
   }
 
+  node_->get_parameter("octomap_double_buffered", parameters_.double_buffered);
+
   std::vector<std::string> sensor_names;
   if (!node_->get_parameter("sensors", sensor_names))
   {
@@ -101,4 +101,11 @@ bool OccupancyMapUpdater::updateTransformCache(const std::string& target_frame,
     return false;
   }
 }
+
+bool OccupancyMapUpdater::lookupCachedTransform(const std::string& target_frame, const std::string& source_frame,
+                                                const rclcpp::Time& time, Eigen::Isometry3d& transform) const
+{
+  const LinkTransformCacheConstPtr& cache = monitor_->getLinkTransformCache();
+  return cache && cache->lookupTransform(target_frame, source_frame, time, transform);
+}
 }  // namespace occupancy_map_monitor
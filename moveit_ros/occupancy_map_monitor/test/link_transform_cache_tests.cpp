@@ -0,0 +1,180 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/occupancy_map_monitor/link_transform_cache.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+namespace
+{
+rclcpp::Time fromNanoseconds(std::int64_t ns)
+{
+  return rclcpp::Time(static_cast<std::int32_t>(ns / 1000000000), static_cast<std::uint32_t>(ns % 1000000000));
+}
+
+EigenSTL::vector_Isometry3d makePoses(double x, double yaw)
+{
+  EigenSTL::vector_Isometry3d poses(2, Eigen::Isometry3d::Identity());
+  poses[0] = Eigen::Translation3d(x, 0.0, 0.0) * Eigen::AngleAxisd(yaw, Eigen::Vector3d::UnitZ());
+  poses[1] = Eigen::Translation3d(0.0, 0.0, 1.0) * Eigen::Isometry3d::Identity();
+  return poses;
+}
+}  // namespace
+
+TEST(LinkTransformCacheTests, InterpolatesBetweenSnapshots)
+{
+  // GIVEN a cache holding two snapshots one second apart
+  occupancy_map_monitor::LinkTransformCache cache("world", { "link_a", "camera" });
+  ASSERT_TRUE(cache.push(rclcpp::Time(1, 0), makePoses(0.0, 0.0)));
+  ASSERT_TRUE(cache.push(rclcpp::Time(2, 0), makePoses(1.0, M_PI_2)));
+
+  // WHEN the poses are requested half way in between
+  EigenSTL::vector_Isometry3d poses;
+  ASSERT_TRUE(cache.getTransforms(rclcpp::Time(1, 500000000), poses));
+
+  // THEN translation and rotation are interpolated
+  ASSERT_EQ(poses.size(), 2u);
+  EXPECT_NEAR(poses[0].translation().x(), 0.5, 1e-9);
+  EXPECT_NEAR(Eigen::AngleAxisd(poses[0].linear()).angle(), M_PI_4, 1e-9);
+  EXPECT_TRUE(poses[1].isApprox(makePoses(0.0, 0.0)[1]));
+
+  // THEN snapshots are matched exactly at their time stamps
+  ASSERT_TRUE(cache.getTransforms(rclcpp::Time(2, 0), poses));
+  EXPECT_TRUE(poses[0].isApprox(makePoses(1.0, M_PI_2)[0]));
+
+  // THEN times outside of the buffered interval are rejected
+  EXPECT_FALSE(cache.getTransforms(rclcpp::Time(0, 500000000), poses));
+  EXPECT_FALSE(cache.getTransforms(rclcpp::Time(2, 1), poses));
+
+  // THEN snapshots older than the newest one are dropped
+  EXPECT_FALSE(cache.push(rclcpp::Time(1, 0), makePoses(0.0, 0.0)));
+}
+
+TEST(LinkTransformCacheTests, LooksUpTransformsBetweenFrames)
+{
+  // GIVEN a cache with a single snapshot
+  occupancy_map_monitor::LinkTransformCache cache("world", { "link_a", "camera" });
+  ASSERT_TRUE(cache.push(rclcpp::Time(1, 0), makePoses(2.0, M_PI_2)));
+  const EigenSTL::vector_Isometry3d expected = makePoses(2.0, M_PI_2);
+  Eigen::Isometry3d transform;
+
+  // THEN transforms between cached frames and the reference frame are available
+  ASSERT_TRUE(cache.lookupTransform("world", "link_a", rclcpp::Time(1, 0), transform));
+  EXPECT_TRUE(transform.isApprox(expected[0]));
+  ASSERT_TRUE(cache.lookupTransform("link_a", "world", rclcpp::Time(1, 0), transform));
+  EXPECT_TRUE(transform.isApprox(expected[0].inverse()));
+  ASSERT_TRUE(cache.lookupTransform("camera", "link_a", rclcpp::Time(1, 0), transform));
+  EXPECT_TRUE(transform.isApprox(expected[1].inverse() * expected[0]));
+
+  // THEN unknown frames are rejected
+  EXPECT_EQ(cache.getFrameIndex("unknown"), -1);
+  EXPECT_FALSE(cache.lookupTransform("unknown", "link_a", rclcpp::Time(1, 0), transform));
+}
+
+TEST(LinkTransformCacheTests, OverwritesOldestSnapshots)
+{
+  // GIVEN a cache with room for four snapshots
+  occupancy_map_monitor::LinkTransformCache cache("world", { "link_a", "camera" }, 4);
+
+  // WHEN ten snapshots are pushed
+  for (int i = 0; i < 10; ++i)
+    ASSERT_TRUE(cache.push(rclcpp::Time(i, 0), makePoses(i, 0.0)));
+
+  // THEN only the most recent ones can be queried
+  EigenSTL::vector_Isometry3d poses;
+  EXPECT_FALSE(cache.getTransforms(rclcpp::Time(5, 0), poses));
+  ASSERT_TRUE(cache.getTransforms(rclcpp::Time(7, 500000000), poses));
+  EXPECT_NEAR(poses[0].translation().x(), 7.5, 1e-9);
+}
+
+TEST(LinkTransformCacheTests, ConcurrentReadersSeeConsistentSnapshots)
+{
+  // GIVEN a small cache that is overwritten continuously by a producer
+  occupancy_map_monitor::LinkTransformCache cache("world", { "link_a", "camera" }, 8);
+  const std::int64_t step = 1000000;
+  ASSERT_TRUE(cache.push(fromNanoseconds(0), makePoses(0.0, 0.0)));
+
+  std::atomic<std::int64_t> newest{ 0 };
+  std::atomic<bool> done{ false };
+  std::atomic<int> inconsistent{ 0 };
+  std::atomic<int> successful{ 0 };
+  std::thread producer([&] {
+    // keep overwriting slots until the readers completed enough queries
+    for (std::int64_t i = 1; successful < 10000 && i < 100000000; ++i)
+    {
+      EigenSTL::vector_Isometry3d poses = makePoses(i, 0.0);
+      poses[1].translation().x() = i;
+      cache.push(fromNanoseconds(i * step), poses);
+      newest = i;
+    }
+    done = true;
+  });
+
+  // WHEN readers query times just before the newest snapshot
+  std::vector<std::thread> readers;
+  for (int r = 0; r < 3; ++r)
+    readers.emplace_back([&] {
+      EigenSTL::vector_Isometry3d poses;
+      while (!done)
+      {
+        const std::int64_t time = newest * step - step / 2;
+        if (time > 0 && cache.getTransforms(fromNanoseconds(time), poses))
+        {
+          ++successful;
+          // THEN both frames come from the same pair of snapshots and match the requested time
+          const double expected = static_cast<double>(time) / step;
+          if (std::abs(poses[0].translation().x() - expected) > 1e-6 ||
+              std::abs(poses[1].translation().x() - expected) > 1e-6)
+            ++inconsistent;
+        }
+      }
+    });
+
+  producer.join();
+  for (std::thread& reader : readers)
+    reader.join();
+  EXPECT_EQ(inconsistent, 0);
+  EXPECT_GT(successful, 0);
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -77,6 +77,57 @@ TEST(OccupancyMapMonitorTests, ConstructorTest)
   };
 }
 
+TEST(OccupancyMapMonitorTests, ChangeTrackingTest)
+{
+  // GIVEN an occupancy map monitor with a 10 cm map that tracks changes
+  auto mock_middleware_handle = std::make_unique<MockMiddlewareHandle>();
+  EXPECT_CALL(*mock_middleware_handle, getParameters)
+      .WillOnce(testing::Return(occupancy_map_monitor::OccupancyMapMonitor::Parameters{ 0.1, "", {} }));
+  occupancy_map_monitor::OccupancyMapMonitor occupancy_map_monitor{ std::move(mock_middleware_handle), nullptr };
+  occupancy_map_monitor.setChangeTracking(true);
+  const collision_detection::OccMapTreePtr& tree = occupancy_map_monitor.getOcTreePtr();
+  octomap::OcTree changes(1.0);
+
+  // THEN the first request requires the full map
+  {
+    collision_detection::OccMapTree::ReadLock lock = tree->reading();
+    EXPECT_FALSE(occupancy_map_monitor.getChangedLeaves(changes));
+  }
+
+  // WHEN a single cell becomes occupied
+  {
+    collision_detection::OccMapTree::WriteLock lock = tree->writing();
+    tree->updateNode(0.55, 0.25, 0.05, true);
+  }
+
+  // THEN exactly that leaf is reported, at the resolution of the map
+  {
+    collision_detection::OccMapTree::ReadLock lock = tree->reading();
+    ASSERT_TRUE(occupancy_map_monitor.getChangedLeaves(changes));
+  }
+  EXPECT_DOUBLE_EQ(changes.getResolution(), 0.1);
+  ASSERT_EQ(changes.getNumLeafNodes(), 1u);
+  const octomap::OcTreeNode* node = changes.search(0.55, 0.25, 0.05);
+  ASSERT_NE(node, nullptr);
+  EXPECT_TRUE(changes.isNodeOccupied(node));
+
+  // THEN no changes are reported until the map is modified again
+  {
+    collision_detection::OccMapTree::ReadLock lock = tree->reading();
+    ASSERT_TRUE(occupancy_map_monitor.getChangedLeaves(changes));
+  }
+  EXPECT_EQ(changes.getNumLeafNodes(), 0u);
+
+  // WHEN the tracked changes are discarded because the map was replaced
+  occupancy_map_monitor.resetChangeTracking();
+
+  // THEN the full map is required again
+  {
+    collision_detection::OccMapTree::ReadLock lock = tree->reading();
+    EXPECT_FALSE(occupancy_map_monitor.getChangedLeaves(changes));
+  }
+}
+
 int main(int argc, char** argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
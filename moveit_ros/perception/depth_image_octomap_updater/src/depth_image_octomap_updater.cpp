@@ -41,6 +41,11 @@
 #else
 #include <tf2_geometry_msgs/tf2_geometry_msgs.h>
 #endif
+#if __has_include(<tf2_eigen/tf2_eigen.hpp>)
+#include <tf2_eigen/tf2_eigen.hpp>
+#else
+#include <tf2_eigen/tf2_eigen.h>
+#endif
 #include <tf2/LinearMath/Vector3.h>
 #include <tf2/LinearMath/Transform.h>
 #include <geometric_shapes/shape_operations.h>
@@ -65,6 +70,8 @@ DepthImageOctomapUpdater::DepthImageOctomapUpdater()
   , max_update_rate_(0)
   , skip_vertical_pixels_(4)
   , skip_horizontal_pixels_(6)
+  , gpu_key_generation_(false)
+  , free_space_threads_(1)
   , image_callback_count_(0)
   , average_callback_dt_(0.0)
   , good_tf_(5)
@@ -98,6 +105,10 @@ bool DepthImageOctomapUpdater::setParams(const std::string& name_space)
         node_->get_parameter(name_space + ".skip_horizontal_pixels", skip_horizontal_pixels_) &&
         node_->get_parameter(name_space + ".filtered_cloud_topic", filtered_cloud_topic_) &&
         node_->get_parameter(name_space + ".ns", ns_);
+    node_->get_parameter_or(name_space + ".gpu_key_generation", gpu_key_generation_, false);
+    node_->get_parameter_or(name_space + ".free_space_threads", free_space_threads_, 1u);
+    if (free_space_updater_)
+      free_space_updater_->setNumThreads(free_space_threads_);
     return true;
   }
   catch (const rclcpp::exceptions::InvalidParameterTypeException& e)
@@ -116,7 +127,7 @@ bool DepthImageOctomapUpdater::initialize(const rclcpp::Node::SharedPtr& node)
   filtered_label_transport_ = std::make_unique<image_transport::ImageTransport>(node_);
 
   tf_buffer_ = monitor_->getTFClient();
-  free_space_updater_ = std::make_unique<LazyFreeSpaceUpdater>(tree_);
+  free_space_updater_ = std::make_unique<LazyFreeSpaceUpdater>(tree_, 10, free_space_threads_);
 
   // create our mesh filter
   mesh_filter_ = std::make_unique<mesh_filter::MeshFilter<mesh_filter::StereoCameraModel>>(
@@ -259,8 +270,12 @@ void DepthImageOctomapUpdater::depthImageCallback(const sensor_msgs::msg::Image:
 
   /* get transform for cloud into map frame */
   tf2::Stamped<tf2::Transform> map_h_sensor;
+  Eigen::Isometry3d map_t_sensor;
   if (monitor_->getMapFrame() == depth_msg->header.frame_id)
     map_h_sensor.setIdentity();
+  else if (lookupCachedTransform(monitor_->getMapFrame(), depth_msg->header.frame_id, depth_msg->header.stamp,
+                                 map_t_sensor))
+    tf2::fromMsg(tf2::eigenToTransform(map_t_sensor).transform, map_h_sensor);
   else
   {
     if (tf_buffer_)
@@ -395,12 +410,30 @@ void DepthImageOctomapUpdater::depthImageCallback(const sensor_msgs::msg::Image:
 
   // allocate memory if needed
   std::size_t img_size = h * w;
-  if (filtered_labels_.size() < img_size)
-    filtered_labels_.resize(img_size);
+  const unsigned int* labels_row = nullptr;
+  if (gpu_key_generation_)
+  {
+    if (octree_keys_.size() < 4 * img_size)
+      octree_keys_.resize(4 * img_size);
+
+    // let the mesh filter back-project the depth image and compute the octree keys, so only keys are read back
+    Eigen::Isometry3d sensor_pose = Eigen::Isometry3d::Identity();
+    const tf2::Matrix3x3& basis = map_h_sensor.getBasis();
+    for (int i = 0; i < 3; ++i)
+      for (int j = 0; j < 3; ++j)
+        sensor_pose.linear()(i, j) = basis[i][j];
+    sensor_pose.translation() = Eigen::Vector3d(sensor_origin.x(), sensor_origin.y(), sensor_origin.z());
+    mesh_filter_->getOctreeKeys(sensor_pose, K0_, K4_, K2_, K5_, tree_->getResolution(), &octree_keys_[0]);
+  }
+  else
+  {
+    if (filtered_labels_.size() < img_size)
+      filtered_labels_.resize(img_size);
 
-  // get the labels of the filtered data
-  const unsigned int* labels_row = &filtered_labels_[0];
-  mesh_filter_->getFilteredLabels(&filtered_labels_[0]);
+    // get the labels of the filtered data
+    labels_row = &filtered_labels_[0];
+    mesh_filter_->getFilteredLabels(&filtered_labels_[0]);
+  }
 
   // publish debug information if needed
   if (debug_info_)
@@ -474,7 +507,21 @@ void DepthImageOctomapUpdater::depthImageCallback(const sensor_msgs::msg::Image:
     const int h_bound = h - skip_vertical_pixels_;
     const int w_bound = w - skip_horizontal_pixels_;
 
-    if (is_u_short)
+    if (gpu_key_generation_)
+    {
+      for (int y = skip_vertical_pixels_; y < h_bound; ++y)
+      {
+        const unsigned short* key = &octree_keys_[4 * (y * w + skip_horizontal_pixels_)];
+        for (int x = skip_horizontal_pixels_; x < w_bound; ++x, key += 4)
+        {
+          if (key[3] == mesh_filter::MeshFilterBase::OCCUPIED_KEY)
+            occupied_cells.insert(octomap::OcTreeKey(key[0], key[1], key[2]));
+          else if (key[3] == mesh_filter::MeshFilterBase::MODEL_KEY)
+            model_cells.insert(octomap::OcTreeKey(key[0], key[1], key[2]));
+        }
+      }
+    }
+    else if (is_u_short)
     {
       const uint16_t* input_row = reinterpret_cast<const uint16_t*>(&depth_msg->data[0]);
 
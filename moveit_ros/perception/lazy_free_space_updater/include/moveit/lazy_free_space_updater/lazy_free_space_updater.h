@@ -37,22 +37,49 @@
 #pragma once
 
 #include <moveit/collision_detection/occupancy_map.h>
+#include <atomic>
+#include <chrono>
 #include <deque>
+#include <mutex>
 #include <unordered_map>
 #include <condition_variable>
 #include <thread>
+#include <vector>
 
 namespace occupancy_map_monitor
 {
 class LazyFreeSpaceUpdater
 {
 public:
-  LazyFreeSpaceUpdater(const collision_detection::OccMapTreePtr& tree, unsigned int max_batch_size = 10);
+  /** \brief Counters and timings of the free space clearing */
+  struct Statistics
+  {
+    /** \brief Number of pushed sets of cells that are not yet part of a batch */
+    std::size_t queue_depth = 0;
+    /** \brief Number of batches whose free space was cleared */
+    std::size_t processed_batches = 0;
+    /** \brief Number of batches dropped because the previous batch was still being processed */
+    std::size_t dropped_batches = 0;
+    /** \brief Time from pushing the oldest set of the last batch until its free space was cleared, in seconds */
+    double last_latency = 0.0;
+    /** \brief Average of the latency over all processed batches, in seconds */
+    double average_latency = 0.0;
+    /** \brief Time spent computing and clearing the free space of the last batch, in seconds */
+    double last_processing_time = 0.0;
+  };
+
+  LazyFreeSpaceUpdater(const collision_detection::OccMapTreePtr& tree, unsigned int max_batch_size = 10,
+                       unsigned int num_threads = 1);
   ~LazyFreeSpaceUpdater();
 
   void pushLazyUpdate(octomap::KeySet* occupied_cells, octomap::KeySet* model_cells,
                       const octomap::point3d& sensor_origin);
 
+  /** \brief Set the number of threads casting rays for a batch. 0 uses one thread per hardware thread. */
+  void setNumThreads(unsigned int num_threads);
+
+  Statistics getStatistics() const;
+
 private:
 #ifdef __APPLE__
   typedef std::unordered_map<octomap::OcTreeKey, unsigned int, octomap::OcTreeKey::KeyHash> OcTreeKeyCountMap;
@@ -63,7 +90,11 @@ private:
 #endif
 
   void pushBatchToProcess(OcTreeKeyCountMap* occupied_cells, octomap::KeySet* model_cells,
-                          const octomap::point3d& sensor_origin);
+                          const octomap::point3d& sensor_origin,
+                          const std::chrono::steady_clock::time_point& push_time);
+
+  /** \brief Cast the rays of the batch that is processed in parallel and count how often each cell was passed */
+  void computeFreeCells(OcTreeKeyCountMap& free_cells);
 
   void lazyUpdateThread();
   void processThread();
@@ -72,19 +103,29 @@ private:
   bool running_;
   std::size_t max_batch_size_;
   double max_sensor_delta_;
+  std::atomic<unsigned int> num_threads_;
 
   std::deque<octomap::KeySet*> occupied_cells_sets_;
   std::deque<octomap::KeySet*> model_cells_sets_;
   std::deque<octomap::point3d> sensor_origins_;
+  std::deque<std::chrono::steady_clock::time_point> push_times_;
   std::condition_variable update_condition_;
-  std::mutex update_cell_sets_lock_;
+  mutable std::mutex update_cell_sets_lock_;
 
   OcTreeKeyCountMap* process_occupied_cells_set_;
   octomap::KeySet* process_model_cells_set_;
   octomap::point3d process_sensor_origin_;
+  std::chrono::steady_clock::time_point process_push_time_;
   std::condition_variable process_condition_;
   std::mutex cell_process_lock_;
 
+  // per thread storage of the ray casting, reused across batches to avoid reallocations
+  std::vector<octomap::KeyRay> key_rays_;
+  std::vector<OcTreeKeyCountMap> thread_free_cells_;
+
+  Statistics statistics_;
+  mutable std::mutex statistics_lock_;
+
   std::thread update_thread_;
   std::thread process_thread_;
 };
@@ -37,16 +37,19 @@
 #include <moveit/lazy_free_space_updater/lazy_free_space_updater.h>
 #include <rclcpp/logging.hpp>
 #include <rclcpp/clock.hpp>
+#include <algorithm>
 
 namespace occupancy_map_monitor
 {
 static const rclcpp::Logger LOGGER = rclcpp::get_logger("moveit.ros.perception.lazy_free_space_updater");
 
-LazyFreeSpaceUpdater::LazyFreeSpaceUpdater(const collision_detection::OccMapTreePtr& tree, unsigned int max_batch_size)
+LazyFreeSpaceUpdater::LazyFreeSpaceUpdater(const collision_detection::OccMapTreePtr& tree, unsigned int max_batch_size,
+                                           unsigned int num_threads)
   : tree_(tree)
   , running_(true)
   , max_batch_size_(max_batch_size)
   , max_sensor_delta_(1e-3)  // 1mm
+  , num_threads_(num_threads)
   , process_occupied_cells_set_(nullptr)
   , process_model_cells_set_(nullptr)
   , update_thread_([this] { lazyUpdateThread(); })
@@ -78,11 +81,30 @@ void LazyFreeSpaceUpdater::pushLazyUpdate(octomap::KeySet* occupied_cells, octom
   occupied_cells_sets_.push_back(occupied_cells);
   model_cells_sets_.push_back(model_cells);
   sensor_origins_.push_back(sensor_origin);
+  push_times_.push_back(std::chrono::steady_clock::now());
   update_condition_.notify_one();
 }
 
+void LazyFreeSpaceUpdater::setNumThreads(unsigned int num_threads)
+{
+  num_threads_ = num_threads;
+}
+
+LazyFreeSpaceUpdater::Statistics LazyFreeSpaceUpdater::getStatistics() const
+{
+  Statistics statistics;
+  {
+    std::scoped_lock _(statistics_lock_);
+    statistics = statistics_;
+  }
+  std::scoped_lock _(update_cell_sets_lock_);
+  statistics.queue_depth = occupied_cells_sets_.size();
+  return statistics;
+}
+
 void LazyFreeSpaceUpdater::pushBatchToProcess(OcTreeKeyCountMap* occupied_cells, octomap::KeySet* model_cells,
-                                              const octomap::point3d& sensor_origin)
+                                              const octomap::point3d& sensor_origin,
+                                              const std::chrono::steady_clock::time_point& push_time)
 {
   // this is basically a queue of size 1. if this function is called repeatedly without any work being done by
   // processThread(),
@@ -92,6 +114,7 @@ void LazyFreeSpaceUpdater::pushBatchToProcess(OcTreeKeyCountMap* occupied_cells,
     process_occupied_cells_set_ = occupied_cells;
     process_model_cells_set_ = model_cells;
     process_sensor_origin_ = sensor_origin;
+    process_push_time_ = push_time;
     process_condition_.notify_one();
     cell_process_lock_.unlock();
   }
@@ -100,7 +123,50 @@ void LazyFreeSpaceUpdater::pushBatchToProcess(OcTreeKeyCountMap* occupied_cells,
     RCLCPP_WARN(LOGGER, "Previous batch update did not complete. Ignoring set of cells to be freed.");
     delete occupied_cells;
     delete model_cells;
+    std::scoped_lock _(statistics_lock_);
+    ++statistics_.dropped_batches;
+  }
+}
+
+void LazyFreeSpaceUpdater::computeFreeCells(OcTreeKeyCountMap& free_cells)
+{
+  // the rays end at the occupied cells, weighted by the number of sets they were seen in, and at the model cells
+  std::vector<std::pair<octomap::OcTreeKey, unsigned int>> end_cells;
+  end_cells.reserve(process_occupied_cells_set_->size() + process_model_cells_set_->size());
+  end_cells.insert(end_cells.end(), process_occupied_cells_set_->begin(), process_occupied_cells_set_->end());
+  for (const octomap::OcTreeKey& it : *process_model_cells_set_)
+    end_cells.emplace_back(it, 1);
+
+  std::size_t num_threads = num_threads_;
+  if (num_threads == 0)
+    num_threads = std::max(1u, std::thread::hardware_concurrency());
+  num_threads = std::max<std::size_t>(1, std::min(num_threads, end_cells.size()));
+
+  if (key_rays_.size() < num_threads)
+  {
+    key_rays_.resize(num_threads);
+    thread_free_cells_.resize(num_threads);
+  }
+
+  // each thread casts the rays of a contiguous partition of the end cells and counts the cells it passes
+#pragma omp parallel for num_threads(num_threads) schedule(static, 1)
+  for (int thread = 0; thread < static_cast<int>(num_threads); ++thread)
+  {
+    const std::size_t begin = end_cells.size() * thread / num_threads;
+    const std::size_t end = end_cells.size() * (thread + 1) / num_threads;
+    octomap::KeyRay& key_ray = key_rays_[thread];
+    OcTreeKeyCountMap& cells = thread_free_cells_[thread];
+    cells.clear();
+    for (std::size_t i = begin; i < end; ++i)
+      if (tree_->computeRayKeys(process_sensor_origin_, tree_->keyToCoord(end_cells[i].first), key_ray))
+        for (const octomap::OcTreeKey& jt : key_ray)
+          cells[jt] += end_cells[i].second;
   }
+
+  free_cells.swap(thread_free_cells_[0]);
+  for (std::size_t thread = 1; thread < num_threads; ++thread)
+    for (const std::pair<const octomap::OcTreeKey, unsigned int>& it : thread_free_cells_[thread])
+      free_cells[it.first] += it.second;
 }
 
 void LazyFreeSpaceUpdater::processThread()
@@ -108,13 +174,11 @@ void LazyFreeSpaceUpdater::processThread()
   const float lg_0 = tree_->getClampingThresMinLog() - tree_->getClampingThresMaxLog();
   const float lg_miss = tree_->getProbMissLog();
 
-  octomap::KeyRay key_ray1, key_ray2;
-  OcTreeKeyCountMap free_cells1, free_cells2;
+  OcTreeKeyCountMap free_cells;
 
   while (running_)
   {
-    free_cells1.clear();
-    free_cells2.clear();
+    free_cells.clear();
 
     std::unique_lock<std::mutex> ulock(cell_process_lock_);
     while (!process_occupied_cells_set_ && running_)
@@ -131,42 +195,15 @@ void LazyFreeSpaceUpdater::processThread()
     rclcpp::Clock clock;
     rclcpp::Time start = clock.now();
     tree_->lockRead();
-
-#pragma omp sections
-    {
-#pragma omp section
-      {
-        /* compute the free cells along each ray that ends at an occupied cell */
-        for (std::pair<const octomap::OcTreeKey, unsigned int>& it : *process_occupied_cells_set_)
-          if (tree_->computeRayKeys(process_sensor_origin_, tree_->keyToCoord(it.first), key_ray1))
-            for (octomap::OcTreeKey& jt : key_ray1)
-              free_cells1[jt] += it.second;
-      }
-
-#pragma omp section
-      {
-        /* compute the free cells along each ray that ends at a model cell */
-        for (const octomap::OcTreeKey& it : *process_model_cells_set_)
-          if (tree_->computeRayKeys(process_sensor_origin_, tree_->keyToCoord(it), key_ray2))
-            for (octomap::OcTreeKey& jt : key_ray2)
-              free_cells2[jt]++;
-      }
-    }
-
+    computeFreeCells(free_cells);
     tree_->unlockRead();
 
     for (std::pair<const octomap::OcTreeKey, unsigned int>& it : *process_occupied_cells_set_)
-    {
-      free_cells1.erase(it.first);
-      free_cells2.erase(it.first);
-    }
+      free_cells.erase(it.first);
 
     for (const octomap::OcTreeKey& it : *process_model_cells_set_)
-    {
-      free_cells1.erase(it);
-      free_cells2.erase(it);
-    }
-    RCLCPP_DEBUG(LOGGER, "Marking %lu cells as free...", (long unsigned int)(free_cells1.size() + free_cells2.size()));
+      free_cells.erase(it);
+    RCLCPP_DEBUG(LOGGER, "Marking %lu cells as free...", (long unsigned int)free_cells.size());
 
     tree_->lockWrite();
 
@@ -177,9 +214,7 @@ void LazyFreeSpaceUpdater::processThread()
         tree_->updateNode(it, lg_0);
 
       /* mark free cells only if not seen occupied in this cloud */
-      for (std::pair<const octomap::OcTreeKey, unsigned int>& it : free_cells1)
-        tree_->updateNode(it.first, it.second * lg_miss);
-      for (std::pair<const octomap::OcTreeKey, unsigned int>& it : free_cells2)
+      for (std::pair<const octomap::OcTreeKey, unsigned int>& it : free_cells)
         tree_->updateNode(it.first, it.second * lg_miss);
     }
     catch (...)
@@ -189,7 +224,18 @@ void LazyFreeSpaceUpdater::processThread()
     tree_->unlockWrite();
     tree_->triggerUpdateCallback();
 
-    RCLCPP_DEBUG(LOGGER, "Marked free cells in %lf ms", (clock.now() - start).seconds() * 1000.0);
+    const double processing_time = (clock.now() - start).seconds();
+    const double latency =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - process_push_time_).count();
+    {
+      std::scoped_lock _(statistics_lock_);
+      ++statistics_.processed_batches;
+      statistics_.last_processing_time = processing_time;
+      statistics_.last_latency = latency;
+      statistics_.average_latency += (latency - statistics_.average_latency) / statistics_.processed_batches;
+    }
+    RCLCPP_DEBUG(LOGGER, "Marked free cells in %lf ms, %lf ms after the oldest cells of the batch were pushed",
+                 processing_time * 1000.0, latency * 1000.0);
 
     delete process_occupied_cells_set_;
     process_occupied_cells_set_ = nullptr;
@@ -203,6 +249,7 @@ void LazyFreeSpaceUpdater::lazyUpdateThread()
   OcTreeKeyCountMap* occupied_cells_set = nullptr;
   octomap::KeySet* model_cells_set = nullptr;
   octomap::point3d sensor_origin;
+  std::chrono::steady_clock::time_point push_time;
   unsigned int batch_size = 0;
 
   while (running_)
@@ -226,6 +273,8 @@ void LazyFreeSpaceUpdater::lazyUpdateThread()
       model_cells_sets_.pop_front();
       sensor_origin = sensor_origins_.front();
       sensor_origins_.pop_front();
+      push_time = push_times_.front();
+      push_times_.pop_front();
       batch_size++;
     }
 
@@ -235,11 +284,12 @@ void LazyFreeSpaceUpdater::lazyUpdateThread()
       {
         RCLCPP_DEBUG(LOGGER, "Pushing %u sets of occupied/model cells to free cells update thread (origin changed)",
                      batch_size);
-        pushBatchToProcess(occupied_cells_set, model_cells_set, sensor_origin);
+        pushBatchToProcess(occupied_cells_set, model_cells_set, sensor_origin, push_time);
         batch_size = 0;
         break;
       }
       sensor_origins_.pop_front();
+      push_times_.pop_front();
 
       octomap::KeySet* add_occ = occupied_cells_sets_.front();
       for (const octomap::OcTreeKey& it : *add_occ)
@@ -256,7 +306,7 @@ void LazyFreeSpaceUpdater::lazyUpdateThread()
     if (batch_size >= max_batch_size_)
     {
       RCLCPP_DEBUG(LOGGER, "Pushing %u sets of occupied/model cells to free cells update thread", batch_size);
-      pushBatchToProcess(occupied_cells_set, model_cells_set, sensor_origin);
+      pushBatchToProcess(occupied_cells_set, model_cells_set, sensor_origin, push_time);
       occupied_cells_set = nullptr;
       batch_size = 0;
     }
@@ -69,8 +69,9 @@ public:
    * \param[in] height height of the framebuffers
    * \param[in] near distance of the near clipping plane in meters
    * \param[in] far distance of the far clipping plane in meters
+   * \param[in] color_format internal format of the color buffer, e.g. GL_RGBA16 for 16 bits per channel
    */
-  GLRenderer(unsigned width, unsigned height, float near = 0.1, float far = 10.0);
+  GLRenderer(unsigned width, unsigned height, float near = 0.1, float far = 10.0, GLint color_format = GL_RGBA);
 
   /** \brief destructor, destroys frame buffer objects and OpenGL context*/
   ~GLRenderer();
@@ -101,6 +102,12 @@ public:
    */
   void getColorBuffer(unsigned char* buffer) const;
 
+  /**
+   * \brief retrieves the color buffer from OpenGL with 16 bits per channel
+   * \param[out] buffer pointer to memory where the RGBA color values need to be stored
+   */
+  void getColorBuffer(unsigned short* buffer) const;
+
   /**
    * \brief retrieves the depth buffer from OpenGL
    * \author Suat Gedikli (gedikli@willowgarage.com)
@@ -280,6 +287,9 @@ private:
   /** \brief handle to program that is currently used*/
   GLuint program_;
 
+  /** \brief internal format of the color buffer*/
+  GLint color_format_;
+
   /** \brief distance of near clipping plane in meters*/
   float near_;
 
@@ -75,16 +75,18 @@ public:
   /**
    * \brief returns the Sensor Parameters
    * \author Suat Gedikli (gedikli@willowgarage.com)
+   * \param[in] sensor index of the sensor as returned by addSensor
    * \return reference of the parameters object of the used Sensor
    */
-  typename SensorType::Parameters& parameters();
+  typename SensorType::Parameters& parameters(unsigned int sensor = 0);
 
   /**
    * \brief returns the Sensor Parameters
    * \author Suat Gedikli (gedikli@willowgarage.com)
+   * \param[in] sensor index of the sensor as returned by addSensor
    * \return const reference of the parameters object of the used Sensor
    */
-  const typename SensorType::Parameters& parameters() const;
+  const typename SensorType::Parameters& parameters(unsigned int sensor = 0) const;
 };
 
 template <typename SensorType>
@@ -97,15 +99,15 @@ MeshFilter<SensorType>::MeshFilter(const TransformCallback& transform_callback,
 }
 
 template <typename SensorType>
-typename SensorType::Parameters& MeshFilter<SensorType>::parameters()
+typename SensorType::Parameters& MeshFilter<SensorType>::parameters(unsigned int sensor)
 {
-  return static_cast<typename SensorType::Parameters&>(*sensor_parameters_);
+  return static_cast<typename SensorType::Parameters&>(*sensors_.at(sensor).parameters);
 }
 
 template <typename SensorType>
-const typename SensorType::Parameters& MeshFilter<SensorType>::parameters() const
+const typename SensorType::Parameters& MeshFilter<SensorType>::parameters(unsigned int sensor) const
 {
-  return static_cast<typename SensorType::Parameters&>(*sensor_parameters_);
+  return static_cast<typename SensorType::Parameters&>(*sensors_.at(sensor).parameters);
 }
 
 }  // namespace mesh_filter
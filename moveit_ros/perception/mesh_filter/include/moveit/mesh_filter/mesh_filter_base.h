@@ -41,10 +41,12 @@
 #include <moveit/mesh_filter/gl_renderer.h>
 #include <moveit/mesh_filter/sensor_model.h>
 #include <Eigen/Geometry>  // for Isometry3d
+#include <eigen_stl_containers/eigen_stl_vector_container.h>
 #include <queue>
 #include <thread>
 #include <condition_variable>
 #include <mutex>
+#include <vector>
 
 // forward declarations
 namespace shapes
@@ -77,6 +79,14 @@ public:
     FIRST_LABEL = 16
   };
 
+  /** \brief classification stored in the fourth channel of the keys returned by getOctreeKeys */
+  enum
+  {
+    NO_KEY = 0,
+    OCCUPIED_KEY = 1,
+    MODEL_KEY = 2
+  };
+
 public:
   /**
    * \brief Constructor
@@ -108,6 +118,19 @@ public:
    */
   void removeMesh(MeshHandle mesh_handle);
 
+  /**
+   * \brief adds another sensor that is rendered together with the sensor passed to the constructor. All sensors share
+   *        the OpenGL context, the uploaded meshes and the mesh transforms of a filter call.
+   * \param[in] sensor_parameters the parameters of the additional sensor
+   * \return index of the sensor, used to pass its data to filter and to retrieve its results. The sensor passed to
+   *         the constructor has index 0.
+   * \note sensors need to be added before filtering starts, as the results are not synchronized with this call.
+   */
+  unsigned int addSensor(const SensorModel::Parameters& sensor_parameters);
+
+  /** \brief returns the number of sensors, including the one passed to the constructor */
+  std::size_t getSensorCount() const;
+
   /**
    * \brief label/remove pixels from input depth-image
    * \author Suat Gedikli (gedikli@willowgarage.com)
@@ -116,40 +139,68 @@ public:
    */
   void filter(const void* sensor_data, GLushort type, bool wait = false) const;
 
+  /**
+   * \brief label/remove pixels from the depth images of several sensors in one batch
+   * \param[in] sensor_data pointers to the input depth images, indexed by sensor. Null pointers skip a sensor.
+   * \param[in] type the type of the data, GL_FLOAT or GL_UNSIGNED_SHORT
+   * \param[in] wait whether to wait until the images are filtered
+   */
+  void filter(const std::vector<const void*>& sensor_data, GLushort type, bool wait = false) const;
+
   /**
    * \brief retrieves the labels of the input data
    * \author Suat Gedikli (gedikli@willowgarage.com)
    * \param[out] labels pointer to buffer to be filled with labels
+   * \param[in] sensor index of the sensor as returned by addSensor
    * \note labels are corresponding 1-1 to the mesh handles. 0 and 1 are reserved indicating either background (0) or
    * shadow (1)
    *       The upper 8bit of a label is filled with the user given flag (see addMesh)
    */
-  void getFilteredLabels(LabelType* labels) const;
+  void getFilteredLabels(LabelType* labels, unsigned int sensor = 0) const;
 
   /**
    * \brief retrieves the filtered depth values
    * \author Suat Gedikli (gedikli@willowgarage.com)
    * \param[out] depth pointer to buffer to be filled with depth values.
+   * \param[in] sensor index of the sensor as returned by addSensor
    */
-  void getFilteredDepth(float* depth) const;
+  void getFilteredDepth(float* depth, unsigned int sensor = 0) const;
 
   /**
    * \brief retrieves the labels of the rendered model
    * \author Suat Gedikli (gedikli@willowgarage.com)
    * \param[out] labels pointer to buffer to be filled with labels
+   * \param[in] sensor index of the sensor as returned by addSensor
    * \note labels are corresponding 1-1 to the mesh handles. 0 and 1 are reserved indicating either background (0) or
    * shadow (1)
    *       The upper 8bit of a label is filled with the user given flag (see addMesh)
    * \todo How is this data different from the filtered labels?
    */
-  void getModelLabels(LabelType* labels) const;
+  void getModelLabels(LabelType* labels, unsigned int sensor = 0) const;
 
   /**
    * \brief retrieves the depth values of the rendered model
    * \author Suat Gedikli (gedikli@willowgarage.com)
    * \param[out] depth pointer to buffer to be filled with depth values.
+   * \param[in] sensor index of the sensor as returned by addSensor
+   */
+  void getModelDepth(float* depth, unsigned int sensor = 0) const;
+
+  /**
+   * \brief back-projects the filtered depth image and computes the octree key of every pixel on the GPU
+   * \param[in] sensor_pose the pose of the sensor in the frame of the octree
+   * \param[in] fx focal length in x-direction of the depth camera
+   * \param[in] fy focal length in y-direction of the depth camera
+   * \param[in] cx x-coordinate of the principal point of the depth camera
+   * \param[in] cy y-coordinate of the principal point of the depth camera
+   * \param[in] resolution the resolution of the octree
+   * \param[out] keys pointer to buffer to be filled with four values per pixel: the x, y and z key of the point
+   *             followed by NO_KEY, OCCUPIED_KEY (background) or MODEL_KEY (model or far clipping plane)
+   * \param[in] sensor index of the sensor as returned by addSensor
+   * \note uses the result of the last call to filter. Far clipped points are placed on the far clipping plane.
    */
-  void getModelDepth(float* depth) const;
+  void getOctreeKeys(const Eigen::Isometry3d& sensor_pose, float fx, float fy, float cx, float cy, double resolution,
+                     unsigned short* keys, unsigned int sensor = 0) const;
 
   /**
    * \brief set the shadow threshold. points that are further away than the rendered model are filtered out.
@@ -181,6 +232,28 @@ public:
   void setPaddingOffset(float offset);
 
 protected:
+  /** \brief the parameters and rendering passes of a single sensor */
+  struct SensorPass
+  {
+    /** \brief the parameters of the used sensor model*/
+    SensorModel::ParametersPtr parameters;
+
+    /** \brief first pass renderer for rendering the mesh*/
+    GLRendererPtr mesh_renderer;
+
+    /** \brief second pass renderer for filtering the results of first pass*/
+    GLRendererPtr depth_filter;
+
+    /** \brief third pass renderer for computing octree keys from the results of the second pass*/
+    GLRendererPtr key_generator;
+
+    /** \brief handle depth texture from sensor data*/
+    GLuint sensor_depth_texture = 0;
+
+    /** \brief handle to GLSL location of shadow threshold*/
+    GLuint shadow_threshold_location = 0;
+  };
+
   /**
    * \brief initializes OpenGL related things as well as renderers
    */
@@ -192,6 +265,12 @@ protected:
    */
   void deInitialize();
 
+  /**
+   * \brief creates the renderers and textures of a sensor
+   * \param[in,out] sensor the sensor whose parameters are set and whose renderers are created
+   */
+  void initializeSensor(SensorPass& sensor) const;
+
   /**
    * \brief filtering thread
    */
@@ -200,10 +279,32 @@ protected:
 
   /**
    * \brief the filter method that does the magic
+   * \param[in] sensor_data pointers to the buffers containing the depth readings of each sensor
+   * \param[in] encoding the representation of the depth readings in the buffers
+   */
+  void doFilter(const std::vector<const void*>& sensor_data, const int encoding) const;
+
+  /**
+   * \brief renders the meshes into the view of one sensor and filters its depth readings
+   * \param[in] sensor the sensor to render
    * \param[in] sensor_data pointer to the buffer containing the depth readings
    * \param[in] encoding the representation of the depth readings in the buffer
+   * \param[in] meshes the meshes to be rendered
+   * \param[in] transforms the transforms of the meshes
    */
-  void doFilter(const void* sensor_data, const int encoding) const;
+  void renderSensor(const SensorPass& sensor, const void* sensor_data, const int encoding,
+                    const std::vector<const GLMesh*>& meshes, const EigenSTL::vector_Isometry3d& transforms) const;
+
+  /**
+   * \brief renders the octree keys of the last filtered depth image with the third rendering stage
+   * \param[in] sensor the sensor whose filtered depth image is used
+   * \param[in] sensor_pose the pose of the sensor in the frame of the octree
+   * \param[in] camera the camera intrinsics fx, fy, cx and cy
+   * \param[in] resolution the resolution of the octree
+   * \param[out] keys pointer to buffer to be filled with the keys
+   */
+  void doGetOctreeKeys(const SensorPass& sensor, const Eigen::Isometry3d& sensor_pose, const Eigen::Vector4f& camera,
+                       double resolution, unsigned short* keys) const;
 
   /**
    * \brief used within a Job to allow the main thread adding meshes
@@ -235,8 +336,14 @@ protected:
   /** \brief storage for meshed to be filtered */
   std::map<MeshHandle, GLMeshPtr> meshes_;
 
-  /** \brief the parameters of the used sensor model*/
-  SensorModel::ParametersPtr sensor_parameters_;
+  /** \brief the sensors rendered by this filter, the first one is passed to the constructor*/
+  std::vector<SensorPass> sensors_;
+
+  /** \brief shader sources used to create the renderers of each sensor*/
+  std::string render_vertex_shader_;
+  std::string render_fragment_shader_;
+  std::string filter_vertex_shader_;
+  std::string filter_fragment_shader_;
 
   /** \brief next handle to be used for next mesh that is added*/
   MeshHandle next_handle_;
@@ -266,21 +373,9 @@ protected:
   /** \brief indicates whether the filtering loop should stop*/
   bool stop_;
 
-  /** \brief first pass renderer for rendering the mesh*/
-  GLRendererPtr mesh_renderer_;
-
-  /** \brief second pass renderer for filtering the results of first pass*/
-  GLRendererPtr depth_filter_;
-
   /** \brief canvas element (screen-filling quad) for second pass*/
   GLuint canvas_;
 
-  /** \brief handle depth texture from sensor data*/
-  GLuint sensor_depth_texture_;
-
-  /** \brief handle to GLSL location of shadow threshold*/
-  GLuint shadow_threshold_location_;
-
   /** \brief callback function for retrieving the mesh transformations*/
   TransformCallback transform_callback_;
 
@@ -39,10 +39,18 @@
 #include <OpenGL/glu.h>
 #else
 #include <GL/glu.h>
+#endif
+#ifdef MOVEIT_MESH_FILTER_USE_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#else
+#ifndef __APPLE__
 #include <GL/glut.h>
 #endif
 #include <GL/freeglut.h>
+#endif
 #include <moveit/mesh_filter/gl_renderer.h>
+#include <cstring>
 #include <sstream>
 #include <fstream>
 #include <stdexcept>
@@ -55,7 +63,7 @@ using namespace std;
 
 static const rclcpp::Logger LOGGER = rclcpp::get_logger("moveit.ros.perception.gl_renderer");
 
-mesh_filter::GLRenderer::GLRenderer(unsigned width, unsigned height, float near, float far)
+mesh_filter::GLRenderer::GLRenderer(unsigned width, unsigned height, float near, float far, GLint color_format)
   : width_(width)
   , height_(height)
   , fbo_id_(0)
@@ -63,6 +71,7 @@ mesh_filter::GLRenderer::GLRenderer(unsigned width, unsigned height, float near,
   , rgb_id_(0)
   , depth_id_(0)
   , program_(0)
+  , color_format_(color_format)
   , near_(near)
   , far_(far)
   , fx_(width >> 1)  // 90 degree wide angle
@@ -130,7 +139,7 @@ void mesh_filter::GLRenderer::initFrameBuffers()
 {
   glGenTextures(1, &rgb_id_);
   glBindTexture(GL_TEXTURE_2D, rgb_id_);
-  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width_, height_, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+  glTexImage2D(GL_TEXTURE_2D, 0, color_format_, width_, height_, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
   glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
   glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -214,6 +223,14 @@ void mesh_filter::GLRenderer::getColorBuffer(unsigned char* buffer) const
   glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
+void mesh_filter::GLRenderer::getColorBuffer(unsigned short* buffer) const
+{
+  glBindFramebuffer(GL_FRAMEBUFFER, fbo_id_);
+  glBindTexture(GL_TEXTURE_2D, rgb_id_);
+  glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_SHORT, buffer);
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
 void mesh_filter::GLRenderer::getDepthBuffer(float* buffer) const
 {
   glBindFramebuffer(GL_FRAMEBUFFER, fbo_id_);
@@ -359,6 +376,114 @@ map<std::thread::id, pair<unsigned, GLuint> > mesh_filter::GLRenderer::context_;
 std::mutex mesh_filter::GLRenderer::context_lock_;
 bool mesh_filter::GLRenderer::glutInitialized_ = false;
 
+#ifdef MOVEIT_MESH_FILTER_USE_EGL
+namespace
+{
+EGLDisplay egl_display = EGL_NO_DISPLAY;
+map<std::thread::id, EGLContext> egl_contexts;
+
+// prefer an EGL device, which does not require a running display server, over the default display
+EGLDisplay getEGLDisplay()
+{
+  auto query_devices = reinterpret_cast<PFNEGLQUERYDEVICESEXTPROC>(eglGetProcAddress("eglQueryDevicesEXT"));
+  auto get_platform_display =
+      reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+  if (query_devices && get_platform_display)
+  {
+    static const EGLint MAX_DEVICES = 16;
+    EGLDeviceEXT devices[MAX_DEVICES];
+    EGLint device_count = 0;
+    if (query_devices(MAX_DEVICES, devices, &device_count))
+      for (EGLint i = 0; i < device_count; ++i)
+      {
+        EGLDisplay display = get_platform_display(EGL_PLATFORM_DEVICE_EXT, devices[i], nullptr);
+        if (display != EGL_NO_DISPLAY && eglInitialize(display, nullptr, nullptr))
+          return display;
+      }
+  }
+
+  EGLDisplay display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+  if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr))
+    throw runtime_error("Unable to initialize an EGL display");
+  return display;
+}
+}  // namespace
+
+void mesh_filter::GLRenderer::createGLContext()
+{
+  std::unique_lock<std::mutex> _(context_lock_);
+  if (egl_display == EGL_NO_DISPLAY)
+    egl_display = getEGLDisplay();
+
+  // check if our thread is initialized
+  std::thread::id thread_id = std::this_thread::get_id();
+  map<std::thread::id, pair<unsigned, GLuint> >::iterator context_it = context_.find(thread_id);
+
+  if (context_it == context_.end())
+  {
+    // all rendering goes to frame buffer objects, so no surface is needed
+    static const EGLint CONFIG_ATTRIBUTES[] = {
+      EGL_SURFACE_TYPE, EGL_PBUFFER_BIT, EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_DEPTH_SIZE, 24, EGL_NONE
+    };
+    if (!eglBindAPI(EGL_OPENGL_API))
+      throw runtime_error("EGL does not support the OpenGL API");
+
+    EGLConfig config;
+    EGLint config_count = 0;
+    if (!eglChooseConfig(egl_display, CONFIG_ATTRIBUTES, &config, 1, &config_count) || config_count == 0)
+      throw runtime_error("Unable to find an EGL configuration supporting OpenGL");
+
+    EGLContext egl_context = eglCreateContext(egl_display, config, EGL_NO_CONTEXT, nullptr);
+    if (egl_context == EGL_NO_CONTEXT)
+      throw runtime_error("Unable to create an EGL context");
+    if (!eglMakeCurrent(egl_display, EGL_NO_SURFACE, EGL_NO_SURFACE, egl_context))
+    {
+      eglDestroyContext(egl_display, egl_context);
+      throw runtime_error("Unable to make the EGL context current");
+    }
+
+    GLenum err = glewInit();
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+    // GLEW built for GLX fails to load the GLX extensions without an X display, the OpenGL functions are loaded anyway
+    if (err == GLEW_ERROR_NO_GLX_DISPLAY)
+      err = GLEW_OK;
+#endif
+    if (GLEW_OK != err)
+    {
+      stringstream error_stream;
+      error_stream << "Unable to initialize GLEW: " << glewGetErrorString(err);
+
+      throw(runtime_error(error_stream.str()));
+    }
+
+    egl_contexts[thread_id] = egl_context;
+    context_[thread_id] = std::pair<unsigned, GLuint>(1, 0);
+  }
+  else
+    ++(context_it->second.first);
+}
+
+void mesh_filter::GLRenderer::deleteGLContext()
+{
+  std::unique_lock<std::mutex> _(context_lock_);
+  std::thread::id thread_id = std::this_thread::get_id();
+  map<std::thread::id, pair<unsigned, GLuint> >::iterator context_it = context_.find(thread_id);
+  if (context_it == context_.end())
+  {
+    stringstream error_msg;
+    error_msg << "No OpenGL context exists for Thread " << thread_id;
+    throw runtime_error(error_msg.str());
+  }
+
+  if (--(context_it->second.first) == 0)
+  {
+    eglMakeCurrent(egl_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    eglDestroyContext(egl_display, egl_contexts[thread_id]);
+    egl_contexts.erase(thread_id);
+    context_.erase(context_it);
+  }
+}
+#else
 namespace
 {
 void nullDisplayFunction()
@@ -431,6 +556,7 @@ void mesh_filter::GLRenderer::deleteGLContext()
     context_.erase(context_it);
   }
 }
+#endif
 
 GLuint mesh_filter::GLRenderer::getColorTexture() const
 {
@@ -51,14 +51,52 @@
 #include <xmmintrin.h>
 #endif
 
+namespace
+{
+const std::string KEY_VERTEX_SHADER_SOURCE = "#version 120\n"
+                                             "void main ()"
+                                             "{"
+                                             "  gl_TexCoord[0] = gl_MultiTexCoord0;"
+                                             "  gl_Position = gl_Vertex;"
+                                             "  gl_Position.w = 1.0;"
+                                             "}";
+
+// back-projects every pixel of the sensor depth image and writes the octree key of the point together with its class
+// (none, occupied or model) derived from the filtered labels. Keys follow octomap's convention of
+// floor(coordinate / resolution) + 32768 and are stored as normalized 16 bit values.
+const std::string KEY_FRAGMENT_SHADER_SOURCE =
+    "#version 120\n"
+    "uniform sampler2D sensor;"
+    "uniform sampler2D label;"
+    "uniform float near;"
+    "uniform float far;"
+    "uniform vec4 camera;"
+    "uniform mat4 sensor_pose;"
+    "uniform float inv_resolution;"
+    "void main()"
+    "{"
+    " vec4 lValue = floor(texture2D(label, gl_TexCoord[0].st) * 255.0 + 0.5);"
+    " float upper = lValue.g + lValue.b + lValue.a;"
+    " float key_class = 0.0;"
+    " if (upper == 0.0 && lValue.r == 0.0)"
+    "   key_class = 1.0;"
+    " else if (upper > 0.0 || lValue.r >= 3.0)"
+    "   key_class = 2.0;"
+    " float z = near + float(texture2D(sensor, gl_TexCoord[0].st)) * (far - near);"
+    " vec2 pixel = floor(gl_FragCoord.xy);"
+    " vec4 point = sensor_pose * vec4((pixel - camera.zw) / camera.xy * z, z, 1.0);"
+    " vec3 key = clamp(floor(point.xyz * inv_resolution) + 32768.0, 0.0, 65535.0);"
+    " gl_FragColor = vec4(key, key_class) / 65535.0;"
+    "}";
+}  // namespace
+
 mesh_filter::MeshFilterBase::MeshFilterBase(const TransformCallback& transform_callback,
                                             const SensorModel::Parameters& sensor_parameters,
                                             const std::string& render_vertex_shader,
                                             const std::string& render_fragment_shader,
                                             const std::string& filter_vertex_shader,
                                             const std::string& filter_fragment_shader)
-  : sensor_parameters_(sensor_parameters.clone())
-  , next_handle_(FIRST_LABEL)  // 0 and 1 are reserved!
+  : next_handle_(FIRST_LABEL)  // 0 and 1 are reserved!
   , min_handle_(FIRST_LABEL)
   , stop_(false)
   , transform_callback_(transform_callback)
@@ -66,6 +104,9 @@ mesh_filter::MeshFilterBase::MeshFilterBase(const TransformCallback& transform_c
   , padding_offset_(0.01)
   , shadow_threshold_(0.5)
 {
+  sensors_.emplace_back();
+  sensors_.front().parameters.reset(sensor_parameters.clone());
+
   filter_thread_ =
       std::thread([this, render_vertex_shader, render_fragment_shader, filter_vertex_shader, filter_fragment_shader] {
         run(render_vertex_shader, render_fragment_shader, filter_vertex_shader, filter_fragment_shader);
@@ -77,27 +118,12 @@ void mesh_filter::MeshFilterBase::initialize(const std::string& render_vertex_sh
                                              const std::string& filter_vertex_shader,
                                              const std::string& filter_fragment_shader)
 {
-  mesh_renderer_ = std::make_shared<GLRenderer>(sensor_parameters_->getWidth(), sensor_parameters_->getHeight(),
-                                                sensor_parameters_->getNearClippingPlaneDistance(),
-                                                sensor_parameters_->getFarClippingPlaneDistance());
-  depth_filter_ = std::make_shared<GLRenderer>(sensor_parameters_->getWidth(), sensor_parameters_->getHeight(),
-                                               sensor_parameters_->getNearClippingPlaneDistance(),
-                                               sensor_parameters_->getFarClippingPlaneDistance());
-
-  mesh_renderer_->setShadersFromString(render_vertex_shader, render_fragment_shader);
-  depth_filter_->setShadersFromString(filter_vertex_shader, filter_fragment_shader);
-
-  depth_filter_->begin();
+  render_vertex_shader_ = render_vertex_shader;
+  render_fragment_shader_ = render_fragment_shader;
+  filter_vertex_shader_ = filter_vertex_shader;
+  filter_fragment_shader_ = filter_fragment_shader;
 
-  glGenTextures(1, &sensor_depth_texture_);
-
-  glUniform1i(glGetUniformLocation(depth_filter_->getProgramID(), "sensor"), 0);
-  glUniform1i(glGetUniformLocation(depth_filter_->getProgramID(), "depth"), 2);
-  glUniform1i(glGetUniformLocation(depth_filter_->getProgramID(), "label"), 4);
-
-  shadow_threshold_location_ = glGetUniformLocation(depth_filter_->getProgramID(), "shadow_threshold");
-
-  depth_filter_->end();
+  initializeSensor(sensors_.front());
 
   canvas_ = glGenLists(1);
   glNewList(canvas_, GL_COMPILE);
@@ -120,6 +146,41 @@ void mesh_filter::MeshFilterBase::initialize(const std::string& render_vertex_sh
   glEndList();
 }
 
+void mesh_filter::MeshFilterBase::initializeSensor(SensorPass& sensor) const
+{
+  const SensorModel::Parameters& parameters = *sensor.parameters;
+  sensor.mesh_renderer =
+      std::make_shared<GLRenderer>(parameters.getWidth(), parameters.getHeight(),
+                                   parameters.getNearClippingPlaneDistance(), parameters.getFarClippingPlaneDistance());
+  sensor.depth_filter =
+      std::make_shared<GLRenderer>(parameters.getWidth(), parameters.getHeight(),
+                                   parameters.getNearClippingPlaneDistance(), parameters.getFarClippingPlaneDistance());
+  sensor.key_generator = std::make_shared<GLRenderer>(parameters.getWidth(), parameters.getHeight(),
+                                                      parameters.getNearClippingPlaneDistance(),
+                                                      parameters.getFarClippingPlaneDistance(), GL_RGBA16);
+
+  sensor.mesh_renderer->setShadersFromString(render_vertex_shader_, render_fragment_shader_);
+  sensor.depth_filter->setShadersFromString(filter_vertex_shader_, filter_fragment_shader_);
+  sensor.key_generator->setShadersFromString(KEY_VERTEX_SHADER_SOURCE, KEY_FRAGMENT_SHADER_SOURCE);
+
+  sensor.depth_filter->begin();
+
+  glGenTextures(1, &sensor.sensor_depth_texture);
+
+  glUniform1i(glGetUniformLocation(sensor.depth_filter->getProgramID(), "sensor"), 0);
+  glUniform1i(glGetUniformLocation(sensor.depth_filter->getProgramID(), "depth"), 2);
+  glUniform1i(glGetUniformLocation(sensor.depth_filter->getProgramID(), "label"), 4);
+
+  sensor.shadow_threshold_location = glGetUniformLocation(sensor.depth_filter->getProgramID(), "shadow_threshold");
+
+  sensor.depth_filter->end();
+
+  sensor.key_generator->begin();
+  glUniform1i(glGetUniformLocation(sensor.key_generator->getProgramID(), "sensor"), 0);
+  glUniform1i(glGetUniformLocation(sensor.key_generator->getProgramID(), "label"), 4);
+  sensor.key_generator->end();
+}
+
 mesh_filter::MeshFilterBase::~MeshFilterBase()
 {
   {
@@ -147,20 +208,30 @@ void mesh_filter::MeshFilterBase::addJob(const JobPtr& job) const
 void mesh_filter::MeshFilterBase::deInitialize()
 {
   glDeleteLists(canvas_, 1);
-  glDeleteTextures(1, &sensor_depth_texture_);
+  for (SensorPass& sensor : sensors_)
+  {
+    glDeleteTextures(1, &sensor.sensor_depth_texture);
+    sensor.mesh_renderer.reset();
+    sensor.depth_filter.reset();
+    sensor.key_generator.reset();
+  }
 
   meshes_.clear();
-  mesh_renderer_.reset();
-  depth_filter_.reset();
 }
 
 void mesh_filter::MeshFilterBase::setSize(unsigned int width, unsigned int height)
 {
-  mesh_renderer_->setBufferSize(width, height);
-  mesh_renderer_->setCameraParameters(width, width, width >> 1, height >> 1);
+  for (SensorPass& sensor : sensors_)
+  {
+    sensor.mesh_renderer->setBufferSize(width, height);
+    sensor.mesh_renderer->setCameraParameters(width, width, width >> 1, height >> 1);
 
-  depth_filter_->setBufferSize(width, height);
-  depth_filter_->setCameraParameters(width, width, width >> 1, height >> 1);
+    sensor.depth_filter->setBufferSize(width, height);
+    sensor.depth_filter->setCameraParameters(width, width, width >> 1, height >> 1);
+
+    sensor.key_generator->setBufferSize(width, height);
+    sensor.key_generator->setCameraParameters(width, width, width >> 1, height >> 1);
+  }
 }
 
 void mesh_filter::MeshFilterBase::setTransformCallback(const TransformCallback& transform_callback)
@@ -169,6 +240,27 @@ void mesh_filter::MeshFilterBase::setTransformCallback(const TransformCallback&
   transform_callback_ = transform_callback;
 }
 
+unsigned int mesh_filter::MeshFilterBase::addSensor(const SensorModel::Parameters& sensor_parameters)
+{
+  SensorPass sensor;
+  sensor.parameters.reset(sensor_parameters.clone());
+
+  FilterJob<unsigned int>* adder = new FilterJob<unsigned int>([this, &sensor] {
+    initializeSensor(sensor);
+    sensors_.push_back(sensor);
+    return static_cast<unsigned int>(sensors_.size() - 1);
+  });
+  JobPtr job(adder);
+  addJob(job);
+  job->wait();
+  return adder->getResult();
+}
+
+std::size_t mesh_filter::MeshFilterBase::getSensorCount() const
+{
+  return sensors_.size();
+}
+
 mesh_filter::MeshHandle mesh_filter::MeshFilterBase::addMesh(const shapes::Mesh& mesh)
 {
   std::unique_lock<std::mutex> _(meshes_mutex_);
@@ -217,20 +309,21 @@ void mesh_filter::MeshFilterBase::setShadowThreshold(float threshold)
   shadow_threshold_ = threshold;
 }
 
-void mesh_filter::MeshFilterBase::getModelLabels(LabelType* labels) const
+void mesh_filter::MeshFilterBase::getModelLabels(LabelType* labels, unsigned int sensor) const
 {
-  JobPtr job(
-      new FilterJob<void>([&renderer = *mesh_renderer_, labels] { renderer.getColorBuffer((unsigned char*)labels); }));
+  JobPtr job(new FilterJob<void>(
+      [&renderer = *sensors_.at(sensor).mesh_renderer, labels] { renderer.getColorBuffer((unsigned char*)labels); }));
   addJob(job);
   job->wait();
 }
 
-void mesh_filter::MeshFilterBase::getModelDepth(float* depth) const
+void mesh_filter::MeshFilterBase::getModelDepth(float* depth, unsigned int sensor) const
 {
+  const SensorPass& pass = sensors_.at(sensor);
   JobPtr job1 =
-      std::make_shared<FilterJob<void>>([&renderer = *mesh_renderer_, depth] { renderer.getDepthBuffer(depth); });
+      std::make_shared<FilterJob<void>>([&renderer = *pass.mesh_renderer, depth] { renderer.getDepthBuffer(depth); });
   JobPtr job2 = std::make_shared<FilterJob<void>>(
-      [&parameters = *sensor_parameters_, depth] { parameters.transformModelDepthToMetricDepth(depth); });
+      [&parameters = *pass.parameters, depth] { parameters.transformModelDepthToMetricDepth(depth); });
   {
     std::unique_lock<std::mutex> lock(jobs_mutex_);
     jobs_queue_.push(job1);
@@ -241,11 +334,13 @@ void mesh_filter::MeshFilterBase::getModelDepth(float* depth) const
   job2->wait();
 }
 
-void mesh_filter::MeshFilterBase::getFilteredDepth(float* depth) const
+void mesh_filter::MeshFilterBase::getFilteredDepth(float* depth, unsigned int sensor) const
 {
-  JobPtr job1 = std::make_shared<FilterJob<void>>([&filter = *depth_filter_, depth] { filter.getDepthBuffer(depth); });
+  const SensorPass& pass = sensors_.at(sensor);
+  JobPtr job1 =
+      std::make_shared<FilterJob<void>>([&filter = *pass.depth_filter, depth] { filter.getDepthBuffer(depth); });
   JobPtr job2 = std::make_shared<FilterJob<void>>(
-      [&parameters = *sensor_parameters_, depth] { parameters.transformFilteredDepthToMetricDepth(depth); });
+      [&parameters = *pass.parameters, depth] { parameters.transformFilteredDepthToMetricDepth(depth); });
   {
     std::unique_lock<std::mutex> lock(jobs_mutex_);
     jobs_queue_.push(job1);
@@ -256,10 +351,23 @@ void mesh_filter::MeshFilterBase::getFilteredDepth(float* depth) const
   job2->wait();
 }
 
-void mesh_filter::MeshFilterBase::getFilteredLabels(LabelType* labels) const
+void mesh_filter::MeshFilterBase::getFilteredLabels(LabelType* labels, unsigned int sensor) const
 {
   JobPtr job = std::make_shared<FilterJob<void>>(
-      [&filter = *depth_filter_, labels] { filter.getColorBuffer((unsigned char*)labels); });
+      [&filter = *sensors_.at(sensor).depth_filter, labels] { filter.getColorBuffer((unsigned char*)labels); });
+  addJob(job);
+  job->wait();
+}
+
+void mesh_filter::MeshFilterBase::getOctreeKeys(const Eigen::Isometry3d& sensor_pose, float fx, float fy, float cx,
+                                                float cy, double resolution, unsigned short* keys,
+                                                unsigned int sensor) const
+{
+  const SensorPass& pass = sensors_.at(sensor);
+  const Eigen::Vector4f camera(fx, fy, cx, cy);
+  JobPtr job = std::make_shared<FilterJob<void>>([this, &pass, &sensor_pose, camera, resolution, keys] {
+    doGetOctreeKeys(pass, sensor_pose, camera, resolution, keys);
+  });
   addJob(job);
   job->wait();
 }
@@ -291,6 +399,11 @@ void mesh_filter::MeshFilterBase::run(const std::string& render_vertex_shader,
 }
 
 void mesh_filter::MeshFilterBase::filter(const void* sensor_data, GLushort type, bool wait) const
+{
+  filter(std::vector<const void*>(1, sensor_data), type, wait);
+}
+
+void mesh_filter::MeshFilterBase::filter(const std::vector<const void*>& sensor_data, GLushort type, bool wait) const
 {
   if (type != GL_FLOAT && type != GL_UNSIGNED_SHORT)
   {
@@ -298,6 +411,12 @@ void mesh_filter::MeshFilterBase::filter(const void* sensor_data, GLushort type,
     msg << "unknown type \"" << type << "\". Allowed values are GL_FLOAT or GL_UNSIGNED_SHORT.";
     throw std::runtime_error(msg.str());
   }
+  if (sensor_data.size() > sensors_.size())
+  {
+    std::stringstream msg;
+    msg << "got data of " << sensor_data.size() << " sensors, but only " << sensors_.size() << " are registered.";
+    throw std::runtime_error(msg.str());
+  }
 
   JobPtr job = std::make_shared<FilterJob<void>>([this, sensor_data, type] { doFilter(sensor_data, type); });
   addJob(job);
@@ -305,12 +424,36 @@ void mesh_filter::MeshFilterBase::filter(const void* sensor_data, GLushort type,
     job->wait();
 }
 
-void mesh_filter::MeshFilterBase::doFilter(const void* sensor_data, const int encoding) const
+void mesh_filter::MeshFilterBase::doFilter(const std::vector<const void*>& sensor_data, const int encoding) const
 {
   std::unique_lock<std::mutex> _(transform_callback_mutex_);
 
-  mesh_renderer_->begin();
-  sensor_parameters_->setRenderParameters(*mesh_renderer_);
+  // query the mesh transforms only once and render them into the views of all sensors
+  std::vector<const GLMesh*> meshes;
+  EigenSTL::vector_Isometry3d transforms;
+  meshes.reserve(meshes_.size());
+  transforms.reserve(meshes_.size());
+  Eigen::Isometry3d transform;
+  for (const std::pair<const MeshHandle, GLMeshPtr>& mesh : meshes_)
+    if (transform_callback_(mesh.first, transform))
+    {
+      meshes.push_back(mesh.second.get());
+      transforms.push_back(transform);
+    }
+
+  for (std::size_t i = 0; i < sensor_data.size(); ++i)
+    if (sensor_data[i])
+      renderSensor(sensors_[i], sensor_data[i], encoding, meshes, transforms);
+}
+
+void mesh_filter::MeshFilterBase::renderSensor(const SensorPass& sensor, const void* sensor_data, const int encoding,
+                                               const std::vector<const GLMesh*>& meshes,
+                                               const EigenSTL::vector_Isometry3d& transforms) const
+{
+  const SensorModel::Parameters& parameters = *sensor.parameters;
+
+  sensor.mesh_renderer->begin();
+  parameters.setRenderParameters(*sensor.mesh_renderer);
 
   glEnable(GL_TEXTURE_2D);
   glEnable(GL_DEPTH_TEST);
@@ -320,23 +463,21 @@ void mesh_filter::MeshFilterBase::doFilter(const void* sensor_data, const int en
   glDisable(GL_ALPHA_TEST);
   glDisable(GL_BLEND);
 
-  GLuint padding_coefficients_id = glGetUniformLocation(mesh_renderer_->getProgramID(), "padding_coefficients");
+  GLuint padding_coefficients_id = glGetUniformLocation(sensor.mesh_renderer->getProgramID(), "padding_coefficients");
   Eigen::Vector3f padding_coefficients =
-      sensor_parameters_->getPaddingCoefficients() * padding_scale_ + Eigen::Vector3f(0, 0, padding_offset_);
+      parameters.getPaddingCoefficients() * padding_scale_ + Eigen::Vector3f(0, 0, padding_offset_);
   glUniform3f(padding_coefficients_id, padding_coefficients[0], padding_coefficients[1], padding_coefficients[2]);
 
-  Eigen::Isometry3d transform;
-  for (const std::pair<const MeshHandle, GLMeshPtr>& mesh : meshes_)
-    if (transform_callback_(mesh.first, transform))
-      mesh.second->render(transform);
+  for (std::size_t i = 0; i < meshes.size(); ++i)
+    meshes[i]->render(transforms[i]);
 
-  mesh_renderer_->end();
+  sensor.mesh_renderer->end();
 
   // now filter the depth_map with the second rendering stage
   // depth_filter_.setBufferSize (width, height);
   // depth_filter_.setCameraParameters (fx, fy, cx, cy);
-  depth_filter_->begin();
-  sensor_parameters_->setFilterParameters(*depth_filter_);
+  sensor.depth_filter->begin();
+  parameters.setFilterParameters(*sensor.depth_filter);
   glEnable(GL_TEXTURE_2D);
   glEnable(GL_DEPTH_TEST);
   glDepthFunc(GL_ALWAYS);
@@ -346,17 +487,16 @@ void mesh_filter::MeshFilterBase::doFilter(const void* sensor_data, const int en
 
   //  glUniform1f (near_location_, depth_filter_.getNearClippingDistance ());
   //  glUniform1f (far_location_, depth_filter_.getFarClippingDistance ());
-  glUniform1f(shadow_threshold_location_, shadow_threshold_);
+  glUniform1f(sensor.shadow_threshold_location, shadow_threshold_);
 
-  GLuint depth_texture = mesh_renderer_->getDepthTexture();
-  GLuint color_texture = mesh_renderer_->getColorTexture();
+  GLuint depth_texture = sensor.mesh_renderer->getDepthTexture();
+  GLuint color_texture = sensor.mesh_renderer->getColorTexture();
 
   // bind sensor depth
   glActiveTexture(GL_TEXTURE0);
-  glBindTexture(GL_TEXTURE_2D, sensor_depth_texture_);
+  glBindTexture(GL_TEXTURE_2D, sensor.sensor_depth_texture);
 
-  float scale =
-      1.0 / (sensor_parameters_->getFarClippingPlaneDistance() - sensor_parameters_->getNearClippingPlaneDistance());
+  float scale = 1.0 / (parameters.getFarClippingPlaneDistance() - parameters.getNearClippingPlaneDistance());
 
   if (encoding == GL_UNSIGNED_SHORT)
     // unsigned shorts shorts will be mapped to the range 0-1 during transfer. Afterwards we can apply another scale +
@@ -367,9 +507,9 @@ void mesh_filter::MeshFilterBase::doFilter(const void* sensor_data, const int en
     glPixelTransferf(GL_DEPTH_SCALE, scale * 65.535);
   else
     glPixelTransferf(GL_DEPTH_SCALE, scale);
-  glPixelTransferf(GL_DEPTH_BIAS, -scale * sensor_parameters_->getNearClippingPlaneDistance());
+  glPixelTransferf(GL_DEPTH_BIAS, -scale * parameters.getNearClippingPlaneDistance());
 
-  glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, sensor_parameters_->getWidth(), sensor_parameters_->getHeight(), 0,
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, parameters.getWidth(), parameters.getHeight(), 0,
                GL_DEPTH_COMPONENT, encoding, sensor_data);
   glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
   glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
@@ -384,7 +524,38 @@ void mesh_filter::MeshFilterBase::doFilter(const void* sensor_data, const int en
   glActiveTexture(GL_TEXTURE4);
   glBindTexture(GL_TEXTURE_2D, color_texture);
   glCallList(canvas_);
-  depth_filter_->end();
+  sensor.depth_filter->end();
+}
+
+void mesh_filter::MeshFilterBase::doGetOctreeKeys(const SensorPass& sensor, const Eigen::Isometry3d& sensor_pose,
+                                                  const Eigen::Vector4f& camera, double resolution,
+                                                  unsigned short* keys) const
+{
+  sensor.key_generator->begin();
+  sensor.parameters->setFilterParameters(*sensor.key_generator);
+  glEnable(GL_TEXTURE_2D);
+  glDisable(GL_DEPTH_TEST);
+  glDisable(GL_CULL_FACE);
+  glDisable(GL_ALPHA_TEST);
+  glDisable(GL_BLEND);
+
+  const GLuint program = sensor.key_generator->getProgramID();
+  const Eigen::Matrix4f sensor_matrix = sensor_pose.matrix().cast<float>();
+  glUniformMatrix4fv(glGetUniformLocation(program, "sensor_pose"), 1, GL_FALSE, sensor_matrix.data());
+  glUniform4f(glGetUniformLocation(program, "camera"), camera[0], camera[1], camera[2], camera[3]);
+  glUniform1f(glGetUniformLocation(program, "inv_resolution"), 1.0 / resolution);
+
+  // bind sensor depth
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, sensor.sensor_depth_texture);
+
+  // bind filtered labels
+  glActiveTexture(GL_TEXTURE4);
+  glBindTexture(GL_TEXTURE_2D, sensor.depth_filter->getColorTexture());
+  glCallList(canvas_);
+  sensor.key_generator->end();
+
+  sensor.key_generator->getColorBuffer(keys);
 }
 
 void mesh_filter::MeshFilterBase::setPaddingOffset(float offset)
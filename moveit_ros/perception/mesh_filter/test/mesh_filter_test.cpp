@@ -86,6 +86,8 @@ public:
   MeshFilterTest(unsigned width = 500, unsigned height = 500, double near = 0.5, double far = 5.0, double shadow = 0.1,
                  double epsilon = 1e-7);
   void test();
+  void testBatch();
+  void testOctreeKeys();
   void setMeshDistance(double distance)
   {
     distance_ = distance;
@@ -94,7 +96,7 @@ public:
 private:
   shapes::Mesh createMesh(double z) const;
   bool transformCallback(MeshHandle handle, Isometry3d& transform) const;
-  void getGroundTruth(unsigned int* labels, float* depth) const;
+  void getGroundTruth(const Type* sensor_data, unsigned int* labels, float* depth) const;
   const unsigned int width_;
   const unsigned int height_;
   const double near_;
@@ -219,7 +221,7 @@ void MeshFilterTest<Type>::test()
 
   vector<float> gt_depth(width_ * height_);
   vector<unsigned int> gt_labels(width_ * height_);
-  getGroundTruth(&gt_labels[0], &gt_depth[0]);
+  getGroundTruth(&sensor_data_[0], &gt_labels[0], &gt_depth[0]);
 
   vector<float> filtered_depth(width_ * height_);
   vector<unsigned int> filtered_labels(width_ * height_);
@@ -240,7 +242,89 @@ void MeshFilterTest<Type>::test()
 }
 
 template <typename Type>
-void MeshFilterTest<Type>::getGroundTruth(unsigned int* labels, float* depth) const
+void MeshFilterTest<Type>::testBatch()
+{
+  // the second sensor sees the same scene, but different sensor readings
+  const unsigned int sensor = filter_.addSensor(sensor_parameters_);
+  ASSERT_EQ(sensor, 1u);
+  ASSERT_EQ(filter_.getSensorCount(), 2u);
+  vector<Type> reversed_data(sensor_data_.rbegin(), sensor_data_.rend());
+  filter_.filter({ &sensor_data_[0], &reversed_data[0] }, FilterTraits<Type>::FILTER_GL_TYPE, false);
+
+  const vector<const Type*> sensor_data = { &sensor_data_[0], &reversed_data[0] };
+  for (unsigned int i = 0; i < sensor_data.size(); ++i)
+  {
+    vector<float> gt_depth(width_ * height_);
+    vector<unsigned int> gt_labels(width_ * height_);
+    getGroundTruth(sensor_data[i], &gt_labels[0], &gt_depth[0]);
+
+    vector<float> filtered_depth(width_ * height_);
+    vector<unsigned int> filtered_labels(width_ * height_);
+    filter_.getFilteredDepth(&filtered_depth[0], i);
+    filter_.getFilteredLabels(&filtered_labels[0], i);
+
+    for (unsigned idx = 0; idx < width_ * height_; ++idx)
+    {
+      float sensor_depth = sensor_data[i][idx] * FilterTraits<Type>::ToMetricScale;
+      if (fabs(sensor_depth - distance_ - shadow_) > epsilon_ && fabs(sensor_depth - distance_) > epsilon_)
+      {
+        ASSERT_NEAR(filtered_depth[idx], gt_depth[idx], 1e-4);
+        ASSERT_EQ(filtered_labels[idx], gt_labels[idx]);
+      }
+    }
+  }
+}
+
+template <typename Type>
+void MeshFilterTest<Type>::testOctreeKeys()
+{
+  filter_.filter(&sensor_data_[0], FilterTraits<Type>::FILTER_GL_TYPE, false);
+
+  const double resolution = 0.05;
+  Isometry3d sensor_pose = Isometry3d::Identity();
+  sensor_pose.translation() = Vector3d(1.0, -2.0, 0.5);
+  vector<unsigned short> keys(4 * width_ * height_);
+  // same intrinsics as sensor_parameters_
+  const float fx = width_ >> 1;
+  const float fy = height_ >> 1;
+  const float cx = width_ >> 1;
+  const float cy = height_ >> 1;
+  filter_.getOctreeKeys(sensor_pose, fx, fy, cx, cy, resolution, &keys[0]);
+
+  vector<float> gt_depth(width_ * height_);
+  vector<unsigned int> gt_labels(width_ * height_);
+  getGroundTruth(&sensor_data_[0], &gt_labels[0], &gt_depth[0]);
+
+  for (unsigned y_idx = 0, idx = 0; y_idx < height_; ++y_idx)
+  {
+    for (unsigned x_idx = 0; x_idx < width_; ++x_idx, ++idx)
+    {
+      float sensor_depth = sensor_data_[idx] * FilterTraits<Type>::ToMetricScale;
+      if (fabs(sensor_depth - distance_ - shadow_) <= epsilon_ || fabs(sensor_depth - distance_) <= epsilon_)
+        continue;
+
+      const unsigned short* key = &keys[4 * idx];
+      if (gt_labels[idx] == MeshFilterBase::BACKGROUND)
+        ASSERT_EQ(key[3], MeshFilterBase::OCCUPIED_KEY);
+      else if (gt_labels[idx] >= MeshFilterBase::FAR_CLIP)
+        ASSERT_EQ(key[3], MeshFilterBase::MODEL_KEY);
+      else
+      {
+        ASSERT_EQ(key[3], MeshFilterBase::NO_KEY);
+        continue;
+      }
+
+      // the GPU computes in single precision, so points close to voxel boundaries may be off by one
+      const double z = std::min<double>(sensor_depth, far_);
+      const Vector3d point = sensor_pose * Vector3d((x_idx - cx) / fx * z, (y_idx - cy) / fy * z, z);
+      for (unsigned int i = 0; i < 3; ++i)
+        ASSERT_NEAR(key[i], std::floor(point[i] / resolution) + 32768, 1);
+    }
+  }
+}
+
+template <typename Type>
+void MeshFilterTest<Type>::getGroundTruth(const Type* sensor_data, unsigned int* labels, float* depth) const
 {
   const double scale = FilterTraits<Type>::ToMetricScale;
   if (distance_ <= near_ || distance_ >= far_)
@@ -250,7 +334,7 @@ void MeshFilterTest<Type>::getGroundTruth(unsigned int* labels, float* depth) co
     {
       for (unsigned x_idx = 0; x_idx < width_; ++x_idx, ++idx)
       {
-        depth[idx] = double(sensor_data_[idx]) * scale;
+        depth[idx] = double(sensor_data[idx]) * scale;
         if (depth[idx] < near_)
           labels[idx] = MeshFilterBase::NEAR_CLIP;
         else if (depth[idx] >= far_)
@@ -269,7 +353,7 @@ void MeshFilterTest<Type>::getGroundTruth(unsigned int* labels, float* depth) co
     {
       for (unsigned x_idx = 0; x_idx < width_; ++x_idx, ++idx)
       {
-        depth[idx] = double(sensor_data_[idx]) * scale;
+        depth[idx] = double(sensor_data[idx]) * scale;
 
         if (depth[idx] < near_)
         {
@@ -307,6 +391,16 @@ TEST_P(MeshFilterTestFloat, float)
   this->setMeshDistance(this->GetParam());
   this->test();
 }
+TEST_P(MeshFilterTestFloat, float_batch)
+{
+  this->setMeshDistance(this->GetParam());
+  this->testBatch();
+}
+TEST_P(MeshFilterTestFloat, float_octree_keys)
+{
+  this->setMeshDistance(this->GetParam());
+  this->testOctreeKeys();
+}
 INSTANTIATE_TEST_CASE_P(float_test, MeshFilterTestFloat, ::testing::Range<double>(0.0f, 6.0f, 0.5f));
 
 typedef mesh_filter_test::MeshFilterTest<unsigned short> MeshFilterTestUnsignedShort;
@@ -315,6 +409,11 @@ TEST_P(MeshFilterTestUnsignedShort, unsigned_short)
   this->setMeshDistance(this->GetParam());
   this->test();
 }
+TEST_P(MeshFilterTestUnsignedShort, unsigned_short_batch)
+{
+  this->setMeshDistance(this->GetParam());
+  this->testBatch();
+}
 INSTANTIATE_TEST_CASE_P(ushort_test, MeshFilterTestUnsignedShort, ::testing::Range<double>(0.0f, 6.0f, 0.5f));
 
 int main(int argc, char** argv)
@@ -113,17 +113,34 @@ protected:
     }
   };
 
+  /** \brief Node of the bounding volume hierarchy over the bounding spheres of the bodies */
+  struct SphereNode
+  {
+    bodies::BoundingSphere sphere;
+    double radius_squared;
+    const bodies::Body* body;  // the body of a leaf, nullptr for inner nodes
+    std::size_t right;         // index of the right child of inner nodes, the left child follows its parent
+  };
+
   TransformCallback transform_callback_;
 
-  /** \brief Protects, bodies_ and bspheres_. All public methods acquire this mutex for their whole duration. */
+  /** \brief Protects, bodies_, bspheres_ and sphere_tree_. All public methods acquire this mutex for their whole
+   * duration. */
   mutable std::mutex shapes_lock_;
   std::set<SeeShape, SortBodies> bodies_;
   std::vector<bodies::BoundingSphere> bspheres_;
+  std::vector<SphereNode> sphere_tree_;
 
 private:
   /** \brief Free memory. */
   void freeMemory();
 
+  /** \brief Build the subtree of sphere_tree_ over the leaves in [begin, end) and return the index of its root */
+  std::size_t buildSphereTree(std::vector<SphereNode>& leaves, std::size_t begin, std::size_t end);
+
+  /** \brief Check whether a point is inside one of the bodies, testing only bodies whose sphere contains it */
+  bool containedInSphereTree(const Eigen::Vector3d& pt) const;
+
   ShapeHandle next_handle_;
   ShapeHandle min_handle_;
   std::map<ShapeHandle, std::set<SeeShape, SortBodies>::iterator> used_handles_;
@@ -39,6 +39,10 @@
 #include <sensor_msgs/point_cloud2_iterator.hpp>
 #include <rclcpp/logger.hpp>
 #include <rclcpp/logging.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
 
 static const rclcpp::Logger LOGGER = rclcpp::get_logger("moveit.ros.perception.shape_mask");
 
@@ -115,6 +119,70 @@ void point_containment_filter::ShapeMask::removeShape(ShapeHandle handle)
     RCLCPP_ERROR(LOGGER, "Unable to remove shape handle %u", handle);
 }
 
+std::size_t point_containment_filter::ShapeMask::buildSphereTree(std::vector<SphereNode>& leaves, std::size_t begin,
+                                                                 std::size_t end)
+{
+  const std::size_t index = sphere_tree_.size();
+  if (end - begin == 1)
+  {
+    sphere_tree_.push_back(leaves[begin]);
+    return index;
+  }
+
+  // split at the median along the axis of largest extent of the sphere centers
+  Eigen::Vector3d min = leaves[begin].sphere.center;
+  Eigen::Vector3d max = min;
+  for (std::size_t i = begin + 1; i < end; ++i)
+  {
+    min = min.cwiseMin(leaves[i].sphere.center);
+    max = max.cwiseMax(leaves[i].sphere.center);
+  }
+  Eigen::Index axis;
+  (max - min).maxCoeff(&axis);
+  const std::size_t mid = begin + (end - begin) / 2;
+  std::nth_element(leaves.begin() + begin, leaves.begin() + mid, leaves.begin() + end,
+                   [axis](const SphereNode& a, const SphereNode& b) {
+                     return a.sphere.center[axis] < b.sphere.center[axis];
+                   });
+
+  sphere_tree_.emplace_back();
+  buildSphereTree(leaves, begin, mid);
+  const std::size_t right = buildSphereTree(leaves, mid, end);
+
+  SphereNode& node = sphere_tree_[index];
+  bodies::mergeBoundingSpheres({ sphere_tree_[index + 1].sphere, sphere_tree_[right].sphere }, node.sphere);
+  node.radius_squared = node.sphere.radius * node.sphere.radius;
+  node.body = nullptr;
+  node.right = right;
+  return index;
+}
+
+bool point_containment_filter::ShapeMask::containedInSphereTree(const Eigen::Vector3d& pt) const
+{
+  // the tree is balanced, so its depth is logarithmic in the number of bodies
+  std::size_t stack[64];
+  std::size_t top = 0;
+  stack[top++] = 0;
+  while (top > 0)
+  {
+    const std::size_t index = stack[--top];
+    const SphereNode& node = sphere_tree_[index];
+    if ((node.sphere.center - pt).squaredNorm() > node.radius_squared)
+      continue;
+    if (node.body)
+    {
+      if (node.body->containsPoint(pt))
+        return true;
+    }
+    else
+    {
+      stack[top++] = node.right;
+      stack[top++] = index + 1;
+    }
+  }
+  return false;
+}
+
 void point_containment_filter::ShapeMask::maskContainment(const sensor_msgs::msg::PointCloud2& data_in,
                                                           const Eigen::Vector3d& /*sensor_origin*/,
                                                           const double min_sensor_dist, const double max_sensor_dist,
@@ -130,8 +198,9 @@ void point_containment_filter::ShapeMask::maskContainment(const sensor_msgs::msg
   {
     Eigen::Isometry3d tmp;
     bspheres_.resize(bodies_.size());
+    std::vector<SphereNode> leaves(bodies_.size());
     std::size_t j = 0;
-    for (std::set<SeeShape>::const_iterator it = bodies_.begin(); it != bodies_.end(); ++it)
+    for (std::set<SeeShape>::const_iterator it = bodies_.begin(); it != bodies_.end(); ++it, ++j)
     {
       if (!transform_callback_(it->handle, tmp))
       {
@@ -142,36 +211,53 @@ void point_containment_filter::ShapeMask::maskContainment(const sensor_msgs::msg
                               "Missing transform for shape " << it->body->getType() << " with handle " << it->handle);
       }
       else
-      {
         it->body->setPose(tmp);
-        it->body->computeBoundingSphere(bspheres_[j++]);
-      }
+      // bodies without a transform are still tested at their last pose
+      it->body->computeBoundingSphere(bspheres_[j]);
+      leaves[j].sphere = bspheres_[j];
+      leaves[j].radius_squared = bspheres_[j].radius * bspheres_[j].radius;
+      leaves[j].body = it->body;
     }
 
-    // compute a sphere that bounds the entire robot
-    bodies::BoundingSphere bound;
-    bodies::mergeBoundingSpheres(bspheres_, bound);
-    const double radius_squared = bound.radius * bound.radius;
+    // build a hierarchy of spheres whose root bounds the entire robot
+    sphere_tree_.clear();
+    sphere_tree_.reserve(2 * leaves.size() - 1);
+    buildSphereTree(leaves, 0, leaves.size());
+
+    // read the coordinates straight from the data buffer, which is much faster than the generic cloud iterators
+    int offsets[3] = { -1, -1, -1 };
+    for (const sensor_msgs::msg::PointField& field : data_in.fields)
+    {
+      const int axis = field.name == "x" ? 0 : field.name == "y" ? 1 : field.name == "z" ? 2 : -1;
+      if (axis >= 0 && field.datatype == sensor_msgs::msg::PointField::FLOAT32)
+        offsets[axis] = field.offset;
+    }
+    if (*std::min_element(offsets, offsets + 3) < 0)
+      throw std::runtime_error("Point cloud lacks FLOAT32 x, y and z fields");
+    const bool packed_xyz = offsets[1] == offsets[0] + 4 && offsets[2] == offsets[0] + 8;
 
-    // we now decide which points we keep
-    sensor_msgs::PointCloud2ConstIterator<float> iter_x(data_in, "x");
-    sensor_msgs::PointCloud2ConstIterator<float> iter_y(data_in, "y");
-    sensor_msgs::PointCloud2ConstIterator<float> iter_z(data_in, "z");
+    const double min_sensor_dist_squared = min_sensor_dist * min_sensor_dist;
+    const double max_sensor_dist_squared = max_sensor_dist * max_sensor_dist;
 
-    // Cloud iterators are not incremented in the for loop, because of the pragma
     // Comment out below parallelization as it can result in very high CPU consumption
     //#pragma omp parallel for schedule(dynamic)
     for (int i = 0; i < static_cast<int>(np); ++i)
     {
-      Eigen::Vector3d pt = Eigen::Vector3d(*(iter_x + i), *(iter_y + i), *(iter_z + i));
-      double d = pt.norm();
+      const std::uint8_t* point_data = &data_in.data[static_cast<std::size_t>(i) * data_in.point_step];
+      float xyz[3];
+      if (packed_xyz)
+        std::memcpy(xyz, point_data + offsets[0], sizeof(xyz));
+      else
+        for (int k = 0; k < 3; ++k)
+          std::memcpy(xyz + k, point_data + offsets[k], sizeof(float));
+      const Eigen::Vector3d pt(xyz[0], xyz[1], xyz[2]);
+
+      const double d_squared = pt.squaredNorm();
       int out = OUTSIDE;
-      if (d < min_sensor_dist || d > max_sensor_dist)
+      if (d_squared < min_sensor_dist_squared || d_squared > max_sensor_dist_squared)
         out = CLIP;
-      else if ((bound.center - pt).squaredNorm() < radius_squared)
-        for (std::set<SeeShape>::const_iterator it = bodies_.begin(); it != bodies_.end() && out == OUTSIDE; ++it)
-          if (it->body->containsPoint(pt))
-            out = INSIDE;
+      else if (containedInSphereTree(pt))
+        out = INSIDE;
       mask[i] = out;
     }
   }
@@ -45,6 +45,7 @@
 #include <moveit/point_containment_filter/shape_mask.h>
 
 #include <memory>
+#include <vector>
 
 namespace occupancy_map_monitor
 {
@@ -69,6 +70,10 @@ protected:
 private:
   bool getShapeTransform(ShapeHandle h, Eigen::Isometry3d& transform) const;
   void cloudMsgCallback(const sensor_msgs::msg::PointCloud2::ConstSharedPtr& cloud_msg);
+
+  /* cast the rays to all end cells on ray_casting_threads_ threads and add the traversed cells to free_cells */
+  void castRaysParallel(const octomap::point3d& sensor_origin, const std::vector<octomap::OcTreeKey>& end_cells,
+                        octomap::KeySet& free_cells);
   void stopHelper();
 
   // TODO: Enable private node for publishing filtered point cloud
@@ -88,6 +93,7 @@ private:
   double padding_;
   double max_range_;
   unsigned int point_subsample_;
+  unsigned int ray_casting_threads_;
   double max_update_rate_;
   std::string filtered_cloud_topic_;
   std::string ns_;
@@ -99,6 +105,7 @@ private:
   /* used to store all cells in the map which a given ray passes through during raycasting.
      we cache this here because it dynamically pre-allocates a lot of memory in its contsructor */
   octomap::KeyRay key_ray_;
+  std::vector<octomap::KeyRay> thread_key_rays_;
 
   std::unique_ptr<point_containment_filter::ShapeMask> shape_mask_;
   std::vector<int> mask_;
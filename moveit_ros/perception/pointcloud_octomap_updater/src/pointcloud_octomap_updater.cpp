@@ -42,12 +42,19 @@
 #else
 #include <tf2_geometry_msgs/tf2_geometry_msgs.h>
 #endif
+#if __has_include(<tf2_eigen/tf2_eigen.hpp>)
+#include <tf2_eigen/tf2_eigen.hpp>
+#else
+#include <tf2_eigen/tf2_eigen.h>
+#endif
 #include <tf2/LinearMath/Vector3.h>
 #include <tf2/LinearMath/Transform.h>
 #include <sensor_msgs/point_cloud2_iterator.hpp>
 #include <tf2_ros/create_timer_interface.h>
 #include <tf2_ros/create_timer_ros.h>
 
+#include <algorithm>
+#include <chrono>
 #include <memory>
 
 namespace occupancy_map_monitor
@@ -59,6 +66,7 @@ PointCloudOctomapUpdater::PointCloudOctomapUpdater()
   , padding_(0.0)
   , max_range_(std::numeric_limits<double>::infinity())
   , point_subsample_(1)
+  , ray_casting_threads_(1)
   , max_update_rate_(0)
   , point_cloud_subscriber_(nullptr)
   , point_cloud_filter_(nullptr)
@@ -74,6 +82,7 @@ bool PointCloudOctomapUpdater::setParams(const std::string& name_space)
 {
   // This parameter is optional
   node_->get_parameter_or(name_space + ".ns", ns_, std::string());
+  node_->get_parameter_or(name_space + ".ray_casting_threads", ray_casting_threads_, 1u);
   return node_->get_parameter(name_space + ".point_cloud_topic", point_cloud_topic_) &&
          node_->get_parameter(name_space + ".max_range", max_range_) &&
          node_->get_parameter(name_space + ".padding_offset", padding_) &&
@@ -112,7 +121,12 @@ void PointCloudOctomapUpdater::start()
     return;
   /* subscribe to point cloud topic using tf filter*/
   point_cloud_subscriber_ = new message_filters::Subscriber<sensor_msgs::msg::PointCloud2>(node_, point_cloud_topic_);
-  if (tf_listener_ && tf_buffer_ && !monitor_->getMapFrame().empty())
+  // clouds need not wait for tf2 if the sensor pose can be taken from the link poses cached from joint states
+  const LinkTransformCacheConstPtr& link_transform_cache = monitor_->getLinkTransformCache();
+  const bool use_link_transform_cache = link_transform_cache &&
+                                        (link_transform_cache->getReferenceFrame() == monitor_->getMapFrame() ||
+                                         link_transform_cache->getFrameIndex(monitor_->getMapFrame()) >= 0);
+  if (tf_listener_ && tf_buffer_ && !monitor_->getMapFrame().empty() && !use_link_transform_cache)
   {
     point_cloud_filter_ = new tf2_ros::MessageFilter<sensor_msgs::msg::PointCloud2>(
         *point_cloud_subscriber_, *tf_buffer_, monitor_->getMapFrame(), 5, node_);
@@ -125,7 +139,8 @@ void PointCloudOctomapUpdater::start()
   {
     point_cloud_subscriber_->registerCallback(
         [this](const sensor_msgs::msg::PointCloud2::ConstSharedPtr& cloud) { cloudMsgCallback(cloud); });
-    RCLCPP_INFO(LOGGER, "Listening to '%s'", point_cloud_topic_.c_str());
+    RCLCPP_INFO(LOGGER, "Listening to '%s'%s", point_cloud_topic_.c_str(),
+                use_link_transform_cache ? " using cached link transforms" : "");
   }
 }
 
@@ -173,10 +188,36 @@ void PointCloudOctomapUpdater::updateMask(const sensor_msgs::msg::PointCloud2& /
 {
 }
 
+void PointCloudOctomapUpdater::castRaysParallel(const octomap::point3d& sensor_origin,
+                                                const std::vector<octomap::OcTreeKey>& end_cells,
+                                                octomap::KeySet& free_cells)
+{
+  // KeyRay pre-allocates a lot of memory, so one is kept per thread
+  const int thread_count = ray_casting_threads_;
+  thread_key_rays_.resize(thread_count);
+  std::vector<octomap::KeySet> thread_free_cells(thread_count);
+  const std::size_t slice = (end_cells.size() + thread_count - 1) / thread_count;
+
+#pragma omp parallel for num_threads(thread_count) schedule(static, 1)
+  for (int t = 0; t < thread_count; ++t)
+  {
+    octomap::KeyRay& key_ray = thread_key_rays_[t];
+    const std::size_t end = std::min(end_cells.size(), (t + 1) * slice);
+    for (std::size_t i = t * slice; i < end; ++i)
+      if (tree_->computeRayKeys(sensor_origin, tree_->keyToCoord(end_cells[i]), key_ray))
+        thread_free_cells[t].insert(key_ray.begin(), key_ray.end());
+  }
+
+  for (const octomap::KeySet& cells : thread_free_cells)
+    free_cells.insert(cells.begin(), cells.end());
+}
+
 void PointCloudOctomapUpdater::cloudMsgCallback(const sensor_msgs::msg::PointCloud2::ConstSharedPtr& cloud_msg)
 {
   RCLCPP_DEBUG(LOGGER, "Received a new point cloud message");
   rclcpp::Time start = rclcpp::Clock(RCL_ROS_TIME).now();
+  using Clock = std::chrono::steady_clock;
+  auto to_ms = [](Clock::duration d) { return std::chrono::duration<double, std::milli>(d).count(); };
 
   if (max_update_rate_ > 0)
   {
@@ -191,8 +232,12 @@ void PointCloudOctomapUpdater::cloudMsgCallback(const sensor_msgs::msg::PointClo
 
   /* get transform for cloud into map frame */
   tf2::Stamped<tf2::Transform> map_h_sensor;
+  Eigen::Isometry3d map_t_sensor;
   if (monitor_->getMapFrame() == cloud_msg->header.frame_id)
     map_h_sensor.setIdentity();
+  else if (lookupCachedTransform(monitor_->getMapFrame(), cloud_msg->header.frame_id, cloud_msg->header.stamp,
+                                 map_t_sensor))
+    tf2::fromMsg(tf2::eigenToTransform(map_t_sensor).transform, map_h_sensor);
   else
   {
     if (tf_buffer_)
@@ -222,6 +267,7 @@ void PointCloudOctomapUpdater::cloudMsgCallback(const sensor_msgs::msg::PointClo
     return;
 
   /* mask out points on the robot */
+  const Clock::time_point mask_start = Clock::now();
   shape_mask_->maskContainment(*cloud_msg, sensor_origin_eigen, 0.0, max_range_, mask_);
   updateMask(*cloud_msg, sensor_origin_eigen, mask_);
 
@@ -250,6 +296,8 @@ void PointCloudOctomapUpdater::cloudMsgCallback(const sensor_msgs::msg::PointClo
   }
   size_t filtered_cloud_size = 0;
 
+  const Clock::time_point end_points_start = Clock::now();
+  Clock::time_point ray_casting_start;
   tree_->lockRead();
 
   try
@@ -306,20 +354,33 @@ void PointCloudOctomapUpdater::cloudMsgCallback(const sensor_msgs::msg::PointClo
       }
     }
 
-    /* compute the free cells along each ray that ends at an occupied cell */
-    for (const octomap::OcTreeKey& occupied_cell : occupied_cells)
-      if (tree_->computeRayKeys(sensor_origin, tree_->keyToCoord(occupied_cell), key_ray_))
-        free_cells.insert(key_ray_.begin(), key_ray_.end());
-
-    /* compute the free cells along each ray that ends at a model cell */
-    for (const octomap::OcTreeKey& model_cell : model_cells)
-      if (tree_->computeRayKeys(sensor_origin, tree_->keyToCoord(model_cell), key_ray_))
-        free_cells.insert(key_ray_.begin(), key_ray_.end());
-
-    /* compute the free cells along each ray that ends at a clipped cell */
-    for (const octomap::OcTreeKey& clip_cell : clip_cells)
-      if (tree_->computeRayKeys(sensor_origin, tree_->keyToCoord(clip_cell), key_ray_))
-        free_cells.insert(key_ray_.begin(), key_ray_.end());
+    ray_casting_start = Clock::now();
+    if (ray_casting_threads_ > 1)
+    {
+      std::vector<octomap::OcTreeKey> end_cells;
+      end_cells.reserve(occupied_cells.size() + model_cells.size() + clip_cells.size());
+      end_cells.insert(end_cells.end(), occupied_cells.begin(), occupied_cells.end());
+      end_cells.insert(end_cells.end(), model_cells.begin(), model_cells.end());
+      end_cells.insert(end_cells.end(), clip_cells.begin(), clip_cells.end());
+      castRaysParallel(sensor_origin, end_cells, free_cells);
+    }
+    else
+    {
+      /* compute the free cells along each ray that ends at an occupied cell */
+      for (const octomap::OcTreeKey& occupied_cell : occupied_cells)
+        if (tree_->computeRayKeys(sensor_origin, tree_->keyToCoord(occupied_cell), key_ray_))
+          free_cells.insert(key_ray_.begin(), key_ray_.end());
+
+      /* compute the free cells along each ray that ends at a model cell */
+      for (const octomap::OcTreeKey& model_cell : model_cells)
+        if (tree_->computeRayKeys(sensor_origin, tree_->keyToCoord(model_cell), key_ray_))
+          free_cells.insert(key_ray_.begin(), key_ray_.end());
+
+      /* compute the free cells along each ray that ends at a clipped cell */
+      for (const octomap::OcTreeKey& clip_cell : clip_cells)
+        if (tree_->computeRayKeys(sensor_origin, tree_->keyToCoord(clip_cell), key_ray_))
+          free_cells.insert(key_ray_.begin(), key_ray_.end());
+    }
   }
   catch (...)
   {
@@ -328,6 +389,7 @@ void PointCloudOctomapUpdater::cloudMsgCallback(const sensor_msgs::msg::PointClo
   }
 
   tree_->unlockRead();
+  const Clock::time_point update_start = Clock::now();
 
   /* cells that overlap with the model are not occupied */
   for (const octomap::OcTreeKey& model_cell : model_cells)
@@ -359,7 +421,13 @@ void PointCloudOctomapUpdater::cloudMsgCallback(const sensor_msgs::msg::PointClo
     RCLCPP_ERROR(LOGGER, "Internal error while updating octree");
   }
   tree_->unlockWrite();
-  RCLCPP_DEBUG(LOGGER, "Processed point cloud in %lf ms", (node_->now() - start).seconds() * 1000.0);
+  const Clock::time_point update_end = Clock::now();
+  RCLCPP_DEBUG(LOGGER,
+               "Processed point cloud in %lf ms (mask: %.3f ms, end points: %.3f ms, ray casting: %.3f ms, "
+               "octree update of %zu free cells: %.3f ms)",
+               (node_->now() - start).seconds() * 1000.0, to_ms(end_points_start - mask_start),
+               to_ms(ray_casting_start - end_points_start), to_ms(update_start - ray_casting_start), free_cells.size(),
+               to_ms(update_end - update_start));
   tree_->triggerUpdateCallback();
 
   if (filtered_cloud)
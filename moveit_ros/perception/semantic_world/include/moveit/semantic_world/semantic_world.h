@@ -41,6 +41,7 @@
 #include <moveit/planning_scene/planning_scene.h>
 #include <object_recognition_msgs/msg/table_array.hpp>
 #include <moveit_msgs/msg/collision_object.hpp>
+#include <memory>
 #include <mutex>
 
 namespace shapes
@@ -132,6 +133,18 @@ public:
                             double min_distance_from_edge = 0.0, double min_vertical_offset = 0.0) const;
 
 private:
+  /** @brief The contour of a table prepared for containment tests, see computeTableContour() */
+  struct TableContour;
+
+  /** @brief Rasterize the convex hull of \e table and extract its contour; nullptr if the table has no contour */
+  static std::shared_ptr<const TableContour> computeTableContour(const object_recognition_msgs::msg::Table& table);
+
+  /** @brief The cached contour of \e table if it is one of the current tables, a freshly computed one otherwise */
+  std::shared_ptr<const TableContour> getTableContour(const object_recognition_msgs::msg::Table& table) const;
+
+  bool isInsideTableContour(const geometry_msgs::msg::Pose& pose, const TableContour& contour,
+                            double min_distance_from_edge, double min_vertical_offset) const;
+
   shapes::Mesh* createSolidMeshFromPlanarPolygon(const shapes::Mesh& polygon, double thickness) const;
 
   shapes::Mesh* orientPlanarPolygon(const shapes::Mesh& polygon) const;
@@ -150,6 +163,9 @@ private:
 
   std::map<std::string, object_recognition_msgs::msg::Table> current_tables_in_collision_world_;
 
+  /** @brief The contours of current_tables_in_collision_world_, computed once per table message */
+  std::map<std::string, std::shared_ptr<const TableContour>> table_contours_;
+
   rclcpp::Subscription<object_recognition_msgs::msg::TableArray>::SharedPtr table_subscriber_;
 
   rclcpp::Publisher<visualization_msgs::msg::MarkerArray>::SharedPtr visualization_publisher_;
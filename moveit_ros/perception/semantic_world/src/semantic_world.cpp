@@ -41,6 +41,7 @@
 #include <geometric_shapes/shape_operations.h>
 #include <moveit_msgs/msg/planning_scene.hpp>
 // OpenCV
+#include <opencv2/core/utility.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
 #include <rclcpp/experimental/buffers/intra_process_buffer.hpp>
 #include <rclcpp/logger.hpp>
@@ -64,6 +65,25 @@ namespace semantic_world
 {
 static const rclcpp::Logger LOGGER = rclcpp::get_logger("moveit.ros.perception.semantic_world");
 
+// Table contours are rasterized with this many pixels per meter
+static const int SCALE_FACTOR = 100;
+
+struct SemanticWorld::TableContour
+{
+  object_recognition_msgs::msg::Table table;
+
+  // The contour in pixels, relative to (x_min, y_min) in the table frame
+  std::vector<cv::Point> contour;
+  float x_min, y_min;
+  double x_range, y_range;
+
+  Eigen::Isometry3d pose;
+  Eigen::Isometry3d pose_inverse;
+
+  // Bounds of the convex hull in the x-y plane of the planning frame, to skip tables without testing the contour
+  Eigen::AlignedBox2d bounds;
+};
+
 SemanticWorld::SemanticWorld(const rclcpp::Node::SharedPtr node,
                              const planning_scene::PlanningSceneConstPtr& planning_scene)
   : planning_scene_(planning_scene), node_handle_(node)
@@ -126,6 +146,7 @@ bool SemanticWorld::addTablesToCollisionWorld()
   planning_scene_diff_publisher_->publish(planning_scene);
   planning_scene.world.collision_objects.clear();
   current_tables_in_collision_world_.clear();
+  table_contours_.clear();
   // Add the new tables
   for (std::size_t i = 0; i < table_array_.tables.size(); ++i)
   {
@@ -134,6 +155,7 @@ bool SemanticWorld::addTablesToCollisionWorld()
     ss << "table_" << i;
     co.id = ss.str();
     current_tables_in_collision_world_[co.id] = table_array_.tables[i];
+    table_contours_[co.id] = computeTableContour(table_array_.tables[i]);
     co.operation = moveit_msgs::msg::CollisionObject::ADD;
 
     const std::vector<geometry_msgs::msg::Point>& convex_hull = table_array_.tables[i].convex_hull;
@@ -222,6 +244,7 @@ void SemanticWorld::clear()
 {
   table_array_.tables.clear();
   current_tables_in_collision_world_.clear();
+  table_contours_.clear();
 }
 
 std::vector<geometry_msgs::msg::PoseStamped>
@@ -320,17 +343,12 @@ SemanticWorld::generatePlacePoses(const object_recognition_msgs::msg::Table& cho
                             min_distance_from_edge);
 }
 
-std::vector<geometry_msgs::msg::PoseStamped>
-SemanticWorld::generatePlacePoses(const object_recognition_msgs::msg::Table& table, double resolution,
-                                  double height_above_table, double delta_height, unsigned int num_heights,
-                                  double min_distance_from_edge) const
+std::shared_ptr<const SemanticWorld::TableContour>
+SemanticWorld::computeTableContour(const object_recognition_msgs::msg::Table& table)
 {
-  std::vector<geometry_msgs::msg::PoseStamped> place_poses;
   // Assumption that the table's normal is along the Z axis
   if (table.convex_hull.empty())
-    return place_poses;
-  const int scale_factor = 100;
-  std::vector<cv::Point2f> table_contour;
+    return nullptr;
   float x_min = table.convex_hull[0].x, x_max = x_min, y_min = table.convex_hull[0].y, y_max = y_min;
   for (std::size_t j = 1; j < table.convex_hull.size(); ++j)
   {
@@ -343,8 +361,9 @@ SemanticWorld::generatePlacePoses(const object_recognition_msgs::msg::Table& tab
     else if (table.convex_hull[j].y > y_max)
       y_max = table.convex_hull[j].y;
   }
+  std::vector<cv::Point2f> table_contour;
   for (const geometry_msgs::msg::Point& vertex : table.convex_hull)
-    table_contour.push_back(cv::Point((vertex.x - x_min) * scale_factor, (vertex.y - y_min) * scale_factor));
+    table_contour.push_back(cv::Point((vertex.x - x_min) * SCALE_FACTOR, (vertex.y - y_min) * SCALE_FACTOR));
 
   double x_range = fabs(x_max - x_min);
   double y_range = fabs(y_max - y_min);
@@ -353,50 +372,92 @@ SemanticWorld::generatePlacePoses(const object_recognition_msgs::msg::Table& tab
     max_range = static_cast<int>(y_range) + 1;
 
   int image_scale = std::max<int>(max_range, 4);
-  cv::Mat src = cv::Mat::zeros(image_scale * scale_factor, image_scale * scale_factor, CV_8UC1);
+  cv::Mat src = cv::Mat::zeros(image_scale * SCALE_FACTOR, image_scale * SCALE_FACTOR, CV_8UC1);
 
   for (std::size_t j = 0; j < table.convex_hull.size(); ++j)
   {
     cv::line(src, table_contour[j], table_contour[(j + 1) % table.convex_hull.size()], cv::Scalar(255), 3, 8);
   }
 
-  unsigned int num_x = fabs(x_max - x_min) / resolution + 1;
-  unsigned int num_y = fabs(y_max - y_min) / resolution + 1;
-
-  RCLCPP_DEBUG(LOGGER, "Num points for possible place operations: %d %d", num_x, num_y);
-
   std::vector<std::vector<cv::Point> > contours;
   std::vector<cv::Vec4i> hierarchy;
   cv::findContours(src, contours, hierarchy, cv::RETR_TREE, cv::CHAIN_APPROX_SIMPLE);
+  if (contours.empty())
+    return nullptr;
+
+  auto result = std::make_shared<TableContour>();
+  result->table = table;
+  result->contour = std::move(contours[0]);
+  result->x_min = x_min;
+  result->y_min = y_min;
+  result->x_range = x_range;
+  result->y_range = y_range;
+  tf2::fromMsg(table.pose, result->pose);
+  result->pose_inverse = result->pose.inverse();
+  for (const geometry_msgs::msg::Point& vertex : table.convex_hull)
+    result->bounds.extend((result->pose * Eigen::Vector3d(vertex.x, vertex.y, vertex.z)).head<2>());
+  return result;
+}
 
-  for (std::size_t j = 0; j < num_x; ++j)
+std::shared_ptr<const SemanticWorld::TableContour>
+SemanticWorld::getTableContour(const object_recognition_msgs::msg::Table& table) const
+{
+  for (const auto& [name, contour] : table_contours_)
   {
-    int point_x = j * resolution * scale_factor;
-    for (std::size_t k = 0; k < num_y; ++k)
+    if (contour && contour->table == table)
+      return contour;
+  }
+  return computeTableContour(table);
+}
+
+std::vector<geometry_msgs::msg::PoseStamped>
+SemanticWorld::generatePlacePoses(const object_recognition_msgs::msg::Table& table, double resolution,
+                                  double height_above_table, double delta_height, unsigned int num_heights,
+                                  double min_distance_from_edge) const
+{
+  std::vector<geometry_msgs::msg::PoseStamped> place_poses;
+  std::shared_ptr<const TableContour> table_contour = getTableContour(table);
+  if (!table_contour)
+    return place_poses;
+
+  unsigned int num_x = table_contour->x_range / resolution + 1;
+  unsigned int num_y = table_contour->y_range / resolution + 1;
+
+  RCLCPP_DEBUG(LOGGER, "Num points for possible place operations: %d %d", num_x, num_y);
+
+  // The grid columns are tested in parallel and concatenated in order, so the poses come out as if sampled serially
+  std::vector<std::vector<geometry_msgs::msg::PoseStamped> > columns(num_x);
+  cv::parallel_for_(cv::Range(0, num_x), [&](const cv::Range& range) {
+    for (int j = range.start; j < range.end; ++j)
     {
-      for (std::size_t mm = 0; mm < num_heights; ++mm)
+      int point_x = j * resolution * SCALE_FACTOR;
+      for (std::size_t k = 0; k < num_y; ++k)
       {
-        int point_y = k * resolution * scale_factor;
+        int point_y = k * resolution * SCALE_FACTOR;
         cv::Point2f point2f(point_x, point_y);
-        double result = cv::pointPolygonTest(contours[0], point2f, true);
-        if (static_cast<int>(result) >= static_cast<int>(min_distance_from_edge * scale_factor))
+        double result = cv::pointPolygonTest(table_contour->contour, point2f, true);
+        if (static_cast<int>(result) < static_cast<int>(min_distance_from_edge * SCALE_FACTOR))
+          continue;
+        for (std::size_t mm = 0; mm < num_heights; ++mm)
         {
-          Eigen::Vector3d point((double)(point_x) / scale_factor + x_min, (double)(point_y) / scale_factor + y_min,
+          Eigen::Vector3d point((double)(point_x) / SCALE_FACTOR + table_contour->x_min,
+                                (double)(point_y) / SCALE_FACTOR + table_contour->y_min,
                                 height_above_table + mm * delta_height);
-          Eigen::Isometry3d pose;
-          tf2::fromMsg(table.pose, pose);
-          point = pose * point;
+          point = table_contour->pose * point;
           geometry_msgs::msg::PoseStamped place_pose;
           place_pose.pose.orientation.w = 1.0;
           place_pose.pose.position.x = point.x();
           place_pose.pose.position.y = point.y();
           place_pose.pose.position.z = point.z();
           place_pose.header = table.header;
-          place_poses.push_back(place_pose);
+          columns[j].push_back(place_pose);
         }
       }
     }
-  }
+  });
+
+  for (const std::vector<geometry_msgs::msg::PoseStamped>& column : columns)
+    place_poses.insert(place_poses.end(), column.begin(), column.end());
   return place_poses;
 }
 
@@ -404,50 +465,17 @@ bool SemanticWorld::isInsideTableContour(const geometry_msgs::msg::Pose& pose,
                                          const object_recognition_msgs::msg::Table& table,
                                          double min_distance_from_edge, double min_vertical_offset) const
 {
-  // Assumption that the table's normal is along the Z axis
-  if (table.convex_hull.empty())
-    return false;
-  float x_min = table.convex_hull[0].x, x_max = x_min, y_min = table.convex_hull[0].y, y_max = y_min;
-  for (std::size_t j = 1; j < table.convex_hull.size(); ++j)
-  {
-    if (table.convex_hull[j].x < x_min)
-      x_min = table.convex_hull[j].x;
-    else if (table.convex_hull[j].x > x_max)
-      x_max = table.convex_hull[j].x;
-    if (table.convex_hull[j].y < y_min)
-      y_min = table.convex_hull[j].y;
-    else if (table.convex_hull[j].y > y_max)
-      y_max = table.convex_hull[j].y;
-  }
-  const int scale_factor = 100;
-  std::vector<cv::Point2f> table_contour;
-  for (const geometry_msgs::msg::Point& vertex : table.convex_hull)
-    table_contour.push_back(cv::Point((vertex.x - x_min) * scale_factor, (vertex.y - y_min) * scale_factor));
-
-  double x_range = fabs(x_max - x_min);
-  double y_range = fabs(y_max - y_min);
-  int max_range = static_cast<int>(x_range) + 1;
-  if (max_range < static_cast<int>(y_range) + 1)
-    max_range = static_cast<int>(y_range) + 1;
-
-  int image_scale = std::max<int>(max_range, 4);
-  cv::Mat src = cv::Mat::zeros(image_scale * scale_factor, image_scale * scale_factor, CV_8UC1);
-
-  for (std::size_t j = 0; j < table.convex_hull.size(); ++j)
-  {
-    cv::line(src, table_contour[j], table_contour[(j + 1) % table.convex_hull.size()], cv::Scalar(255), 3, 8);
-  }
-
-  std::vector<std::vector<cv::Point> > contours;
-  std::vector<cv::Vec4i> hierarchy;
-  cv::findContours(src, contours, hierarchy, cv::RETR_TREE, cv::CHAIN_APPROX_SIMPLE);
+  std::shared_ptr<const TableContour> table_contour = getTableContour(table);
+  return table_contour && isInsideTableContour(pose, *table_contour, min_distance_from_edge, min_vertical_offset);
+}
 
+bool SemanticWorld::isInsideTableContour(const geometry_msgs::msg::Pose& pose, const TableContour& table_contour,
+                                         double min_distance_from_edge, double min_vertical_offset) const
+{
   Eigen::Vector3d point(pose.position.x, pose.position.y, pose.position.z);
-  Eigen::Isometry3d pose_table;
-  tf2::fromMsg(table.pose, pose_table);
 
   // Point in table frame
-  point = pose_table.inverse() * point;
+  point = table_contour.pose_inverse * point;
   // Assuming Z axis points upwards for the table
   if (point.z() < -fabs(min_vertical_offset))
   {
@@ -455,24 +483,28 @@ bool SemanticWorld::isInsideTableContour(const geometry_msgs::msg::Pose& pose,
     return false;
   }
 
-  int point_x = (point.x() - x_min) * scale_factor;
-  int point_y = (point.y() - y_min) * scale_factor;
+  int point_x = (point.x() - table_contour.x_min) * SCALE_FACTOR;
+  int point_y = (point.y() - table_contour.y_min) * SCALE_FACTOR;
   cv::Point2f point2f(point_x, point_y);
-  double result = cv::pointPolygonTest(contours[0], point2f, true);
+  double result = cv::pointPolygonTest(table_contour.contour, point2f, true);
   RCLCPP_DEBUG(LOGGER, "table distance: %f", result);
 
-  return static_cast<int>(result) >= static_cast<int>(min_distance_from_edge * scale_factor);
+  return static_cast<int>(result) >= static_cast<int>(min_distance_from_edge * SCALE_FACTOR);
 }
 
 std::string SemanticWorld::findObjectTable(const geometry_msgs::msg::Pose& pose, double min_distance_from_edge,
                                            double min_vertical_offset) const
 {
-  std::map<std::string, object_recognition_msgs::msg::Table>::const_iterator it;
-  for (it = current_tables_in_collision_world_.begin(); it != current_tables_in_collision_world_.end(); ++it)
+  // a pose outside the bounds of a table's hull is outside its contour too, unless it may be off the edge
+  const Eigen::Vector2d position(pose.position.x, pose.position.y);
+  const double margin = std::max(0.0, -min_distance_from_edge);
+  for (const auto& [name, table_contour] : table_contours_)
   {
-    RCLCPP_DEBUG_STREAM(LOGGER, "Testing table: " << it->first);
-    if (isInsideTableContour(pose, it->second, min_distance_from_edge, min_vertical_offset))
-      return it->first;
+    if (!table_contour || table_contour->bounds.exteriorDistance(position) > margin)
+      continue;
+    RCLCPP_DEBUG_STREAM(LOGGER, "Testing table: " << name);
+    if (isInsideTableContour(pose, *table_contour, min_distance_from_edge, min_vertical_offset))
+      return name;
   }
   return std::string();
 }
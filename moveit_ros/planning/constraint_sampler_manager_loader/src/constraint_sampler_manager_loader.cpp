@@ -51,6 +51,16 @@ class ConstraintSamplerManagerLoader::Helper
 public:
   Helper(const rclcpp::Node::SharedPtr& node, const constraint_samplers::ConstraintSamplerManagerPtr& csm) : node_(node)
   {
+    // keep valid samples of recently used constraints, so repeated goals are sampled instantly
+    const int reservoir_size = node_->get_parameter_or("constraint_sample_reservoir_size", 0);
+    if (reservoir_size > 0)
+    {
+      const int max_reservoirs = node_->get_parameter_or("constraint_sample_reservoirs", 16);
+      csm->enableSampleReservoirs(reservoir_size, std::max(max_reservoirs, 1));
+      RCLCPP_INFO(LOGGER, "Keeping up to %d valid samples for each of %d constraint sets", reservoir_size,
+                  std::max(max_reservoirs, 1));
+    }
+
     if (node_->has_parameter("constraint_samplers"))
     {
       std::string constraint_samplers;
@@ -98,6 +98,12 @@ public:
     return ik_timeout_;
   }
 
+  /** \brief Get a map from group name to whether every thread should use its own solver instance of the group */
+  const std::map<std::string, bool>& getPerThreadInstances() const
+  {
+    return per_thread_instances_;
+  }
+
   void status() const;
 
 private:
@@ -110,6 +116,7 @@ private:
 
   std::vector<std::string> groups_;
   std::map<std::string, double> ik_timeout_;
+  std::map<std::string, bool> per_thread_instances_;
 
   // default configuration
   std::string default_solver_plugin_;
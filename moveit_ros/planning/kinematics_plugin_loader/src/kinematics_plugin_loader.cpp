@@ -175,13 +175,16 @@ public:
                                   links.front()->getParentJointModel()->getParentLinkModel()->getName() :
                                   jmg->getParentModel().getModelFrame();
 
-    // just to be sure, do not call the same pluginlib instance allocation function in parallel
-    std::scoped_lock slock(lock_);
     for (std::size_t i = 0; !result && i < it->second.size(); ++i)
     {
       try
       {
-        result = kinematics_loader_->createUniqueInstance(it->second[i]);
+        {
+          // just to be sure, do not call the same pluginlib instance allocation function in parallel,
+          // the initialization of the instances is independent and may run concurrently for different groups
+          std::scoped_lock slock(lock_);
+          result = kinematics_loader_->createUniqueInstance(it->second[i]);
+        }
         if (result)
         {
           // choose the tip of the IK solver
@@ -226,14 +229,18 @@ public:
   // second call in JointModelGroup::setSolverAllocators() is to actually retrieve the instance for use
   kinematics::KinematicsBasePtr allocKinematicsSolverWithCache(const moveit::core::JointModelGroup* jmg)
   {
-    std::scoped_lock slock(cache_lock_);
-    kinematics::KinematicsBasePtr& cached = instances_[jmg];
-    if (cached.unique())
-      return std::move(cached);  // pass on unique instance
+    {
+      std::scoped_lock slock(cache_lock_);
+      kinematics::KinematicsBasePtr& cached = instances_[jmg];
+      if (cached.unique())
+        return std::move(cached);  // pass on unique instance
+    }
 
-    // create a new instance and store in instances_
-    cached = allocKinematicsSolver(jmg);
-    return cached;
+    // create a new instance and store in instances_, without holding the lock so that groups allocate concurrently
+    kinematics::KinematicsBasePtr result = allocKinematicsSolver(jmg);
+    std::scoped_lock slock(cache_lock_);
+    instances_[jmg] = result;
+    return result;
   }
 
   void status() const
@@ -354,6 +361,13 @@ moveit::core::SolverAllocatorFn KinematicsPluginLoader::getLoaderFunction(const
             }
           }
 
+          // kinematics solvers are generally not thread-safe, so concurrent planners may need one per thread
+          std::string ksolver_per_thread_param_name = base_param_name + ".kinematics_solver_per_thread_instances";
+          rclcpp::Parameter ksolver_per_thread_param =
+              declare_parameter<rclcpp::ParameterType::PARAMETER_BOOL>(node_, ksolver_per_thread_param_name);
+          if (ksolver_per_thread_param.get_type() == rclcpp::ParameterType::PARAMETER_BOOL)
+            per_thread_instances_[known_group.name_] = ksolver_per_thread_param.as_bool();
+
           std::string ksolver_res_param_name = base_param_name + ".kinematics_solver_search_resolution";
           rclcpp::Parameter ksolver_res_param =
               declare_parameter<rclcpp::ParameterType::PARAMETER_DOUBLE>(node_, ksolver_res_param_name);
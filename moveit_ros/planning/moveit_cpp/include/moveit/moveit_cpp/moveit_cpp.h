@@ -160,6 +160,12 @@ public:
   const planning_scene_monitor::PlanningSceneMonitorPtr& getPlanningSceneMonitor() const;
   planning_scene_monitor::PlanningSceneMonitorPtr getPlanningSceneMonitorNonConst();
 
+  /** \brief Get an immutable snapshot of the monitored planning scene for planning in the same process.
+      If the planning scene monitor uses scene snapshots (parameter use_scene_snapshots), the snapshot is shared with
+      all other readers instead of being copied, and the octomap shared with the monitored scene stays locked for
+      reading as long as the returned pointer is referenced. Otherwise, a copy of the monitored scene is returned. */
+  planning_scene::PlanningSceneConstPtr getPlanningSceneSnapshot() const;
+
   const std::shared_ptr<tf2_ros::Buffer>& getTFBuffer() const;
 
   /** \brief Get the stored instance of the trajectory execution manager */
@@ -44,6 +44,8 @@
 #include <moveit/robot_state/conversions.h>
 #include <moveit/utils/moveit_error_code.h>
 
+#include <functional>
+
 namespace moveit_cpp
 {
 MOVEIT_CLASS_FORWARD(PlanningComponent);  // Defines PlanningComponentPtr, ConstPtr, WeakPtr... etc
@@ -83,9 +85,9 @@ public:
     double max_velocity_scaling_factor;
     double max_acceleration_scaling_factor;
 
-    void load(const rclcpp::Node::SharedPtr& node)
+    void load(const rclcpp::Node::SharedPtr& node, const std::string& param_namespace = "plan_request_params")
     {
-      std::string ns = "plan_request_params.";
+      std::string ns = param_namespace + ".";
       node->get_parameter_or(ns + "planner_id", planner_id, std::string(""));
       node->get_parameter_or(ns + "planning_pipeline", planning_pipeline, std::string(""));
       node->get_parameter_or(ns + "planning_time", planning_time, 1.0);
@@ -95,6 +97,40 @@ public:
     }
   };
 
+  /// Planner parameters for several planning pipelines that plan concurrently
+  struct MultiPipelinePlanRequestParameters
+  {
+    MultiPipelinePlanRequestParameters() = default;
+
+    /// Load the PlanRequestParameters of each entry from the parameter namespace of the same name
+    MultiPipelinePlanRequestParameters(const rclcpp::Node::SharedPtr& node,
+                                       const std::vector<std::string>& parameter_namespaces)
+    {
+      plan_request_parameter_vector.resize(parameter_namespaces.size());
+      for (std::size_t i = 0; i < parameter_namespaces.size(); ++i)
+        plan_request_parameter_vector[i].load(node, parameter_namespaces[i]);
+    }
+
+    std::vector<PlanRequestParameters> plan_request_parameter_vector;
+  };
+
+  /// Decide from the solutions found so far whether the pipelines that are still planning should be terminated
+  using StoppingCriterionFunction = std::function<bool(const std::vector<PlanSolution>& solutions,
+                                                       const MultiPipelinePlanRequestParameters& parameters)>;
+
+  /// Pick the returned solution among the solutions of all pipelines
+  using SolutionSelectionFunction = std::function<PlanSolution(const std::vector<PlanSolution>& solutions)>;
+
+  /** \brief Stopping criterion that terminates planning once any pipeline found a solution */
+  static bool stopAtFirstSolution(const std::vector<PlanSolution>& solutions,
+                                  const MultiPipelinePlanRequestParameters& parameters);
+
+  /** \brief Select the successful solution with the shortest joint space path, or the first failure if none is */
+  static PlanSolution getShortestSolution(const std::vector<PlanSolution>& solutions);
+
+  /** \brief Select the successful solution with the lowest duration, or the first failure if none is */
+  static PlanSolution getFastestSolution(const std::vector<PlanSolution>& solutions);
+
   /** \brief Constructor */
   PlanningComponent(const std::string& group_name, const rclcpp::Node::SharedPtr& node);
   PlanningComponent(const std::string& group_name, const MoveItCppPtr& moveit_cpp);
@@ -160,6 +196,13 @@ public:
   /** \brief Run a plan from start or current state to fulfill the last goal constraints provided by setGoal() using the
    * provided PlanRequestParameters. */
   PlanSolution plan(const PlanRequestParameters& parameters);
+  /** \brief Run the planning pipelines of all entries of \e parameters concurrently on the same planning scene snapshot
+   * and return the solution picked by \e solution_selection_function. \e stopping_criterion_callback is evaluated
+   * whenever a pipeline finishes and periodically in between, so it can also implement a deadline. Once it returns
+   * true, the pipelines that are still planning are terminated. */
+  PlanSolution plan(const MultiPipelinePlanRequestParameters& parameters,
+                    const SolutionSelectionFunction& solution_selection_function = &getShortestSolution,
+                    const StoppingCriterionFunction& stopping_criterion_callback = StoppingCriterionFunction());
 
   /** \brief Execute the latest computed solution trajectory computed by plan(). By default this function terminates
    * after the execution is complete. The execution can be run in background by setting blocking to false. */
@@ -169,6 +212,15 @@ public:
   const PlanSolutionPtr getLastPlanSolution();
 
 private:
+  /** \brief Snapshot the planning scene and fill the parts of \e req that do not depend on the planning pipeline */
+  moveit::core::MoveItErrorCode prepareRequest(planning_scene::PlanningSceneConstPtr& planning_scene,
+                                               ::planning_interface::MotionPlanRequest& req);
+
+  /** \brief Solve \e req with the planning pipeline and planner settings of \e parameters */
+  PlanSolution planWithPipeline(const PlanRequestParameters& parameters,
+                                const planning_scene::PlanningSceneConstPtr& planning_scene,
+                                ::planning_interface::MotionPlanRequest req) const;
+
   // Core properties and instances
   rclcpp::Node::SharedPtr node_;
   MoveItCppPtr moveit_cpp_;
@@ -34,10 +34,12 @@
 
 /* Author: Henning Kayser */
 
+#include <future>
 #include <stdexcept>
 
 #include <moveit/controller_manager/controller_manager.h>
 #include <moveit/moveit_cpp/moveit_cpp.h>
+#include <moveit/utils/startup_profile.h>
 #if __has_include(<tf2_geometry_msgs/tf2_geometry_msgs.hpp>)
 #include <tf2_geometry_msgs/tf2_geometry_msgs.hpp>
 #else
@@ -81,6 +83,7 @@ MoveItCpp::MoveItCpp(const rclcpp::Node::SharedPtr& node, const Options& options
     throw std::runtime_error(error);
   }
 
+  moveit::profiling::ScopedStartupPhase phase("trajectory execution manager");
   trajectory_execution_manager_ = std::make_shared<trajectory_execution_manager::TrajectoryExecutionManager>(
       node_, robot_model_, planning_scene_monitor_->getStateMonitor());
 
@@ -95,6 +98,7 @@ MoveItCpp::~MoveItCpp()
 
 bool MoveItCpp::loadPlanningSceneMonitor(const PlanningSceneMonitorOptions& options)
 {
+  moveit::profiling::ScopedStartupPhase phase("planning scene monitor");
   planning_scene_monitor_ =
       std::make_shared<planning_scene_monitor::PlanningSceneMonitor>(node_, options.robot_description, options.name);
   // Allows us to synchronize to Rviz and also publish collision objects to ourselves
@@ -134,18 +138,28 @@ bool MoveItCpp::loadPlanningPipelines(const PlanningPipelineOptions& options)
 {
   // TODO(henningkayser): Use parent namespace for planning pipeline config lookup
   // ros::NodeHandle node_handle(options.parent_namespace.empty() ? "~" : options.parent_namespace);
+  moveit::profiling::ScopedStartupPhase phase("planning pipelines");
+
+  // the pipelines are independent of each other, so their planner and adapter plugins are loaded concurrently
+  std::map<std::string, std::future<planning_pipeline::PlanningPipelinePtr>> loading_pipelines;
   for (const auto& planning_pipeline_name : options.pipeline_names)
   {
-    if (planning_pipelines_.count(planning_pipeline_name) > 0)
+    if (planning_pipelines_.count(planning_pipeline_name) > 0 || loading_pipelines.count(planning_pipeline_name) > 0)
     {
       RCLCPP_WARN(LOGGER, "Skipping duplicate entry for planning pipeline '%s'.", planning_pipeline_name.c_str());
       continue;
     }
     RCLCPP_INFO(LOGGER, "Loading planning pipeline '%s'", planning_pipeline_name.c_str());
-    planning_pipeline::PlanningPipelinePtr pipeline;
-    pipeline = std::make_shared<planning_pipeline::PlanningPipeline>(robot_model_, node_, planning_pipeline_name,
-                                                                     PLANNING_PLUGIN_PARAM);
+    loading_pipelines[planning_pipeline_name] = std::async(std::launch::async, [this, planning_pipeline_name] {
+      moveit::profiling::ScopedStartupPhase phase("planning pipeline '" + planning_pipeline_name + "'");
+      return std::make_shared<planning_pipeline::PlanningPipeline>(robot_model_, node_, planning_pipeline_name,
+                                                                   PLANNING_PLUGIN_PARAM);
+    });
+  }
 
+  for (auto& [planning_pipeline_name, loading_pipeline] : loading_pipelines)
+  {
+    const planning_pipeline::PlanningPipelinePtr pipeline = loading_pipeline.get();
     if (!pipeline->getPlannerManager())
     {
       RCLCPP_ERROR(LOGGER, "Failed to initialize planning pipeline '%s'.", planning_pipeline_name.c_str());
@@ -239,6 +253,18 @@ planning_scene_monitor::PlanningSceneMonitorPtr MoveItCpp::getPlanningSceneMonit
   return planning_scene_monitor_;
 }
 
+planning_scene::PlanningSceneConstPtr MoveItCpp::getPlanningSceneSnapshot() const
+{
+  auto lock = std::make_shared<planning_scene_monitor::LockedPlanningSceneRO>(planning_scene_monitor_);
+  const planning_scene::PlanningSceneConstPtr& scene = *lock;
+  // Without snapshots the lock protects the monitored scene itself, which must not stay locked
+  if (scene == planning_scene_monitor_->getPlanningScene())
+    return planning_scene::PlanningScene::clone(scene);
+
+  // The returned pointer shares ownership of the lock, which releases the octomap once the snapshot is dropped
+  return planning_scene::PlanningSceneConstPtr(lock, scene.get());
+}
+
 const trajectory_execution_manager::TrajectoryExecutionManagerPtr& MoveItCpp::getTrajectoryExecutionManager() const
 {
   return trajectory_execution_manager_;
@@ -34,7 +34,12 @@
 
 /* Author: Henning Kayser */
 
+#include <algorithm>
+#include <condition_variable>
+#include <limits>
+#include <mutex>
 #include <stdexcept>
+#include <thread>
 
 #include <moveit/moveit_cpp/planning_component.h>
 #include <moveit/kinematic_constraints/utils.h>
@@ -46,6 +51,40 @@ namespace moveit_cpp
 {
 static const rclcpp::Logger LOGGER = rclcpp::get_logger("moveit.ros_planning_interface.planning_component");
 
+// Period at which parallel planning evaluates the stopping criterion while no pipeline finishes
+static const auto STOPPING_CRITERION_PERIOD = std::chrono::milliseconds(10);
+
+namespace
+{
+// The successful solution with the lowest cost, or the first solution if none succeeded
+PlanningComponent::PlanSolution
+selectSolution(const std::vector<PlanningComponent::PlanSolution>& solutions,
+               const std::function<double(const robot_trajectory::RobotTrajectory&)>& cost)
+{
+  const PlanningComponent::PlanSolution* best = nullptr;
+  double best_cost = std::numeric_limits<double>::infinity();
+  for (const PlanningComponent::PlanSolution& solution : solutions)
+  {
+    if (!solution || !solution.trajectory)
+      continue;
+    const double solution_cost = cost(*solution.trajectory);
+    if (!best || solution_cost < best_cost)
+    {
+      best = &solution;
+      best_cost = solution_cost;
+    }
+  }
+  if (best)
+    return *best;
+  if (!solutions.empty())
+    return solutions.front();
+
+  PlanningComponent::PlanSolution failure;
+  failure.error_code = moveit::core::MoveItErrorCode::FAILURE;
+  return failure;
+}
+}  // namespace
+
 PlanningComponent::PlanningComponent(const std::string& group_name, const MoveItCppPtr& moveit_cpp)
   : node_(moveit_cpp->getNode()), moveit_cpp_(moveit_cpp), group_name_(group_name)
 {
@@ -107,76 +146,91 @@ bool PlanningComponent::setPathConstraints(const moveit_msgs::msg::Constraints&
   return true;
 }
 
-PlanningComponent::PlanSolution PlanningComponent::plan(const PlanRequestParameters& parameters)
+moveit::core::MoveItErrorCode
+PlanningComponent::prepareRequest(planning_scene::PlanningSceneConstPtr& planning_scene,
+                                  ::planning_interface::MotionPlanRequest& req)
 {
-  last_plan_solution_ = std::make_shared<PlanSolution>();
-  if (!joint_model_group_)
-  {
-    RCLCPP_ERROR(LOGGER, "Failed to retrieve joint model group for name '%s'.", group_name_.c_str());
-    last_plan_solution_->error_code = moveit::core::MoveItErrorCode::INVALID_GROUP_NAME;
-    return *last_plan_solution_;
-  }
-
-  // Clone current planning scene
-  planning_scene_monitor::PlanningSceneMonitorPtr planning_scene_monitor =
-      moveit_cpp_->getPlanningSceneMonitorNonConst();
-  planning_scene_monitor->updateFrameTransforms();
-  const planning_scene::PlanningScenePtr planning_scene = [planning_scene_monitor] {
-    planning_scene_monitor::LockedPlanningSceneRO ls(planning_scene_monitor);
-    return planning_scene::PlanningScene::clone(ls);
-  }();
-  planning_scene_monitor.reset();  // release this pointer
+  // Snapshot the current planning scene, it is only copied if the scene monitor does not keep snapshots
+  moveit_cpp_->getPlanningSceneMonitorNonConst()->updateFrameTransforms();
+  planning_scene = moveit_cpp_->getPlanningSceneSnapshot();
 
   // Init MotionPlanRequest
-  ::planning_interface::MotionPlanRequest req;
   req.group_name = group_name_;
-  req.planner_id = parameters.planner_id;
-  req.num_planning_attempts = std::max(1, parameters.planning_attempts);
-  req.allowed_planning_time = parameters.planning_time;
-  req.max_velocity_scaling_factor = parameters.max_velocity_scaling_factor;
-  req.max_acceleration_scaling_factor = parameters.max_acceleration_scaling_factor;
   if (workspace_parameters_set_)
     req.workspace_parameters = workspace_parameters_;
 
-  // Set start state
+  // Set start state, the full state message overrides the current state of the scene for planning
   moveit::core::RobotStatePtr start_state = considered_start_state_;
   if (!start_state)
     start_state = moveit_cpp_->getCurrentState();
   start_state->update();
   moveit::core::robotStateToRobotStateMsg(*start_state, req.start_state);
-  planning_scene->setCurrentState(*start_state);
 
   // Set goal constraints
   if (current_goal_constraints_.empty())
   {
     RCLCPP_ERROR(LOGGER, "No goal constraints set for planning request");
-    last_plan_solution_->error_code = moveit::core::MoveItErrorCode::INVALID_GOAL_CONSTRAINTS;
-    return *last_plan_solution_;
+    return moveit::core::MoveItErrorCode::INVALID_GOAL_CONSTRAINTS;
   }
   req.goal_constraints = current_goal_constraints_;
 
   // Set path constraints
   req.path_constraints = current_path_constraints_;
+  return moveit::core::MoveItErrorCode::SUCCESS;
+}
+
+PlanningComponent::PlanSolution
+PlanningComponent::planWithPipeline(const PlanRequestParameters& parameters,
+                                    const planning_scene::PlanningSceneConstPtr& planning_scene,
+                                    ::planning_interface::MotionPlanRequest req) const
+{
+  PlanSolution solution;
+  req.planner_id = parameters.planner_id;
+  req.num_planning_attempts = std::max(1, parameters.planning_attempts);
+  req.allowed_planning_time = parameters.planning_time;
+  req.max_velocity_scaling_factor = parameters.max_velocity_scaling_factor;
+  req.max_acceleration_scaling_factor = parameters.max_acceleration_scaling_factor;
 
   // Run planning attempt
   ::planning_interface::MotionPlanResponse res;
   if (planning_pipeline_names_.find(parameters.planning_pipeline) == planning_pipeline_names_.end())
   {
     RCLCPP_ERROR(LOGGER, "No planning pipeline available for name '%s'", parameters.planning_pipeline.c_str());
-    last_plan_solution_->error_code = moveit::core::MoveItErrorCode::FAILURE;
-    return *last_plan_solution_;
+    solution.error_code = moveit::core::MoveItErrorCode::FAILURE;
+    return solution;
   }
   const planning_pipeline::PlanningPipelinePtr pipeline =
       moveit_cpp_->getPlanningPipelines().at(parameters.planning_pipeline);
   pipeline->generatePlan(planning_scene, req, res);
-  last_plan_solution_->error_code = res.error_code_.val;
+  solution.error_code = res.error_code_.val;
   if (res.error_code_.val != res.error_code_.SUCCESS)
   {
-    RCLCPP_ERROR(LOGGER, "Could not compute plan successfully");
+    RCLCPP_ERROR(LOGGER, "Could not compute plan successfully with pipeline '%s'",
+                 parameters.planning_pipeline.c_str());
+    return solution;
+  }
+  solution.start_state = req.start_state;
+  solution.trajectory = res.trajectory_;
+  return solution;
+}
+
+PlanningComponent::PlanSolution PlanningComponent::plan(const PlanRequestParameters& parameters)
+{
+  last_plan_solution_ = std::make_shared<PlanSolution>();
+  if (!joint_model_group_)
+  {
+    RCLCPP_ERROR(LOGGER, "Failed to retrieve joint model group for name '%s'.", group_name_.c_str());
+    last_plan_solution_->error_code = moveit::core::MoveItErrorCode::INVALID_GROUP_NAME;
     return *last_plan_solution_;
   }
-  last_plan_solution_->start_state = req.start_state;
-  last_plan_solution_->trajectory = res.trajectory_;
+
+  planning_scene::PlanningSceneConstPtr planning_scene;
+  ::planning_interface::MotionPlanRequest req;
+  last_plan_solution_->error_code = prepareRequest(planning_scene, req);
+  if (!last_plan_solution_->error_code)
+    return *last_plan_solution_;
+
+  *last_plan_solution_ = planWithPipeline(parameters, planning_scene, req);
   // TODO(henningkayser): Visualize trajectory
   // std::vector<const moveit::core::LinkModel*> eef_links;
   // if (joint_model_group->getEndEffectorTips(eef_links))
@@ -192,6 +246,101 @@ PlanningComponent::PlanSolution PlanningComponent::plan(const PlanRequestParamet
   return *last_plan_solution_;
 }
 
+PlanningComponent::PlanSolution
+PlanningComponent::plan(const MultiPipelinePlanRequestParameters& parameters,
+                        const SolutionSelectionFunction& solution_selection_function,
+                        const StoppingCriterionFunction& stopping_criterion_callback)
+{
+  last_plan_solution_ = std::make_shared<PlanSolution>();
+  if (!joint_model_group_)
+  {
+    RCLCPP_ERROR(LOGGER, "Failed to retrieve joint model group for name '%s'.", group_name_.c_str());
+    last_plan_solution_->error_code = moveit::core::MoveItErrorCode::INVALID_GROUP_NAME;
+    return *last_plan_solution_;
+  }
+  const std::vector<PlanRequestParameters>& pipeline_parameters = parameters.plan_request_parameter_vector;
+  if (pipeline_parameters.empty())
+  {
+    RCLCPP_ERROR(LOGGER, "No planning pipelines given for parallel planning");
+    last_plan_solution_->error_code = moveit::core::MoveItErrorCode::FAILURE;
+    return *last_plan_solution_;
+  }
+
+  // All pipelines plan on the same scene snapshot, which they only read
+  planning_scene::PlanningSceneConstPtr planning_scene;
+  ::planning_interface::MotionPlanRequest req;
+  last_plan_solution_->error_code = prepareRequest(planning_scene, req);
+  if (!last_plan_solution_->error_code)
+    return *last_plan_solution_;
+
+  std::vector<PlanSolution> solutions;
+  solutions.reserve(pipeline_parameters.size());
+  std::mutex solutions_mutex;
+  std::condition_variable solution_available;
+  std::vector<std::thread> planning_threads;
+  planning_threads.reserve(pipeline_parameters.size());
+  for (const PlanRequestParameters& pipeline_parameter : pipeline_parameters)
+  {
+    planning_threads.emplace_back([&] {
+      PlanSolution solution = planWithPipeline(pipeline_parameter, planning_scene, req);
+      {
+        std::scoped_lock lock(solutions_mutex);
+        solutions.push_back(std::move(solution));
+      }
+      solution_available.notify_all();
+    });
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(solutions_mutex);
+    bool stopped = false;
+    while (solutions.size() < pipeline_parameters.size())
+    {
+      solution_available.wait_for(lock, STOPPING_CRITERION_PERIOD);
+      if (stopped || !stopping_criterion_callback || !stopping_criterion_callback(solutions, parameters))
+        continue;
+
+      // Terminating a pipeline that already finished has no effect
+      stopped = true;
+      for (const PlanRequestParameters& pipeline_parameter : pipeline_parameters)
+      {
+        const auto& pipelines = moveit_cpp_->getPlanningPipelines();
+        const auto it = pipelines.find(pipeline_parameter.planning_pipeline);
+        if (it != pipelines.end())
+          it->second->terminate();
+      }
+    }
+  }
+  for (std::thread& planning_thread : planning_threads)
+    planning_thread.join();
+
+  *last_plan_solution_ = solution_selection_function ? solution_selection_function(solutions) :
+                                                       getShortestSolution(solutions);
+  return *last_plan_solution_;
+}
+
+bool PlanningComponent::stopAtFirstSolution(const std::vector<PlanSolution>& solutions,
+                                            const MultiPipelinePlanRequestParameters& /* parameters */)
+{
+  return std::any_of(solutions.begin(), solutions.end(), [](const PlanSolution& solution) { return bool(solution); });
+}
+
+PlanningComponent::PlanSolution PlanningComponent::getShortestSolution(const std::vector<PlanSolution>& solutions)
+{
+  return selectSolution(solutions, [](const robot_trajectory::RobotTrajectory& trajectory) {
+    double length = 0.0;
+    for (std::size_t i = 1; i < trajectory.getWayPointCount(); ++i)
+      length += trajectory.getWayPoint(i - 1).distance(trajectory.getWayPoint(i), trajectory.getGroup());
+    return length;
+  });
+}
+
+PlanningComponent::PlanSolution PlanningComponent::getFastestSolution(const std::vector<PlanSolution>& solutions)
+{
+  return selectSolution(solutions,
+                        [](const robot_trajectory::RobotTrajectory& trajectory) { return trajectory.getDuration(); });
+}
+
 PlanningComponent::PlanSolution PlanningComponent::plan()
 {
   return plan(plan_request_parameters_);
@@ -42,9 +42,11 @@
 #include <moveit/planning_scene_monitor/planning_scene_monitor.h>
 #include <moveit/planning_scene_monitor/trajectory_monitor.h>
 #include <moveit/sensor_manager/sensor_manager.h>
+#include <moveit/robot_model/aabb.h>
 #include <pluginlib/class_loader.hpp>
 
 #include <atomic>
+#include <mutex>
 
 /** \brief This namespace includes functionality specific to the execution and monitoring of motion plans */
 namespace plan_execution
@@ -138,6 +140,17 @@ public:
       start of the method. They are then used to monitor the execution. */
   moveit_msgs::msg::MoveItErrorCodes executeAndMonitor(ExecutableMotionPlan& plan, bool reset_preempted = true);
 
+  /** \brief Plan and execute a queue of goals, planning each goal while the previous one is executing.
+
+      Goal \e i is planned by \e plan_callbacks[i] in a planning scene whose current state is the end state of goal
+      \e i-1. Its trajectories are queued through the continuous execution of the TrajectoryExecutionManager with a
+      start time at the end of goal \e i-1, so consecutive motions chain without stopping. \e plans holds the plan of
+      every goal. Once planning fails, the motions already queued are completed and the planning error is returned.
+      Unlike executeAndMonitor(), the queued trajectories are not validated against scene updates. */
+  moveit_msgs::msg::MoveItErrorCodes
+  planAndExecuteSequence(const std::vector<ExecutableMotionPlanComputationFn>& plan_callbacks,
+                         std::vector<ExecutableMotionPlan>& plans);
+
   void stop();
 
   std::string getErrorCodeString(const moveit_msgs::msg::MoveItErrorCodes& error_code);
@@ -146,7 +159,13 @@ private:
   void planAndExecuteHelper(ExecutableMotionPlan& plan, const Options& opt);
   bool isRemainingPathValid(const ExecutableMotionPlan& plan, const std::pair<int, int>& path_segment);
 
+  /** \brief Forget the cached validity of waypoints that may be affected by the world changes recorded since the last
+      call. Must be called with \e path_validity_mutex_ held. */
+  void invalidatePathValidity();
+
   void planningSceneUpdatedCallback(const planning_scene_monitor::PlanningSceneMonitor::SceneUpdateType update_type);
+  void worldChangedCallback(const collision_detection::World::ObjectConstPtr& object,
+                            collision_detection::World::Action action);
   void doneWithTrajectoryExecution(const moveit_controller_manager::ExecutionStatus& status);
   void successfulTrajectorySegmentExecution(const ExecutableMotionPlan& plan, std::size_t index);
 
@@ -181,6 +200,25 @@ private:
   bool execution_complete_;
   bool path_became_invalid_;
 
+  /** \brief Waypoint validity of one plan component, kept across scene updates during executeAndMonitor() */
+  struct ComponentValidity
+  {
+    /// Bounding box of the robot at each waypoint; computed on the first check
+    std::vector<moveit::core::AABB> waypoint_aabbs_;
+    /// Whether each waypoint is known to be valid in the current scene
+    std::vector<bool> valid_;
+  };
+  std::vector<ComponentValidity> path_validity_;
+  std::mutex path_validity_mutex_;
+
+  // world changes since the last validity check: regions where obstacles may have appeared, or a flag for changes
+  // that cannot be bounded
+  collision_detection::WorldPtr world_;
+  collision_detection::World::ObserverHandle world_observer_;
+  std::vector<moveit::core::AABB> changed_regions_;
+  bool unbounded_world_change_;
+  std::mutex world_changes_mutex_;
+
   // class DynamicReconfigureImpl;
   // DynamicReconfigureImpl* reconfigure_impl_;
 };
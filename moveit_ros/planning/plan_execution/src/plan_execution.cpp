@@ -39,6 +39,7 @@
 #include <moveit/trajectory_processing/trajectory_tools.h>
 #include <moveit/collision_detection/collision_tools.h>
 #include <moveit/utils/message_checks.h>
+#include <geometric_shapes/shape_operations.h>
 #include <boost/algorithm/string/join.hpp>
 #include <rclcpp/logger.hpp>
 #include <rclcpp/logging.hpp>
@@ -47,6 +48,8 @@
 #include <rclcpp/rate.hpp>
 #include <rclcpp/utilities.hpp>
 
+#include <optional>
+
 // #include <dynamic_reconfigure/server.h>
 // #include <moveit_ros_planning/PlanExecutionDynamicReconfigureConfig.h>
 
@@ -54,6 +57,37 @@ namespace plan_execution
 {
 static const rclcpp::Logger LOGGER = rclcpp::get_logger("moveit_ros.plan_execution");
 
+namespace
+{
+/** Compute the region covered by \e object. Returns false if the object is unbounded. */
+bool computeObjectAABB(const collision_detection::World::Object& object, moveit::core::AABB& aabb)
+{
+  for (std::size_t i = 0; i < object.shapes_.size(); ++i)
+  {
+    const shapes::Shape* shape = object.shapes_[i].get();
+    const Eigen::Isometry3d& pose = object.global_shape_poses_[i];
+    if (shape->type == shapes::PLANE)
+      return false;
+    if (shape->type == shapes::OCTREE)
+    {
+      const std::shared_ptr<const octomap::OcTree>& octree = static_cast<const shapes::OcTree*>(shape)->octree;
+      Eigen::Vector3d min, max;
+      octree->getMetricMin(min.x(), min.y(), min.z());
+      octree->getMetricMax(max.x(), max.y(), max.z());
+      aabb.extendWithTransformedBox(pose * Eigen::Translation3d(0.5 * (min + max)), max - min);
+    }
+    else
+    {
+      Eigen::Vector3d center;
+      double radius;
+      shapes::computeShapeBoundingSphere(shape, center, radius);
+      aabb.extendWithTransformedBox(pose * Eigen::Translation3d(center), Eigen::Vector3d::Constant(2.0 * radius));
+    }
+  }
+  return true;
+}
+}  // namespace
+
 // class PlanExecution::DynamicReconfigureImpl
 // {
 // public:
@@ -88,6 +122,14 @@ plan_execution::PlanExecution::PlanExecution(
   default_max_replan_attempts_ = 5;
 
   new_scene_update_ = false;
+  unbounded_world_change_ = false;
+
+  // track which parts of the world change, so that only the affected waypoints are validated again
+  world_ = planning_scene_monitor_->getPlanningScene()->getWorldNonConst();
+  world_observer_ = world_->addObserver(
+      [this](const collision_detection::World::ObjectConstPtr& object, collision_detection::World::Action action) {
+        worldChangedCallback(object, action);
+      });
 
   // we want to be notified when new information is available
   planning_scene_monitor_->addUpdateCallback(
@@ -101,6 +143,7 @@ plan_execution::PlanExecution::PlanExecution(
 
 plan_execution::PlanExecution::~PlanExecution()
 {
+  world_->removeObserver(world_observer_);
   // delete reconfigure_impl_;
 }
 
@@ -280,6 +323,38 @@ void plan_execution::PlanExecution::planAndExecuteHelper(ExecutableMotionPlan& p
   }
 }
 
+void plan_execution::PlanExecution::invalidatePathValidity()
+{
+  std::vector<moveit::core::AABB> changed_regions;
+  bool unbounded_change;
+  {
+    std::scoped_lock lock(world_changes_mutex_);
+    changed_regions.swap(changed_regions_);
+    unbounded_change = unbounded_world_change_;
+    unbounded_world_change_ = false;
+  }
+  if (changed_regions.empty() && !unbounded_change)
+    return;
+
+  for (ComponentValidity& component : path_validity_)
+    for (std::size_t i = 0; i < component.valid_.size(); ++i)
+    {
+      if (!component.valid_[i])
+        continue;
+      if (unbounded_change)
+      {
+        component.valid_[i] = false;
+        continue;
+      }
+      for (const moveit::core::AABB& region : changed_regions)
+        if (region.intersects(component.waypoint_aabbs_[i]))
+        {
+          component.valid_[i] = false;
+          break;
+        }
+    }
+}
+
 bool plan_execution::PlanExecution::isRemainingPathValid(const ExecutableMotionPlan& plan,
                                                          const std::pair<int, int>& path_segment)
 {
@@ -287,6 +362,9 @@ bool plan_execution::PlanExecution::isRemainingPathValid(const ExecutableMotionP
       plan.plan_components_[path_segment.first].trajectory_monitoring_)  // If path_segment.second <= 0, the function
                                                                          // will fallback to check the entire trajectory
   {
+    std::scoped_lock validity_lock(path_validity_mutex_);
+    invalidatePathValidity();
+
     planning_scene_monitor::LockedPlanningSceneRO lscene(plan.planning_scene_monitor_);  // lock the scene so that it
                                                                                          // does not modify the world
                                                                                          // representation while
@@ -295,10 +373,34 @@ bool plan_execution::PlanExecution::isRemainingPathValid(const ExecutableMotionP
     const collision_detection::AllowedCollisionMatrix* acm =
         plan.plan_components_[path_segment.first].allowed_collision_matrix_.get();
     std::size_t wpc = t.getWayPointCount();
+
+    // waypoints that were valid before and are away from all changes since then need not be checked again
+    if (path_validity_.size() < plan.plan_components_.size())
+      path_validity_.resize(plan.plan_components_.size());
+    ComponentValidity& validity = path_validity_[path_segment.first];
+    if (validity.valid_.size() != wpc)
+    {
+      validity.waypoint_aabbs_.resize(wpc);
+      for (std::size_t i = 0; i < wpc; ++i)
+      {
+        moveit::core::RobotState state(t.getWayPoint(i));
+        state.updateCollisionBodyTransforms();
+        std::vector<double> aabb;
+        state.computeAABB(aabb);
+        validity.waypoint_aabbs_[i] = moveit::core::AABB();
+        validity.waypoint_aabbs_[i].extend(Eigen::Vector3d(aabb[0], aabb[2], aabb[4]));
+        validity.waypoint_aabbs_[i].extend(Eigen::Vector3d(aabb[1], aabb[3], aabb[5]));
+      }
+      validity.valid_.assign(wpc, false);
+    }
+
     collision_detection::CollisionRequest req;
     req.group_name = t.getGroupName();
     for (std::size_t i = std::max(path_segment.second - 1, 0); i < wpc; ++i)
     {
+      if (validity.valid_[i])
+        continue;
+
       collision_detection::CollisionResult res;
       if (acm)
         plan.planning_scene_->checkCollisionUnpadded(req, res, t.getWayPoint(i), *acm);
@@ -321,6 +423,7 @@ bool plan_execution::PlanExecution::isRemainingPathValid(const ExecutableMotionP
           plan.planning_scene_->checkCollisionUnpadded(req, res, t.getWayPoint(i));
         return false;
       }
+      validity.valid_[i] = true;
     }
   }
   return true;
@@ -357,6 +460,12 @@ moveit_msgs::msg::MoveItErrorCodes plan_execution::PlanExecution::executeAndMoni
 
   execution_complete_ = false;
 
+  // nothing is known about the validity of the new plan yet
+  {
+    std::scoped_lock validity_lock(path_validity_mutex_);
+    path_validity_.assign(plan.plan_components_.size(), ComponentValidity());
+  }
+
   // push the trajectories we have slated for execution to the trajectory execution manager
   int prev = -1;
   for (std::size_t i = 0; i < plan.plan_components_.size(); ++i)
@@ -413,6 +522,12 @@ moveit_msgs::msg::MoveItErrorCodes plan_execution::PlanExecution::executeAndMoni
     node_->get_parameter_or("plan_execution.record_trajectory_state_frequency", sampling_frequency, 0.0);
     trajectory_monitor_ = std::make_shared<planning_scene_monitor::TrajectoryMonitor>(
         planning_scene_monitor_->getStateMonitor(), sampling_frequency);
+
+    // record every state update instead of sampling, if a buffer capacity is configured
+    int compact_recording_capacity = 0;
+    node_->get_parameter_or("plan_execution.compact_trajectory_recording_capacity", compact_recording_capacity, 0);
+    if (compact_recording_capacity > 0)
+      trajectory_monitor_->setCompactRecording(compact_recording_capacity);
   }
 
   // start recording trajectory states
@@ -502,6 +617,109 @@ moveit_msgs::msg::MoveItErrorCodes plan_execution::PlanExecution::executeAndMoni
   return result;
 }
 
+moveit_msgs::msg::MoveItErrorCodes plan_execution::PlanExecution::planAndExecuteSequence(
+    const std::vector<ExecutableMotionPlanComputationFn>& plan_callbacks, std::vector<ExecutableMotionPlan>& plans)
+{
+  preempt_.checkAndClear();  // clear any previous preempt_ request
+
+  moveit_msgs::msg::MoveItErrorCodes result;
+  result.val = moveit_msgs::msg::MoveItErrorCodes::SUCCESS;
+  plans.assign(plan_callbacks.size(), ExecutableMotionPlan());
+
+  // start time of the next motion on the controllers' time axis; unset until the first trajectory is queued
+  std::optional<rclcpp::Time> next_start;
+  moveit::core::RobotStatePtr predicted_state;
+
+  for (std::size_t i = 0; i < plan_callbacks.size(); ++i)
+  {
+    ExecutableMotionPlan& plan = plans[i];
+    plan.planning_scene_monitor_ = planning_scene_monitor_;
+    if (!predicted_state)
+      plan.planning_scene_ = planning_scene_monitor_->getPlanningScene();
+    else
+    {
+      planning_scene::PlanningScenePtr scene;
+      {
+        planning_scene_monitor::LockedPlanningSceneRO lscene(planning_scene_monitor_);
+        scene = lscene->diff();
+      }
+      scene->setCurrentState(*predicted_state);
+      plan.planning_scene_ = scene;
+    }
+
+    RCLCPP_INFO(LOGGER, "Planning goal %zu of %zu", i + 1, plan_callbacks.size());
+    if (!plan_callbacks[i](plan) && plan.error_code_.val == moveit_msgs::msg::MoveItErrorCodes::SUCCESS)
+      plan.error_code_.val = moveit_msgs::msg::MoveItErrorCodes::PLANNING_FAILED;
+    if (plan.error_code_.val != moveit_msgs::msg::MoveItErrorCodes::SUCCESS)
+    {
+      RCLCPP_ERROR(LOGGER, "Planning goal %zu failed: %s", i + 1, getErrorCodeString(plan.error_code_).c_str());
+      result = plan.error_code_;
+      break;
+    }
+
+    if (preempt_.checkAndClear())
+    {
+      result.val = moveit_msgs::msg::MoveItErrorCodes::PREEMPTED;
+      break;
+    }
+
+    // queue the trajectories of this goal behind the ones already executing
+    for (ExecutableTrajectory& component : plan.plan_components_)
+    {
+      if (!component.trajectory_ || component.trajectory_->empty())
+        continue;
+
+      if (predicted_state)
+        component.trajectory_->unwind(*predicted_state);
+      else
+        component.trajectory_->unwind(planning_scene_monitor_->getStateMonitor() ?
+                                          *planning_scene_monitor_->getStateMonitor()->getCurrentState() :
+                                          plan.planning_scene_->getCurrentState());
+
+      if (!next_start)
+        next_start = node_->now();
+
+      moveit_msgs::msg::RobotTrajectory msg;
+      component.trajectory_->getRobotTrajectoryMsg(msg);
+      msg.joint_trajectory.header.stamp = *next_start;
+      msg.multi_dof_joint_trajectory.header.stamp = *next_start;
+      if (!trajectory_execution_manager_->pushAndExecute(msg, component.controller_names_))
+      {
+        RCLCPP_ERROR(LOGGER, "Failed to queue trajectory component '%s'", component.description_.c_str());
+        result.val = moveit_msgs::msg::MoveItErrorCodes::CONTROL_FAILED;
+        break;
+      }
+
+      *next_start += rclcpp::Duration::from_seconds(component.trajectory_->getDuration());
+      predicted_state = std::make_shared<moveit::core::RobotState>(component.trajectory_->getLastWayPoint());
+    }
+    if (result.val != moveit_msgs::msg::MoveItErrorCodes::SUCCESS)
+      break;
+  }
+
+  if (result.val == moveit_msgs::msg::MoveItErrorCodes::PREEMPTED ||
+      result.val == moveit_msgs::msg::MoveItErrorCodes::CONTROL_FAILED)
+  {
+    RCLCPP_INFO(LOGGER, "Stopping execution of the queued goals");
+    trajectory_execution_manager_->stopExecution();
+    return result;
+  }
+
+  // let the motions that were already queued finish
+  const moveit_controller_manager::ExecutionStatus status = trajectory_execution_manager_->waitForContinuousExecution();
+  if (result.val != moveit_msgs::msg::MoveItErrorCodes::SUCCESS)
+    return result;
+  if (status == moveit_controller_manager::ExecutionStatus::SUCCEEDED)
+    result.val = moveit_msgs::msg::MoveItErrorCodes::SUCCESS;
+  else if (status == moveit_controller_manager::ExecutionStatus::TIMED_OUT)
+    result.val = moveit_msgs::msg::MoveItErrorCodes::TIMED_OUT;
+  else if (status == moveit_controller_manager::ExecutionStatus::PREEMPTED)
+    result.val = moveit_msgs::msg::MoveItErrorCodes::PREEMPTED;
+  else
+    result.val = moveit_msgs::msg::MoveItErrorCodes::CONTROL_FAILED;
+  return result;
+}
+
 void plan_execution::PlanExecution::planningSceneUpdatedCallback(
     const planning_scene_monitor::PlanningSceneMonitor::SceneUpdateType update_type)
 {
@@ -510,6 +728,21 @@ void plan_execution::PlanExecution::planningSceneUpdatedCallback(
     new_scene_update_ = true;
 }
 
+void plan_execution::PlanExecution::worldChangedCallback(const collision_detection::World::ObjectConstPtr& object,
+                                                         collision_detection::World::Action action)
+{
+  // removing geometry cannot make a waypoint invalid
+  if (action & collision_detection::World::DESTROY)
+    return;
+
+  std::scoped_lock lock(world_changes_mutex_);
+  moveit::core::AABB aabb;
+  if (!object || !computeObjectAABB(*object, aabb))
+    unbounded_world_change_ = true;
+  else if (!aabb.isEmpty())
+    changed_regions_.push_back(aabb);
+}
+
 void plan_execution::PlanExecution::doneWithTrajectoryExecution(
     const moveit_controller_manager::ExecutionStatus& /*status*/)
 {
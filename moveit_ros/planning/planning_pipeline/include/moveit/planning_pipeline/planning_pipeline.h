@@ -41,6 +41,7 @@
 #include <pluginlib/class_loader.hpp>
 #include <rclcpp/rclcpp.hpp>
 #include <moveit_msgs/msg/display_trajectory.hpp>
+#include <diagnostic_msgs/msg/diagnostic_status.hpp>
 #include <visualization_msgs/msg/marker_array.hpp>
 
 #include <memory>
@@ -71,6 +72,11 @@ public:
    * this topic (visualization_msgs::MarkerArray) */
   static const std::string MOTION_CONTACTS_TOPIC;
 
+  /** \brief When the timing of the planning stages is supposed to be published, it is sent to this topic
+   * (diagnostic_msgs::msg::DiagnosticStatus, one key per stage with the time in seconds as value, followed by the
+   * allocations of each stage if allocation tracking is enabled and the estimated scene and robot model memory) */
+  static const std::string PLANNING_METRICS_TOPIC;
+
   /** \brief Given a robot model (\e model), a node handle (\e pipeline_nh), initialize the planning pipeline.
       \param model The robot model for which this pipeline is initialized.
       \param node The ROS node that should be used for reading parameters needed for configuration
@@ -108,6 +114,10 @@ public:
    * This is true by default.  */
   void checkSolutionPaths(bool flag);
 
+  /** \brief Pass a flag telling the pipeline whether or not to publish the time taken by each stage of a planning
+   * request on PLANNING_METRICS_TOPIC. Default is the value of the 'publish_planning_metrics' parameter, or false. */
+  void publishPlanningMetrics(bool flag);
+
   /** \brief Get the flag set by displayComputedMotionPlans() */
   bool getDisplayComputedMotionPlans() const
   {
@@ -126,6 +136,12 @@ public:
     return check_solution_paths_;
   }
 
+  /** \brief Get the flag set by publishPlanningMetrics() */
+  bool getPublishPlanningMetrics() const
+  {
+    return publish_planning_metrics_;
+  }
+
   /** \brief Call the motion planner plugin and the sequence of planning request adapters (if any).
       \param planning_scene The planning scene where motion planning is to be done
       \param req The request for motion planning
@@ -200,6 +216,10 @@ private:
   /// Flag indicating whether the reported plans should be checked once again, by the planning pipeline itself
   bool check_solution_paths_;
   rclcpp::Publisher<visualization_msgs::msg::MarkerArray>::SharedPtr contacts_publisher_;
+
+  /// Flag indicating whether the time taken by each stage of a request should be published
+  bool publish_planning_metrics_;
+  rclcpp::Publisher<diagnostic_msgs::msg::DiagnosticStatus>::SharedPtr planning_metrics_publisher_;
 };
 
 MOVEIT_CLASS_FORWARD(PlanningPipeline);  // Defines PlanningPipelinePtr, ConstPtr, WeakPtr... etc
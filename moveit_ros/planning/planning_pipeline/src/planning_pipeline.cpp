@@ -38,8 +38,13 @@
 #include <moveit/robot_state/conversions.h>
 #include <moveit/collision_detection/collision_tools.h>
 #include <moveit/trajectory_processing/trajectory_tools.h>
+#include <moveit/utils/allocation_tracking.h>
+#include <moveit/utils/tracing.h>
 #include <boost/tokenizer.hpp>
 #include <boost/algorithm/string/join.hpp>
+#include <chrono>
+#include <functional>
+#include <numeric>
 #include <sstream>
 
 static const rclcpp::Logger LOGGER = rclcpp::get_logger("moveit.ros_planning.planning_pipeline");
@@ -47,6 +52,15 @@ static const rclcpp::Logger LOGGER = rclcpp::get_logger("moveit.ros_planning.pla
 const std::string planning_pipeline::PlanningPipeline::DISPLAY_PATH_TOPIC = "display_planned_path";
 const std::string planning_pipeline::PlanningPipeline::MOTION_PLAN_REQUEST_TOPIC = "motion_plan_request";
 const std::string planning_pipeline::PlanningPipeline::MOTION_CONTACTS_TOPIC = "display_contacts";
+const std::string planning_pipeline::PlanningPipeline::PLANNING_METRICS_TOPIC = "planning_metrics";
+
+namespace
+{
+double secondsSince(const std::chrono::steady_clock::time_point& start)
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+}  // namespace
 
 planning_pipeline::PlanningPipeline::PlanningPipeline(const moveit::core::RobotModelConstPtr& model,
                                                       const std::shared_ptr<rclcpp::Node>& node,
@@ -99,6 +113,7 @@ void planning_pipeline::PlanningPipeline::configure()
   check_solution_paths_ = false;  // this is set to true below
   publish_received_requests_ = false;
   display_computed_motion_plans_ = false;  // this is set to true below
+  publish_planning_metrics_ = false;
 
   // load the planning plugin
   try
@@ -193,6 +208,10 @@ void planning_pipeline::PlanningPipeline::configure()
   }
   displayComputedMotionPlans(true);
   checkSolutionPaths(true);
+
+  const std::string metrics_param =
+      parameter_namespace_.empty() ? "publish_planning_metrics" : parameter_namespace_ + ".publish_planning_metrics";
+  publishPlanningMetrics(node_->get_parameter_or(metrics_param, false));
 }
 
 void planning_pipeline::PlanningPipeline::displayComputedMotionPlans(bool flag)
@@ -229,6 +248,18 @@ void planning_pipeline::PlanningPipeline::checkSolutionPaths(bool flag)
   check_solution_paths_ = flag;
 }
 
+void planning_pipeline::PlanningPipeline::publishPlanningMetrics(bool flag)
+{
+  if (publish_planning_metrics_ && !flag)
+    planning_metrics_publisher_.reset();
+  else if (!publish_planning_metrics_ && flag)
+  {
+    planning_metrics_publisher_ =
+        node_->create_publisher<diagnostic_msgs::msg::DiagnosticStatus>(PLANNING_METRICS_TOPIC, 10);
+  }
+  publish_planning_metrics_ = flag;
+}
+
 bool planning_pipeline::PlanningPipeline::generatePlan(const planning_scene::PlanningSceneConstPtr& planning_scene,
                                                        const planning_interface::MotionPlanRequest& req,
                                                        planning_interface::MotionPlanResponse& res) const
@@ -246,19 +277,28 @@ bool planning_pipeline::PlanningPipeline::generatePlan(const planning_scene::Pla
   if (publish_received_requests_)
     received_request_publisher_->publish(req);
   adapter_added_state_index.clear();
+  res.stage_descriptions_.clear();
+  res.stage_times_.clear();
+  res.stage_allocations_.clear();
 
   if (!planner_instance_)
   {
     RCLCPP_ERROR(LOGGER, "No planning plugin loaded. Cannot plan.");
     return false;
   }
+  MOVEIT_TRACE_SCOPE("planning_pipeline.generate_plan", &res);
 
   bool solved = false;
+  auto stage_start = std::chrono::steady_clock::now();
+  moveit::memory::ScopedAllocationTracker stage_allocations;
   try
   {
     if (adapter_chain_)
     {
       solved = adapter_chain_->adaptAndPlan(planner_instance_, planning_scene, req, res, adapter_added_state_index);
+      for (std::size_t i = 0; i < res.adapter_times_.size(); ++i)
+        RCLCPP_DEBUG(LOGGER, "Planning request adapter '%s' took %f seconds", res.adapter_descriptions_[i].c_str(),
+                     res.adapter_times_[i]);
       if (!adapter_added_state_index.empty())
       {
         std::stringstream ss;
@@ -279,6 +319,30 @@ bool planning_pipeline::PlanningPipeline::generatePlan(const planning_scene::Pla
     RCLCPP_ERROR(LOGGER, "Exception caught: '%s'", ex.what());
     return false;
   }
+
+  // the planner reports the parts of its solve, if it can; whatever the adapters did not take was spent in the planner
+  const double solve_time = secondsSince(stage_start) -
+                            std::accumulate(res.adapter_times_.begin(), res.adapter_times_.end(), 0.0);
+  if (res.stage_descriptions_.empty())
+  {
+    res.stage_descriptions_.emplace_back("solve");
+    res.stage_times_.push_back(solve_time);
+    res.stage_allocations_.clear();
+    res.stage_allocations_.push_back(std::accumulate(res.adapter_allocations_.begin(), res.adapter_allocations_.end(),
+                                                     stage_allocations.getAllocations(),
+                                                     std::minus<moveit::memory::AllocationStats>()));
+  }
+  // planners that report stage times but no allocations count as allocating nothing
+  res.stage_allocations_.resize(res.stage_descriptions_.size());
+  if (adapter_chain_)
+  {
+    res.stage_descriptions_.insert(res.stage_descriptions_.begin(), res.adapter_descriptions_.begin(),
+                                   res.adapter_descriptions_.end());
+    res.stage_times_.insert(res.stage_times_.begin(), res.adapter_times_.begin(), res.adapter_times_.end());
+    res.stage_allocations_.insert(res.stage_allocations_.begin(), res.adapter_allocations_.begin(),
+                                  res.adapter_allocations_.end());
+  }
+
   bool valid = true;
 
   if (solved && res.trajectory_)
@@ -287,6 +351,9 @@ bool planning_pipeline::PlanningPipeline::generatePlan(const planning_scene::Pla
     RCLCPP_DEBUG(LOGGER, "Motion planner reported a solution path with %ld states", state_count);
     if (check_solution_paths_)
     {
+      stage_start = std::chrono::steady_clock::now();
+      stage_allocations = moveit::memory::ScopedAllocationTracker();
+      MOVEIT_TRACE_STAGE_BEGIN("planning_pipeline.validate", &res);
       visualization_msgs::msg::MarkerArray arr;
       visualization_msgs::msg::Marker m;
       m.action = visualization_msgs::msg::Marker::DELETEALL;
@@ -367,18 +434,75 @@ bool planning_pipeline::PlanningPipeline::generatePlan(const planning_scene::Pla
       else
         RCLCPP_DEBUG(LOGGER, "Planned path was found to be valid when rechecked");
       contacts_publisher_->publish(arr);
+      MOVEIT_TRACE_STAGE_END("planning_pipeline.validate", &res, valid);
+      res.stage_descriptions_.emplace_back("validate");
+      res.stage_times_.push_back(secondsSince(stage_start));
+      res.stage_allocations_.push_back(stage_allocations.getAllocations());
     }
   }
 
   // display solution path if needed
   if (display_computed_motion_plans_ && solved)
   {
+    stage_start = std::chrono::steady_clock::now();
+    stage_allocations = moveit::memory::ScopedAllocationTracker();
+    MOVEIT_TRACE_STAGE_BEGIN("planning_pipeline.display", &res);
     moveit_msgs::msg::DisplayTrajectory disp;
     disp.model_id = robot_model_->getName();
     disp.trajectory.resize(1);
     res.trajectory_->getRobotTrajectoryMsg(disp.trajectory[0]);
     moveit::core::robotStateToRobotStateMsg(res.trajectory_->getFirstWayPoint(), disp.trajectory_start);
     display_path_publisher_->publish(disp);
+    MOVEIT_TRACE_STAGE_END("planning_pipeline.display", &res, true);
+    res.stage_descriptions_.emplace_back("display");
+    res.stage_times_.push_back(secondsSince(stage_start));
+    res.stage_allocations_.push_back(stage_allocations.getAllocations());
+  }
+
+  const bool track_allocations = moveit::memory::isAllocationTrackingEnabled();
+  for (std::size_t i = 0; i < res.stage_times_.size(); ++i)
+  {
+    RCLCPP_DEBUG(LOGGER, "Planning stage '%s' took %f seconds", res.stage_descriptions_[i].c_str(),
+                 res.stage_times_[i]);
+    if (track_allocations)
+      RCLCPP_DEBUG(LOGGER, "Planning stage '%s' made %zu allocations of %zu bytes", res.stage_descriptions_[i].c_str(),
+                   res.stage_allocations_[i].count, res.stage_allocations_[i].bytes);
+  }
+  if (publish_planning_metrics_)
+  {
+    diagnostic_msgs::msg::DiagnosticStatus metrics;
+    metrics.level = solved && valid ? diagnostic_msgs::msg::DiagnosticStatus::OK :
+                                      diagnostic_msgs::msg::DiagnosticStatus::WARN;
+    metrics.name = planner_plugin_name_;
+    metrics.hardware_id = req.group_name;
+    metrics.message = solved && valid ? "solved" : "failed";
+    metrics.values.resize(res.stage_times_.size());
+    for (std::size_t i = 0; i < res.stage_times_.size(); ++i)
+    {
+      metrics.values[i].key = res.stage_descriptions_[i];
+      metrics.values[i].value = std::to_string(res.stage_times_[i]);
+    }
+    if (track_allocations)
+    {
+      for (std::size_t i = 0; i < res.stage_allocations_.size(); ++i)
+      {
+        diagnostic_msgs::msg::KeyValue count, bytes;
+        count.key = res.stage_descriptions_[i] + " allocations";
+        count.value = std::to_string(res.stage_allocations_[i].count);
+        bytes.key = res.stage_descriptions_[i] + " allocated bytes";
+        bytes.value = std::to_string(res.stage_allocations_[i].bytes);
+        metrics.values.push_back(count);
+        metrics.values.push_back(bytes);
+      }
+    }
+    diagnostic_msgs::msg::KeyValue scene_memory, model_memory;
+    scene_memory.key = "scene memory bytes";
+    scene_memory.value = std::to_string(planning_scene->getMemoryUsage());
+    model_memory.key = "robot model memory bytes";
+    model_memory.value = std::to_string(robot_model_->getMemoryUsage());
+    metrics.values.push_back(scene_memory);
+    metrics.values.push_back(model_memory);
+    planning_metrics_publisher_->publish(metrics);
   }
 
   if (!solved)
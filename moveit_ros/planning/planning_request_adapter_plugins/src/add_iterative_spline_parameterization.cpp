@@ -67,7 +67,9 @@ public:
     if (result && res.trajectory_)
     {
       RCLCPP_DEBUG(LOGGER, "Running '%s'", getDescription().c_str());
-      if (!time_param_.computeTimeStamps(*res.trajectory_, req.max_velocity_scaling_factor,
+      // Scratch memory of the time parameterization, kept per thread to avoid allocations for every plan
+      thread_local trajectory_processing::IterativeSplineParameterization::Workspace workspace;
+      if (!time_param_.computeTimeStamps(*res.trajectory_, workspace, req.max_velocity_scaling_factor,
                                          req.max_acceleration_scaling_factor))
       {
         RCLCPP_WARN(LOGGER, "Time parametrization for the solution path failed.");
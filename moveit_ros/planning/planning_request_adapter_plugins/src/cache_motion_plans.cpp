@@ -0,0 +1,213 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/planning_request_adapter/planning_request_adapter.h>
+#include <moveit/robot_state/conversions.h>
+#include <class_loader/class_loader.hpp>
+#include <rclcpp/logger.hpp>
+#include <rclcpp/logging.hpp>
+#include <rclcpp/node.hpp>
+#include <rclcpp/serialization.hpp>
+
+#include <cmath>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace default_planner_request_adapters
+{
+static const rclcpp::Logger LOGGER = rclcpp::get_logger("moveit_ros.cache_motion_plans");
+
+/** \brief Return a cached solution for a request that was solved before in the same world, after re-validating it.
+ *
+ * Requests are identified by group, pipeline, planner and scaling factors, the world version of the scene, the start
+ * state of the group quantized to start_state_resolution and the goal and path constraints without names and stamps.
+ * A hit skips every adapter after this one, so it should be listed first to cache the post-processed trajectory. */
+class CacheMotionPlans : public planning_request_adapter::PlanningRequestAdapter
+{
+public:
+  static const std::string MAX_ENTRIES_PARAM_NAME;
+  static const std::string RESOLUTION_PARAM_NAME;
+
+  void initialize(const rclcpp::Node::SharedPtr& node, const std::string& parameter_namespace) override
+  {
+    max_entries_ = std::max(1, getParam(node, LOGGER, parameter_namespace, MAX_ENTRIES_PARAM_NAME, 100));
+    start_state_resolution_ = getParam(node, LOGGER, parameter_namespace, RESOLUTION_PARAM_NAME, 1e-3);
+  }
+
+  std::string getDescription() const override
+  {
+    return "Cache Motion Plans";
+  }
+
+  bool adaptAndPlan(const PlannerFn& planner, const planning_scene::PlanningSceneConstPtr& planning_scene,
+                    const planning_interface::MotionPlanRequest& req, planning_interface::MotionPlanResponse& res,
+                    std::vector<std::size_t>& /*added_path_index*/) const override
+  {
+    RCLCPP_DEBUG(LOGGER, "Running '%s'", getDescription().c_str());
+    const rclcpp::Clock clock(RCL_STEADY_TIME);
+    const rclcpp::Time start_time = clock.now();
+
+    moveit::core::RobotState start_state = planning_scene->getCurrentState();
+    moveit::core::robotStateMsgToRobotState(planning_scene->getTransforms(), req.start_state, start_state);
+    const moveit::core::JointModelGroup* group = planning_scene->getRobotModel()->getJointModelGroup(req.group_name);
+    if (!group)
+      return planner(planning_scene, req, res);
+
+    const std::string key = computeKey(*planning_scene, req, start_state, group);
+    robot_trajectory::RobotTrajectoryPtr cached = lookup(key);
+    if (cached)
+    {
+      // The start state only matches up to the resolution, so the cached path starts exactly at the requested one
+      std::vector<double> start_positions;
+      start_state.copyJointGroupPositions(group, start_positions);
+      cached->getFirstWayPointPtr()->setJointGroupPositions(group, start_positions);
+      cached->getFirstWayPointPtr()->update();
+      if (planning_scene->isPathValid(*cached, req.path_constraints, req.goal_constraints, req.group_name))
+      {
+        RCLCPP_DEBUG(LOGGER, "Returning cached motion plan");
+        res.trajectory_ = cached;
+        res.error_code_.val = moveit_msgs::msg::MoveItErrorCodes::SUCCESS;
+        res.planning_time_ = (clock.now() - start_time).seconds();
+        return true;
+      }
+      RCLCPP_DEBUG(LOGGER, "Cached motion plan is no longer valid, planning again");
+      erase(key);
+    }
+
+    const bool result = planner(planning_scene, req, res);
+    if (result && res.trajectory_ && !res.trajectory_->empty())
+      insert(key, std::make_shared<robot_trajectory::RobotTrajectory>(*res.trajectory_, true));
+    return result;
+  }
+
+private:
+  /** \brief Append the canonical serialization of \e constraints to \e key */
+  static void appendConstraints(const moveit_msgs::msg::Constraints& constraints, std::string& key)
+  {
+    // Names and stamps do not change the meaning of a request
+    moveit_msgs::msg::Constraints canonical = constraints;
+    canonical.name.clear();
+    for (moveit_msgs::msg::PositionConstraint& constraint : canonical.position_constraints)
+      constraint.header.stamp = builtin_interfaces::msg::Time();
+    for (moveit_msgs::msg::OrientationConstraint& constraint : canonical.orientation_constraints)
+      constraint.header.stamp = builtin_interfaces::msg::Time();
+    for (moveit_msgs::msg::VisibilityConstraint& constraint : canonical.visibility_constraints)
+    {
+      constraint.target_pose.header.stamp = builtin_interfaces::msg::Time();
+      constraint.sensor_pose.header.stamp = builtin_interfaces::msg::Time();
+    }
+
+    static const rclcpp::Serialization<moveit_msgs::msg::Constraints> SERIALIZER;
+    rclcpp::SerializedMessage serialized;
+    SERIALIZER.serialize_message(&canonical, &serialized);
+    const rcl_serialized_message_t& buffer = serialized.get_rcl_serialized_message();
+    key.append(reinterpret_cast<const char*>(buffer.buffer), buffer.buffer_length);
+  }
+
+  std::string computeKey(const planning_scene::PlanningScene& planning_scene,
+                         const planning_interface::MotionPlanRequest& req, const moveit::core::RobotState& start_state,
+                         const moveit::core::JointModelGroup* group) const
+  {
+    std::string key = req.group_name + '\0' + req.pipeline_id + '\0' + req.planner_id + '\0';
+    const auto append_value = [&key](auto value) { key.append(reinterpret_cast<const char*>(&value), sizeof(value)); };
+    append_value(req.max_velocity_scaling_factor);
+    append_value(req.max_acceleration_scaling_factor);
+    append_value(planning_scene.getWorld()->getVersion());
+
+    std::vector<double> start_positions;
+    start_state.copyJointGroupPositions(group, start_positions);
+    for (double position : start_positions)
+      append_value(static_cast<std::int64_t>(std::llround(position / start_state_resolution_)));
+
+    for (const moveit_msgs::msg::Constraints& constraints : req.goal_constraints)
+      appendConstraints(constraints, key);
+    key += '\0';
+    appendConstraints(req.path_constraints, key);
+    return key;
+  }
+
+  /** \brief Copy of the cached trajectory for \e key, or nullptr */
+  robot_trajectory::RobotTrajectoryPtr lookup(const std::string& key) const
+  {
+    std::scoped_lock lock(mutex_);
+    const auto it = index_.find(key);
+    if (it == index_.end())
+      return nullptr;
+    // Move the entry to the front of the least recently used list
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return std::make_shared<robot_trajectory::RobotTrajectory>(*it->second->second, true);
+  }
+
+  void insert(const std::string& key, const robot_trajectory::RobotTrajectoryPtr& trajectory) const
+  {
+    std::scoped_lock lock(mutex_);
+    const auto it = index_.find(key);
+    if (it != index_.end())
+      entries_.erase(it->second);
+    entries_.emplace_front(key, trajectory);
+    index_[key] = entries_.begin();
+    while (entries_.size() > static_cast<std::size_t>(max_entries_))
+    {
+      index_.erase(entries_.back().first);
+      entries_.pop_back();
+    }
+  }
+
+  void erase(const std::string& key) const
+  {
+    std::scoped_lock lock(mutex_);
+    const auto it = index_.find(key);
+    if (it == index_.end())
+      return;
+    entries_.erase(it->second);
+    index_.erase(it);
+  }
+
+  int max_entries_;
+  double start_state_resolution_;
+
+  // Cached trajectories, most recently used first
+  using Entry = std::pair<std::string, robot_trajectory::RobotTrajectoryPtr>;
+  mutable std::mutex mutex_;
+  mutable std::list<Entry> entries_;
+  mutable std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+};
+
+const std::string CacheMotionPlans::MAX_ENTRIES_PARAM_NAME = "max_cached_plans";
+const std::string CacheMotionPlans::RESOLUTION_PARAM_NAME = "cache_start_state_resolution";
+}  // namespace default_planner_request_adapters
+
+CLASS_LOADER_REGISTER_CLASS(default_planner_request_adapters::CacheMotionPlans,
+                            planning_request_adapter::PlanningRequestAdapter);
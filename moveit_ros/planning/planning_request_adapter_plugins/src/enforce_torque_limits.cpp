@@ -0,0 +1,175 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+#include <moveit/dynamics_solver/dynamics_solver.h>
+#include <moveit/planning_request_adapter/planning_request_adapter.h>
+#include <class_loader/class_loader.hpp>
+#include <rclcpp/logger.hpp>
+#include <rclcpp/logging.hpp>
+#include <rclcpp/node.hpp>
+#include <cmath>
+#include <map>
+#include <mutex>
+
+namespace default_planner_request_adapters
+{
+static const rclcpp::Logger LOGGER = rclcpp::get_logger("moveit_ros.enforce_torque_limits");
+
+/** @brief Check the joint torques of the time-parameterized solution against the effort limits in the URDF.
+ *  Violating trajectories are slowed down uniformly until they are feasible, or rejected if that is disabled or
+ *  does not succeed. Use after a time parameterization algorithm. */
+class EnforceTorqueLimits : public planning_request_adapter::PlanningRequestAdapter
+{
+public:
+  void initialize(const rclcpp::Node::SharedPtr& node, const std::string& parameter_namespace) override
+  {
+    retime_ = getParam(node, LOGGER, parameter_namespace, "retime", true);
+    max_retime_iterations_ = getParam(node, LOGGER, parameter_namespace, "max_retime_iterations", 10);
+    gravity_.x = 0.0;
+    gravity_.y = 0.0;
+    gravity_.z = getParam(node, LOGGER, parameter_namespace, "gravity_z", -9.81);
+  }
+
+  std::string getDescription() const override
+  {
+    return "Enforce Torque Limits";
+  }
+
+  bool adaptAndPlan(const PlannerFn& planner, const planning_scene::PlanningSceneConstPtr& planning_scene,
+                    const planning_interface::MotionPlanRequest& req, planning_interface::MotionPlanResponse& res,
+                    std::vector<std::size_t>& /*added_path_index*/) const override
+  {
+    bool result = planner(planning_scene, req, res);
+    if (result && res.trajectory_ && !res.trajectory_->empty())
+    {
+      RCLCPP_DEBUG(LOGGER, "Running '%s'", getDescription().c_str());
+      const dynamics_solver::DynamicsSolverConstPtr solver = getSolver(planning_scene->getRobotModel(), req.group_name);
+
+      std::vector<double> torques;
+      double ratio;
+      if (!solver->getTorquesTrajectory(*res.trajectory_, torques) || !getTorqueRatio(*solver, torques, ratio))
+      {
+        RCLCPP_WARN(LOGGER, "Cannot compute the torques of group '%s'; torque limits are not checked.",
+                    req.group_name.c_str());
+        return result;
+      }
+
+      for (int iteration = 0; ratio > 1.0 && retime_ && iteration < max_retime_iterations_; ++iteration)
+      {
+        // Velocity and inertial torques shrink quadratically with the time scale; gravity torques do not
+        // change, so the stretch is only an estimate and the check is repeated
+        const double stretch = std::sqrt(ratio) * 1.01;
+        RCLCPP_DEBUG(LOGGER, "Torque limits exceeded by factor %f, slowing the trajectory down by %f", ratio, stretch);
+        stretchTrajectory(*res.trajectory_, stretch);
+        if (!solver->getTorquesTrajectory(*res.trajectory_, torques) || !getTorqueRatio(*solver, torques, ratio))
+          break;
+      }
+
+      if (ratio > 1.0)
+      {
+        RCLCPP_ERROR(LOGGER, "The solution path exceeds the torque limits of group '%s' by factor %f.",
+                     req.group_name.c_str(), ratio);
+        result = false;
+      }
+    }
+
+    return result;
+  }
+
+private:
+  /** @brief Get a cached solver for the group, rebuilding it if the robot model changed */
+  dynamics_solver::DynamicsSolverConstPtr getSolver(const moveit::core::RobotModelConstPtr& robot_model,
+                                                    const std::string& group_name) const
+  {
+    std::scoped_lock lock(solvers_mutex_);
+    dynamics_solver::DynamicsSolverConstPtr& solver = solvers_[group_name];
+    if (!solver || solver->getRobotModel() != robot_model)
+      solver = std::make_shared<const dynamics_solver::DynamicsSolver>(robot_model, group_name, gravity_);
+    return solver;
+  }
+
+  /** @brief Compute the largest ratio of torque to effort limit over all waypoints; joints without a limit are
+   *  ignored. Returns false if no joint has a limit. */
+  static bool getTorqueRatio(const dynamics_solver::DynamicsSolver& solver, const std::vector<double>& torques,
+                             double& ratio)
+  {
+    const std::vector<double>& max_torques = solver.getMaxTorques();
+    bool limited = false;
+    ratio = 0.0;
+    for (std::size_t i = 0; i < torques.size(); ++i)
+    {
+      const double max_torque = max_torques[i % max_torques.size()];
+      if (max_torque <= 0.0)
+        continue;
+      limited = true;
+      ratio = std::max(ratio, std::fabs(torques[i]) / max_torque);
+    }
+    return limited;
+  }
+
+  /** @brief Scale the duration of the trajectory by \e stretch, adjusting velocities and accelerations */
+  static void stretchTrajectory(robot_trajectory::RobotTrajectory& trajectory, double stretch)
+  {
+    const double velocity_scale = 1.0 / stretch;
+    const double acceleration_scale = velocity_scale * velocity_scale;
+    const std::size_t variable_count = trajectory.getRobotModel()->getVariableCount();
+    for (std::size_t i = 0; i < trajectory.getWayPointCount(); ++i)
+    {
+      trajectory.setWayPointDurationFromPrevious(i, trajectory.getWayPointDurationFromPrevious(i) * stretch);
+      moveit::core::RobotState& waypoint = *trajectory.getWayPointPtr(i);
+      if (waypoint.hasVelocities())
+      {
+        double* velocities = waypoint.getVariableVelocities();
+        for (std::size_t j = 0; j < variable_count; ++j)
+          velocities[j] *= velocity_scale;
+      }
+      if (waypoint.hasAccelerations())
+      {
+        double* accelerations = waypoint.getVariableAccelerations();
+        for (std::size_t j = 0; j < variable_count; ++j)
+          accelerations[j] *= acceleration_scale;
+      }
+    }
+  }
+
+  bool retime_;
+  int max_retime_iterations_;
+  geometry_msgs::msg::Vector3 gravity_;
+
+  mutable std::mutex solvers_mutex_;
+  mutable std::map<std::string, dynamics_solver::DynamicsSolverConstPtr> solvers_;
+};
+}  // namespace default_planner_request_adapters
+
+CLASS_LOADER_REGISTER_CLASS(default_planner_request_adapters::EnforceTorqueLimits,
+                            planning_request_adapter::PlanningRequestAdapter)
@@ -42,6 +42,8 @@
 #include <rclcpp/logging.hpp>
 #include <rclcpp/node.hpp>
 #include <rclcpp/parameter_value.hpp>
+#include <algorithm>
+#include <limits>
 
 namespace default_planner_request_adapters
 {
@@ -53,6 +55,7 @@ public:
   static const std::string DT_PARAM_NAME;
   static const std::string JIGGLE_PARAM_NAME;
   static const std::string ATTEMPTS_PARAM_NAME;
+  static const std::string BATCH_PARAM_NAME;
 
   void initialize(const rclcpp::Node::SharedPtr& node, const std::string& parameter_namespace) override
   {
@@ -65,6 +68,12 @@ public:
       sampling_attempts_ = 1;
       RCLCPP_WARN(LOGGER, "Param '%s' needs to be at least 1.", ATTEMPTS_PARAM_NAME.c_str());
     }
+    sampling_batch_size_ = getParam(node_, LOGGER, parameter_namespace, BATCH_PARAM_NAME, 10);
+    if (sampling_batch_size_ < 1)
+    {
+      sampling_batch_size_ = 1;
+      RCLCPP_WARN(LOGGER, "Param '%s' needs to be at least 1.", BATCH_PARAM_NAME.c_str());
+    }
   }
 
   std::string getDescription() const override
@@ -92,6 +101,9 @@ public:
       collision_detection::CollisionRequest vcreq = creq;
       collision_detection::CollisionResult vcres;
       vcreq.verbose = true;
+      // the contacts tell in which direction to move out of collision
+      vcreq.contacts = true;
+      vcreq.max_contacts = MAX_ESCAPE_CONTACTS;
       planning_scene->checkCollision(vcreq, vcres, start_state);
 
       if (creq.group_name.empty())
@@ -102,29 +114,76 @@ public:
       auto prefix_state = std::make_shared<moveit::core::RobotState>(start_state);
       random_numbers::RandomNumberGenerator& rng = prefix_state->getRandomNumberGenerator();
 
+      const moveit::core::RobotModelConstPtr& robot_model = planning_scene->getRobotModel();
+      const moveit::core::JointModelGroup* jmg =
+          robot_model->hasJointModelGroup(req.group_name) ? robot_model->getJointModelGroup(req.group_name) : nullptr;
       const std::vector<const moveit::core::JointModel*>& jmodels =
-          planning_scene->getRobotModel()->hasJointModelGroup(req.group_name) ?
-              planning_scene->getRobotModel()->getJointModelGroup(req.group_name)->getJointModels() :
-              planning_scene->getRobotModel()->getJointModels();
+          jmg ? jmg->getJointModels() : robot_model->getJointModels();
 
+      // Candidates are preferred by how well they follow the escape direction, if the collision checker reported
+      // contact normals, or else by their distance to the start state
+      const Eigen::VectorXd escape_direction =
+          jmg ? computeEscapeDirection(*prefix_state, jmg, vcres) : Eigen::VectorXd();
+      std::vector<double> start_positions;
+      if (escape_direction.size() > 0)
+        prefix_state->copyJointGroupPositions(jmg, start_positions);
+
+      std::vector<moveit::core::RobotState> candidates;
+      std::vector<const moveit::core::RobotState*> candidate_ptrs;
+      std::vector<collision_detection::CollisionResult> candidate_results;
       bool found = false;
-      for (int c = 0; !found && c < sampling_attempts_; ++c)
+      int attempts = 0;
+      while (!found && attempts < sampling_attempts_)
       {
-        for (std::size_t i = 0; !found && i < jmodels.size(); ++i)
+        const auto batch_size = static_cast<std::size_t>(std::min(sampling_batch_size_, sampling_attempts_ - attempts));
+        candidates.assign(batch_size, *prefix_state);
+        std::vector<double> scores(batch_size);
+        for (std::size_t k = 0; k < batch_size; ++k)
         {
-          std::vector<double> sampled_variable_values(jmodels[i]->getVariableCount());
-          const double* original_values = prefix_state->getJointPositions(jmodels[i]);
-          jmodels[i]->getVariableRandomPositionsNearBy(rng, &sampled_variable_values[0], original_values,
-                                                       jmodels[i]->getMaximumExtent() * jiggle_fraction_);
-          start_state.setJointPositions(jmodels[i], sampled_variable_values);
-          collision_detection::CollisionResult cres;
-          planning_scene->checkCollision(creq, cres, start_state);
-          if (!cres.collision)
+          moveit::core::RobotState& candidate = candidates[k];
+          if (attempts == 0 && k == 0 && escape_direction.size() > 0)
           {
-            found = true;
-            RCLCPP_INFO(LOGGER, "Found a valid state near the start state at distance %lf after %d attempts",
-                        prefix_state->distance(start_state), c);
+            // follow the escape direction as far as the jiggle fraction allows
+            const Eigen::Map<const Eigen::VectorXd> start(start_positions.data(), start_positions.size());
+            const Eigen::VectorXd step = escape_direction * getJiggleDistance(jmodels) / escape_direction.norm();
+            candidate.setJointGroupPositions(jmg, Eigen::VectorXd(start + step));
+            candidate.enforceBounds(jmg);
+            scores[k] = std::numeric_limits<double>::infinity();
           }
+          else
+          {
+            for (const moveit::core::JointModel* jmodel : jmodels)
+            {
+              std::vector<double> sampled_variable_values(jmodel->getVariableCount());
+              const double* original_values = prefix_state->getJointPositions(jmodel);
+              jmodel->getVariableRandomPositionsNearBy(rng, &sampled_variable_values[0], original_values,
+                                                       jmodel->getMaximumExtent() * jiggle_fraction_);
+              candidate.setJointPositions(jmodel, sampled_variable_values);
+            }
+            scores[k] = scoreCandidate(candidate, *prefix_state, jmg, start_positions, escape_direction);
+          }
+          candidate.updateCollisionBodyTransforms();
+        }
+
+        candidate_ptrs.resize(batch_size);
+        for (std::size_t k = 0; k < batch_size; ++k)
+          candidate_ptrs[k] = &candidates[k];
+        // The padded environment also checks self collisions with padding, so every candidate it accepts is valid
+        // for PlanningScene::checkCollision() as well
+        planning_scene->getCollisionEnv()->checkCollisionBatch(creq, candidate_results, candidate_ptrs,
+                                                               planning_scene->getAllowedCollisionMatrix());
+
+        std::size_t best = batch_size;
+        for (std::size_t k = 0; k < batch_size; ++k)
+          if (!candidate_results[k].collision && (best == batch_size || scores[k] > scores[best]))
+            best = k;
+        attempts += static_cast<int>(batch_size);
+        if (best < batch_size)
+        {
+          found = true;
+          start_state = candidates[best];
+          RCLCPP_INFO(LOGGER, "Found a valid state near the start state at distance %lf after %d attempts",
+                      prefix_state->distance(start_state), attempts);
         }
       }
 
@@ -167,15 +226,84 @@ public:
   }
 
 private:
+  /** \brief The number of contacts used to compute the escape direction */
+  static constexpr std::size_t MAX_ESCAPE_CONTACTS = 10;
+
+  /** \brief Direction of the group variables that moves the links of \e jmg out of the contacts in \e res, weighted by
+      penetration depth. Empty if \e jmg is not a chain or no usable contact normals were reported. */
+  Eigen::VectorXd computeEscapeDirection(moveit::core::RobotState& state, const moveit::core::JointModelGroup* jmg,
+                                         const collision_detection::CollisionResult& res) const
+  {
+    if (!jmg->isChain())
+      return Eigen::VectorXd();
+
+    // getJacobian() expresses the linear velocity in the frame of the parent link of the group root
+    const moveit::core::LinkModel* root_link = jmg->getJointModels()[0]->getParentLinkModel();
+    state.updateLinkTransforms();
+    const Eigen::Matrix3d world_to_root =
+        root_link ? state.getGlobalLinkTransform(root_link).linear().transpose() : Eigen::Matrix3d::Identity();
+
+    Eigen::VectorXd direction = Eigen::VectorXd::Zero(jmg->getVariableCount());
+    Eigen::MatrixXd jacobian;
+    for (const auto& [link_pair, contacts] : res.contacts)
+    {
+      for (const collision_detection::Contact& contact : contacts)
+      {
+        if (contact.normal.isZero() || contact.depth <= 0.0)
+          continue;
+        // the contact normal points from the first to the second body
+        const auto add_escape = [&](const std::string& link_name, collision_detection::BodyType type, double sign) {
+          if (type != collision_detection::BodyTypes::ROBOT_LINK || !jmg->isLinkUpdated(link_name))
+            return;
+          const moveit::core::LinkModel* link = state.getLinkModel(link_name);
+          const Eigen::Vector3d point = state.getGlobalLinkTransform(link).inverse() * contact.pos;
+          if (state.getJacobian(jmg, link, point, jacobian))
+            direction += jacobian.topRows<3>().transpose() * (world_to_root * (sign * contact.depth * contact.normal));
+        };
+        add_escape(contact.body_name_1, contact.body_type_1, -1.0);
+        add_escape(contact.body_name_2, contact.body_type_2, 1.0);
+      }
+    }
+    if (direction.norm() < std::numeric_limits<double>::epsilon())
+      return Eigen::VectorXd();
+    return direction;
+  }
+
+  /** \brief The largest distance a single variable is jiggled by */
+  double getJiggleDistance(const std::vector<const moveit::core::JointModel*>& jmodels) const
+  {
+    double distance = 0.0;
+    for (const moveit::core::JointModel* jmodel : jmodels)
+      distance = std::max(distance, jmodel->getMaximumExtent() * jiggle_fraction_);
+    return distance;
+  }
+
+  /** \brief Higher scores are better: alignment with \e escape_direction if given, otherwise closeness to \e start */
+  static double scoreCandidate(const moveit::core::RobotState& candidate, const moveit::core::RobotState& start,
+                               const moveit::core::JointModelGroup* jmg, const std::vector<double>& start_positions,
+                               const Eigen::VectorXd& escape_direction)
+  {
+    if (escape_direction.size() == 0)
+      return -start.distance(candidate);
+    std::vector<double> positions;
+    candidate.copyJointGroupPositions(jmg, positions);
+    const Eigen::VectorXd delta = Eigen::Map<const Eigen::VectorXd>(positions.data(), positions.size()) -
+                                  Eigen::Map<const Eigen::VectorXd>(start_positions.data(), start_positions.size());
+    const double norm = delta.norm();
+    return norm > 0.0 ? delta.dot(escape_direction) / norm : 0.0;
+  }
+
   rclcpp::Node::SharedPtr node_;
   double max_dt_offset_;
   double jiggle_fraction_;
   int sampling_attempts_;
+  int sampling_batch_size_;
 };
 
 const std::string FixStartStateCollision::DT_PARAM_NAME = "start_state_max_dt";
 const std::string FixStartStateCollision::JIGGLE_PARAM_NAME = "jiggle_fraction";
 const std::string FixStartStateCollision::ATTEMPTS_PARAM_NAME = "max_sampling_attempts";
+const std::string FixStartStateCollision::BATCH_PARAM_NAME = "sampling_batch_size";
 }  // namespace default_planner_request_adapters
 
 CLASS_LOADER_REGISTER_CLASS(default_planner_request_adapters::FixStartStateCollision,
@@ -0,0 +1,100 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/planning_request_adapter/planning_request_adapter.h>
+#include <moveit/trajectory_processing/trajectory_resampling.h>
+#include <class_loader/class_loader.hpp>
+#include <rclcpp/logger.hpp>
+#include <rclcpp/logging.hpp>
+#include <rclcpp/node.hpp>
+
+namespace default_planner_request_adapters
+{
+static const rclcpp::Logger LOGGER = rclcpp::get_logger("moveit_ros.resample_trajectory");
+
+/** @brief Resample the time-parameterized solution at the control period of the controllers.
+ *  Waypoints that lie on the line between their neighbors can be dropped first, within a position tolerance. */
+class ResampleTrajectory : public planning_request_adapter::PlanningRequestAdapter
+{
+public:
+  static const std::string RESAMPLE_PERIOD_PARAM_NAME;
+  static const std::string DECIMATION_TOLERANCE_PARAM_NAME;
+
+  void initialize(const rclcpp::Node::SharedPtr& node, const std::string& parameter_namespace) override
+  {
+    node_ = node;
+    resample_period_ = getParam(node_, LOGGER, parameter_namespace, RESAMPLE_PERIOD_PARAM_NAME, 0.004);
+    decimation_tolerance_ = getParam(node_, LOGGER, parameter_namespace, DECIMATION_TOLERANCE_PARAM_NAME, 0.0);
+  }
+
+  std::string getDescription() const override
+  {
+    return "Resample Trajectory";
+  }
+
+  bool adaptAndPlan(const PlannerFn& planner, const planning_scene::PlanningSceneConstPtr& planning_scene,
+                    const planning_interface::MotionPlanRequest& req, planning_interface::MotionPlanResponse& res,
+                    std::vector<std::size_t>& /*added_path_index*/) const override
+  {
+    bool result = planner(planning_scene, req, res);
+    if (result && res.trajectory_)
+    {
+      RCLCPP_DEBUG(LOGGER, "Running '%s'", getDescription().c_str());
+      if (decimation_tolerance_ > 0.0)
+      {
+        const std::size_t removed = trajectory_processing::decimateTrajectory(*res.trajectory_, decimation_tolerance_);
+        RCLCPP_DEBUG(LOGGER, "Removed %zu waypoints within tolerance %f", removed, decimation_tolerance_);
+      }
+      if (!trajectory_processing::resampleTrajectory(*res.trajectory_, resample_period_))
+      {
+        RCLCPP_WARN(LOGGER, "Resampling the solution path failed.");
+        result = false;
+      }
+    }
+
+    return result;
+  }
+
+private:
+  rclcpp::Node::SharedPtr node_;
+  double resample_period_;
+  double decimation_tolerance_;
+};
+
+const std::string ResampleTrajectory::RESAMPLE_PERIOD_PARAM_NAME = "resample_period";
+const std::string ResampleTrajectory::DECIMATION_TOLERANCE_PARAM_NAME = "decimation_tolerance";
+}  // namespace default_planner_request_adapters
+
+CLASS_LOADER_REGISTER_CLASS(default_planner_request_adapters::ResampleTrajectory,
+                            planning_request_adapter::PlanningRequestAdapter)
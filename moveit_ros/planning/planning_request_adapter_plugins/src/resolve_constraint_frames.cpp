@@ -64,11 +64,16 @@ public:
   {
     RCLCPP_DEBUG(LOGGER, "Running '%s'", getDescription().c_str());
     planning_interface::MotionPlanRequest modified = req;
-    kinematic_constraints::resolveConstraintFrames(planning_scene->getCurrentState(), modified.path_constraints);
+    // frames resolved for earlier requests stay valid as long as the attached bodies do not change
+    const std::uint64_t version = planning_scene->getAttachedBodiesVersion();
+    frame_resolver_.resolve(planning_scene->getCurrentState(), version, modified.path_constraints);
     for (moveit_msgs::msg::Constraints& constraint : modified.goal_constraints)
-      kinematic_constraints::resolveConstraintFrames(planning_scene->getCurrentState(), constraint);
+      frame_resolver_.resolve(planning_scene->getCurrentState(), version, constraint);
     return planner(planning_scene, modified, res);
   }
+
+private:
+  mutable kinematic_constraints::ConstraintFrameResolver frame_resolver_;
 };
 
 }  // namespace default_planner_request_adapters
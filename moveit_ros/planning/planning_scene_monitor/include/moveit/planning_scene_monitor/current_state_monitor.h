@@ -36,6 +36,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <chrono>
 #include <functional>
 #include <string>
@@ -50,6 +51,7 @@
 
 #include <tf2_ros/buffer.h>
 
+#include <moveit/robot_model/joint_name_layout.h>
 #include <moveit/robot_state/robot_state.h>
 
 namespace planning_scene_monitor
@@ -243,9 +245,18 @@ public:
   }
 
   /** @brief Get the current state
+   *
+   *  This and the other getters of the current state read a snapshot that the joint state and TF callbacks publish
+   *  after every update. Readers never block the callbacks, nor each other.
    *  @return Returns the current state */
   moveit::core::RobotStatePtr getCurrentState() const;
 
+  /** @brief Copy the current positions of the variables of \e group into \e positions, ordered as in the group.
+   *
+   *  Only the group's variables are copied, straight out of the snapshot; no RobotState is created and
+   *  \e positions is not reallocated if its capacity suffices. */
+  void getCurrentGroupPositions(const moveit::core::JointModelGroup* group, std::vector<double>& positions) const;
+
   /** @brief Set the state \e upd to the current state maintained by this class. */
   void setToCurrentState(moveit::core::RobotState& upd) const;
 
@@ -260,6 +271,24 @@ public:
    *  @return Returns the map from joint names to joint state values*/
   std::map<std::string, double> getCurrentStateValues() const;
 
+  /** @brief Keep a history of the last \e capacity states, for queries with getStateAtTime().
+   *
+   *  The history is a fixed-capacity ring buffer of timestamped variable positions, filled by the joint state and TF
+   *  callbacks. Readers never block the callbacks, nor each other. Only the first call has an effect. */
+  void enableStateHistory(std::size_t capacity);
+
+  /** @brief Get the positions of all variables at time \e t, interpolated between the two recorded states around it.
+   *  @return false if the history is disabled or does not cover \e t */
+  bool getStateAtTime(const rclcpp::Time& t, std::vector<double>& positions) const;
+
+  /** @brief Set the positions of \e state to the recorded state at time \e t, see getStateAtTime().
+   *  @return false if the history is disabled or does not cover \e t */
+  bool getStateAtTime(const rclcpp::Time& t, moveit::core::RobotState& state) const;
+
+  /** @brief Get the time span covered by the state history
+   *  @return false if the history is disabled or empty */
+  bool getStateHistoryTimeRange(rclcpp::Time& oldest, rclcpp::Time& newest) const;
+
   /** @brief Wait for at most \e wait_time_s seconds (default 1s) for a robot state more recent than t
    *  @return true on success, false if up-to-date robot state wasn't received within \e wait_time_s
    */
@@ -285,6 +314,17 @@ public:
   /** @brief Clear the functions to be called when an update to the joint state is received */
   void clearUpdateCallbacks();
 
+  /** @brief Function called after every state update with the complete state and its time stamp. It runs on the
+   *  updating thread while the state is locked, so it must be quick and must not call back into this monitor. */
+  using StateListenerFn = std::function<void(const moveit::core::RobotState&, const rclcpp::Time&)>;
+
+  /** @brief Add a state listener. Unlike update callbacks, listeners can be added and removed at any time.
+   *  @return An id for removeStateListener() */
+  std::size_t addStateListener(const StateListenerFn& fn) const;
+
+  /** @brief Remove a state listener. Once this returns, the listener is neither running nor called again. */
+  void removeStateListener(std::size_t id) const;
+
   /** @brief When a joint value is received to be out of bounds, it is changed slightly to fit within bounds,
    *  if the difference is less than a specified value (labeled the "allowed bounds error").
    *  This value can be set using this function.
@@ -315,6 +355,51 @@ private:
   bool haveCompleteStateHelper(const rclcpp::Time& oldest_allowed_update_time,
                                std::vector<std::string>* missing_joints) const;
 
+  /** @brief A consistent copy of the variables published in the snapshot */
+  struct SnapshotData
+  {
+    std::vector<double> positions;
+    std::vector<double> velocities;
+    std::vector<double> efforts;
+    bool has_velocities = false;
+    bool has_effort = false;
+    rclcpp::Time time = rclcpp::Time(0, 0, RCL_ROS_TIME);
+  };
+
+  /** @brief Publish the variables of robot_state_ and current_state_time_ to readers. Requires state_update_lock_. */
+  void publishSnapshot();
+
+  /** @brief Read the latest published snapshot into \e data */
+  void readSnapshot(SnapshotData& data) const;
+
+  /** @brief Ring buffer of timestamped variable positions.
+   *
+   *  Entry k is stored in slot k % capacity. The slot's sequence is 2k+1 while entry k is written and 2k+2 once it is
+   *  complete, so a reader can detect both torn reads and slots that were reused for a newer entry. */
+  struct StateHistory
+  {
+    StateHistory(std::size_t capacity, std::size_t variable_count);
+
+    const std::size_t capacity;
+    const std::size_t variable_count;
+    std::atomic<std::uint64_t> count;                         // number of entries ever written
+    std::unique_ptr<std::atomic<std::uint64_t>[]> sequences;  // per slot
+    std::unique_ptr<std::atomic<std::int64_t>[]> times;       // per slot, nanoseconds
+    std::unique_ptr<std::atomic<double>[]> positions;         // variable_count per slot
+  };
+
+  /** @brief Append the positions of robot_state_ to the history. Requires state_update_lock_. */
+  void recordHistory();
+
+  /** @brief Read the time of history entry \e k. Returns false if the entry was overwritten. */
+  bool readHistoryTime(const StateHistory& history, std::uint64_t k, std::int64_t& time) const;
+
+  /** @brief Read the positions of history entry \e k. Returns false if the entry was overwritten. */
+  bool readHistoryPositions(const StateHistory& history, std::uint64_t k, double* positions) const;
+
+  /** @brief Copy the latest published state into \e state */
+  void copySnapshotToState(const SnapshotData& data, moveit::core::RobotState& state, bool copy_dynamics) const;
+
   void jointStateCallback(sensor_msgs::msg::JointState::ConstSharedPtr joint_state);
   void updateMultiDofJoints();
   void transformCallback(const tf2_msgs::msg::TFMessage::ConstSharedPtr msg, const bool is_static);
@@ -324,6 +409,7 @@ private:
   moveit::core::RobotModelConstPtr robot_model_;
   moveit::core::RobotState robot_state_;
   std::map<const moveit::core::JointModel*, rclcpp::Time> joint_time_;
+  moveit::core::JointNameLayout joint_state_layout_;  // of the last joint state message, guarded by state_update_lock_
   bool state_monitor_started_;
   bool copy_dynamics_;  // Copy velocity and effort from joint_state
   rclcpp::Time monitor_start_time_ = rclcpp::Time(0, 0, RCL_ROS_TIME);
@@ -332,7 +418,23 @@ private:
 
   mutable std::mutex state_update_lock_;
   mutable std::condition_variable state_update_condition_;
+
+  /** @brief Seqlock protecting the snapshot: odd while publishSnapshot() writes it.
+   *  Only the callbacks write the snapshot, serialized by state_update_lock_. */
+  std::atomic<std::uint64_t> snapshot_sequence_;
+
+  /** @brief Positions, velocities and efforts of all variables, in this order */
+  std::unique_ptr<std::atomic<double>[]> snapshot_values_;
+  std::atomic<bool> snapshot_has_velocities_;
+  std::atomic<bool> snapshot_has_effort_;
+  std::atomic<std::int64_t> snapshot_time_;  // nanoseconds
+
+  /** @brief Set once by enableStateHistory() and kept until destruction, so readers never see it freed */
+  std::atomic<StateHistory*> state_history_;
+  std::unique_ptr<StateHistory> state_history_storage_;
   std::vector<JointStateUpdateCallback> update_callbacks_;
+  mutable std::map<std::size_t, StateListenerFn> state_listeners_;  // guarded by state_update_lock_
+  mutable std::size_t next_state_listener_id_ = 0;
 
   bool use_sim_time_;
 };
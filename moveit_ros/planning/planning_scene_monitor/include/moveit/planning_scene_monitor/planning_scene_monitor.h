@@ -46,6 +46,9 @@
 #include <moveit/planning_scene_monitor/current_state_monitor.h>
 #include <moveit/collision_plugin_loader/collision_plugin_loader.h>
 #include <moveit_msgs/srv/get_planning_scene.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <memory>
 #include <thread>
 #include <shared_mutex>
@@ -116,6 +119,9 @@ public:
   /// name, so the topic is prefixed by the node name)
   static const std::string MONITORED_PLANNING_SCENE_TOPIC;  // "monitored_planning_scene"
 
+  /// The suffix appended to the name of the planning scene topic to obtain the topic carrying octomap diffs
+  static const std::string OCTOMAP_DIFF_TOPIC_SUFFIX;  // "_octomap_diff"
+
   /** @brief Constructor
    *  @param robot_description The name of the ROS parameter that contains the URDF (in string format)
    *  @param tf_buffer A pointer to a tf2_ros::Buffer
@@ -287,7 +293,58 @@ public:
   /** \brief Stop publishing the maintained planning scene. */
   void stopPublishingPlanningScene();
 
-  /** \brief Set the maximum frequency at which planning scenes are being published */
+  /** \brief When enabled, planning scene diffs no longer carry the complete octomap whenever it changes. Instead, only
+      the leaves modified since the previous message are published as an octree on the planning scene topic with
+      OCTOMAP_DIFF_TOPIC_SUFFIX appended. Full planning scenes still contain the complete octomap. Monitors listening
+      to the planning scene topic via startSceneMonitor() apply these diffs automatically; since the diffs build on
+      each other, late subscribers should request a full scene first. Takes effect the next time publishing is
+      started. */
+  void setOctomapDiffPublishing(bool flag)
+  {
+    publish_octomap_diffs_ = flag;
+  }
+
+  /** \brief Check whether octomap changes are published as diffs (see setOctomapDiffPublishing()) */
+  bool getOctomapDiffPublishing() const
+  {
+    return publish_octomap_diffs_;
+  }
+
+  /** \brief When enabled, changes to the monitored scene publish an immutable copy of it, which LockedPlanningSceneRO
+      hands out instead of locking the scene for reading. Readers then neither wait for writers nor for the
+      serialization of published planning scenes, at the cost of copying the scene after updates. The octomap is shared
+      with the monitored scene and remains protected by its own lock. */
+  void setSceneSnapshots(bool flag);
+
+  /** \brief Check whether read-only access uses scene snapshots (see setSceneSnapshots()) */
+  bool getSceneSnapshots() const
+  {
+    return scene_snapshots_;
+  }
+
+  /** \brief Collect the planning scene, planning scene world, collision object and attached collision object messages
+      received within \e window seconds of the first one, and apply them together under a single write lock. The batch
+      triggers one combined update event, so it is published as one diff. A window of zero applies every message as
+      it arrives, which is the default. */
+  void setSceneUpdateBatchWindow(double window);
+
+  /** \brief Get the window in seconds within which received scene updates are batched (see
+      setSceneUpdateBatchWindow()) */
+  double getSceneUpdateBatchWindow() const
+  {
+    return scene_update_batch_window_.count();
+  }
+
+  /** \brief Get the latest snapshot of the monitored scene, nullptr if snapshots are disabled or none was taken yet.
+      The octomap of the snapshot needs to be locked for reading while it is used. */
+  planning_scene::PlanningSceneConstPtr getPlanningSceneSnapshot() const
+  {
+    return std::atomic_load(&scene_snapshot_);
+  }
+
+  /** \brief Set the maximum frequency at which planning scenes are being published.
+      Diffs that only change the robot state are held back and coalesced until the period has passed. Updates of the
+      geometry, the transforms or the full scene are published right away and include the pending state changes. */
   void setPlanningScenePublishingFrequency(double hz);
 
   /** \brief Get the maximum frequency at which planning scenes are published (Hz) */
@@ -296,6 +353,45 @@ public:
     return publish_planning_scene_frequency_;
   }
 
+  /** \brief Limit the bandwidth in bytes per second used for publishing octomaps in planning scene diffs, 0 for no
+      limit. After an octomap (or octomap diff) of n bytes was published to k subscribers, the next one is held back for
+      n * k / bandwidth seconds, and the octomap is not published at all while nobody subscribes. Other changes are
+      published in the meantime. Full planning scenes always contain the octomap. */
+  void setOctomapPublishingBandwidth(double bytes_per_second)
+  {
+    octomap_publish_bandwidth_ = bytes_per_second;
+  }
+
+  /** \brief Get the bandwidth limit for publishing octomaps (see setOctomapPublishingBandwidth()) */
+  double getOctomapPublishingBandwidth() const
+  {
+    return octomap_publish_bandwidth_;
+  }
+
+  /** \brief Statistics of publishing the maintained planning scene */
+  struct ScenePublishingStatistics
+  {
+    /// number of scene update events not published yet
+    std::size_t pending_updates = 0;
+    /// number of published scene messages
+    std::size_t published_messages = 0;
+    /// number of scene update events coalesced into the published messages
+    std::size_t published_updates = 0;
+    /// time from the oldest update event in the last published message until it was published
+    std::chrono::duration<double> last_publish_latency{ 0.0 };
+    /// largest publish latency so far
+    std::chrono::duration<double> max_publish_latency{ 0.0 };
+    /// whether an octomap change is held back by the bandwidth limit
+    bool octomap_deferred = false;
+  };
+
+  /** \brief Get the statistics of publishing the maintained planning scene, for diagnostics */
+  ScenePublishingStatistics getScenePublishingStatistics() const
+  {
+    std::scoped_lock lock(publish_statistics_mutex_);
+    return publish_statistics_;
+  }
+
   /** @brief Get the stored instance of the stored current state monitor
    *  @return An instance of the stored current state monitor*/
   const CurrentStateMonitorPtr& getStateMonitor() const
@@ -438,12 +534,31 @@ protected:
    */
   void unlockSceneWrite();
 
+  /** \brief Get an up-to-date snapshot of the scene and lock its octomap for reading. If snapshots are disabled, the
+      scene is locked for reading (see lockSceneRead()) and nullptr is returned */
+  planning_scene::PlanningSceneConstPtr lockSceneSnapshotRead();
+
+  /** \brief Unlock the octomap of a snapshot obtained from lockSceneSnapshotRead() */
+  void unlockSceneSnapshotRead();
+
+  /** \brief Replace the scene snapshot by a copy of the scene if it is outdated. If \e wait is false, the update is
+      skipped when the scene is locked, leaving it to the next reader */
+  void updateSceneSnapshot(bool wait);
+
   /** @brief Configure the collision matrix for a particular scene */
   void configureCollisionMatrix(const planning_scene::PlanningScenePtr& scene);
 
   /** @brief Configure the default padding*/
   void configureDefaultPadding();
 
+  /** @brief Apply \e update to the locked scene, or queue it if updates are batched. \e update returns the type of the
+   *  change it made, UPDATE_NONE for no change. If \e update_frame_transforms is true, the frame transforms are
+   *  refreshed before \e update is applied */
+  void applySceneUpdate(const std::function<SceneUpdateType()>& update, bool update_frame_transforms);
+
+  /** @brief Apply all queued scene updates under one write lock and trigger one combined update event */
+  void flushSceneUpdates();
+
   /** @brief Callback for a new collision object msg*/
   void collisionObjectCallback(moveit_msgs::msg::CollisionObject::SharedPtr obj);
 
@@ -479,6 +594,10 @@ protected:
   bool getShapeTransformCache(const std::string& target_frame, const rclcpp::Time& target_time,
                               occupancy_map_monitor::ShapeTransformCache& cache) const;
 
+  /** @brief Fill the shape transform cache from link_transform_cache_; returns false if tf2 needs to be queried */
+  bool getCachedShapeTransforms(const std::string& target_frame, const rclcpp::Time& target_time,
+                                occupancy_map_monitor::ShapeTransformCache& cache) const;
+
   /// The name of this scene monitor
   std::string monitor_name_;
 
@@ -523,9 +642,30 @@ protected:
   SceneUpdateType publish_update_types_;
   std::atomic<SceneUpdateType> new_scene_update_;
   std::condition_variable_any new_scene_update_condition_;
+  rclcpp::Publisher<octomap_msgs::msg::OctomapWithPose>::SharedPtr octomap_diff_publisher_;
+  bool publish_octomap_diffs_;
+  std::atomic<double> octomap_publish_bandwidth_;  /// bytes per second, 0 if unlimited
+  mutable std::mutex publish_statistics_mutex_;
+  ScenePublishingStatistics publish_statistics_;
+  std::chrono::steady_clock::time_point oldest_pending_update_time_;  /// protected by publish_statistics_mutex_
+
+  // immutable copy of scene_ for readers, accessed through std::atomic_load / std::atomic_store
+  planning_scene::PlanningSceneConstPtr scene_snapshot_;
+  std::mutex scene_snapshot_mutex_;                    /// serializes snapshot updates
+  std::atomic<bool> scene_snapshots_;                  /// true if LockedPlanningSceneRO uses scene_snapshot_
+  std::atomic<std::uint64_t> scene_version_;           /// incremented on every change of scene_
+  std::atomic<std::uint64_t> scene_snapshot_version_;  /// value of scene_version_ when scene_snapshot_ was taken
+
+  // received scene updates that wait to be applied together, protected by scene_update_queue_mutex_
+  std::mutex scene_update_queue_mutex_;
+  std::vector<std::function<SceneUpdateType()> > scene_update_queue_;
+  bool scene_update_queue_needs_transforms_;
+  std::chrono::duration<double> scene_update_batch_window_;
+  rclcpp::TimerBase::SharedPtr scene_update_batch_timer_;  /// flushes the queue once the batch window has passed
 
   // subscribe to various sources of data
   rclcpp::Subscription<moveit_msgs::msg::PlanningScene>::SharedPtr planning_scene_subscriber_;
+  rclcpp::Subscription<octomap_msgs::msg::OctomapWithPose>::SharedPtr octomap_diff_subscriber_;
   rclcpp::Subscription<moveit_msgs::msg::PlanningSceneWorld>::SharedPtr planning_scene_world_subscriber_;
 
   rclcpp::Subscription<moveit_msgs::msg::AttachedCollisionObject>::SharedPtr attached_collision_object_subscriber_;
@@ -538,6 +678,10 @@ protected:
   // include a octomap monitor
   std::unique_ptr<occupancy_map_monitor::OccupancyMapMonitor> octomap_monitor_;
 
+  // timestamped link poses computed from joint states, shared with the octomap updaters
+  // (accessed through std::atomic_load / std::atomic_store, as it is set after the state monitor may have started)
+  occupancy_map_monitor::LinkTransformCachePtr link_transform_cache_;
+
   // include a current state monitor
   CurrentStateMonitorPtr current_state_monitor_;
 
@@ -565,15 +709,35 @@ private:
   // publish planning scene update diffs (runs in its own thread)
   void scenePublishingThread();
 
+  // move the octomap changes tracked since the last published scene from \e octomap into \e diff; the monitored octree
+  // must be locked for reading. Returns false if the full octomap needs to be sent
+  bool getOctomapDiffMsg(const planning_scene::PlanningScene& scene, octomap_msgs::msg::OctomapWithPose& diff,
+                         octomap_msgs::msg::OctomapWithPose& octomap);
+
+  // forget the tracked octomap changes after a full planning scene was built; the monitored octree must be locked
+  void discardOctomapChanges();
+
   // called by current_state_monitor_ when robot state (as monitored on joint state topic) changes
   void onStateUpdate(const sensor_msgs::msg::JointState::ConstSharedPtr& joint_state);
 
+  // push the link poses for a joint state message into link_transform_cache_
+  void updateLinkTransformCache(const sensor_msgs::msg::JointState& joint_state);
+
+  // create link_transform_cache_ for the robot model, relative to the model frame if the robot is fixed to it
+  occupancy_map_monitor::LinkTransformCachePtr createLinkTransformCache() const;
+
   // called by state_update_timer_ when a state update it pending
   void stateUpdateTimerCallback();
 
   // Callback for a new planning scene msg
   void newPlanningSceneCallback(const moveit_msgs::msg::PlanningScene::SharedPtr scene);
 
+  // Apply a planning scene msg to the scene, which must be locked for writing. Returns the type of the update
+  SceneUpdateType applyPlanningSceneMessage(const moveit_msgs::msg::PlanningScene& scene, bool& result);
+
+  // Callback for the changed octomap leaves published along with planning scene diffs
+  void octomapDiffCallback(const octomap_msgs::msg::OctomapWithPose::ConstSharedPtr& msg);
+
   // Callback for requesting the full planning scene via service
   void getPlanningSceneServiceCallback(moveit_msgs::srv::GetPlanningScene::Request::SharedPtr req,
                                        moveit_msgs::srv::GetPlanningScene::Response::SharedPtr res);
@@ -607,6 +771,14 @@ private:
   // Only access this from callback functions (and constructor)
   std::chrono::system_clock::time_point last_robot_state_update_wall_time_;
 
+  /// State used to compute the poses pushed into link_transform_cache_
+  // Only access this from onStateUpdate()
+  moveit::core::RobotStatePtr link_transform_cache_state_;
+  EigenSTL::vector_Isometry3d link_transform_cache_poses_;
+
+  /// Poses read from link_transform_cache_, protected by shape_handles_lock_
+  mutable EigenSTL::vector_Isometry3d link_transform_cache_lookup_;
+
   robot_model_loader::RobotModelLoaderPtr rm_loader_;
   moveit::core::RobotModelConstPtr robot_model_;
 
@@ -662,12 +834,12 @@ public:
 
   operator const planning_scene::PlanningSceneConstPtr&() const
   {
-    return static_cast<const PlanningSceneMonitor*>(planning_scene_monitor_.get())->getPlanningScene();
+    return getLockedScene();
   }
 
   const planning_scene::PlanningSceneConstPtr& operator->() const
   {
-    return static_cast<const PlanningSceneMonitor*>(planning_scene_monitor_.get())->getPlanningScene();
+    return getLockedScene();
   }
 
 protected:
@@ -683,6 +855,14 @@ protected:
       lock_ = std::make_shared<SingleUnlock>(planning_scene_monitor_.get(), read_only);
   }
 
+  // the scene snapshot if one was locked, the monitored scene otherwise
+  const planning_scene::PlanningSceneConstPtr& getLockedScene() const
+  {
+    if (lock_ && lock_->scene_snapshot_)
+      return lock_->scene_snapshot_;
+    return static_cast<const PlanningSceneMonitor*>(planning_scene_monitor_.get())->getPlanningScene();
+  }
+
   MOVEIT_STRUCT_FORWARD(SingleUnlock);
 
   // we use this struct so that lock/unlock are called only once
@@ -693,19 +873,22 @@ protected:
       : planning_scene_monitor_(planning_scene_monitor), read_only_(read_only)
     {
       if (read_only)
-        planning_scene_monitor_->lockSceneRead();
+        scene_snapshot_ = planning_scene_monitor_->lockSceneSnapshotRead();
       else
         planning_scene_monitor_->lockSceneWrite();
     }
     ~SingleUnlock()
     {
-      if (read_only_)
+      if (scene_snapshot_)
+        planning_scene_monitor_->unlockSceneSnapshotRead();
+      else if (read_only_)
         planning_scene_monitor_->unlockSceneRead();
       else
         planning_scene_monitor_->unlockSceneWrite();
     }
     PlanningSceneMonitor* planning_scene_monitor_;
     bool read_only_;
+    planning_scene::PlanningSceneConstPtr scene_snapshot_;
   };
 
   PlanningSceneMonitorPtr planning_scene_monitor_;
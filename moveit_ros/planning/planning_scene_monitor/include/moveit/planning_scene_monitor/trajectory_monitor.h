@@ -43,6 +43,8 @@
 #include <rclcpp/time.hpp>
 #include <memory>
 #include <functional>
+#include <mutex>
+#include <optional>
 #include <thread>
 
 namespace planning_scene_monitor
@@ -108,15 +110,25 @@ public:
 
   void setSamplingFrequency(double sampling_frequency);
 
+  /** @brief Record compactly instead of polling at the sampling frequency.
+   *
+   *  Every state update of the current state monitor appends only its positions and time stamp to a buffer
+   *  preallocated for \e capacity states (it grows if needed). The buffer is converted to waypoints of the
+   *  trajectory when the trajectory is requested, which is also when the state add callback is called.
+   *  Takes effect on the next startTrajectoryMonitor(). A capacity of zero selects polling. */
+  void setCompactRecording(std::size_t capacity);
+
   /// Return the current maintained trajectory. This function is not thread safe (hence NOT const), because the
   /// trajectory could be modified.
   const robot_trajectory::RobotTrajectory& getTrajectory()
   {
+    flushCompactRecording();
     return trajectory_;
   }
 
   void swapTrajectory(robot_trajectory::RobotTrajectory& other)
   {
+    flushCompactRecording();
     trajectory_.swap(other);
   }
 
@@ -128,6 +140,12 @@ public:
 private:
   void recordStates();
 
+  /// Append a state update to the compact buffer
+  void recordCompactState(const moveit::core::RobotState& state, const rclcpp::Time& time);
+
+  /// Convert the states in the compact buffer to waypoints of trajectory_
+  void flushCompactRecording();
+
   // Samples robot states.
   CurrentStateMonitorConstPtr current_state_monitor_;
   // Interface for communicating with ROS.
@@ -140,5 +158,12 @@ private:
 
   std::unique_ptr<std::thread> record_states_thread_;
   TrajectoryStateAddedCallback state_add_callback_;
+
+  // compact recording: variable positions of each state, back to back, and the state's time stamps
+  std::size_t compact_capacity_;
+  std::optional<std::size_t> state_listener_id_;
+  std::mutex compact_mutex_;
+  std::vector<double> compact_positions_;
+  std::vector<rclcpp::Time> compact_times_;
 };
 }  // namespace planning_scene_monitor
@@ -51,6 +51,7 @@
 #include <chrono>
 #include <limits>
 #include <memory>
+#include <thread>
 
 namespace planning_scene_monitor
 {
@@ -68,12 +69,21 @@ CurrentStateMonitor::CurrentStateMonitor(std::unique_ptr<CurrentStateMonitor::Mi
   , tf_buffer_(tf_buffer)
   , robot_model_(robot_model)
   , robot_state_(robot_model)
+  , joint_state_layout_(robot_model)
   , state_monitor_started_(false)
   , copy_dynamics_(false)
   , error_(std::numeric_limits<double>::epsilon())
+  , snapshot_sequence_(0)
+  , snapshot_values_(new std::atomic<double>[3 * robot_model->getVariableCount()])
+  , snapshot_has_velocities_(false)
+  , snapshot_has_effort_(false)
+  , snapshot_time_(0)
+  , state_history_(nullptr)
   , use_sim_time_(use_sim_time)
 {
   robot_state_.setToDefaultValues();
+  std::unique_lock<std::mutex> slock(state_update_lock_);
+  publishSnapshot();
 }
 
 CurrentStateMonitor::CurrentStateMonitor(const rclcpp::Node::SharedPtr& node,
@@ -89,62 +99,319 @@ CurrentStateMonitor::~CurrentStateMonitor()
   stopStateMonitor();
 }
 
-moveit::core::RobotStatePtr CurrentStateMonitor::getCurrentState() const
+void CurrentStateMonitor::publishSnapshot()
 {
-  std::unique_lock<std::mutex> slock(state_update_lock_);
-  moveit::core::RobotState* result = new moveit::core::RobotState(robot_state_);
-  return moveit::core::RobotStatePtr(result);
+  const std::size_t n = robot_model_->getVariableCount();
+  const std::uint64_t sequence = snapshot_sequence_.load(std::memory_order_relaxed);
+  snapshot_sequence_.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  const double* pos = robot_state_.getVariablePositions();
+  for (std::size_t i = 0; i < n; ++i)
+    snapshot_values_[i].store(pos[i], std::memory_order_relaxed);
+  snapshot_has_velocities_.store(robot_state_.hasVelocities(), std::memory_order_relaxed);
+  if (robot_state_.hasVelocities())
+  {
+    const double* vel = robot_state_.getVariableVelocities();
+    for (std::size_t i = 0; i < n; ++i)
+      snapshot_values_[n + i].store(vel[i], std::memory_order_relaxed);
+  }
+  snapshot_has_effort_.store(robot_state_.hasEffort(), std::memory_order_relaxed);
+  if (robot_state_.hasEffort())
+  {
+    const double* eff = robot_state_.getVariableEffort();
+    for (std::size_t i = 0; i < n; ++i)
+      snapshot_values_[2 * n + i].store(eff[i], std::memory_order_relaxed);
+  }
+  snapshot_time_.store(current_state_time_.nanoseconds(), std::memory_order_relaxed);
+
+  snapshot_sequence_.store(sequence + 2, std::memory_order_release);
+
+  recordHistory();
+  for (const std::pair<const std::size_t, StateListenerFn>& listener : state_listeners_)
+    listener.second(robot_state_, current_state_time_);
 }
 
-rclcpp::Time CurrentStateMonitor::getCurrentStateTime() const
+CurrentStateMonitor::StateHistory::StateHistory(std::size_t capacity, std::size_t variable_count)
+  : capacity(capacity)
+  , variable_count(variable_count)
+  , count(0)
+  , sequences(new std::atomic<std::uint64_t>[capacity])
+  , times(new std::atomic<std::int64_t>[capacity])
+  , positions(new std::atomic<double>[capacity * variable_count])
 {
-  std::unique_lock<std::mutex> slock(state_update_lock_);
-  return current_state_time_;
+  for (std::size_t i = 0; i < capacity; ++i)
+    sequences[i].store(0, std::memory_order_relaxed);
 }
 
-std::pair<moveit::core::RobotStatePtr, rclcpp::Time> CurrentStateMonitor::getCurrentStateAndTime() const
+void CurrentStateMonitor::enableStateHistory(std::size_t capacity)
 {
   std::unique_lock<std::mutex> slock(state_update_lock_);
-  moveit::core::RobotState* result = new moveit::core::RobotState(robot_state_);
-  return std::make_pair(moveit::core::RobotStatePtr(result), current_state_time_);
+  if (state_history_storage_)
+  {
+    if (state_history_storage_->capacity != capacity)
+      RCLCPP_WARN(LOGGER, "The state history is already enabled with a capacity of %zu states",
+                  state_history_storage_->capacity);
+    return;
+  }
+  if (capacity < 2)
+  {
+    RCLCPP_ERROR(LOGGER, "The state history needs a capacity of at least 2 states");
+    return;
+  }
+  state_history_storage_ = std::make_unique<StateHistory>(capacity, robot_model_->getVariableCount());
+  state_history_.store(state_history_storage_.get(), std::memory_order_release);
 }
 
-std::map<std::string, double> CurrentStateMonitor::getCurrentStateValues() const
+void CurrentStateMonitor::recordHistory()
 {
-  std::map<std::string, double> m;
-  std::unique_lock<std::mutex> slock(state_update_lock_);
+  StateHistory* history = state_history_.load(std::memory_order_relaxed);
+  if (!history)
+    return;
+
+  // lookups bisect on time, so the history must be sorted; stamps from the past are not recorded
+  const std::int64_t time = current_state_time_.nanoseconds();
+  const std::uint64_t k = history->count.load(std::memory_order_relaxed);
+  if (k > 0 && time < history->times[(k - 1) % history->capacity].load(std::memory_order_relaxed))
+    return;
+
+  const std::size_t slot = k % history->capacity;
+  history->sequences[slot].store(2 * k + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  history->times[slot].store(time, std::memory_order_relaxed);
   const double* pos = robot_state_.getVariablePositions();
-  const std::vector<std::string>& names = robot_state_.getVariableNames();
-  for (std::size_t i = 0; i < names.size(); ++i)
-    m[names[i]] = pos[i];
-  return m;
+  std::atomic<double>* values = &history->positions[slot * history->variable_count];
+  for (std::size_t i = 0; i < history->variable_count; ++i)
+    values[i].store(pos[i], std::memory_order_relaxed);
+
+  history->sequences[slot].store(2 * k + 2, std::memory_order_release);
+  history->count.store(k + 1, std::memory_order_release);
 }
 
-void CurrentStateMonitor::setToCurrentState(moveit::core::RobotState& upd) const
+bool CurrentStateMonitor::readHistoryTime(const StateHistory& history, std::uint64_t k, std::int64_t& time) const
 {
-  std::unique_lock<std::mutex> slock(state_update_lock_);
-  const double* pos = robot_state_.getVariablePositions();
-  upd.setVariablePositions(pos);
-  if (copy_dynamics_)
+  const std::size_t slot = k % history.capacity;
+  if (history.sequences[slot].load(std::memory_order_acquire) != 2 * k + 2)
+    return false;
+  time = history.times[slot].load(std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return history.sequences[slot].load(std::memory_order_relaxed) == 2 * k + 2;
+}
+
+bool CurrentStateMonitor::readHistoryPositions(const StateHistory& history, std::uint64_t k, double* positions) const
+{
+  const std::size_t slot = k % history.capacity;
+  if (history.sequences[slot].load(std::memory_order_acquire) != 2 * k + 2)
+    return false;
+  const std::atomic<double>* values = &history.positions[slot * history.variable_count];
+  for (std::size_t i = 0; i < history.variable_count; ++i)
+    positions[i] = values[i].load(std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return history.sequences[slot].load(std::memory_order_relaxed) == 2 * k + 2;
+}
+
+bool CurrentStateMonitor::getStateHistoryTimeRange(rclcpp::Time& oldest, rclcpp::Time& newest) const
+{
+  const StateHistory* history = state_history_.load(std::memory_order_acquire);
+  if (!history)
+    return false;
+  while (true)
+  {
+    const std::uint64_t count = history->count.load(std::memory_order_acquire);
+    if (count == 0)
+      return false;
+    const std::uint64_t first = count > history->capacity ? count - history->capacity : 0;
+    std::int64_t oldest_time, newest_time;
+    if (readHistoryTime(*history, first, oldest_time) && readHistoryTime(*history, count - 1, newest_time))
+    {
+      oldest = rclcpp::Time(oldest_time, RCL_ROS_TIME);
+      newest = rclcpp::Time(newest_time, RCL_ROS_TIME);
+      return true;
+    }
+  }
+}
+
+bool CurrentStateMonitor::getStateAtTime(const rclcpp::Time& t, std::vector<double>& positions) const
+{
+  const StateHistory* history = state_history_.load(std::memory_order_acquire);
+  if (!history)
+    return false;
+
+  const std::int64_t query = t.nanoseconds();
+  // reuse the buffers, so repeated calls from the same thread do not allocate
+  thread_local std::vector<double> before, after;
+  before.resize(history->variable_count);
+  after.resize(history->variable_count);
+
+  // retry whenever the writer overwrote an entry while we were reading it
+  while (true)
+  {
+    const std::uint64_t count = history->count.load(std::memory_order_acquire);
+    if (count == 0)
+      return false;
+    std::uint64_t lo = count > history->capacity ? count - history->capacity : 0;
+    std::uint64_t hi = count - 1;
+
+    std::int64_t lo_time, hi_time;
+    if (!readHistoryTime(*history, lo, lo_time) || !readHistoryTime(*history, hi, hi_time))
+      continue;
+    if (query < lo_time || query > hi_time)
+      return false;
+
+    // find the last entry at or before the query time
+    bool overwritten = false;
+    while (lo < hi)
+    {
+      const std::uint64_t mid = lo + (hi - lo + 1) / 2;
+      std::int64_t mid_time;
+      if (!readHistoryTime(*history, mid, mid_time))
+      {
+        overwritten = true;
+        break;
+      }
+      if (mid_time <= query)
+        lo = mid;
+      else
+        hi = mid - 1;
+    }
+    std::int64_t before_time, after_time;
+    if (overwritten || !readHistoryTime(*history, lo, before_time) ||
+        !readHistoryPositions(*history, lo, before.data()))
+      continue;
+    if (before_time == query || lo + 1 >= count)
+    {
+      positions = before;
+      return true;
+    }
+    if (!readHistoryTime(*history, lo + 1, after_time) || !readHistoryPositions(*history, lo + 1, after.data()))
+      continue;
+
+    positions.resize(history->variable_count);
+    const double fraction = static_cast<double>(query - before_time) / static_cast<double>(after_time - before_time);
+    robot_model_->interpolate(before.data(), after.data(), fraction, positions.data());
+    return true;
+  }
+}
+
+bool CurrentStateMonitor::getStateAtTime(const rclcpp::Time& t, moveit::core::RobotState& state) const
+{
+  thread_local std::vector<double> positions;
+  if (!getStateAtTime(t, positions))
+    return false;
+  state.setVariablePositions(positions);
+  return true;
+}
+
+void CurrentStateMonitor::readSnapshot(SnapshotData& data) const
+{
+  const std::size_t n = robot_model_->getVariableCount();
+  data.positions.resize(n);
+  data.velocities.resize(n);
+  data.efforts.resize(n);
+  while (true)
   {
-    if (robot_state_.hasVelocities())
+    const std::uint64_t sequence = snapshot_sequence_.load(std::memory_order_acquire);
+    if (sequence & 1)
     {
-      const double* vel = robot_state_.getVariableVelocities();
-      upd.setVariableVelocities(vel);
+      std::this_thread::yield();
+      continue;
     }
-    if (robot_state_.hasAccelerations())
+
+    for (std::size_t i = 0; i < n; ++i)
+      data.positions[i] = snapshot_values_[i].load(std::memory_order_relaxed);
+    data.has_velocities = snapshot_has_velocities_.load(std::memory_order_relaxed);
+    if (data.has_velocities)
+      for (std::size_t i = 0; i < n; ++i)
+        data.velocities[i] = snapshot_values_[n + i].load(std::memory_order_relaxed);
+    data.has_effort = snapshot_has_effort_.load(std::memory_order_relaxed);
+    if (data.has_effort)
+      for (std::size_t i = 0; i < n; ++i)
+        data.efforts[i] = snapshot_values_[2 * n + i].load(std::memory_order_relaxed);
+    const std::int64_t time = snapshot_time_.load(std::memory_order_relaxed);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (snapshot_sequence_.load(std::memory_order_relaxed) == sequence)
     {
-      const double* acc = robot_state_.getVariableAccelerations();
-      upd.setVariableAccelerations(acc);
+      data.time = rclcpp::Time(time, RCL_ROS_TIME);
+      return;
     }
-    if (robot_state_.hasEffort())
+  }
+}
+
+void CurrentStateMonitor::copySnapshotToState(const SnapshotData& data, moveit::core::RobotState& state,
+                                              bool copy_dynamics) const
+{
+  state.setVariablePositions(data.positions);
+  if (copy_dynamics)
+  {
+    if (data.has_velocities)
+      state.setVariableVelocities(data.velocities.data());
+    if (data.has_effort)
+      state.setVariableEffort(data.efforts.data());
+  }
+}
+
+moveit::core::RobotStatePtr CurrentStateMonitor::getCurrentState() const
+{
+  return getCurrentStateAndTime().first;
+}
+
+void CurrentStateMonitor::getCurrentGroupPositions(const moveit::core::JointModelGroup* group,
+                                                   std::vector<double>& positions) const
+{
+  const std::vector<int>& indices = group->getVariableIndexList();
+  positions.resize(indices.size());
+  while (true)
+  {
+    const std::uint64_t sequence = snapshot_sequence_.load(std::memory_order_acquire);
+    if (sequence & 1)
     {
-      const double* eff = robot_state_.getVariableEffort();
-      upd.setVariableEffort(eff);
+      std::this_thread::yield();
+      continue;
     }
+    for (std::size_t i = 0; i < indices.size(); ++i)
+      positions[i] = snapshot_values_[indices[i]].load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (snapshot_sequence_.load(std::memory_order_relaxed) == sequence)
+      return;
   }
 }
 
+rclcpp::Time CurrentStateMonitor::getCurrentStateTime() const
+{
+  return rclcpp::Time(snapshot_time_.load(std::memory_order_acquire), RCL_ROS_TIME);
+}
+
+std::pair<moveit::core::RobotStatePtr, rclcpp::Time> CurrentStateMonitor::getCurrentStateAndTime() const
+{
+  SnapshotData data;
+  readSnapshot(data);
+  auto result = std::make_shared<moveit::core::RobotState>(robot_model_);
+  // the monitored state always carries the dynamics it received, regardless of copy_dynamics_
+  copySnapshotToState(data, *result, true);
+  return std::make_pair(result, data.time);
+}
+
+std::map<std::string, double> CurrentStateMonitor::getCurrentStateValues() const
+{
+  std::map<std::string, double> m;
+  SnapshotData data;
+  readSnapshot(data);
+  const std::vector<std::string>& names = robot_model_->getVariableNames();
+  for (std::size_t i = 0; i < names.size(); ++i)
+    m[names[i]] = data.positions[i];
+  return m;
+}
+
+void CurrentStateMonitor::setToCurrentState(moveit::core::RobotState& upd) const
+{
+  // reuse the buffers, so repeated calls from the same thread do not allocate
+  thread_local SnapshotData data;
+  readSnapshot(data);
+  copySnapshotToState(data, upd, copy_dynamics_);
+}
+
 void CurrentStateMonitor::addUpdateCallback(const JointStateUpdateCallback& fn)
 {
   if (fn)
@@ -156,6 +423,20 @@ void CurrentStateMonitor::clearUpdateCallbacks()
   update_callbacks_.clear();
 }
 
+std::size_t CurrentStateMonitor::addStateListener(const StateListenerFn& fn) const
+{
+  std::unique_lock<std::mutex> slock(state_update_lock_);
+  const std::size_t id = next_state_listener_id_++;
+  state_listeners_.emplace(id, fn);
+  return id;
+}
+
+void CurrentStateMonitor::removeStateListener(std::size_t id) const
+{
+  std::unique_lock<std::mutex> slock(state_update_lock_);
+  state_listeners_.erase(id);
+}
+
 void CurrentStateMonitor::startStateMonitor(const std::string& joint_states_topic)
 {
   if (!state_monitor_started_ && robot_model_)
@@ -334,9 +615,18 @@ void CurrentStateMonitor::jointStateCallback(sensor_msgs::msg::JointState::Const
     // read the received values, and update their time stamps
     std::size_t n = joint_state->name.size();
     current_state_time_ = joint_state->header.stamp;
+    // publishers repeat the same joint names, so they are only looked up when they change
+    const std::vector<const moveit::core::JointModel*>& joint_models = joint_state_layout_.getJointModels();
+    if (joint_state_layout_.update(joint_state->name))
+    {
+      for (std::size_t i = 0; i < n; ++i)
+        if (!joint_models[i])
+          RCLCPP_ERROR(LOGGER, "Joint '%s' not found in model '%s'", joint_state->name[i].c_str(),
+                       robot_model_->getName().c_str());
+    }
     for (std::size_t i = 0; i < n; ++i)
     {
-      const moveit::core::JointModel* jm = robot_model_->getJointModel(joint_state->name[i]);
+      const moveit::core::JointModel* jm = joint_models[i];
       if (!jm)
         continue;
       // ignore fixed joints, multi-dof joints (they should not even be in the message)
@@ -386,6 +676,7 @@ void CurrentStateMonitor::jointStateCallback(sensor_msgs::msg::JointState::Const
         }
       }
     }
+    publishSnapshot();
   }
 
   // callbacks, if needed
@@ -453,6 +744,8 @@ void CurrentStateMonitor::updateMultiDofJoints()
       robot_state_.setJointPositions(joint, new_values.data());
       update = true;
     }
+    if (update)
+      publishSnapshot();
   }
 
   // callbacks, if needed
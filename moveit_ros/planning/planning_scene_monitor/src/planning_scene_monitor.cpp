@@ -37,8 +37,10 @@
 #include <moveit/planning_scene_monitor/planning_scene_monitor.h>
 #include <moveit/robot_model_loader/robot_model_loader.h>
 #include <moveit/utils/message_checks.h>
+#include <moveit/utils/tracing.h>
 #include <moveit/exceptions/exceptions.h>
 #include <moveit_msgs/srv/get_planning_scene.hpp>
+#include <octomap_msgs/conversions.h>
 
 #include <tf2/exceptions.h>
 #include <tf2/LinearMath/Transform.h>
@@ -55,6 +57,7 @@
 
 #include <boost/algorithm/string/join.hpp>
 #include <memory>
+#include <algorithm>
 
 #include <std_msgs/msg/string.hpp>
 
@@ -72,6 +75,7 @@ const std::string PlanningSceneMonitor::DEFAULT_PLANNING_SCENE_WORLD_TOPIC = "pl
 const std::string PlanningSceneMonitor::DEFAULT_PLANNING_SCENE_TOPIC = "planning_scene";
 const std::string PlanningSceneMonitor::DEFAULT_PLANNING_SCENE_SERVICE = "get_planning_scene";
 const std::string PlanningSceneMonitor::MONITORED_PLANNING_SCENE_TOPIC = "monitored_planning_scene";
+const std::string PlanningSceneMonitor::OCTOMAP_DIFF_TOPIC_SUFFIX = "_octomap_diff";
 
 PlanningSceneMonitor::PlanningSceneMonitor(const rclcpp::Node::SharedPtr& node, const std::string& robot_description,
                                            const std::string& name)
@@ -206,6 +210,13 @@ void PlanningSceneMonitor::initialize(const planning_scene::PlanningScenePtr& sc
   }
 
   publish_planning_scene_frequency_ = 2.0;
+  publish_octomap_diffs_ = false;
+  octomap_publish_bandwidth_ = 0.0;
+  scene_snapshots_ = false;
+  scene_version_ = 0;
+  scene_snapshot_version_ = 0;
+  scene_update_queue_needs_transforms_ = false;
+  scene_update_batch_window_ = std::chrono::duration<double>(0.0);
   new_scene_update_ = UPDATE_NONE;
 
   last_update_time_ = last_robot_motion_time_ = rclcpp::Clock().now();
@@ -250,6 +261,16 @@ void PlanningSceneMonitor::initialize(const planning_scene::PlanningScenePtr& sc
         "publish_transforms_updates", false, "Set to True to publish transform updates of the planning scene");
     double publish_planning_scene_hz = declare_parameter(
         "publish_planning_scene_hz", 4.0, "Set the maximum frequency at which planning scene updates are published");
+    publish_octomap_diffs_ = declare_parameter("publish_octomap_diffs", false,
+                                               "Set to True to publish only the changed octomap leaves with diffs");
+    setOctomapPublishingBandwidth(declare_parameter("octomap_publish_bandwidth", 0.0,
+                                                    "Set the bandwidth in bytes per second used for publishing "
+                                                    "octomaps in planning scene diffs, 0 for no limit"));
+    setSceneSnapshots(declare_parameter("use_scene_snapshots", false,
+                                        "Set to True to let read-only scene access use immutable scene snapshots"));
+    setSceneUpdateBatchWindow(declare_parameter("scene_update_batch_window", 0.0,
+                                                "Set the time in seconds within which received scene updates are "
+                                                "applied together, 0 to apply every update on arrival"));
     updatePublishSettings(publish_geometry_updates, publish_state_updates, publish_transform_updates,
                           publish_planning_scene, publish_planning_scene_hz);
   }
@@ -375,6 +396,12 @@ void PlanningSceneMonitor::stopPublishingPlanningScene()
     copy->join();
     monitorDiffs(false);
     planning_scene_publisher_.reset();
+    if (octomap_diff_publisher_)
+    {
+      octomap_diff_publisher_.reset();
+      if (octomap_monitor_)
+        octomap_monitor_->setChangeTracking(false);
+    }
     RCLCPP_INFO(LOGGER, "Stopped publishing maintained planning scene.");
   }
 }
@@ -387,6 +414,15 @@ void PlanningSceneMonitor::startPublishingPlanningScene(SceneUpdateType update_t
   {
     planning_scene_publisher_ = pnode_->create_publisher<moveit_msgs::msg::PlanningScene>(planning_scene_topic, 100);
     RCLCPP_INFO(LOGGER, "Publishing maintained planning scene on '%s'", planning_scene_topic.c_str());
+    if (publish_octomap_diffs_)
+    {
+      const std::string octomap_diff_topic = planning_scene_topic + OCTOMAP_DIFF_TOPIC_SUFFIX;
+      octomap_diff_publisher_ =
+          pnode_->create_publisher<octomap_msgs::msg::OctomapWithPose>(octomap_diff_topic, 100);
+      if (octomap_monitor_)
+        octomap_monitor_->setChangeTracking(true);
+      RCLCPP_INFO(LOGGER, "Publishing octomap diffs on '%s'", octomap_diff_topic.c_str());
+    }
     monitorDiffs(true);
     publish_planning_scene_ = std::make_unique<std::thread>([this] { scenePublishingThread(); });
   }
@@ -404,83 +440,225 @@ void PlanningSceneMonitor::scenePublishingThread()
       if (octomap_monitor_)
         lock = octomap_monitor_->getOcTreePtr()->reading();
       scene_->getPlanningSceneMsg(msg);
+      discardOctomapChanges();
     }
-    planning_scene_publisher_->publish(msg);
-    RCLCPP_DEBUG(LOGGER, "Published the full planning scene: '%s'", msg.name.c_str());
+    RCLCPP_DEBUG(LOGGER, "Publishing the full planning scene: '%s'", msg.name.c_str());
+    // handing over ownership lets intra-process subscribers receive the message without a copy
+    planning_scene_publisher_->publish(std::make_unique<moveit_msgs::msg::PlanningScene>(std::move(msg)));
   }
 
+  {
+    std::scoped_lock slock(publish_statistics_mutex_);
+    publish_statistics_.pending_updates = 0;
+  }
+
+  // robot state changes are coalesced until next_state_publish, a deferred octomap is published at next_octomap_publish
+  std::chrono::steady_clock::time_point next_state_publish = std::chrono::steady_clock::now();
+  std::chrono::steady_clock::time_point next_octomap_publish = next_state_publish;
+  bool octomap_deferred = false;
   do
   {
+    const auto state_period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(1.0 / publish_planning_scene_frequency_));
+    const auto octomap_ready = [this, &next_octomap_publish, &state_period](const auto& now) {
+      if (now < next_octomap_publish)
+        return false;
+      if (planning_scene_publisher_->get_subscription_count() > 0)
+        return true;
+      // nobody would receive the octomap, check again later
+      next_octomap_publish = now + state_period;
+      return false;
+    };
     moveit_msgs::msg::PlanningScene msg;
+    octomap_msgs::msg::OctomapWithPose octomap_diff_msg;
     bool publish_msg = false;
+    bool publish_octomap = false;
+    bool publish_octomap_diff = false;
     bool is_full = false;
-    rclcpp::Rate rate(publish_planning_scene_frequency_);
+    std::size_t updates = 0;
+    std::chrono::steady_clock::time_point oldest_update;
+    // with scene snapshots, the octomap is serialized from this copy after scene_update_mutex_ is released
+    planning_scene::PlanningSceneConstPtr snapshot;
     {
       std::unique_lock<std::shared_mutex> ulock(scene_update_mutex_);
-      while (new_scene_update_ == UPDATE_NONE && publish_planning_scene_)
-        new_scene_update_condition_.wait(ulock);
-      if (new_scene_update_ != UPDATE_NONE)
+      while (publish_planning_scene_)
+      {
+        const SceneUpdateType pending = new_scene_update_;
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if ((pending != UPDATE_NONE && (pending != UPDATE_STATE || now >= next_state_publish)) ||
+            (octomap_deferred && now >= next_octomap_publish))
+          break;
+        if (pending == UPDATE_STATE && (!octomap_deferred || next_state_publish < next_octomap_publish))
+          new_scene_update_condition_.wait_until(ulock, next_state_publish);
+        else if (octomap_deferred)
+          new_scene_update_condition_.wait_until(ulock, next_octomap_publish);
+        else
+          new_scene_update_condition_.wait(ulock);
+      }
+
+      const SceneUpdateType update = new_scene_update_.exchange(UPDATE_NONE);
+      {
+        std::scoped_lock slock(publish_statistics_mutex_);
+        updates = publish_statistics_.pending_updates;
+        oldest_update = oldest_pending_update_time_;
+        publish_statistics_.pending_updates = 0;
+      }
+      const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+      const bool octomap_due = octomap_deferred && octomap_ready(now);
+      if ((update != UPDATE_NONE && ((publish_update_types_ & update) || update == UPDATE_SCENE)) || octomap_due)
       {
-        if ((publish_update_types_ & new_scene_update_) || new_scene_update_ == UPDATE_SCENE)
+        if (update == UPDATE_SCENE)
+          is_full = true;
+        else
         {
-          if (new_scene_update_ == UPDATE_SCENE)
-            is_full = true;
-          else
-          {
-            collision_detection::OccMapTree::ReadLock lock;
-            if (octomap_monitor_)
-              lock = octomap_monitor_->getOcTreePtr()->reading();
-            scene_->getPlanningSceneDiffMsg(msg);
-            if (new_scene_update_ == UPDATE_STATE)
-            {
-              msg.robot_state.attached_collision_objects.clear();
-              msg.robot_state.is_diff = true;
-            }
-          }
-          std::scoped_lock prevent_shape_cache_updates(shape_handles_lock_);  // we don't want the
-                                                                              // transform cache to
-                                                                              // update while we are
-                                                                              // potentially changing
-                                                                              // attached bodies
-          scene_->setAttachedBodyUpdateCallback(moveit::core::AttachedBodyCallback());
-          scene_->setCollisionObjectUpdateCallback(collision_detection::World::ObserverCallbackFn());
-          scene_->pushDiffs(parent_scene_);
-          scene_->clearDiffs();
-          scene_->setAttachedBodyUpdateCallback([this](moveit::core::AttachedBody* body, bool attached) {
-            currentStateAttachedBodyUpdateCallback(body, attached);
-          });
-          scene_->setCollisionObjectUpdateCallback(
-              [this](const collision_detection::World::ObjectConstPtr& object,
-                     collision_detection::World::Action action) { currentWorldObjectUpdateCallback(object, action); });
+          collision_detection::OccMapTree::ReadLock lock;
           if (octomap_monitor_)
+            lock = octomap_monitor_->getOcTreePtr()->reading();
+          if (scene_->getPlanningSceneDiffMsg(msg, false))
+            octomap_deferred = true;
+          // changed octomaps wait for the bandwidth limit, and for somebody to receive them
+          if (octomap_deferred && octomap_ready(now))
           {
-            excludeAttachedBodiesFromOctree();  // in case updates have happened to the attached bodies, put them in
-            excludeWorldObjectsFromOctree();    // in case updates have happened to the attached bodies, put them in
+            octomap_deferred = false;
+            publish_octomap = true;
+            if (scene_snapshots_)
+              snapshot = planning_scene::PlanningScene::clone(scene_);
+            else if (scene_->getOctomapMsg(msg.world.octomap))
+              publish_octomap_diff = getOctomapDiffMsg(*scene_, octomap_diff_msg, msg.world.octomap);
           }
-          if (is_full)
+          if (update == UPDATE_STATE)
           {
-            collision_detection::OccMapTree::ReadLock lock;
-            if (octomap_monitor_)
-              lock = octomap_monitor_->getOcTreePtr()->reading();
-            scene_->getPlanningSceneMsg(msg);
+            msg.robot_state.attached_collision_objects.clear();
+            msg.robot_state.is_diff = true;
           }
-          // also publish timestamp of this robot_state
-          msg.robot_state.joint_state.header.stamp = last_robot_motion_time_;
-          publish_msg = true;
         }
-        new_scene_update_ = UPDATE_NONE;
+        std::scoped_lock prevent_shape_cache_updates(shape_handles_lock_);  // we don't want the
+                                                                            // transform cache to
+                                                                            // update while we are
+                                                                            // potentially changing
+                                                                            // attached bodies
+        scene_->setAttachedBodyUpdateCallback(moveit::core::AttachedBodyCallback());
+        scene_->setCollisionObjectUpdateCallback(collision_detection::World::ObserverCallbackFn());
+        scene_->pushDiffs(parent_scene_);
+        scene_->clearDiffs();
+        scene_->setAttachedBodyUpdateCallback([this](moveit::core::AttachedBody* body, bool attached) {
+          currentStateAttachedBodyUpdateCallback(body, attached);
+        });
+        scene_->setCollisionObjectUpdateCallback(
+            [this](const collision_detection::World::ObjectConstPtr& object,
+                   collision_detection::World::Action action) { currentWorldObjectUpdateCallback(object, action); });
+        if (octomap_monitor_)
+        {
+          excludeAttachedBodiesFromOctree();  // in case updates have happened to the attached bodies, put them in
+          excludeWorldObjectsFromOctree();    // in case updates have happened to the attached bodies, put them in
+        }
+        if (is_full)
+        {
+          // full scenes always carry the octomap
+          octomap_deferred = false;
+          publish_octomap = true;
+        }
+        if (is_full && scene_snapshots_)
+          snapshot = planning_scene::PlanningScene::clone(scene_);
+        else if (is_full)
+        {
+          collision_detection::OccMapTree::ReadLock lock;
+          if (octomap_monitor_)
+            lock = octomap_monitor_->getOcTreePtr()->reading();
+          scene_->getPlanningSceneMsg(msg);
+          discardOctomapChanges();
+        }
+        // also publish timestamp of this robot_state
+        msg.robot_state.joint_state.header.stamp = last_robot_motion_time_;
+        publish_msg = true;
       }
     }
+    if (snapshot)
+    {
+      collision_detection::OccMapTree::ReadLock lock;
+      if (octomap_monitor_)
+        lock = octomap_monitor_->getOcTreePtr()->reading();
+      if (is_full)
+      {
+        const builtin_interfaces::msg::Time stamp = msg.robot_state.joint_state.header.stamp;
+        snapshot->getPlanningSceneMsg(msg);
+        msg.robot_state.joint_state.header.stamp = stamp;
+        discardOctomapChanges();
+      }
+      else if (snapshot->getOctomapMsg(msg.world.octomap))
+        publish_octomap_diff = getOctomapDiffMsg(*snapshot, octomap_diff_msg, msg.world.octomap);
+    }
     if (publish_msg)
     {
-      planning_scene_publisher_->publish(msg);
+      const std::size_t octomap_bytes =
+          publish_octomap_diff ? octomap_diff_msg.octomap.data.size() : msg.world.octomap.octomap.data.size();
+      const std::size_t subscribers = planning_scene_publisher_->get_subscription_count();
       if (is_full)
-        RCLCPP_DEBUG(LOGGER, "Published full planning scene: '%s'", msg.name.c_str());
-      rate.sleep();
+        RCLCPP_DEBUG(LOGGER, "Publishing full planning scene: '%s'", msg.name.c_str());
+      planning_scene_publisher_->publish(std::make_unique<moveit_msgs::msg::PlanningScene>(std::move(msg)));
+      if (publish_octomap_diff)
+        octomap_diff_publisher_->publish(
+            std::make_unique<octomap_msgs::msg::OctomapWithPose>(std::move(octomap_diff_msg)));
+
+      const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+      next_state_publish = now + state_period;
+      const double bandwidth = octomap_publish_bandwidth_;
+      if (publish_octomap && bandwidth > 0.0)
+        next_octomap_publish = now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                         std::chrono::duration<double>(octomap_bytes * subscribers / bandwidth));
+
+      std::scoped_lock slock(publish_statistics_mutex_);
+      ++publish_statistics_.published_messages;
+      publish_statistics_.published_updates += updates;
+      if (updates > 0)
+      {
+        publish_statistics_.last_publish_latency = now - oldest_update;
+        publish_statistics_.max_publish_latency =
+            std::max(publish_statistics_.max_publish_latency, publish_statistics_.last_publish_latency);
+      }
+      publish_statistics_.octomap_deferred = octomap_deferred;
     }
   } while (publish_planning_scene_);
 }
 
+bool PlanningSceneMonitor::getOctomapDiffMsg(const planning_scene::PlanningScene& scene,
+                                             octomap_msgs::msg::OctomapWithPose& diff,
+                                             octomap_msgs::msg::OctomapWithPose& octomap)
+{
+  if (!octomap_diff_publisher_ || !octomap_monitor_)
+    return false;
+
+  // only the octree maintained by the octomap monitor is tracked, octomaps received via messages are sent in full
+  const collision_detection::World::ObjectConstPtr map = scene.getWorld()->getObject(scene.OCTOMAP_NS);
+  const collision_detection::OccMapTreePtr& tree = octomap_monitor_->getOcTreePtr();
+  const std::shared_ptr<const octomap::OcTree> scene_octree =
+      map && map->shapes_.size() == 1 ? static_cast<const shapes::OcTree*>(map->shapes_[0].get())->octree : nullptr;
+  if (!scene_octree || (scene_octree != tree && scene_octree != tree->getSnapshot()))
+  {
+    octomap_monitor_->resetChangeTracking();
+    return false;
+  }
+
+  octomap::OcTree changes(octomap_monitor_->getOcTreePtr()->getResolution());
+  if (!octomap_monitor_->getChangedLeaves(changes))
+    return false;
+
+  diff.header = octomap.header;
+  diff.origin = octomap.origin;
+  octomap_msgs::fullMapToMsg(changes, diff.octomap);
+  octomap = octomap_msgs::msg::OctomapWithPose();
+  return true;
+}
+
+void PlanningSceneMonitor::discardOctomapChanges()
+{
+  if (octomap_diff_publisher_ && octomap_monitor_)
+  {
+    octomap::OcTree changes(octomap_monitor_->getOcTreePtr()->getResolution());
+    octomap_monitor_->getChangedLeaves(changes);
+  }
+}
+
 void PlanningSceneMonitor::getMonitoredTopics(std::vector<std::string>& topics) const
 {
   // TODO(anasarrak): Do we need this for ROS2?
@@ -526,11 +704,22 @@ bool PlanningSceneMonitor::updatesScene(const planning_scene::PlanningSceneConst
 
 void PlanningSceneMonitor::triggerSceneUpdateEvent(SceneUpdateType update_type)
 {
+  // the caller might still hold a write lock, so do not wait for the scene here
+  ++scene_version_;
+  updateSceneSnapshot(false);
+
   // do not modify update functions while we are calling them
   std::scoped_lock lock(update_lock_);
 
+  MOVEIT_TRACE_STAGE_BEGIN("planning_scene_monitor.update_callbacks", this);
   for (std::function<void(SceneUpdateType)>& update_callback : update_callbacks_)
     update_callback(update_type);
+  MOVEIT_TRACE_STAGE_END("planning_scene_monitor.update_callbacks", this, true);
+  {
+    std::scoped_lock slock(publish_statistics_mutex_);
+    if (publish_statistics_.pending_updates++ == 0)
+      oldest_pending_update_time_ = std::chrono::steady_clock::now();
+  }
   new_scene_update_ = (SceneUpdateType)(static_cast<int>(new_scene_update_) | static_cast<int>(update_type));
   new_scene_update_condition_.notify_all();
 }
@@ -598,9 +787,24 @@ void PlanningSceneMonitor::getPlanningSceneServiceCallback(moveit_msgs::srv::Get
 
   moveit_msgs::msg::PlanningSceneComponents all_components;
   all_components.components = UINT_MAX;  // Return all scene components if nothing is specified.
+  const moveit_msgs::msg::PlanningSceneComponents& components =
+      req->components.components ? req->components : all_components;
+
+  if (scene_snapshots_)
+  {
+    // serializing a snapshot does not block scene updates while large scenes are converted
+    planning_scene::PlanningSceneConstPtr snapshot = lockSceneSnapshotRead();
+    if (snapshot)
+    {
+      snapshot->getPlanningSceneMsg(res->scene, components);
+      unlockSceneSnapshotRead();
+      return;
+    }
+    unlockSceneRead();
+  }
 
   std::unique_lock<std::shared_mutex> ulock(scene_update_mutex_);
-  scene_->getPlanningSceneMsg(res->scene, req->components.components ? req->components : all_components);
+  scene_->getPlanningSceneMsg(res->scene, components);
 }
 
 void PlanningSceneMonitor::updatePublishSettings(bool publish_geom_updates, bool publish_state_updates,
@@ -628,7 +832,85 @@ void PlanningSceneMonitor::updatePublishSettings(bool publish_geom_updates, bool
 
 void PlanningSceneMonitor::newPlanningSceneCallback(moveit_msgs::msg::PlanningScene::SharedPtr scene)
 {
-  newPlanningSceneMessage(*scene);
+  if (!scene_)
+    return;
+
+  applySceneUpdate(
+      [this, scene] {
+        bool result;
+        return applyPlanningSceneMessage(*scene, result);
+      },
+      false);
+}
+
+void PlanningSceneMonitor::setSceneUpdateBatchWindow(double window)
+{
+  {
+    std::scoped_lock lock(scene_update_queue_mutex_);
+    scene_update_batch_window_ = std::chrono::duration<double>(std::max(window, 0.0));
+  }
+  // updates queued so far are not held back any longer than before
+  if (window <= 0.0)
+    flushSceneUpdates();
+}
+
+void PlanningSceneMonitor::applySceneUpdate(const std::function<SceneUpdateType()>& update,
+                                            bool update_frame_transforms)
+{
+  {
+    std::scoped_lock lock(scene_update_queue_mutex_);
+    if (scene_update_batch_window_.count() > 0.0)
+    {
+      scene_update_queue_.push_back(update);
+      scene_update_queue_needs_transforms_ = scene_update_queue_needs_transforms_ || update_frame_transforms;
+      if (!scene_update_batch_timer_)
+        scene_update_batch_timer_ = pnode_->create_wall_timer(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(scene_update_batch_window_),
+            [this]() { flushSceneUpdates(); });
+      return;
+    }
+  }
+
+  if (update_frame_transforms)
+    updateFrameTransforms();
+  SceneUpdateType upd;
+  {
+    std::unique_lock<std::shared_mutex> ulock(scene_update_mutex_);
+    upd = update();
+  }
+  if (upd != UPDATE_NONE)
+    triggerSceneUpdateEvent(upd);
+}
+
+void PlanningSceneMonitor::flushSceneUpdates()
+{
+  std::vector<std::function<SceneUpdateType()> > updates;
+  bool update_frame_transforms;
+  {
+    std::scoped_lock lock(scene_update_queue_mutex_);
+    if (scene_update_batch_timer_)
+    {
+      scene_update_batch_timer_->cancel();
+      scene_update_batch_timer_.reset();
+    }
+    updates.swap(scene_update_queue_);
+    update_frame_transforms = scene_update_queue_needs_transforms_;
+    scene_update_queue_needs_transforms_ = false;
+  }
+  if (updates.empty())
+    return;
+
+  if (update_frame_transforms)
+    updateFrameTransforms();
+  int upd = UPDATE_NONE;
+  {
+    std::unique_lock<std::shared_mutex> ulock(scene_update_mutex_);
+    for (const std::function<SceneUpdateType()>& update : updates)
+      upd |= update();
+  }
+  RCLCPP_DEBUG(LOGGER, "Applied %zu queued scene updates", updates.size());
+  if (upd != UPDATE_NONE)
+    triggerSceneUpdateEvent(static_cast<SceneUpdateType>(upd));
 }
 
 void PlanningSceneMonitor::clearOctomap()
@@ -643,6 +925,8 @@ void PlanningSceneMonitor::clearOctomap()
       octomap_monitor_->getOcTreePtr()->lockWrite();
       octomap_monitor_->getOcTreePtr()->clear();
       octomap_monitor_->getOcTreePtr()->unlockWrite();
+      octomap_monitor_->getOcTreePtr()->publishSnapshot();
+      octomap_monitor_->resetChangeTracking();
     }
     else
     {
@@ -658,13 +942,27 @@ bool PlanningSceneMonitor::newPlanningSceneMessage(const moveit_msgs::msg::Plann
 {
   if (!scene_)
     return false;
+  MOVEIT_TRACE_SCOPE("planning_scene_monitor.planning_scene", this);
+
+  // apply queued messages first, so that updates are not reordered
+  flushSceneUpdates();
 
   bool result;
+  SceneUpdateType upd;
+  {
+    std::unique_lock<std::shared_mutex> ulock(scene_update_mutex_);
+    upd = applyPlanningSceneMessage(scene, result);
+  }
+  triggerSceneUpdateEvent(upd);
+  return result;
+}
 
+PlanningSceneMonitor::SceneUpdateType
+PlanningSceneMonitor::applyPlanningSceneMessage(const moveit_msgs::msg::PlanningScene& scene, bool& result)
+{
   SceneUpdateType upd = UPDATE_SCENE;
   std::string old_scene_name;
   {
-    std::unique_lock<std::shared_mutex> ulock(scene_update_mutex_);
     // we don't want the transform cache to update while we are potentially changing attached bodies
     std::scoped_lock prevent_shape_cache_updates(shape_handles_lock_);
 
@@ -681,6 +979,8 @@ bool PlanningSceneMonitor::newPlanningSceneMessage(const moveit_msgs::msg::Plann
         octomap_monitor_->getOcTreePtr()->lockWrite();
         octomap_monitor_->getOcTreePtr()->clear();
         octomap_monitor_->getOcTreePtr()->unlockWrite();
+        octomap_monitor_->getOcTreePtr()->publishSnapshot();
+        octomap_monitor_->resetChangeTracking();
       }
     }
     robot_model_ = scene_->getRobotModel();
@@ -732,31 +1032,78 @@ bool PlanningSceneMonitor::newPlanningSceneMessage(const moveit_msgs::msg::Plann
       }
     }
   }
-  triggerSceneUpdateEvent(upd);
-  return result;
+  return upd;
 }
 
-void PlanningSceneMonitor::newPlanningSceneWorldCallback(moveit_msgs::msg::PlanningSceneWorld::SharedPtr world)
+void PlanningSceneMonitor::octomapDiffCallback(const octomap_msgs::msg::OctomapWithPose::ConstSharedPtr& msg)
 {
-  if (scene_)
+  // a local octomap monitor maintains the octree of this scene itself
+  if (!scene_ || octomap_monitor_)
+    return;
+
+  std::unique_ptr<octomap::AbstractOcTree> tree(octomap_msgs::msgToMap(msg->octomap));
+  const octomap::OcTree* changes = dynamic_cast<const octomap::OcTree*>(tree.get());
+  if (!changes)
   {
-    updateFrameTransforms();
+    RCLCPP_ERROR(LOGGER, "Received octomap diff is of type '%s' but type 'OcTree' is expected.",
+                 msg->octomap.id.c_str());
+    return;
+  }
+
+  {
+    std::unique_lock<std::shared_mutex> ulock(scene_update_mutex_);
+    last_update_time_ = rclcpp::Clock().now();
+
+    // the current octree may still be referenced by collision environments, so the diff is applied to a copy
+    std::shared_ptr<octomap::OcTree> octree;
+    const collision_detection::World::ObjectConstPtr map = scene_->getWorld()->getObject(scene_->OCTOMAP_NS);
+    if (map && map->shapes_.size() == 1)
+      octree = std::make_shared<octomap::OcTree>(*static_cast<const shapes::OcTree*>(map->shapes_[0].get())->octree);
+    else
+      octree = std::make_shared<octomap::OcTree>(changes->getResolution());
+
+    if (octree->getResolution() != changes->getResolution())
     {
-      std::unique_lock<std::shared_mutex> ulock(scene_update_mutex_);
-      last_update_time_ = rclcpp::Clock().now();
-      scene_->getWorldNonConst()->clearObjects();
-      scene_->processPlanningSceneWorldMsg(*world);
-      if (octomap_monitor_)
-      {
-        if (world->octomap.octomap.data.empty())
-        {
-          octomap_monitor_->getOcTreePtr()->lockWrite();
-          octomap_monitor_->getOcTreePtr()->clear();
-          octomap_monitor_->getOcTreePtr()->unlockWrite();
-        }
-      }
+      RCLCPP_ERROR(LOGGER, "Received octomap diff with resolution %f but the octomap of the scene uses %f",
+                   changes->getResolution(), octree->getResolution());
+      return;
     }
-    triggerSceneUpdateEvent(UPDATE_SCENE);
+
+    for (octomap::OcTree::leaf_iterator it = changes->begin_leafs(), end = changes->end_leafs(); it != end; ++it)
+      octree->setNodeValue(it.getKey(), it->getLogOdds(), true);
+    octree->updateInnerOccupancy();
+
+    Eigen::Isometry3d origin;
+    tf2::fromMsg(msg->origin, origin);
+    scene_->processOctomapPtr(octree, scene_->getFrameTransform(msg->header.frame_id) * origin);
+  }
+  triggerSceneUpdateEvent(UPDATE_GEOMETRY);
+}
+
+void PlanningSceneMonitor::newPlanningSceneWorldCallback(moveit_msgs::msg::PlanningSceneWorld::SharedPtr world)
+{
+  if (scene_)
+  {
+    MOVEIT_TRACE_SCOPE("planning_scene_monitor.planning_scene_world", this);
+    applySceneUpdate(
+        [this, world] {
+          last_update_time_ = rclcpp::Clock().now();
+          scene_->getWorldNonConst()->clearObjects();
+          scene_->processPlanningSceneWorldMsg(*world);
+          if (octomap_monitor_)
+          {
+            if (world->octomap.octomap.data.empty())
+            {
+              octomap_monitor_->getOcTreePtr()->lockWrite();
+              octomap_monitor_->getOcTreePtr()->clear();
+              octomap_monitor_->getOcTreePtr()->unlockWrite();
+              octomap_monitor_->getOcTreePtr()->publishSnapshot();
+              octomap_monitor_->resetChangeTracking();
+            }
+          }
+          return UPDATE_SCENE;
+        },
+        true);
   }
 }
 
@@ -765,27 +1112,27 @@ void PlanningSceneMonitor::collisionObjectCallback(moveit_msgs::msg::CollisionOb
   if (!scene_)
     return;
 
-  updateFrameTransforms();
-  {
-    std::unique_lock<std::shared_mutex> ulock(scene_update_mutex_);
-    last_update_time_ = rclcpp::Clock().now();
-    if (!scene_->processCollisionObjectMsg(*obj))
-      return;
-  }
-  triggerSceneUpdateEvent(UPDATE_GEOMETRY);
+  MOVEIT_TRACE_SCOPE("planning_scene_monitor.collision_object", this);
+  applySceneUpdate(
+      [this, obj] {
+        last_update_time_ = rclcpp::Clock().now();
+        return scene_->processCollisionObjectMsg(*obj) ? UPDATE_GEOMETRY : UPDATE_NONE;
+      },
+      true);
 }
 
 void PlanningSceneMonitor::attachObjectCallback(moveit_msgs::msg::AttachedCollisionObject::SharedPtr obj)
 {
   if (scene_)
   {
-    updateFrameTransforms();
-    {
-      std::unique_lock<std::shared_mutex> ulock(scene_update_mutex_);
-      last_update_time_ = rclcpp::Clock().now();
-      scene_->processAttachedCollisionObjectMsg(*obj);
-    }
-    triggerSceneUpdateEvent(UPDATE_GEOMETRY);
+    MOVEIT_TRACE_SCOPE("planning_scene_monitor.attached_collision_object", this);
+    applySceneUpdate(
+        [this, obj] {
+          last_update_time_ = rclcpp::Clock().now();
+          scene_->processAttachedCollisionObjectMsg(*obj);
+          return UPDATE_GEOMETRY;
+        },
+        true);
   }
 }
 
@@ -1061,30 +1408,91 @@ bool PlanningSceneMonitor::waitForCurrentRobotState(const rclcpp::Time& t, doubl
 
 void PlanningSceneMonitor::lockSceneRead()
 {
+  MOVEIT_TRACE_STAGE_BEGIN("planning_scene_monitor.lock_read", this);
   scene_update_mutex_.lock_shared();
-  if (octomap_monitor_)
+  // a double-buffered octree is only shared with the scene through immutable snapshots, readers need no tree lock
+  if (octomap_monitor_ && !octomap_monitor_->getOcTreePtr()->isDoubleBuffered())
     octomap_monitor_->getOcTreePtr()->lockRead();
+  MOVEIT_TRACE_STAGE_END("planning_scene_monitor.lock_read", this, true);
 }
 
 void PlanningSceneMonitor::unlockSceneRead()
 {
-  if (octomap_monitor_)
+  if (octomap_monitor_ && !octomap_monitor_->getOcTreePtr()->isDoubleBuffered())
     octomap_monitor_->getOcTreePtr()->unlockRead();
   scene_update_mutex_.unlock_shared();
 }
 
 void PlanningSceneMonitor::lockSceneWrite()
 {
+  MOVEIT_TRACE_STAGE_BEGIN("planning_scene_monitor.lock_write", this);
   scene_update_mutex_.lock();
   if (octomap_monitor_)
     octomap_monitor_->getOcTreePtr()->lockWrite();
+  MOVEIT_TRACE_STAGE_END("planning_scene_monitor.lock_write", this, true);
 }
 
 void PlanningSceneMonitor::unlockSceneWrite()
 {
   if (octomap_monitor_)
     octomap_monitor_->getOcTreePtr()->unlockWrite();
+  ++scene_version_;
   scene_update_mutex_.unlock();
+  updateSceneSnapshot(true);
+}
+
+planning_scene::PlanningSceneConstPtr PlanningSceneMonitor::lockSceneSnapshotRead()
+{
+  planning_scene::PlanningSceneConstPtr snapshot;
+  if (scene_snapshots_)
+  {
+    if (scene_snapshot_version_ != scene_version_)
+      updateSceneSnapshot(true);
+    snapshot = std::atomic_load(&scene_snapshot_);
+  }
+  if (!snapshot)
+  {
+    lockSceneRead();
+    return snapshot;
+  }
+  if (octomap_monitor_ && !octomap_monitor_->getOcTreePtr()->isDoubleBuffered())
+    octomap_monitor_->getOcTreePtr()->lockRead();
+  return snapshot;
+}
+
+void PlanningSceneMonitor::unlockSceneSnapshotRead()
+{
+  if (octomap_monitor_ && !octomap_monitor_->getOcTreePtr()->isDoubleBuffered())
+    octomap_monitor_->getOcTreePtr()->unlockRead();
+}
+
+void PlanningSceneMonitor::updateSceneSnapshot(bool wait)
+{
+  if (!scene_snapshots_ || !scene_)
+    return;
+
+  std::unique_lock<std::mutex> snapshot_lock(scene_snapshot_mutex_, std::defer_lock);
+  std::shared_lock<std::shared_mutex> scene_lock(scene_update_mutex_, std::defer_lock);
+  if (wait)
+    std::lock(snapshot_lock, scene_lock);
+  else if (!snapshot_lock.try_lock() || !scene_lock.try_lock())
+    return;
+
+  // all changes counted in version are complete, as the version is incremented after a change
+  const std::uint64_t version = scene_version_;
+  if (!scene_snapshots_ || (scene_snapshot_ && scene_snapshot_version_ == version))
+    return;
+  std::atomic_store(&scene_snapshot_,
+                    planning_scene::PlanningSceneConstPtr(planning_scene::PlanningScene::clone(scene_)));
+  scene_snapshot_version_ = version;
+}
+
+void PlanningSceneMonitor::setSceneSnapshots(bool flag)
+{
+  std::scoped_lock lock(scene_snapshot_mutex_);
+  scene_snapshots_ = flag;
+  // the first reader takes a new snapshot
+  std::atomic_store(&scene_snapshot_, planning_scene::PlanningSceneConstPtr());
 }
 
 void PlanningSceneMonitor::startSceneMonitor(const std::string& scene_topic)
@@ -1099,6 +1507,9 @@ void PlanningSceneMonitor::startSceneMonitor(const std::string& scene_topic)
         scene_topic, 100,
         [this](const moveit_msgs::msg::PlanningScene::SharedPtr scene) { return newPlanningSceneCallback(scene); });
     RCLCPP_INFO(LOGGER, "Listening to '%s'", planning_scene_subscriber_->get_topic_name());
+    octomap_diff_subscriber_ = pnode_->create_subscription<octomap_msgs::msg::OctomapWithPose>(
+        scene_topic + OCTOMAP_DIFF_TOPIC_SUFFIX, 100,
+        [this](const octomap_msgs::msg::OctomapWithPose::ConstSharedPtr& msg) { return octomapDiffCallback(msg); });
   }
 }
 
@@ -1108,6 +1519,7 @@ void PlanningSceneMonitor::stopSceneMonitor()
   {
     RCLCPP_INFO(LOGGER, "Stopping planning scene monitor");
     planning_scene_subscriber_.reset();
+    octomap_diff_subscriber_.reset();
   }
 }
 
@@ -1117,6 +1529,8 @@ bool PlanningSceneMonitor::getShapeTransformCache(const std::string& target_fram
   try
   {
     std::scoped_lock _(shape_handles_lock_);
+    if (getCachedShapeTransforms(target_frame, target_time, cache))
+      return true;
 
     for (const std::pair<const moveit::core::LinkModel* const,
                          std::vector<std::pair<occupancy_map_monitor::ShapeHandle, std::size_t>>>& link_shape_handle :
@@ -1171,6 +1585,102 @@ bool PlanningSceneMonitor::getShapeTransformCache(const std::string& target_fram
   return true;
 }
 
+bool PlanningSceneMonitor::getCachedShapeTransforms(const std::string& target_frame, const rclcpp::Time& target_time,
+                                                    occupancy_map_monitor::ShapeTransformCache& cache) const
+{
+  const occupancy_map_monitor::LinkTransformCacheConstPtr link_transform_cache =
+      std::atomic_load(&link_transform_cache_);
+  if (!link_transform_cache)
+    return false;
+
+  // world objects are expressed in the planning frame, which is only cached if the robot is fixed to it
+  const std::string& reference_frame = link_transform_cache->getReferenceFrame();
+  if (!collision_body_shape_handles_.empty() && reference_frame != scene_->getPlanningFrame())
+    return false;
+
+  int target_index = -1;
+  if (target_frame != reference_frame)
+  {
+    target_index = link_transform_cache->getFrameIndex(target_frame);
+    if (target_index < 0)
+      return false;
+  }
+  if (!link_transform_cache->getTransforms(target_time, link_transform_cache_lookup_))
+    return false;
+
+  const Eigen::Isometry3d target_t_reference =
+      target_index < 0 ? Eigen::Isometry3d::Identity() : link_transform_cache_lookup_[target_index].inverse();
+
+  for (const std::pair<const moveit::core::LinkModel* const,
+                       std::vector<std::pair<occupancy_map_monitor::ShapeHandle, std::size_t>>>& link_shape_handle :
+       link_shape_handles_)
+  {
+    const Eigen::Isometry3d ttr =
+        target_t_reference * link_transform_cache_lookup_[link_shape_handle.first->getLinkIndex()];
+    for (const std::pair<occupancy_map_monitor::ShapeHandle, std::size_t>& it : link_shape_handle.second)
+      cache[it.first] = ttr * link_shape_handle.first->getCollisionOriginTransforms()[it.second];
+  }
+  for (const std::pair<const moveit::core::AttachedBody* const,
+                       std::vector<std::pair<occupancy_map_monitor::ShapeHandle, std::size_t>>>&
+           attached_body_shape_handle : attached_body_shape_handles_)
+  {
+    const Eigen::Isometry3d transform =
+        target_t_reference *
+        link_transform_cache_lookup_[attached_body_shape_handle.first->getAttachedLink()->getLinkIndex()];
+    for (const std::pair<occupancy_map_monitor::ShapeHandle, std::size_t>& it : attached_body_shape_handle.second)
+      cache[it.first] = transform * attached_body_shape_handle.first->getShapePosesInLinkFrame()[it.second];
+  }
+  for (const std::pair<const std::string,
+                       std::vector<std::pair<occupancy_map_monitor::ShapeHandle, const Eigen::Isometry3d*>>>&
+           collision_body_shape_handle : collision_body_shape_handles_)
+    for (const std::pair<occupancy_map_monitor::ShapeHandle, const Eigen::Isometry3d*>& it :
+         collision_body_shape_handle.second)
+      cache[it.first] = target_t_reference * (*it.second);
+  return true;
+}
+
+occupancy_map_monitor::LinkTransformCachePtr PlanningSceneMonitor::createLinkTransformCache() const
+{
+  // a moving root joint is updated from tf2 rather than joint states, so only cache poses relative to the root link
+  const std::string& reference_frame = robot_model_->getRootJoint()->getType() == moveit::core::JointModel::FIXED ?
+                                           robot_model_->getModelFrame() :
+                                           robot_model_->getRootLinkName();
+  return std::make_shared<occupancy_map_monitor::LinkTransformCache>(reference_frame,
+                                                                     robot_model_->getLinkModelNames());
+}
+
+void PlanningSceneMonitor::updateLinkTransformCache(const sensor_msgs::msg::JointState& joint_state)
+{
+  const occupancy_map_monitor::LinkTransformCachePtr link_transform_cache = std::atomic_load(&link_transform_cache_);
+  const rclcpp::Time stamp(joint_state.header.stamp);
+  if (!link_transform_cache || stamp.nanoseconds() == 0)
+    return;
+
+  if (!link_transform_cache_state_)
+  {
+    link_transform_cache_state_ = std::make_shared<moveit::core::RobotState>(robot_model_);
+    link_transform_cache_state_->setToDefaultValues();
+    link_transform_cache_poses_.resize(robot_model_->getLinkModelCount());
+  }
+  link_transform_cache_state_->setVariableValues(joint_state);
+  link_transform_cache_state_->updateLinkTransforms();
+
+  const moveit::core::RobotState& state = *link_transform_cache_state_;
+  const std::vector<const moveit::core::LinkModel*>& links = robot_model_->getLinkModels();
+  if (link_transform_cache->getReferenceFrame() == robot_model_->getModelFrame())
+  {
+    for (std::size_t i = 0; i < links.size(); ++i)
+      link_transform_cache_poses_[i] = state.getGlobalLinkTransform(links[i]);
+  }
+  else
+  {
+    const Eigen::Isometry3d root_t_model = state.getGlobalLinkTransform(robot_model_->getRootLink()).inverse();
+    for (std::size_t i = 0; i < links.size(); ++i)
+      link_transform_cache_poses_[i] = root_t_model * state.getGlobalLinkTransform(links[i]);
+  }
+  link_transform_cache->push(stamp, link_transform_cache_poses_);
+}
+
 void PlanningSceneMonitor::startWorldGeometryMonitor(const std::string& collision_objects_topic,
                                                      const std::string& planning_scene_world_topic,
                                                      const bool load_octomap_monitor)
@@ -1212,6 +1722,10 @@ void PlanningSceneMonitor::startWorldGeometryMonitor(const std::string& collisio
         return getShapeTransformCache(frame, stamp, cache);
       });
       octomap_monitor_->setUpdateCallback([this] { octomapUpdateCallback(); });
+      std::atomic_store(&link_transform_cache_, createLinkTransformCache());
+      octomap_monitor_->setLinkTransformCache(link_transform_cache_);
+      if (octomap_diff_publisher_)
+        octomap_monitor_->setChangeTracking(true);
     }
     octomap_monitor_->startMonitor();
   }
@@ -1287,8 +1801,11 @@ void PlanningSceneMonitor::stopStateMonitor()
   }
 }
 
-void PlanningSceneMonitor::onStateUpdate(const sensor_msgs::msg::JointState::ConstSharedPtr& /*joint_state */)
+void PlanningSceneMonitor::onStateUpdate(const sensor_msgs::msg::JointState::ConstSharedPtr& joint_state)
 {
+  // the link poses are cached for every message, independent of the throttled scene updates
+  updateLinkTransformCache(*joint_state);
+
   const std::chrono::system_clock::time_point& n = std::chrono::system_clock::now();
   std::chrono::duration<double> dt = n - last_robot_state_update_wall_time_;
 
@@ -1352,16 +1869,25 @@ void PlanningSceneMonitor::octomapUpdateCallback()
   {
     std::unique_lock<std::shared_mutex> ulock(scene_update_mutex_);
     last_update_time_ = rclcpp::Clock().now();
-    octomap_monitor_->getOcTreePtr()->lockRead();
-    try
+    if (octomap_monitor_->getOcTreePtr()->isDoubleBuffered())
     {
-      scene_->processOctomapPtr(octomap_monitor_->getOcTreePtr(), Eigen::Isometry3d::Identity());
-      octomap_monitor_->getOcTreePtr()->unlockRead();
+      // the snapshot is immutable, so the updaters can keep writing into the tree while the scene is updated
+      if (std::shared_ptr<const octomap::OcTree> snapshot = octomap_monitor_->getOcTreePtr()->getSnapshot())
+        scene_->processOctomapPtr(snapshot, Eigen::Isometry3d::Identity());
     }
-    catch (...)
+    else
     {
-      octomap_monitor_->getOcTreePtr()->unlockRead();  // unlock and rethrow
-      throw;
+      octomap_monitor_->getOcTreePtr()->lockRead();
+      try
+      {
+        scene_->processOctomapPtr(octomap_monitor_->getOcTreePtr(), Eigen::Isometry3d::Identity());
+        octomap_monitor_->getOcTreePtr()->unlockRead();
+      }
+      catch (...)
+      {
+        octomap_monitor_->getOcTreePtr()->unlockRead();  // unlock and rethrow
+        throw;
+      }
     }
   }
   triggerSceneUpdateEvent(UPDATE_GEOMETRY);
@@ -1398,6 +1924,7 @@ void PlanningSceneMonitor::setStateUpdateFrequency(double hz)
 
 void PlanningSceneMonitor::updateSceneWithCurrentState()
 {
+  MOVEIT_TRACE_SCOPE("planning_scene_monitor.current_state", this);
   rclcpp::Time time = node_->now();
   rclcpp::Clock steady_clock = rclcpp::Clock(RCL_STEADY_TIME);
   if (current_state_monitor_)
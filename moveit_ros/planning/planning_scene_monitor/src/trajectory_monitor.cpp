@@ -56,6 +56,7 @@ planning_scene_monitor::TrajectoryMonitor::TrajectoryMonitor(
   , middleware_handle_(std::move(middleware_handle))
   , sampling_frequency_(sampling_frequency)
   , trajectory_(current_state_monitor_->getRobotModel(), "")
+  , compact_capacity_(0)
 {
   setSamplingFrequency(sampling_frequency);
 }
@@ -77,14 +78,33 @@ void planning_scene_monitor::TrajectoryMonitor::setSamplingFrequency(double samp
   sampling_frequency_ = sampling_frequency;
 }
 
+void planning_scene_monitor::TrajectoryMonitor::setCompactRecording(std::size_t capacity)
+{
+  compact_capacity_ = capacity;
+}
+
 bool planning_scene_monitor::TrajectoryMonitor::isActive() const
 {
-  return static_cast<bool>(record_states_thread_);
+  return record_states_thread_ || state_listener_id_;
 }
 
 void planning_scene_monitor::TrajectoryMonitor::startTrajectoryMonitor()
 {
-  if (sampling_frequency_ > std::numeric_limits<double>::epsilon() && !record_states_thread_)
+  if (isActive())
+    return;
+
+  if (compact_capacity_ > 0)
+  {
+    {
+      std::scoped_lock lock(compact_mutex_);
+      compact_positions_.reserve(compact_capacity_ * current_state_monitor_->getRobotModel()->getVariableCount());
+      compact_times_.reserve(compact_capacity_);
+    }
+    state_listener_id_ = current_state_monitor_->addStateListener(
+        [this](const moveit::core::RobotState& state, const rclcpp::Time& time) { recordCompactState(state, time); });
+    RCLCPP_DEBUG(LOGGER, "Started compact trajectory recording");
+  }
+  else if (sampling_frequency_ > std::numeric_limits<double>::epsilon())
   {
     record_states_thread_ = std::make_unique<std::thread>([this] { recordStates(); });
     RCLCPP_DEBUG(LOGGER, "Started trajectory monitor");
@@ -100,6 +120,12 @@ void planning_scene_monitor::TrajectoryMonitor::stopTrajectoryMonitor()
     copy->join();
     RCLCPP_DEBUG(LOGGER, "Stopped trajectory monitor");
   }
+  if (state_listener_id_)
+  {
+    current_state_monitor_->removeStateListener(*state_listener_id_);
+    state_listener_id_.reset();
+    RCLCPP_DEBUG(LOGGER, "Stopped compact trajectory recording");
+  }
 }
 
 void planning_scene_monitor::TrajectoryMonitor::clearTrajectory()
@@ -108,10 +134,62 @@ void planning_scene_monitor::TrajectoryMonitor::clearTrajectory()
   if (restart)
     stopTrajectoryMonitor();
   trajectory_.clear();
+  {
+    std::scoped_lock lock(compact_mutex_);
+    compact_positions_.clear();
+    compact_times_.clear();
+  }
   if (restart)
     startTrajectoryMonitor();
 }
 
+void planning_scene_monitor::TrajectoryMonitor::recordCompactState(const moveit::core::RobotState& state,
+                                                                   const rclcpp::Time& time)
+{
+  std::scoped_lock lock(compact_mutex_);
+  // TF and joint state updates may share a stamp; keep one state per stamp so that durations stay positive
+  if (!compact_times_.empty() && time <= compact_times_.back())
+    return;
+  if (compact_times_.size() == compact_capacity_)
+    RCLCPP_DEBUG(LOGGER, "Compact trajectory recording exceeds its capacity of %zu states", compact_capacity_);
+  const double* positions = state.getVariablePositions();
+  compact_positions_.insert(compact_positions_.end(), positions, positions + state.getVariableCount());
+  compact_times_.push_back(time);
+}
+
+void planning_scene_monitor::TrajectoryMonitor::flushCompactRecording()
+{
+  std::vector<double> positions;
+  std::vector<rclcpp::Time> times;
+  {
+    std::scoped_lock lock(compact_mutex_);
+    if (compact_times_.empty())
+      return;
+    // hand the filled buffers over and continue recording into buffers of the same capacity
+    positions.swap(compact_positions_);
+    times.swap(compact_times_);
+    compact_positions_.reserve(positions.capacity());
+    compact_times_.reserve(times.capacity());
+  }
+
+  const std::size_t variable_count = current_state_monitor_->getRobotModel()->getVariableCount();
+  for (std::size_t i = 0; i < times.size(); ++i)
+  {
+    auto state = std::make_shared<moveit::core::RobotState>(current_state_monitor_->getRobotModel());
+    state->setVariablePositions(&positions[i * variable_count]);
+    if (trajectory_.empty())
+    {
+      trajectory_.addSuffixWayPoint(state, 0.0);
+      trajectory_start_time_ = times[i];
+    }
+    else
+      trajectory_.addSuffixWayPoint(state, (times[i] - last_recorded_state_time_).seconds());
+    last_recorded_state_time_ = times[i];
+    if (state_add_callback_)
+      state_add_callback_(state, times[i]);
+  }
+}
+
 void planning_scene_monitor::TrajectoryMonitor::recordStates()
 {
   if (!current_state_monitor_)
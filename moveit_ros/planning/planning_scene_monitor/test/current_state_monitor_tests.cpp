@@ -34,9 +34,12 @@
 
 /* Author: Tyler Weaver */
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <memory>
 #include <string>
+#include <thread>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -198,6 +201,110 @@ TEST(CurrentStateMonitorTests, WaitForCompleteStateWaits)
   EXPECT_NEAR(nanoseconds_slept.count(), 1e+9, 1e3);
 }
 
+TEST(CurrentStateMonitorTests, SnapshotIsConsistentUnderConcurrentUpdates)
+{
+  auto mock_middleware_handle = std::make_unique<MockMiddlewareHandle>();
+  planning_scene_monitor::JointStateUpdateCallback joint_state_callback;
+  EXPECT_CALL(*mock_middleware_handle, createJointStateSubscription)
+      .WillOnce(testing::SaveArg<1>(&joint_state_callback));
+
+  // GIVEN a started CurrentStateMonitor
+  const moveit::core::RobotModelPtr robot_model = moveit::core::loadTestingRobotModel("panda");
+  planning_scene_monitor::CurrentStateMonitor current_state_monitor{
+    std::move(mock_middleware_handle), robot_model,
+    std::make_shared<tf2_ros::Buffer>(std::make_shared<rclcpp::Clock>()), false
+  };
+  current_state_monitor.startStateMonitor();
+  ASSERT_TRUE(joint_state_callback);
+
+  // WHEN joint states setting all arm joints to the same value are received while readers query the state
+  const moveit::core::JointModelGroup* group = robot_model->getJointModelGroup("panda_arm");
+  std::atomic<bool> done{ false };
+  std::thread writer([&] {
+    for (int i = 1; i <= 2000; ++i)
+    {
+      auto joint_state = std::make_shared<sensor_msgs::msg::JointState>();
+      joint_state->header.stamp = rclcpp::Time(i, 0, RCL_ROS_TIME);
+      joint_state->name = group->getVariableNames();
+      joint_state->position.assign(joint_state->name.size(), 1e-4 * i);
+      joint_state_callback(joint_state);
+    }
+    done = true;
+  });
+
+  // THEN every snapshot a reader gets is one of the received joint states, not a mix of two
+  std::vector<double> positions;
+  bool consistent = true;
+  while (!done)
+  {
+    current_state_monitor.getCurrentGroupPositions(group, positions);
+    consistent &= std::all_of(positions.begin(), positions.end(), [&](double p) { return p == positions[0]; });
+    const moveit::core::RobotStatePtr state = current_state_monitor.getCurrentState();
+    std::vector<double> state_positions;
+    state->copyJointGroupPositions(group, state_positions);
+    consistent &= std::all_of(state_positions.begin(), state_positions.end(),
+                              [&](double p) { return p == state_positions[0]; });
+  }
+  writer.join();
+  EXPECT_TRUE(consistent);
+
+  current_state_monitor.getCurrentGroupPositions(group, positions);
+  EXPECT_EQ(positions, std::vector<double>(group->getVariableCount(), 1e-4 * 2000));
+  EXPECT_EQ(current_state_monitor.getCurrentStateTime(), rclcpp::Time(2000, 0, RCL_ROS_TIME));
+}
+
+TEST(CurrentStateMonitorTests, StateHistoryInterpolatesRecordedStates)
+{
+  auto mock_middleware_handle = std::make_unique<MockMiddlewareHandle>();
+  planning_scene_monitor::JointStateUpdateCallback joint_state_callback;
+  EXPECT_CALL(*mock_middleware_handle, createJointStateSubscription)
+      .WillOnce(testing::SaveArg<1>(&joint_state_callback));
+
+  // GIVEN a started CurrentStateMonitor recording the last 3 states
+  const moveit::core::RobotModelPtr robot_model = moveit::core::loadTestingRobotModel("panda");
+  planning_scene_monitor::CurrentStateMonitor current_state_monitor{
+    std::move(mock_middleware_handle), robot_model,
+    std::make_shared<tf2_ros::Buffer>(std::make_shared<rclcpp::Clock>()), false
+  };
+  current_state_monitor.enableStateHistory(3);
+  current_state_monitor.startStateMonitor();
+  ASSERT_TRUE(joint_state_callback);
+
+  // WHEN joint states are received at 1s, 2s, ... 5s
+  const moveit::core::JointModelGroup* group = robot_model->getJointModelGroup("panda_arm");
+  for (int i = 1; i <= 5; ++i)
+  {
+    auto joint_state = std::make_shared<sensor_msgs::msg::JointState>();
+    joint_state->header.stamp = rclcpp::Time(i, 0, RCL_ROS_TIME);
+    joint_state->name = group->getVariableNames();
+    joint_state->position.assign(joint_state->name.size(), 0.1 * i);
+    joint_state_callback(joint_state);
+  }
+
+  // THEN only the last 3 states are kept
+  rclcpp::Time oldest, newest;
+  ASSERT_TRUE(current_state_monitor.getStateHistoryTimeRange(oldest, newest));
+  EXPECT_EQ(oldest, rclcpp::Time(3, 0, RCL_ROS_TIME));
+  EXPECT_EQ(newest, rclcpp::Time(5, 0, RCL_ROS_TIME));
+
+  // THEN states in between are interpolated, and times outside the history are rejected
+  moveit::core::RobotState state(robot_model);
+  state.setToDefaultValues();
+  ASSERT_TRUE(current_state_monitor.getStateAtTime(rclcpp::Time(3, 500000000, RCL_ROS_TIME), state));
+  std::vector<double> positions;
+  state.copyJointGroupPositions(group, positions);
+  for (double position : positions)
+    EXPECT_NEAR(position, 0.35, 1e-9);
+
+  ASSERT_TRUE(current_state_monitor.getStateAtTime(rclcpp::Time(5, 0, RCL_ROS_TIME), state));
+  state.copyJointGroupPositions(group, positions);
+  for (double position : positions)
+    EXPECT_NEAR(position, 0.5, 1e-9);
+
+  EXPECT_FALSE(current_state_monitor.getStateAtTime(rclcpp::Time(2, 0, RCL_ROS_TIME), state));
+  EXPECT_FALSE(current_state_monitor.getStateAtTime(rclcpp::Time(6, 0, RCL_ROS_TIME), state));
+}
+
 int main(int argc, char** argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
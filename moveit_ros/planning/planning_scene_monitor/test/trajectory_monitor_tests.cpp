@@ -109,6 +109,58 @@ TEST(TrajectoryMonitorTests, SleepAtLeastOnce)
   waitFor(10s, [&]() { return static_cast<bool>(callback_called); });
 }
 
+TEST(TrajectoryMonitorTests, CompactRecordingConvertsOnDemand)
+{
+  auto mock_trajectory_monitor_middleware_handle = std::make_unique<MockTrajectoryMonitorMiddlewareHandle>();
+  auto mock_current_state_monitor_middleware_handle = std::make_unique<MockCurrentStateMonitorMiddlewareHandle>();
+
+  // THEN we expect it not to poll
+  EXPECT_CALL(*mock_trajectory_monitor_middleware_handle, sleep).Times(0);
+
+  planning_scene_monitor::JointStateUpdateCallback joint_state_callback;
+  EXPECT_CALL(*mock_current_state_monitor_middleware_handle, createJointStateSubscription)
+      .WillOnce(testing::SaveArg<1>(&joint_state_callback));
+
+  // GIVEN a started CurrentStateMonitor and a TrajectoryMonitor recording compactly
+  const moveit::core::RobotModelPtr robot_model = moveit::core::loadTestingRobotModel("panda");
+  auto current_state_monitor = std::make_shared<planning_scene_monitor::CurrentStateMonitor>(
+      std::move(mock_current_state_monitor_middleware_handle), robot_model,
+      std::make_shared<tf2_ros::Buffer>(std::make_shared<rclcpp::Clock>()), false);
+  current_state_monitor->startStateMonitor();
+  ASSERT_TRUE(joint_state_callback);
+
+  planning_scene_monitor::TrajectoryMonitor trajectory_monitor{ current_state_monitor,
+                                                                std::move(mock_trajectory_monitor_middleware_handle),
+                                                                10.0 };
+  trajectory_monitor.setCompactRecording(2);
+  trajectory_monitor.startTrajectoryMonitor();
+  EXPECT_TRUE(trajectory_monitor.isActive());
+
+  // WHEN more joint states than the preallocated capacity are received
+  const moveit::core::JointModelGroup* group = robot_model->getJointModelGroup("panda_arm");
+  for (int i = 1; i <= 3; ++i)
+  {
+    auto joint_state = std::make_shared<sensor_msgs::msg::JointState>();
+    joint_state->header.stamp = rclcpp::Time(i, 0, RCL_ROS_TIME);
+    joint_state->name = group->getVariableNames();
+    joint_state->position.assign(joint_state->name.size(), 0.1 * i);
+    joint_state_callback(joint_state);
+  }
+  trajectory_monitor.stopTrajectoryMonitor();
+  EXPECT_FALSE(trajectory_monitor.isActive());
+
+  // THEN every state is part of the trajectory, with the durations between their stamps
+  const robot_trajectory::RobotTrajectory& trajectory = trajectory_monitor.getTrajectory();
+  ASSERT_EQ(trajectory.getWayPointCount(), 3u);
+  for (std::size_t i = 0; i < 3; ++i)
+  {
+    std::vector<double> positions;
+    trajectory.getWayPoint(i).copyJointGroupPositions(group, positions);
+    EXPECT_NEAR(positions[0], 0.1 * (i + 1), 1e-9);
+    EXPECT_NEAR(trajectory.getWayPointDurationFromPrevious(i), i == 0 ? 0.0 : 1.0, 1e-9);
+  }
+}
+
 int main(int argc, char** argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -93,6 +93,18 @@ public:
     return srdf_;
   }
 
+  /** @brief Get the URDF document the model was parsed from */
+  const std::string& getURDFString() const
+  {
+    return urdf_string_;
+  }
+
+  /** @brief Get the SRDF document the model was parsed from */
+  const std::string& getSRDFString() const
+  {
+    return srdf_string_;
+  }
+
   void setNewModelCallback(NewModelCallback cb)
   {
     new_model_cb_ = cb;
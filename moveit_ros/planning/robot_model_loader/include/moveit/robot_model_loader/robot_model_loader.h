@@ -74,6 +74,11 @@ public:
     /** @brief Flag indicating whether the kinematics solvers should be loaded as well, using specified ROS parameters
      */
     bool load_kinematics_solvers_;
+
+    /** @brief Directory holding binary snapshots of robot models (see moveit::core::RobotModelSnapshot). If empty,
+     * the ROS parameter robot_description + "_planning.snapshot_directory" is used. If that is empty too, no snapshot
+     * is used. */
+    std::string snapshot_directory_;
   };
 
   /** @brief Default constructor */
@@ -129,6 +134,10 @@ public:
 private:
   void configure(const Options& opt);
 
+  /** @brief Build model_, reusing the meshes of a snapshot in \e snapshot_directory that matches the loaded URDF and
+   * SRDF documents, and writing a new snapshot if meshes had to be loaded */
+  void buildModelFromSnapshot(const srdf::ModelSharedPtr& srdf, const std::string& snapshot_directory);
+
   moveit::core::RobotModelPtr model_;
   rdf_loader::RDFLoaderPtr rdf_loader_;
   kinematics_plugin_loader::KinematicsPluginLoaderPtr kinematics_loader_;
@@ -35,12 +35,15 @@
 /* Author: Ioan Sucan, E. Gil Jones */
 
 #include <moveit/robot_model_loader/robot_model_loader.h>
+#include <moveit/utils/startup_profile.h>
 #include <rclcpp/clock.hpp>
 #include <rclcpp/duration.hpp>
 #include <rclcpp/logger.hpp>
 #include <rclcpp/logging.hpp>
 #include <rclcpp/parameter_value.hpp>
 #include <rclcpp/time.hpp>
+#include <filesystem>
+#include <future>
 #include <typeinfo>
 
 namespace robot_model_loader
@@ -101,8 +104,41 @@ bool canSpecifyPosition(const moveit::core::JointModel* jmodel, const unsigned i
 }
 }  // namespace
 
+void RobotModelLoader::buildModelFromSnapshot(const srdf::ModelSharedPtr& srdf, const std::string& snapshot_directory)
+{
+  const std::uint64_t urdf_hash = moveit::core::RobotModelSnapshot::hashDescription(rdf_loader_->getURDFString());
+  const std::uint64_t srdf_hash = moveit::core::RobotModelSnapshot::hashDescription(rdf_loader_->getSRDFString());
+  const std::string path =
+      (std::filesystem::path(snapshot_directory) / (rdf_loader_->getURDF()->getName() + ".moveit_snapshot")).string();
+
+  moveit::core::RobotModelSnapshotPtr snapshot = moveit::core::RobotModelSnapshot::load(path);
+  if (snapshot && !snapshot->matches(urdf_hash, srdf_hash))
+  {
+    RCLCPP_INFO(LOGGER, "Robot model snapshot '%s' is outdated and will be replaced", path.c_str());
+    snapshot.reset();
+  }
+  if (!snapshot)
+    snapshot = std::make_shared<moveit::core::RobotModelSnapshot>(urdf_hash, srdf_hash);
+  else
+    RCLCPP_INFO(LOGGER, "Using %zu meshes of robot model snapshot '%s'", snapshot->getMeshCount(), path.c_str());
+
+  model_ = std::make_shared<moveit::core::RobotModel>(rdf_loader_->getURDF(), srdf, *snapshot);
+
+  if (snapshot->isModified())
+  {
+    std::error_code error;
+    std::filesystem::create_directories(snapshot_directory, error);
+    if (error)
+      RCLCPP_WARN(LOGGER, "Unable to create directory '%s' for robot model snapshots: %s", snapshot_directory.c_str(),
+                  error.message().c_str());
+    else if (snapshot->save(path))
+      RCLCPP_INFO(LOGGER, "Wrote robot model snapshot '%s'", path.c_str());
+  }
+}
+
 void RobotModelLoader::configure(const Options& opt)
 {
+  moveit::profiling::ScopedStartupPhase phase("robot model '" + opt.robot_description_ + "'");
   rclcpp::Clock clock;
   rclcpp::Time start = clock.now();
   if (!opt.urdf_string_.empty() && !opt.srdf_string_.empty())
@@ -113,7 +149,20 @@ void RobotModelLoader::configure(const Options& opt)
   {
     const srdf::ModelSharedPtr& srdf =
         rdf_loader_->getSRDF() ? rdf_loader_->getSRDF() : std::make_shared<srdf::Model>();
-    model_ = std::make_shared<moveit::core::RobotModel>(rdf_loader_->getURDF(), srdf);
+
+    std::string snapshot_directory = opt.snapshot_directory_;
+    if (snapshot_directory.empty() && node_)
+    {
+      const std::string param_name = rdf_loader_->getRobotDescription() + "_planning.snapshot_directory";
+      if (!node_->has_parameter(param_name))
+        node_->declare_parameter(param_name, std::string());
+      node_->get_parameter(param_name, snapshot_directory);
+    }
+
+    if (snapshot_directory.empty())
+      model_ = std::make_shared<moveit::core::RobotModel>(rdf_loader_->getURDF(), srdf);
+    else
+      buildModelFromSnapshot(srdf, snapshot_directory);
   }
 
   if (model_ && !rdf_loader_->getRobotDescription().empty())
@@ -252,6 +301,7 @@ void RobotModelLoader::loadKinematicsSolvers(const kinematics_plugin_loader::Kin
 {
   if (rdf_loader_ && model_)
   {
+    moveit::profiling::ScopedStartupPhase phase("kinematics solvers");
     // load the kinematics solvers
     if (kloader)
       kinematics_loader_ = kloader;
@@ -267,7 +317,9 @@ void RobotModelLoader::loadKinematicsSolvers(const kinematics_plugin_loader::Kin
     if (groups.empty() && !model_->getJointModelGroups().empty())
       RCLCPP_WARN(LOGGER, "No kinematics plugins defined. Fill and load kinematics.yaml!");
 
-    std::map<std::string, moveit::core::SolverAllocatorFn> imap;
+    // the solvers of the groups are independent, so they are initialized concurrently. The loader caches them,
+    // so setKinematicsAllocators() below retrieves these instances instead of initializing them again
+    std::map<std::string, std::future<kinematics::KinematicsBasePtr>> solvers;
     for (const std::string& group : groups)
     {
       // Check if a group in kinematics.yaml exists in the srdf
@@ -275,8 +327,18 @@ void RobotModelLoader::loadKinematicsSolvers(const kinematics_plugin_loader::Kin
         continue;
 
       const moveit::core::JointModelGroup* jmg = model_->getJointModelGroup(group);
+      solvers[group] = std::async(std::launch::async, [&kinematics_allocator, jmg] {
+        moveit::profiling::ScopedStartupPhase phase("kinematics solver '" + jmg->getName() + "'");
+        return kinematics_allocator(jmg);
+      });
+    }
 
-      kinematics::KinematicsBasePtr solver = kinematics_allocator(jmg);
+    std::map<std::string, moveit::core::SolverAllocatorFn> imap;
+    for (auto& [group, future] : solvers)
+    {
+      const moveit::core::JointModelGroup* jmg = model_->getJointModelGroup(group);
+
+      kinematics::KinematicsBasePtr solver = future.get();
       if (solver)
       {
         std::string error_msg;
@@ -307,6 +369,14 @@ void RobotModelLoader::loadKinematicsSolvers(const kinematics_plugin_loader::Kin
       moveit::core::JointModelGroup* jmg = model_->getJointModelGroup(it.first);
       jmg->setDefaultIKTimeout(it.second);
     }
+
+    // let every thread use its own solver instance where requested
+    for (const std::pair<const std::string, bool>& it : kinematics_loader_->getPerThreadInstances())
+    {
+      if (!model_->hasJointModelGroup(it.first))
+        continue;
+      model_->getJointModelGroup(it.first)->setPerThreadSolverInstances(it.second);
+    }
   }
 }
 }  // namespace robot_model_loader
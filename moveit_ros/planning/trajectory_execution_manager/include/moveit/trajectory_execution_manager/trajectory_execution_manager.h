@@ -46,9 +46,11 @@
 #include <moveit/controller_manager/controller_manager.h>
 #include <pluginlib/class_loader.hpp>
 
+#include <atomic>
 #include <memory>
 #include <deque>
 #include <thread>
+#include <tuple>
 
 #include "moveit_trajectory_execution_manager_export.h"
 
@@ -207,6 +209,10 @@ public:
   /// pushAndExecute(), it will immediately stop execution.
   moveit_controller_manager::ExecutionStatus waitForExecution();
 
+  /// Wait until all trajectories passed to pushAndExecute() have been sent and the controllers that received them have
+  /// finished executing. Unlike waitForExecution(), this does not stop continuous execution.
+  moveit_controller_manager::ExecutionStatus waitForContinuousExecution();
+
   /// Get the state that the robot is expected to be at, given current time, after execute() has been called. The return
   /// value is a pair of two index values:
   /// first = the index of the trajectory to be executed (in the order push() was called), second = the index of the
@@ -246,6 +252,18 @@ public:
   /// Enable or disable waiting for trajectory completion
   void setWaitForTrajectoryCompletion(bool flag);
 
+  /// When a trajectory is split across several controllers, all parts are stamped to start this long (in seconds)
+  /// after they are dispatched, so that the controllers start together. Zero disables the common stamp.
+  void setMultiControllerStartDelay(double delay);
+
+  /// A current state at most this old (in seconds) is used as is to validate a trajectory's start point; otherwise
+  /// validation waits for a new joint state
+  void setAllowedStartStateAge(double age);
+
+  /// Stop execution early when a joint deviates more than \e error (radians or meters) from where the trajectory
+  /// expects it. The check runs at \e rate Hz on the state history of the current state monitor. Zero disables it.
+  void setMaxTrackingError(double error, double rate = 20.0);
+
   rclcpp::Node::SharedPtr getControllerManagerNode()
   {
     return controller_mgr_node_;
@@ -268,6 +286,21 @@ private:
     }
   };
 
+  /// The inputs of a controller selection: the states are those of the available controllers, in the same order
+  struct ControllerSelectionKey
+  {
+    std::set<std::string> actuated_joints_;
+    std::vector<std::string> available_controllers_;
+    std::vector<bool> active_;
+    std::vector<bool> default_;
+
+    bool operator<(const ControllerSelectionKey& other) const
+    {
+      return std::tie(actuated_joints_, available_controllers_, active_, default_) <
+             std::tie(other.actuated_joints_, other.available_controllers_, other.active_, other.default_);
+    }
+  };
+
   void initialize();
 
   void reloadControllerInformation();
@@ -294,15 +327,30 @@ private:
                                      std::vector<std::string>& selected_controllers,
                                      std::vector<std::vector<std::string> >& selected_options,
                                      const std::set<std::string>& actuated_joints);
+  /// Select controllers, memoized for the same joints, available controllers and controller states
   bool selectControllers(const std::set<std::string>& actuated_joints,
                          const std::vector<std::string>& available_controllers,
                          std::vector<std::string>& selected_controllers);
+  /// Search all combinations of controllers for the best one
+  bool searchControllers(const std::set<std::string>& actuated_joints,
+                         const std::vector<std::string>& available_controllers,
+                         std::vector<std::string>& selected_controllers);
 
   void executeThread(const ExecutionCompleteCallback& callback, const PathSegmentCompleteCallback& part_callback,
                      bool auto_clear);
   bool executePart(std::size_t part_index);
+  /// Compare the recorded joint states with the expected positions of \e context until \e done is set. On excessive
+  /// tracking error, stop the execution and set \e exceeded.
+  void monitorTrackingError(const TrajectoryExecutionContext& context, const rclcpp::Time& start_time,
+                            const std::atomic<bool>& done, std::atomic<bool>& exceeded);
+  /// Send the \e parts of a split trajectory to their \e handles concurrently, with a common start stamp. If any part
+  /// fails, the parts that were sent are canceled.
+  bool dispatchTrajectoryParts(const std::vector<moveit_controller_manager::MoveItControllerHandlePtr>& handles,
+                               std::vector<moveit_msgs::msg::RobotTrajectory>& parts);
   bool waitForRobotToStop(const TrajectoryExecutionContext& context, double wait_time = 1.0);
   void continuousExecutionThread();
+  /// Account for a processed pushAndExecute() trajectory and remember the \e handles it was sent to
+  void markContinuousContextDone(const std::vector<moveit_controller_manager::MoveItControllerHandlePtr>& handles);
 
   void stopExecutionInternal();
 
@@ -323,6 +371,9 @@ private:
   std::map<std::string, ControllerInformation> known_controllers_;
   bool manage_controllers_;
 
+  // Successful controller selections. Cleared when the known controllers or their joints change
+  std::map<ControllerSelectionKey, std::vector<std::string>> controller_selection_cache_;
+
   // thread used to execute trajectories using the execute() command
   std::unique_ptr<std::thread> execution_thread_;
 
@@ -349,6 +400,10 @@ private:
   bool run_continuous_execution_thread_;
   std::vector<TrajectoryExecutionContext*> trajectories_;
   std::deque<TrajectoryExecutionContext*> continuous_execution_queue_;
+  // number of trajectories passed to pushAndExecute() that were not yet sent to the controllers
+  std::size_t continuous_execution_pending_;
+  // controller handles that received trajectories from pushAndExecute() since the last waitForContinuousExecution()
+  std::set<moveit_controller_manager::MoveItControllerHandlePtr> continuous_execution_handles_;
 
   std::unique_ptr<pluginlib::ClassLoader<moveit_controller_manager::MoveItControllerManager> > controller_manager_loader_;
   moveit_controller_manager::MoveItControllerManagerPtr controller_manager_;
@@ -367,6 +422,10 @@ private:
   double allowed_start_tolerance_;  // joint tolerance for validate(): radians for revolute joints
   double execution_velocity_scaling_;
   bool wait_for_trajectory_completion_;
+  double multi_controller_start_delay_;  // seconds
+  double allowed_start_state_age_;       // seconds
+  double max_tracking_error_;            // zero disables tracking error monitoring
+  double tracking_monitor_rate_;         // Hz
 
   rclcpp::node_interfaces::OnSetParametersCallbackHandle::SharedPtr callback_handler_;
 };
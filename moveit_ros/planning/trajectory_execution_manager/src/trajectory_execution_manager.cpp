@@ -36,6 +36,7 @@
 
 #include <moveit/trajectory_execution_manager/trajectory_execution_manager.h>
 #include <moveit/robot_state/robot_state.h>
+#include <moveit/utils/tracing.h>
 #include <geometric_shapes/check_isometry.h>
 #if __has_include(<tf2_eigen/tf2_eigen.hpp>)
 #include <tf2_eigen/tf2_eigen.hpp>
@@ -43,8 +44,15 @@
 #include <tf2_eigen/tf2_eigen.h>
 #endif
 
+#include <algorithm>
+#include <future>
+#include <optional>
+
 namespace trajectory_execution_manager
 {
+// number of joint states kept for tracking error monitoring
+static const std::size_t TRACKING_HISTORY_CAPACITY = 1000;
+
 static const rclcpp::Logger LOGGER = rclcpp::get_logger("moveit_ros.trajectory_execution_manager");
 
 const std::string TrajectoryExecutionManager::EXECUTION_EVENT_TOPIC = "trajectory_execution_event";
@@ -90,6 +98,7 @@ void TrajectoryExecutionManager::initialize()
   verbose_ = false;
   execution_complete_ = true;
   stop_continuous_execution_ = false;
+  continuous_execution_pending_ = 0;
   current_context_ = -1;
   last_execution_status_ = moveit_controller_manager::ExecutionStatus::SUCCEEDED;
   run_continuous_execution_thread_ = true;
@@ -97,6 +106,10 @@ void TrajectoryExecutionManager::initialize()
   execution_velocity_scaling_ = 1.0;
   allowed_start_tolerance_ = 0.01;
   wait_for_trajectory_completion_ = true;
+  multi_controller_start_delay_ = 0.05;
+  allowed_start_state_age_ = 0.05;
+  max_tracking_error_ = 0.0;
+  tracking_monitor_rate_ = 20.0;
 
   allowed_execution_duration_scaling_ = DEFAULT_CONTROLLER_GOAL_DURATION_SCALING;
   allowed_goal_duration_margin_ = DEFAULT_CONTROLLER_GOAL_DURATION_MARGIN;
@@ -188,6 +201,14 @@ void TrajectoryExecutionManager::initialize()
   controller_mgr_node_->get_parameter("trajectory_execution.allowed_goal_duration_margin",
                                       allowed_goal_duration_margin_);
   controller_mgr_node_->get_parameter("trajectory_execution.allowed_start_tolerance", allowed_start_tolerance_);
+  controller_mgr_node_->get_parameter("trajectory_execution.multi_controller_start_delay",
+                                      multi_controller_start_delay_);
+  controller_mgr_node_->get_parameter("trajectory_execution.allowed_start_state_age", allowed_start_state_age_);
+  double max_tracking_error = 0.0;
+  double tracking_monitor_rate = 20.0;
+  controller_mgr_node_->get_parameter("trajectory_execution.max_tracking_error", max_tracking_error);
+  controller_mgr_node_->get_parameter("trajectory_execution.tracking_monitor_rate", tracking_monitor_rate);
+  setMaxTrackingError(max_tracking_error, tracking_monitor_rate);
 
   if (manage_controllers_)
     RCLCPP_INFO(LOGGER, "Trajectory execution is managing controllers");
@@ -212,6 +233,14 @@ void TrajectoryExecutionManager::initialize()
         setAllowedStartTolerance(parameter.as_double());
       else if (name == "trajectory_execution.wait_for_trajectory_completion")
         setWaitForTrajectoryCompletion(parameter.as_bool());
+      else if (name == "trajectory_execution.multi_controller_start_delay")
+        setMultiControllerStartDelay(parameter.as_double());
+      else if (name == "trajectory_execution.allowed_start_state_age")
+        setAllowedStartStateAge(parameter.as_double());
+      else if (name == "trajectory_execution.max_tracking_error")
+        setMaxTrackingError(parameter.as_double(), tracking_monitor_rate_);
+      else if (name == "trajectory_execution.tracking_monitor_rate")
+        setMaxTrackingError(max_tracking_error_, parameter.as_double());
       else
         result.successful = false;
     }
@@ -250,6 +279,30 @@ void TrajectoryExecutionManager::setWaitForTrajectoryCompletion(bool flag)
   wait_for_trajectory_completion_ = flag;
 }
 
+void TrajectoryExecutionManager::setMultiControllerStartDelay(double delay)
+{
+  multi_controller_start_delay_ = delay;
+}
+
+void TrajectoryExecutionManager::setAllowedStartStateAge(double age)
+{
+  allowed_start_state_age_ = age;
+}
+
+void TrajectoryExecutionManager::setMaxTrackingError(double error, double rate)
+{
+  if (error > 0.0 && rate <= 0.0)
+  {
+    RCLCPP_ERROR(LOGGER, "The tracking monitor rate must be positive, not %g", rate);
+    return;
+  }
+  max_tracking_error_ = std::max(error, 0.0);
+  tracking_monitor_rate_ = rate;
+  // the monitor compares against the recorded joint states; a few seconds of them suffice at any joint state rate
+  if (max_tracking_error_ > 0.0 && csm_)
+    csm_->enableStateHistory(TRACKING_HISTORY_CAPACITY);
+}
+
 bool TrajectoryExecutionManager::isManagingControllers() const
 {
   return manage_controllers_;
@@ -398,6 +451,7 @@ bool TrajectoryExecutionManager::pushAndExecute(const moveit_msgs::msg::RobotTra
     {
       std::scoped_lock slock(continuous_execution_mutex_);
       continuous_execution_queue_.push_back(context);
+      ++continuous_execution_pending_;
       if (!continuous_execution_thread_)
         continuous_execution_thread_ = std::make_unique<std::thread>([this] { continuousExecutionThread(); });
     }
@@ -431,12 +485,18 @@ void TrajectoryExecutionManager::continuousExecutionThread()
         if (used_handle->getLastExecutionStatus() == moveit_controller_manager::ExecutionStatus::RUNNING)
           used_handle->cancelExecution();
       used_handles.clear();
-      while (!continuous_execution_queue_.empty())
       {
-        TrajectoryExecutionContext* context = continuous_execution_queue_.front();
-        continuous_execution_queue_.pop_front();
-        delete context;
+        std::scoped_lock slock(continuous_execution_mutex_);
+        while (!continuous_execution_queue_.empty())
+        {
+          TrajectoryExecutionContext* context = continuous_execution_queue_.front();
+          continuous_execution_queue_.pop_front();
+          delete context;
+        }
+        continuous_execution_pending_ = 0;
+        continuous_execution_handles_.clear();
       }
+      continuous_execution_condition_.notify_all();
       stop_continuous_execution_ = false;
       continue;
     }
@@ -498,47 +558,22 @@ void TrajectoryExecutionManager::continuousExecutionThread()
         if (stop_continuous_execution_ || !run_continuous_execution_thread_)
         {
           delete context;
+          markContinuousContextDone({});
           break;
         }
 
         // push all trajectories to all controllers simultaneously
-        if (!handles.empty())
-          for (std::size_t i = 0; i < context->trajectory_parts_.size(); ++i)
-          {
-            bool ok = false;
-            try
-            {
-              ok = handles[i]->sendTrajectory(context->trajectory_parts_[i]);
-            }
-            catch (std::exception& ex)
-            {
-              RCLCPP_ERROR(LOGGER, "Caught %s when sending trajectory to controller", ex.what());
-            }
-            if (!ok)
-            {
-              for (std::size_t j = 0; j < i; ++j)
-                try
-                {
-                  handles[j]->cancelExecution();
-                }
-                catch (std::exception& ex)
-                {
-                  RCLCPP_ERROR(LOGGER, "Caught %s when canceling execution", ex.what());
-                }
-              RCLCPP_ERROR(LOGGER, "Failed to send trajectory part %zu of %zu to controller %s", i + 1,
-                           context->trajectory_parts_.size(), handles[i]->getName().c_str());
-              if (i > 0)
-                RCLCPP_ERROR(LOGGER, "Cancelling previously sent trajectory parts");
-              last_execution_status_ = moveit_controller_manager::ExecutionStatus::ABORTED;
-              handles.clear();
-              break;
-            }
-          }
+        if (!handles.empty() && !dispatchTrajectoryParts(handles, context->trajectory_parts_))
+        {
+          last_execution_status_ = moveit_controller_manager::ExecutionStatus::ABORTED;
+          handles.clear();
+        }
         delete context;
 
         // remember which handles we used
         for (const moveit_controller_manager::MoveItControllerHandlePtr& handle : handles)
           used_handles.insert(handle);
+        markContinuousContextDone(handles);
       }
       else
       {
@@ -546,13 +581,58 @@ void TrajectoryExecutionManager::continuousExecutionThread()
                              "calling ensureActiveControllers() before pushAndExecute()");
         last_execution_status_ = moveit_controller_manager::ExecutionStatus::ABORTED;
         delete context;
+        markContinuousContextDone({});
       }
     }
   }
 }
 
+void TrajectoryExecutionManager::markContinuousContextDone(
+    const std::vector<moveit_controller_manager::MoveItControllerHandlePtr>& handles)
+{
+  {
+    std::scoped_lock slock(continuous_execution_mutex_);
+    continuous_execution_handles_.insert(handles.begin(), handles.end());
+    if (continuous_execution_pending_ > 0)
+      --continuous_execution_pending_;
+  }
+  continuous_execution_condition_.notify_all();
+}
+
+moveit_controller_manager::ExecutionStatus TrajectoryExecutionManager::waitForContinuousExecution()
+{
+  std::set<moveit_controller_manager::MoveItControllerHandlePtr> handles;
+  {
+    std::unique_lock<std::mutex> ulock(continuous_execution_mutex_);
+    continuous_execution_condition_.wait(ulock, [this] { return continuous_execution_pending_ == 0; });
+    handles.swap(continuous_execution_handles_);
+  }
+
+  // a failure to send any of the trajectories is already reflected in the last execution status
+  moveit_controller_manager::ExecutionStatus status = last_execution_status_;
+  for (const moveit_controller_manager::MoveItControllerHandlePtr& handle : handles)
+  {
+    try
+    {
+      handle->waitForExecution();
+    }
+    catch (std::exception& ex)
+    {
+      RCLCPP_ERROR(LOGGER, "Caught %s when waiting for execution of controller %s", ex.what(),
+                   handle->getName().c_str());
+    }
+    if (status == moveit_controller_manager::ExecutionStatus::SUCCEEDED)
+      status = handle->getLastExecutionStatus();
+  }
+  return status;
+}
+
 void TrajectoryExecutionManager::reloadControllerInformation()
 {
+  std::map<std::string, std::set<std::string>> previous_controller_joints;
+  for (const std::pair<const std::string, ControllerInformation>& known_controller : known_controllers_)
+    previous_controller_joints[known_controller.first] = known_controller.second.joints_;
+
   known_controllers_.clear();
   if (controller_manager_)
   {
@@ -600,6 +680,13 @@ void TrajectoryExecutionManager::reloadControllerInformation()
   {
     RCLCPP_ERROR(LOGGER, "Failed to reload controllers: `controller_manager_` does not exist.");
   }
+
+  // The cached selections only depend on the controller names and joints, apart from the states in their keys
+  std::map<std::string, std::set<std::string>> controller_joints;
+  for (const std::pair<const std::string, ControllerInformation>& known_controller : known_controllers_)
+    controller_joints[known_controller.first] = known_controller.second.joints_;
+  if (controller_joints != previous_controller_joints)
+    controller_selection_cache_.clear();
 }
 
 void TrajectoryExecutionManager::updateControllerState(const std::string& controller, const rclcpp::Duration& age)
@@ -828,6 +915,38 @@ bool TrajectoryExecutionManager::areControllersActive(const std::vector<std::str
 bool TrajectoryExecutionManager::selectControllers(const std::set<std::string>& actuated_joints,
                                                    const std::vector<std::string>& available_controllers,
                                                    std::vector<std::string>& selected_controllers)
+{
+  // The selection prefers default and active controllers, so their states are part of the key.
+  // Like the search itself, this only queries the states that are older than the validity age
+  ControllerSelectionKey key;
+  key.actuated_joints_ = actuated_joints;
+  key.available_controllers_ = available_controllers;
+  for (const std::string& controller : available_controllers)
+  {
+    std::map<std::string, ControllerInformation>::iterator it = known_controllers_.find(controller);
+    if (it != known_controllers_.end())
+      updateControllerState(it->second, DEFAULT_CONTROLLER_INFORMATION_VALIDITY_AGE);
+    key.active_.push_back(it != known_controllers_.end() && it->second.state_.active_);
+    key.default_.push_back(it != known_controllers_.end() && it->second.state_.default_);
+  }
+
+  std::map<ControllerSelectionKey, std::vector<std::string>>::const_iterator cached =
+      controller_selection_cache_.find(key);
+  if (cached != controller_selection_cache_.end())
+  {
+    selected_controllers = cached->second;
+    return true;
+  }
+
+  if (!searchControllers(actuated_joints, available_controllers, selected_controllers))
+    return false;
+  controller_selection_cache_[key] = selected_controllers;
+  return true;
+}
+
+bool TrajectoryExecutionManager::searchControllers(const std::set<std::string>& actuated_joints,
+                                                   const std::vector<std::string>& available_controllers,
+                                                   std::vector<std::string>& selected_controllers)
 {
   for (std::size_t i = 1; i <= available_controllers.size(); ++i)
     if (findControllers(actuated_joints, i, available_controllers, selected_controllers))
@@ -995,8 +1114,12 @@ bool TrajectoryExecutionManager::validate(const TrajectoryExecutionContext& cont
 
   RCLCPP_INFO(LOGGER, "Validating trajectory with allowed_start_tolerance %g", allowed_start_tolerance_);
 
+  // only block for a new joint state if the cached one is too old
   moveit::core::RobotStatePtr current_state;
-  if (!csm_->waitForCurrentState(node_->now()) || !(current_state = csm_->getCurrentState()))
+  const rclcpp::Time now = node_->now();
+  const bool fresh = csm_->haveCompleteState() &&
+                     now - csm_->getCurrentStateTime() <= rclcpp::Duration::from_seconds(allowed_start_state_age_);
+  if (!(fresh || csm_->waitForCurrentState(now)) || !(current_state = csm_->getCurrentState()))
   {
     RCLCPP_WARN(LOGGER, "Failed to validate trajectory: couldn't receive full current joint state within 1s");
     return false;
@@ -1376,12 +1499,177 @@ void TrajectoryExecutionManager::executeThread(const ExecutionCompleteCallback&
     callback(last_execution_status_);
 }
 
+void TrajectoryExecutionManager::monitorTrackingError(const TrajectoryExecutionContext& context,
+                                                      const rclcpp::Time& start_time, const std::atomic<bool>& done,
+                                                      std::atomic<bool>& exceeded)
+{
+  // resolve the variables of every part once; only single-variable joints are monitored
+  struct PartMonitor
+  {
+    const trajectory_msgs::msg::JointTrajectory* trajectory;
+    rclcpp::Time start;
+    std::vector<const moveit::core::JointModel*> joints;  // nullptr for joints that are not monitored
+    std::size_t cursor = 0;
+  };
+  std::vector<PartMonitor> parts;
+  for (const moveit_msgs::msg::RobotTrajectory& part : context.trajectory_parts_)
+  {
+    if (part.joint_trajectory.points.empty())
+      continue;
+    PartMonitor monitor;
+    monitor.trajectory = &part.joint_trajectory;
+    const rclcpp::Time stamp(part.joint_trajectory.header.stamp);
+    monitor.start = stamp.nanoseconds() != 0 ? stamp : start_time;
+    for (const std::string& name : part.joint_trajectory.joint_names)
+    {
+      const moveit::core::JointModel* jm = robot_model_->getJointModel(name);
+      monitor.joints.push_back(jm && jm->getVariableCount() == 1 ? jm : nullptr);
+    }
+    parts.push_back(std::move(monitor));
+  }
+  if (parts.empty())
+    return;
+
+  const auto period = std::chrono::duration<double>(1.0 / tracking_monitor_rate_);
+  std::vector<double> positions;
+  rclcpp::Time oldest, newest;
+  while (!done)
+  {
+    std::this_thread::sleep_for(period);
+    if (done || !csm_->getStateHistoryTimeRange(oldest, newest) || !csm_->getStateAtTime(newest, positions))
+      continue;
+
+    double max_error = 0.0;
+    std::string worst_joint;
+    for (PartMonitor& part : parts)
+    {
+      const std::vector<trajectory_msgs::msg::JointTrajectoryPoint>& points = part.trajectory->points;
+      if (newest < part.start)
+        continue;
+      // the state history only moves forward, so the cursor into the trajectory does too
+      const auto time_from_start = [&points](std::size_t i) {
+        return rclcpp::Duration(points[i].time_from_start).seconds();
+      };
+      const double t = std::min((newest - part.start).seconds(), time_from_start(points.size() - 1));
+      while (part.cursor + 1 < points.size() && time_from_start(part.cursor + 1) <= t)
+        ++part.cursor;
+
+      const trajectory_msgs::msg::JointTrajectoryPoint& before = points[part.cursor];
+      const trajectory_msgs::msg::JointTrajectoryPoint& after = points[std::min(part.cursor + 1, points.size() - 1)];
+      const double t0 = time_from_start(part.cursor);
+      const double t1 = time_from_start(std::min(part.cursor + 1, points.size() - 1));
+      const double alpha = t1 > t0 ? std::clamp((t - t0) / (t1 - t0), 0.0, 1.0) : 0.0;
+      for (std::size_t j = 0; j < part.joints.size(); ++j)
+      {
+        const moveit::core::JointModel* jm = part.joints[j];
+        if (!jm || j >= before.positions.size() || j >= after.positions.size())
+          continue;
+        double expected;
+        jm->interpolate(&before.positions[j], &after.positions[j], alpha, &expected);
+        const double error = jm->distance(&expected, &positions[jm->getFirstVariableIndex()]);
+        if (error > max_error)
+        {
+          max_error = error;
+          worst_joint = jm->getName();
+        }
+      }
+    }
+
+    if (max_error > max_tracking_error_)
+    {
+      RCLCPP_ERROR(LOGGER, "Joint '%s' deviates %g from the expected trajectory, more than the allowed %g. Stopping "
+                           "trajectory.",
+                   worst_joint.c_str(), max_error, max_tracking_error_);
+      exceeded = true;
+      std::scoped_lock slock(execution_state_mutex_);
+      stopExecutionInternal();
+      return;
+    }
+  }
+}
+
+bool TrajectoryExecutionManager::dispatchTrajectoryParts(
+    const std::vector<moveit_controller_manager::MoveItControllerHandlePtr>& handles,
+    std::vector<moveit_msgs::msg::RobotTrajectory>& parts)
+{
+  // give all parts a common start time, so that the controllers start together even if their goals arrive at
+  // different times; a stamp that is already set on any part is kept and shared with the others
+  if (parts.size() > 1 && multi_controller_start_delay_ > 0.0)
+  {
+    std::optional<rclcpp::Time> start;
+    for (const moveit_msgs::msg::RobotTrajectory& part : parts)
+      for (const builtin_interfaces::msg::Time& stamp :
+           { part.joint_trajectory.header.stamp, part.multi_dof_joint_trajectory.header.stamp })
+        if (!start && rclcpp::Time(stamp).nanoseconds() != 0)
+          start = rclcpp::Time(stamp);
+    if (!start)
+      start = node_->now() + rclcpp::Duration::from_seconds(multi_controller_start_delay_);
+    for (moveit_msgs::msg::RobotTrajectory& part : parts)
+    {
+      if (rclcpp::Time(part.joint_trajectory.header.stamp).nanoseconds() == 0)
+        part.joint_trajectory.header.stamp = *start;
+      if (rclcpp::Time(part.multi_dof_joint_trajectory.header.stamp).nanoseconds() == 0)
+        part.multi_dof_joint_trajectory.header.stamp = *start;
+    }
+  }
+
+  auto send = [&handles, &parts](std::size_t i) {
+    try
+    {
+      MOVEIT_TRACE_SCOPE("trajectory_execution.send", handles[i].get());
+      return handles[i]->sendTrajectory(parts[i]);
+    }
+    catch (std::exception& ex)
+    {
+      RCLCPP_ERROR(LOGGER, "Caught %s when sending trajectory to controller", ex.what());
+    }
+    return false;
+  };
+
+  // sending blocks until the controller accepted the goal, so the parts are sent in parallel
+  std::vector<std::future<bool>> futures;
+  for (std::size_t i = 1; i < parts.size(); ++i)
+    futures.push_back(std::async(std::launch::async, send, i));
+  std::vector<bool> sent(parts.size(), false);
+  if (!parts.empty())
+    sent[0] = send(0);
+  for (std::size_t i = 1; i < parts.size(); ++i)
+    sent[i] = futures[i - 1].get();
+
+  if (std::all_of(sent.begin(), sent.end(), [](bool ok) { return ok; }))
+    return true;
+
+  for (std::size_t i = 0; i < parts.size(); ++i)
+  {
+    if (!sent[i])
+    {
+      RCLCPP_ERROR(LOGGER, "Failed to send trajectory part %zu of %zu to controller %s", i + 1, parts.size(),
+                   handles[i]->getName().c_str());
+      continue;
+    }
+    RCLCPP_ERROR(LOGGER, "Cancelling trajectory part %zu sent to controller %s", i + 1, handles[i]->getName().c_str());
+    try
+    {
+      handles[i]->cancelExecution();
+    }
+    catch (std::exception& ex)
+    {
+      RCLCPP_ERROR(LOGGER, "Caught %s when canceling execution", ex.what());
+    }
+  }
+  return false;
+}
+
 bool TrajectoryExecutionManager::executePart(std::size_t part_index)
 {
   TrajectoryExecutionContext& context = *trajectories_[part_index];
+  MOVEIT_TRACE_SCOPE("trajectory_execution.execute_part", &context);
 
   // first make sure desired controllers are active
-  if (ensureActiveControllers(context.controllers_))
+  MOVEIT_TRACE_STAGE_BEGIN("trajectory_execution.ensure_controllers", &context);
+  const bool controllers_active = ensureActiveControllers(context.controllers_);
+  MOVEIT_TRACE_STAGE_END("trajectory_execution.ensure_controllers", &context, controllers_active);
+  if (controllers_active)
   {
     // stop if we are already asked to do so
     if (execution_complete_)
@@ -1419,37 +1707,15 @@ bool TrajectoryExecutionManager::executePart(std::size_t part_index)
           active_handles_[i] = h;
         }
         handles = active_handles_;  // keep a copy for later, to avoid thread safety issues
-        for (std::size_t i = 0; i < context.trajectory_parts_.size(); ++i)
+        MOVEIT_TRACE_STAGE_BEGIN("trajectory_execution.dispatch", &context);
+        const bool dispatched = dispatchTrajectoryParts(handles, context.trajectory_parts_);
+        MOVEIT_TRACE_STAGE_END("trajectory_execution.dispatch", &context, dispatched);
+        if (!dispatched)
         {
-          bool ok = false;
-          try
-          {
-            ok = active_handles_[i]->sendTrajectory(context.trajectory_parts_[i]);
-          }
-          catch (std::exception& ex)
-          {
-            RCLCPP_ERROR(LOGGER, "Caught %s when sending trajectory to controller", ex.what());
-          }
-          if (!ok)
-          {
-            for (std::size_t j = 0; j < i; ++j)
-              try
-              {
-                active_handles_[j]->cancelExecution();
-              }
-              catch (std::exception& ex)
-              {
-                RCLCPP_ERROR(LOGGER, "Caught %s when canceling execution", ex.what());
-              }
-            RCLCPP_ERROR(LOGGER, "Failed to send trajectory part %zu of %zu to controller %s", i + 1,
-                         context.trajectory_parts_.size(), active_handles_[i]->getName().c_str());
-            if (i > 0)
-              RCLCPP_ERROR(LOGGER, "Cancelling previously sent trajectory parts");
-            active_handles_.clear();
-            current_context_ = -1;
-            last_execution_status_ = moveit_controller_manager::ExecutionStatus::ABORTED;
-            return false;
-          }
+          active_handles_.clear();
+          current_context_ = -1;
+          last_execution_status_ = moveit_controller_manager::ExecutionStatus::ABORTED;
+          return false;
         }
       }
     }
@@ -1533,7 +1799,17 @@ bool TrajectoryExecutionManager::executePart(std::size_t part_index)
       }
     }
 
+    // compare the actual motion with the expected one while waiting, to stop a blocked robot early
+    std::atomic<bool> monitoring_done{ false };
+    std::atomic<bool> tracking_error_exceeded{ false };
+    std::thread tracking_monitor;
+    if (max_tracking_error_ > 0.0)
+      tracking_monitor = std::thread([this, &context, current_time, &monitoring_done, &tracking_error_exceeded] {
+        monitorTrackingError(context, current_time, monitoring_done, tracking_error_exceeded);
+      });
+
     bool result = true;
+    MOVEIT_TRACE_STAGE_BEGIN("trajectory_execution.wait", &context);
     for (moveit_controller_manager::MoveItControllerHandlePtr& handle : handles)
     {
       if (execution_duration_monitoring_)
@@ -1573,6 +1849,16 @@ bool TrajectoryExecutionManager::executePart(std::size_t part_index)
       }
     }
 
+    monitoring_done = true;
+    if (tracking_monitor.joinable())
+      tracking_monitor.join();
+    if (tracking_error_exceeded)
+    {
+      last_execution_status_ = moveit_controller_manager::ExecutionStatus::ABORTED;
+      result = false;
+    }
+    MOVEIT_TRACE_STAGE_END("trajectory_execution.wait", &context, result);
+
     // clear the active handles
     execution_state_mutex_.lock();
     active_handles_.clear();
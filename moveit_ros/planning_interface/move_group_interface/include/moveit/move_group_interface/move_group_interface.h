@@ -51,12 +51,14 @@
 // #include <moveit_msgs/action/place.hpp>
 #include <moveit_msgs/action/move_group.hpp>
 #include <moveit_msgs/action/execute_trajectory.hpp>
+#include <moveit_msgs/srv/get_cartesian_path.hpp>
 
 #include <moveit_msgs/msg/motion_plan_request.hpp>
 #include <geometry_msgs/msg/pose_stamped.h>
 
 #include <rclcpp_action/rclcpp_action.hpp>
 
+#include <future>
 #include <memory>
 #include <utility>
 #include <tf2_ros/buffer.h>
@@ -104,6 +106,10 @@ public:
 
     /// The namespace for the move group node
     std::string move_group_namespace_;
+
+    /// Return from the constructor without waiting for the action servers. A request that needs a server which is not
+    /// connected yet waits for it, up to the wait_for_servers timeout of the constructor.
+    bool lazy_connection_ = false;
   };
 
   MOVEIT_STRUCT_FORWARD(Plan);
@@ -121,6 +127,16 @@ public:
     double planning_time_;
   };
 
+  /** \brief The result of an asynchronous planning request */
+  struct PlanResult
+  {
+    /// The outcome of the planning request
+    moveit::core::MoveItErrorCode error_code;
+
+    /// The computed plan, only valid if \e error_code is SUCCESS
+    Plan plan;
+  };
+
   /**
       \brief Construct a MoveGroupInterface instance call using a specified set of options \e opt.
 
@@ -130,6 +146,8 @@ public:
       \param tf_buffer. Specify a TF2_ROS Buffer instance to use. If not specified,
                         one will be constructed internally
       \param wait_for_servers. Timeout for connecting to action servers. -1 time means unlimited waiting.
+                        The servers are waited for concurrently, and only when a request needs them if
+                        Options::lazy_connection_ is set.
     */
   MoveGroupInterface(const rclcpp::Node::SharedPtr& node, const Options& opt,
                      const std::shared_ptr<tf2_ros::Buffer>& tf_buffer = std::shared_ptr<tf2_ros::Buffer>(),
@@ -731,6 +749,24 @@ public:
   /** \brief Given a \e robot trajectory, execute it while waiting for completion. */
   moveit::core::MoveItErrorCode execute(const moveit_msgs::msg::RobotTrajectory& trajectory);
 
+  /** \brief Send a planning request like plan() and return immediately. The returned future completes with the
+      planning result. Unlike the blocking calls, several requests may be outstanding at the same time. */
+  std::shared_future<PlanResult> planAsync();
+
+  /** \brief Send a plan and execute request like move() and return immediately. The returned future completes when the
+      execution of the trajectory finished. */
+  std::shared_future<moveit::core::MoveItErrorCode> moveAsync();
+
+  /** \brief Send \e plan for execution and return a future that completes when the execution finished. */
+  std::shared_future<moveit::core::MoveItErrorCode> executeAsync(const Plan& plan);
+
+  /** \brief Send \e trajectory for execution and return a future that completes when the execution finished. */
+  std::shared_future<moveit::core::MoveItErrorCode> executeAsync(const moveit_msgs::msg::RobotTrajectory& trajectory);
+
+  /** \brief Cancel all move and execute action goals sent by this interface that did not finish yet. Their futures
+      complete with the result reported by move_group. */
+  void cancelAsyncRequests();
+
   /** \brief Compute a Cartesian path that follows specified waypoints with a step size of at most \e eef_step meters
       between end effector configurations of consecutive points in the result \e trajectory. The reference frame for the
       waypoints is that specified by setPoseReferenceFrame(). No more than \e jump_threshold
@@ -761,6 +797,14 @@ public:
                               const moveit_msgs::msg::Constraints& path_constraints, bool avoid_collisions = true,
                               moveit_msgs::msg::MoveItErrorCodes* error_code = nullptr);
 
+  /** \brief Send a Cartesian path request like computeCartesianPath() and return immediately. The returned future
+      completes with the response of the Cartesian path service. */
+  std::shared_future<moveit_msgs::srv::GetCartesianPath::Response::SharedPtr>
+  computeCartesianPathAsync(const std::vector<geometry_msgs::msg::Pose>& waypoints, double eef_step,
+                            double jump_threshold,
+                            const moveit_msgs::msg::Constraints& path_constraints = moveit_msgs::msg::Constraints(),
+                            bool avoid_collisions = true);
+
   /** \brief Stop any trajectory execution, if one is active */
   void stop();
 
@@ -38,7 +38,11 @@
 
 #include <stdexcept>
 #include <sstream>
+#include <functional>
+#include <future>
+#include <map>
 #include <memory>
+#include <mutex>
 #if __has_include(<tf2_geometry_msgs/tf2_geometry_msgs.hpp>)
 #include <tf2_geometry_msgs/tf2_geometry_msgs.hpp>
 #else
@@ -101,7 +105,7 @@ class MoveGroupInterface::MoveGroupInterfaceImpl
 public:
   MoveGroupInterfaceImpl(const rclcpp::Node::SharedPtr& node, const Options& opt,
                          const std::shared_ptr<tf2_ros::Buffer>& tf_buffer, const rclcpp::Duration& wait_for_servers)
-    : opt_(opt), node_(node), tf_buffer_(tf_buffer)
+    : opt_(opt), node_(node), tf_buffer_(tf_buffer), wait_for_servers_(wait_for_servers)
   {
     // We have no control on how the passed node is getting executed. To make sure MGI is functional, we're creating
     // our own callback group which is managed in a separate callback thread
@@ -164,10 +168,15 @@ public:
 
     move_action_client_ = rclcpp_action::create_client<moveit_msgs::action::MoveGroup>(
         node_, rclcpp::names::append(opt_.move_group_namespace_, move_group::MOVE_ACTION), callback_group_);
-    move_action_client_->wait_for_action_server(wait_for_servers.to_chrono<std::chrono::duration<double>>());
     execute_action_client_ = rclcpp_action::create_client<moveit_msgs::action::ExecuteTrajectory>(
         node_, rclcpp::names::append(opt_.move_group_namespace_, move_group::EXECUTE_ACTION_NAME), callback_group_);
-    execute_action_client_->wait_for_action_server(wait_for_servers.to_chrono<std::chrono::duration<double>>());
+    if (!opt_.lazy_connection_)
+    {
+      // wait for both servers at once, so the waits overlap instead of adding up
+      auto move_ready = std::async(std::launch::async, [this] { return waitForServer(move_action_client_); });
+      waitForServer(execute_action_client_);
+      move_ready.wait();
+    }
 
     query_service_ = node_->create_client<moveit_msgs::srv::QueryPlannerInterfaces>(
         rclcpp::names::append(opt_.move_group_namespace_, move_group::QUERY_PLANNERS_SERVICE_NAME),
@@ -200,6 +209,15 @@ public:
       callback_thread_.join();
   }
 
+  /** \brief Wait for the server of \e client, up to the wait_for_servers timeout given to the constructor */
+  template <typename ActionT>
+  bool waitForServer(const std::shared_ptr<rclcpp_action::Client<ActionT>>& client) const
+  {
+    if (client->action_server_is_ready())
+      return true;
+    return client->wait_for_action_server(wait_for_servers_.to_chrono<std::chrono::duration<double>>());
+  }
+
   const std::shared_ptr<tf2_ros::Buffer>& getTF() const
   {
     return tf_buffer_;
@@ -742,15 +760,71 @@ public:
   //    return pick(constructPickupGoal(object.id, std::move(response->grasps), plan_only));
   //  }
 
-  moveit::core::MoveItErrorCode plan(Plan& plan)
-  {
-    if (!move_action_client_ || !move_action_client_->action_server_is_ready())
+  /** \brief Send \e goal to \e client. The returned future is completed with \e make_result applied to the action
+      result, or with \e failure if the server is not ready or rejects the goal. Accepted goals can be canceled with
+      cancelAsyncRequests() until their result arrives. */
+  template <typename ActionT, typename ResultT>
+  std::shared_future<ResultT> sendGoal(const std::shared_ptr<rclcpp_action::Client<ActionT>>& client,
+                                       const typename ActionT::Goal& goal, const std::string& description,
+                                       const ResultT& failure,
+                                       const std::function<ResultT(const typename ActionT::Result&)>& make_result)
+  {
+    using GoalHandle = rclcpp_action::ClientGoalHandle<ActionT>;
+    auto promise = std::make_shared<std::promise<ResultT>>();
+    std::shared_future<ResultT> future = promise->get_future().share();
+    if (client && opt_.lazy_connection_)
+      waitForServer(client);
+    if (!client || !client->action_server_is_ready())
     {
-      RCLCPP_INFO_STREAM(LOGGER, "MoveGroup action client/server not ready");
-      return moveit::core::MoveItErrorCode::FAILURE;
+      RCLCPP_INFO_STREAM(LOGGER, description << " action client/server not ready");
+      promise->set_value(failure);
+      return future;
     }
-    RCLCPP_INFO_STREAM(LOGGER, "MoveGroup action client/server ready");
 
+    auto send_goal_opts = typename rclcpp_action::Client<ActionT>::SendGoalOptions();
+    send_goal_opts.goal_response_callback = [this, client, promise, description,
+                                             failure](typename GoalHandle::SharedPtr goal_handle) {
+      if (!goal_handle)
+      {
+        RCLCPP_INFO(LOGGER, "%s rejected", description.c_str());
+        promise->set_value(failure);
+        return;
+      }
+      RCLCPP_INFO(LOGGER, "%s accepted", description.c_str());
+      std::scoped_lock lock(active_goals_mutex_);
+      active_goals_[goal_handle->get_goal_id()] = [client, goal_handle] { client->async_cancel_goal(goal_handle); };
+    };
+    send_goal_opts.result_callback = [this, promise, description, failure,
+                                      make_result](const typename GoalHandle::WrappedResult& result) {
+      {
+        std::scoped_lock lock(active_goals_mutex_);
+        active_goals_.erase(result.goal_id);
+      }
+
+      switch (result.code)
+      {
+        case rclcpp_action::ResultCode::SUCCEEDED:
+          RCLCPP_INFO(LOGGER, "%s complete!", description.c_str());
+          break;
+        case rclcpp_action::ResultCode::ABORTED:
+          RCLCPP_INFO(LOGGER, "%s aborted", description.c_str());
+          break;
+        case rclcpp_action::ResultCode::CANCELED:
+          RCLCPP_INFO(LOGGER, "%s canceled", description.c_str());
+          break;
+        default:
+          RCLCPP_INFO(LOGGER, "%s unknown result code", description.c_str());
+          break;
+      }
+      promise->set_value(result.result ? make_result(*result.result) : failure);
+    };
+
+    client->async_send_goal(goal, send_goal_opts);
+    return future;
+  }
+
+  std::shared_future<PlanResult> planAsync()
+  {
     moveit_msgs::action::MoveGroup::Goal goal;
     constructGoal(goal);
     goal.planning_options.plan_only = true;
@@ -759,74 +833,35 @@ public:
     goal.planning_options.planning_scene_diff.is_diff = true;
     goal.planning_options.planning_scene_diff.robot_state.is_diff = true;
 
-    bool done = false;
-    rclcpp_action::ResultCode code = rclcpp_action::ResultCode::UNKNOWN;
-    std::shared_ptr<moveit_msgs::action::MoveGroup::Result> res;
-    auto send_goal_opts = rclcpp_action::Client<moveit_msgs::action::MoveGroup>::SendGoalOptions();
-
-    send_goal_opts.goal_response_callback =
-        [&](rclcpp_action::ClientGoalHandle<moveit_msgs::action::MoveGroup>::SharedPtr goal_handle) {
-          if (!goal_handle)
-          {
-            done = true;
-            RCLCPP_INFO(LOGGER, "Planning request rejected");
-          }
-          else
-            RCLCPP_INFO(LOGGER, "Planning request accepted");
-        };
-    send_goal_opts.result_callback =
-        [&](const rclcpp_action::ClientGoalHandle<moveit_msgs::action::MoveGroup>::WrappedResult& result) {
-          res = result.result;
-          code = result.code;
-          done = true;
-
-          switch (result.code)
-          {
-            case rclcpp_action::ResultCode::SUCCEEDED:
-              RCLCPP_INFO(LOGGER, "Planning request complete!");
-              break;
-            case rclcpp_action::ResultCode::ABORTED:
-              RCLCPP_INFO(LOGGER, "Planning request aborted");
-              return;
-            case rclcpp_action::ResultCode::CANCELED:
-              RCLCPP_INFO(LOGGER, "Planning request canceled");
-              return;
-            default:
-              RCLCPP_INFO(LOGGER, "Planning request unknown result code");
-              return;
-          }
-        };
-
-    auto goal_handle_future = move_action_client_->async_send_goal(goal, send_goal_opts);
-
-    // wait until send_goal_opts.result_callback is called
-    while (!done)
-    {
-      std::this_thread::sleep_for(std::chrono::milliseconds(100));
-    }
+    PlanResult failure;
+    failure.error_code = moveit::core::MoveItErrorCode::FAILURE;
+    return sendGoal<moveit_msgs::action::MoveGroup, PlanResult>(
+        move_action_client_, goal, "Planning request", failure, [](const moveit_msgs::action::MoveGroup::Result& res) {
+          PlanResult result;
+          result.error_code = res.error_code;
+          result.plan.trajectory_ = res.planned_trajectory;
+          result.plan.start_state_ = res.trajectory_start;
+          result.plan.planning_time_ = res.planning_time;
+          return result;
+        });
+  }
 
-    if (code != rclcpp_action::ResultCode::SUCCEEDED)
+  moveit::core::MoveItErrorCode plan(Plan& plan)
+  {
+    const PlanResult result = planAsync().get();
+    if (result.error_code != moveit::core::MoveItErrorCode::SUCCESS)
     {
       RCLCPP_ERROR_STREAM(LOGGER, "MoveGroupInterface::plan() failed or timeout reached");
-      return res->error_code;
+      return result.error_code;
     }
 
-    plan.trajectory_ = res->planned_trajectory;
-    plan.start_state_ = res->trajectory_start;
-    plan.planning_time_ = res->planning_time;
+    plan = result.plan;
     RCLCPP_INFO(LOGGER, "time taken to generate plan: %g seconds", plan.planning_time_);
-
-    return res->error_code;
+    return result.error_code;
   }
 
-  moveit::core::MoveItErrorCode move(bool wait)
+  std::shared_future<moveit::core::MoveItErrorCode> moveAsync()
   {
-    if (!move_action_client_ || !move_action_client_->action_server_is_ready())
-    {
-      RCLCPP_INFO_STREAM(LOGGER, "MoveGroup action client/server not ready");
-      return moveit::core::MoveItErrorCode::FAILURE;
-    }
-
     moveit_msgs::action::MoveGroup::Goal goal;
     constructGoal(goal);
     goal.planning_options.plan_only = false;
@@ -836,133 +871,65 @@ public:
     goal.planning_options.planning_scene_diff.is_diff = true;
     goal.planning_options.planning_scene_diff.robot_state.is_diff = true;
 
-    bool done = false;
-    rclcpp_action::ResultCode code = rclcpp_action::ResultCode::UNKNOWN;
-    std::shared_ptr<moveit_msgs::action::MoveGroup_Result> res;
-    auto send_goal_opts = rclcpp_action::Client<moveit_msgs::action::MoveGroup>::SendGoalOptions();
-
-    send_goal_opts.goal_response_callback =
-        [&](rclcpp_action::ClientGoalHandle<moveit_msgs::action::MoveGroup>::SharedPtr goal_handle) {
-          if (!goal_handle)
-          {
-            done = true;
-            RCLCPP_INFO(LOGGER, "Plan and Execute request rejected");
-          }
-          else
-            RCLCPP_INFO(LOGGER, "Plan and Execute request accepted");
-        };
-    send_goal_opts.result_callback =
-        [&](const rclcpp_action::ClientGoalHandle<moveit_msgs::action::MoveGroup>::WrappedResult& result) {
-          res = result.result;
-          code = result.code;
-          done = true;
-
-          switch (result.code)
-          {
-            case rclcpp_action::ResultCode::SUCCEEDED:
-              RCLCPP_INFO(LOGGER, "Plan and Execute request complete!");
-              break;
-            case rclcpp_action::ResultCode::ABORTED:
-              RCLCPP_INFO(LOGGER, "Plan and Execute request aborted");
-              return;
-            case rclcpp_action::ResultCode::CANCELED:
-              RCLCPP_INFO(LOGGER, "Plan and Execute request canceled");
-              return;
-            default:
-              RCLCPP_INFO(LOGGER, "Plan and Execute request unknown result code");
-              return;
-          }
-        };
-    auto goal_handle_future = move_action_client_->async_send_goal(goal, send_goal_opts);
+    return sendGoal<moveit_msgs::action::MoveGroup, moveit::core::MoveItErrorCode>(
+        move_action_client_, goal, "Plan and Execute request", moveit::core::MoveItErrorCode::FAILURE,
+        [](const moveit_msgs::action::MoveGroup::Result& res) {
+          return moveit::core::MoveItErrorCode(res.error_code);
+        });
+  }
+
+  moveit::core::MoveItErrorCode move(bool wait)
+  {
+    std::shared_future<moveit::core::MoveItErrorCode> future = moveAsync();
     if (!wait)
       return moveit::core::MoveItErrorCode::SUCCESS;
 
-    // wait until send_goal_opts.result_callback is called
-    while (!done)
-    {
-      std::this_thread::sleep_for(std::chrono::milliseconds(100));
-    }
-
-    if (code != rclcpp_action::ResultCode::SUCCEEDED)
+    const moveit::core::MoveItErrorCode error_code = future.get();
+    if (error_code != moveit::core::MoveItErrorCode::SUCCESS)
     {
       RCLCPP_ERROR_STREAM(LOGGER, "MoveGroupInterface::move() failed or timeout reached");
     }
-    return res->error_code;
+    return error_code;
   }
 
-  moveit::core::MoveItErrorCode execute(const moveit_msgs::msg::RobotTrajectory& trajectory, bool wait)
+  std::shared_future<moveit::core::MoveItErrorCode> executeAsync(const moveit_msgs::msg::RobotTrajectory& trajectory)
   {
-    if (!execute_action_client_ || !execute_action_client_->action_server_is_ready())
-    {
-      RCLCPP_INFO_STREAM(LOGGER, "execute_action_client_ client/server not ready");
-      return moveit::core::MoveItErrorCode::FAILURE;
-    }
-
-    bool done = false;
-    rclcpp_action::ResultCode code = rclcpp_action::ResultCode::UNKNOWN;
-    std::shared_ptr<moveit_msgs::action::ExecuteTrajectory_Result> res;
-    auto send_goal_opts = rclcpp_action::Client<moveit_msgs::action::ExecuteTrajectory>::SendGoalOptions();
-
-    send_goal_opts.goal_response_callback =
-        [&](rclcpp_action::ClientGoalHandle<moveit_msgs::action::ExecuteTrajectory>::SharedPtr goal_handle) {
-          if (!goal_handle)
-          {
-            done = true;
-            RCLCPP_INFO(LOGGER, "Execute request rejected");
-          }
-          else
-            RCLCPP_INFO(LOGGER, "Execute request accepted");
-        };
-    send_goal_opts.result_callback =
-        [&](const rclcpp_action::ClientGoalHandle<moveit_msgs::action::ExecuteTrajectory>::WrappedResult& result) {
-          res = result.result;
-          code = result.code;
-          done = true;
-
-          switch (result.code)
-          {
-            case rclcpp_action::ResultCode::SUCCEEDED:
-              RCLCPP_INFO(LOGGER, "Execute request success!");
-              break;
-            case rclcpp_action::ResultCode::ABORTED:
-              RCLCPP_INFO(LOGGER, "Execute request aborted");
-              return;
-            case rclcpp_action::ResultCode::CANCELED:
-              RCLCPP_INFO(LOGGER, "Execute request canceled");
-              return;
-            default:
-              RCLCPP_INFO(LOGGER, "Execute request unknown result code");
-              return;
-          }
-        };
-
     moveit_msgs::action::ExecuteTrajectory::Goal goal;
     goal.trajectory = trajectory;
 
-    auto goal_handle_future = execute_action_client_->async_send_goal(goal, send_goal_opts);
+    return sendGoal<moveit_msgs::action::ExecuteTrajectory, moveit::core::MoveItErrorCode>(
+        execute_action_client_, goal, "Execute request", moveit::core::MoveItErrorCode::FAILURE,
+        [](const moveit_msgs::action::ExecuteTrajectory::Result& res) {
+          return moveit::core::MoveItErrorCode(res.error_code);
+        });
+  }
+
+  moveit::core::MoveItErrorCode execute(const moveit_msgs::msg::RobotTrajectory& trajectory, bool wait)
+  {
+    std::shared_future<moveit::core::MoveItErrorCode> future = executeAsync(trajectory);
     if (!wait)
       return moveit::core::MoveItErrorCode::SUCCESS;
 
-    // wait until send_goal_opts.result_callback is called
-    while (!done)
-    {
-      std::this_thread::sleep_for(std::chrono::milliseconds(100));
-    }
-
-    if (code != rclcpp_action::ResultCode::SUCCEEDED)
+    const moveit::core::MoveItErrorCode error_code = future.get();
+    if (error_code != moveit::core::MoveItErrorCode::SUCCESS)
     {
       RCLCPP_ERROR_STREAM(LOGGER, "MoveGroupInterface::execute() failed or timeout reached");
     }
-    return res->error_code;
+    return error_code;
   }
 
-  double computeCartesianPath(const std::vector<geometry_msgs::msg::Pose>& waypoints, double step,
-                              double jump_threshold, moveit_msgs::msg::RobotTrajectory& msg,
-                              const moveit_msgs::msg::Constraints& path_constraints, bool avoid_collisions,
-                              moveit_msgs::msg::MoveItErrorCodes& error_code)
+  void cancelAsyncRequests()
+  {
+    std::scoped_lock lock(active_goals_mutex_);
+    for (const auto& active_goal : active_goals_)
+      active_goal.second();
+  }
+
+  std::shared_future<moveit_msgs::srv::GetCartesianPath::Response::SharedPtr>
+  computeCartesianPathAsync(const std::vector<geometry_msgs::msg::Pose>& waypoints, double step, double jump_threshold,
+                            const moveit_msgs::msg::Constraints& path_constraints, bool avoid_collisions)
   {
     auto req = std::make_shared<moveit_msgs::srv::GetCartesianPath::Request>();
-    moveit_msgs::srv::GetCartesianPath::Response::SharedPtr response;
 
     if (considered_start_state_)
       moveit::core::robotStateToRobotStateMsg(*considered_start_state_, req->start_state);
@@ -979,24 +946,36 @@ public:
     req->avoid_collisions = avoid_collisions;
     req->link_name = getEndEffectorLink();
 
-    auto future_response = cartesian_path_service_->async_send_request(req);
-    if (future_response.valid())
-    {
-      response = future_response.get();
-      error_code = response->error_code;
-      if (response->error_code.val == moveit_msgs::msg::MoveItErrorCodes::SUCCESS)
-      {
-        msg = response->solution;
-        return response->fraction;
-      }
-      else
-        return -1.0;
-    }
-    else
+    auto promise = std::make_shared<std::promise<moveit_msgs::srv::GetCartesianPath::Response::SharedPtr>>();
+    std::shared_future<moveit_msgs::srv::GetCartesianPath::Response::SharedPtr> future = promise->get_future().share();
+    cartesian_path_service_->async_send_request(
+        req, [promise](rclcpp::Client<moveit_msgs::srv::GetCartesianPath>::SharedFuture response) {
+          promise->set_value(response.get());
+        });
+    return future;
+  }
+
+  double computeCartesianPath(const std::vector<geometry_msgs::msg::Pose>& waypoints, double step,
+                              double jump_threshold, moveit_msgs::msg::RobotTrajectory& msg,
+                              const moveit_msgs::msg::Constraints& path_constraints, bool avoid_collisions,
+                              moveit_msgs::msg::MoveItErrorCodes& error_code)
+  {
+    const moveit_msgs::srv::GetCartesianPath::Response::SharedPtr response =
+        computeCartesianPathAsync(waypoints, step, jump_threshold, path_constraints, avoid_collisions).get();
+    if (!response)
     {
       error_code.val = error_code.FAILURE;
       return -1.0;
     }
+
+    error_code = response->error_code;
+    if (response->error_code.val == moveit_msgs::msg::MoveItErrorCodes::SUCCESS)
+    {
+      msg = response->solution;
+      return response->fraction;
+    }
+    else
+      return -1.0;
   }
 
   void stop()
@@ -1348,6 +1327,11 @@ private:
   // std::shared_ptr<rclcpp_action::Client<moveit_msgs::action::Pickup>> pick_action_client_;
   // std::shared_ptr<rclcpp_action::Client<moveit_msgs::action::Place>> place_action_client_;
   std::shared_ptr<rclcpp_action::Client<moveit_msgs::action::ExecuteTrajectory>> execute_action_client_;
+  rclcpp::Duration wait_for_servers_;
+
+  // cancel functions of the accepted action goals that did not return a result yet
+  std::mutex active_goals_mutex_;
+  std::map<rclcpp_action::GoalUUID, std::function<void()>> active_goals_;
 
   // general planning params
   moveit::core::RobotStatePtr considered_start_state_;
@@ -1561,6 +1545,32 @@ moveit::core::MoveItErrorCode MoveGroupInterface::plan(Plan& plan)
   return impl_->plan(plan);
 }
 
+std::shared_future<MoveGroupInterface::PlanResult> MoveGroupInterface::planAsync()
+{
+  return impl_->planAsync();
+}
+
+std::shared_future<moveit::core::MoveItErrorCode> MoveGroupInterface::moveAsync()
+{
+  return impl_->moveAsync();
+}
+
+std::shared_future<moveit::core::MoveItErrorCode> MoveGroupInterface::executeAsync(const Plan& plan)
+{
+  return impl_->executeAsync(plan.trajectory_);
+}
+
+std::shared_future<moveit::core::MoveItErrorCode>
+MoveGroupInterface::executeAsync(const moveit_msgs::msg::RobotTrajectory& trajectory)
+{
+  return impl_->executeAsync(trajectory);
+}
+
+void MoveGroupInterface::cancelAsyncRequests()
+{
+  impl_->cancelAsyncRequests();
+}
+
 // moveit_msgs::action::Pickup::Goal MoveGroupInterface::constructPickupGoal(const std::string& object,
 //                                                                        std::vector<moveit_msgs::msg::Grasp> grasps,
 //                                                                        bool plan_only = false) const
@@ -1628,6 +1638,15 @@ double MoveGroupInterface::computeCartesianPath(const std::vector<geometry_msgs:
   }
 }
 
+std::shared_future<moveit_msgs::srv::GetCartesianPath::Response::SharedPtr>
+MoveGroupInterface::computeCartesianPathAsync(const std::vector<geometry_msgs::msg::Pose>& waypoints, double eef_step,
+                                              double jump_threshold,
+                                              const moveit_msgs::msg::Constraints& path_constraints,
+                                              bool avoid_collisions)
+{
+  return impl_->computeCartesianPathAsync(waypoints, eef_step, jump_threshold, path_constraints, avoid_collisions);
+}
+
 void MoveGroupInterface::stop()
 {
   impl_->stop();
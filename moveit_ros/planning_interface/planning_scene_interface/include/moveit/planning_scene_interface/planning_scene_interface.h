@@ -114,6 +114,18 @@ public:
       const std::vector<moveit_msgs::msg::CollisionObject>& collision_objects,
       const std::vector<moveit_msgs::msg::ObjectColor>& object_colors = std::vector<moveit_msgs::msg::ObjectColor>());
 
+  /** \brief Make the collision objects synchronized by earlier calls match \e collision_objects, synchronously.
+      Only the difference to the previous call is sent, as a single planning scene diff: objects that are new or whose
+      geometry changed are added, objects that only moved are sent as MOVE operations without their geometry,
+      unchanged objects are not sent at all, and objects that were synchronized before but are missing from
+      \e collision_objects are removed. Objects added to the scene by other means are left alone.
+      The operation of the given objects is ignored. If object_colors do not specify an id, the corresponding object id
+      from collision_objects is used; colors are only sent when they changed.
+      Other PlanningSceneMonitors will NOT receive the update unless they subscribe to move_group's monitored scene */
+  bool syncCollisionObjects(
+      const std::vector<moveit_msgs::msg::CollisionObject>& collision_objects,
+      const std::vector<moveit_msgs::msg::ObjectColor>& object_colors = std::vector<moveit_msgs::msg::ObjectColor>());
+
   /** \brief Apply attached collision object to the planning scene of the move_group node synchronously.
       Other PlanningSceneMonitors will NOT receive the update unless they subscribe to move_group's monitored scene */
   bool applyAttachedCollisionObject(const moveit_msgs::msg::AttachedCollisionObject& attached_collision_object);
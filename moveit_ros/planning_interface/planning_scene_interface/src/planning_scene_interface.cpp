@@ -39,6 +39,8 @@
 #include <moveit_msgs/srv/get_planning_scene.hpp>
 #include <moveit_msgs/srv/apply_planning_scene.hpp>
 #include <algorithm>
+#include <functional>
+#include <optional>
 #include <rclcpp/executors.hpp>
 #include <rclcpp/future_return_code.hpp>
 
@@ -48,6 +50,70 @@ namespace planning_interface
 {
 static const rclcpp::Logger LOGGER = rclcpp::get_logger("moveit_ros.planning_scene_interface.planning_scene_interface");
 
+namespace
+{
+void hashCombine(std::size_t& seed, double value)
+{
+  seed ^= std::hash<double>()(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+void hashCombine(std::size_t& seed, const std::string& value)
+{
+  seed ^= std::hash<std::string>()(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+void hashCombine(std::size_t& seed, const geometry_msgs::msg::Pose& pose)
+{
+  for (double value : { pose.position.x, pose.position.y, pose.position.z, pose.orientation.x, pose.orientation.y,
+                        pose.orientation.z, pose.orientation.w })
+    hashCombine(seed, value);
+}
+
+/** A hash of everything in \e object but its header, pose and operation, i.e. of what a MOVE operation keeps */
+std::size_t hashObjectGeometry(const moveit_msgs::msg::CollisionObject& object)
+{
+  std::size_t seed = 0;
+  hashCombine(seed, object.type.key);
+  hashCombine(seed, object.type.db);
+  for (std::size_t i = 0; i < object.primitives.size(); ++i)
+  {
+    hashCombine(seed, object.primitives[i].type);
+    for (double dimension : object.primitives[i].dimensions)
+      hashCombine(seed, dimension);
+    if (i < object.primitive_poses.size())
+      hashCombine(seed, object.primitive_poses[i]);
+  }
+  for (std::size_t i = 0; i < object.meshes.size(); ++i)
+  {
+    for (const geometry_msgs::msg::Point& vertex : object.meshes[i].vertices)
+    {
+      hashCombine(seed, vertex.x);
+      hashCombine(seed, vertex.y);
+      hashCombine(seed, vertex.z);
+    }
+    for (const shape_msgs::msg::MeshTriangle& triangle : object.meshes[i].triangles)
+      for (uint32_t index : triangle.vertex_indices)
+        hashCombine(seed, index);
+    if (i < object.mesh_poses.size())
+      hashCombine(seed, object.mesh_poses[i]);
+  }
+  for (std::size_t i = 0; i < object.planes.size(); ++i)
+  {
+    for (double coefficient : object.planes[i].coef)
+      hashCombine(seed, coefficient);
+    if (i < object.plane_poses.size())
+      hashCombine(seed, object.plane_poses[i]);
+  }
+  for (std::size_t i = 0; i < object.subframe_names.size(); ++i)
+  {
+    hashCombine(seed, object.subframe_names[i]);
+    if (i < object.subframe_poses.size())
+      hashCombine(seed, object.subframe_poses[i]);
+  }
+  return seed;
+}
+}  // namespace
+
 class PlanningSceneInterface::PlanningSceneInterfaceImpl
 {
 public:
@@ -256,6 +322,88 @@ public:
     planning_scene_diff_publisher_->publish(planning_scene);
   }
 
+  bool syncCollisionObjects(const std::vector<moveit_msgs::msg::CollisionObject>& collision_objects,
+                            const std::vector<moveit_msgs::msg::ObjectColor>& object_colors)
+  {
+    moveit_msgs::msg::PlanningScene planning_scene;
+    planning_scene.robot_state.is_diff = true;
+    planning_scene.is_diff = true;
+
+    std::map<std::string, SyncedObject> synced_objects;
+    for (std::size_t i = 0; i < collision_objects.size(); ++i)
+    {
+      const moveit_msgs::msg::CollisionObject& object = collision_objects[i];
+      SyncedObject& synced = synced_objects[object.id];
+      synced.geometry_hash = hashObjectGeometry(object);
+      synced.header_frame = object.header.frame_id;
+      synced.pose = object.pose;
+      const auto previous = synced_objects_.find(object.id);
+      if (i < object_colors.size() && (object_colors[i].id.empty() || object_colors[i].id == object.id))
+        synced.color = object_colors[i].color;
+      else if (previous != synced_objects_.end())
+        synced.color = previous->second.color;
+
+      if (previous == synced_objects_.end() || previous->second.geometry_hash != synced.geometry_hash)
+      {
+        // ADD replaces an existing object of the same id
+        planning_scene.world.collision_objects.push_back(object);
+        planning_scene.world.collision_objects.back().operation = moveit_msgs::msg::CollisionObject::ADD;
+      }
+      else if (previous->second.header_frame != synced.header_frame || previous->second.pose != synced.pose)
+      {
+        moveit_msgs::msg::CollisionObject move;
+        move.header = object.header;
+        move.id = object.id;
+        move.pose = object.pose;
+        move.operation = moveit_msgs::msg::CollisionObject::MOVE;
+        planning_scene.world.collision_objects.push_back(move);
+      }
+
+      if (synced.color && (previous == synced_objects_.end() || previous->second.color != synced.color))
+      {
+        moveit_msgs::msg::ObjectColor color;
+        color.id = object.id;
+        color.color = *synced.color;
+        planning_scene.object_colors.push_back(color);
+      }
+    }
+    for (const moveit_msgs::msg::ObjectColor& color : object_colors)
+    {
+      auto it = synced_objects.find(color.id);
+      if (!color.id.empty() && it != synced_objects.end() && it->second.color != color.color)
+      {
+        it->second.color = color.color;
+        planning_scene.object_colors.push_back(color);
+      }
+    }
+
+    for (const auto& [id, synced] : synced_objects_)
+    {
+      if (synced_objects.count(id))
+        continue;
+      moveit_msgs::msg::CollisionObject remove;
+      remove.id = id;
+      remove.operation = moveit_msgs::msg::CollisionObject::REMOVE;
+      planning_scene.world.collision_objects.push_back(remove);
+    }
+
+    if (planning_scene.world.collision_objects.empty() && planning_scene.object_colors.empty())
+      return true;
+
+    if (!applyPlanningScene(planning_scene))
+    {
+      // the scene may have applied part of the diff; forget the geometry, so the next call sends all objects again
+      for (auto& [id, synced] : synced_objects)
+        synced = SyncedObject();
+      for (const auto& [id, synced] : synced_objects_)
+        synced_objects.emplace(id, SyncedObject());
+      synced_objects_ = std::move(synced_objects);
+      return false;
+    }
+    synced_objects_ = std::move(synced_objects);
+    return true;
+  }
+
   void removeCollisionObjects(const std::vector<std::string>& object_ids) const
   {
     moveit_msgs::msg::PlanningScene planning_scene;
@@ -271,6 +419,15 @@ public:
   }
 
 private:
+  // What syncCollisionObjects() last applied for an object
+  struct SyncedObject
+  {
+    std::size_t geometry_hash = 0;
+    std::string header_frame;
+    geometry_msgs::msg::Pose pose;
+    std::optional<std_msgs::msg::ColorRGBA> color;
+  };
+
   void waitForService(std::shared_ptr<rclcpp::ClientBase> srv)
   {
     // rclcpp::Duration time_before_warning(5.0);
@@ -289,6 +446,7 @@ private:
   rclcpp::Client<moveit_msgs::srv::ApplyPlanningScene>::SharedPtr apply_planning_scene_service_;
   rclcpp::Publisher<moveit_msgs::msg::PlanningScene>::SharedPtr planning_scene_diff_publisher_;
   moveit::core::RobotModelConstPtr robot_model_;
+  std::map<std::string, SyncedObject> synced_objects_;
 };
 
 PlanningSceneInterface::PlanningSceneInterface(const std::string& ns, bool wait)
@@ -378,6 +536,13 @@ bool PlanningSceneInterface::applyCollisionObjects(
   return applyPlanningScene(ps);
 }
 
+bool PlanningSceneInterface::syncCollisionObjects(
+    const std::vector<moveit_msgs::msg::CollisionObject>& collision_objects,
+    const std::vector<moveit_msgs::msg::ObjectColor>& object_colors)
+{
+  return impl_->syncCollisionObjects(collision_objects, object_colors);
+}
+
 bool PlanningSceneInterface::applyAttachedCollisionObject(
     const moveit_msgs::msg::AttachedCollisionObject& collision_object)
 {
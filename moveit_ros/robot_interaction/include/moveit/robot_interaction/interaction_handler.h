@@ -44,6 +44,11 @@
 #include <interactive_markers/menu_handler.hpp>
 #include <tf2_ros/buffer.h>
 
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+
 namespace robot_interaction
 {
 MOVEIT_CLASS_FORWARD(InteractionHandler);   // Defines InteractionHandlerPtr, ConstPtr, WeakPtr... etc
@@ -92,9 +97,7 @@ public:
   InteractionHandler(const std::string& name, const moveit::core::RobotModelConstPtr& model,
                      const std::shared_ptr<tf2_ros::Buffer>& tf_buffer = std::shared_ptr<tf2_ros::Buffer>());
 
-  ~InteractionHandler() override
-  {
-  }
+  ~InteractionHandler() override;
 
   const std::string& getName() const
   {
@@ -189,7 +192,11 @@ public:
   void clearLastMarkerPoses();
 
   /** \brief Update the internal state maintained by the handler using
-   * information from the received feedback message. */
+   * information from the received feedback message.
+   *
+   * The IK is solved asynchronously on a worker thread of the handler: only the latest pose of each end-effector is
+   * kept, a solve that is superseded by a newer pose is abandoned, and each solve is seeded from the previous
+   * solution. The update callback is called from the worker once the state has been updated. */
   virtual void handleEndEffector(const EndEffectorInteraction& eef,
                                  const visualization_msgs::msg::InteractiveMarkerFeedback::ConstSharedPtr& feedback);
 
@@ -235,10 +242,20 @@ private:
                           const visualization_msgs::msg::InteractiveMarkerFeedback::ConstSharedPtr& feedback,
                           StateChangeCallbackFn& callback);
 
-  // Update RobotState for a new pose of an eef.
-  // YOU MUST LOCK state_lock_ BEFORE CALLING THIS.
-  void updateStateEndEffector(moveit::core::RobotState& state, const EndEffectorInteraction& eef,
-                              const geometry_msgs::msg::Pose& pose, StateChangeCallbackFn& callback);
+  // The latest end-effector pose to solve IK for
+  struct EndEffectorRequest
+  {
+    std::string group;
+    std::string tip;
+    geometry_msgs::msg::Pose pose;
+  };
+
+  // Solve the queued end-effector requests until the handler is destroyed.
+  void endEffectorThread();
+
+  // Solve IK for \e request on a copy of the state and apply the solution, unless a newer
+  // request for the same group arrived before a solution was found.
+  void solveEndEffector(const EndEffectorRequest& request);
 
   // Update RobotState for a new joint position.
   // YOU MUST LOCK state_lock_ BEFORE CALLING THIS.
@@ -307,6 +324,19 @@ private:
   // PROTECTED BY state_lock_
   bool display_controls_;
 
+  // The latest pending end-effector request for each group, waiting for end_effector_thread_.
+  // PROTECTED BY end_effector_lock_
+  std::map<std::string, EndEffectorRequest> end_effector_requests_;
+
+  // PROTECTED BY end_effector_lock_
+  bool run_end_effector_thread_ = false;
+
+  std::mutex end_effector_lock_;
+  std::condition_variable end_effector_condition_;
+
+  // Started with the first end-effector request
+  std::thread end_effector_thread_;
+
   // remove '_' characters from name
   static std::string fixName(std::string name);
 };
@@ -56,6 +56,7 @@
 #endif
 #include <algorithm>
 #include <string>
+#include <vector>
 
 #include <Eigen/Core>
 #include <Eigen/Geometry>
@@ -89,6 +90,17 @@ InteractionHandler::InteractionHandler(const RobotInteractionPtr& robot_interact
 {
 }
 
+InteractionHandler::~InteractionHandler()
+{
+  {
+    std::scoped_lock lock(end_effector_lock_);
+    run_end_effector_thread_ = false;
+    end_effector_condition_.notify_all();
+  }
+  if (end_effector_thread_.joinable())
+    end_effector_thread_.join();
+}
+
 std::string InteractionHandler::fixName(std::string name)
 {
   std::replace(name.begin(), name.end(), '_', '-');  // we use _ as a special char in marker name
@@ -247,12 +259,94 @@ void InteractionHandler::handleEndEffector(
   else
     return;
 
-  StateChangeCallbackFn callback;
+  // Solving IK can take longer than the feedback keeps coming in, so only the latest pose of each group is kept
+  // and solved on end_effector_thread_; this also keeps state_lock_ free while the solver runs.
+  std::scoped_lock lock(end_effector_lock_);
+  end_effector_requests_[eef.parent_group] = EndEffectorRequest{ eef.parent_group, eef.parent_link, tpose.pose };
+  if (!end_effector_thread_.joinable())
+  {
+    run_end_effector_thread_ = true;
+    end_effector_thread_ = std::thread([this] { endEffectorThread(); });
+  }
+  end_effector_condition_.notify_all();
+}
 
-  // modify the RobotState in-place with state_lock_ held.
-  // This locks state_lock_ before calling updateState()
-  LockedRobotState::modifyState([this, &eef, &pose = tpose.pose, &callback](moveit::core::RobotState* state) {
-    updateStateEndEffector(*state, eef, pose, callback);
+void InteractionHandler::endEffectorThread()
+{
+  std::unique_lock<std::mutex> lock(end_effector_lock_);
+  while (true)
+  {
+    end_effector_condition_.wait(lock, [this] { return !run_end_effector_thread_ || !end_effector_requests_.empty(); });
+    if (!run_end_effector_thread_)
+      return;
+
+    EndEffectorRequest request = std::move(end_effector_requests_.begin()->second);
+    end_effector_requests_.erase(end_effector_requests_.begin());
+    lock.unlock();
+    try
+    {
+      solveEndEffector(request);
+    }
+    catch (std::exception& ex)
+    {
+      RCLCPP_ERROR(LOGGER, "Exception caught while handling end-effector update: %s", ex.what());
+    }
+    lock.lock();
+  }
+}
+
+void InteractionHandler::solveEndEffector(const EndEffectorRequest& request)
+{
+  // kinematics solvers need not be safe to call concurrently, and the handlers of one RobotInteraction share them
+  static std::mutex solver_lock;
+
+  KinematicOptions kinematic_options;
+  {
+    std::scoped_lock lock(state_lock_);
+    kinematic_options = kinematic_options_map_->getOptions(request.group);
+  }
+
+  // Abandon the search as soon as a newer pose for the group is waiting. Accepting the candidate ends the search
+  // right away; the result is thrown away below.
+  bool superseded = false;
+  moveit::core::GroupStateValidityCallbackFn validity = kinematic_options.state_validity_callback_;
+  kinematic_options.state_validity_callback_ = [this, &request, &superseded, validity](
+                                                   moveit::core::RobotState* state,
+                                                   const moveit::core::JointModelGroup* jmg, const double* values) {
+    {
+      std::scoped_lock lock(end_effector_lock_);
+      superseded = end_effector_requests_.count(request.group) > 0;
+    }
+    return superseded || !validity || validity(state, jmg, values);
+  };
+
+  // seed from the previous solution
+  moveit::core::RobotState state(*getState());
+  bool ok;
+  {
+    std::scoped_lock lock(solver_lock);
+    ok = kinematic_options.setStateFromIK(state, request.group, request.tip, request.pose);
+  }
+  if (superseded)
+    return;
+
+  const moveit::core::JointModelGroup* jmg = state.getJointModelGroup(request.group);
+  std::vector<double> solution;
+  if (ok && jmg)
+    state.copyJointGroupPositions(jmg, solution);
+
+  StateChangeCallbackFn callback;
+  LockedRobotState::modifyState([this, &request, ok, jmg, &solution, &callback](moveit::core::RobotState* state) {
+    if (!solution.empty())
+    {
+      state->setJointGroupPositions(jmg, solution);
+      state->update();
+    }
+    bool error_state_changed = setErrorState(request.group, !ok);
+    if (update_callback_)
+      callback = [cb = this->update_callback_, error_state_changed](robot_interaction::InteractionHandler* handler) {
+        cb(handler, error_state_changed);
+      };
   });
 
   // This calls update_callback_ to notify client that state changed.
@@ -305,22 +399,6 @@ void InteractionHandler::updateStateGeneric(
     };
 }
 
-// MUST hold state_lock_ when calling this!
-void InteractionHandler::updateStateEndEffector(moveit::core::RobotState& state, const EndEffectorInteraction& eef,
-                                                const geometry_msgs::msg::Pose& pose, StateChangeCallbackFn& callback)
-{
-  // This is called with state_lock_ held, so no additional locking needed to
-  // access kinematic_options_map_.
-  KinematicOptions kinematic_options = kinematic_options_map_->getOptions(eef.parent_group);
-
-  bool ok = kinematic_options.setStateFromIK(state, eef.parent_group, eef.parent_link, pose);
-  bool error_state_changed = setErrorState(eef.parent_group, !ok);
-  if (update_callback_)
-    callback = [cb = this->update_callback_, error_state_changed](robot_interaction::InteractionHandler* handler) {
-      cb(handler, error_state_changed);
-    };
-}
-
 // MUST hold state_lock_ when calling this!
 void InteractionHandler::updateStateJoint(moveit::core::RobotState& state, const JointInteraction& vj,
                                           const geometry_msgs::msg::Pose& feedback_pose,
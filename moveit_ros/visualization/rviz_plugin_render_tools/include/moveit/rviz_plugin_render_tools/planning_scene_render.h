@@ -41,6 +41,9 @@
 #include <moveit/rviz_plugin_render_tools/render_shapes.h>
 #include <rviz_common/properties/color_property.hpp>
 #include <OgreMaterial.h>
+#include <map>
+#include <string>
+#include <vector>
 
 namespace moveit_rviz_plugin
 {
@@ -74,9 +77,29 @@ public:
   void clear();
 
 private:
+  /** \brief The geometry rendered for one world object, together with what it was rendered from.
+   *
+   * Shapes are rendered relative to \e node, which carries the object pose. A pose-only change therefore just
+   * moves the node, and the shapes are only rebuilt when the shapes, their local poses or the appearance change. */
+  struct RenderedObject
+  {
+    Ogre::SceneNode* node = nullptr;
+    RenderShapesPtr render_shapes;
+    std::vector<shapes::ShapeConstPtr> shapes;
+    EigenSTL::vector_Isometry3d shape_poses;
+    Ogre::ColourValue color;
+    float alpha = 1.0f;
+    OctreeVoxelRenderMode octree_voxel_rendering = OCTOMAP_DISABLED;
+    OctreeVoxelColorMode octree_color_mode = OCTOMAP_Z_AXIS_COLOR;
+  };
+
+  void destroyRenderedObject(RenderedObject& rendered);
+
   Ogre::SceneNode* planning_scene_geometry_node_;
   rviz_common::DisplayContext* context_;
-  RenderShapesPtr render_shapes_;
   RobotStateVisualizationPtr scene_robot_;
+
+  /** \brief Rendered world objects, indexed by object id */
+  std::map<std::string, RenderedObject> rendered_objects_;
 };
 }  // namespace moveit_rviz_plugin
@@ -41,6 +41,7 @@
 #include <rviz_common/panel_dock_widget.hpp>
 #include <rviz_common/properties/int_property.hpp>
 #include <rviz_common/properties/ros_topic_property.hpp>
+#include <future>
 #include <mutex>
 
 #ifndef Q_MOC_RUN
@@ -115,6 +116,7 @@ private Q_SLOTS:
   void changedLoopDisplay();
   void changedShowTrail();
   void changedTrailStepSize();
+  void changedTrailMinDistance();
   void changedTrajectoryTopic();
   void changedStateDisplayTime();
   void changedRobotColor();
@@ -135,6 +137,27 @@ protected:
   float getStateDisplayTime();
   void clearTrajectoryTrail();
 
+  /**
+   * \brief The waypoints shown in the trail of \e trajectory: every step size-th waypoint, skipping those where no
+   * link moved by the trail's minimum distance since the previously shown one, and always the last waypoint
+   */
+  std::vector<std::size_t> selectTrailWaypoints(const robot_trajectory::RobotTrajectory& trajectory) const;
+
+  /**
+   * \brief Move a trajectory that finished preparing on the worker thread to trajectory_message_to_display_
+   */
+  void takePreparedTrajectory();
+
+  /**
+   * \brief A received trajectory with the forward kinematics of all of its waypoints computed, or the error that
+   * made its conversion fail
+   */
+  struct PreparedTrajectory
+  {
+    robot_trajectory::RobotTrajectoryPtr trajectory;
+    std::string error;
+  };
+
   // Handles actually drawing the robot along motion plans
   RobotStateVisualizationPtr display_path_robot_;
   std_msgs::msg::ColorRGBA default_attached_object_color_;
@@ -146,6 +169,8 @@ protected:
   robot_trajectory::RobotTrajectoryPtr displaying_trajectory_message_;
   robot_trajectory::RobotTrajectoryPtr trajectory_message_to_display_;
   std::vector<RobotStateVisualizationUniquePtr> trajectory_trail_;
+  std::vector<std::size_t> trajectory_trail_waypoints_;  // the waypoint shown by each robot of trajectory_trail_
+  std::future<PreparedTrajectory> prepared_trajectory_;   // guarded by update_trajectory_message_
   rclcpp::Subscription<moveit_msgs::msg::DisplayTrajectory>::SharedPtr trajectory_topic_sub_;
   bool animating_path_;
   bool drop_displaying_trajectory_;
@@ -178,6 +203,7 @@ protected:
   rviz_common::properties::ColorProperty* robot_color_property_;
   rviz_common::properties::BoolProperty* enable_robot_color_property_;
   rviz_common::properties::IntProperty* trail_step_size_property_;
+  rviz_common::properties::FloatProperty* trail_min_distance_property_;
 };
 
 }  // namespace moveit_rviz_plugin
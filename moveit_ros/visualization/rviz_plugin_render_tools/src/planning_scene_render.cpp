@@ -42,17 +42,19 @@
 #include <OgreSceneNode.h>
 #include <OgreSceneManager.h>
 
+#include <algorithm>
+
 namespace moveit_rviz_plugin
 {
 PlanningSceneRender::PlanningSceneRender(Ogre::SceneNode* node, rviz_common::DisplayContext* context,
                                          const RobotStateVisualizationPtr& robot)
   : planning_scene_geometry_node_(node->createChildSceneNode()), context_(context), scene_robot_(robot)
 {
-  render_shapes_ = std::make_shared<RenderShapes>(context);
 }
 
 PlanningSceneRender::~PlanningSceneRender()
 {
+  clear();
   context_->getSceneManager()->destroySceneNode(planning_scene_geometry_node_);
 }
 
@@ -68,7 +70,18 @@ void PlanningSceneRender::updateRobotPosition(const planning_scene::PlanningScen
 
 void PlanningSceneRender::clear()
 {
-  render_shapes_->clear();
+  for (auto& [id, rendered] : rendered_objects_)
+    destroyRenderedObject(rendered);
+  rendered_objects_.clear();
+}
+
+void PlanningSceneRender::destroyRenderedObject(RenderedObject& rendered)
+{
+  // the shapes are attached to the node, so they have to go first
+  rendered.render_shapes.reset();
+  if (rendered.node)
+    context_->getSceneManager()->destroySceneNode(rendered.node);
+  rendered.node = nullptr;
 }
 
 void PlanningSceneRender::renderPlanningScene(const planning_scene::PlanningSceneConstPtr& scene,
@@ -80,8 +93,6 @@ void PlanningSceneRender::renderPlanningScene(const planning_scene::PlanningScen
   if (!scene)
     return;
 
-  clear();
-
   if (scene_robot_)
   {
     moveit::core::RobotState* rs = new moveit::core::RobotState(scene->getCurrentState());
@@ -97,10 +108,23 @@ void PlanningSceneRender::renderPlanningScene(const planning_scene::PlanningScen
     scene_robot_->update(moveit::core::RobotStateConstPtr(rs), color, color_map);
   }
 
-  const std::vector<std::string>& ids = scene->getWorld()->getObjectIds();
+  // drop the objects that are no longer part of the world
+  const collision_detection::WorldConstPtr& world = scene->getWorld();
+  for (auto it = rendered_objects_.begin(); it != rendered_objects_.end();)
+  {
+    if (world->hasObject(it->first))
+    {
+      ++it;
+      continue;
+    }
+    destroyRenderedObject(it->second);
+    it = rendered_objects_.erase(it);
+  }
+
+  const std::vector<std::string>& ids = world->getObjectIds();
   for (const std::string& id : ids)
   {
-    collision_detection::CollisionEnv::ObjectConstPtr object = scene->getWorld()->getObject(id);
+    collision_detection::CollisionEnv::ObjectConstPtr object = world->getObject(id);
     Ogre::ColourValue color = default_env_color;
     float alpha = default_scene_alpha;
     if (scene->hasObjectColor(id))
@@ -111,12 +135,40 @@ void PlanningSceneRender::renderPlanningScene(const planning_scene::PlanningScen
       color.b = c.b;
       alpha = c.a;
     }
-    for (std::size_t j = 0; j < object->shapes_.size(); ++j)
+
+    RenderedObject& rendered = rendered_objects_[id];
+    if (!rendered.node)
+      rendered.node = planning_scene_geometry_node_->createChildSceneNode();
+
+    // world shapes are immutable and replaced on change, so comparing the pointers is enough
+    const bool unchanged =
+        rendered.render_shapes && rendered.shapes == object->shapes_ && rendered.color == color &&
+        rendered.alpha == alpha && rendered.octree_voxel_rendering == octree_voxel_rendering &&
+        rendered.octree_color_mode == octree_color_mode && rendered.shape_poses.size() == object->shape_poses_.size() &&
+        std::equal(rendered.shape_poses.begin(), rendered.shape_poses.end(), object->shape_poses_.begin(),
+                   [](const Eigen::Isometry3d& a, const Eigen::Isometry3d& b) { return a.matrix() == b.matrix(); });
+
+    if (!unchanged)
     {
-      render_shapes_->renderShape(planning_scene_geometry_node_, object->shapes_[j].get(),
-                                  object->global_shape_poses_[j], octree_voxel_rendering, octree_color_mode, color,
-                                  alpha);
+      rendered.render_shapes = std::make_shared<RenderShapes>(context_);
+      for (std::size_t j = 0; j < object->shapes_.size(); ++j)
+      {
+        rendered.render_shapes->renderShape(rendered.node, object->shapes_[j].get(), object->shape_poses_[j],
+                                            octree_voxel_rendering, octree_color_mode, color, alpha);
+      }
+      rendered.shapes = object->shapes_;
+      rendered.shape_poses = object->shape_poses_;
+      rendered.color = color;
+      rendered.alpha = alpha;
+      rendered.octree_voxel_rendering = octree_voxel_rendering;
+      rendered.octree_color_mode = octree_color_mode;
     }
+
+    // moving the object only moves its node
+    const Eigen::Vector3d& translation = object->pose_.translation();
+    const Eigen::Quaterniond q(object->pose_.linear());
+    rendered.node->setPosition(Ogre::Vector3(translation.x(), translation.y(), translation.z()));
+    rendered.node->setOrientation(Ogre::Quaternion(q.w(), q.x(), q.y(), q.z()));
   }
 }
 }  // namespace moveit_rviz_plugin
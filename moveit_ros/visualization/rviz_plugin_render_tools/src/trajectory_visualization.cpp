@@ -56,6 +56,8 @@
 #include <rviz_default_plugins/robot/robot_link.hpp>
 #include <rviz_common/window_manager_interface.hpp>
 
+#include <algorithm>
+#include <chrono>
 #include <string>
 
 using namespace std::placeholders;
@@ -127,6 +129,13 @@ TrajectoryVisualization::TrajectoryVisualization(rviz_common::properties::Proper
                                                                        widget, SLOT(changedTrailStepSize()), this);
   trail_step_size_property_->setMin(1);
 
+  trail_min_distance_property_ = new rviz_common::properties::FloatProperty(
+      "Trail Min Distance", 0.01f,
+      "Waypoints of the trail where no link moved by this distance (m) since the previously shown waypoint are "
+      "skipped. Set 0 to show every step.",
+      widget, SLOT(changedTrailMinDistance()), this);
+  trail_min_distance_property_->setMin(0.0);
+
   interrupt_display_property_ = new rviz_common::properties::BoolProperty(
       "Interrupt Display", false,
       "Immediately show newly planned trajectory, interrupting the currently displayed one.", widget);
@@ -233,6 +242,7 @@ void TrajectoryVisualization::reset()
 void TrajectoryVisualization::clearTrajectoryTrail()
 {
   trajectory_trail_.clear();
+  trajectory_trail_waypoints_.clear();
 }
 
 void TrajectoryVisualization::changedLoopDisplay()
@@ -254,12 +264,12 @@ void TrajectoryVisualization::changedShowTrail()
   if (!t)
     return;
 
-  int stepsize = trail_step_size_property_->getInt();
-  // always include last trajectory point
-  trajectory_trail_.resize(static_cast<int>(std::ceil((t->getWayPointCount() + stepsize - 1) / (float)stepsize)));
+  // every trail robot holds an entity per link, so robots that would overlap the previous one are not created
+  trajectory_trail_waypoints_ = selectTrailWaypoints(*t);
+  trajectory_trail_.resize(trajectory_trail_waypoints_.size());
   for (std::size_t i = 0; i < trajectory_trail_.size(); ++i)
   {
-    int waypoint_i = std::min(i * stepsize, t->getWayPointCount() - 1);  // limit to last trajectory point
+    const std::size_t waypoint_i = trajectory_trail_waypoints_[i];
     auto r =
         std::make_unique<RobotStateVisualization>(scene_node_, context_, "Trail Robot " + std::to_string(i), nullptr);
     r->load(*robot_model_->getURDF());
@@ -269,17 +279,56 @@ void TrajectoryVisualization::changedShowTrail()
     r->update(t->getWayPointPtr(waypoint_i), default_attached_object_color_);
     if (enable_robot_color_property_->getBool())
       setRobotColor(&(r->getRobot()), robot_color_property_->getColor());
-    r->setVisible(display_->isEnabled() && (!animating_path_ || waypoint_i <= current_state_));
+    r->setVisible(display_->isEnabled() && (!animating_path_ || static_cast<int>(waypoint_i) <= current_state_));
     trajectory_trail_[i] = std::move(r);
   }
 }
 
+std::vector<std::size_t>
+TrajectoryVisualization::selectTrailWaypoints(const robot_trajectory::RobotTrajectory& trajectory) const
+{
+  std::vector<std::size_t> waypoints;
+  const std::size_t count = trajectory.getWayPointCount();
+  if (count == 0)
+    return waypoints;
+
+  const std::size_t step_size = trail_step_size_property_->getInt();
+  const double min_distance = trail_min_distance_property_->getFloat();
+  const std::vector<const moveit::core::LinkModel*>& links = robot_model_->getLinkModelsWithCollisionGeometry();
+  auto moved = [&](std::size_t from, std::size_t to) {
+    if (min_distance <= 0.0)
+      return true;
+    // the waypoints' link transforms are up to date, they were computed when the trajectory was received
+    const moveit::core::RobotState& a = trajectory.getWayPoint(from);
+    const moveit::core::RobotState& b = trajectory.getWayPoint(to);
+    return std::any_of(links.begin(), links.end(), [&](const moveit::core::LinkModel* link) {
+      return (a.getGlobalLinkTransform(link).translation() - b.getGlobalLinkTransform(link).translation()).norm() >=
+             min_distance;
+    });
+  };
+
+  waypoints.push_back(0);
+  for (std::size_t i = step_size; i < count - 1; i += step_size)
+    if (moved(waypoints.back(), i))
+      waypoints.push_back(i);
+  // always include last trajectory point
+  if (count > 1)
+    waypoints.push_back(count - 1);
+  return waypoints;
+}
+
 void TrajectoryVisualization::changedTrailStepSize()
 {
   if (trail_display_property_->getBool())
     changedShowTrail();
 }
 
+void TrajectoryVisualization::changedTrailMinDistance()
+{
+  if (trail_display_property_->getBool())
+    changedShowTrail();
+}
+
 void TrajectoryVisualization::changedRobotPathAlpha()
 {
   display_path_robot_->setAlpha(robot_path_alpha_property_->getFloat());
@@ -417,6 +466,7 @@ void TrajectoryVisualization::dropTrajectory()
 
 void TrajectoryVisualization::update(float wall_dt, float sim_dt)
 {
+  takePreparedTrajectory();
   if (drop_displaying_trajectory_)
   {
     animating_path_ = false;
@@ -515,8 +565,7 @@ void TrajectoryVisualization::update(float wall_dt, float sim_dt)
         trajectory_slider_panel_->setSliderPosition(current_state_);
       display_path_robot_->update(displaying_trajectory_message_->getWayPointPtr(current_state_));
       for (std::size_t i = 0; i < trajectory_trail_.size(); ++i)
-        trajectory_trail_[i]->setVisible(
-            std::min(waypoint_count - 1, static_cast<int>(i) * trail_step_size_property_->getInt()) <= current_state_);
+        trajectory_trail_[i]->setVisible(static_cast<int>(trajectory_trail_waypoints_[i]) <= current_state_);
     }
     else
     {
@@ -549,39 +598,71 @@ void TrajectoryVisualization::incomingDisplayTrajectory(const moveit_msgs::msg::
     RCLCPP_WARN(LOGGER, "Received a trajectory to display for model '%s' but model '%s' was expected",
                 msg->model_id.c_str(), robot_model_->getName().c_str());
 
-  trajectory_message_to_display_.reset();
-
-  auto t = std::make_shared<robot_trajectory::RobotTrajectory>(robot_model_, "");
-  try
-  {
-    for (std::size_t i = 0; i < msg->trajectory.size(); ++i)
+  // converting the message and computing the forward kinematics of every waypoint takes long for long trajectories,
+  // so it runs on a worker thread and update() picks up the result. A newer message waits for the previous one.
+  auto prepare = [robot_model = robot_model_, start_state = *robot_state_, msg] {
+    PreparedTrajectory prepared;
+    auto t = std::make_shared<robot_trajectory::RobotTrajectory>(robot_model, "");
+    try
     {
-      if (t->empty())
+      for (std::size_t i = 0; i < msg->trajectory.size(); ++i)
       {
-        t->setRobotTrajectoryMsg(*robot_state_, msg->trajectory_start, msg->trajectory[i]);
-      }
-      else
-      {
-        robot_trajectory::RobotTrajectory tmp(robot_model_, "");
-        tmp.setRobotTrajectoryMsg(t->getLastWayPoint(), msg->trajectory[i]);
-        t->append(tmp, 0.0);
+        if (t->empty())
+        {
+          t->setRobotTrajectoryMsg(start_state, msg->trajectory_start, msg->trajectory[i]);
+        }
+        else
+        {
+          robot_trajectory::RobotTrajectory tmp(robot_model, "");
+          tmp.setRobotTrajectoryMsg(t->getLastWayPoint(), msg->trajectory[i]);
+          t->append(tmp, 0.0);
+        }
       }
     }
-    display_->setStatus(rviz_common::properties::StatusProperty::Ok, "Trajectory", "");
+    catch (const moveit::Exception& e)
+    {
+      prepared.error = e.what();
+      return prepared;
+    }
+    // animation and trail then only set the link poses of the waypoints
+    for (std::size_t i = 0; i < t->getWayPointCount(); ++i)
+      t->getWayPointPtr(i)->update();
+    prepared.trajectory = t;
+    return prepared;
+  };
+
+  std::scoped_lock lock(update_trajectory_message_);
+  prepared_trajectory_ = std::async(std::launch::async, prepare);
+}
+
+void TrajectoryVisualization::takePreparedTrajectory()
+{
+  PreparedTrajectory prepared;
+  {
+    std::scoped_lock lock(update_trajectory_message_);
+    if (!prepared_trajectory_.valid() ||
+        prepared_trajectory_.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+      return;
+    prepared = prepared_trajectory_.get();
   }
-  catch (const moveit::Exception& e)
+
+  if (!prepared.error.empty())
   {
-    display_->setStatus(rviz_common::properties::StatusProperty::Error, "Trajectory", e.what());
+    display_->setStatus(rviz_common::properties::StatusProperty::Error, "Trajectory", prepared.error.c_str());
     return;
   }
+  display_->setStatus(rviz_common::properties::StatusProperty::Ok, "Trajectory", "");
+
+  // the robot model may have been reloaded while the trajectory was prepared
+  if (prepared.trajectory->empty() || prepared.trajectory->getRobotModel() != robot_model_)
+    return;
 
-  if (!t->empty())
   {
     std::scoped_lock lock(update_trajectory_message_);
-    trajectory_message_to_display_.swap(t);
-    if (interrupt_display_property_->getBool())
-      interruptCurrentDisplay();
+    trajectory_message_to_display_.swap(prepared.trajectory);
   }
+  if (interrupt_display_property_->getBool())
+    interruptCurrentDisplay();
 }
 
 void TrajectoryVisualization::changedRobotColor()
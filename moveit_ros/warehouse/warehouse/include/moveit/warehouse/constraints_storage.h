@@ -59,9 +59,13 @@ public:
   static const std::string ROBOT_NAME;
 
   ConstraintsStorage(warehouse_ros::DatabaseConnection::Ptr conn);
+  ~ConstraintsStorage() override;
 
   void addConstraints(const moveit_msgs::msg::Constraints& msg, const std::string& robot = "",
                       const std::string& group = "");
+  /** \brief Add or replace the constraints \e msgs by their names, looking up which exist with a single query */
+  void addConstraints(const std::vector<moveit_msgs::msg::Constraints>& msgs, const std::string& robot = "",
+                      const std::string& group = "");
   bool hasConstraints(const std::string& name, const std::string& robot = "", const std::string& group = "") const;
   void getKnownConstraints(std::vector<std::string>& names, const std::string& robot = "",
                            const std::string& group = "") const;
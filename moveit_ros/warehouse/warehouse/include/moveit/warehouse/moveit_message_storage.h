@@ -37,6 +37,12 @@
 #pragma once
 
 #include <warehouse_ros/database_connection.h>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
 #include <vector>
 #include <string>
 
@@ -51,15 +57,44 @@ public:
   /// initialized.
   MoveItMessageStorage(warehouse_ros::DatabaseConnection::Ptr conn);
 
-  virtual ~MoveItMessageStorage()
-  {
-  }
+  virtual ~MoveItMessageStorage();
+
+  /** \brief Queue the changes to the database for a background thread instead of writing them in the calls that
+   *  make them, so that logging many messages does not block the caller. At most \e max_queued_writes changes are
+   *  queued, further calls block until there is room. Reads wait for the queued changes to be written first. */
+  void enableWriteBehind(std::size_t max_queued_writes = 1000);
+
+  /** \brief Write the queued changes and make the changes in the calls again, the default */
+  void disableWriteBehind();
+
+  /** \brief Wait until the queued changes are written. Rethrows the first exception of a queued change since the
+   *  last flush, the changes after it are written nevertheless */
+  void flush() const;
 
 protected:
   /// Keep only the \e names that match \e regex
   void filterNames(const std::string& regex, std::vector<std::string>& names) const;
 
+  /// Whether \e regex only matches itself, so that it can be looked up in the database instead of filtering names
+  static bool isLiteral(const std::string& regex);
+
+  /** \brief Make the change to the database \e write, queued when write-behind is enabled. Derived classes must
+   *  call disableWriteBehind() in their destructor, as queued changes may use their collections */
+  void queueWrite(std::function<void()> write);
+
   warehouse_ros::DatabaseConnection::Ptr conn_;
+
+private:
+  void processWrites();
+
+  mutable std::mutex write_queue_lock_;
+  mutable std::condition_variable write_queue_condition_;
+  std::deque<std::function<void()>> write_queue_;
+  std::size_t max_queued_writes_ = 0;
+  bool writing_ = false;
+  bool stop_writing_ = false;
+  mutable std::exception_ptr write_error_;
+  std::thread write_thread_;
 };
 
 /// \brief Load a database connection
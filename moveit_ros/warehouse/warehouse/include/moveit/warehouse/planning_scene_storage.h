@@ -41,6 +41,7 @@
 #include <moveit_msgs/msg/planning_scene.hpp>
 #include <moveit_msgs/msg/motion_plan_request.hpp>
 #include <moveit_msgs/msg/robot_trajectory.hpp>
+#include <functional>
 
 #include "moveit_warehouse_export.h"
 
@@ -63,14 +64,24 @@ public:
 
   static const std::string PLANNING_SCENE_ID_NAME;
   static const std::string MOTION_PLAN_REQUEST_ID_NAME;
+  static const std::string TRAJECTORY_POINTS_NAME;
 
   PlanningSceneStorage(warehouse_ros::DatabaseConnection::Ptr conn);
+  ~PlanningSceneStorage() override;
+
+  /** \brief Store the joint trajectory points of planning results added from now on with encodeJointTrajectoryPoints(),
+   *  quantized to \e resolution, instead of as part of the message. 0 stores them in the message, the default.
+   *  Encoded results are decoded transparently when they are read */
+  void setTrajectoryEncoding(double resolution);
 
   void addPlanningScene(const moveit_msgs::msg::PlanningScene& scene);
   void addPlanningQuery(const moveit_msgs::msg::MotionPlanRequest& planning_query, const std::string& scene_name,
                         const std::string& query_name = "");
   void addPlanningResult(const moveit_msgs::msg::MotionPlanRequest& planning_query,
                          const moveit_msgs::msg::RobotTrajectory& result, const std::string& scene_name);
+  /** \brief Add the \e results of one \e planning_query, which is looked up or added only once for all of them */
+  void addPlanningResults(const moveit_msgs::msg::MotionPlanRequest& planning_query,
+                          const std::vector<moveit_msgs::msg::RobotTrajectory>& results, const std::string& scene_name);
 
   bool hasPlanningScene(const std::string& name) const;
   void getPlanningSceneNames(std::vector<std::string>& names) const;
@@ -95,6 +106,15 @@ public:
                           const moveit_msgs::msg::MotionPlanRequest& planning_query) const;
   void getPlanningResults(std::vector<RobotTrajectoryWithMetadata>& planning_results, const std::string& scene_name,
                           const std::string& query_name) const;
+  /** \brief Get the page of at most \e limit results of \e query_name that starts after the first \e offset */
+  void getPlanningResults(std::vector<RobotTrajectoryWithMetadata>& planning_results, const std::string& scene_name,
+                          const std::string& query_name, std::size_t offset, std::size_t limit) const;
+  /** \brief Pass the results of \e query_name to \e callback one at a time, as they are read from the database,
+   *  instead of loading all of them at once. Skips the first \e offset results and stops after \e limit results
+   *  (0 for all of them) or when \e callback returns false. Returns the number of results passed to \e callback */
+  std::size_t streamPlanningResults(const std::function<bool(const RobotTrajectoryWithMetadata&)>& callback,
+                                    const std::string& scene_name, const std::string& query_name,
+                                    std::size_t offset = 0, std::size_t limit = 0, bool metadata_only = false) const;
 
   void renamePlanningScene(const std::string& old_scene_name, const std::string& new_scene_name);
   void renamePlanningQuery(const std::string& scene_name, const std::string& old_query_name,
@@ -115,9 +135,14 @@ private:
                                        const std::string& scene_name) const;
   std::string addNewPlanningRequest(const moveit_msgs::msg::MotionPlanRequest& planning_query,
                                     const std::string& scene_name, const std::string& query_name);
+  void insertPlanningResult(const moveit_msgs::msg::RobotTrajectory& result, const std::string& scene_name,
+                            const std::string& query_name);
+  /** \brief Restore the points of an encoded result into its message */
+  static void decodePlanningResult(const RobotTrajectoryWithMetadata& result);
 
   PlanningSceneCollection planning_scene_collection_;
   MotionPlanRequestCollection motion_plan_request_collection_;
   RobotTrajectoryCollection robot_trajectory_collection_;
+  double trajectory_resolution_ = 0.0;
 };
 }  // namespace moveit_warehouse
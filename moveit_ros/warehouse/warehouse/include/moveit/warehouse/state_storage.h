@@ -39,6 +39,7 @@
 #include <moveit/warehouse/moveit_message_storage.h>
 #include <moveit/macros/class_forward.h>
 #include <moveit_msgs/msg/robot_state.hpp>
+#include <map>
 
 #include "moveit_warehouse_export.h"
 
@@ -58,8 +59,12 @@ public:
   static const std::string ROBOT_NAME;
 
   RobotStateStorage(warehouse_ros::DatabaseConnection::Ptr conn);
+  ~RobotStateStorage() override;
 
   void addRobotState(const moveit_msgs::msg::RobotState& msg, const std::string& name, const std::string& robot = "");
+  /** \brief Add or replace the \e states by their names, looking up which of them exist with a single query */
+  void addRobotStates(const std::map<std::string, moveit_msgs::msg::RobotState>& states,
+                      const std::string& robot = "");
   bool hasRobotState(const std::string& name, const std::string& robot = "") const;
   void getKnownRobotStates(std::vector<std::string>& names, const std::string& robot = "") const;
   void getKnownRobotStates(const std::string& regex, std::vector<std::string>& names,
@@ -0,0 +1,57 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+#pragma once
+
+#include <trajectory_msgs/msg/joint_trajectory.hpp>
+#include <string>
+
+#include "moveit_warehouse_export.h"
+
+namespace moveit_warehouse
+{
+/** \brief Encode the points of \e trajectory compactly into \e encoded, for storing them as metadata.
+ *
+ *  The values are quantized to multiples of \e resolution and stored per joint and field, i.e. as columns. Each
+ *  value is stored as the variable-length difference to the linear extrapolation of its two predecessors, which is
+ *  small for smooth trajectories. The times from start are kept to the nanosecond. The result is base64 text.
+ *  Returns false, leaving \e encoded unchanged, if the points do not all have the same fields or if \e resolution
+ *  is not positive. */
+MOVEIT_WAREHOUSE_EXPORT bool encodeJointTrajectoryPoints(const trajectory_msgs::msg::JointTrajectory& trajectory,
+                                                         double resolution, std::string& encoded);
+
+/** \brief Decode the points stored by encodeJointTrajectoryPoints() into \e trajectory, replacing its points.
+ *  Returns false if \e encoded is malformed */
+MOVEIT_WAREHOUSE_EXPORT bool decodeJointTrajectoryPoints(const std::string& encoded,
+                                                         trajectory_msgs::msg::JointTrajectory& trajectory);
+}  // namespace moveit_warehouse
@@ -36,6 +36,7 @@
 
 #include <moveit/warehouse/constraints_storage.h>
 
+#include <set>
 #include <utility>
 
 const std::string moveit_warehouse::ConstraintsStorage::DATABASE_NAME = "moveit_constraints";
@@ -55,6 +56,11 @@ moveit_warehouse::ConstraintsStorage::ConstraintsStorage(warehouse_ros::Database
   createCollections();
 }
 
+moveit_warehouse::ConstraintsStorage::~ConstraintsStorage()
+{
+  disableWriteBehind();
+}
+
 void moveit_warehouse::ConstraintsStorage::createCollections()
 {
   constraints_collection_ = conn_->openCollectionPtr<moveit_msgs::msg::Constraints>(DATABASE_NAME, "constraints");
@@ -62,6 +68,7 @@ void moveit_warehouse::ConstraintsStorage::createCollections()
 
 void moveit_warehouse::ConstraintsStorage::reset()
 {
+  flush();
   constraints_collection_.reset();
   conn_->dropDatabase(DATABASE_NAME);
   createCollections();
@@ -70,23 +77,48 @@ void moveit_warehouse::ConstraintsStorage::reset()
 void moveit_warehouse::ConstraintsStorage::addConstraints(const moveit_msgs::msg::Constraints& msg,
                                                           const std::string& robot, const std::string& group)
 {
-  bool replace = false;
-  if (hasConstraints(msg.name, robot, group))
-  {
-    removeConstraints(msg.name, robot, group);
-    replace = true;
-  }
-  Metadata::Ptr metadata = constraints_collection_->createMetadata();
-  metadata->append(CONSTRAINTS_ID_NAME, msg.name);
-  metadata->append(ROBOT_NAME, robot);
-  metadata->append(CONSTRAINTS_GROUP_NAME, group);
-  constraints_collection_->insert(msg, metadata);
-  RCLCPP_DEBUG(LOGGER, "%s constraints '%s'", replace ? "Replaced" : "Added", msg.name.c_str());
+  queueWrite([this, msg, robot, group] {
+    bool replace = false;
+    if (hasConstraints(msg.name, robot, group))
+    {
+      removeConstraints(msg.name, robot, group);
+      replace = true;
+    }
+    Metadata::Ptr metadata = constraints_collection_->createMetadata();
+    metadata->append(CONSTRAINTS_ID_NAME, msg.name);
+    metadata->append(ROBOT_NAME, robot);
+    metadata->append(CONSTRAINTS_GROUP_NAME, group);
+    constraints_collection_->insert(msg, metadata);
+    RCLCPP_DEBUG(LOGGER, "%s constraints '%s'", replace ? "Replaced" : "Added", msg.name.c_str());
+  });
+}
+
+void moveit_warehouse::ConstraintsStorage::addConstraints(const std::vector<moveit_msgs::msg::Constraints>& msgs,
+                                                          const std::string& robot, const std::string& group)
+{
+  queueWrite([this, msgs, robot, group] {
+    std::vector<std::string> known;
+    getKnownConstraints(known, robot, group);
+    std::set<std::string> existing(known.begin(), known.end());
+    for (const moveit_msgs::msg::Constraints& msg : msgs)
+    {
+      // the later of two constraints with the same name replaces the earlier one, as with single additions
+      if (!existing.insert(msg.name).second)
+        removeConstraints(msg.name, robot, group);
+      Metadata::Ptr metadata = constraints_collection_->createMetadata();
+      metadata->append(CONSTRAINTS_ID_NAME, msg.name);
+      metadata->append(ROBOT_NAME, robot);
+      metadata->append(CONSTRAINTS_GROUP_NAME, group);
+      constraints_collection_->insert(msg, metadata);
+    }
+    RCLCPP_DEBUG(LOGGER, "Added %zu constraints", msgs.size());
+  });
 }
 
 bool moveit_warehouse::ConstraintsStorage::hasConstraints(const std::string& name, const std::string& robot,
                                                           const std::string& group) const
 {
+  flush();
   Query::Ptr q = constraints_collection_->createQuery();
   q->append(CONSTRAINTS_ID_NAME, name);
   if (!robot.empty())
@@ -101,6 +133,13 @@ void moveit_warehouse::ConstraintsStorage::getKnownConstraints(const std::string
                                                                std::vector<std::string>& names,
                                                                const std::string& robot, const std::string& group) const
 {
+  if (!regex.empty() && isLiteral(regex))
+  {
+    names.clear();
+    if (hasConstraints(regex, robot, group))
+      names.push_back(regex);
+    return;
+  }
   getKnownConstraints(names, robot, group);
   filterNames(regex, names);
 }
@@ -108,6 +147,7 @@ void moveit_warehouse::ConstraintsStorage::getKnownConstraints(const std::string
 void moveit_warehouse::ConstraintsStorage::getKnownConstraints(std::vector<std::string>& names,
                                                                const std::string& robot, const std::string& group) const
 {
+  flush();
   names.clear();
   Query::Ptr q = constraints_collection_->createQuery();
   if (!robot.empty())
@@ -123,6 +163,7 @@ void moveit_warehouse::ConstraintsStorage::getKnownConstraints(std::vector<std::
 bool moveit_warehouse::ConstraintsStorage::getConstraints(ConstraintsWithMetadata& msg_m, const std::string& name,
                                                           const std::string& robot, const std::string& group) const
 {
+  flush();
   Query::Ptr q = constraints_collection_->createQuery();
   q->append(CONSTRAINTS_ID_NAME, name);
   if (!robot.empty())
@@ -145,27 +186,31 @@ bool moveit_warehouse::ConstraintsStorage::getConstraints(ConstraintsWithMetadat
 void moveit_warehouse::ConstraintsStorage::renameConstraints(const std::string& old_name, const std::string& new_name,
                                                              const std::string& robot, const std::string& group)
 {
-  Query::Ptr q = constraints_collection_->createQuery();
-  q->append(CONSTRAINTS_ID_NAME, old_name);
-  if (!robot.empty())
-    q->append(ROBOT_NAME, robot);
-  if (!group.empty())
-    q->append(CONSTRAINTS_GROUP_NAME, group);
-  Metadata::Ptr m = constraints_collection_->createMetadata();
-  m->append(CONSTRAINTS_ID_NAME, new_name);
-  constraints_collection_->modifyMetadata(q, m);
-  RCLCPP_DEBUG(LOGGER, "Renamed constraints from '%s' to '%s'", old_name.c_str(), new_name.c_str());
+  queueWrite([this, old_name, new_name, robot, group] {
+    Query::Ptr q = constraints_collection_->createQuery();
+    q->append(CONSTRAINTS_ID_NAME, old_name);
+    if (!robot.empty())
+      q->append(ROBOT_NAME, robot);
+    if (!group.empty())
+      q->append(CONSTRAINTS_GROUP_NAME, group);
+    Metadata::Ptr m = constraints_collection_->createMetadata();
+    m->append(CONSTRAINTS_ID_NAME, new_name);
+    constraints_collection_->modifyMetadata(q, m);
+    RCLCPP_DEBUG(LOGGER, "Renamed constraints from '%s' to '%s'", old_name.c_str(), new_name.c_str());
+  });
 }
 
 void moveit_warehouse::ConstraintsStorage::removeConstraints(const std::string& name, const std::string& robot,
                                                              const std::string& group)
 {
-  Query::Ptr q = constraints_collection_->createQuery();
-  q->append(CONSTRAINTS_ID_NAME, name);
-  if (!robot.empty())
-    q->append(ROBOT_NAME, robot);
-  if (!group.empty())
-    q->append(CONSTRAINTS_GROUP_NAME, group);
-  unsigned int rem = constraints_collection_->removeMessages(q);
-  RCLCPP_DEBUG(LOGGER, "Removed %u Constraints messages (named '%s')", rem, name.c_str());
+  queueWrite([this, name, robot, group] {
+    Query::Ptr q = constraints_collection_->createQuery();
+    q->append(CONSTRAINTS_ID_NAME, name);
+    if (!robot.empty())
+      q->append(ROBOT_NAME, robot);
+    if (!group.empty())
+      q->append(CONSTRAINTS_GROUP_NAME, group);
+    unsigned int rem = constraints_collection_->removeMessages(q);
+    RCLCPP_DEBUG(LOGGER, "Removed %u Constraints messages (named '%s')", rem, name.c_str());
+  });
 }
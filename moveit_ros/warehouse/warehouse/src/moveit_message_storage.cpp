@@ -36,15 +36,122 @@
 
 #include <moveit/warehouse/moveit_message_storage.h>
 #include <warehouse_ros/database_loader.h>
+#include <rclcpp/logger.hpp>
+#include <rclcpp/logging.hpp>
+#include <algorithm>
 #include <memory>
 #include <utility>
 #include <regex>
 
+static const rclcpp::Logger LOGGER = rclcpp::get_logger("moveit.ros.warehouse.moveit_message_storage");
+
 moveit_warehouse::MoveItMessageStorage::MoveItMessageStorage(warehouse_ros::DatabaseConnection::Ptr conn)
   : conn_(std::move(conn))
 {
 }
 
+moveit_warehouse::MoveItMessageStorage::~MoveItMessageStorage()
+{
+  disableWriteBehind();
+}
+
+void moveit_warehouse::MoveItMessageStorage::enableWriteBehind(std::size_t max_queued_writes)
+{
+  std::unique_lock<std::mutex> lock(write_queue_lock_);
+  max_queued_writes_ = std::max<std::size_t>(max_queued_writes, 1);
+  if (!write_thread_.joinable())
+  {
+    stop_writing_ = false;
+    write_thread_ = std::thread([this] { processWrites(); });
+  }
+}
+
+void moveit_warehouse::MoveItMessageStorage::disableWriteBehind()
+{
+  {
+    std::unique_lock<std::mutex> lock(write_queue_lock_);
+    if (!write_thread_.joinable())
+      return;
+    stop_writing_ = true;
+  }
+  write_queue_condition_.notify_all();
+  write_thread_.join();
+  max_queued_writes_ = 0;
+}
+
+void moveit_warehouse::MoveItMessageStorage::flush() const
+{
+  // queued changes may read the database themselves, e.g. to replace a message
+  if (std::this_thread::get_id() == write_thread_.get_id())
+    return;
+  std::unique_lock<std::mutex> lock(write_queue_lock_);
+  write_queue_condition_.wait(lock, [this] { return write_queue_.empty() && !writing_; });
+  if (write_error_)
+  {
+    std::exception_ptr error;
+    std::swap(error, write_error_);
+    std::rethrow_exception(error);
+  }
+}
+
+void moveit_warehouse::MoveItMessageStorage::queueWrite(std::function<void()> write)
+{
+  std::unique_lock<std::mutex> lock(write_queue_lock_);
+  if (!write_thread_.joinable() || std::this_thread::get_id() == write_thread_.get_id())
+  {
+    lock.unlock();
+    write();
+    return;
+  }
+  write_queue_condition_.wait(lock, [this] { return write_queue_.size() < max_queued_writes_; });
+  write_queue_.push_back(std::move(write));
+  write_queue_condition_.notify_all();
+}
+
+void moveit_warehouse::MoveItMessageStorage::processWrites()
+{
+  std::unique_lock<std::mutex> lock(write_queue_lock_);
+  while (true)
+  {
+    write_queue_condition_.wait(lock, [this] { return !write_queue_.empty() || stop_writing_; });
+    if (write_queue_.empty())
+      break;  // stopped and everything is written
+
+    std::function<void()> write = std::move(write_queue_.front());
+    write_queue_.pop_front();
+    writing_ = true;
+    lock.unlock();
+    write_queue_condition_.notify_all();  // there is room in the queue again
+    try
+    {
+      write();
+    }
+    catch (...)
+    {
+      const std::exception_ptr error = std::current_exception();
+      try
+      {
+        std::rethrow_exception(error);
+      }
+      catch (const std::exception& e)
+      {
+        RCLCPP_ERROR(LOGGER, "A queued change to the database failed: %s", e.what());
+      }
+      catch (...)
+      {
+        RCLCPP_ERROR(LOGGER, "A queued change to the database failed");
+      }
+      lock.lock();
+      if (!write_error_)
+        write_error_ = error;
+      lock.unlock();
+    }
+    lock.lock();
+    writing_ = false;
+    write_queue_condition_.notify_all();
+  }
+}
+
 void moveit_warehouse::MoveItMessageStorage::filterNames(const std::string& regex, std::vector<std::string>& names) const
 {
   if (!regex.empty())
@@ -61,6 +168,11 @@ void moveit_warehouse::MoveItMessageStorage::filterNames(const std::string& rege
   }
 }
 
+bool moveit_warehouse::MoveItMessageStorage::isLiteral(const std::string& regex)
+{
+  return regex.find_first_of("\\^$.|?*+()[]{}") == std::string::npos;
+}
+
 static std::unique_ptr<warehouse_ros::DatabaseLoader> DBLOADER;
 
 typename warehouse_ros::DatabaseConnection::Ptr moveit_warehouse::loadDatabase(const rclcpp::Node::SharedPtr& node)
@@ -35,14 +35,16 @@
 /* Author: Ioan Sucan */
 
 #include <moveit/warehouse/planning_scene_storage.h>
+#include <moveit/warehouse/trajectory_encoding.h>
+#include <algorithm>
 #include <utility>
 #include <rclcpp/serialization.hpp>
-#include <regex>
 
 const std::string moveit_warehouse::PlanningSceneStorage::DATABASE_NAME = "moveit_planning_scenes";
 
 const std::string moveit_warehouse::PlanningSceneStorage::PLANNING_SCENE_ID_NAME = "planning_scene_id";
 const std::string moveit_warehouse::PlanningSceneStorage::MOTION_PLAN_REQUEST_ID_NAME = "motion_request_id";
+const std::string moveit_warehouse::PlanningSceneStorage::TRAJECTORY_POINTS_NAME = "joint_trajectory_points";
 
 using warehouse_ros::Metadata;
 using warehouse_ros::Query;
@@ -55,6 +57,17 @@ moveit_warehouse::PlanningSceneStorage::PlanningSceneStorage(warehouse_ros::Data
   createCollections();
 }
 
+moveit_warehouse::PlanningSceneStorage::~PlanningSceneStorage()
+{
+  disableWriteBehind();
+}
+
+void moveit_warehouse::PlanningSceneStorage::setTrajectoryEncoding(double resolution)
+{
+  // queued so that results added before keep the encoding they were added with
+  queueWrite([this, resolution] { trajectory_resolution_ = std::max(resolution, 0.0); });
+}
+
 void moveit_warehouse::PlanningSceneStorage::createCollections()
 {
   planning_scene_collection_ =
@@ -67,6 +80,7 @@ void moveit_warehouse::PlanningSceneStorage::createCollections()
 
 void moveit_warehouse::PlanningSceneStorage::reset()
 {
+  flush();
   planning_scene_collection_.reset();
   motion_plan_request_collection_.reset();
   robot_trajectory_collection_.reset();
@@ -76,20 +90,23 @@ void moveit_warehouse::PlanningSceneStorage::reset()
 
 void moveit_warehouse::PlanningSceneStorage::addPlanningScene(const moveit_msgs::msg::PlanningScene& scene)
 {
-  bool replace = false;
-  if (hasPlanningScene(scene.name))
-  {
-    removePlanningScene(scene.name);
-    replace = true;
-  }
-  Metadata::Ptr metadata = planning_scene_collection_->createMetadata();
-  metadata->append(PLANNING_SCENE_ID_NAME, scene.name);
-  planning_scene_collection_->insert(scene, metadata);
-  RCLCPP_DEBUG(LOGGER, "%s scene '%s'", replace ? "Replaced" : "Added", scene.name.c_str());
+  queueWrite([this, scene] {
+    bool replace = false;
+    if (hasPlanningScene(scene.name))
+    {
+      removePlanningScene(scene.name);
+      replace = true;
+    }
+    Metadata::Ptr metadata = planning_scene_collection_->createMetadata();
+    metadata->append(PLANNING_SCENE_ID_NAME, scene.name);
+    planning_scene_collection_->insert(scene, metadata);
+    RCLCPP_DEBUG(LOGGER, "%s scene '%s'", replace ? "Replaced" : "Added", scene.name.c_str());
+  });
 }
 
 bool moveit_warehouse::PlanningSceneStorage::hasPlanningScene(const std::string& name) const
 {
+  flush();
   Query::Ptr q = planning_scene_collection_->createQuery();
   q->append(PLANNING_SCENE_ID_NAME, name);
   std::vector<PlanningSceneWithMetadata> planning_scenes = planning_scene_collection_->queryList(q, true);
@@ -136,14 +153,16 @@ void moveit_warehouse::PlanningSceneStorage::addPlanningQuery(const moveit_msgs:
                                                               const std::string& scene_name,
                                                               const std::string& query_name)
 {
-  std::string id = getMotionPlanRequestName(planning_query, scene_name);
+  queueWrite([this, planning_query, scene_name, query_name] {
+    std::string id = getMotionPlanRequestName(planning_query, scene_name);
 
-  // if we are trying to overwrite, we remove the old query first (if it exists).
-  if (!query_name.empty() && id.empty())
-    removePlanningQuery(scene_name, query_name);
+    // if we are trying to overwrite, we remove the old query first (if it exists).
+    if (!query_name.empty() && id.empty())
+      removePlanningQuery(scene_name, query_name);
 
-  if (id != query_name || id.empty())
-    addNewPlanningRequest(planning_query, scene_name, query_name);
+    if (id != query_name || id.empty())
+      addNewPlanningRequest(planning_query, scene_name, query_name);
+  });
 }
 
 std::string
@@ -179,17 +198,65 @@ void moveit_warehouse::PlanningSceneStorage::addPlanningResult(const moveit_msgs
                                                                const moveit_msgs::msg::RobotTrajectory& result,
                                                                const std::string& scene_name)
 {
-  std::string id = getMotionPlanRequestName(planning_query, scene_name);
-  if (id.empty())
-    id = addNewPlanningRequest(planning_query, scene_name, "");
+  queueWrite([this, planning_query, result, scene_name] {
+    std::string id = getMotionPlanRequestName(planning_query, scene_name);
+    if (id.empty())
+      id = addNewPlanningRequest(planning_query, scene_name, "");
+    insertPlanningResult(result, scene_name, id);
+  });
+}
+
+void moveit_warehouse::PlanningSceneStorage::addPlanningResults(
+    const moveit_msgs::msg::MotionPlanRequest& planning_query,
+    const std::vector<moveit_msgs::msg::RobotTrajectory>& results, const std::string& scene_name)
+{
+  queueWrite([this, planning_query, results, scene_name] {
+    std::string id = getMotionPlanRequestName(planning_query, scene_name);
+    if (id.empty())
+      id = addNewPlanningRequest(planning_query, scene_name, "");
+    for (const moveit_msgs::msg::RobotTrajectory& result : results)
+      insertPlanningResult(result, scene_name, id);
+    RCLCPP_DEBUG(LOGGER, "Saved %zu planning results of query '%s' for scene '%s'", results.size(), id.c_str(),
+                 scene_name.c_str());
+  });
+}
+
+void moveit_warehouse::PlanningSceneStorage::insertPlanningResult(const moveit_msgs::msg::RobotTrajectory& result,
+                                                                  const std::string& scene_name,
+                                                                  const std::string& query_name)
+{
   Metadata::Ptr metadata = robot_trajectory_collection_->createMetadata();
   metadata->append(PLANNING_SCENE_ID_NAME, scene_name);
-  metadata->append(MOTION_PLAN_REQUEST_ID_NAME, id);
-  robot_trajectory_collection_->insert(result, metadata);
+  metadata->append(MOTION_PLAN_REQUEST_ID_NAME, query_name);
+
+  std::string points;
+  if (trajectory_resolution_ > 0.0 &&
+      encodeJointTrajectoryPoints(result.joint_trajectory, trajectory_resolution_, points))
+  {
+    moveit_msgs::msg::RobotTrajectory stripped = result;
+    stripped.joint_trajectory.points.clear();
+    metadata->append(TRAJECTORY_POINTS_NAME, points);
+    robot_trajectory_collection_->insert(stripped, metadata);
+  }
+  else
+    robot_trajectory_collection_->insert(result, metadata);
+}
+
+void moveit_warehouse::PlanningSceneStorage::decodePlanningResult(const RobotTrajectoryWithMetadata& result)
+{
+  if (!result->lookupField(TRAJECTORY_POINTS_NAME))
+    return;
+  // like the renaming of scenes, the points are restored into the message that is returned
+  auto& trajectory = const_cast<moveit_msgs::msg::RobotTrajectory*>(
+                         static_cast<const moveit_msgs::msg::RobotTrajectory*>(result.get()))
+                         ->joint_trajectory;
+  if (!decodeJointTrajectoryPoints(result->lookupString(TRAJECTORY_POINTS_NAME), trajectory))
+    RCLCPP_ERROR(LOGGER, "Failed to decode the trajectory points of a planning result");
 }
 
 void moveit_warehouse::PlanningSceneStorage::getPlanningSceneNames(std::vector<std::string>& names) const
 {
+  flush();
   names.clear();
   Query::Ptr q = planning_scene_collection_->createQuery();
   std::vector<PlanningSceneWithMetadata> planning_scenes =
@@ -202,6 +269,13 @@ void moveit_warehouse::PlanningSceneStorage::getPlanningSceneNames(std::vector<s
 void moveit_warehouse::PlanningSceneStorage::getPlanningSceneNames(const std::string& regex,
                                                                    std::vector<std::string>& names) const
 {
+  if (!regex.empty() && isLiteral(regex))
+  {
+    names.clear();
+    if (hasPlanningScene(regex))
+      names.push_back(regex);
+    return;
+  }
   getPlanningSceneNames(names);
   filterNames(regex, names);
 }
@@ -222,6 +296,7 @@ bool moveit_warehouse::PlanningSceneStorage::getPlanningSceneWorld(moveit_msgs::
 bool moveit_warehouse::PlanningSceneStorage::getPlanningScene(PlanningSceneWithMetadata& scene_m,
                                                               const std::string& scene_name) const
 {
+  flush();
   Query::Ptr q = planning_scene_collection_->createQuery();
   q->append(PLANNING_SCENE_ID_NAME, scene_name);
   std::vector<PlanningSceneWithMetadata> planning_scenes = planning_scene_collection_->queryList(q, false);
@@ -241,6 +316,7 @@ bool moveit_warehouse::PlanningSceneStorage::getPlanningQuery(MotionPlanRequestW
                                                               const std::string& scene_name,
                                                               const std::string& query_name)
 {
+  flush();
   Query::Ptr q = motion_plan_request_collection_->createQuery();
   q->append(PLANNING_SCENE_ID_NAME, scene_name);
   q->append(MOTION_PLAN_REQUEST_ID_NAME, query_name);
@@ -260,6 +336,7 @@ bool moveit_warehouse::PlanningSceneStorage::getPlanningQuery(MotionPlanRequestW
 void moveit_warehouse::PlanningSceneStorage::getPlanningQueries(
     std::vector<MotionPlanRequestWithMetadata>& planning_queries, const std::string& scene_name) const
 {
+  flush();
   Query::Ptr q = motion_plan_request_collection_->createQuery();
   q->append(PLANNING_SCENE_ID_NAME, scene_name);
   planning_queries = motion_plan_request_collection_->queryList(q, false);
@@ -268,6 +345,7 @@ void moveit_warehouse::PlanningSceneStorage::getPlanningQueries(
 void moveit_warehouse::PlanningSceneStorage::getPlanningQueriesNames(std::vector<std::string>& query_names,
                                                                      const std::string& scene_name) const
 {
+  flush();
   Query::Ptr q = motion_plan_request_collection_->createQuery();
   q->append(PLANNING_SCENE_ID_NAME, scene_name);
   std::vector<MotionPlanRequestWithMetadata> planning_queries = motion_plan_request_collection_->queryList(q, true);
@@ -281,28 +359,22 @@ void moveit_warehouse::PlanningSceneStorage::getPlanningQueriesNames(const std::
                                                                      std::vector<std::string>& query_names,
                                                                      const std::string& scene_name) const
 {
-  getPlanningQueriesNames(query_names, scene_name);
-
-  if (!regex.empty())
+  if (!regex.empty() && isLiteral(regex))
   {
-    std::vector<std::string> fnames;
-    std::regex r(regex);
-    for (const std::string& query_name : query_names)
-    {
-      std::smatch match;
-      if (std::regex_match(query_name, match, r))
-      {
-        fnames.push_back(query_name);
-      }
-    }
-    query_names.swap(fnames);
+    query_names.clear();
+    if (hasPlanningQuery(scene_name, regex))
+      query_names.push_back(regex);
+    return;
   }
+  getPlanningQueriesNames(query_names, scene_name);
+  filterNames(regex, query_names);
 }
 
 void moveit_warehouse::PlanningSceneStorage::getPlanningQueries(
     std::vector<MotionPlanRequestWithMetadata>& planning_queries, std::vector<std::string>& query_names,
     const std::string& scene_name) const
 {
+  flush();
   Query::Ptr q = motion_plan_request_collection_->createQuery();
   q->append(PLANNING_SCENE_ID_NAME, scene_name);
   planning_queries = motion_plan_request_collection_->queryList(q, false);
@@ -318,26 +390,74 @@ void moveit_warehouse::PlanningSceneStorage::getPlanningResults(
     std::vector<RobotTrajectoryWithMetadata>& planning_results, const std::string& scene_name,
     const moveit_msgs::msg::MotionPlanRequest& planning_query) const
 {
+  flush();
   std::string id = getMotionPlanRequestName(planning_query, scene_name);
   if (id.empty())
     planning_results.clear();
   else
-    getPlanningResults(planning_results, id, scene_name);
+    getPlanningResults(planning_results, scene_name, id);
 }
 
 void moveit_warehouse::PlanningSceneStorage::getPlanningResults(
     std::vector<RobotTrajectoryWithMetadata>& planning_results, const std::string& scene_name,
     const std::string& planning_query) const
 {
+  flush();
   Query::Ptr q = robot_trajectory_collection_->createQuery();
   q->append(PLANNING_SCENE_ID_NAME, scene_name);
   q->append(MOTION_PLAN_REQUEST_ID_NAME, planning_query);
   planning_results = robot_trajectory_collection_->queryList(q, false);
+  for (const RobotTrajectoryWithMetadata& planning_result : planning_results)
+    decodePlanningResult(planning_result);
+}
+
+void moveit_warehouse::PlanningSceneStorage::getPlanningResults(
+    std::vector<RobotTrajectoryWithMetadata>& planning_results, const std::string& scene_name,
+    const std::string& query_name, std::size_t offset, std::size_t limit) const
+{
+  planning_results.clear();
+  streamPlanningResults(
+      [&planning_results](const RobotTrajectoryWithMetadata& result) {
+        planning_results.push_back(result);
+        return true;
+      },
+      scene_name, query_name, offset, limit);
+}
+
+std::size_t moveit_warehouse::PlanningSceneStorage::streamPlanningResults(
+    const std::function<bool(const RobotTrajectoryWithMetadata&)>& callback, const std::string& scene_name,
+    const std::string& query_name, std::size_t offset, std::size_t limit, bool metadata_only) const
+{
+  flush();
+  Query::Ptr q = robot_trajectory_collection_->createQuery();
+  q->append(PLANNING_SCENE_ID_NAME, scene_name);
+  q->append(MOTION_PLAN_REQUEST_ID_NAME, query_name);
+
+  // the results are read from the cursor of the query as they are iterated, not collected into a list first
+  auto results = robot_trajectory_collection_->query(q, metadata_only);
+  std::size_t skipped = 0;
+  std::size_t passed = 0;
+  for (auto result = results.first; result != results.second && (limit == 0 || passed < limit); ++result)
+  {
+    if (skipped < offset)
+    {
+      ++skipped;
+      continue;
+    }
+    ++passed;
+    const RobotTrajectoryWithMetadata planning_result = *result;
+    if (!metadata_only)
+      decodePlanningResult(planning_result);
+    if (!callback(planning_result))
+      break;
+  }
+  return passed;
 }
 
 bool moveit_warehouse::PlanningSceneStorage::hasPlanningQuery(const std::string& scene_name,
                                                               const std::string& query_name) const
 {
+  flush();
   Query::Ptr q = motion_plan_request_collection_->createQuery();
   q->append(PLANNING_SCENE_ID_NAME, scene_name);
   q->append(MOTION_PLAN_REQUEST_ID_NAME, query_name);
@@ -348,73 +468,87 @@ bool moveit_warehouse::PlanningSceneStorage::hasPlanningQuery(const std::string&
 void moveit_warehouse::PlanningSceneStorage::renamePlanningScene(const std::string& old_scene_name,
                                                                  const std::string& new_scene_name)
 {
-  Query::Ptr q = planning_scene_collection_->createQuery();
-  q->append(PLANNING_SCENE_ID_NAME, old_scene_name);
-  Metadata::Ptr m = planning_scene_collection_->createMetadata();
-  m->append(PLANNING_SCENE_ID_NAME, new_scene_name);
-  planning_scene_collection_->modifyMetadata(q, m);
-  RCLCPP_DEBUG(LOGGER, "Renamed planning scene from '%s' to '%s'", old_scene_name.c_str(), new_scene_name.c_str());
+  queueWrite([this, old_scene_name, new_scene_name] {
+    Query::Ptr q = planning_scene_collection_->createQuery();
+    q->append(PLANNING_SCENE_ID_NAME, old_scene_name);
+    Metadata::Ptr m = planning_scene_collection_->createMetadata();
+    m->append(PLANNING_SCENE_ID_NAME, new_scene_name);
+    planning_scene_collection_->modifyMetadata(q, m);
+    RCLCPP_DEBUG(LOGGER, "Renamed planning scene from '%s' to '%s'", old_scene_name.c_str(), new_scene_name.c_str());
+  });
 }
 
 void moveit_warehouse::PlanningSceneStorage::renamePlanningQuery(const std::string& scene_name,
                                                                  const std::string& old_query_name,
                                                                  const std::string& new_query_name)
 {
-  Query::Ptr q = motion_plan_request_collection_->createQuery();
-  q->append(PLANNING_SCENE_ID_NAME, scene_name);
-  q->append(MOTION_PLAN_REQUEST_ID_NAME, old_query_name);
-  Metadata::Ptr m = motion_plan_request_collection_->createMetadata();
-  m->append(MOTION_PLAN_REQUEST_ID_NAME, new_query_name);
-  motion_plan_request_collection_->modifyMetadata(q, m);
-  RCLCPP_DEBUG(LOGGER, "Renamed planning query for scene '%s' from '%s' to '%s'", scene_name.c_str(),
-               old_query_name.c_str(), new_query_name.c_str());
+  queueWrite([this, scene_name, old_query_name, new_query_name] {
+    Query::Ptr q = motion_plan_request_collection_->createQuery();
+    q->append(PLANNING_SCENE_ID_NAME, scene_name);
+    q->append(MOTION_PLAN_REQUEST_ID_NAME, old_query_name);
+    Metadata::Ptr m = motion_plan_request_collection_->createMetadata();
+    m->append(MOTION_PLAN_REQUEST_ID_NAME, new_query_name);
+    motion_plan_request_collection_->modifyMetadata(q, m);
+    RCLCPP_DEBUG(LOGGER, "Renamed planning query for scene '%s' from '%s' to '%s'", scene_name.c_str(),
+                 old_query_name.c_str(), new_query_name.c_str());
+  });
 }
 
 void moveit_warehouse::PlanningSceneStorage::removePlanningScene(const std::string& scene_name)
 {
-  removePlanningQueries(scene_name);
-  Query::Ptr q = planning_scene_collection_->createQuery();
-  q->append(PLANNING_SCENE_ID_NAME, scene_name);
-  unsigned int rem = planning_scene_collection_->removeMessages(q);
-  RCLCPP_DEBUG(LOGGER, "Removed %u PlanningScene messages (named '%s')", rem, scene_name.c_str());
+  queueWrite([this, scene_name] {
+    removePlanningQueries(scene_name);
+    Query::Ptr q = planning_scene_collection_->createQuery();
+    q->append(PLANNING_SCENE_ID_NAME, scene_name);
+    unsigned int rem = planning_scene_collection_->removeMessages(q);
+    RCLCPP_DEBUG(LOGGER, "Removed %u PlanningScene messages (named '%s')", rem, scene_name.c_str());
+  });
 }
 
 void moveit_warehouse::PlanningSceneStorage::removePlanningQueries(const std::string& scene_name)
 {
-  removePlanningResults(scene_name);
-  Query::Ptr q = motion_plan_request_collection_->createQuery();
-  q->append(PLANNING_SCENE_ID_NAME, scene_name);
-  unsigned int rem = motion_plan_request_collection_->removeMessages(q);
-  RCLCPP_DEBUG(LOGGER, "Removed %u MotionPlanRequest messages for scene '%s'", rem, scene_name.c_str());
+  queueWrite([this, scene_name] {
+    removePlanningResults(scene_name);
+    Query::Ptr q = motion_plan_request_collection_->createQuery();
+    q->append(PLANNING_SCENE_ID_NAME, scene_name);
+    unsigned int rem = motion_plan_request_collection_->removeMessages(q);
+    RCLCPP_DEBUG(LOGGER, "Removed %u MotionPlanRequest messages for scene '%s'", rem, scene_name.c_str());
+  });
 }
 
 void moveit_warehouse::PlanningSceneStorage::removePlanningQuery(const std::string& scene_name,
                                                                  const std::string& query_name)
 {
-  removePlanningResults(scene_name, query_name);
-  Query::Ptr q = motion_plan_request_collection_->createQuery();
-  q->append(PLANNING_SCENE_ID_NAME, scene_name);
-  q->append(MOTION_PLAN_REQUEST_ID_NAME, query_name);
-  unsigned int rem = motion_plan_request_collection_->removeMessages(q);
-  RCLCPP_DEBUG(LOGGER, "Removed %u MotionPlanRequest messages for scene '%s', query '%s'", rem, scene_name.c_str(),
-               query_name.c_str());
+  queueWrite([this, scene_name, query_name] {
+    removePlanningResults(scene_name, query_name);
+    Query::Ptr q = motion_plan_request_collection_->createQuery();
+    q->append(PLANNING_SCENE_ID_NAME, scene_name);
+    q->append(MOTION_PLAN_REQUEST_ID_NAME, query_name);
+    unsigned int rem = motion_plan_request_collection_->removeMessages(q);
+    RCLCPP_DEBUG(LOGGER, "Removed %u MotionPlanRequest messages for scene '%s', query '%s'", rem, scene_name.c_str(),
+                 query_name.c_str());
+  });
 }
 
 void moveit_warehouse::PlanningSceneStorage::removePlanningResults(const std::string& scene_name)
 {
-  Query::Ptr q = robot_trajectory_collection_->createQuery();
-  q->append(PLANNING_SCENE_ID_NAME, scene_name);
-  unsigned int rem = robot_trajectory_collection_->removeMessages(q);
-  RCLCPP_DEBUG(LOGGER, "Removed %u RobotTrajectory messages for scene '%s'", rem, scene_name.c_str());
+  queueWrite([this, scene_name] {
+    Query::Ptr q = robot_trajectory_collection_->createQuery();
+    q->append(PLANNING_SCENE_ID_NAME, scene_name);
+    unsigned int rem = robot_trajectory_collection_->removeMessages(q);
+    RCLCPP_DEBUG(LOGGER, "Removed %u RobotTrajectory messages for scene '%s'", rem, scene_name.c_str());
+  });
 }
 
 void moveit_warehouse::PlanningSceneStorage::removePlanningResults(const std::string& scene_name,
                                                                    const std::string& query_name)
 {
-  Query::Ptr q = robot_trajectory_collection_->createQuery();
-  q->append(PLANNING_SCENE_ID_NAME, scene_name);
-  q->append(MOTION_PLAN_REQUEST_ID_NAME, query_name);
-  unsigned int rem = robot_trajectory_collection_->removeMessages(q);
-  RCLCPP_DEBUG(LOGGER, "Removed %u RobotTrajectory messages for scene '%s', query '%s'", rem, scene_name.c_str(),
-               query_name.c_str());
+  queueWrite([this, scene_name, query_name] {
+    Query::Ptr q = robot_trajectory_collection_->createQuery();
+    q->append(PLANNING_SCENE_ID_NAME, scene_name);
+    q->append(MOTION_PLAN_REQUEST_ID_NAME, query_name);
+    unsigned int rem = robot_trajectory_collection_->removeMessages(q);
+    RCLCPP_DEBUG(LOGGER, "Removed %u RobotTrajectory messages for scene '%s', query '%s'", rem, scene_name.c_str(),
+                 query_name.c_str());
+  });
 }
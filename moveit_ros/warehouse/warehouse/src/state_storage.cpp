@@ -36,6 +36,7 @@
 
 #include <moveit/warehouse/state_storage.h>
 
+#include <set>
 #include <utility>
 
 const std::string moveit_warehouse::RobotStateStorage::DATABASE_NAME = "moveit_robot_states";
@@ -54,6 +55,11 @@ moveit_warehouse::RobotStateStorage::RobotStateStorage(warehouse_ros::DatabaseCo
   createCollections();
 }
 
+moveit_warehouse::RobotStateStorage::~RobotStateStorage()
+{
+  disableWriteBehind();
+}
+
 void moveit_warehouse::RobotStateStorage::createCollections()
 {
   state_collection_ = conn_->openCollectionPtr<moveit_msgs::msg::RobotState>(DATABASE_NAME, "robot_states");
@@ -61,6 +67,7 @@ void moveit_warehouse::RobotStateStorage::createCollections()
 
 void moveit_warehouse::RobotStateStorage::reset()
 {
+  flush();
   state_collection_.reset();
   conn_->dropDatabase(DATABASE_NAME);
   createCollections();
@@ -69,21 +76,44 @@ void moveit_warehouse::RobotStateStorage::reset()
 void moveit_warehouse::RobotStateStorage::addRobotState(const moveit_msgs::msg::RobotState& msg,
                                                         const std::string& name, const std::string& robot)
 {
-  bool replace = false;
-  if (hasRobotState(name, robot))
-  {
-    removeRobotState(name, robot);
-    replace = true;
-  }
-  Metadata::Ptr metadata = state_collection_->createMetadata();
-  metadata->append(STATE_NAME, name);
-  metadata->append(ROBOT_NAME, robot);
-  state_collection_->insert(msg, metadata);
-  RCLCPP_DEBUG(LOGGER, "%s robot state '%s'", replace ? "Replaced" : "Added", name.c_str());
+  queueWrite([this, msg, name, robot] {
+    bool replace = false;
+    if (hasRobotState(name, robot))
+    {
+      removeRobotState(name, robot);
+      replace = true;
+    }
+    Metadata::Ptr metadata = state_collection_->createMetadata();
+    metadata->append(STATE_NAME, name);
+    metadata->append(ROBOT_NAME, robot);
+    state_collection_->insert(msg, metadata);
+    RCLCPP_DEBUG(LOGGER, "%s robot state '%s'", replace ? "Replaced" : "Added", name.c_str());
+  });
+}
+
+void moveit_warehouse::RobotStateStorage::addRobotStates(
+    const std::map<std::string, moveit_msgs::msg::RobotState>& states, const std::string& robot)
+{
+  queueWrite([this, states, robot] {
+    std::vector<std::string> known;
+    getKnownRobotStates(known, robot);
+    const std::set<std::string> existing(known.begin(), known.end());
+    for (const auto& [name, msg] : states)
+    {
+      if (existing.count(name))
+        removeRobotState(name, robot);
+      Metadata::Ptr metadata = state_collection_->createMetadata();
+      metadata->append(STATE_NAME, name);
+      metadata->append(ROBOT_NAME, robot);
+      state_collection_->insert(msg, metadata);
+    }
+    RCLCPP_DEBUG(LOGGER, "Added %zu robot states", states.size());
+  });
 }
 
 bool moveit_warehouse::RobotStateStorage::hasRobotState(const std::string& name, const std::string& robot) const
 {
+  flush();
   Query::Ptr q = state_collection_->createQuery();
   q->append(STATE_NAME, name);
   if (!robot.empty())
@@ -95,6 +125,13 @@ bool moveit_warehouse::RobotStateStorage::hasRobotState(const std::string& name,
 void moveit_warehouse::RobotStateStorage::getKnownRobotStates(const std::string& regex, std::vector<std::string>& names,
                                                               const std::string& robot) const
 {
+  if (!regex.empty() && isLiteral(regex))
+  {
+    names.clear();
+    if (hasRobotState(regex, robot))
+      names.push_back(regex);
+    return;
+  }
   getKnownRobotStates(names, robot);
   filterNames(regex, names);
 }
@@ -102,6 +139,7 @@ void moveit_warehouse::RobotStateStorage::getKnownRobotStates(const std::string&
 void moveit_warehouse::RobotStateStorage::getKnownRobotStates(std::vector<std::string>& names,
                                                               const std::string& robot) const
 {
+  flush();
   names.clear();
   Query::Ptr q = state_collection_->createQuery();
   if (!robot.empty())
@@ -115,6 +153,7 @@ void moveit_warehouse::RobotStateStorage::getKnownRobotStates(std::vector<std::s
 bool moveit_warehouse::RobotStateStorage::getRobotState(RobotStateWithMetadata& msg_m, const std::string& name,
                                                         const std::string& robot) const
 {
+  flush();
   Query::Ptr q = state_collection_->createQuery();
   q->append(STATE_NAME, name);
   if (!robot.empty())
@@ -132,22 +171,26 @@ bool moveit_warehouse::RobotStateStorage::getRobotState(RobotStateWithMetadata&
 void moveit_warehouse::RobotStateStorage::renameRobotState(const std::string& old_name, const std::string& new_name,
                                                            const std::string& robot)
 {
-  Query::Ptr q = state_collection_->createQuery();
-  q->append(STATE_NAME, old_name);
-  if (!robot.empty())
-    q->append(ROBOT_NAME, robot);
-  Metadata::Ptr m = state_collection_->createMetadata();
-  m->append(STATE_NAME, new_name);
-  state_collection_->modifyMetadata(q, m);
-  RCLCPP_DEBUG(LOGGER, "Renamed robot state from '%s' to '%s'", old_name.c_str(), new_name.c_str());
+  queueWrite([this, old_name, new_name, robot] {
+    Query::Ptr q = state_collection_->createQuery();
+    q->append(STATE_NAME, old_name);
+    if (!robot.empty())
+      q->append(ROBOT_NAME, robot);
+    Metadata::Ptr m = state_collection_->createMetadata();
+    m->append(STATE_NAME, new_name);
+    state_collection_->modifyMetadata(q, m);
+    RCLCPP_DEBUG(LOGGER, "Renamed robot state from '%s' to '%s'", old_name.c_str(), new_name.c_str());
+  });
 }
 
 void moveit_warehouse::RobotStateStorage::removeRobotState(const std::string& name, const std::string& robot)
 {
-  Query::Ptr q = state_collection_->createQuery();
-  q->append(STATE_NAME, name);
-  if (!robot.empty())
-    q->append(ROBOT_NAME, robot);
-  unsigned int rem = state_collection_->removeMessages(q);
-  RCLCPP_DEBUG(LOGGER, "Removed %u RobotState messages (named '%s')", rem, name.c_str());
+  queueWrite([this, name, robot] {
+    Query::Ptr q = state_collection_->createQuery();
+    q->append(STATE_NAME, name);
+    if (!robot.empty())
+      q->append(ROBOT_NAME, robot);
+    unsigned int rem = state_collection_->removeMessages(q);
+    RCLCPP_DEBUG(LOGGER, "Removed %u RobotState messages (named '%s')", rem, name.c_str());
+  });
 }
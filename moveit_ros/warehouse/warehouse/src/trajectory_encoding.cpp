@@ -0,0 +1,307 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, PickNik Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of PickNik Robotics nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+#include <moveit/warehouse/trajectory_encoding.h>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace moveit_warehouse
+{
+namespace
+{
+constexpr std::uint8_t ENCODING_VERSION = 1;
+constexpr char BASE64_DIGITS[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+enum Field : std::uint8_t
+{
+  POSITIONS = 1 << 0,
+  VELOCITIES = 1 << 1,
+  ACCELERATIONS = 1 << 2,
+  EFFORT = 1 << 3
+};
+
+const std::vector<double>& fieldValues(const trajectory_msgs::msg::JointTrajectoryPoint& point, Field field)
+{
+  switch (field)
+  {
+    case POSITIONS:
+      return point.positions;
+    case VELOCITIES:
+      return point.velocities;
+    case ACCELERATIONS:
+      return point.accelerations;
+    default:
+      return point.effort;
+  }
+}
+
+std::vector<double>& fieldValues(trajectory_msgs::msg::JointTrajectoryPoint& point, Field field)
+{
+  return const_cast<std::vector<double>&>(
+      fieldValues(static_cast<const trajectory_msgs::msg::JointTrajectoryPoint&>(point), field));
+}
+
+void writeVarint(std::string& out, std::uint64_t value)
+{
+  while (value >= 0x80)
+  {
+    out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<char>(value));
+}
+
+// zigzag encoding maps small negative differences to small unsigned numbers
+void writeSigned(std::string& out, std::int64_t value)
+{
+  writeVarint(out, (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63));
+}
+
+class Reader
+{
+public:
+  explicit Reader(const std::string& data) : data_(data)
+  {
+  }
+
+  bool readVarint(std::uint64_t& value)
+  {
+    value = 0;
+    for (unsigned int shift = 0; shift < 64 && pos_ < data_.size(); shift += 7)
+    {
+      const auto byte = static_cast<std::uint8_t>(data_[pos_++]);
+      value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+      if (!(byte & 0x80))
+        return true;
+    }
+    return false;
+  }
+
+  bool readSigned(std::int64_t& value)
+  {
+    std::uint64_t zigzag;
+    if (!readVarint(zigzag))
+      return false;
+    value = static_cast<std::int64_t>(zigzag >> 1) ^ -static_cast<std::int64_t>(zigzag & 1);
+    return true;
+  }
+
+  bool readDouble(double& value)
+  {
+    if (data_.size() - pos_ < sizeof(value))
+      return false;
+    std::memcpy(&value, data_.data() + pos_, sizeof(value));
+    pos_ += sizeof(value);
+    return true;
+  }
+
+  bool atEnd() const
+  {
+    return pos_ == data_.size();
+  }
+
+private:
+  const std::string& data_;
+  std::size_t pos_ = 0;
+};
+
+std::string toBase64(const std::string& data)
+{
+  std::string out;
+  out.reserve((data.size() + 2) / 3 * 4);
+  for (std::size_t i = 0; i < data.size(); i += 3)
+  {
+    std::uint32_t chunk = static_cast<std::uint8_t>(data[i]) << 16;
+    if (i + 1 < data.size())
+      chunk |= static_cast<std::uint8_t>(data[i + 1]) << 8;
+    if (i + 2 < data.size())
+      chunk |= static_cast<std::uint8_t>(data[i + 2]);
+    out.push_back(BASE64_DIGITS[(chunk >> 18) & 0x3f]);
+    out.push_back(BASE64_DIGITS[(chunk >> 12) & 0x3f]);
+    out.push_back(i + 1 < data.size() ? BASE64_DIGITS[(chunk >> 6) & 0x3f] : '=');
+    out.push_back(i + 2 < data.size() ? BASE64_DIGITS[chunk & 0x3f] : '=');
+  }
+  return out;
+}
+
+bool fromBase64(const std::string& text, std::string& data)
+{
+  if (text.size() % 4 != 0)
+    return false;
+  data.clear();
+  data.reserve(text.size() / 4 * 3);
+  for (std::size_t i = 0; i < text.size(); i += 4)
+  {
+    std::uint32_t chunk = 0;
+    std::size_t padding = 0;
+    for (std::size_t j = 0; j < 4; ++j)
+    {
+      const char c = text[i + j];
+      const char* digit = c == '=' ? nullptr : std::strchr(BASE64_DIGITS, c);
+      if (c == '=' && i + 4 == text.size() && j >= 2)
+        ++padding;
+      else if (!digit || !c || padding)
+        return false;
+      chunk = (chunk << 6) | (digit ? static_cast<std::uint32_t>(digit - BASE64_DIGITS) : 0);
+    }
+    data.push_back(static_cast<char>(chunk >> 16));
+    if (padding < 2)
+      data.push_back(static_cast<char>((chunk >> 8) & 0xff));
+    if (padding < 1)
+      data.push_back(static_cast<char>(chunk & 0xff));
+  }
+  return true;
+}
+}  // namespace
+
+bool encodeJointTrajectoryPoints(const trajectory_msgs::msg::JointTrajectory& trajectory, double resolution,
+                                 std::string& encoded)
+{
+  if (!(resolution > 0.0))
+    return false;
+
+  // all points have to contain the same fields, each with a value for every joint
+  const std::size_t joint_count = trajectory.joint_names.size();
+  std::uint8_t fields = 0;
+  if (!trajectory.points.empty())
+    for (Field field : { POSITIONS, VELOCITIES, ACCELERATIONS, EFFORT })
+      if (!fieldValues(trajectory.points.front(), field).empty())
+        fields |= field;
+  for (const trajectory_msgs::msg::JointTrajectoryPoint& point : trajectory.points)
+    for (Field field : { POSITIONS, VELOCITIES, ACCELERATIONS, EFFORT })
+      if (fieldValues(point, field).size() != ((fields & field) ? joint_count : 0))
+        return false;
+
+  std::string data;
+  writeVarint(data, ENCODING_VERSION);
+  writeVarint(data, joint_count);
+  writeVarint(data, trajectory.points.size());
+  writeVarint(data, fields);
+  data.append(reinterpret_cast<const char*>(&resolution), sizeof(resolution));
+
+  // times are extrapolated as the values below, which makes uniformly sampled trajectories nearly free
+  std::int64_t previous_time = 0;
+  std::int64_t time_step = 0;
+  for (const trajectory_msgs::msg::JointTrajectoryPoint& point : trajectory.points)
+  {
+    const std::int64_t time =
+        static_cast<std::int64_t>(point.time_from_start.sec) * 1000000000 + point.time_from_start.nanosec;
+    writeSigned(data, time - (previous_time + time_step));
+    time_step = time - previous_time;
+    previous_time = time;
+  }
+
+  for (Field field : { POSITIONS, VELOCITIES, ACCELERATIONS, EFFORT })
+  {
+    if (!(fields & field))
+      continue;
+    for (std::size_t joint = 0; joint < joint_count; ++joint)
+    {
+      // the values are predicted by extrapolating the two previous ones, only the error of that is stored
+      std::int64_t previous = 0;
+      std::int64_t slope = 0;
+      for (const trajectory_msgs::msg::JointTrajectoryPoint& point : trajectory.points)
+      {
+        const std::int64_t quantized = std::llround(fieldValues(point, field)[joint] / resolution);
+        writeSigned(data, quantized - (previous + slope));
+        slope = quantized - previous;
+        previous = quantized;
+      }
+    }
+  }
+
+  encoded = toBase64(data);
+  return true;
+}
+
+bool decodeJointTrajectoryPoints(const std::string& encoded, trajectory_msgs::msg::JointTrajectory& trajectory)
+{
+  std::string data;
+  if (!fromBase64(encoded, data))
+    return false;
+
+  Reader reader(data);
+  std::uint64_t version, joint_count, point_count, fields;
+  double resolution;
+  if (!reader.readVarint(version) || version != ENCODING_VERSION || !reader.readVarint(joint_count) ||
+      !reader.readVarint(point_count) || !reader.readVarint(fields) || !reader.readDouble(resolution))
+    return false;
+  // every value takes at least one byte, which bounds the sizes of a valid encoding
+  if (point_count > data.size() || (point_count && joint_count > data.size() / point_count))
+    return false;
+
+  std::vector<trajectory_msgs::msg::JointTrajectoryPoint> points(point_count);
+  std::int64_t time = 0;
+  std::int64_t time_step = 0;
+  for (trajectory_msgs::msg::JointTrajectoryPoint& point : points)
+  {
+    std::int64_t error;
+    if (!reader.readSigned(error))
+      return false;
+    time_step += error;
+    time += time_step;
+    point.time_from_start.sec = static_cast<std::int32_t>(time / 1000000000);
+    point.time_from_start.nanosec = static_cast<std::uint32_t>(time % 1000000000);
+  }
+
+  for (Field field : { POSITIONS, VELOCITIES, ACCELERATIONS, EFFORT })
+  {
+    if (!(fields & field))
+      continue;
+    for (trajectory_msgs::msg::JointTrajectoryPoint& point : points)
+      fieldValues(point, field).resize(joint_count);
+    for (std::size_t joint = 0; joint < joint_count; ++joint)
+    {
+      std::int64_t previous = 0;
+      std::int64_t slope = 0;
+      for (trajectory_msgs::msg::JointTrajectoryPoint& point : points)
+      {
+        std::int64_t error;
+        if (!reader.readSigned(error))
+          return false;
+        const std::int64_t quantized = previous + slope + error;
+        slope = quantized - previous;
+        previous = quantized;
+        fieldValues(point, field)[joint] = static_cast<double>(quantized) * resolution;
+      }
+    }
+  }
+  if (!reader.atEnd())
+    return false;
+
+  trajectory.points.swap(points);
+  return true;
+}
+}  // namespace moveit_warehouse
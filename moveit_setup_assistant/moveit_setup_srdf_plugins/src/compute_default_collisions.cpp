@@ -39,6 +39,7 @@
 #include <boost/math/special_functions/binomial.hpp>  // for statistics at end
 #include <boost/thread.hpp>
 #include <boost/assign.hpp>
+#include <cmath>
 #include <unordered_map>
 
 namespace moveit_setup
@@ -62,30 +63,6 @@ static const rclcpp::Logger LOGGER = rclcpp::get_logger("collision_updater");
 // Unique set of pairs of links in string-based form
 typedef std::set<std::pair<std::string, std::string> > StringPairSet;
 
-// Struct for passing parameters to threads, for cleaner code
-struct ThreadComputation
-{
-  ThreadComputation(planning_scene::PlanningScene& scene, const collision_detection::CollisionRequest& req,
-                    int thread_id, int num_trials, StringPairSet* links_seen_colliding, std::mutex* lock,
-                    unsigned int* progress)
-    : scene_(scene)
-    , req_(req)
-    , thread_id_(thread_id)
-    , num_trials_(num_trials)
-    , links_seen_colliding_(links_seen_colliding)
-    , lock_(lock)
-    , progress_(progress)
-  {
-  }
-  planning_scene::PlanningScene& scene_;
-  const collision_detection::CollisionRequest& req_;
-  int thread_id_;
-  unsigned int num_trials_;
-  StringPairSet* links_seen_colliding_;
-  std::mutex* lock_;
-  unsigned int* progress_;  // only to be updated by thread 0
-};
-
 // LinkGraph defines a Link's model and a set of unique links it connects
 typedef std::map<const moveit::core::LinkModel*, std::set<const moveit::core::LinkModel*> > LinkGraph;
 
@@ -158,24 +135,22 @@ static unsigned int disableAlwaysInCollision(planning_scene::PlanningScene& scen
  * \param link_pairs List of all unique link pairs and each pair's properties
  * \param req A reference to a collision request that is already initialized
  * \param links_seen_colliding Set of links that have at some point been seen in collision
+ * \param never_collision_probability Stop sampling early once pairs colliding at least this often would have been
+ * found with \e never_collision_confidence, 0 to always sample \e num_trials states
  * \return number of never in collision links found and disabled
  */
 static unsigned int disableNeverInCollision(const unsigned int num_trials, planning_scene::PlanningScene& scene,
                                             LinkPairMap& link_pairs, const collision_detection::CollisionRequest& req,
-                                            StringPairSet& links_seen_colliding, unsigned int* progress);
-
-/**
- * \brief Thread for getting the pairs of links that are never in collision
- * \param tc Struct that encapsulates all the data each thread needs
- */
-static void disableNeverInCollisionThread(ThreadComputation tc);
+                                            StringPairSet& links_seen_colliding, unsigned int* progress,
+                                            double never_collision_probability, double never_collision_confidence);
 
 // ******************************************************************************************
 // Generates an adjacency list of links that are always and never in collision, to speed up collision detection
 // ******************************************************************************************
 LinkPairMap computeDefaultCollisions(const planning_scene::PlanningSceneConstPtr& parent_scene, unsigned int* progress,
                                      const bool include_never_colliding, const unsigned int num_trials,
-                                     const double min_collision_fraction, const bool verbose)
+                                     const double min_collision_fraction, const bool verbose,
+                                     const double never_collision_probability, const double never_collision_confidence)
 {
   // Create new instance of planning scene using pointer
   planning_scene::PlanningScenePtr scene = parent_scene->diff();
@@ -240,7 +215,8 @@ LinkPairMap computeDefaultCollisions(const planning_scene::PlanningSceneConstPtr
   unsigned int num_never = 0;
   if (include_never_colliding)  // option of function
   {
-    num_never = disableNeverInCollision(num_trials, *scene, link_pairs, req, links_seen_colliding, progress);
+    num_never = disableNeverInCollision(num_trials, *scene, link_pairs, req, links_seen_colliding, progress,
+                                        never_collision_probability, never_collision_confidence);
   }
 
   // RCLCPP_INFO_STREAM(LOGGER, "Link pairs seen colliding ever: %d", int(links_seen_colliding.size()));
@@ -553,27 +529,74 @@ unsigned int disableAlwaysInCollision(planning_scene::PlanningScene& scene, Link
 // ******************************************************************************************
 unsigned int disableNeverInCollision(const unsigned int num_trials, planning_scene::PlanningScene& scene,
                                      LinkPairMap& link_pairs, const collision_detection::CollisionRequest& req,
-                                     StringPairSet& links_seen_colliding, unsigned int* progress)
+                                     StringPairSet& links_seen_colliding, unsigned int* progress,
+                                     double never_collision_probability, double never_collision_confidence)
 {
-  unsigned int num_disabled = 0;
-  std::vector<std::thread> bgroup;
-  std::mutex lock;  // used for sharing the same data structures
+  // States are sampled and checked in batches, the collision checker may check a batch concurrently. Pairs seen in
+  // collision are allowed to collide from then on, so later checks only consider the pairs still in question.
+  static const unsigned int BATCH_SIZE = 1000;
+
+  // If a pair collides with probability p, n samples without seeing it collide happen with probability (1 - p)^n.
+  // Sampling stops once that many samples in a row found no new colliding pair, so that the remaining pairs are
+  // "never" in collision with the requested confidence.
+  unsigned int samples_to_confidence = num_trials;
+  if (never_collision_probability > 0.0 && never_collision_probability < 1.0 && never_collision_confidence > 0.0 &&
+      never_collision_confidence < 1.0)
+  {
+    samples_to_confidence = static_cast<unsigned int>(std::min<double>(
+        num_trials, std::ceil(std::log(1.0 - never_collision_confidence) / std::log1p(-never_collision_probability))));
+  }
+
+  collision_detection::AllowedCollisionMatrix& acm = scene.getAllowedCollisionMatrixNonConst();
+  const collision_detection::CollisionEnvConstPtr& collision_env = scene.getCollisionEnvUnpadded();
 
-  int num_threads = std::thread::hardware_concurrency();  // how many cores does this computer have?
-  // RCLCPP_INFO_STREAM_STREAM(LOGGER, "Performing " << num_trials << " trials for 'always in collision' checking on " <<
-  //   num_threads << " threads...");
+  std::vector<moveit::core::RobotState> states(std::min(BATCH_SIZE, num_trials),
+                                               moveit::core::RobotState(scene.getRobotModel()));
+  std::vector<const moveit::core::RobotState*> batch;
+  std::vector<collision_detection::CollisionResult> results;
 
-  for (int i = 0; i < num_threads; ++i)
+  unsigned int samples = 0;
+  unsigned int samples_without_new_pair = 0;
+  while (samples < num_trials && samples_without_new_pair < samples_to_confidence)
   {
-    ThreadComputation tc(scene, req, i, num_trials / num_threads, &links_seen_colliding, &lock, progress);
-    bgroup.push_back(std::thread([tc] { return disableNeverInCollisionThread(tc); }));
-  }
+    boost::this_thread::interruption_point();
+    (*progress) = samples * 92 / num_trials + 8;  // 8 is the amount of progress already completed in prev steps
+
+    batch.clear();
+    for (std::size_t i = 0; i < states.size() && samples + batch.size() < num_trials; ++i)
+    {
+      states[i].setToRandomPositions();
+      states[i].updateCollisionBodyTransforms();
+      batch.push_back(&states[i]);
+    }
+    collision_env->checkCollisionBatch(req, results, batch, acm);
 
-  for (auto& thread : bgroup)
+    // merge the contacts of the batch in order, so that the count of samples without a new pair is exact
+    for (const collision_detection::CollisionResult& res : results)
+    {
+      ++samples;
+      bool new_pair = false;
+      for (const auto& contact : res.contacts)
+      {
+        if (links_seen_colliding.insert(contact.first).second)
+        {
+          acm.setEntry(contact.first.first, contact.first.second, true);
+          new_pair = true;
+        }
+      }
+      samples_without_new_pair = new_pair ? 0 : samples_without_new_pair + 1;
+    }
+  }
+  if (samples < num_trials)
   {
-    thread.join();
+    RCLCPP_INFO(LOGGER,
+                "Stopped sampling after %u of %u states, the last %u found no new colliding link pair, so the "
+                "remaining pairs collide with a probability below %g at %g confidence",
+                samples, num_trials, samples_without_new_pair, never_collision_probability,
+                never_collision_confidence);
   }
 
+  unsigned int num_disabled = 0;
   // Loop through every possible link pair and check if it has ever been seen in collision
   for (std::pair<const std::pair<std::string, std::string>, LinkPairData>& link_pair : link_pairs)
   {
@@ -597,53 +620,6 @@ unsigned int disableNeverInCollision(const unsigned int num_trials, planning_sce
   return num_disabled;
 }
 
-// ******************************************************************************************
-// Thread for getting the pairs of links that are never in collision
-// ******************************************************************************************
-void disableNeverInCollisionThread(ThreadComputation tc)
-{
-  // RCLCPP_INFO_STREAM_STREAM(LOGGER, "Thread " << tc.thread_id_ << " running " << tc.num_trials_ << " trials");
-
-  // User feedback vars
-  const unsigned int progress_interval = tc.num_trials_ / 20;  // show progress update every 5%
-
-  // Create a new kinematic state for this thread to work on
-  moveit::core::RobotState robot_state(tc.scene_.getRobotModel());
-
-  // Do a large number of tests
-  for (unsigned int i = 0; i < tc.num_trials_; ++i)
-  {
-    boost::this_thread::interruption_point();
-
-    // Status update at intervals and only for 0 thread
-    if (i % progress_interval == 0 && tc.thread_id_ == 0)
-    {
-      (*tc.progress_) = i * 92 / tc.num_trials_ + 8;  // 8 is the amount of progress already completed in prev steps
-    }
-
-    collision_detection::CollisionResult res;
-    robot_state.setToRandomPositions();
-    tc.scene_.checkSelfCollision(tc.req_, res, robot_state);
-
-    // Check all contacts
-    for (collision_detection::CollisionResult::ContactMap::const_iterator it = res.contacts.begin();
-         it != res.contacts.end(); ++it)
-    {
-      // Check if this collision pair is unique before doing a thread lock
-      if (tc.links_seen_colliding_->find(it->first) == tc.links_seen_colliding_->end())
-      {
-        // Collision Matrix and links_seen_colliding is modified only if needed, based on above if statement
-
-        std::scoped_lock slock(*tc.lock_);
-        tc.links_seen_colliding_->insert(it->first);
-
-        tc.scene_.getAllowedCollisionMatrixNonConst().setEntry(it->first.first, it->first.second,
-                                                               true);  // disable link checking in the collision matrix
-      }
-    }
-  }
-}
-
 // ******************************************************************************************
 // Converts a reason for disabling a link pair into a string
 // ******************************************************************************************